@@ -37,10 +37,23 @@ int main(int argc, char** argv) {
   validInput->resize(1000);
   nanInput->resize(1000);
 
+  auto bigintInput = vectorMaker.flatVector<facebook::velox::StringView>({""});
+  auto doubleInput = vectorMaker.flatVector<facebook::velox::StringView>({""});
+  auto dateInput = vectorMaker.flatVector<facebook::velox::StringView>({""});
+  bigintInput->resize(1000);
+  doubleInput->resize(1000);
+  dateInput->resize(1000);
+
   for (int i = 0; i < 1000; i++) {
     nanInput->set(i, "$"_sv);
     invalidInput->set(i, StringView::makeInline(std::string("")));
     validInput->set(i, StringView::makeInline(std::to_string(i)));
+    bigintInput->set(i, StringView::makeInline(std::to_string(i * 1'234'567)));
+    doubleInput->set(i, StringView::makeInline(std::to_string(i * 1.25)));
+    dateInput->set(
+        i,
+        StringView::makeInline(fmt::format(
+            "20{:02}-{:02}-{:02}", i % 100, i % 12 + 1, i % 28 + 1)));
   }
 
   benchmarkBuilder
@@ -59,6 +72,18 @@ int main(int argc, char** argv) {
       .withIterations(100)
       .disableTesting();
 
+  benchmarkBuilder
+      .addBenchmarkSet(
+          "cast_string",
+          vectorMaker.rowVector(
+              {"bigint_string", "double_string", "date_string"},
+              {bigintInput, doubleInput, dateInput}))
+      .addExpression("cast_bigint", "cast(bigint_string as bigint)")
+      .addExpression("cast_double", "cast(double_string as double)")
+      .addExpression("cast_date", "cast(date_string as date)")
+      .withIterations(100)
+      .disableTesting();
+
   benchmarkBuilder.registerBenchmarks();
   folly::runBenchmarks();
   return 0;
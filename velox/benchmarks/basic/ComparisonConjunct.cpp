@@ -94,6 +94,12 @@ class ComparisonBenchmark : public functions::test::FunctionBenchmarkBase {
         pool(), inputType_, nullptr, vectorSize, std::move(children));
   }
 
+  void setFilterReordering(bool enabled) {
+    queryCtx_->testingOverrideConfigUnsafe(
+        {{core::QueryConfig::kAdaptiveFilterReorderingEnabled,
+          enabled ? "true" : "false"}});
+  }
+
   // Runs `expression` `times` times.
   size_t run(const std::string& expression, size_t times = 100) {
     folly::BenchmarkSuspender suspender;
@@ -172,6 +178,28 @@ BENCHMARK(conjunctsNested) {
   benchmark->run("(d OR e) AND ((d AND (neq(d, (d OR e)))) OR (eq(a, b)))");
 }
 
+BENCHMARK_DRAW_LINE();
+
+// An expensive input that drops no rows is listed before cheap inputs that
+// drop about half of the rows each. Adaptive reordering moves the expensive
+// input last.
+const std::string kExpensiveFirst =
+    "neq(plus(plus(plus(plus(a, b), c), a), b), c) AND d AND e";
+
+BENCHMARK(expensiveFirstNoReorder) {
+  folly::BenchmarkSuspender suspender;
+  benchmark->setFilterReordering(false);
+  suspender.dismiss();
+  benchmark->run(kExpensiveFirst);
+}
+
+BENCHMARK_RELATIVE(expensiveFirstReorder) {
+  folly::BenchmarkSuspender suspender;
+  benchmark->setFilterReordering(true);
+  suspender.dismiss();
+  benchmark->run(kExpensiveFirst);
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -108,6 +108,26 @@ class SelectivityVectorBenchmark
     return run(rows99PerCent_);
   }
 
+  size_t runIndicesSelectivity50PerCent() {
+    return runIndices(rows50PerCent_);
+  }
+
+  size_t runIndicesSelectivity10PerCent() {
+    return runIndices(rows10PerCent_);
+  }
+
+  size_t runIndicesSelectivity1PerCent() {
+    return runIndices(rows1PerCent_);
+  }
+
+  size_t runExtractIndices50PerCent() {
+    return extractIndices(rows50PerCent_);
+  }
+
+  size_t runExtractIndices1PerCent() {
+    return extractIndices(rows1PerCent_);
+  }
+
  private:
   size_t run(const SelectivityVector& rows) {
     const int64_t* flatBuffer = flatVector_->values()->as<int64_t>();
@@ -118,6 +138,21 @@ class SelectivityVectorBenchmark
     return vectorSize_;
   }
 
+  // Iterates over the cached list of selected rows. The list is extracted on
+  // the first call and reused afterwards.
+  size_t runIndices(const SelectivityVector& rows) {
+    rows.selectedIndices();
+    return run(rows);
+  }
+
+  // Measures the extraction of the selected rows from the bits.
+  size_t extractIndices(const SelectivityVector& rows) {
+    SelectivityVector copy;
+    copy.setFromBits(rows.asRange().bits(), rows.size());
+    folly::doNotOptimizeAway(copy.selectedIndices().size());
+    return vectorSize_;
+  }
+
   const size_t vectorSize_;
   VectorPtr flatVector_;
 
@@ -161,6 +196,30 @@ BENCHMARK(sumSelectivity1PerCent) {
   run([] { benchmark->runSelectivity1PerCent(); });
 }
 
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(sumIndicesSelectivity50PerCent) {
+  run([] { benchmark->runIndicesSelectivity50PerCent(); });
+}
+
+BENCHMARK(sumIndicesSelectivity10PerCent) {
+  run([] { benchmark->runIndicesSelectivity10PerCent(); });
+}
+
+BENCHMARK(sumIndicesSelectivity1PerCent) {
+  run([] { benchmark->runIndicesSelectivity1PerCent(); });
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(extractIndices50PerCent) {
+  run([] { benchmark->runExtractIndices50PerCent(); });
+}
+
+BENCHMARK(extractIndices1PerCent) {
+  run([] { benchmark->runExtractIndices1PerCent(); });
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
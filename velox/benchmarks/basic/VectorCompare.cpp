@@ -47,6 +47,21 @@ class VectorCompareBenchmark : public functions::test::FunctionBenchmarkBase {
     mapVector_ = fuzzer.fuzzFlat(MAP(BIGINT(), BIGINT()));
 
     rowVector_ = fuzzer.fuzzFlat(ROW({BIGINT(), BIGINT(), BIGINT()}));
+
+    opts.stringLength = 50;
+    opts.stringVariableLength = false;
+    fuzzer.setOptions(opts);
+    stringVector_ = fuzzer.fuzzFlat(VARCHAR());
+
+    // Strings that share their inlined prefix, so that comparisons need to
+    // look at the out of line part.
+    auto strings = stringVector_->as<FlatVector<StringView>>();
+    std::vector<std::string> samePrefix;
+    samePrefix.reserve(vectorSize_);
+    for (auto i = 0; i < vectorSize_; ++i) {
+      samePrefix.push_back("prefix" + strings->valueAt(i).str());
+    }
+    samePrefixStringVector_ = vectorMaker_.flatVector(samePrefix);
   }
 
   size_t run(const VectorPtr& vector) {
@@ -59,6 +74,16 @@ class VectorCompareBenchmark : public functions::test::FunctionBenchmarkBase {
     return vectorSize_;
   }
 
+  size_t runFastString(const VectorPtr& vector) {
+    size_t sum = 0;
+    auto flatVector = vector->as<FlatVector<StringView>>();
+    for (auto i = 0; i < vectorSize_; i++) {
+      sum += *flatVector->compare(flatVector, i, vectorSize_ - i - 1, kFlags);
+    }
+    folly::doNotOptimizeAway(sum);
+    return vectorSize_;
+  }
+
   // Avoid dynamic dispatch by casting the vector before calling compare to its
   // derived that have final compare function.
   size_t runFastFlat() {
@@ -75,6 +100,8 @@ class VectorCompareBenchmark : public functions::test::FunctionBenchmarkBase {
   VectorPtr arrayVector_;
   VectorPtr mapVector_;
   VectorPtr rowVector_;
+  VectorPtr stringVector_;
+  VectorPtr samePrefixStringVector_;
 
  private:
   static constexpr CompareFlags kFlags{
@@ -97,6 +124,14 @@ BENCHMARK(compareSimilarSimpleFlatNoDispatch) {
   benchmark->runFastFlat();
 }
 
+BENCHMARK(compareStringNoDispatch) {
+  benchmark->runFastString(benchmark->stringVector_);
+}
+
+BENCHMARK(compareSamePrefixStringNoDispatch) {
+  benchmark->runFastString(benchmark->samePrefixStringVector_);
+}
+
 BENCHMARK(compareSimilarArray) {
   benchmark->run(benchmark->arrayVector_);
 }
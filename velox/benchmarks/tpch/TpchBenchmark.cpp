@@ -19,11 +19,15 @@
 #include <sys/time.h>
 
 #include <folly/Benchmark.h>
+#include <folly/String.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/init/Init.h>
+#include <folly/json.h>
 #include <gflags/gflags.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <fstream>
+#include <numeric>
 
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/common/file/FileSystems.h"
@@ -34,6 +38,7 @@
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/Split.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/exec/tests/utils/TpchQueryBuilder.h"
 #include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
@@ -105,6 +110,23 @@ DEFINE_int32(
     run_query_verbose,
     -1,
     "Run a given query and print execution statistics");
+DEFINE_string(
+    run_queries,
+    "",
+    "Comma separated list of queries to run one after the other, e.g. 1,3,6, "
+    "or 'all' for all 22 queries. Prints the execution time of each and, with "
+    "--stats_json_path, records per operator statistics");
+DEFINE_string(
+    stats_json_path,
+    "",
+    "File to which --run_queries appends one JSON object per query run with "
+    "the settings and the statistics of each plan node and operator, for "
+    "comparing runs and detecting regressions");
+DEFINE_bool(
+    spill,
+    false,
+    "Enables spilling of joins, aggregations and order by to a temporary "
+    "directory");
 DEFINE_int32(
     io_meter_column_pct,
     0,
@@ -263,7 +285,9 @@ class TpchBenchmark {
   }
 
   void shutdown() {
-    cache_->shutdown();
+    if (cache_) {
+      cache_->shutdown();
+    }
   }
 
   std::pair<std::unique_ptr<TaskCursor>, std::vector<RowVectorPtr>> run(
@@ -274,6 +298,18 @@ class TpchBenchmark {
         CursorParameters params;
         params.maxDrivers = FLAGS_num_drivers;
         params.planNode = tpchPlan.plan;
+        if (FLAGS_spill) {
+          if (queryExecutor_ == nullptr) {
+            queryExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+                std::thread::hardware_concurrency());
+            spillDirectory_ = TempDirectoryPath::create();
+          }
+          params.queryCtx = std::make_shared<core::QueryCtx>(
+              queryExecutor_.get(),
+              std::unordered_map<std::string, std::string>{
+                  {core::QueryConfig::kSpillEnabled, "true"}});
+          params.spillDirectory = spillDirectory_->path;
+        }
         const int numSplitsPerFile = FLAGS_num_splits_per_file;
 
         bool noMoreSplits = false;
@@ -306,7 +342,10 @@ class TpchBenchmark {
   }
 
   void runMain(std::ostream& out, RunStats& runStats) {
-    if (FLAGS_run_query_verbose == -1 && FLAGS_io_meter_column_pct == 0) {
+    if (!FLAGS_run_queries.empty()) {
+      runQueries(out);
+    } else if (
+        FLAGS_run_query_verbose == -1 && FLAGS_io_meter_column_pct == 0) {
       folly::runBenchmarks();
     } else {
       const auto queryPlan = FLAGS_io_meter_column_pct > 0
@@ -348,6 +387,54 @@ class TpchBenchmark {
     }
   }
 
+  // Runs the queries in --run_queries and appends their statistics to
+  // --stats_json_path if set.
+  void runQueries(std::ostream& out) {
+    std::vector<int32_t> queryIds;
+    if (FLAGS_run_queries == "all") {
+      queryIds.resize(22);
+      std::iota(queryIds.begin(), queryIds.end(), 1);
+    } else {
+      std::vector<folly::StringPiece> ids;
+      folly::split(',', FLAGS_run_queries, ids);
+      for (const auto& id : ids) {
+        queryIds.push_back(folly::to<int32_t>(id));
+      }
+    }
+
+    std::ofstream statsFile;
+    if (!FLAGS_stats_json_path.empty()) {
+      statsFile.open(FLAGS_stats_json_path, std::ios::app);
+      VELOX_CHECK(
+          statsFile.is_open(), "Cannot open {}", FLAGS_stats_json_path);
+    }
+    for (auto queryId : queryIds) {
+      auto [cursor, results] = run(queryBuilder->getQueryPlan(queryId));
+      if (!cursor) {
+        out << fmt::format("q{}: failed", queryId) << std::endl;
+        continue;
+      }
+      const auto stats = cursor->task()->taskStats();
+      const auto executionMs =
+          stats.executionEndTimeMs - stats.executionStartTimeMs;
+      out << fmt::format("q{}: {}", queryId, succinctMillis(executionMs))
+          << std::endl;
+      if (statsFile.is_open()) {
+        folly::dynamic json = folly::dynamic::object;
+        json["query"] = queryId;
+        json["dataPath"] = FLAGS_data_path;
+        json["dataFormat"] = FLAGS_data_format;
+        json["numDrivers"] = FLAGS_num_drivers;
+        json["cacheGb"] = FLAGS_cache_gb;
+        json["ssdCacheGb"] = FLAGS_ssd_cache_gb;
+        json["spill"] = FLAGS_spill;
+        json["executionMs"] = static_cast<int64_t>(executionMs);
+        json["planStats"] = toPlanStatsJson(stats);
+        statsFile << folly::toJson(json) << std::endl;
+      }
+    }
+  }
+
   void readCombinations() {
     std::ifstream file(FLAGS_test_flags_file);
     std::string line;
@@ -464,6 +551,10 @@ class TpchBenchmark {
 
   std::unique_ptr<folly::IOThreadPoolExecutor> ioExecutor_;
   std::unique_ptr<folly::IOThreadPoolExecutor> cacheExecutor_;
+  // Runs the drivers of queries with --spill, which need a QueryCtx with
+  // spilling enabled.
+  std::unique_ptr<folly::CPUThreadPoolExecutor> queryExecutor_;
+  std::shared_ptr<TempDirectoryPath> spillDirectory_;
   std::shared_ptr<memory::MemoryAllocator> allocator_;
   std::shared_ptr<cache::AsyncDataCache> cache_;
   // Parameter combinations to try. Each element specifies a flag and possible
@@ -480,11 +571,21 @@ BENCHMARK(q1) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q2) {
+  const auto planContext = queryBuilder->getQueryPlan(2);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q3) {
   const auto planContext = queryBuilder->getQueryPlan(3);
   benchmark.run(planContext);
 }
 
+BENCHMARK(q4) {
+  const auto planContext = queryBuilder->getQueryPlan(4);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q5) {
   const auto planContext = queryBuilder->getQueryPlan(5);
   benchmark.run(planContext);
@@ -515,6 +616,11 @@ BENCHMARK(q10) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q11) {
+  const auto planContext = queryBuilder->getQueryPlan(11);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q12) {
   const auto planContext = queryBuilder->getQueryPlan(12);
   benchmark.run(planContext);
@@ -17,6 +17,10 @@
 #include "velox/common/base/Counters.h"
 #include "velox/common/base/StatsReporter.h"
 
+#include <fmt/format.h>
+#include <folly/Synchronized.h>
+#include <unordered_set>
+
 namespace facebook::velox {
 
 void registerVeloxCounters() {
@@ -24,6 +28,50 @@ void registerVeloxCounters() {
   // P50, P90, P99, and P100.
   REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE(
       kCounterHiveFileHandleGenerateLatencyMs, 10, 0, 100000, 50, 90, 99, 100);
+
+  // Track memory arbitration latency in range of [0, 100s] and reports P50,
+  // P90, P99, and P100.
+  REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE(
+      kCounterArbitrationLatencyUs, 1000, 0, 100'000'000, 50, 90, 99, 100);
+}
+
+std::string operatorCounterKey(
+    const std::string& operatorType,
+    folly::StringPiece counter) {
+  return fmt::format("velox.operator.{}.{}", operatorType, counter);
+}
+
+void registerOperatorCounters(const std::string& operatorType) {
+  static folly::Synchronized<std::unordered_set<std::string>> registered;
+  if (registered.rlock()->count(operatorType) ||
+      !registered.wlock()->insert(operatorType).second) {
+    return;
+  }
+  // Batches mostly take well under a millisecond, so track [0, 1s] in 100us
+  // buckets to see the tail. Reports P50, P90, P99, and P100.
+  for (auto counter :
+       {kCounterOperatorAddInputLatencyUs,
+        kCounterOperatorGetOutputLatencyUs}) {
+    REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE(
+        operatorCounterKey(operatorType, counter),
+        100,
+        0,
+        1'000'000,
+        50,
+        90,
+        99,
+        100);
+  }
+  // Track the I/O wait of a split in range of [0, 100s].
+  REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE(
+      operatorCounterKey(operatorType, kCounterOperatorIoWaitUs),
+      1000,
+      0,
+      100'000'000,
+      50,
+      90,
+      99,
+      100);
 }
 
 } // namespace facebook::velox
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <folly/Range.h>
+#include <string>
 
 namespace facebook::velox {
 
@@ -25,4 +26,34 @@ void registerVeloxCounters();
 
 constexpr folly::StringPiece kCounterHiveFileHandleGenerateLatencyMs{
     "velox.hive_file_handle_generate_latency_ms"};
+
+/// Time in microseconds that a memory pool waits for and spends in a memory
+/// arbitration, i.e. the stall of the operator that needs the memory.
+constexpr folly::StringPiece kCounterArbitrationLatencyUs{
+    "velox.arbitration_latency_us"};
+
+/// Per operator type histograms. The key of a histogram is
+/// operatorCounterKey(<operator type>, <counter>), e.g.
+/// velox.operator.HashBuild.add_input_latency_us.
+///
+/// Wall time in microseconds of each Operator::addInput() call.
+constexpr folly::StringPiece kCounterOperatorAddInputLatencyUs{
+    "add_input_latency_us"};
+
+/// Wall time in microseconds of each Operator::getOutput() call.
+constexpr folly::StringPiece kCounterOperatorGetOutputLatencyUs{
+    "get_output_latency_us"};
+
+/// Time in microseconds that an operator waited for I/O while reading one
+/// split.
+constexpr folly::StringPiece kCounterOperatorIoWaitUs{"io_wait_us"};
+
+/// Returns the key of 'counter' of operators of 'operatorType'.
+std::string operatorCounterKey(
+    const std::string& operatorType,
+    folly::StringPiece counter);
+
+/// Registers the per operator type histograms of 'operatorType'. Does
+/// nothing if they are already registered.
+void registerOperatorCounters(const std::string& operatorType);
 } // namespace facebook::velox
@@ -47,6 +47,35 @@ class SelectivityInfo {
     return numOut_;
   }
 
+  uint64_t timeClocks() const {
+    return timeClocks_;
+  }
+
+  // Adds the measurements in 'other' to 'this'.
+  void merge(const SelectivityInfo& other) {
+    numIn_ += other.numIn_;
+    numOut_ += other.numOut_;
+    timeClocks_ += other.timeClocks_;
+  }
+
+  // Returns the measurements made since 'earlier', a copy of 'this' taken
+  // before.
+  SelectivityInfo since(const SelectivityInfo& earlier) const {
+    SelectivityInfo delta;
+    delta.numIn_ = numIn_ - earlier.numIn_;
+    delta.numOut_ = numOut_ - earlier.numOut_;
+    delta.timeClocks_ = timeClocks_ - earlier.timeClocks_;
+    return delta;
+  }
+
+  // Halves the measurements. Keeps timeToDropValue() about the same while
+  // giving more weight to measurements added after this.
+  void halve() {
+    numIn_ /= 2;
+    numOut_ /= 2;
+    timeClocks_ /= 2;
+  }
+
  private:
   uint64_t numIn_ = 0;
   uint64_t numOut_ = 0;
@@ -176,6 +176,11 @@ int32_t indicesOfSetBits(
   if (end <= begin) {
     return 0;
   }
+#ifdef __x86_64__
+  if (end - begin >= detail::kMinAvx512IndicesBits && process::hasAvx512()) {
+    return detail::indicesOfSetBitsAvx512(bits, begin, end, result);
+  }
+#endif
   int32_t row = begin & ~63;
   auto originalResult = result;
   int32_t endWord = bits::roundUp(end, 64) / 64;
@@ -19,6 +19,7 @@
 #include <cstdint>
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/process/ProcessBase.h"
 
 #include <folly/Likely.h>
 #include <xsimd/xsimd.hpp>
@@ -57,7 +58,21 @@ int32_t indicesOfSetBits(
 
 namespace detail {
 extern int32_t byteSetBits[256][8];
-}
+
+#ifdef __x86_64__
+// Minimum number of bits for which indicesOfSetBits() uses the AVX-512
+// kernel.
+constexpr int32_t kMinAvx512IndicesBits = 512;
+
+// indicesOfSetBits() with AVX-512 compress. Compiled for AVX-512 regardless
+// of the build target. Must be called only if process::hasAvx512().
+int32_t indicesOfSetBitsAvx512(
+    const uint64_t* bits,
+    int32_t begin,
+    int32_t end,
+    int32_t* indices);
+#endif
+} // namespace detail
 
 // Offsets of set bits in a byte. For example, for byte 42 it returns
 // {1, 3, 5, 3, 4, 5, 6, 7}, because 42 has bits 1, 3 and 5 set. The
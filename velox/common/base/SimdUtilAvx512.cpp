@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Kernels that use AVX-512 in binaries built for an older target. Each is
+// compiled for AVX-512 with a target attribute instead of compiler flags for
+// the whole file, so that no inline function of a header gets instantiated
+// with AVX-512 instructions and picked by the linker for the other callers.
+// Callers check process::hasAvx512() first.
+
+#include "velox/common/base/SimdUtil.h"
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+namespace facebook::velox::simd::detail {
+
+#ifdef __x86_64__
+
+__attribute__((target("avx512f,avx512bw,avx512vl"))) int32_t
+indicesOfSetBitsAvx512(
+    const uint64_t* bits,
+    int32_t begin,
+    int32_t end,
+    int32_t* indices) {
+  if (end <= begin) {
+    return 0;
+  }
+  const auto lanes = _mm512_setr_epi32(
+      0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  auto* result = indices;
+  const int32_t firstWord = begin / 64;
+  const int32_t endWord = (end + 63) / 64;
+  for (auto wordIndex = firstWord; wordIndex < endWord; ++wordIndex) {
+    const int32_t row = wordIndex * 64;
+    uint64_t word = bits[wordIndex];
+    if (wordIndex == firstWord) {
+      word &= ~0ULL << (begin - row);
+    }
+    if (end - row < 64) {
+      word &= (1ULL << (end - row)) - 1;
+    }
+    // Writes the positions of the set bits of each 16 bit part of 'word'.
+    for (auto offset = row; word; offset += 16, word >>= 16) {
+      const __mmask16 mask = word;
+      if (mask) {
+        _mm512_mask_compressstoreu_epi32(
+            result, mask, _mm512_add_epi32(lanes, _mm512_set1_epi32(offset)));
+        result += __builtin_popcount(mask);
+      }
+    }
+  }
+  return result - indices;
+}
+
+#endif
+
+} // namespace facebook::velox::simd::detail
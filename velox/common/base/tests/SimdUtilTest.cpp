@@ -19,6 +19,8 @@
 
 #include <gtest/gtest.h>
 
+DECLARE_bool(avx512);
+
 using namespace facebook::velox;
 
 namespace {
@@ -127,6 +129,39 @@ TEST_F(SimdUtilTest, bitIndices) {
   testIndices(999);
 }
 
+#ifdef __x86_64__
+TEST_F(SimdUtilTest, bitIndicesAvx512) {
+  if (!process::hasAvx512()) {
+    GTEST_SKIP() << "No AVX-512";
+  }
+  std::vector<uint64_t> bits(20);
+  randomBits(bits, 300);
+  std::vector<int32_t> reference(bits.size() * 64);
+  std::vector<int32_t> test(bits.size() * 64);
+  for (auto begin = 0; begin < 130; begin += 7) {
+    for (auto end = begin; end < bits.size() * 64; end += 61) {
+      auto numReference =
+          simpleIndicesOfSetBits(bits.data(), begin, end, reference.data());
+      auto numTest = simd::detail::indicesOfSetBitsAvx512(
+          bits.data(), begin, end, test.data());
+      ASSERT_EQ(numReference, numTest);
+      ASSERT_EQ(
+          memcmp(
+              reference.data(),
+              test.data(),
+              numReference * sizeof(reference[0])),
+          0);
+    }
+  }
+
+  // Checks the path without AVX-512 for large ranges on this machine.
+  gflags::FlagSaver flagSaver;
+  FLAGS_avx512 = false;
+  testIndices(10);
+  testIndices(500);
+}
+#endif
+
 TEST_F(SimdUtilTest, gather32) {
   int32_t indices8[8] = {7, 6, 5, 4, 3, 2, 1, 0};
   int32_t indices6[8] = {7, 6, 5, 4, 3, 2, 1 << 31, 1 << 31};
@@ -15,6 +15,7 @@
  */
 
 #include "velox/common/base/StatsReporter.h"
+#include "velox/common/base/Counters.h"
 #include <folly/Singleton.h>
 #include <folly/init/Init.h>
 #include <gtest/gtest.h>
@@ -121,6 +122,26 @@ TEST_F(StatsReporterTest, trivialReporter) {
   EXPECT_EQ(100, reporter->counterMap["key4"]);
 };
 
+TEST_F(StatsReporterTest, operatorCounters) {
+  auto reporter = std::dynamic_pointer_cast<TestReporter>(
+      folly::Singleton<BaseStatsReporter>::try_get());
+
+  registerOperatorCounters("HashBuild");
+  registerOperatorCounters("HashBuild");
+  const auto key =
+      operatorCounterKey("HashBuild", kCounterOperatorGetOutputLatencyUs);
+  EXPECT_EQ("velox.operator.HashBuild.get_output_latency_us", key);
+  std::vector<int32_t> expected = {50, 90, 99, 100};
+  EXPECT_EQ(expected, reporter->histogramPercentilesMap[key]);
+  EXPECT_EQ(
+      expected,
+      reporter->histogramPercentilesMap[operatorCounterKey(
+          "HashBuild", kCounterOperatorIoWaitUs)]);
+
+  REPORT_ADD_HISTOGRAM_VALUE(key, 150);
+  EXPECT_EQ(150, reporter->counterMap[key]);
+}
+
 // Registering to folly Singleton with intended reporter type
 folly::Singleton<BaseStatsReporter> reporter([]() {
   return new TestReporter();
@@ -17,6 +17,7 @@
 #include "velox/common/caching/AsyncDataCache.h"
 #include <velox/common/base/BitUtil.h>
 #include "velox/common/caching/FileIds.h"
+#include "velox/common/caching/PeerCache.h"
 #include "velox/common/caching/SsdCache.h"
 
 #include <folly/executors/QueuedImmediateExecutor.h>
@@ -40,7 +41,7 @@ void AsyncDataCacheEntry::setExclusiveToShared() {
   numPins_ = 1;
   std::unique_ptr<folly::SharedPromise<bool>> promise;
   {
-    std::lock_guard<std::mutex> l(shard_->mutex());
+    std::lock_guard<std::shared_mutex> l(shard_->mutex());
     // Enter the shard's mutex to make sure a promise is not being added during
     // the move.
     promise = std::move(promise_);
@@ -59,7 +60,8 @@ void AsyncDataCacheEntry::setExclusiveToShared() {
   if ((ssdFile_ == nullptr) && (shard_->cache()->ssdCache() != nullptr)) {
     auto* ssdCache = shard_->cache()->ssdCache();
     assert(ssdCache); // for lint only.
-    if (ssdCache->groupStats().shouldSaveToSsd(groupId_, trackingId_)) {
+    if (shard_->cache()->savesToSsd(partition_) &&
+        ssdCache->groupStats().shouldSaveToSsd(groupId_, trackingId_)) {
       ssdSaveable_ = true;
       shard_->cache()->possibleSsdSave(size_);
     }
@@ -137,6 +139,37 @@ std::string AsyncDataCacheEntry::toString() const {
       numPins_);
 }
 
+TinyLfuAdmission::TinyLfuAdmission(int32_t numCounters, int32_t minFrequency)
+    : mask_(bits::nextPowerOfTwo(numCounters) - 1),
+      minFrequency_(minFrequency),
+      sampleSize_(10 * (mask_ + 1ULL)),
+      counters_(mask_ + 1ULL, 0) {
+  VELOX_CHECK_GT(numCounters, 0);
+  VELOX_CHECK_LE(minFrequency, kMaxCount);
+}
+
+void TinyLfuAdmission::recordAccess(RawFileCacheKey key) {
+  forEachCounter(key, [&](uint32_t index) {
+    if (counters_[index] < kMaxCount) {
+      ++counters_[index];
+    }
+  });
+  if (++numAccesses_ >= sampleSize_) {
+    for (auto& counter : counters_) {
+      counter >>= 1;
+    }
+    numAccesses_ /= 2;
+  }
+}
+
+int32_t TinyLfuAdmission::frequency(RawFileCacheKey key) const {
+  int32_t result = kMaxCount;
+  forEachCounter(key, [&](uint32_t index) {
+    result = std::min<int32_t>(result, counters_[index]);
+  });
+  return result;
+}
+
 std::unique_ptr<AsyncDataCacheEntry> CacheShard::getFreeEntry() {
   std::unique_ptr<AsyncDataCacheEntry> newEntry;
   if (freeEntries_.empty()) {
@@ -151,11 +184,19 @@ std::unique_ptr<AsyncDataCacheEntry> CacheShard::getFreeEntry() {
 CachePin CacheShard::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
-    folly::SemiFuture<bool>* wait) {
+    folly::SemiFuture<bool>* wait,
+    int32_t partition) {
+  auto sharedPin = findShared(key, size, partition);
+  if (!sharedPin.empty()) {
+    return sharedPin;
+  }
   AsyncDataCacheEntry* entryToInit = nullptr;
   {
-    std::lock_guard<std::mutex> l(mutex_);
+    std::lock_guard<std::shared_mutex> l(mutex_);
     ++eventCounter_;
+    if (admissionPolicy_ != nullptr) {
+      admissionPolicy_->recordAccess(key);
+    }
     auto it = entryMap_.find(key);
     if (it != entryMap_.end()) {
       auto* found = it->second;
@@ -176,6 +217,11 @@ CachePin CacheShard::findOrCreate(
         } else {
           ++numHit_;
           hitBytes_ += found->size();
+          if (auto* state = cache_->partitionState(partition)) {
+            ++state->numHit;
+            state->hitBytes += found->size();
+          }
+          protectLocked(found);
         }
         ++found->numPins_;
         CachePin pin;
@@ -192,6 +238,11 @@ CachePin CacheShard::findOrCreate(
           << " requested size " << size;
       // The old entry is superseded. Possible readers of the old entry still
       // retain a valid read pin.
+      unprotectLocked(found);
+      cachedBytes_ -= found->size_;
+      if (auto* state = cache_->partitionState(found->partition_)) {
+        state->cachedBytes -= found->size_;
+      }
       found->key_.fileNum.clear();
     }
 
@@ -213,12 +264,61 @@ CachePin CacheShard::findOrCreate(
     VELOX_CHECK_EQ(entryToInit->size_, 0);
     entryToInit->size_ = size;
     entryToInit->isFirstUse_ = true;
+    entryToInit->partition_ = partition;
+    cachedBytes_ += size;
+    if (auto* state = cache_->partitionState(partition)) {
+      ++state->numNew;
+      state->cachedBytes += size;
+    }
+    // A reused entry must not inherit the access history of its previous
+    // contents.
+    entryToInit->accessStats_.reset();
+    if (admissionPolicy_ != nullptr && !admissionPolicy_->admit(key, size)) {
+      ++numRejected_;
+      entryToInit->makeEvictable();
+    }
   }
   return initEntry(key, entryToInit);
 }
 
+CachePin CacheShard::findShared(
+    RawFileCacheKey key,
+    uint64_t size,
+    int32_t partition) {
+  std::shared_lock<std::shared_mutex> l(mutex_);
+  // The admission policy records every lookup and is not thread-safe.
+  if (admissionPolicy_ != nullptr) {
+    return CachePin();
+  }
+  auto it = entryMap_.find(key);
+  if (it == entryMap_.end()) {
+    return CachePin();
+  }
+  auto* found = it->second;
+  // Waiting for an exclusive entry, the first hit on a prefetched entry and
+  // moving an entry to the protected segment all need the exclusive mutex.
+  if (found->isExclusive() || found->size() < size || found->isPrefetch() ||
+      (protectedPct_ > 0 && !found->isProtected_)) {
+    return CachePin();
+  }
+  ++eventCounter_;
+  found->touch();
+  ++numHit_;
+  hitBytes_ += found->size();
+  if (auto* state = cache_->partitionState(partition)) {
+    ++state->numHit;
+    state->hitBytes += found->size();
+  }
+  // Eviction frees only unpinned entries and runs under the exclusive mutex,
+  // so 'found' stays valid after this.
+  ++found->numPins_;
+  CachePin pin;
+  pin.setEntry(found);
+  return pin;
+}
+
 bool CacheShard::exists(RawFileCacheKey key) const {
-  std::lock_guard<std::mutex> l(mutex_);
+  std::shared_lock<std::shared_mutex> l(mutex_);
   auto it = entryMap_.find(key);
   if (it != entryMap_.end()) {
     it->second->touch();
@@ -227,6 +327,23 @@ bool CacheShard::exists(RawFileCacheKey key) const {
   return false;
 }
 
+CachePin CacheShard::find(RawFileCacheKey key, uint64_t size) {
+  std::shared_lock<std::shared_mutex> l(mutex_);
+  auto it = entryMap_.find(key);
+  if (it == entryMap_.end()) {
+    return CachePin();
+  }
+  auto* found = it->second;
+  if (found->isExclusive() || found->size() < size) {
+    return CachePin();
+  }
+  found->touch();
+  ++found->numPins_;
+  CachePin pin;
+  pin.setEntry(found);
+  return pin;
+}
+
 CachePin CacheShard::initEntry(
     RawFileCacheKey key,
     AsyncDataCacheEntry* entry) {
@@ -300,7 +417,7 @@ void CoalescedLoad::setEndState(State endState) {
 
 std::unique_ptr<folly::SharedPromise<bool>> CacheShard::removeEntry(
     AsyncDataCacheEntry* entry) {
-  std::lock_guard<std::mutex> l(mutex_);
+  std::lock_guard<std::shared_mutex> l(mutex_);
   removeEntryLocked(entry);
   // After the entry is removed from the hash table, a promise can no longer
   // be made. It is safe to move the promise and realize it.
@@ -315,6 +432,11 @@ void CacheShard::removeEntryLocked(AsyncDataCacheEntry* entry) {
       RawFileCacheKey{entry->key_.fileNum.id(), entry->key_.offset});
   VELOX_CHECK(it != entryMap_.end());
   entryMap_.erase(it);
+  unprotectLocked(entry);
+  cachedBytes_ -= entry->size_;
+  if (auto* state = cache_->partitionState(entry->partition_)) {
+    state->cachedBytes -= entry->size_;
+  }
   entry->key_.fileNum.clear();
   entry->setSsdFile(nullptr, 0);
   if (entry->isPrefetch()) {
@@ -331,7 +453,17 @@ void CacheShard::removeEntryLocked(AsyncDataCacheEntry* entry) {
   }
 }
 
-void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
+void CacheShard::evict(
+    uint64_t bytesToFree,
+    bool evictAllUnpinned,
+    int32_t partition) {
+  const bool onlyPartition = partition != kAnyPartition;
+  // Entries of 'partition' are evicted regardless of protection and score.
+  const bool evictAny = evictAllUnpinned || onlyPartition;
+  // Set while a partition is over its quota. Entries of partitions within
+  // their quotas are then skipped.
+  bool enforceQuotas = !evictAny && cache_->hasPartitions() &&
+      cache_->anyPartitionOverQuota();
   int64_t tinyFreed = 0;
   int64_t largeFreed = 0;
   int32_t evictSaveableSkipped = 0;
@@ -340,7 +472,7 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
   auto now = accessTime();
   std::vector<memory::Allocation> toFree;
   {
-    std::lock_guard<std::mutex> l(mutex_);
+    std::lock_guard<std::shared_mutex> l(mutex_);
     int size = entries_.size();
     if (!size) {
       return;
@@ -361,6 +493,15 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
       if (!candidate) {
         continue;
       }
+      if (onlyPartition && candidate->partition_ != partition) {
+        continue;
+      }
+      if (enforceQuotas && !cache_->overQuota(candidate->partition_)) {
+        if (cache_->anyPartitionOverQuota()) {
+          continue;
+        }
+        enforceQuotas = false;
+      }
       ++numChecked;
       ++clockHand_;
       if (evictionThreshold_ == kNoThreshold ||
@@ -371,11 +512,23 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
         numChecked = 0;
         eventCounter_ = 0;
       }
+      if (candidate->isProtected_ && !evictAny) {
+        // Protected entries are only evicted in an emergency. If the
+        // protected segment is over its share, the clock hand demotes the
+        // entries it passes to probation.
+        if (protectedFullLocked()) {
+          unprotectLocked(candidate);
+        }
+        continue;
+      }
+      // With segmented eviction, all unpinned probation entries are
+      // evictable except unused prefetches, which follow the score.
+      const bool probation = protectedPct_ > 0 && !candidate->isPrefetch_;
       int32_t score = 0;
       if (candidate->numPins_ == 0 &&
-          (!candidate->key_.fileNum.hasValue() || evictAllUnpinned ||
+          (!candidate->key_.fileNum.hasValue() || evictAny || probation ||
            (score = candidate->score(now)) >= evictionThreshold_)) {
-        if (skipSsdSaveable && candidate->ssdSaveable_ && !evictAllUnpinned) {
+        if (skipSsdSaveable && candidate->ssdSaveable_ && !evictAny) {
           ++evictSaveableSkipped;
           continue;
         }
@@ -387,6 +540,9 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
         candidate->tinyData_.clear();
         candidate->tinyData_.shrink_to_fit();
         candidate->size_ = 0;
+        if (auto* state = cache_->partitionState(candidate->partition_)) {
+          ++state->numEvict;
+        }
         tryAddFreeEntry(std::move(*iter));
         ++numEvict_;
         if (score) {
@@ -413,6 +569,42 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
   }
 }
 
+void CacheShard::protectLocked(AsyncDataCacheEntry* entry) {
+  if (protectedPct_ == 0 || entry->isProtected_) {
+    return;
+  }
+  entry->isProtected_ = true;
+  protectedBytes_ += entry->size_;
+}
+
+void CacheShard::unprotectLocked(AsyncDataCacheEntry* entry) {
+  if (!entry->isProtected_) {
+    return;
+  }
+  entry->isProtected_ = false;
+  protectedBytes_ -= entry->size_;
+}
+
+void CacheShard::setAdmissionPolicy(
+    std::unique_ptr<CacheAdmissionPolicy> policy) {
+  std::lock_guard<std::shared_mutex> l(mutex_);
+  admissionPolicy_ = std::move(policy);
+}
+
+void CacheShard::setProtectedPct(int32_t protectedPct) {
+  VELOX_CHECK_GE(protectedPct, 0);
+  VELOX_CHECK_LT(protectedPct, 100);
+  std::lock_guard<std::shared_mutex> l(mutex_);
+  protectedPct_ = protectedPct;
+  if (protectedPct_ == 0) {
+    for (auto& entry : entries_) {
+      if (entry != nullptr) {
+        unprotectLocked(entry.get());
+      }
+    }
+  }
+}
+
 void CacheShard::tryAddFreeEntry(std::unique_ptr<AsyncDataCacheEntry>&& entry) {
   freeEntries_.push_back(std::move(entry));
   // If we have too many free entries, we free up half of them to save space.
@@ -452,7 +644,7 @@ void CacheShard::calibrateThreshold() {
 }
 
 void CacheShard::updateStats(CacheStats& stats) {
-  std::lock_guard<std::mutex> l(mutex_);
+  std::lock_guard<std::shared_mutex> l(mutex_);
   for (auto& entry : entries_) {
     if (!entry || !entry->key_.fileNum.hasValue()) {
       ++stats.numEmptyEntries;
@@ -466,6 +658,9 @@ void CacheShard::updateStats(CacheStats& stats) {
       ++stats.numPrefetch;
       stats.prefetchBytes += entry->size();
     }
+    if (entry->isProtected_) {
+      ++stats.numProtected;
+    }
     ++stats.numEntries;
     stats.tinySize += entry->tinyData_.size();
     stats.tinyPadding += entry->tinyData_.capacity() - entry->tinyData_.size();
@@ -479,11 +674,13 @@ void CacheShard::updateStats(CacheStats& stats) {
   stats.numEvictChecks += numEvictChecks_;
   stats.numWaitExclusive += numWaitExclusive_;
   stats.sumEvictScore += sumEvictScore_;
+  stats.numRejected += numRejected_;
+  stats.protectedBytes += protectedBytes_;
   stats.allocClocks += allocClocks_;
 }
 
 void CacheShard::appendSsdSaveable(std::vector<CachePin>& pins) {
-  std::lock_guard<std::mutex> l(mutex_);
+  std::lock_guard<std::shared_mutex> l(mutex_);
   // Do not add more than 70% of entries to a write batch.If SSD save
   // is slower than storage read, we must not have a situation where
   // SSD save pins everything and stops reading.
@@ -512,6 +709,8 @@ AsyncDataCache::AsyncDataCache(
   for (auto i = 0; i < kNumShards; ++i) {
     shards_.push_back(std::make_unique<CacheShard>(this));
   }
+  partitions_.push_back(std::make_unique<Partition>(
+      CachePartitionConfig{.name = "default"}));
 }
 
 AsyncDataCache::~AsyncDataCache() {}
@@ -562,9 +761,63 @@ void CacheShard::shutdown() {
 CachePin AsyncDataCache::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
-    folly::SemiFuture<bool>* wait) {
+    folly::SemiFuture<bool>* wait,
+    int32_t partition) {
+  VELOX_DCHECK_LT(partition, partitions_.size());
   const int shard = std::hash<RawFileCacheKey>()(key) & (kShardMask);
-  return shards_[shard]->findOrCreate(key, size, wait);
+  auto pin = shards_[shard]->findOrCreate(key, size, wait, partition);
+  if (!pin.empty() && pin.checkedEntry()->isExclusive()) {
+    // The new entry is pinned and is not evicted to make room for itself.
+    evictToQuota(partition);
+  }
+  return pin;
+}
+
+int32_t AsyncDataCache::addPartition(CachePartitionConfig config) {
+  VELOX_CHECK(!config.name.empty(), "Cache partition must have a name");
+  for (const auto& partition : partitions_) {
+    VELOX_CHECK_NE(
+        partition->config.name,
+        config.name,
+        "Duplicate cache partition {}",
+        config.name);
+  }
+  VELOX_CHECK_LT(
+      partitions_.size(), kMaxCachePartitions, "Too many cache partitions");
+  partitions_.push_back(std::make_unique<Partition>(std::move(config)));
+  return partitions_.size() - 1;
+}
+
+int32_t AsyncDataCache::partitionId(std::string_view name) const {
+  for (auto i = 0; i < partitions_.size(); ++i) {
+    if (partitions_[i]->config.name == name) {
+      return i;
+    }
+  }
+  return kDefaultCachePartition;
+}
+
+bool AsyncDataCache::anyPartitionOverQuota() const {
+  for (auto i = 0; i < partitions_.size(); ++i) {
+    if (overQuota(i)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AsyncDataCache::evictToQuota(int32_t partition) {
+  const auto* state = partitionState(partition);
+  if (state == nullptr || partition == kDefaultCachePartition ||
+      state->config.canBorrow) {
+    return;
+  }
+  for (auto i = 0; i < kNumShards && overQuota(partition); ++i) {
+    shards_[(++shardCounter_) & (kShardMask)]->evict(
+        state->cachedBytes - state->config.quotaBytes,
+        false,
+        partition);
+  }
 }
 
 bool AsyncDataCache::exists(RawFileCacheKey key) const {
@@ -572,6 +825,15 @@ bool AsyncDataCache::exists(RawFileCacheKey key) const {
   return shards_[shard]->exists(key);
 }
 
+void AsyncDataCache::setPeerCache(std::unique_ptr<PeerCache> peerCache) {
+  peerCache_ = std::move(peerCache);
+}
+
+CachePin AsyncDataCache::find(RawFileCacheKey key, uint64_t size) {
+  const int shard = std::hash<RawFileCacheKey>()(key) & (kShardMask);
+  return shards_[shard]->find(key, size);
+}
+
 bool AsyncDataCache::makeSpace(
     MachinePageCount numPages,
     std::function<bool()> allocate) {
@@ -708,9 +970,35 @@ CacheStats AsyncDataCache::refreshStats() const {
   if (ssdCache_ != nullptr) {
     stats.ssdStats = std::make_shared<SsdCacheStats>(ssdCache_->stats());
   }
+  if (hasPartitions()) {
+    for (const auto& partition : partitions_) {
+      CachePartitionStats partitionStats;
+      partitionStats.name = partition->config.name;
+      partitionStats.quotaBytes = partition->config.quotaBytes;
+      partitionStats.cachedBytes = partition->cachedBytes;
+      partitionStats.numHit = partition->numHit;
+      partitionStats.hitBytes = partition->hitBytes;
+      partitionStats.numNew = partition->numNew;
+      partitionStats.numEvict = partition->numEvict;
+      stats.partitions.push_back(std::move(partitionStats));
+    }
+  }
   return stats;
 }
 
+void AsyncDataCache::setAdmissionPolicy(
+    std::function<std::unique_ptr<CacheAdmissionPolicy>()> factory) {
+  for (auto& shard : shards_) {
+    shard->setAdmissionPolicy(factory ? factory() : nullptr);
+  }
+}
+
+void AsyncDataCache::setProtectedPct(int32_t protectedPct) {
+  for (auto& shard : shards_) {
+    shard->setProtectedPct(protectedPct);
+  }
+}
+
 void AsyncDataCache::clear() {
   for (auto& shard : shards_) {
     shard->evict(std::numeric_limits<int32_t>::max(), true);
@@ -731,6 +1019,11 @@ std::string AsyncDataCache::toString() const {
       << " Alloc Megaclocks " << (stats.allocClocks >> 20)
       << " allocated pages " << allocator_->numAllocated() << " cached pages "
       << cachedPages_;
+  for (const auto& partition : stats.partitions) {
+    out << "\nPartition " << partition.name << ": " << partition.cachedBytes
+        << " / " << partition.quotaBytes << " bytes Miss: " << partition.numNew
+        << " Hit " << partition.numHit << " evict " << partition.numEvict;
+  }
   out << "\nBacking: " << allocator_->toString();
   if (ssdCache_) {
     out << "\nSSD: " << ssdCache_->toString();
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <deque>
+#include <shared_mutex>
 
 #include <fmt/format.h>
 #include <folly/chrono/Hardware.h>
@@ -41,6 +42,7 @@ namespace facebook::velox::cache {
 
 class AsyncDataCache;
 class CacheShard;
+class PeerCache;
 class SsdCache;
 class SsdCacheStats;
 class SsdFile;
@@ -60,8 +62,10 @@ inline AccessTime accessTime() {
 }
 
 struct AccessStats {
-  AccessTime lastUse{0};
-  int32_t numUses{0};
+  // touch() may run concurrently from lookups that hold the shard mutex in
+  // shared mode. Lost updates are harmless, the stats are only a hint.
+  tsan_atomic<AccessTime> lastUse{0};
+  tsan_atomic<int32_t> numUses{0};
 
   // Retention score. A higher number means less worth retaining. This
   // works well with a typical formula of time over use count going to
@@ -245,6 +249,16 @@ class AsyncDataCacheEntry {
     groupId_ = groupId;
   }
 
+  uint64_t groupId() const {
+    return groupId_;
+  }
+
+  /// Returns the id of the cache partition that holds 'this'. See
+  /// AsyncDataCache::addPartition().
+  int32_t partition() const {
+    return partition_;
+  }
+
   /// Sets access stats so that this is immediately evictable.
   void makeEvictable();
 
@@ -285,11 +299,16 @@ class AsyncDataCacheEntry {
   std::unique_ptr<folly::SharedPromise<bool>> promise_;
   int32_t size_{0};
 
-  // Setting this from 0 to 1 or to kExclusive requires owning shard_->mutex_.
+  // Setting this from 0 to 1 requires owning shard_->mutex_ at least in shared
+  // mode. Setting this to kExclusive requires owning it in exclusive mode.
   std::atomic<int32_t> numPins_{0};
 
   AccessStats accessStats_;
 
+  // True if 'this' has been hit after the read that created it and is in the
+  // protected segment of its shard. Set and cleared under the shard mutex.
+  bool isProtected_{false};
+
   // True if 'this' is speculatively loaded. This is reset on first
   // hit. Allows catching a situation where prefetched entries get
   // evicted before they are hit.
@@ -319,6 +338,9 @@ class AsyncDataCacheEntry {
   // True if this should be saved to SSD.
   std::atomic<bool> ssdSaveable_{false};
 
+  // The cache partition of 'this'. Set with the key under the shard mutex.
+  uint8_t partition_{0};
+
   friend class CacheShard;
   friend class CachePin;
 };
@@ -465,6 +487,106 @@ class CoalescedLoad {
   std::vector<int32_t> sizes_;
 };
 
+/// Decides if a new cache entry is worth retaining after the read that
+/// creates it. An entry that is not admitted is still created and filled for
+/// that read but is marked evictable, so it is the first to go unless it is
+/// hit again before that. Each CacheShard has its own instance, which is
+/// called under the shard mutex.
+class CacheAdmissionPolicy {
+ public:
+  virtual ~CacheAdmissionPolicy() = default;
+
+  /// Records a lookup of 'key', hit or miss.
+  virtual void recordAccess(RawFileCacheKey key) = 0;
+
+  /// Returns true if a new entry of 'size' bytes for 'key' is to be retained.
+  virtual bool admit(RawFileCacheKey key, uint64_t size) = 0;
+};
+
+/// TinyLFU style admission. Admits a new entry if its key has been looked up
+/// at least 'minFrequency' times recently, including the miss that creates
+/// it. The frequencies are kept in a count-min sketch of saturating 4 bit
+/// counters that are all halved after 10 lookups per counter, so that old
+/// popularity fades. A scan that reads each key once is not admitted, so it
+/// does not flush the repeatedly read working set.
+class TinyLfuAdmission : public CacheAdmissionPolicy {
+ public:
+  /// 'numCounters' is rounded up to a power of 2.
+  explicit TinyLfuAdmission(
+      int32_t numCounters = 1 << 16,
+      int32_t minFrequency = 2);
+
+  void recordAccess(RawFileCacheKey key) override;
+
+  bool admit(RawFileCacheKey key, uint64_t /*size*/) override {
+    return frequency(key) >= minFrequency_;
+  }
+
+  /// Returns the estimated recent number of lookups of 'key'.
+  int32_t frequency(RawFileCacheKey key) const;
+
+ private:
+  static constexpr int32_t kNumHashes = 4;
+  static constexpr uint8_t kMaxCount = 15;
+
+  template <typename Func>
+  void forEachCounter(RawFileCacheKey key, Func func) const {
+    const uint64_t hash = std::hash<RawFileCacheKey>()(key);
+    const uint32_t step = (hash >> 32) | 1;
+    for (auto i = 0; i < kNumHashes; ++i) {
+      func((static_cast<uint32_t>(hash) + i * step) & mask_);
+    }
+  }
+
+  const uint32_t mask_;
+  const int32_t minFrequency_;
+  // Number of lookups after which all counters are halved.
+  const uint64_t sampleSize_;
+  std::vector<uint8_t> counters_;
+  uint64_t numAccesses_{0};
+};
+
+/// Id of the cache partition of the entries created without naming one. See
+/// AsyncDataCache::addPartition().
+constexpr int32_t kDefaultCachePartition = 0;
+
+/// Maximum number of cache partitions including the default one.
+constexpr int32_t kMaxCachePartitions = 256;
+
+/// A named share of the capacity of an AsyncDataCache, e.g. for one tenant.
+struct CachePartitionConfig {
+  std::string name;
+
+  /// Bytes of cached data that eviction leaves to the partition while other
+  /// partitions are over their quotas.
+  uint64_t quotaBytes{0};
+
+  /// If true, the partition may grow past 'quotaBytes' into capacity that the
+  /// other partitions do not use. Its bytes over the quota are then evicted
+  /// first. If false, the partition never grows past 'quotaBytes' and its new
+  /// entries evict its own older entries.
+  bool canBorrow{true};
+
+  /// If false, the entries of the partition are not written to the SSD cache.
+  bool saveToSsd{true};
+};
+
+/// Stats of one cache partition. See CacheStats::partitions.
+struct CachePartitionStats {
+  std::string name;
+  uint64_t quotaBytes{};
+  // Total size of the entries of the partition.
+  int64_t cachedBytes{};
+  // Number of hits by readers of the partition.
+  int64_t numHit{};
+  // Sum of sizes of entries counted in 'numHit'.
+  int64_t hitBytes{};
+  // Number of new entries created in the partition.
+  int64_t numNew{};
+  // Number of entries of the partition evicted to make space.
+  int64_t numEvict{};
+};
+
 // Struct for CacheShard stats. Stats from all shards are added into
 // this struct to provide a snapshot of state.
 struct CacheStats {
@@ -509,8 +631,24 @@ struct CacheStats {
   // Sum of scores of evicted entries. This serves to infer an average
   // lifetime for entries in cache.
   int64_t sumEvictScore{};
+  // Number of new entries that the admission policy did not admit.
+  int64_t numRejected{};
+  // Number of entries in the protected segment.
+  int32_t numProtected{};
+  // Total size of entries in the protected segment.
+  int64_t protectedBytes{};
+
+  // Returns the fraction of lookups that were hits.
+  double hitRate() const {
+    return numHit + numNew == 0
+        ? 0
+        : static_cast<double>(numHit) / (numHit + numNew);
+  }
 
   std::shared_ptr<SsdCacheStats> ssdStats = nullptr;
+
+  // Stats of each cache partition by id. Empty if no partitions are added.
+  std::vector<CachePartitionStats> partitions;
 };
 
 /// Collection of cache entries whose key hashes to the same shard of
@@ -519,22 +657,30 @@ struct CacheStats {
 /// and other housekeeping.
 class CacheShard {
  public:
+  /// Value of the 'partition' argument of evict() for evicting entries of
+  /// any partition.
+  static constexpr int32_t kAnyPartition = -1;
+
   explicit CacheShard(AsyncDataCache* cache) : cache_(cache) {}
 
   /// See AsyncDataCache::findOrCreate.
   CachePin findOrCreate(
       RawFileCacheKey key,
       uint64_t size,
-      folly::SemiFuture<bool>* readyFuture);
+      folly::SemiFuture<bool>* readyFuture,
+      int32_t partition = kDefaultCachePartition);
 
   /// Returns true if there is an entry for 'key'. Updates access time.
   bool exists(RawFileCacheKey key) const;
 
+  /// See AsyncDataCache::find.
+  CachePin find(RawFileCacheKey key, uint64_t size);
+
   AsyncDataCache* cache() const {
     return cache_;
   }
 
-  std::mutex& mutex() {
+  std::shared_mutex& mutex() {
     return mutex_;
   }
 
@@ -546,8 +692,14 @@ class CacheShard {
   // not pinned. This favors first removing older and less frequently
   // used entries. If 'evictAllUnpinned' is true, anything that is
   // not pinned is evicted at first sight. This is for out of memory
-  // emergencies.
-  void evict(uint64_t bytesToFree, bool evictAllUnpinned);
+  // emergencies. While a cache partition is over its quota, entries of
+  // partitions within their quotas are only evicted in an emergency. If
+  // 'partition' is set, only unpinned entries of 'partition' are evicted, in
+  // clock order.
+  void evict(
+      uint64_t bytesToFree,
+      bool evictAllUnpinned,
+      int32_t partition = kAnyPartition);
 
   // Removes 'entry' from 'this'. Removes a possible promise from the entry
   // inside the shard mutex and returns it so that it can be realized outside of
@@ -569,14 +721,42 @@ class CacheShard {
     return allocClocks_;
   }
 
+  /// Sets the admission policy for new entries. nullptr admits all.
+  void setAdmissionPolicy(std::unique_ptr<CacheAdmissionPolicy> policy);
+
+  /// Enables segmented eviction if 'protectedPct' is > 0. Entries that are
+  /// hit after the read that created them move from the probation to the
+  /// protected segment. Eviction takes unpinned probation entries first and
+  /// protected entries only in an emergency. When the protected segment
+  /// exceeds 'protectedPct' of the cached bytes, eviction demotes protected
+  /// entries back to probation in clock order.
+  void setProtectedPct(int32_t protectedPct);
+
  private:
   static constexpr uint32_t kMaxFreeEntries = 1 << 10;
   static constexpr int32_t kNoThreshold = std::numeric_limits<int32_t>::max();
 
   void calibrateThreshold();
 
+  // Returns a shared pin on the entry for 'key' if it is readable and has at
+  // least 'size' bytes and the hit does not change the state of the shard.
+  // Holds 'mutex_' in shared mode, so that concurrent hits do not serialize.
+  // Returns an empty pin if findOrCreate() must take the exclusive path.
+  CachePin findShared(RawFileCacheKey key, uint64_t size, int32_t partition);
+
   void removeEntryLocked(AsyncDataCacheEntry* entry);
 
+  // Moves 'entry' from the probation to the protected segment.
+  void protectLocked(AsyncDataCacheEntry* entry);
+
+  // Moves 'entry' back to probation if protected.
+  void unprotectLocked(AsyncDataCacheEntry* entry);
+
+  // Returns true if the protected segment is over its share.
+  bool protectedFullLocked() const {
+    return protectedBytes_ * 100 > cachedBytes_ * protectedPct_;
+  }
+
   // Returns an unused entry if found.
   //
   // TODO: consider to pass a size hint so as to select the a free entry which
@@ -591,7 +771,9 @@ class CacheShard {
 
   AsyncDataCache* const cache_;
 
-  mutable std::mutex mutex_;
+  // Held in shared mode for lookups of existing entries and in exclusive mode
+  // for anything that changes the entries or the segments.
+  mutable std::shared_mutex mutex_;
   folly::F14FastMap<RawFileCacheKey, AsyncDataCacheEntry*> entryMap_;
   // Entries associated to a key.
   std::deque<std::unique_ptr<AsyncDataCacheEntry>> entries_;
@@ -604,13 +786,13 @@ class CacheShard {
   // Index in 'entries_' for the next eviction candidate.
   uint32_t clockHand_{};
   // Number of gets since last stats sampling.
-  uint32_t eventCounter_{};
+  std::atomic<uint32_t> eventCounter_{};
   // Maximum retainable entry score(). Anything above this is evictable.
   int32_t evictionThreshold_{kNoThreshold};
   // Cumulative count of cache hits.
-  uint64_t numHit_{};
+  std::atomic<uint64_t> numHit_{};
   // Sum of bytes in cache hits.
-  uint64_t hitBytes_{};
+  std::atomic<uint64_t> hitBytes_{};
   // Cumulative count of hits on entries held in exclusive mode.
   uint64_t numWaitExclusive_{};
   // Cumulative count of new entry creation.
@@ -623,6 +805,17 @@ class CacheShard {
   // Sum of evict scores. This divided by 'numEvict_' correlates to
   // time data stays in cache.
   uint64_t sumEvictScore_{};
+  // Decides which new entries are retained. Admits all if nullptr.
+  std::unique_ptr<CacheAdmissionPolicy> admissionPolicy_;
+  // Count of new entries not admitted by 'admissionPolicy_'.
+  uint64_t numRejected_{};
+  // Share of 'cachedBytes_' for protected entries in percent. 0 disables
+  // segmented eviction.
+  int32_t protectedPct_{0};
+  // Total size of the entries associated to a key.
+  uint64_t cachedBytes_{};
+  // Total size of the entries with 'isProtected_'.
+  uint64_t protectedBytes_{};
   // Tracker of time spent in allocating/freeing MemoryAllocator space
   // for backing cached data.
   std::atomic<uint64_t> allocClocks_;
@@ -679,14 +872,41 @@ class AsyncDataCache : public memory::Cache {
   /// the future is realized, the caller may retry findOrCreate().
   /// runtime error with code kNoCacheSpace if there is no space to create the
   /// new entry after evicting any unpinned content.
+  ///
+  /// A new entry is created in 'partition' and a hit is counted for
+  /// 'partition'. If 'partition' may not borrow, a new entry evicts older
+  /// entries of 'partition' to keep it within its quota.
   CachePin findOrCreate(
       RawFileCacheKey key,
       uint64_t size,
-      folly::SemiFuture<bool>* waitFuture = nullptr);
+      folly::SemiFuture<bool>* waitFuture = nullptr,
+      int32_t partition = kDefaultCachePartition);
 
   /// Returns true if there is an entry for 'key'. Updates access time.
   bool exists(RawFileCacheKey key) const;
 
+  /// Adds a named partition of the cache capacity and returns its id for
+  /// findOrCreate(). Eviction takes entries from partitions over their quotas
+  /// first, so that the working set of one partition is not evicted by the
+  /// scans of another. The entries created without a partition are in the
+  /// partition named "default", whose quota is 0. Must be called before the
+  /// cache is used.
+  int32_t addPartition(CachePartitionConfig config);
+
+  /// Returns the id of the partition named 'name' or kDefaultCachePartition if
+  /// there is none.
+  int32_t partitionId(std::string_view name) const;
+
+  /// Returns true if entries of 'partition' may be written to the SSD cache.
+  bool savesToSsd(int32_t partition) const {
+    return partitions_[partition]->config.saveToSsd;
+  }
+
+  /// Returns a shared pin on the entry for 'key' if it is readable and has at
+  /// least 'size' bytes, otherwise an empty pin. Does not create an entry and
+  /// does not count as a hit. Used for serving the cache to other processes.
+  CachePin find(RawFileCacheKey key, uint64_t size);
+
   CacheStats refreshStats() const;
 
   std::string toString() const;
@@ -705,6 +925,21 @@ class AsyncDataCache : public memory::Cache {
     return ssdCache_.get();
   }
 
+  /// Sets the peer tier that is asked for entries that miss the RAM and SSD
+  /// cache before reading from storage. Must be set before the cache is used.
+  void setPeerCache(std::unique_ptr<PeerCache> peerCache);
+
+  /// Returns the peer tier or nullptr if none.
+  PeerCache* peerCache() const {
+    return peerCache_.get();
+  }
+
+  /// Returns the stream access frequencies accumulated over the scans of all
+  /// queries that read through 'this'.
+  TrackingHistory& trackingHistory() {
+    return trackingHistory_;
+  }
+
   /// Updates stats for creation of a new cache entry of 'size' bytes,
   /// i.e. a cache miss. Periodically updates SSD admission criteria,
   /// i.e. reconsider criteria every half cache capacity worth of misses.
@@ -735,9 +970,10 @@ class AsyncDataCache : public memory::Cache {
   void makePins(
       const std::vector<RawFileCacheKey>& keys,
       SizeFunc sizeFunc,
-      ProcessPin processPin) {
+      ProcessPin processPin,
+      int32_t partition = kDefaultCachePartition) {
     for (auto i = 0; i < keys.size(); ++i) {
-      auto pin = findOrCreate(keys[i], sizeFunc(i), nullptr);
+      auto pin = findOrCreate(keys[i], sizeFunc(i), nullptr, partition);
       if (pin.empty() || pin.checkedEntry()->isShared()) {
         continue;
       }
@@ -755,18 +991,68 @@ class AsyncDataCache : public memory::Cache {
     return numSkippedSaves_;
   }
 
+  /// Gives each shard an admission policy made by 'factory'. See
+  /// CacheAdmissionPolicy.
+  void setAdmissionPolicy(
+      std::function<std::unique_ptr<CacheAdmissionPolicy>()> factory);
+
+  /// Enables segmented eviction in all shards. See
+  /// CacheShard::setProtectedPct().
+  void setProtectedPct(int32_t protectedPct);
+
  private:
   static constexpr int32_t kNumShards = 4; // Must be power of 2.
   static constexpr int32_t kShardMask = kNumShards - 1;
 
+  // The accounting of a cache partition. The counters are updated by the
+  // shards only if there are named partitions.
+  struct Partition {
+    explicit Partition(CachePartitionConfig _config)
+        : config(std::move(_config)) {}
+
+    const CachePartitionConfig config;
+    std::atomic<int64_t> cachedBytes{0};
+    std::atomic<int64_t> numHit{0};
+    std::atomic<int64_t> hitBytes{0};
+    std::atomic<int64_t> numNew{0};
+    std::atomic<int64_t> numEvict{0};
+  };
+
   static AsyncDataCache** getInstancePtr();
 
+  bool hasPartitions() const {
+    return partitions_.size() > 1;
+  }
+
+  // Returns the accounting of 'partition' or nullptr if there are no named
+  // partitions.
+  Partition* partitionState(int32_t partition) const {
+    return hasPartitions() ? partitions_[partition].get() : nullptr;
+  }
+
+  bool overQuota(int32_t partition) const {
+    const auto& state = *partitions_[partition];
+    return state.cachedBytes > static_cast<int64_t>(state.config.quotaBytes);
+  }
+
+  // Returns true if some partition holds more than its quota.
+  bool anyPartitionOverQuota() const;
+
+  // Evicts unpinned entries of 'partition' while it is over its quota if it
+  // may not borrow.
+  void evictToQuota(int32_t partition);
+
   // Waits a pseudorandom delay times 'counter'.
   void backoff(int32_t counter);
 
   memory::MemoryAllocator* const allocator_;
   std::unique_ptr<SsdCache> ssdCache_;
+  std::unique_ptr<PeerCache> peerCache_;
+
+  TrackingHistory trackingHistory_;
   std::vector<std::unique_ptr<CacheShard>> shards_;
+  // The partitions by id. The first is the default partition.
+  std::vector<std::unique_ptr<Partition>> partitions_;
   std::atomic<int32_t> shardCounter_{0};
   std::atomic<memory::MachinePageCount> cachedPages_{0};
   // Number of pages that are allocated and not yet loaded or loaded
@@ -798,6 +1084,8 @@ class AsyncDataCache : public memory::Cache {
   // Counter of threads competing for allocation in makeSpace(). Used
   // for setting staggered backoff. Mutexes are not allowed for this.
   std::atomic<int32_t> numThreadsInAllocate_{0};
+
+  friend class CacheShard;
 };
 
 // Samples a set of values T from 'numSamples' calls of
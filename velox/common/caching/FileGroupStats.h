@@ -16,7 +16,11 @@
 
 #pragma once
 
+#include <folly/container/F14Map.h>
+#include <shared_mutex>
+
 #include "velox/common/caching/ScanTracker.h"
+#include "velox/common/compression/Compression.h"
 
 namespace facebook::velox::cache {
 
@@ -58,6 +62,29 @@ class FileGroupStats {
   std::string toString(uint64_t /*cacheBytes*/) {
     return "<dummy FileGroupStats>";
   }
+
+  // Sets the compression of SSD cache entries of 'groupId'. Entries of
+  // groups without a setting are stored uncompressed.
+  void setSsdCompression(uint64_t groupId, common::CompressionKind kind) {
+    std::lock_guard<std::shared_mutex> l(mutex_);
+    if (kind == common::CompressionKind_NONE) {
+      ssdCompression_.erase(groupId);
+    } else {
+      ssdCompression_[groupId] = kind;
+    }
+  }
+
+  // Returns the compression of SSD cache entries of 'groupId'.
+  common::CompressionKind ssdCompression(uint64_t groupId) const {
+    std::shared_lock<std::shared_mutex> l(mutex_);
+    auto it = ssdCompression_.find(groupId);
+    return it == ssdCompression_.end() ? common::CompressionKind_NONE
+                                       : it->second;
+  }
+
+ private:
+  mutable std::shared_mutex mutex_;
+  folly::F14FastMap<uint64_t, common::CompressionKind> ssdCompression_;
 };
 
 } // namespace facebook::velox::cache
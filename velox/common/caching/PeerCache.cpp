@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/PeerCache.h"
+
+#include <folly/hash/Hash.h>
+
+#include "velox/common/caching/FileIds.h"
+
+namespace facebook::velox::cache {
+
+namespace {
+// Returns the ranges of the memory of 'entry' that hold its data.
+std::vector<folly::Range<char*>> entryRanges(AsyncDataCacheEntry& entry) {
+  std::vector<folly::Range<char*>> ranges;
+  const uint64_t size = entry.size();
+  auto& data = entry.data();
+  if (data.numPages() == 0) {
+    ranges.push_back(folly::Range<char*>(entry.tinyData(), size));
+    return ranges;
+  }
+  uint64_t offsetInRuns = 0;
+  for (int i = 0; i < data.numRuns() && offsetInRuns < size; ++i) {
+    const auto run = data.runAt(i);
+    const uint64_t bytes = std::min(run.numBytes(), size - offsetInRuns);
+    ranges.push_back(folly::Range<char*>(run.data<char>(), bytes));
+    offsetInRuns += bytes;
+  }
+  VELOX_CHECK_EQ(offsetInRuns, size);
+  return ranges;
+}
+} // namespace
+
+PeerCache::PeerCache(
+    std::vector<std::string> peers,
+    int32_t selfIndex,
+    uint64_t rangeBytes,
+    int32_t numVirtualNodes)
+    : peers_(std::move(peers)), selfIndex_(selfIndex), rangeBytes_(rangeBytes) {
+  VELOX_CHECK(!peers_.empty());
+  VELOX_CHECK_GE(selfIndex_, 0);
+  VELOX_CHECK_LT(selfIndex_, peers_.size());
+  VELOX_CHECK_GT(rangeBytes_, 0);
+  VELOX_CHECK_GT(numVirtualNodes, 0);
+  ring_.reserve(peers_.size() * numVirtualNodes);
+  for (auto i = 0; i < peers_.size(); ++i) {
+    for (auto node = 0; node < numVirtualNodes; ++node) {
+      ring_.emplace_back(
+          folly::hash::hash_combine(std::hash<std::string>()(peers_[i]), node),
+          i);
+    }
+  }
+  std::sort(ring_.begin(), ring_.end());
+}
+
+int32_t PeerCache::peerFor(std::string_view fileName, uint64_t offset) const {
+  const uint64_t hash = folly::hash::hash_combine(
+      std::hash<std::string_view>()(fileName), offset / rangeBytes_);
+  auto it = std::lower_bound(
+      ring_.begin(),
+      ring_.end(),
+      std::make_pair(hash, std::numeric_limits<int32_t>::min()));
+  if (it == ring_.end()) {
+    it = ring_.begin();
+  }
+  return it->second;
+}
+
+bool PeerCache::load(AsyncDataCacheEntry& entry) {
+  VELOX_CHECK(entry.isExclusive());
+  const auto fileName = fileIds().string(entry.key().fileNum.id());
+  const auto offset = entry.offset();
+  const auto peer = peerFor(fileName, offset);
+  if (peer == selfIndex_) {
+    return false;
+  }
+  ++numReads_;
+  try {
+    if (!readFromPeer(peers_[peer], fileName, offset, entryRanges(entry))) {
+      return false;
+    }
+  } catch (const std::exception& e) {
+    ++numErrors_;
+    VLOG(1) << "Failed to read " << fileName << " at " << offset
+            << " from peer " << peers_[peer] << ": " << e.what();
+    return false;
+  }
+  ++numHits_;
+  hitBytes_ += entry.size();
+  return true;
+}
+
+bool PeerCache::serve(
+    AsyncDataCache& cache,
+    std::string_view fileName,
+    uint64_t offset,
+    uint64_t size,
+    char* buffer) {
+  const auto fileNum = fileIds().id(fileName);
+  if (fileNum == StringIdMap::kNoId) {
+    return false;
+  }
+  auto pin = cache.find(RawFileCacheKey{fileNum, offset}, size);
+  if (pin.empty()) {
+    return false;
+  }
+  uint64_t copied = 0;
+  for (const auto& range : entryRanges(*pin.checkedEntry())) {
+    const auto bytes = std::min<uint64_t>(range.size(), size - copied);
+    ::memcpy(buffer + copied, range.data(), bytes);
+    copied += bytes;
+    if (copied == size) {
+      break;
+    }
+  }
+  ++numServed_;
+  servedBytes_ += size;
+  return true;
+}
+
+PeerCache::Stats PeerCache::stats() const {
+  Stats stats;
+  stats.numReads = numReads_;
+  stats.numHits = numHits_;
+  stats.hitBytes = hitBytes_;
+  stats.numErrors = numErrors_;
+  stats.numServed = numServed_;
+  stats.servedBytes = servedBytes_;
+  return stats;
+}
+
+} // namespace facebook::velox::cache
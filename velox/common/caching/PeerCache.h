@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "velox/common/caching/AsyncDataCache.h"
+
+namespace facebook::velox::cache {
+
+/// A tier of AsyncDataCache between the local SSD cache and storage. The
+/// ranges of a file are assigned to the workers of a cluster by consistent
+/// hashing of the file name and the range. When an entry misses the RAM and
+/// SSD cache, the worker asks the peer that the range is assigned to. It
+/// reads from storage only if the peer does not have the entry. The peers
+/// read their assigned ranges through their own caches, so a hot range is
+/// read from storage by about one worker instead of by all of them.
+///
+/// Velox has no network transport of its own. The embedding system
+/// subclasses this, implements readFromPeer() over its RPC layer and answers
+/// the requests of peers with serve().
+///
+/// This object is thread-safe.
+class PeerCache {
+ public:
+  /// The size of the ranges that are assigned to a peer as a unit. Entries
+  /// that are close in a file, e.g. the streams of a stripe, go to the same
+  /// peer.
+  static constexpr uint64_t kDefaultRangeBytes = 8 << 20;
+
+  /// The number of points per peer on the hash ring. More points spread the
+  /// ranges more evenly.
+  static constexpr int32_t kDefaultVirtualNodes = 100;
+
+  struct Stats {
+    /// Number of entries requested from peers.
+    uint64_t numReads{0};
+    /// Number of requested entries that peers returned.
+    uint64_t numHits{0};
+    uint64_t hitBytes{0};
+    /// Number of failed requests.
+    uint64_t numErrors{0};
+    /// Number of requests of peers served from the local RAM cache.
+    uint64_t numServed{0};
+    uint64_t servedBytes{0};
+  };
+
+  /// 'peers' are the addresses of all workers of the cluster, including this
+  /// one at 'selfIndex'. All workers must be given the same 'peers' in the
+  /// same order, so that they assign the ranges alike.
+  PeerCache(
+      std::vector<std::string> peers,
+      int32_t selfIndex,
+      uint64_t rangeBytes = kDefaultRangeBytes,
+      int32_t numVirtualNodes = kDefaultVirtualNodes);
+
+  virtual ~PeerCache() = default;
+
+  /// Returns the index in 'peers' of the worker that the range containing
+  /// 'offset' of 'fileName' is assigned to.
+  int32_t peerFor(std::string_view fileName, uint64_t offset) const;
+
+  /// Fills the exclusive 'entry' from the peer its range is assigned to.
+  /// Returns false without contacting a peer if the range is assigned to
+  /// this worker. Returns false if the peer does not have the entry or the
+  /// request fails. The entry stays exclusive either way.
+  bool load(AsyncDataCacheEntry& entry);
+
+  /// Serves the request of a peer. Copies 'size' bytes at 'offset' of
+  /// 'fileName' from the RAM cache 'cache' to 'buffer'. Returns false if
+  /// 'cache' has no readable entry of at least 'size' bytes at 'offset'.
+  bool serve(
+      AsyncDataCache& cache,
+      std::string_view fileName,
+      uint64_t offset,
+      uint64_t size,
+      char* buffer);
+
+  Stats stats() const;
+
+ protected:
+  /// Reads the entry at 'offset' of 'fileName' from the cache of 'peer' into
+  /// 'buffers', which have the size of the entry. Returns false if the peer
+  /// does not have the entry. Throws on transport errors.
+  virtual bool readFromPeer(
+      const std::string& peer,
+      const std::string& fileName,
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) = 0;
+
+ private:
+  const std::vector<std::string> peers_;
+  const int32_t selfIndex_;
+  const uint64_t rangeBytes_;
+
+  // The points of the peers on the hash ring with the peer index, sorted by
+  // hash.
+  std::vector<std::pair<uint64_t, int32_t>> ring_;
+
+  std::atomic<uint64_t> numReads_{0};
+  std::atomic<uint64_t> numHits_{0};
+  std::atomic<uint64_t> hitBytes_{0};
+  std::atomic<uint64_t> numErrors_{0};
+  std::atomic<uint64_t> numServed_{0};
+  std::atomic<uint64_t> servedBytes_{0};
+};
+
+} // namespace facebook::velox::cache
@@ -31,6 +31,9 @@ void ScanTracker::recordReference(
   if (fileGroupStats_) {
     fileGroupStats_->recordReference(fileId, groupId, id, bytes);
   }
+  if (history_) {
+    history_->recordReference(groupId, id, bytes, loadQuantum_);
+  }
   std::lock_guard<std::mutex> l(mutex_);
   data_[id].incrementReference(bytes, loadQuantum_);
   sum_.incrementReference(bytes, loadQuantum_);
@@ -44,11 +47,63 @@ void ScanTracker::recordRead(
   if (fileGroupStats_) {
     fileGroupStats_->recordRead(fileId, groupId, id, bytes);
   }
+  if (history_) {
+    history_->recordRead(groupId, id, bytes);
+  }
   std::lock_guard<std::mutex> l(mutex_);
   data_[id].incrementRead(bytes);
   sum_.incrementRead(bytes);
 }
 
+void TrackingHistory::recordReference(
+    uint64_t groupId,
+    TrackingId id,
+    uint64_t bytes,
+    int32_t loadQuantum) {
+  std::lock_guard<std::mutex> l(mutex_);
+  data_[Key{groupId, id}].incrementReference(bytes, loadQuantum);
+  if (++numReferences_ >= kDecayReferences) {
+    decayLocked();
+  }
+}
+
+void TrackingHistory::recordRead(
+    uint64_t groupId,
+    TrackingId id,
+    uint64_t bytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  data_[Key{groupId, id}].incrementRead(bytes);
+}
+
+TrackingData TrackingHistory::trackingData(uint64_t groupId, TrackingId id)
+    const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = data_.find(Key{groupId, id});
+  return it == data_.end() ? TrackingData() : it->second;
+}
+
+size_t TrackingHistory::size() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return data_.size();
+}
+
+void TrackingHistory::decayLocked() {
+  numReferences_ = 0;
+  auto it = data_.begin();
+  while (it != data_.end()) {
+    auto& data = it->second;
+    if (data.numReferences <= 1) {
+      it = data_.erase(it);
+      continue;
+    }
+    data.referencedBytes /= 2;
+    data.readBytes /= 2;
+    data.numReferences /= 2;
+    data.numReads /= 2;
+    ++it;
+  }
+}
+
 std::string ScanTracker::toString() const {
   std::stringstream out;
   out << "ScanTracker for " << id_ << std::endl;
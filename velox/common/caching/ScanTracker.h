@@ -99,6 +99,55 @@ struct TrackingData {
   }
 };
 
+// Access frequencies of the streams of file groups, accumulated over the
+// scans of all queries. A new scan has no access data of its own for its
+// first stripes and uses the history to decide what to prefetch for these.
+// The counts are halved after every 'kDecayReferences' references, so that
+// the history follows changes in the workload. This object is thread-safe.
+class TrackingHistory {
+ public:
+  static constexpr int64_t kDecayReferences = 1 << 20;
+
+  void recordReference(
+      uint64_t groupId,
+      TrackingId id,
+      uint64_t bytes,
+      int32_t loadQuantum);
+
+  void recordRead(uint64_t groupId, TrackingId id, uint64_t bytes);
+
+  // Returns the access data of stream 'id' in 'groupId'. The data is empty
+  // if no scan has referenced the stream.
+  TrackingData trackingData(uint64_t groupId, TrackingId id) const;
+
+  // Returns the number of tracked streams.
+  size_t size() const;
+
+ private:
+  struct Key {
+    uint64_t groupId;
+    TrackingId id;
+
+    bool operator==(const Key& other) const {
+      return groupId == other.groupId && id == other.id;
+    }
+  };
+
+  struct KeyHasher {
+    size_t operator()(const Key& key) const {
+      return bits::hashMix(std::hash<uint64_t>()(key.groupId), key.id.hash());
+    }
+  };
+
+  // Halves the counts and drops the streams that have at most one reference
+  // left.
+  void decayLocked();
+
+  mutable std::mutex mutex_;
+  folly::F14FastMap<Key, TrackingData, KeyHasher> data_;
+  int64_t numReferences_{0};
+};
+
 // Tracks column access frequency during execution of a query. A
 // ScanTracker is created at the level of a Task/TableScan, so that
 // all threads of a scan report in the same tracker. The same
@@ -119,11 +168,13 @@ class ScanTracker {
       std::string_view id,
       std::function<void(ScanTracker* FOLLY_NONNULL)> unregisterer,
       int32_t loadQuantum,
-      FileGroupStats* FOLLY_NULLABLE fileGroupStats = nullptr)
+      FileGroupStats* FOLLY_NULLABLE fileGroupStats = nullptr,
+      TrackingHistory* FOLLY_NULLABLE history = nullptr)
       : id_(id),
         unregisterer_(unregisterer),
         loadQuantum_(loadQuantum),
-        fileGroupStats_(fileGroupStats) {}
+        fileGroupStats_(fileGroupStats),
+        history_(history) {}
 
   ~ScanTracker() {
     if (unregisterer_) {
@@ -176,6 +227,12 @@ class ScanTracker {
     return fileGroupStats_;
   }
 
+  // Returns the cross query access history that the references and reads of
+  // 'this' are added to, nullptr if none.
+  TrackingHistory* FOLLY_NULLABLE history() const {
+    return history_;
+  }
+
   std::string toString() const;
 
  private:
@@ -191,6 +248,7 @@ class ScanTracker {
   // size is unlimited.
   const int32_t loadQuantum_;
   FileGroupStats* FOLLY_NULLABLE fileGroupStats_;
+  TrackingHistory* FOLLY_NULLABLE history_;
 };
 
 } // namespace facebook::velox::cache
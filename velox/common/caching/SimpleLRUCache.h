@@ -95,11 +95,17 @@ class SimpleLRUCache {
   /// added, false otherwise.
   bool add(const Key& key, const Value& value);
 
+  /// Adds an item to the cache or replaces the value of an existing item.
+  void set(const Key& key, const Value& value);
+
   /// Gets value associated with key.
   /// returns std::nullopt when the key is missing
   /// returns the cached value, when the key is present.
   std::optional<Value> get(const Key& key);
 
+  /// Removes the item of 'key'. Returns false if there is none.
+  bool erase(const Key& key);
+
   void clear();
 
   /// Total size of elements in the cache (NOT the maximum size/limit).
@@ -145,6 +151,13 @@ inline bool SimpleLRUCache<Key, Value>::add(
   return lru_.insert(key, value).second;
 }
 
+template <typename Key, typename Value>
+inline void SimpleLRUCache<Key, Value>::set(
+    const Key& key,
+    const Value& value) {
+  lru_.set(key, value);
+}
+
 template <typename Key, typename Value>
 inline std::optional<Value> SimpleLRUCache<Key, Value>::get(const Key& key) {
   ++numLookups_;
@@ -157,6 +170,11 @@ inline std::optional<Value> SimpleLRUCache<Key, Value>::get(const Key& key) {
   return it->second;
 }
 
+template <typename Key, typename Value>
+inline bool SimpleLRUCache<Key, Value>::erase(const Key& key) {
+  return lru_.erase(key);
+}
+
 template <typename Key, typename Value>
 inline void SimpleLRUCache<Key, Value>::clear() {
   lru_.clear();
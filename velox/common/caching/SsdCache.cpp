@@ -109,7 +109,7 @@ void SsdCache::write(std::vector<CachePin> pins) {
     auto pinHolder = std::make_shared<PinHolder>(std::move(shards[i]));
     executor_->add([this, i, pinHolder, bytes, startTimeUs]() {
       try {
-        files_[i]->write(pinHolder->pins);
+        files_[i]->write(pinHolder->pins, groupStats_.get());
       } catch (const std::exception& e) {
         // Catch so as not to miss updating 'writesInProgress_'. Could
         // theoretically happen for std::bad_alloc or such.
@@ -129,6 +129,77 @@ void SsdCache::write(std::vector<CachePin> pins) {
   writesInProgress_.fetch_sub(numNoStore);
 }
 
+void SsdCache::startWarmUp(AsyncDataCache& cache, uint64_t maxBytes) {
+  VELOX_CHECK_NOT_NULL(executor_, "SSD cache warm up needs an executor");
+  if (isShutdown_) {
+    return;
+  }
+  const auto shardBytes = maxBytes / numShards_;
+  warmUpTargetBytes_ += shardBytes * numShards_;
+  warmUpsInProgress_ += numShards_;
+  for (auto i = 0; i < numShards_; ++i) {
+    executor_->add([this, &cache, i, shardBytes]() {
+      try {
+        warmUpShard(cache, i, shardBytes);
+      } catch (const std::exception& e) {
+        VELOX_SSD_CACHE_LOG(WARNING)
+            << "Stopping warm up of shard " << i << ": " << e.what();
+      }
+      --warmUpsInProgress_;
+    });
+  }
+}
+
+void SsdCache::warmUpShard(
+    AsyncDataCache& cache,
+    int32_t shard,
+    uint64_t maxBytes) {
+  auto& file = *files_[shard];
+  const auto entries = file.hottestEntries(maxBytes);
+  size_t next = 0;
+  while (next < entries.size() && !isShutdown_) {
+    std::vector<SsdPin> ssdPins;
+    std::vector<CachePin> pins;
+    uint64_t bytes = 0;
+    for (; next < entries.size() && bytes < kWarmUpLoadBytes; ++next) {
+      const auto& [key, size] = entries[next];
+      auto pin = cache.findOrCreate(key, size, nullptr);
+      if (pin.empty() || pin.checkedEntry()->isShared()) {
+        // Already in RAM or being loaded by a query.
+        continue;
+      }
+      auto ssdPin = file.find(key);
+      if (ssdPin.empty()) {
+        // Evicted from SSD since hottestEntries(). Dropping the exclusive pin
+        // removes the new entry.
+        continue;
+      }
+      pin.checkedEntry()->setPrefetch(true);
+      bytes += size;
+      pins.push_back(std::move(pin));
+      ssdPins.push_back(std::move(ssdPin));
+    }
+    if (pins.empty()) {
+      continue;
+    }
+    file.load(ssdPins, pins);
+    for (auto& pin : pins) {
+      pin.checkedEntry()->setExclusiveToShared();
+    }
+    warmUpLoadedBytes_ += bytes;
+    warmUpLoadedEntries_ += pins.size();
+  }
+}
+
+SsdCache::WarmUpStats SsdCache::warmUpStats() const {
+  WarmUpStats stats;
+  stats.targetBytes = warmUpTargetBytes_;
+  stats.loadedBytes = warmUpLoadedBytes_;
+  stats.loadedEntries = warmUpLoadedEntries_;
+  stats.numPendingShards = warmUpsInProgress_;
+  return stats;
+}
+
 SsdCacheStats SsdCache::stats() const {
   SsdCacheStats stats;
   for (auto& file : files_) {
@@ -163,7 +234,7 @@ void SsdCache::testingDeleteFiles() {
 
 void SsdCache::shutdown() {
   isShutdown_ = true;
-  while (writesInProgress_) {
+  while (writesInProgress_ || warmUpsInProgress_) {
     std::this_thread::sleep_for(std::chrono::milliseconds(100)); // NOLINT
   }
   for (auto& file : files_) {
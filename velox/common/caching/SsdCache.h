@@ -76,6 +76,25 @@ class SsdCache {
   /// have returned true.
   void write(std::vector<CachePin> pins);
 
+  /// Progress of the warm up started by startWarmUp().
+  struct WarmUpStats {
+    uint64_t targetBytes{0};
+    uint64_t loadedBytes{0};
+    uint64_t loadedEntries{0};
+    /// Number of shards that have not finished warming up.
+    int32_t numPendingShards{0};
+  };
+
+  /// Loads up to 'maxBytes' of the most read entries of the shards into
+  /// 'cache' in the background on 'executor_'. The entries are ranked by the
+  /// read scores of their regions, which are restored from the checkpoint
+  /// after a restart. The entries are loaded as prefetched, so they are first
+  /// to evict if no query reads them. This lets a restarted process serve
+  /// its first queries from RAM. Progress is given by warmUpStats().
+  void startWarmUp(AsyncDataCache& cache, uint64_t maxBytes);
+
+  WarmUpStats warmUpStats() const;
+
   /// Returns stats aggregated from all shards.
   SsdCacheStats stats() const;
 
@@ -98,6 +117,13 @@ class SsdCache {
   std::string toString() const;
 
  private:
+  // Max bytes loaded into the RAM cache by one load of the warm up.
+  static constexpr uint64_t kWarmUpLoadBytes = 8 << 20;
+
+  // Loads up to 'maxBytes' of the hottest entries of shard 'shard' into
+  // 'cache'.
+  void warmUpShard(AsyncDataCache& cache, int32_t shard, uint64_t maxBytes);
+
   const std::string filePrefix_;
   const int32_t numShards_;
   std::vector<std::unique_ptr<SsdFile>> files_;
@@ -109,6 +135,12 @@ class SsdCache {
   std::unique_ptr<FileGroupStats> groupStats_;
   folly::Executor* executor_;
   std::atomic<bool> isShutdown_{false};
+
+  // Progress of the warm up.
+  std::atomic<uint64_t> warmUpTargetBytes_{0};
+  std::atomic<uint64_t> warmUpLoadedBytes_{0};
+  std::atomic<uint64_t> warmUpLoadedEntries_{0};
+  std::atomic<int32_t> warmUpsInProgress_{0};
 };
 
 } // namespace facebook::velox::cache
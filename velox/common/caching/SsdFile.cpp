@@ -21,6 +21,7 @@
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/common/caching/FileIds.h"
 #include "velox/common/caching/SsdCache.h"
+#include "velox/common/compression/Compression.h"
 
 #include <fcntl.h>
 #ifdef linux
@@ -79,6 +80,63 @@ void addEntryToIovecs(AsyncDataCacheEntry& entry, std::vector<iovec>& iovecs) {
     };
   }
 }
+
+// Header of a compressed entry on SSD: the CompressionKind and the
+// uncompressed size.
+constexpr int32_t kCompressedHeaderSize = 1 + sizeof(uint32_t);
+
+// Returns the contents of 'entry' compressed with 'kind' and preceded by the
+// compressed entry header. Returns nullptr if compression saves less than
+// 1/8 of the size, in which case the entry is stored as is.
+std::unique_ptr<folly::IOBuf> compressEntry(
+    AsyncDataCacheEntry& entry,
+    common::CompressionKind kind) {
+  std::vector<iovec> iovecs;
+  addEntryToIovecs(entry, iovecs);
+  std::unique_ptr<folly::IOBuf> input;
+  for (const auto& iov : iovecs) {
+    auto buf = folly::IOBuf::wrapBuffer(iov.iov_base, iov.iov_len);
+    if (input == nullptr) {
+      input = std::move(buf);
+    } else {
+      input->prependChain(std::move(buf));
+    }
+  }
+  auto output = common::compressionKindToCodec(kind)->compress(input.get());
+  const uint64_t size =
+      kCompressedHeaderSize + output->computeChainDataLength();
+  if (size > entry.size() - entry.size() / 8) {
+    return nullptr;
+  }
+  auto result = folly::IOBuf::create(size);
+  auto* data = result->writableData();
+  data[0] = static_cast<uint8_t>(kind);
+  const uint32_t uncompressedSize = entry.size();
+  memcpy(data + 1, &uncompressedSize, sizeof(uncompressedSize));
+  auto* position = data + kCompressedHeaderSize;
+  for (const auto& range : *output) {
+    memcpy(position, range.data(), range.size());
+    position += range.size();
+  }
+  result->append(size);
+  return result;
+}
+
+// Copies 'data' into the memory of 'entry'.
+void copyToEntry(folly::ByteRange data, AsyncDataCacheEntry& entry) {
+  if (entry.tinyData() != nullptr) {
+    memcpy(entry.tinyData(), data.data(), data.size());
+    return;
+  }
+  const auto& allocation = entry.data();
+  uint64_t offset = 0;
+  for (auto i = 0; i < allocation.numRuns() && offset < data.size(); ++i) {
+    const auto run = allocation.runAt(i);
+    const auto bytes = std::min<uint64_t>(run.numBytes(), data.size() - offset);
+    memcpy(run.data<char>(), data.data() + offset, bytes);
+    offset += bytes;
+  }
+}
 } // namespace
 
 SsdPin::SsdPin(SsdFile& file, SsdRun run) : file_(&file), run_(run) {
@@ -213,6 +271,51 @@ bool SsdFile::erase(RawFileCacheKey key) {
   return true;
 }
 
+std::vector<std::pair<RawFileCacheKey, uint32_t>> SsdFile::hottestEntries(
+    uint64_t maxBytes) {
+  std::shared_lock<std::shared_mutex> l(mutex_);
+  const auto scores = tracker_.copyScores();
+  std::vector<int32_t> regions(numRegions_);
+  std::iota(regions.begin(), regions.end(), 0);
+  std::sort(regions.begin(), regions.end(), [&](int32_t left, int32_t right) {
+    return scores[left] > scores[right];
+  });
+  std::vector<int32_t> regionRank(numRegions_);
+  for (auto i = 0; i < regions.size(); ++i) {
+    regionRank[regions[i]] = i;
+  }
+
+  std::vector<std::pair<RawFileCacheKey, SsdRun>> candidates;
+  candidates.reserve(entries_.size());
+  for (const auto& [key, run] : entries_) {
+    if (!run.compressed()) {
+      candidates.push_back({{key.fileNum.id(), key.offset}, run});
+    }
+  }
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [&](const auto& left, const auto& right) {
+        const auto leftRank = regionRank[regionIndex(left.second.offset())];
+        const auto rightRank = regionRank[regionIndex(right.second.offset())];
+        if (leftRank != rightRank) {
+          return leftRank < rightRank;
+        }
+        return left.second.offset() < right.second.offset();
+      });
+
+  std::vector<std::pair<RawFileCacheKey, uint32_t>> result;
+  uint64_t totalBytes = 0;
+  for (const auto& [key, run] : candidates) {
+    if (totalBytes + run.size() > maxBytes) {
+      break;
+    }
+    totalBytes += run.size();
+    result.push_back({key, run.size()});
+  }
+  return result;
+}
+
 CoalesceIoStats SsdFile::load(
     const std::vector<SsdPin>& ssdPins,
     const std::vector<CachePin>& pins) {
@@ -221,9 +324,18 @@ CoalesceIoStats SsdFile::load(
     return CoalesceIoStats();
   }
   int payloadTotal = 0;
+  // Indices of the entries that are stored as is.
+  std::vector<int32_t> uncompressed;
   for (auto i = 0; i < pins.size(); ++i) {
     const auto runSize = ssdPins[i].run().size();
     auto* entry = pins[i].checkedEntry();
+    regionRead(regionIndex(ssdPins[i].run().offset()), runSize);
+    ++stats_.entriesRead;
+    stats_.bytesRead += entry->size();
+    if (ssdPins[i].run().compressed()) {
+      continue;
+    }
+    uncompressed.push_back(i);
     if (FOLLY_UNLIKELY(runSize < entry->size())) {
       ++stats_.readSsdErrors;
       VELOX_FAIL(
@@ -232,29 +344,53 @@ CoalesceIoStats SsdFile::load(
           succinctBytes(entry->size()));
     }
     payloadTotal += entry->size();
-    regionRead(regionIndex(ssdPins[i].run().offset()), runSize);
-    ++stats_.entriesRead;
-    stats_.bytesRead += entry->size();
   }
+  loadCompressed(ssdPins, pins);
+  if (uncompressed.empty()) {
+    for (auto i = 0; i < ssdPins.size(); ++i) {
+      pins[i].checkedEntry()->setSsdFile(this, ssdPins[i].run().offset());
+    }
+    return CoalesceIoStats();
+  }
+  std::vector<CachePin> uncompressedPins;
+  if (uncompressed.size() < pins.size()) {
+    uncompressedPins.reserve(uncompressed.size());
+    for (auto i : uncompressed) {
+      uncompressedPins.push_back(pins[i]);
+    }
+  }
+  const auto& readablePins =
+      uncompressed.size() < pins.size() ? uncompressedPins : pins;
 
+  // Coalesced reads to submit together when 'readFile_' reads asynchronously.
+  std::vector<ReadBatch> batches;
   // Do coalesced IO for the pins. For short payloads, the break-even between
   // discrete pread calls and a single preadv that discards gaps is ~25K per
   // gap. For longer payloads this is ~50-100K.
   auto stats = readPins(
-      pins,
-      payloadTotal / pins.size() < 10000 ? 25000 : 50000,
+      readablePins,
+      payloadTotal / readablePins.size() < 10000 ? 25000 : 50000,
       // Max ranges in one preadv call. Longest gap + longest cache entry are
       // under 12 ranges. If a system has a limit of 1K ranges, coalesce limit
       // of 1000 is safe.
       900,
-      [&](int32_t index) { return ssdPins[index].run().offset(); },
+      [&](int32_t index) {
+        return ssdPins[uncompressed[index]].run().offset();
+      },
       [&](const std::vector<CachePin>& /*pins*/,
           int32_t /*begin*/,
           int32_t /*end*/,
           uint64_t offset,
           const std::vector<folly::Range<char*>>& buffers) {
-        read(offset, buffers);
+        if (!readFile_->hasPreadvAsync()) {
+          read(offset, buffers);
+          return;
+        }
+        // Defer the read so that all the coalesced reads of the load are in
+        // flight together.
+        batches.push_back({offset, buffers});
       });
+  readBatches(batches);
 
   for (auto i = 0; i < ssdPins.size(); ++i) {
     pins[i].checkedEntry()->setSsdFile(this, ssdPins[i].run().offset());
@@ -262,14 +398,69 @@ CoalesceIoStats SsdFile::load(
   return stats;
 }
 
+void SsdFile::loadCompressed(
+    const std::vector<SsdPin>& ssdPins,
+    const std::vector<CachePin>& pins) {
+  std::string buffer;
+  for (auto i = 0; i < pins.size(); ++i) {
+    const auto run = ssdPins[i].run();
+    if (!run.compressed()) {
+      continue;
+    }
+    auto* entry = pins[i].checkedEntry();
+    buffer.resize(run.size());
+    read(run.offset(), {folly::Range<char*>(buffer.data(), run.size())});
+    const auto kind = static_cast<common::CompressionKind>(buffer[0]);
+    uint32_t uncompressedSize;
+    memcpy(&uncompressedSize, buffer.data() + 1, sizeof(uncompressedSize));
+    if (FOLLY_UNLIKELY(uncompressedSize < entry->size())) {
+      ++stats_.readSsdErrors;
+      VELOX_FAIL(
+          "IOERR: SSD cache compressed entry {} shorter than requested "
+          "range {}",
+          succinctBytes(uncompressedSize),
+          succinctBytes(entry->size()));
+    }
+    auto input = folly::IOBuf::wrapBuffer(
+        buffer.data() + kCompressedHeaderSize,
+        run.size() - kCompressedHeaderSize);
+    auto output = common::compressionKindToCodec(kind)->uncompress(
+        input.get(), uncompressedSize);
+    output->coalesce();
+    copyToEntry(folly::ByteRange(output->data(), entry->size()), *entry);
+  }
+}
+
 void SsdFile::read(
     uint64_t offset,
     const std::vector<folly::Range<char*>>& buffers) {
   readFile_->preadv(offset, buffers);
 }
 
+void SsdFile::readBatches(const std::vector<ReadBatch>& batches) {
+  if (batches.empty()) {
+    return;
+  }
+  std::vector<folly::SemiFuture<uint64_t>> futures;
+  futures.reserve(batches.size());
+  for (const auto& batch : batches) {
+    futures.push_back(readFile_->preadvAsync(batch.offset, batch.buffers));
+  }
+  auto results = folly::collectAll(std::move(futures)).get();
+  for (auto& result : results) {
+    if (result.hasException()) {
+      ++stats_.readSsdErrors;
+      result.throwUnlessValue();
+    }
+  }
+}
+
+void SsdFile::testingSetReadFile(std::unique_ptr<ReadFile> readFile) {
+  readFile_ = std::move(readFile);
+}
+
 std::optional<std::pair<uint64_t, int32_t>> SsdFile::getSpace(
-    const std::vector<CachePin>& pins,
+    const std::vector<uint32_t>& sizes,
     int32_t begin) {
   int32_t next = begin;
   std::lock_guard<std::shared_mutex> l(mutex_);
@@ -284,13 +475,12 @@ std::optional<std::pair<uint64_t, int32_t>> SsdFile::getSpace(
     const auto offset = regionSizes_[region];
     auto available = kRegionSize - offset;
     int64_t toWrite = 0;
-    for (; next < pins.size(); ++next) {
-      auto* entry = pins[next].checkedEntry();
-      if (entry->size() > available) {
+    for (; next < sizes.size(); ++next) {
+      if (sizes[next] > available) {
         break;
       }
-      available -= entry->size();
-      toWrite += entry->size();
+      available -= sizes[next];
+      toWrite += sizes[next];
     }
     if (toWrite > 0) {
       // At least some pins got space from this region. If the region is full
@@ -348,6 +538,14 @@ void SsdFile::clearRegionEntriesLocked(const std::vector<int32_t>& regions) {
       ++it;
     }
   }
+  pendingEntries_.erase(
+      std::remove_if(
+          pendingEntries_.begin(),
+          pendingEntries_.end(),
+          [&](const auto& entry) {
+            return regionSet.count(regionIndex(entry.run.offset())) != 0;
+          }),
+      pendingEntries_.end());
   for (const auto region : regions) {
     // While the region is being filled, it may get score from hits. When it is
     // full, it will get a score boost to be a little ahead of the best.
@@ -356,20 +554,35 @@ void SsdFile::clearRegionEntriesLocked(const std::vector<int32_t>& regions) {
   }
 }
 
-void SsdFile::write(std::vector<CachePin>& pins) {
+void SsdFile::write(
+    std::vector<CachePin>& pins,
+    const FileGroupStats* groupStats) {
   // Sorts the pins by their file/offset. In this way what is adjacent in
   // storage is likely adjacent on SSD.
   std::sort(pins.begin(), pins.end());
-  uint64_t total = 0;
-  for (const auto& pin : pins) {
-    auto* entry = pin.checkedEntry();
+  // The bytes each entry takes on SSD and the compressed form of the entries
+  // that are stored compressed.
+  std::vector<uint32_t> sizes(pins.size());
+  std::vector<std::unique_ptr<folly::IOBuf>> compressed(pins.size());
+  for (auto i = 0; i < pins.size(); ++i) {
+    auto* entry = pins[i].checkedEntry();
     VELOX_CHECK_NULL(entry->ssdFile());
-    total += entry->size();
+    sizes[i] = entry->size();
+    if (groupStats == nullptr) {
+      continue;
+    }
+    const auto kind = groupStats->ssdCompression(entry->groupId());
+    if (kind != common::CompressionKind_NONE) {
+      compressed[i] = compressEntry(*entry, kind);
+      if (compressed[i] != nullptr) {
+        sizes[i] = compressed[i]->length();
+      }
+    }
   }
 
   int32_t storeIndex = 0;
   while (storeIndex < pins.size()) {
-    auto space = getSpace(pins, storeIndex);
+    auto space = getSpace(sizes, storeIndex);
     if (!space.has_value()) {
       // No space can be reclaimed. The pins are freed when the caller is freed.
       return;
@@ -380,13 +593,16 @@ void SsdFile::write(std::vector<CachePin>& pins) {
     int32_t bytes = 0;
     std::vector<iovec> iovecs;
     for (auto i = storeIndex; i < pins.size(); ++i) {
-      auto* entry = pins[i].checkedEntry();
-      const auto entrySize = entry->size();
-      if (bytes + entrySize > available) {
+      if (bytes + sizes[i] > available) {
         break;
       }
-      addEntryToIovecs(*entry, iovecs);
-      bytes += entrySize;
+      if (compressed[i] != nullptr) {
+        iovecs.push_back(
+            {compressed[i]->writableData(), compressed[i]->length()});
+      } else {
+        addEntryToIovecs(*pins[i].checkedEntry(), iovecs);
+      }
+      bytes += sizes[i];
       ++numWritten;
     }
     VELOX_CHECK_GE(fileSize_, offset + bytes);
@@ -409,16 +625,25 @@ void SsdFile::write(std::vector<CachePin>& pins) {
       for (auto i = storeIndex; i < storeIndex + numWritten; ++i) {
         auto* entry = pins[i].checkedEntry();
         entry->setSsdFile(this, offset);
-        const auto size = entry->size();
+        const auto size = sizes[i];
+        const bool isCompressed = compressed[i] != nullptr;
         FileCacheKey key = {
             entry->key().fileNum, static_cast<uint64_t>(entry->offset())};
-        entries_[std::move(key)] = SsdRun(offset, size);
-        if (FLAGS_ssd_verify_write) {
+        const SsdRun run(offset, size, isCompressed);
+        if (checkpointIntervalBytes_ > 0) {
+          pendingEntries_.push_back({key, run, ++writeSequence_});
+        }
+        entries_[std::move(key)] = run;
+        if (FLAGS_ssd_verify_write && !isCompressed) {
           verifyWrite(*entry, SsdRun(offset, size));
         }
         offset += size;
         ++stats_.entriesWritten;
         stats_.bytesWritten += size;
+        if (isCompressed) {
+          ++stats_.entriesCompressed;
+          stats_.bytesSavedByCompression += entry->size() - size;
+        }
         bytesAfterCheckpoint_ += size;
       }
     }
@@ -486,6 +711,8 @@ void SsdFile::updateStats(SsdCacheStats& stats) const {
   for (auto pins : regionPins_) {
     stats.numPins += pins;
   }
+  stats.entriesCompressed += stats_.entriesCompressed;
+  stats.bytesSavedByCompression += stats_.bytesSavedByCompression;
 
   stats.openFileErrors += stats_.openFileErrors;
   stats.openCheckpointErrors += stats_.openCheckpointErrors;
@@ -501,6 +728,8 @@ void SsdFile::updateStats(SsdCacheStats& stats) const {
 void SsdFile::clear() {
   std::lock_guard<std::shared_mutex> l(mutex_);
   entries_.clear();
+  pendingEntries_.clear();
+  needsFullCheckpoint_ = true;
   std::fill(regionSizes_.begin(), regionSizes_.end(), 0);
   writableRegions_.resize(numRegions_);
   std::iota(writableRegions_.begin(), writableRegions_.end(), 0);
@@ -520,8 +749,12 @@ void SsdFile::deleteFile() {
 
 void SsdFile::logEviction(const std::vector<int32_t>& regions) {
   if (checkpointIntervalBytes_ > 0) {
-    const int32_t rc = ::write(
-        evictLogFd_, regions.data(), regions.size() * sizeof(regions[0]));
+    int32_t rc;
+    {
+      std::lock_guard<std::mutex> l(logMutex_);
+      rc = ::write(
+          evictLogFd_, regions.data(), regions.size() * sizeof(regions[0]));
+    }
     if (rc != regions.size() * sizeof(regions[0])) {
       checkpointError(rc, "Failed to log eviction");
     }
@@ -529,6 +762,7 @@ void SsdFile::logEviction(const std::vector<int32_t>& regions) {
 }
 
 void SsdFile::deleteCheckpoint(bool keepLog) {
+  std::lock_guard<std::mutex> l(logMutex_);
   if (checkpointDeleted_) {
     return;
   }
@@ -577,103 +811,42 @@ template <typename T>
 inline const char* asChar(const T* ptr) {
   return reinterpret_cast<const char*>(ptr);
 }
+
+// Throws if 'rc' is negative.
+int64_t checkRc(int64_t rc, const std::string& errMsg) {
+  if (rc < 0) {
+    VELOX_FAIL("{} with rc {} :{}", errMsg, rc, folly::errnoStr(errno));
+  }
+  return rc;
+}
+
+template <typename T>
+void appendNumber(std::string& out, T value) {
+  out.append(asChar(&value), sizeof(value));
+}
 } // namespace
 
 void SsdFile::checkpoint(bool force) {
-  std::lock_guard<std::shared_mutex> l(mutex_);
-  if (!force && (bytesAfterCheckpoint_ < checkpointIntervalBytes_)) {
+  std::unique_lock<std::mutex> checkpointLock(
+      checkpointMutex_, std::defer_lock);
+  if (force) {
+    checkpointLock.lock();
+  } else if (!checkpointLock.try_lock()) {
+    return;
+  }
+  if (checkpointIntervalBytes_ == 0 ||
+      (!force && (bytesAfterCheckpoint_ < checkpointIntervalBytes_))) {
     return;
   }
 
-  checkpointDeleted_ = false;
   bytesAfterCheckpoint_ = 0;
   try {
-    // We schedule the potentially long fsync of the cache file on another
-    // thread of the cache write executor, if available. If there is none, we do
-    // the sync on this thread at the end.
-    auto fileSync = std::make_shared<AsyncSource<int>>(
-        [fd = fd_]() { return std::make_unique<int>(::fsync(fd)); });
-    if (executor_ != nullptr) {
-      executor_->add([fileSync]() { fileSync->prepare(); });
-    }
-
-    const auto checkRc = [&](int32_t rc, const std::string& errMsg) {
-      if (rc < 0) {
-        VELOX_FAIL("{} with rc {} :{}", errMsg, rc, folly::errnoStr(errno));
-      }
-      return rc;
-    };
-
-    std::ofstream state;
-    auto checkpointPath = fileName_ + kCheckpointExtension;
-    state.exceptions(std::ofstream::failbit);
-    state.open(checkpointPath, std::ios_base::out | std::ios_base::trunc);
-    // The checkpoint state file contains:
-    // int32_t The 4 bytes of kCheckpointMagic,
-    // int32_t maxRegions,
-    // int32_t numRegions,
-    // regionScores from the 'tracker_',
-    // {fileId, fileName} pairs,
-    // kMapMarker,
-    // {fileId, offset, SSdRun} triples,
-    // kEndMarker.
-    state.write(kCheckpointMagic, sizeof(int32_t));
-    state.write(asChar(&maxRegions_), sizeof(maxRegions_));
-    state.write(asChar(&numRegions_), sizeof(numRegions_));
-
-    // Copy the region scores before writing out for tsan.
-    const auto scoresCopy = tracker_.copyScores();
-    state.write(asChar(scoresCopy.data()), maxRegions_ * sizeof(uint64_t));
-    std::unordered_set<uint64_t> fileNums;
-    for (const auto& entry : entries_) {
-      const auto fileNum = entry.first.fileNum.id();
-      if (fileNums.insert(fileNum).second) {
-        state.write(asChar(&fileNum), sizeof(fileNum));
-        const auto name = fileIds().string(fileNum);
-        const int32_t length = name.size();
-        state.write(asChar(&length), sizeof(length));
-        state.write(name.data(), length);
-      }
+    if (force || needsFullCheckpoint_ ||
+        numLogEntries_ > numCheckpointEntries_) {
+      writeCheckpoint();
+    } else {
+      logPendingEntries();
     }
-
-    const auto mapMarker = kCheckpointMapMarker;
-    state.write(asChar(&mapMarker), sizeof(mapMarker));
-    for (auto& pair : entries_) {
-      auto id = pair.first.fileNum.id();
-      state.write(asChar(&id), sizeof(id));
-      state.write(asChar(&pair.first.offset), sizeof(pair.first.offset));
-      auto offsetAndSize = pair.second.bits();
-      state.write(asChar(&offsetAndSize), sizeof(offsetAndSize));
-    }
-
-    // NOTE: we need to ensure cache file data sync update completes before
-    // updating checkpoint file.
-    const auto fileSyncRc = fileSync->move();
-    checkRc(*fileSyncRc, "Sync of cache data file");
-
-    const auto endMarker = kCheckpointEndMarker;
-    state.write(asChar(&endMarker), sizeof(endMarker));
-
-    if (state.bad()) {
-      ++stats_.writeCheckpointErrors;
-      checkRc(-1, "Write of checkpoint file");
-    }
-    state.close();
-
-    // Sync checkpoint data file. ofstream does not have a sync method, so open
-    // as fd and sync that.
-    const auto checkpointFd = checkRc(
-        ::open(checkpointPath.c_str(), O_WRONLY),
-        "Open of checkpoint file for sync");
-    VELOX_CHECK_GE(checkpointFd, 0);
-    checkRc(::fsync(checkpointFd), "Sync of checkpoint file");
-    ::close(checkpointFd);
-
-    // NOTE: we shall truncate eviction log after checkpoint file sync
-    // completes so that we never recover from an old checkpoint file without
-    // log evictions. The latter might lead to data consistent issue.
-    checkRc(::ftruncate(evictLogFd_, 0), "Truncate of event log");
-    checkRc(::fsync(evictLogFd_), "Sync of evict log");
   } catch (const std::exception& e) {
     try {
       checkpointError(-1, e.what());
@@ -683,6 +856,206 @@ void SsdFile::checkpoint(bool force) {
   }
 }
 
+void SsdFile::writeCheckpoint() {
+  // Copy the state under the locks and write it out without them. The names
+  // of the files are kept alive by the leases in 'fileNames'.
+  struct CheckpointEntry {
+    uint64_t fileNum;
+    uint64_t offset;
+    uint64_t run;
+  };
+  std::vector<CheckpointEntry> snapshot;
+  folly::F14FastMap<uint64_t, StringIdLease> fileNames;
+  std::vector<uint64_t> scores;
+  int32_t numRegions;
+  int64_t logOffset;
+  {
+    std::lock_guard<std::shared_mutex> l(mutex_);
+    snapshot.reserve(entries_.size());
+    for (const auto& [key, run] : entries_) {
+      const auto fileNum = key.fileNum.id();
+      fileNames.try_emplace(fileNum, key.fileNum);
+      snapshot.push_back({fileNum, key.offset, run.bits()});
+    }
+    // Copy the region scores before writing out for tsan.
+    scores = tracker_.copyScores();
+    numRegions = numRegions_;
+    // The snapshot covers the entries written so far.
+    pendingEntries_.clear();
+    needsFullCheckpoint_ = false;
+    std::lock_guard<std::mutex> logLock(logMutex_);
+    logOffset = checkRc(::lseek(evictLogFd_, 0, SEEK_END), "Seek of log");
+    checkpointDeleted_ = false;
+  }
+  loggedFileNums_.clear();
+
+  // We schedule the potentially long fsync of the cache file on another
+  // thread of the cache write executor, if available. If there is none, we do
+  // the sync on this thread at the end.
+  auto fileSync = std::make_shared<AsyncSource<int>>(
+      [fd = fd_]() { return std::make_unique<int>(::fsync(fd)); });
+  if (executor_ != nullptr) {
+    executor_->add([fileSync]() { fileSync->prepare(); });
+  }
+
+  // The checkpoint is written to a temporary file that replaces the previous
+  // checkpoint only when complete.
+  const auto checkpointPath = fileName_ + kCheckpointExtension;
+  const auto tempPath = checkpointPath + kTempExtension;
+  std::ofstream state;
+  state.exceptions(std::ofstream::failbit);
+  state.open(tempPath, std::ios_base::out | std::ios_base::trunc);
+  // The checkpoint state file contains:
+  // int32_t The 4 bytes of kCheckpointMagic,
+  // int32_t maxRegions,
+  // int32_t numRegions,
+  // regionScores from the 'tracker_',
+  // {fileId, fileName} pairs,
+  // kMapMarker,
+  // {fileId, offset, SSdRun} triples,
+  // kEndMarker.
+  state.write(kCheckpointMagic, sizeof(int32_t));
+  state.write(asChar(&maxRegions_), sizeof(maxRegions_));
+  state.write(asChar(&numRegions), sizeof(numRegions));
+  state.write(asChar(scores.data()), maxRegions_ * sizeof(uint64_t));
+  for (const auto& pair : fileNames) {
+    const auto fileNum = pair.first;
+    state.write(asChar(&fileNum), sizeof(fileNum));
+    const auto string = fileIds().string(fileNum);
+    const int32_t length = string.size();
+    state.write(asChar(&length), sizeof(length));
+    state.write(string.data(), length);
+  }
+
+  const auto mapMarker = kCheckpointMapMarker;
+  state.write(asChar(&mapMarker), sizeof(mapMarker));
+  for (const auto& entry : snapshot) {
+    state.write(asChar(&entry.fileNum), sizeof(entry.fileNum));
+    state.write(asChar(&entry.offset), sizeof(entry.offset));
+    state.write(asChar(&entry.run), sizeof(entry.run));
+  }
+
+  // NOTE: we need to ensure cache file data sync update completes before
+  // updating checkpoint file.
+  const auto fileSyncRc = fileSync->move();
+  checkRc(*fileSyncRc, "Sync of cache data file");
+
+  const auto endMarker = kCheckpointEndMarker;
+  state.write(asChar(&endMarker), sizeof(endMarker));
+
+  if (state.bad()) {
+    ++stats_.writeCheckpointErrors;
+    checkRc(-1, "Write of checkpoint file");
+  }
+  state.close();
+
+  // Sync checkpoint data file. ofstream does not have a sync method, so open
+  // as fd and sync that.
+  const auto checkpointFd = checkRc(
+      ::open(tempPath.c_str(), O_WRONLY), "Open of checkpoint file for sync");
+  const auto syncRc = ::fsync(checkpointFd);
+  ::close(checkpointFd);
+  checkRc(syncRc, "Sync of checkpoint file");
+  checkRc(
+      ::rename(tempPath.c_str(), checkpointPath.c_str()),
+      "Rename of checkpoint file");
+
+  // NOTE: we shall cut the log after the checkpoint file is in place so that
+  // we never recover from an old checkpoint file without the log records
+  // after it. The latter might lead to data consistent issue.
+  compactLog(logOffset);
+  numLogEntries_ = 0;
+  numCheckpointEntries_ = snapshot.size();
+}
+
+void SsdFile::compactLog(int64_t offset) {
+  const auto logPath = fileName_ + kLogExtension;
+  const auto tempPath = logPath + kTempExtension;
+  const auto fd = checkRc(
+      ::open(tempPath.c_str(), O_CREAT | O_TRUNC | O_RDWR, S_IRUSR | S_IWUSR),
+      "Open of new log");
+  // Copies the records in [offset, end of log) to the new log and returns
+  // the end.
+  const auto copyRecords = [&](int64_t begin) {
+    const auto end = checkRc(::lseek(evictLogFd_, 0, SEEK_END), "Seek of log");
+    std::string records(end - begin, '\0');
+    const ssize_t size = records.size();
+    if (::pread(evictLogFd_, records.data(), size, begin) != size ||
+        ::write(fd, records.data(), size) != size) {
+      VELOX_FAIL("Failed to copy log: {}", folly::errnoStr(errno));
+    }
+    return end;
+  };
+
+  try {
+    // Most records are copied and synced without 'logMutex_'. Holding it, the
+    // records logged meanwhile are copied and the new log replaces the old.
+    offset = copyRecords(offset);
+    checkRc(::fsync(fd), "Sync of new log");
+    std::lock_guard<std::mutex> l(logMutex_);
+    if (copyRecords(offset) > offset) {
+      checkRc(::fsync(fd), "Sync of new log");
+    }
+    checkRc(::rename(tempPath.c_str(), logPath.c_str()), "Rename of log");
+    ::close(evictLogFd_);
+    evictLogFd_ = fd;
+  } catch (const std::exception&) {
+    ::close(fd);
+    throw;
+  }
+}
+
+void SsdFile::logPendingEntries() {
+  uint64_t syncedSequence;
+  {
+    std::lock_guard<std::shared_mutex> l(mutex_);
+    syncedSequence = writeSequence_;
+  }
+  // The logged entries must refer to data that is on the device.
+  checkRc(::fsync(fd_), "Sync of cache data file");
+
+  std::vector<PendingEntry> entries;
+  std::unique_lock<std::mutex> logLock(logMutex_, std::defer_lock);
+  {
+    std::lock_guard<std::shared_mutex> l(mutex_);
+    const auto synced = std::find_if(
+        pendingEntries_.begin(), pendingEntries_.end(), [&](const auto& entry) {
+          return entry.sequence > syncedSequence;
+        });
+    entries.assign(
+        std::make_move_iterator(pendingEntries_.begin()),
+        std::make_move_iterator(synced));
+    pendingEntries_.erase(pendingEntries_.begin(), synced);
+    // An eviction of the region of one of 'entries' must be logged after it.
+    logLock.lock();
+  }
+
+  std::string records;
+  for (const auto& entry : entries) {
+    const auto fileNum = entry.key.fileNum.id();
+    if (loggedFileNums_.insert(fileNum).second) {
+      const auto name = fileIds().string(fileNum);
+      appendNumber(records, kLogFileName);
+      appendNumber(records, fileNum);
+      appendNumber<int32_t>(records, name.size());
+      records.append(name);
+    }
+    appendNumber(records, kLogEntry);
+    appendNumber(records, fileNum);
+    appendNumber(records, entry.key.offset);
+    appendNumber(records, entry.run.bits());
+  }
+  const auto rc = ::write(evictLogFd_, records.data(), records.size());
+  const auto logFd = evictLogFd_;
+  logLock.unlock();
+  if (rc != static_cast<ssize_t>(records.size())) {
+    ++stats_.writeCheckpointErrors;
+    checkRc(-1, "Write of log");
+  }
+  checkRc(::fsync(logFd), "Sync of log");
+  numLogEntries_ += entries.size();
+}
+
 void SsdFile::initializeCheckpoint() {
   if (checkpointIntervalBytes_ == 0) {
     return;
@@ -711,6 +1084,9 @@ void SsdFile::initializeCheckpoint() {
     if (hasCheckpoint) {
       state.exceptions(std::ifstream::failbit);
       readCheckpoint(state);
+      // New entries are logged after the recovered ones.
+      numCheckpointEntries_ = entries_.size();
+      needsFullCheckpoint_ = false;
     }
   } catch (const std::exception& e) {
     ++stats_.readCheckpointErrors;
@@ -718,6 +1094,7 @@ void SsdFile::initializeCheckpoint() {
       VELOX_SSD_CACHE_LOG(ERROR) << "Error recovering from checkpoint "
                                  << e.what() << ": Starting without checkpoint";
       entries_.clear();
+      numLogEntries_ = 0;
       deleteCheckpoint(true);
     } catch (const std::exception& e) {
     }
@@ -775,14 +1152,6 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
     idMap[id] = std::move(lease);
   }
 
-  const auto logSize = ::lseek(evictLogFd_, 0, SEEK_END);
-  std::vector<uint32_t> evicted(logSize / sizeof(uint32_t));
-  const auto rc = ::pread(evictLogFd_, evicted.data(), logSize, 0);
-  VELOX_CHECK_EQ(logSize, rc, "Failed to read eviction log");
-  std::unordered_set<uint32_t> evictedMap;
-  for (auto region : evicted) {
-    evictedMap.insert(region);
-  }
   for (;;) {
     const uint64_t fileNum = readNumber<uint64_t>(state);
     if (fileNum == kCheckpointEndMarker) {
@@ -790,23 +1159,15 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
     }
     const uint64_t offset = readNumber<uint64_t>(state);
     const auto run = SsdRun(readNumber<uint64_t>(state));
-    // Check that the recovered entry does not fall in an evicted region.
-    if (evictedMap.find(regionIndex(run.offset())) == evictedMap.end()) {
-      // The file may have a different id on restore.
-      auto it = idMap.find(fileNum);
-      VELOX_CHECK(it != idMap.end());
-      FileCacheKey key{it->second, offset};
-      entries_[std::move(key)] = run;
-    }
+    // The file may have a different id on restore.
+    auto it = idMap.find(fileNum);
+    VELOX_CHECK(it != idMap.end());
+    FileCacheKey key{it->second, offset};
+    entries_[std::move(key)] = run;
   }
-  // The state is successfully read. Install the access frequency scores and
-  // evicted regions.
+  replayLog();
+  // The state is successfully read. Install the access frequency scores.
   VELOX_CHECK_EQ(scores.size(), tracker_.regionScores().size());
-  // Set the writable regions by deduplicated evicted regions.
-  writableRegions_.clear();
-  for (auto region : evictedMap) {
-    writableRegions_.push_back(region);
-  }
   tracker_.setRegionScores(scores);
   VELOX_SSD_CACHE_LOG(INFO) << fmt::format(
       "Starting shard {} from checkpoint with {} entries, {} regions with {} free.",
@@ -816,4 +1177,86 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
       writableRegions_.size());
 }
 
+void SsdFile::replayLog() {
+  const auto logSize = ::lseek(evictLogFd_, 0, SEEK_END);
+  std::string log(logSize, '\0');
+  const auto rc = ::pread(evictLogFd_, log.data(), logSize, 0);
+  VELOX_CHECK_EQ(logSize, rc, "Failed to read eviction log");
+
+  // Record numbers of the last eviction of each region and of the last
+  // kLogEntry of each entry. The entries from the checkpoint precede all
+  // records.
+  std::vector<int64_t> lastEviction(maxRegions_, -1);
+  folly::F14FastMap<FileCacheKey, int64_t> lastLogged;
+  // The ids in the log may differ from those in the checkpoint and from
+  // those of earlier processes in the log.
+  std::unordered_map<uint64_t, StringIdLease> idMap;
+  const char* position = log.data();
+  const char* const end = log.data() + log.size();
+  // Reads 'value' or returns false if the log ends first, which happens if
+  // the process died while appending to it.
+  const auto read = [&](auto& value) {
+    if (end - position < static_cast<int64_t>(sizeof(value))) {
+      return false;
+    }
+    memcpy(&value, position, sizeof(value));
+    position += sizeof(value);
+    return true;
+  };
+
+  int32_t kind;
+  for (int64_t record = 0; read(kind); ++record) {
+    if (kind >= 0) {
+      VELOX_CHECK_LT(kind, maxRegions_, "Corrupt SSD cache log");
+      lastEviction[kind] = record;
+    } else if (kind == kLogFileName) {
+      uint64_t fileNum;
+      int32_t length;
+      if (!read(fileNum) || !read(length) || end - position < length) {
+        break;
+      }
+      idMap[fileNum] =
+          StringIdLease(fileIds(), std::string_view(position, length));
+      position += length;
+    } else if (kind == kLogEntry) {
+      uint64_t fileNum;
+      uint64_t offset;
+      uint64_t run;
+      if (!read(fileNum) || !read(offset) || !read(run)) {
+        break;
+      }
+      auto it = idMap.find(fileNum);
+      VELOX_CHECK(it != idMap.end(), "Corrupt SSD cache log");
+      FileCacheKey key{it->second, offset};
+      entries_[key] = SsdRun(run);
+      lastLogged[std::move(key)] = record;
+      ++numLogEntries_;
+    } else {
+      VELOX_FAIL("Corrupt SSD cache log record {}", kind);
+    }
+  }
+
+  std::vector<bool> hasEntries(maxRegions_);
+  auto it = entries_.begin();
+  while (it != entries_.end()) {
+    const auto region = regionIndex(it->second.offset());
+    VELOX_CHECK_LT(region, maxRegions_, "Corrupt SSD cache entry");
+    const auto logged = lastLogged.find(it->first);
+    const int64_t record = logged == lastLogged.end() ? -1 : logged->second;
+    if (lastEviction[region] > record) {
+      it = entries_.erase(it);
+    } else {
+      hasEntries[region] = true;
+      ++it;
+    }
+  }
+
+  writableRegions_.clear();
+  for (auto region = 0; region < numRegions_; ++region) {
+    if (lastEviction[region] >= 0 && !hasEntries[region]) {
+      writableRegions_.push_back(region);
+    }
+  }
+}
+
 } // namespace facebook::velox::cache
@@ -20,7 +20,9 @@
 #include "velox/common/caching/SsdFileTracker.h"
 #include "velox/common/file/File.h"
 
+#include <folly/container/F14Set.h>
 #include <gflags/gflags.h>
+#include <mutex>
 
 DECLARE_bool(ssd_odirect);
 DECLARE_bool(ssd_verify_write);
@@ -28,17 +30,20 @@ DECLARE_bool(ssd_verify_write);
 namespace facebook::velox::cache {
 
 // A 64 bit word describing a SSD cache entry in an SsdFile. The low
-// 23 bits are the size, for a maximum entry size of 8MB. The high
-// bits are the offset.
+// 23 bits are the size, for a maximum entry size of 8MB. The highest bit is
+// set if the entry is stored compressed. The bits in between are the offset.
 class SsdRun {
  public:
   static constexpr int32_t kSizeBits = 23;
+  static constexpr int32_t kOffsetBits = 63 - kSizeBits;
 
   SsdRun() : bits_(0) {}
 
-  SsdRun(uint64_t offset, uint32_t size)
-      : bits_((offset << kSizeBits) | ((size - 1))) {
-    VELOX_CHECK_LT(offset, 1L << (64 - kSizeBits));
+  SsdRun(uint64_t offset, uint32_t size, bool compressed = false)
+      : bits_(
+            (static_cast<uint64_t>(compressed) << 63) |
+            (offset << kSizeBits) | ((size - 1))) {
+    VELOX_CHECK_LT(offset, 1L << kOffsetBits);
     VELOX_CHECK_LT(size - 1, 1 << kSizeBits);
   }
 
@@ -55,13 +60,21 @@ class SsdRun {
   }
 
   uint64_t offset() const {
-    return (bits_ >> kSizeBits);
+    return (bits_ >> kSizeBits) & ((1UL << kOffsetBits) - 1);
   }
 
+  // Returns the number of bytes the entry takes on SSD. For a compressed
+  // entry this is the compressed size.
   uint32_t size() const {
     return (bits_ & ((1 << kSizeBits) - 1)) + 1;
   }
 
+  // Returns true if the entry is stored compressed, starting with a header
+  // that gives the compression kind and the uncompressed size.
+  bool compressed() const {
+    return bits_ >> 63;
+  }
+
   // Returns raw bits for serialization.
   uint64_t bits() const {
     return bits_;
@@ -134,6 +147,8 @@ struct SsdCacheStats {
     entriesCached = tsanAtomicValue(other.entriesCached);
     bytesCached = tsanAtomicValue(other.bytesCached);
     numPins = tsanAtomicValue(other.numPins);
+    entriesCompressed = tsanAtomicValue(other.entriesCompressed);
+    bytesSavedByCompression = tsanAtomicValue(other.bytesSavedByCompression);
 
     openFileErrors = tsanAtomicValue(other.openFileErrors);
     openCheckpointErrors = tsanAtomicValue(other.openCheckpointErrors);
@@ -153,6 +168,9 @@ struct SsdCacheStats {
   tsan_atomic<uint64_t> entriesCached{0};
   tsan_atomic<uint64_t> bytesCached{0};
   tsan_atomic<int32_t> numPins{0};
+  // Number of entries written compressed and the bytes saved by compression.
+  tsan_atomic<uint64_t> entriesCompressed{0};
+  tsan_atomic<uint64_t> bytesSavedByCompression{0};
 
   tsan_atomic<uint32_t> openFileErrors{0};
   tsan_atomic<uint32_t> openCheckpointErrors{0};
@@ -189,8 +207,12 @@ class SsdFile {
 
   // Adds entries of  'pins'  to this file. 'pins' must be in read mode and
   // those pins that are successfully added to SSD are marked as being on SSD.
-  // The file of the entries must be a file that is backed by 'this'.
-  void write(std::vector<CachePin>& pins);
+  // The file of the entries must be a file that is backed by 'this'. If
+  // 'groupStats' is given, entries of file groups that have an SSD
+  // compression are stored compressed when this saves space.
+  void write(
+      std::vector<CachePin>& pins,
+      const FileGroupStats* groupStats = nullptr);
 
   // Finds an entry for 'key'. If no entry is found, the returned pin is empty.
   SsdPin find(RawFileCacheKey key);
@@ -198,6 +220,15 @@ class SsdFile {
   // Erases 'key'
   bool erase(RawFileCacheKey key);
 
+  // Returns the keys and sizes of entries in the regions with the highest
+  // read scores, up to 'maxBytes' in total. The regions are in descending
+  // score order and the entries of a region are in ascending offset order, so
+  // that loads of consecutive entries coalesce. Compressed entries are left
+  // out since their uncompressed size is only known after reading them. Used
+  // for warming up the RAM cache after restarting from a checkpoint.
+  std::vector<std::pair<RawFileCacheKey, uint32_t>> hottestEntries(
+      uint64_t maxBytes);
+
   // Copies the data in 'ssdPins' into 'pins'. Coalesces IO for nearby
   // entries if they are in ascending order and near enough.
   CoalesceIoStats load(
@@ -245,15 +276,25 @@ class SsdFile {
   // Deletes the backing file. Used in testing.
   void deleteFile();
 
-  // Writes a checkpoint state that can be recovered from. The
-  // checkpoint is serialized on 'mutex_'. If 'force' is false,
-  // rechecks that at least 'checkpointIntervalBytes_' have been
-  // written since last checkpoint and silently returns if not.
+  // Writes a checkpoint state that can be recovered from. If 'force' is
+  // false, rechecks that at least 'checkpointIntervalBytes_' have been
+  // written since last checkpoint and silently returns if not or if another
+  // checkpoint is in progress. A checkpoint normally appends the entries
+  // written since the previous one to the log. If 'force' is true or the log
+  // has more entries than the checkpoint file, the checkpoint file is
+  // rewritten from a snapshot of the entries and the log is cut to the
+  // records after the snapshot. 'mutex_' is held only for taking snapshots,
+  // not for IO, so that checkpoints do not block reads.
   void checkpoint(bool force = false);
 
   /// Returns true if copy on write is disabled for this file. Used in testing.
   bool testingIsCowDisabled() const;
 
+  /// Replaces the ReadFile used for loads. If 'readFile' has a native
+  /// preadvAsync(), the coalesced reads of a load are submitted together.
+  /// Used in testing.
+  void testingSetReadFile(std::unique_ptr<ReadFile> readFile);
+
  private:
   // 4 first bytes of a checkpoint file. Allows distinguishing between format
   // versions.
@@ -264,18 +305,37 @@ class SsdFile {
   // Magic number at end of completed checkpoint file.
   static constexpr int64_t kCheckpointEndMarker = 0xcbedf11e;
 
+  // The log is a sequence of records that each start with an int32_t. An
+  // evicted region is logged as its non-negative index. The other records
+  // start with one of the below.
+  //
+  // Followed by {fileId, length, fileName}. Precedes the first entry of the
+  // file after the start of the log or the start of the process.
+  static constexpr int32_t kLogFileName = -1;
+  // Followed by {fileId, offset, SsdRun}.
+  static constexpr int32_t kLogEntry = -2;
+
+  // An entry of 'entries_' that is not yet in the log.
+  struct PendingEntry {
+    FileCacheKey key;
+    SsdRun run;
+    // Ascending in the order of writes.
+    uint64_t sequence;
+  };
+
   // Increments the pin count of the region of 'offset'. Caller must hold
   // 'mutex_'.
   void pinRegionLocked(uint64_t offset) {
     ++regionPins_[regionIndex(offset)];
   }
 
-  // Returns [offset, size] of contiguous space for storing data of a number of
-  // contiguous 'pins' starting with the pin at index 'begin'.  Returns nullopt
-  // if there is no space. The space does not necessarily cover all the pins, so
-  // multiple calls starting at the first unwritten pin may be needed.
+  // Returns [offset, size] of contiguous space for storing a number of
+  // contiguous entries of 'sizes' starting with the entry at index 'begin'.
+  // 'sizes' has the bytes each entry takes on SSD. Returns nullopt if there is
+  // no space. The space does not necessarily cover all the entries, so
+  // multiple calls starting at the first unwritten entry may be needed.
   std::optional<std::pair<uint64_t, int32_t>> getSpace(
-      const std::vector<CachePin>& pins,
+      const std::vector<uint32_t>& sizes,
       int32_t begin);
 
   // Removes all 'entries_' that reference data in regions described by
@@ -286,9 +346,25 @@ class SsdFile {
   // added to 'writableRegions_'. Returns true if regions could be cleared.
   bool growOrEvictLocked();
 
+  // Reads the compressed entries of 'ssdPins' into the matching 'pins' and
+  // decompresses them in place.
+  void loadCompressed(
+      const std::vector<SsdPin>& ssdPins,
+      const std::vector<CachePin>& pins);
+
   // Reads the backing file with ReadFile::preadv().
   void read(uint64_t offset, const std::vector<folly::Range<char*>>& buffers);
 
+  // A coalesced read deferred for submission with the other reads of a load.
+  struct ReadBatch {
+    uint64_t offset;
+    std::vector<folly::Range<char*>> buffers;
+  };
+
+  // Submits all of 'batches' with ReadFile::preadvAsync() and waits for all
+  // to complete. This keeps the device queue full for loads of many runs.
+  void readBatches(const std::vector<ReadBatch>& batches);
+
   // Verifies that 'entry' has the data at 'run'.
   void verifyWrite(AsyncDataCacheEntry& entry, SsdRun run);
 
@@ -301,6 +377,22 @@ class SsdFile {
   // deletes the checkpoint and leaves the log truncated open.
   void readCheckpoint(std::ifstream& state);
 
+  // Applies the log to the entries read from the checkpoint. An entry is kept
+  // if its region was not evicted after the entry was checkpointed or logged.
+  // The evicted regions without entries become writable.
+  void replayLog();
+
+  // Writes the checkpoint file from a snapshot of 'entries_' and cuts the log
+  // to the records after the snapshot.
+  void writeCheckpoint();
+
+  // Replaces the log with its records from 'offset' on.
+  void compactLog(int64_t offset);
+
+  // Syncs the data file and appends the entries written before the sync to
+  // the log.
+  void logPendingEntries();
+
   // Logs an error message, deletes the checkpoint and stop making new
   // checkpoints.
   void checkpointError(int32_t rc, const std::string& error);
@@ -318,6 +410,9 @@ class SsdFile {
 
   static constexpr const char* kLogExtension = ".log";
   static constexpr const char* kCheckpointExtension = ".cpt";
+  // Suffix of a checkpoint or log file being written before it is renamed
+  // over the previous one.
+  static constexpr const char* kTempExtension = ".tmp";
 
   // Name of cache file, used as prefix for checkpoint files.
   const std::string fileName_;
@@ -325,9 +420,16 @@ class SsdFile {
   // Maximum size of the backing file in kRegionSize units.
   const int32_t maxRegions_;
 
-  // Serializes access to all private data members.
+  // Serializes access to all private data members not documented otherwise.
   mutable std::shared_mutex mutex_;
 
+  // Serializes checkpoints.
+  std::mutex checkpointMutex_;
+
+  // Serializes writes to the log and changes of 'evictLogFd_'. Acquired after
+  // 'mutex_' if both are held.
+  std::mutex logMutex_;
+
   // Shard index within 'cache_'.
   int32_t shardId_;
 
@@ -379,11 +481,35 @@ class SsdFile {
   // Count of bytes written after last checkpoint.
   std::atomic<uint64_t> bytesAfterCheckpoint_{0};
 
-  // fd for logging evictions.
+  // fd for logging evictions and entries.
   int32_t evictLogFd_{-1};
 
   // True if there was an error with checkpoint and the checkpoint was deleted.
+  // Guarded by 'logMutex_'.
   bool checkpointDeleted_{false};
+
+  // Entries written since the last checkpoint, in write order. Entries of
+  // evicted regions are removed since they may not be logged after the
+  // eviction.
+  std::vector<PendingEntry> pendingEntries_;
+
+  // Sequence number of the last entry added to 'pendingEntries_'.
+  uint64_t writeSequence_{0};
+
+  // True if the next checkpoint must rewrite the checkpoint file, e.g. if
+  // there is no checkpoint to append to or after clear().
+  std::atomic<bool> needsFullCheckpoint_{true};
+
+  // Below members are guarded by 'checkpointMutex_'.
+
+  // Ids of the files with a kLogFileName record in the log.
+  folly::F14FastSet<uint64_t> loggedFileNums_;
+
+  // Number of kLogEntry records in the log.
+  uint64_t numLogEntries_{0};
+
+  // Number of entries in the checkpoint file.
+  uint64_t numCheckpointEntries_{0};
 };
 
 } // namespace facebook::velox::cache
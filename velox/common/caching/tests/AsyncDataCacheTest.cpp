@@ -200,6 +200,22 @@ class AsyncDataCacheTest : public testing::Test {
     };
   }
 
+  // Reads the entry at 'offset' of the first file. Returns true on a hit. A
+  // miss creates the entry and sets it to shared mode without a read.
+  bool readEntry(
+      uint64_t offset,
+      int32_t size,
+      int32_t partition = kDefaultCachePartition) {
+    RawFileCacheKey key{filenames_[0].id(), offset};
+    auto pin = cache_->findOrCreate(key, size, nullptr, partition);
+    VELOX_CHECK(!pin.empty());
+    if (pin.entry()->isExclusive()) {
+      pin.entry()->setExclusiveToShared();
+      return false;
+    }
+    return true;
+  }
+
   folly::IOThreadPoolExecutor* executor() {
     static std::mutex mutex;
     std::lock_guard<std::mutex> l(mutex);
@@ -606,6 +622,228 @@ TEST_F(AsyncDataCacheTest, outOfCapacity) {
   clearAllocations(allocations);
 }
 
+TEST_F(AsyncDataCacheTest, tinyLfuAdmission) {
+  TinyLfuAdmission admission(1 << 10, 2);
+  const RawFileCacheKey key{1, 100};
+  const RawFileCacheKey otherKey{1, 200};
+  admission.recordAccess(key);
+  ASSERT_GE(admission.frequency(key), 1);
+  ASSERT_FALSE(admission.admit(otherKey, 100));
+  admission.recordAccess(key);
+  ASSERT_TRUE(admission.admit(key, 100));
+
+  // The counters saturate and decay, so that old popularity fades.
+  for (auto i = 0; i < 100; ++i) {
+    admission.recordAccess(key);
+  }
+  ASSERT_EQ(admission.frequency(key), 15);
+  for (auto i = 0; i < 100'000; ++i) {
+    admission.recordAccess(otherKey);
+  }
+  ASSERT_LT(admission.frequency(key), 2);
+
+  initializeCache(64 << 20);
+  cache_->setAdmissionPolicy(
+      []() { return std::make_unique<TinyLfuAdmission>(); });
+  constexpr int32_t kSize = 16 << 10;
+  RawFileCacheKey cacheKey{filenames_[0].id(), 0};
+  {
+    // A new key is not admitted. Its entry is still made for the read but is
+    // the first to evict.
+    auto pin = cache_->findOrCreate(cacheKey, kSize, nullptr);
+    ASSERT_TRUE(pin.entry()->isExclusive());
+    ASSERT_EQ(
+        pin.entry()->score(accessTime()), std::numeric_limits<int32_t>::max());
+    pin.entry()->setExclusiveToShared();
+  }
+  ASSERT_EQ(cache_->refreshStats().numRejected, 1);
+
+  // A hit makes the entry retainable.
+  ASSERT_TRUE(readEntry(0, kSize));
+  auto pin = cache_->findOrCreate(cacheKey, kSize, nullptr);
+  ASSERT_LT(
+      pin.entry()->score(accessTime()), std::numeric_limits<int32_t>::max());
+}
+
+TEST_F(AsyncDataCacheTest, segmentedEviction) {
+  constexpr int64_t kMaxBytes = 64 << 20;
+  constexpr int32_t kSize = 256 << 10;
+  constexpr int32_t kNumHot = 32;
+  initializeCache(kMaxBytes);
+  cache_->setProtectedPct(50);
+
+  // Read the hot entries twice to move them to the protected segment.
+  for (auto i = 0; i < kNumHot; ++i) {
+    ASSERT_FALSE(readEntry(i * kSize, kSize));
+    ASSERT_TRUE(readEntry(i * kSize, kSize));
+  }
+  auto stats = cache_->refreshStats();
+  ASSERT_EQ(stats.numProtected, kNumHot);
+  ASSERT_EQ(stats.protectedBytes, kNumHot * kSize);
+
+  // A scan of 4x the cache capacity does not evict the hot entries.
+  const uint64_t scanStart = kNumHot * kSize;
+  for (auto i = 0; i < 4 * kMaxBytes / kSize; ++i) {
+    ASSERT_FALSE(readEntry(scanStart + i * kSize, kSize));
+  }
+  stats = cache_->refreshStats();
+  ASSERT_GT(stats.numEvict, 0);
+  for (auto i = 0; i < kNumHot; ++i) {
+    ASSERT_TRUE(readEntry(i * kSize, kSize)) << i;
+  }
+  ASSERT_GT(cache_->refreshStats().hitRate(), 0);
+
+  // Without segments, the protected state is dropped.
+  cache_->setProtectedPct(0);
+  ASSERT_EQ(cache_->refreshStats().numProtected, 0);
+  ASSERT_EQ(cache_->refreshStats().protectedBytes, 0);
+}
+
+TEST_F(AsyncDataCacheTest, partitions) {
+  constexpr int64_t kMaxBytes = 64 << 20;
+  constexpr int32_t kSize = 256 << 10;
+  constexpr int64_t kHotQuota = 16 << 20;
+  constexpr int64_t kCappedQuota = 4 << 20;
+  initializeCache(kMaxBytes);
+  const auto hot =
+      cache_->addPartition({.name = "hot", .quotaBytes = kHotQuota});
+  const auto capped = cache_->addPartition(
+      {.name = "capped", .quotaBytes = kCappedQuota, .canBorrow = false});
+  const auto noSsd =
+      cache_->addPartition({.name = "noSsd", .saveToSsd = false});
+  ASSERT_EQ(cache_->partitionId("hot"), hot);
+  ASSERT_EQ(cache_->partitionId("capped"), capped);
+  ASSERT_EQ(cache_->partitionId("unknown"), kDefaultCachePartition);
+  ASSERT_TRUE(cache_->savesToSsd(hot));
+  ASSERT_FALSE(cache_->savesToSsd(noSsd));
+  VELOX_ASSERT_THROW(
+      cache_->addPartition({.name = "hot"}), "Duplicate cache partition hot");
+
+  // Fill the quota of 'hot' with entries that are read once.
+  constexpr int32_t kNumHot = kHotQuota / kSize;
+  for (auto i = 0; i < kNumHot; ++i) {
+    ASSERT_FALSE(readEntry(i * kSize, kSize, hot));
+  }
+
+  // A scan of 4x the cache capacity in the default partition evicts only its
+  // own entries since 'hot' is within its quota.
+  const uint64_t scanStart = kNumHot * kSize;
+  for (auto i = 0; i < 4 * kMaxBytes / kSize; ++i) {
+    ASSERT_FALSE(readEntry(scanStart + i * kSize, kSize));
+  }
+  for (auto i = 0; i < kNumHot; ++i) {
+    ASSERT_TRUE(readEntry(i * kSize, kSize, hot)) << i;
+  }
+
+  // 'capped' may not borrow, so its entries evict each other.
+  const uint64_t cappedStart = scanStart + 4 * kMaxBytes;
+  constexpr int32_t kNumCapped = 2 * kCappedQuota / kSize;
+  for (auto i = 0; i < kNumCapped; ++i) {
+    ASSERT_FALSE(readEntry(cappedStart + i * kSize, kSize, capped));
+  }
+  ASSERT_TRUE(
+      readEntry(cappedStart + (kNumCapped - 1) * kSize, kSize, capped));
+
+  const auto stats = cache_->refreshStats();
+  ASSERT_EQ(stats.partitions.size(), 4);
+  ASSERT_EQ(stats.partitions[kDefaultCachePartition].name, "default");
+  ASSERT_GT(stats.partitions[kDefaultCachePartition].numEvict, 0);
+  const auto& hotStats = stats.partitions[hot];
+  ASSERT_EQ(hotStats.cachedBytes, kHotQuota);
+  ASSERT_EQ(hotStats.numNew, kNumHot);
+  ASSERT_EQ(hotStats.numHit, kNumHot);
+  ASSERT_EQ(hotStats.hitBytes, kHotQuota);
+  ASSERT_EQ(hotStats.numEvict, 0);
+  const auto& cappedStats = stats.partitions[capped];
+  ASSERT_LE(cappedStats.cachedBytes, kCappedQuota);
+  ASSERT_EQ(cappedStats.numNew, kNumCapped);
+  ASSERT_GE(cappedStats.numEvict, kNumCapped - kCappedQuota / kSize);
+  ASSERT_EQ(stats.partitions[noSsd].cachedBytes, 0);
+}
+
+TEST_F(AsyncDataCacheTest, concurrentHits) {
+  constexpr int32_t kNumEntries = 100;
+  constexpr int32_t kSize = 4096;
+  constexpr int32_t kNumThreads = 16;
+  constexpr int32_t kNumLookups = 10'000;
+  initializeCache(64 << 20);
+  cache_->setProtectedPct(50);
+  for (auto i = 0; i < kNumEntries; ++i) {
+    ASSERT_FALSE(readEntry(i * kSize, kSize));
+  }
+  // The first hit moves the entries to the protected segment. After this,
+  // hits do not change the state of the shards.
+  for (auto i = 0; i < kNumEntries; ++i) {
+    ASSERT_TRUE(readEntry(i * kSize, kSize));
+  }
+  ASSERT_EQ(cache_->refreshStats().numProtected, kNumEntries);
+
+  std::vector<std::thread> threads;
+  threads.reserve(kNumThreads);
+  for (auto i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      for (auto j = 0; j < kNumLookups; ++j) {
+        const auto offset = ((i + j) % kNumEntries) * kSize;
+        auto pin = cache_->findOrCreate(
+            RawFileCacheKey{filenames_[0].id(), uint64_t(offset)},
+            kSize,
+            nullptr);
+        ASSERT_FALSE(pin.empty());
+        ASSERT_FALSE(pin.checkedEntry()->isExclusive());
+        ASSERT_GE(pin.checkedEntry()->numPins(), 1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const auto stats = cache_->refreshStats();
+  ASSERT_EQ(stats.numHit, kNumEntries + kNumThreads * kNumLookups);
+  ASSERT_EQ(stats.numNew, kNumEntries);
+  ASSERT_EQ(stats.numShared, 0);
+  ASSERT_EQ(stats.numProtected, kNumEntries);
+}
+
+TEST_F(AsyncDataCacheTest, trackingHistory) {
+  constexpr int32_t kLoadQuantum = 8 << 20;
+  constexpr uint64_t kGroupId = 11;
+  initializeCache(16 << 20);
+  auto& history = cache_->trackingHistory();
+  const TrackingId readId(1);
+  const TrackingId skippedId(2);
+
+  // Each query has its own tracker and all report to the same history.
+  for (auto query = 0; query < 4; ++query) {
+    ScanTracker tracker(
+        fmt::format("query{}", query),
+        nullptr,
+        kLoadQuantum,
+        nullptr,
+        &history);
+    tracker.recordReference(readId, 1000, 1, kGroupId);
+    tracker.recordRead(readId, 1000, 1, kGroupId);
+    tracker.recordReference(skippedId, 1000, 1, kGroupId);
+  }
+  auto data = history.trackingData(kGroupId, readId);
+  ASSERT_EQ(data.numReferences, 4);
+  ASSERT_EQ(data.numReads, 4);
+  ASSERT_EQ(data.readBytes, 4000);
+  data = history.trackingData(kGroupId, skippedId);
+  ASSERT_EQ(data.numReferences, 4);
+  ASSERT_EQ(data.numReads, 0);
+  ASSERT_EQ(history.trackingData(kGroupId + 1, readId).numReferences, 0);
+  ASSERT_EQ(history.size(), 2);
+
+  // The counts decay as other streams are referenced.
+  const TrackingId otherId(3);
+  for (auto i = 0; i < TrackingHistory::kDecayReferences; ++i) {
+    history.recordReference(kGroupId + 1, otherId, 100, kLoadQuantum);
+  }
+  data = history.trackingData(kGroupId, readId);
+  ASSERT_EQ(data.numReferences, 2);
+  ASSERT_EQ(data.numReads, 2);
+}
+
 namespace {
 // Cuts off the last 1/10th of file at 'path'.
 void corruptFile(const std::string& path) {
@@ -691,6 +929,51 @@ TEST_F(AsyncDataCacheTest, ssd) {
   ASSERT_EQ(ssdStatsFromCP.readCheckpointErrors, 1);
 }
 
+TEST_F(AsyncDataCacheTest, ssdWarmUp) {
+  constexpr uint64_t kRamBytes = 64 << 20;
+  constexpr uint64_t kSsdBytes = 256UL << 20;
+  constexpr uint64_t kWarmUpBytes = 16 << 20;
+  initializeCache(kRamBytes, kSsdBytes);
+  runThreads(4, [&](int32_t /*i*/) { loadLoop(0, kSsdBytes / 2); });
+  // Wait for writes to finish and make a checkpoint.
+  cache_->ssdCache()->shutdown();
+  ASSERT_GT(cache_->ssdCache()->stats().entriesWritten, 0);
+
+  // Restart from the checkpoint. The RAM cache starts empty.
+  initializeCache(kRamBytes, kSsdBytes);
+  ASSERT_EQ(cache_->refreshStats().numEntries, 0);
+  auto* ssdCache = cache_->ssdCache();
+  ssdCache->startWarmUp(*cache_, kWarmUpBytes);
+  while (ssdCache->warmUpStats().numPendingShards > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10)); // NOLINT
+  }
+  const auto warmUpStats = ssdCache->warmUpStats();
+  ASSERT_EQ(warmUpStats.targetBytes, kWarmUpBytes);
+  ASSERT_GT(warmUpStats.loadedEntries, 0);
+  ASSERT_LE(warmUpStats.loadedBytes, kWarmUpBytes);
+  const auto stats = cache_->refreshStats();
+  ASSERT_EQ(stats.numEntries, warmUpStats.loadedEntries);
+  ASSERT_EQ(stats.numShared, 0);
+  ASSERT_EQ(stats.numExclusive, 0);
+  ASSERT_GT(stats.numPrefetch, 0);
+
+  // The warmed up entries are in RAM and have the SSD contents.
+  uint64_t numInRam = 0;
+  for (auto i = 0; i < kNumFiles; ++i) {
+    auto& file = ssdCache->file(filenames_[i].id());
+    for (const auto& [key, size] : file.hottestEntries(kSsdBytes)) {
+      if (key.fileNum != filenames_[i].id() || !cache_->exists(key)) {
+        continue;
+      }
+      ++numInRam;
+      auto pin = cache_->findOrCreate(key, size, nullptr);
+      ASSERT_TRUE(pin.checkedEntry()->isShared());
+      checkContents(*pin.checkedEntry());
+    }
+  }
+  ASSERT_EQ(numInRam, warmUpStats.loadedEntries);
+}
+
 TEST_F(AsyncDataCacheTest, invalidSsdPath) {
   auto testPath = "hdfs:/test/prefix_";
   uint64_t ssdBytes = 256UL << 20;
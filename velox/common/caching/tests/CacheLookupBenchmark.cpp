@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Random.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <thread>
+
+#include "velox/common/caching/AsyncDataCache.h"
+#include "velox/common/caching/FileIds.h"
+#include "velox/common/memory/MmapAllocator.h"
+#include "velox/common/time/Timer.h"
+
+DEFINE_uint32(num_entries, 10'000, "The number of cached entries");
+DEFINE_uint32(entry_size, 4096, "The size of a cached entry in bytes");
+DEFINE_uint32(
+    max_threads,
+    128,
+    "The max number of lookup threads. Runs with 1, 2, 4, ... threads up to "
+    "this");
+DEFINE_uint32(
+    num_lookups_per_thread,
+    1'000'000,
+    "The number of lookups of existing entries per thread");
+
+using namespace facebook::velox;
+using namespace facebook::velox::cache;
+
+namespace {
+// Measures the throughput of AsyncDataCache::findOrCreate() for entries that
+// are in the cache, as is the case for repeat scans of hot data by many
+// drivers.
+class CacheLookupBenchmark {
+ public:
+  CacheLookupBenchmark()
+      : file_(fileIds(), std::string_view("cache_lookup_benchmark_file")) {
+    memory::MmapAllocator::Options options;
+    options.capacity = std::max<uint64_t>(
+        64 << 20, 2 * uint64_t(FLAGS_num_entries) * FLAGS_entry_size);
+    allocator_ = std::make_shared<memory::MmapAllocator>(options);
+    cache_ = AsyncDataCache::create(allocator_.get());
+    for (auto i = 0; i < FLAGS_num_entries; ++i) {
+      auto pin = cache_->findOrCreate(key(i), FLAGS_entry_size, nullptr);
+      VELOX_CHECK(!pin.empty());
+      pin.checkedEntry()->setExclusiveToShared();
+    }
+  }
+
+  ~CacheLookupBenchmark() {
+    cache_->shutdown();
+  }
+
+  // Returns the lookups per second with 'numThreads' threads.
+  double run(int32_t numThreads) {
+    std::atomic<uint64_t> numMisses{0};
+    uint64_t runTimeUs{0};
+    {
+      MicrosecondTimer timer(&runTimeUs);
+      std::vector<std::thread> threads;
+      threads.reserve(numThreads);
+      for (auto i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&, i]() {
+          folly::Random::DefaultGenerator rng(i);
+          for (auto j = 0; j < FLAGS_num_lookups_per_thread; ++j) {
+            const auto index = folly::Random::rand32(rng) % FLAGS_num_entries;
+            auto pin =
+                cache_->findOrCreate(key(index), FLAGS_entry_size, nullptr);
+            if (pin.empty() || pin.checkedEntry()->isExclusive()) {
+              ++numMisses;
+            }
+          }
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    }
+    VELOX_CHECK_EQ(numMisses, 0, "Entries were evicted during the benchmark");
+    return numThreads * uint64_t(FLAGS_num_lookups_per_thread) * 1'000'000.0 /
+        std::max<uint64_t>(1, runTimeUs);
+  }
+
+ private:
+  RawFileCacheKey key(int32_t index) const {
+    return RawFileCacheKey{file_.id(), uint64_t(index) * FLAGS_entry_size};
+  }
+
+  StringIdLease file_;
+  std::shared_ptr<memory::MmapAllocator> allocator_;
+  std::shared_ptr<AsyncDataCache> cache_;
+};
+} // namespace
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  CacheLookupBenchmark benchmark;
+  LOG(INFO) << "\n\t\tTHREADS\t\tLOOKUPS/S";
+  for (int32_t numThreads = 1; numThreads <= FLAGS_max_threads;
+       numThreads *= 2) {
+    LOG(INFO) << "\t\t" << numThreads << "\t\t"
+              << static_cast<uint64_t>(benchmark.run(numThreads));
+  }
+  return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/PeerCache.h"
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/caching/FileIds.h"
+#include "velox/common/memory/MmapAllocator.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::cache;
+
+namespace {
+struct Worker;
+
+// Connects the workers of a test cluster in process.
+using Cluster = std::unordered_map<std::string, Worker*>;
+
+class TestPeerCache : public PeerCache {
+ public:
+  TestPeerCache(
+      std::vector<std::string> peers,
+      int32_t selfIndex,
+      const Cluster& cluster)
+      : PeerCache(std::move(peers), selfIndex), cluster_(cluster) {}
+
+ protected:
+  bool readFromPeer(
+      const std::string& peer,
+      const std::string& fileName,
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) override;
+
+ private:
+  const Cluster& cluster_;
+};
+
+struct Worker {
+  Worker(std::vector<std::string> peers, int32_t selfIndex, Cluster& cluster) {
+    memory::MmapAllocator::Options options;
+    options.capacity = 64 << 20;
+    allocator = std::make_shared<memory::MmapAllocator>(options);
+    cache = AsyncDataCache::create(allocator.get());
+    cache->setPeerCache(
+        std::make_unique<TestPeerCache>(peers, selfIndex, cluster));
+    cluster[peers[selfIndex]] = this;
+  }
+
+  ~Worker() {
+    cache->shutdown();
+  }
+
+  PeerCache& peerCache() {
+    return *cache->peerCache();
+  }
+
+  std::shared_ptr<memory::MmapAllocator> allocator;
+  std::shared_ptr<AsyncDataCache> cache;
+};
+
+bool TestPeerCache::readFromPeer(
+    const std::string& peer,
+    const std::string& fileName,
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) {
+  auto it = cluster_.find(peer);
+  VELOX_CHECK(it != cluster_.end(), "Unreachable peer {}", peer);
+  uint64_t size = 0;
+  for (const auto& buffer : buffers) {
+    size += buffer.size();
+  }
+  std::string data(size, 0);
+  auto* worker = it->second;
+  if (!worker->peerCache().serve(
+          *worker->cache, fileName, offset, size, data.data())) {
+    return false;
+  }
+  uint64_t copied = 0;
+  for (const auto& buffer : buffers) {
+    ::memcpy(buffer.data(), data.data() + copied, buffer.size());
+    copied += buffer.size();
+  }
+  return true;
+}
+
+// Creates the entry for 'key' in 'cache' and fills it with bytes that depend
+// on the offset.
+void fillEntry(AsyncDataCache& cache, RawFileCacheKey key, int32_t size) {
+  auto pin = cache.findOrCreate(key, size, nullptr);
+  ASSERT_TRUE(pin.checkedEntry()->isExclusive());
+  auto* entry = pin.checkedEntry();
+  auto& data = entry->data();
+  char* tiny = entry->tinyData();
+  for (auto i = 0; i < size; ++i) {
+    const char value = (key.offset + i) % 251;
+    if (tiny != nullptr) {
+      tiny[i] = value;
+    } else {
+      data.runAt(0).data<char>()[i] = value;
+    }
+  }
+  entry->setExclusiveToShared();
+}
+} // namespace
+
+TEST(PeerCacheTest, assignment) {
+  const std::vector<std::string> peers{"w0:1", "w1:1", "w2:1", "w3:1"};
+  Cluster cluster;
+  TestPeerCache peerCache(peers, 0, cluster);
+  constexpr int32_t kNumRanges = 1000;
+  std::vector<int32_t> numRanges(peers.size());
+  std::vector<int32_t> assignment;
+  for (auto i = 0; i < kNumRanges; ++i) {
+    const auto peer =
+        peerCache.peerFor("file", i * PeerCache::kDefaultRangeBytes);
+    ASSERT_EQ(
+        peer,
+        peerCache.peerFor("file", i * PeerCache::kDefaultRangeBytes + 100));
+    ++numRanges[peer];
+    assignment.push_back(peer);
+  }
+  for (auto count : numRanges) {
+    ASSERT_GT(count, kNumRanges / static_cast<int32_t>(peers.size()) / 2);
+  }
+
+  // Removing a peer moves only the ranges that were assigned to it.
+  TestPeerCache smaller({"w0:1", "w1:1", "w2:1"}, 0, cluster);
+  for (auto i = 0; i < kNumRanges; ++i) {
+    const auto peer =
+        smaller.peerFor("file", i * PeerCache::kDefaultRangeBytes);
+    if (assignment[i] != 3) {
+      ASSERT_EQ(peer, assignment[i]);
+    }
+  }
+}
+
+TEST(PeerCacheTest, load) {
+  constexpr int32_t kSize = 1000;
+  const std::vector<std::string> peers{"w0:1", "w1:1"};
+  Cluster cluster;
+  Worker local(peers, 0, cluster);
+  Worker remote(peers, 1, cluster);
+  const std::string fileName = "peer_cache_test_file";
+  StringIdLease file(fileIds(), fileName);
+
+  // Finds a range assigned to each worker.
+  uint64_t localOffset = 0;
+  while (local.peerCache().peerFor(fileName, localOffset) != 0) {
+    localOffset += PeerCache::kDefaultRangeBytes;
+  }
+  uint64_t remoteOffset = 0;
+  while (local.peerCache().peerFor(fileName, remoteOffset) != 1) {
+    remoteOffset += PeerCache::kDefaultRangeBytes;
+  }
+
+  // The remote worker does not have the entry.
+  const RawFileCacheKey remoteKey{file.id(), remoteOffset};
+  {
+    auto pin = local.cache->findOrCreate(remoteKey, kSize, nullptr);
+    ASSERT_FALSE(local.peerCache().load(*pin.checkedEntry()));
+  }
+  ASSERT_EQ(local.peerCache().stats().numReads, 1);
+  ASSERT_EQ(local.peerCache().stats().numHits, 0);
+
+  fillEntry(*remote.cache, remoteKey, kSize);
+  {
+    auto pin = local.cache->findOrCreate(remoteKey, kSize, nullptr);
+    auto* entry = pin.checkedEntry();
+    ASSERT_TRUE(entry->isExclusive());
+    ASSERT_TRUE(local.peerCache().load(*entry));
+    for (auto i = 0; i < kSize; ++i) {
+      ASSERT_EQ(entry->tinyData()[i], char((remoteOffset + i) % 251));
+    }
+    entry->setExclusiveToShared();
+  }
+  auto stats = local.peerCache().stats();
+  ASSERT_EQ(stats.numReads, 2);
+  ASSERT_EQ(stats.numHits, 1);
+  ASSERT_EQ(stats.hitBytes, kSize);
+  ASSERT_EQ(remote.peerCache().stats().numServed, 1);
+
+  // A range assigned to this worker is not requested from a peer.
+  fillEntry(*remote.cache, RawFileCacheKey{file.id(), localOffset}, kSize);
+  {
+    auto pin = local.cache->findOrCreate(
+        RawFileCacheKey{file.id(), localOffset}, kSize, nullptr);
+    ASSERT_FALSE(local.peerCache().load(*pin.checkedEntry()));
+  }
+  ASSERT_EQ(local.peerCache().stats().numReads, 2);
+
+  // A peer that fails counts as an error.
+  cluster.erase("w1:1");
+  {
+    auto pin = local.cache->findOrCreate(
+        RawFileCacheKey{file.id(), remoteOffset + 100}, kSize, nullptr);
+    ASSERT_FALSE(local.peerCache().load(*pin.checkedEntry()));
+  }
+  ASSERT_EQ(local.peerCache().stats().numErrors, 1);
+}
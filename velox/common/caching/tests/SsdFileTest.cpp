@@ -19,6 +19,7 @@
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 #include <folly/executors/QueuedImmediateExecutor.h>
+#include <filesystem>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
@@ -37,6 +38,30 @@ struct TestEntry {
       : key(_key), ssdOffset(_ssdOffset), size(_size) {}
 };
 
+namespace {
+// A LocalReadFile that reports a native preadvAsync() and counts the reads
+// submitted through it.
+class AsyncLocalReadFile : public LocalReadFile {
+ public:
+  AsyncLocalReadFile(std::string_view path, std::atomic<int32_t>& numReads)
+      : LocalReadFile(path), numReads_(numReads) {}
+
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const override {
+    ++numReads_;
+    return LocalReadFile::preadvAsync(offset, buffers);
+  }
+
+  bool hasPreadvAsync() const override {
+    return true;
+  }
+
+ private:
+  std::atomic<int32_t>& numReads_;
+};
+} // namespace
+
 class SsdFileTest : public testing::Test {
  protected:
   static constexpr int64_t kMB = 1 << 20;
@@ -53,22 +78,35 @@ class SsdFileTest : public testing::Test {
   void initializeCache(
       int64_t maxBytes,
       int64_t ssdBytes = 0,
-      bool setNoCowFlag = false) {
+      bool setNoCowFlag = false,
+      int64_t checkpointIntervalBytes = 0) {
     // tmpfs does not support O_DIRECT, so turn this off for testing.
     FLAGS_ssd_odirect = false;
+    if (cache_ != nullptr) {
+      cache_->shutdown();
+    }
     cache_ = AsyncDataCache::create(MemoryAllocator::getInstance());
 
     fileName_ = StringIdLease(fileIds(), "fileInStorage");
 
-    tempDirectory_ = exec::test::TempDirectoryPath::create();
+    // Make a new tempDirectory only if one is not already set. A second
+    // SsdFile must find the checkpoint of the previous one.
+    if (tempDirectory_ == nullptr) {
+      tempDirectory_ = exec::test::TempDirectoryPath::create();
+    }
     ssdFile_ = std::make_unique<SsdFile>(
         fmt::format("{}/ssdtest", tempDirectory_->path),
         0, // shardId
         bits::roundUp(ssdBytes, SsdFile::kRegionSize) / SsdFile::kRegionSize,
-        0, // checkpointInternalBytes
+        checkpointIntervalBytes,
         setNoCowFlag);
   }
 
+  uint64_t checkpointFileSize(const std::string& extension) {
+    return std::filesystem::file_size(
+        fmt::format("{}/ssdtest{}", tempDirectory_->path, extension));
+  }
+
   static void initializeContents(int64_t sequence, memory::Allocation& alloc) {
     bool first = true;
     for (int32_t i = 0; i < alloc.numRuns(); ++i) {
@@ -299,6 +337,177 @@ TEST_F(SsdFileTest, writeAndRead) {
   }
 }
 
+TEST_F(SsdFileTest, incrementalCheckpoint) {
+  constexpr int64_t kSsdSize = 2 * SsdFile::kRegionSize;
+  constexpr int64_t kBatchSize = 20 * kMB;
+  const auto writeBatch = [&](int32_t batch) {
+    auto pins = makePins(
+        fileName_.id(), batch * kBatchSize, 4096, 2048 * 1025, kBatchSize);
+    ssdFile_->write(pins);
+  };
+  const auto readBatches = [&](int32_t numBatches) {
+    for (auto batch = 0; batch < numBatches; ++batch) {
+      readAndCheckPins(makePins(
+          fileName_.id(), batch * kBatchSize, 4096, 2048 * 1025, kBatchSize));
+    }
+  };
+
+  // Checkpoint after every write. The first checkpoint writes the checkpoint
+  // file, the next ones append the new entries to the log.
+  initializeCache(128 * kMB, kSsdSize, false, 1);
+  writeBatch(0);
+  const auto checkpointSize = checkpointFileSize(".cpt");
+  EXPECT_EQ(0, checkpointFileSize(".log"));
+  writeBatch(1);
+  writeBatch(2);
+  EXPECT_EQ(checkpointSize, checkpointFileSize(".cpt"));
+  auto logSize = checkpointFileSize(".log");
+  EXPECT_LT(0, logSize);
+
+  // Recover from the checkpoint and the log and continue appending to the
+  // log.
+  initializeCache(128 * kMB, kSsdSize, false, 1);
+  readBatches(3);
+  writeBatch(3);
+  EXPECT_EQ(checkpointSize, checkpointFileSize(".cpt"));
+  EXPECT_LT(logSize, checkpointFileSize(".log"));
+
+  // A forced checkpoint rewrites the checkpoint file and empties the log.
+  ssdFile_->checkpoint(true);
+  EXPECT_LT(checkpointSize, checkpointFileSize(".cpt"));
+  EXPECT_EQ(0, checkpointFileSize(".log"));
+  initializeCache(128 * kMB, kSsdSize, false, 1);
+  readBatches(4);
+
+  // Fill the file past its capacity so that regions get evicted and
+  // rewritten between checkpoints. The recovered entries must not be in
+  // regions evicted after they were logged.
+  for (auto batch = 4; batch < 9; ++batch) {
+    writeBatch(batch);
+  }
+  initializeCache(128 * kMB, kSsdSize, false, 1);
+  int32_t numFound = 0;
+  for (auto batch = 0; batch < 9; ++batch) {
+    auto pins = makePins(
+        fileName_.id(), batch * kBatchSize, 4096, 2048 * 1025, kBatchSize);
+    for (auto& pin : pins) {
+      std::vector<SsdPin> ssdPins;
+      ssdPins.push_back(ssdFile_->find(
+          RawFileCacheKey{fileName_.id(), pin.entry()->key().offset}));
+      if (ssdPins.back().empty()) {
+        continue;
+      }
+      ++numFound;
+      std::vector<CachePin> loadPins;
+      loadPins.push_back(std::move(pin));
+      ssdFile_->load(ssdPins, loadPins);
+      checkContents(loadPins[0].entry()->data(), loadPins[0].entry()->size());
+    }
+  }
+  EXPECT_LT(0, numFound);
+}
+
+TEST_F(SsdFileTest, asyncLoad) {
+  constexpr int64_t kSsdSize = 4 * SsdFile::kRegionSize;
+  initializeCache(128 * kMB, kSsdSize);
+  std::atomic<int32_t> numReads{0};
+  ssdFile_->testingSetReadFile(std::make_unique<AsyncLocalReadFile>(
+      fmt::format("{}/ssdtest", tempDirectory_->path), numReads));
+  auto pins = makePins(fileName_.id(), 0, 4096, 2048 * 1025, 32 * kMB);
+  ssdFile_->write(pins);
+  pins.clear();
+
+  // The entries are still in memory, so the load overwrites them from SSD
+  // with the same contents.
+  pins = makePins(fileName_.id(), 0, 4096, 2048 * 1025, 32 * kMB);
+  readAndCheckPins(pins);
+  ASSERT_GT(numReads, 0);
+  SsdCacheStats stats;
+  ssdFile_->updateStats(stats);
+  ASSERT_EQ(stats.readSsdErrors, 0);
+}
+
+TEST_F(SsdFileTest, compression) {
+  constexpr int64_t kSsdSize = 4 * SsdFile::kRegionSize;
+  constexpr int32_t kNumEntries = 20;
+  constexpr uint64_t kCompressedGroup = 1;
+  initializeCache(128 * kMB, kSsdSize);
+  FileGroupStats groupStats;
+  groupStats.setSsdCompression(
+      kCompressedGroup, common::CompressionKind_ZSTD);
+
+  // Even entries are in the compressed group. Odd entries in another group
+  // are stored as is. The sizes cover both tiny and allocated entries.
+  auto fill = [](AsyncDataCacheEntry& entry, int32_t seed) {
+    std::string data(entry.size(), 0);
+    for (auto i = 0; i < data.size(); ++i) {
+      data[i] = 'a' + (i / 100 + seed) % 7;
+    }
+    if (entry.tinyData() != nullptr) {
+      memcpy(entry.tinyData(), data.data(), data.size());
+      return data;
+    }
+    uint64_t offset = 0;
+    for (auto i = 0; i < entry.data().numRuns(); ++i) {
+      auto run = entry.data().runAt(i);
+      const auto bytes =
+          std::min<uint64_t>(run.numBytes(), data.size() - offset);
+      memcpy(run.data<char>(), data.data() + offset, bytes);
+      offset += bytes;
+    }
+    return data;
+  };
+  auto contents = [](AsyncDataCacheEntry& entry) {
+    if (entry.tinyData() != nullptr) {
+      return std::string(entry.tinyData(), entry.size());
+    }
+    std::string data;
+    for (auto i = 0; i < entry.data().numRuns(); ++i) {
+      auto run = entry.data().runAt(i);
+      data.append(run.data<char>(), run.numBytes());
+    }
+    data.resize(entry.size());
+    return data;
+  };
+
+  std::vector<CachePin> pins;
+  std::vector<std::string> expected;
+  uint64_t offset = 0;
+  for (auto i = 0; i < kNumEntries; ++i) {
+    const int32_t size = i % 4 < 2 ? 1000 : 200'000 + i * 1000;
+    pins.push_back(cache_->findOrCreate(
+        RawFileCacheKey{fileName_.id(), offset}, size, nullptr));
+    auto* entry = pins.back().entry();
+    ASSERT_TRUE(entry->isExclusive());
+    entry->setGroupId(i % 2 == 0 ? kCompressedGroup : kCompressedGroup + 1);
+    expected.push_back(fill(*entry, i));
+    entry->setExclusiveToShared();
+    offset += size;
+  }
+  ssdFile_->write(pins, &groupStats);
+
+  SsdCacheStats stats;
+  ssdFile_->updateStats(stats);
+  ASSERT_EQ(stats.entriesWritten, kNumEntries);
+  ASSERT_EQ(stats.entriesCompressed, kNumEntries / 2);
+  ASSERT_GT(stats.bytesSavedByCompression, 0);
+
+  // Overwrite the memory copies and load them back from SSD.
+  std::vector<SsdPin> ssdPins;
+  for (auto i = 0; i < pins.size(); ++i) {
+    auto* entry = pins[i].entry();
+    fill(*entry, i + 3);
+    ssdPins.push_back(ssdFile_->find(RawFileCacheKey{
+        fileName_.id(), static_cast<uint64_t>(entry->offset())}));
+    ASSERT_FALSE(ssdPins.back().empty());
+    ASSERT_EQ(ssdPins.back().run().compressed(), i % 2 == 0);
+  }
+  ssdFile_->load(ssdPins, pins);
+  for (auto i = 0; i < pins.size(); ++i) {
+    ASSERT_EQ(contents(*pins[i].entry()), expected[i]) << i;
+  }
+}
+
 #ifdef VELOX_SSD_FILE_TEST_SET_NO_COW_FLAG
 TEST_F(SsdFileTest, disabledCow) {
   constexpr int64_t kSsdSize = 16 * SsdFile::kRegionSize;
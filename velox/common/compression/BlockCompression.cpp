@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/compression/BlockCompression.h"
+
+#include <folly/io/Cursor.h>
+#include <limits>
+
+namespace facebook::velox::common {
+namespace {
+
+constexpr int32_t kBlockHeaderSize = 2 * sizeof(int32_t);
+
+std::unique_ptr<folly::IOBuf> compressBlock(
+    CompressionKind kind,
+    int32_t level,
+    const std::string& data) {
+  const int32_t uncompressedSize = data.size();
+  auto input = folly::IOBuf::wrapBufferAsValue(data.data(), data.size());
+  auto compressed = compressionKindToCodec(kind, level)->compress(&input);
+  int32_t compressedSize = compressed->computeChainDataLength();
+  if (compressedSize >= uncompressedSize) {
+    compressed = folly::IOBuf::copyBuffer(data.data(), data.size());
+    compressedSize = uncompressedSize;
+  }
+  auto result = folly::IOBuf::create(kBlockHeaderSize);
+  auto* header = reinterpret_cast<int32_t*>(result->writableData());
+  header[0] = uncompressedSize;
+  header[1] = compressedSize;
+  result->append(kBlockHeaderSize);
+  result->prependChain(std::move(compressed));
+  return result;
+}
+
+// Waits for all 'items', also after an error since the items may write into
+// memory owned by the caller. Returns the results in order or rethrows the
+// first error.
+template <typename Item>
+std::vector<std::unique_ptr<Item>> syncBlocks(
+    std::vector<std::shared_ptr<AsyncSource<Item>>>& items) {
+  std::vector<std::unique_ptr<Item>> results;
+  results.reserve(items.size());
+  std::exception_ptr error;
+  for (auto& item : items) {
+    try {
+      results.push_back(item->move());
+    } catch (const std::exception&) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return results;
+}
+
+} // namespace
+
+BlockCompressor::BlockCompressor(
+    CompressionKind kind,
+    const BlockCompressionOptions& options)
+    : kind_(kind), options_(options) {
+  VELOX_CHECK_GT(options_.blockSize, 0);
+  VELOX_CHECK_LE(options_.blockSize, std::numeric_limits<int32_t>::max());
+  pending_.reserve(options_.blockSize);
+}
+
+void BlockCompressor::append(const char* data, uint64_t size) {
+  while (size > 0) {
+    const auto numBytes =
+        std::min<uint64_t>(size, options_.blockSize - pending_.size());
+    pending_.append(data, numBytes);
+    data += numBytes;
+    size -= numBytes;
+    if (pending_.size() == options_.blockSize) {
+      compressPending();
+    }
+  }
+}
+
+void BlockCompressor::append(const folly::IOBuf& data) {
+  for (auto range : data) {
+    append(reinterpret_cast<const char*>(range.data()), range.size());
+  }
+}
+
+void BlockCompressor::compressPending() {
+  blocks_.push_back(std::make_shared<AsyncSource<folly::IOBuf>>(
+      [kind = kind_,
+       level = options_.level,
+       data = std::make_shared<std::string>(std::move(pending_))]() {
+        return compressBlock(kind, level, *data);
+      }));
+  pending_ = std::string();
+  pending_.reserve(options_.blockSize);
+  if (options_.executor != nullptr) {
+    options_.executor->add([block = blocks_.back()]() { block->prepare(); });
+  }
+}
+
+std::unique_ptr<folly::IOBuf> BlockCompressor::finish() {
+  if (!pending_.empty()) {
+    compressPending();
+  }
+  auto result = folly::IOBuf::create(sizeof(int32_t));
+  *reinterpret_cast<int32_t*>(result->writableData()) = blocks_.size();
+  result->append(sizeof(int32_t));
+  for (auto& block : syncBlocks(blocks_)) {
+    result->prependChain(std::move(block));
+  }
+  blocks_.clear();
+  return result;
+}
+
+std::unique_ptr<folly::IOBuf> compressBlocks(
+    const folly::IOBuf& data,
+    CompressionKind kind,
+    const BlockCompressionOptions& options) {
+  BlockCompressor compressor(kind, options);
+  compressor.append(data);
+  return compressor.finish();
+}
+
+std::unique_ptr<folly::IOBuf> uncompressBlocks(
+    const folly::IOBuf& data,
+    CompressionKind kind,
+    folly::Executor* executor) {
+  folly::io::Cursor cursor(&data);
+  const auto numBlocks = cursor.read<int32_t>();
+  VELOX_CHECK_GE(numBlocks, 0, "Corrupt block compressed data");
+
+  struct Block {
+    uint64_t offset;
+    int32_t uncompressedSize;
+    std::shared_ptr<folly::IOBuf> data;
+  };
+  std::vector<Block> blocks;
+  blocks.reserve(numBlocks);
+  uint64_t totalSize = 0;
+  for (auto i = 0; i < numBlocks; ++i) {
+    const auto uncompressedSize = cursor.read<int32_t>();
+    const auto compressedSize = cursor.read<int32_t>();
+    VELOX_CHECK(
+        uncompressedSize >= 0 && compressedSize >= 0 &&
+            compressedSize <= uncompressedSize,
+        "Corrupt block compressed data");
+    std::unique_ptr<folly::IOBuf> blockData;
+    cursor.clone(blockData, compressedSize);
+    blocks.push_back({totalSize, uncompressedSize, std::move(blockData)});
+    totalSize += uncompressedSize;
+  }
+  VELOX_CHECK(cursor.isAtEnd(), "Corrupt block compressed data");
+
+  auto result = folly::IOBuf::create(totalSize);
+  result->append(totalSize);
+  auto* output = result->writableData();
+  std::vector<std::shared_ptr<AsyncSource<bool>>> items;
+  items.reserve(numBlocks);
+  for (auto& block : blocks) {
+    items.push_back(std::make_shared<AsyncSource<bool>>(
+        [kind, block, output]() {
+          const auto* data = block.data.get();
+          std::unique_ptr<folly::IOBuf> uncompressed;
+          if (data->computeChainDataLength() < block.uncompressedSize) {
+            uncompressed = compressionKindToCodec(kind)->uncompress(
+                data, block.uncompressedSize);
+            data = uncompressed.get();
+          }
+          VELOX_CHECK_EQ(
+              data->computeChainDataLength(),
+              block.uncompressedSize,
+              "Corrupt block compressed data");
+          folly::io::Cursor(data).pull(
+              output + block.offset, block.uncompressedSize);
+          return std::make_unique<bool>(true);
+        }));
+    if (executor != nullptr) {
+      executor->add([item = items.back()]() { item->prepare(); });
+    }
+  }
+  syncBlocks(items);
+  return result;
+}
+
+} // namespace facebook::velox::common
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Executor.h>
+#include <folly/io/IOBuf.h>
+
+#include "velox/common/base/AsyncSource.h"
+#include "velox/common/compression/Compression.h"
+
+namespace facebook::velox::common {
+
+/// Uncompressed bytes per block if not set in BlockCompressionOptions.
+constexpr uint64_t kDefaultBlockCompressionSize = 1 << 20;
+
+struct BlockCompressionOptions {
+  /// Codec level. folly::io::COMPRESSION_LEVEL_DEFAULT uses the default of
+  /// the codec.
+  int32_t level{folly::io::COMPRESSION_LEVEL_DEFAULT};
+
+  /// Uncompressed bytes per block. Smaller blocks give more parallelism at
+  /// the cost of compression ratio.
+  uint64_t blockSize{kDefaultBlockCompressionSize};
+
+  /// If set, blocks are compressed and decompressed on this executor. The
+  /// calling thread runs blocks the executor has not yet started, so a busy
+  /// executor does not stall the caller.
+  folly::Executor* executor{nullptr};
+};
+
+/// Compresses a stream of bytes as a sequence of independently compressed
+/// blocks. Each full block is compressed as soon as it is appended, on the
+/// executor if there is one, so that compression overlaps producing the
+/// input and large buffers are compressed on several threads. The output is
+///
+///   numBlocks(4) | {uncompressedSize(4) | compressedSize(4) | data}*
+///
+/// where each block is a complete frame of the codec for 'kind', e.g. a ZSTD
+/// frame or an LZ4 block, so no block refers to data of another. A block
+/// that does not get smaller is stored as is with compressedSize equal to
+/// uncompressedSize.
+class BlockCompressor {
+ public:
+  BlockCompressor(CompressionKind kind, const BlockCompressionOptions& options);
+
+  void append(const char* data, uint64_t size);
+
+  void append(const folly::IOBuf& data);
+
+  /// Compresses the last partial block, waits for all blocks and returns the
+  /// compressed stream. The compressor may not be used afterwards.
+  std::unique_ptr<folly::IOBuf> finish();
+
+ private:
+  // Starts compressing 'pending_'.
+  void compressPending();
+
+  const CompressionKind kind_;
+  const BlockCompressionOptions options_;
+  std::string pending_;
+  std::vector<std::shared_ptr<AsyncSource<folly::IOBuf>>> blocks_;
+};
+
+/// Compresses 'data' with a BlockCompressor.
+std::unique_ptr<folly::IOBuf> compressBlocks(
+    const folly::IOBuf& data,
+    CompressionKind kind,
+    const BlockCompressionOptions& options);
+
+/// Decompresses the output of a BlockCompressor. The blocks are decompressed
+/// on 'executor' if set. Returns a single buffer.
+std::unique_ptr<folly::IOBuf> uncompressBlocks(
+    const folly::IOBuf& data,
+    CompressionKind kind,
+    folly::Executor* executor = nullptr);
+
+} // namespace facebook::velox::common
@@ -22,19 +22,25 @@
 namespace facebook::velox::common {
 
 std::unique_ptr<folly::io::Codec> compressionKindToCodec(CompressionKind kind) {
+  return compressionKindToCodec(kind, folly::io::COMPRESSION_LEVEL_DEFAULT);
+}
+
+std::unique_ptr<folly::io::Codec> compressionKindToCodec(
+    CompressionKind kind,
+    int32_t level) {
   switch (static_cast<int32_t>(kind)) {
     case CompressionKind_NONE:
-      return getCodec(folly::io::CodecType::NO_COMPRESSION);
+      return getCodec(folly::io::CodecType::NO_COMPRESSION, level);
     case CompressionKind_ZLIB:
-      return getCodec(folly::io::CodecType::ZLIB);
+      return getCodec(folly::io::CodecType::ZLIB, level);
     case CompressionKind_SNAPPY:
-      return getCodec(folly::io::CodecType::SNAPPY);
+      return getCodec(folly::io::CodecType::SNAPPY, level);
     case CompressionKind_ZSTD:
-      return getCodec(folly::io::CodecType::ZSTD);
+      return getCodec(folly::io::CodecType::ZSTD, level);
     case CompressionKind_LZ4:
-      return getCodec(folly::io::CodecType::LZ4);
+      return getCodec(folly::io::CodecType::LZ4, level);
     case CompressionKind_GZIP:
-      return getCodec(folly::io::CodecType::GZIP);
+      return getCodec(folly::io::CodecType::GZIP, level);
     default:
       VELOX_UNSUPPORTED(
           "Not support {} in folly", compressionKindToString(kind));
@@ -34,6 +34,12 @@ enum CompressionKind {
 
 std::unique_ptr<folly::io::Codec> compressionKindToCodec(CompressionKind kind);
 
+/// Returns the codec for 'kind' at compression 'level', e.g. 1 to 22 for
+/// ZSTD. folly::io::COMPRESSION_LEVEL_DEFAULT gives the default level.
+std::unique_ptr<folly::io::Codec> compressionKindToCodec(
+    CompressionKind kind,
+    int32_t level);
+
 CompressionKind codecTypeToCompressionKind(folly::io::CodecType type);
 
 /**
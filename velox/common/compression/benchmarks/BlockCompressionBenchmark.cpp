@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fmt/format.h>
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/init/Init.h>
+
+#include "velox/common/compression/BlockCompression.h"
+
+// Compares whole buffer compression with block compression on one thread and
+// on an executor, for ZSTD at several levels and LZ4.
+
+DEFINE_int64(data_size, 64 << 20, "Bytes to compress");
+DEFINE_int64(block_size, 1 << 20, "Uncompressed bytes per block");
+DEFINE_int32(num_threads, 8, "Threads of the executor");
+
+using namespace facebook::velox;
+using namespace facebook::velox::common;
+
+namespace {
+
+std::string data;
+std::unique_ptr<folly::CPUThreadPoolExecutor> executor;
+
+// Rows of a few repeating and a few random fields, compressing about 3:1
+// with ZSTD.
+std::string makeData(int64_t size) {
+  folly::Random::DefaultGenerator rng(1);
+  std::string result;
+  result.reserve(size + 100);
+  while (result.size() < size) {
+    result += fmt::format(
+        "{}|{}|status_{}|{}\n",
+        folly::Random::rand64(rng) % 1'000'000,
+        folly::Random::rand32(rng) % 100,
+        folly::Random::rand32(rng) % 5,
+        folly::Random::randDouble01(rng));
+  }
+  result.resize(size);
+  return result;
+}
+
+folly::IOBuf input() {
+  return folly::IOBuf::wrapBufferAsValue(data.data(), data.size());
+}
+
+void runCompressWhole(CompressionKind kind, int32_t level) {
+  auto buffer = input();
+  auto compressed = compressionKindToCodec(kind, level)->compress(&buffer);
+  folly::doNotOptimizeAway(compressed);
+}
+
+void runCompressBlocks(CompressionKind kind, int32_t level, bool parallel) {
+  BlockCompressionOptions options;
+  options.level = level;
+  options.blockSize = FLAGS_block_size;
+  options.executor = parallel ? executor.get() : nullptr;
+  auto compressed = compressBlocks(input(), kind, options);
+  folly::doNotOptimizeAway(compressed);
+}
+
+void runUncompressBlocks(CompressionKind kind, int32_t level, bool parallel) {
+  folly::BenchmarkSuspender suspender;
+  BlockCompressionOptions options;
+  options.level = level;
+  options.blockSize = FLAGS_block_size;
+  auto compressed = compressBlocks(input(), kind, options);
+  suspender.dismiss();
+
+  auto uncompressed = uncompressBlocks(
+      *compressed, kind, parallel ? executor.get() : nullptr);
+  folly::doNotOptimizeAway(uncompressed);
+}
+
+} // namespace
+
+#define COMPRESSION_BENCHMARKS(name, kind, level)      \
+  BENCHMARK(name##Whole) {                             \
+    runCompressWhole(kind, level);                     \
+  }                                                    \
+  BENCHMARK_RELATIVE(name##Blocks) {                   \
+    runCompressBlocks(kind, level, false);             \
+  }                                                    \
+  BENCHMARK_RELATIVE(name##ParallelBlocks) {           \
+    runCompressBlocks(kind, level, true);              \
+  }                                                    \
+  BENCHMARK(name##UncompressBlocks) {                  \
+    runUncompressBlocks(kind, level, false);           \
+  }                                                    \
+  BENCHMARK_RELATIVE(name##UncompressParallelBlocks) { \
+    runUncompressBlocks(kind, level, true);            \
+  }                                                    \
+  BENCHMARK_DRAW_LINE();
+
+COMPRESSION_BENCHMARKS(zstd1, CompressionKind_ZSTD, 1)
+COMPRESSION_BENCHMARKS(zstd3, CompressionKind_ZSTD, 3)
+COMPRESSION_BENCHMARKS(zstd9, CompressionKind_ZSTD, 9)
+COMPRESSION_BENCHMARKS(zstd19, CompressionKind_ZSTD, 19)
+COMPRESSION_BENCHMARKS(lz4, CompressionKind_LZ4, 1)
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  data = makeData(FLAGS_data_size);
+  executor = std::make_unique<folly::CPUThreadPoolExecutor>(FLAGS_num_threads);
+  folly::runBenchmarks();
+  executor.reset();
+  return 0;
+}
@@ -14,10 +14,14 @@
  * limitations under the License.
  */
 
+#include <fmt/format.h>
+#include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 
 #include "velox/common/base/VeloxException.h"
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/compression/BlockCompression.h"
 #include "velox/common/compression/Compression.h"
 
 namespace facebook::velox::common {
@@ -59,4 +63,60 @@ TEST_F(CompressionTest, stringToCompressionKind) {
   VELOX_ASSERT_THROW(
       stringToCompressionKind("bz2"), "Not support compression kind bz2");
 }
+
+TEST_F(CompressionTest, blockCompression) {
+  // Compressible text followed by random bytes that are stored as is.
+  std::string data;
+  for (auto i = 0; data.size() < 300'000; ++i) {
+    data += fmt::format("row {} value {};", i, i % 17);
+  }
+  folly::Random::DefaultGenerator rng(1);
+  for (auto i = 0; i < 100'000; ++i) {
+    data.push_back(static_cast<char>(folly::Random::rand32(rng)));
+  }
+  auto input = folly::IOBuf::wrapBufferAsValue(data.data(), data.size());
+
+  folly::CPUThreadPoolExecutor executor(4);
+  for (auto kind : {CompressionKind_ZSTD, CompressionKind_LZ4}) {
+    for (auto* blockExecutor : {static_cast<folly::Executor*>(nullptr),
+                                static_cast<folly::Executor*>(&executor)}) {
+      SCOPED_TRACE(fmt::format(
+          "{} executor {}",
+          compressionKindToString(kind),
+          blockExecutor != nullptr));
+      BlockCompressionOptions options;
+      options.level = kind == CompressionKind_ZSTD ? 3 : 1;
+      options.blockSize = 64 << 10;
+      options.executor = blockExecutor;
+
+      auto compressed = compressBlocks(input, kind, options);
+      ASSERT_LT(compressed->computeChainDataLength(), data.size());
+      auto uncompressed = uncompressBlocks(*compressed, kind, blockExecutor);
+      ASSERT_EQ(uncompressed->length(), data.size());
+      ASSERT_EQ(0, memcmp(uncompressed->data(), data.data(), data.size()));
+
+      // Appending in pieces that do not line up with the blocks gives the
+      // same result.
+      BlockCompressor compressor(kind, options);
+      for (auto offset = 0; offset < data.size(); offset += 10'000) {
+        compressor.append(
+            data.data() + offset,
+            std::min<int32_t>(10'000, data.size() - offset));
+      }
+      auto streamed = compressor.finish();
+      ASSERT_TRUE(folly::IOBufEqualTo()(*compressed, *streamed));
+    }
+  }
+
+  auto empty = compressBlocks(
+      folly::IOBuf(), CompressionKind_ZSTD, BlockCompressionOptions{});
+  ASSERT_EQ(0, uncompressBlocks(*empty, CompressionKind_ZSTD)->length());
+
+  auto truncated = compressBlocks(
+      input, CompressionKind_ZSTD, BlockCompressionOptions{});
+  truncated->coalesce();
+  truncated->trimEnd(1);
+  EXPECT_THROW(
+      uncompressBlocks(*truncated, CompressionKind_ZSTD), std::exception);
+}
 } // namespace facebook::velox::common
@@ -18,6 +18,7 @@
 #include <exception>
 #include <sstream>
 #include "velox/common/base/IOUtils.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/common/hyperloglog/BiasCorrection.h"
 #include "velox/common/hyperloglog/HllUtils.h"
 
@@ -567,6 +568,11 @@ void DenseHll::mergeWith(
     int16_t otherOverflows,
     const uint16_t* otherOverflowBuckets,
     const int8_t* otherOverflowValues) {
+  if (overflows_ == 0 && otherOverflows == 0) {
+    mergeWithoutOverflows(otherBaseline, otherDeltas);
+    return;
+  }
+
   int8_t newBaseline = std::max(baseline_, otherBaseline);
   int32_t baselineCount = 0;
 
@@ -622,6 +628,65 @@ void DenseHll::mergeWith(
   adjustBaselineIfNeeded();
 }
 
+void DenseHll::mergeWithoutOverflows(
+    int8_t otherBaseline,
+    const int8_t* otherDeltas) {
+  // Without overflows, the value of a bucket is baseline + delta. Relative to
+  // the new baseline, the delta of each side is its delta minus the increase
+  // of its baseline, clamped at 0. The merged delta is the max of the two and
+  // does not exceed kMaxDelta, so no overflows are created either.
+  using Batch = xsimd::batch<uint8_t>;
+  const int8_t newBaseline = std::max(baseline_, otherBaseline);
+  const uint8_t shift = newBaseline - baseline_;
+  const uint8_t otherShift = newBaseline - otherBaseline;
+
+  auto* deltas = reinterpret_cast<uint8_t*>(deltas_.data());
+  const auto* other = reinterpret_cast<const uint8_t*>(otherDeltas);
+  const int32_t size = deltas_.size();
+  int32_t baselineCount = 0;
+
+  int32_t i = 0;
+  const auto mask = Batch::broadcast(kBucketMask);
+  const auto shifts = Batch::broadcast(shift);
+  const auto otherShifts = Batch::broadcast(otherShift);
+  const auto zeros = Batch::broadcast(0);
+  for (; i + Batch::size <= size; i += Batch::size) {
+    const auto slots = Batch::load_unaligned(deltas + i);
+    const auto otherSlots = Batch::load_unaligned(other + i);
+    const auto low = xsimd::max(
+        xsimd::ssub(slots & mask, shifts),
+        xsimd::ssub(otherSlots & mask, otherShifts));
+    const auto high = xsimd::max(
+        xsimd::ssub((slots >> kBitsPerBucket) & mask, shifts),
+        xsimd::ssub((otherSlots >> kBitsPerBucket) & mask, otherShifts));
+    (low | (high << kBitsPerBucket)).store_unaligned(deltas + i);
+    baselineCount += __builtin_popcount(simd::toBitMask(low == zeros)) +
+        __builtin_popcount(simd::toBitMask(high == zeros));
+  }
+
+  auto mergeDelta = [&](uint8_t slot, uint8_t otherSlot, int32_t bucketShift) {
+    const int32_t delta = (slot >> bucketShift) & kBucketMask;
+    const int32_t otherDelta = (otherSlot >> bucketShift) & kBucketMask;
+    const uint8_t newDelta =
+        std::max(std::max(delta - shift, otherDelta - otherShift), 0);
+    if (newDelta == 0) {
+      ++baselineCount;
+    }
+    return newDelta;
+  };
+  for (; i < size; ++i) {
+    deltas[i] = mergeDelta(deltas[i], other[i], 0) |
+        (mergeDelta(deltas[i], other[i], kBitsPerBucket) << kBitsPerBucket);
+  }
+
+  baseline_ = newBaseline;
+  baselineCount_ = baselineCount;
+
+  // All baseline values in one of the HLLs lost to the values
+  // in the other HLL, so we need to adjust the final baseline.
+  adjustBaselineIfNeeded();
+}
+
 int8_t
 DenseHll::updateOverflow(int32_t index, int overflowEntry, int8_t delta) {
   if (delta > kMaxDelta) {
@@ -116,6 +116,10 @@ class DenseHll {
       const uint16_t* otherOverflowBuckets,
       const int8_t* otherOverflowValues);
 
+  // Fast path of mergeWith() for when neither HLL has overflows. Merges the
+  // 4-bit deltas of a SIMD register worth of buckets at a time.
+  void mergeWithoutOverflows(int8_t otherBaseline, const int8_t* otherDeltas);
+
   /// Number of first bits of the hash to calculate buckets from.
   int8_t indexBitLength_;
 
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+#include "velox/common/hyperloglog/DenseHll.h"
+#include "velox/common/memory/HashStringAllocator.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::common::hll;
+
+namespace {
+
+// Default number of index bits of approx_distinct.
+constexpr int8_t kIndexBitLength = 11;
+
+// Number of HLLs on each side of the merge. Each benchmark iteration does
+// kNumGroups merges, as a final approx_distinct does for one partial result
+// for each of as many groups.
+constexpr int32_t kNumGroups = 10'000;
+
+class DenseHllBenchmark {
+ public:
+  // Makes HLLs with 'numValues' random values each. If 'withOverflows' is
+  // true, adds a value to one bucket of each HLL which does not fit in a
+  // 4-bit delta.
+  DenseHllBenchmark(int32_t numValues, bool withOverflows) {
+    folly::Random::DefaultGenerator rng(1);
+    for (auto side : {&left_, &right_}) {
+      for (auto i = 0; i < kNumGroups; ++i) {
+        side->emplace_back(kIndexBitLength, &allocator_);
+        for (auto j = 0; j < numValues; ++j) {
+          side->back().insertHash(folly::Random::rand64(rng));
+        }
+        if (withOverflows) {
+          side->back().insert(i % (1 << kIndexBitLength), 30);
+        }
+      }
+    }
+  }
+
+  void run(int32_t iterations) {
+    for (auto i = 0; i < iterations; ++i) {
+      for (auto j = 0; j < kNumGroups; ++j) {
+        left_[j].mergeWith(right_[j]);
+      }
+    }
+    folly::doNotOptimizeAway(left_[0].cardinality());
+  }
+
+ private:
+  std::shared_ptr<memory::MemoryPool> pool_{
+      memory::addDefaultLeafMemoryPool()};
+  HashStringAllocator allocator_{pool_.get()};
+  std::vector<DenseHll> left_;
+  std::vector<DenseHll> right_;
+};
+
+std::unique_ptr<DenseHllBenchmark> noOverflows;
+std::unique_ptr<DenseHllBenchmark> withOverflows;
+
+BENCHMARK_MULTI(mergeDense) {
+  noOverflows->run(100);
+  return 100 * kNumGroups;
+}
+
+BENCHMARK_MULTI(mergeDenseWithOverflows) {
+  withOverflows->run(100);
+  return 100 * kNumGroups;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  noOverflows = std::make_unique<DenseHllBenchmark>(5'000, false);
+  withOverflows = std::make_unique<DenseHllBenchmark>(5'000, true);
+  folly::runBenchmarks();
+  noOverflows.reset();
+  withOverflows.reset();
+  return 0;
+}
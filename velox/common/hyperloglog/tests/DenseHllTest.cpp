@@ -206,6 +206,10 @@ TEST_P(DenseHllTest, mergeWith) {
   // small, same
   testMergeWith(indexBitLength, sequence(0, 100), sequence(0, 100));
 
+  // small and medium, with different baselines
+  testMergeWith(indexBitLength, sequence(0, 100), sequence(100, 5'000));
+  testMergeWith(indexBitLength, sequence(0, 5'000), sequence(2'000, 2'100));
+
   // large, non-overlapping
   testMergeWith(indexBitLength, sequence(0, 20'000), sequence(20'000, 40'000));
   testMergeWith(indexBitLength, sequence(20'000, 40'000), sequence(0, 20'000));
@@ -324,6 +324,14 @@ class HashStringAllocator : public StreamArena {
     return minFree;
   }
 
+  // Returns the fraction of the memory retained by 'this' that is on the
+  // free lists. A high value after many allocations and frees of variable
+  // size means that live data is scattered over mostly free slabs.
+  double fragmentation() const {
+    const auto retained = retainedSize();
+    return retained == 0 ? 0 : static_cast<double>(freeBytes_) / retained;
+  }
+
   // Frees all memory associated with 'this' and leaves 'this' ready for reuse.
   void clear();
 
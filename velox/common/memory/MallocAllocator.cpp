@@ -27,7 +27,8 @@ bool MallocAllocator::allocateNonContiguousWithoutRetry(
     MachinePageCount numPages,
     Allocation& out,
     ReservationCallback reservationCB,
-    MachinePageCount minSizeClass) {
+    MachinePageCount minSizeClass,
+    bool /*hugePages*/) {
   const uint64_t freedBytes = freeNonContiguous(out);
   if (numPages == 0) {
     if (freedBytes != 0 && reservationCB != nullptr) {
@@ -88,7 +88,8 @@ class MallocAllocator : public MemoryAllocator {
       MachinePageCount numPages,
       Allocation& out,
       ReservationCallback reservationCB = nullptr,
-      MachinePageCount minSizeClass = 0) override;
+      MachinePageCount minSizeClass = 0,
+      bool hugePages = false) override;
 
   bool allocateContiguousWithoutRetry(
       MachinePageCount numPages,
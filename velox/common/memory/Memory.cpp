@@ -36,10 +36,13 @@ MemoryManager::MemoryManager(const MemoryManagerOptions& options)
            .capacity = std::min(options.queryMemoryCapacity, options.capacity),
            .memoryPoolInitCapacity = options.memoryPoolInitCapacity,
            .memoryPoolTransferCapacity = options.memoryPoolTransferCapacity,
-           .retryArbitrationFailure = options.retryArbitrationFailure})),
+           .retryArbitrationFailure = options.retryArbitrationFailure,
+           .victimAgeProtectionMs = options.arbitratorVictimAgeProtectionMs,
+           .tenantCapacities = options.arbitratorTenantCapacities})),
       alignment_(std::max(MemoryAllocator::kMinAlignment, options.alignment)),
       checkUsageLeak_(options.checkUsageLeak),
       debugEnabled_(options.debugEnabled),
+      poolSmallBufferCacheBytes_(options.poolSmallBufferCacheBytes),
       poolDestructionCb_([&](MemoryPool* pool) { dropPool(pool); }),
       defaultRoot_{std::make_shared<MemoryPoolImpl>(
           this,
@@ -128,6 +131,7 @@ std::shared_ptr<MemoryPool> MemoryManager::addRootPool(
   options.trackUsage = true;
   options.checkUsageLeak = checkUsageLeak_;
   options.debugEnabled = debugEnabled_;
+  options.smallBufferCacheBytes = poolSmallBufferCacheBytes_;
 
   folly::SharedMutex::WriteHolder guard{mutex_};
   if (pools_.find(poolName) != pools_.end()) {
@@ -22,6 +22,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 #include <fmt/format.h>
 #include <folly/Synchronized.h>
@@ -88,6 +89,10 @@ struct MemoryManagerOptions {
   /// testing purpose.
   bool debugEnabled{FLAGS_velox_memory_pool_debug_enabled};
 
+  /// The max bytes of freed small buffers each leaf memory pool keeps for
+  /// reuse. See MemoryPool::Options::smallBufferCacheBytes.
+  int64_t poolSmallBufferCacheBytes{0};
+
   /// Specifies the backing memory allocator.
   MemoryAllocator* allocator{MemoryAllocator::getInstance()};
 
@@ -113,6 +118,12 @@ struct MemoryManagerOptions {
   /// same query on all the workers instead of a random victim query which
   /// happens to trigger the failed memory arbitration.
   bool retryArbitrationFailure{true};
+
+  /// See MemoryArbitrator::Config::victimAgeProtectionMs.
+  uint64_t arbitratorVictimAgeProtectionMs{0};
+
+  /// See MemoryArbitrator::Config::tenantCapacities.
+  std::unordered_map<std::string, uint64_t> arbitratorTenantCapacities{};
 };
 
 /// 'MemoryManager' is responsible for managing the memory pools. For now, users
@@ -222,6 +233,7 @@ class MemoryManager {
   const uint16_t alignment_;
   const bool checkUsageLeak_;
   const bool debugEnabled_;
+  const int64_t poolSmallBufferCacheBytes_;
   // The destruction callback set for the allocated  root memory pools which are
   // tracked by 'pools_'. It is invoked on the root pool destruction and removes
   // the pool from 'pools_'.
@@ -164,14 +164,15 @@ bool MemoryAllocator::allocateNonContiguous(
     MachinePageCount numPages,
     Allocation& out,
     ReservationCallback reservationCB,
-    MachinePageCount minSizeClass) {
+    MachinePageCount minSizeClass,
+    bool hugePages) {
   if (cache() == nullptr) {
     return allocateNonContiguousWithoutRetry(
-        numPages, out, reservationCB, minSizeClass);
+        numPages, out, reservationCB, minSizeClass, hugePages);
   }
   return cache()->makeSpace(numPages, [&]() {
     return allocateNonContiguousWithoutRetry(
-        numPages, out, reservationCB, minSizeClass);
+        numPages, out, reservationCB, minSizeClass, hugePages);
   });
 }
 
@@ -241,6 +242,8 @@ Stats Stats::operator-(const Stats& other) const {
     result.sizes[i] = sizes[i] - other.sizes[i];
   }
   result.numAdvise = numAdvise - other.numAdvise;
+  result.numLocalNodePages = numLocalNodePages - other.numLocalNodePages;
+  result.numRemoteNodePages = numRemoteNodePages - other.numRemoteNodePages;
   return result;
 }
 
@@ -257,6 +260,12 @@ std::string Stats::toString() const {
       totalBytes >> 20,
       totalClocks >> 30,
       numAdvise >> 8);
+  if (numLocalNodePages + numRemoteNodePages > 0) {
+    out << fmt::format(
+        "NUMA: {}MB local node, {}MB remote node\n",
+        numLocalNodePages >> 8,
+        numRemoteNodePages >> 8);
+  }
 
   // Sort the size classes by decreasing clocks.
   std::vector<int32_t> indices(sizes.size());
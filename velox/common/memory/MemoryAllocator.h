@@ -137,6 +137,11 @@ struct Stats {
 
   /// Cumulative count of pages advised away, if the allocator exposes this.
   int64_t numAdvise{0};
+
+  /// Cumulative count of size class pages allocated on the NUMA node of the
+  /// allocating thread and on other nodes, if the allocator is NUMA aware.
+  int64_t numLocalNodePages{0};
+  int64_t numRemoteNodePages{0};
 };
 
 class MemoryAllocator;
@@ -244,11 +249,14 @@ class MemoryAllocator : public std::enable_shared_from_this<MemoryAllocator> {
   ///  - Allocation is not guaranteed even if collateral 'out' is larger than
   ///    'numPages', because this method is not atomic.
   ///  - Throws if allocation exceeds capacity.
+  ///  - If 'hugePages' is true, the pages are preferably taken from memory
+  ///    backed by huge pages if the allocator has any.
   bool allocateNonContiguous(
       MachinePageCount numPages,
       Allocation& out,
       ReservationCallback reservationCB = nullptr,
-      MachinePageCount minSizeClass = 0);
+      MachinePageCount minSizeClass = 0,
+      bool hugePages = false);
 
   /// Frees non-contiguous 'allocation'. 'allocation' is empty on return. The
   /// function returns the actual freed bytes.
@@ -399,7 +407,8 @@ class MemoryAllocator : public std::enable_shared_from_this<MemoryAllocator> {
       MachinePageCount numPages,
       Allocation& out,
       ReservationCallback reservationCB,
-      MachinePageCount minSizeClass) = 0;
+      MachinePageCount minSizeClass,
+      bool hugePages) = 0;
 
   virtual void* allocateBytesWithoutRetry(
       uint64_t bytes,
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <vector>
 
 #include "velox/common/base/Exceptions.h"
@@ -67,6 +68,22 @@ class MemoryArbitrator {
     /// same query on all the workers instead of a random victim query which
     /// happens to trigger the failed memory arbitration.
     bool retryArbitrationFailure{true};
+
+    /// If not zero, protects long running queries from memory reclamation.
+    /// Among the candidates with the same arbitration priority, the shared
+    /// arbitrator ranks a candidate by its reclaimable bytes divided by (1 +
+    /// age / 'victimAgeProtectionMs'). A query that has run for
+    /// 'victimAgeProtectionMs' thus counts with half of its reclaimable bytes.
+    /// This keeps a nearly finished large query from losing its work to help
+    /// a small new one.
+    uint64_t victimAgeProtectionMs{0};
+
+    /// The max total capacity of the root memory pools of each tenant, keyed
+    /// by MemoryPool::arbitrationTenant(). A tenant at its limit only grows
+    /// by taking memory from its own pools. Tenants not listed are not
+    /// limited. The initial capacity reserved for a new pool is not limited
+    /// as the pool has no tenant yet.
+    std::unordered_map<std::string, uint64_t> tenantCapacities{};
   };
 
   using Factory = std::function<std::unique_ptr<MemoryArbitrator>(
@@ -21,6 +21,7 @@
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/common/testutil/TestValue.h"
+#include "velox/common/time/Timer.h"
 
 #include <re2/re2.h>
 
@@ -202,7 +203,10 @@ MemoryPool::MemoryPool(
       trackUsage_(options.trackUsage),
       threadSafe_(options.threadSafe),
       checkUsageLeak_(options.checkUsageLeak),
-      debugEnabled_(options.debugEnabled) {
+      debugEnabled_(options.debugEnabled),
+      smallBufferCacheBytes_(options.smallBufferCacheBytes),
+      useHugePages_(options.useHugePages),
+      createTimeMs_(getCurrentTimeMs()) {
   VELOX_CHECK(!isRoot() || !isLeaf());
   VELOX_CHECK_GT(
       maxCapacity_, 0, "Memory pool {} max capacity can't be zero", name_);
@@ -388,6 +392,7 @@ MemoryPoolImpl::MemoryPoolImpl(
 }
 
 MemoryPoolImpl::~MemoryPoolImpl() {
+  freeCachedBuffers();
   DEBUG_LEAK_CHECK();
   if (parent_ != nullptr) {
     toImpl(parent_)->dropChild(this);
@@ -425,6 +430,13 @@ MemoryPool::Stats MemoryPoolImpl::statsLocked() const {
 void* MemoryPoolImpl::allocate(int64_t size) {
   CHECK_AND_INC_MEM_OP_STATS(Allocs);
   const auto alignedSize = sizeAlign(size);
+  if (smallBufferCacheBytes_ > 0) {
+    void* buffer = allocateFromCache(alignedSize);
+    if (buffer != nullptr) {
+      DEBUG_RECORD_ALLOC(buffer, size);
+      return buffer;
+    }
+  }
   reserve(alignedSize);
   void* buffer = allocator_->allocateBytes(alignedSize, alignment_);
   if (FOLLY_UNLIKELY(buffer == nullptr)) {
@@ -482,10 +494,100 @@ void MemoryPoolImpl::free(void* p, int64_t size) {
   CHECK_AND_INC_MEM_OP_STATS(Frees);
   const auto alignedSize = sizeAlign(size);
   DEBUG_RECORD_FREE(p, size);
+  if (smallBufferCacheBytes_ > 0 && freeToCache(p, alignedSize)) {
+    return;
+  }
   allocator_->freeBytes(p, alignedSize);
   release(alignedSize);
 }
 
+// static
+int32_t MemoryPoolImpl::cacheSlot(int64_t size) {
+  if (size < 8 || size > kMaxCachedBufferSize) {
+    return -1;
+  }
+  const int32_t bits = 63 - bits::countLeadingZeros<uint64_t>(size);
+  const int64_t lower = 1LL << bits;
+  if (size == lower) {
+    return 2 * bits;
+  }
+  if (size == lower + lower / 2) {
+    return 2 * bits + 1;
+  }
+  return -1;
+}
+
+// static
+int64_t MemoryPoolImpl::cacheSlotSize(int32_t slot) {
+  const int64_t lower = 1LL << (slot / 2);
+  return (slot % 2) == 0 ? lower : lower + lower / 2;
+}
+
+void* MemoryPoolImpl::allocateFromCache(int64_t size) {
+  const auto slot = cacheSlot(size);
+  if (slot < 0) {
+    return nullptr;
+  }
+  std::unique_lock<std::mutex> l(mutex_, std::defer_lock);
+  if (threadSafe_) {
+    l.lock();
+  }
+  auto& buffers = cachedBuffers_[slot];
+  if (buffers.empty()) {
+    return nullptr;
+  }
+  void* buffer = buffers.back();
+  buffers.pop_back();
+  cachedBytes_ -= size;
+  cumulativeBytes_ += size;
+  ++numCacheHits_;
+  return buffer;
+}
+
+bool MemoryPoolImpl::freeToCache(void* p, int64_t size) {
+  const auto slot = cacheSlot(size);
+  if (slot < 0) {
+    return false;
+  }
+  std::unique_lock<std::mutex> l(mutex_, std::defer_lock);
+  if (threadSafe_) {
+    l.lock();
+  }
+  if (cachedBytes_ + size > smallBufferCacheBytes_) {
+    return false;
+  }
+  cachedBuffers_[slot].push_back(p);
+  cachedBytes_ += size;
+  return true;
+}
+
+uint64_t MemoryPoolImpl::freeCachedBuffers() {
+  if (smallBufferCacheBytes_ == 0) {
+    return 0;
+  }
+  std::array<std::vector<void*>, kNumCacheSlots> buffers;
+  {
+    std::unique_lock<std::mutex> l(mutex_, std::defer_lock);
+    if (threadSafe_) {
+      l.lock();
+    }
+    std::swap(buffers, cachedBuffers_);
+    cachedBytes_ = 0;
+  }
+  uint64_t freedBytes = 0;
+  for (auto slot = 0; slot < kNumCacheSlots; ++slot) {
+    const auto size = cacheSlotSize(slot);
+    for (auto* buffer : buffers[slot]) {
+      allocator_->freeBytes(buffer, size);
+      freedBytes += size;
+    }
+  }
+  if (freedBytes > 0) {
+    release(freedBytes);
+  }
+  return freedBytes;
+}
+
 void MemoryPoolImpl::allocateNonContiguous(
     MachinePageCount numPages,
     Allocation& out,
@@ -509,7 +611,8 @@ void MemoryPoolImpl::allocateNonContiguous(
               release(allocBytes);
             }
           },
-          minSizeClass)) {
+          minSizeClass,
+          useHugePages_)) {
     VELOX_CHECK(out.empty());
     VELOX_MEM_ALLOC_ERROR(fmt::format(
         "{} failed with {} pages from {}", __FUNCTION__, numPages, toString()));
@@ -625,7 +728,9 @@ std::shared_ptr<MemoryPool> MemoryPoolImpl::genChild(
           .trackUsage = trackUsage_,
           .threadSafe = threadSafe,
           .checkUsageLeak = checkUsageLeak_,
-          .debugEnabled = debugEnabled_});
+          .debugEnabled = debugEnabled_,
+          .useHugePages = useHugePages_,
+          .smallBufferCacheBytes = smallBufferCacheBytes_});
 }
 
 bool MemoryPoolImpl::maybeReserve(uint64_t increment) {
@@ -777,6 +882,8 @@ bool MemoryPoolImpl::maybeIncrementReservationLocked(uint64_t size) {
   if (!isLeaf()) {
     cumulativeBytes_ += size;
     maybeUpdatePeakBytesLocked(reservationBytes_);
+  } else {
+    recordTimelineLocked();
   }
   return true;
 }
@@ -820,6 +927,7 @@ void MemoryPoolImpl::releaseThreadSafe(uint64_t size, bool releaseOnly) {
     freeable = reservationBytes_ - newQuantized;
     if (freeable > 0) {
       reservationBytes_ = newQuantized;
+      recordTimelineLocked();
     }
     sanityCheckLocked();
   }
@@ -839,6 +947,27 @@ void MemoryPoolImpl::decrementReservation(uint64_t size) noexcept {
   sanityCheckLocked();
 }
 
+void MemoryPoolImpl::recordTimelineLocked() {
+  if (numReservationChanges_++ % timelineStride_ != 0) {
+    return;
+  }
+  if (timeline_.size() == kMaxTimelineSamples) {
+    for (auto i = 1; i < kMaxTimelineSamples / 2; ++i) {
+      timeline_[i] = timeline_[2 * i];
+    }
+    timeline_.resize(kMaxTimelineSamples / 2);
+    timelineStride_ *= 2;
+  }
+  timeline_.push_back(
+      {getCurrentTimeMs(), reservationBytes_, usedReservationBytes_});
+}
+
+std::vector<MemoryPool::TimelineSample> MemoryPoolImpl::memoryTimeline()
+    const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return timeline_;
+}
+
 std::string MemoryPoolImpl::treeMemoryUsage() const {
   if (parent_ != nullptr) {
     return parent_->treeMemoryUsage();
@@ -914,21 +1043,27 @@ bool MemoryPoolImpl::reclaimableBytes(uint64_t& reclaimableBytes) const {
 }
 
 uint64_t MemoryPoolImpl::reclaim(uint64_t targetBytes) {
+  // The cached small buffers are not in use and go first.
+  const auto freedBytes = freeCachedBuffers();
   if (reclaimer() == nullptr) {
-    return 0;
+    return freedBytes;
   }
-  return reclaimer()->reclaim(this, targetBytes);
+  return freedBytes + reclaimer()->reclaim(this, targetBytes);
 }
 
 void MemoryPoolImpl::enterArbitration() {
   if (reclaimer() != nullptr) {
     reclaimer()->enterArbitration();
+  } else if (parent_ != nullptr) {
+    parent_->enterArbitration();
   }
 }
 
 void MemoryPoolImpl::leaveArbitration() noexcept {
   if (reclaimer() != nullptr) {
     reclaimer()->leaveArbitration();
+  } else if (parent_ != nullptr) {
+    parent_->leaveArbitration();
   }
 }
 
@@ -157,6 +157,21 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
     /// If true, tracks the allocation and free call stacks to detect the source
     /// of memory leak for testing purpose.
     bool debugEnabled{FLAGS_velox_memory_pool_debug_enabled};
+
+    /// If true, non-contiguous allocations come from the huge page backed
+    /// size classes of the allocator if it has them. This suits pools with
+    /// large, randomly accessed allocations like those of RowContainer and
+    /// HashStringAllocator. Child pools inherit the setting.
+    bool useHugePages{false};
+
+    /// The max bytes of freed small buffers a leaf memory pool keeps in per
+    /// size free lists for reuse by allocate(). A cached buffer stays in the
+    /// used memory of the pool, so allocate() and free() of a cached size
+    /// skip both the allocator and the reservation accounting. This pays off
+    /// for leaf pools that churn through AlignedBuffers of the sizes returned
+    /// by preferredSize(). Child pools inherit the setting. 0 disables the
+    /// cache.
+    int64_t smallBufferCacheBytes{0};
   };
 
   /// Constructs a named memory pool with specified 'name', 'parent' and 'kind'.
@@ -205,6 +220,19 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
     return threadSafe_;
   }
 
+  /// Returns true if non-contiguous allocations of this pool prefer huge page
+  /// backed memory.
+  bool useHugePages() const {
+    return useHugePages_;
+  }
+
+  /// Sets whether non-contiguous allocations of this pool and of its children
+  /// created afterwards prefer huge page backed memory. Must be called before
+  /// the pool allocates.
+  void setUseHugePages(bool useHugePages) {
+    useHugePages_ = useHugePages;
+  }
+
   /// Returns true if this memory pool checks memory leak on destruction.
   /// Used only for test purposes.
   virtual bool testingCheckUsageLeak() const {
@@ -383,13 +411,14 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
   virtual MemoryReclaimer* reclaimer() const = 0;
 
   /// Invoked by the memory arbitrator to enter memory arbitration processing.
-  /// It is a noop if 'reclaimer_' is not set, otherwise invoke the reclaimer's
-  /// corresponding method.
+  /// It invokes the reclaimer's corresponding method if 'reclaimer_' is set,
+  /// otherwise forwards to the parent pool if any. The latter is for the pools
+  /// created by a component under an operator such as a file writer, whose
+  /// allocations shall still put the driver into suspension.
   virtual void enterArbitration() = 0;
 
   /// Invoked by the memory arbitrator to leave memory arbitration processing.
-  /// It is a noop if 'reclaimer_' is not set, otherwise invoke the reclaimer's
-  /// corresponding method.
+  /// It is used in pair with 'enterArbitration' and forwards the same way.
   virtual void leaveArbitration() noexcept = 0;
 
   /// Returns how many bytes is reclaimable from this memory pool. The function
@@ -419,6 +448,36 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
   /// Returns true if this memory pool has been aborted.
   virtual bool aborted() const = 0;
 
+  /// Sets the arbitration priority of this root memory pool. The memory
+  /// arbitrator reclaims from and aborts the pools with lower priority before
+  /// those with higher priority. The default is 0.
+  void setArbitrationPriority(int32_t priority) {
+    VELOX_CHECK(isRoot());
+    arbitrationPriority_ = priority;
+  }
+
+  int32_t arbitrationPriority() const {
+    return arbitrationPriority_;
+  }
+
+  /// Sets the tenant this root memory pool belongs to for the per tenant
+  /// capacity limits of the memory arbitrator. Must be set before the pool
+  /// takes part in memory arbitration.
+  void setArbitrationTenant(const std::string& tenant) {
+    VELOX_CHECK(isRoot());
+    arbitrationTenant_ = tenant;
+  }
+
+  const std::string& arbitrationTenant() const {
+    return arbitrationTenant_;
+  }
+
+  /// Returns the time in milliseconds since epoch when this memory pool was
+  /// created.
+  uint64_t createTimeMs() const {
+    return createTimeMs_;
+  }
+
   /// The memory pool's execution stats.
   struct Stats {
     /// The current memory usage.
@@ -465,6 +524,32 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
   /// Returns the stats of this memory pool.
   virtual Stats stats() const = 0;
 
+  /// A sample of the memory timeline of a leaf memory pool.
+  struct TimelineSample {
+    /// The time of the sample in milliseconds since the epoch.
+    uint64_t timeMs;
+    /// The reservation after the change that took the sample.
+    int64_t reservedBytes;
+    /// The used memory at the time of the sample.
+    int64_t usedBytes;
+
+    bool operator==(const TimelineSample& other) const {
+      return timeMs == other.timeMs && reservedBytes == other.reservedBytes &&
+          usedBytes == other.usedBytes;
+    }
+  };
+
+  /// Returns the memory timeline of a leaf memory pool, oldest sample first.
+  /// A sample is taken when the reservation changes, which is in quantized
+  /// steps (see quantizedSize()), so sampling is cheap. At most
+  /// kMaxTimelineSamples are kept. When full, every second sample is dropped
+  /// and only every second reservation change is sampled from then on, so
+  /// the timeline covers the whole life of the pool at a coarser resolution.
+  /// Empty for non-leaf pools.
+  virtual std::vector<TimelineSample> memoryTimeline() const = 0;
+
+  static constexpr int32_t kMaxTimelineSamples = 64;
+
   virtual std::string toString() const = 0;
 
   /// Invoked to generate a descriptive memory usage summary of the entire tree.
@@ -519,6 +604,11 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
   const bool threadSafe_;
   const bool checkUsageLeak_;
   const bool debugEnabled_;
+  const int64_t smallBufferCacheBytes_;
+  bool useHugePages_;
+  const uint64_t createTimeMs_;
+  std::atomic<int32_t> arbitrationPriority_{0};
+  std::string arbitrationTenant_;
 
   /// Indicates if the memory pool has been aborted by the memory arbitrator or
   /// not.
@@ -665,6 +755,24 @@ class MemoryPoolImpl : public MemoryPool {
 
   Stats stats() const override;
 
+  std::vector<TimelineSample> memoryTimeline() const override;
+
+  /// Returns the bytes of freed small buffers kept for reuse.
+  int64_t cachedBytes() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return cachedBytes_;
+  }
+
+  /// Returns the number of allocate() calls served from the small buffer
+  /// cache.
+  uint64_t numCacheHits() const {
+    return numCacheHits_;
+  }
+
+  /// Returns the cached small buffers to the allocator and releases their
+  /// memory usage. Returns the freed bytes.
+  uint64_t freeCachedBuffers();
+
   void testingSetCapacity(int64_t bytes);
 
   MemoryAllocator* testingAllocator() const {
@@ -726,6 +834,28 @@ class MemoryPoolImpl : public MemoryPool {
     return (remainder == 0) ? size : (size + alignment_ - remainder);
   }
 
+  // The largest buffer size kept in the small buffer cache.
+  static constexpr int64_t kMaxCachedBufferSize = 64 << 10;
+
+  // The number of free lists in the small buffer cache. There is one per
+  // power of two and one per 1.5 times a power of two up to
+  // 'kMaxCachedBufferSize'.
+  static constexpr int32_t kNumCacheSlots = 2 * 17;
+
+  // Returns the free list in the small buffer cache for buffers of 'size'
+  // bytes or -1 if 'size' is not cached.
+  static int32_t cacheSlot(int64_t size);
+
+  // Returns the buffer size for the free list at 'slot'.
+  static int64_t cacheSlotSize(int32_t slot);
+
+  // Returns a cached buffer of 'size' bytes or nullptr if there is none.
+  void* allocateFromCache(int64_t size);
+
+  // Keeps 'p' of 'size' bytes in the small buffer cache. Returns false if
+  // 'size' is not cached or the cache is full.
+  bool freeToCache(void* p, int64_t size);
+
   // Returns a rounded up delta based on adding 'delta' to 'size'. Adding the
   // rounded delta to 'size' will result in 'size' a quantized size, rounded to
   // the MB or 8MB for larger sizes.
@@ -794,6 +924,7 @@ class MemoryPoolImpl : public MemoryPool {
     }
 
     reservationBytes_ += size;
+    recordTimelineLocked();
     return true;
   }
 
@@ -850,6 +981,7 @@ class MemoryPoolImpl : public MemoryPool {
     const int64_t freeable = reservationBytes_ - newQuantized;
     if (FOLLY_UNLIKELY(freeable > 0)) {
       reservationBytes_ = newQuantized;
+      recordTimelineLocked();
       sanityCheckLocked();
       toImpl(parent_)->decrementReservation(freeable);
     }
@@ -858,6 +990,9 @@ class MemoryPoolImpl : public MemoryPool {
   // Decrements the reservation in 'this' and parents.
   void decrementReservation(uint64_t size) noexcept;
 
+  // Adds a sample to 'timeline_' after a reservation change of a leaf pool.
+  void recordTimelineLocked();
+
   FOLLY_ALWAYS_INLINE void sanityCheckLocked() const {
     if (FOLLY_UNLIKELY(
             (reservationBytes_ < usedReservationBytes_) ||
@@ -999,6 +1134,27 @@ class MemoryPoolImpl : public MemoryPool {
   // memory reservation requests.
   std::atomic<uint64_t> numCollisions_{0};
 
+  // The number of allocations served from 'cachedBuffers_'.
+  std::atomic<uint64_t> numCacheHits_{0};
+
+  // The free lists of the small buffer cache, indexed by cacheSlot(). Guarded
+  // by 'mutex_' if 'threadSafe_'.
+  std::array<std::vector<void*>, kNumCacheSlots> cachedBuffers_;
+
+  // The total bytes in 'cachedBuffers_'.
+  int64_t cachedBytes_{0};
+
+  // The samples returned by memoryTimeline(). Guarded by 'mutex_' if
+  // 'threadSafe_'.
+  std::vector<TimelineSample> timeline_;
+
+  // Only every 'timelineStride_'th reservation change is sampled. Doubles
+  // each time 'timeline_' is thinned out.
+  uint64_t timelineStride_{1};
+
+  // The number of reservation changes of a leaf pool.
+  uint64_t numReservationChanges_{0};
+
   // Mutex for 'debugAllocRecords_'.
   std::mutex debugAllocMutex_;
 
@@ -17,13 +17,67 @@
 #include "velox/common/memory/MmapAllocator.h"
 
 #include <sys/mman.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "velox/common/base/Portability.h"
 #include "velox/common/memory/Memory.h"
 
 namespace facebook::velox::memory {
+namespace {
+// The node set by MmapAllocator::setThreadNumaNode() for the calling thread.
+thread_local int32_t threadPreferredNumaNode = MmapAllocator::kNoNumaNode;
+
+// Returns the NUMA node of the CPU the calling thread runs on, or 0 if not
+// known.
+int32_t currentNumaNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned cpu;
+  unsigned node;
+  if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return node;
+  }
+#endif
+  return 0;
+}
+
+// Makes the kernel place the pages of [address, address + size) on 'node'
+// when they are first touched. The memory comes from other nodes if 'node'
+// has none free.
+void preferNumaNode(void* address, size_t size, int32_t node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  constexpr int kMpolPreferred = 1;
+  constexpr int32_t kMaxNodes = 1024;
+  VELOX_CHECK_LT(node, kMaxNodes);
+  std::vector<uint64_t> nodeMask(kMaxNodes / 64);
+  bits::setBit(nodeMask.data(), node);
+  if (::syscall(
+          SYS_mbind,
+          address,
+          size,
+          kMpolPreferred,
+          nodeMask.data(),
+          kMaxNodes,
+          0) != 0) {
+    VELOX_MEM_LOG(WARNING) << "mbind to NUMA node " << node << " failed with "
+                           << folly::errnoStr(errno);
+  }
+#endif
+}
+} // namespace
+
 MmapAllocator::MmapAllocator(const Options& options)
     : kind_(MemoryAllocator::Kind::kMmap),
+      numNumaNodes_(std::max(1, options.numNumaNodes)),
+      numNodeClasses_(numNumaNodes_ * sizeClassSizes_.size()),
+      hugePageCapacity_(
+          options.hugePageCapacity == 0
+              ? 0
+              : bits::roundUp(
+                    AllocationTraits::numPages(options.hugePageCapacity),
+                    64 * sizeClassSizes_.back())),
       useMmapArena_(options.useMmapArena),
       maxMallocBytes_(options.maxMallocBytes),
       mallocReservedBytes_(
@@ -32,9 +86,20 @@ MmapAllocator::MmapAllocator(const Options& options)
               : options.capacity * options.smallAllocationReservePct / 100),
       capacity_(bits::roundUp(
           AllocationTraits::numPages(options.capacity - mallocReservedBytes_),
-          64 * sizeClassSizes_.back())) {
-  for (const auto& size : sizeClassSizes_) {
-    sizeClasses_.push_back(std::make_unique<SizeClass>(capacity_ / size, size));
+          64 * sizeClassSizes_.back() * std::max(1, options.numNumaNodes))) {
+  for (auto node = 0; node < numNumaNodes_; ++node) {
+    for (const auto& size : sizeClassSizes_) {
+      sizeClasses_.push_back(std::make_unique<SizeClass>(
+          capacity_ / size / numNumaNodes_,
+          size,
+          numNumaNodes_ == 1 ? kNoNumaNode : node));
+    }
+  }
+  if (hugePageCapacity_ != 0) {
+    for (const auto& size : sizeClassSizes_) {
+      sizeClasses_.push_back(std::make_unique<SizeClass>(
+          hugePageCapacity_ / size, size, kNoNumaNode, true));
+    }
   }
 
   if (useMmapArena_) {
@@ -55,7 +120,8 @@ bool MmapAllocator::allocateNonContiguousWithoutRetry(
     MachinePageCount numPages,
     Allocation& out,
     ReservationCallback reservationCB,
-    MachinePageCount minSizeClass) {
+    MachinePageCount minSizeClass,
+    bool hugePages) {
   const MachinePageCount numFreed = freeInternal(out);
   const auto bytesFreed = AllocationTraits::pageBytes(numFreed);
   if (numFreed != 0) {
@@ -117,8 +183,12 @@ bool MmapAllocator::allocateNonContiguousWithoutRetry(
         AllocationTraits::pageBytes(sizeClassSizes_[mix.sizeIndices[i]]),
         mix.sizeCounts[i],
         [&]() {
-          success = sizeClasses_[mix.sizeIndices[i]]->allocate(
-              mix.sizeCounts[i], newMapsNeeded, out);
+          success = allocateFromSizeClass(
+              mix.sizeIndices[i],
+              mix.sizeCounts[i],
+              hugePages,
+              newMapsNeeded,
+              out);
         });
     if (success && ((i > 0) || (mix.numSizes == 1)) &&
         testingHasInjectedFailure(InjectedFailure::kAllocate)) {
@@ -158,6 +228,77 @@ bool MmapAllocator::allocateNonContiguousWithoutRetry(
   return false;
 }
 
+bool MmapAllocator::allocateFromSizeClass(
+    int32_t sizeIndex,
+    ClassPageCount numPages,
+    bool hugePages,
+    MachinePageCount& numUnmapped,
+    Allocation& out) {
+  auto numRemaining = numPages;
+  if (hugePages && hugePageCapacity_ != 0) {
+    // The huge page size classes are outside of 'capacity_' for mapping
+    // purposes since they are never advised away.
+    MachinePageCount numHugeUnmapped = 0;
+    numRemaining -= hugePageSizeClassAt(sizeIndex).allocateUpTo(
+        numRemaining, numHugeUnmapped, out);
+    numHugePageClassPages_ +=
+        (numPages - numRemaining) * sizeClassSizes_[sizeIndex];
+    numHugePageFallbackPages_ += numRemaining * sizeClassSizes_[sizeIndex];
+    if (numRemaining == 0) {
+      return true;
+    }
+  }
+  if (numNumaNodes_ == 1) {
+    return sizeClasses_[sizeIndex]->allocate(numRemaining, numUnmapped, out);
+  }
+  const auto localNode = threadNumaNode();
+  for (auto i = 0; i < numNumaNodes_ && numRemaining > 0; ++i) {
+    const auto node = (localNode + i) % numNumaNodes_;
+    const auto numAllocated = sizeClassAt(node, sizeIndex)
+                                  .allocateUpTo(numRemaining, numUnmapped, out);
+    const auto numMachinePages = numAllocated * sizeClassSizes_[sizeIndex];
+    if (i == 0) {
+      numLocalNodePages_ += numMachinePages;
+    } else {
+      numRemoteNodePages_ += numMachinePages;
+    }
+    numRemaining -= numAllocated;
+  }
+  return numRemaining == 0;
+}
+
+int32_t MmapAllocator::threadNumaNode() const {
+  auto node = threadPreferredNumaNode;
+  if (node == kNoNumaNode) {
+    node = currentNumaNode();
+  }
+  return node % numNumaNodes_;
+}
+
+// static
+void MmapAllocator::setThreadNumaNode(int32_t node) {
+  VELOX_CHECK(node == kNoNumaNode || node >= 0);
+  threadPreferredNumaNode = node;
+}
+
+MachinePageCount MmapAllocator::numHugePageAllocated() const {
+  MachinePageCount result = 0;
+  for (auto i = numNodeClasses_; i < sizeClasses_.size(); ++i) {
+    result += sizeClasses_[i]->numAllocatedPages();
+  }
+  return result;
+}
+
+std::vector<MachinePageCount> MmapAllocator::numAllocatedPerNode() const {
+  std::vector<MachinePageCount> result(numNumaNodes_, 0);
+  for (auto node = 0; node < numNumaNodes_; ++node) {
+    for (auto i = 0; i < sizeClassSizes_.size(); ++i) {
+      result[node] += sizeClassAt(node, i).numAllocatedPages();
+    }
+  }
+  return result;
+}
+
 bool MmapAllocator::ensureEnoughMappedPages(int32_t newMappedNeeded) {
   if (testingHasInjectedFailure(InjectedFailure::kMadvise)) {
     return false;
@@ -205,8 +346,8 @@ MachinePageCount MmapAllocator::freeInternal(Allocation& allocation) {
       // Increment the free time only if the allocation contained
       // pages in the class. Note that size class indices in the
       // allocator are not necessarily the same as in the stats.
-      const auto sizeIndex =
-          Stats::sizeIndex(AllocationTraits::pageBytes(sizeClassSizes_[i]));
+      const auto sizeIndex = Stats::sizeIndex(AllocationTraits::pageBytes(
+          sizeClassSizes_[i % sizeClassSizes_.size()]));
       stats_.sizes[sizeIndex].freeClocks += clocks;
     }
     numFreed += pages;
@@ -531,7 +672,9 @@ void MmapAllocator::markAllMapped(const Allocation& allocation) {
 
 MachinePageCount MmapAllocator::adviseAway(MachinePageCount target) {
   MachinePageCount numAway = 0;
-  for (int32_t i = sizeClasses_.size() - 1; i >= 0; --i) {
+  // The huge page size classes are not advised away, which would split their
+  // huge pages.
+  for (int32_t i = numNodeClasses_ - 1; i >= 0; --i) {
     numAway += sizeClasses_[i]->adviseAway(target - numAway);
     if (numAway >= target) {
       break;
@@ -540,9 +683,15 @@ MachinePageCount MmapAllocator::adviseAway(MachinePageCount target) {
   return numAway;
 }
 
-MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
+MmapAllocator::SizeClass::SizeClass(
+    size_t capacity,
+    MachinePageCount unitSize,
+    int32_t numaNode,
+    bool hugePages)
     : capacity_(capacity),
       unitSize_(unitSize),
+      numaNode_(numaNode),
+      hugePages_(hugePages),
       byteSize_(AllocationTraits::pageBytes(capacity_ * unitSize_)),
       pageBitmapSize_(capacity_ / 64),
       // Min 8 words + 1 bit for every 512 bits in 'pageAllocated_'.
@@ -554,9 +703,13 @@ MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
       0,
       "Sizeclass {} must have a multiple of 64 capacity",
       unitSize_);
+  // A huge page size class maps one huge page more and trims the range to
+  // huge page boundaries.
+  const size_t mapSize =
+      hugePages_ ? byteSize_ + AllocationTraits::kHugePageSize : byteSize_;
   void* ptr = mmap(
       nullptr,
-      AllocationTraits::pageBytes(capacity_ * unitSize_),
+      mapSize,
       PROT_READ | PROT_WRITE,
       MAP_PRIVATE | MAP_ANONYMOUS,
       -1,
@@ -569,6 +722,32 @@ MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
         unitSize_);
   }
   address_ = reinterpret_cast<uint8_t*>(ptr);
+  if (hugePages_) {
+    auto* start = reinterpret_cast<uint8_t*>(bits::roundUp(
+        reinterpret_cast<uint64_t>(address_), AllocationTraits::kHugePageSize));
+    if (start > address_) {
+      ::munmap(address_, start - address_);
+    }
+    const auto tail = (address_ + mapSize) - (start + byteSize_);
+    if (tail > 0) {
+      ::munmap(start + byteSize_, tail);
+    }
+    address_ = start;
+#ifdef MADV_HUGEPAGE
+    if (::madvise(address_, byteSize_, MADV_HUGEPAGE) != 0) {
+      VELOX_MEM_LOG(WARNING) << "madvise hugepage for size class " << unitSize_
+                             << " failed with " << folly::errnoStr(errno);
+    }
+#endif
+  }
+  if (numaNode_ != kNoNumaNode) {
+    preferNumaNode(address_, byteSize_, numaNode_);
+  }
+}
+
+MachinePageCount MmapAllocator::SizeClass::numAllocatedPages() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return numAllocated_ * unitSize_;
 }
 
 MmapAllocator::SizeClass::~SizeClass() {
@@ -616,6 +795,12 @@ ClassPageCount MmapAllocator::SizeClass::checkConsistency(
         << " vs recorded= " << numMappedFreePages_
         << ". Total mapped=" << mappedCount;
   }
+  if (count != numAllocated_) {
+    ++numErrors;
+    VELOX_MEM_LOG(WARNING) << "Mismatched count of allocated pages in size "
+                           << "class " << unitSize_ << ". Actual= " << count
+                           << " vs recorded= " << numAllocated_;
+  }
   numMapped = mappedCount;
   return count;
 }
@@ -632,7 +817,14 @@ std::string MmapAllocator::SizeClass::toString() const {
         __builtin_popcountll(~pageAllocated_[i] & pageMapped_[i]);
   }
   auto mb = (AllocationTraits::pageBytes(count * unitSize_)) >> 20;
-  out << "[size " << unitSize_ << ": " << count << "(" << mb << "MB) allocated "
+  out << "[";
+  if (numaNode_ != kNoNumaNode) {
+    out << "node " << numaNode_ << " ";
+  }
+  if (hugePages_) {
+    out << "huge page ";
+  }
+  out << "size " << unitSize_ << ": " << count << "(" << mb << "MB) allocated "
       << mappedCount << " mapped";
   if (mappedFreeCount != numMappedFreePages_) {
     out << "Mismatched count of mapped free pages "
@@ -652,6 +844,20 @@ bool MmapAllocator::SizeClass::allocate(
   return allocateLocked(numPages, &numUnmapped, out);
 }
 
+ClassPageCount MmapAllocator::SizeClass::allocateUpTo(
+    ClassPageCount numPages,
+    MachinePageCount& numUnmapped,
+    Allocation& out) {
+  std::lock_guard<std::mutex> l(mutex_);
+  const auto numToAllocate =
+      std::min<ClassPageCount>(numPages, capacity_ - numAllocated_);
+  if (numToAllocate == 0) {
+    return 0;
+  }
+  VELOX_CHECK(allocateLocked(numToAllocate, &numUnmapped, out));
+  return numToAllocate;
+}
+
 bool MmapAllocator::SizeClass::allocateLocked(
     const ClassPageCount numPages,
     MachinePageCount* numUnmapped,
@@ -772,6 +978,7 @@ void MmapAllocator::SizeClass::allocateFromMappedFree(
             }
             const auto page = word * 64 + bit;
             bits::setBit(pageAllocated_.data(), page);
+            ++numAllocated_;
             allocation.append(
                 address_ + AllocationTraits::pageBytes(page * unitSize_),
                 unitSize_);
@@ -920,6 +1127,7 @@ MachinePageCount MmapAllocator::SizeClass::free(Allocation& allocation) {
         markMappedFree(page);
       }
       bits::clearBit(pageAllocated_.data(), page);
+      --numAllocated_;
       numFreed += unitSize_;
     }
   }
@@ -948,6 +1156,7 @@ void MmapAllocator::SizeClass::allocateAny(
     freeBits &= freeBits - 1;
   }
   numPages -= toAlloc;
+  numAllocated_ += toAlloc;
 }
 
 bool MmapAllocator::checkConsistency() const {
@@ -992,6 +1201,21 @@ std::string MmapAllocator::toString() const {
   for (auto& sizeClass : sizeClasses_) {
     out << sizeClass->toString() << std::endl;
   }
+  if (hugePageCapacity_ != 0) {
+    // Pages outside of the huge page size classes may each need a TLB entry.
+    out << "[huge page size classes: capacity " << hugePageCapacity_
+        << " pages, allocated " << numHugePageAllocated() << " pages, "
+        << numHugePageClassPages_ << " pages allocated in huge pages, "
+        << numHugePageFallbackPages_ << " pages fell back to small pages]"
+        << std::endl;
+  }
+  if (numNumaNodes_ > 1) {
+    const auto perNode = numAllocatedPerNode();
+    for (auto node = 0; node < numNumaNodes_; ++node) {
+      out << "[node " << node << ": " << perNode[node] << " allocated pages]"
+          << std::endl;
+    }
+  }
   out << "]";
   return out.str();
 }
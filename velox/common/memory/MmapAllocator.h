@@ -75,8 +75,27 @@ class MmapAllocator : public MemoryAllocator {
     /// and 'smallAllocationReservePct' will be automatically set to 0
     /// disregarding any passed in value.
     int32_t maxMallocBytes = 3072;
+
+    /// If greater than 1, each size class is split into one arena per NUMA
+    /// node, each with an equal share of the capacity and with its memory
+    /// preferably placed on its node via mbind(). A non-contiguous allocation
+    /// is taken from the arenas of the node of the calling thread first and
+    /// from the other nodes only when these are full.
+    int32_t numNumaNodes = 1;
+
+    /// If not zero, this many bytes of 'capacity' are set aside in a separate
+    /// set of size classes whose address ranges are aligned to 2MB and
+    /// advised to be backed by transparent huge pages. Non-contiguous
+    /// allocations that ask for huge pages, see MemoryPool::Options, are taken
+    /// from these first. Pages of these size classes are not advised away, so
+    /// that the huge pages are not split.
+    uint64_t hugePageCapacity = 0;
   };
 
+  /// Denotes that a thread has no preferred NUMA node or that a size class is
+  /// not bound to one.
+  static constexpr int32_t kNoNumaNode = -1;
+
   explicit MmapAllocator(const Options& options);
 
   ~MmapAllocator();
@@ -150,11 +169,30 @@ class MmapAllocator : public MemoryAllocator {
   Stats stats() const override {
     auto stats = stats_;
     stats.numAdvise = numAdvisedPages_;
+    stats.numLocalNodePages = numLocalNodePages_;
+    stats.numRemoteNodePages = numRemoteNodePages_;
     return stats;
   }
 
   std::string toString() const override;
 
+  int32_t numNumaNodes() const {
+    return numNumaNodes_;
+  }
+
+  /// Returns the number of machine pages allocated from the size classes of
+  /// each NUMA node.
+  std::vector<MachinePageCount> numAllocatedPerNode() const;
+
+  /// Returns the number of machine pages allocated from the huge page size
+  /// classes.
+  MachinePageCount numHugePageAllocated() const;
+
+  /// Makes the size classes of 'node' the first choice for the allocations of
+  /// the calling thread. By default a thread prefers the node of the CPU it
+  /// runs on. kNoNumaNode restores the default.
+  static void setThreadNumaNode(int32_t node);
+
  private:
   static constexpr uint64_t kAllSet = 0xffffffffffffffff;
 
@@ -162,7 +200,16 @@ class MmapAllocator : public MemoryAllocator {
   // 'unitSize_' machine pages.
   class SizeClass {
    public:
-    SizeClass(size_t capacity, MachinePageCount unitSize);
+    // If 'numaNode' is not kNoNumaNode, the memory of 'this' is preferably
+    // placed on 'numaNode'.
+    //
+    // If 'hugePages' is true, the address range of 'this' is aligned to 2MB
+    // and advised to be backed by transparent huge pages.
+    SizeClass(
+        size_t capacity,
+        MachinePageCount unitSize,
+        int32_t numaNode = kNoNumaNode,
+        bool hugePages = false);
 
     ~SizeClass();
 
@@ -170,6 +217,17 @@ class MmapAllocator : public MemoryAllocator {
       return unitSize_;
     }
 
+    int32_t numaNode() const {
+      return numaNode_;
+    }
+
+    bool hugePages() const {
+      return hugePages_;
+    }
+
+    // Returns the number of allocated machine pages.
+    MachinePageCount numAllocatedPages() const;
+
     // Allocates 'numPages' from 'this' and appends these to *out.
     // '*numUnmapped' is incremented by the number of pages that are not backed
     // by memory.
@@ -178,6 +236,14 @@ class MmapAllocator : public MemoryAllocator {
         MachinePageCount& numUnmapped,
         Allocation& out);
 
+    // Allocates up to 'numPages' from 'this' as long as there are free class
+    // pages and appends these to *out. Returns the number of class pages
+    // allocated. '*numUnmapped' is incremented as in allocate().
+    ClassPageCount allocateUpTo(
+        ClassPageCount numPages,
+        MachinePageCount& numUnmapped,
+        Allocation& out);
+
     // Frees all pages of 'allocation' that fall in this size
     // class. Erases the corresponding runs from 'allocation'.
     MachinePageCount free(Allocation& allocation);
@@ -267,6 +333,10 @@ class MmapAllocator : public MemoryAllocator {
     // Size of one size class page in machine pages.
     const MachinePageCount unitSize_;
 
+    const int32_t numaNode_;
+
+    const bool hugePages_;
+
     // Size in bytes of the address range.
     const size_t byteSize_;
 
@@ -275,7 +345,7 @@ class MmapAllocator : public MemoryAllocator {
     const int32_t pageBitmapSize_;
 
     // Serializes access to all data members and private methods.
-    std::mutex mutex_;
+    mutable std::mutex mutex_;
 
     // Start of address range.
     uint8_t* address_;
@@ -287,6 +357,9 @@ class MmapAllocator : public MemoryAllocator {
     // Count of free pages backed by memory.
     ClassPageCount numMappedFreePages_ = 0;
 
+    // Count of allocated class pages.
+    ClassPageCount numAllocated_ = 0;
+
     // Last used index in 'mappedFreeLookup_'.
     int32_t lastLookupIndex_{kNoLastLookup};
 
@@ -316,7 +389,8 @@ class MmapAllocator : public MemoryAllocator {
       MachinePageCount numPages,
       Allocation& out,
       ReservationCallback reservationCB = nullptr,
-      MachinePageCount minSizeClass = 0) override;
+      MachinePageCount minSizeClass = 0,
+      bool hugePages = false) override;
 
   bool allocateContiguousWithoutRetry(
       MachinePageCount numPages,
@@ -370,8 +444,44 @@ class MmapAllocator : public MemoryAllocator {
 
   bool useMalloc(uint64_t bytes);
 
+  // Returns the size class for 'sizeIndex' in 'sizeClassSizes_' on 'node'.
+  SizeClass& sizeClassAt(int32_t node, int32_t sizeIndex) const {
+    return *sizeClasses_[node * sizeClassSizes_.size() + sizeIndex];
+  }
+
+  // Returns the huge page size class for 'sizeIndex' in 'sizeClassSizes_'.
+  // May only be called if 'hugePageCapacity_' is not 0.
+  SizeClass& hugePageSizeClassAt(int32_t sizeIndex) const {
+    return *sizeClasses_[numNodeClasses_ + sizeIndex];
+  }
+
+  // Allocates 'numPages' class pages of the size class for 'sizeIndex',
+  // taking from the huge page size class first if 'hugePages' and then from
+  // the node of the calling thread. '*numUnmapped' is incremented as in
+  // SizeClass::allocate().
+  bool allocateFromSizeClass(
+      int32_t sizeIndex,
+      ClassPageCount numPages,
+      bool hugePages,
+      MachinePageCount& numUnmapped,
+      Allocation& out);
+
+  // Returns the node whose size classes the calling thread allocates from
+  // first.
+  int32_t threadNumaNode() const;
+
   const Kind kind_;
 
+  const int32_t numNumaNodes_;
+
+  // The number of size classes of all NUMA nodes. These come first in
+  // 'sizeClasses_'.
+  const int32_t numNodeClasses_;
+
+  // The capacity of each huge page size class in machine pages. 0 if there
+  // are no huge page size classes.
+  const MachinePageCount hugePageCapacity_;
+
   // If set true, allocations larger than the largest size class size will be
   // delegated to ManagedMmapArena. Otherwise, a system mmap call will be
   // issued for each such allocation.
@@ -406,6 +516,9 @@ class MmapAllocator : public MemoryAllocator {
   // to std::malloc().
   const MachinePageCount capacity_ = 0;
 
+  // The size classes of each NUMA node in the order of 'sizeClassSizes_',
+  // one node after the other, followed by the huge page size classes if
+  // 'hugePageCapacity_' is not 0.
   std::vector<std::unique_ptr<SizeClass>> sizeClasses_;
 
   // Statistics.
@@ -413,6 +526,12 @@ class MmapAllocator : public MemoryAllocator {
   std::atomic<uint64_t> numAllocatedPages_ = 0;
   std::atomic<uint64_t> numAdvisedPages_ = 0;
   std::atomic<uint64_t> numMallocBytes_ = 0;
+  std::atomic<uint64_t> numLocalNodePages_ = 0;
+  std::atomic<uint64_t> numRemoteNodePages_ = 0;
+  // Cumulative count of pages asked for with huge pages that came from the
+  // huge page size classes and that did not fit there.
+  std::atomic<uint64_t> numHugePageClassPages_ = 0;
+  std::atomic<uint64_t> numHugePageFallbackPages_ = 0;
 
   // Allocations that are larger than largest size classes will be delegated to
   // ManagedMmapArenas, to avoid calling mmap on every allocation.
@@ -16,7 +16,12 @@
 
 #include "velox/common/memory/SharedArbitrator.h"
 
+#include <algorithm>
+#include <limits>
+
+#include "velox/common/base/Counters.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/StatsReporter.h"
 #include "velox/common/testutil/TestValue.h"
 #include "velox/common/time/Timer.h"
 
@@ -61,17 +66,30 @@ std::string memoryPoolAbortMessage(
 } // namespace
 
 SharedArbitrator::SharedArbitrator(const MemoryArbitrator::Config& config)
-    : MemoryArbitrator(config), freeCapacity_(capacity_) {
+    : MemoryArbitrator(config),
+      victimAgeProtectionMs_(config.victimAgeProtectionMs),
+      tenantCapacities_(config.tenantCapacities),
+      freeCapacity_(capacity_) {
   VELOX_CHECK_EQ(kind_, config.kind);
 }
 
 std::string SharedArbitrator::Candidate::toString() const {
   return fmt::format(
-      "CANDIDATE[{} RECLAIMABLE[{}] RECLAIMABLE_BYTES[{}] FREE_BYTES[{}]]",
+      "CANDIDATE[{} RECLAIMABLE[{}] RECLAIMABLE_BYTES[{}] FREE_BYTES[{}] PRIORITY[{}] AGE[{}]]",
       pool->root()->name(),
       reclaimable,
       succinctBytes(reclaimableBytes),
-      succinctBytes(freeBytes));
+      succinctBytes(freeBytes),
+      priority,
+      succinctMillis(ageMs));
+}
+
+double SharedArbitrator::reclaimScore(const Candidate& candidate) const {
+  if (victimAgeProtectionMs_ == 0) {
+    return candidate.reclaimableBytes;
+  }
+  return candidate.reclaimableBytes /
+      (1.0 + static_cast<double>(candidate.ageMs) / victimAgeProtectionMs_);
 }
 
 void SharedArbitrator::sortCandidatesByFreeCapacity(
@@ -93,14 +111,17 @@ void SharedArbitrator::sortCandidatesByReclaimableMemory(
   std::sort(
       candidates.begin(),
       candidates.end(),
-      [](const Candidate& lhs, const Candidate& rhs) {
+      [&](const Candidate& lhs, const Candidate& rhs) {
         if (!lhs.reclaimable) {
           return false;
         }
         if (!rhs.reclaimable) {
           return true;
         }
-        return lhs.reclaimableBytes > rhs.reclaimableBytes;
+        if (lhs.priority != rhs.priority) {
+          return lhs.priority < rhs.priority;
+        }
+        return reclaimScore(lhs) > reclaimScore(rhs);
       });
 
   TestValue::adjust(
@@ -122,11 +143,15 @@ SharedArbitrator::findCandidateWithLargestCapacity(
     // current capacity and the capacity growth.
     const int64_t capacity =
         candidates[i].pool->capacity() + (isCandidate ? targetBytes : 0);
-    if (i == 0) {
-      candidateIdx = 0;
+    // The pools with the lowest priority are aborted first.
+    if (i == 0 || candidates[i].priority < candidates[candidateIdx].priority) {
+      candidateIdx = i;
       maxCapacity = capacity;
       continue;
     }
+    if (candidates[i].priority > candidates[candidateIdx].priority) {
+      continue;
+    }
     if (capacity < maxCapacity) {
       continue;
     }
@@ -173,15 +198,67 @@ std::vector<SharedArbitrator::Candidate> SharedArbitrator::getCandidateStats(
     const std::vector<std::shared_ptr<MemoryPool>>& pools) {
   std::vector<SharedArbitrator::Candidate> candidates;
   candidates.reserve(pools.size());
+  const uint64_t nowMs = getCurrentTimeMs();
   for (const auto& pool : pools) {
     uint64_t reclaimableBytes;
     const bool reclaimable = pool->reclaimableBytes(reclaimableBytes);
     candidates.push_back(
-        {reclaimable, reclaimableBytes, pool->freeBytes(), pool.get()});
+        {reclaimable,
+         reclaimableBytes,
+         pool->freeBytes(),
+         pool.get(),
+         pool->arbitrationPriority(),
+         nowMs - std::min(nowMs, pool->createTimeMs())});
   }
   return candidates;
 }
 
+uint64_t SharedArbitrator::tenantHeadroom(
+    const MemoryPool* requestor,
+    const std::vector<Candidate>& candidates) const {
+  const auto& tenant = requestor->arbitrationTenant();
+  const auto it = tenantCapacities_.find(tenant);
+  if (tenant.empty() || it == tenantCapacities_.end()) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  uint64_t tenantCapacity{0};
+  for (const auto& candidate : candidates) {
+    if (candidate.pool->arbitrationTenant() == tenant) {
+      tenantCapacity += candidate.pool->capacity();
+    }
+  }
+  return it->second - std::min(it->second, tenantCapacity);
+}
+
+// static
+void SharedArbitrator::keepTenantCandidates(
+    const MemoryPool* requestor,
+    std::vector<Candidate>& candidates) {
+  const auto& tenant = requestor->arbitrationTenant();
+  candidates.erase(
+      std::remove_if(
+          candidates.begin(),
+          candidates.end(),
+          [&](const Candidate& candidate) {
+            return candidate.pool->arbitrationTenant() != tenant;
+          }),
+      candidates.end());
+}
+
+void SharedArbitrator::logDecision(std::string decision) {
+  VELOX_MEM_LOG(INFO) << decision;
+  std::lock_guard<std::mutex> l(mutex_);
+  if (decisionLog_.size() == kMaxDecisionLogSize) {
+    decisionLog_.pop_front();
+  }
+  decisionLog_.push_back(std::move(decision));
+}
+
+std::vector<std::string> SharedArbitrator::decisionLog() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return {decisionLog_.begin(), decisionLog_.end()};
+}
+
 bool SharedArbitrator::growMemory(
     MemoryPool* pool,
     const std::vector<std::shared_ptr<MemoryPool>>& candidatePools,
@@ -209,7 +286,20 @@ bool SharedArbitrator::growMemory(
   for (;; ++numRetries) {
     // Get refreshed stats before the memory arbitration retry.
     candidates = getCandidateStats(candidatePools);
-    if (arbitrateMemory(requestor, candidates, targetBytes)) {
+    const uint64_t headroom = tenantHeadroom(requestor, candidates);
+    if (headroom < targetBytes) {
+      // The tenant is at its capacity limit and can only rebalance among its
+      // own pools.
+      ++numTenantLimitedRequests_;
+      logDecision(fmt::format(
+          "Tenant '{}' of {} is at its capacity limit, arbitrating {} among "
+          "its own pools",
+          requestor->arbitrationTenant(),
+          requestor->name(),
+          succinctBytes(targetBytes)));
+      keepTenantCandidates(requestor, candidates);
+    }
+    if (arbitrateMemory(requestor, candidates, targetBytes, headroom)) {
       return true;
     }
     if (numRetries > 0) {
@@ -269,9 +359,13 @@ bool SharedArbitrator::handleOOM(
         << " is selected as victim memory pool so fail the memory arbitration";
     return false;
   }
-  VELOX_MEM_LOG(WARNING) << "Aborting victim memory pool " << victim->name()
-                         << " to free up memory for requestor "
-                         << requestor->name();
+  logDecision(fmt::format(
+      "Aborting victim memory pool {} with priority {} and capacity {} to "
+      "free up memory for requestor {}",
+      victim->name(),
+      victim->arbitrationPriority(),
+      succinctBytes(victim->capacity()),
+      requestor->name()));
   try {
     VELOX_MEM_POOL_ABORTED(
         memoryPoolAbortMessage(victim, requestor, targetBytes));
@@ -287,13 +381,19 @@ bool SharedArbitrator::handleOOM(
 bool SharedArbitrator::arbitrateMemory(
     MemoryPool* requestor,
     std::vector<Candidate>& candidates,
-    uint64_t targetBytes) {
+    uint64_t targetBytes,
+    uint64_t maxFreeBytes) {
   VELOX_CHECK(!requestor->aborted());
 
-  const uint64_t growTarget = std::min(
+  uint64_t growTarget = std::min(
       maxGrowBytes(*requestor),
       std::max(memoryPoolTransferCapacity_, targetBytes));
-  uint64_t freedBytes = decrementFreeCapacity(growTarget);
+  if (maxFreeBytes >= targetBytes) {
+    // Do not grow the requestor's tenant beyond its capacity limit.
+    growTarget = std::min(growTarget, maxFreeBytes);
+  }
+  uint64_t freedBytes =
+      decrementFreeCapacity(std::min(growTarget, maxFreeBytes));
   if (freedBytes >= targetBytes) {
     requestor->grow(freedBytes);
     return true;
@@ -375,7 +475,8 @@ uint64_t SharedArbitrator::reclaimUsedMemoryFromCandidates(
   sortCandidatesByReclaimableMemory(candidates);
 
   int64_t freedBytes{0};
-  for (const auto& candidate : candidates) {
+  for (auto i = 0; i < candidates.size(); ++i) {
+    const auto& candidate = candidates[i];
     VELOX_CHECK_LT(freedBytes, targetBytes);
     if (!candidate.reclaimable || candidate.reclaimableBytes == 0) {
       break;
@@ -383,7 +484,27 @@ uint64_t SharedArbitrator::reclaimUsedMemoryFromCandidates(
     const int64_t bytesToReclaim = std::max<int64_t>(
         targetBytes - freedBytes, memoryPoolTransferCapacity_);
     VELOX_CHECK_GT(bytesToReclaim, 0);
-    freedBytes += reclaim(candidate.pool, bytesToReclaim);
+    const bool spared = std::any_of(
+        candidates.begin() + i + 1,
+        candidates.end(),
+        [&](const Candidate& other) {
+          return other.reclaimable &&
+              other.reclaimableBytes > candidate.reclaimableBytes;
+        });
+    if (spared) {
+      ++numVictimsByPriorityOrAge_;
+    }
+    const uint64_t reclaimedBytes = reclaim(candidate.pool, bytesToReclaim);
+    logDecision(fmt::format(
+        "Reclaimed {} from memory pool {} with priority {} and age {} for "
+        "requestor {}{}",
+        succinctBytes(reclaimedBytes),
+        candidate.pool->name(),
+        candidate.priority,
+        succinctMillis(candidate.ageMs),
+        requestor->name(),
+        spared ? ", sparing larger candidates" : ""));
+    freedBytes += reclaimedBytes;
     if ((freedBytes >= targetBytes) || requestor->aborted()) {
       break;
     }
@@ -510,6 +631,8 @@ SharedArbitrator::ScopedArbitration::~ScopedArbitration() {
       std::chrono::duration_cast<std::chrono::microseconds>(
           std::chrono::steady_clock::now() - startTime_);
   arbitrator_->arbitrationTimeUs_ += arbitrationTime.count();
+  REPORT_ADD_HISTOGRAM_VALUE(
+      kCounterArbitrationLatencyUs, arbitrationTime.count());
   arbitrator_->finishArbitration();
 }
 
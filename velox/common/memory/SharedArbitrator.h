@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "velox/common/memory/MemoryArbitrator.h"
 
 #include "velox/common/future/VeloxPromise.h"
@@ -62,12 +64,34 @@ class SharedArbitrator : public MemoryArbitrator {
 
   std::string toString() const final;
 
+  /// Returns the number of arbitration requests which could only take memory
+  /// from the pools of the requestor's tenant as the tenant was at its
+  /// capacity limit.
+  uint64_t numTenantLimitedRequests() const {
+    return numTenantLimitedRequests_;
+  }
+
+  /// Returns the number of times the memory of a candidate was reclaimed
+  /// while a candidate with more reclaimable bytes was spared for its higher
+  /// priority or age.
+  uint64_t numVictimsByPriorityOrAge() const {
+    return numVictimsByPriorityOrAge_;
+  }
+
+  /// Returns the most recent victim selection decisions, oldest first. At
+  /// most 'kMaxDecisionLogSize' decisions are kept.
+  std::vector<std::string> decisionLog() const;
+
+  static constexpr int32_t kMaxDecisionLogSize = 64;
+
   // The candidate memory pool stats used by arbitration.
   struct Candidate {
     bool reclaimable{false};
     uint64_t reclaimableBytes{0};
     uint64_t freeBytes{0};
     MemoryPool* pool;
+    int32_t priority{0};
+    uint64_t ageMs{0};
 
     std::string toString() const;
   };
@@ -105,6 +129,25 @@ class SharedArbitrator : public MemoryArbitrator {
   static std::vector<Candidate> getCandidateStats(
       const std::vector<std::shared_ptr<MemoryPool>>& pools);
 
+  // Returns the reclaimable bytes of 'candidate' discounted by its age as
+  // described in Config::victimAgeProtectionMs.
+  double reclaimScore(const Candidate& candidate) const;
+
+  // Returns how much more capacity the tenant of 'requestor' may take from
+  // the arbitrator given the capacity of the tenant's pools in 'candidates'.
+  // Returns max uint64_t if the tenant is not limited.
+  uint64_t tenantHeadroom(
+      const MemoryPool* requestor,
+      const std::vector<Candidate>& candidates) const;
+
+  // Removes the candidates which do not belong to the tenant of 'requestor'.
+  static void keepTenantCandidates(
+      const MemoryPool* requestor,
+      std::vector<Candidate>& candidates);
+
+  // Logs 'decision' and keeps it in 'decisionLog_'.
+  void logDecision(std::string decision);
+
   void sortCandidatesByReclaimableMemory(
       std::vector<Candidate>& candidates) const;
 
@@ -118,10 +161,14 @@ class SharedArbitrator : public MemoryArbitrator {
       uint64_t targetBytes,
       const std::vector<Candidate>& candidates) const;
 
+  // Grows 'requestor' by at least 'targetBytes' with the free capacity of the
+  // arbitrator, of which it takes at most 'maxFreeBytes', and the memory of
+  // 'candidates'.
   bool arbitrateMemory(
       MemoryPool* requestor,
       std::vector<Candidate>& candidates,
-      uint64_t targetBytes);
+      uint64_t targetBytes,
+      uint64_t maxFreeBytes);
 
   // Invoked to start next memory arbitration request, and it will wait for the
   // serialized execution if there is a running or other waiting arbitration
@@ -181,6 +228,9 @@ class SharedArbitrator : public MemoryArbitrator {
 
   Stats statsLocked() const;
 
+  const uint64_t victimAgeProtectionMs_;
+  const std::unordered_map<std::string, uint64_t> tenantCapacities_;
+
   mutable std::mutex mutex_;
   uint64_t freeCapacity_{0};
   // Indicates if there is a running arbitration request or not.
@@ -197,5 +247,10 @@ class SharedArbitrator : public MemoryArbitrator {
   tsan_atomic<uint64_t> arbitrationTimeUs_{0};
   tsan_atomic<uint64_t> numShrunkBytes_{0};
   tsan_atomic<uint64_t> numReclaimedBytes_{0};
+  std::atomic<uint64_t> numTenantLimitedRequests_{0};
+  std::atomic<uint64_t> numVictimsByPriorityOrAge_{0};
+
+  // The most recent victim selection decisions. Guarded by 'mutex_'.
+  std::deque<std::string> decisionLog_;
 };
 } // namespace facebook::velox::memory
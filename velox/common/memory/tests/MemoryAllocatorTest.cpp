@@ -464,6 +464,85 @@ TEST_P(MemoryAllocatorTest, mmapAllocatorInit) {
   }
 }
 
+TEST_P(MemoryAllocatorTest, numaNodes) {
+  if (!useMmap_) {
+    return;
+  }
+  MmapAllocator::Options options;
+  options.capacity = kCapacityBytes;
+  options.maxMallocBytes = 0;
+  options.numNumaNodes = 2;
+  auto allocator = std::make_shared<MmapAllocator>(options);
+  ASSERT_EQ(allocator->numNumaNodes(), 2);
+  const auto nodeCapacity =
+      AllocationTraits::numPages(allocator->capacity()) / 2;
+
+  MmapAllocator::setThreadNumaNode(1);
+  Allocation local;
+  ASSERT_TRUE(allocator->allocateNonContiguous(nodeCapacity / 2, local));
+  EXPECT_EQ(
+      allocator->numAllocatedPerNode(),
+      (std::vector<MachinePageCount>{0, local.numPages()}));
+
+  // What does not fit on the preferred node comes from the other node.
+  Allocation remote;
+  ASSERT_TRUE(allocator->allocateNonContiguous(nodeCapacity, remote));
+  const auto perNode = allocator->numAllocatedPerNode();
+  EXPECT_GT(perNode[0], 0);
+  EXPECT_LE(perNode[1], nodeCapacity);
+  EXPECT_EQ(perNode[0] + perNode[1], local.numPages() + remote.numPages());
+  const auto stats = allocator->stats();
+  EXPECT_EQ(stats.numLocalNodePages, perNode[1]);
+  EXPECT_EQ(stats.numRemoteNodePages, perNode[0]);
+  EXPECT_TRUE(allocator->checkConsistency());
+
+  allocator->freeNonContiguous(local);
+  allocator->freeNonContiguous(remote);
+  EXPECT_EQ(
+      allocator->numAllocatedPerNode(), (std::vector<MachinePageCount>{0, 0}));
+  EXPECT_TRUE(allocator->checkConsistency());
+  MmapAllocator::setThreadNumaNode(MmapAllocator::kNoNumaNode);
+}
+
+TEST_P(MemoryAllocatorTest, hugePageSizeClasses) {
+  if (!useMmap_) {
+    return;
+  }
+  MmapAllocator::Options options;
+  options.capacity = kCapacityBytes;
+  options.maxMallocBytes = 0;
+  options.hugePageCapacity = 64 << 20;
+  auto allocator = std::make_shared<MmapAllocator>(options);
+  const auto hugePageCapacity =
+      AllocationTraits::numPages(options.hugePageCapacity);
+
+  Allocation small;
+  ASSERT_TRUE(allocator->allocateNonContiguous(100, small));
+  EXPECT_EQ(allocator->numHugePageAllocated(), 0);
+
+  Allocation huge;
+  ASSERT_TRUE(allocator->allocateNonContiguous(
+      100, huge, nullptr, 0, /*hugePages=*/true));
+  EXPECT_EQ(allocator->numHugePageAllocated(), huge.numPages());
+
+  // What does not fit in the huge page size classes comes from the others.
+  Allocation overflow;
+  ASSERT_TRUE(allocator->allocateNonContiguous(
+      2 * hugePageCapacity, overflow, nullptr, 0, /*hugePages=*/true));
+  EXPECT_LT(
+      allocator->numHugePageAllocated(), huge.numPages() + overflow.numPages());
+  EXPECT_TRUE(allocator->checkConsistency());
+  EXPECT_NE(
+      allocator->toString().find("huge page size classes"), std::string::npos);
+
+  allocator->freeNonContiguous(small);
+  allocator->freeNonContiguous(huge);
+  allocator->freeNonContiguous(overflow);
+  EXPECT_EQ(allocator->numHugePageAllocated(), 0);
+  EXPECT_EQ(allocator->numAllocated(), 0);
+  EXPECT_TRUE(allocator->checkConsistency());
+}
+
 TEST_P(MemoryAllocatorTest, allocationPool) {
   const size_t kNumLargeAllocPages = instance_->largestSizeClass() * 2;
   const size_t kLarge = kNumLargeAllocPages * AllocationTraits::kPageSize;
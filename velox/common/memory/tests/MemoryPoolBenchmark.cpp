@@ -15,6 +15,7 @@
  */
 
 #include <folly/futures/Future.h>
+#include <array>
 #include <limits>
 
 #include "folly/Benchmark.h"
@@ -238,6 +239,41 @@ BENCHMARK(FlatSticks, iters) {
   });
 }
 
+namespace {
+// Allocates and frees AlignedBuffer sized buffers from 10 * 20 leaves in
+// parallel, with up to 'cacheBytes' of freed buffers kept in each leaf.
+void smallBufferChurn(size_t iters, int64_t cacheBytes) {
+  folly::BenchmarkSuspender suspender;
+  MemoryManager manager{{.poolSmallBufferCacheBytes = cacheBytes}};
+  for (size_t i = 0; i < 10 * 20; ++i) {
+    auto child =
+        manager.addRootPool("query_fragment_" + folly::to<std::string>(i));
+    addNLeaves(*child, 1);
+  }
+  BenchmarkHelper helper{manager};
+  suspender.dismiss();
+  helper.runForEachPool([iters](MemoryPool& pool) {
+    std::array<void*, 8> buffers;
+    for (size_t i = 0; i < iters; ++i) {
+      for (auto j = 0; j < buffers.size(); ++j) {
+        buffers[j] = pool.allocate(pool.preferredSize(100 << j));
+      }
+      for (auto j = 0; j < buffers.size(); ++j) {
+        pool.free(buffers[j], pool.preferredSize(100 << j));
+      }
+    }
+  });
+}
+} // namespace
+
+BENCHMARK(SmallBufferChurn, iters) {
+  smallBufferChurn(iters, 0);
+}
+
+BENCHMARK_RELATIVE(SmallBufferChurnCached, iters) {
+  smallBufferChurn(iters, 1 << 20);
+}
+
 int main(int argc, char* argv[]) {
   folly::init(&argc, &argv);
   folly::runBenchmarks();
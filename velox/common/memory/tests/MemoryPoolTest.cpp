@@ -391,6 +391,94 @@ TEST_P(MemoryPoolTest, AllocTest) {
   ASSERT_EQ(4 * kChunkSize, child->stats().peakBytes);
 }
 
+TEST_P(MemoryPoolTest, smallBufferCache) {
+  MemoryManagerOptions options{.capacity = kDefaultCapacity};
+  options.poolSmallBufferCacheBytes = 8 << 10;
+  setupMemory(options);
+  auto manager = getMemoryManager();
+  auto root = manager->addRootPool();
+  auto leaf = root->addLeafChild("leaf", isLeafThreadSafe_);
+  auto* pool = static_cast<MemoryPoolImpl*>(leaf.get());
+
+  void* buffer = pool->allocate(4096);
+  pool->free(buffer, 4096);
+  ASSERT_EQ(pool->cachedBytes(), 4096);
+  ASSERT_EQ(pool->currentBytes(), 4096);
+
+  // A freed buffer of the same size is reused.
+  ASSERT_EQ(pool->allocate(4096), buffer);
+  ASSERT_EQ(pool->numCacheHits(), 1);
+  ASSERT_EQ(pool->cachedBytes(), 0);
+  ASSERT_EQ(pool->currentBytes(), 4096);
+
+  // Sizes that preferredSize() does not return are not cached.
+  void* odd = pool->allocate(4096 + 64);
+  pool->free(odd, 4096 + 64);
+  ASSERT_EQ(pool->cachedBytes(), 0);
+  ASSERT_EQ(pool->currentBytes(), 4096);
+
+  // The cache does not grow beyond its capacity.
+  void* other = pool->allocate(6144);
+  void* large = pool->allocate(64 << 10);
+  pool->free(buffer, 4096);
+  pool->free(other, 6144);
+  pool->free(large, 64 << 10);
+  ASSERT_EQ(pool->cachedBytes(), 4096);
+  ASSERT_EQ(pool->currentBytes(), 4096);
+
+  ASSERT_EQ(pool->freeCachedBuffers(), 4096);
+  ASSERT_EQ(pool->cachedBytes(), 0);
+  ASSERT_EQ(pool->currentBytes(), 0);
+
+  // Buffers still cached on destruction go back to the allocator.
+  pool->free(pool->allocate(1024), 1024);
+  ASSERT_EQ(pool->cachedBytes(), 1024);
+  leaf.reset();
+  ASSERT_EQ(root->currentBytes(), 0);
+}
+
+TEST_P(MemoryPoolTest, memoryTimeline) {
+  auto manager = getMemoryManager();
+  auto root = manager->addRootPool();
+  auto leaf = root->addLeafChild("leaf", isLeafThreadSafe_);
+  ASSERT_TRUE(leaf->memoryTimeline().empty());
+
+  constexpr int64_t kSize = 1 << 20;
+  void* buffer = leaf->allocate(kSize);
+  auto timeline = leaf->memoryTimeline();
+  ASSERT_EQ(timeline.size(), 1);
+  ASSERT_EQ(timeline[0].reservedBytes, kSize);
+  ASSERT_EQ(timeline[0].usedBytes, 0);
+  leaf->free(buffer, kSize);
+  timeline = leaf->memoryTimeline();
+  ASSERT_EQ(timeline.size(), 2);
+  ASSERT_EQ(timeline[1].reservedBytes, 0);
+  ASSERT_GE(timeline[1].timeMs, timeline[0].timeMs);
+  const auto first = timeline[0];
+
+  // No change of reservation, no sample.
+  buffer = leaf->allocate(kSize / 2);
+  ASSERT_EQ(leaf->memoryTimeline().size(), 3);
+  leaf->free(leaf->allocate(1024), 1024);
+  ASSERT_EQ(leaf->memoryTimeline().size(), 3);
+  leaf->free(buffer, kSize / 2);
+
+  // The timeline is thinned out when full and keeps its first sample.
+  for (auto i = 0; i < 10 * MemoryPool::kMaxTimelineSamples; ++i) {
+    leaf->free(leaf->allocate(kSize), kSize);
+  }
+  timeline = leaf->memoryTimeline();
+  ASSERT_LE(timeline.size(), MemoryPool::kMaxTimelineSamples);
+  ASSERT_GT(timeline.size(), MemoryPool::kMaxTimelineSamples / 2);
+  ASSERT_EQ(timeline[0], first);
+  for (auto i = 1; i < timeline.size(); ++i) {
+    ASSERT_GE(timeline[i].timeMs, timeline[i - 1].timeMs);
+  }
+
+  // Non-leaf pools have no timeline.
+  ASSERT_TRUE(root->memoryTimeline().empty());
+}
+
 TEST_P(MemoryPoolTest, DISABLED_memoryLeakCheck) {
   gflags::FlagSaver flagSaver;
   testing::FLAGS_gtest_death_test_style = "fast";
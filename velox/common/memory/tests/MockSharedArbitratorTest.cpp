@@ -398,7 +398,8 @@ class MockSharedArbitrationTest : public testing::Test {
   void setupMemory(
       int64_t memoryCapacity = 0,
       uint64_t memoryPoolInitCapacity = kMaxMemory,
-      uint64_t memoryPoolTransferCapacity = 0) {
+      uint64_t memoryPoolTransferCapacity = 0,
+      std::unordered_map<std::string, uint64_t> tenantCapacities = {}) {
     if (memoryPoolInitCapacity == kMaxMemory) {
       memoryPoolInitCapacity = kMemoryPoolInitCapacity;
     }
@@ -416,6 +417,7 @@ class MockSharedArbitrationTest : public testing::Test {
     options.memoryPoolInitCapacity = memoryPoolInitCapacity;
     options.memoryPoolTransferCapacity = memoryPoolTransferCapacity;
     options.checkUsageLeak = true;
+    options.arbitratorTenantCapacities = std::move(tenantCapacities);
     manager_ = std::make_unique<MemoryManager>(options);
     ASSERT_EQ(manager_->arbitrator()->kind(), arbitratorKind);
     arbitrator_ = static_cast<SharedArbitrator*>(manager_->arbitrator());
@@ -929,6 +931,70 @@ TEST_F(MockSharedArbitrationTest, arbitrateWithMemoryReclaim) {
   }
 }
 
+TEST_F(MockSharedArbitrationTest, arbitrateByPriority) {
+  const uint64_t memoryCapacity = 256 * MB;
+  setupMemory(memoryCapacity, 8 * MB);
+  auto highTask = addTask();
+  highTask->pool()->setArbitrationPriority(1);
+  auto* highOp = addMemoryOp(highTask, true);
+  auto lowTask = addTask();
+  auto* lowOp = addMemoryOp(lowTask, true);
+  const int allocateSize = 8 * MB;
+  while (highOp->pool()->currentBytes() < memoryCapacity / 2 + 32 * MB) {
+    highOp->allocate(allocateSize);
+  }
+  while (lowOp->pool()->currentBytes() < memoryCapacity / 2 - 32 * MB) {
+    lowOp->allocate(allocateSize);
+  }
+
+  // The low priority task is reclaimed although the high priority one has
+  // more reclaimable memory.
+  auto* arbitrateOp = addMemoryOp();
+  arbitrateOp->allocate(allocateSize);
+  ASSERT_EQ(highOp->reclaimer()->stats().numReclaims, 0);
+  ASSERT_EQ(lowOp->reclaimer()->stats().numReclaims, 1);
+  ASSERT_EQ(arbitrator_->numVictimsByPriorityOrAge(), 1);
+  const auto decisions = arbitrator_->decisionLog();
+  ASSERT_EQ(decisions.size(), 1);
+  ASSERT_NE(decisions[0].find(lowTask->pool()->name()), std::string::npos);
+  clearTasks();
+}
+
+TEST_F(MockSharedArbitrationTest, arbitrateWithTenantCapacity) {
+  const uint64_t memoryCapacity = 256 * MB;
+  const uint64_t tenantCapacity = 64 * MB;
+  setupMemory(memoryCapacity, 0, 0, {{"tenant", tenantCapacity}});
+  auto firstTask = addTask();
+  firstTask->pool()->setArbitrationTenant("tenant");
+  auto* firstOp = addMemoryOp(firstTask, true);
+  const int allocateSize = 8 * MB;
+  while (firstOp->pool()->currentBytes() < tenantCapacity) {
+    firstOp->allocate(allocateSize);
+  }
+  ASSERT_EQ(firstTask->capacity(), tenantCapacity);
+  ASSERT_EQ(arbitrator_->numTenantLimitedRequests(), 0);
+
+  // The tenant is at its limit, so the second task of the tenant takes memory
+  // from the first one instead of the free capacity of the arbitrator.
+  auto secondTask = addTask();
+  secondTask->pool()->setArbitrationTenant("tenant");
+  auto* secondOp = addMemoryOp(secondTask, true);
+  secondOp->allocate(allocateSize);
+  ASSERT_EQ(arbitrator_->numTenantLimitedRequests(), 1);
+  ASSERT_EQ(firstOp->reclaimer()->stats().numReclaims, 1);
+  ASSERT_LE(firstTask->capacity() + secondTask->capacity(), tenantCapacity);
+  ASSERT_GE(
+      arbitrator_->stats().freeCapacityBytes, memoryCapacity - tenantCapacity);
+
+  // A task without tenant is not limited.
+  auto* otherOp = addMemoryOp();
+  while (otherOp->pool()->currentBytes() < 2 * tenantCapacity) {
+    otherOp->allocate(allocateSize);
+  }
+  ASSERT_EQ(arbitrator_->numTenantLimitedRequests(), 1);
+  clearTasks();
+}
+
 TEST_F(MockSharedArbitrationTest, arbitrateBySelfMemoryReclaim) {
   const std::vector<bool> isLeafReclaimables = {true, false};
   for (const auto isLeafReclaimable : isLeafReclaimables) {
@@ -32,6 +32,8 @@ DECLARE_bool(avx2); // Enables use of AVX2 when available NOLINT
 
 DECLARE_bool(bmi2); // Enables use of BMI2 when available NOLINT
 
+DECLARE_bool(avx512); // Enables the AVX-512 kernels when available NOLINT
+
 namespace facebook {
 namespace velox {
 namespace process {
@@ -106,6 +108,8 @@ uint64_t threadCpuNanos() {
 namespace {
 bool bmi2CpuFlag = folly::CpuId().bmi2();
 bool avx2CpuFlag = folly::CpuId().avx2();
+bool avx512CpuFlag = folly::CpuId().avx512f() && folly::CpuId().avx512bw() &&
+    folly::CpuId().avx512vl();
 } // namespace
 
 bool hasAvx2() {
@@ -124,6 +128,14 @@ bool hasBmi2() {
 #endif
 }
 
+bool hasAvx512() {
+#ifdef __x86_64__
+  return avx512CpuFlag && FLAGS_avx512;
+#else
+  return false;
+#endif
+}
+
 } // namespace process
 } // namespace velox
 } // namespace facebook
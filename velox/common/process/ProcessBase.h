@@ -63,6 +63,12 @@ bool hasAvx2();
 // flag.
 bool hasBmi2();
 
+// True if the machine has Intel AVX-512 F, BW and VL instructions and these
+// are not disabled by flag. Unlike hasAvx2(), this does not depend on the
+// instructions the binary is compiled for. The AVX-512 kernels are compiled
+// with target attributes and chosen at run time.
+bool hasAvx512();
+
 } // namespace process
 } // namespace velox
 } // namespace facebook
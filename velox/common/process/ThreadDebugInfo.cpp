@@ -16,9 +16,12 @@
 
 #include "velox/common/process/ThreadDebugInfo.h"
 
+#include <folly/Synchronized.h>
 #include <folly/experimental/symbolizer/SignalHandler.h>
 #include <glog/logging.h>
 
+#include <unordered_set>
+
 namespace facebook::velox::process {
 thread_local const ThreadDebugInfo* threadDebugInfo = nullptr;
 
@@ -53,6 +56,34 @@ ScopedThreadDebugInfo::~ScopedThreadDebugInfo() {
   threadDebugInfo = prevThreadDebugInfo_;
 }
 
+const char* internProfileName(const std::string& name) {
+  // Leaked so that the names stay valid during static destruction.
+  static auto* names =
+      new folly::Synchronized<std::unordered_set<std::string>>();
+  auto locked = names->wlock();
+  return locked->insert(name).first->c_str();
+}
+
+ScopedProfileFrame::ScopedProfileFrame(
+    const char*& name,
+    const std::string& fullName) {
+  if (threadDebugInfo == nullptr ||
+      threadDebugInfo->profileFrames_ == nullptr) {
+    return;
+  }
+  if (name == nullptr) {
+    name = internProfileName(fullName);
+  }
+  frames_ = threadDebugInfo->profileFrames_;
+  frames_->push(name);
+}
+
+ScopedProfileFrame::~ScopedProfileFrame() {
+  if (frames_ != nullptr) {
+    frames_->pop();
+  }
+}
+
 void addDefaultFatalSignalHandler() {
   static bool initialized = false;
   if (!initialized) {
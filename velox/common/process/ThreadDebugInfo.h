@@ -16,15 +16,78 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <string>
+#include <vector>
 
 namespace facebook::velox::process {
 
+// Stack of names of what a thread is running, e.g. the expressions being
+// evaluated. Written by the thread itself and read by a sampling profiler on
+// another thread without locking. A read racing with a push or pop may see
+// the frame being pushed or popped, which is acceptable for sampling.
+struct ProfileFrames {
+  static constexpr int32_t kMaxDepth = 16;
+
+  // 'name' must stay valid for the life of the process, see
+  // internProfileName().
+  void push(const char* name) {
+    const auto depth = depth_.load(std::memory_order_relaxed);
+    if (depth < kMaxDepth) {
+      names_[depth].store(name, std::memory_order_relaxed);
+    }
+    depth_.store(depth + 1, std::memory_order_release);
+  }
+
+  void pop() {
+    depth_.store(
+        depth_.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+  }
+
+  // Returns the names from outermost to innermost. Frames deeper than
+  // kMaxDepth are left out.
+  std::vector<const char*> read() const {
+    const auto depth =
+        std::min(depth_.load(std::memory_order_acquire), kMaxDepth);
+    std::vector<const char*> names;
+    names.reserve(depth);
+    for (auto i = 0; i < depth; ++i) {
+      names.push_back(names_[i].load(std::memory_order_relaxed));
+    }
+    return names;
+  }
+
+ private:
+  std::atomic<int32_t> depth_{0};
+  std::array<std::atomic<const char*>, kMaxDepth> names_{};
+};
+
+// Returns a copy of 'name' that lives for the life of the process. Equal
+// names return the same pointer.
+const char* internProfileName(const std::string& name);
+
 // Used to store thread local information which can be retrieved by a signal
 // handler and logged.
 struct ThreadDebugInfo {
   std::string queryId_;
   std::string taskId_;
+  // Set if the thread is being profiled. Names pushed here are attributed to
+  // the samples taken while they are on the stack.
+  ProfileFrames* profileFrames_{nullptr};
+};
+
+// A RAII class that pushes a frame to the ProfileFrames of the current
+// thread's ThreadDebugInfo, if any. 'name' caches the interned copy of
+// 'fullName' so that it is interned once per caller.
+class ScopedProfileFrame {
+ public:
+  ScopedProfileFrame(const char*& name, const std::string& fullName);
+  ~ScopedProfileFrame();
+
+ private:
+  ProfileFrames* frames_{nullptr};
 };
 
 // A RAII class to store thread local debug information.
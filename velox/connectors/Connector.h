@@ -33,6 +33,10 @@ namespace facebook::velox {
 class Config;
 }
 
+namespace facebook::velox::exec {
+struct SpillConfig;
+}
+
 namespace facebook::velox::connector {
 
 class DataSource;
@@ -44,6 +48,9 @@ struct ConnectorSplit {
 
   std::unique_ptr<AsyncSource<DataSource>> dataSource;
 
+  // True if Connector::prefetchMetadata() has been scheduled for 'this'.
+  bool metadataPrefetched{false};
+
   explicit ConnectorSplit(const std::string& _connectorId)
       : connectorId(_connectorId) {}
 
@@ -148,6 +155,18 @@ class DataSink {
   virtual std::vector<std::string> finish() const = 0;
 
   virtual void close() = 0;
+
+  /// Returns true if the data sink can release memory from the connector
+  /// memory pool on reclaim().
+  virtual bool canReclaim() const {
+    return false;
+  }
+
+  /// Invoked by the memory arbitrator, through the table writer, to release
+  /// at least 'targetBytes' of memory, e.g. by flushing or closing some of the
+  /// open file writers. If 'targetBytes' is zero, releases as much as possible.
+  /// It is only called between appendData() calls and before finish().
+  virtual void reclaim(uint64_t /*targetBytes*/) {}
 };
 
 class DataSource {
@@ -211,6 +230,25 @@ class DataSource {
   virtual int64_t estimatedRowSize() {
     return kUnknownRowSize;
   }
+
+  // Makes the next addSplit() divide the split into up to 'maxParts'
+  // parts that can be read independently, e.g. ranges of stripes of a
+  // file. 'this' then reads the first part and the others are returned
+  // by takeSplitParts(). 1 disables this. The default does not divide
+  // splits.
+  virtual void setMaxSplitParts(int32_t /*maxParts*/) {}
+
+  // Tells 'this' that at most 'numRows' more output rows are needed, e.g.
+  // by a LIMIT over the scan. next() may then read fewer rows, e.g. stop in
+  // the middle of a stripe. The default ignores this.
+  virtual void setRemainingLimit(uint64_t /*numRows*/) {}
+
+  // Returns the parts of the last added split that 'this' does not
+  // read. These are to be given to other drivers. Empty if the split
+  // was not divided.
+  virtual std::vector<std::shared_ptr<ConnectorSplit>> takeSplitParts() {
+    return {};
+  }
 };
 
 /// Collection of context data for use in a DataSource or DataSink. One instance
@@ -228,7 +266,8 @@ class ConnectorQueryCtx {
       const std::string& queryId,
       const std::string& taskId,
       const std::string& planNodeId,
-      int driverId)
+      int driverId,
+      const exec::SpillConfig* spillConfig = nullptr)
       : operatorPool_(operatorPool),
         connectorPool_(connectorPool),
         config_(connectorConfig),
@@ -238,7 +277,8 @@ class ConnectorQueryCtx {
         queryId_(queryId),
         taskId_(taskId),
         driverId_(driverId),
-        planNodeId_(planNodeId) {}
+        planNodeId_(planNodeId),
+        spillConfig_(spillConfig) {}
 
   /// Returns the associated operator's memory pool which is a leaf kind of
   /// memory pool, used for direct memory allocation use.
@@ -289,6 +329,13 @@ class ConnectorQueryCtx {
     return planNodeId_;
   }
 
+  /// Returns the disk spilling config of the associated operator, or null if
+  /// spilling is disabled. A data sink can use it to spill the data it buffers
+  /// before writing, e.g. to sort a bucket.
+  const exec::SpillConfig* spillConfig() const {
+    return spillConfig_;
+  }
+
  private:
   memory::MemoryPool* operatorPool_;
   memory::MemoryPool* connectorPool_;
@@ -300,6 +347,7 @@ class ConnectorQueryCtx {
   const std::string taskId_;
   const int driverId_;
   const std::string planNodeId_;
+  const exec::SpillConfig* const spillConfig_;
 };
 
 class Connector {
@@ -341,6 +389,20 @@ class Connector {
     return false;
   }
 
+  // Returns true if prefetchMetadata() does something. If so, TableScan
+  // prefetches the metadata of the splits queued behind the preloaded ones.
+  virtual bool supportsMetadataPrefetch() {
+    return false;
+  }
+
+  // Fetches the metadata a DataSource needs before reading 'split', e.g.
+  // opens its file and gets its size, and keeps it where addSplit() finds
+  // it. Runs on executor(). Calls for different splits run in parallel, so
+  // that the round trips to storage for many small files overlap. Errors are
+  // not reported here but by the addSplit() that reads 'split'.
+  virtual void prefetchMetadata(
+      const std::shared_ptr<ConnectorSplit>& /*split*/) {}
+
   virtual std::unique_ptr<DataSink> createDataSink(
       RowTypePtr inputType,
       std::shared_ptr<ConnectorInsertTableHandle> connectorInsertTableHandle,
@@ -350,10 +412,12 @@ class Connector {
   // Returns a ScanTracker for 'id'. 'id' uniquely identifies the
   // tracker and different threads will share the same
   // instance. 'loadQuantum' is the largest single IO for the query
-  // being tracked.
+  // being tracked. If 'history' is given, the tracker adds its accesses
+  // to it.
   static std::shared_ptr<cache::ScanTracker> getTracker(
       const std::string& scanId,
-      int32_t loadQuantum);
+      int32_t loadQuantum,
+      cache::TrackingHistory* history = nullptr);
 
   virtual folly::Executor* FOLLY_NULLABLE executor() const {
     return nullptr;
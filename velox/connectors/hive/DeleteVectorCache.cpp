@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/connectors/hive/DeleteVectorCache.h"
+
+#include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/common/ReaderFactory.h"
+
+namespace facebook::velox::connector::hive {
+namespace {
+
+// The columns of a positional delete file.
+constexpr const char* kDeleteFilePath = "file_path";
+constexpr const char* kDeletePosition = "pos";
+
+void addPositionalDeletes(
+    const std::string& dataFilePath,
+    const HiveDeleteFile& deleteFile,
+    FileHandleFactory& fileHandleFactory,
+    memory::MemoryPool& pool,
+    dwio::common::DeleteVector& deletes) {
+  auto fileHandle = fileHandleFactory.generate(deleteFile.filePath).second;
+  dwio::common::ReaderOptions readerOpts(&pool);
+  readerOpts.setFileFormat(deleteFile.fileFormat);
+  auto reader = dwio::common::getReaderFactory(deleteFile.fileFormat)
+                    ->createReader(
+                        std::make_unique<dwio::common::BufferedInput>(
+                            fileHandle->file, pool),
+                        readerOpts);
+  const auto& fileType = reader->rowType();
+  VELOX_USER_CHECK(
+      fileType->containsChild(kDeleteFilePath) &&
+          fileType->containsChild(kDeletePosition),
+      "Positional delete file {} must have the columns {} and {}",
+      deleteFile.filePath,
+      kDeleteFilePath,
+      kDeletePosition);
+
+  // The rows of other data files are filtered out by the reader, which skips
+  // the row groups of other files since delete files are sorted by file.
+  auto spec = std::make_shared<common::ScanSpec>("<root>");
+  auto* pathSpec = spec->addField(kDeleteFilePath, 0);
+  pathSpec->setProjectOut(false);
+  pathSpec->setFilter(std::make_unique<common::BytesValues>(
+      std::vector<std::string>{dataFilePath}, false));
+  spec->addField(kDeletePosition, 0);
+  dwio::common::RowReaderOptions rowReaderOpts;
+  rowReaderOpts.setScanSpec(spec);
+  rowReaderOpts.select(std::make_shared<dwio::common::ColumnSelector>(
+      fileType,
+      std::vector<std::string>{kDeleteFilePath, kDeletePosition}));
+  auto rowReader = reader->createRowReader(rowReaderOpts);
+
+  VectorPtr batch =
+      BaseVector::create(ROW({kDeletePosition}, {BIGINT()}), 0, &pool);
+  while (rowReader->next(10'000, batch) > 0) {
+    auto* positions = batch->as<RowVector>()->childAt(0).get();
+    DecodedVector decoded(*positions);
+    for (auto i = 0; i < batch->size(); ++i) {
+      VELOX_USER_CHECK(
+          !decoded.isNullAt(i),
+          "Null position in positional delete file {}",
+          deleteFile.filePath);
+      const auto position = decoded.valueAt<int64_t>(i);
+      VELOX_USER_CHECK_GE(
+          position,
+          0,
+          "Negative position in positional delete file {}",
+          deleteFile.filePath);
+      deletes.add(position);
+    }
+  }
+}
+
+} // namespace
+
+// static
+std::shared_ptr<const dwio::common::DeleteVector> DeleteVectorCache::load(
+    const HiveConnectorSplit& split,
+    FileHandleFactory& fileHandleFactory,
+    memory::MemoryPool& pool) {
+  auto deletes = std::make_shared<dwio::common::DeleteVector>();
+  for (const auto& deleteFile : split.deleteFiles) {
+    addPositionalDeletes(
+        split.filePath, deleteFile, fileHandleFactory, pool, *deletes);
+    // Keeps at most one file worth of row numbers uncompressed.
+    deletes->build();
+  }
+  return deletes;
+}
+
+std::shared_ptr<const dwio::common::DeleteVector> DeleteVectorCache::get(
+    const HiveConnectorSplit& split,
+    FileHandleFactory& fileHandleFactory,
+    memory::MemoryPool& pool) {
+  std::string key = split.filePath;
+  for (const auto& deleteFile : split.deleteFiles) {
+    key += "\n" + deleteFile.filePath;
+  }
+  std::promise<std::shared_ptr<const dwio::common::DeleteVector>> promise;
+  std::optional<Value> cached;
+  {
+    auto entries = entries_.wlock();
+    cached = entries->get(key);
+    if (!cached.has_value()) {
+      entries->set(key, promise.get_future().share());
+    }
+  }
+  if (cached.has_value()) {
+    // Waits if another scan is reading the same delete files.
+    return cached->get();
+  }
+  try {
+    auto deletes = load(split, fileHandleFactory, pool);
+    promise.set_value(deletes);
+    return deletes;
+  } catch (const std::exception&) {
+    promise.set_exception(std::current_exception());
+    entries_.wlock()->erase(key);
+    throw;
+  }
+}
+
+} // namespace facebook::velox::connector::hive
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <future>
+
+#include <folly/Synchronized.h>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/connectors/hive/FileHandle.h"
+#include "velox/connectors/hive/HiveConnectorSplit.h"
+#include "velox/dwio/common/DeleteVector.h"
+
+namespace facebook::velox::connector::hive {
+
+/// Keeps the deleted rows of recently read data files, loaded from their
+/// positional delete files. The delete files of a data file are read once for
+/// all splits and scans of the file, which then drop the deleted rows while
+/// reading instead of joining with the delete files. Entries are keyed on the
+/// paths of the data file and its delete files, which are expected not to
+/// change, as in the file handle cache.
+class DeleteVectorCache {
+ public:
+  explicit DeleteVectorCache(int32_t maxFiles) : entries_(maxFiles) {}
+
+  /// Returns the deleted rows of the file of 'split', reading the delete files
+  /// of 'split' if not cached. Concurrent calls for the same files wait for
+  /// the first one to read them.
+  std::shared_ptr<const dwio::common::DeleteVector> get(
+      const HiveConnectorSplit& split,
+      FileHandleFactory& fileHandleFactory,
+      memory::MemoryPool& pool);
+
+  /// Reads the rows of the delete files of 'split' that refer to the file of
+  /// 'split'.
+  static std::shared_ptr<const dwio::common::DeleteVector> load(
+      const HiveConnectorSplit& split,
+      FileHandleFactory& fileHandleFactory,
+      memory::MemoryPool& pool);
+
+  SimpleLRUCacheStats stats() {
+    return entries_.wlock()->getStats();
+  }
+
+ private:
+  using Value =
+      std::shared_future<std::shared_ptr<const dwio::common::DeleteVector>>;
+
+  folly::Synchronized<SimpleLRUCache<std::string, Value>> entries_;
+};
+
+} // namespace facebook::velox::connector::hive
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/connectors/hive/FileStatisticsCache.h"
+
+namespace facebook::velox::connector::hive {
+
+std::shared_ptr<const FileStatisticsCache::Entry> FileStatisticsCache::find(
+    const std::string& path) {
+  // SimpleLRUCache::get() updates the LRU order and the counters.
+  auto entry = entries_.wlock()->get(path);
+  return entry.has_value() ? entry.value() : nullptr;
+}
+
+void FileStatisticsCache::add(
+    const std::string& path,
+    const dwio::common::Reader& reader,
+    const common::ScanSpec& spec) {
+  auto entry = find(path);
+  const auto& rowType = reader.rowType();
+  const auto& fileTypeWithId = reader.typeWithId();
+  folly::F14FastMap<std::string, Column> columns;
+  for (const auto& child : spec.children()) {
+    const auto& name = child->fieldName();
+    if (!child->filter() || !rowType->containsChild(name) ||
+        (entry && entry->columns.count(name))) {
+      continue;
+    }
+    const auto& typeWithId = fileTypeWithId->childByName(name);
+    std::shared_ptr<dwio::common::ColumnStatistics> statistics =
+        reader.columnStatistics(typeWithId->id());
+    if (statistics) {
+      columns[name] = Column{typeWithId->type(), std::move(statistics)};
+    }
+  }
+  if (columns.empty()) {
+    return;
+  }
+  auto numRows = reader.numberOfRows();
+  if (!numRows.has_value()) {
+    return;
+  }
+  add(path, numRows.value(), std::move(columns));
+}
+
+void FileStatisticsCache::add(
+    const std::string& path,
+    uint64_t numRows,
+    folly::F14FastMap<std::string, Column> columns) {
+  auto entries = entries_.wlock();
+  auto existing = entries->get(path);
+  auto entry = std::make_shared<Entry>();
+  entry->numRows = numRows;
+  if (existing.has_value() && existing.value()->numRows == numRows) {
+    entry->columns = existing.value()->columns;
+  }
+  for (auto& [name, column] : columns) {
+    entry->columns[name] = std::move(column);
+  }
+  entries->set(path, std::move(entry));
+}
+
+bool FileStatisticsCache::mayMatch(
+    const std::string& path,
+    const common::ScanSpec& spec,
+    const std::unordered_map<std::string, std::optional<std::string>>&
+        partitionKeys) {
+  auto entry = find(path);
+  if (!entry) {
+    return true;
+  }
+  for (const auto& child : spec.children()) {
+    if (!child->filter() || partitionKeys.count(child->fieldName())) {
+      continue;
+    }
+    auto it = entry->columns.find(child->fieldName());
+    if (it == entry->columns.end()) {
+      continue;
+    }
+    if (!common::testFilter(
+            child->filter(),
+            it->second.statistics.get(),
+            entry->numRows,
+            it->second.type)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace facebook::velox::connector::hive
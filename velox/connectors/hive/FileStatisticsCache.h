@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/dwio/common/Reader.h"
+#include "velox/dwio/common/ScanSpec.h"
+#include "velox/dwio/common/Statistics.h"
+
+namespace facebook::velox::connector::hive {
+
+/// Keeps the file level statistics of the filtered columns of recently read
+/// files. A split of a file whose statistics show that no row can pass the
+/// filters is skipped without opening the file. The statistics of a column are
+/// added the first time a file is read with a filter on the column. Files are
+/// identified by path and are expected not to change, as in the file handle
+/// cache.
+class FileStatisticsCache {
+ public:
+  /// The statistics of one column of a file.
+  struct Column {
+    TypePtr type;
+    std::shared_ptr<dwio::common::ColumnStatistics> statistics;
+  };
+
+  /// The cached statistics of one file.
+  struct Entry {
+    uint64_t numRows;
+    folly::F14FastMap<std::string, Column> columns;
+  };
+
+  explicit FileStatisticsCache(int32_t maxFiles) : entries_(maxFiles) {}
+
+  /// Adds the statistics of the top level columns of 'reader' that have
+  /// filters in 'spec' to the entry of 'path'. Does not read the file if the
+  /// columns are already cached.
+  void add(
+      const std::string& path,
+      const dwio::common::Reader& reader,
+      const common::ScanSpec& spec);
+
+  /// Adds 'columns' to the entry of 'path' for a file of 'numRows' rows.
+  void add(
+      const std::string& path,
+      uint64_t numRows,
+      folly::F14FastMap<std::string, Column> columns);
+
+  /// Returns false if the cached statistics of 'path' show that no row of the
+  /// file passes the filters in 'spec'. Columns in 'partitionKeys' and columns
+  /// with no cached statistics are not checked.
+  bool mayMatch(
+      const std::string& path,
+      const common::ScanSpec& spec,
+      const std::unordered_map<std::string, std::optional<std::string>>&
+          partitionKeys);
+
+  SimpleLRUCacheStats stats() {
+    return entries_.wlock()->getStats();
+  }
+
+ private:
+  std::shared_ptr<const Entry> find(const std::string& path);
+
+  // The entries are immutable and replaced when columns are added so that
+  // mayMatch() can test them without holding the lock.
+  folly::Synchronized<SimpleLRUCache<std::string, std::shared_ptr<const Entry>>>
+      entries_;
+};
+
+} // namespace facebook::velox::connector::hive
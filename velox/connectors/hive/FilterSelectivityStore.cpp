@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/connectors/hive/FilterSelectivityStore.h"
+
+namespace facebook::velox::connector::hive {
+
+// static
+std::string FilterSelectivityStore::filterKey(const common::ScanSpec& column) {
+  if (!column.filter() || column.isConstant()) {
+    return "";
+  }
+  return fmt::format("{}:{}", column.fieldName(), column.filter()->toString());
+}
+
+void FilterSelectivityStore::initialize(
+    const std::string& tableName,
+    common::ScanSpec& spec,
+    Baseline& baseline) const {
+  baseline.clear();
+  auto history = history_.rlock();
+  auto it = history->find(tableName);
+  for (auto& child : spec.children()) {
+    auto key = filterKey(*child);
+    if (key.empty()) {
+      continue;
+    }
+    if (it != history->end()) {
+      auto filterIt = it->second.find(key);
+      if (filterIt != it->second.end()) {
+        child->selectivity() = filterIt->second;
+      }
+    }
+    baseline[child->fieldName()] =
+        std::make_pair(std::move(key), child->selectivity());
+  }
+}
+
+void FilterSelectivityStore::update(
+    const std::string& tableName,
+    const common::ScanSpec& spec,
+    Baseline& baseline) {
+  std::vector<std::pair<std::string, velox::SelectivityInfo>> deltas;
+  for (auto& child : spec.children()) {
+    auto key = filterKey(*child);
+    if (key.empty()) {
+      continue;
+    }
+    auto it = baseline.find(child->fieldName());
+    if (it != baseline.end() && it->second.first == key) {
+      auto delta = child->selectivity().since(it->second.second);
+      if (delta.numIn() > 0) {
+        deltas.emplace_back(key, delta);
+      }
+    }
+    // A filter that changed, e.g. by a dynamic filter, is measured from now
+    // on.
+    baseline[child->fieldName()] =
+        std::make_pair(std::move(key), child->selectivity());
+  }
+  if (deltas.empty()) {
+    return;
+  }
+  auto history = history_.wlock();
+  auto& tableHistory = (*history)[tableName];
+  for (auto& [key, delta] : deltas) {
+    auto& info = tableHistory[key];
+    info.merge(delta);
+    if (info.numIn() > kMaxHistoryRows) {
+      info.halve();
+    }
+  }
+}
+
+std::optional<velox::SelectivityInfo> FilterSelectivityStore::find(
+    const std::string& tableName,
+    const common::ScanSpec& column) const {
+  auto key = filterKey(column);
+  auto history = history_.rlock();
+  auto it = history->find(tableName);
+  if (key.empty() || it == history->end()) {
+    return std::nullopt;
+  }
+  auto filterIt = it->second.find(key);
+  if (filterIt == it->second.end()) {
+    return std::nullopt;
+  }
+  return filterIt->second;
+}
+
+} // namespace facebook::velox::connector::hive
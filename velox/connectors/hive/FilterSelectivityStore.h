@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+
+#include "velox/common/base/SelectivityInfo.h"
+#include "velox/dwio/common/ScanSpec.h"
+
+namespace facebook::velox::connector::hive {
+
+/// Keeps the measured cost and selectivity of the filters pushed into the
+/// scans of each table. A new scan of a table starts with the filter order
+/// found by the earlier scans instead of learning it again on each driver.
+/// A filter is identified by its column and its toString(), so that the
+/// same filter with different constants is measured separately.
+class FilterSelectivityStore {
+ public:
+  /// The filter and the selectivity of each filtered column of a scan as
+  /// last seen by initialize() or update(), keyed on field name.
+  using Baseline = folly::F14FastMap<
+      std::string,
+      std::pair<std::string, velox::SelectivityInfo>>;
+
+  /// Sets the selectivity of the filtered children of 'spec' from the history
+  /// of 'tableName' and records the set values in 'baseline'.
+  void initialize(
+      const std::string& tableName,
+      common::ScanSpec& spec,
+      Baseline& baseline) const;
+
+  /// Adds the measurements made on the filtered children of 'spec' since
+  /// 'baseline' to the history of 'tableName' and updates 'baseline'.
+  void update(
+      const std::string& tableName,
+      const common::ScanSpec& spec,
+      Baseline& baseline);
+
+  /// Returns the history of the filter of 'column' on 'tableName' or nullopt
+  /// if it has not been measured.
+  std::optional<velox::SelectivityInfo> find(
+      const std::string& tableName,
+      const common::ScanSpec& column) const;
+
+ private:
+  // Rows after which the history of a filter is halved so that it follows
+  // changes of the data.
+  static constexpr uint64_t kMaxHistoryRows = 1UL << 28;
+
+  // Returns the key of the filter of 'column' or an empty string if 'column'
+  // has no filter that is measured.
+  static std::string filterKey(const common::ScanSpec& column);
+
+  folly::Synchronized<folly::F14FastMap<
+      std::string,
+      folly::F14FastMap<std::string, velox::SelectivityInfo>>>
+      history_;
+};
+
+} // namespace facebook::velox::connector::hive
@@ -125,6 +125,41 @@ std::string HiveConfig::s3IAMRoleSessionName(const Config* config) {
   return config->get(kS3IamRoleSessionName, std::string("velox-session"));
 }
 
+// static
+int32_t HiveConfig::s3MaxConcurrentReads(const Config* config) {
+  return config->get<int32_t>(kS3MaxConcurrentReads, 32);
+}
+
+// static
+uint64_t HiveConfig::s3ReadPartSize(const Config* config) {
+  return config->get<uint64_t>(kS3ReadPartSize, 8UL << 20);
+}
+
+// static
+uint64_t HiveConfig::s3WritePartSize(const Config* config) {
+  return config->get<uint64_t>(kS3WritePartSize, 16UL << 20);
+}
+
+// static
+int32_t HiveConfig::s3MaxWritePartsInFlight(const Config* config) {
+  return config->get<int32_t>(kS3MaxWritePartsInFlight, 4);
+}
+
+// static
+int32_t HiveConfig::hdfsReadThreads(const Config* config) {
+  return config->get<int32_t>(kHdfsReadThreads, 0);
+}
+
+// static
+bool HiveConfig::hdfsHedgedReadsEnabled(const Config* config) {
+  return config->get<bool>(kHdfsHedgedReadsEnabled, false);
+}
+
+// static
+int32_t HiveConfig::hdfsMinHedgeDelayMs(const Config* config) {
+  return config->get<int32_t>(kHdfsMinHedgeDelayMs, 50);
+}
+
 // static
 std::string HiveConfig::gcsEndpoint(const Config* config) {
   return config->get<std::string>(kGCSEndpoint, std::string(""));
@@ -160,4 +195,49 @@ int32_t HiveConfig::numCacheFileHandles(const Config* config) {
   return config->get<int32_t>(kNumCacheFileHandles, 20'000);
 }
 
+// static.
+bool HiveConfig::filterSelectivityHistoryEnabled(const Config* config) {
+  return config->get<bool>(kFilterSelectivityHistoryEnabled, true);
+}
+
+// static.
+int32_t HiveConfig::numCachedFileStatistics(const Config* config) {
+  return config->get<int32_t>(kNumCachedFileStatistics, 10'000);
+}
+
+// static
+int32_t HiveConfig::numCachedDeleteVectors(const Config* config) {
+  return config->get<int32_t>(kNumCachedDeleteVectors, 1'000);
+}
+
+// static
+uint32_t HiveConfig::sortWriterMaxOutputRows(const Config* config) {
+  return config->get<uint32_t>(kSortWriterMaxOutputRows, 1024);
+}
+
+// static
+bool HiveConfig::sharedScanEnabled(const Config* config) {
+  return config->get<bool>(kSharedScanEnabled, false);
+}
+
+// static
+std::string HiveConfig::ioTraceDirectory(const Config* config) {
+  return config->get<std::string>(kIoTraceDirectory, "");
+}
+
+// static
+int32_t HiveConfig::ioTraceMaxEntries(const Config* config) {
+  return config->get<int32_t>(kIoTraceMaxEntries, 100'000);
+}
+
+// static
+std::string HiveConfig::cachePartition(const Config* config) {
+  return config->get<std::string>(kCachePartition, "");
+}
+
+// static
+bool HiveConfig::readerExpressionFilterEnabled(const Config* config) {
+  return config->get<bool>(kReaderExpressionFilterEnabled, false);
+}
+
 } // namespace facebook::velox::connector::hive
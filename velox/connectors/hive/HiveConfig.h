@@ -80,6 +80,37 @@ class HiveConfig {
   static constexpr const char* kS3IamRoleSessionName =
       "hive.s3.iam-role-session-name";
 
+  /// Maximum number of GET requests in flight per S3 file system. Sizes the
+  /// connection pool and the threads that run the async requests.
+  static constexpr const char* kS3MaxConcurrentReads =
+      "hive.s3.max-concurrent-reads";
+
+  /// Reads larger than this are split into ranged GETs of this size that run
+  /// in parallel.
+  static constexpr const char* kS3ReadPartSize = "hive.s3.read-part-size";
+
+  /// Size of the parts of a multipart upload written by an S3 WriteFile. S3
+  /// requires at least 5MB for all but the last part.
+  static constexpr const char* kS3WritePartSize = "hive.s3.write-part-size";
+
+  /// Maximum number of parts an S3 WriteFile has buffered for upload. An
+  /// append that fills a part waits while this many are being uploaded.
+  static constexpr const char* kS3MaxWritePartsInFlight =
+      "hive.s3.max-write-parts-in-flight";
+
+  /// Number of threads per HDFS file system that run async and hedged reads.
+  /// 0 means reads are synchronous on the calling thread.
+  static constexpr const char* kHdfsReadThreads = "hive.hdfs.read-threads";
+
+  /// Whether an HDFS read that takes longer than the p95 read latency of the
+  /// file starts a second read of the same range.
+  static constexpr const char* kHdfsHedgedReadsEnabled =
+      "hive.hdfs.hedged-reads-enabled";
+
+  /// Minimum time an HDFS read runs before it is hedged.
+  static constexpr const char* kHdfsMinHedgeDelayMs =
+      "hive.hdfs.min-hedge-delay-ms";
+
   // The GCS storage endpoint server.
   static constexpr const char* kGCSEndpoint = "hive.gcs.endpoint";
 
@@ -103,6 +134,49 @@ class HiveConfig {
   /// Maximum number of entries in the file handle cache.
   static constexpr const char* kNumCacheFileHandles = "num_cached_file_handles";
 
+  /// Whether scans start with the filter order measured by the earlier scans
+  /// of the same table and add their own measurements to it.
+  static constexpr const char* kFilterSelectivityHistoryEnabled =
+      "filter_selectivity_history_enabled";
+
+  /// Maximum number of files whose statistics are kept for skipping splits
+  /// without opening the file. 0 disables the cache.
+  static constexpr const char* kNumCachedFileStatistics =
+      "num_cached_file_statistics";
+
+  /// Maximum number of files whose deleted rows, read from the positional
+  /// delete files of their splits, are kept. 0 disables the cache.
+  static constexpr const char* kNumCachedDeleteVectors =
+      "num_cached_delete_vectors";
+
+  /// Whether scans share the reads of a split with the concurrent scans of
+  /// other queries that read the same columns. Needs the process wide
+  /// DecodedVectorCache.
+  static constexpr const char* kSharedScanEnabled = "shared_scan_enabled";
+
+  /// Directory to which each scan writes the reads it made, one file per
+  /// driver named <taskId>.<planNodeId>.<driverId>.iotrace. Empty disables
+  /// the trace.
+  static constexpr const char* kIoTraceDirectory = "io_trace_directory";
+
+  /// Maximum number of reads a scan keeps in its trace.
+  static constexpr const char* kIoTraceMaxEntries = "io_trace_max_entries";
+
+  /// Name of the AsyncDataCache partition that holds the data read by the
+  /// scans. Unknown names and the empty name select the default partition.
+  static constexpr const char* kCachePartition = "cache_partition";
+
+  /// Whether the leading conjuncts of the remaining filter that reference
+  /// columns are evaluated by the file reader after reading these columns and
+  /// before reading the others, which are then read only for passing rows.
+  static constexpr const char* kReaderExpressionFilterEnabled =
+      "reader_expression_filter_enabled";
+
+  /// Maximum number of rows per batch handed to the file writer when the rows
+  /// of a sorted bucketed table are written out in sort order.
+  static constexpr const char* kSortWriterMaxOutputRows =
+      "sort_writer_max_output_rows";
+
   static InsertExistingPartitionsBehavior insertExistingPartitionsBehavior(
       const Config* config);
 
@@ -128,6 +202,20 @@ class HiveConfig {
 
   static std::string s3IAMRoleSessionName(const Config* config);
 
+  static int32_t s3MaxConcurrentReads(const Config* config);
+
+  static uint64_t s3ReadPartSize(const Config* config);
+
+  static uint64_t s3WritePartSize(const Config* config);
+
+  static int32_t s3MaxWritePartsInFlight(const Config* config);
+
+  static int32_t hdfsReadThreads(const Config* config);
+
+  static bool hdfsHedgedReadsEnabled(const Config* config);
+
+  static int32_t hdfsMinHedgeDelayMs(const Config* config);
+
   static std::string gcsEndpoint(const Config* config);
 
   static std::string gcsScheme(const Config* config);
@@ -141,6 +229,24 @@ class HiveConfig {
   static int32_t maxCoalescedDistanceBytes(const Config* config);
 
   static int32_t numCacheFileHandles(const Config* config);
+
+  static bool filterSelectivityHistoryEnabled(const Config* config);
+
+  static int32_t numCachedFileStatistics(const Config* config);
+
+  static int32_t numCachedDeleteVectors(const Config* config);
+
+  static uint32_t sortWriterMaxOutputRows(const Config* config);
+
+  static bool sharedScanEnabled(const Config* config);
+
+  static std::string ioTraceDirectory(const Config* config);
+
+  static int32_t ioTraceMaxEntries(const Config* config);
+
+  static std::string cachePartition(const Config* config);
+
+  static bool readerExpressionFilterEnabled(const Config* config);
 };
 
 } // namespace facebook::velox::connector::hive
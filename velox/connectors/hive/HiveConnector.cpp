@@ -17,6 +17,7 @@
 #include "velox/connectors/hive/HiveConnector.h"
 
 #include "velox/common/base/Fs.h"
+#include "velox/common/caching/AsyncDataCache.h"
 #include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HiveDataSink.h"
 #include "velox/connectors/hive/HiveDataSource.h"
@@ -63,6 +64,20 @@ HiveConnector::HiveConnector(
               numCachedFileHandles(properties.get())),
           std::make_unique<FileHandleGenerator>(properties)),
       executor_(executor) {
+  auto numCachedFileStatistics = properties
+      ? HiveConfig::numCachedFileStatistics(properties.get())
+      : 10'000;
+  if (numCachedFileStatistics > 0) {
+    fileStatistics_ =
+        std::make_unique<FileStatisticsCache>(numCachedFileStatistics);
+  }
+  auto numCachedDeleteVectors = properties
+      ? HiveConfig::numCachedDeleteVectors(properties.get())
+      : 1'000;
+  if (numCachedDeleteVectors > 0) {
+    deleteVectors_ =
+        std::make_unique<DeleteVectorCache>(numCachedDeleteVectors);
+  }
   LOG(INFO) << "Hive connector " << connectorId() << " created with maximum of "
             << numCachedFileHandles(properties.get())
             << " cached file handles.";
@@ -83,6 +98,23 @@ std::unique_ptr<DataSource> HiveConnector::createDataSource(
   options.setFileColumnNamesReadAsLowerCase(
       HiveConfig::isFileColumnNamesReadAsLowerCase(
           connectorQueryCtx->config()));
+  const auto cachePartition =
+      HiveConfig::cachePartition(connectorQueryCtx->config());
+  if (!cachePartition.empty() && connectorQueryCtx->cache() != nullptr) {
+    options.setCachePartition(
+        connectorQueryCtx->cache()->partitionId(cachePartition));
+  }
+  std::string ioTracePath;
+  const auto ioTraceDirectory =
+      HiveConfig::ioTraceDirectory(connectorQueryCtx->config());
+  if (!ioTraceDirectory.empty()) {
+    ioTracePath = fmt::format(
+        "{}/{}.{}.{}.iotrace",
+        ioTraceDirectory,
+        connectorQueryCtx->taskId(),
+        connectorQueryCtx->planNodeId(),
+        connectorQueryCtx->driverId());
+  }
   return std::make_unique<HiveDataSource>(
       outputType,
       tableHandle,
@@ -92,7 +124,32 @@ std::unique_ptr<DataSource> HiveConnector::createDataSource(
       connectorQueryCtx->cache(),
       connectorQueryCtx->scanId(),
       executor_,
-      options);
+      options,
+      HiveConfig::filterSelectivityHistoryEnabled(connectorQueryCtx->config())
+          ? &filterSelectivity_
+          : nullptr,
+      fileStatistics_.get(),
+      HiveConfig::sharedScanEnabled(connectorQueryCtx->config()),
+      connectorQueryCtx->queryId(),
+      ioTracePath,
+      HiveConfig::ioTraceMaxEntries(connectorQueryCtx->config()),
+      HiveConfig::readerExpressionFilterEnabled(connectorQueryCtx->config()),
+      deleteVectors_.get());
+}
+
+void HiveConnector::prefetchMetadata(
+    const std::shared_ptr<ConnectorSplit>& split) {
+  auto hiveSplit = std::dynamic_pointer_cast<HiveConnectorSplit>(split);
+  if (!hiveSplit) {
+    return;
+  }
+  try {
+    fileHandleFactory_.generate(hiveSplit->filePath);
+  } catch (const std::exception& e) {
+    // The open is retried and the error reported when the split is read.
+    VLOG(1) << "Failed to prefetch file handle for " << hiveSplit->filePath
+            << ": " << e.what();
+  }
 }
 
 std::unique_ptr<DataSink> HiveConnector::createDataSink(
@@ -17,6 +17,9 @@
 
 #include "velox/connectors/Connector.h"
 #include "velox/connectors/hive/FileHandle.h"
+#include "velox/connectors/hive/DeleteVectorCache.h"
+#include "velox/connectors/hive/FileStatisticsCache.h"
+#include "velox/connectors/hive/FilterSelectivityStore.h"
 #include "velox/core/PlanNode.h"
 
 namespace facebook::velox::dwio::common {
@@ -49,6 +52,13 @@ class HiveConnector : public Connector {
     return true;
   }
 
+  bool supportsMetadataPrefetch() override {
+    return true;
+  }
+
+  /// Opens the file of 'split' into the file handle cache.
+  void prefetchMetadata(const std::shared_ptr<ConnectorSplit>& split) override;
+
   std::unique_ptr<DataSink> createDataSink(
       RowTypePtr inputType,
       std::shared_ptr<ConnectorInsertTableHandle> connectorInsertTableHandle,
@@ -72,6 +82,11 @@ class HiveConnector : public Connector {
  protected:
   FileHandleFactory fileHandleFactory_;
   folly::Executor* FOLLY_NULLABLE executor_;
+  FilterSelectivityStore filterSelectivity_;
+  // nullptr if num_cached_file_statistics is 0.
+  std::unique_ptr<FileStatisticsCache> fileStatistics_;
+  // nullptr if num_cached_delete_vectors is 0.
+  std::unique_ptr<DeleteVectorCache> deleteVectors_;
 };
 
 class HiveConnectorFactory : public ConnectorFactory {
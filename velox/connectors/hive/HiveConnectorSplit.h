@@ -22,6 +22,14 @@
 
 namespace facebook::velox::connector::hive {
 
+/// A file that lists deleted rows of the file of a split. Positional delete
+/// files have the columns file_path and pos, the path of a data file and a row
+/// number in it, as in Iceberg.
+struct HiveDeleteFile {
+  std::string filePath;
+  dwio::common::FileFormat fileFormat;
+};
+
 struct HiveConnectorSplit : public connector::ConnectorSplit {
   const std::string filePath;
   dwio::common::FileFormat fileFormat;
@@ -33,6 +41,11 @@ struct HiveConnectorSplit : public connector::ConnectorSplit {
   std::unordered_map<std::string, std::string> customSplitInfo;
   std::shared_ptr<std::string> extraFileInfo;
   std::unordered_map<std::string, std::string> serdeParameters;
+  // True if this is a part of a split divided by HiveDataSource. A part is
+  // not divided again.
+  bool isPart{false};
+  // Positional delete files whose rows for 'filePath' are not returned.
+  std::vector<HiveDeleteFile> deleteFiles;
 
   HiveConnectorSplit(
       const std::string& connectorId,
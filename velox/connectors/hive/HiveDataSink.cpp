@@ -19,6 +19,7 @@
 #include "velox/common/base/Fs.h"
 #include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HivePartitionFunction.h"
+#include "velox/connectors/hive/SortingWriter.h"
 #include "velox/core/ITypedExpr.h"
 #include "velox/dwio/dwrf/writer/Writer.h"
 
@@ -102,6 +103,40 @@ std::unique_ptr<core::PartitionFunction> createBucketFunction(
       bucketProperty.bucketCount(), bucketedByChannels);
 }
 
+// Returns the input channels of the sorting columns of a bucketed table.
+std::vector<column_index_t> getSortColumnIndices(
+    const HiveBucketProperty* bucketProperty,
+    const RowTypePtr& inputType) {
+  std::vector<column_index_t> sortColumnIndices;
+  if (bucketProperty == nullptr) {
+    return sortColumnIndices;
+  }
+  sortColumnIndices.reserve(bucketProperty->sortedBy().size());
+  for (const auto& sortColumn : bucketProperty->sortedBy()) {
+    sortColumnIndices.push_back(
+        inputType->getChildIdx(sortColumn->sortColumn()));
+  }
+  return sortColumnIndices;
+}
+
+std::vector<CompareFlags> getSortCompareFlags(
+    const HiveBucketProperty* bucketProperty) {
+  std::vector<CompareFlags> compareFlags;
+  if (bucketProperty == nullptr) {
+    return compareFlags;
+  }
+  compareFlags.reserve(bucketProperty->sortedBy().size());
+  for (const auto& sortColumn : bucketProperty->sortedBy()) {
+    const auto& sortOrder = sortColumn->sortOrder();
+    compareFlags.push_back(
+        {sortOrder.isNullsFirst(),
+         sortOrder.isAscending(),
+         false,
+         CompareFlags::NullHandlingMode::NoStop});
+  }
+  return compareFlags;
+}
+
 std::string computeBucketedFileName(
     const std::string& queryId,
     int32_t bucket) {
@@ -298,6 +333,11 @@ HiveDataSink::HiveDataSink(
                              *insertTableHandle_->bucketProperty(),
                              inputType_)
                        : nullptr),
+      sortColumnIndices_(getSortColumnIndices(
+          insertTableHandle_->bucketProperty(),
+          inputType_)),
+      sortCompareFlags_(
+          getSortCompareFlags(insertTableHandle_->bucketProperty())),
       writerFactory_(dwio::common::getWriterFactory(
           insertTableHandle_->tableStorageFormat())) {
   VELOX_USER_CHECK(
@@ -317,8 +357,7 @@ void HiveDataSink::appendData(RowVectorPtr input) {
   // Write to unpartitioned table.
   if (!isPartitioned()) {
     const auto index = ensureWriter(HiveWriterId::unpartitionedId());
-    writers_[index]->write(input);
-    writerInfo_[index]->numWrittenRows += input->size();
+    write(index, input);
     return;
   }
 
@@ -334,8 +373,7 @@ void HiveDataSink::appendData(RowVectorPtr input) {
   // be zero.
   if (!isBucketed() && partitionIdGenerator_->numPartitions() == 1) {
     const auto index = ensureWriter(HiveWriterId{0});
-    writers_[index]->write(input);
-    writerInfo_[index]->numWrittenRows += input->size();
+    write(index, input);
     return;
   }
 
@@ -350,9 +388,17 @@ void HiveDataSink::appendData(RowVectorPtr input) {
     RowVectorPtr writerInput = partitionSize == input->size()
         ? input
         : exec::wrap(partitionSize, partitionRows_[index], input);
-    writers_[index]->write(writerInput);
-    writerInfo_[index]->numWrittenRows += partitionSize;
+    write(index, writerInput);
+  }
+}
+
+void HiveDataSink::write(uint32_t index, const RowVectorPtr& input) {
+  if (writers_[index] == nullptr) {
+    reopenWriter(index);
   }
+  writers_[index]->write(input);
+  writerInfo_[index]->numWrittenRows += input->size();
+  lastWriteSequences_[index] = ++writeSequence_;
 }
 
 void HiveDataSink::computePartitionAndBucketIds(const RowVectorPtr& input) {
@@ -368,6 +414,11 @@ int64_t HiveDataSink::getCompletedBytes() const {
   for (const auto& ioStats : ioStats_) {
     completedBytes += ioStats->rawBytesWritten();
   }
+  for (const auto& info : writerInfo_) {
+    for (const auto& file : info->closedFiles) {
+      completedBytes += file.fileSize;
+    }
+  }
   return completedBytes;
 }
 
@@ -378,6 +429,24 @@ std::vector<std::string> HiveDataSink::finish() const {
   for (int i = 0; i < writerInfo_.size(); ++i) {
     const auto& info = writerInfo_.at(i);
     VELOX_CHECK_NOT_NULL(info);
+    auto fileWriteInfos = folly::dynamic::array();
+    uint64_t onDiskDataSizeInBytes{0};
+    for (const auto& file : info->closedFiles) {
+      // clang-format off
+      fileWriteInfos.push_back(folly::dynamic::object
+          ("writeFileName", file.writeFileName)
+          ("targetFileName", file.targetFileName)
+          ("fileSize", file.fileSize));
+      // clang-format on
+      onDiskDataSizeInBytes += file.fileSize;
+    }
+    // clang-format off
+    fileWriteInfos.push_back(folly::dynamic::object
+        ("writeFileName", info->writerParameters.writeFileName())
+        ("targetFileName", info->writerParameters.targetFileName())
+        ("fileSize", ioStats_.at(i)->rawBytesWritten()));
+    // clang-format on
+    onDiskDataSizeInBytes += ioStats_.at(i)->rawBytesWritten();
     // clang-format off
       auto partitionUpdateJson = folly::toJson(
        folly::dynamic::object
@@ -387,16 +456,12 @@ std::vector<std::string> HiveDataSink::finish() const {
               info->writerParameters.updateMode()))
           ("writePath", info->writerParameters.writeDirectory())
           ("targetPath", info->writerParameters.targetDirectory())
-          ("fileWriteInfos", folly::dynamic::array(
-            folly::dynamic::object
-              ("writeFileName", info->writerParameters.writeFileName())
-              ("targetFileName", info->writerParameters.targetFileName())
-              ("fileSize", ioStats_.at(i)->rawBytesWritten())))
+          ("fileWriteInfos", fileWriteInfos)
           ("rowCount", info->numWrittenRows)
          // TODO(gaoge): track and send the fields when inMemoryDataSizeInBytes
          // and containsNumberedFileNames are needed at coordinator when file_renaming_enabled are turned on.
           ("inMemoryDataSizeInBytes", 0)
-          ("onDiskDataSizeInBytes", ioStats_.at(i)->rawBytesWritten())
+          ("onDiskDataSizeInBytes", onDiskDataSizeInBytes)
           ("containsNumberedFileNames", true));
     // clang-format on
     partitionUpdates.push_back(partitionUpdateJson);
@@ -406,7 +471,49 @@ std::vector<std::string> HiveDataSink::finish() const {
 
 void HiveDataSink::close() {
   for (const auto& writer : writers_) {
-    writer->close();
+    // A null writer has been closed by reclaim().
+    if (writer != nullptr) {
+      writer->close();
+    }
+  }
+}
+
+void HiveDataSink::reclaim(uint64_t targetBytes) {
+  std::vector<uint32_t> openWriters;
+  openWriters.reserve(writers_.size());
+  for (uint32_t i = 0; i < writers_.size(); ++i) {
+    if (writers_[i] != nullptr) {
+      openWriters.push_back(i);
+    }
+  }
+  // The least recently written writers go first as they are the least likely
+  // to get more rows soon.
+  std::sort(
+      openWriters.begin(),
+      openWriters.end(),
+      [&](uint32_t lhs, uint32_t rhs) {
+        return lastWriteSequences_[lhs] < lastWriteSequences_[rhs];
+      });
+
+  uint64_t reclaimedBytes{0};
+  for (const auto index : openWriters) {
+    const int64_t usedBytes = writerPools_[index]->currentBytes();
+    if (isBucketed()) {
+      // A bucket has exactly one file, so its writer can only flush the
+      // buffered data.
+      writers_[index]->flush();
+    } else {
+      // Rows arriving later for the partition go to a new file.
+      writers_[index]->close();
+      writers_[index].reset();
+    }
+    const int64_t remainingBytes = writerPools_[index]->currentBytes();
+    if (remainingBytes < usedBytes) {
+      reclaimedBytes += usedBytes - remainingBytes;
+    }
+    if (targetBytes != 0 && reclaimedBytes >= targetBytes) {
+      break;
+    }
   }
 }
 
@@ -431,28 +538,14 @@ uint32_t HiveDataSink::appendWriter(const HiveWriterId& id) {
         partitionIdGenerator_->partitionName(id.partitionId.value());
   }
 
-  // Without explicitly setting flush policy, the default memory based flush
-  // policy is used.
-  auto writerParameters = getWriterParameters(partitionName, id.bucketId);
-  const auto writePath = fs::path(writerParameters.writeDirectory()) /
-      writerParameters.writeFileName();
-  writerInfo_.emplace_back(
-      std::make_shared<HiveWriterInfo>(std::move(writerParameters)));
-
-  dwio::common::WriterOptions options;
-  options.schema = inputType_;
-  options.memoryPool = connectorQueryCtx_->connectorMemoryPool();
-  options.compressionKind = insertTableHandle_->compressionKind();
+  writerInfo_.emplace_back(std::make_shared<HiveWriterInfo>(
+      getWriterParameters(partitionName, id.bucketId)));
+  writerPools_.emplace_back(
+      connectorQueryCtx_->connectorMemoryPool()->addAggregateChild(
+          fmt::format("writer.{}", writers_.size())));
   ioStats_.emplace_back(std::make_shared<dwio::common::IoStatistics>());
-  writers_.emplace_back(writerFactory_->createWriter(
-      dwio::common::FileSink::create(
-          writePath,
-          {.bufferWrite = false,
-           .connectorProperties = connectorProperties_,
-           .pool = connectorQueryCtx_->memoryPool(),
-           .metricLogger = dwio::common::MetricsLog::voidLog(),
-           .stats = ioStats_.back().get()}),
-      options));
+  writers_.emplace_back(createWriter(writers_.size()));
+  lastWriteSequences_.emplace_back(0);
   // Extends the buffer used for partition rows calculations.
   partitionSizes_.emplace_back(0);
   partitionRows_.emplace_back(nullptr);
@@ -462,6 +555,71 @@ uint32_t HiveDataSink::appendWriter(const HiveWriterId& id) {
   return writerIndexMap_[id];
 }
 
+void HiveDataSink::reopenWriter(uint32_t index) {
+  VELOX_CHECK(!isBucketed());
+  VELOX_CHECK_NULL(writers_[index]);
+  const auto& closedInfo = writerInfo_[index];
+  auto info = std::make_shared<HiveWriterInfo>(getWriterParameters(
+      closedInfo->writerParameters.partitionName(), std::nullopt));
+  info->numWrittenRows = closedInfo->numWrittenRows;
+  info->closedFiles = std::move(closedInfo->closedFiles);
+  info->closedFiles.push_back(
+      {closedInfo->writerParameters.writeFileName(),
+       closedInfo->writerParameters.targetFileName(),
+       ioStats_[index]->rawBytesWritten()});
+  writerInfo_[index] = std::move(info);
+  ioStats_[index] = std::make_shared<dwio::common::IoStatistics>();
+  writers_[index] = createWriter(index);
+}
+
+std::unique_ptr<dwio::common::Writer> HiveDataSink::createWriter(
+    uint32_t index) {
+  const auto& writerParameters = writerInfo_[index]->writerParameters;
+  const auto writePath = fs::path(writerParameters.writeDirectory()) /
+      writerParameters.writeFileName();
+
+  // Without explicitly setting flush policy, the default memory based flush
+  // policy is used.
+  dwio::common::WriterOptions options;
+  options.schema = inputType_;
+  options.memoryPool = writerPools_[index].get();
+  options.compressionKind = insertTableHandle_->compressionKind();
+  return maybeCreateSortingWriter(
+      index,
+      writerFactory_->createWriter(
+          dwio::common::FileSink::create(
+              writePath,
+              {.bufferWrite = false,
+               .connectorProperties = connectorProperties_,
+               .pool = connectorQueryCtx_->memoryPool(),
+               .metricLogger = dwio::common::MetricsLog::voidLog(),
+               .stats = ioStats_[index].get()}),
+          options));
+}
+
+std::unique_ptr<dwio::common::Writer> HiveDataSink::maybeCreateSortingWriter(
+    uint32_t writerIndex,
+    std::unique_ptr<dwio::common::Writer> writer) {
+  if (!isSorted()) {
+    return writer;
+  }
+  // The writer index keeps the spill files of the writers apart.
+  std::optional<exec::SpillConfig> spillConfig;
+  if (connectorQueryCtx_->spillConfig() != nullptr) {
+    spillConfig = *connectorQueryCtx_->spillConfig();
+    spillConfig->filePath =
+        fmt::format("{}-sort-{}", spillConfig->filePath, writerIndex);
+  }
+  return std::make_unique<SortingWriter>(
+      std::move(writer),
+      inputType_,
+      sortColumnIndices_,
+      sortCompareFlags_,
+      HiveConfig::sortWriterMaxOutputRows(connectorQueryCtx_->config()),
+      writerPools_[writerIndex]->addLeafChild("sort"),
+      std::move(spillConfig));
+}
+
 void HiveDataSink::splitInputRowsAndEnsureWriters() {
   VELOX_CHECK(isPartitioned());
   if (isBucketed()) {
@@ -338,12 +338,23 @@ class HiveWriterParameters {
   const std::string writeDirectory_;
 };
 
+/// Describes a file which has been written and closed.
+struct HiveFileInfo {
+  std::string writeFileName;
+  std::string targetFileName;
+  uint64_t fileSize;
+};
+
 struct HiveWriterInfo {
   explicit HiveWriterInfo(HiveWriterParameters parameters)
       : writerParameters(std::move(parameters)) {}
 
+  /// The parameters of the file being written.
   const HiveWriterParameters writerParameters;
   int64_t numWrittenRows = 0;
+  /// The earlier files of the same partition. A partition writer which is
+  /// closed to release memory starts a new file on the next rows.
+  std::vector<HiveFileInfo> closedFiles;
 };
 
 /// Identifies a hive writer.
@@ -406,6 +417,16 @@ class HiveDataSink : public DataSink {
 
   void close() override;
 
+  bool canReclaim() const override {
+    return true;
+  }
+
+  /// Flushes or closes the open writers from the least recently written one
+  /// until 'targetBytes' are released. A partition writer of a bucketed table
+  /// only flushes as a bucket has a single file. The others are closed and
+  /// their partitions continue in new files if more rows arrive.
+  void reclaim(uint64_t targetBytes) override;
+
  private:
   // Returns true if the table is partitioned.
   FOLLY_ALWAYS_INLINE bool isPartitioned() const {
@@ -417,6 +438,11 @@ class HiveDataSink : public DataSink {
     return bucketCount_ != 0;
   }
 
+  // Returns true if the rows of each bucket are written in sort order.
+  FOLLY_ALWAYS_INLINE bool isSorted() const {
+    return !sortColumnIndices_.empty();
+  }
+
   FOLLY_ALWAYS_INLINE bool isCommitRequired() const {
     return commitStrategy_ != CommitStrategy::kNoCommit;
   }
@@ -438,6 +464,23 @@ class HiveDataSink : public DataSink {
   // the newly created writer in 'writers_'.
   uint32_t appendWriter(const HiveWriterId& id);
 
+  // Writes 'input' with the writer at 'index', reopening it if reclaim() has
+  // closed it.
+  void write(uint32_t index, const RowVectorPtr& input);
+
+  // Creates a writer at 'index' for a new file of the same partition after the
+  // previous writer has been closed by reclaim().
+  void reopenWriter(uint32_t index);
+
+  // Creates the file writer for the file described by 'writerInfo_[index]'.
+  std::unique_ptr<dwio::common::Writer> createWriter(uint32_t index);
+
+  // Wraps 'writer' in a SortingWriter if the table is bucketed with sorting
+  // columns, otherwise returns 'writer' as is.
+  std::unique_ptr<dwio::common::Writer> maybeCreateSortingWriter(
+      uint32_t writerIndex,
+      std::unique_ptr<dwio::common::Writer> writer);
+
   HiveWriterParameters getWriterParameters(
       const std::optional<std::string>& partition,
       std::optional<uint32_t> bucketId) const;
@@ -464,6 +507,10 @@ class HiveDataSink : public DataSink {
   const std::unique_ptr<PartitionIdGenerator> partitionIdGenerator_;
   const int32_t bucketCount_{0};
   const std::unique_ptr<core::PartitionFunction> bucketFunction_;
+  // The input channels and sort orders of the sorting columns of a bucketed
+  // table. Empty if the rows are written in arrival order.
+  const std::vector<column_index_t> sortColumnIndices_;
+  const std::vector<CompareFlags> sortCompareFlags_;
   std::shared_ptr<dwio::common::WriterFactory> writerFactory_;
 
   // The map from writer id to the writer index in 'writers_' and 'writerInfo_'.
@@ -473,9 +520,17 @@ class HiveDataSink : public DataSink {
   // Below are structures for partitions from all inputs. writerInfo_ and
   // writers_ are both indexed by partitionId.
   std::vector<std::shared_ptr<HiveWriterInfo>> writerInfo_;
+  // The memory pool of each writer. It is the parent of the writer's own
+  // pools, which tells how much memory closing the writer would release.
+  std::vector<std::shared_ptr<memory::MemoryPool>> writerPools_;
+  // A writer is null if reclaim() has closed it.
   std::vector<std::unique_ptr<dwio::common::Writer>> writers_;
   // IO statistics collected for each writer.
   std::vector<std::shared_ptr<dwio::common::IoStatistics>> ioStats_;
+  // The value of 'writeSequence_' at the last write of each writer.
+  std::vector<uint64_t> lastWriteSequences_;
+  // Counts the writes to order the writers by recency in reclaim().
+  uint64_t writeSequence_{0};
 
   // Below are structures updated when processing current input. partitionIds_
   // are indexed by the row of input_. partitionRows_, rawPartitionRows_ and
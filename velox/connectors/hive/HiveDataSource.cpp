@@ -16,10 +16,13 @@
 
 #include "velox/connectors/hive/HiveDataSource.h"
 
+#include <folly/json.h>
+#include <map>
 #include <string>
 #include <unordered_map>
 
 #include "velox/common/caching/AsyncDataCache.h"
+#include "velox/common/file/FileSystems.h"
 #include "velox/dwio/common/CachedBufferedInput.h"
 #include "velox/dwio/common/ReaderFactory.h"
 #include "velox/expression/ExprToSubfieldFilter.h"
@@ -32,6 +35,87 @@ class HiveColumnHandle;
 
 namespace {
 
+// Appends the fields, constants and filters of 'spec' and its children to
+// 'out'. Returns false if 'spec' has filters that cannot be described, in
+// which case the output is not cacheable.
+bool appendScanSpecFingerprint(
+    const common::ScanSpec& spec,
+    std::string& out) {
+  if (spec.numMetadataFilters() > 0) {
+    return false;
+  }
+  out += fmt::format(
+      "{}:{}:{}", spec.fieldName(), spec.channel(), spec.projectOut());
+  if (spec.filter() != nullptr) {
+    try {
+      out += folly::toJson(spec.filter()->serialize());
+    } catch (const VeloxException&) {
+      return false;
+    }
+  }
+  if (spec.isConstant()) {
+    out += " constant " + spec.constantValue()->toString(0);
+  }
+  out += "(";
+  for (const auto& child : spec.children()) {
+    if (!appendScanSpecFingerprint(*child, out)) {
+      return false;
+    }
+    out += ",";
+  }
+  out += ")";
+  return true;
+}
+
+// Adds the conjuncts of 'expr' to 'conjuncts' in order.
+void flattenConjuncts(
+    const core::TypedExprPtr& expr,
+    std::vector<core::TypedExprPtr>& conjuncts) {
+  auto* call = dynamic_cast<const core::CallTypedExpr*>(expr.get());
+  if (call != nullptr && call->name() == "and") {
+    for (const auto& input : call->inputs()) {
+      flattenConjuncts(input, conjuncts);
+    }
+    return;
+  }
+  conjuncts.push_back(expr);
+}
+
+// Evaluates a conjunct of the remaining filter in the reader.
+class ExprMultiColumnFilter : public common::MultiColumnFilter {
+ public:
+  ExprMultiColumnFilter(
+      std::vector<std::string> inputs,
+      std::unique_ptr<exec::ExprSet> exprSet,
+      core::ExpressionEvaluator* evaluator)
+      : inputs_(std::move(inputs)),
+        exprSet_(std::move(exprSet)),
+        evaluator_(evaluator) {}
+
+  const std::vector<std::string>& inputs() const override {
+    return inputs_;
+  }
+
+  void filter(const RowVector& input, uint64_t* passed) override {
+    rows_.resize(input.size());
+    rows_.setFromBits(passed, input.size());
+    evaluator_->evaluate(exprSet_.get(), rows_, input, result_);
+    DecodedVector decoded(*result_, rows_);
+    rows_.applyToSelected([&](vector_size_t row) {
+      if (decoded.isNullAt(row) || !decoded.valueAt<bool>(row)) {
+        bits::clearBit(passed, row);
+      }
+    });
+  }
+
+ private:
+  const std::vector<std::string> inputs_;
+  const std::unique_ptr<exec::ExprSet> exprSet_;
+  core::ExpressionEvaluator* const evaluator_;
+  SelectivityVector rows_;
+  VectorPtr result_;
+};
+
 static const char* kPath = "$path";
 static const char* kBucket = "$bucket";
 
@@ -333,6 +417,66 @@ const std::string& getColumnName(const common::Subfield& subfield) {
   return field->name();
 }
 
+// Returns true if a scan that shares its reads can apply a filter on a column
+// of 'kind' to the batches read by another scan.
+bool canApplySharedFilter(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::HUGEINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return true;
+    default:
+      return false;
+  }
+}
+
+template <TypeKind Kind>
+void applySharedFilterTyped(
+    const common::Filter& filter,
+    const DecodedVector& decoded,
+    SelectivityVector& rows) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  for (auto row = rows.begin(); row < rows.end(); ++row) {
+    if (!rows.isValid(row)) {
+      continue;
+    }
+    if (decoded.isNullAt(row)
+            ? !filter.testNull()
+            : !common::applyFilter(filter, decoded.valueAt<T>(row))) {
+      rows.setValid(row, false);
+    }
+  }
+}
+
+// Deselects the rows of 'rows' where 'vector' does not pass 'filter'.
+void applySharedFilter(
+    const common::Filter& filter,
+    const BaseVector& vector,
+    SelectivityVector& rows) {
+  DecodedVector decoded(vector, rows);
+  if (filter.kind() == common::FilterKind::kIsNull ||
+      filter.kind() == common::FilterKind::kIsNotNull) {
+    for (auto row = rows.begin(); row < rows.end(); ++row) {
+      if (rows.isValid(row) &&
+          !(decoded.isNullAt(row) ? filter.testNull()
+                                  : filter.testNonNull())) {
+        rows.setValid(row, false);
+      }
+    }
+  } else {
+    VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+        applySharedFilterTyped, vector.typeKind(), filter, decoded, rows);
+  }
+  rows.updateBounds();
+}
+
 } // namespace
 
 core::TypedExprPtr HiveDataSource::extractFiltersFromRemainingFilter(
@@ -385,6 +529,46 @@ core::TypedExprPtr HiveDataSource::extractFiltersFromRemainingFilter(
   return expr;
 }
 
+core::TypedExprPtr HiveDataSource::pushRemainingFilterToReader(
+    const core::TypedExprPtr& filter) {
+  std::vector<core::TypedExprPtr> conjuncts;
+  flattenConjuncts(filter, conjuncts);
+  // Pushes a prefix of the conjuncts so that no conjunct is evaluated on rows
+  // that a preceding one drops, e.g. a / b > 1 after b <> 0.
+  size_t numPushed = 0;
+  for (; numPushed < conjuncts.size(); ++numPushed) {
+    auto exprSet = expressionEvaluator_->compile(conjuncts[numPushed]);
+    const auto& expr = exprSet->expr(0);
+    if (!expr->isDeterministic() || expr->distinctFields().empty()) {
+      break;
+    }
+    std::vector<std::string> inputs;
+    for (const auto* field : expr->distinctFields()) {
+      if (scanSpec_->childByName(field->field()) == nullptr) {
+        break;
+      }
+      inputs.push_back(field->field());
+    }
+    if (inputs.size() < expr->distinctFields().size()) {
+      break;
+    }
+    scanSpec_->addMultiColumnFilter(std::make_shared<ExprMultiColumnFilter>(
+        std::move(inputs), std::move(exprSet), expressionEvaluator_));
+    readerFilters_.push_back(conjuncts[numPushed]);
+  }
+  if (numPushed == conjuncts.size()) {
+    return nullptr;
+  }
+  auto remaining = conjuncts[numPushed];
+  for (auto i = numPushed + 1; i < conjuncts.size(); ++i) {
+    remaining = std::make_shared<core::CallTypedExpr>(
+        BOOLEAN(),
+        std::vector<core::TypedExprPtr>{remaining, conjuncts[i]},
+        "and");
+  }
+  return remaining;
+}
+
 HiveDataSource::HiveDataSource(
     const RowTypePtr& outputType,
     const std::shared_ptr<connector::ConnectorTableHandle>& tableHandle,
@@ -396,15 +580,29 @@ HiveDataSource::HiveDataSource(
     cache::AsyncDataCache* cache,
     const std::string& scanId,
     folly::Executor* executor,
-    const dwio::common::ReaderOptions& options)
+    const dwio::common::ReaderOptions& options,
+    FilterSelectivityStore* filterSelectivity,
+    FileStatisticsCache* fileStatistics,
+    bool sharedScanEnabled,
+    const std::string& queryId,
+    const std::string& ioTracePath,
+    int32_t ioTraceMaxEntries,
+    bool readerExpressionFilterEnabled,
+    DeleteVectorCache* deleteVectors)
     : fileHandleFactory_(fileHandleFactory),
       readerOpts_(options),
       pool_(&options.getMemoryPool()),
       outputType_(outputType),
+      ioTracePath_(ioTracePath),
       expressionEvaluator_(expressionEvaluator),
       cache_(cache),
       scanId_(scanId),
-      executor_(executor) {
+      executor_(executor),
+      decodedVectorCache_(dwio::common::DecodedVectorCache::getInstance()),
+      queryId_(queryId),
+      filterSelectivity_(filterSelectivity),
+      fileStatistics_(fileStatistics),
+      deleteVectors_(deleteVectors) {
   // Column handled keyed on the column alias, the name used in the query.
   for (const auto& [canonicalizedName, columnHandle] : columnHandles) {
     auto handle = std::dynamic_pointer_cast<HiveColumnHandle>(columnHandle);
@@ -524,13 +722,58 @@ HiveDataSource::HiveDataSource(
   if (remainingFilter) {
     metadataFilter_ = std::make_shared<common::MetadataFilter>(
         *scanSpec_, *remainingFilter, expressionEvaluator_);
+    if (readerExpressionFilterEnabled) {
+      remainingFilter = pushRemainingFilterToReader(remainingFilter);
+      remainingFilterExprSet_ = remainingFilter
+          ? expressionEvaluator_->compile(remainingFilter)
+          : nullptr;
+    }
   }
 
   readerOpts_.setFileSchema(hiveTableHandle->dataColumns());
   rowReaderOpts_.setScanSpec(scanSpec_);
   rowReaderOpts_.setMetadataFilter(metadataFilter_);
+  if (sharedScanEnabled && decodedVectorCache_ != nullptr) {
+    initializeSharedScan(hiveTableHandle->dataColumns());
+  }
+  if (filterSelectivity_ != nullptr) {
+    tableName_ = hiveTableHandle->tableName();
+    filterSelectivity_->initialize(
+        tableName_, *scanSpec_, filterSelectivityBaseline_);
+  }
 
   ioStats_ = std::make_shared<dwio::common::IoStatistics>();
+  if (!ioTracePath_.empty()) {
+    ioStats_->enableTrace(ioTraceMaxEntries);
+  }
+}
+
+HiveDataSource::~HiveDataSource() {
+  // The other scans must not wait for the batches of a split that is not
+  // read to the end, e.g. after a limit is reached.
+  abandonSharedLoad();
+  writeIoTrace();
+}
+
+void HiveDataSource::writeIoTrace() {
+  // 'ioStats_' is null after it is moved to the data source that takes over
+  // from this one.
+  if (!ioStats_ || !ioStats_->trace()) {
+    return;
+  }
+  try {
+    auto fs = filesystems::getFileSystem(ioTracePath_, nullptr);
+    auto file = fs->openFileForWrite(ioTracePath_);
+    file->append(ioStats_->trace()->serialize());
+    file->close();
+    if (const auto numDropped = ioStats_->trace()->numDropped()) {
+      LOG(WARNING) << "IO trace " << ioTracePath_ << " is missing "
+                   << numDropped << " reads";
+    }
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to write IO trace " << ioTracePath_ << ": "
+               << e.what();
+  }
 }
 
 inline uint8_t parseDelimiter(const std::string& delim) {
@@ -584,6 +827,22 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
   VELOX_CHECK(split_, "Wrong type of split");
 
   VLOG(1) << "Adding split " << split_->toString();
+  cachedBatches_ = nullptr;
+  nextCachedBatch_ = 0;
+  stopCollectingDecodedBatches();
+
+  emptySplit_ = false;
+  // Check filters against the statistics cached by earlier reads of the file
+  // before opening it.
+  if (fileStatistics_ != nullptr &&
+      !fileStatistics_->mayMatch(
+          split_->filePath, *scanSpec_, split_->partitionKeys)) {
+    emptySplit_ = true;
+    ++runtimeStats_.skippedSplits;
+    runtimeStats_.skippedSplitBytes += split_->length;
+    ++numSplitsSkippedByFileStatistics_;
+    return;
+  }
 
   fileHandle_ = fileHandleFactory_->generate(split_->filePath).second;
   auto input = createBufferedInput(*fileHandle_, readerOpts_);
@@ -602,12 +861,15 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
   reader_ = dwio::common::getReaderFactory(readerOpts_.getFileFormat())
                 ->createReader(std::move(input), readerOpts_);
 
-  emptySplit_ = false;
   if (reader_->numberOfRows() == 0) {
     emptySplit_ = true;
     return;
   }
 
+  if (fileStatistics_ != nullptr) {
+    fileStatistics_->add(split_->filePath, *reader_, *scanSpec_);
+  }
+
   // Check filters and see if the whole split can be skipped.
   if (!testFilters(
           scanSpec_.get(),
@@ -624,21 +886,67 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
   auto& fileType = reader_->rowType();
   // Keep track of schema types for columns in file, used by ColumnSelector.
   std::vector<TypePtr> columnTypes = fileType->children();
+  setConstantColumns(*scanSpec_, *readerOutputType_, columnTypes);
+  scanSpec_->resetCachedValues(false);
+  fileReadType_ = ROW(
+      std::vector<std::string>(fileType->names()), std::move(columnTypes));
+  if (maxSplitParts_ > 1 && !split_->isPart) {
+    divideSplit();
+  }
+  deleteVector_ = nullptr;
+  if (!split_->deleteFiles.empty()) {
+    deleteVector_ = deleteVectors_ != nullptr
+        ? deleteVectors_->get(*split_, *fileHandleFactory_, *pool_)
+        : DeleteVectorCache::load(*split_, *fileHandleFactory_, *pool_);
+    if (deleteVector_->size() == 0) {
+      deleteVector_ = nullptr;
+    }
+  }
+  // Shared and cached batches are read without deletes.
+  if (sharedScanSpec_ != nullptr && deleteVector_ == nullptr) {
+    std::vector<TypePtr> sharedColumnTypes = fileType->children();
+    setConstantColumns(*sharedScanSpec_, *sharedOutputType_, sharedColumnTypes);
+    sharedScanSpec_->resetCachedValues(false);
+    if (startSharedScan(
+            ROW(std::vector<std::string>(fileType->names()),
+                std::move(sharedColumnTypes)))) {
+      return;
+    }
+  }
+  if (decodedVectorCache_ != nullptr && deleteVector_ == nullptr) {
+    decodedCacheKey_ = makeDecodedCacheKey();
+    if (decodedCacheKey_.has_value()) {
+      cachedBatches_ = decodedVectorCache_->find(decodedCacheKey_.value());
+      if (cachedBatches_ != nullptr) {
+        // The split is served from the cache without a row reader.
+        decodedCacheKey_.reset();
+        ++numDecodedCacheHits_;
+        return;
+      }
+    }
+  }
+  configureRowReaderOptions(rowReaderOpts_, *scanSpec_, fileReadType_);
+  rowReader_ = createRowReader(rowReaderOpts_);
+}
 
-  auto& childrenSpecs = scanSpec_->children();
-  for (size_t i = 0; i < childrenSpecs.size(); ++i) {
-    auto* childSpec = childrenSpecs[i].get();
+void HiveDataSource::setConstantColumns(
+    common::ScanSpec& spec,
+    const RowType& outputType,
+    std::vector<TypePtr>& columnTypes) const {
+  const auto& fileType = reader_->rowType();
+  for (auto& childSpec : spec.children()) {
     const std::string& fieldName = childSpec->fieldName();
 
     auto iter = split_->partitionKeys.find(fieldName);
     if (iter != split_->partitionKeys.end()) {
-      setPartitionValue(childSpec, fieldName, iter->second);
+      setPartitionValue(childSpec.get(), fieldName, iter->second);
     } else if (fieldName == kPath) {
-      setConstantValue(childSpec, VARCHAR(), velox::variant(split_->filePath));
+      setConstantValue(
+          childSpec.get(), VARCHAR(), velox::variant(split_->filePath));
     } else if (fieldName == kBucket) {
       if (split_->tableBucketNumber.has_value()) {
         setConstantValue(
-            childSpec,
+            childSpec.get(),
             INTEGER(),
             velox::variant(split_->tableBucketNumber.value()));
       }
@@ -648,31 +956,26 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
         // Column is missing. Most likely due to schema evolution.
         VELOX_CHECK(readerOpts_.getFileSchema());
         setNullConstantValue(
-            childSpec, readerOpts_.getFileSchema()->findChild(fieldName));
+            childSpec.get(),
+            readerOpts_.getFileSchema()->findChild(fieldName));
       } else {
         // Column no longer missing, reset constant value set on the spec.
         childSpec->setConstantValue(nullptr);
-        auto outputTypeIdx = readerOutputType_->getChildIdxIfExists(fieldName);
+        auto outputTypeIdx = outputType.getChildIdxIfExists(fieldName);
         if (outputTypeIdx.has_value()) {
           // We know the fieldName exists in the file, make the type at that
           // position match what we expect in the output.
           columnTypes[fileTypeIdx.value()] =
-              readerOutputType_->childAt(*outputTypeIdx);
+              outputType.childAt(*outputTypeIdx);
         }
       }
     }
   }
-
-  scanSpec_->resetCachedValues(false);
-  configureRowReaderOptions(
-      rowReaderOpts_,
-      ROW(std::vector<std::string>(fileType->names()), std::move(columnTypes)));
-  rowReader_ = createRowReader(rowReaderOpts_);
 }
 
 std::optional<RowVectorPtr> HiveDataSource::next(
     uint64_t size,
-    velox::ContinueFuture& /*future*/) {
+    velox::ContinueFuture& future) {
   VELOX_CHECK(split_ != nullptr, "No split to process. Call addSplit first.");
   if (emptySplit_) {
     resetSplit();
@@ -687,20 +990,44 @@ std::optional<RowVectorPtr> HiveDataSource::next(
   // any column, e.g. rand() < 0.1. Evaluate that conjunct first, then scan
   // only rows that passed.
 
-  auto rowsScanned = readNext(size);
+  if (remainingLimit_.has_value() && !remainingFilterExprSet_ &&
+      !scanSpec_->hasFilter()) {
+    // Every row read is returned, so rows beyond the limit are not read.
+    size = std::max<uint64_t>(1, std::min(size, remainingLimit_.value()));
+  }
+
+  RowVectorPtr rowVector;
+  uint64_t rowsScanned = 0;
+  const bool shared = sharedLoad_ != nullptr || sharedRowReader_ != nullptr;
+  if (shared) {
+    auto batch = nextSharedBatch(size, rowsScanned, future);
+    if (!batch.has_value()) {
+      return std::nullopt;
+    }
+    rowVector = std::move(batch.value());
+  } else if (cachedBatches_ != nullptr) {
+    if (nextCachedBatch_ < cachedBatches_->size()) {
+      rowVector = (*cachedBatches_)[nextCachedBatch_++];
+      rowsScanned = rowVector->size();
+    }
+  } else {
+    rowsScanned = readNext(size);
+    if (rowsScanned) {
+      rowVector = std::dynamic_pointer_cast<RowVector>(output_);
+      collectDecodedBatch(rowVector);
+    }
+  }
   completedRows_ += rowsScanned;
 
   if (rowsScanned) {
     VELOX_CHECK(
-        !output_->mayHaveNulls(), "Top-level row vector cannot have nulls");
-    auto rowsRemaining = output_->size();
+        !rowVector->mayHaveNulls(), "Top-level row vector cannot have nulls");
+    auto rowsRemaining = rowVector->size();
     if (rowsRemaining == 0) {
       // no rows passed the pushed down filters.
       return RowVector::createEmpty(outputType_, pool_);
     }
 
-    auto rowVector = std::dynamic_pointer_cast<RowVector>(output_);
-
     // In case there is a remaining filter that excludes some but not all
     // rows, collect the indices of the passing rows. If there is no filter,
     // or it passes on all rows, leave this as null and let exec::wrap skip
@@ -728,9 +1055,10 @@ std::optional<RowVectorPtr> HiveDataSource::next(
     outputColumns.reserve(outputType_->size());
     for (int i = 0; i < outputType_->size(); i++) {
       auto& child = rowVector->childAt(i);
-      if (remainingIndices) {
+      if (remainingIndices && cachedBatches_ == nullptr && !shared) {
         // Disable dictionary values caching in expression eval so that we
-        // don't need to reallocate the result for every batch.
+        // don't need to reallocate the result for every batch. Cached and
+        // shared vectors are used by other scans and are not modified.
         child->disableMemo();
       }
       outputColumns.emplace_back(
@@ -741,7 +1069,10 @@ std::optional<RowVectorPtr> HiveDataSource::next(
         pool_, outputType_, BufferPtr(nullptr), rowsRemaining, outputColumns);
   }
 
-  rowReader_->updateRuntimeStats(runtimeStats_);
+  if (cachedBatches_ == nullptr && !shared) {
+    finishDecodedBatches();
+    rowReader_->updateRuntimeStats(runtimeStats_);
+  }
 
   resetSplit();
   return nullptr;
@@ -753,6 +1084,9 @@ void HiveDataSource::addDynamicFilter(
   auto& fieldSpec = scanSpec_->getChildByChannel(outputChannel);
   fieldSpec.addFilter(*filter);
   scanSpec_->resetCachedValues(true);
+  hasDynamicFilters_ = true;
+  // The rest of the split is read with a filter that is not in the cache key.
+  stopCollectingDecodedBatches();
   if (rowReader_) {
     rowReader_->resetFilterCaches();
   }
@@ -787,6 +1121,50 @@ std::unordered_map<std::string, RuntimeCounter> HiveDataSource::runtimeStats() {
             ioStats_->rawOverreadBytes(), RuntimeCounter::Unit::kBytes)},
        {"queryThreadIoLatency",
         RuntimeCounter(ioStats_->queryThreadIoLatency().count())}});
+  if (numDecodedCacheHits_ > 0) {
+    res.insert(
+        {"numDecodedCacheHits", RuntimeCounter(numDecodedCacheHits_)});
+  }
+  if (numSharedScanSplits_ > 0) {
+    res.insert(
+        {"numSharedScanSplits", RuntimeCounter(numSharedScanSplits_)});
+  }
+  if (numSplitsSkippedByFileStatistics_ > 0) {
+    res.insert(
+        {"numSplitsSkippedByFileStatistics",
+         RuntimeCounter(numSplitsSkippedByFileStatistics_)});
+  }
+  if (numDeletedRows_ > 0) {
+    res.insert({"numDeletedRows", RuntimeCounter(numDeletedRows_)});
+  }
+  if (ioStats_->storageReadLatency().count() > 0) {
+    const auto& latency = ioStats_->storageReadLatency();
+    res.insert(
+        {{"storageReadLatencyP50",
+          RuntimeCounter(
+              latency.percentileMicros(0.5) * 1000,
+              RuntimeCounter::Unit::kNanos)},
+         {"storageReadLatencyP99",
+          RuntimeCounter(
+              latency.percentileMicros(0.99) * 1000,
+              RuntimeCounter::Unit::kNanos)}});
+  }
+  if (ioStats_->peerRead().count() > 0) {
+    res.insert(
+        {{"numPeerRead", RuntimeCounter(ioStats_->peerRead().count())},
+         {"peerReadBytes",
+          RuntimeCounter(
+              ioStats_->peerRead().sum(), RuntimeCounter::Unit::kBytes)}});
+  }
+  if (ioStats_->metadataCacheHit().count() +
+          ioStats_->metadataCacheMiss().count() >
+      0) {
+    res.insert(
+        {{"numMetadataCacheHit",
+          RuntimeCounter(ioStats_->metadataCacheHit().count())},
+         {"numMetadataCacheMiss",
+          RuntimeCounter(ioStats_->metadataCacheMiss().count())}});
+  }
   return res;
 }
 
@@ -796,6 +1174,9 @@ void HiveDataSource::setFromDataSource(
   VELOX_CHECK(source, "Bad DataSource type");
   emptySplit_ = source->emptySplit_;
   split_ = std::move(source->split_);
+  splitParts_ = std::move(source->splitParts_);
+  numSplitsSkippedByFileStatistics_ +=
+      source->numSplitsSkippedByFileStatistics_;
   if (emptySplit_) {
     return;
   }
@@ -803,10 +1184,39 @@ void HiveDataSource::setFromDataSource(
   scanSpec_ = std::move(source->scanSpec_);
   reader_ = std::move(source->reader_);
   rowReader_ = std::move(source->rowReader_);
+  cachedBatches_ = std::move(source->cachedBatches_);
+  nextCachedBatch_ = source->nextCachedBatch_;
+  decodedCacheKey_ = std::move(source->decodedCacheKey_);
+  decodedBatches_ = std::move(source->decodedBatches_);
+  decodedBytes_ = source->decodedBytes_;
+  numDecodedCacheHits_ += source->numDecodedCacheHits_;
+  fileReadType_ = std::move(source->fileReadType_);
+  deleteVector_ = std::move(source->deleteVector_);
+  numDeletedRows_ += source->numDeletedRows_;
+  sharedLoad_ = std::move(source->sharedLoad_);
+  sharedRowReader_ = std::move(source->sharedRowReader_);
+  sharedLoadBytes_ = source->sharedLoadBytes_;
+  nextSharedBatch_ = source->nextSharedBatch_;
+  sharedRowsScanned_ = source->sharedRowsScanned_;
+  numSharedScanSplits_ += source->numSharedScanSplits_;
   // New io will be accounted on the stats of 'source'. Add the existing
   // balance to that.
   source->ioStats_->merge(*ioStats_);
   ioStats_ = std::move(source->ioStats_);
+
+  // 'source' tested the file statistics without the dynamic filters, e.g.
+  // the threshold of a TopN, which 'scanSpec_' now has.
+  if (hasDynamicFilters_ && reader_ != nullptr &&
+      !testFilters(
+          scanSpec_.get(),
+          reader_.get(),
+          split_->filePath,
+          split_->partitionKeys,
+          partitionKeys_)) {
+    emptySplit_ = true;
+    ++runtimeStats_.skippedSplits;
+    runtimeStats_.skippedSplitBytes += split_->length;
+  }
 }
 
 int64_t HiveDataSource::estimatedRowSize() {
@@ -903,7 +1313,8 @@ HiveDataSource::createBufferedInput(
         dwio::common::MetricsLog::voidLog(),
         fileHandle.uuid.id(),
         cache_,
-        Connector::getTracker(scanId_, readerOpts.loadQuantum()),
+        Connector::getTracker(
+            scanId_, readerOpts.loadQuantum(), &cache_->trackingHistory()),
         fileHandle.groupId.id(),
         ioStats_,
         executor_,
@@ -916,8 +1327,29 @@ HiveDataSource::createBufferedInput(
       ioStats_.get());
 }
 
+uint64_t HiveDataSource::readNext(uint64_t size) {
+  if (deleteVector_ == nullptr) {
+    return rowReader_->next(size, output_);
+  }
+  const auto rowNumber = rowReader_->nextRowNumber();
+  const auto numRows = rowReader_->nextReadSize(size);
+  if (rowNumber == dwio::common::RowReader::kAtEnd ||
+      numRows == dwio::common::RowReader::kAtEnd) {
+    return rowReader_->next(size, output_);
+  }
+  deletedRows_.resize(bits::nwords(numRows));
+  const auto numDeleted =
+      deleteVector_->fillBits(rowNumber, numRows, deletedRows_.data());
+  if (numDeleted == 0) {
+    return rowReader_->next(size, output_);
+  }
+  numDeletedRows_ += numDeleted;
+  dwio::common::Mutation mutation{deletedRows_.data()};
+  return rowReader_->next(size, output_, &mutation);
+}
+
 vector_size_t HiveDataSource::evaluateRemainingFilter(RowVectorPtr& rowVector) {
-  filterRows_.resize(output_->size());
+  filterRows_.resize(rowVector->size());
 
   expressionEvaluator_->evaluate(
       remainingFilterExprSet_.get(), filterRows_, *rowVector, filterResult_);
@@ -952,16 +1384,360 @@ void HiveDataSource::setPartitionValue(
   setConstantValue(spec, it->second->dataType(), constValue);
 }
 
+std::optional<dwio::common::DecodedVectorCache::Key>
+HiveDataSource::makeDecodedCacheKey() const {
+  std::string fingerprint = readerOutputType_->toString();
+  // A remaining filter is applied after the cache but its metadata filters
+  // skip row groups in the reader, so it is part of the key.
+  if (remainingFilterExprSet_ != nullptr) {
+    fingerprint += " remaining " + remainingFilterExprSet_->expr(0)->toString();
+  }
+  for (const auto& filter : readerFilters_) {
+    fingerprint += " reader " + filter->toString();
+  }
+  if (!appendScanSpecFingerprint(*scanSpec_, fingerprint)) {
+    return std::nullopt;
+  }
+  return dwio::common::DecodedVectorCache::Key{
+      split_->filePath,
+      split_->start,
+      split_->length,
+      std::move(fingerprint)};
+}
+
+void HiveDataSource::collectDecodedBatch(const RowVectorPtr& rowVector) {
+  if (!decodedCacheKey_.has_value() || rowVector->size() == 0) {
+    return;
+  }
+  auto copy = decodedVectorCache_->copy(rowVector);
+  if (copy == nullptr) {
+    stopCollectingDecodedBatches();
+    return;
+  }
+  decodedBytes_ += copy->retainedSize();
+  if (decodedBytes_ > decodedVectorCache_->maxEntryBytes()) {
+    stopCollectingDecodedBatches();
+    return;
+  }
+  decodedBatches_.push_back(std::move(copy));
+}
+
+void HiveDataSource::finishDecodedBatches() {
+  if (decodedCacheKey_.has_value()) {
+    decodedVectorCache_->insert(
+        std::move(decodedCacheKey_.value()), std::move(decodedBatches_));
+  }
+  stopCollectingDecodedBatches();
+}
+
+void HiveDataSource::stopCollectingDecodedBatches() {
+  decodedCacheKey_.reset();
+  decodedBatches_.clear();
+  decodedBytes_ = 0;
+}
+
+void HiveDataSource::initializeSharedScan(const RowTypePtr& dataColumns) {
+  // The columns by name, so that scans that read the same columns in a
+  // different order share their reads.
+  if (!scanSpec_->multiColumnFilters().empty()) {
+    // The shared reads apply only single column filters.
+    return;
+  }
+  std::map<std::string, TypePtr> columns;
+  for (auto i = 0; i < readerOutputType_->size(); ++i) {
+    columns.emplace(
+        readerOutputType_->nameOf(i), readerOutputType_->childAt(i));
+  }
+  for (const auto& child : scanSpec_->children()) {
+    for (const auto& grandchild : child->children()) {
+      if (grandchild->hasFilter()) {
+        // Filters on subfields are only applied by the file readers.
+        return;
+      }
+    }
+    if (child->filter() == nullptr) {
+      continue;
+    }
+    const auto& name = child->fieldName();
+    TypePtr type;
+    auto partitionKeyIt = partitionKeys_.find(name);
+    if (auto it = columns.find(name); it != columns.end()) {
+      type = it->second;
+    } else if (partitionKeyIt != partitionKeys_.end()) {
+      type = partitionKeyIt->second->dataType();
+    } else if (dataColumns != nullptr && dataColumns->containsChild(name)) {
+      type = dataColumns->findChild(name);
+    }
+    if (type == nullptr || !canApplySharedFilter(type->kind())) {
+      return;
+    }
+    columns.emplace(name, type);
+  }
+
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (auto& [name, type] : columns) {
+    names.push_back(name);
+    types.push_back(type);
+  }
+  sharedOutputType_ = ROW(std::move(names), std::move(types));
+  sharedScanSpec_ = makeScanSpec(sharedOutputType_, {}, {}, dataColumns, pool_);
+  sharedRowReaderOpts_.setScanSpec(sharedScanSpec_);
+}
+
+bool HiveDataSource::startSharedScan(const RowTypePtr& fileType) {
+  auto sharedScan = decodedVectorCache_->shareScan(
+      {split_->filePath,
+       split_->start,
+       split_->length,
+       "shared " + sharedOutputType_->toString()},
+      queryId_);
+  if (sharedScan.load == nullptr) {
+    return false;
+  }
+  sharedLoad_ = std::move(sharedScan.load);
+  sharedLoadBytes_ = 0;
+  nextSharedBatch_ = 0;
+  sharedRowsScanned_ = 0;
+  if (sharedScan.reader) {
+    configureRowReaderOptions(sharedRowReaderOpts_, *sharedScanSpec_, fileType);
+    sharedRowReader_ = reader_->createRowReader(sharedRowReaderOpts_);
+  } else {
+    ++numSharedScanSplits_;
+  }
+  return true;
+}
+
+std::optional<RowVectorPtr> HiveDataSource::nextSharedBatch(
+    uint64_t size,
+    uint64_t& rowsScanned,
+    velox::ContinueFuture& future) {
+  using Result = dwio::common::DecodedVectorCache::SharedLoad::Result;
+  RowVectorPtr batch;
+  if (sharedRowReader_ != nullptr) {
+    batch = readNextShared(size);
+  } else {
+    switch (sharedLoad_->batchAt(nextSharedBatch_, batch, future)) {
+      case Result::kBatch:
+        ++nextSharedBatch_;
+        break;
+      case Result::kWait:
+        return std::nullopt;
+      case Result::kEnd:
+        break;
+      case Result::kAbandoned:
+        continueUnshared();
+        rowsScanned = readNext(size);
+        if (rowsScanned == 0) {
+          rowReader_->updateRuntimeStats(runtimeStats_);
+          return nullptr;
+        }
+        return std::dynamic_pointer_cast<RowVector>(output_);
+    }
+  }
+  if (batch == nullptr) {
+    // End of split.
+    if (sharedRowReader_ != nullptr) {
+      sharedRowReader_->updateRuntimeStats(runtimeStats_);
+      sharedRowReader_.reset();
+    }
+    sharedLoad_.reset();
+    rowsScanned = 0;
+    return nullptr;
+  }
+  rowsScanned = batch->size();
+  sharedRowsScanned_ += rowsScanned;
+  return filterSharedBatch(batch);
+}
+
+RowVectorPtr HiveDataSource::readNextShared(uint64_t size) {
+  if (!sharedOutput_) {
+    sharedOutput_ = BaseVector::create(sharedOutputType_, 0, pool_);
+  }
+  if (sharedRowReader_->next(size, sharedOutput_) == 0) {
+    if (sharedLoad_ != nullptr) {
+      sharedLoad_->finish();
+      sharedLoad_.reset();
+    }
+    return nullptr;
+  }
+  auto batch = std::dynamic_pointer_cast<RowVector>(sharedOutput_);
+  if (sharedLoad_ == nullptr) {
+    return batch;
+  }
+  auto copy = decodedVectorCache_->copy(batch);
+  if (copy != nullptr) {
+    sharedLoadBytes_ += copy->retainedSize();
+  }
+  if (copy == nullptr ||
+      sharedLoadBytes_ > decodedVectorCache_->maxEntryBytes()) {
+    // The other scans read the rest of the split by themselves.
+    abandonSharedLoad();
+    return batch;
+  }
+  sharedLoad_->add(copy);
+  return copy;
+}
+
+RowVectorPtr HiveDataSource::filterSharedBatch(const RowVectorPtr& batch) {
+  const auto numRows = batch->size();
+  sharedRows_.resizeFill(numRows, true);
+  for (const auto& child : scanSpec_->children()) {
+    // The filters on constant columns are checked in addSplit().
+    if (child->filter() == nullptr || child->isConstant()) {
+      continue;
+    }
+    const auto& column =
+        batch->childAt(sharedOutputType_->getChildIdx(child->fieldName()));
+    if (!canApplySharedFilter(column->typeKind())) {
+      // Only a dynamic filter can be on such a column, see
+      // initializeSharedScan(). It is redundant with the join that made it.
+      continue;
+    }
+    applySharedFilter(*child->filter(), *column, sharedRows_);
+    if (!sharedRows_.hasSelections()) {
+      return RowVector::createEmpty(readerOutputType_, pool_);
+    }
+  }
+
+  const auto numPassed = sharedRows_.countSelected();
+  BufferPtr indices;
+  if (numPassed < numRows) {
+    indices = allocateIndices(numPassed, pool_);
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    vector_size_t i = 0;
+    sharedRows_.applyToSelected([&](auto row) { rawIndices[i++] = row; });
+  }
+  std::vector<VectorPtr> columns;
+  columns.reserve(readerOutputType_->size());
+  for (const auto& name : readerOutputType_->names()) {
+    columns.push_back(exec::wrapChild(
+        numPassed,
+        indices,
+        batch->childAt(sharedOutputType_->getChildIdx(name))));
+  }
+  return std::make_shared<RowVector>(
+      pool_,
+      readerOutputType_,
+      BufferPtr(nullptr),
+      numPassed,
+      std::move(columns));
+}
+
+void HiveDataSource::continueUnshared() {
+  sharedLoad_.reset();
+  configureRowReaderOptions(rowReaderOpts_, *scanSpec_, fileReadType_);
+  rowReader_ = createRowReader(rowReaderOpts_);
+  // The rows that were read from the shared batches are scanned again and
+  // dropped.
+  while (sharedRowsScanned_ > 0) {
+    const auto rowsScanned = rowReader_->next(sharedRowsScanned_, output_);
+    VELOX_CHECK_GT(rowsScanned, 0);
+    VELOX_CHECK_LE(rowsScanned, sharedRowsScanned_);
+    sharedRowsScanned_ -= rowsScanned;
+  }
+}
+
+void HiveDataSource::abandonSharedLoad() {
+  if (sharedLoad_ != nullptr && sharedRowReader_ != nullptr) {
+    sharedLoad_->abandon();
+  }
+  sharedLoad_.reset();
+}
+
 void HiveDataSource::resetSplit() {
   split_.reset();
+  if (filterSelectivity_ != nullptr) {
+    filterSelectivity_->update(
+        tableName_, *scanSpec_, filterSelectivityBaseline_);
+  }
   // Keep readers around to hold adaptation.
 }
 
+void HiveDataSource::divideSplit() {
+  // The default length of a split is the maximum uint64_t.
+  const auto end = split_->start +
+      std::min(
+          split_->length,
+          std::numeric_limits<uint64_t>::max() - split_->start);
+  const auto stripeOffsets = reader_->stripeOffsets();
+  std::vector<uint64_t> offsets;
+  // Size of each stripe in 'offsets', taken as the distance to the next
+  // stripe. The last stripe of the file gets the average size.
+  std::vector<uint64_t> sizes;
+  uint64_t totalBytes = 0;
+  for (auto i = 0; i < stripeOffsets.size(); ++i) {
+    const auto offset = stripeOffsets[i];
+    if (offset >= split_->start && offset < end) {
+      offsets.push_back(offset);
+      if (i + 1 < stripeOffsets.size()) {
+        sizes.push_back(stripeOffsets[i + 1] - offset);
+        totalBytes += sizes.back();
+      }
+    }
+  }
+  if (offsets.size() < 2) {
+    return;
+  }
+  if (sizes.size() < offsets.size()) {
+    sizes.push_back(totalBytes / sizes.size());
+    totalBytes += sizes.back();
+  }
+  const auto numParts = std::min<size_t>(maxSplitParts_, offsets.size());
+  auto makePart = [&](size_t firstStripe, size_t lastStripe) {
+    // A part starts at its first stripe and ends before the first stripe of
+    // the next part so that each stripe is read by exactly one part.
+    const auto start = firstStripe == 0 ? split_->start : offsets[firstStripe];
+    const auto partEnd =
+        lastStripe == offsets.size() ? end : offsets[lastStripe];
+    auto part = std::make_shared<HiveConnectorSplit>(
+        split_->connectorId,
+        split_->filePath,
+        split_->fileFormat,
+        start,
+        partEnd - start,
+        split_->partitionKeys,
+        split_->tableBucketNumber,
+        split_->customSplitInfo,
+        split_->extraFileInfo,
+        split_->serdeParameters);
+    part->isPart = true;
+    part->deleteFiles = split_->deleteFiles;
+    return part;
+  };
+  // Makes parts of about equal bytes so that a part with a few large stripes
+  // does not run much longer than the others.
+  size_t firstStripe = 0;
+  uint64_t partsBytes = 0;
+  std::shared_ptr<HiveConnectorSplit> first;
+  for (size_t i = 0; i < numParts; ++i) {
+    const auto targetBytes = totalBytes * (i + 1) / numParts;
+    // Takes at least one stripe and leaves one for each of the next parts.
+    const auto maxLastStripe = offsets.size() - (numParts - i - 1);
+    auto lastStripe = firstStripe;
+    do {
+      partsBytes += sizes[lastStripe++];
+    } while (lastStripe < maxLastStripe &&
+             partsBytes + sizes[lastStripe] / 2 <= targetBytes);
+    auto part = makePart(firstStripe, lastStripe);
+    if (i == 0) {
+      first = std::move(part);
+    } else {
+      splitParts_.push_back(std::move(part));
+    }
+    firstStripe = lastStripe;
+  }
+  VLOG(1) << "Divided split " << split_->toString() << " into " << numParts
+          << " parts";
+  split_ = std::move(first);
+}
+
 void HiveDataSource::configureRowReaderOptions(
     dwio::common::RowReaderOptions& options,
+    const common::ScanSpec& scanSpec,
     const RowTypePtr& rowType) const {
   std::vector<std::string> columnNames;
-  for (auto& spec : scanSpec_->children()) {
+  for (auto& spec : scanSpec.children()) {
     if (!spec->isConstant()) {
       columnNames.push_back(spec->fieldName());
     }
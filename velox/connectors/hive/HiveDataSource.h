@@ -16,10 +16,14 @@
 #pragma once
 
 #include "velox/connectors/Connector.h"
+#include "velox/connectors/hive/DeleteVectorCache.h"
 #include "velox/connectors/hive/FileHandle.h"
+#include "velox/connectors/hive/FileStatisticsCache.h"
+#include "velox/connectors/hive/FilterSelectivityStore.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
 #include "velox/connectors/hive/TableHandle.h"
 #include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/common/DecodedVectorCache.h"
 #include "velox/dwio/common/Reader.h"
 #include "velox/dwio/common/ScanSpec.h"
 #include "velox/exec/OperatorUtils.h"
@@ -40,7 +44,17 @@ class HiveDataSource : public DataSource {
       cache::AsyncDataCache* cache,
       const std::string& scanId,
       folly::Executor* executor,
-      const dwio::common::ReaderOptions& options);
+      const dwio::common::ReaderOptions& options,
+      FilterSelectivityStore* filterSelectivity = nullptr,
+      FileStatisticsCache* fileStatistics = nullptr,
+      bool sharedScanEnabled = false,
+      const std::string& queryId = "",
+      const std::string& ioTracePath = "",
+      int32_t ioTraceMaxEntries = 0,
+      bool readerExpressionFilterEnabled = false,
+      DeleteVectorCache* deleteVectors = nullptr);
+
+  ~HiveDataSource() override;
 
   void addSplit(std::shared_ptr<ConnectorSplit> split) override;
 
@@ -69,6 +83,18 @@ class HiveDataSource : public DataSource {
 
   int64_t estimatedRowSize() override;
 
+  void setMaxSplitParts(int32_t maxParts) override {
+    maxSplitParts_ = maxParts;
+  }
+
+  std::vector<std::shared_ptr<ConnectorSplit>> takeSplitParts() override {
+    return std::move(splitParts_);
+  }
+
+  void setRemainingLimit(uint64_t numRows) override {
+    remainingLimit_ = numRows;
+  }
+
   // Internal API, made public to be accessible in unit tests.  Do not use in
   // other places.
   static std::shared_ptr<common::ScanSpec> makeScanSpec(
@@ -89,9 +115,9 @@ class HiveDataSource : public DataSource {
       SubfieldFilters& filters);
 
  protected:
-  virtual uint64_t readNext(uint64_t size) {
-    return rowReader_->next(size, output_);
-  }
+  // Reads the next batch with 'rowReader_', dropping the rows in
+  // 'deleteVector_'.
+  virtual uint64_t readNext(uint64_t size);
 
   std::unique_ptr<dwio::common::BufferedInput> createBufferedInput(
       const FileHandle&,
@@ -117,6 +143,79 @@ class HiveDataSource : public DataSource {
   // filterEvalCtx_.selectedIndices and selectedBits are not updated.
   vector_size_t evaluateRemainingFilter(RowVectorPtr& rowVector);
 
+  // Adds the leading conjuncts of 'filter' that reference columns as
+  // multi-column filters of 'scanSpec_', so that the reader evaluates them.
+  // Returns the conjuncts that are not pushed down or nullptr if all are.
+  core::TypedExprPtr pushRemainingFilterToReader(
+      const core::TypedExprPtr& filter);
+
+  // Returns the key of the current split in 'decodedVectorCache_' or nullopt
+  // if the output of the split cannot be cached.
+  std::optional<dwio::common::DecodedVectorCache::Key> makeDecodedCacheKey()
+      const;
+
+  // Adds a copy of 'rowVector' to the batches collected for the decoded
+  // vector cache entry of the current split. Stops collecting if the split
+  // gets too large for the cache.
+  void collectDecodedBatch(const RowVectorPtr& rowVector);
+
+  // Adds the collected batches to the decoded vector cache at the end of the
+  // split.
+  void finishDecodedBatches();
+
+  // Stops collecting batches for the decoded vector cache for the rest of
+  // the split.
+  void stopCollectingDecodedBatches();
+
+  // Sets 'sharedOutputType_' and 'sharedScanSpec_' if the scan can share the
+  // reads of splits with other scans. 'dataColumns' are the columns of the
+  // table.
+  void initializeSharedScan(const RowTypePtr& dataColumns);
+
+  // Attaches to the read of 'split_' by a concurrent scan or starts one for
+  // the other scans. Returns false if the split is read without sharing.
+  // 'fileType' is the type of the file with the types of 'sharedOutputType_'
+  // for its columns.
+  bool startSharedScan(const RowTypePtr& fileType);
+
+  // Returns the next batch of the split from 'sharedLoad_' or from
+  // 'sharedRowReader_' with the filters of 'scanSpec_' applied and the
+  // columns of 'readerOutputType_'. Returns std::nullopt and sets 'future' if
+  // the batch is yet to be read by another scan. Sets 'rowsScanned' to the
+  // number of rows in the batch before the filters, 0 at the end of the
+  // split.
+  std::optional<RowVectorPtr> nextSharedBatch(
+      uint64_t size,
+      uint64_t& rowsScanned,
+      velox::ContinueFuture& future);
+
+  // Reads the next batch with 'sharedRowReader_' and adds a copy to
+  // 'sharedLoad_' for the other scans. Returns nullptr at the end of the
+  // split.
+  RowVectorPtr readNextShared(uint64_t size);
+
+  // Returns the rows of 'batch', which has the columns of 'sharedOutputType_',
+  // that pass the filters of 'scanSpec_', with the columns of
+  // 'readerOutputType_'.
+  RowVectorPtr filterSharedBatch(const RowVectorPtr& batch);
+
+  // Creates 'rowReader_' to read the rest of the split by itself after the
+  // scan that shared its reads stopped sharing.
+  void continueUnshared();
+
+  // Stops adding batches to 'sharedLoad_' if this scan reads them for other
+  // scans.
+  void abandonSharedLoad();
+
+  // Sets the constant values of the columns in 'spec' that are not read from
+  // the file of 'split_': the partition keys, the $path and $bucket columns
+  // and the columns missing in the file. Sets the types of the columns of
+  // 'outputType' in 'columnTypes', the column types of the file.
+  void setConstantColumns(
+      common::ScanSpec& spec,
+      const RowType& outputType,
+      std::vector<TypePtr>& columnTypes) const;
+
   void setConstantValue(
       common::ScanSpec* FOLLY_NONNULL spec,
       const TypePtr& type,
@@ -137,22 +236,47 @@ class HiveDataSource : public DataSource {
 
   void configureRowReaderOptions(
       dwio::common::RowReaderOptions&,
+      const common::ScanSpec& scanSpec,
       const RowTypePtr& rowType) const;
 
   void parseSerdeParameters(
       const std::unordered_map<std::string, std::string>& serdeParameters);
 
+  // Divides 'split_' into up to 'maxSplitParts_' ranges of consecutive
+  // stripes of about equal size in bytes. Narrows 'split_' to the first range and adds splits for the
+  // others to 'splitParts_'. Does nothing if the split has fewer than 2
+  // stripes.
+  void divideSplit();
+
+  // Writes the IO trace of the scan to 'ioTracePath_'. Logs and ignores
+  // errors since the trace is diagnostic only.
+  void writeIoTrace();
+
   const RowTypePtr outputType_;
   // Column handles for the partition key columns keyed on partition key column
   // name.
   std::unordered_map<std::string, std::shared_ptr<HiveColumnHandle>>
       partitionKeys_;
   std::shared_ptr<dwio::common::IoStatistics> ioStats_;
+  // File to which the IO trace is written at destruction. Empty if the reads
+  // are not traced.
+  const std::string ioTracePath_;
   std::shared_ptr<common::ScanSpec> scanSpec_;
   std::shared_ptr<common::MetadataFilter> metadataFilter_;
   dwio::common::RowReaderOptions rowReaderOpts_;
   std::unique_ptr<dwio::common::Reader> reader_;
   std::unique_ptr<exec::ExprSet> remainingFilterExprSet_;
+  // Conjuncts of the remaining filter that are evaluated by the reader.
+  std::vector<core::TypedExprPtr> readerFilters_;
+
+  // Deleted rows of the files of splits with delete files. nullptr if there
+  // is no cache.
+  DeleteVectorCache* const deleteVectors_;
+  // The deleted rows of the current split or nullptr if none.
+  std::shared_ptr<const dwio::common::DeleteVector> deleteVector_;
+  // Bits of the deleted rows of the next batch.
+  std::vector<uint64_t> deletedRows_;
+  uint64_t numDeletedRows_{0};
   bool emptySplit_;
 
   dwio::common::RuntimeStatistics runtimeStats_;
@@ -169,6 +293,86 @@ class HiveDataSource : public DataSource {
   cache::AsyncDataCache* const cache_{nullptr};
   const std::string& scanId_;
   folly::Executor* executor_;
+
+  // The process wide decoded vector cache or nullptr if there is none.
+  dwio::common::DecodedVectorCache* const decodedVectorCache_;
+
+  // The cached batches of the current split if it was found in
+  // 'decodedVectorCache_' and the index of the next batch to return.
+  std::shared_ptr<const dwio::common::DecodedVectorCache::Batches>
+      cachedBatches_;
+  size_t nextCachedBatch_{0};
+
+  // The key of the current split and the copies of its batches while they
+  // are collected for adding to 'decodedVectorCache_'.
+  std::optional<dwio::common::DecodedVectorCache::Key> decodedCacheKey_;
+  dwio::common::DecodedVectorCache::Batches decodedBatches_;
+  uint64_t decodedBytes_{0};
+
+  // Number of splits read from 'decodedVectorCache_'.
+  uint64_t numDecodedCacheHits_{0};
+
+  // The columns read by a scan that shares its reads with other scans: the
+  // columns of 'readerOutputType_' and the columns with filters, ordered by
+  // name. Scans with the same columns share the reads of a split whatever
+  // their filters. nullptr if the scan does not share its reads.
+  RowTypePtr sharedOutputType_;
+  // Reads the columns of 'sharedOutputType_' without filters.
+  std::shared_ptr<common::ScanSpec> sharedScanSpec_;
+  dwio::common::RowReaderOptions sharedRowReaderOpts_;
+  // The file type for 'rowReader_' of the current split. 'rowReader_' is
+  // only created if the split is read without sharing.
+  RowTypePtr fileReadType_;
+  // The query of the scan. Scans of the same query do not share reads.
+  const std::string queryId_;
+
+  // The read of the current split shared with other scans or nullptr.
+  std::shared_ptr<dwio::common::DecodedVectorCache::SharedLoad> sharedLoad_;
+  // Reads the current split with 'sharedScanSpec_' if this scan reads it for
+  // other scans. Set until the end of the split, also after 'sharedLoad_' is
+  // abandoned.
+  std::unique_ptr<dwio::common::RowReader> sharedRowReader_;
+  VectorPtr sharedOutput_;
+  // The bytes of the copies added to 'sharedLoad_'.
+  uint64_t sharedLoadBytes_{0};
+  // The index in 'sharedLoad_' of the next batch and the number of rows in
+  // the batches before it.
+  size_t nextSharedBatch_{0};
+  uint64_t sharedRowsScanned_{0};
+  // Reusable memory for applying the filters to a shared batch.
+  SelectivityVector sharedRows_;
+
+  // Number of splits read from the batches read by another scan.
+  uint64_t numSharedScanSplits_{0};
+
+  // Number of splits skipped by 'fileStatistics_' without opening the file.
+  uint64_t numSplitsSkippedByFileStatistics_{0};
+
+  // Maximum number of parts a split is divided into. 1 means splits are read
+  // whole.
+  int32_t maxSplitParts_{1};
+
+  // The parts of the current split that are to be read by other drivers.
+  std::vector<std::shared_ptr<ConnectorSplit>> splitParts_;
+
+  // The most output rows that are still needed, if set by
+  // setRemainingLimit().
+  std::optional<uint64_t> remainingLimit_;
+
+  // True if a filter was added by addDynamicFilter(). A split prepared by
+  // another data source is then tested again against the file statistics.
+  bool hasDynamicFilters_{false};
+
+  // The filter measurements of the scans of the table or nullptr if they are
+  // not kept. 'scanSpec_' starts with these and adds to them after each split.
+  FilterSelectivityStore* const filterSelectivity_;
+  std::string tableName_;
+  FilterSelectivityStore::Baseline filterSelectivityBaseline_;
+
+  // Statistics of recently read files or nullptr if not kept. A split is
+  // skipped before opening its file if these show that no row passes the
+  // filters.
+  FileStatisticsCache* const fileStatistics_;
 };
 
 } // namespace facebook::velox::connector::hive
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/connectors/hive/SortingWriter.h"
+
+namespace facebook::velox::connector::hive {
+
+SortingWriter::SortingWriter(
+    std::unique_ptr<dwio::common::Writer> writer,
+    const RowTypePtr& inputType,
+    const std::vector<column_index_t>& sortColumnIndices,
+    const std::vector<CompareFlags>& sortCompareFlags,
+    uint32_t maxOutputRows,
+    std::shared_ptr<memory::MemoryPool> pool,
+    std::optional<exec::SpillConfig> spillConfig)
+    : writer_(std::move(writer)),
+      pool_(std::move(pool)),
+      spillConfig_(std::move(spillConfig)),
+      sortBuffer_(std::make_unique<exec::SortBuffer>(
+          inputType,
+          sortColumnIndices,
+          sortCompareFlags,
+          maxOutputRows,
+          pool_.get(),
+          &nonReclaimableSection_,
+          spillConfig_.has_value() ? &spillConfig_.value() : nullptr)) {
+  VELOX_CHECK_NOT_NULL(writer_);
+}
+
+void SortingWriter::write(const VectorPtr& data) {
+  VELOX_CHECK_NOT_NULL(sortBuffer_, "Sorting writer is closed");
+  auto input = std::dynamic_pointer_cast<RowVector>(data);
+  VELOX_CHECK_NOT_NULL(input, "Sorting writer expects a row vector");
+  sortBuffer_->addInput(input);
+}
+
+void SortingWriter::flush() {
+  VELOX_CHECK_NOT_NULL(sortBuffer_, "Sorting writer is closed");
+  if (spillConfig_.has_value()) {
+    sortBuffer_->spill(0, 0);
+  }
+}
+
+void SortingWriter::close() {
+  VELOX_CHECK_NOT_NULL(sortBuffer_, "Sorting writer is closed");
+  sortBuffer_->noMoreInput();
+  while (auto output = sortBuffer_->getOutput()) {
+    writer_->write(output);
+  }
+  writer_->close();
+  sortBuffer_.reset();
+}
+
+void SortingWriter::abort() {
+  sortBuffer_.reset();
+  writer_->abort();
+}
+
+} // namespace facebook::velox::connector::hive
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/dwio/common/Writer.h"
+#include "velox/exec/SortBuffer.h"
+
+namespace facebook::velox::connector::hive {
+
+/// Wraps a file writer to write the rows in sort order. The rows are
+/// accumulated in a SortBuffer which spills to disk if 'spillConfig' is set
+/// and it runs short of memory. The sorted rows are passed to the wrapped
+/// writer on close().
+class SortingWriter : public dwio::common::Writer {
+ public:
+  /// @param pool Leaf memory pool for the buffered rows.
+  /// @param spillConfig If set, its 'filePath' must be unique to this writer.
+  SortingWriter(
+      std::unique_ptr<dwio::common::Writer> writer,
+      const RowTypePtr& inputType,
+      const std::vector<column_index_t>& sortColumnIndices,
+      const std::vector<CompareFlags>& sortCompareFlags,
+      uint32_t maxOutputRows,
+      std::shared_ptr<memory::MemoryPool> pool,
+      std::optional<exec::SpillConfig> spillConfig);
+
+  void write(const VectorPtr& data) override;
+
+  /// Spills the buffered rows to release memory if spilling is enabled,
+  /// otherwise no-op. No row can be written before all the rows are seen.
+  void flush() override;
+
+  /// Sorts the buffered rows, writes them out and closes the wrapped writer.
+  void close() override;
+
+  void abort() override;
+
+ private:
+  const std::unique_ptr<dwio::common::Writer> writer_;
+  const std::shared_ptr<memory::MemoryPool> pool_;
+  const std::optional<exec::SpillConfig> spillConfig_;
+  // Set while 'sortBuffer_' adds input. Nothing reclaims from the sort buffer
+  // but itself, so this is only to satisfy the SortBuffer interface.
+  tsan_atomic<bool> nonReclaimableSection_{false};
+  std::unique_ptr<exec::SortBuffer> sortBuffer_;
+};
+
+} // namespace facebook::velox::connector::hive
@@ -14,8 +14,11 @@
  * limitations under the License.
  */
 #include "velox/connectors/hive/storage_adapters/hdfs/HdfsFileSystem.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <hdfs/hdfs.h>
 #include <mutex>
+#include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/storage_adapters/hdfs/HdfsReadFile.h"
 #include "velox/connectors/hive/storage_adapters/hdfs/HdfsWriteFile.h"
 #include "velox/core/Config.h"
@@ -25,8 +28,18 @@ std::string_view HdfsFileSystem::kScheme("hdfs://");
 
 class HdfsFileSystem::Impl {
  public:
-  // Keep config here for possible use in the future.
   explicit Impl(const Config* config, const HdfsServiceEndpoint& endpoint) {
+    using connector::hive::HiveConfig;
+    const auto readThreads = HiveConfig::hdfsReadThreads(config);
+    if (readThreads > 0) {
+      readExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+          readThreads,
+          std::make_shared<folly::NamedThreadFactory>("HdfsRead"));
+      readOptions_.executor = readExecutor_.get();
+      readOptions_.hedgedReads = HiveConfig::hdfsHedgedReadsEnabled(config);
+      readOptions_.minHedgeDelay =
+          std::chrono::milliseconds(HiveConfig::hdfsMinHedgeDelayMs(config));
+    }
     auto builder = hdfsNewBuilder();
     hdfsBuilderSetNameNode(builder, endpoint.host.c_str());
     hdfsBuilderSetNameNodePort(builder, atoi(endpoint.port.data()));
@@ -39,6 +52,9 @@ class HdfsFileSystem::Impl {
   }
 
   ~Impl() {
+    if (readExecutor_ != nullptr) {
+      readExecutor_->join();
+    }
     LOG(INFO) << "Disconnecting HDFS file system";
     int disconnectResult = hdfsDisconnect(hdfsClient_);
     if (disconnectResult != 0) {
@@ -51,8 +67,15 @@ class HdfsFileSystem::Impl {
     return hdfsClient_;
   }
 
+  const HdfsReadOptions& readOptions() const {
+    return readOptions_;
+  }
+
  private:
   hdfsFS hdfsClient_;
+  // Runs async and hedged reads if hive.hdfs.read-threads > 0.
+  std::unique_ptr<folly::CPUThreadPoolExecutor> readExecutor_;
+  HdfsReadOptions readOptions_;
 };
 
 HdfsFileSystem::HdfsFileSystem(
@@ -76,7 +99,8 @@ std::unique_ptr<ReadFile> HdfsFileSystem::openFileForRead(
     path.remove_prefix(index);
   }
 
-  return std::make_unique<HdfsReadFile>(impl_->hdfsClient(), path);
+  return std::make_unique<HdfsReadFile>(
+      impl_->hdfsClient(), path, impl_->readOptions());
 }
 
 std::unique_ptr<WriteFile> HdfsFileSystem::openFileForWrite(
@@ -15,13 +15,18 @@
  */
 
 #include "HdfsReadFile.h"
+#include <folly/futures/Future.h>
 #include <folly/synchronization/CallOnce.h>
 #include <hdfs/hdfs.h>
+#include "velox/common/time/Timer.h"
 
 namespace facebook::velox {
 
-HdfsReadFile::HdfsReadFile(hdfsFS hdfs, const std::string_view path)
-    : hdfsClient_(hdfs), filePath_(path) {
+HdfsReadFile::HdfsReadFile(
+    hdfsFS hdfs,
+    const std::string_view path,
+    HdfsReadOptions options)
+    : hdfsClient_(hdfs), filePath_(path), options_(options) {
   fileInfo_ = hdfsGetPathInfo(hdfsClient_, filePath_.data());
   VELOX_CHECK_NOT_NULL(
       fileInfo_,
@@ -33,33 +38,138 @@ HdfsReadFile::HdfsReadFile(hdfsFS hdfs, const std::string_view path)
 void HdfsReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
     const {
   checkFileReadParameters(offset, length);
-  auto file = hdfsOpenFile(hdfsClient_, filePath_.data(), O_RDONLY, 0, 0, 0);
+  if (!options_.hedgedReads || options_.executor == nullptr) {
+    readRange(offset, length, pos);
+    return;
+  }
+  // Both reads go to buffers of their own since the one that loses keeps
+  // running after this returns.
+  auto primary = readRangeAsync(offset, length);
+  primary.wait(hedgeDelay());
+  std::shared_ptr<std::string> data;
+  if (primary.isReady()) {
+    data = std::move(primary).get();
+  } else {
+    // Each read opens the file, so the hedge gets a new block reader. A
+    // DataNode the primary is stuck on is likely to be avoided.
+    ++numHedgedReads_;
+    std::vector<folly::SemiFuture<std::shared_ptr<std::string>>> reads;
+    reads.push_back(std::move(primary));
+    reads.push_back(readRangeAsync(offset, length));
+    auto [index, result] =
+        folly::collectAnyWithoutException(std::move(reads)).get();
+    if (index == 1) {
+      ++numHedgeWins_;
+    }
+    data = std::move(result);
+  }
+  memcpy(pos, data->data(), length);
+}
+
+folly::SemiFuture<std::shared_ptr<std::string>> HdfsReadFile::readRangeAsync(
+    uint64_t offset,
+    uint64_t length) const {
+  return folly::via(
+             options_.executor,
+             [hdfsClient = hdfsClient_,
+              filePath = filePath_,
+              latency = readLatency_,
+              offset,
+              length]() {
+               auto data = std::make_shared<std::string>(length, 0);
+               readRange(
+                   hdfsClient,
+                   filePath,
+                   offset,
+                   length,
+                   data->data(),
+                   *latency);
+               return data;
+             })
+      .semi();
+}
+
+std::chrono::microseconds HdfsReadFile::hedgeDelay() const {
+  const std::chrono::microseconds minDelay = options_.minHedgeDelay;
+  if (readLatency_->count() < kMinHedgeSamples) {
+    return minDelay;
+  }
+  return std::max(
+      minDelay,
+      std::chrono::microseconds(readLatency_->percentileMicros(0.95)));
+}
+
+folly::SemiFuture<uint64_t> HdfsReadFile::preadvAsync(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  if (options_.executor == nullptr) {
+    return ReadFile::preadvAsync(offset, buffers);
+  }
+  // Reads without hedging. A hedge would wait on the executor from a thread
+  // of the executor.
+  return folly::via(
+             options_.executor,
+             [this, offset, buffers]() {
+               auto position = offset;
+               for (const auto& range : buffers) {
+                 if (range.data() != nullptr) {
+                   checkFileReadParameters(position, range.size());
+                   readRange(position, range.size(), range.data());
+                 }
+                 position += range.size();
+               }
+               return position - offset;
+             })
+      .semi();
+}
+
+void HdfsReadFile::readRange(uint64_t offset, uint64_t length, char* pos)
+    const {
+  readRange(hdfsClient_, filePath_, offset, length, pos, *readLatency_);
+}
+
+// static
+void HdfsReadFile::readRange(
+    hdfsFS hdfsClient,
+    const std::string& filePath,
+    uint64_t offset,
+    uint64_t length,
+    char* pos,
+    dwio::common::IoLatencyHistogram& latency) {
+  const auto startMicros = getCurrentTimeMicro();
+  auto file = hdfsOpenFile(hdfsClient, filePath.data(), O_RDONLY, 0, 0, 0);
   VELOX_CHECK_NOT_NULL(
       file,
       "Unable to open file {}. got error: {}",
-      filePath_,
+      filePath,
       hdfsGetLastError());
-  seekToPosition(file, offset);
+  seekToPosition(hdfsClient, file, filePath, offset);
   uint64_t totalBytesRead = 0;
   while (totalBytesRead < length) {
-    auto bytesRead = hdfsRead(hdfsClient_, file, pos, length - totalBytesRead);
+    auto bytesRead = hdfsRead(hdfsClient, file, pos, length - totalBytesRead);
     VELOX_CHECK(bytesRead >= 0, "Read failure in HDFSReadFile::preadInternal.")
     totalBytesRead += bytesRead;
     pos += bytesRead;
   }
 
-  if (hdfsCloseFile(hdfsClient_, file) == -1) {
+  if (hdfsCloseFile(hdfsClient, file) == -1) {
     LOG(ERROR) << "Unable to close file, errno: " << errno;
   }
+  latency.add(getCurrentTimeMicro() - startMicros);
 }
 
-void HdfsReadFile::seekToPosition(hdfsFile file, uint64_t offset) const {
-  auto seekStatus = hdfsSeek(hdfsClient_, file, offset);
+// static
+void HdfsReadFile::seekToPosition(
+    hdfsFS hdfsClient,
+    hdfsFile file,
+    const std::string& filePath,
+    uint64_t offset) {
+  auto seekStatus = hdfsSeek(hdfsClient, file, offset);
   VELOX_CHECK_EQ(
       seekStatus,
       0,
       "Cannot seek through HDFS file: {}, error: {}",
-      filePath_,
+      filePath,
       std::string(hdfsGetLastError()));
 }
 
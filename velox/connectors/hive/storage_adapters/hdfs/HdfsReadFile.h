@@ -14,14 +14,36 @@
  * limitations under the License.
  */
 
+#include <folly/Executor.h>
 #include <hdfs/hdfs.h>
+#include <atomic>
+#include <chrono>
 #include "velox/common/file/File.h"
+#include "velox/dwio/common/IoStatistics.h"
 
 namespace facebook::velox {
 
+struct HdfsReadOptions {
+  /// Runs preadvAsync() and hedged reads. If null, reads are synchronous on
+  /// the calling thread.
+  folly::Executor* executor{nullptr};
+
+  /// If true, a read that runs longer than the p95 read latency of the file
+  /// starts a second read of the same range and the first to finish is
+  /// used. Requires 'executor'.
+  bool hedgedReads{false};
+
+  /// Lower bound of the hedge delay. Also the delay until the file has
+  /// enough reads for a percentile.
+  std::chrono::milliseconds minHedgeDelay{50};
+};
+
 class HdfsReadFile final : public ReadFile {
  public:
-  explicit HdfsReadFile(hdfsFS hdfs, std::string_view path);
+  explicit HdfsReadFile(
+      hdfsFS hdfs,
+      std::string_view path,
+      HdfsReadOptions options = {});
 
   std::string_view pread(uint64_t offset, uint64_t length, void* buf)
       const final;
@@ -42,12 +64,67 @@ class HdfsReadFile final : public ReadFile {
     return 72 << 20;
   }
 
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  bool hasPreadvAsync() const final {
+    return options_.executor != nullptr;
+  }
+
+  /// Latencies of the reads from HDFS, including the hedges.
+  const dwio::common::IoLatencyHistogram& readLatency() const {
+    return *readLatency_;
+  }
+
+  /// Number of reads that were hedged.
+  uint64_t numHedgedReads() const {
+    return numHedgedReads_;
+  }
+
+  /// Number of hedged reads where the hedge finished first.
+  uint64_t numHedgeWins() const {
+    return numHedgeWins_;
+  }
+
  private:
+  // Minimum number of reads of the file before the hedge delay is taken from
+  // their latencies.
+  static constexpr uint64_t kMinHedgeSamples = 20;
+
   void preadInternal(uint64_t offset, uint64_t length, char* pos) const;
-  void seekToPosition(hdfsFile file, uint64_t offset) const;
+
+  // Reads the range with its own open of the file and records the latency.
+  void readRange(uint64_t offset, uint64_t length, char* pos) const;
+
+  // Reads the range on 'options_.executor' into a new buffer. Does not
+  // reference 'this', so that a hedged read that lost may outlive it.
+  folly::SemiFuture<std::shared_ptr<std::string>> readRangeAsync(
+      uint64_t offset,
+      uint64_t length) const;
+
+  std::chrono::microseconds hedgeDelay() const;
+
+  static void seekToPosition(
+      hdfsFS hdfsClient,
+      hdfsFile file,
+      const std::string& filePath,
+      uint64_t offset);
   void checkFileReadParameters(uint64_t offset, uint64_t length) const;
+  static void readRange(
+      hdfsFS hdfsClient,
+      const std::string& filePath,
+      uint64_t offset,
+      uint64_t length,
+      char* pos,
+      dwio::common::IoLatencyHistogram& latency);
   hdfsFS hdfsClient_;
   hdfsFileInfo* fileInfo_;
   std::string filePath_;
+  const HdfsReadOptions options_;
+  const std::shared_ptr<dwio::common::IoLatencyHistogram> readLatency_{
+      std::make_shared<dwio::common::IoLatencyHistogram>()};
+  mutable std::atomic<uint64_t> numHedgedReads_{0};
+  mutable std::atomic<uint64_t> numHedgeWins_{0};
 };
 } // namespace facebook::velox
@@ -15,6 +15,7 @@
  */
 #include "velox/connectors/hive/storage_adapters/hdfs/HdfsFileSystem.h"
 #include <boost/format.hpp>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <connectors/hive/storage_adapters/hdfs/HdfsReadFile.h>
 #include <connectors/hive/storage_adapters/hdfs/RegisterHdfsFileSystem.h>
 #include <gmock/gmock-matchers.h>
@@ -175,6 +176,38 @@ TEST_F(HdfsFileSystemTest, read) {
   readData(&readFile);
 }
 
+TEST_F(HdfsFileSystemTest, asyncAndHedgedReads) {
+  struct hdfsBuilder* builder = hdfsNewBuilder();
+  hdfsBuilderSetNameNode(builder, localhost.c_str());
+  hdfsBuilderSetNameNodePort(builder, 7878);
+  auto hdfs = hdfsBuilderConnect(builder);
+  folly::CPUThreadPoolExecutor executor(4);
+  // Every read is hedged with no delay.
+  HdfsReadFile readFile(
+      hdfs,
+      destinationPath,
+      {.executor = &executor,
+       .hedgedReads = true,
+       .minHedgeDelay = std::chrono::milliseconds(0)});
+  ASSERT_TRUE(readFile.hasPreadvAsync());
+  readData(&readFile);
+  ASSERT_GT(readFile.numHedgedReads(), 0);
+  ASSERT_LE(readFile.numHedgeWins(), readFile.numHedgedReads());
+  ASSERT_GE(readFile.readLatency().count(), readFile.numHedgedReads());
+
+  char head[12];
+  char tail[7];
+  std::vector<folly::Range<char*>> buffers = {
+      folly::Range<char*>(head, sizeof(head)),
+      folly::Range<char*>(
+          nullptr, (char*)(uint64_t)(15 + kOneMB - sizeof(head) - sizeof(tail))),
+      folly::Range<char*>(tail, sizeof(tail))};
+  ASSERT_EQ(15 + kOneMB, readFile.preadvAsync(0, buffers).get());
+  ASSERT_EQ(std::string_view(head, sizeof(head)), "aaaaabbbbbcc");
+  ASSERT_EQ(std::string_view(tail, sizeof(tail)), "ccddddd");
+  executor.join();
+}
+
 TEST_F(HdfsFileSystemTest, viaFileSystem) {
   auto memConfig = std::make_shared<const core::MemConfig>(configurationValues);
   auto hdfsFileSystem =
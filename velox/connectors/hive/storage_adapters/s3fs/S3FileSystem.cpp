@@ -21,8 +21,11 @@
 #include "velox/core/Config.h"
 
 #include <fmt/format.h>
+#include <folly/futures/Future.h>
 #include <glog/logging.h>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 
 #include <aws/core/Aws.h>
@@ -30,10 +33,18 @@
 #include <aws/core/http/HttpResponse.h>
 #include <aws/core/utils/logging/ConsoleLogSystem.h>
 #include <aws/core/utils/stream/PreallocatedStreamBuf.h>
+#include <aws/core/utils/threading/Executor.h>
 #include <aws/identity-management/auth/STSAssumeRoleCredentialsProvider.h>
 #include <aws/s3/S3Client.h>
+#include <aws/s3/model/AbortMultipartUploadRequest.h>
+#include <aws/s3/model/CompleteMultipartUploadRequest.h>
+#include <aws/s3/model/CompletedMultipartUpload.h>
+#include <aws/s3/model/CompletedPart.h>
+#include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/HeadObjectRequest.h>
+#include <aws/s3/model/PutObjectRequest.h>
+#include <aws/s3/model/UploadPartRequest.h>
 
 namespace facebook::velox {
 namespace {
@@ -62,8 +73,11 @@ Aws::IOStreamFactory AwsWriteableStreamFactory(void* data, int64_t nbytes) {
 
 class S3ReadFile final : public ReadFile {
  public:
-  S3ReadFile(const std::string& path, Aws::S3::S3Client* client)
-      : client_(client) {
+  S3ReadFile(
+      const std::string& path,
+      Aws::S3::S3Client* client,
+      uint64_t partSize)
+      : client_(client), partSize_(partSize) {
     bucketAndKeyFromS3Path(path, bucket_, key_);
   }
 
@@ -102,27 +116,41 @@ class S3ReadFile final : public ReadFile {
   uint64_t preadv(
       uint64_t offset,
       const std::vector<folly::Range<char*>>& buffers) const override {
+    return preadvAsync(offset, buffers).get();
+  }
+
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const override {
     // 'buffers' contains Ranges(data, size)  with some gaps (data = nullptr) in
     // between. This call must populate the ranges (except gap ranges)
     // sequentially starting from 'offset'. AWS S3 GetObject does not support
     // multi-range. AWS S3 also charges by number of read requests and not size.
-    // The idea here is to use a single read spanning all the ranges and then
-    // populate individual ranges. We pre-allocate a buffer to support this.
+    // The idea here is to read the span of all the ranges in as few requests
+    // as the part size allows and then populate individual ranges. We
+    // pre-allocate a buffer to support this.
     size_t length = 0;
     for (const auto range : buffers) {
       length += range.size();
     }
     // TODO: allocate from a memory pool
-    std::string result(length, 0);
-    preadInternal(offset, length, static_cast<char*>(result.data()));
-    size_t resultOffset = 0;
-    for (auto range : buffers) {
-      if (range.data()) {
-        memcpy(range.data(), &(result.data()[resultOffset]), range.size());
-      }
-      resultOffset += range.size();
-    }
-    return length;
+    auto result = std::make_shared<std::string>(length, 0);
+    return readParts(offset, length, result->data(), result)
+        .deferValue([result, buffers, length](auto&& /*unused*/) {
+          size_t resultOffset = 0;
+          for (auto range : buffers) {
+            if (range.data()) {
+              memcpy(
+                  range.data(), result->data() + resultOffset, range.size());
+            }
+            resultOffset += range.size();
+          }
+          return static_cast<uint64_t>(length);
+        });
+  }
+
+  bool hasPreadvAsync() const override {
+    return true;
   }
 
   uint64_t size() const override {
@@ -151,10 +179,19 @@ class S3ReadFile final : public ReadFile {
   // The assumption here is that "position" has space for at least "length"
   // bytes.
   void preadInternal(uint64_t offset, uint64_t length, char* position) const {
+    if (length > partSize_) {
+      readParts(offset, length, position, nullptr).get();
+      return;
+    }
     // Read the desired range of bytes.
-    Aws::S3::Model::GetObjectRequest request;
-    Aws::S3::Model::GetObjectResult result;
+    auto request = makeGetObjectRequest(offset, length, position);
+    auto outcome = client_->GetObject(request);
+    VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to get S3 object", bucket_, key_);
+  }
 
+  Aws::S3::Model::GetObjectRequest
+  makeGetObjectRequest(uint64_t offset, uint64_t length, char* position) const {
+    Aws::S3::Model::GetObjectRequest request;
     request.SetBucket(awsString(bucket_));
     request.SetKey(awsString(key_));
     std::stringstream ss;
@@ -162,16 +199,274 @@ class S3ReadFile final : public ReadFile {
     request.SetRange(awsString(ss.str()));
     request.SetResponseStreamFactory(
         AwsWriteableStreamFactory(position, length));
-    auto outcome = client_->GetObject(request);
-    VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to get S3 object", bucket_, key_);
+    return request;
+  }
+
+  // Reads 'length' bytes at 'offset' into 'position' with one ranged GET per
+  // 'partSize_' bytes. The GETs run in parallel on the executor of
+  // 'client_'. The result is ready when all GETs are done, also if some
+  // fail, so that none writes to 'position' after that. 'keepAlive' is held
+  // until then.
+  folly::SemiFuture<folly::Unit> readParts(
+      uint64_t offset,
+      uint64_t length,
+      char* position,
+      std::shared_ptr<void> keepAlive) const {
+    std::vector<folly::SemiFuture<folly::Unit>> parts;
+    for (uint64_t partOffset = 0; partOffset < length;
+         partOffset += partSize_) {
+      const auto partLength = std::min(partSize_, length - partOffset);
+      auto [promise, future] = folly::makePromiseContract<folly::Unit>();
+      auto sharedPromise =
+          std::make_shared<folly::Promise<folly::Unit>>(std::move(promise));
+      client_->GetObjectAsync(
+          makeGetObjectRequest(
+              offset + partOffset, partLength, position + partOffset),
+          [sharedPromise, keepAlive, bucket = bucket_, key = key_](
+              const Aws::S3::S3Client* /*client*/,
+              const Aws::S3::Model::GetObjectRequest& /*request*/,
+              auto outcome,
+              const auto& /*context*/) {
+            try {
+              VELOX_CHECK_AWS_OUTCOME(
+                  outcome, "Failed to get S3 object", bucket, key);
+              sharedPromise->setValue();
+            } catch (const std::exception& e) {
+              sharedPromise->setException(
+                  folly::exception_wrapper(std::current_exception(), e));
+            }
+          });
+      parts.push_back(std::move(future));
+    }
+    return folly::collectAll(std::move(parts))
+        .deferValue([](std::vector<folly::Try<folly::Unit>>&& results) {
+          for (auto& result : results) {
+            result.throwUnlessValue();
+          }
+        });
   }
 
   Aws::S3::S3Client* client_;
+  const uint64_t partSize_;
   std::string bucket_;
   std::string key_;
   int64_t length_ = -1;
 };
 
+// Writes an S3 object with a multipart upload. Appended data is buffered
+// until it fills a part, which is then uploaded asynchronously on the
+// executor of the client while the next part is being filled. At most
+// 'maxPartsInFlight' parts are buffered, so a writer that is faster than the
+// network waits in append(). A file that is smaller than a part is written
+// with a single PutObject at close(). The object becomes visible at close().
+class S3WriteFile final : public WriteFile {
+ public:
+  S3WriteFile(
+      const std::string& path,
+      Aws::S3::S3Client* client,
+      uint64_t partSize,
+      int32_t maxPartsInFlight)
+      : client_(client),
+        partSize_(partSize),
+        maxPartsInFlight_(maxPartsInFlight) {
+    VELOX_CHECK_GE(partSize_, kMinPartSize, "S3 parts must be at least 5MB");
+    VELOX_CHECK_GT(maxPartsInFlight_, 0);
+    bucketAndKeyFromS3Path(path, bucket_, key_);
+    currentPart_.reserve(partSize_);
+  }
+
+  ~S3WriteFile() override {
+    if (closed_ || uploadId_.empty()) {
+      return;
+    }
+    // Not closed, e.g. because the writer failed. Do not leave the uploaded
+    // parts behind.
+    try {
+      abort();
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Failed to abort upload of " << getName() << ": "
+                   << e.what();
+    }
+  }
+
+  void append(std::string_view data) override {
+    VELOX_CHECK(!closed_, "Append to closed S3 file {}", getName());
+    size_ += data.size();
+    while (!data.empty()) {
+      const auto appendSize =
+          std::min<uint64_t>(data.size(), partSize_ - currentPart_.size());
+      currentPart_.append(data.data(), appendSize);
+      data.remove_prefix(appendSize);
+      if (currentPart_.size() == partSize_) {
+        uploadPart();
+      }
+    }
+  }
+
+  // A part smaller than 5MB can only be the last, so data buffered in
+  // 'currentPart_' stays there. Waits for the parts being uploaded.
+  void flush() override {
+    waitForUploads(0);
+  }
+
+  void close() override {
+    if (closed_) {
+      return;
+    }
+    if (uploadId_.empty()) {
+      putObject();
+      closed_ = true;
+      return;
+    }
+    if (!currentPart_.empty()) {
+      uploadPart();
+    }
+    waitForUploads(0);
+    Aws::S3::Model::CompletedMultipartUpload upload;
+    upload.SetParts(completedParts_);
+    Aws::S3::Model::CompleteMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    request.SetMultipartUpload(std::move(upload));
+    auto outcome = client_->CompleteMultipartUpload(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to complete multipart upload", bucket_, key_);
+    closed_ = true;
+  }
+
+  uint64_t size() const override {
+    return size_;
+  }
+
+ private:
+  // Minimum size of all but the last part of a multipart upload.
+  static constexpr uint64_t kMinPartSize = 5UL << 20;
+
+  std::string getName() const {
+    return fmt::format("s3://{}/{}", bucket_, key_);
+  }
+
+  void putObject() {
+    Aws::S3::Model::PutObjectRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetBody(Aws::MakeShared<StringViewStream>(
+        "", currentPart_.data(), currentPart_.size()));
+    request.SetContentLength(currentPart_.size());
+    auto outcome = client_->PutObject(request);
+    VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to put S3 object", bucket_, key_);
+  }
+
+  // Starts the upload of 'currentPart_' and starts a new part. Creates the
+  // multipart upload on first use.
+  void uploadPart() {
+    if (uploadId_.empty()) {
+      Aws::S3::Model::CreateMultipartUploadRequest request;
+      request.SetBucket(awsString(bucket_));
+      request.SetKey(awsString(key_));
+      auto outcome = client_->CreateMultipartUpload(request);
+      VELOX_CHECK_AWS_OUTCOME(
+          outcome, "Failed to create multipart upload", bucket_, key_);
+      uploadId_ = outcome.GetResult().GetUploadId();
+    }
+    waitForUploads(maxPartsInFlight_ - 1);
+
+    auto part = std::make_shared<std::string>(std::move(currentPart_));
+    currentPart_ = std::string();
+    currentPart_.reserve(partSize_);
+    int32_t partNumber;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      partNumber = completedParts_.size() + 1;
+      completedParts_.emplace_back();
+      completedParts_.back().SetPartNumber(partNumber);
+      ++numPartsInFlight_;
+    }
+
+    Aws::S3::Model::UploadPartRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    request.SetPartNumber(partNumber);
+    request.SetBody(
+        Aws::MakeShared<StringViewStream>("", part->data(), part->size()));
+    request.SetContentLength(part->size());
+    client_->UploadPartAsync(
+        request,
+        [this, part, partNumber](
+            const Aws::S3::S3Client* /*client*/,
+            const Aws::S3::Model::UploadPartRequest& /*request*/,
+            auto outcome,
+            const auto& /*context*/) {
+          std::lock_guard<std::mutex> l(mutex_);
+          if (outcome.IsSuccess()) {
+            completedParts_[partNumber - 1].SetETag(
+                outcome.GetResult().GetETag());
+          } else if (error_.empty()) {
+            error_ = outcome.GetError().GetMessage();
+          }
+          --numPartsInFlight_;
+          partUploaded_.notify_all();
+        });
+  }
+
+  // Waits until at most 'maxInFlight' parts are being uploaded. Aborts the
+  // upload and throws if a part failed.
+  void waitForUploads(int32_t maxInFlight) {
+    std::string error;
+    {
+      std::unique_lock<std::mutex> l(mutex_);
+      partUploaded_.wait(l, [&]() {
+        return numPartsInFlight_ <= maxInFlight ||
+            (!error_.empty() && numPartsInFlight_ == 0);
+      });
+      error = error_;
+    }
+    if (!error.empty()) {
+      abort();
+      VELOX_FAIL("Failed to upload part of {}: {}", getName(), error);
+    }
+  }
+
+  // Waits for the parts being uploaded and aborts the multipart upload.
+  void abort() {
+    {
+      std::unique_lock<std::mutex> l(mutex_);
+      partUploaded_.wait(l, [&]() { return numPartsInFlight_ == 0; });
+    }
+    closed_ = true;
+    Aws::S3::Model::AbortMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    auto outcome = client_->AbortMultipartUpload(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to abort multipart upload", bucket_, key_);
+  }
+
+  Aws::S3::S3Client* const client_;
+  const uint64_t partSize_;
+  const int32_t maxPartsInFlight_;
+  std::string bucket_;
+  std::string key_;
+  Aws::String uploadId_;
+  // Data appended since the last part was uploaded.
+  std::string currentPart_;
+  uint64_t size_{0};
+  bool closed_{false};
+
+  // Serializes the upload callbacks with the writer.
+  std::mutex mutex_;
+  std::condition_variable partUploaded_;
+  int32_t numPartsInFlight_{0};
+  // Part number and ETag of the uploaded parts, 1:1 to the part numbers. The
+  // ETag is set when the upload completes.
+  Aws::Vector<Aws::S3::Model::CompletedPart> completedParts_;
+  // The error of the first failed part upload, if any.
+  std::string error_;
+};
+
 Aws::Utils::Logging::LogLevel inferS3LogLevel(std::string level) {
   // Convert to upper case.
   std::transform(
@@ -299,6 +594,14 @@ class S3FileSystem::Impl {
 
     clientConfig.endpointOverride = HiveConfig::s3Endpoint(config_);
 
+    // The async GETs of S3ReadFile run on this pool. The default executor
+    // starts a thread per request.
+    const auto maxConcurrentReads = HiveConfig::s3MaxConcurrentReads(config_);
+    clientConfig.maxConnections = maxConcurrentReads;
+    clientConfig.executor =
+        std::make_shared<Aws::Utils::Threading::PooledThreadExecutor>(
+            maxConcurrentReads);
+
     if (HiveConfig::s3UseSSL(config_)) {
       clientConfig.scheme = Aws::Http::Scheme::HTTPS;
     } else {
@@ -321,6 +624,18 @@ class S3FileSystem::Impl {
     return client_.get();
   }
 
+  uint64_t readPartSize() const {
+    return HiveConfig::s3ReadPartSize(config_);
+  }
+
+  uint64_t writePartSize() const {
+    return HiveConfig::s3WritePartSize(config_);
+  }
+
+  int32_t maxWritePartsInFlight() const {
+    return HiveConfig::s3MaxWritePartsInFlight(config_);
+  }
+
   std::string getLogLevelName() const {
     return GetLogLevelName(inferS3LogLevel(HiveConfig::s3GetLogLevel(config_)));
   }
@@ -350,7 +665,8 @@ std::unique_ptr<ReadFile> S3FileSystem::openFileForRead(
     std::string_view path,
     const FileOptions& /*unused*/) {
   const std::string file = s3Path(path);
-  auto s3file = std::make_unique<S3ReadFile>(file, impl_->s3Client());
+  auto s3file = std::make_unique<S3ReadFile>(
+      file, impl_->s3Client(), impl_->readPartSize());
   s3file->initialize();
   return s3file;
 }
@@ -358,7 +674,12 @@ std::unique_ptr<ReadFile> S3FileSystem::openFileForRead(
 std::unique_ptr<WriteFile> S3FileSystem::openFileForWrite(
     std::string_view path,
     const FileOptions& /*unused*/) {
-  VELOX_NYI();
+  const std::string file = s3Path(path);
+  return std::make_unique<S3WriteFile>(
+      file,
+      impl_->s3Client(),
+      impl_->writePartSize(),
+      impl_->maxWritePartsInFlight());
 }
 
 std::string S3FileSystem::name() const {
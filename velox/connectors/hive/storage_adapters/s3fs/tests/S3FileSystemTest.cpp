@@ -119,6 +119,78 @@ TEST_F(S3FileSystemTest, writeAndRead) {
   readData(readFile.get());
 }
 
+TEST_F(S3FileSystemTest, readInParts) {
+  const char* bucketName = "data-parts";
+  const char* file = "test.txt";
+  const std::string filename = localPath(bucketName) + "/" + file;
+  const std::string s3File = s3URI(bucketName, file);
+  addBucket(bucketName);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  // Reads of more than 100KB are split into parallel ranged GETs.
+  auto hiveConfig =
+      minioServer_->hiveConfig({{"hive.s3.read-part-size", "100000"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+  auto readFile = s3fs.openFileForRead(s3File);
+  ASSERT_TRUE(readFile->hasPreadvAsync());
+  readData(readFile.get());
+
+  char head[12];
+  char tail[7];
+  std::vector<folly::Range<char*>> buffers = {
+      folly::Range<char*>(head, sizeof(head)),
+      folly::Range<char*>(
+          nullptr, (char*)(uint64_t)(15 + kOneMB - sizeof(head) - sizeof(tail))),
+      folly::Range<char*>(tail, sizeof(tail))};
+  ASSERT_EQ(15 + kOneMB, readFile->preadvAsync(0, buffers).get());
+  ASSERT_EQ(std::string_view(head, sizeof(head)), "aaaaabbbbbcc");
+  ASSERT_EQ(std::string_view(tail, sizeof(tail)), "ccddddd");
+}
+
+TEST_F(S3FileSystemTest, writeFile) {
+  const char* bucketName = "data-write";
+  addBucket(bucketName);
+  // Two parts in flight of the minimum size.
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.write-part-size", std::to_string(5 * kOneMB)},
+       {"hive.s3.max-write-parts-in-flight", "2"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+
+  // Smaller than a part.
+  const std::string smallFile = s3URI(bucketName, "small.txt");
+  {
+    auto writeFile = s3fs.openFileForWrite(smallFile);
+    writeData(writeFile.get());
+    writeFile->close();
+  }
+  readData(s3fs.openFileForRead(smallFile).get());
+
+  // Five parts, the last one partial, written with appends that cross the
+  // part boundaries.
+  const std::string largeFile = s3URI(bucketName, "large.txt");
+  const uint64_t largeSize = 23 * kOneMB + 123;
+  std::string data(largeSize, 0);
+  for (uint64_t i = 0; i < largeSize; ++i) {
+    data[i] = 'a' + i % 23;
+  }
+  {
+    auto writeFile = s3fs.openFileForWrite(largeFile);
+    const uint64_t kAppendSize = 3 * kOneMB + 17;
+    for (uint64_t offset = 0; offset < largeSize; offset += kAppendSize) {
+      writeFile->append(std::string_view(data).substr(offset, kAppendSize));
+    }
+    ASSERT_EQ(writeFile->size(), largeSize);
+    writeFile->close();
+  }
+  auto readFile = s3fs.openFileForRead(largeFile);
+  ASSERT_EQ(readFile->size(), largeSize);
+  ASSERT_EQ(readFile->pread(0, largeSize), data);
+}
+
 TEST_F(S3FileSystemTest, viaRegistry) {
   const char* bucketName = "data2";
   const char* file = "test.txt";
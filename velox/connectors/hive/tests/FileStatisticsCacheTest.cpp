@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/connectors/hive/FileStatisticsCache.h"
+
+#include "gtest/gtest.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::connector::hive;
+
+namespace {
+
+std::shared_ptr<common::ScanSpec> makeSpec(int64_t lower, int64_t upper) {
+  auto spec = std::make_shared<common::ScanSpec>("root");
+  spec->getOrCreateChild(common::Subfield("c0"))
+      ->setFilter(std::make_unique<common::BigintRange>(lower, upper, false));
+  return spec;
+}
+
+folly::F14FastMap<std::string, FileStatisticsCache::Column> makeColumns(
+    int64_t min,
+    int64_t max) {
+  folly::F14FastMap<std::string, FileStatisticsCache::Column> columns;
+  columns["c0"] = FileStatisticsCache::Column{
+      BIGINT(),
+      std::make_shared<dwio::common::IntegerColumnStatistics>(
+          100, false, std::nullopt, std::nullopt, min, max, std::nullopt)};
+  return columns;
+}
+
+} // namespace
+
+TEST(FileStatisticsCacheTest, mayMatch) {
+  FileStatisticsCache cache(10);
+  std::unordered_map<std::string, std::optional<std::string>> noPartitionKeys;
+  cache.add("f1", 100, makeColumns(0, 10));
+
+  ASSERT_FALSE(cache.mayMatch("f1", *makeSpec(20, 30), noPartitionKeys));
+  ASSERT_TRUE(cache.mayMatch("f1", *makeSpec(5, 6), noPartitionKeys));
+  // Files with no cached statistics are not skipped.
+  ASSERT_TRUE(cache.mayMatch("f2", *makeSpec(20, 30), noPartitionKeys));
+  // Filters on partition keys are not tested against file statistics.
+  std::unordered_map<std::string, std::optional<std::string>> partitionKeys{
+      {"c0", "25"}};
+  ASSERT_TRUE(cache.mayMatch("f1", *makeSpec(20, 30), partitionKeys));
+}
+
+TEST(FileStatisticsCacheTest, replace) {
+  FileStatisticsCache cache(10);
+  std::unordered_map<std::string, std::optional<std::string>> noPartitionKeys;
+  cache.add("f1", 100, makeColumns(0, 10));
+  // A file with a different row count replaces the previous statistics.
+  cache.add("f1", 200, makeColumns(20, 30));
+  ASSERT_TRUE(cache.mayMatch("f1", *makeSpec(20, 30), noPartitionKeys));
+  ASSERT_FALSE(cache.mayMatch("f1", *makeSpec(5, 6), noPartitionKeys));
+}
+
+TEST(FileStatisticsCacheTest, eviction) {
+  FileStatisticsCache cache(1);
+  std::unordered_map<std::string, std::optional<std::string>> noPartitionKeys;
+  cache.add("f1", 100, makeColumns(0, 10));
+  cache.add("f2", 100, makeColumns(0, 10));
+  ASSERT_TRUE(cache.mayMatch("f1", *makeSpec(20, 30), noPartitionKeys));
+  ASSERT_FALSE(cache.mayMatch("f2", *makeSpec(20, 30), noPartitionKeys));
+}
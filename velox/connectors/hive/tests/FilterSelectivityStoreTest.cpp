@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/connectors/hive/FilterSelectivityStore.h"
+
+#include "gtest/gtest.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::connector::hive;
+
+namespace {
+
+std::shared_ptr<common::ScanSpec> makeSpec(int64_t upper) {
+  auto spec = std::make_shared<common::ScanSpec>("root");
+  spec->getOrCreateChild(common::Subfield("c0"))
+      ->setFilter(std::make_unique<common::BigintRange>(0, upper, false));
+  spec->getOrCreateChild(common::Subfield("c1"));
+  return spec;
+}
+
+void measure(common::ScanSpec& column, uint64_t numIn, uint64_t numOut) {
+  {
+    SelectivityTimer timer(column.selectivity(), numIn);
+  }
+  column.selectivity().addOutput(numOut);
+}
+
+} // namespace
+
+TEST(FilterSelectivityStoreTest, history) {
+  FilterSelectivityStore store;
+  FilterSelectivityStore::Baseline baseline;
+  auto spec = makeSpec(10);
+  auto* c0 = spec->childByName("c0");
+  store.initialize("t", *spec, baseline);
+  ASSERT_EQ(c0->selectivity().numIn(), 0);
+  ASSERT_FALSE(store.find("t", *c0).has_value());
+
+  measure(*c0, 100, 10);
+  store.update("t", *spec, baseline);
+  auto history = store.find("t", *c0);
+  ASSERT_TRUE(history.has_value());
+  ASSERT_EQ(history->numIn(), 100);
+  ASSERT_EQ(history->numOut(), 10);
+  // Nothing new was measured.
+  store.update("t", *spec, baseline);
+  ASSERT_EQ(store.find("t", *c0)->numIn(), 100);
+  // A column without a filter has no history.
+  ASSERT_FALSE(store.find("t", *spec->childByName("c1")).has_value());
+
+  // A new scan of the table starts with the history and adds only its own
+  // measurements to it.
+  auto otherSpec = makeSpec(10);
+  auto* otherC0 = otherSpec->childByName("c0");
+  FilterSelectivityStore::Baseline otherBaseline;
+  store.initialize("t", *otherSpec, otherBaseline);
+  ASSERT_EQ(otherC0->selectivity().numIn(), 100);
+  measure(*otherC0, 50, 50);
+  store.update("t", *otherSpec, otherBaseline);
+  ASSERT_EQ(store.find("t", *c0)->numIn(), 150);
+  ASSERT_EQ(store.find("t", *c0)->numOut(), 60);
+
+  // Other tables and other filters on the same column are separate.
+  FilterSelectivityStore::Baseline newBaseline;
+  auto newSpec = makeSpec(20);
+  store.initialize("t", *newSpec, newBaseline);
+  ASSERT_EQ(newSpec->childByName("c0")->selectivity().numIn(), 0);
+  store.initialize("u", *otherSpec, newBaseline);
+  ASSERT_FALSE(store.find("u", *otherC0).has_value());
+}
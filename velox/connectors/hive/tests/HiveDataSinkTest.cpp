@@ -17,7 +17,11 @@
 #include <gtest/gtest.h>
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 
+#include "velox/common/base/Fs.h"
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/core/Config.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 namespace facebook::velox::connector::hive {
 namespace {
@@ -28,6 +32,7 @@ using namespace facebook::velox::exec::test;
 class HiveDataSinkTest : public exec::test::HiveConnectorTestBase {
  protected:
   void SetUp() override {
+    HiveConnectorTestBase::SetUp();
     Type::registerSerDe();
     HiveSortingColumn::registerSerDe();
     HiveBucketProperty::registerSerDe();
@@ -305,5 +310,79 @@ TEST_F(HiveDataSinkTest, hiveBucketProperty) {
     ASSERT_EQ(obj, deserializedProperty->serialize());
   }
 }
+TEST_F(HiveDataSinkTest, reclaimClosesLeastRecentlyWrittenWriter) {
+  const auto rowType = ROW({"c0", "p0"}, {BIGINT(), INTEGER()});
+  auto outputDirectory = TempDirectoryPath::create();
+  auto connectorPool = rootPool_->addAggregateChild("connector");
+  auto operatorPool = rootPool_->addLeafChild("operator");
+  auto connectorConfig = std::make_shared<const core::MemConfig>();
+  ConnectorQueryCtx connectorQueryCtx(
+      operatorPool.get(),
+      connectorPool.get(),
+      connectorConfig.get(),
+      nullptr,
+      nullptr,
+      "query",
+      "task",
+      "planNodeId",
+      0);
+  HiveDataSink dataSink(
+      rowType,
+      makeHiveInsertTableHandle(
+          rowType->names(),
+          rowType->children(),
+          {"p0"},
+          makeLocationHandle(outputDirectory->path)),
+      &connectorQueryCtx,
+      CommitStrategy::kNoCommit,
+      connectorConfig);
+  ASSERT_TRUE(dataSink.canReclaim());
+
+  int64_t nextValue{0};
+  std::vector<RowVectorPtr> batches;
+  auto makeBatch = [&](const std::vector<int32_t>& partitions) {
+    batches.push_back(makeRowVector(
+        rowType->names(),
+        {makeFlatVector<int64_t>(
+             partitions.size(), [&](auto /*row*/) { return nextValue++; }),
+         makeFlatVector<int32_t>(partitions)}));
+    return batches.back();
+  };
+  dataSink.appendData(makeBatch({0, 1, 0, 1}));
+  dataSink.appendData(makeBatch({1, 1}));
+  // Partition 0 is written least recently, so its writer alone is closed to
+  // release one byte.
+  dataSink.reclaim(1);
+  // The rows of partition 0 go to a new file.
+  dataSink.appendData(makeBatch({0, 1}));
+  dataSink.close();
+
+  const auto partitionUpdates = dataSink.finish();
+  ASSERT_EQ(partitionUpdates.size(), 2);
+  for (const auto& partitionUpdate : partitionUpdates) {
+    const auto update = folly::parseJson(partitionUpdate);
+    if (update["name"].asString() == "p0=0") {
+      ASSERT_EQ(update["fileWriteInfos"].size(), 2);
+      ASSERT_EQ(update["rowCount"].asInt(), 3);
+    } else {
+      ASSERT_EQ(update["name"].asString(), "p0=1");
+      ASSERT_EQ(update["fileWriteInfos"].size(), 1);
+      ASSERT_EQ(update["rowCount"].asInt(), 5);
+    }
+  }
+
+  std::vector<std::shared_ptr<ConnectorSplit>> splits;
+  for (const auto& path :
+       fs::recursive_directory_iterator(outputDirectory->path)) {
+    if (path.is_regular_file()) {
+      splits.push_back(makeHiveConnectorSplit(path.path().string()));
+    }
+  }
+  ASSERT_EQ(splits.size(), 3);
+  createDuckDbTable(batches);
+  assertQuery(
+      PlanBuilder().tableScan(rowType).planNode(), splits, "SELECT * FROM tmp");
+}
+
 } // namespace
 } // namespace facebook::velox::connector::hive
@@ -1105,12 +1105,14 @@ WindowNode::WindowNode(
     std::vector<SortOrder> sortingOrders,
     std::vector<std::string> windowColumnNames,
     std::vector<Function> windowFunctions,
+    bool inputsSorted,
     PlanNodePtr source)
     : PlanNode(std::move(id)),
       partitionKeys_(std::move(partitionKeys)),
       sortingKeys_(std::move(sortingKeys)),
       sortingOrders_(std::move(sortingOrders)),
       windowFunctions_(std::move(windowFunctions)),
+      inputsSorted_(inputsSorted),
       sources_{std::move(source)},
       outputType_(getWindowOutputType(
           sources_[0]->outputType(),
@@ -1254,6 +1256,7 @@ folly::dynamic WindowNode::serialize() const {
   for (const auto& function : windowFunctions_) {
     obj["functions"].push_back(function.serialize());
   }
+  obj["inputsSorted"] = inputsSorted_;
 
   auto numInputs = sources()[0]->outputType()->size();
   auto numOutputs = outputType()->size();
@@ -1288,6 +1291,7 @@ PlanNodePtr WindowNode::create(const folly::dynamic& obj, void* context) {
       sortingOrders,
       windowNames,
       functions,
+      obj["inputsSorted"].asBool(),
       source);
 }
 
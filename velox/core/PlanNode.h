@@ -282,10 +282,26 @@ class ArrowStreamNode : public PlanNode {
       const PlanNodeId& id,
       RowTypePtr outputType,
       std::shared_ptr<ArrowArrayStream> arrowStream)
+      : ArrowStreamNode(
+            id,
+            std::move(outputType),
+            std::vector<std::shared_ptr<ArrowArrayStream>>{
+                std::move(arrowStream)}) {}
+
+  /// Reads several streams of the same schema. Each driver of the pipeline
+  /// reads a disjoint subset of the streams, so there are up to
+  /// 'arrowStreams.size()' drivers.
+  ArrowStreamNode(
+      const PlanNodeId& id,
+      RowTypePtr outputType,
+      std::vector<std::shared_ptr<ArrowArrayStream>> arrowStreams)
       : PlanNode(id),
         outputType_(std::move(outputType)),
-        arrowStream_(std::move(arrowStream)) {
-    VELOX_CHECK_NOT_NULL(arrowStream_);
+        arrowStreams_(std::move(arrowStreams)) {
+    VELOX_CHECK(!arrowStreams_.empty());
+    for (const auto& arrowStream : arrowStreams_) {
+      VELOX_CHECK_NOT_NULL(arrowStream);
+    }
   }
 
   const RowTypePtr& outputType() const override {
@@ -295,7 +311,11 @@ class ArrowStreamNode : public PlanNode {
   const std::vector<PlanNodePtr>& sources() const override;
 
   const std::shared_ptr<ArrowArrayStream>& arrowStream() const {
-    return arrowStream_;
+    return arrowStreams_[0];
+  }
+
+  const std::vector<std::shared_ptr<ArrowArrayStream>>& arrowStreams() const {
+    return arrowStreams_;
   }
 
   std::string_view name() const override {
@@ -310,7 +330,7 @@ class ArrowStreamNode : public PlanNode {
   void addDetails(std::stringstream& stream) const override;
 
   const RowTypePtr outputType_;
-  std::shared_ptr<ArrowArrayStream> arrowStream_;
+  const std::vector<std::shared_ptr<ArrowArrayStream>> arrowStreams_;
 };
 
 class FilterNode : public PlanNode {
@@ -820,7 +840,7 @@ class GroupIdNode : public PlanNode {
     return aggregationInputs_;
   }
 
-  const std::string& groupIdName() {
+  const std::string& groupIdName() const {
     return groupIdName_;
   }
 
@@ -961,11 +981,16 @@ class LocalMergeNode : public PlanNode {
 /// Calculates partition number for each row of the specified vector.
 class PartitionFunction {
  public:
+  /// Partition number for a row that goes to all partitions. Used to replicate
+  /// the build side rows of skewed join keys.
+  static constexpr uint32_t kAllPartitions =
+      std::numeric_limits<uint32_t>::max();
+
   virtual ~PartitionFunction() = default;
 
   /// @param input RowVector to split into partitions.
   /// @param [out] partitions Computed partition numbers for each row in
-  /// 'input'.
+  /// 'input'. A row may be assigned 'kAllPartitions'.
   /// @return Returns partition number in case all rows of 'input' are assigned
   /// to the same partition. In this case 'partitions' vector is left unchanged.
   /// Used to optimize round-robin partitioning in local exchange.
@@ -2027,6 +2052,10 @@ class WindowNode : public PlanNode {
   /// @param windowColumnNames specifies the output column
   /// names for each window function column. So
   /// windowColumnNames.length() = windowFunctions.length().
+  /// @param inputsSorted True if the input arrives clustered by the partition
+  /// keys and sorted by the sorting keys within each partition, e.g. from a
+  /// MergeJoin or a LocalMerge. The window is then computed one partition at
+  /// a time as the input arrives instead of after sorting all input.
   WindowNode(
       PlanNodeId id,
       std::vector<FieldAccessTypedExprPtr> partitionKeys,
@@ -2034,6 +2063,7 @@ class WindowNode : public PlanNode {
       std::vector<SortOrder> sortingOrders,
       std::vector<std::string> windowColumnNames,
       std::vector<Function> windowFunctions,
+      bool inputsSorted,
       PlanNodePtr source);
 
   const std::vector<PlanNodePtr>& sources() const override {
@@ -2062,6 +2092,16 @@ class WindowNode : public PlanNode {
     return windowFunctions_;
   }
 
+  bool inputsSorted() const {
+    return inputsSorted_;
+  }
+
+  /// A window over sorted inputs holds one partition at a time and does not
+  /// spill.
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    return !inputsSorted_ && queryConfig.windowSpillEnabled();
+  }
+
   std::string_view name() const override {
     return "Window";
   }
@@ -2080,6 +2120,8 @@ class WindowNode : public PlanNode {
 
   const std::vector<Function> windowFunctions_;
 
+  const bool inputsSorted_;
+
   const std::vector<PlanNodePtr> sources_;
 
   const RowTypePtr outputType_;
@@ -2245,6 +2287,10 @@ class TopNRowNumberNode : public PlanNode {
     return outputType_->size() > sources_[0]->outputType()->size();
   }
 
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    return queryConfig.topNRowNumberSpillEnabled();
+  }
+
   std::string_view name() const override {
     return "TopNRowNumber";
   }
@@ -64,11 +64,63 @@ class QueryConfig {
   static constexpr const char* kExprTrackCpuUsage =
       "expression.track_cpu_usage";
 
+  // Whether to evaluate trees of DOUBLE plus, minus and multiply, optionally
+  // under a comparison, in one pass over the rows without materializing the
+  // results of inner calls. False by default.
+  static constexpr const char* kExprFuseFloatingPointArithmetic =
+      "expression.fuse_floating_point_arithmetic";
+
+  // Whether ExprSets share the rewritten and constant folded form of their
+  // expressions through the process-wide exec::PreparedExprCache. Requires
+  // function registrations not to change while queries run. False by
+  // default.
+  static constexpr const char* kExprPreparedCacheEnabled =
+      "expression.prepared_cache_enabled";
+
   // Whether to track CPU usage for stages of individual operators. True by
   // default. Can be expensive when processing small batches, e.g. < 10K rows.
   static constexpr const char* kOperatorTrackCpuUsage =
       "track_operator_cpu_usage";
 
+  // Whether a Driver that comes back on thread after being blocked continues
+  // from the operator that blocked it instead of walking the pipeline from
+  // the last operator. False by default. Saves the isBlocked() and
+  // needsInput() calls on the operators after the blocked one, which shows
+  // with many small batches, e.g. from exchanges.
+  static constexpr const char* kDriverResumeAtBlockedOperator =
+      "driver_resume_at_blocked_operator";
+
+  // Whether operators size their output batches by the bytes per row
+  // observed in the batches they have produced so far instead of by a
+  // static estimate. False by default. Setting kPreferredOutputBatchBytes to
+  // about the size of the CPU cache keeps the batches of wide and narrow
+  // rows in cache.
+  static constexpr const char* kAdaptiveOutputBatchRows =
+      "adaptive_output_batch_rows";
+
+  // Whether the Drivers of the query are sampled by DriverProfiler. False by
+  // default. The sample counts by operator and expression stack are reported
+  // in OperatorStats::profileSamples.
+  static constexpr const char* kDriverProfilingEnabled =
+      "driver_profiling_enabled";
+
+  // Whether an aggregation over a GroupId, e.g. for ROLLUP or CUBE, first
+  // aggregates its input by all grouping keys so that GroupId replicates
+  // groups instead of input rows. Applies when all aggregates can be split
+  // into partial and final steps. False by default.
+  static constexpr const char* kGroupIdPreAggregation =
+      "group_id_pre_aggregation";
+
+  // The number of batches an ArrowStream source fetches ahead of the driver
+  // on the query executor. 0 fetches each batch synchronously in getOutput.
+  static constexpr const char* kArrowStreamPrefetchDepth =
+      "arrow_stream_prefetch_depth";
+
+  // Whether hash aggregations and hash join builds estimate the number of
+  // distinct values of their keys. The estimates are reported in
+  // OperatorStats::keyNdvSketches. False by default.
+  static constexpr const char* kCollectKeyNdvs = "collect_key_ndvs";
+
   // Flags used to configure the CAST operator:
 
   // This flag makes the Row conversion to by applied in a way that the casting
@@ -85,26 +137,64 @@ class QueryConfig {
   static constexpr const char* kMaxLocalExchangeBufferSize =
       "max_local_exchange_buffer_size";
 
+  /// If true, a local exchange that hash partitions its input attaches the
+  /// hashes of the partitioning keys to its output, and a hash join probe or
+  /// a hash aggregation on the same keys uses them instead of hashing again.
+  static constexpr const char* kLocalExchangeReuseKeyHashes =
+      "local_exchange_reuse_key_hashes";
+
   /// Maximum size in bytes to accumulate in ExchangeQueue. Enforced
   /// approximately, not strictly.
   static constexpr const char* kMaxExchangeBufferSize =
       "exchange.max_buffer_size";
 
+  /// If true, PartitionedOutput keeps dictionary and constant encoded top
+  /// level columns as DICTIONARY and RLE blocks in the pages it produces.
+  static constexpr const char* kExchangePreserveEncodings =
+      "exchange.preserve_encodings";
+
+  /// The compression codec of the pages exchanged between the tasks of a
+  /// query, e.g. "lz4" or "zstd". The producers and the consumers must use the
+  /// same codec.
+  static constexpr const char* kExchangeCompressionKind =
+      "exchange.compression_codec";
+
   static constexpr const char* kMaxPartialAggregationMemory =
       "max_partial_aggregation_memory";
 
   static constexpr const char* kMaxExtendedPartialAggregationMemory =
       "max_extended_partial_aggregation_memory";
 
+  /// If not zero, a final aggregation keeps 2^N hash tables, each holding the
+  /// groups whose key hashes have a given value in N high bits. The input is
+  /// inserted one table at a time, so that each insert works on a table 2^N
+  /// times smaller. Not used with spilling, pre-grouped keys or if there are
+  /// no aggregates.
+  static constexpr const char* kAggregationTablePartitionBits =
+      "aggregation_table_partition_bits";
+
   static constexpr const char* kAbandonPartialAggregationMinRows =
       "abandon_partial_aggregation_min_rows";
 
   static constexpr const char* kAbandonPartialAggregationMinPct =
       "abandon_partial_aggregation_min_pct";
 
+  /// If non-zero, a partial aggregation keeps at most this many groups. When
+  /// there are more, the oldest groups are flushed to the output and removed
+  /// from the table. The table stays small enough to be cache resident and the
+  /// partial aggregation is never abandoned.
+  static constexpr const char* kPartialAggregationMaxGroups =
+      "partial_aggregation_max_groups";
+
   static constexpr const char* kMaxPartitionedOutputBufferSize =
       "max_page_partitioning_buffer_size";
 
+  /// If true, PartitionedOutput enqueues pages that hold the output vectors
+  /// instead of serializing them. This saves the serialization round trip
+  /// when all consumers of the output run in the same process. Such pages
+  /// cannot be sent over the network.
+  static constexpr const char* kInProcessExchange = "in_process_exchange";
+
   /// Preferred size of batches in bytes to be returned by operators from
   /// Operator::getOutput. It is used when an estimate of average row size is
   /// known. Otherwise kPreferredOutputBatchRows is used.
@@ -134,6 +224,12 @@ class QueryConfig {
   static constexpr const char* kAdaptiveFilterReorderingEnabled =
       "adaptive_filter_reordering_enabled";
 
+  /// Number of batches between reorderings of the inputs of a conjunction
+  /// expression. The measurements of the inputs are halved at each reordering
+  /// so that the order follows changes in the data.
+  static constexpr const char* kAdaptiveFilterReorderingInterval =
+      "adaptive_filter_reordering_interval";
+
   /// Global enable spilling flag.
   static constexpr const char* kSpillEnabled = "spill_enabled";
 
@@ -147,11 +243,24 @@ class QueryConfig {
   /// OrderBy spilling flag, only applies if "spill_enabled" flag is set.
   static constexpr const char* kOrderBySpillEnabled = "order_by_spill_enabled";
 
+  /// Window spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kWindowSpillEnabled = "window_spill_enabled";
+
+  /// TopNRowNumber spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kTopNRowNumberSpillEnabled =
+      "topn_row_number_spill_enabled";
+
   /// The max memory that a final aggregation can use before spilling. If it 0,
   /// then there is no limit.
   static constexpr const char* kAggregationSpillMemoryThreshold =
       "aggregation_spill_memory_threshold";
 
+  /// If true, every spill of a final or single aggregation writes out all of
+  /// its groups as one sorted run instead of just enough groups to make room
+  /// for the next input. Suits high cardinality aggregations that are known
+  /// to spill: the output merges fewer, longer runs.
+  static constexpr const char* kAggregationSpillAll = "aggregation_spill_all";
+
   /// The max memory that a hash join can use before spilling. If it 0, then
   /// there is no limit.
   static constexpr const char* kJoinSpillMemoryThreshold =
@@ -188,18 +297,44 @@ class QueryConfig {
   static constexpr const char* kSpillCompressionKind =
       "spill_compression_codec";
 
+  /// The serialization format of spill files: 'presto' for PrestoVectorSerde
+  /// pages or 'compact_row' for CompactRow serialized rows. 'compact_row' is
+  /// cheaper to write and read back but ignores the spill compression codec.
+  static constexpr const char* kSpillFormat = "spill_format";
+
   static constexpr const char* kSpillStartPartitionBit =
       "spiller_start_partition_bit";
 
   static constexpr const char* kJoinSpillPartitionBits =
       "join_spiller_partition_bits";
 
+  /// If true, each recursive hash join spill level uses one more partition bit
+  /// than its parent level, up to 6 bits, so that skewed partitions get split
+  /// further before reaching 'kMaxSpillLevel'.
+  static constexpr const char* kJoinSpillAdaptivePartitionBits =
+      "join_spiller_adaptive_partition_bits";
+
   static constexpr const char* kAggregationSpillPartitionBits =
       "aggregation_spiller_partition_bits";
 
+  /// If true, the hash join build and aggregation spill the partitions with
+  /// the least rows inserted since the previous spill relative to their size
+  /// first, instead of the largest partitions first. The partitions that are
+  /// still being inserted into then stay in memory.
+  static constexpr const char* kSpillColdPartitionsFirst =
+      "spill_cold_partitions_first";
+
   static constexpr const char* kSpillableReservationGrowthPct =
       "spillable_reservation_growth_pct";
 
+  /// If true, spillable operators grow their memory reservation for the next
+  /// input off the driver thread. The driver is blocked with
+  /// BlockingReason::kWaitForMemory while the reservation, including any
+  /// memory arbitration it triggers, is in progress, and its thread runs
+  /// other drivers meanwhile.
+  static constexpr const char* kAsyncMemoryReservationEnabled =
+      "async_memory_reservation_enabled";
+
   /// If true, array_agg() aggregation function will ignore nulls in the input.
   static constexpr const char* kPrestoArrayAggIgnoreNulls =
       "presto.array_agg.ignore_nulls";
@@ -238,6 +373,80 @@ class QueryConfig {
   static constexpr const char* kMinTableRowsForParallelJoinBuild =
       "min_table_rows_for_parallel_join_build";
 
+  /// If true, a hash join build side in kHash mode makes a Bloom filter over
+  /// each integer or string join key and pushes it down into the probe side
+  /// table scan as a dynamic filter.
+  static constexpr const char* kHashJoinBloomFilterEnabled =
+      "hash_join_bloom_filter_enabled";
+
+  /// The max number of build side rows for which the join key Bloom filters
+  /// are made. Each Bloom filter takes about 2 bytes per row.
+  static constexpr const char* kHashJoinBloomFilterMaxRows =
+      "hash_join_bloom_filter_max_rows";
+
+  /// If not zero, a hash join build side samples its join keys and reports the
+  /// keys having at least this percentage of the build side rows as hot keys.
+  /// The hashes of these keys can be given to a skewed HashPartitionFunction to
+  /// replicate or spread them across partitions.
+  static constexpr const char* kHashJoinHotKeyRowsPct =
+      "hash_join_hot_key_rows_pct";
+
+  /// If not empty, hash join build side tables are cached across queries
+  /// under this key combined with the join type, the build keys and the build
+  /// side plan. The caller must put into the key whatever identifies the build
+  /// side data beyond the plan, e.g. the table snapshot or split set, so that
+  /// equal keys mean equal tables. Joins with spilling or null-aware semantics
+  /// are not cached.
+  static constexpr const char* kHashJoinTableCacheKey =
+      "hash_join_table_cache_key";
+
+  /// If true, the drivers of a partial OrderBy that feeds a LocalMerge divide
+  /// the sorted rows into key ranges, one per driver, when all of them have
+  /// sorted their input. Each driver then merges and returns the rows of its
+  /// range, and the LocalMerge concatenates the ranges in order instead of
+  /// merging all rows on one thread. Does not apply if an OrderBy driver
+  /// spilled.
+  static constexpr const char* kParallelOrderByEnabled =
+      "parallel_order_by_enabled";
+
+  /// The number of splits per driver of a table scan that are opened ahead
+  /// of being read. Opening a split creates its reader in the background on
+  /// the connector executor, which opens the file, reads the footer and
+  /// schedules the loads of the first stripe. 0 disables split preload. If
+  /// not set, the value of --split_preload_per_driver is used.
+  static constexpr const char* kSplitPreloadPerDriver =
+      "split_preload_per_driver";
+
+  /// The number of splits per driver of a table scan, beyond the preloaded
+  /// ones, whose metadata is fetched ahead of being read. For the Hive
+  /// connector this opens the files in parallel on the connector executor,
+  /// which hides the open latency of object stores on tables of many small
+  /// files. 0 disables metadata prefetch.
+  static constexpr const char* kSplitMetadataPrefetchPerDriver =
+      "split_metadata_prefetch_per_driver";
+
+  /// The maximum number of parts a table scan divides a split into. The
+  /// parts are ranges of stripes that other drivers of the scan read in
+  /// parallel. 1 disables dividing splits.
+  static constexpr const char* kTableScanMaxSplitParts =
+      "table_scan_max_split_parts";
+
+  /// The number of drivers of a table scan pipeline that start with the task.
+  /// The other drivers of the pipeline start one at a time when there are
+  /// more queued splits than started drivers, and all start when no more
+  /// splits are coming. 0 starts all drivers with the task.
+  static constexpr const char* kTableScanInitialDrivers =
+      "table_scan_initial_drivers";
+
+  /// In grouped execution, the percentage of the query memory limit that the
+  /// running split groups together with one more split group are expected to
+  /// fit in for another split group to start. The memory of a split group is
+  /// estimated as the memory of the Task divided by the number of its running
+  /// split groups. A split group always starts if none is running. 0 starts
+  /// split groups regardless of memory.
+  static constexpr const char* kSplitGroupMemoryAdmissionPct =
+      "split_group_memory_admission_pct";
+
   uint64_t maxPartialAggregationMemoryUsage() const {
     static constexpr uint64_t kDefault = 1L << 24;
     return get<uint64_t>(kMaxPartialAggregationMemory, kDefault);
@@ -248,6 +457,10 @@ class QueryConfig {
     return get<uint64_t>(kMaxExtendedPartialAggregationMemory, kDefault);
   }
 
+  uint8_t aggregationTablePartitionBits() const {
+    return get<uint8_t>(kAggregationTablePartitionBits, 0);
+  }
+
   int32_t abandonPartialAggregationMinRows() const {
     return get<int32_t>(kAbandonPartialAggregationMinRows, 100'000);
   }
@@ -256,11 +469,19 @@ class QueryConfig {
     return get<int32_t>(kAbandonPartialAggregationMinPct, 80);
   }
 
+  int32_t partialAggregationMaxGroups() const {
+    return get<int32_t>(kPartialAggregationMaxGroups, 0);
+  }
+
   uint64_t aggregationSpillMemoryThreshold() const {
     static constexpr uint64_t kDefault = 0;
     return get<uint64_t>(kAggregationSpillMemoryThreshold, kDefault);
   }
 
+  bool aggregationSpillAll() const {
+    return get<bool>(kAggregationSpillAll, false);
+  }
+
   uint64_t joinSpillMemoryThreshold() const {
     static constexpr uint64_t kDefault = 0;
     return get<uint64_t>(kJoinSpillMemoryThreshold, kDefault);
@@ -280,16 +501,32 @@ class QueryConfig {
     return get<uint64_t>(kMaxPartitionedOutputBufferSize, kDefault);
   }
 
+  bool inProcessExchange() const {
+    return get<bool>(kInProcessExchange, false);
+  }
+
   uint64_t maxLocalExchangeBufferSize() const {
     static constexpr uint64_t kDefault = 32UL << 20;
     return get<uint64_t>(kMaxLocalExchangeBufferSize, kDefault);
   }
 
+  bool localExchangeReuseKeyHashes() const {
+    return get<bool>(kLocalExchangeReuseKeyHashes, false);
+  }
+
   uint64_t maxExchangeBufferSize() const {
     static constexpr uint64_t kDefault = 32UL << 20;
     return get<uint64_t>(kMaxExchangeBufferSize, kDefault);
   }
 
+  bool exchangePreserveEncodings() const {
+    return get<bool>(kExchangePreserveEncodings, false);
+  }
+
+  std::string exchangeCompressionKind() const {
+    return get<std::string>(kExchangeCompressionKind, "none");
+  }
+
   uint64_t preferredOutputBatchBytes() const {
     static constexpr uint64_t kDefault = 10UL << 20;
     return get<uint64_t>(kPreferredOutputBatchBytes, kDefault);
@@ -321,6 +558,10 @@ class QueryConfig {
     return get<bool>(kAdaptiveFilterReorderingEnabled, true);
   }
 
+  int32_t adaptiveFilterReorderingInterval() const {
+    return get<int32_t>(kAdaptiveFilterReorderingInterval, 8);
+  }
+
   bool isMatchStructByName() const {
     return get<bool>(kCastMatchStructByName, false);
   }
@@ -376,6 +617,18 @@ class QueryConfig {
     return get<bool>(kOrderBySpillEnabled, true);
   }
 
+  /// Returns 'is window spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool windowSpillEnabled() const {
+    return get<bool>(kWindowSpillEnabled, true);
+  }
+
+  /// Returns 'is topN row number spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool topNRowNumberSpillEnabled() const {
+    return get<bool>(kTopNRowNumberSpillEnabled, true);
+  }
+
   // Returns a percentage of aggregation or join input batches that
   // will be forced to spill for testing. 0 means no extra spilling.
   int32_t testingSpillPct() const {
@@ -407,6 +660,18 @@ class QueryConfig {
         kMaxBits, get<uint8_t>(kJoinSpillPartitionBits, kDefaultBits));
   }
 
+  bool joinSpillAdaptivePartitionBits() const {
+    return get<bool>(kJoinSpillAdaptivePartitionBits, false);
+  }
+
+  bool spillColdPartitionsFirst() const {
+    return get<bool>(kSpillColdPartitionsFirst, false);
+  }
+
+  bool asyncMemoryReservationEnabled() const {
+    return get<bool>(kAsyncMemoryReservationEnabled, false);
+  }
+
   /// Returns the number of bits used to calculate the spilling partition
   /// number for hash join. The number of spilling partitions will be power of
   /// two.
@@ -433,6 +698,10 @@ class QueryConfig {
     return get<std::string>(kSpillCompressionKind, "none");
   }
 
+  std::string spillFormat() const {
+    return get<std::string>(kSpillFormat, "presto");
+  }
+
   /// Returns the spillable memory reservation growth percentage of the previous
   /// memory reservation size. 25 means exponential growth along a series of
   /// integer powers of 5/4. The reservation grows by this much until it no
@@ -478,10 +747,42 @@ class QueryConfig {
     return get<bool>(kExprTrackCpuUsage, false);
   }
 
+  bool exprFuseFloatingPointArithmetic() const {
+    return get<bool>(kExprFuseFloatingPointArithmetic, false);
+  }
+
+  bool exprPreparedCacheEnabled() const {
+    return get<bool>(kExprPreparedCacheEnabled, false);
+  }
+
   bool operatorTrackCpuUsage() const {
     return get<bool>(kOperatorTrackCpuUsage, true);
   }
 
+  bool driverResumeAtBlockedOperator() const {
+    return get<bool>(kDriverResumeAtBlockedOperator, false);
+  }
+
+  bool adaptiveOutputBatchRows() const {
+    return get<bool>(kAdaptiveOutputBatchRows, false);
+  }
+
+  bool driverProfilingEnabled() const {
+    return get<bool>(kDriverProfilingEnabled, false);
+  }
+
+  bool groupIdPreAggregation() const {
+    return get<bool>(kGroupIdPreAggregation, false);
+  }
+
+  uint32_t arrowStreamPrefetchDepth() const {
+    return get<uint32_t>(kArrowStreamPrefetchDepth, 0);
+  }
+
+  bool collectKeyNdvs() const {
+    return get<bool>(kCollectKeyNdvs, false);
+  }
+
   uint32_t taskWriterCount() const {
     return get<uint32_t>(kTaskWriterCount, 4);
   }
@@ -499,6 +800,46 @@ class QueryConfig {
     return get<uint32_t>(kMinTableRowsForParallelJoinBuild, 1'000);
   }
 
+  bool hashJoinBloomFilterEnabled() const {
+    return get<bool>(kHashJoinBloomFilterEnabled, false);
+  }
+
+  uint32_t hashJoinBloomFilterMaxRows() const {
+    return get<uint32_t>(kHashJoinBloomFilterMaxRows, 4 << 20);
+  }
+
+  double hashJoinHotKeyRowsPct() const {
+    return get<double>(kHashJoinHotKeyRowsPct, 0);
+  }
+
+  std::string hashJoinTableCacheKey() const {
+    return get<std::string>(kHashJoinTableCacheKey, "");
+  }
+
+  bool parallelOrderByEnabled() const {
+    return get<bool>(kParallelOrderByEnabled, false);
+  }
+
+  std::optional<int32_t> splitPreloadPerDriver() const {
+    return get<int32_t>(kSplitPreloadPerDriver);
+  }
+
+  int32_t splitMetadataPrefetchPerDriver() const {
+    return get<int32_t>(kSplitMetadataPrefetchPerDriver, 0);
+  }
+
+  int32_t tableScanMaxSplitParts() const {
+    return get<int32_t>(kTableScanMaxSplitParts, 1);
+  }
+
+  uint32_t tableScanInitialDrivers() const {
+    return get<uint32_t>(kTableScanInitialDrivers, 0);
+  }
+
+  int32_t splitGroupMemoryAdmissionPct() const {
+    return get<int32_t>(kSplitGroupMemoryAdmissionPct, 0);
+  }
+
   template <typename T>
   T get(const std::string& key, const T& defaultValue) const {
     return config_->get<T>(key, defaultValue);
@@ -508,6 +849,11 @@ class QueryConfig {
     return std::optional<T>(config_->get<T>(key));
   }
 
+  /// Returns all properties set for the query.
+  const std::unordered_map<std::string, std::string>& values() const {
+    return config_->values();
+  }
+
   /// Test-only method to override the current query config properties.
   /// It is not thread safe.
   void testingOverrideConfigUnsafe(
@@ -58,4 +58,18 @@ QueryCtx::QueryCtx(
   return fmt::format("query.{}.{}", queryId.c_str(), seqNum++);
 }
 
+void ExecCtx::resetScratch() {
+  const auto numRanges = scratch_.numRanges();
+  if (numRanges == 0) {
+    return;
+  }
+  if (numRanges == 1) {
+    scratch_.setFirstFreeInRun(scratch_.rangeAt(0).data());
+    return;
+  }
+  const auto bytes = scratch_.allocatedBytes();
+  scratch_.clear();
+  scratch_.newRun(bytes);
+}
+
 } // namespace facebook::velox::core
@@ -18,6 +18,7 @@
 #include <folly/Executor.h>
 #include <folly/executors/CPUThreadPoolExecutor.h>
 #include "velox/common/caching/AsyncDataCache.h"
+#include "velox/common/memory/AllocationPool.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/core/QueryConfig.h"
 #include "velox/vector/DecodedVector.h"
@@ -145,7 +146,7 @@ class QueryCtx {
 class ExecCtx {
  public:
   ExecCtx(memory::MemoryPool* pool, QueryCtx* queryCtx)
-      : pool_(pool), queryCtx_(queryCtx), vectorPool_{pool} {}
+      : pool_(pool), queryCtx_(queryCtx), vectorPool_{pool}, scratch_{pool} {}
 
   velox::memory::MemoryPool* pool() const {
     return pool_;
@@ -222,6 +223,28 @@ class ExecCtx {
     return vectorPool_.release(vectors);
   }
 
+  /// Returns 'bytes' of uninitialized memory aligned to 'alignment' that is
+  /// valid until the next resetScratch(). This is for temporaries of
+  /// expression evaluation that die with the batch being evaluated, e.g.
+  /// scratch arrays of vector functions. The memory is not owned by any
+  /// Buffer, so it must not be referenced from vectors that can outlive the
+  /// batch.
+  char* allocateScratch(uint64_t bytes, int32_t alignment = 1) {
+    return scratch_.allocateFixed(bytes, alignment);
+  }
+
+  /// Makes all memory from allocateScratch() reusable. This is O(1) if the
+  /// previous batch fit in one run. Otherwise the runs are replaced by a
+  /// single run of their total size so that the next batches of the same
+  /// size do not allocate. Called at the start of each batch by
+  /// ExprSet::eval().
+  void resetScratch();
+
+  /// Returns the bytes of memory held for allocateScratch().
+  int64_t scratchBytes() const {
+    return scratch_.allocatedBytes();
+  }
+
  private:
   // Pool for all Buffers for this thread.
   memory::MemoryPool* pool_;
@@ -232,6 +255,8 @@ class ExecCtx {
   // and operators.
   std::vector<std::unique_ptr<SelectivityVector>> selectivityVectorPool_;
   VectorPool vectorPool_;
+  // Bump allocator for allocateScratch(). Reset by resetScratch().
+  memory::AllocationPool scratch_;
 };
 
 } // namespace facebook::velox::core
@@ -18,6 +18,7 @@
 
 #include "folly/io/Cursor.h"
 #include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/common/CoalescePolicy.h"
 
 DEFINE_bool(wsVRLoad, false, "Use WS VRead API to load");
 
@@ -145,10 +146,11 @@ void BufferedInput::mergeRegions() {
   DWIO_ENSURE(!r.empty(), "Assumes that there's at least one region");
   DWIO_ENSURE_GT(r[ia].length, 0, "invalid region");
 
+  const auto maxMergeDistance = mergeDistance();
   te[e[0]] = 0;
   for (size_t ib = 1; ib < r.size(); ++ib) {
     DWIO_ENSURE_GT(r[ib].length, 0, "invalid region");
-    if (!tryMerge(r[ia], r[ib])) {
+    if (!tryMerge(r[ia], r[ib], maxMergeDistance)) {
       r[++ia] = r[ib];
     }
     te[e[ib]] = ia;
@@ -158,7 +160,25 @@ void BufferedInput::mergeRegions() {
   std::swap(e, te);
 }
 
-bool BufferedInput::tryMerge(Region& first, const Region& second) {
+uint64_t BufferedInput::mergeDistance() const {
+  auto* policy = CoalescePolicy::getInstance();
+  if (policy == nullptr) {
+    return maxMergeDistance_;
+  }
+  // Only the gap adapts. BufferedInput does not limit the merged size.
+  return policy
+      ->limits(
+          input_->getName(),
+          input_->getNaturalReadSize(),
+          {static_cast<int32_t>(maxMergeDistance_),
+           std::numeric_limits<int64_t>::max()})
+      .maxGap;
+}
+
+bool BufferedInput::tryMerge(
+    Region& first,
+    const Region& second,
+    uint64_t maxMergeDistance) {
   DWIO_ENSURE_GE(second.offset, first.offset, "regions should be sorted.");
   const int64_t gap = second.offset - first.offset - first.length;
 
@@ -170,13 +190,17 @@ bool BufferedInput::tryMerge(Region& first, const Region& second) {
   }
 
   // compare with 0 since it's comparison in different types
-  if (gap < 0 || gap <= maxMergeDistance_) {
+  if (gap < 0 || gap <= maxMergeDistance) {
     // the second region is inside first one if extension is negative
     if (extension > 0) {
       first.length += extension;
       if ((input_->getStats() != nullptr) && gap > 0) {
         input_->getStats()->incRawOverreadBytes(gap);
       }
+      auto* policy = CoalescePolicy::getInstance();
+      if (policy != nullptr && gap > 0) {
+        policy->recordOverread(input_->getName(), gap);
+      }
     }
 
     return true;
@@ -137,6 +137,11 @@ class BufferedInput {
     return input_;
   }
 
+  // Returns the IO stats of the reads through 'this', nullptr if none.
+  virtual IoStatistics* FOLLY_NULLABLE ioStatistics() const {
+    return input_->getStats();
+  }
+
   virtual folly::Executor* FOLLY_NULLABLE executor() const {
     return nullptr;
   }
@@ -188,10 +193,15 @@ class BufferedInput {
   void sortRegions();
   void mergeRegions();
 
+  // Returns the max gap between merged regions. This adapts to the backend
+  // of the file if a CoalescePolicy is set.
+  uint64_t mergeDistance() const;
+
   // tries and merges WS read regions into one
   bool tryMerge(
       velox::common::Region& first,
-      const velox::common::Region& second);
+      const velox::common::Region& second,
+      uint64_t maxMergeDistance);
 };
 
 } // namespace facebook::velox::dwio::common
@@ -16,6 +16,7 @@
 
 #include <folly/executors/QueuedImmediateExecutor.h>
 
+#include "velox/common/caching/PeerCache.h"
 #include "velox/common/process/TraceContext.h"
 #include "velox/common/time/Timer.h"
 #include "velox/dwio/common/CacheInputStream.h"
@@ -135,6 +136,26 @@ size_t CacheInputStream::positionSize() {
   return 1;
 }
 
+namespace {
+// Keeps a cache entry pinned for as long as a vector refers to its memory.
+struct CachePinReleaser {
+  explicit CachePinReleaser(const cache::CachePin& pin) : pin_(pin) {}
+  void addRef() const {}
+  void release() const {}
+
+ private:
+  cache::CachePin pin_;
+};
+} // namespace
+
+BufferPtr CacheInputStream::currentBufferOwner() const {
+  if (pin_.empty() || run_ == nullptr || !pin_.checkedEntry()->isShared()) {
+    return nullptr;
+  }
+  return BufferView<CachePinReleaser>::create(
+      run_, runSize_, CachePinReleaser(pin_));
+}
+
 void CacheInputStream::setRemainingBytes(uint64_t remainingBytes) {
   VELOX_CHECK_GE(region_.length, position_ + remainingBytes);
   window_ = Region{static_cast<uint64_t>(position_), remainingBytes};
@@ -179,7 +200,8 @@ void CacheInputStream::loadSync(Region region) {
       pin_.checkedEntry()->makeEvictable();
     }
     pin_.clear();
-    pin_ = cache_->findOrCreate(key, region.length, &wait);
+    pin_ = cache_->findOrCreate(
+        key, region.length, &wait, bufferedInput_->cachePartition());
     if (pin_.empty()) {
       VELOX_CHECK(wait.valid());
       auto& exec = folly::QueuedImmediateExecutor::instance();
@@ -193,13 +215,34 @@ void CacheInputStream::loadSync(Region region) {
     }
     auto entry = pin_.checkedEntry();
     if (entry->isExclusive()) {
-      // Missed memory cache. Trying to load from ssd cache, and if again
-      // missed, fall back to remote fetching.
+      // Missed memory cache. Trying to load from ssd cache, then from the
+      // cache of a peer worker, and if again missed, fall back to remote
+      // fetching.
       entry->setGroupId(groupId_);
       entry->setTrackingId(trackingId_);
       if (loadFromSsd(region, *entry)) {
         return;
       }
+      auto* peerCache = cache_->peerCache();
+      if (peerCache != nullptr) {
+        uint64_t peerUsec = 0;
+        bool loaded;
+        {
+          MicrosecondTimer timer(&peerUsec);
+          loaded = peerCache->load(*entry);
+        }
+        if (loaded) {
+          ioStats_->peerRead().increment(region.length);
+          ioStats_->recordTrace(
+              IoTraceEntry::Tier::kPeer,
+              input_->getName(),
+              region.offset,
+              region.length,
+              peerUsec);
+          entry->setExclusiveToShared();
+          return;
+        }
+      }
       auto ranges = makeRanges(entry, region.length);
       uint64_t usec = 0;
       {
@@ -214,6 +257,12 @@ void CacheInputStream::loadSync(Region region) {
       if (!entry->getAndClearFirstUseFlag()) {
         ioStats_->ramHit().increment(entry->size());
       }
+      ioStats_->recordTrace(
+          IoTraceEntry::Tier::kRam,
+          input_->getName(),
+          region.offset,
+          region.length,
+          0);
       return;
     }
   } while (pin_.empty());
@@ -271,6 +320,12 @@ bool CacheInputStream::loadFromSsd(
   pin_ = std::move(pins[0]);
   ioStats_->ssdRead().increment(entry.size());
   ioStats_->queryThreadIoLatency().increment(usec);
+  ioStats_->recordTrace(
+      IoTraceEntry::Tier::kSsd,
+      input_->getName(),
+      region.offset,
+      entry.size(),
+      usec);
   entry.setExclusiveToShared();
   return true;
 }
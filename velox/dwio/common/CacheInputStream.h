@@ -48,6 +48,9 @@ class CacheInputStream : public SeekableInputStream {
   std::string getName() const override;
   size_t positionSize() override;
 
+  /// Returns a view over the current run that holds a pin on the cache entry.
+  BufferPtr currentBufferOwner() const override;
+
   /// Returns a copy of 'this', ranging over the same bytes. The clone
   /// is initially positioned at the position of 'this' and can be
   /// moved independently within 'region_'.  This is used for first
@@ -15,8 +15,10 @@
  */
 
 #include "velox/dwio/common/CachedBufferedInput.h"
+#include "velox/common/caching/PeerCache.h"
 #include "velox/common/memory/Allocation.h"
 #include "velox/common/process/TraceContext.h"
+#include "velox/common/time/Timer.h"
 #include "velox/dwio/common/CacheInputStream.h"
 
 DEFINE_int32(
@@ -144,6 +146,17 @@ std::vector<CacheRequest*> makeRequestParts(
   return parts;
 }
 
+// Min references to a stream in the cross query history for using the history
+// for the prefetch decision.
+constexpr int32_t kMinHistoryReferences = 4;
+
+// Returns the read percentage of a stream in the cross query history. The
+// history includes the reference made by this scan.
+int32_t historyReadPct(const cache::TrackingData& history) {
+  return std::min<int32_t>(
+      100, (100 * history.numReads) / (history.numReferences - 1));
+}
+
 int32_t adjustedReadPct(const cache::TrackingData& trackingData) {
   // When called, there will be one more reference that read, since references
   // are counted before reading.
@@ -178,10 +191,22 @@ void CachedBufferedInput::load(const LogType) {
       cache::TrackingData trackingData;
       bool prefetchAnyway = request.trackingId.empty() ||
           request.trackingId.id() == StreamIdentifier::sequentialFile().id_;
+      int32_t requestReadPct = 0;
       if (!prefetchAnyway && tracker_) {
         trackingData = tracker_->trackingData(request.trackingId);
+        requestReadPct = adjustedReadPct(trackingData);
+        if (trackingData.numReferences < 2 && tracker_->history()) {
+          // The scan has no data of its own yet. Use what earlier scans of
+          // the file group read.
+          const auto history = tracker_->history()->trackingData(
+              groupId_, request.trackingId);
+          if (history.numReferences >= kMinHistoryReferences) {
+            trackingData = history;
+            requestReadPct = historyReadPct(history);
+          }
+        }
       }
-      if (prefetchAnyway || adjustedReadPct(trackingData) >= readPct) {
+      if (prefetchAnyway || requestReadPct >= readPct) {
         request.processed = true;
         auto parts = makeRequestParts(
             request, trackingData, options_.loadQuantum(), extraRequests);
@@ -218,7 +243,7 @@ void CachedBufferedInput::makeLoads(
     return;
   }
   bool isSsd = !requests[0]->ssdPin.empty();
-  int32_t maxDistance = isSsd ? 20000 : options_.maxCoalesceDistance();
+  const auto limits = coalesceLimits(isSsd);
   std::sort(
       requests.begin(),
       requests.end(),
@@ -235,7 +260,7 @@ void CachedBufferedInput::makeLoads(
   int64_t coalescedBytes = 0;
   coalesceIo<CacheRequest*, CacheRequest*>(
       requests,
-      maxDistance,
+      limits.maxGap,
       // Break batches up. Better load more short ones i parallel.
       40,
       [&](int32_t index) {
@@ -248,7 +273,7 @@ void CachedBufferedInput::makeLoads(
         return size;
       },
       [&](int32_t index) {
-        if (coalescedBytes > options_.maxCoalesceBytes()) {
+        if (coalescedBytes > limits.maxCoalesceBytes) {
           coalescedBytes = 0;
           return kNoCoalesce;
         }
@@ -264,7 +289,7 @@ void CachedBufferedInput::makeLoads(
           uint64_t /*offset*/,
           const std::vector<CacheRequest*>& ranges) {
         ++numNewLoads;
-        readRegion(ranges, prefetch);
+        readRegion(ranges, prefetch, limits.maxGap);
       });
   if (prefetch && executor_) {
     std::vector<int32_t> doneIndices;
@@ -289,6 +314,20 @@ void CachedBufferedInput::makeLoads(
   }
 }
 
+CoalescePolicy::Limits CachedBufferedInput::coalesceLimits(bool isSsd) const {
+  if (isSsd) {
+    return {20000, options_.maxCoalesceBytes()};
+  }
+  const CoalescePolicy::Limits defaults{
+      options_.maxCoalesceDistance(), options_.maxCoalesceBytes()};
+  auto* policy = CoalescePolicy::getInstance();
+  if (policy == nullptr) {
+    return defaults;
+  }
+  return policy->limits(
+      input_->getName(), input_->getNaturalReadSize(), defaults);
+}
+
 namespace {
 // Base class for CoalescedLoads for different storage types.
 class DwioCoalescedLoadBase : public cache::CoalescedLoad {
@@ -297,11 +336,13 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
       cache::AsyncDataCache& cache,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
+      int32_t cachePartition,
       std::vector<CacheRequest*> requests)
       : CoalescedLoad(makeKeys(requests), makeSizes(requests)),
         cache_(cache),
         ioStats_(std::move(ioStats)),
-        groupId_(groupId) {
+        groupId_(groupId),
+        cachePartition_(cachePartition) {
     for (auto& request : requests) {
       size_ += request->size;
       requests_.push_back(std::move(*request));
@@ -369,6 +410,7 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
   std::vector<CacheRequest> requests_;
   std::shared_ptr<IoStatistics> ioStats_;
   const uint64_t groupId_;
+  const int32_t cachePartition_;
   int64_t size_{0};
 };
 
@@ -380,9 +422,15 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
       std::shared_ptr<ReadFileInputStream> input,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
+      int32_t cachePartition,
       std::vector<CacheRequest*> requests,
       int32_t maxCoalesceDistance)
-      : DwioCoalescedLoadBase(cache, ioStats, groupId, std::move(requests)),
+      : DwioCoalescedLoadBase(
+            cache,
+            ioStats,
+            groupId,
+            cachePartition,
+            std::move(requests)),
         input_(std::move(input)),
         maxCoalesceDistance_(maxCoalesceDistance) {}
 
@@ -397,15 +445,20 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
             pin.checkedEntry()->setPrefetch(true);
           }
           pins.push_back(std::move(pin));
-        });
+        },
+        cachePartition_);
     if (pins.empty()) {
       return pins;
     }
+    auto storagePins = loadFromPeers(pins);
+    if (storagePins.empty()) {
+      return pins;
+    }
     auto stats = cache::readPins(
-        pins,
+        storagePins,
         maxCoalesceDistance_,
         1000,
-        [&](int32_t i) { return pins[i].entry()->offset(); },
+        [&](int32_t i) { return storagePins[i].entry()->offset(); },
         [&](const std::vector<CachePin>& /*pins*/,
             int32_t /*begin*/,
             int32_t /*end*/,
@@ -414,9 +467,46 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
           input_->read(buffers, offset, LogType::FILE);
         });
     updateStats(stats, isPrefetch, false);
+    auto* policy = CoalescePolicy::getInstance();
+    if (policy != nullptr && stats.extraBytes > 0) {
+      policy->recordOverread(input_->getName(), stats.extraBytes);
+    }
+    for (auto& pin : storagePins) {
+      pins.push_back(std::move(pin));
+    }
     return pins;
   }
 
+ private:
+  // Fills the entries of 'pins' that the peer tier of the cache has. Moves
+  // the other pins out of 'pins' and returns them in offset order. These are
+  // to be read from storage.
+  std::vector<CachePin> loadFromPeers(std::vector<CachePin>& pins) {
+    auto* peerCache = cache_.peerCache();
+    std::vector<CachePin> storagePins;
+    if (peerCache == nullptr) {
+      storagePins.swap(pins);
+      return storagePins;
+    }
+    int32_t numLoaded = 0;
+    for (auto i = 0; i < pins.size(); ++i) {
+      auto* entry = pins[i].checkedEntry();
+      if (!peerCache->load(*entry)) {
+        storagePins.push_back(std::move(pins[i]));
+        continue;
+      }
+      if (ioStats_) {
+        ioStats_->peerRead().increment(entry->size());
+      }
+      if (numLoaded != i) {
+        pins[numLoaded] = std::move(pins[i]);
+      }
+      ++numLoaded;
+    }
+    pins.resize(numLoaded);
+    return storagePins;
+  }
+
   std::shared_ptr<ReadFileInputStream> input_;
   const int32_t maxCoalesceDistance_;
 };
@@ -428,8 +518,16 @@ class SsdLoad : public DwioCoalescedLoadBase {
       cache::AsyncDataCache& cache,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
-      std::vector<CacheRequest*> requests)
-      : DwioCoalescedLoadBase(cache, ioStats, groupId, std::move(requests)) {}
+      int32_t cachePartition,
+      std::vector<CacheRequest*> requests,
+      std::string path)
+      : DwioCoalescedLoadBase(
+            cache,
+            ioStats,
+            groupId,
+            cachePartition,
+            std::move(requests)),
+        path_(std::move(path)) {}
 
   std::vector<CachePin> loadData(bool isPrefetch) override {
     std::vector<SsdPin> ssdPins;
@@ -443,36 +541,61 @@ class SsdLoad : public DwioCoalescedLoadBase {
           }
           pins.push_back(std::move(pin));
           ssdPins.push_back(std::move(requests_[index].ssdPin));
-        });
+        },
+        cachePartition_);
     if (pins.empty()) {
       return pins;
     }
     assert(!ssdPins.empty()); // for lint.
-    auto stats = ssdPins[0].file()->load(ssdPins, pins);
+    uint64_t usec = 0;
+    CoalesceIoStats stats;
+    {
+      MicrosecondTimer timer(&usec);
+      stats = ssdPins[0].file()->load(ssdPins, pins);
+    }
     updateStats(stats, isPrefetch, true);
+    if (ioStats_) {
+      ioStats_->recordTrace(
+          IoTraceEntry::Tier::kSsd,
+          path_,
+          requests_[0].key.offset,
+          stats.payloadBytes,
+          usec);
+    }
     return pins;
   }
+
+ private:
+  const std::string path_;
 };
 
 } // namespace
 
 void CachedBufferedInput::readRegion(
     std::vector<CacheRequest*> requests,
-    bool prefetch) {
+    bool prefetch,
+    int32_t maxCoalesceDistance) {
   if (requests.empty() || (requests.size() == 1 && !prefetch)) {
     return;
   }
   std::shared_ptr<cache::CoalescedLoad> load;
   if (!requests[0]->ssdPin.empty()) {
-    load = std::make_shared<SsdLoad>(*cache_, ioStats_, groupId_, requests);
+    load = std::make_shared<SsdLoad>(
+        *cache_,
+        ioStats_,
+        groupId_,
+        options_.cachePartition(),
+        requests,
+        input_->getName());
   } else {
     load = std::make_shared<DwioCoalescedLoad>(
         *cache_,
         input_,
         ioStats_,
         groupId_,
+        options_.cachePartition(),
         requests,
-        options_.maxCoalesceDistance());
+        maxCoalesceDistance);
   }
   allCoalescedLoads_.push_back(load);
   coalescedLoads_.withWLock([&](auto& loads) {
@@ -23,6 +23,7 @@
 #include "velox/common/caching/SsdCache.h"
 #include "velox/dwio/common/BufferedInput.h"
 #include "velox/dwio/common/CacheInputStream.h"
+#include "velox/dwio/common/CoalescePolicy.h"
 #include "velox/dwio/common/InputStream.h"
 #include "velox/dwio/common/IoStatistics.h"
 #include "velox/dwio/common/Options.h"
@@ -148,6 +149,11 @@ class CachedBufferedInput : public BufferedInput {
     return cache_;
   }
 
+  // Returns the partition of 'cache_' that holds the data of 'this'.
+  int32_t cachePartition() const {
+    return options_.cachePartition();
+  }
+
   // Returns the CoalescedLoad that contains the correlated loads for
   // 'stream' or nullptr if none. Returns nullptr on all but first
   // call for 'stream' since the load is to be triggered by the first
@@ -159,6 +165,10 @@ class CachedBufferedInput : public BufferedInput {
     return executor_;
   }
 
+  IoStatistics* FOLLY_NULLABLE ioStatistics() const override {
+    return ioStats_.get();
+  }
+
   int64_t prefetchSize() const override {
     return prefetchSize_;
   }
@@ -173,7 +183,15 @@ class CachedBufferedInput : public BufferedInput {
   // on 'executor_'. Links the CoalescedLoad  to all CacheInputStreams that it
   // concerns.
 
-  void readRegion(std::vector<CacheRequest*> requests, bool prefetch);
+  void readRegion(
+      std::vector<CacheRequest*> requests,
+      bool prefetch,
+      int32_t maxCoalesceDistance);
+
+  // Returns the coalescing limits for loading from SSD if 'isSsd' is true,
+  // otherwise from storage. The storage limits adapt to the measured
+  // latency and bandwidth of the backend if a CoalescePolicy is set.
+  CoalescePolicy::Limits coalesceLimits(bool isSsd) const;
 
   cache::AsyncDataCache* FOLLY_NONNULL cache_;
   const uint64_t fileNum_;
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/CoalescePolicy.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace facebook::velox::dwio::common {
+
+void CoalescePolicy::Model::add(uint64_t bytes, uint64_t micros) {
+  weight = weight * kDecay + 1;
+  sumBytes = sumBytes * kDecay + bytes;
+  sumMicros = sumMicros * kDecay + micros;
+  sumBytes2 = sumBytes2 * kDecay + static_cast<double>(bytes) * bytes;
+  sumBytesMicros =
+      sumBytesMicros * kDecay + static_cast<double>(bytes) * micros;
+  ++stats.numIos;
+  stats.bytes += bytes;
+  stats.micros += micros;
+  fit();
+}
+
+void CoalescePolicy::Model::fit() {
+  const double meanBytes = sumBytes / weight;
+  const double meanMicros = sumMicros / weight;
+  const double variance = sumBytes2 / weight - meanBytes * meanBytes;
+  // IOs of about the same size do not separate latency from transfer time.
+  // Keep the previous fit until the sizes vary.
+  if (variance <= 0.0001 * meanBytes * meanBytes) {
+    return;
+  }
+  const double covariance = sumBytesMicros / weight - meanBytes * meanMicros;
+  const double microsPerByte = covariance / variance;
+  if (microsPerByte <= 0) {
+    return;
+  }
+  stats.bytesPerMicro = 1 / microsPerByte;
+  stats.latencyMicros =
+      std::max<double>(0, meanMicros - microsPerByte * meanBytes);
+}
+
+// static
+std::string_view CoalescePolicy::backend(std::string_view fileName) {
+  const auto pos = fileName.find("://");
+  if (pos == std::string_view::npos || pos == 0) {
+    return "file";
+  }
+  return fileName.substr(0, pos);
+}
+
+void CoalescePolicy::recordIo(
+    std::string_view fileName,
+    uint64_t bytes,
+    uint64_t micros) {
+  const std::string name(backend(fileName));
+  std::lock_guard<std::mutex> l(mutex_);
+  models_[name].add(bytes, micros);
+}
+
+void CoalescePolicy::recordOverread(
+    std::string_view fileName,
+    uint64_t bytes) {
+  const std::string name(backend(fileName));
+  std::lock_guard<std::mutex> l(mutex_);
+  models_[name].stats.overreadBytes += bytes;
+}
+
+CoalescePolicy::Limits CoalescePolicy::limits(
+    std::string_view fileName,
+    uint64_t naturalReadSize,
+    const Limits& defaults) const {
+  double latencyMicros;
+  double bytesPerMicro;
+  {
+    const std::string name(backend(fileName));
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = models_.find(name);
+    if (it == models_.end() || it->second.stats.numIos < kMinSamples ||
+        it->second.stats.bytesPerMicro == 0) {
+      return defaults;
+    }
+    latencyMicros = it->second.stats.latencyMicros;
+    bytesPerMicro = it->second.stats.bytesPerMicro;
+  }
+  Limits limits;
+  limits.maxGap = std::min<double>(kMaxGap, latencyMicros * bytesPerMicro);
+  const int64_t minBytes = std::max<int64_t>(
+      kMinCoalesceBytes, static_cast<int64_t>(naturalReadSize));
+  limits.maxCoalesceBytes = std::min<int64_t>(
+      defaults.maxCoalesceBytes,
+      std::max<int64_t>(
+          minBytes, static_cast<int64_t>(limits.maxGap) * (1 + kAmortization)));
+  return limits;
+}
+
+folly::F14FastMap<std::string, CoalescePolicy::Stats> CoalescePolicy::stats()
+    const {
+  folly::F14FastMap<std::string, Stats> result;
+  std::lock_guard<std::mutex> l(mutex_);
+  for (const auto& [name, model] : models_) {
+    result[name] = model.stats;
+  }
+  return result;
+}
+
+namespace {
+std::atomic<CoalescePolicy*>& instance() {
+  static std::atomic<CoalescePolicy*> policy{nullptr};
+  return policy;
+}
+} // namespace
+
+// static
+CoalescePolicy* CoalescePolicy::getInstance() {
+  return instance();
+}
+
+// static
+void CoalescePolicy::setInstance(CoalescePolicy* policy) {
+  instance() = policy;
+}
+
+} // namespace facebook::velox::dwio::common
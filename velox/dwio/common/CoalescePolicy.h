@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/container/F14Map.h>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace facebook::velox::dwio::common {
+
+/// Chooses the IO coalescing limits of a storage backend from the latency
+/// and bandwidth measured on its reads. A read of 'bytes' is modeled as
+/// taking 'latency + bytes / bandwidth'. Reading a gap between two ranges
+/// costs the transfer time of the gap, a separate IO costs the latency, so
+/// gaps are worth reading up to 'latency * bandwidth' bytes. Coalesced IOs
+/// are capped at a size that amortizes the latency. Local NVMe gets small
+/// gaps and requests, object stores with tens of ms of latency get large
+/// ones.
+///
+/// Backends are identified by the URI scheme of the file name, e.g. "s3" or
+/// "hdfs". Paths without a scheme are "file". The model of each backend is
+/// fitted by least squares over recent reads, older reads decaying in
+/// weight, so that it follows changes in load.
+///
+/// This object is thread-safe.
+class CoalescePolicy {
+ public:
+  struct Limits {
+    /// Max bytes of gap between ranges that are read in one IO.
+    int32_t maxGap;
+    /// Max size of a coalesced IO.
+    int64_t maxCoalesceBytes;
+  };
+
+  struct Stats {
+    uint64_t numIos{0};
+    uint64_t bytes{0};
+    uint64_t micros{0};
+    /// Bytes read and discarded due to coalescing.
+    uint64_t overreadBytes{0};
+    /// The fitted model. 0 until there are enough samples.
+    double latencyMicros{0};
+    double bytesPerMicro{0};
+  };
+
+  /// Number of reads of a backend before its model replaces the configured
+  /// limits.
+  static constexpr int32_t kMinSamples = 16;
+
+  /// Weight of a sample relative to the previous one.
+  static constexpr double kDecay = 0.99;
+
+  /// A coalesced IO is at least this many times its gap limit, which makes
+  /// the latency at most 1 / (1 + kAmortization) of the IO time.
+  static constexpr int32_t kAmortization = 9;
+
+  /// Bounds of the limits chosen from the model.
+  static constexpr int32_t kMaxGap = 64 << 20;
+  static constexpr int64_t kMinCoalesceBytes = 1 << 20;
+
+  /// Returns the backend of 'fileName'.
+  static std::string_view backend(std::string_view fileName);
+
+  /// Records a read of 'bytes' from 'fileName' that took 'micros'.
+  void recordIo(std::string_view fileName, uint64_t bytes, uint64_t micros);
+
+  /// Records 'bytes' of gaps read and discarded from 'fileName'.
+  void recordOverread(std::string_view fileName, uint64_t bytes);
+
+  /// Returns the limits for reading 'fileName'. Returns 'defaults' until the
+  /// backend has kMinSamples reads. The chosen coalesce size is not over
+  /// 'defaults.maxCoalesceBytes' and not under 'naturalReadSize'.
+  Limits limits(
+      std::string_view fileName,
+      uint64_t naturalReadSize,
+      const Limits& defaults) const;
+
+  /// Returns the stats of each backend.
+  folly::F14FastMap<std::string, Stats> stats() const;
+
+  /// Returns the process wide policy, nullptr if none is set. Readers use
+  /// the configured limits if no policy is set.
+  static CoalescePolicy* getInstance();
+
+  static void setInstance(CoalescePolicy* policy);
+
+ private:
+  // Decayed sums for the least squares fit of IO time over IO size.
+  struct Model {
+    double weight{0};
+    double sumBytes{0};
+    double sumMicros{0};
+    double sumBytes2{0};
+    double sumBytesMicros{0};
+    Stats stats;
+
+    void add(uint64_t bytes, uint64_t micros);
+
+    // Sets the latency and bandwidth in 'stats' from the sums.
+    void fit();
+  };
+
+  mutable std::mutex mutex_;
+  folly::F14FastMap<std::string, Model> models_;
+};
+
+} // namespace facebook::velox::dwio::common
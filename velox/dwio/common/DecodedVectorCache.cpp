@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/DecodedVectorCache.h"
+
+#include "velox/common/memory/MemoryArbitrator.h"
+
+namespace facebook::velox::dwio::common {
+
+// Gives the memory of the cache back to the memory arbitrator by evicting
+// entries.
+class DecodedVectorCache::Reclaimer : public memory::MemoryReclaimer {
+ public:
+  explicit Reclaimer(DecodedVectorCache* cache) : cache_(cache) {}
+
+  bool reclaimableBytes(
+      const memory::MemoryPool& /*pool*/,
+      uint64_t& reclaimableBytes) const override {
+    reclaimableBytes = cache_->stats().cachedBytes;
+    return true;
+  }
+
+  uint64_t reclaim(memory::MemoryPool* /*pool*/, uint64_t targetBytes)
+      override {
+    return cache_->shrink(targetBytes);
+  }
+
+ private:
+  DecodedVectorCache* const cache_;
+};
+
+DecodedVectorCache::DecodedVectorCache(
+    uint64_t capacity,
+    uint64_t maxEntryBytes,
+    memory::MemoryManager& memoryManager)
+    : capacity_(capacity), maxEntryBytes_(maxEntryBytes) {
+  VELOX_CHECK_GT(capacity_, 0);
+  VELOX_CHECK_LE(maxEntryBytes_, capacity_);
+  rootPool_ = memoryManager.addRootPool(
+      "DecodedVectorCache", capacity_, std::make_unique<Reclaimer>(this));
+  pool_ = rootPool_->addLeafChild("DecodedVectorCache");
+}
+
+DecodedVectorCache::~DecodedVectorCache() {
+  shrink(0);
+}
+
+std::shared_ptr<const DecodedVectorCache::Batches> DecodedVectorCache::find(
+    const Key& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++stats_.numMisses;
+    return nullptr;
+  }
+  ++stats_.numHits;
+  lru_.splice(lru_.end(), lru_, it->second.lruPosition);
+  return it->second.batches;
+}
+
+RowVectorPtr DecodedVectorCache::copy(const RowVectorPtr& vector) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    makeSpaceLocked(vector->retainedSize());
+  }
+  try {
+    auto result = std::static_pointer_cast<RowVector>(
+        BaseVector::create(vector->type(), vector->size(), pool_.get()));
+    for (auto i = 0; i < vector->childrenSize(); ++i) {
+      const auto& child = vector->childAt(i);
+      if (child == nullptr) {
+        continue;
+      }
+      const auto& loaded = BaseVector::loadedVectorShared(child);
+      result->childAt(i)->copy(loaded.get(), 0, 0, loaded->size());
+    }
+    return result;
+  } catch (const VeloxException& e) {
+    LOG(WARNING) << "Failed to copy vector to the decoded vector cache: "
+                 << e.what();
+    return nullptr;
+  }
+}
+
+bool DecodedVectorCache::insert(Key key, Batches batches) {
+  uint64_t bytes = 0;
+  for (const auto& batch : batches) {
+    VELOX_CHECK_EQ(batch->pool(), pool_.get());
+    bytes += batch->retainedSize();
+  }
+  if (bytes > maxEntryBytes_) {
+    return false;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    // A concurrent scan of the same split added the entry first.
+    lru_.splice(lru_.end(), lru_, it->second.lruPosition);
+    return true;
+  }
+  makeSpaceLocked(bytes);
+  lru_.push_back(key);
+  entries_[std::move(key)] = Entry{
+      std::make_shared<const Batches>(std::move(batches)),
+      bytes,
+      std::prev(lru_.end())};
+  cachedBytes_ += bytes;
+  ++stats_.numInserts;
+  return true;
+}
+
+DecodedVectorCache::SharedScan DecodedVectorCache::shareScan(
+    const Key& key,
+    const std::string& queryId) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto entryIt = entries_.find(key);
+  if (entryIt != entries_.end()) {
+    ++stats_.numHits;
+    lru_.splice(lru_.end(), lru_, entryIt->second.lruPosition);
+    return {std::make_shared<SharedLoad>(*entryIt->second.batches), false};
+  }
+  auto loadIt = loads_.find(key);
+  if (loadIt != loads_.end()) {
+    if (loadIt->second->queryId_ == queryId) {
+      return {nullptr, false};
+    }
+    ++stats_.numSharedLoadHits;
+    return {loadIt->second, false};
+  }
+  ++stats_.numMisses;
+  auto load = std::make_shared<SharedLoad>(this, key, queryId);
+  loads_.emplace(key, load);
+  return {std::move(load), true};
+}
+
+void DecodedVectorCache::removeLoad(const Key& key, const SharedLoad* load) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = loads_.find(key);
+  if (it != loads_.end() && it->second.get() == load) {
+    loads_.erase(it);
+  }
+}
+
+DecodedVectorCache::SharedLoad::Result
+DecodedVectorCache::SharedLoad::batchAt(
+    size_t index,
+    RowVectorPtr& batch,
+    ContinueFuture& future) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (index < batches_.size()) {
+    batch = batches_[index];
+    return Result::kBatch;
+  }
+  switch (state_) {
+    case State::kFinished:
+      return Result::kEnd;
+    case State::kAbandoned:
+      return Result::kAbandoned;
+    case State::kLoading:
+      break;
+  }
+  promises_.emplace_back("DecodedVectorCache::SharedLoad::batchAt");
+  future = promises_.back().getSemiFuture();
+  return Result::kWait;
+}
+
+void DecodedVectorCache::SharedLoad::add(RowVectorPtr batch) {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(state_ == State::kLoading);
+    batches_.push_back(std::move(batch));
+    promises.swap(promises_);
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+void DecodedVectorCache::SharedLoad::finish() {
+  VELOX_CHECK_NOT_NULL(cache_);
+  setState(State::kFinished);
+  // The entry is added before the load is removed, so that a scan of the same
+  // key finds either of them.
+  cache_->insert(key_, batches_);
+  cache_->removeLoad(key_, this);
+}
+
+void DecodedVectorCache::SharedLoad::abandon() {
+  VELOX_CHECK_NOT_NULL(cache_);
+  setState(State::kAbandoned);
+  cache_->removeLoad(key_, this);
+}
+
+void DecodedVectorCache::SharedLoad::setState(State state) {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(state_ == State::kLoading);
+    state_ = state;
+    promises.swap(promises_);
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+uint64_t DecodedVectorCache::shrink(uint64_t targetBytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  uint64_t freedBytes = 0;
+  while (!lru_.empty() && (targetBytes == 0 || freedBytes < targetBytes)) {
+    freedBytes += evictOneLocked();
+  }
+  return freedBytes;
+}
+
+DecodedVectorCache::Stats DecodedVectorCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto stats = stats_;
+  stats.numEntries = entries_.size();
+  stats.cachedBytes = cachedBytes_;
+  return stats;
+}
+
+uint64_t DecodedVectorCache::makeSpaceLocked(uint64_t bytes) {
+  uint64_t freedBytes = 0;
+  while (!lru_.empty() && cachedBytes_ + bytes > capacity_) {
+    freedBytes += evictOneLocked();
+  }
+  return freedBytes;
+}
+
+uint64_t DecodedVectorCache::evictOneLocked() {
+  auto it = entries_.find(lru_.front());
+  VELOX_CHECK(it != entries_.end());
+  const auto bytes = it->second.bytes;
+  entries_.erase(it);
+  lru_.pop_front();
+  cachedBytes_ -= bytes;
+  ++stats_.numEvicts;
+  return bytes;
+}
+
+namespace {
+std::atomic<DecodedVectorCache*>& instance() {
+  static std::atomic<DecodedVectorCache*> cache{nullptr};
+  return cache;
+}
+} // namespace
+
+// static
+DecodedVectorCache* DecodedVectorCache::getInstance() {
+  return instance();
+}
+
+// static
+void DecodedVectorCache::setInstance(DecodedVectorCache* cache) {
+  instance() = cache;
+}
+
+} // namespace facebook::velox::dwio::common
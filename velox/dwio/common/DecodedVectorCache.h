@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/container/F14Map.h>
+#include <folly/hash/Hash.h>
+#include <list>
+#include <mutex>
+
+#include "velox/common/future/VeloxPromise.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::dwio::common {
+
+/// Caches the decoded output of the scan of a split. A repeat scan of the same
+/// split with the same columns and pushed down filters gets the decoded
+/// batches from the cache and does not read or decode the file. This pays off
+/// for small, hot tables, e.g. dimension tables that are scanned by many
+/// queries. The cached vectors are allocated from a root memory pool owned by
+/// the cache. The pool has a reclaimer that evicts entries, so the memory
+/// arbitrator can take memory back from the cache.
+///
+/// Scans that run at the same time can also share one read of a split through
+/// shareScan(): the first scan reads the split and adds each batch to a
+/// SharedLoad, which the other scans read as the batches arrive. The batches
+/// become a cache entry when the split is complete.
+///
+/// Entries are evicted in LRU order when the cache is over its capacity. The
+/// key does not capture changes to the file contents, so the cache is only
+/// correct for immutable files, like AsyncDataCache. The cache must outlive
+/// the scans that use it.
+///
+/// This object is thread-safe.
+class DecodedVectorCache {
+ public:
+  struct Key {
+    std::string filePath;
+    uint64_t start;
+    uint64_t length;
+    /// Describes the columns and the filters of the scan. Scans with the same
+    /// fingerprint produce the same rows from the same split.
+    std::string fingerprint;
+
+    bool operator==(const Key& other) const {
+      return start == other.start && length == other.length &&
+          filePath == other.filePath && fingerprint == other.fingerprint;
+    }
+  };
+
+  struct KeyHasher {
+    size_t operator()(const Key& key) const {
+      return folly::hash::hash_combine(
+          std::hash<std::string>()(key.filePath),
+          key.start,
+          key.length,
+          std::hash<std::string>()(key.fingerprint));
+    }
+  };
+
+  /// The decoded batches of a split, in scan order.
+  using Batches = std::vector<RowVectorPtr>;
+
+  struct Stats {
+    uint64_t numHits{0};
+    uint64_t numMisses{0};
+    uint64_t numInserts{0};
+    uint64_t numEvicts{0};
+    uint64_t numEntries{0};
+    uint64_t cachedBytes{0};
+    /// Number of shareScan() calls that attached to a load in progress.
+    uint64_t numSharedLoadHits{0};
+  };
+
+  /// The batches of a split while one scan reads it for the other scans of
+  /// the same key. The reading scan adds the batches with add() and ends with
+  /// either finish() or abandon(). The batches are copies made by copy().
+  ///
+  /// This object is thread-safe.
+  class SharedLoad {
+   public:
+    enum class Result {
+      /// The batch is returned.
+      kBatch,
+      /// The batch is not added yet. The future is realized when it is.
+      kWait,
+      /// All the batches of the split have been returned.
+      kEnd,
+      /// The reading scan stopped sharing before adding the batch. The caller
+      /// reads the rest of the split by itself.
+      kAbandoned,
+    };
+
+    SharedLoad(DecodedVectorCache* cache, Key key, std::string queryId)
+        : cache_(cache), key_(std::move(key)), queryId_(std::move(queryId)) {}
+
+    /// Makes a finished load of the batches of a cache entry.
+    explicit SharedLoad(const Batches& batches)
+        : key_(), state_(State::kFinished), batches_(batches) {}
+
+    /// Returns the batch at 'index' in 'batch', or sets 'future' if the batch
+    /// is yet to be added.
+    Result batchAt(size_t index, RowVectorPtr& batch, ContinueFuture& future);
+
+    /// Adds the next batch of the split.
+    void add(RowVectorPtr batch);
+
+    /// Adds the batches to the cache after the last batch of the split.
+    void finish();
+
+    /// Stops sharing, e.g. if there is no memory for the copies. The scans
+    /// that have not read all the batches read the rest by themselves. The
+    /// reader must call either finish() or abandon(), otherwise the other
+    /// scans wait forever.
+    void abandon();
+
+   private:
+    friend class DecodedVectorCache;
+
+    enum class State { kLoading, kFinished, kAbandoned };
+
+    // Sets 'state' and wakes up the waiting scans.
+    void setState(State state);
+
+    DecodedVectorCache* const cache_{nullptr};
+    const Key key_;
+    // The query of the reading scan.
+    const std::string queryId_;
+
+    std::mutex mutex_;
+    State state_{State::kLoading};
+    Batches batches_;
+    // The promises of the scans waiting for the next batch.
+    std::vector<ContinuePromise> promises_;
+  };
+
+  /// The outcome of shareScan(). 'load' is nullptr if the caller reads the
+  /// split without sharing.
+  struct SharedScan {
+    std::shared_ptr<SharedLoad> load;
+    /// True if the caller reads the split and adds the batches to 'load'.
+    bool reader{false};
+  };
+
+  /// 'capacity' is the max bytes of cached vectors. Splits whose decoded size
+  /// is over 'maxEntryBytes' are not cached.
+  DecodedVectorCache(
+      uint64_t capacity,
+      uint64_t maxEntryBytes,
+      memory::MemoryManager& memoryManager = memory::defaultMemoryManager());
+
+  ~DecodedVectorCache();
+
+  /// Returns the batches for 'key' or nullptr if there is no entry.
+  std::shared_ptr<const Batches> find(const Key& key);
+
+  /// Returns a deep copy of 'vector' allocated from the memory of the cache,
+  /// for adding to an entry with insert(). Lazy children are loaded. Evicts
+  /// entries to make space for the copy. Returns nullptr if there is no
+  /// memory for the copy.
+  RowVectorPtr copy(const RowVectorPtr& vector);
+
+  /// Adds the batches made by copy() for 'key'. Returns false if the batches
+  /// are over 'maxEntryBytes' and are not added.
+  bool insert(Key key, Batches batches);
+
+  /// Returns a finished load with the cached batches for 'key' if there is an
+  /// entry, or the load of 'key' by a concurrent scan if there is one.
+  /// Otherwise starts a load with the caller as its reader. Returns no load if
+  /// the load in progress is read by a scan of the same query 'queryId': the
+  /// scans of one query may wait for each other, e.g. the probe side of a
+  /// self join waits for the build side, so neither can wait for the other's
+  /// reads.
+  SharedScan shareScan(const Key& key, const std::string& queryId);
+
+  /// Evicts entries in LRU order until at least 'targetBytes' are freed.
+  /// Evicts all entries if 'targetBytes' is 0. Returns the freed bytes.
+  uint64_t shrink(uint64_t targetBytes);
+
+  uint64_t maxEntryBytes() const {
+    return maxEntryBytes_;
+  }
+
+  Stats stats() const;
+
+  /// Returns the process wide cache, nullptr if none is set. Scans use the
+  /// cache only if it is set.
+  static DecodedVectorCache* getInstance();
+
+  static void setInstance(DecodedVectorCache* cache);
+
+ private:
+  class Reclaimer;
+
+  struct Entry {
+    std::shared_ptr<const Batches> batches;
+    uint64_t bytes;
+    std::list<Key>::iterator lruPosition;
+  };
+
+  // Evicts entries until 'cachedBytes_' + 'bytes' is within 'capacity_'.
+  // Returns the freed bytes.
+  uint64_t makeSpaceLocked(uint64_t bytes);
+
+  // Evicts the least recently used entry. Returns its bytes.
+  uint64_t evictOneLocked();
+
+  // Removes 'load' from 'loads_' when its reader finishes or abandons it.
+  void removeLoad(const Key& key, const SharedLoad* load);
+
+  const uint64_t capacity_;
+  const uint64_t maxEntryBytes_;
+
+  // The pools are declared before the entries, so that the entries free
+  // their memory before the pools are destroyed.
+  std::shared_ptr<memory::MemoryPool> rootPool_;
+  std::shared_ptr<memory::MemoryPool> pool_;
+
+  mutable std::mutex mutex_;
+  // Keys from least to most recently used.
+  std::list<Key> lru_;
+  folly::F14FastMap<Key, Entry, KeyHasher> entries_;
+  // The loads in progress. A load is removed when it is finished or
+  // abandoned.
+  folly::F14FastMap<Key, std::shared_ptr<SharedLoad>, KeyHasher> loads_;
+  uint64_t cachedBytes_{0};
+  Stats stats_;
+};
+
+} // namespace facebook::velox::dwio::common
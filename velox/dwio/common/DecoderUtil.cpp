@@ -18,6 +18,10 @@
 #include "velox/common/base/Nulls.h"
 #include "velox/common/base/SimdUtil.h"
 
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
 namespace facebook::velox::dwio::common {
 
 int32_t nonNullRowsFromDense(
@@ -195,6 +199,65 @@ template bool nonNullRowsFromSparse<false, false>(
     uint64_t* resultNulls,
     int32_t& tailSkip);
 
+#ifdef __x86_64__
+namespace {
+
+// Minimum number of values for which scatterNonNulls() uses AVX-512.
+constexpr int32_t kMinAvx512Scatter = 32;
+
+// Scatters the values of 'data' from the last to the first with AVX-512
+// scatter, a vector of values at a time, until the first value of a vector is
+// already in place or fewer than a vector of values is left. Returns the
+// number of values left for the scalar loop. Since the destinations are
+// increasing and no destination is below its source, a vector never
+// overwrites the values of the vectors before it. Compiled for AVX-512
+// regardless of the build target.
+__attribute__((target("avx512f,avx512vl"))) int32_t scatterNonNulls32Avx512(
+    int32_t targetBegin,
+    int32_t numValues,
+    int32_t sourceBegin,
+    const int32_t* target,
+    int32_t* data) {
+  constexpr int32_t kLanes = 16;
+  auto index = numValues;
+  while (index >= kLanes) {
+    const auto first = index - kLanes;
+    if (target[targetBegin + first] == sourceBegin + first) {
+      break;
+    }
+    const auto values = _mm512_loadu_si512(data + sourceBegin + first);
+    const auto destinations = _mm512_loadu_si512(target + targetBegin + first);
+    _mm512_i32scatter_epi32(data, destinations, values, sizeof(int32_t));
+    index = first;
+  }
+  return index;
+}
+
+__attribute__((target("avx512f,avx512vl"))) int32_t scatterNonNulls64Avx512(
+    int32_t targetBegin,
+    int32_t numValues,
+    int32_t sourceBegin,
+    const int32_t* target,
+    int64_t* data) {
+  constexpr int32_t kLanes = 8;
+  auto index = numValues;
+  while (index >= kLanes) {
+    const auto first = index - kLanes;
+    if (target[targetBegin + first] == sourceBegin + first) {
+      break;
+    }
+    const auto values = _mm512_loadu_si512(data + sourceBegin + first);
+    const auto destinations = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(target + targetBegin + first));
+    _mm512_i32scatter_epi64(data, destinations, values, sizeof(int64_t));
+    index = first;
+  }
+  return index;
+}
+
+} // namespace
+#endif
+
 template <typename T>
 void scatterNonNulls(
     int32_t targetBegin,
@@ -202,6 +265,27 @@ void scatterNonNulls(
     int32_t sourceBegin,
     const int32_t* target,
     T* data) {
+#ifdef __x86_64__
+  if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
+    if (numValues >= kMinAvx512Scatter && process::hasAvx512()) {
+      if constexpr (sizeof(T) == 4) {
+        numValues = scatterNonNulls32Avx512(
+            targetBegin,
+            numValues,
+            sourceBegin,
+            target,
+            reinterpret_cast<int32_t*>(data));
+      } else {
+        numValues = scatterNonNulls64Avx512(
+            targetBegin,
+            numValues,
+            sourceBegin,
+            target,
+            reinterpret_cast<int64_t*>(data));
+      }
+    }
+  }
+#endif
   for (auto index = numValues - 1; index >= 0; --index) {
     auto destination = target[targetBegin + index];
     if (destination == sourceBegin + index) {
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/dwio/common/DeleteVector.h"
+
+#include <algorithm>
+
+#include "velox/common/base/BitUtil.h"
+
+namespace facebook::velox::dwio::common {
+
+void DeleteVector::build() {
+  if (pending_.empty()) {
+    return;
+  }
+  // Adds the rows of the existing chunks so that each chunk is made once.
+  for (const auto& chunk : chunks_) {
+    const uint64_t base = chunk.key << kChunkBits;
+    if (chunk.bitmap.empty()) {
+      for (auto low : chunk.array) {
+        pending_.push_back(base + low);
+      }
+    } else {
+      bits::forEachSetBit(chunk.bitmap.data(), 0, kChunkSize, [&](auto low) {
+        pending_.push_back(base + low);
+      });
+    }
+  }
+  std::sort(pending_.begin(), pending_.end());
+  pending_.erase(std::unique(pending_.begin(), pending_.end()), pending_.end());
+  chunks_.clear();
+  size_ = pending_.size();
+  for (size_t begin = 0; begin < pending_.size();) {
+    const uint64_t key = pending_[begin] >> kChunkBits;
+    auto end = begin + 1;
+    while (end < pending_.size() && pending_[end] >> kChunkBits == key) {
+      ++end;
+    }
+    Chunk chunk{key, {}, {}};
+    if (end - begin <= kMaxArraySize) {
+      chunk.array.reserve(end - begin);
+      for (auto i = begin; i < end; ++i) {
+        chunk.array.push_back(pending_[i] & (kChunkSize - 1));
+      }
+    } else {
+      chunk.bitmap.resize(kChunkSize / 64);
+      for (auto i = begin; i < end; ++i) {
+        bits::setBit(chunk.bitmap.data(), pending_[i] & (kChunkSize - 1));
+      }
+    }
+    chunks_.push_back(std::move(chunk));
+    begin = end;
+  }
+  pending_.clear();
+  pending_.shrink_to_fit();
+}
+
+std::vector<DeleteVector::Chunk>::const_iterator DeleteVector::lowerBound(
+    uint64_t key) const {
+  return std::lower_bound(
+      chunks_.begin(), chunks_.end(), key, [](const Chunk& chunk, uint64_t k) {
+        return chunk.key < k;
+      });
+}
+
+bool DeleteVector::contains(uint64_t row) const {
+  auto it = lowerBound(row >> kChunkBits);
+  if (it == chunks_.end() || it->key != row >> kChunkBits) {
+    return false;
+  }
+  const uint16_t low = row & (kChunkSize - 1);
+  if (!it->bitmap.empty()) {
+    return bits::isBitSet(it->bitmap.data(), low);
+  }
+  return std::binary_search(it->array.begin(), it->array.end(), low);
+}
+
+int32_t DeleteVector::fillBits(
+    uint64_t begin,
+    int32_t numRows,
+    uint64_t* bits) const {
+  std::fill(bits, bits + bits::nwords(numRows), 0);
+  const uint64_t end = begin + numRows;
+  int32_t numDeleted = 0;
+  for (auto it = lowerBound(begin >> kChunkBits);
+       it != chunks_.end() && it->key << kChunkBits < end;
+       ++it) {
+    const uint64_t base = it->key << kChunkBits;
+    const uint64_t first = std::max(begin, base);
+    const uint64_t last = std::min(end, base + kChunkSize);
+    if (!it->bitmap.empty()) {
+      // Copies 64 bits at a time.
+      bits::copyBits(
+          it->bitmap.data(), first - base, bits, first - begin, last - first);
+      numDeleted += bits::countBits(bits, first - begin, last - begin);
+      continue;
+    }
+    const auto firstLow = static_cast<uint16_t>(first - base);
+    auto low = std::lower_bound(it->array.begin(), it->array.end(), firstLow);
+    for (; low != it->array.end() && base + *low < last; ++low) {
+      bits::setBit(bits, base + *low - begin);
+      ++numDeleted;
+    }
+  }
+  return numDeleted;
+}
+
+uint64_t DeleteVector::memoryBytes() const {
+  uint64_t bytes = chunks_.capacity() * sizeof(Chunk);
+  for (const auto& chunk : chunks_) {
+    bytes += chunk.array.capacity() * sizeof(uint16_t) +
+        chunk.bitmap.capacity() * sizeof(uint64_t);
+  }
+  return bytes;
+}
+
+} // namespace facebook::velox::dwio::common
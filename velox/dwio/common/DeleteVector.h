@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace facebook::velox::dwio::common {
+
+/// The deleted row numbers of a file, e.g. from the positional delete files of
+/// a merge-on-read table. Stored like a roaring bitmap: the rows are grouped in
+/// chunks of 64K rows and a chunk is a sorted array of the low 16 bits of its
+/// rows if it has at most 4096 rows and a bitmap otherwise, so that no chunk
+/// takes more than 8KB. Rows are added with add() and the chunks are made by
+/// build(). A built DeleteVector is read-only and may be shared by concurrent
+/// scans of the file.
+class DeleteVector {
+ public:
+  static constexpr int32_t kChunkBits = 16;
+  static constexpr uint64_t kChunkSize = 1 << kChunkBits;
+  /// Chunks with more rows are bitmaps.
+  static constexpr int32_t kMaxArraySize = 4096;
+
+  /// Adds a deleted row. Rows may be added in any order and more than once.
+  void add(uint64_t row) {
+    pending_.push_back(row);
+  }
+
+  /// Adds the rows added since the last build() to the chunks.
+  void build();
+
+  /// Number of distinct deleted rows.
+  uint64_t size() const {
+    return size_;
+  }
+
+  bool contains(uint64_t row) const;
+
+  /// Sets bit i of 'bits' if row 'begin' + i is deleted and clears it
+  /// otherwise, for 'numRows' rows. Returns the number of deleted rows in the
+  /// range.
+  int32_t fillBits(uint64_t begin, int32_t numRows, uint64_t* bits) const;
+
+  /// Bytes of memory taken by the chunks.
+  uint64_t memoryBytes() const;
+
+ private:
+  struct Chunk {
+    // The row numbers of the chunk divided by kChunkSize.
+    uint64_t key;
+    // The low bits of the rows, sorted. Empty if the chunk is a bitmap.
+    std::vector<uint16_t> array;
+    // kChunkSize bits if the chunk has more than kMaxArraySize rows.
+    std::vector<uint64_t> bitmap;
+  };
+
+  // Returns the first chunk with a key of at least 'key'.
+  std::vector<Chunk>::const_iterator lowerBound(uint64_t key) const;
+
+  std::vector<uint64_t> pending_;
+  std::vector<Chunk> chunks_;
+  uint64_t size_{0};
+};
+
+} // namespace facebook::velox::dwio::common
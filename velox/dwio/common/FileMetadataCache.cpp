@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/FileMetadataCache.h"
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::dwio::common {
+
+FileMetadataCache::FileMetadataCache(uint64_t capacity) : capacity_(capacity) {
+  VELOX_CHECK_GT(capacity_, 0);
+}
+
+std::shared_ptr<const FileMetadataCache::Entry> FileMetadataCache::find(
+    const Key& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++stats_.numMisses;
+    return nullptr;
+  }
+  ++stats_.numHits;
+  lru_.splice(lru_.end(), lru_, it->second.lruPosition);
+  return it->second.entry;
+}
+
+void FileMetadataCache::insert(Key key, std::shared_ptr<const Entry> entry) {
+  VELOX_CHECK_NOT_NULL(entry);
+  const auto bytes = entry->memoryBytes();
+  if (bytes > capacity_) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    // A concurrent reader of the same file added the entry first.
+    lru_.splice(lru_.end(), lru_, it->second.lruPosition);
+    return;
+  }
+  while (!lru_.empty() && cachedBytes_ + bytes > capacity_) {
+    evictOneLocked();
+  }
+  lru_.push_back(key);
+  entries_[std::move(key)] =
+      CachedEntry{std::move(entry), bytes, std::prev(lru_.end())};
+  cachedBytes_ += bytes;
+}
+
+void FileMetadataCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  while (!lru_.empty()) {
+    evictOneLocked();
+  }
+}
+
+FileMetadataCache::Stats FileMetadataCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto stats = stats_;
+  stats.numEntries = entries_.size();
+  stats.cachedBytes = cachedBytes_;
+  return stats;
+}
+
+void FileMetadataCache::evictOneLocked() {
+  auto it = entries_.find(lru_.front());
+  VELOX_CHECK(it != entries_.end());
+  cachedBytes_ -= it->second.bytes;
+  entries_.erase(it);
+  lru_.pop_front();
+  ++stats_.numEvicts;
+}
+
+namespace {
+std::atomic<FileMetadataCache*>& instance() {
+  static std::atomic<FileMetadataCache*> cache{nullptr};
+  return cache;
+}
+} // namespace
+
+// static
+FileMetadataCache* FileMetadataCache::getInstance() {
+  return instance();
+}
+
+// static
+void FileMetadataCache::setInstance(FileMetadataCache* cache) {
+  instance() = cache;
+}
+
+} // namespace facebook::velox::dwio::common
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/container/F14Map.h>
+#include <folly/hash/Hash.h>
+#include <list>
+#include <mutex>
+
+#include "velox/dwio/common/Options.h"
+
+namespace facebook::velox::dwio::common {
+
+/// Caches the parsed file footers of the readers, e.g. the post script and
+/// footer protos of DWRF and the thrift FileMetaData of Parquet. A reader
+/// that opens a file whose footer is in the cache neither reads nor parses
+/// the footer. This pays off for short queries over many small files, where
+/// opening the file dominates. The cached objects are immutable and are
+/// shared by all readers of the file.
+///
+/// Files are identified by format, name and size. Like AsyncDataCache, this
+/// assumes that files are not modified in place. Entries are evicted in LRU
+/// order when the cache is over its capacity.
+///
+/// This object is thread-safe.
+class FileMetadataCache {
+ public:
+  /// A parsed footer. Subclassed by each reader.
+  class Entry {
+   public:
+    virtual ~Entry() = default;
+
+    /// Returns the memory held by 'this' in bytes.
+    virtual uint64_t memoryBytes() const = 0;
+  };
+
+  struct Key {
+    FileFormat format;
+    std::string fileName;
+    uint64_t fileSize;
+
+    bool operator==(const Key& other) const {
+      return format == other.format && fileSize == other.fileSize &&
+          fileName == other.fileName;
+    }
+  };
+
+  struct KeyHasher {
+    size_t operator()(const Key& key) const {
+      return folly::hash::hash_combine(
+          static_cast<int32_t>(key.format),
+          std::hash<std::string>()(key.fileName),
+          key.fileSize);
+    }
+  };
+
+  struct Stats {
+    uint64_t numHits{0};
+    uint64_t numMisses{0};
+    uint64_t numEvicts{0};
+    uint64_t numEntries{0};
+    uint64_t cachedBytes{0};
+  };
+
+  /// 'capacity' is the max bytes of cached entries.
+  explicit FileMetadataCache(uint64_t capacity);
+
+  /// Returns the entry for 'key' or nullptr if there is none.
+  std::shared_ptr<const Entry> find(const Key& key);
+
+  /// Adds 'entry' for 'key'. Evicts entries to make space. Entries over the
+  /// capacity are not added.
+  void insert(Key key, std::shared_ptr<const Entry> entry);
+
+  /// Removes all entries.
+  void clear();
+
+  Stats stats() const;
+
+  /// Returns the process wide cache, nullptr if none is set. Readers use the
+  /// cache only if it is set.
+  static FileMetadataCache* getInstance();
+
+  static void setInstance(FileMetadataCache* cache);
+
+ private:
+  struct CachedEntry {
+    std::shared_ptr<const Entry> entry;
+    uint64_t bytes;
+    std::list<Key>::iterator lruPosition;
+  };
+
+  // Evicts the least recently used entry.
+  void evictOneLocked();
+
+  const uint64_t capacity_;
+
+  mutable std::mutex mutex_;
+  // Keys from least to most recently used.
+  std::list<Key> lru_;
+  folly::F14FastMap<Key, CachedEntry, KeyHasher> entries_;
+  uint64_t cachedBytes_{0};
+  Stats stats_;
+};
+
+} // namespace facebook::velox::dwio::common
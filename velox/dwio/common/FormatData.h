@@ -95,6 +95,9 @@ class FormatData {
         const velox::common::MetadataFilter::LeafNode*,
         std::vector<uint64_t>>>
         metadataFilterResults;
+    // Subset of 'filterResult' excluded by Bloom filters after passing the
+    // min/max statistics. Not set by formats without Bloom filters.
+    std::vector<uint64_t> bloomFilterResult;
     int totalCount = 0;
   };
 
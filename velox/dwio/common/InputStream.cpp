@@ -33,6 +33,7 @@
 #include <type_traits>
 
 #include "velox/common/time/Timer.h"
+#include "velox/dwio/common/CoalescePolicy.h"
 #include "velox/dwio/common/exception/Exception.h"
 
 using ::facebook::velox::common::Region;
@@ -73,9 +74,16 @@ void ReadFileInputStream::read(
   logRead(offset, length, purpose);
   auto readStartMicros = getCurrentTimeMicro();
   std::string_view data_read = readFile_->pread(offset, length, buf);
+  const auto readMicros = getCurrentTimeMicro() - readStartMicros;
   if (stats_) {
     stats_->incRawBytesRead(length);
-    stats_->incTotalScanTime((getCurrentTimeMicro() - readStartMicros) * 1000);
+    stats_->incTotalScanTime(readMicros * 1000);
+    stats_->storageReadLatency().add(readMicros);
+    stats_->recordTrace(
+        IoTraceEntry::Tier::kStorage, getName(), offset, length, readMicros);
+  }
+  if (auto* policy = CoalescePolicy::getInstance()) {
+    policy->recordIo(getName(), length, readMicros);
   }
 
   DWIO_ENSURE_EQ(
@@ -100,7 +108,21 @@ void ReadFileInputStream::read(
     bufferSize += buffer.size();
   }
   logRead(offset, bufferSize, logType);
+  auto readStartMicros = getCurrentTimeMicro();
   auto size = readFile_->preadv(offset, buffers);
+  const auto readMicros = getCurrentTimeMicro() - readStartMicros;
+  if (stats_) {
+    stats_->storageReadLatency().add(readMicros);
+    stats_->recordTrace(
+        IoTraceEntry::Tier::kStorage,
+        getName(),
+        offset,
+        bufferSize,
+        readMicros);
+  }
+  if (auto* policy = CoalescePolicy::getInstance()) {
+    policy->recordIo(getName(), bufferSize, readMicros);
+  }
   DWIO_ENSURE_EQ(
       size,
       bufferSize,
@@ -142,10 +164,22 @@ void ReadFileInputStream::vread(
       [&](size_t acc, const auto& r) { return acc + r.length; });
   logRead(regions[0].offset, length, purpose);
   auto readStartMs = getCurrentTimeMs();
+  auto readStartMicros = getCurrentTimeMicro();
   readFile_->preadv(regions, iobufs);
   if (stats_) {
+    const auto readMicros = getCurrentTimeMicro() - readStartMicros;
     stats_->incRawBytesRead(length);
     stats_->incTotalScanTime(getCurrentTimeMs() - readStartMs);
+    stats_->storageReadLatency().add(readMicros);
+    // The regions are read together, so each gets the latency of the whole.
+    for (const auto& region : regions) {
+      stats_->recordTrace(
+          IoTraceEntry::Tier::kStorage,
+          getName(),
+          region.offset,
+          region.length,
+          readMicros);
+    }
   }
 }
 
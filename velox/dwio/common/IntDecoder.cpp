@@ -912,6 +912,125 @@ FOLLY_ALWAYS_INLINE void varintSwitch(
   }
 }
 
+#if XSIMD_WITH_AVX2
+
+namespace {
+
+// Masked VByte style decoding of varints of 1 or 2 bytes, which are most
+// values of length and dictionary index streams. The high bits of a 16 byte
+// window give the ends of the varints. If there are no continuation bits, the
+// window has 16 values of 1 byte. Otherwise the continuation bits of the first
+// 8 bytes select a shuffle that moves each varint of up to 2 bytes to its own
+// 16 bit lane.
+struct ShortVarintShuffle {
+  // Number of varints moved by 'shuffle'. 0 if the first varint is longer
+  // than 2 bytes.
+  int8_t numValues;
+  // Number of bytes taken by the varints moved by 'shuffle'.
+  int8_t numBytes;
+  alignas(16) int8_t shuffle[16];
+};
+
+std::array<ShortVarintShuffle, 256> makeShortVarintShuffles() {
+  std::array<ShortVarintShuffle, 256> shuffles;
+  for (auto mask = 0; mask < 256; ++mask) {
+    auto& entry = shuffles[mask];
+    entry.numValues = 0;
+    entry.numBytes = 0;
+    // A negative index zeros the byte.
+    memset(entry.shuffle, -1, sizeof(entry.shuffle));
+    int32_t start = 0;
+    for (auto i = 0; i < 8; ++i) {
+      if (mask & (1 << i)) {
+        continue;
+      }
+      if (i - start > 1) {
+        // Stop at the first varint of more than 2 bytes.
+        break;
+      }
+      entry.shuffle[entry.numValues * 2] = start;
+      if (i > start) {
+        entry.shuffle[entry.numValues * 2 + 1] = i;
+      }
+      ++entry.numValues;
+      start = i + 1;
+      entry.numBytes = start;
+    }
+  }
+  return shuffles;
+}
+
+const std::array<ShortVarintShuffle, 256> kShortVarintShuffles =
+    makeShortVarintShuffles();
+
+// Stores the 16 bytes of 'bytes' as 16 values of T at 'output'.
+template <typename T>
+FOLLY_ALWAYS_INLINE void store16x1(__m128i bytes, T* output) {
+  auto* out = reinterpret_cast<__m256i*>(output);
+  if constexpr (sizeof(T) == 2) {
+    _mm256_storeu_si256(out, _mm256_cvtepu8_epi16(bytes));
+  } else if constexpr (sizeof(T) == 4) {
+    _mm256_storeu_si256(out, _mm256_cvtepu8_epi32(bytes));
+    _mm256_storeu_si256(
+        out + 1, _mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8)));
+  } else {
+    for (auto i = 0; i < 4; ++i) {
+      _mm256_storeu_si256(out + i, _mm256_cvtepu8_epi64(bytes));
+      bytes = _mm_srli_si128(bytes, 4);
+    }
+  }
+}
+
+// Stores the 8 16 bit lanes of 'lanes' as 8 values of T at 'output'.
+template <typename T>
+FOLLY_ALWAYS_INLINE void store8x2(__m128i lanes, T* output) {
+  if constexpr (sizeof(T) == 2) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output), lanes);
+  } else if constexpr (sizeof(T) == 4) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(output), _mm256_cvtepu16_epi32(lanes));
+  } else {
+    auto* out = reinterpret_cast<__m256i*>(output);
+    _mm256_storeu_si256(out, _mm256_cvtepu16_epi64(lanes));
+    _mm256_storeu_si256(
+        out + 1, _mm256_cvtepu16_epi64(_mm_srli_si128(lanes, 8)));
+  }
+}
+
+// Decodes the varints of 1 or 2 bytes at the start of the 16 bytes at 'input'
+// to 'output' and returns the number of bytes decoded. Returns 0 if the first
+// varint is longer. Stores up to 16 values, so 'output' must have room for 16.
+template <typename T>
+FOLLY_ALWAYS_INLINE int32_t decodeShortVarints(const char* input, T*& output) {
+  const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+  const uint32_t mask = _mm_movemask_epi8(bytes);
+  if (mask == 0) {
+    store16x1(bytes, output);
+    output += 16;
+    return 16;
+  }
+  const auto& entry = kShortVarintShuffles[mask & 0xff];
+  if (entry.numValues == 0) {
+    return 0;
+  }
+  auto lanes = _mm_shuffle_epi8(
+      bytes, *reinterpret_cast<const __m128i*>(entry.shuffle));
+  lanes = _mm_or_si128(
+      _mm_and_si128(lanes, _mm_set1_epi16(0x7f)),
+      _mm_srli_epi16(_mm_and_si128(lanes, _mm_set1_epi16(0x7f00)), 1));
+  store8x2(lanes, output);
+  output += entry.numValues;
+  return entry.numBytes;
+}
+
+// Number of words decoded by varintSwitch() after decodeShortVarints() finds
+// a long varint, before it is tried again.
+constexpr int32_t kShortVarintRetryWords = 4;
+
+} // namespace
+
+#endif
+
 template <bool isSigned>
 template <typename T>
 void IntDecoder<isSigned>::bulkRead(uint64_t size, T* result) {
@@ -930,9 +1049,22 @@ void IntDecoder<isSigned>::bulkRead(uint64_t size, T* result) {
     // Decrement only if non-null to avoid asan error.
     pos -= maskSize;
   }
+  [[maybe_unused]] int32_t scalarWords = 0;
   while (output < end) {
     while (end >= output + 8 && bufferEnd - pos >= 8 + maskSize) {
       pos += maskSize;
+#if XSIMD_WITH_AVX2
+      if (carryoverBits == 0 && end - output >= 16 && bufferEnd - pos >= 16) {
+        if (scalarWords > 0) {
+          --scalarWords;
+        } else if (auto numBytes = decodeShortVarints(pos, output)) {
+          pos += numBytes - maskSize;
+          continue;
+        } else {
+          scalarWords = kShortVarintRetryWords;
+        }
+      }
+#endif
       const auto word = folly::loadUnaligned<uint64_t>(pos);
       const uint64_t controlBits = bits::extractBits<uint64_t>(word, mask);
       varintSwitch(word, controlBits, pos, output, carryover, carryoverBits);
@@ -981,6 +1113,7 @@ void IntDecoder<isSigned>::bulkReadRows(
   int32_t row = initialRow;
   int32_t endRow = rows.back() + 1;
   int32_t endRowIndex = rows.size();
+  [[maybe_unused]] int32_t scalarWords = 0;
   if (pos) {
     // Decrement only if non-null to avoid asan error.
     pos -= maskSize;
@@ -994,6 +1127,26 @@ void IntDecoder<isSigned>::bulkReadRows(
         pos += 8 - maskSize;
         continue;
       }
+#if XSIMD_WITH_AVX2
+      // Decodes 16 bytes at a time while the next 16 rows are all selected.
+      if (carryoverBits == 0 && nextRow == row &&
+          nextRowIndex + 16 < rows.size() &&
+          rows[nextRowIndex + 15] == row + 15 && bufferEnd - pos >= 16) {
+        auto orgOutput = output;
+        if (scalarWords > 0) {
+          --scalarWords;
+        } else if (auto numBytes = decodeShortVarints(pos, output)) {
+          const int32_t numDone = output - orgOutput;
+          row += numDone;
+          nextRowIndex += numDone;
+          nextRow = rows[nextRowIndex];
+          pos += numBytes - maskSize;
+          continue;
+        } else {
+          scalarWords = kShortVarintRetryWords;
+        }
+      }
+#endif
       const uint64_t controlBits = bits::extractBits<uint64_t>(word, mask);
       int32_t numEnds = __builtin_popcount(controlBits ^ 0xff);
       if (row != nextRow) {
@@ -16,9 +16,11 @@
 
 #include <glog/logging.h>
 #include <atomic>
+#include <cmath>
 #include <utility>
 
 #include "velox/dwio/common/IoStatistics.h"
+#include "velox/common/base/Exceptions.h"
 
 namespace facebook::velox::dwio::common {
 
@@ -104,13 +106,162 @@ void IoStatistics::merge(const IoStatistics& other) {
   read_.merge(other.read_);
   ramHit_.merge(other.ramHit_);
   ssdRead_.merge(other.ssdRead_);
+  peerRead_.merge(other.peerRead_);
   queryThreadIoLatency_.merge(other.queryThreadIoLatency_);
+  metadataCacheHit_.merge(other.metadataCacheHit_);
+  metadataCacheMiss_.merge(other.metadataCacheMiss_);
+  storageReadLatency_.merge(other.storageReadLatency_);
+  if (other.trace_) {
+    if (!trace_) {
+      trace_ = std::make_unique<IoTrace>(other.trace_->maxEntries());
+    }
+    trace_->merge(*other.trace_);
+  }
   std::lock_guard<std::mutex> l(operationStatsMutex_);
   for (auto& item : other.operationStats_) {
     operationStats_[item.first].merge(item.second);
   }
 }
 
+void IoTrace::record(
+    IoTraceEntry::Tier tier,
+    std::string_view path,
+    uint64_t offset,
+    uint64_t size,
+    uint64_t latencyMicros) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (entries_.size() >= static_cast<size_t>(maxEntries_)) {
+    ++numDropped_;
+    return;
+  }
+  entries_.push_back({tier, std::string(path), offset, size, latencyMicros});
+}
+
+std::vector<IoTraceEntry> IoTrace::entries() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return entries_;
+}
+
+uint64_t IoTrace::numDropped() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return numDropped_;
+}
+
+void IoTrace::merge(const IoTrace& other) {
+  auto otherEntries = other.entries();
+  const auto otherDropped = other.numDropped();
+  std::lock_guard<std::mutex> l(mutex_);
+  numDropped_ += otherDropped;
+  for (auto& entry : otherEntries) {
+    if (entries_.size() >= static_cast<size_t>(maxEntries_)) {
+      ++numDropped_;
+      continue;
+    }
+    entries_.push_back(std::move(entry));
+  }
+}
+
+// static
+std::string_view IoTrace::tierName(IoTraceEntry::Tier tier) {
+  switch (tier) {
+    case IoTraceEntry::Tier::kStorage:
+      return "storage";
+    case IoTraceEntry::Tier::kSsd:
+      return "ssd";
+    case IoTraceEntry::Tier::kPeer:
+      return "peer";
+    case IoTraceEntry::Tier::kRam:
+      return "ram";
+  }
+  VELOX_UNREACHABLE();
+}
+
+std::string IoTrace::serialize() const {
+  std::string text;
+  for (const auto& entry : entries()) {
+    text += fmt::format(
+        "{}\t{}\t{}\t{}\t{}\n",
+        tierName(entry.tier),
+        entry.offset,
+        entry.size,
+        entry.latencyMicros,
+        entry.path);
+  }
+  return text;
+}
+
+// static
+std::vector<IoTraceEntry> IoTrace::deserialize(std::string_view text) {
+  static const std::unordered_map<std::string_view, IoTraceEntry::Tier>
+      kTiers = {
+          {"storage", IoTraceEntry::Tier::kStorage},
+          {"ssd", IoTraceEntry::Tier::kSsd},
+          {"peer", IoTraceEntry::Tier::kPeer},
+          {"ram", IoTraceEntry::Tier::kRam}};
+  std::vector<IoTraceEntry> entries;
+  while (!text.empty()) {
+    auto end = text.find('\n');
+    auto line = text.substr(0, end);
+    text = end == std::string_view::npos ? std::string_view()
+                                         : text.substr(end + 1);
+    if (line.empty()) {
+      continue;
+    }
+    // The path is last and may have tabs.
+    std::array<std::string_view, 4> fields;
+    for (auto& field : fields) {
+      const auto tab = line.find('\t');
+      VELOX_CHECK_NE(tab, std::string_view::npos, "Bad IO trace line");
+      field = line.substr(0, tab);
+      line = line.substr(tab + 1);
+    }
+    auto it = kTiers.find(fields[0]);
+    VELOX_CHECK(it != kTiers.end(), "Bad IO trace tier: {}", fields[0]);
+    entries.push_back(
+        {it->second,
+         std::string(line),
+         std::stoull(std::string(fields[1])),
+         std::stoull(std::string(fields[2])),
+         std::stoull(std::string(fields[3]))});
+  }
+  return entries;
+}
+
+uint64_t IoLatencyHistogram::count() const {
+  uint64_t total = 0;
+  for (const auto& count : buckets_) {
+    total += count;
+  }
+  return total;
+}
+
+uint64_t IoLatencyHistogram::percentileMicros(double percentile) const {
+  std::array<uint64_t, kNumBuckets> counts;
+  uint64_t total = 0;
+  for (auto i = 0; i < kNumBuckets; ++i) {
+    counts[i] = buckets_[i];
+    total += counts[i];
+  }
+  if (total == 0) {
+    return 0;
+  }
+  const auto target = static_cast<uint64_t>(std::ceil(total * percentile));
+  uint64_t seen = 0;
+  for (auto i = 0; i < kNumBuckets; ++i) {
+    seen += counts[i];
+    if (seen >= target) {
+      return 1UL << i;
+    }
+  }
+  return 1UL << (kNumBuckets - 1);
+}
+
+void IoLatencyHistogram::merge(const IoLatencyHistogram& other) {
+  for (auto i = 0; i < kNumBuckets; ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+}
+
 void OperationCounters::merge(const OperationCounters& other) {
   resourceThrottleCount += other.resourceThrottleCount;
   localThrottleCount += other.localThrottleCount;
@@ -16,11 +16,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 #include <folly/dynamic.h>
 
@@ -63,6 +67,89 @@ class IoCounter {
   std::atomic<uint64_t> sum_{0};
 };
 
+/// Counts of IO latencies in power of two buckets of microseconds.
+class IoLatencyHistogram {
+ public:
+  static constexpr int32_t kNumBuckets = 24;
+
+  void add(uint64_t micros) {
+    ++buckets_[bucket(micros)];
+  }
+
+  uint64_t count() const;
+
+  /// Returns the upper bound in microseconds of the bucket that has the
+  /// latency at 'percentile', e.g. 0.99. Returns 0 if empty.
+  uint64_t percentileMicros(double percentile) const;
+
+  void merge(const IoLatencyHistogram& other);
+
+ private:
+  // Bucket 'i' has latencies below 2^i and at least 2^(i-1). The last bucket
+  // also has all larger latencies.
+  static int32_t bucket(uint64_t micros) {
+    return micros == 0 ? 0
+                       : std::min<int32_t>(
+                             kNumBuckets - 1, 64 - __builtin_clzll(micros));
+  }
+
+  std::array<std::atomic<uint64_t>, kNumBuckets> buckets_{};
+};
+
+/// A read recorded by IoTrace.
+struct IoTraceEntry {
+  /// Where the data came from.
+  enum class Tier : uint8_t { kStorage, kSsd, kPeer, kRam };
+
+  Tier tier;
+  std::string path;
+  uint64_t offset;
+  uint64_t size;
+  uint64_t latencyMicros;
+};
+
+/// Sequence of reads of a scan in the order they were made, for finding
+/// out whether a slow scan was slow because of cache misses, coalescing or
+/// storage latency, and for replaying the reads against a FileSystem. Keeps
+/// up to 'maxEntries' reads and counts the ones past that.
+class IoTrace {
+ public:
+  explicit IoTrace(int32_t maxEntries) : maxEntries_(maxEntries) {}
+
+  void record(
+      IoTraceEntry::Tier tier,
+      std::string_view path,
+      uint64_t offset,
+      uint64_t size,
+      uint64_t latencyMicros);
+
+  std::vector<IoTraceEntry> entries() const;
+
+  int32_t maxEntries() const {
+    return maxEntries_;
+  }
+
+  /// Number of reads not recorded because the trace was full.
+  uint64_t numDropped() const;
+
+  /// Appends the entries of 'other'.
+  void merge(const IoTrace& other);
+
+  /// Returns one line per entry with the tier, offset, size, latency and
+  /// path separated by tabs.
+  std::string serialize() const;
+
+  static std::vector<IoTraceEntry> deserialize(std::string_view text);
+
+  static std::string_view tierName(IoTraceEntry::Tier tier);
+
+ private:
+  const int32_t maxEntries_;
+  mutable std::mutex mutex_;
+  std::vector<IoTraceEntry> entries_;
+  uint64_t numDropped_{0};
+};
+
 class IoStatistics {
  public:
   uint64_t rawBytesRead() const;
@@ -91,6 +178,10 @@ class IoStatistics {
     return ssdRead_;
   }
 
+  IoCounter& peerRead() {
+    return peerRead_;
+  }
+
   IoCounter& ramHit() {
     return ramHit_;
   }
@@ -99,6 +190,41 @@ class IoStatistics {
     return queryThreadIoLatency_;
   }
 
+  IoCounter& metadataCacheHit() {
+    return metadataCacheHit_;
+  }
+
+  IoCounter& metadataCacheMiss() {
+    return metadataCacheMiss_;
+  }
+
+  IoLatencyHistogram& storageReadLatency() {
+    return storageReadLatency_;
+  }
+
+  /// Starts recording the reads in an IoTrace of up to 'maxEntries'. Must
+  /// be called before the reads start.
+  void enableTrace(int32_t maxEntries) {
+    trace_ = std::make_unique<IoTrace>(maxEntries);
+  }
+
+  /// Returns the trace of the reads or nullptr if tracing is not enabled.
+  IoTrace* trace() const {
+    return trace_.get();
+  }
+
+  /// Adds a read to the trace if tracing is enabled.
+  void recordTrace(
+      IoTraceEntry::Tier tier,
+      std::string_view path,
+      uint64_t offset,
+      uint64_t size,
+      uint64_t latencyMicros) {
+    if (trace_) {
+      trace_->record(tier, path, offset, size, latencyMicros);
+    }
+  }
+
   void incOperationCounters(
       const std::string& operation,
       const uint64_t resourceThrottleCount,
@@ -135,10 +261,25 @@ class IoStatistics {
   // reads.
   IoCounter ssdRead_;
 
+  // Read from the cache of a peer worker instead of storage.
+  IoCounter peerRead_;
+
   // Time spent by a query processing thread waiting for synchronously
   // issued IO or for an in-progress read-ahead to finish.
   IoCounter queryThreadIoLatency_;
 
+  // File footers found in FileMetadataCache. The sum is the memory of the
+  // parsed footers.
+  IoCounter metadataCacheHit_;
+
+  // File footers read and parsed while FileMetadataCache is enabled.
+  IoCounter metadataCacheMiss_;
+
+  // Latencies of the reads from storage through ReadFileInputStream.
+  IoLatencyHistogram storageReadLatency_;
+
+  std::unique_ptr<IoTrace> trace_;
+
   std::unordered_map<std::string, OperationCounters> operationStats_;
   mutable std::mutex operationStatsMutex_;
 };
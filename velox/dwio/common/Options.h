@@ -386,6 +386,7 @@ class ReaderOptions {
   int32_t loadQuantum_{kDefaultLoadQuantum};
   int32_t maxCoalesceDistance_{kDefaultCoalesceDistance};
   int64_t maxCoalesceBytes_{kDefaultCoalesceBytes};
+  int32_t cachePartition_{0};
   SerDeOptions serDeOptions;
   std::shared_ptr<encryption::DecrypterFactory> decrypterFactory_;
   uint64_t directorySizeGuess{kDefaultDirectorySizeGuess};
@@ -429,6 +430,7 @@ class ReaderOptions {
     fileColumnNamesReadAsLowerCase = other.fileColumnNamesReadAsLowerCase;
     maxCoalesceDistance_ = other.maxCoalesceDistance_;
     maxCoalesceBytes_ = other.maxCoalesceBytes_;
+    cachePartition_ = other.cachePartition_;
     return *this;
   }
 
@@ -515,6 +517,14 @@ class ReaderOptions {
     return *this;
   }
 
+  /**
+   * Set the AsyncDataCache partition that holds the data read from the file.
+   */
+  ReaderOptions& setCachePartition(int32_t partition) {
+    cachePartition_ = partition;
+    return *this;
+  }
+
   /**
    * Modify the serialization-deserialization options.
    */
@@ -594,6 +604,10 @@ class ReaderOptions {
     return maxCoalesceBytes_;
   }
 
+  int32_t cachePartition() const {
+    return cachePartition_;
+  }
+
   SerDeOptions& getSerDeOptions() {
     return serDeOptions;
   }
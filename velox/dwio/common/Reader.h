@@ -196,6 +196,17 @@ class Reader {
    */
   virtual std::unique_ptr<RowReader> createRowReader(
       const RowReaderOptions& options = {}) const = 0;
+
+  /**
+   * Get the file offsets of the units that can be read independently, e.g.
+   * stripes, in file order. A row reader with a range covers the units whose
+   * offset falls in the range.
+   * @return the offsets or an empty vector if the format does not provide
+   * them
+   */
+  virtual std::vector<uint64_t> stripeOffsets() const {
+    return {};
+  }
 };
 
 } // namespace facebook::velox::dwio::common
@@ -30,6 +30,7 @@ ScanSpec& ScanSpec::operator=(const ScanSpec& other) {
     extractValues_ = other.extractValues_;
     makeFlat_ = other.makeFlat_;
     filter_ = other.filter_;
+    multiColumnFilters_ = other.multiColumnFilters_;
     metadataFilters_ = other.metadataFilters_;
     selectivity_ = other.selectivity_;
     enableFilterReorder_ = other.enableFilterReorder_;
@@ -139,7 +140,7 @@ bool ScanSpec::hasFilter() const {
   if (hasFilter_.has_value()) {
     return hasFilter_.value();
   }
-  if (!isConstant() && filter_) {
+  if ((!isConstant() && filter_) || !multiColumnFilters_.empty()) {
     hasFilter_ = true;
     return true;
   }
@@ -394,6 +395,9 @@ std::string ScanSpec::toString() const {
     if (!metadataFilters_.empty()) {
       out << " metadata_filters(" << metadataFilters_.size() << ")";
     }
+    if (!multiColumnFilters_.empty()) {
+      out << " multi_column_filters(" << multiColumnFilters_.size() << ")";
+    }
   }
   if (!children_.empty()) {
     out << " (";
@@ -416,7 +420,24 @@ std::shared_ptr<ScanSpec> ScanSpec::removeChild(const ScanSpec* child) {
   return nullptr;
 }
 
+void ScanSpec::addMultiColumnFilter(
+    std::shared_ptr<MultiColumnFilter> filter) {
+  for (const auto& name : filter->inputs()) {
+    auto* child = childByName(name);
+    VELOX_CHECK_NOT_NULL(
+        child, "Input of multi-column filter not found: {}", name);
+    child->setExtractValues(true);
+  }
+  multiColumnFilters_.push_back(std::move(filter));
+  hasFilter_.reset();
+}
+
 void ScanSpec::addFilter(const Filter& filter) {
+  if (filter_ && filter.kind() == FilterKind::kBloomFilterValues) {
+    // Typed filters do not know how to merge with a Bloom filter.
+    filter_ = filter.mergeWith(filter_.get());
+    return;
+  }
   filter_ = filter_ ? filter_->mergeWith(&filter) : filter.clone();
 }
 
@@ -33,6 +33,26 @@ class ColumnStatistics;
 }
 namespace common {
 
+// A filter on several children of a struct, e.g. a > b or (a, b) IN (...),
+// which cannot be expressed as a Filter on a single column. The struct
+// reader evaluates it after the children with filters and the inputs of the
+// filter are read and before the other children, which are then read only
+// for the rows that pass.
+class MultiColumnFilter {
+ public:
+  virtual ~MultiColumnFilter() = default;
+
+  // Names of the children of the struct the filter reads.
+  virtual const std::vector<std::string>& inputs() const = 0;
+
+  // 'input' has a child for each of inputs() in the same order. 'passed' has
+  // a bit for each row of 'input'. The rows with the bit set are evaluated
+  // and the bits of the rows that do not pass are cleared. Rows with the bit
+  // clear on entry are not evaluated, so that a filter is not applied to rows
+  // excluded by a preceding one.
+  virtual void filter(const RowVector& input, uint64_t* passed) = 0;
+};
+
 // Describes the filtering and value extraction for a
 // SelectiveColumnReader. This is owned by the TableScan Operator and
 // is passed to SelectiveColumnReaders at construction.  This is
@@ -77,6 +97,16 @@ class ScanSpec {
 
   void addFilter(const Filter&);
 
+  // Adds a filter on several children of 'this', which must correspond to a
+  // struct. The values of the inputs of the filter are extracted even if they
+  // are not projected out. Filters are applied in the order they are added.
+  void addMultiColumnFilter(std::shared_ptr<MultiColumnFilter> filter);
+
+  const std::vector<std::shared_ptr<MultiColumnFilter>>& multiColumnFilters()
+      const {
+    return multiColumnFilters_;
+  }
+
   void setMaxArrayElementsCount(vector_size_t count) {
     maxArrayElementsCount_ = count;
   }
@@ -377,6 +407,9 @@ class ScanSpec {
   bool makeFlat_ = false;
   std::shared_ptr<common::Filter> filter_;
 
+  // Filters on several children of 'this'.
+  std::vector<std::shared_ptr<MultiColumnFilter>> multiColumnFilters_;
+
   // Filters that will be only used for row group filtering based on metadata.
   // The conjunctions among these filters are tracked in MetadataFilter, with
   // the pointers to LeafNodes are stored here.  We need to keep these pointers
@@ -18,6 +18,7 @@
 
 #include <vector>
 
+#include "velox/buffer/Buffer.h"
 #include "velox/dwio/common/DataBuffer.h"
 #include "velox/dwio/common/InputStream.h"
 #include "velox/dwio/common/wrap/zero-copy-stream-wrapper.h"
@@ -57,6 +58,14 @@ class SeekableInputStream : public google::protobuf::io::ZeroCopyInputStream {
   // ORC/DWRF stream address.
   virtual size_t positionSize() = 0;
 
+  // Returns a buffer that keeps the bytes last returned by Next() valid and
+  // unchanged, or nullptr if they may be overwritten, e.g. by decompressing
+  // into a reused buffer. Readers may make vectors that refer to these bytes
+  // instead of copying them.
+  virtual BufferPtr currentBufferOwner() const {
+    return nullptr;
+  }
+
   void readFully(char* buffer, size_t bufferSize);
 };
 
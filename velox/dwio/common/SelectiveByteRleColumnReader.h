@@ -134,11 +134,23 @@ void SelectiveByteRleColumnReader::processValueHook(
     ValueHook* hook) {
   using namespace facebook::velox::aggregate;
   switch (hook->kind()) {
-    case aggregate::AggregationHook::kSumBigintToBigint:
+    case aggregate::AggregationHook::kSumTinyintToBigint:
       readHelper<Reader, velox::common::AlwaysTrue, isDense>(
           &dwio::common::alwaysTrue(),
           rows,
-          dwio::common::ExtractToHook<SumHook<int64_t, int64_t>>(hook));
+          dwio::common::ExtractToHook<SumHook<int8_t, int64_t>>(hook));
+      break;
+    case aggregate::AggregationHook::kTinyintMax:
+      readHelper<Reader, velox::common::AlwaysTrue, isDense>(
+          &dwio::common::alwaysTrue(),
+          rows,
+          dwio::common::ExtractToHook<MinMaxHook<int8_t, false>>(hook));
+      break;
+    case aggregate::AggregationHook::kTinyintMin:
+      readHelper<Reader, velox::common::AlwaysTrue, isDense>(
+          &dwio::common::alwaysTrue(),
+          rows,
+          dwio::common::ExtractToHook<MinMaxHook<int8_t, true>>(hook));
       break;
     default:
       readHelper<Reader, velox::common::AlwaysTrue, isDense>(
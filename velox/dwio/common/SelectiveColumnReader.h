@@ -608,6 +608,10 @@ class SelectiveColumnReader {
   std::vector<BufferPtr> stringBuffers_;
   // Writable contents of 'stringBuffers_.back()'.
   char* FOLLY_NULLABLE rawStringBuffer_ = nullptr;
+  // Range of stream memory kept alive by a buffer in 'stringBuffers_', e.g. a
+  // pinned cache entry. Strings inside the range are referenced, not copied.
+  const char* FOLLY_NULLABLE ownedStringsBegin_ = nullptr;
+  const char* FOLLY_NULLABLE ownedStringsEnd_ = nullptr;
   // True if a vector can acquire a pin to a stream's buffer and refer
   // to that as its values.
   bool mayUseStreamBuffer_ = false;
@@ -639,6 +643,12 @@ inline void SelectiveColumnReader::addValue(const folly::StringPiece value) {
         StringView(value.data(), size);
     return;
   }
+  if (value.data() >= ownedStringsBegin_ &&
+      value.data() + size <= ownedStringsEnd_) {
+    reinterpret_cast<StringView*>(rawValues_)[numValues_++] =
+        StringView(value.data(), size);
+    return;
+  }
   if (rawStringBuffer_ && rawStringUsed_ + size <= rawStringSize_) {
     memcpy(rawStringBuffer_ + rawStringUsed_, value.data(), size);
     reinterpret_cast<StringView*>(rawValues_)[numValues_++] =
@@ -52,6 +52,11 @@ class SelectiveIntegerColumnReader : public SelectiveColumnReader {
   template <typename Reader, bool isDence>
   void processValueHook(RowSet rows, ValueHook* hook);
 
+  // Reads into the specialized 'THook' if it consumes values of the width
+  // being decoded. Falls back to the generic virtual hook otherwise.
+  template <typename Reader, bool isDense, typename THook, typename TValue>
+  void readToHook(RowSet rows, ValueHook* hook);
+
   // Instantiates a Visitor based on type, isDense, value processing.
   template <
       typename Reader,
@@ -170,28 +175,58 @@ void SelectiveIntegerColumnReader::processFilter(
   }
 }
 
+template <typename Reader, bool isDense, typename THook, typename TValue>
+void SelectiveIntegerColumnReader::readToHook(RowSet rows, ValueHook* hook) {
+  if (valueSize_ == sizeof(TValue)) {
+    readHelper<Reader, velox::common::AlwaysTrue, isDense>(
+        &alwaysTrue(), rows, ExtractToHook<THook>(hook));
+  } else {
+    readHelper<Reader, velox::common::AlwaysTrue, isDense>(
+        &alwaysTrue(), rows, ExtractToGenericHook(hook));
+  }
+}
+
 template <typename Reader, bool isDense>
 void SelectiveIntegerColumnReader::processValueHook(
     RowSet rows,
     ValueHook* hook) {
+  using namespace facebook::velox::aggregate;
   switch (hook->kind()) {
-    case aggregate::AggregationHook::kSumBigintToBigint:
-      readHelper<Reader, velox::common::AlwaysTrue, isDense>(
-          &alwaysTrue(),
-          rows,
-          ExtractToHook<aggregate::SumHook<int64_t, int64_t>>(hook));
+    case AggregationHook::kSumBigintToBigint:
+      readToHook<Reader, isDense, SumHook<int64_t, int64_t>, int64_t>(
+          rows, hook);
       break;
-    case aggregate::AggregationHook::kBigintMax:
-      readHelper<Reader, velox::common::AlwaysTrue, isDense>(
-          &dwio::common::alwaysTrue(),
-          rows,
-          ExtractToHook<aggregate::MinMaxHook<int64_t, false>>(hook));
+    case AggregationHook::kSumIntegerToBigint:
+      readToHook<Reader, isDense, SumHook<int32_t, int64_t>, int32_t>(
+          rows, hook);
       break;
-    case aggregate::AggregationHook::kBigintMin:
-      readHelper<Reader, velox::common::AlwaysTrue, isDense>(
-          &alwaysTrue(),
-          rows,
-          ExtractToHook<aggregate::MinMaxHook<int64_t, true>>(hook));
+    case AggregationHook::kSumSmallintToBigint:
+      readToHook<Reader, isDense, SumHook<int16_t, int64_t>, int16_t>(
+          rows, hook);
+      break;
+    case AggregationHook::kBigintMax:
+      readToHook<Reader, isDense, MinMaxHook<int64_t, false>, int64_t>(
+          rows, hook);
+      break;
+    case AggregationHook::kBigintMin:
+      readToHook<Reader, isDense, MinMaxHook<int64_t, true>, int64_t>(
+          rows, hook);
+      break;
+    case AggregationHook::kIntegerMax:
+      readToHook<Reader, isDense, MinMaxHook<int32_t, false>, int32_t>(
+          rows, hook);
+      break;
+    case AggregationHook::kIntegerMin:
+      readToHook<Reader, isDense, MinMaxHook<int32_t, true>, int32_t>(
+          rows, hook);
+      break;
+    case AggregationHook::kSmallintMax:
+      readToHook<Reader, isDense, MinMaxHook<int16_t, false>, int16_t>(
+          rows, hook);
+      break;
+    case AggregationHook::kSmallintMin:
+      readToHook<Reader, isDense, MinMaxHook<int16_t, true>, int16_t>(
+          rows, hook);
       break;
     default:
       readHelper<Reader, velox::common::AlwaysTrue, isDense>(
@@ -16,6 +16,7 @@
 
 #include "velox/dwio/common/SelectiveStructColumnReader.h"
 
+#include "velox/common/base/SimdUtil.h"
 #include "velox/dwio/common/ColumnLoader.h"
 
 namespace facebook::velox::dwio::common {
@@ -96,6 +97,7 @@ void SelectiveStructColumnReaderBase::read(
     const uint64_t* incomingNulls) {
   numReads_ = scanSpec_->newRead();
   prepareRead<char>(offset, rows, incomingNulls);
+  multiColumnFilterValues_.clear();
   RowSet activeRows = rows;
   if (hasMutation_) {
     // We handle the mutation after prepareRead so that output rows and format
@@ -103,10 +105,17 @@ void SelectiveStructColumnReaderBase::read(
     VELOX_DCHECK(!nullsInReadRange_, "Only top level can have mutation");
     VELOX_DCHECK_EQ(
         rows.back(), rows.size() - 1, "Top level should have a dense row set");
-    bits::forEachUnsetBit(
-        mutation_->deletedRows, 0, rows.back() + 1, [&](auto i) {
-          addOutputRow(i);
-        });
+    // The rows that are not deleted are the set bits of the inverted mask,
+    // which are extracted with SIMD.
+    const auto numRows = rows.back() + 1;
+    const auto numWords = bits::nwords(numRows);
+    notDeletedRows_.resize(numWords);
+    for (auto i = 0; i < numWords; ++i) {
+      notDeletedRows_[i] = ~mutation_->deletedRows[i];
+    }
+    outputRows_.resize(numRows);
+    outputRows_.resize(simd::indicesOfSetBits(
+        notDeletedRows_.data(), 0, numRows, outputRows_.data()));
     if (outputRows_.empty()) {
       readOffset_ = offset + rows.back() + 1;
       return;
@@ -132,12 +141,26 @@ void SelectiveStructColumnReaderBase::read(
 
   auto& childSpecs = scanSpec_->children();
   VELOX_CHECK(!childSpecs.empty());
+  bool multiColumnFiltersApplied = scanSpec_->multiColumnFilters().empty();
   for (size_t i = 0; i < childSpecs.size(); ++i) {
     auto& childSpec = childSpecs[i];
+    if (!multiColumnFiltersApplied && !childSpec->hasFilter()) {
+      // The children with filters come first, so the remaining children are
+      // read only for the rows that pass the multi-column filters.
+      multiColumnFiltersApplied = true;
+      activeRows = applyMultiColumnFilters(offset, activeRows, structNulls);
+      if (activeRows.empty()) {
+        break;
+      }
+    }
     if (isChildConstant(*childSpec)) {
       continue;
     }
     auto fieldIndex = childSpec->subscript();
+    if (multiColumnFilterValues_.count(fieldIndex) > 0) {
+      // Read as input of a multi-column filter.
+      continue;
+    }
     auto reader = children_.at(fieldIndex);
     if (reader->isTopLevel() && childSpec->projectOut() &&
         !childSpec->hasFilter() && !childSpec->extractValues()) {
@@ -166,6 +189,10 @@ void SelectiveStructColumnReaderBase::read(
     }
   }
 
+  if (!multiColumnFiltersApplied && !activeRows.empty()) {
+    activeRows = applyMultiColumnFilters(offset, activeRows, structNulls);
+  }
+
   // If this adds nulls, the field readers will miss a value for each null added
   // here.
   recordParentNullsInChildren(offset, rows);
@@ -177,6 +204,98 @@ void SelectiveStructColumnReaderBase::read(
   readOffset_ = offset + rows.back() + 1;
 }
 
+RowSet SelectiveStructColumnReaderBase::applyMultiColumnFilters(
+    vector_size_t offset,
+    RowSet rows,
+    const uint64_t* structNulls) {
+  // 'rows' may be the output rows of a child reader, which change when the
+  // child is read again.
+  multiColumnFilterRows_.assign(rows.begin(), rows.end());
+  rows = multiColumnFilterRows_;
+  const auto numRows = rows.size();
+  auto& rowType = requestedType_->type()->asRow();
+  multiColumnFilterPassed_.assign(bits::nwords(numRows), ~0ULL);
+  for (auto& filter : scanSpec_->multiColumnFilters()) {
+    if (bits::isAllSet(multiColumnFilterPassed_.data(), 0, numRows, false)) {
+      break;
+    }
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    std::vector<VectorPtr> inputs;
+    for (const auto& name : filter->inputs()) {
+      auto* childSpec = scanSpec_->childByName(name);
+      VectorPtr values;
+      if (childSpec->isConstant()) {
+        values = BaseVector::wrapInConstant(
+            numRows, 0, childSpec->constantValue());
+      } else if (isChildConstant(*childSpec)) {
+        // A column missing from the file reads as null.
+        values = BaseVector::createNullConstant(
+            rowType.containsChild(name) ? rowType.findChild(name) : UNKNOWN(),
+            numRows,
+            &memoryPool_);
+      } else {
+        auto fieldIndex = childSpec->subscript();
+        auto it = multiColumnFilterValues_.find(fieldIndex);
+        if (it != multiColumnFilterValues_.end()) {
+          values = it->second;
+        } else {
+          auto* reader = children_.at(fieldIndex);
+          if (!childSpec->hasFilter()) {
+            advanceFieldReader(reader, offset);
+            reader->read(offset, rows, structNulls);
+          }
+          if (reader->requestedType()->isRow()) {
+            values =
+                BaseVector::create(reader->requestedType(), 0, &memoryPool_);
+          }
+          // The values are kept for getValues() since the reader may hand out
+          // its string buffers only once.
+          reader->getValues(rows, &values);
+          multiColumnFilterValues_[fieldIndex] = values;
+        }
+      }
+      names.push_back(name);
+      types.push_back(values->type());
+      inputs.push_back(std::move(values));
+    }
+    auto input = std::make_shared<RowVector>(
+        &memoryPool_,
+        ROW(std::move(names), std::move(types)),
+        nullptr,
+        numRows,
+        std::move(inputs));
+    filter->filter(*input, multiColumnFilterPassed_.data());
+  }
+  multiColumnFilterPassedRows_.clear();
+  bits::forEachSetBit(
+      multiColumnFilterPassed_.data(), 0, numRows, [&](vector_size_t i) {
+        multiColumnFilterPassedRows_.push_back(rows[i]);
+      });
+  return multiColumnFilterPassedRows_;
+}
+
+VectorPtr SelectiveStructColumnReaderBase::multiColumnFilterValues(
+    const VectorPtr& values,
+    RowSet rows) {
+  if (rows.size() == multiColumnFilterRows_.size()) {
+    return values;
+  }
+  // 'rows' is a subset of the rows the values were extracted for.
+  auto indices = allocateIndices(rows.size(), &memoryPool_);
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  vector_size_t position = 0;
+  for (auto i = 0; i < rows.size(); ++i) {
+    while (multiColumnFilterRows_[position] < rows[i]) {
+      ++position;
+    }
+    VELOX_DCHECK_EQ(multiColumnFilterRows_[position], rows[i]);
+    rawIndices[i] = position;
+  }
+  return BaseVector::wrapInDictionary(
+      nullptr, std::move(indices), rows.size(), values);
+}
+
 void SelectiveStructColumnReaderBase::recordParentNullsInChildren(
     vector_size_t offset,
     RowSet rows) {
@@ -203,6 +322,9 @@ bool SelectiveStructColumnReaderBase::isChildConstant(
   // Returns true if the child has a constant set in the ScanSpec, or if the
   // file doesn't have this child (in which case it will be treated as null).
   return childSpec.isConstant() ||
+      // A key of a flat map read as struct that is missing from the stripe.
+      (fileType_->type()->kind() == TypeKind::MAP &&
+       childSpec.subscript() == kConstantChildSpecSubscript) ||
       // The below check is trying to determine if this is a missing field in a
       // struct that should be constant null.
       (!isRoot_ && // If we're in the root struct channel is meaningless in this
@@ -348,6 +470,11 @@ void SelectiveStructColumnReaderBase::getValues(
       setNullField(rows.size(), childResult);
       continue;
     }
+    if (auto it = multiColumnFilterValues_.find(index);
+        it != multiColumnFilterValues_.end()) {
+      childResult = multiColumnFilterValues(it->second, rows);
+      continue;
+    }
     if (childSpec->extractValues() || childSpec->hasFilter() ||
         !children_[index]->isTopLevel()) {
       children_[index]->getValues(rows, &childResult);
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <folly/container/F14Map.h>
+
 #include "velox/dwio/common/SelectiveColumnReaderInternal.h"
 
 namespace facebook::velox::dwio::common {
@@ -126,6 +128,17 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
   // need to read it).
   bool isChildConstant(const velox::common::ScanSpec& childSpec) const;
 
+  // Reads the inputs of the multi-column filters of 'scanSpec_' that are not
+  // yet read for 'rows' and applies the filters. Returns the rows that pass.
+  RowSet applyMultiColumnFilters(
+      vector_size_t offset,
+      RowSet rows,
+      const uint64_t* structNulls);
+
+  // Returns 'values' of an input of a multi-column filter for 'rows', a
+  // subset of 'multiColumnFilterRows_'.
+  VectorPtr multiColumnFilterValues(const VectorPtr& values, RowSet rows);
+
   const std::shared_ptr<const dwio::common::TypeWithId> requestedType_;
 
   std::vector<SelectiveColumnReader*> children_;
@@ -145,6 +158,9 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
   // around for lazy columns.
   bool hasMutation_ = false;
 
+  // Complement of the deleted rows of 'mutation_'.
+  std::vector<uint64_t> notDeletedRows_;
+
   // Context information obtained from ExceptionContext. Stored here
   // so that LazyVector readers under this can add this to their
   // ExceptionContext. Allows contextualizing reader errors to split
@@ -155,6 +171,13 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
   // Whether or not this is the root Struct that represents entire rows of the
   // table.
   const bool isRoot_;
+
+  // Values of the inputs of multi-column filters in the last read, keyed on
+  // the child subscript, for 'multiColumnFilterRows_'.
+  folly::F14FastMap<int32_t, VectorPtr> multiColumnFilterValues_;
+  std::vector<vector_size_t> multiColumnFilterRows_;
+  std::vector<uint64_t> multiColumnFilterPassed_;
+  std::vector<vector_size_t> multiColumnFilterPassedRows_;
 };
 
 struct SelectiveStructColumnReader : SelectiveStructColumnReaderBase {
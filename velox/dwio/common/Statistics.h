@@ -523,12 +523,23 @@ struct RuntimeStatistics {
   // Number of strides (row groups) skipped based on statistics.
   int64_t skippedStrides{0};
 
+  // Number of the strides in 'skippedStrides' skipped based on Bloom filters
+  // after passing the min/max statistics.
+  int64_t skippedStridesByBloomFilter{0};
+
   std::unordered_map<std::string, RuntimeCounter> toMap() {
-    return {
+    std::unordered_map<std::string, RuntimeCounter> result = {
         {"skippedSplits", RuntimeCounter(skippedSplits)},
         {"skippedSplitBytes",
          RuntimeCounter(skippedSplitBytes, RuntimeCounter::Unit::kBytes)},
         {"skippedStrides", RuntimeCounter(skippedStrides)}};
+    // Reported only when set, most files have no Bloom filters.
+    if (skippedStridesByBloomFilter > 0) {
+      result.emplace(
+          "skippedStridesByBloomFilter",
+          RuntimeCounter(skippedStridesByBloomFilter));
+    }
+    return result;
   }
 };
 
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/compression/AsyncDecompressor.h"
+
+#include <folly/Synchronized.h>
+#include <folly/futures/Future.h>
+
+#include <snappy.h>
+#include <zlib.h>
+#include <zstd.h>
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::dwio::common::compression {
+
+using velox::common::CompressionKind;
+
+namespace {
+folly::Synchronized<std::shared_ptr<AsyncDecompressor>>& decompressorHolder() {
+  static folly::Synchronized<std::shared_ptr<AsyncDecompressor>> holder;
+  return holder;
+}
+
+uint64_t inflateGzip(const DecompressionRequest& request) {
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  constexpr int kWindowBits = 15;
+  // Accept both zlib and gzip headers.
+  constexpr int kDetectHeader = 32;
+  auto ret = inflateInit2(&stream, kWindowBits | kDetectHeader);
+  VELOX_CHECK_EQ(
+      ret, Z_OK, "zlib inflateInit failed: {}", stream.msg ? stream.msg : "");
+  stream.next_in = const_cast<Bytef*>(
+      reinterpret_cast<const Bytef*>(request.source));
+  stream.avail_in = static_cast<uInt>(request.sourceLength);
+  stream.next_out = reinterpret_cast<Bytef*>(request.destination);
+  stream.avail_out = static_cast<uInt>(request.destinationLength);
+  ret = inflate(&stream, Z_FINISH);
+  auto size = stream.total_out;
+  std::string message = stream.msg ? stream.msg : "";
+  inflateEnd(&stream);
+  VELOX_CHECK_EQ(ret, Z_STREAM_END, "zlib inflate failed: {}", message);
+  return size;
+}
+} // namespace
+
+bool ExecutorDecompressor::supports(CompressionKind kind) const {
+  switch (kind) {
+    case CompressionKind::CompressionKind_ZSTD:
+    case CompressionKind::CompressionKind_SNAPPY:
+    case CompressionKind::CompressionKind_GZIP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// static
+uint64_t ExecutorDecompressor::decompressOne(
+    const DecompressionRequest& request) {
+  switch (request.kind) {
+    case CompressionKind::CompressionKind_ZSTD: {
+      auto ret = ZSTD_decompress(
+          request.destination,
+          request.destinationLength,
+          request.source,
+          request.sourceLength);
+      VELOX_CHECK(
+          !ZSTD_isError(ret),
+          "ZSTD returned an error: {}",
+          ZSTD_getErrorName(ret));
+      return ret;
+    }
+    case CompressionKind::CompressionKind_SNAPPY: {
+      size_t length;
+      VELOX_CHECK(
+          snappy::GetUncompressedLength(
+              request.source, request.sourceLength, &length),
+          "Snappy uncompressed size not available");
+      VELOX_CHECK_LE(length, request.destinationLength);
+      VELOX_CHECK(
+          snappy::RawUncompress(
+              request.source, request.sourceLength, request.destination),
+          "Snappy decompress failed");
+      return length;
+    }
+    case CompressionKind::CompressionKind_GZIP:
+      return inflateGzip(request);
+    default:
+      VELOX_UNSUPPORTED(
+          "Unsupported compression for ExecutorDecompressor: {}",
+          velox::common::compressionKindToString(request.kind));
+  }
+}
+
+folly::SemiFuture<std::vector<uint64_t>> ExecutorDecompressor::decompress(
+    std::vector<DecompressionRequest> requests) {
+  std::vector<folly::Future<uint64_t>> futures;
+  futures.reserve(requests.size());
+  for (auto& request : requests) {
+    futures.push_back(folly::via(
+        executor_, [request]() { return decompressOne(request); }));
+  }
+  return folly::collect(std::move(futures));
+}
+
+void setAsyncDecompressor(std::shared_ptr<AsyncDecompressor> decompressor) {
+  *decompressorHolder().wlock() = std::move(decompressor);
+}
+
+std::shared_ptr<AsyncDecompressor> asyncDecompressor() {
+  return *decompressorHolder().rlock();
+}
+
+} // namespace facebook::velox::dwio::common::compression
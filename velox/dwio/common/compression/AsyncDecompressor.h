@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Executor.h>
+#include <folly/futures/Future.h>
+
+#include "velox/common/compression/Compression.h"
+
+namespace facebook::velox::dwio::common::compression {
+
+/// One buffer to decompress. 'source' and 'destination' are not owned and
+/// must stay valid until the decompression completes.
+struct DecompressionRequest {
+  velox::common::CompressionKind kind;
+  const char* source;
+  uint64_t sourceLength;
+  char* destination;
+  uint64_t destinationLength;
+};
+
+/// Decompresses batches of independent buffers, e.g. all the pages of a
+/// Parquet column chunk. An implementation may offload to a hardware
+/// accelerator or spread the work over threads. Readers use the front end set
+/// with setAsyncDecompressor() and fall back to their synchronous codecs if
+/// there is none or it does not support the compression kind.
+class AsyncDecompressor {
+ public:
+  virtual ~AsyncDecompressor() = default;
+
+  /// True if buffers of 'kind' can be submitted.
+  virtual bool supports(velox::common::CompressionKind kind) const = 0;
+
+  /// Starts decompressing 'requests'. The result is the decompressed size of
+  /// each request, in request order. An error in any request fails the
+  /// result.
+  virtual folly::SemiFuture<std::vector<uint64_t>> decompress(
+      std::vector<DecompressionRequest> requests) = 0;
+};
+
+/// Decompresses each request as a separate task on 'executor' with
+/// the zstd, snappy and zlib libraries.
+class ExecutorDecompressor : public AsyncDecompressor {
+ public:
+  explicit ExecutorDecompressor(folly::Executor* executor)
+      : executor_(executor) {}
+
+  bool supports(velox::common::CompressionKind kind) const override;
+
+  folly::SemiFuture<std::vector<uint64_t>> decompress(
+      std::vector<DecompressionRequest> requests) override;
+
+  /// Decompresses 'request' on the calling thread and returns the
+  /// decompressed size.
+  static uint64_t decompressOne(const DecompressionRequest& request);
+
+ private:
+  folly::Executor* const executor_;
+};
+
+/// Sets the process wide AsyncDecompressor. nullptr, the default, means that
+/// readers decompress synchronously.
+void setAsyncDecompressor(std::shared_ptr<AsyncDecompressor> decompressor);
+
+/// Returns the AsyncDecompressor set with setAsyncDecompressor() or nullptr.
+std::shared_ptr<AsyncDecompressor> asyncDecompressor();
+
+} // namespace facebook::velox::dwio::common::compression
@@ -150,10 +150,20 @@ bool PagedInputStream::Next(const void** data, int32_t* size) {
 
   // perform decryption
   if (decrypter_) {
-    decryptionBuffer_ =
-        decrypter_->decrypt(folly::StringPiece{input, remainingLength_});
-    input = reinterpret_cast<const char*>(decryptionBuffer_->data());
-    remainingLength_ = decryptionBuffer_->length();
+    if (decrypter_->canDecryptInto()) {
+      if (decryptedBuffer_.capacity() < remainingLength_) {
+        decryptedBuffer_.reserve(remainingLength_);
+      }
+      remainingLength_ = decrypter_->decryptInto(
+          folly::StringPiece{input, remainingLength_},
+          decryptedBuffer_.data());
+      input = decryptedBuffer_.data();
+    } else {
+      decryptionBuffer_ =
+          decrypter_->decrypt(folly::StringPiece{input, remainingLength_});
+      input = reinterpret_cast<const char*>(decryptionBuffer_->data());
+      remainingLength_ = decryptionBuffer_->length();
+    }
     *data = input;
     *size = remainingLength_;
     outputBufferPtr_ = input + remainingLength_;
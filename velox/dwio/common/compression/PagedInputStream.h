@@ -32,6 +32,7 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
       : input_(std::move(inStream)),
         pool_(memPool),
         inputBuffer_(pool_),
+        decryptedBuffer_(pool_),
         decompressor_{std::move(decompressor)},
         decrypter_{decrypter},
         streamDebugInfo_{streamDebugInfo} {
@@ -75,6 +76,7 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
       : input_(std::move(inStream)),
         pool_(memPool),
         inputBuffer_(pool_),
+        decryptedBuffer_(pool_),
         decompressor_{nullptr},
         decrypter_{nullptr},
         streamDebugInfo_{streamDebugInfo} {}
@@ -114,6 +116,10 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
   // unencrypted output
   std::unique_ptr<folly::IOBuf> decryptionBuffer_{nullptr};
 
+  // Unencrypted output of decrypters that support decryptInto(), reused
+  // across chunks.
+  dwio::common::DataBuffer<char> decryptedBuffer_;
+
   // the current state
   State state_{State::HEADER};
 
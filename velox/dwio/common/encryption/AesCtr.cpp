@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/dwio/common/encryption/AesCtr.h"
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <limits>
+
+namespace facebook::velox::dwio::common::encryption {
+namespace {
+
+const EVP_CIPHER* cipherForKey(const std::string& key) {
+  switch (key.size()) {
+    case 16:
+      return EVP_aes_128_ctr();
+    case 24:
+      return EVP_aes_192_ctr();
+    case 32:
+      return EVP_aes_256_ctr();
+    default:
+      DWIO_RAISE("Invalid AES key size: ", key.size());
+  }
+}
+
+} // namespace
+
+// static
+void AesCtr::checkKey(const std::string& key) {
+  cipherForKey(key);
+}
+
+// static
+void AesCtr::transform(
+    const std::string& key,
+    const char* iv,
+    const char* input,
+    size_t size,
+    char* output) {
+  std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)> context(
+      EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+  DWIO_ENSURE_NOT_NULL(context.get());
+  DWIO_ENSURE_EQ(
+      EVP_EncryptInit_ex(
+          context.get(),
+          cipherForKey(key),
+          nullptr,
+          reinterpret_cast<const uint8_t*>(key.data()),
+          reinterpret_cast<const uint8_t*>(iv)),
+      1);
+  // EVP_EncryptUpdate takes int sizes. The counter carries over between calls.
+  constexpr size_t kMaxBatch = std::numeric_limits<int32_t>::max() & ~15;
+  while (size > 0) {
+    const auto batch = std::min(size, kMaxBatch);
+    int32_t outputSize = 0;
+    DWIO_ENSURE_EQ(
+        EVP_EncryptUpdate(
+            context.get(),
+            reinterpret_cast<uint8_t*>(output),
+            &outputSize,
+            reinterpret_cast<const uint8_t*>(input),
+            static_cast<int32_t>(batch)),
+        1);
+    DWIO_ENSURE_EQ(static_cast<size_t>(outputSize), batch);
+    input += batch;
+    output += batch;
+    size -= batch;
+  }
+}
+
+AesCtrEncrypter::AesCtrEncrypter(std::string key, std::string keyMetadata)
+    : key_(std::move(key)), keyMetadata_(std::move(keyMetadata)) {
+  AesCtr::checkKey(key_);
+}
+
+std::unique_ptr<folly::IOBuf> AesCtrEncrypter::encrypt(
+    folly::StringPiece input) const {
+  auto result = folly::IOBuf::create(AesCtr::kIvSize + input.size());
+  auto* data = reinterpret_cast<char*>(result->writableData());
+  // A counter must never repeat under one key, so each buffer starts from a
+  // random one.
+  DWIO_ENSURE_EQ(
+      RAND_bytes(reinterpret_cast<uint8_t*>(data), AesCtr::kIvSize), 1);
+  AesCtr::transform(
+      key_, data, input.data(), input.size(), data + AesCtr::kIvSize);
+  result->append(AesCtr::kIvSize + input.size());
+  return result;
+}
+
+void AesCtrDecrypter::setKey(const std::string& keyMetadata) {
+  auto key = resolver_(keyMetadata);
+  AesCtr::checkKey(key);
+  keyMetadata_ = keyMetadata;
+  key_ = std::move(key);
+}
+
+std::unique_ptr<folly::IOBuf> AesCtrDecrypter::decrypt(
+    folly::StringPiece input) const {
+  auto result = folly::IOBuf::create(input.size());
+  result->append(
+      decryptInto(input, reinterpret_cast<char*>(result->writableData())));
+  return result;
+}
+
+size_t AesCtrDecrypter::decryptInto(folly::StringPiece input, char* output)
+    const {
+  DWIO_ENSURE(isKeyLoaded(), "AES key is not set");
+  DWIO_ENSURE_GE(input.size(), AesCtr::kIvSize, "Truncated AES-CTR buffer");
+  const auto size = input.size() - AesCtr::kIvSize;
+  AesCtr::transform(
+      key_, input.data(), input.data() + AesCtr::kIvSize, size, output);
+  return size;
+}
+
+std::unique_ptr<Decrypter> AesCtrDecrypter::clone() const {
+  auto decrypter = std::make_unique<AesCtrDecrypter>(resolver_);
+  if (isKeyLoaded()) {
+    decrypter->keyMetadata_ = keyMetadata_;
+    decrypter->key_ = key_;
+  }
+  return decrypter;
+}
+
+std::unique_ptr<Encrypter> AesCtrEncrypterFactory::create(
+    EncryptionProvider /* provider */,
+    const EncryptionProperties& props) {
+  auto& aesProps = dynamic_cast<const AesCtrEncryptionProperties&>(props);
+  return std::make_unique<AesCtrEncrypter>(
+      aesProps.key(), aesProps.keyMetadata());
+}
+
+std::unique_ptr<Decrypter> AesCtrDecrypterFactory::create(
+    EncryptionProvider /* provider */) {
+  return std::make_unique<AesCtrDecrypter>(resolver_);
+}
+
+} // namespace facebook::velox::dwio::common::encryption
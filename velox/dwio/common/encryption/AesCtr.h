@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <functional>
+
+#include "velox/dwio/common/encryption/Encryption.h"
+
+namespace facebook::velox::dwio::common::encryption {
+
+/// AES in counter mode with a 16, 24 or 32 byte key. An encrypted buffer is a
+/// random 16 byte initial counter followed by the ciphertext, which is as long
+/// as the plaintext. The cipher is OpenSSL's, which uses AES-NI or VAES when
+/// the CPU has them, and since CTR is a stream cipher a chunk is decrypted
+/// straight into the buffer of the reader by decryptInto().
+///
+/// The key written to the file by the Encrypter is the key metadata, e.g. the
+/// id of the key in a key management service, never the key itself. The
+/// Decrypter resolves the metadata to the key with a KeyResolver.
+class AesCtr {
+ public:
+  static constexpr int32_t kIvSize = 16;
+
+  using KeyResolver = std::function<std::string(const std::string&)>;
+
+  /// Throws if 'key' is not a valid AES key.
+  static void checkKey(const std::string& key);
+
+  /// Writes the AES-CTR transform of 'size' bytes of 'input' with the
+  /// initial counter 'iv' to 'output'. Encryption and decryption are the
+  /// same transform.
+  static void transform(
+      const std::string& key,
+      const char* iv,
+      const char* input,
+      size_t size,
+      char* output);
+};
+
+class AesCtrEncrypter : public Encrypter {
+ public:
+  AesCtrEncrypter(std::string key, std::string keyMetadata);
+
+  const std::string& getKey() const override {
+    return keyMetadata_;
+  }
+
+  std::unique_ptr<folly::IOBuf> encrypt(
+      folly::StringPiece input) const override;
+
+  std::unique_ptr<Encrypter> clone() const override {
+    return std::make_unique<AesCtrEncrypter>(key_, keyMetadata_);
+  }
+
+ private:
+  const std::string key_;
+  const std::string keyMetadata_;
+};
+
+class AesCtrDecrypter : public Decrypter {
+ public:
+  explicit AesCtrDecrypter(AesCtr::KeyResolver resolver)
+      : resolver_(std::move(resolver)) {}
+
+  void setKey(const std::string& keyMetadata) override;
+
+  bool isKeyLoaded() const override {
+    return !key_.empty();
+  }
+
+  std::unique_ptr<folly::IOBuf> decrypt(
+      folly::StringPiece input) const override;
+
+  bool canDecryptInto() const override {
+    return true;
+  }
+
+  size_t decryptInto(folly::StringPiece input, char* output) const override;
+
+  std::unique_ptr<Decrypter> clone() const override;
+
+ private:
+  const AesCtr::KeyResolver resolver_;
+  std::string keyMetadata_;
+  std::string key_;
+};
+
+class AesCtrEncryptionProperties : public EncryptionProperties {
+ public:
+  AesCtrEncryptionProperties(std::string key, std::string keyMetadata)
+      : key_(std::move(key)), keyMetadata_(std::move(keyMetadata)) {}
+
+  const std::string& key() const {
+    return key_;
+  }
+
+  const std::string& keyMetadata() const {
+    return keyMetadata_;
+  }
+
+  size_t hash() const override {
+    return std::hash<std::string>{}(keyMetadata_);
+  }
+
+ protected:
+  bool equals(const EncryptionProperties& other) const override {
+    auto& casted = dynamic_cast<const AesCtrEncryptionProperties&>(other);
+    return key_ == casted.key_ && keyMetadata_ == casted.keyMetadata_;
+  }
+
+ private:
+  const std::string key_;
+  const std::string keyMetadata_;
+};
+
+class AesCtrEncrypterFactory : public EncrypterFactory {
+ public:
+  std::unique_ptr<Encrypter> create(
+      EncryptionProvider provider,
+      const EncryptionProperties& props) override;
+};
+
+class AesCtrDecrypterFactory : public DecrypterFactory {
+ public:
+  explicit AesCtrDecrypterFactory(AesCtr::KeyResolver resolver)
+      : resolver_(std::move(resolver)) {}
+
+  std::unique_ptr<Decrypter> create(EncryptionProvider provider) override;
+
+ private:
+  const AesCtr::KeyResolver resolver_;
+};
+
+} // namespace facebook::velox::dwio::common::encryption
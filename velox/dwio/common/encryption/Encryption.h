@@ -89,6 +89,21 @@ class Decrypter {
   virtual std::unique_ptr<folly::IOBuf> decrypt(
       folly::StringPiece input) const = 0;
 
+  /// True if decryptInto() is supported. Readers then decrypt into a buffer
+  /// they reuse instead of allocating an IOBuf per encrypted chunk.
+  virtual bool canDecryptInto() const {
+    return false;
+  }
+
+  /// Decrypts 'input' into 'output', which has space for input.size() bytes
+  /// and does not overlap 'input'. Returns the size of the plaintext, which
+  /// is at most input.size().
+  virtual size_t decryptInto(
+      folly::StringPiece /* input */,
+      char* /* output */) const {
+    DWIO_RAISE("decryptInto is not supported");
+  }
+
   virtual std::unique_ptr<Decrypter> clone() const = 0;
 };
 
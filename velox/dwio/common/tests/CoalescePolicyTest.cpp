@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/CoalescePolicy.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::dwio::common;
+
+namespace {
+// Records 'numIos' reads of 1 to 8MB that take 'latencyMicros' plus the
+// transfer time at 'bytesPerMicro'.
+void recordReads(
+    CoalescePolicy& policy,
+    const std::string& fileName,
+    int32_t numIos,
+    uint64_t latencyMicros,
+    uint64_t bytesPerMicro) {
+  for (auto i = 0; i < numIos; ++i) {
+    const uint64_t bytes = (1 + i % 8) << 20;
+    policy.recordIo(fileName, bytes, latencyMicros + bytes / bytesPerMicro);
+  }
+}
+} // namespace
+
+TEST(CoalescePolicyTest, backend) {
+  EXPECT_EQ(CoalescePolicy::backend("s3://bucket/key"), "s3");
+  EXPECT_EQ(CoalescePolicy::backend("hdfs://host:9000/a/b"), "hdfs");
+  EXPECT_EQ(CoalescePolicy::backend("/tmp/file"), "file");
+  EXPECT_EQ(CoalescePolicy::backend("file"), "file");
+}
+
+TEST(CoalescePolicyTest, limits) {
+  CoalescePolicy policy;
+  const CoalescePolicy::Limits defaults{512 << 10, 128 << 20};
+
+  // The configured limits apply until there are enough reads.
+  recordReads(policy, "s3://bucket/a", CoalescePolicy::kMinSamples - 1, 0, 1);
+  auto limits = policy.limits("s3://bucket/b", 0, defaults);
+  EXPECT_EQ(limits.maxGap, defaults.maxGap);
+  EXPECT_EQ(limits.maxCoalesceBytes, defaults.maxCoalesceBytes);
+
+  // An object store with 20ms latency and 100MB/s reads gaps of up to
+  // 2MB.
+  CoalescePolicy::Limits s3Limits;
+  {
+    CoalescePolicy s3;
+    recordReads(s3, "s3://bucket/a", 100, 20'000, 100);
+    s3Limits = s3.limits("s3://bucket/b", 0, defaults);
+    EXPECT_NEAR(s3Limits.maxGap, 2'000'000, 10'000);
+    EXPECT_NEAR(
+        s3Limits.maxCoalesceBytes,
+        s3Limits.maxGap * (1 + CoalescePolicy::kAmortization),
+        (1 + CoalescePolicy::kAmortization));
+
+    // The coalesced size does not exceed the configured limit.
+    limits = s3.limits("s3://bucket/b", 0, {512 << 10, 8 << 20});
+    EXPECT_EQ(limits.maxCoalesceBytes, 8 << 20);
+  }
+
+  // Local NVMe with 100us latency and 2GB/s reads gaps of up to 200KB and
+  // IOs of at least the natural read size.
+  recordReads(policy, "/data/a", 100, 100, 2'000);
+  limits = policy.limits("/data/b", 4 << 20, defaults);
+  EXPECT_NEAR(limits.maxGap, 200'000, 2'000);
+  EXPECT_LT(limits.maxGap, s3Limits.maxGap);
+  EXPECT_EQ(limits.maxCoalesceBytes, 4 << 20);
+
+  // Reads of a single size do not produce a model.
+  CoalescePolicy sameSize;
+  for (auto i = 0; i < 100; ++i) {
+    sameSize.recordIo("hdfs://a", 1 << 20, 1'000);
+  }
+  limits = sameSize.limits("hdfs://b", 0, defaults);
+  EXPECT_EQ(limits.maxGap, defaults.maxGap);
+}
+
+TEST(CoalescePolicyTest, stats) {
+  CoalescePolicy policy;
+  recordReads(policy, "s3://bucket/a", 20, 20'000, 100);
+  policy.recordOverread("s3://bucket/a", 1000);
+  policy.recordOverread("s3://bucket/b", 500);
+  policy.recordOverread("/tmp/a", 10);
+  auto stats = policy.stats();
+  ASSERT_EQ(stats.size(), 2);
+  EXPECT_EQ(stats["s3"].numIos, 20);
+  EXPECT_EQ(stats["s3"].overreadBytes, 1500);
+  EXPECT_NEAR(stats["s3"].latencyMicros, 20'000, 200);
+  EXPECT_NEAR(stats["s3"].bytesPerMicro, 100, 1);
+  EXPECT_EQ(stats["file"].numIos, 0);
+  EXPECT_EQ(stats["file"].overreadBytes, 10);
+}
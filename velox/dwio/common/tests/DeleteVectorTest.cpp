@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/dwio/common/DeleteVector.h"
+
+#include <algorithm>
+#include <folly/Random.h>
+#include <gtest/gtest.h>
+#include <set>
+
+#include "velox/common/base/BitUtil.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+
+namespace {
+// Checks contains() and fillBits() of 'deletes' against 'expected' over
+// ranges that start and end at arbitrary rows, crossing chunk boundaries.
+void checkDeletes(
+    const DeleteVector& deletes,
+    const std::set<uint64_t>& expected,
+    uint64_t maxRow) {
+  ASSERT_EQ(deletes.size(), expected.size());
+  for (auto row : expected) {
+    ASSERT_TRUE(deletes.contains(row));
+  }
+  folly::Random::DefaultGenerator rng(1);
+  std::vector<uint64_t> bits;
+  for (auto i = 0; i < 100; ++i) {
+    const uint64_t begin = folly::Random::rand64(rng) % maxRow;
+    const int32_t numRows = 1 + folly::Random::rand32(rng) % 100'000;
+    bits.assign(bits::nwords(numRows), ~0ULL);
+    const auto numDeleted = deletes.fillBits(begin, numRows, bits.data());
+    int32_t expectedDeleted = 0;
+    for (auto row = 0; row < numRows; ++row) {
+      const bool deleted = expected.count(begin + row) > 0;
+      expectedDeleted += deleted;
+      ASSERT_EQ(bits::isBitSet(bits.data(), row), deleted)
+          << "begin " << begin << " row " << row;
+      ASSERT_EQ(deletes.contains(begin + row), deleted);
+    }
+    ASSERT_EQ(numDeleted, expectedDeleted);
+  }
+}
+} // namespace
+
+TEST(DeleteVectorTest, empty) {
+  DeleteVector deletes;
+  deletes.build();
+  EXPECT_EQ(deletes.size(), 0);
+  EXPECT_FALSE(deletes.contains(0));
+  uint64_t bits = ~0ULL;
+  EXPECT_EQ(deletes.fillBits(0, 64, &bits), 0);
+  EXPECT_EQ(bits, 0);
+}
+
+TEST(DeleteVectorTest, sparseAndDense) {
+  DeleteVector deletes;
+  std::set<uint64_t> expected;
+  folly::Random::DefaultGenerator rng(2);
+  // Chunk 0 is sparse, chunk 1 is dense, chunk 2 is empty and chunk 3 has
+  // exactly kMaxArraySize rows, added in random order with duplicates.
+  for (auto i = 0; i < 1'000; ++i) {
+    expected.insert(folly::Random::rand32(rng) % DeleteVector::kChunkSize);
+  }
+  for (auto i = 0; i < 30'000; ++i) {
+    expected.insert(
+        DeleteVector::kChunkSize +
+        folly::Random::rand32(rng) % DeleteVector::kChunkSize);
+  }
+  for (auto i = 0; i < DeleteVector::kMaxArraySize; ++i) {
+    expected.insert(3 * DeleteVector::kChunkSize + i * 7);
+  }
+  std::vector<uint64_t> rows(expected.begin(), expected.end());
+  std::shuffle(rows.begin(), rows.end(), rng);
+  for (auto row : rows) {
+    deletes.add(row);
+  }
+  deletes.add(rows[0]);
+  deletes.build();
+  checkDeletes(deletes, expected, 4 * DeleteVector::kChunkSize);
+  // One array, one bitmap of 8KB and one full array.
+  EXPECT_LT(deletes.memoryBytes(), 32 << 10);
+}
+
+TEST(DeleteVectorTest, incrementalBuild) {
+  DeleteVector deletes;
+  std::set<uint64_t> expected;
+  // The first build makes arrays, the second turns them into bitmaps and the
+  // later ones add to the bitmaps.
+  for (auto batch = 0; batch < 4; ++batch) {
+    const int32_t step = batch == 0 ? 50 : 5;
+    for (uint64_t row = batch; row < 2 * DeleteVector::kChunkSize;
+         row += step) {
+      deletes.add(row);
+      expected.insert(row);
+    }
+    deletes.build();
+    checkDeletes(deletes, expected, 2 * DeleteVector::kChunkSize);
+  }
+}
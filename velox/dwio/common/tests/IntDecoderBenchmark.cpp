@@ -22,6 +22,7 @@
 #include "folly/init/Init.h"
 #include "folly/lang/Bits.h"
 #include "velox/common/base/BitUtil.h"
+#include "velox/dwio/common/DirectDecoder.h"
 #include "velox/dwio/common/IntCodecCommon.h"
 #include "velox/dwio/common/IntDecoder.h"
 #include "velox/dwio/common/exception/Exception.h"
@@ -48,6 +49,12 @@ std::vector<uint64_t> randomInts_u64;
 std::vector<uint64_t> randomInts_u64_result;
 std::vector<char> buffer_u64;
 
+// Varints of 1 or 2 bytes, like string lengths and dictionary indices.
+static size_t len_short = 0;
+std::vector<uint64_t> randomInts_short;
+std::vector<uint64_t> randomInts_short_result;
+std::vector<char> buffer_short;
+
 uint64_t readVuLong(const char* buffer, size_t& len) {
   if (LIKELY(len >= folly::kMaxVarintLength64)) {
     const char* p = buffer;
@@ -938,6 +945,45 @@ BENCHMARK_RELATIVE(decodeNew_64) {
       randomInts_u64.size(), buffer_u64.data(), randomInts_u64_result.data());
 }
 
+// Decodes 'numValues' varints from 'buffer' with IntDecoder::bulkRead(),
+// which uses decodeShortVarints() for runs of short varints.
+void bulkRead(
+    const std::vector<char>& buffer,
+    size_t length,
+    size_t numValues,
+    uint64_t* result) {
+  DirectDecoder<false> decoder(
+      std::make_unique<SeekableArrayInputStream>(buffer.data(), length),
+      true,
+      sizeof(uint64_t));
+  decoder.bulkRead(numValues, result);
+}
+
+BENCHMARK(decodeNew_short) {
+  readVuLongOptimized(
+      randomInts_short.size(),
+      buffer_short.data(),
+      randomInts_short_result.data());
+}
+
+BENCHMARK_RELATIVE(bulkRead_short) {
+  bulkRead(
+      buffer_short,
+      len_short,
+      randomInts_short.size(),
+      randomInts_short_result.data());
+}
+
+BENCHMARK(decodeNewBaseline_32) {
+  readVuLongOptimized(
+      randomInts_u32.size(), buffer_u32.data(), randomInts_u32_result.data());
+}
+
+BENCHMARK_RELATIVE(bulkRead_32) {
+  bulkRead(
+      buffer_u32, len_u32, randomInts_u32.size(), randomInts_u32_result.data());
+}
+
 int32_t main(int32_t argc, char* argv[]) {
   folly::init(&argc, &argv);
 
@@ -975,6 +1021,19 @@ int32_t main(int32_t argc, char* argv[]) {
   randomInts_u64_result.resize(randomInts_u64.size());
   len_u64 = pos;
 
+  // Populate buffer of 1 and 2 byte varints.
+  buffer_short.resize(kNumElements);
+  pos = 0;
+  for (int32_t i = 0; i < 400000; i++) {
+    auto randomInt = folly::Random::rand32() % 3 == 0
+        ? folly::Random::rand32() & 0x3fff
+        : folly::Random::rand32() & 0x7f;
+    randomInts_short.push_back(randomInt);
+    pos = writeVulongToBuffer(randomInt, buffer_short.data(), pos);
+  }
+  randomInts_short_result.resize(randomInts_short.size());
+  len_short = pos;
+
   folly::runBenchmarks();
   return 0;
 }
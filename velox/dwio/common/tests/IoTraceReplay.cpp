@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/String.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <iostream>
+
+#include "velox/common/file/File.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/common/time/Timer.h"
+#include "velox/dwio/common/IoStatistics.h"
+
+// Replays the reads of an IO trace written by a table scan with the Hive
+// connector's io_trace_directory set, e.g. to compare storage or cache
+// settings offline. Reports the recorded and the replayed latencies per tier.
+//
+// velox_io_trace_replay --io_trace_file=/tmp/trace/t.0.1.iotrace \
+//   --tiers=storage,ssd --path_prefix=s3://bucket --replace_prefix=/data
+
+DEFINE_string(io_trace_file, "", "IO trace to replay");
+
+DEFINE_string(
+    tiers,
+    "storage",
+    "Comma separated tiers whose reads are replayed: storage, ssd, peer, ram");
+
+DEFINE_string(
+    path_prefix,
+    "",
+    "Prefix of the traced paths that is replaced by --replace_prefix, e.g. to "
+    "replay against a copy of the files");
+
+DEFINE_string(replace_prefix, "", "Replaces --path_prefix in traced paths");
+
+DEFINE_int32(repeats, 1, "Number of times the trace is replayed");
+
+using namespace facebook::velox;
+using dwio::common::IoLatencyHistogram;
+using dwio::common::IoTrace;
+using dwio::common::IoTraceEntry;
+
+namespace {
+
+std::string readTrace(const std::string& path) {
+  auto file = filesystems::getFileSystem(path, nullptr)->openFileForRead(path);
+  return file->pread(0, file->size());
+}
+
+std::string replayPath(const std::string& path) {
+  if (FLAGS_path_prefix.empty() ||
+      path.compare(0, FLAGS_path_prefix.size(), FLAGS_path_prefix) != 0) {
+    return path;
+  }
+  return FLAGS_replace_prefix + path.substr(FLAGS_path_prefix.size());
+}
+
+struct TierStats {
+  uint64_t numReads{0};
+  uint64_t bytes{0};
+  uint64_t recordedMicros{0};
+  uint64_t replayedMicros{0};
+  IoLatencyHistogram recorded;
+  IoLatencyHistogram replayed;
+};
+
+void printStats(std::string_view tier, const TierStats& stats) {
+  if (stats.numReads == 0) {
+    return;
+  }
+  auto mbPerSecond = [&](uint64_t micros) {
+    return micros == 0 ? 0.0 : stats.bytes / static_cast<double>(micros);
+  };
+  std::cout << fmt::format(
+                   "{}: {} reads {} bytes\n"
+                   "  recorded: {:.1f} MB/s p50 {}us p90 {}us p99 {}us\n"
+                   "  replayed: {:.1f} MB/s p50 {}us p90 {}us p99 {}us",
+                   tier,
+                   stats.numReads,
+                   stats.bytes,
+                   mbPerSecond(stats.recordedMicros),
+                   stats.recorded.percentileMicros(0.5),
+                   stats.recorded.percentileMicros(0.9),
+                   stats.recorded.percentileMicros(0.99),
+                   mbPerSecond(stats.replayedMicros),
+                   stats.replayed.percentileMicros(0.5),
+                   stats.replayed.percentileMicros(0.9),
+                   stats.replayed.percentileMicros(0.99))
+            << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  VELOX_CHECK(!FLAGS_io_trace_file.empty(), "--io_trace_file is required");
+  filesystems::registerLocalFileSystem();
+
+  std::vector<std::string> tierNames;
+  folly::split(',', FLAGS_tiers, tierNames, true);
+  std::array<bool, 4> replayTier{};
+  for (auto tier :
+       {IoTraceEntry::Tier::kStorage,
+        IoTraceEntry::Tier::kSsd,
+        IoTraceEntry::Tier::kPeer,
+        IoTraceEntry::Tier::kRam}) {
+    replayTier[static_cast<int32_t>(tier)] =
+        std::find(
+            tierNames.begin(), tierNames.end(), IoTrace::tierName(tier)) !=
+        tierNames.end();
+  }
+
+  const auto entries = IoTrace::deserialize(readTrace(FLAGS_io_trace_file));
+  std::unordered_map<std::string, std::unique_ptr<ReadFile>> files;
+  std::array<TierStats, 4> stats;
+  std::string buffer;
+  for (auto repeat = 0; repeat < FLAGS_repeats; ++repeat) {
+    for (const auto& entry : entries) {
+      const auto tier = static_cast<int32_t>(entry.tier);
+      if (!replayTier[tier]) {
+        continue;
+      }
+      auto& file = files[entry.path];
+      if (!file) {
+        const auto path = replayPath(entry.path);
+        file = filesystems::getFileSystem(path, nullptr)->openFileForRead(path);
+      }
+      buffer.resize(entry.size);
+      uint64_t micros = 0;
+      {
+        MicrosecondTimer timer(&micros);
+        file->pread(entry.offset, entry.size, buffer.data());
+      }
+      auto& tierStats = stats[tier];
+      ++tierStats.numReads;
+      tierStats.bytes += entry.size;
+      tierStats.recordedMicros += entry.latencyMicros;
+      tierStats.replayedMicros += micros;
+      tierStats.recorded.add(entry.latencyMicros);
+      tierStats.replayed.add(micros);
+    }
+  }
+  std::cout << fmt::format(
+                   "Replayed {} reads of the {} in {}, {} times",
+                   stats[0].numReads + stats[1].numReads + stats[2].numReads +
+                       stats[3].numReads,
+                   entries.size(),
+                   FLAGS_io_trace_file,
+                   FLAGS_repeats)
+            << std::endl;
+  for (auto i = 0; i < stats.size(); ++i) {
+    printStats(IoTrace::tierName(static_cast<IoTraceEntry::Tier>(i)), stats[i]);
+  }
+  return 0;
+}
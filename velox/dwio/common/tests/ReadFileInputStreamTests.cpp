@@ -73,3 +73,34 @@ TEST(ReadFileInputStream, VReadIOBufs) {
   std::vector<std::string> expected = {"aaaaab", "bcccc"};
   EXPECT_EQ(result, expected);
 }
+
+TEST(ReadFileInputStream, ioTrace) {
+  std::string fileData(100, 'a');
+  auto readFile = std::make_shared<InMemoryReadFile>(fileData);
+  IoStatistics stats;
+  stats.enableTrace(2);
+  ReadFileInputStream inputStream(readFile, MetricsLog::voidLog(), &stats);
+  char buf[20];
+  inputStream.read(buf, 10, 5, LogType::STREAM);
+  stats.recordTrace(IoTraceEntry::Tier::kSsd, "other\tfile", 30, 20, 7);
+  inputStream.read(buf, 20, 50, LogType::STREAM);
+  ASSERT_EQ(stats.trace()->numDropped(), 1);
+
+  auto entries = IoTrace::deserialize(stats.trace()->serialize());
+  ASSERT_EQ(entries.size(), 2);
+  EXPECT_EQ(entries[0].tier, IoTraceEntry::Tier::kStorage);
+  EXPECT_EQ(entries[0].path, readFile->getName());
+  EXPECT_EQ(entries[0].offset, 5);
+  EXPECT_EQ(entries[0].size, 10);
+  EXPECT_EQ(entries[1].tier, IoTraceEntry::Tier::kSsd);
+  EXPECT_EQ(entries[1].path, "other\tfile");
+  EXPECT_EQ(entries[1].offset, 30);
+  EXPECT_EQ(entries[1].size, 20);
+  EXPECT_EQ(entries[1].latencyMicros, 7);
+
+  IoStatistics merged;
+  merged.merge(stats);
+  ASSERT_NE(merged.trace(), nullptr);
+  EXPECT_EQ(merged.trace()->entries().size(), 2);
+  EXPECT_EQ(merged.trace()->numDropped(), 1);
+}
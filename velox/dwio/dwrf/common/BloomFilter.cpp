@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/common/BloomFilter.h"
+
+#include <cmath>
+
+#include "velox/dwio/common/exception/Exception.h"
+
+namespace facebook::velox::dwrf {
+
+namespace {
+
+constexpr uint64_t kMurmurC1 = 0x87c37b91114253d5UL;
+constexpr uint64_t kMurmurC2 = 0x4cf5ad432745937fUL;
+constexpr int32_t kMurmurR1 = 31;
+constexpr int32_t kMurmurR2 = 27;
+constexpr uint64_t kMurmurM = 5;
+constexpr uint64_t kMurmurN1 = 0x52dce729;
+constexpr uint64_t kMurmurSeed = 104729;
+
+inline uint64_t rotateLeft(uint64_t value, int32_t shift) {
+  return (value << shift) | (value >> (64 - shift));
+}
+
+} // namespace
+
+BloomFilter::BloomFilter(uint64_t expectedEntries, double fpp) {
+  DWIO_ENSURE_GT(expectedEntries, 0);
+  DWIO_ENSURE(fpp > 0.0 && fpp < 1.0, "Invalid bloom filter fpp ", fpp);
+  const auto n = static_cast<double>(expectedEntries);
+  const auto numBits = static_cast<uint64_t>(
+      -n * std::log(fpp) / (std::log(2.0) * std::log(2.0)));
+  // Rounds up to whole words like ORC.
+  bits_.resize(std::max<uint64_t>(1, (numBits + 63) / 64));
+  numHashFunctions_ = std::max<int32_t>(
+      1, std::round(static_cast<double>(this->numBits()) / n * std::log(2.0)));
+}
+
+BloomFilter::BloomFilter(const proto::BloomFilter& proto)
+    : bits_(proto.bitset().begin(), proto.bitset().end()),
+      numHashFunctions_(proto.numhashfunctions()) {
+  DWIO_ENSURE(!bits_.empty(), "Bloom filter has no bits");
+  DWIO_ENSURE_GT(numHashFunctions_, 0);
+}
+
+// static
+uint64_t BloomFilter::hashLong(int64_t value) {
+  // Thomas Wang's integer hash. The right shifts are arithmetic like in the
+  // Java original.
+  auto shiftRight = [](uint64_t key, int32_t shift) {
+    return static_cast<uint64_t>(static_cast<int64_t>(key) >> shift);
+  };
+  auto key = static_cast<uint64_t>(value);
+  key = (~key) + (key << 21);
+  key = key ^ shiftRight(key, 24);
+  key = (key + (key << 3)) + (key << 8);
+  key = key ^ shiftRight(key, 14);
+  key = (key + (key << 2)) + (key << 4);
+  key = key ^ shiftRight(key, 28);
+  key = key + (key << 31);
+  return key;
+}
+
+// static
+uint64_t BloomFilter::hashBytes(const char* data, int32_t size) {
+  auto* bytes = reinterpret_cast<const uint8_t*>(data);
+  uint64_t hash = kMurmurSeed;
+  const int32_t numBlocks = size >> 3;
+  for (auto i = 0; i < numBlocks; ++i) {
+    uint64_t k = 0;
+    for (auto j = 7; j >= 0; --j) {
+      k = (k << 8) | bytes[i * 8 + j];
+    }
+    k *= kMurmurC1;
+    k = rotateLeft(k, kMurmurR1);
+    k *= kMurmurC2;
+    hash ^= k;
+    hash = rotateLeft(hash, kMurmurR2) * kMurmurM + kMurmurN1;
+  }
+  const int32_t tailStart = numBlocks << 3;
+  if (size > tailStart) {
+    uint64_t k = 0;
+    for (auto j = size - 1; j >= tailStart; --j) {
+      k = (k << 8) | bytes[j];
+    }
+    k *= kMurmurC1;
+    k = rotateLeft(k, kMurmurR1);
+    k *= kMurmurC2;
+    hash ^= k;
+  }
+  hash ^= size;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdUL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53UL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+void BloomFilter::addHash(uint64_t hash) {
+  const int32_t hash1 = static_cast<int32_t>(hash);
+  const int32_t hash2 = static_cast<int32_t>(hash >> 32);
+  const auto numBits = this->numBits();
+  for (auto i = 1; i <= numHashFunctions_; ++i) {
+    int32_t combined = static_cast<int32_t>(
+        static_cast<uint32_t>(hash1) + static_cast<uint32_t>(i) *
+            static_cast<uint32_t>(hash2));
+    if (combined < 0) {
+      combined = ~combined;
+    }
+    const auto position = static_cast<uint64_t>(combined) % numBits;
+    bits_[position >> 6] |= 1UL << (position & 63);
+  }
+}
+
+bool BloomFilter::testHash(uint64_t hash) const {
+  const int32_t hash1 = static_cast<int32_t>(hash);
+  const int32_t hash2 = static_cast<int32_t>(hash >> 32);
+  const auto numBits = this->numBits();
+  for (auto i = 1; i <= numHashFunctions_; ++i) {
+    int32_t combined = static_cast<int32_t>(
+        static_cast<uint32_t>(hash1) + static_cast<uint32_t>(i) *
+            static_cast<uint32_t>(hash2));
+    if (combined < 0) {
+      combined = ~combined;
+    }
+    const auto position = static_cast<uint64_t>(combined) % numBits;
+    if ((bits_[position >> 6] & (1UL << (position & 63))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BloomFilter::reset() {
+  std::fill(bits_.begin(), bits_.end(), 0);
+}
+
+void BloomFilter::toProto(proto::BloomFilter& proto) const {
+  proto.set_numhashfunctions(numHashFunctions_);
+  proto.clear_bitset();
+  for (auto word : bits_) {
+    proto.add_bitset(word);
+  }
+}
+
+} // namespace facebook::velox::dwrf
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "velox/dwio/dwrf/common/wrap/dwrf-proto-wrapper.h"
+
+namespace facebook::velox::dwrf {
+
+/// Bloom filter of the values of a column in a row group, stored in the
+/// BLOOM_FILTER_UTF8 stream. The bit layout and the hashing follow the ORC
+/// bloom filters: integers are hashed with Thomas Wang's 64 bit integer hash
+/// and strings with the 64 bit Murmur3 variant of Hive, so that the filters
+/// can be read by other ORC readers.
+class BloomFilter {
+ public:
+  /// Makes an empty filter sized for 'expectedEntries' distinct values with a
+  /// false positive probability of 'fpp'.
+  BloomFilter(uint64_t expectedEntries, double fpp);
+
+  /// Makes a filter over the bits in 'proto'.
+  explicit BloomFilter(const proto::BloomFilter& proto);
+
+  void addLong(int64_t value) {
+    addHash(hashLong(value));
+  }
+
+  void addBytes(const char* data, int32_t size) {
+    addHash(hashBytes(data, size));
+  }
+
+  /// Returns false if 'value' was certainly not added.
+  bool testLong(int64_t value) const {
+    return testHash(hashLong(value));
+  }
+
+  /// Returns false if the string was certainly not added.
+  bool testBytes(const char* data, int32_t size) const {
+    return testHash(hashBytes(data, size));
+  }
+
+  /// Clears all bits.
+  void reset();
+
+  void toProto(proto::BloomFilter& proto) const;
+
+  uint64_t numBits() const {
+    return bits_.size() * 64;
+  }
+
+  int32_t numHashFunctions() const {
+    return numHashFunctions_;
+  }
+
+  static uint64_t hashLong(int64_t value);
+
+  static uint64_t hashBytes(const char* data, int32_t size);
+
+ private:
+  void addHash(uint64_t hash);
+
+  bool testHash(uint64_t hash) const;
+
+  std::vector<uint64_t> bits_;
+  int32_t numHashFunctions_;
+};
+
+} // namespace facebook::velox::dwrf
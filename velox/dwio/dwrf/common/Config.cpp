@@ -105,6 +105,13 @@ Config::Entry<uint32_t> Config::ENTROPY_STRING_THRESHOLD{
     "hive.exec.orc.entropy.string.threshold",
     20};
 
+// When positive, string columns keep dictionary encoding if its estimated size
+// is at most this ratio of the direct encoding size, in place of the key size
+// and entropy heuristics.
+Config::Entry<float> Config::DICTIONARY_STRING_COST_RATIO{
+    "orc.dictionary.string.cost.ratio",
+    0.0f};
+
 Config::Entry<uint32_t> Config::STRING_STATS_LIMIT(
     "hive.orc.string.stats.limit",
     64);
@@ -209,4 +216,25 @@ Config::Entry<uint64_t> Config::RAW_DATA_SIZE_PER_BATCH(
     50UL * 1024 * 1024);
 
 Config::Entry<bool> Config::MAP_STATISTICS("orc.map.statistics", false);
+
+Config::Entry<const std::vector<uint32_t>> Config::BLOOM_FILTER_COLS(
+    "orc.bloom.filter.cols",
+    {},
+    [](const std::vector<uint32_t>& val) { return folly::join(",", val); },
+    [](const std::string& /* key */, const std::string& val) {
+      std::vector<uint32_t> result;
+      if (!val.empty()) {
+        std::vector<folly::StringPiece> pieces;
+        folly::split(',', val, pieces, true);
+        for (const auto& p : pieces) {
+          const auto& trimmedCol = folly::trimWhitespace(p);
+          if (!trimmedCol.empty()) {
+            result.push_back(folly::to<uint32_t>(trimmedCol));
+          }
+        }
+      }
+      return result;
+    });
+
+Config::Entry<float> Config::BLOOM_FILTER_FPP("orc.bloom.filter.fpp", 0.05);
 } // namespace facebook::velox::dwrf
@@ -51,6 +51,7 @@ class Config : public common::ConfigBase<Config> {
   static Entry<uint32_t> ENTROPY_STRING_MIN_SAMPLES;
   static Entry<float> ENTROPY_STRING_DICT_SAMPLE_FRACTION;
   static Entry<uint32_t> ENTROPY_STRING_THRESHOLD;
+  static Entry<float> DICTIONARY_STRING_COST_RATIO;
   static Entry<uint32_t> STRING_STATS_LIMIT;
   static Entry<bool> FLATTEN_MAP;
   static Entry<bool> MAP_FLAT_DISABLE_DICT_ENCODING;
@@ -74,6 +75,12 @@ class Config : public common::ConfigBase<Config> {
   /// stripes.
   static Entry<uint64_t> RAW_DATA_SIZE_PER_BATCH;
   static Entry<bool> MAP_STATISTICS;
+  /// Top level columns, by their position in the schema, for which the
+  /// writer adds a bloom filter of the values of each row group to the
+  /// index. Supported for integer and VARCHAR columns.
+  static Entry<const std::vector<uint32_t>> BLOOM_FILTER_COLS;
+  /// False positive probability of the bloom filters.
+  static Entry<float> BLOOM_FILTER_FPP;
 
   static std::shared_ptr<Config> fromMap(
       const std::map<std::string, std::string>& map) {
@@ -238,6 +238,49 @@ template void RleDecoderV2<false>::next(
     const uint64_t numValues,
     const uint64_t* const nulls);
 
+template <bool isSigned>
+void RleDecoderV2<isSigned>::startRun() {
+  resetRun();
+  switch (type) {
+    case SHORT_REPEAT:
+      readShortRepeatsHeader();
+      break;
+    case DIRECT:
+      readDirectHeader();
+      break;
+    case PATCHED_BASE:
+      readPatchedHeader();
+      break;
+    case DELTA:
+      readDeltaHeader();
+      break;
+    default:
+      DWIO_RAISE("unknown encoding");
+  }
+}
+
+template void RleDecoderV2<true>::startRun();
+template void RleDecoderV2<false>::startRun();
+
+template <bool isSigned>
+void RleDecoderV2<isSigned>::readShortRepeatsHeader() {
+  // extract the number of fixed bytes
+  byteSize = (firstByte >> 3) & 0x07;
+  byteSize += 1;
+
+  runLength = firstByte & 0x07;
+  // run lengths values are stored only after MIN_REPEAT value is met
+  runLength += RLE_MINIMUM_REPEAT;
+  runRead = 0;
+
+  // read the repeated value which is store using fixed bytes
+  firstValue = readLongBE(byteSize);
+
+  if (isSigned) {
+    firstValue = ZigZag::decode<uint64_t>(static_cast<uint64_t>(firstValue));
+  }
+}
+
 template <bool isSigned>
 uint64_t RleDecoderV2<isSigned>::nextShortRepeats(
     int64_t* const data,
@@ -245,21 +288,7 @@ uint64_t RleDecoderV2<isSigned>::nextShortRepeats(
     uint64_t numValues,
     const uint64_t* const nulls) {
   if (runRead == runLength) {
-    // extract the number of fixed bytes
-    byteSize = (firstByte >> 3) & 0x07;
-    byteSize += 1;
-
-    runLength = firstByte & 0x07;
-    // run lengths values are stored only after MIN_REPEAT value is met
-    runLength += RLE_MINIMUM_REPEAT;
-    runRead = 0;
-
-    // read the repeated value which is store using fixed bytes
-    firstValue = readLongBE(byteSize);
-
-    if (isSigned) {
-      firstValue = ZigZag::decode<uint64_t>(static_cast<uint64_t>(firstValue));
-    }
+    readShortRepeatsHeader();
   }
 
   uint64_t nRead = std::min(runLength - runRead, numValues);
@@ -292,6 +321,20 @@ template uint64_t RleDecoderV2<false>::nextShortRepeats(
     uint64_t numValues,
     const uint64_t* const nulls);
 
+template <bool isSigned>
+void RleDecoderV2<isSigned>::readDirectHeader() {
+  // extract the number of fixed bits
+  unsigned char fbo = (firstByte >> 1) & 0x1f;
+  bitSize = decodeBitWidth(fbo);
+
+  // extract the run length
+  runLength = static_cast<uint64_t>(firstByte & 0x01) << 8;
+  runLength |= readByte();
+  // runs are one off
+  runLength += 1;
+  runRead = 0;
+}
+
 template <bool isSigned>
 uint64_t RleDecoderV2<isSigned>::nextDirect(
     int64_t* const data,
@@ -299,16 +342,7 @@ uint64_t RleDecoderV2<isSigned>::nextDirect(
     uint64_t numValues,
     const uint64_t* const nulls) {
   if (runRead == runLength) {
-    // extract the number of fixed bits
-    unsigned char fbo = (firstByte >> 1) & 0x1f;
-    bitSize = decodeBitWidth(fbo);
-
-    // extract the run length
-    runLength = static_cast<uint64_t>(firstByte & 0x01) << 8;
-    runLength |= readByte();
-    // runs are one off
-    runLength += 1;
-    runRead = 0;
+    readDirectHeader();
   }
 
   uint64_t nRead = std::min(runLength - runRead, numValues);
@@ -344,6 +378,80 @@ template uint64_t RleDecoderV2<false>::nextDirect(
     uint64_t numValues,
     const uint64_t* const nulls);
 
+template <bool isSigned>
+void RleDecoderV2<isSigned>::readPatchedHeader() {
+  // extract the number of fixed bits
+  unsigned char fbo = (firstByte >> 1) & 0x1f;
+  bitSize = decodeBitWidth(fbo);
+
+  // extract the run length
+  runLength = static_cast<uint64_t>(firstByte & 0x01) << 8;
+  runLength |= readByte();
+  // runs are one off
+  runLength += 1;
+  runRead = 0;
+
+  // extract the number of bytes occupied by base
+  uint64_t thirdByte = readByte();
+  byteSize = (thirdByte >> 5) & 0x07;
+  // base width is one off
+  byteSize += 1;
+
+  // extract patch width
+  uint32_t pwo = thirdByte & 0x1f;
+  patchBitSize = decodeBitWidth(pwo);
+
+  // read fourth byte and extract patch gap width
+  uint64_t fourthByte = readByte();
+  uint32_t pgw = (fourthByte >> 5) & 0x07;
+  // patch gap width is one off
+  pgw += 1;
+
+  // extract the length of the patch list
+  size_t pl = fourthByte & 0x1f;
+  DWIO_ENSURE_NE(
+      pl,
+      0,
+      "Corrupt PATCHED_BASE encoded data (pl==0)! ",
+      dwio::common::IntDecoder<isSigned>::inputStream->getName());
+
+  // read the next base width number of bytes to extract base value
+  base = readLongBE(byteSize);
+  int64_t mask = (static_cast<int64_t>(1) << ((byteSize * 8) - 1));
+  // if mask of base value is 1 then base is negative value else positive
+  if ((base & mask) != 0) {
+    base = base & ~mask;
+    base = -base;
+  }
+
+  // TODO: something more efficient than resize
+  unpacked.resize(runLength);
+  unpackedIdx = 0;
+  readLongs(unpacked.data(), 0, runLength, bitSize);
+  // any remaining bits are thrown out
+  resetReadLongs();
+
+  // TODO: something more efficient than resize
+  unpackedPatch.resize(pl);
+  patchIdx = 0;
+  // TODO: Skip corrupt?
+  //    if ((patchBitSize + pgw) > 64 && !skipCorrupt) {
+  DWIO_ENSURE_LE(
+      (patchBitSize + pgw),
+      64,
+      "Corrupt PATCHED_BASE encoded data (patchBitSize + pgw > 64)! ",
+      dwio::common::IntDecoder<isSigned>::inputStream->getName());
+  uint32_t cfb = getClosestFixedBits(patchBitSize + pgw);
+  readLongs(unpackedPatch.data(), 0, pl, cfb);
+  // any remaining bits are thrown out
+  resetReadLongs();
+
+  // apply the patch directly when decoding the packed data
+  patchMask = ((static_cast<int64_t>(1) << patchBitSize) - 1);
+
+  adjustGapAndPatch();
+}
+
 template <bool isSigned>
 uint64_t RleDecoderV2<isSigned>::nextPatched(
     int64_t* const data,
@@ -351,80 +459,37 @@ uint64_t RleDecoderV2<isSigned>::nextPatched(
     uint64_t numValues,
     const uint64_t* const nulls) {
   if (runRead == runLength) {
-    // extract the number of fixed bits
-    unsigned char fbo = (firstByte >> 1) & 0x1f;
-    bitSize = decodeBitWidth(fbo);
-
-    // extract the run length
-    runLength = static_cast<uint64_t>(firstByte & 0x01) << 8;
-    runLength |= readByte();
-    // runs are one off
-    runLength += 1;
-    runRead = 0;
-
-    // extract the number of bytes occupied by base
-    uint64_t thirdByte = readByte();
-    byteSize = (thirdByte >> 5) & 0x07;
-    // base width is one off
-    byteSize += 1;
-
-    // extract patch width
-    uint32_t pwo = thirdByte & 0x1f;
-    patchBitSize = decodeBitWidth(pwo);
-
-    // read fourth byte and extract patch gap width
-    uint64_t fourthByte = readByte();
-    uint32_t pgw = (fourthByte >> 5) & 0x07;
-    // patch gap width is one off
-    pgw += 1;
-
-    // extract the length of the patch list
-    size_t pl = fourthByte & 0x1f;
-    DWIO_ENSURE_NE(
-        pl,
-        0,
-        "Corrupt PATCHED_BASE encoded data (pl==0)! ",
-        dwio::common::IntDecoder<isSigned>::inputStream->getName());
-
-    // read the next base width number of bytes to extract base value
-    base = readLongBE(byteSize);
-    int64_t mask = (static_cast<int64_t>(1) << ((byteSize * 8) - 1));
-    // if mask of base value is 1 then base is negative value else positive
-    if ((base & mask) != 0) {
-      base = base & ~mask;
-      base = -base;
-    }
-
-    // TODO: something more efficient than resize
-    unpacked.resize(runLength);
-    unpackedIdx = 0;
-    readLongs(unpacked.data(), 0, runLength, bitSize);
-    // any remaining bits are thrown out
-    resetReadLongs();
-
-    // TODO: something more efficient than resize
-    unpackedPatch.resize(pl);
-    patchIdx = 0;
-    // TODO: Skip corrupt?
-    //    if ((patchBitSize + pgw) > 64 && !skipCorrupt) {
-    DWIO_ENSURE_LE(
-        (patchBitSize + pgw),
-        64,
-        "Corrupt PATCHED_BASE encoded data (patchBitSize + pgw > 64)! ",
-        dwio::common::IntDecoder<isSigned>::inputStream->getName());
-    uint32_t cfb = getClosestFixedBits(patchBitSize + pgw);
-    readLongs(unpackedPatch.data(), 0, pl, cfb);
-    // any remaining bits are thrown out
-    resetReadLongs();
-
-    // apply the patch directly when decoding the packed data
-    patchMask = ((static_cast<int64_t>(1) << patchBitSize) - 1);
-
-    adjustGapAndPatch();
+    readPatchedHeader();
   }
 
   uint64_t nRead = std::min(runLength - runRead, numValues);
 
+  if (!nulls) {
+    // Adds the base to all values in one pass and then applies the patches
+    // that fall in the range instead of checking for a patch at each value.
+    const auto* source = unpacked.data() + unpackedIdx;
+    for (uint64_t i = 0; i < nRead; ++i) {
+      data[offset + i] = base + source[i];
+    }
+    const uint64_t end = unpackedIdx + nRead;
+    while (patchIdx < unpackedPatch.size() &&
+           static_cast<uint64_t>(actualGap) >= unpackedIdx &&
+           static_cast<uint64_t>(actualGap) < end) {
+      const uint64_t patched = actualGap;
+      data[offset + patched - unpackedIdx] =
+          base + (unpacked[patched] | (curPatch << bitSize));
+      ++patchIdx;
+      if (patchIdx < unpackedPatch.size()) {
+        adjustGapAndPatch();
+        // next gap is relative to the current gap
+        actualGap += patched;
+      }
+    }
+    runRead += nRead;
+    unpackedIdx = end;
+    return nRead;
+  }
+
   for (uint64_t pos = offset; pos < offset + nRead; ++pos) {
     // skip null positions
     if (nulls && bits::isBitNull(nulls, pos)) {
@@ -470,6 +535,37 @@ template uint64_t RleDecoderV2<false>::nextPatched(
     uint64_t numValues,
     const uint64_t* const nulls);
 
+template <bool isSigned>
+void RleDecoderV2<isSigned>::readDeltaHeader() {
+  // extract the number of fixed bits
+  unsigned char fbo = (firstByte >> 1) & 0x1f;
+  if (fbo != 0) {
+    bitSize = decodeBitWidth(fbo);
+  } else {
+    bitSize = 0;
+  }
+
+  // extract the run length
+  runLength = static_cast<uint64_t>(firstByte & 0x01) << 8;
+  runLength |= readByte();
+  ++runLength; // account for first value
+  runRead = deltaBase = 0;
+
+  // read the first value stored as vint
+  if constexpr (isSigned) {
+    firstValue = dwio::common::IntDecoder<isSigned>::readVsLong();
+  } else {
+    firstValue = static_cast<int64_t>(
+        dwio::common::IntDecoder<isSigned>::readVuLong());
+  }
+
+  prevValue = firstValue;
+
+  // read the fixed delta value stored as vint (deltas can be negative even
+  // if all number are positive)
+  deltaBase = dwio::common::IntDecoder<isSigned>::readVsLong();
+}
+
 template <bool isSigned>
 uint64_t RleDecoderV2<isSigned>::nextDelta(
     int64_t* const data,
@@ -477,33 +573,7 @@ uint64_t RleDecoderV2<isSigned>::nextDelta(
     uint64_t numValues,
     const uint64_t* const nulls) {
   if (runRead == runLength) {
-    // extract the number of fixed bits
-    unsigned char fbo = (firstByte >> 1) & 0x1f;
-    if (fbo != 0) {
-      bitSize = decodeBitWidth(fbo);
-    } else {
-      bitSize = 0;
-    }
-
-    // extract the run length
-    runLength = static_cast<uint64_t>(firstByte & 0x01) << 8;
-    runLength |= readByte();
-    ++runLength; // account for first value
-    runRead = deltaBase = 0;
-
-    // read the first value stored as vint
-    if constexpr (isSigned) {
-      firstValue = dwio::common::IntDecoder<isSigned>::readVsLong();
-    } else {
-      firstValue = static_cast<int64_t>(
-          dwio::common::IntDecoder<isSigned>::readVuLong());
-    }
-
-    prevValue = firstValue;
-
-    // read the fixed delta value stored as vint (deltas can be negative even
-    // if all number are positive)
-    deltaBase = dwio::common::IntDecoder<isSigned>::readVsLong();
+    readDeltaHeader();
   }
 
   uint64_t nRead = std::min(runLength - runRead, numValues);
@@ -20,9 +20,12 @@
 #include "velox/common/memory/Memory.h"
 #include "velox/dwio/common/Adaptor.h"
 #include "velox/dwio/common/DataBuffer.h"
+#include "velox/dwio/common/DecoderUtil.h"
 #include "velox/dwio/common/IntDecoder.h"
 #include "velox/dwio/common/exception/Exception.h"
 
+#include <folly/lang/Bits.h>
+
 #include <vector>
 
 namespace facebook::velox::dwrf {
@@ -72,6 +75,12 @@ class RleDecoderV2 : public dwio::common::IntDecoder<isSigned> {
 
   template <bool hasNulls, typename Visitor>
   void readWithVisitor(const uint64_t* nulls, Visitor visitor) {
+    if constexpr (std::is_integral_v<typename Visitor::DataType>) {
+      if (dwio::common::useFastPath<Visitor, hasNulls>(visitor)) {
+        fastPath<hasNulls>(nulls, visitor);
+        return;
+      }
+    }
     int32_t current = visitor.start();
     skip<hasNulls>(current, 0, nulls);
 
@@ -110,6 +119,225 @@ class RleDecoderV2 : public dwio::common::IntDecoder<isSigned> {
   }
 
  private:
+  // Max number of values in a run of any encoding.
+  static constexpr int32_t kMaxRunLength = 512;
+
+  template <bool hasNulls, typename Visitor>
+  void fastPath(const uint64_t* nulls, Visitor& visitor) {
+    constexpr bool hasFilter =
+        !std::is_same_v<typename Visitor::FilterType, common::AlwaysTrue>;
+    constexpr bool hasHook =
+        !std::is_same_v<typename Visitor::HookType, dwio::common::NoHook>;
+    auto rows = visitor.rows();
+    auto numRows = visitor.numRows();
+    auto rowsAsRange = folly::Range<const int32_t*>(rows, numRows);
+    if (hasNulls) {
+      raw_vector<int32_t>* innerVector = nullptr;
+      auto outerVector = &visitor.outerNonNullRows();
+      if (Visitor::dense) {
+        dwio::common::nonNullRowsFromDense(nulls, numRows, *outerVector);
+        if (outerVector->empty()) {
+          visitor.setAllNull(hasFilter ? 0 : numRows);
+          return;
+        }
+        bulkScan<hasFilter, hasHook, true>(
+            folly::Range<const int32_t*>(rows, outerVector->size()),
+            outerVector->data(),
+            visitor);
+      } else {
+        innerVector = &visitor.innerNonNullRows();
+        int32_t tailSkip = -1;
+        auto anyNulls = dwio::common::nonNullRowsFromSparse < hasFilter,
+             !hasFilter &&
+            !hasHook >
+                (nulls,
+                 rowsAsRange,
+                 *innerVector,
+                 *outerVector,
+                 (hasFilter || hasHook) ? nullptr : visitor.rawNulls(numRows),
+                 tailSkip);
+        if (anyNulls) {
+          visitor.setHasNulls();
+        }
+        if (innerVector->empty()) {
+          skip<false>(tailSkip, 0, nullptr);
+          visitor.setAllNull(hasFilter ? 0 : numRows);
+          return;
+        }
+        bulkScan<hasFilter, hasHook, true>(
+            *innerVector, outerVector->data(), visitor);
+        skip<false>(tailSkip, 0, nullptr);
+      }
+    } else {
+      bulkScan<hasFilter, hasHook, false>(rowsAsRange, nullptr, visitor);
+    }
+  }
+
+  // Returns true if the values of the current run are an arithmetic
+  // progression of 'firstValue' and 'runDelta()', i.e. a SHORT_REPEAT
+  // or a DELTA run with a fixed delta.
+  bool isLinearRun() const {
+    return type == SHORT_REPEAT || (type == DELTA && bitSize == 0);
+  }
+
+  int64_t runDelta() const {
+    return type == SHORT_REPEAT ? 0 : deltaBase;
+  }
+
+  // Returns the value at 'runRead' in a linear run.
+  int64_t linearValue() const {
+    return static_cast<int64_t>(
+        static_cast<uint64_t>(firstValue) +
+        runRead * static_cast<uint64_t>(runDelta()));
+  }
+
+  // Skips 'numValues' values of a linear run without decoding them.
+  void skipLinear(uint64_t numValues) {
+    runRead += numValues;
+    if (type == DELTA) {
+      prevValue = static_cast<int64_t>(
+          static_cast<uint64_t>(firstValue) +
+          (runRead - 1) * static_cast<uint64_t>(deltaBase));
+    }
+  }
+
+  // Decodes the values of the current run up to the last row of
+  // 'rows' in the run and passes the ones at 'rows' to the visitor.
+  template <bool hasFilter, bool hasHook, bool scatter, typename Visitor>
+  void processRun(
+      const int32_t* rows,
+      int32_t rowIndex,
+      int32_t currentRow,
+      int32_t numRows,
+      int32_t numAdvanced,
+      const int32_t* scatterRows,
+      int32_t* filterHits,
+      typename Visitor::DataType* values,
+      int32_t& numValues,
+      Visitor& visitor) {
+    using T = typename Visitor::DataType;
+    int64_t decoded[kMaxRunLength];
+    next(decoded, numAdvanced, nullptr);
+    auto* input = values + numValues;
+    if (Visitor::dense) {
+      for (auto i = 0; i < numRows; ++i) {
+        input[i] = static_cast<T>(decoded[i]);
+      }
+    } else {
+      for (auto i = 0; i < numRows; ++i) {
+        input[i] = static_cast<T>(decoded[rows[rowIndex + i] - currentRow]);
+      }
+    }
+    visitor.template processRun<hasFilter, hasHook, scatter>(
+        input, numRows, scatterRows, filterHits, values, numValues);
+  }
+
+  // Returns 1. how many of 'rows' are in the current run 2. the
+  // distance in rows from the current row to the first row after the
+  // last in rows that falls in the current run.
+  template <bool dense>
+  std::pair<int32_t, std::int32_t> findNumInRun(
+      const int32_t* rows,
+      int32_t rowIndex,
+      int32_t numRows,
+      int32_t currentRow) const {
+    DCHECK_LT(rowIndex, numRows);
+    const int32_t remainingValues = runLength - runRead;
+    if (dense) {
+      auto left = std::min<int32_t>(remainingValues, numRows - rowIndex);
+      return std::make_pair(left, left);
+    }
+    if (rows[rowIndex] - currentRow >= remainingValues) {
+      return std::make_pair(0, 0);
+    }
+    if (rows[numRows - 1] - currentRow < remainingValues) {
+      return std::pair(numRows - rowIndex, rows[numRows - 1] - currentRow + 1);
+    }
+    auto range = folly::Range<const int32_t*>(
+        rows + rowIndex,
+        std::min<int32_t>(remainingValues, numRows - rowIndex));
+    auto endOfRun = currentRow + remainingValues;
+    auto bound = std::lower_bound(range.begin(), range.end(), endOfRun);
+    return std::make_pair(bound - range.begin(), bound[-1] - currentRow + 1);
+  }
+
+  // Decodes a run at a time. Linear runs are given to the visitor as
+  // value and delta, the others are decoded in bulk and given to the
+  // visitor for filtering and hooks.
+  template <bool hasFilter, bool hasHook, bool scatter, typename Visitor>
+  void bulkScan(
+      folly::Range<const int32_t*> nonNullRows,
+      const int32_t* scatterRows,
+      Visitor& visitor) {
+    auto numAllRows = visitor.numRows();
+    visitor.setRows(nonNullRows);
+    auto rows = visitor.rows();
+    auto numRows = visitor.numRows();
+    auto rowIndex = 0;
+    int32_t currentRow = 0;
+    auto values = visitor.rawValues(numRows);
+    auto filterHits = hasFilter ? visitor.outputRows(numRows) : nullptr;
+    int32_t numValues = 0;
+    for (;;) {
+      if (runRead < runLength) {
+        auto [numInRun, numAdvanced] =
+            findNumInRun<Visitor::dense>(rows, rowIndex, numRows, currentRow);
+        if (!numInRun) {
+          // We are not at end and the next row of interest is after this run.
+          VELOX_CHECK(!numAdvanced, "Would advance past end of RLEv2 run");
+        } else if (isLinearRun()) {
+          visitor.template processRle<hasFilter, hasHook, scatter>(
+              linearValue(),
+              runDelta(),
+              numInRun,
+              currentRow,
+              scatterRows,
+              filterHits,
+              values,
+              numValues);
+          skipLinear(numAdvanced);
+        } else {
+          processRun<hasFilter, hasHook, scatter>(
+              rows,
+              rowIndex,
+              currentRow,
+              numInRun,
+              numAdvanced,
+              scatterRows,
+              filterHits,
+              values,
+              numValues,
+              visitor);
+        }
+        currentRow += numAdvanced;
+        rowIndex += numInRun;
+        if (visitor.atEnd()) {
+          visitor.setNumValues(hasFilter ? numValues : numAllRows);
+          return;
+        }
+        if (runRead < runLength) {
+          auto remaining = runLength - runRead;
+          currentRow += remaining;
+          if (isLinearRun()) {
+            skipLinear(remaining);
+          } else {
+            skip(remaining);
+          }
+        }
+      }
+      startRun();
+    }
+  }
+
+  // Reads the header of the next run and sets up 'this' for decoding
+  // it.
+  void startRun();
+
+  void readShortRepeatsHeader();
+  void readDirectHeader();
+  void readPatchedHeader();
+  void readDeltaHeader();
+
   // Used by PATCHED_BASE
   void adjustGapAndPatch() {
     curGap = static_cast<uint64_t>(unpackedPatch[patchIdx]) >> patchBitSize;
@@ -161,6 +389,37 @@ class RleDecoderV2 : public dwio::common::IntDecoder<isSigned> {
     return result;
   }
 
+  // Unpacks up to 'len' values of 'fb' bits from the current buffer into
+  // 'data' and returns how many were unpacked. Each value is extracted from
+  // a big endian 64 bit load at its first byte, so the loop has no data
+  // dependent branches. Stops before a load would cross the end of the
+  // buffer. Requires that the current position is byte aligned.
+  uint64_t unpackFast(int64_t* data, uint64_t len, uint64_t fb) {
+    auto& bufferStart = dwio::common::IntDecoder<isSigned>::bufferStart;
+    const uint64_t available =
+        dwio::common::IntDecoder<isSigned>::bufferEnd - bufferStart;
+    if (available < sizeof(uint64_t)) {
+      return 0;
+    }
+    const uint64_t numFits =
+        ((available - sizeof(uint64_t)) * 8 + 7) / fb + 1;
+    const uint64_t numValues = std::min(len, numFits);
+    const uint64_t shift = 64 - fb;
+    uint64_t bitOffset = 0;
+    for (uint64_t i = 0; i < numValues; ++i) {
+      const auto word = folly::Endian::big(
+          folly::loadUnaligned<uint64_t>(bufferStart + (bitOffset >> 3)));
+      data[i] = static_cast<int64_t>((word << (bitOffset & 7)) >> shift);
+      bitOffset += fb;
+    }
+    bufferStart += bitOffset >> 3;
+    if (bitOffset & 7) {
+      curByte = readByte();
+      bitsLeft = 8 - (bitOffset & 7);
+    }
+    return numValues;
+  }
+
   int64_t readLongBE(uint64_t bsz);
   uint64_t readLongs(
       int64_t* data,
@@ -170,7 +429,12 @@ class RleDecoderV2 : public dwio::common::IntDecoder<isSigned> {
       const uint64_t* nulls = nullptr) {
     uint64_t ret = 0;
 
-    // TODO: unroll to improve performance
+    if (!nulls && bitsLeft == 0 && fb > 0 && fb <= 56) {
+      ret = unpackFast(data + offset, len, fb);
+      offset += ret;
+      len -= ret;
+    }
+
     for (uint64_t i = offset; i < (offset + len); i++) {
       // skip null positions
       if (nulls && bits::isBitNull(nulls, i)) {
@@ -47,6 +47,10 @@ DwrfData::DwrfData(
       encodingKey.forKind(proto::Stream_Kind_ROW_INDEX),
       streamLabels.label(),
       false);
+  bloomFilterStream_ = stripe.getStream(
+      encodingKey.forKind(proto::Stream_Kind_BLOOM_FILTER_UTF8),
+      streamLabels.label(),
+      false);
 }
 
 uint64_t DwrfData::skipNulls(uint64_t numValues, bool /*nullsOnly*/) {
@@ -136,6 +140,75 @@ void DwrfData::readNulls(
   }
 }
 
+bool DwrfData::testBloomFilter(const common::Filter& filter, int32_t index) {
+  if (filter.testNull()) {
+    // Nulls are not in the bloom filter.
+    return true;
+  }
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange:
+      if (!static_cast<const common::BigintRange&>(filter).isSingleValue()) {
+        return true;
+      }
+      break;
+    case common::FilterKind::kBigintValuesUsingHashTable:
+    case common::FilterKind::kBigintValuesUsingBitmask:
+    case common::FilterKind::kBytesValues:
+      break;
+    case common::FilterKind::kBytesRange:
+      if (!static_cast<const common::BytesRange&>(filter).isSingleValue()) {
+        return true;
+      }
+      break;
+    default:
+      return true;
+  }
+  if (bloomFilterStream_) {
+    bloomFilters_ = ProtoUtils::readProto<proto::BloomFilterIndex>(
+        std::move(bloomFilterStream_));
+  }
+  if (!bloomFilters_ || index >= bloomFilters_->bloomfilter_size()) {
+    return true;
+  }
+  BloomFilter bloomFilter(bloomFilters_->bloomfilter(index));
+  auto testAnyLong = [&](const auto& values) {
+    for (auto value : values) {
+      if (bloomFilter.testLong(value)) {
+        return true;
+      }
+    }
+    return false;
+  };
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange:
+      return bloomFilter.testLong(
+          static_cast<const common::BigintRange&>(filter).lower());
+    case common::FilterKind::kBigintValuesUsingHashTable:
+      return testAnyLong(
+          static_cast<const common::BigintValuesUsingHashTable&>(filter)
+              .values());
+    case common::FilterKind::kBigintValuesUsingBitmask:
+      return testAnyLong(
+          static_cast<const common::BigintValuesUsingBitmask&>(filter)
+              .values());
+    case common::FilterKind::kBytesValues: {
+      auto& values = static_cast<const common::BytesValues&>(filter).values();
+      for (auto& value : values) {
+        if (bloomFilter.testBytes(value.data(), value.size())) {
+          return true;
+        }
+      }
+      return false;
+    }
+    case common::FilterKind::kBytesRange: {
+      auto& value = static_cast<const common::BytesRange&>(filter).lower();
+      return bloomFilter.testBytes(value.data(), value.size());
+    }
+    default:
+      return true;
+  }
+}
+
 void DwrfData::filterRowGroups(
     const common::ScanSpec& scanSpec,
     uint64_t rowGroupSize,
@@ -162,8 +235,9 @@ void DwrfData::filterRowGroups(
     auto columnStats =
         buildColumnStatisticsFromProto(entry.statistics(), *dwrfContext);
     if (filter &&
-        !testFilter(
-            filter, columnStats.get(), rowGroupSize, nodeType_->type())) {
+        (!testFilter(
+             filter, columnStats.get(), rowGroupSize, nodeType_->type()) ||
+         !testBloomFilter(*filter, i))) {
       VLOG(1) << "Drop stride " << i << " on " << scanSpec.toString();
       bits::setBit(result.filterResult.data(), i);
       continue;
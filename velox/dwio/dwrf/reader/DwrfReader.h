@@ -307,6 +307,16 @@ class DwrfReader : public dwio::common::Reader {
     return readerBase_->getFooter();
   }
 
+  std::vector<uint64_t> stripeOffsets() const override {
+    auto& footer = readerBase_->getFooter();
+    std::vector<uint64_t> offsets;
+    offsets.reserve(footer.stripesSize());
+    for (auto i = 0; i < footer.stripesSize(); ++i) {
+      offsets.push_back(footer.stripes(i).offset());
+    }
+    return offsets;
+  }
+
   std::optional<uint64_t> numberOfRows() const override {
     auto& footer = readerBase_->getFooter();
     if (footer.hasNumberOfRows()) {
@@ -18,6 +18,7 @@
 
 #include <fmt/format.h>
 
+#include "velox/dwio/common/FileMetadataCache.h"
 #include "velox/dwio/common/exception/Exception.h"
 
 namespace facebook::velox::dwrf {
@@ -31,6 +32,23 @@ using dwio::common::encryption::DecrypterFactory;
 using encryption::DecryptionHandler;
 using memory::MemoryPool;
 
+namespace {
+// The parsed post script and footer of a file in FileMetadataCache.
+struct DwrfFileTail : public dwio::common::FileMetadataCache::Entry {
+  std::shared_ptr<google::protobuf::Arena> arena;
+  std::shared_ptr<const PostScript> postScript;
+  // One of the footers is set, depending on the format. Allocated from
+  // 'arena'.
+  const proto::Footer* dwrfFooter{nullptr};
+  const proto::orc::Footer* orcFooter{nullptr};
+  uint64_t psLength{0};
+
+  uint64_t memoryBytes() const override {
+    return arena->SpaceAllocated() + sizeof(*this) + psLength;
+  }
+};
+} // namespace
+
 FooterStatisticsImpl::FooterStatisticsImpl(
     const ReaderBase& reader,
     const StatsContext& statsContext) {
@@ -111,9 +129,97 @@ ReaderBase::ReaderBase(
       preloadFile ? fileLength_ : std::min(fileLength_, directorySizeGuess_);
   DWIO_ENSURE_GE(readSize, 4, "File size too small");
 
-  input_->enqueue({fileLength_ - readSize, readSize, "footer"});
-  input_->load(preloadFile ? LogType::FILE : LogType::FOOTER);
+  auto* metadataCache = dwio::common::FileMetadataCache::getInstance();
+  auto* ioStats = input_->ioStatistics();
+  const dwio::common::FileMetadataCache::Key cacheKey{
+      fileFormat, input_->getReadFile()->getName(), fileLength_};
+  std::shared_ptr<const DwrfFileTail> cachedTail;
+  if (metadataCache != nullptr) {
+    cachedTail = std::dynamic_pointer_cast<const DwrfFileTail>(
+        metadataCache->find(cacheKey));
+  }
+  if (cachedTail != nullptr) {
+    // The footer is not read but a small file is still loaded in one IO.
+    if (preloadFile) {
+      input_->enqueue({0, fileLength_, "footer"});
+      input_->load(LogType::FILE);
+    }
+    psLength_ = cachedTail->psLength;
+    postScript_ = cachedTail->postScript;
+    footerArena_ = cachedTail->arena;
+    if (cachedTail->dwrfFooter != nullptr) {
+      footer_ = std::make_unique<FooterWrapper>(cachedTail->dwrfFooter);
+    } else {
+      footer_ = std::make_unique<FooterWrapper>(cachedTail->orcFooter);
+    }
+    if (ioStats != nullptr) {
+      ioStats->metadataCacheHit().increment(cachedTail->memoryBytes());
+    }
+  } else {
+    input_->enqueue({fileLength_ - readSize, readSize, "footer"});
+    input_->load(preloadFile ? LogType::FILE : LogType::FOOTER);
+    readTail(fileFormat, readSize);
+    if (metadataCache != nullptr) {
+      auto tail = std::make_shared<DwrfFileTail>();
+      tail->arena = footerArena_;
+      tail->postScript = postScript_;
+      if (footer_->format() == DwrfFormat::kDwrf) {
+        tail->dwrfFooter = footer_->getDwrfPtr();
+      } else {
+        tail->orcFooter = footer_->getOrcPtr();
+      }
+      tail->psLength = psLength_;
+      if (ioStats != nullptr) {
+        ioStats->metadataCacheMiss().increment(tail->memoryBytes());
+      }
+      metadataCache->insert(cacheKey, std::move(tail));
+    }
+  }
+  const uint64_t cacheSize =
+      postScript_->hasCacheSize() ? postScript_->cacheSize() : 0;
+  const uint64_t tailSize =
+      1 + psLength_ + postScript_->footerLength() + cacheSize;
+
+  schema_ = std::dynamic_pointer_cast<const RowType>(
+      convertType(*footer_, 0, fileColumnNamesReadAsLowerCase));
+  DWIO_ENSURE_NOT_NULL(schema_, "invalid schema");
 
+  // load stripe index/footer cache
+  if (cacheSize > 0) {
+    DWIO_ENSURE_EQ(format(), DwrfFormat::kDwrf);
+    if (input_->shouldPrefetchStripes()) {
+      cache_ = std::make_unique<StripeMetadataCache>(
+          postScript_->cacheMode(),
+          *footer_,
+          input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER));
+      input_->load(LogType::FOOTER);
+    } else {
+      auto cacheBuffer =
+          std::make_shared<dwio::common::DataBuffer<char>>(pool, cacheSize);
+      input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER)
+          ->readFully(cacheBuffer->data(), cacheSize);
+      cache_ = std::make_unique<StripeMetadataCache>(
+          postScript_->cacheMode(), *footer_, std::move(cacheBuffer));
+    }
+  }
+  if (!cache_ && input_->shouldPrefetchStripes()) {
+    auto numStripes = getFooter().stripesSize();
+    for (auto i = 0; i < numStripes; i++) {
+      const auto stripe = getFooter().stripes(i);
+      input_->enqueue(
+          {stripe.offset() + stripe.indexLength() + stripe.dataLength(),
+           stripe.footerLength(),
+           "stripe_footer"});
+    }
+    if (numStripes) {
+      input_->load(LogType::FOOTER);
+    }
+  }
+  // initialize file decrypter
+  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
+}
+
+void ReaderBase::readTail(FileFormat fileFormat, uint64_t readSize) {
   // TODO: read footer from spectrum
   {
     const void* buf;
@@ -164,61 +270,24 @@ ReaderBase::ReaderBase(
     input_->load(LogType::FOOTER);
   }
 
+  footerArena_ = std::make_shared<google::protobuf::Arena>();
   auto footerStream = input_->read(
       fileLength_ - psLength_ - footerSize - 1, footerSize, LogType::FOOTER);
   if (fileFormat == FileFormat::DWRF) {
-    auto footer =
-        google::protobuf::Arena::CreateMessage<proto::Footer>(arena_.get());
+    auto footer = google::protobuf::Arena::CreateMessage<proto::Footer>(
+        footerArena_.get());
     ProtoUtils::readProtoInto<proto::Footer>(
         createDecompressedStream(std::move(footerStream), "File Footer"),
         footer);
     footer_ = std::make_unique<FooterWrapper>(footer);
   } else {
     auto footer = google::protobuf::Arena::CreateMessage<proto::orc::Footer>(
-        arena_.get());
+        footerArena_.get());
     ProtoUtils::readProtoInto<proto::orc::Footer>(
         createDecompressedStream(std::move(footerStream), "File Footer"),
         footer);
     footer_ = std::make_unique<FooterWrapper>(footer);
   }
-
-  schema_ = std::dynamic_pointer_cast<const RowType>(
-      convertType(*footer_, 0, fileColumnNamesReadAsLowerCase));
-  DWIO_ENSURE_NOT_NULL(schema_, "invalid schema");
-
-  // load stripe index/footer cache
-  if (cacheSize > 0) {
-    DWIO_ENSURE_EQ(format(), DwrfFormat::kDwrf);
-    if (input_->shouldPrefetchStripes()) {
-      cache_ = std::make_unique<StripeMetadataCache>(
-          postScript_->cacheMode(),
-          *footer_,
-          input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER));
-      input_->load(LogType::FOOTER);
-    } else {
-      auto cacheBuffer =
-          std::make_shared<dwio::common::DataBuffer<char>>(pool, cacheSize);
-      input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER)
-          ->readFully(cacheBuffer->data(), cacheSize);
-      cache_ = std::make_unique<StripeMetadataCache>(
-          postScript_->cacheMode(), *footer_, std::move(cacheBuffer));
-    }
-  }
-  if (!cache_ && input_->shouldPrefetchStripes()) {
-    auto numStripes = getFooter().stripesSize();
-    for (auto i = 0; i < numStripes; i++) {
-      const auto stripe = getFooter().stripes(i);
-      input_->enqueue(
-          {stripe.offset() + stripe.indexLength() + stripe.dataLength(),
-           stripe.footerLength(),
-           "stripe_footer"});
-    }
-    if (numStripes) {
-      input_->load(LogType::FOOTER);
-    }
-  }
-  // initialize file decrypter
-  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
 }
 
 std::vector<uint64_t> ReaderBase::getRowsPerStripe() const {
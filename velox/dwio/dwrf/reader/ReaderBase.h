@@ -235,9 +235,16 @@ class ReaderBase {
       uint32_t index = 0,
       bool fileColumnNamesReadAsLowerCase = false);
 
+  // Reads and parses the post script and the footer. Sets 'psLength_',
+  // 'postScript_', 'footerArena_' and 'footer_'. 'readSize' bytes at the end
+  // of the file are loaded.
+  void readTail(dwio::common::FileFormat fileFormat, uint64_t readSize);
+
   memory::MemoryPool& pool_;
   std::unique_ptr<google::protobuf::Arena> arena_;
-  std::unique_ptr<PostScript> postScript_;
+  std::shared_ptr<const PostScript> postScript_;
+  // Holds the footer. Shared with FileMetadataCache if the footer is cached.
+  std::shared_ptr<google::protobuf::Arena> footerArena_;
   std::unique_ptr<FooterWrapper> footer_ = nullptr;
   std::unique_ptr<StripeMetadataCache> cache_;
   // Keeps factory alive for possibly async prefetch.
@@ -106,12 +106,45 @@ void SelectiveDecimalColumnReader<DataT>::readHelper(RowSet rows) {
   readOffset_ += numRows;
 }
 
+template <typename DataT>
+bool SelectiveDecimalColumnReader<DataT>::scalesMatch(
+    const uint64_t* nulls) const {
+  auto scales = scaleBuffer_->as<int64_t>();
+  for (vector_size_t i = 0; i < numValues_; ++i) {
+    if ((!nulls || !bits::isBitNull(nulls, i)) && scales[i] != scale_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename DataT>
+template <typename TFilter>
+void SelectiveDecimalColumnReader<DataT>::filterValues(
+    const TFilter& filter,
+    RowSet rows) {
+  auto values = reinterpret_cast<DataT*>(rawValues_);
+  auto nulls = anyNulls_ ? rawResultNulls_ : nullptr;
+  vector_size_t numPassed = 0;
+  for (vector_size_t i = 0; i < numValues_; ++i) {
+    const bool isNull = nulls && bits::isBitNull(nulls, i);
+    if (isNull ? filter.testNull() : common::applyFilter(filter, values[i])) {
+      values[numPassed] = values[i];
+      if (nulls) {
+        bits::setNull(nulls, numPassed, isNull);
+      }
+      addOutputRow(rows[i]);
+      ++numPassed;
+    }
+  }
+  numValues_ = numPassed;
+}
+
 template <typename DataT>
 void SelectiveDecimalColumnReader<DataT>::read(
     vector_size_t offset,
     RowSet rows,
     const uint64_t* incomingNulls) {
-  VELOX_CHECK(!scanSpec_->filter());
   prepareRead<int64_t>(offset, rows, incomingNulls);
   bool isDense = rows.back() == rows.size() - 1;
   if (isDense) {
@@ -119,23 +152,46 @@ void SelectiveDecimalColumnReader<DataT>::read(
   } else {
     readHelper<false>(rows);
   }
-}
 
-template <typename DataT>
-void SelectiveDecimalColumnReader<DataT>::getValues(
-    RowSet rows,
-    VectorPtr* result) {
+  // Rescale in read so that a filter sees the values at the requested scale.
+  // The writer usually uses one scale for a column, so the values can most
+  // often be used as decoded.
   auto nullsPtr = nullsInReadRange_
       ? (returnReaderNulls_ ? nullsInReadRange_->as<uint64_t>()
                             : rawResultNulls_)
       : nullptr;
-  auto scales = scaleBuffer_->as<int64_t>();
-  auto values = values_->asMutable<DataT>();
+  if (!scalesMatch(nullsPtr)) {
+    auto values = reinterpret_cast<DataT*>(rawValues_);
+    DecimalUtil::fillDecimals<DataT>(
+        values,
+        nullsPtr,
+        values,
+        scaleBuffer_->as<int64_t>(),
+        numValues_,
+        scale_);
+  }
 
-  DecimalUtil::fillDecimals<DataT>(
-      values, nullsPtr, values, scales, numValues_, scale_);
+  auto filter = scanSpec_->filter();
+  if (!filter || filter->kind() == common::FilterKind::kAlwaysTrue) {
+    return;
+  }
+  switch (filter->kind()) {
+    case common::FilterKind::kBigintRange:
+      filterValues(*static_cast<const common::BigintRange*>(filter), rows);
+      break;
+    case common::FilterKind::kHugeintRange:
+      filterValues(*static_cast<const common::HugeintRange*>(filter), rows);
+      break;
+    default:
+      filterValues(*filter, rows);
+      break;
+  }
+}
 
-  rawValues_ = values_->asMutable<char>();
+template <typename DataT>
+void SelectiveDecimalColumnReader<DataT>::getValues(
+    RowSet rows,
+    VectorPtr* result) {
   getIntValues(rows, requestedType_, result);
 }
 
@@ -44,6 +44,14 @@ class SelectiveDecimalColumnReader : public SelectiveColumnReader {
   template <bool kDense>
   void readHelper(RowSet rows);
 
+  // Returns true if every non-null value read has the scale of the requested
+  // type, in which case the values need no rescaling.
+  bool scalesMatch(const uint64_t* nulls) const;
+
+  // Applies 'filter' to the rescaled values and keeps the passing ones.
+  template <typename TFilter>
+  void filterValues(const TFilter& filter, RowSet rows);
+
   std::unique_ptr<IntDecoder<true>> valueDecoder_;
   std::unique_ptr<IntDecoder<true>> scaleDecoder_;
 
@@ -196,17 +196,45 @@ class SelectiveFlatMapAsStructReader : public SelectiveStructColumnReaderBase {
         keyNodes_(
             getKeyNodes<T>(requestedType, dataType, params, scanSpec, true)) {
     VELOX_CHECK(
-        !keyNodes_.empty(),
+        !scanSpec.children().empty(),
         "For struct encoding, keys to project must be configured");
+    // Keys that are not in this stripe read as null fields. The subscripts
+    // are left from the previous stripe, so reset them before assigning the
+    // ones of the keys present.
+    for (auto& childSpec : scanSpec.stableChildren()) {
+      childSpec->setSubscript(kConstantChildSpecSubscript);
+    }
     children_.resize(keyNodes_.size());
     for (int i = 0; i < keyNodes_.size(); ++i) {
       keyNodes_[i].reader->scanSpec()->setSubscript(i);
       children_[i] = keyNodes_[i].reader.get();
     }
+    for (auto& childSpec : scanSpec.stableChildren()) {
+      if (!childSpec->isConstant() &&
+          childSpec->subscript() == kConstantChildSpecSubscript &&
+          (childSpec->filter() ? !childSpec->filter()->testNull()
+                               : childSpec->hasFilter())) {
+        missingKeyRejectsNull_ = true;
+      }
+    }
+  }
+
+  void read(vector_size_t offset, RowSet rows, const uint64_t* incomingNulls)
+      override {
+    if (!missingKeyRejectsNull_) {
+      SelectiveStructColumnReaderBase::read(offset, rows, incomingNulls);
+      return;
+    }
+    // A key with a filter that rejects nulls is not in this stripe, so no row
+    // passes.
+    numReads_ = scanSpec_->newRead();
+    prepareRead<char>(offset, rows, incomingNulls);
+    readOffset_ = offset + rows.back() + 1;
   }
 
  private:
   std::vector<KeyNode<T>> keyNodes_;
+  bool missingKeyRejectsNull_{false};
 };
 
 template <typename T>
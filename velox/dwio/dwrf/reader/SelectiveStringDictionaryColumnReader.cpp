@@ -28,7 +28,8 @@ SelectiveStringDictionaryColumnReader::SelectiveStringDictionaryColumnReader(
     common::ScanSpec& scanSpec)
     : SelectiveColumnReader(nodeType->type(), params, scanSpec, nodeType),
       lastStrideIndex_(-1),
-      provider_(params.stripeStreams().getStrideIndexProvider()) {
+      provider_(params.stripeStreams().getStrideIndexProvider()),
+      maxEagerFilterEntries_(params.stripeStreams().rowsPerRowGroup()) {
   auto& stripe = params.stripeStreams();
   EncodingKey encodingKey{fileType_->id(), params.flatMapContext().sequence};
   version_ = convertRleVersion(stripe.getEncoding(encodingKey).kind());
@@ -129,6 +130,45 @@ void SelectiveStringDictionaryColumnReader::loadDictionary(
   }
 }
 
+namespace {
+bool isBytesFilter(common::FilterKind kind) {
+  switch (kind) {
+    case common::FilterKind::kBytesRange:
+    case common::FilterKind::kNegatedBytesRange:
+    case common::FilterKind::kBytesValues:
+    case common::FilterKind::kNegatedBytesValues:
+      return true;
+    default:
+      return false;
+  }
+}
+} // namespace
+
+void SelectiveStringDictionaryColumnReader::initFilterCache(
+    const DictionaryValues& values,
+    int32_t offset) {
+  if (values.numValues == 0) {
+    return;
+  }
+  auto* cache = scanState_.filterCache.data() + offset;
+  auto* filter = scanSpec_->filter();
+  if (!filter || !filter->isDeterministic() || !isBytesFilter(filter->kind()) ||
+      values.numValues > maxEagerFilterEntries_) {
+    simd::memset(cache, FilterResult::kUnknown, values.numValues);
+    return;
+  }
+  // Evaluates the filter on each entry once so that the rows are filtered by
+  // a gather over the dictionary indices without checks for unknown results.
+  auto* views = values.values->as<StringView>();
+  filterPassed_.resize(bits::nwords(values.numValues));
+  filter->testStringViews(views, values.numValues, filterPassed_.data());
+  for (auto i = 0; i < values.numValues; ++i) {
+    cache[i] = bits::isBitSet(filterPassed_.data(), i)
+        ? FilterResult::kSuccess
+        : FilterResult::kFailure;
+  }
+}
+
 void SelectiveStringDictionaryColumnReader::loadStrideDictionary() {
   auto nextStride = provider_.getStrideIndex();
   if (nextStride == lastStrideIndex_) {
@@ -156,10 +196,7 @@ void SelectiveStringDictionaryColumnReader::loadStrideDictionary() {
   if (scanSpec_->hasFilter()) {
     scanState_.filterCache.resize(
         scanState_.dictionary.numValues + scanState_.dictionary2.numValues);
-    simd::memset(
-        scanState_.filterCache.data() + scanState_.dictionary.numValues,
-        FilterResult::kUnknown,
-        scanState_.dictionary2.numValues);
+    initFilterCache(scanState_.dictionary2, scanState_.dictionary.numValues);
   }
   scanState_.updateRawState();
 }
@@ -298,10 +335,7 @@ void SelectiveStringDictionaryColumnReader::ensureInitialized() {
 
   if (scanSpec_->hasFilter()) {
     scanState_.filterCache.resize(scanState_.dictionary.numValues);
-    simd::memset(
-        scanState_.filterCache.data(),
-        FilterResult::kUnknown,
-        scanState_.dictionary.numValues);
+    initFilterCache(scanState_.dictionary, 0);
   }
 
   // handle in dictionary stream
@@ -81,6 +81,15 @@ class SelectiveStringDictionaryColumnReader
       dwio::common::IntDecoder</*isSigned*/ false>& lengthDecoder,
       dwio::common::DictionaryValues& values);
   void ensureInitialized();
+
+  // Fills the part of 'scanState_.filterCache' starting at 'offset' with the
+  // result of the filter on each value of 'values' if the filter is cheaper
+  // to evaluate once per dictionary entry than on first use. Otherwise sets it
+  // to kUnknown for evaluation on first use.
+  void initFilterCache(
+      const dwio::common::DictionaryValues& values,
+      int32_t offset);
+
   std::unique_ptr<dwio::common::IntDecoder</*isSigned*/ false>> dictIndex_;
   std::unique_ptr<ByteRleDecoder> inDictionaryReader_;
   std::unique_ptr<dwio::common::SeekableInputStream> strideDictStream_;
@@ -96,6 +105,16 @@ class SelectiveStringDictionaryColumnReader
 
   const StrideIndexProvider& provider_;
 
+  // Maximum number of entries of a dictionary for evaluating the filter on
+  // all of them when the dictionary is loaded. A dictionary with at most a
+  // row group's worth of entries is low cardinality and most of its entries
+  // are hit.
+  const uint32_t maxEagerFilterEntries_;
+
+  // Bits of the dictionary entries that pass the filter, reused across
+  // dictionaries.
+  std::vector<uint64_t> filterPassed_;
+
   // lazy load the dictionary
   std::unique_ptr<dwio::common::IntDecoder</*isSigned*/ false>> lengthDecoder_;
   std::unique_ptr<dwio::common::SeekableInputStream> blobStream_;
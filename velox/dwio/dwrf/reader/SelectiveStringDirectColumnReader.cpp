@@ -76,6 +76,11 @@ void SelectiveStringDirectColumnReader::extractCrossBuffers(
       if (size <= StringView::kInlineSize) {
         reinterpret_cast<StringView*>(rawValues_)[index] =
             StringView(value.data(), size);
+      } else if (
+          value.data() >= ownedStringsBegin_ &&
+          value.data() + size <= ownedStringsEnd_) {
+        reinterpret_cast<StringView*>(rawValues_)[index] =
+            StringView(value.data(), size);
       } else {
         auto copy = copyStringValue(value);
         reinterpret_cast<StringView*>(rawValues_)[index] =
@@ -147,6 +152,10 @@ inline bool SelectiveStringDirectColumnReader::try8Consecutive(
   if (!data || bufferEnd_ - data < start + 8 * 12) {
     return false;
   }
+  referenceStreamBuffer();
+  // 'data' stays inside the current stream buffer, so long strings can refer
+  // to it if the buffer has an owner.
+  const bool referenceData = ownedStringsBegin_ != nullptr;
   int32_t* result = reinterpret_cast<int32_t*>(rawValues_);
   int32_t resultIndex = numValues_ * 4 - 4;
   auto rawUsed = rawStringUsed_;
@@ -179,6 +188,11 @@ inline bool SelectiveStringDirectColumnReader::try8Consecutive(
           reinterpret_cast<char*>(result + resultIndex + 1) + length) = 0;
       continue;
     }
+    if (referenceData) {
+      *reinterpret_cast<const char**>(result + resultIndex + 2) = data;
+      data += length;
+      continue;
+    }
     if (!rawStringBuffer_ || rawUsed + length > rawStringSize_) {
       // Slow path if no space in raw strings
       return false;
@@ -258,6 +272,9 @@ folly::StringPiece SelectiveStringDirectColumnReader::readValue(
   // we're reading.
   if (bufferEnd_ - bufferStart_ >= length) {
     bytesToSkip_ = length;
+    if (length > StringView::kInlineSize) {
+      referenceStreamBuffer();
+    }
     return folly::StringPiece(bufferStart_, length);
   }
   tempString_.resize(length);
@@ -40,6 +40,7 @@ class SelectiveStringDirectColumnReader
 
     bytesToSkip_ = 0;
     bufferStart_ = bufferEnd_;
+    clearOwnedStrings();
   }
 
   uint64_t skip(uint64_t numValues) override;
@@ -51,10 +52,36 @@ class SelectiveStringDirectColumnReader
     rawStringBuffer_ = nullptr;
     rawStringSize_ = 0;
     rawStringUsed_ = 0;
+    // The result takes 'stringBuffers_', including the owner of the current
+    // stream buffer, so the next read gets a new owner.
+    clearOwnedStrings();
     getFlatValues<StringView, StringView>(rows, result, requestedType());
   }
 
  private:
+  // Makes the strings in the current buffer of 'blobStream_' referenced
+  // instead of copied if the stream can give out an owner for its buffer.
+  void referenceStreamBuffer() {
+    if (bufferEnd_ == checkedBufferEnd_) {
+      return;
+    }
+    checkedBufferEnd_ = bufferEnd_;
+    if (auto owner = blobStream_->currentBufferOwner()) {
+      ownedStringsBegin_ = owner->as<char>();
+      ownedStringsEnd_ = ownedStringsBegin_ + owner->size();
+      stringBuffers_.push_back(std::move(owner));
+    } else {
+      ownedStringsBegin_ = nullptr;
+      ownedStringsEnd_ = nullptr;
+    }
+  }
+
+  void clearOwnedStrings() {
+    checkedBufferEnd_ = nullptr;
+    ownedStringsBegin_ = nullptr;
+    ownedStringsEnd_ = nullptr;
+  }
+
   template <bool hasNulls>
   void skipInDecode(int32_t numValues, int32_t current, const uint64_t* nulls);
 
@@ -102,6 +129,8 @@ class SelectiveStringDirectColumnReader
   int32_t lengthIndex_ = 0;
   const uint32_t* rawLengths_ = nullptr;
   int64_t bytesToSkip_ = 0;
+  // 'bufferEnd_' at the last referenceStreamBuffer().
+  const char* checkedBufferEnd_ = nullptr;
   // Storage for a string straddling a buffer boundary. Needed for calling
   // the filter.
   std::string tempString_;
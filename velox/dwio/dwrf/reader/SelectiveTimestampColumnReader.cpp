@@ -15,6 +15,7 @@
  */
 
 #include "velox/dwio/dwrf/reader/SelectiveTimestampColumnReader.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/dwio/common/BufferUtil.h"
 #include "velox/dwio/dwrf/common/DecoderUtil.h"
 
@@ -64,8 +65,131 @@ void SelectiveTimestampColumnReader::seekToRowGroup(uint32_t index) {
   VELOX_CHECK(!positionsProvider.hasNext());
 }
 
+namespace {
+
+// Classification of a row of a filtered read by its seconds.
+enum RowKind : uint8_t { kFail = 0, kPass = 1, kCompare = 2 };
+
+// Multipliers of the nanos by the number of trailing zeros in the low 3 bits.
+constexpr int64_t kNanoScales[8] =
+    {1, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000};
+
+Timestamp makeTimestamp(int64_t seconds, uint64_t nanos) {
+  nanos = (nanos >> 3) * kNanoScales[nanos & 7];
+  seconds += EPOCH_OFFSET;
+  if (seconds < 0 && nanos != 0) {
+    seconds -= 1;
+  }
+  return Timestamp(seconds, nanos);
+}
+
+// Combines the seconds and encoded nanos of 'numValues' timestamps. The
+// positions that are null in 'nulls' get Timestamp().
+void fillTimestamps(
+    Timestamp* timestamps,
+    const uint64_t* nullsPtr,
+    const int64_t* secondsPtr,
+    const uint64_t* nanosPtr,
+    vector_size_t numValues) {
+  using Batch = xsimd::batch<int64_t>;
+  constexpr int32_t kWidth = Batch::size;
+  const auto zero = xsimd::broadcast<int64_t>(0);
+  const auto one = xsimd::broadcast<int64_t>(1);
+  const auto zerosMask = xsimd::broadcast<int64_t>(7);
+  const auto epochOffset = xsimd::broadcast<int64_t>(EPOCH_OFFSET);
+  alignas(Batch::arch_type::alignment()) int64_t zeros[kWidth];
+  alignas(Batch::arch_type::alignment()) int64_t seconds[kWidth];
+  alignas(Batch::arch_type::alignment()) int64_t nanos[kWidth];
+  vector_size_t i = 0;
+  for (; i + kWidth <= numValues; i += kWidth) {
+    const auto encoded =
+        Batch::load_unaligned(reinterpret_cast<const int64_t*>(nanosPtr + i));
+    (encoded & zerosMask).store_aligned(zeros);
+    const auto scaledNanos =
+        (encoded >> 3) * simd::gather(kNanoScales, zeros);
+    auto batchSeconds = Batch::load_unaligned(secondsPtr + i) + epochOffset;
+    batchSeconds = xsimd::select(
+        (batchSeconds < zero) & (scaledNanos != zero),
+        batchSeconds - one,
+        batchSeconds);
+    batchSeconds.store_aligned(seconds);
+    scaledNanos.store_aligned(nanos);
+    for (auto j = 0; j < kWidth; ++j) {
+      if (nullsPtr && bits::isBitNull(nullsPtr, i + j)) {
+        timestamps[i + j] = Timestamp();
+      } else {
+        timestamps[i + j] = Timestamp(seconds[j], nanos[j]);
+      }
+    }
+  }
+  for (; i < numValues; ++i) {
+    if (nullsPtr && bits::isBitNull(nullsPtr, i)) {
+      timestamps[i] = Timestamp();
+    } else {
+      timestamps[i] = makeTimestamp(secondsPtr[i], nanosPtr[i]);
+    }
+  }
+}
+
+// Sets 'kinds' for the stored seconds of 'numValues' timestamps tested by
+// 'filter'. A negative timestamp with nanos is one second below its stored
+// seconds, so only the rows within a second of a bound need their nanos.
+void classifySeconds(
+    const int64_t* secondsPtr,
+    vector_size_t numValues,
+    const common::TimestampRange& filter,
+    uint8_t* kinds) {
+  const auto lower = filter.lower();
+  const auto upper = filter.upper();
+  // A timestamp passes regardless of its nanos if its seconds are in
+  // [minPass, maxPass].
+  const int64_t minPass = lower.getSeconds() + (lower.getNanos() != 0);
+  const int64_t maxPass =
+      upper.getSeconds() - (upper.getNanos() != Timestamp::kMaxNanos);
+  auto kindOf = [&](int64_t seconds) {
+    const int64_t high = seconds + EPOCH_OFFSET;
+    const int64_t low = high - (high < 0);
+    if (low >= minPass && high <= maxPass) {
+      return kPass;
+    }
+    if (high < lower.getSeconds() || low > upper.getSeconds()) {
+      return kFail;
+    }
+    return kCompare;
+  };
+
+  using Batch = xsimd::batch<int64_t>;
+  constexpr int32_t kWidth = Batch::size;
+  const auto zero = xsimd::broadcast<int64_t>(0);
+  const auto one = xsimd::broadcast<int64_t>(1);
+  const auto epochOffset = xsimd::broadcast<int64_t>(EPOCH_OFFSET);
+  const auto minPassBatch = xsimd::broadcast<int64_t>(minPass);
+  const auto maxPassBatch = xsimd::broadcast<int64_t>(maxPass);
+  const auto lowerBatch = xsimd::broadcast<int64_t>(lower.getSeconds());
+  const auto upperBatch = xsimd::broadcast<int64_t>(upper.getSeconds());
+  vector_size_t i = 0;
+  for (; i + kWidth <= numValues; i += kWidth) {
+    const auto high = Batch::load_unaligned(secondsPtr + i) + epochOffset;
+    const auto low = xsimd::select(high < zero, high - one, high);
+    const auto passBits =
+        simd::toBitMask((low >= minPassBatch) & (high <= maxPassBatch));
+    const auto failBits =
+        simd::toBitMask((high < lowerBatch) | (low > upperBatch));
+    for (auto j = 0; j < kWidth; ++j) {
+      const bool pass = (passBits >> j) & 1;
+      const bool fail = (failBits >> j) & 1;
+      kinds[i + j] = pass ? kPass : (fail ? kFail : kCompare);
+    }
+  }
+  for (; i < numValues; ++i) {
+    kinds[i] = kindOf(secondsPtr[i]);
+  }
+}
+
+} // namespace
+
 template <bool dense>
-void SelectiveTimestampColumnReader::readHelper(RowSet rows) {
+void SelectiveTimestampColumnReader::readSeconds(RowSet rows) {
   ExtractToReader extractValues(this);
   common::AlwaysTrue filter;
   DirectRleColumnVisitor<
@@ -90,6 +214,18 @@ void SelectiveTimestampColumnReader::readHelper(RowSet rows) {
       secondsValues_->asMutable<char>(),
       rawValues_,
       numValues_ * sizeof(int64_t));
+}
+
+template <bool dense>
+void SelectiveTimestampColumnReader::readNanos(RowSet rows) {
+  ExtractToReader extractValues(this);
+  common::AlwaysTrue filter;
+  DirectRleColumnVisitor<
+      int64_t,
+      common::AlwaysTrue,
+      decltype(extractValues),
+      dense>
+      visitor(filter, this, rows, extractValues);
 
   // We read the nanos into 'values_' starting at index 0.
   numValues_ = 0;
@@ -100,19 +236,149 @@ void SelectiveTimestampColumnReader::readHelper(RowSet rows) {
   }
 }
 
+template <bool dense>
+void SelectiveTimestampColumnReader::readHelper(RowSet rows) {
+  readSeconds<dense>(rows);
+  readNanos<dense>(rows);
+}
+
+void SelectiveTimestampColumnReader::readWithFilter(RowSet rows) {
+  const auto* filter = scanSpec_->filter();
+  const bool keepValues = scanSpec_->keepValues();
+  if (!keepValues) {
+    // The seconds are extracted with their nulls also when only filtering.
+    prepareNulls(rows, nullsInReadRange_ != nullptr);
+  }
+  if (rows.back() == rows.size() - 1) {
+    readSeconds<true>(rows);
+  } else {
+    readSeconds<false>(rows);
+  }
+
+  const vector_size_t numRows = rows.size();
+  auto* rawSeconds = secondsValues_->asMutable<int64_t>();
+  rowKinds_.resize(numRows);
+  switch (filter->kind()) {
+    case common::FilterKind::kTimestampRange:
+      classifySeconds(
+          rawSeconds,
+          numRows,
+          *static_cast<const common::TimestampRange*>(filter),
+          rowKinds_.data());
+      break;
+    case common::FilterKind::kIsNull:
+      std::fill(rowKinds_.begin(), rowKinds_.end(), kFail);
+      break;
+    case common::FilterKind::kIsNotNull:
+      std::fill(rowKinds_.begin(), rowKinds_.end(), kPass);
+      break;
+    default:
+      std::fill(rowKinds_.begin(), rowKinds_.end(), kCompare);
+      break;
+  }
+
+  // Decode the nanos of the rows that are compared or returned. The others
+  // are skipped in the nanos stream.
+  const auto* rawNulls =
+      nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr;
+  nanoRows_.clear();
+  nanoIndices_.clear();
+  for (auto i = 0; i < numRows; ++i) {
+    if (rawNulls && bits::isBitNull(rawNulls, rows[i])) {
+      continue;
+    }
+    if (rowKinds_[i] == kCompare || (rowKinds_[i] == kPass && keepValues)) {
+      nanoRows_.push_back(rows[i]);
+      nanoIndices_.push_back(i);
+    }
+  }
+  if (!nanoRows_.empty()) {
+    readNanos<false>(nanoRows_);
+  }
+  const vector_size_t nanosEnd = nanoRows_.empty() ? 0 : nanoRows_.back() + 1;
+  const vector_size_t numSkipped = rawNulls
+      ? bits::countBits(rawNulls, nanosEnd, rows.back() + 1)
+      : rows.back() + 1 - nanosEnd;
+  if (numSkipped > 0) {
+    nano_->skip(numSkipped);
+  }
+
+  const vector_size_t numNanos = nanoRows_.size();
+  for (auto i = 0; i < numNanos; ++i) {
+    // In place since nanoIndices_[i] >= i.
+    rawSeconds[i] = rawSeconds[nanoIndices_[i]];
+  }
+  dwio::common::ensureCapacity<Timestamp>(
+      nanoTimestamps_, numNanos, &memoryPool_);
+  auto* timestamps = nanoTimestamps_->asMutable<Timestamp>();
+  fillTimestamps(
+      timestamps, nullptr, rawSeconds, values_->as<uint64_t>(), numNanos);
+
+  BufferPtr resultValues;
+  Timestamp* rawResult = nullptr;
+  if (keepValues) {
+    resultValues = AlignedBuffer::allocate<Timestamp>(numRows, &memoryPool_);
+    rawResult = resultValues->asMutable<Timestamp>();
+  }
+  const bool nullPasses = filter->testNull();
+  vector_size_t numPassed = 0;
+  vector_size_t nanoIndex = 0;
+  anyNulls_ = false;
+  for (auto i = 0; i < numRows; ++i) {
+    const auto row = rows[i];
+    if (rawNulls && bits::isBitNull(rawNulls, row)) {
+      if (!nullPasses) {
+        continue;
+      }
+      addOutputRow(row);
+      if (keepValues) {
+        anyNulls_ = true;
+        bits::setNull(rawResultNulls_, numPassed);
+        rawResult[numPassed++] = Timestamp();
+      }
+      continue;
+    }
+    const auto kind = rowKinds_[i];
+    if (kind == kFail) {
+      continue;
+    }
+    const Timestamp* timestamp = nullptr;
+    if (kind == kCompare || keepValues) {
+      timestamp = &timestamps[nanoIndex++];
+    }
+    if (kind == kCompare && !filter->testTimestamp(*timestamp)) {
+      continue;
+    }
+    addOutputRow(row);
+    if (keepValues) {
+      if (rawNulls) {
+        bits::clearNull(rawResultNulls_, numPassed);
+      }
+      rawResult[numPassed++] = *timestamp;
+    }
+  }
+
+  numValues_ = numPassed;
+  if (keepValues) {
+    values_ = std::move(resultValues);
+    rawValues_ = values_->asMutable<char>();
+    valueSize_ = sizeof(Timestamp);
+    timestampsCombined_ = true;
+  }
+}
+
 void SelectiveTimestampColumnReader::read(
     vector_size_t offset,
     RowSet rows,
     const uint64_t* incomingNulls) {
   prepareRead<int64_t>(offset, rows, incomingNulls);
-  VELOX_CHECK(
-      !scanSpec_->filter(),
-      "Selective reader for TIMESTAMP doesn't support filter pushdown yet");
   VELOX_CHECK(
       !scanSpec_->valueHook(),
       "Selective reader for TIMESTAMP doesn't support aggregation pushdown yet");
-  bool isDense = rows.back() == rows.size() - 1;
-  if (isDense) {
+  timestampsCombined_ = false;
+  if (scanSpec_->filter()) {
+    readWithFilter(rows);
+  } else if (rows.back() == rows.size() - 1) {
     readHelper<true>(rows);
   } else {
     readHelper<false>(rows);
@@ -120,47 +386,22 @@ void SelectiveTimestampColumnReader::read(
   readOffset_ += rows.back() + 1;
 }
 
-namespace {
-void fillTimestamps(
-    Timestamp* timestamps,
-    const uint64_t* nullsPtr,
-    const int64_t* secondsPtr,
-    const uint64_t* nanosPtr,
-    vector_size_t numValues) {
-  for (vector_size_t i = 0; i < numValues; i++) {
-    if (!nullsPtr || !bits::isBitNull(nullsPtr, i)) {
-      auto nanos = nanosPtr[i];
-      uint64_t zeros = nanos & 0x7;
-      nanos >>= 3;
-      if (zeros != 0) {
-        for (uint64_t j = 0; j <= zeros; ++j) {
-          nanos *= 10;
-        }
-      }
-      auto seconds = secondsPtr[i] + EPOCH_OFFSET;
-      if (seconds < 0 && nanos != 0) {
-        seconds -= 1;
-      }
-      timestamps[i] = Timestamp(seconds, nanos);
-    }
-  }
-}
-
-} // namespace
-
 void SelectiveTimestampColumnReader::getValues(RowSet rows, VectorPtr* result) {
-  // We merge the seconds and nanos into 'values_'
-  auto tsValues = AlignedBuffer::allocate<Timestamp>(numValues_, &memoryPool_);
-  auto rawTs = tsValues->asMutable<Timestamp>();
-  auto secondsData = secondsValues_->as<int64_t>();
-  auto nanosData = values_->as<uint64_t>();
-  auto rawNulls = nullsInReadRange_
-      ? (returnReaderNulls_ ? nullsInReadRange_->as<uint64_t>()
-                            : rawResultNulls_)
-      : nullptr;
-  fillTimestamps(rawTs, rawNulls, secondsData, nanosData, numValues_);
-  values_ = tsValues;
-  rawValues_ = values_->asMutable<char>();
+  if (!timestampsCombined_) {
+    // We merge the seconds and nanos into 'values_'
+    auto tsValues =
+        AlignedBuffer::allocate<Timestamp>(numValues_, &memoryPool_);
+    auto rawTs = tsValues->asMutable<Timestamp>();
+    auto secondsData = secondsValues_->as<int64_t>();
+    auto nanosData = values_->as<uint64_t>();
+    auto rawNulls = nullsInReadRange_
+        ? (returnReaderNulls_ ? nullsInReadRange_->as<uint64_t>()
+                              : rawResultNulls_)
+        : nullptr;
+    fillTimestamps(rawTs, rawNulls, secondsData, nanosData, numValues_);
+    values_ = tsValues;
+    rawValues_ = values_->asMutable<char>();
+  }
   getFlatValues<Timestamp, Timestamp>(rows, result, fileType_->type(), true);
 }
 
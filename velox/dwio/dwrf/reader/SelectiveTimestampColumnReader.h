@@ -44,12 +44,41 @@ class SelectiveTimestampColumnReader
   template <bool dense>
   void readHelper(RowSet rows);
 
+  // Decodes 'seconds_' for 'rows' into 'secondsValues_'.
+  template <bool dense>
+  void readSeconds(RowSet rows);
+
+  // Decodes 'nano_' for 'rows' into 'values_'.
+  template <bool dense>
+  void readNanos(RowSet rows);
+
+  // Applies the filter of 'scanSpec_'. The seconds are decoded first and
+  // decide most rows of a TimestampRange, so that the nanos are decoded only
+  // for the rows that are compared with the bounds or are returned. Leaves
+  // the passing Timestamps in 'values_'.
+  void readWithFilter(RowSet rows);
+
   std::unique_ptr<dwio::common::IntDecoder</*isSigned*/ true>> seconds_;
   std::unique_ptr<dwio::common::IntDecoder</*isSigned*/ false>> nano_;
 
   // Values from copied from 'seconds_'. Nanos are in 'values_'.
   BufferPtr secondsValues_;
   RleVersion version_;
+
+  // True if 'values_' holds Timestamps, i.e. the last read had a filter.
+  bool timestampsCombined_{false};
+
+  // Per row of a filtered read, whether it fails, passes or must be compared
+  // with its nanos.
+  raw_vector<uint8_t> rowKinds_;
+
+  // The rows of a filtered read whose nanos are decoded and their indices in
+  // the rows of the read.
+  raw_vector<vector_size_t> nanoRows_;
+  raw_vector<vector_size_t> nanoIndices_;
+
+  // The Timestamps of 'nanoRows_'.
+  BufferPtr nanoTimestamps_;
 };
 
 } // namespace facebook::velox::dwrf
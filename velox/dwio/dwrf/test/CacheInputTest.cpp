@@ -504,6 +504,43 @@ TEST_F(CacheTest, window) {
   EXPECT_FALSE(clone->Next(&buffer, &size));
 }
 
+TEST_F(CacheTest, currentBufferOwner) {
+  constexpr int32_t kMB = 1 << 20;
+  initializeCache(64 * kMB);
+  uint64_t fileId;
+  uint64_t groupId;
+  auto file = inputByPath("test_for_buffer_owner", fileId, groupId);
+  auto input = std::make_unique<CachedBufferedInput>(
+      file,
+      MetricsLog::voidLog(),
+      fileId,
+      cache_.get(),
+      nullptr,
+      groupId,
+      ioStats_,
+      executor_.get(),
+      ReaderOptions(pool_.get()));
+  auto stream = input->read(kMB, kMB, LogType::TEST);
+  EXPECT_EQ(nullptr, stream->currentBufferOwner());
+  const void* buffer;
+  int32_t size;
+  ASSERT_TRUE(stream->Next(&buffer, &size));
+  auto owner = stream->currentBufferOwner();
+  ASSERT_NE(nullptr, owner);
+  auto* data = reinterpret_cast<const char*>(buffer);
+  EXPECT_LE(owner->as<char>(), data);
+  EXPECT_GE(owner->as<char>() + owner->size(), data + size);
+  const std::string expected(data, size);
+
+  // The owner keeps the entry pinned after the stream is gone.
+  stream.reset();
+  input.reset();
+  EXPECT_EQ(1, cache_->refreshStats().numShared);
+  EXPECT_EQ(expected, std::string(data, size));
+  owner.reset();
+  EXPECT_EQ(0, cache_->refreshStats().numShared);
+}
+
 TEST_F(CacheTest, bufferedInput) {
   // Size 160 MB. Frequent evictions and not everything fits in prefetch window.
   initializeCache(160 << 20);
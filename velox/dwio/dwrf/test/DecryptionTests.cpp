@@ -15,7 +15,9 @@
  */
 
 #include <gmock/gmock.h>
+#include <folly/String.h>
 #include <gtest/gtest.h>
+#include "velox/dwio/common/encryption/AesCtr.h"
 #include "velox/dwio/common/encryption/TestProvider.h"
 #include "velox/dwio/dwrf/test/OrcTest.h"
 #include "velox/dwio/dwrf/utils/ProtoUtils.h"
@@ -256,3 +258,48 @@ TEST(Decryption, GroupOverlap) {
   ASSERT_THROW(
       DecryptionHandler::create(footer, &factory), exception::LoggedException);
 }
+
+TEST(Decryption, AesCtr) {
+  // Test vector F.5.1 of NIST SP 800-38A.
+  const auto key = folly::unhexlify("2b7e151628aed2a6abf7158809cf4f3c");
+  const auto encrypted = folly::unhexlify(
+      "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff874d6191b620e3261bef6864990db6ce");
+  AesCtrDecrypterFactory factory([&](const std::string& keyMetadata) {
+    EXPECT_EQ(keyMetadata, "key-1");
+    return key;
+  });
+  auto decrypter = factory.create(EncryptionProvider::Unknown);
+  ASSERT_FALSE(decrypter->isKeyLoaded());
+  decrypter->setKey("key-1");
+  ASSERT_TRUE(decrypter->canDecryptInto());
+  const auto plaintext = folly::unhexlify("6bc1bee22e409f96e93d7e117393172a");
+  ASSERT_EQ(
+      decrypter->decrypt(encrypted)->moveToFbString().toStdString(), plaintext);
+  std::string output(encrypted.size(), '\0');
+  ASSERT_EQ(decrypter->decryptInto(encrypted, output.data()), plaintext.size());
+  ASSERT_EQ(output.substr(0, plaintext.size()), plaintext);
+
+  // Round trip of a buffer that is not a multiple of the block size.
+  AesCtrEncrypterFactory encrypterFactory;
+  auto encrypter = encrypterFactory.create(
+      EncryptionProvider::Unknown, AesCtrEncryptionProperties(key, "key-1"));
+  ASSERT_EQ(encrypter->getKey(), "key-1");
+  std::string data(1'000, 'a');
+  for (auto i = 0; i < data.size(); ++i) {
+    data[i] += i % 26;
+  }
+  auto encryptedData =
+      encrypter->encrypt(data)->moveToFbString().toStdString();
+  ASSERT_EQ(encryptedData.size(), AesCtr::kIvSize + data.size());
+  auto clone = decrypter->clone();
+  ASSERT_EQ(
+      clone->decrypt(encryptedData)->moveToFbString().toStdString(), data);
+  // Each buffer gets a fresh counter.
+  ASSERT_NE(
+      encrypter->encrypt(data)->moveToFbString().toStdString(), encryptedData);
+
+  ASSERT_THROW(
+      decrypter->decrypt(folly::StringPiece(encrypted.data(), 8)),
+      exception::LoggedException);
+  ASSERT_THROW(AesCtrEncrypter("short", "key-1"), exception::LoggedException);
+}
@@ -102,6 +102,7 @@ class E2EFilterTest : public E2EFilterTestBase {
   }
 
   std::unordered_set<std::string> flatMapColumns_;
+  std::unordered_set<std::string> bloomFilterColumns_;
 
  private:
   dwrf::WriterOptions createWriterOptions(const TypePtr& type) {
@@ -145,6 +146,17 @@ class E2EFilterTest : public E2EFilterTestBase {
       config->set<const std::vector<std::vector<std::string>>>(
           dwrf::Config::MAP_FLAT_COLS_STRUCT_KEYS, mapFlatColsStructKeys);
     }
+    if (!bloomFilterColumns_.empty()) {
+      auto& rowType = type->asRow();
+      std::vector<uint32_t> bloomFilterCols;
+      for (int i = 0; i < rowType.size(); ++i) {
+        if (bloomFilterColumns_.count(rowType.nameOf(i)) > 0) {
+          bloomFilterCols.push_back(i);
+        }
+      }
+      config->set<const std::vector<uint32_t>>(
+          dwrf::Config::BLOOM_FILTER_COLS, bloomFilterCols);
+    }
     dwrf::WriterOptions options;
     options.config = config;
     options.schema = writerSchema;
@@ -213,6 +225,30 @@ TEST_F(E2EFilterTest, integerDictionary) {
       true);
 }
 
+TEST_F(E2EFilterTest, bloomFilter) {
+  bloomFilterColumns_ = {"int_val", "long_val", "string_val"};
+  testWithTypes(
+      "int_val:int,"
+      "long_val:bigint,"
+      "string_val:string",
+      [&]() {
+        makeIntDistribution<int64_t>(
+            "long_val",
+            10, // min
+            100, // max
+            22, // repeats
+            19, // rareFrequency
+            -9999, // rareMin
+            10000000000, // rareMax
+            true);
+        makeStringDistribution("string_val", 100, true, false);
+      },
+      false,
+      {"int_val", "long_val", "string_val"},
+      20,
+      true);
+}
+
 TEST_F(E2EFilterTest, byteRle) {
   testWithTypes(
       "tiny_val:tinyint,"
@@ -15,6 +15,7 @@
  */
 
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <random>
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/common/Statistics.h"
@@ -343,6 +344,98 @@ TEST_F(E2EWriterTests, E2E) {
   E2EWriterTestUtil::testWriter(*leafPool_, type, batches, 1, 1, config);
 }
 
+TEST_F(E2EWriterTests, parallelEncoding) {
+  HiveTypeParser parser;
+  auto type = parser.parse(
+      "struct<"
+      "bool_val:boolean,"
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "double_val:double,"
+      "string_val:string,"
+      "timestamp_val:timestamp,"
+      "array_val:array<float>,"
+      "map_val:map<bigint,map<string, int>>,"
+      "struct_val:struct<a:float,b:double>"
+      ">");
+
+  auto config = std::make_shared<dwrf::Config>();
+  config->set(dwrf::Config::ROW_INDEX_STRIDE, static_cast<uint32_t>(1000));
+  // Small compression blocks make the columns compress concurrently while
+  // writing.
+  config->set(
+      dwrf::Config::COMPRESSION_BLOCK_SIZE, static_cast<uint64_t>(1024));
+
+  auto batches =
+      E2EWriterTestUtil::generateBatches(type, 10, 1100, 1, *leafPool_);
+  auto executor = std::make_shared<folly::CPUThreadPoolExecutor>(4);
+  E2EWriterTestUtil::testWriter(
+      *leafPool_,
+      type,
+      batches,
+      1,
+      10,
+      config,
+      E2EWriterTestUtil::simpleFlushPolicyFactory(true),
+      nullptr,
+      std::numeric_limits<int64_t>::max(),
+      true,
+      executor);
+}
+
+TEST_F(E2EWriterTests, flatMapParallelEncoding) {
+  using keyType = int32_t;
+  using valueType = int64_t;
+  using b = MapBuilder<keyType, valueType>;
+
+  const int32_t numKeys = 1000;
+  const uint32_t strideSize = 500;
+  auto pool = memory::addDefaultLeafMemoryPool();
+  const auto type = CppToType<Row<Map<keyType, valueType>>>::create();
+
+  // Each batch adds keys, so that the new value writers are backfilled, and
+  // every 10th map is null.
+  std::vector<VectorPtr> batches;
+  for (int32_t batch = 1; batch <= 4; ++batch) {
+    b::rows rows;
+    for (int32_t i = 0; i < 600; ++i) {
+      if (i % 10 == 0) {
+        rows.push_back(std::nullopt);
+        continue;
+      }
+      b::row row;
+      for (int32_t key = i % 7; key < numKeys * batch / 4; key += 7) {
+        row.push_back(b::pair{key, Random::rand64()});
+      }
+      rows.push_back(std::move(row));
+    }
+    const auto rowCount = rows.size();
+    batches.push_back(createRowVector(
+        pool.get(), type, rowCount, b::create(*pool, std::move(rows))));
+  }
+
+  auto config = std::make_shared<dwrf::Config>();
+  config->set(dwrf::Config::FLATTEN_MAP, true);
+  config->set(dwrf::Config::MAP_FLAT_COLS, {0});
+  config->set(dwrf::Config::ROW_INDEX_STRIDE, strideSize);
+  config->set(dwrf::Config::MAP_STATISTICS, true);
+
+  auto executor = std::make_shared<folly::CPUThreadPoolExecutor>(4);
+  E2EWriterTestUtil::testWriter(
+      *pool,
+      type,
+      batches,
+      1,
+      1,
+      config,
+      E2EWriterTestUtil::simpleFlushPolicyFactory(false),
+      nullptr,
+      std::numeric_limits<int64_t>::max(),
+      true,
+      executor);
+}
+
 TEST_F(E2EWriterTests, FlatMapDictionaryEncoding) {
   const size_t batchCount = 4;
   // Start with a size larger than stride to cover splitting into
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <folly/Benchmark.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/init/Init.h>
+
+#include "velox/dwio/common/TypeWithId.h"
+#include "velox/dwio/dwrf/writer/ColumnWriter.h"
+#include "velox/type/Type.h"
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/FlatVector.h"
+
+// Compares writing a flat map column with 1K and 10K keys per stripe with the
+// values of the keys encoded on the caller thread and on an executor.
+
+DEFINE_int32(num_threads, 8, "Threads of the encoding executor");
+
+using namespace facebook::velox::dwio::common;
+using namespace facebook::velox;
+using namespace facebook::velox::dwrf;
+
+namespace {
+
+constexpr vector_size_t kVectorSize = 10000;
+constexpr vector_size_t kKeysPerMap = 100;
+constexpr int32_t kNumBatches = 10;
+
+std::shared_ptr<memory::MemoryPool> pool;
+std::shared_ptr<folly::CPUThreadPoolExecutor> executor;
+
+// Maps of 'kKeysPerMap' consecutive keys, starting where the previous map
+// ended, so that every key is in about the same number of maps.
+VectorPtr makeMaps(int32_t numKeys) {
+  const auto numEntries = kVectorSize * kKeysPerMap;
+  BufferPtr offsets = allocateOffsets(kVectorSize, pool.get());
+  BufferPtr sizes = allocateSizes(kVectorSize, pool.get());
+  auto* rawOffsets = offsets->asMutable<vector_size_t>();
+  auto* rawSizes = sizes->asMutable<vector_size_t>();
+  BufferPtr keys = AlignedBuffer::allocate<int32_t>(numEntries, pool.get());
+  BufferPtr values = AlignedBuffer::allocate<int64_t>(numEntries, pool.get());
+  auto* rawKeys = keys->asMutable<int32_t>();
+  auto* rawValues = values->asMutable<int64_t>();
+  for (vector_size_t i = 0; i < kVectorSize; ++i) {
+    rawOffsets[i] = i * kKeysPerMap;
+    rawSizes[i] = kKeysPerMap;
+    for (auto j = 0; j < kKeysPerMap; ++j) {
+      const auto index = i * kKeysPerMap + j;
+      rawKeys[index] = index % numKeys;
+      rawValues[index] = index * 31 % 1000;
+    }
+  }
+  return std::make_shared<MapVector>(
+      pool.get(),
+      MAP(INTEGER(), BIGINT()),
+      nullptr,
+      kVectorSize,
+      offsets,
+      sizes,
+      std::make_shared<FlatVector<int32_t>>(
+          pool.get(),
+          INTEGER(),
+          nullptr,
+          numEntries,
+          keys,
+          std::vector<BufferPtr>{}),
+      std::make_shared<FlatVector<int64_t>>(
+          pool.get(),
+          BIGINT(),
+          nullptr,
+          numEntries,
+          values,
+          std::vector<BufferPtr>{}));
+}
+
+void runBenchmark(int32_t numKeys, bool parallel) {
+  folly::BenchmarkSuspender braces;
+
+  auto maps = makeMaps(numKeys);
+  auto rowType = ROW({"c0"}, {maps->type()});
+  auto schema = TypeWithId::create(rowType);
+  auto config = std::make_shared<dwrf::Config>();
+  config->set(Config::FLATTEN_MAP, true);
+  config->set(Config::MAP_FLAT_COLS, {schema->childAt(0)->column()});
+  config->set(Config::MAP_FLAT_MAX_KEYS, static_cast<uint32_t>(numKeys));
+  WriterContext context{
+      config,
+      memory::defaultMemoryManager().addRootPool(
+          "FlatMapColumnWriterBenchmark")};
+  if (parallel) {
+    context.setEncodingExecutor(executor);
+  }
+  auto writer = BaseColumnWriter::create(context, *schema->childAt(0));
+
+  braces.dismiss();
+
+  for (auto i = 0; i < kNumBatches; ++i) {
+    writer->write(maps, common::Ranges::of(0, kVectorSize));
+  }
+}
+
+} // namespace
+
+BENCHMARK(flatMap1KKeys) {
+  runBenchmark(1'000, false);
+}
+
+BENCHMARK_RELATIVE(flatMap1KKeysParallel) {
+  runBenchmark(1'000, true);
+}
+
+BENCHMARK(flatMap10KKeys) {
+  runBenchmark(10'000, false);
+}
+
+BENCHMARK_RELATIVE(flatMap10KKeysParallel) {
+  runBenchmark(10'000, true);
+}
+
+int32_t main(int32_t argc, char* argv[]) {
+  folly::init(&argc, &argv);
+  pool = memory::addDefaultLeafMemoryPool();
+  executor = std::make_shared<folly::CPUThreadPoolExecutor>(FLAGS_num_threads);
+  folly::runBenchmarks();
+  executor.reset();
+  pool.reset();
+  return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/dwio/common/SeekableInputStream.h"
+#include "velox/dwio/dwrf/common/DecoderUtil.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwrf;
+
+// Compares decoding RLEv2 DIRECT runs, the encoding Hive's ORC writer uses
+// for random integers, in batches with decoding them one value at a time,
+// which is what the selective readers did before the bulk path.
+
+namespace {
+
+constexpr int32_t kNumValues = 1'000'000;
+constexpr int32_t kBatchSize = 1'000;
+
+// 5 bit header codes for the bit widths below.
+uint32_t widthCode(uint32_t bitWidth) {
+  switch (bitWidth) {
+    case 32:
+      return 27;
+    case 40:
+      return 28;
+    case 48:
+      return 29;
+    case 56:
+      return 30;
+    default:
+      VELOX_CHECK_LE(bitWidth, 24);
+      return bitWidth - 1;
+  }
+}
+
+std::vector<unsigned char> makeDirectStream(uint32_t bitWidth) {
+  folly::Random::DefaultGenerator rng(1);
+  std::vector<unsigned char> bytes;
+  for (int32_t row = 0; row < kNumValues; row += 512) {
+    const int32_t runLength = std::min(512, kNumValues - row);
+    bytes.push_back(
+        0x40 | (widthCode(bitWidth) << 1) | ((runLength - 1) >> 8));
+    bytes.push_back((runLength - 1) & 0xff);
+    const auto begin = bytes.size();
+    bytes.resize(begin + bits::nbytes(runLength * bitWidth));
+    uint64_t bitOffset = 0;
+    for (int32_t i = 0; i < runLength; ++i) {
+      const uint64_t value =
+          folly::Random::rand64(rng) & ((1UL << bitWidth) - 1);
+      for (int32_t bit = bitWidth - 1; bit >= 0; --bit) {
+        if ((value >> bit) & 1) {
+          bytes[begin + bitOffset / 8] |= 0x80 >> (bitOffset % 8);
+        }
+        ++bitOffset;
+      }
+    }
+  }
+  return bytes;
+}
+
+std::unique_ptr<dwio::common::IntDecoder<true>> makeDecoder(
+    const std::vector<unsigned char>& bytes,
+    memory::MemoryPool& pool) {
+  return createRleDecoder<true>(
+      std::make_unique<dwio::common::SeekableArrayInputStream>(
+          bytes.data(), bytes.size(), 64 << 10),
+      RleVersion_2,
+      pool,
+      true,
+      dwio::common::INT_BYTE_SIZE);
+}
+
+void decodeBatches(uint32_t iters, uint32_t bitWidth) {
+  std::vector<unsigned char> bytes;
+  BENCHMARK_SUSPEND {
+    bytes = makeDirectStream(bitWidth);
+  }
+  auto pool = memory::addDefaultLeafMemoryPool();
+  std::vector<int64_t> data(kBatchSize);
+  for (auto iter = 0; iter < iters; ++iter) {
+    auto decoder = makeDecoder(bytes, *pool);
+    for (auto row = 0; row < kNumValues; row += kBatchSize) {
+      decoder->next(data.data(), kBatchSize, nullptr);
+    }
+    folly::doNotOptimizeAway(data);
+  }
+}
+
+void decodeValues(uint32_t iters, uint32_t bitWidth) {
+  std::vector<unsigned char> bytes;
+  BENCHMARK_SUSPEND {
+    bytes = makeDirectStream(bitWidth);
+  }
+  auto pool = memory::addDefaultLeafMemoryPool();
+  std::vector<int32_t> data(kBatchSize);
+  for (auto iter = 0; iter < iters; ++iter) {
+    auto decoder = makeDecoder(bytes, *pool);
+    for (auto row = 0; row < kNumValues; row += kBatchSize) {
+      // nextLengths() decodes one value at a time.
+      decoder->nextLengths(data.data(), kBatchSize);
+    }
+    folly::doNotOptimizeAway(data);
+  }
+}
+
+} // namespace
+
+BENCHMARK_NAMED_PARAM(decodeValues, width7, 7);
+BENCHMARK_RELATIVE_NAMED_PARAM(decodeBatches, width7, 7);
+BENCHMARK_NAMED_PARAM(decodeValues, width17, 17);
+BENCHMARK_RELATIVE_NAMED_PARAM(decodeBatches, width17, 17);
+BENCHMARK_NAMED_PARAM(decodeValues, width32, 32);
+BENCHMARK_RELATIVE_NAMED_PARAM(decodeBatches, width32, 32);
+BENCHMARK_NAMED_PARAM(decodeValues, width48, 48);
+BENCHMARK_RELATIVE_NAMED_PARAM(decodeBatches, width48, 48);
+
+int32_t main(int32_t argc, char* argv[]) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
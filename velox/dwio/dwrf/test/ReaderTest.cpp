@@ -18,8 +18,10 @@
 #include <gtest/gtest.h>
 #include <velox/buffer/Buffer.h>
 #include "folly/Random.h"
+#include "folly/ScopeGuard.h"
 #include "folly/lang/Assume.h"
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/dwio/common/FileMetadataCache.h"
 #include "velox/dwio/common/FileSink.h"
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
 #include "velox/dwio/dwrf/common/Common.h"
@@ -2489,3 +2491,154 @@ TEST(TestReader, readFlatMapsWithNullMaps) {
     }
   }
 }
+
+TEST(TestReader, fileMetadataCache) {
+  const std::string fmSmall(getExampleFilePath("fm_small.orc"));
+  FileMetadataCache cache(1 << 20);
+  FileMetadataCache::setInstance(&cache);
+  SCOPE_EXIT {
+    FileMetadataCache::setInstance(nullptr);
+  };
+  ReaderOptions readerOpts{defaultPool.get()};
+  auto readRows = [&](IoStatistics& ioStats, const proto::Footer*& footer) {
+    auto reader = DwrfReader::create(
+        std::make_unique<BufferedInput>(
+            std::make_shared<LocalReadFile>(fmSmall),
+            *defaultPool,
+            MetricsLog::voidLog(),
+            &ioStats),
+        readerOpts);
+    footer = reader->getFooter().getDwrfPtr();
+    auto rowReader = reader->createRowReader(RowReaderOptions());
+    VectorPtr batch;
+    uint64_t numRows = 0;
+    while (rowReader->next(1000, batch)) {
+      numRows += batch->size();
+    }
+    return numRows;
+  };
+
+  IoStatistics firstStats;
+  const proto::Footer* firstFooter;
+  const auto numRows = readRows(firstStats, firstFooter);
+  ASSERT_GT(numRows, 0);
+  ASSERT_EQ(firstStats.metadataCacheHit().count(), 0);
+  ASSERT_EQ(firstStats.metadataCacheMiss().count(), 1);
+  ASSERT_EQ(cache.stats().numEntries, 1);
+
+  // The second reader gets the parsed footer of the first.
+  IoStatistics secondStats;
+  const proto::Footer* secondFooter;
+  ASSERT_EQ(readRows(secondStats, secondFooter), numRows);
+  ASSERT_EQ(secondStats.metadataCacheHit().count(), 1);
+  ASSERT_EQ(secondStats.metadataCacheMiss().count(), 0);
+  ASSERT_GT(secondStats.metadataCacheHit().sum(), 0);
+  ASSERT_EQ(firstFooter, secondFooter);
+  ASSERT_EQ(cache.stats().numHits, 1);
+
+  // The footer of a file that is not in the cache is read.
+  cache.clear();
+  IoStatistics thirdStats;
+  const proto::Footer* thirdFooter;
+  ASSERT_EQ(readRows(thirdStats, thirdFooter), numRows);
+  ASSERT_EQ(thirdStats.metadataCacheMiss().count(), 1);
+  ASSERT_EQ(cache.stats().numEntries, 1);
+}
+
+namespace {
+
+// Passes the rows where the first input is greater than the second.
+class GreaterThanFilter : public common::MultiColumnFilter {
+ public:
+  GreaterThanFilter(const std::string& left, const std::string& right)
+      : inputs_{left, right} {}
+
+  const std::vector<std::string>& inputs() const override {
+    return inputs_;
+  }
+
+  void filter(const RowVector& input, uint64_t* passed) override {
+    DecodedVector left(*input.childAt(0));
+    DecodedVector right(*input.childAt(1));
+    bits::forEachSetBit(passed, 0, input.size(), [&](vector_size_t i) {
+      ++numTested;
+      if (left.valueAt<int64_t>(i) <= right.valueAt<int64_t>(i)) {
+        bits::clearBit(passed, i);
+      }
+    });
+  }
+
+  int32_t numTested{0};
+
+ private:
+  const std::vector<std::string> inputs_;
+};
+
+} // namespace
+
+TEST(TestReader, multiColumnFilter) {
+  constexpr int32_t kSize = 1'000;
+  auto& pool = defaultPool;
+  VectorMaker maker(pool.get());
+  std::vector<std::string> strings;
+  for (auto i = 0; i < kSize; ++i) {
+    strings.push_back(fmt::format("string {}", i));
+  }
+  auto batch = maker.rowVector(
+      {"c0", "c1", "c2", "c3"},
+      {maker.flatVector<int64_t>(kSize, [](auto row) { return row % 10; }),
+       maker.flatVector<int64_t>(kSize, [](auto row) { return row % 7; }),
+       maker.flatVector(strings),
+       maker.flatVector<int64_t>(kSize, [](auto row) { return row; })});
+  auto schema = asRowType(batch->type());
+  auto [writer, reader] = createWriterReader({batch}, *pool);
+
+  auto spec = std::make_shared<common::ScanSpec>("<root>");
+  spec->addAllChildFields(*schema);
+  spec->childByName("c3")->setFilter(
+      std::make_unique<common::BigintRange>(0, 899, false));
+  auto greaterThan = std::make_shared<GreaterThanFilter>("c0", "c1");
+  spec->addMultiColumnFilter(greaterThan);
+  ASSERT_TRUE(spec->hasFilter());
+  RowReaderOptions rowReaderOpts;
+  rowReaderOpts.setScanSpec(spec);
+
+  auto readRows = [&]() {
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    std::vector<int64_t> rows;
+    auto result = BaseVector::create(schema, 0, pool.get());
+    while (rowReader->next(300, result)) {
+      auto* rowVector = result->asUnchecked<RowVector>();
+      DecodedVector c0(*rowVector->childAt(0));
+      DecodedVector c1(*rowVector->childAt(1));
+      DecodedVector c2(*rowVector->childAt(2));
+      DecodedVector c3(*rowVector->childAt(3));
+      for (auto i = 0; i < rowVector->size(); ++i) {
+        const auto row = c3.valueAt<int64_t>(i);
+        EXPECT_EQ(c0.valueAt<int64_t>(i), row % 10);
+        EXPECT_EQ(c1.valueAt<int64_t>(i), row % 7);
+        EXPECT_EQ(c2.valueAt<StringView>(i).str(), strings[row]);
+        rows.push_back(row);
+      }
+    }
+    return rows;
+  };
+
+  std::vector<int64_t> expected;
+  for (auto i = 0; i < 900; ++i) {
+    if (i % 10 > i % 7) {
+      expected.push_back(i);
+    }
+  }
+  ASSERT_EQ(readRows(), expected);
+  // Only the rows that pass the filter on 'c3' are tested.
+  ASSERT_EQ(greaterThan->numTested, 900);
+
+  // A second filter sees only the rows that pass the first.
+  auto lessThan = std::make_shared<GreaterThanFilter>("c1", "c0");
+  spec->addMultiColumnFilter(lessThan);
+  greaterThan->numTested = 0;
+  ASSERT_TRUE(readRows().empty());
+  ASSERT_EQ(greaterThan->numTested, 900);
+  ASSERT_EQ(lessThan->numTested, expected.size());
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/common/BloomFilter.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::dwrf;
+
+TEST(BloomFilterTest, addAndTest) {
+  BloomFilter filter(1'000, 0.05);
+  ASSERT_EQ(filter.numBits() % 64, 0);
+  ASSERT_GT(filter.numHashFunctions(), 0);
+  for (int64_t i = 0; i < 1'000; ++i) {
+    filter.addLong(i * 7);
+    auto string = std::to_string(i);
+    filter.addBytes(string.data(), string.size());
+  }
+  for (int64_t i = 0; i < 1'000; ++i) {
+    ASSERT_TRUE(filter.testLong(i * 7));
+    auto string = std::to_string(i);
+    ASSERT_TRUE(filter.testBytes(string.data(), string.size()));
+  }
+  // Both the longs and the strings are in 'filter', so it is at about twice
+  // the expected entries. The false positive rate stays well below 1.
+  int32_t numFalsePositives = 0;
+  for (int64_t i = 0; i < 1'000; ++i) {
+    numFalsePositives += filter.testLong(i * 7 + 1);
+  }
+  ASSERT_LT(numFalsePositives, 500);
+
+  filter.reset();
+  ASSERT_FALSE(filter.testLong(0));
+  ASSERT_FALSE(filter.testLong(7));
+}
+
+TEST(BloomFilterTest, proto) {
+  BloomFilter filter(100, 0.01);
+  filter.addLong(-1);
+  filter.addBytes("abc", 3);
+  filter.addBytes("", 0);
+  proto::BloomFilter proto;
+  filter.toProto(proto);
+  ASSERT_EQ(proto.numhashfunctions(), filter.numHashFunctions());
+  ASSERT_EQ(proto.bitset_size() * 64, filter.numBits());
+
+  BloomFilter copy(proto);
+  ASSERT_TRUE(copy.testLong(-1));
+  ASSERT_TRUE(copy.testBytes("abc", 3));
+  ASSERT_TRUE(copy.testBytes("", 0));
+  ASSERT_EQ(copy.numBits(), filter.numBits());
+}
+
+TEST(BloomFilterTest, hash) {
+  // The hashes depend on all the bytes of a string, also in the tail after
+  // the last whole 8 byte block.
+  std::string string = "0123456789abcdef!";
+  auto hash = BloomFilter::hashBytes(string.data(), string.size());
+  for (auto i = 0; i < string.size(); ++i) {
+    auto changed = string;
+    ++changed[i];
+    ASSERT_NE(hash, BloomFilter::hashBytes(changed.data(), changed.size()));
+  }
+  ASSERT_NE(BloomFilter::hashLong(1), BloomFilter::hashLong(2));
+  ASSERT_NE(BloomFilter::hashLong(-1), BloomFilter::hashLong(1));
+}
@@ -3883,6 +3883,74 @@ TEST_P(TestColumnReader, testDecimal64WithSkip) {
   EXPECT_EQ(49, intBatch->valueAt(0));
 }
 
+TEST_P(TestColumnReader, testDecimal64WithFilter) {
+  if (!useSelectiveReader()) {
+    return;
+  }
+  // set getEncoding
+  proto::ColumnEncoding directEncoding;
+  directEncoding.set_kind(proto::ColumnEncoding_Kind_DIRECT);
+  EXPECT_CALL(streams_, getEncodingProxy(_))
+      .WillRepeatedly(Return(&directEncoding));
+
+  // set getStream
+  EXPECT_CALL(streams_, getStreamProxy(_, proto::Stream_Kind_ROW_INDEX, false))
+      .WillRepeatedly(Return(nullptr));
+  EXPECT_CALL(streams_, getStreamProxy(_, proto::Stream_Kind_PRESENT, false))
+      .WillRepeatedly(Return(nullptr));
+  const unsigned char numBuffer[] = {
+      0xf8, 0xe8, 0xe2, 0xcf, 0xf4, 0xcb, 0xb6, 0xda, 0x0d, 0x86, 0xc1, 0xcc,
+      0xcd, 0x9e, 0xd5, 0xc5, 0x11, 0xb4, 0xf6, 0xfc, 0xf3, 0xb9, 0xba, 0x16,
+      0xca, 0xe7, 0xa3, 0xa6, 0xdf, 0x1c, 0xea, 0xad, 0xc0, 0xe5, 0x24, 0xf8,
+      0x94, 0x8c, 0x2f, 0x86, 0xa4, 0x3c, 0x94, 0x4d, 0x62};
+  EXPECT_CALL(streams_, getStreamProxy(1, proto::Stream_Kind_DATA, true))
+      .WillRepeatedly(
+          Invoke([&](auto /* unused */, auto /* unused */, auto /* unused */) {
+            return new SeekableArrayInputStream(
+                numBuffer, VELOX_ARRAY_SIZE(numBuffer));
+          }));
+  const unsigned char buffer1[] = {0x06, 0x00, 0x14}; // [0x0a] * 9
+  EXPECT_CALL(streams_, getStreamProxy(1, proto::Stream_Kind_NANO_DATA, true))
+      .WillRepeatedly(
+          Invoke([&](auto /* unused */, auto /* unused */, auto /* unused */) {
+            return new SeekableArrayInputStream(
+                buffer1, VELOX_ARRAY_SIZE(buffer1));
+          }));
+
+  // The file scale matches the requested scale, so the values are filtered
+  // as decoded.
+  auto rowType = HiveTypeParser().parse("struct<col_0:decimal(12, 10)>");
+  auto scanSpec = std::make_unique<common::ScanSpec>("root");
+  scanSpec->addAllChildFields(*rowType);
+  scanSpec->childByName("col_0")->setFilter(
+      std::make_unique<common::BigintRange>(
+          1'000'000'000, 10'000'000'000'000'000, false));
+  buildReader(rowType, {}, nullptr, scanSpec.get());
+  VectorPtr batch = newBatch(rowType);
+  selectiveColumnReader_->next(6, batch, nullptr);
+  auto intBatch = getOnlyChild<FlatVector<int64_t>>(batch);
+  ASSERT_EQ(4, batch->size());
+  ASSERT_EQ(4938271605493827, intBatch->valueAt(0));
+  ASSERT_EQ(49382716054938, intBatch->valueAt(1));
+  ASSERT_EQ(493827160549, intBatch->valueAt(2));
+  ASSERT_EQ(4938271605, intBatch->valueAt(3));
+
+  // The values are rescaled from 10 to 2 before the filter is applied.
+  rowType = HiveTypeParser().parse("struct<col_0:decimal(12, 2)>");
+  scanSpec = std::make_unique<common::ScanSpec>("root");
+  scanSpec->addAllChildFields(*rowType);
+  scanSpec->childByName("col_0")->setFilter(
+      std::make_unique<common::BigintRange>(40, 5'000'000, false));
+  buildReader(rowType, {}, nullptr, scanSpec.get());
+  batch = newBatch(rowType);
+  selectiveColumnReader_->next(6, batch, nullptr);
+  intBatch = getOnlyChild<FlatVector<int64_t>>(batch);
+  ASSERT_EQ(3, batch->size());
+  ASSERT_EQ(493827, intBatch->valueAt(0));
+  ASSERT_EQ(4938, intBatch->valueAt(1));
+  ASSERT_EQ(49, intBatch->valueAt(2));
+}
+
 TEST_P(TestColumnReader, testDecimal128WithSkip) {
   // set getEncoding
   proto::ColumnEncoding directEncoding;
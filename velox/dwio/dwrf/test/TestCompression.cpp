@@ -15,6 +15,7 @@
  */
 
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/dwio/common/encryption/AesCtr.h"
 #include "velox/dwio/common/encryption/TestProvider.h"
 #include "velox/dwio/dwrf/common/Compression.h"
 #include "velox/dwio/dwrf/common/wrap/dwrf-proto-wrapper.h"
@@ -145,6 +146,17 @@ typedef std::tuple<CompressionKind, const Encrypter*, const Decrypter*>
 TestEncrypter testEncrypter;
 TestDecrypter testDecrypter;
 
+// Decrypts into the buffer of the stream instead of an IOBuf.
+const std::string aesKey(32, 'k');
+AesCtrEncrypter aesEncrypter{aesKey, "test-key"};
+AesCtrDecrypter aesDecrypter = []() {
+  AesCtrDecrypter decrypter([](const std::string& keyMetadata) {
+    return keyMetadata == "test-key" ? aesKey : "";
+  });
+  decrypter.setKey("test-key");
+  return decrypter;
+}();
+
 class CompressionTest : public TestWithParam<TestParams> {
  public:
   void SetUp() override {
@@ -287,8 +299,10 @@ VELOX_INSTANTIATE_TEST_SUITE_P(
         std::make_tuple(CompressionKind_ZLIB, &testEncrypter, &testDecrypter),
         std::make_tuple(CompressionKind_ZSTD, nullptr, nullptr),
         std::make_tuple(CompressionKind_ZSTD, &testEncrypter, &testDecrypter),
+        std::make_tuple(CompressionKind_ZSTD, &aesEncrypter, &aesDecrypter),
         std::make_tuple(CompressionKind_NONE, nullptr, nullptr),
-        std::make_tuple(CompressionKind_NONE, &testEncrypter, &testDecrypter)));
+        std::make_tuple(CompressionKind_NONE, &testEncrypter, &testDecrypter),
+        std::make_tuple(CompressionKind_NONE, &aesEncrypter, &aesDecrypter)));
 
 typedef std::tuple<CompressionKind, const Encrypter*> TestParams2;
 
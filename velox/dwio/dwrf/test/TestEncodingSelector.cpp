@@ -212,4 +212,32 @@ TEST(TestEntropyEncodingSelector, Sampling) {
   }
 }
 
+TEST(TestEntropyEncodingSelector, costRatio) {
+  auto pool = addDefaultLeafMemoryPool();
+  auto decide = [&](size_t size,
+                    std::function<std::string(size_t)> genData,
+                    float costRatio) {
+    StringDictionaryEncoder dictEncoder{*pool, *pool};
+    for (size_t i = 0; i != size; ++i) {
+      dictEncoder.addKey(genData(i), 0);
+    }
+    // The key size and entropy thresholds would reject every dictionary, so
+    // any dictionary kept is chosen by cost.
+    EntropyEncodingSelector selector{
+        *pool, 0.0f, 0.0f, 100, 0.5f, 1000, costRatio};
+    return selector.useDictionary(dictEncoder, size);
+  };
+
+  // Few long distinct values: the dictionary is a fraction of direct size.
+  auto repeated = [](size_t i) { return std::string(100, 'a' + i % 4); };
+  EXPECT_TRUE(decide(1000, repeated, 1.0f));
+  EXPECT_TRUE(decide(1000, repeated, 0.1f));
+
+  // All distinct values: the dictionary adds indices on top of the values.
+  auto distinct = [](size_t i) { return fmt::format("value_{:06}", i); };
+  EXPECT_FALSE(decide(1000, distinct, 1.0f));
+  // A high enough ratio accepts the larger dictionary encoding.
+  EXPECT_TRUE(decide(1000, distinct, 2.0f));
+}
+
 } // namespace facebook::velox::dwrf
@@ -191,6 +191,22 @@ TEST(TestDirect, vIntUnsignedLong) {
   });
 }
 
+TEST(TestDirect, vIntShort) {
+  folly::Random::DefaultGenerator rng;
+  rng.seed(3);
+  int32_t count = 0;
+  // Mostly runs of 1 and 2 byte varints, which are decoded 16 bytes at a time,
+  // broken by an occasional longer one.
+  auto generator = [&]() -> int64_t {
+    auto mod = ++count % 101;
+    auto numBytes = mod == 0 ? 5 : mod < 40 ? 1 : mod < 70 ? 2 : 1 + mod % 2;
+    return folly::Random::rand64(rng) & ((1UL << (7 * numBytes)) - 1);
+  };
+  testInts<int64_t, false, true>(generator);
+  testInts<int32_t, true, true>(generator);
+  testInts<int16_t, true, true>([&]() -> int16_t { return generator(); });
+}
+
 template <bool isSigned>
 void testCorruptedVarInts() {
   std::vector<uint8_t> invalidInt{
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <folly/Random.h>
 #include <gtest/gtest.h>
 
 #include "velox/common/base/Nulls.h"
@@ -666,6 +667,77 @@ TEST(RLEv2, bitsLeftByPreviousStream) {
   }
 };
 
+namespace {
+// Returns the RLEv2 DIRECT encoding of 'values' as unsigned 'bitWidth' bit
+// integers. 'widthCode' is the 5 bit encoding of 'bitWidth'.
+std::vector<unsigned char> encodeDirect(
+    const std::vector<uint64_t>& values,
+    uint32_t bitWidth,
+    uint32_t widthCode) {
+  VELOX_CHECK_LE(values.size(), 512);
+  std::vector<unsigned char> bytes;
+  const auto lengthMinusOne = values.size() - 1;
+  bytes.push_back(0x40 | (widthCode << 1) | (lengthMinusOne >> 8));
+  bytes.push_back(lengthMinusOne & 0xff);
+  uint64_t bitOffset = 0;
+  const auto begin = bytes.size();
+  bytes.resize(begin + bits::nbytes(values.size() * bitWidth));
+  for (auto value : values) {
+    for (int32_t bit = bitWidth - 1; bit >= 0; --bit) {
+      if ((value >> bit) & 1) {
+        bytes[begin + bitOffset / 8] |= 0x80 >> (bitOffset % 8);
+      }
+      ++bitOffset;
+    }
+  }
+  return bytes;
+}
+} // namespace
+
+TEST(RLEv2, longDirect) {
+  // Bit widths and their codes in the header.
+  const std::vector<std::pair<uint32_t, uint32_t>> widths = {
+      {1, 0}, {3, 2}, {7, 6}, {13, 12}, {24, 23}, {32, 27}, {40, 28},
+      {56, 30}, {64, 31}};
+  folly::Random::DefaultGenerator rng(1);
+  for (auto [bitWidth, widthCode] : widths) {
+    SCOPED_TRACE(fmt::format("bitWidth {}", bitWidth));
+    std::vector<unsigned char> bytes;
+    std::vector<int64_t> expected;
+    // Two runs so that the second starts in the middle of a byte of the
+    // buffer.
+    for (auto runLength : {509, 512}) {
+      std::vector<uint64_t> values(runLength);
+      for (auto& value : values) {
+        value = folly::Random::rand64(rng);
+        if (bitWidth < 64) {
+          value &= (1UL << bitWidth) - 1;
+        }
+        expected.push_back(zigZagDecode(value));
+      }
+      auto run = encodeDirect(values, bitWidth, widthCode);
+      bytes.insert(bytes.end(), run.begin(), run.end());
+    }
+    for (auto blockSize : {0, 5, 64}) {
+      auto pool = memory::addDefaultLeafMemoryPool();
+      auto rle = createRleDecoder<true>(
+          std::make_unique<dwio::common::SeekableArrayInputStream>(
+              bytes.data(), bytes.size(), blockSize),
+          RleVersion_2,
+          *pool,
+          true /* doesn't matter */,
+          dwio::common::INT_BYTE_SIZE /* doesn't matter */);
+      std::vector<int64_t> data(expected.size());
+      // Reads in uneven batches so that reads start at misaligned bits.
+      for (size_t i = 0; i < data.size(); i += 100) {
+        rle->next(
+            data.data() + i, std::min<size_t>(100, data.size() - i), nullptr);
+      }
+      checkResults(expected, data, blockSize);
+    }
+  }
+}
+
 TEST(RLEv1, simpleTest) {
   auto pool = memory::addDefaultLeafMemoryPool();
   const unsigned char buffer[] = {
@@ -37,6 +37,7 @@ class E2EWriterTestUtil {
    *    layoutPlannerFactory    supplies the layout planner and determine how
    *                            order of the data streams prior to flush
    *    writerMemoryCap         total memory budget for the writer
+   *    encodingExecutor        if set, encodes the columns in parallel
    */
   static std::unique_ptr<Writer> writeData(
       std::unique_ptr<dwio::common::FileSink> sink,
@@ -47,7 +48,8 @@ class E2EWriterTestUtil {
           nullptr,
       std::function<std::unique_ptr<LayoutPlanner>(
           const dwio::common::TypeWithId&)> layoutPlannerFactory = nullptr,
-      const int64_t writerMemoryCap = std::numeric_limits<int64_t>::max());
+      const int64_t writerMemoryCap = std::numeric_limits<int64_t>::max(),
+      std::shared_ptr<folly::Executor> encodingExecutor = nullptr);
 
   /**
    * Creates a writer with the supplied configuration and check the IO
@@ -68,7 +70,8 @@ class E2EWriterTestUtil {
       std::function<std::unique_ptr<LayoutPlanner>(
           const dwio::common::TypeWithId&)> layoutPlannerFactory = nullptr,
       const int64_t writerMemoryCap = std::numeric_limits<int64_t>::max(),
-      const bool verifyContent = true);
+      const bool verifyContent = true,
+      std::shared_ptr<folly::Executor> encodingExecutor = nullptr);
 
   static std::vector<VectorPtr> generateBatches(
       const std::shared_ptr<const Type>& type,
@@ -16,6 +16,9 @@
 
 #include "velox/dwio/dwrf/writer/ColumnWriter.h"
 #include <velox/dwio/common/exception/Exception.h>
+#include <folly/ScopeGuard.h>
+#include <optional>
+#include "velox/common/base/AsyncSource.h"
 #include "velox/dwio/common/ChainedBuffer.h"
 #include "velox/dwio/dwrf/common/EncoderUtil.h"
 #include "velox/dwio/dwrf/writer/DictionaryEncodingUtils.h"
@@ -35,7 +38,12 @@ namespace facebook::velox::dwrf {
 WriterContext::LocalDecodedVector BaseColumnWriter::decode(
     const VectorPtr& slice,
     const common::Ranges& ranges) {
-  auto& selected = context_.getSharedSelectivityVector(slice->size());
+  // The shared selectivity vector is not safe to use when the columns are
+  // encoded in parallel.
+  std::optional<SelectivityVector> localSelected;
+  auto& selected = context_.encodingExecutor()
+      ? localSelected.emplace(slice->size())
+      : context_.getSharedSelectivityVector(slice->size());
   // initialize
   selected.clearAll();
   for (auto& range : ranges.getRanges()) {
@@ -300,6 +308,7 @@ class IntegerColumnWriter : public BaseColumnWriter {
     // Add entry with stats for either case.
     indexBuilder_->addEntry(*indexStatsBuilder_);
     indexStatsBuilder_->reset();
+    addBloomFilterEntry();
     BaseColumnWriter::recordPosition();
     // TODO: the only way useDictionaryEncoding_ right now is
     // through abandonDictionary, so we already have the stream initialization
@@ -510,6 +519,9 @@ uint64_t IntegerColumnWriter<T>::writeDict(
     T value = decodedVector.valueAt<T>(pos);
     rows_.unsafeAppend(dictEncoder_.addKey(value));
     statsBuilder.addValues(value);
+    if (bloomFilter_) {
+      bloomFilter_->addLong(value);
+    }
   };
 
   uint64_t nullCount = 0;
@@ -548,6 +560,13 @@ uint64_t IntegerColumnWriter<T>::writeDirect(
   auto vals = flatVector->rawValues();
 
   auto count = dataDirect_->add(vals, ranges, nulls);
+  if (bloomFilter_) {
+    for (auto& pos : ranges) {
+      if (!nulls || !bits::isBitNull(nulls, pos)) {
+        bloomFilter_->addLong(vals[pos]);
+      }
+    }
+  }
   StatisticsBuilderUtils::addValues<T>(
       dynamic_cast<IntegerStatisticsBuilder&>(*indexStatsBuilder_),
       slice,
@@ -802,7 +821,8 @@ class StringColumnWriter : public BaseColumnWriter {
             getConfig(Config::ENTROPY_KEY_STRING_SIZE_THRESHOLD),
             getConfig(Config::ENTROPY_STRING_MIN_SAMPLES),
             getConfig(Config::ENTROPY_STRING_DICT_SAMPLE_FRACTION),
-            getConfig(Config::ENTROPY_STRING_THRESHOLD)},
+            getConfig(Config::ENTROPY_STRING_THRESHOLD),
+            getConfig(Config::DICTIONARY_STRING_COST_RATIO)},
         sort_{getConfig(Config::DICTIONARY_SORT_KEYS)},
         useDictionaryEncoding_{useDictionaryEncoding()},
         strideOffsets_{getMemoryPool(MemoryUsageCategory::GENERAL)} {
@@ -894,6 +914,7 @@ class StringColumnWriter : public BaseColumnWriter {
     // Add entry with stats for either case.
     indexBuilder_->addEntry(*indexStatsBuilder_);
     indexStatsBuilder_->reset();
+    addBloomFilterEntry();
     BaseColumnWriter::recordPosition();
     // TODO: the only way useDictionaryEncoding_ right now is
     // through abandonDictionary, so we already have the stream initialization
@@ -1113,6 +1134,9 @@ uint64_t StringColumnWriter::writeDict(
     auto sp = decodedVector.valueAt<StringView>(pos);
     rows_.unsafeAppend(dictEncoder_.addKey(sp, strideIndex));
     statsBuilder.addValues(sp);
+    if (bloomFilter_) {
+      bloomFilter_->addBytes(sp.data(), sp.size());
+    }
     rawSize += sp.size();
   };
 
@@ -1158,6 +1182,9 @@ uint64_t StringColumnWriter::writeDirect(
     auto size = sp.size();
     dataDirect_->write(sp.data(), size);
     statsBuilder.addValues(sp);
+    if (bloomFilter_) {
+      bloomFilter_->addBytes(sp.data(), size);
+    }
     rawSize += size;
     lengths.unsafeAppend(size);
   };
@@ -1598,14 +1625,65 @@ class StructColumnWriter : public BaseColumnWriter {
       const RowVector* rowSlice,
       const common::Ranges& ranges,
       uint64_t nullCount);
+
+  // Writes the children of the root on 'context_.encodingExecutor()'. Returns
+  // the sum of their raw sizes.
+  uint64_t writeChildrenInParallel(
+      const RowVector* rowSlice,
+      const common::Ranges& ranges);
 };
 
+uint64_t StructColumnWriter::writeChildrenInParallel(
+    const RowVector* rowSlice,
+    const common::Ranges& ranges) {
+  auto* executor = context_.encodingExecutor();
+  std::vector<std::shared_ptr<AsyncSource<uint64_t>>> steps;
+  steps.reserve(children_.size());
+  uint64_t rawSize = 0;
+  std::exception_ptr error;
+  // The steps reference 'rowSlice' and 'ranges', so all of them must be done
+  // before returning, also when one of them throws. Steps not yet started on
+  // the executor run on the caller thread.
+  auto drain = [&]() {
+    for (auto& step : steps) {
+      try {
+        if (auto size = step->move()) {
+          rawSize += *size;
+        }
+      } catch (const std::exception&) {
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+  };
+  auto sync = folly::makeGuard(drain);
+  for (size_t i = 0; i < children_.size(); ++i) {
+    steps.push_back(std::make_shared<AsyncSource<uint64_t>>(
+        [child = children_[i].get(),
+         &childSlice = rowSlice->childAt(i),
+         &ranges]() {
+          return std::make_unique<uint64_t>(child->write(childSlice, ranges));
+        }));
+    executor->add([step = steps.back()]() { step->prepare(); });
+  }
+  sync.dismiss();
+  drain();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return rawSize;
+}
+
 uint64_t StructColumnWriter::writeChildrenAndStats(
     const RowVector* rowSlice,
     const common::Ranges& ranges,
     uint64_t nullCount) {
   uint64_t rawSize = 0;
-  if (ranges.size() > 0) {
+  if (ranges.size() > 0 && isRoot() && context_.encodeColumnsInParallel() &&
+      children_.size() > 1) {
+    rawSize = writeChildrenInParallel(rowSlice, ranges);
+  } else if (ranges.size() > 0) {
     for (size_t i = 0; i < children_.size(); ++i) {
       rawSize += children_.at(i)->write(rowSlice->childAt(i), ranges);
     }
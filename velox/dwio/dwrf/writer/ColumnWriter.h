@@ -18,6 +18,7 @@
 
 #include "velox/common/base/GTestMacros.h"
 #include "velox/dwio/common/OutputStream.h"
+#include "velox/dwio/dwrf/common/BloomFilter.h"
 #include "velox/dwio/dwrf/common/ByteRLE.h"
 #include "velox/dwio/dwrf/common/Common.h"
 #include "velox/dwio/dwrf/common/IntEncoder.h"
@@ -84,6 +85,7 @@ class BaseColumnWriter : public ColumnWriter {
     fileStatsBuilder_->merge(*indexStatsBuilder_, /*ignoreSize=*/true);
     indexBuilder_->addEntry(*indexStatsBuilder_);
     indexStatsBuilder_->reset();
+    addBloomFilterEntry();
     recordPosition();
     for (auto& child : children_) {
       child->createIndexEntry();
@@ -117,6 +119,11 @@ class BaseColumnWriter : public ColumnWriter {
     setEncoding(encoding);
     encodingOverride(encoding);
     indexBuilder_->flush();
+    if (bloomFilter_) {
+      bloomFilterIndex_.SerializeToZeroCopyStream(bloomFilterOut_.get());
+      bloomFilterOut_->flush();
+      bloomFilterIndex_.Clear();
+    }
   }
 
   uint64_t writeFileStats(std::function<proto::ColumnStatistics&(uint32_t)>
@@ -172,6 +179,43 @@ class BaseColumnWriter : public ColumnWriter {
         StatisticsBuilderOptions::fromConfig(context.getConfigs());
     indexStatsBuilder_ = StatisticsBuilder::create(*type.type(), options);
     fileStatsBuilder_ = StatisticsBuilder::create(*type.type(), options);
+    if (needsBloomFilter()) {
+      bloomFilter_ = std::make_unique<BloomFilter>(
+          getConfig(Config::ROW_INDEX_STRIDE),
+          getConfig(Config::BLOOM_FILTER_FPP));
+      bloomFilterOut_ = newStream(StreamKind::StreamKind_BLOOM_FILTER_UTF8);
+    }
+  }
+
+  // True if the values of 'this' go in a bloom filter per row group. Only
+  // top level columns listed in BLOOM_FILTER_COLS of the supported types
+  // have one.
+  bool needsBloomFilter() const {
+    if (!isIndexEnabled() || sequence_ != 0 || type_.parent() == nullptr ||
+        type_.parent()->id() != 0) {
+      return false;
+    }
+    switch (type_.type()->kind()) {
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+      case TypeKind::VARCHAR:
+        break;
+      default:
+        return false;
+    }
+    const auto& columns = getConfig(Config::BLOOM_FILTER_COLS);
+    return std::find(columns.begin(), columns.end(), type_.column()) !=
+        columns.end();
+  }
+
+  // Adds the bloom filter of the finished row group to the index of the
+  // stripe and starts the filter of the next row group.
+  void addBloomFilterEntry() {
+    if (bloomFilter_) {
+      bloomFilter_->toProto(*bloomFilterIndex_.add_bloomfilter());
+      bloomFilter_->reset();
+    }
   }
 
   uint64_t writeNulls(const VectorPtr& slice, const common::Ranges& ranges) {
@@ -263,6 +307,12 @@ class BaseColumnWriter : public ColumnWriter {
   std::unique_ptr<StatisticsBuilder> indexStatsBuilder_;
   std::unique_ptr<StatisticsBuilder> fileStatsBuilder_;
   std::unique_ptr<ByteRleEncoder> present_;
+  // Bloom filter of the values of the current row group and the filters of
+  // the finished row groups of the stripe. nullptr if the column has no bloom
+  // filters.
+  std::unique_ptr<BloomFilter> bloomFilter_;
+  std::unique_ptr<BufferedOutputStream> bloomFilterOut_;
+  proto::BloomFilterIndex bloomFilterIndex_;
   bool hasNull_ = false;
   // callback used to inject the logic that captures positions for flat map
   // in_map stream
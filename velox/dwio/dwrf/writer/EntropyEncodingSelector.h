@@ -31,19 +31,22 @@ class EntropyEncodingSelector {
       const float entropyKeySizeThreshold,
       const size_t entropyMinSamples,
       const float entropyDictSampleFraction,
-      const size_t entropyThreshold)
+      const size_t entropyThreshold,
+      const float dictionaryCostRatio = 0.0f)
       : pool_{pool},
         dictionaryKeySizeThreshold_{dictionaryKeySizeThreshold},
         entropyKeySizeThreshold_{entropyKeySizeThreshold},
         entropyMinSamples_{entropyMinSamples},
         entropyDictSampleFraction_{entropyDictSampleFraction},
-        entropyThreshold_{entropyThreshold} {
+        entropyThreshold_{entropyThreshold},
+        dictionaryCostRatio_{dictionaryCostRatio} {
     DWIO_ENSURE_GE(1.0f, dictionaryKeySizeThreshold_);
     DWIO_ENSURE_LE(0.0f, dictionaryKeySizeThreshold_);
     DWIO_ENSURE_GE(1.0f, entropyKeySizeThreshold_);
     DWIO_ENSURE_LE(0.0f, entropyKeySizeThreshold_);
     DWIO_ENSURE_GE(1.0f, entropyDictSampleFraction_);
     DWIO_ENSURE_LE(0.0f, entropyDictSampleFraction_);
+    DWIO_ENSURE_LE(0.0f, dictionaryCostRatio_);
   }
 
   // NOTE: some inclusiveness of inequality in this method is flipped to grant
@@ -54,6 +57,9 @@ class EntropyEncodingSelector {
       const StringDictionaryEncoder& dictEncoder,
       uint64_t valueCount) const {
     DWIO_ENSURE(valueCount, "No rows provided to encoding selector!");
+    if (dictionaryCostRatio_ > 0.0f) {
+      return useDictionaryByCost(dictEncoder, valueCount);
+    }
     // The fraction of non-null values in this column that are repeats of values
     // in the dictionary
     float repeatedValuesFraction =
@@ -77,6 +83,54 @@ class EntropyEncodingSelector {
   }
 
  private:
+  static uint64_t varintSize(uint64_t value) {
+    return std::max<uint64_t>(1, (64 - __builtin_clzll(value | 1) + 6) / 7);
+  }
+
+  // Compares the estimated encoded sizes of the column with and without the
+  // dictionary. The estimate is taken from the key sizes and counts of a
+  // sample of the dictionary and extrapolated to the whole dictionary.
+  // Dictionary encoding is kept if it is at most 'dictionaryCostRatio_' times
+  // the size of direct encoding. A ratio over 1 accepts larger files for
+  // cheaper decoding, since readers evaluate filters once per dictionary entry.
+  bool useDictionaryByCost(
+      const StringDictionaryEncoder& dictEncoder,
+      uint64_t valueCount) const {
+    const size_t dictSize = dictEncoder.size();
+    uint64_t sampledKeyBytes = 0;
+    uint64_t sampledValueBytes = 0;
+    size_t numSampled = 0;
+    const auto addKey = [&](size_t index) {
+      const auto keySize = dictEncoder.getKey(index).size();
+      sampledKeyBytes += keySize;
+      sampledValueBytes += keySize * dictEncoder.getCount(index);
+      ++numSampled;
+    };
+    if (dictSize > entropyMinSamples_) {
+      auto samples = getSampleIndicesForEntropy(dictEncoder);
+      for (size_t i = 0; i != samples.size(); ++i) {
+        addKey(samples[i]);
+      }
+    } else {
+      for (size_t i = 0; i != dictSize; ++i) {
+        addKey(i);
+      }
+    }
+    if (numSampled == 0) {
+      return true;
+    }
+    const double scale = static_cast<double>(dictSize) / numSampled;
+    const double keyBytes = sampledKeyBytes * scale;
+    const double valueBytes = sampledValueBytes * scale;
+    // Lengths and dictionary indices are written as varints.
+    const double dictionaryCost = keyBytes +
+        dictSize * varintSize(static_cast<uint64_t>(keyBytes / dictSize)) +
+        valueCount * varintSize(dictSize - 1);
+    const double directCost = valueBytes +
+        valueCount * varintSize(static_cast<uint64_t>(valueBytes / valueCount));
+    return dictionaryCost <= dictionaryCostRatio_ * directCost;
+  }
+
   bool useDictionaryEncodingEntropyHeuristic(
       const StringDictionaryEncoder& dictEncoder) const {
     std::unordered_set<char> charSet;
@@ -157,6 +211,7 @@ class EntropyEncodingSelector {
   const size_t entropyMinSamples_;
   const float entropyDictSampleFraction_;
   const size_t entropyThreshold_;
+  const float dictionaryCostRatio_;
 };
 
 } // namespace facebook::velox::dwrf
@@ -15,7 +15,9 @@
  */
 
 #include "velox/dwio/dwrf/writer/FlatMapColumnWriter.h"
+#include <folly/ScopeGuard.h>
 #include <velox/dwio/dwrf/writer/StatisticsBuilder.h>
+#include "velox/common/base/AsyncSource.h"
 #include "velox/type/Type.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/FlatVector.h"
@@ -24,6 +26,10 @@ namespace facebook::velox::dwrf {
 
 namespace {
 
+// Value writers written by one step on the encoding executor. Keeps the
+// per-step overhead small next to encoding the values of a few rows per key.
+constexpr size_t kValueWritersPerStep = 32;
+
 template <typename T>
 T getKey(const std::string& val) {
   try {
@@ -190,9 +196,7 @@ KeyInfo getKeyInfo(StringView key) {
 }
 
 template <TypeKind K>
-ValueWriter& FlatMapColumnWriter<K>::getValueWriter(
-    KeyType key,
-    uint32_t inMapSize) {
+ValueWriter& FlatMapColumnWriter<K>::getValueWriter(KeyType key) {
   auto it = valueWriters_.find(key);
   if (it != valueWriters_.end()) {
     return it->second;
@@ -216,8 +220,7 @@ ValueWriter& FlatMapColumnWriter<K>::getValueWriter(
                    valueWriters_.size() + 1, /* sequence */
                    keyInfo,
                    this->context_,
-                   this->valueType_,
-                   inMapSize))
+                   this->valueType_))
            .first;
 
   ValueWriter& valueWriter = it->second;
@@ -236,6 +239,64 @@ ValueWriter& FlatMapColumnWriter<K>::getValueWriter(
   return valueWriter;
 }
 
+template <TypeKind K>
+uint64_t FlatMapColumnWriter<K>::writeValues(
+    size_t numValueWriters,
+    const std::function<uint64_t(size_t)>& write) {
+  auto* executor = context_.encodingExecutor();
+  if (!executor || context_.shareFlatMapDictionaries() ||
+      numValueWriters <= kValueWritersPerStep) {
+    uint64_t rawSize = 0;
+    for (size_t i = 0; i < numValueWriters; ++i) {
+      rawSize += write(i);
+    }
+    return rawSize;
+  }
+
+  std::vector<std::shared_ptr<AsyncSource<uint64_t>>> steps;
+  steps.reserve(
+      bits::roundUp(numValueWriters, kValueWritersPerStep) /
+      kValueWritersPerStep);
+  uint64_t rawSize = 0;
+  std::exception_ptr error;
+  // The steps reference the batch being written, so all of them must be done
+  // before returning, also when one of them throws. Steps not yet started on
+  // the executor run on the caller thread.
+  auto drain = [&]() {
+    for (auto& step : steps) {
+      try {
+        if (auto size = step->move()) {
+          rawSize += *size;
+        }
+      } catch (const std::exception&) {
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+  };
+  auto sync = folly::makeGuard(drain);
+  for (size_t begin = 0; begin < numValueWriters;
+       begin += kValueWritersPerStep) {
+    const auto end = std::min(begin + kValueWritersPerStep, numValueWriters);
+    steps.push_back(
+        std::make_shared<AsyncSource<uint64_t>>([&write, begin, end]() {
+          uint64_t size = 0;
+          for (auto i = begin; i < end; ++i) {
+            size += write(i);
+          }
+          return std::make_unique<uint64_t>(size);
+        }));
+    executor->add([step = steps.back()]() { step->prepare(); });
+  }
+  sync.dismiss();
+  drain();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return rawSize;
+}
+
 template <TypeKind K>
 uint32_t updateKeyStatistics(
     typename TypeInfo<K>::StatisticsBuilder& keyStatsBuilder,
@@ -387,7 +448,7 @@ uint64_t FlatMapColumnWriter<K>::writeMap(
 
     for (auto i = begin; i < end; ++i) {
       auto key = keysVector.valueAt(i);
-      ValueWriter& valueWriter = getValueWriter(key, ranges.size());
+      ValueWriter& valueWriter = getValueWriter(key);
       valueWriter.addOffset(i, mapCount);
       auto keySize = updateKeyStatistics<K>(*keyFileStatsBuilder_, key);
       keyFileStatsBuilder_->increaseRawSize(keySize);
@@ -429,7 +490,7 @@ uint64_t FlatMapColumnWriter<K>::writeMap(
   // This includes existing value writers that are not used in this batch
   // (their buffers will be set to empty buffers)
   for (auto& pair : valueWriters_) {
-    pair.second.resizeBuffers(ranges.size());
+    pair.second.resetBatch();
   }
 
   // Fill value buffers per key
@@ -454,12 +515,18 @@ uint64_t FlatMapColumnWriter<K>::writeMap(
     nullCount = processBatch(Decoded{decodedMap}, mapSlice);
   }
 
-  auto& values = mapSlice->mapValues();
+  // The values are read by all value writers, so load them up front.
+  auto values = BaseVector::loadedVectorShared(mapSlice->mapValues());
   // Write all accumulated buffers (this includes value writers that weren't
   // used in this write. This is how we backfill unused value writers)
+  std::vector<ValueWriter*> valueWriters;
+  valueWriters.reserve(valueWriters_.size());
   for (auto& pair : valueWriters_) {
-    rawSize += pair.second.writeBuffers(values, mapCount);
+    valueWriters.push_back(&pair.second);
   }
+  rawSize += writeValues(valueWriters.size(), [&](size_t i) {
+    return valueWriters[i]->writeBuffers(values, mapCount);
+  });
 
   if (nullCount > 0) {
     indexStatsBuilder_->setHasNull();
@@ -516,6 +583,10 @@ uint64_t FlatMapColumnWriter<K>::writeRow(
       &context_.getMemoryPool(MemoryUsageCategory::GENERAL),
       1);
 
+  // The value writers are created before writing so that streams are only
+  // created on this thread.
+  std::vector<ValueWriter*> valueWriters;
+  valueWriters.reserve(structKeys_.size());
   for (size_t i = 0; i < structKeys_.size(); i++) {
     // looping each non-null row for now; no batch updateKeyStatistics()
     for (size_t j = 0; j < nonNullRanges.size(); j++) {
@@ -524,12 +595,14 @@ uint64_t FlatMapColumnWriter<K>::writeRow(
       keyFileStatsBuilder_->increaseRawSize(keySize);
       rawSize += keySize;
     }
-
-    ValueWriter& valueWriter =
-        getValueWriter(structKeys_[i], nonNullRanges.size());
-    valueWriter.writeBuffers(rowSlice->childAt(i), nonNullRanges, inMapBuffer);
+    valueWriters.push_back(&getValueWriter(structKeys_[i]));
   }
 
+  writeValues(valueWriters.size(), [&](size_t i) {
+    return valueWriters[i]->writeBuffers(
+        rowSlice->childAt(i), nonNullRanges, inMapBuffer);
+  });
+
   size_t numNullRows = ranges.size() - nonNullRanges.size();
   if (numNullRows > 0) {
     indexStatsBuilder_->setHasNull();
@@ -89,16 +89,19 @@ class ValueStatisticsBuilder {
 // ValueWriter is used to write flat-map value columns.
 // It holds a column writer to write the values and an in-map encoder to
 // indicate if a value exists in the map (to distinguish null values from
-// not-in-map values)
+// not-in-map values). Only the maps that have the key are recorded per batch
+// and the in-map bits are expanded in a scratch buffer of the context when
+// writing, so that thousands of keys do not each hold a buffer of the batch
+// size. writeBuffers() of different ValueWriters may run in parallel.
 class ValueWriter {
  public:
   ValueWriter(
       const uint32_t sequence,
       const proto::KeyInfo& keyInfo,
       WriterContext& context,
-      const dwio::common::TypeWithId& type,
-      uint32_t inMapSize)
-      : sequence_{sequence},
+      const dwio::common::TypeWithId& type)
+      : context_{context},
+        sequence_{sequence},
         keyInfo_{keyInfo},
         inMap_{createBooleanRleEncoder(context.newStream(
             {type.id(),
@@ -112,25 +115,26 @@ class ValueWriter {
             [this](auto& indexBuilder) {
               inMap_->recordPosition(indexBuilder);
             })},
-        inMapBuffer_{
-            context.getMemoryPool(MemoryUsageCategory::GENERAL),
-            inMapSize},
         ranges_{},
         collectMapStats_{context.getConfig(Config::MAP_STATISTICS)} {}
 
+  // Maps are added in order, so a duplicate key repeats the last index.
   void addOffset(uint64_t offset, uint64_t inMapIndex) {
-    if (UNLIKELY(inMapBuffer_[inMapIndex])) {
+    if (UNLIKELY(!inMapRows_.empty() && inMapRows_.back() == inMapIndex)) {
       DWIO_RAISE("Duplicate key in map");
     }
 
     ranges_.add(offset, offset + 1);
-    inMapBuffer_[inMapIndex] = 1;
+    inMapRows_.push_back(inMapIndex);
   }
 
   uint64_t writeBuffers(const VectorPtr& values, uint32_t mapCount) {
     if (mapCount) {
-      inMap_->add(
-          inMapBuffer_.data(), common::Ranges::of(0, mapCount), nullptr);
+      auto inMap = context_.getLocalScratchBuffer(mapCount);
+      for (auto row : inMapRows_) {
+        inMap.data()[row] = 1;
+      }
+      inMap_->add(inMap.data(), common::Ranges::of(0, mapCount), nullptr);
     }
 
     if (values) {
@@ -162,9 +166,8 @@ class ValueWriter {
       return;
     }
 
-    inMapBuffer_.reserve(count);
-    std::memset(inMapBuffer_.data(), 0, count);
-    inMap_->add(inMapBuffer_.data(), common::Ranges::of(0, count), nullptr);
+    auto inMap = context_.getLocalScratchBuffer(count);
+    inMap_->add(inMap.data(), common::Ranges::of(0, count), nullptr);
   }
 
   uint32_t getSequence() const {
@@ -196,18 +199,19 @@ class ValueWriter {
     columnWriter_->reset();
   }
 
-  void resizeBuffers(size_t inMap) {
-    inMapBuffer_.reserve(inMap);
-    std::memset(inMapBuffer_.data(), 0, inMap);
+  void resetBatch() {
+    inMapRows_.clear();
     ranges_.clear();
   }
 
  private:
+  WriterContext& context_;
   uint32_t sequence_;
   const proto::KeyInfo keyInfo_;
   std::unique_ptr<ByteRleEncoder> inMap_;
   std::unique_ptr<BaseColumnWriter> columnWriter_;
-  dwio::common::DataBuffer<char> inMapBuffer_;
+  // Indices of the maps of the current batch that have the key.
+  std::vector<uint32_t> inMapRows_;
   common::Ranges ranges_;
   const bool collectMapStats_;
 };
@@ -275,7 +279,15 @@ class FlatMapColumnWriter : public BaseColumnWriter {
 
   void setEncoding(proto::ColumnEncoding& encoding) const override;
 
-  ValueWriter& getValueWriter(KeyType key, uint32_t inMapSize);
+  ValueWriter& getValueWriter(KeyType key);
+
+  // Calls 'write' for each index below 'numValueWriters' and returns the sum
+  // of the results. Each call writes one value writer, so the calls run in
+  // parallel on 'context_.encodingExecutor()' if set and there are enough of
+  // them. Value writers sharing dictionaries are always written in order.
+  uint64_t writeValues(
+      size_t numValueWriters,
+      const std::function<uint64_t(size_t)>& write);
 
   // write() calls writeMap() or writeRow() depending on input type
   uint64_t writeMap(const VectorPtr& slice, const common::Ranges& ranges);
@@ -19,6 +19,8 @@
 #include <iterator>
 #include <limits>
 
+#include <folly/Executor.h>
+
 #include "velox/dwio/common/Writer.h"
 #include "velox/dwio/common/WriterFactory.h"
 #include "velox/dwio/dwrf/common/Encryption.h"
@@ -46,6 +48,12 @@ struct WriterOptions {
       WriterContext& context,
       const velox::dwio::common::TypeWithId& type)>
       columnWriterFactory;
+  /// If set, the top level columns of each written batch are encoded in
+  /// parallel on this executor. If maps are flattened, the values of the
+  /// keys of each flat map are encoded in parallel instead. The caller thread
+  /// takes part in the encoding, so a saturated executor does not stall the
+  /// write.
+  std::shared_ptr<folly::Executor> encodingExecutor;
 };
 
 class Writer : public dwio::common::Writer {
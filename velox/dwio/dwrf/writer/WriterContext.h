@@ -17,6 +17,10 @@
 #pragma once
 
 #include <limits>
+#include <mutex>
+
+#include <folly/Executor.h>
+
 #include "velox/common/base/GTestMacros.h"
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/dwio/dwrf/common/Common.h"
@@ -273,6 +277,12 @@ class WriterContext : public CompressionBufferPool {
 
   std::unique_ptr<dwio::common::DataBuffer<char>> getBuffer(
       uint64_t size) override {
+    std::lock_guard<std::mutex> l(compressionBufferMutex_);
+    if (!compressionBuffer_ && encodingExecutor_) {
+      // Another column encoded in parallel holds the buffer.
+      return std::make_unique<dwio::common::DataBuffer<char>>(
+          *generalPool_, compressionBlockSize_ + PAGE_HEADER_SIZE);
+    }
     DWIO_ENSURE_NOT_NULL(compressionBuffer_);
     DWIO_ENSURE_GE(compressionBuffer_->size(), size);
     return std::move(compressionBuffer_);
@@ -281,6 +291,10 @@ class WriterContext : public CompressionBufferPool {
   void returnBuffer(
       std::unique_ptr<dwio::common::DataBuffer<char>> buffer) override {
     DWIO_ENSURE_NOT_NULL(buffer);
+    std::lock_guard<std::mutex> l(compressionBufferMutex_);
+    if (compressionBuffer_ && encodingExecutor_) {
+      return;
+    }
     DWIO_ENSURE(!compressionBuffer_);
     compressionBuffer_ = std::move(buffer);
   }
@@ -362,6 +376,23 @@ class WriterContext : public CompressionBufferPool {
     return lowMemoryMode_;
   }
 
+  void setEncodingExecutor(std::shared_ptr<folly::Executor> executor) {
+    encodingExecutor_ = std::move(executor);
+  }
+
+  /// Executor for encoding top level columns or the values of flat map keys
+  /// in parallel, nullptr if everything is encoded on the caller thread.
+  folly::Executor* encodingExecutor() const {
+    return encodingExecutor_.get();
+  }
+
+  /// True if the top level columns are encoded in parallel. Flat map writers
+  /// create streams while writing, so when maps are flattened they encode
+  /// the values of their keys in parallel instead.
+  bool encodeColumnsInParallel() const {
+    return encodingExecutor_ && !getConfig(Config::FLATTEN_MAP);
+  }
+
   PhysicalSizeAggregator& getPhysicalSizeAggregator(uint32_t node) {
     return *physicalSizeAggregators_.at(node);
   }
@@ -571,6 +602,44 @@ class WriterContext : public CompressionBufferPool {
     return LocalDecodedVector{*this};
   }
 
+  /// A zero filled scratch buffer from a pool shared by all column writers,
+  /// returned to the pool when destroyed. Flat map writers fill the in-map
+  /// bits of each key in one, so their memory is bounded by the number of
+  /// keys encoded at the same time instead of the number of keys.
+  class LocalScratchBuffer {
+   public:
+    LocalScratchBuffer(WriterContext& context, uint64_t size)
+        : context_(context), buffer_(context_.getScratchBuffer()) {
+      if (size > 0) {
+        buffer_->reserve(size);
+        std::memset(buffer_->data(), 0, size);
+      }
+    }
+
+    LocalScratchBuffer(LocalScratchBuffer&& other) noexcept
+        : context_{other.context_}, buffer_{std::move(other.buffer_)} {}
+
+    LocalScratchBuffer& operator=(LocalScratchBuffer&& other) = delete;
+
+    ~LocalScratchBuffer() {
+      if (buffer_) {
+        context_.releaseScratchBuffer(std::move(buffer_));
+      }
+    }
+
+    char* data() {
+      return buffer_->data();
+    }
+
+   private:
+    WriterContext& context_;
+    std::unique_ptr<dwio::common::DataBuffer<char>> buffer_;
+  };
+
+  LocalScratchBuffer getLocalScratchBuffer(uint64_t size) {
+    return LocalScratchBuffer{*this, size};
+  }
+
   SelectivityVector& getSharedSelectivityVector(velox::vector_size_t size) {
     if (FOLLY_UNLIKELY(selectivityVector_ == nullptr)) {
       selectivityVector_ = std::make_unique<velox::SelectivityVector>(size);
@@ -584,6 +653,7 @@ class WriterContext : public CompressionBufferPool {
   void validateConfigs() const;
 
   std::unique_ptr<velox::DecodedVector> getDecodedVector() {
+    std::lock_guard<std::mutex> l(decodedVectorPoolMutex_);
     if (decodedVectorPool_.empty()) {
       return std::make_unique<velox::DecodedVector>();
     }
@@ -593,9 +663,26 @@ class WriterContext : public CompressionBufferPool {
   }
 
   void releaseDecodedVector(std::unique_ptr<velox::DecodedVector>&& vector) {
+    std::lock_guard<std::mutex> l(decodedVectorPoolMutex_);
     decodedVectorPool_.push_back(std::move(vector));
   }
 
+  std::unique_ptr<dwio::common::DataBuffer<char>> getScratchBuffer() {
+    std::lock_guard<std::mutex> l(scratchBufferPoolMutex_);
+    if (scratchBufferPool_.empty()) {
+      return std::make_unique<dwio::common::DataBuffer<char>>(*generalPool_);
+    }
+    auto buffer = std::move(scratchBufferPool_.back());
+    scratchBufferPool_.pop_back();
+    return buffer;
+  }
+
+  void releaseScratchBuffer(
+      std::unique_ptr<dwio::common::DataBuffer<char>>&& buffer) {
+    std::lock_guard<std::mutex> l(scratchBufferPoolMutex_);
+    scratchBufferPool_.push_back(std::move(buffer));
+  }
+
   const std::shared_ptr<const Config> config_;
   const std::shared_ptr<memory::MemoryPool> pool_;
   const std::shared_ptr<memory::MemoryPool> dictionaryPool_;
@@ -631,8 +718,15 @@ class WriterContext : public CompressionBufferPool {
       std::unique_ptr<BufferedOutputStream>)>
       indexBuilderFactory_;
   std::unique_ptr<dwio::common::DataBuffer<char>> compressionBuffer_;
+  std::mutex compressionBufferMutex_;
   // A pool of reusable DecodedVectors.
   std::vector<std::unique_ptr<velox::DecodedVector>> decodedVectorPool_;
+  // Serializes access to 'decodedVectorPool_' from parallel column encoding.
+  std::mutex decodedVectorPoolMutex_;
+  // A pool of reusable scratch buffers, see LocalScratchBuffer.
+  std::vector<std::unique_ptr<dwio::common::DataBuffer<char>>>
+      scratchBufferPool_;
+  std::mutex scratchBufferPoolMutex_;
   // Reusable SelectivityVector
   std::unique_ptr<velox::SelectivityVector> selectivityVector_;
 
@@ -645,6 +739,7 @@ class WriterContext : public CompressionBufferPool {
   AverageRowSizeTracker rowSizeTracker_;
   bool checkLowMemoryMode_;
   bool lowMemoryMode_{false};
+  std::shared_ptr<folly::Executor> encodingExecutor_;
 
   /// stats
   uint32_t stripeIndex_{0};
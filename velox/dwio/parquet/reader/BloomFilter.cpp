@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/BloomFilter.h"
+
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+#include "velox/dwio/common/StreamUtil.h"
+#include "velox/dwio/parquet/thrift/ThriftTransport.h"
+
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+namespace facebook::velox::parquet {
+
+namespace {
+// The BloomFilterHeader is a few bytes of compact thrift. This is read in one
+// go together with the start of the bitset.
+constexpr uint64_t kHeaderSizeGuess = 64;
+
+// Maximum bitset size written by parquet-mr and Arrow.
+constexpr int32_t kMaxBloomFilterBytes = 128 << 20;
+
+// Salts for selecting a bit in each word of a block.
+constexpr uint32_t kSalt[8] = {
+    0x47b6137bU,
+    0x44974d91U,
+    0x8824ad5bU,
+    0xa2b7289dU,
+    0x705495c7U,
+    0x2df1424bU,
+    0x9efc4947U,
+    0x5c6bfb31U};
+} // namespace
+
+BlockSplitBloomFilter::BlockSplitBloomFilter(std::string bitset)
+    : bitset_(std::move(bitset)), numBlocks_(bitset_.size() / kBytesPerBlock) {
+  VELOX_CHECK_GT(numBlocks_, 0);
+  VELOX_CHECK_EQ(bitset_.size() % kBytesPerBlock, 0);
+}
+
+// static
+std::unique_ptr<BlockSplitBloomFilter> BlockSplitBloomFilter::read(
+    dwio::common::BufferedInput& input,
+    uint64_t offset) {
+  const uint64_t fileSize = input.getReadFile()->size();
+  VELOX_CHECK_LT(offset, fileSize, "Bloom filter offset past end of file");
+  const uint64_t readSize = std::min(kHeaderSizeGuess, fileSize - offset);
+  std::string buffer(readSize, '\0');
+  auto stream =
+      input.read(offset, readSize, dwio::common::LogType::STRIPE_INDEX);
+  const char* bufferStart = nullptr;
+  const char* bufferEnd = nullptr;
+  dwio::common::readBytes(
+      readSize, stream.get(), buffer.data(), bufferStart, bufferEnd);
+
+  auto transport =
+      std::make_shared<thrift::ThriftBufferedTransport>(buffer.data(), readSize);
+  apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport> protocol(
+      transport);
+  thrift::BloomFilterHeader header;
+  header.read(&protocol);
+  if (!header.algorithm.__isset.BLOCK || !header.hash.__isset.XXHASH ||
+      !header.compression.__isset.UNCOMPRESSED) {
+    return nullptr;
+  }
+  VELOX_CHECK(
+      header.numBytes > 0 && header.numBytes <= kMaxBloomFilterBytes &&
+          header.numBytes % kBytesPerBlock == 0,
+      "Bad Bloom filter size: {}",
+      header.numBytes);
+
+  const uint64_t headerSize = transport->offset();
+  std::string bitset(header.numBytes, '\0');
+  const uint64_t numBuffered =
+      std::min<uint64_t>(readSize - headerSize, header.numBytes);
+  memcpy(bitset.data(), buffer.data() + headerSize, numBuffered);
+  if (numBuffered < header.numBytes) {
+    const uint64_t numLeft = header.numBytes - numBuffered;
+    VELOX_CHECK_LE(offset + readSize + numLeft, fileSize);
+    stream = input.read(
+        offset + readSize, numLeft, dwio::common::LogType::STRIPE_INDEX);
+    bufferStart = nullptr;
+    bufferEnd = nullptr;
+    dwio::common::readBytes(
+        numLeft, stream.get(), bitset.data() + numBuffered, bufferStart, bufferEnd);
+  }
+  return std::make_unique<BlockSplitBloomFilter>(std::move(bitset));
+}
+
+// static
+uint64_t BlockSplitBloomFilter::hashInt32(int32_t value) {
+  return XXH64(&value, sizeof(value), 0);
+}
+
+// static
+uint64_t BlockSplitBloomFilter::hashInt64(int64_t value) {
+  return XXH64(&value, sizeof(value), 0);
+}
+
+// static
+uint64_t BlockSplitBloomFilter::hashBytes(const char* data, int32_t length) {
+  return XXH64(data, length, 0);
+}
+
+bool BlockSplitBloomFilter::mayContain(uint64_t hash) const {
+  const uint32_t blockIndex = ((hash >> 32) * numBlocks_) >> 32;
+  const uint32_t key = static_cast<uint32_t>(hash);
+  auto* block = reinterpret_cast<const uint32_t*>(bitset_.data()) +
+      blockIndex * (kBytesPerBlock / sizeof(uint32_t));
+  for (auto i = 0; i < 8; ++i) {
+    const uint32_t mask = 1U << ((key * kSalt[i]) >> 27);
+    if ((block[i] & mask) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+namespace {
+bool mayContainInt(
+    const BlockSplitBloomFilter& bloomFilter,
+    int64_t value,
+    thrift::Type::type physicalType) {
+  if (physicalType == thrift::Type::INT32) {
+    if (value < std::numeric_limits<int32_t>::min() ||
+        value > std::numeric_limits<int32_t>::max()) {
+      return false;
+    }
+    return bloomFilter.mayContain(BlockSplitBloomFilter::hashInt32(value));
+  }
+  return bloomFilter.mayContain(BlockSplitBloomFilter::hashInt64(value));
+}
+
+bool mayContainAnyInt(
+    const BlockSplitBloomFilter& bloomFilter,
+    const std::vector<int64_t>& values,
+    thrift::Type::type physicalType) {
+  for (auto value : values) {
+    if (mayContainInt(bloomFilter, value, physicalType)) {
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace
+
+bool canUseBloomFilter(
+    const common::Filter& filter,
+    thrift::Type::type physicalType) {
+  // Nulls are not in the Bloom filter.
+  if (filter.nullAllowed()) {
+    return false;
+  }
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange:
+      return (physicalType == thrift::Type::INT32 ||
+              physicalType == thrift::Type::INT64) &&
+          static_cast<const common::BigintRange&>(filter).isSingleValue();
+    case common::FilterKind::kBigintValuesUsingHashTable:
+    case common::FilterKind::kBigintValuesUsingBitmask:
+      return physicalType == thrift::Type::INT32 ||
+          physicalType == thrift::Type::INT64;
+    case common::FilterKind::kBytesRange:
+      return physicalType == thrift::Type::BYTE_ARRAY &&
+          static_cast<const common::BytesRange&>(filter).isSingleValue();
+    case common::FilterKind::kBytesValues:
+      return physicalType == thrift::Type::BYTE_ARRAY;
+    default:
+      return false;
+  }
+}
+
+bool testBloomFilter(
+    const common::Filter& filter,
+    const BlockSplitBloomFilter& bloomFilter,
+    thrift::Type::type physicalType) {
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange:
+      return mayContainInt(
+          bloomFilter,
+          static_cast<const common::BigintRange&>(filter).lower(),
+          physicalType);
+    case common::FilterKind::kBigintValuesUsingHashTable:
+      return mayContainAnyInt(
+          bloomFilter,
+          static_cast<const common::BigintValuesUsingHashTable&>(filter)
+              .values(),
+          physicalType);
+    case common::FilterKind::kBigintValuesUsingBitmask:
+      return mayContainAnyInt(
+          bloomFilter,
+          static_cast<const common::BigintValuesUsingBitmask&>(filter).values(),
+          physicalType);
+    case common::FilterKind::kBytesRange: {
+      auto& value = static_cast<const common::BytesRange&>(filter).lower();
+      return bloomFilter.mayContain(
+          BlockSplitBloomFilter::hashBytes(value.data(), value.size()));
+    }
+    case common::FilterKind::kBytesValues:
+      for (auto& value :
+           static_cast<const common::BytesValues&>(filter).values()) {
+        if (bloomFilter.mayContain(
+                BlockSplitBloomFilter::hashBytes(value.data(), value.size()))) {
+          return true;
+        }
+      }
+      return false;
+    default:
+      return true;
+  }
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/type/Filter.h"
+
+namespace facebook::velox::parquet {
+
+/// Split block Bloom filter of a Parquet column chunk as described in
+/// https://github.com/apache/parquet-format/blob/master/BloomFilter.md. The
+/// bitset is a sequence of 256 bit blocks. A value is hashed with XXH64 over
+/// its plain encoding. The upper 32 bits of the hash select the block and the
+/// lower 32 bits select one bit in each of the 8 words of the block.
+class BlockSplitBloomFilter {
+ public:
+  static constexpr int32_t kBytesPerBlock = 32;
+
+  explicit BlockSplitBloomFilter(std::string bitset);
+
+  /// Reads the BloomFilterHeader and the bitset starting at 'offset' in
+  /// 'input'. Returns nullptr if the filter uses an algorithm, hash or
+  /// compression this reader does not know.
+  static std::unique_ptr<BlockSplitBloomFilter> read(
+      dwio::common::BufferedInput& input,
+      uint64_t offset);
+
+  static uint64_t hashInt32(int32_t value);
+
+  static uint64_t hashInt64(int64_t value);
+
+  static uint64_t hashBytes(const char* data, int32_t length);
+
+  /// False if no value with 'hash' was inserted in 'this'.
+  bool mayContain(uint64_t hash) const;
+
+ private:
+  const std::string bitset_;
+  const uint32_t numBlocks_;
+};
+
+/// Returns true if 'filter' is an equality or IN-list filter that can be
+/// tested against a Bloom filter of a column of 'physicalType'.
+bool canUseBloomFilter(
+    const common::Filter& filter,
+    thrift::Type::type physicalType);
+
+/// Returns false if no value passing 'filter' is in 'bloomFilter'. Only
+/// meaningful if canUseBloomFilter() is true for 'filter'.
+bool testBloomFilter(
+    const common::Filter& filter,
+    const BlockSplitBloomFilter& bloomFilter,
+    thrift::Type::type physicalType);
+
+} // namespace facebook::velox::parquet
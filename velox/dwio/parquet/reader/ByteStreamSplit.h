@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::parquet {
+
+/// Decodes 'numValues' values of 'kWidth' bytes from BYTE_STREAM_SPLIT
+/// encoded 'data' into 'values'. The encoding stores byte 0 of all values,
+/// then byte 1 of all values and so on. The inner loop has a constant trip
+/// count and a contiguous store, so the compiler unrolls and vectorizes the
+/// interleave.
+template <int32_t kWidth>
+inline void decodeByteStreamSplit(
+    const char* data,
+    int32_t numValues,
+    char* values) {
+  for (int32_t i = 0; i < numValues; ++i) {
+    for (int32_t byte = 0; byte < kWidth; ++byte) {
+      values[i * kWidth + byte] = data[byte * numValues + i];
+    }
+  }
+}
+
+/// Decodes 'numBytes' of BYTE_STREAM_SPLIT encoded 'data' with values of
+/// 'width' bytes into 'values'. Returns the number of values.
+inline int32_t decodeByteStreamSplit(
+    const char* data,
+    int32_t numBytes,
+    int32_t width,
+    char* values) {
+  VELOX_CHECK_EQ(
+      numBytes % width,
+      0,
+      "BYTE_STREAM_SPLIT data is not a whole number of values");
+  auto numValues = numBytes / width;
+  switch (width) {
+    case 4:
+      decodeByteStreamSplit<4>(data, numValues, values);
+      break;
+    case 8:
+      decodeByteStreamSplit<8>(data, numValues, values);
+      break;
+    default:
+      VELOX_UNSUPPORTED("BYTE_STREAM_SPLIT with width {}", width);
+  }
+  return numValues;
+}
+
+} // namespace facebook::velox::parquet
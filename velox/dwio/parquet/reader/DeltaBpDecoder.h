@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/base/Nulls.h"
+#include "velox/common/encode/Coding.h"
+#include "velox/dwio/common/BitPackDecoder.h"
+
+namespace facebook::velox::parquet {
+
+/// Decoder for the DELTA_BINARY_PACKED encoding of INT32 and INT64 columns.
+/// The values of a miniblock are unpacked and prefix summed at a time, so
+/// that the per-value work is a load from 'values_'.
+class DeltaBpDecoder {
+ public:
+  /// 'is32Bit' is true for INT32 data, where the deltas wrap around at 32
+  /// bits. The values are then sign extended from the low 32 bits.
+  DeltaBpDecoder(
+      const char* FOLLY_NONNULL start,
+      const char* FOLLY_NONNULL end,
+      bool is32Bit = false)
+      : bufferStart_(start), bufferEnd_(end), is32Bit_(is32Bit) {
+    blockSize_ = readVarint();
+    numMiniBlocks_ = readVarint();
+    totalValues_ = readVarint();
+    VELOX_CHECK(
+        blockSize_ > 0 && blockSize_ % 128 == 0,
+        "Bad DELTA_BINARY_PACKED block size {}",
+        blockSize_);
+    VELOX_CHECK(
+        numMiniBlocks_ > 0 && blockSize_ % numMiniBlocks_ == 0,
+        "Bad DELTA_BINARY_PACKED miniblock count {}",
+        numMiniBlocks_);
+    valuesPerMiniBlock_ = blockSize_ / numMiniBlocks_;
+    VELOX_CHECK_EQ(valuesPerMiniBlock_ % 32, 0);
+    bitWidths_.resize(numMiniBlocks_);
+    miniBlockIndex_ = numMiniBlocks_;
+    values_.resize(valuesPerMiniBlock_);
+    deltas_.resize(valuesPerMiniBlock_);
+    lastValue_ = ZigZag::decode<uint64_t>(readVarint());
+    if (totalValues_ > 0) {
+      values_[0] = is32Bit_ ? static_cast<int32_t>(lastValue_) : lastValue_;
+      numBuffered_ = 1;
+    }
+  }
+
+  /// Returns the number of values in the page.
+  int64_t totalValues() const {
+    return totalValues_;
+  }
+
+  /// Returns the first byte after the miniblocks read so far. After all
+  /// values are read, this is the end of the encoded data.
+  const char* FOLLY_NONNULL bufferStart() const {
+    return bufferStart_;
+  }
+
+  void skip(uint64_t numValues) {
+    skip<false>(numValues, 0, nullptr);
+  }
+
+  template <bool hasNulls>
+  inline void skip(
+      int32_t numValues,
+      int32_t current,
+      const uint64_t* FOLLY_NULLABLE nulls) {
+    if (hasNulls) {
+      numValues = bits::countNonNulls(nulls, current, current + numValues);
+    }
+    // Each value is the sum of the deltas before it, so skipped miniblocks
+    // are decoded as well.
+    while (numValues > 0) {
+      if (valueIndex_ == numBuffered_) {
+        readMiniBlock();
+      }
+      auto numSkipped = std::min<int32_t>(numValues, numBuffered_ - valueIndex_);
+      valueIndex_ += numSkipped;
+      numValues -= numSkipped;
+    }
+  }
+
+  template <bool hasNulls, typename Visitor>
+  void readWithVisitor(const uint64_t* FOLLY_NULLABLE nulls, Visitor visitor) {
+    int32_t current = visitor.start();
+    skip<hasNulls>(current, 0, nulls);
+    int32_t toSkip;
+    bool atEnd = false;
+    const bool allowNulls = hasNulls && visitor.allowNulls();
+    for (;;) {
+      if (hasNulls && allowNulls && bits::isBitNull(nulls, current)) {
+        toSkip = visitor.processNull(atEnd);
+      } else {
+        if (hasNulls && !allowNulls) {
+          toSkip = visitor.checkAndSkipNulls(nulls, current, atEnd);
+          if (!Visitor::dense) {
+            skip<false>(toSkip, current, nullptr);
+          }
+          if (atEnd) {
+            return;
+          }
+        }
+
+        // We are at a non-null value on a row to visit.
+        toSkip = visitor.process(readLong(), atEnd);
+      }
+      ++current;
+      if (toSkip) {
+        skip<hasNulls>(toSkip, current, nulls);
+        current += toSkip;
+      }
+      if (atEnd) {
+        return;
+      }
+    }
+  }
+
+  /// Returns the next value. INT32 values are produced in the low 32 bits.
+  int64_t readLong() {
+    if (valueIndex_ == numBuffered_) {
+      readMiniBlock();
+    }
+    return values_[valueIndex_++];
+  }
+
+ private:
+  uint64_t readVarint() {
+    uint64_t result = 0;
+    for (int32_t shift = 0; shift < 64; shift += 7) {
+      VELOX_CHECK_LT(bufferStart_, bufferEnd_, "DELTA_BINARY_PACKED overrun");
+      auto byte = static_cast<uint8_t>(*bufferStart_++);
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return result;
+      }
+    }
+    VELOX_FAIL("Bad varint in DELTA_BINARY_PACKED header");
+  }
+
+  void readBlockHeader() {
+    minDelta_ = ZigZag::decode<uint64_t>(readVarint());
+    VELOX_CHECK_LE(
+        bufferStart_ + numMiniBlocks_, bufferEnd_, "DELTA_BINARY_PACKED overrun");
+    for (auto i = 0; i < numMiniBlocks_; ++i) {
+      bitWidths_[i] = static_cast<uint8_t>(bufferStart_[i]);
+      VELOX_CHECK_LE(bitWidths_[i], 64);
+    }
+    bufferStart_ += numMiniBlocks_;
+    miniBlockIndex_ = 0;
+  }
+
+  // Unpacks the next miniblock and replaces the deltas with the values they
+  // produce.
+  void readMiniBlock() {
+    VELOX_CHECK_LT(
+        valuesRead_ + numBuffered_, totalValues_, "Reading past end of page");
+    if (miniBlockIndex_ == numMiniBlocks_) {
+      readBlockHeader();
+    }
+    auto bitWidth = bitWidths_[miniBlockIndex_++];
+    auto numValues = std::min<int64_t>(
+        valuesPerMiniBlock_, totalValues_ - valuesRead_ - numBuffered_);
+    valuesRead_ += numBuffered_;
+    // Unpack a multiple of 8 values, 'valuesPerMiniBlock_' is a multiple of
+    // 32.
+    auto numUnpacked = bits::roundUp(numValues, 8);
+    auto numUnpackedBytes = numUnpacked * bitWidth / 8;
+    // The last miniblock may be truncated to the bytes that contain values.
+    auto numBytes = std::min<int64_t>(
+        valuesPerMiniBlock_ * bitWidth / 8, bufferEnd_ - bufferStart_);
+    VELOX_CHECK_GE(
+        numBytes,
+        bits::roundUp(numValues * bitWidth, 8) / 8,
+        "DELTA_BINARY_PACKED overrun");
+    const char* packed = bufferStart_;
+    if (bufferStart_ + numUnpackedBytes + sizeof(uint64_t) > bufferEnd_) {
+      // Unpacking reads whole words, copy the end of the page to a padded
+      // buffer.
+      scratch_.assign(numUnpackedBytes + sizeof(uint64_t), 0);
+      memcpy(
+          scratch_.data(),
+          bufferStart_,
+          std::min<int64_t>(numBytes, numUnpackedBytes));
+      packed = scratch_.data();
+    }
+    bufferStart_ += numBytes;
+
+    unpackDeltas(packed, bitWidth, numUnpacked, numUnpackedBytes);
+    uint64_t value = lastValue_;
+    if (is32Bit_) {
+      for (auto i = 0; i < numValues; ++i) {
+        value += minDelta_ + deltas_[i];
+        values_[i] = static_cast<int32_t>(value);
+      }
+    } else {
+      for (auto i = 0; i < numValues; ++i) {
+        value += minDelta_ + deltas_[i];
+        values_[i] = value;
+      }
+    }
+    lastValue_ = value;
+    numBuffered_ = numValues;
+    valueIndex_ = 0;
+  }
+
+  void unpackDeltas(
+      const char* FOLLY_NONNULL packed,
+      uint8_t bitWidth,
+      int32_t numValues,
+      int32_t numBytes) {
+    if (bitWidth == 0) {
+      std::fill(deltas_.begin(), deltas_.begin() + numValues, 0);
+      return;
+    }
+    if (bitWidth <= 32) {
+      // Runs the SIMD unpacking of the RLE/bit packed encoding when
+      // available.
+      deltas32_.resize(valuesPerMiniBlock_);
+      auto input = reinterpret_cast<const uint8_t*>(packed);
+      auto output = deltas32_.data();
+      dwio::common::unpack<uint32_t>(
+          input, numBytes, numValues, bitWidth, output);
+      for (auto i = 0; i < numValues; ++i) {
+        deltas_[i] = deltas32_[i];
+      }
+      return;
+    }
+    auto mask = bitWidth == 64 ? ~0UL : bits::lowMask(bitWidth);
+    auto words = reinterpret_cast<const uint64_t*>(packed);
+    for (auto i = 0; i < numValues; ++i) {
+      deltas_[i] =
+          bits::detail::loadBits<uint64_t>(words, i * bitWidth, bitWidth) &
+          mask;
+    }
+  }
+
+  const char* FOLLY_NONNULL bufferStart_;
+  const char* FOLLY_NONNULL bufferEnd_;
+  const bool is32Bit_;
+
+  int64_t blockSize_;
+  int64_t numMiniBlocks_;
+  int64_t valuesPerMiniBlock_;
+  int64_t totalValues_;
+
+  // Bit widths of the miniblocks of the current block.
+  std::vector<uint8_t> bitWidths_;
+  int32_t miniBlockIndex_;
+  uint64_t minDelta_{0};
+
+  // The last value produced, to which the next delta is added.
+  uint64_t lastValue_;
+
+  // Decoded values of the current miniblock, 'valueIndex_' is the next one
+  // to return.
+  std::vector<int64_t> values_;
+  int32_t numBuffered_{0};
+  int32_t valueIndex_{0};
+
+  // Number of values in miniblocks before the current one.
+  int64_t valuesRead_{0};
+
+  std::vector<uint64_t> deltas_;
+  std::vector<uint32_t> deltas32_;
+
+  // Padded copy of a miniblock at the end of the page.
+  std::vector<char> scratch_;
+};
+
+} // namespace facebook::velox::parquet
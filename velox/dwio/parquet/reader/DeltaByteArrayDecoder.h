@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
+
+#include <folly/Range.h>
+
+namespace facebook::velox::parquet {
+
+/// Decoder for the DELTA_LENGTH_BYTE_ARRAY encoding. The lengths are
+/// DELTA_BINARY_PACKED and are followed by the concatenated values.
+class DeltaLengthByteArrayDecoder {
+ public:
+  DeltaLengthByteArrayDecoder(
+      const char* FOLLY_NONNULL start,
+      const char* FOLLY_NONNULL end)
+      : bufferEnd_(end) {
+    DeltaBpDecoder lengthDecoder(start, end, true);
+    lengths_.resize(lengthDecoder.totalValues());
+    for (auto& length : lengths_) {
+      length = lengthDecoder.readLong();
+      VELOX_CHECK_GE(length, 0);
+    }
+    bufferStart_ = lengthDecoder.bufferStart();
+  }
+
+  void skip(uint64_t numValues) {
+    skip<false>(numValues, 0, nullptr);
+  }
+
+  template <bool hasNulls>
+  inline void skip(
+      int32_t numValues,
+      int32_t current,
+      const uint64_t* FOLLY_NULLABLE nulls) {
+    if (hasNulls) {
+      numValues = bits::countNonNulls(nulls, current, current + numValues);
+    }
+    for (auto i = 0; i < numValues; ++i) {
+      bufferStart_ += lengths_[index_++];
+    }
+  }
+
+  template <bool hasNulls, typename Visitor>
+  void readWithVisitor(const uint64_t* FOLLY_NULLABLE nulls, Visitor visitor) {
+    int32_t current = visitor.start();
+    skip<hasNulls>(current, 0, nulls);
+    int32_t toSkip;
+    bool atEnd = false;
+    const bool allowNulls = hasNulls && visitor.allowNulls();
+    for (;;) {
+      if (hasNulls && allowNulls && bits::isBitNull(nulls, current)) {
+        toSkip = visitor.processNull(atEnd);
+      } else {
+        if (hasNulls && !allowNulls) {
+          toSkip = visitor.checkAndSkipNulls(nulls, current, atEnd);
+          if (!Visitor::dense) {
+            skip<false>(toSkip, current, nullptr);
+          }
+          if (atEnd) {
+            return;
+          }
+        }
+
+        // We are at a non-null value on a row to visit.
+        toSkip = visitor.process(readString(), atEnd);
+      }
+      ++current;
+      if (toSkip) {
+        skip<hasNulls>(toSkip, current, nulls);
+        current += toSkip;
+      }
+      if (atEnd) {
+        return;
+      }
+    }
+  }
+
+  /// Returns the next value. The value points into the page.
+  folly::StringPiece readString() {
+    VELOX_CHECK_LT(index_, lengths_.size(), "Reading past end of page");
+    auto length = lengths_[index_++];
+    VELOX_CHECK_LE(bufferStart_ + length, bufferEnd_);
+    bufferStart_ += length;
+    return folly::StringPiece(bufferStart_ - length, length);
+  }
+
+ private:
+  const char* FOLLY_NONNULL bufferStart_;
+  const char* FOLLY_NONNULL bufferEnd_;
+  std::vector<int32_t> lengths_;
+  int32_t index_{0};
+};
+
+/// Decoder for the DELTA_BYTE_ARRAY encoding. Each value is a prefix of the
+/// previous value followed by a suffix. The prefix lengths are
+/// DELTA_BINARY_PACKED and are followed by the suffixes in
+/// DELTA_LENGTH_BYTE_ARRAY.
+class DeltaByteArrayDecoder {
+ public:
+  DeltaByteArrayDecoder(
+      const char* FOLLY_NONNULL start,
+      const char* FOLLY_NONNULL end) {
+    DeltaBpDecoder prefixDecoder(start, end, true);
+    prefixLengths_.resize(prefixDecoder.totalValues());
+    for (auto& length : prefixLengths_) {
+      length = prefixDecoder.readLong();
+      VELOX_CHECK_GE(length, 0);
+    }
+    suffixDecoder_ = std::make_unique<DeltaLengthByteArrayDecoder>(
+        prefixDecoder.bufferStart(), end);
+  }
+
+  void skip(uint64_t numValues) {
+    skip<false>(numValues, 0, nullptr);
+  }
+
+  template <bool hasNulls>
+  inline void skip(
+      int32_t numValues,
+      int32_t current,
+      const uint64_t* FOLLY_NULLABLE nulls) {
+    if (hasNulls) {
+      numValues = bits::countNonNulls(nulls, current, current + numValues);
+    }
+    // The next value may share a prefix with a skipped one.
+    for (auto i = 0; i < numValues; ++i) {
+      readString();
+    }
+  }
+
+  template <bool hasNulls, typename Visitor>
+  void readWithVisitor(const uint64_t* FOLLY_NULLABLE nulls, Visitor visitor) {
+    int32_t current = visitor.start();
+    skip<hasNulls>(current, 0, nulls);
+    int32_t toSkip;
+    bool atEnd = false;
+    const bool allowNulls = hasNulls && visitor.allowNulls();
+    for (;;) {
+      if (hasNulls && allowNulls && bits::isBitNull(nulls, current)) {
+        toSkip = visitor.processNull(atEnd);
+      } else {
+        if (hasNulls && !allowNulls) {
+          toSkip = visitor.checkAndSkipNulls(nulls, current, atEnd);
+          if (!Visitor::dense) {
+            skip<false>(toSkip, current, nullptr);
+          }
+          if (atEnd) {
+            return;
+          }
+        }
+
+        // We are at a non-null value on a row to visit.
+        toSkip = visitor.process(readString(), atEnd);
+      }
+      ++current;
+      if (toSkip) {
+        skip<hasNulls>(toSkip, current, nulls);
+        current += toSkip;
+      }
+      if (atEnd) {
+        return;
+      }
+    }
+  }
+
+  /// Returns the next value. The value is valid until the next call.
+  folly::StringPiece readString() {
+    VELOX_CHECK_LT(index_, prefixLengths_.size(), "Reading past end of page");
+    auto prefixLength = prefixLengths_[index_++];
+    VELOX_CHECK_LE(prefixLength, lastValue_.size());
+    auto suffix = suffixDecoder_->readString();
+    lastValue_.resize(prefixLength);
+    lastValue_.append(suffix.data(), suffix.size());
+    return folly::StringPiece(lastValue_);
+  }
+
+ private:
+  std::vector<int32_t> prefixLengths_;
+  std::unique_ptr<DeltaLengthByteArrayDecoder> suffixDecoder_;
+  int32_t index_{0};
+  std::string lastValue_;
+};
+
+} // namespace facebook::velox::parquet
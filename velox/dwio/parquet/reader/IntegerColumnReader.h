@@ -64,14 +64,91 @@ class IntegerColumnReader : public dwio::common::SelectiveIntegerColumnReader {
         offset,
         rows,
         nullptr);
+    readDictionaryIds_ = canReadDictionaryIds();
+    data.setReadDictionaryIds(readDictionaryIds_);
     readCommon<IntegerColumnReader>(rows);
     readOffset_ += rows.back() + 1;
   }
 
+  void getValues(RowSet rows, VectorPtr* result) override {
+    if (readDictionaryIds_ && scanState_.dictionary.values) {
+      if (fileType_->type()->kind() == TypeKind::INTEGER) {
+        getDictionaryValues<int32_t>(rows, result);
+      } else {
+        getDictionaryValues<int64_t>(rows, result);
+      }
+      return;
+    }
+    SelectiveIntegerColumnReader::getValues(rows, result);
+  }
+
+  // Called when a page without dictionary follows dictionary pages in the
+  // same read. Replaces the dictionary indices read so far with values.
+  void dedictionarize() override {
+    if (!readDictionaryIds_) {
+      return;
+    }
+    if (fileType_->type()->kind() == TypeKind::INTEGER) {
+      dedictionarizeIds<int32_t>();
+    } else {
+      dedictionarizeIds<int64_t>();
+    }
+    scanState_.clear();
+    formatData_->as<ParquetData>().clearDictionary();
+  }
+
   template <typename ColumnVisitor>
   void readWithVisitor(RowSet rows, ColumnVisitor visitor) {
     formatData_->as<ParquetData>().readWithVisitor(visitor);
   }
+
+ private:
+  // True if dictionary encoded pages can be returned as a DictionaryVector
+  // over the column chunk dictionary. This is the case for unfiltered INTEGER
+  // and BIGINT columns read into the result without type conversion. Filtered
+  // columns keep translating indices in the visitor.
+  bool canReadDictionaryIds() const {
+    auto kind = fileType_->type()->kind();
+    return !scanSpec_->filter() && scanSpec_->keepValues() &&
+        !scanSpec_->valueHook() &&
+        (kind == TypeKind::INTEGER || kind == TypeKind::BIGINT) &&
+        requestedType_->kind() == kind &&
+        !fileType_->type()->isShortDecimal();
+  }
+
+  template <typename T>
+  void getDictionaryValues(RowSet rows, VectorPtr* result) {
+    auto dictionaryValues =
+        formatData_->as<ParquetData>().dictionaryValues(requestedType_);
+    compactScalarValues<int32_t, int32_t>(rows, false);
+    *result = std::make_shared<DictionaryVector<T>>(
+        &memoryPool_,
+        !anyNulls_               ? nullptr
+            : returnReaderNulls_ ? nullsInReadRange_
+                                 : resultNulls_,
+        numValues_,
+        dictionaryValues,
+        values_);
+  }
+
+  template <typename T>
+  void dedictionarizeIds() {
+    auto dictionary = scanState_.dictionary.values->as<T>();
+    auto indices = values_->as<int32_t>();
+    auto values = values_->asMutable<T>();
+    // Loop from end to beginning so as not to overwrite 32 bit indices with
+    // wider values.
+    for (auto i = numValues_ - 1; i >= 0; --i) {
+      if (anyNulls_ && bits::isBitNull(rawResultNulls_, i)) {
+        values[i] = 0;
+        continue;
+      }
+      values[i] = dictionary[indices[i]];
+    }
+  }
+
+  // True if the current read puts dictionary indices in 'values_'.
+  bool readDictionaryIds_{false};
 };
 
 } // namespace facebook::velox::parquet
@@ -17,6 +17,7 @@
 #include "velox/dwio/parquet/reader/NestedStructureDecoder.h"
 
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/dwio/common/BufferUtil.h"
 
 namespace facebook::velox::parquet {
@@ -80,4 +81,92 @@ int64_t NestedStructureDecoder::readOffsetsAndNulls(
   return outputIndex;
 }
 
+namespace {
+// Sets 'starts' and 'elements' to the bit masks of list starts and list
+// elements for the 64 or fewer levels at 'definitionLevels' and
+// 'repetitionLevels'.
+void levelMasks(
+    const int16_t* definitionLevels,
+    const int16_t* repetitionLevels,
+    int32_t numLevels,
+    int16_t elementDefinition,
+    uint64_t& starts,
+    uint64_t& elements) {
+  constexpr int32_t kWidth = xsimd::batch<int16_t>::size;
+  starts = 0;
+  elements = 0;
+  int32_t i = 0;
+  if (numLevels == 64) {
+    auto minDefinition = xsimd::broadcast<int16_t>(elementDefinition);
+    auto zero = xsimd::broadcast<int16_t>(0);
+    auto one = xsimd::broadcast<int16_t>(1);
+    for (; i < 64; i += kWidth) {
+      auto definition = xsimd::load_unaligned(definitionLevels + i);
+      auto repetition = xsimd::load_unaligned(repetitionLevels + i);
+      starts |= static_cast<uint64_t>(simd::toBitMask(repetition == zero))
+          << i;
+      elements |= static_cast<uint64_t>(simd::toBitMask(
+                      (repetition <= one) & (definition >= minDefinition)))
+          << i;
+    }
+    return;
+  }
+  for (; i < numLevels; ++i) {
+    starts |= static_cast<uint64_t>(repetitionLevels[i] == 0) << i;
+    elements |= static_cast<uint64_t>(
+                    repetitionLevels[i] <= 1 &&
+                    definitionLevels[i] >= elementDefinition)
+        << i;
+  }
+}
+} // namespace
+
+// static
+int32_t NestedStructureDecoder::readTopLevelLengthsAndNulls(
+    const int16_t* definitionLevels,
+    const int16_t* repetitionLevels,
+    int32_t numLevels,
+    int16_t elementDefinition,
+    int32_t* lengths,
+    uint64_t* nulls,
+    int32_t nullsStartIndex,
+    int32_t maxItems) {
+  int32_t numLists = 0;
+  for (int32_t begin = 0; begin < numLevels; begin += 64) {
+    auto numInWord = std::min<int32_t>(64, numLevels - begin);
+    uint64_t starts;
+    uint64_t elements;
+    levelMasks(
+        definitionLevels + begin,
+        repetitionLevels + begin,
+        numInWord,
+        elementDefinition,
+        starts,
+        elements);
+    while (starts) {
+      auto bit = __builtin_ctzll(starts);
+      auto before = bits::lowMask(bit);
+      // The elements before the start belong to the previous list. Elements
+      // before the first start of the range belong to no list.
+      if (numLists > 0) {
+        lengths[numLists - 1] += __builtin_popcountll(elements & before);
+      }
+      elements &= ~before;
+      starts &= starts - 1;
+      VELOX_CHECK_LT(
+          numLists, maxItems, "Definition levels exceeded upper bound");
+      lengths[numLists] = 0;
+      bits::setBit(
+          nulls,
+          nullsStartIndex + numLists,
+          definitionLevels[begin + bit] >= elementDefinition - 1);
+      ++numLists;
+    }
+    if (numLists > 0) {
+      lengths[numLists - 1] += __builtin_popcountll(elements);
+    }
+  }
+  return numLists;
+}
+
 } // namespace facebook::velox::parquet
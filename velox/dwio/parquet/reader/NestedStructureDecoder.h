@@ -60,6 +60,34 @@ class NestedStructureDecoder {
       BufferPtr& nullsBuffer,
       memory::MemoryPool& pool);
 
+  /// Computes the lengths and nulls of a top level ARRAY or MAP, i.e. one with
+  /// repetition level 1 and no repeated ancestor, from int16_t leaf levels.
+  /// This is the same as ::parquet::internal::DefRepLevelsToList() for such
+  /// a level but compares 'definitionLevels' and 'repetitionLevels' a SIMD
+  /// vector at a time into bit masks and counts list elements with popcount.
+  ///
+  /// A level with repetition 0 starts a list. The list is null if its
+  /// definition level is below 'elementDefinition' - 1. A level with
+  /// repetition 0 or 1 and definition at least 'elementDefinition' is an
+  /// element of the current list. Deeper levels are not counted.
+  ///
+  /// @param elementDefinition The definition level at which a list element is
+  /// present.
+  /// @param lengths The output element counts, one per list.
+  /// @param nulls The output null flags, one per list, starting at bit
+  /// 'nullsStartIndex'.
+  /// @param maxItems Maximum number of lists expected.
+  /// @return The number of lists.
+  static int32_t readTopLevelLengthsAndNulls(
+      const int16_t* definitionLevels,
+      const int16_t* repetitionLevels,
+      int32_t numLevels,
+      int16_t elementDefinition,
+      int32_t* lengths,
+      uint64_t* nulls,
+      int32_t nullsStartIndex,
+      int32_t maxItems);
+
  private:
   NestedStructureDecoder() {}
 };
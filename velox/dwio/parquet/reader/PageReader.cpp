@@ -18,7 +18,11 @@
 #include "velox/common/compression/LzoDecompressor.h"
 #include "velox/dwio/common/BufferUtil.h"
 #include "velox/dwio/common/ColumnVisitors.h"
+#include "velox/dwio/common/ScanSpec.h"
+#include "velox/dwio/common/compression/AsyncDecompressor.h"
+#include "velox/dwio/parquet/reader/ByteStreamSplit.h"
 #include "velox/dwio/parquet/reader/NestedStructureDecoder.h"
+#include "velox/dwio/parquet/reader/Statistics.h"
 #include "velox/dwio/parquet/thrift/ThriftTransport.h"
 #include "velox/vector/FlatVector.h"
 
@@ -33,7 +37,18 @@ namespace facebook::velox::parquet {
 using thrift::Encoding;
 using thrift::PageHeader;
 
+PageReader::~PageReader() {
+  if (pendingDecompression_.has_value()) {
+    // The decompression writes to 'decompressedPages_' and reads the input.
+    std::move(*pendingDecompression_).wait();
+  }
+}
+
 void PageReader::seekToPage(int64_t row) {
+  if (!decompressAheadChecked_) {
+    decompressAheadChecked_ = true;
+    decompressPagesAhead();
+  }
   defineDecoder_.reset();
   repeatDecoder_.reset();
   // 'rowOfPage_' is the row number of the first row of the next page.
@@ -221,10 +236,124 @@ const char* FOLLY_NONNULL decompressLz4AndLzo(
   return uncompressedData->as<char>();
 }
 
+namespace {
+std::optional<common::CompressionKind> toCompressionKind(
+    thrift::CompressionCodec::type codec) {
+  switch (codec) {
+    case thrift::CompressionCodec::SNAPPY:
+      return common::CompressionKind_SNAPPY;
+    case thrift::CompressionCodec::ZSTD:
+      return common::CompressionKind_ZSTD;
+    case thrift::CompressionCodec::GZIP:
+      return common::CompressionKind_GZIP;
+    default:
+      return std::nullopt;
+  }
+}
+
+// True if the data after the levels of a DATA_PAGE_V2 is compressed. Matches
+// the check in prepareDataPageV2().
+bool isV2DataCompressed(const PageHeader& pageHeader) {
+  return pageHeader.data_page_header_v2.__isset.is_compressed ||
+      pageHeader.data_page_header_v2.is_compressed;
+}
+} // namespace
+
+void PageReader::decompressPagesAhead() {
+  auto decompressor = dwio::common::compression::asyncDecompressor();
+  auto kind = toCompressionKind(codec_);
+  if (!decompressor || !kind.has_value() || !decompressor->supports(*kind)) {
+    return;
+  }
+  if (bufferEnd_ == bufferStart_) {
+    const void* buffer;
+    int32_t size;
+    if (!inputStream_->Next(&buffer, &size)) {
+      return;
+    }
+    bufferStart_ = reinterpret_cast<const char*>(buffer);
+    bufferEnd_ = bufferStart_ + size;
+  }
+  if (bufferEnd_ - bufferStart_ < chunkSize_ - pageStart_) {
+    // The pages would have to be copied out of several buffers.
+    return;
+  }
+  std::vector<dwio::common::compression::DecompressionRequest> requests;
+  auto position = bufferStart_;
+  auto end = bufferStart_ + (chunkSize_ - pageStart_);
+  while (position < end) {
+    auto transport = std::make_shared<thrift::ThriftBufferedTransport>(
+        position, end - position);
+    apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport>
+        protocol(transport);
+    PageHeader pageHeader;
+    pageHeader.read(&protocol);
+    auto data = position + transport->offset();
+    position = data + pageHeader.compressed_page_size;
+    uint32_t levelsSize = 0;
+    switch (pageHeader.type) {
+      case thrift::PageType::DATA_PAGE:
+      case thrift::PageType::DICTIONARY_PAGE:
+        break;
+      case thrift::PageType::DATA_PAGE_V2:
+        if (!isV2DataCompressed(pageHeader)) {
+          continue;
+        }
+        levelsSize = (maxDefine_ > 0
+                          ? pageHeader.data_page_header_v2
+                                .definition_levels_byte_length
+                          : 0) +
+            (maxRepeat_ > 0
+                 ? pageHeader.data_page_header_v2.repetition_levels_byte_length
+                 : 0);
+        break;
+      default:
+        continue;
+    }
+    auto uncompressedSize = pageHeader.uncompressed_page_size - levelsSize;
+    auto buffer = AlignedBuffer::allocate<char>(uncompressedSize, &pool_);
+    requests.push_back(
+        {*kind,
+         data + levelsSize,
+         static_cast<uint64_t>(pageHeader.compressed_page_size - levelsSize),
+         buffer->asMutable<char>(),
+         static_cast<uint64_t>(uncompressedSize)});
+    expectedDecompressedSizes_.push_back(uncompressedSize);
+    decompressedPages_[data + levelsSize] = std::move(buffer);
+  }
+  if (!requests.empty()) {
+    pendingDecompression_ = decompressor->decompress(std::move(requests));
+  }
+}
+
+void PageReader::waitForDecompression() {
+  if (!pendingDecompression_.has_value()) {
+    return;
+  }
+  auto sizes = std::move(*pendingDecompression_).get();
+  pendingDecompression_.reset();
+  VELOX_CHECK_EQ(sizes.size(), expectedDecompressedSizes_.size());
+  for (auto i = 0; i < sizes.size(); ++i) {
+    VELOX_CHECK_EQ(
+        sizes[i],
+        expectedDecompressedSizes_[i],
+        "Decompressed page size does not match the page header");
+  }
+}
+
 const char* FOLLY_NONNULL PageReader::uncompressData(
     const char* pageData,
     uint32_t compressedSize,
     uint32_t uncompressedSize) {
+  if (!decompressedPages_.empty()) {
+    auto it = decompressedPages_.find(pageData);
+    if (it != decompressedPages_.end()) {
+      waitForDecompression();
+      uncompressedData_ = std::move(it->second);
+      decompressedPages_.erase(it);
+      return uncompressedData_->as<char>();
+    }
+  }
   switch (codec_) {
     case thrift::CompressionCodec::UNCOMPRESSED:
       return pageData;
@@ -465,6 +594,34 @@ void PageReader::prepareDataPageV2(const PageHeader& pageHeader, int64_t row) {
   }
 }
 
+namespace {
+// Converts 'numValues' big endian two's complement decimals of 'typeLength'
+// bytes at 'source' to native T at 'values'. 'source' and 'values' may be the
+// same address: the values are converted from the end so that a value is
+// widened only after the values after it have been moved.
+template <typename T>
+void bigEndianDecimalsToNative(
+    const char* source,
+    int32_t typeLength,
+    int32_t numValues,
+    T* values) {
+  VELOX_CHECK_LE(typeLength, sizeof(T));
+  for (auto i = numValues - 1; i >= 0; --i) {
+    auto sourceValue = source + i * typeLength;
+    T value = static_cast<int8_t>(*sourceValue) >= 0 ? 0 : -1;
+    memcpy(
+        reinterpret_cast<char*>(&value) + sizeof(T) - typeLength,
+        sourceValue,
+        typeLength);
+    if constexpr (std::is_same_v<T, int128_t>) {
+      values[i] = bits::builtin_bswap128(value);
+    } else {
+      values[i] = __builtin_bswap64(value);
+    }
+  }
+}
+} // namespace
+
 void PageReader::prepareDictionary(const PageHeader& pageHeader) {
   dictionary_.numValues = pageHeader.dictionary_page_header.num_values;
   dictionaryEncoding_ = pageHeader.dictionary_page_header.encoding;
@@ -565,50 +722,18 @@ void PageReader::prepareDictionary(const PageHeader& pageHeader) {
             bufferEnd_);
       }
       if (type_->type()->isShortDecimal()) {
-        // Parquet decimal values have a fixed typeLength_ and are in big-endian
-        // layout.
-        if (numParquetBytes < numVeloxBytes) {
-          auto values = dictionary_.values->asMutable<int64_t>();
-          for (auto i = dictionary_.numValues - 1; i >= 0; --i) {
-            // Expand the Parquet type length values to Velox type length.
-            // We start from the end to allow in-place expansion.
-            auto sourceValue = data + (i * parquetTypeLength);
-            int64_t value = *sourceValue >= 0 ? 0 : -1;
-            memcpy(
-                reinterpret_cast<uint8_t*>(&value) + veloxTypeLength -
-                    parquetTypeLength,
-                sourceValue,
-                parquetTypeLength);
-            values[i] = value;
-          }
-        }
-        auto values = dictionary_.values->asMutable<int64_t>();
-        for (auto i = 0; i < dictionary_.numValues; ++i) {
-          values[i] = __builtin_bswap64(values[i]);
-        }
+        bigEndianDecimalsToNative(
+            data,
+            parquetTypeLength,
+            dictionary_.numValues,
+            dictionary_.values->asMutable<int64_t>());
         break;
       } else if (type_->type()->isLongDecimal()) {
-        // Parquet decimal values have a fixed typeLength_ and are in big-endian
-        // layout.
-        if (numParquetBytes < numVeloxBytes) {
-          auto values = dictionary_.values->asMutable<int128_t>();
-          for (auto i = dictionary_.numValues - 1; i >= 0; --i) {
-            // Expand the Parquet type length values to Velox type length.
-            // We start from the end to allow in-place expansion.
-            auto sourceValue = data + (i * parquetTypeLength);
-            int128_t value = *sourceValue >= 0 ? 0 : -1;
-            memcpy(
-                reinterpret_cast<uint8_t*>(&value) + veloxTypeLength -
-                    parquetTypeLength,
-                sourceValue,
-                parquetTypeLength);
-            values[i] = value;
-          }
-        }
-        auto values = dictionary_.values->asMutable<int128_t>();
-        for (auto i = 0; i < dictionary_.numValues; ++i) {
-          values[i] = bits::builtin_bswap128(values[i]);
-        }
+        bigEndianDecimalsToNative(
+            data,
+            parquetTypeLength,
+            dictionary_.numValues,
+            dictionary_.values->asMutable<int128_t>());
         break;
       }
       VELOX_UNSUPPORTED(
@@ -732,6 +857,20 @@ int32_t PageReader::getLengthsAndNulls(
           definitionLevels_.data() + begin, end - begin, info, &bits);
       break;
     case LevelMode::kList: {
+      if (info.rep_level == 1 && info.repeated_ancestor_def_level == 0 &&
+          info.null_slot_usage == 1) {
+        // Top level list or map. Use the vectorized decoding that produces
+        // lengths directly.
+        return NestedStructureDecoder::readTopLevelLengthsAndNulls(
+            definitionLevels_.data() + begin,
+            repetitionLevels_.data() + begin,
+            end - begin,
+            info.def_level,
+            lengths,
+            nulls,
+            nullsStartIndex,
+            maxItems);
+      }
       ::parquet::internal::DefRepLevelsToList(
           definitionLevels_.data() + begin,
           repetitionLevels_.data() + begin,
@@ -760,6 +899,11 @@ int32_t PageReader::getLengthsAndNulls(
 
 void PageReader::makeDecoder() {
   auto parquetType = type_->parquetType_.value();
+  deltaBpDecoder_.reset();
+  deltaLengthByteArrayDecoder_.reset();
+  deltaByteArrayDecoder_.reset();
+  directValues_.reset();
+  nativeShortDecimals_ = false;
   switch (encoding_) {
     case Encoding::RLE_DICTIONARY:
     case Encoding::PLAIN_DICTIONARY:
@@ -777,12 +921,17 @@ void PageReader::makeDecoder() {
               pageData_, pageData_ + encodedDataSize_);
           break;
         case thrift::Type::FIXED_LEN_BYTE_ARRAY:
-          directDecoder_ = std::make_unique<dwio::common::DirectDecoder<true>>(
-              std::make_unique<dwio::common::SeekableArrayInputStream>(
-                  pageData_, encodedDataSize_),
-              false,
-              type_->typeLength_,
-              true);
+          if (type_->type()->isShortDecimal()) {
+            makeNativeShortDecimalDecoder();
+          } else {
+            directDecoder_ =
+                std::make_unique<dwio::common::DirectDecoder<true>>(
+                    std::make_unique<dwio::common::SeekableArrayInputStream>(
+                        pageData_, encodedDataSize_),
+                    false,
+                    type_->typeLength_,
+                    true);
+          }
           break;
         default: {
           directDecoder_ = std::make_unique<dwio::common::DirectDecoder<true>>(
@@ -793,12 +942,71 @@ void PageReader::makeDecoder() {
         }
       }
       break;
+    case Encoding::BYTE_STREAM_SPLIT: {
+      VELOX_CHECK(
+          parquetType == thrift::Type::FLOAT ||
+              parquetType == thrift::Type::DOUBLE,
+          "BYTE_STREAM_SPLIT is only supported for FLOAT and DOUBLE");
+      // The values are interleaved back into one buffer for the PLAIN
+      // decoder, which then runs with all its fast paths.
+      auto width = parquetTypeBytes(parquetType);
+      directValues_ = AlignedBuffer::allocate<char>(encodedDataSize_, &pool_);
+      decodeByteStreamSplit(
+          pageData_,
+          encodedDataSize_,
+          width,
+          directValues_->asMutable<char>());
+      directDecoder_ = std::make_unique<dwio::common::DirectDecoder<true>>(
+          std::make_unique<dwio::common::SeekableArrayInputStream>(
+              directValues_->as<char>(), encodedDataSize_),
+          false,
+          width);
+      break;
+    }
     case Encoding::DELTA_BINARY_PACKED:
+      VELOX_CHECK(
+          parquetType == thrift::Type::INT32 ||
+              parquetType == thrift::Type::INT64,
+          "DELTA_BINARY_PACKED is only valid for INT32 and INT64");
+      deltaBpDecoder_ = std::make_unique<DeltaBpDecoder>(
+          pageData_,
+          pageData_ + encodedDataSize_,
+          parquetType == thrift::Type::INT32);
+      break;
+    case Encoding::DELTA_LENGTH_BYTE_ARRAY:
+      VELOX_CHECK(
+          parquetType == thrift::Type::BYTE_ARRAY,
+          "DELTA_LENGTH_BYTE_ARRAY is only valid for BYTE_ARRAY");
+      deltaLengthByteArrayDecoder_ =
+          std::make_unique<DeltaLengthByteArrayDecoder>(
+              pageData_, pageData_ + encodedDataSize_);
+      break;
+    case Encoding::DELTA_BYTE_ARRAY:
+      VELOX_CHECK(
+          parquetType == thrift::Type::BYTE_ARRAY,
+          "DELTA_BYTE_ARRAY is only valid for BYTE_ARRAY");
+      deltaByteArrayDecoder_ = std::make_unique<DeltaByteArrayDecoder>(
+          pageData_, pageData_ + encodedDataSize_);
+      break;
     default:
       VELOX_UNSUPPORTED("Encoding not supported yet");
   }
 }
 
+void PageReader::makeNativeShortDecimalDecoder() {
+  auto typeLength = type_->typeLength_;
+  auto numValues = encodedDataSize_ / typeLength;
+  directValues_ = AlignedBuffer::allocate<int64_t>(numValues, &pool_);
+  bigEndianDecimalsToNative(
+      pageData_, typeLength, numValues, directValues_->asMutable<int64_t>());
+  directDecoder_ = std::make_unique<dwio::common::DirectDecoder<true>>(
+      std::make_unique<dwio::common::SeekableArrayInputStream>(
+          directValues_->as<char>(), numValues * sizeof(int64_t)),
+      false,
+      sizeof(int64_t));
+  nativeShortDecimals_ = true;
+}
+
 void PageReader::skip(int64_t numRows) {
   if (!numRows && firstUnvisited_ != rowOfPage_ + numRowsInPage_) {
     // Return if no skip and position not at end of page or before first page.
@@ -820,6 +1028,12 @@ void PageReader::skip(int64_t numRows) {
   // Skip the decoder
   if (isDictionary()) {
     dictionaryIdDecoder_->skip(toSkip);
+  } else if (deltaBpDecoder_) {
+    deltaBpDecoder_->skip(toSkip);
+  } else if (deltaLengthByteArrayDecoder_) {
+    deltaLengthByteArrayDecoder_->skip(toSkip);
+  } else if (deltaByteArrayDecoder_) {
+    deltaByteArrayDecoder_->skip(toSkip);
   } else if (directDecoder_) {
     directDecoder_->skip(toSkip);
   } else if (stringDecoder_) {
@@ -930,6 +1144,9 @@ bool PageReader::rowsForPage(
     bool mayProduceNulls,
     folly::Range<const vector_size_t*>& rows,
     const uint64_t* FOLLY_NULLABLE& nulls) {
+  if (hasFilter && columnIndex_) {
+    skipPagesNotMatching(*reader.scanSpec()->filter());
+  }
   if (currentVisitorRow_ == numVisitorRows_) {
     return false;
   }
@@ -1024,15 +1241,115 @@ bool PageReader::rowsForPage(
   return true;
 }
 
+void PageReader::setPageIndex(
+    thrift::ColumnIndex columnIndex,
+    thrift::OffsetIndex offsetIndex,
+    int64_t numRowsInChunk) {
+  if (!isTopLevel_ || offsetIndex.page_locations.empty() ||
+      columnIndex.null_pages.size() != offsetIndex.page_locations.size()) {
+    return;
+  }
+  columnIndex_ = std::make_unique<thrift::ColumnIndex>(std::move(columnIndex));
+  offsetIndex_ = std::make_unique<thrift::OffsetIndex>(std::move(offsetIndex));
+  numRowsInChunk_ = numRowsInChunk;
+  pageFilter_ = nullptr;
+}
+
+void PageReader::skipPagesNotMatching(common::Filter& filter) {
+  auto& locations = offsetIndex_->page_locations;
+  while (currentVisitorRow_ < numVisitorRows_) {
+    auto row = visitBase_ + visitorRows_[currentVisitorRow_];
+    if (row < rowOfPage_ + numRowsInPage_) {
+      // The current page is already decompressed.
+      return;
+    }
+    auto it = std::upper_bound(
+        locations.begin(),
+        locations.end(),
+        row,
+        [](int64_t value, const thrift::PageLocation& location) {
+          return value < location.first_row_index;
+        });
+    VELOX_CHECK(it != locations.begin());
+    int32_t page = it - locations.begin() - 1;
+    if (pageMayMatch(page, filter)) {
+      return;
+    }
+    int64_t endRow =
+        it == locations.end() ? numRowsInChunk_ : it->first_row_index;
+    auto begin = visitorRows_ + currentVisitorRow_;
+    auto end = visitorRows_ + numVisitorRows_;
+    auto next = std::lower_bound(begin, end, endRow - visitBase_);
+    currentVisitorRow_ = next - visitorRows_;
+    firstUnvisited_ = visitBase_ + next[-1] + 1;
+  }
+}
+
+bool PageReader::pageMayMatch(int32_t page, common::Filter& filter) {
+  if (pageFilter_ != &filter) {
+    pageFilter_ = &filter;
+    pageMatches_.assign(columnIndex_->null_pages.size(), -1);
+  }
+  if (pageMatches_[page] != -1) {
+    return pageMatches_[page];
+  }
+  auto& locations = offsetIndex_->page_locations;
+  int64_t numRows =
+      (page + 1 < locations.size() ? locations[page + 1].first_row_index
+                                   : numRowsInChunk_) -
+      locations[page].first_row_index;
+  thrift::Statistics stats;
+  if (columnIndex_->null_pages[page]) {
+    stats.__set_null_count(numRows);
+  } else {
+    stats.__set_min_value(columnIndex_->min_values[page]);
+    stats.__set_max_value(columnIndex_->max_values[page]);
+    if (columnIndex_->__isset.null_counts) {
+      stats.__set_null_count(columnIndex_->null_counts[page]);
+    }
+  }
+  auto columnStats =
+      buildColumnStatisticsFromThrift(stats, *type_->type(), numRows);
+  pageMatches_[page] =
+      testFilter(&filter, columnStats.get(), numRows, type_->type());
+  return pageMatches_[page];
+}
+
 const VectorPtr& PageReader::dictionaryValues(const TypePtr& type) {
   if (!dictionaryValues_) {
-    dictionaryValues_ = std::make_shared<FlatVector<StringView>>(
-        &pool_,
-        type,
-        nullptr,
-        dictionary_.numValues,
-        dictionary_.values,
-        std::vector<BufferPtr>{dictionary_.strings});
+    switch (type->kind()) {
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        dictionaryValues_ = std::make_shared<FlatVector<StringView>>(
+            &pool_,
+            type,
+            nullptr,
+            dictionary_.numValues,
+            dictionary_.values,
+            std::vector<BufferPtr>{dictionary_.strings});
+        break;
+      case TypeKind::INTEGER:
+        dictionaryValues_ = std::make_shared<FlatVector<int32_t>>(
+            &pool_,
+            type,
+            nullptr,
+            dictionary_.numValues,
+            dictionary_.values,
+            std::vector<BufferPtr>{});
+        break;
+      case TypeKind::BIGINT:
+        dictionaryValues_ = std::make_shared<FlatVector<int64_t>>(
+            &pool_,
+            type,
+            nullptr,
+            dictionary_.numValues,
+            dictionary_.values,
+            std::vector<BufferPtr>{});
+        break;
+      default:
+        VELOX_UNSUPPORTED(
+            "Dictionary values are not supported for {}", type->toString());
+    }
   }
   return dictionaryValues_;
 }
@@ -17,10 +17,14 @@
 #pragma once
 
 #include <arrow/util/rle_encoding.h>
+#include <folly/container/F14Map.h>
+#include <folly/futures/Future.h>
 #include "velox/dwio/common/BitConcatenation.h"
 #include "velox/dwio/common/DirectDecoder.h"
 #include "velox/dwio/common/SelectiveColumnReader.h"
 #include "velox/dwio/parquet/reader/BooleanDecoder.h"
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
+#include "velox/dwio/parquet/reader/DeltaByteArrayDecoder.h"
 #include "velox/dwio/parquet/reader/ParquetTypeWithId.h"
 #include "velox/dwio/parquet/reader/RleBpDataDecoder.h"
 #include "velox/dwio/parquet/reader/StringDecoder.h"
@@ -66,6 +70,8 @@ class PageReader {
         chunkSize_(chunkSize),
         nullConcatenation_(pool_) {}
 
+  ~PageReader();
+
   /// Advances 'numRows' top level rows.
   void skip(int64_t numRows);
 
@@ -106,9 +112,26 @@ class PageReader {
   /// are no nulls, buffer may be set to nullptr.
   void readNullsOnly(int64_t numValues, BufferPtr& buffer);
 
-  // Returns the current string dictionary as a FlatVector<StringView>.
+  // Returns the current dictionary as a FlatVector of 'type'. 'type' is
+  // VARCHAR, VARBINARY, INTEGER or BIGINT.
   const VectorPtr& dictionaryValues(const TypePtr& type);
 
+  /// If true, a read without filter of an INTEGER or BIGINT column puts the
+  /// dictionary indices of dictionary encoded pages in the reader instead of
+  /// the values, so that the reader can return a DictionaryVector.
+  void setReadDictionaryIds(bool readDictionaryIds) {
+    readDictionaryIds_ = readDictionaryIds;
+  }
+
+  /// Sets the page index of the column chunk. A read with a filter then
+  /// skips the pages whose statistics fail the filter without decompressing
+  /// them. Ignored for non-top level columns. 'numRowsInChunk' is the row
+  /// count of the row group.
+  void setPageIndex(
+      thrift::ColumnIndex columnIndex,
+      thrift::OffsetIndex offsetIndex,
+      int64_t numRowsInChunk);
+
   // True if the current page holds dictionary indices.
   bool isDictionary() const {
     return encoding_ == thrift::Encoding::PLAIN_DICTIONARY ||
@@ -148,6 +171,15 @@ class PageReader {
   // current page.
   int32_t skipNulls(int32_t numRows);
 
+  // Advances past the rows to visit that are on pages after the current one
+  // whose page index statistics fail 'filter'. These rows fail the filter
+  // and are not decoded.
+  void skipPagesNotMatching(common::Filter& filter);
+
+  // True if the 'page'th page of the chunk may have values that pass
+  // 'filter' according to the page index.
+  bool pageMayMatch(int32_t page, common::Filter& filter);
+
   // Initializes a filter result cache for the dictionary in 'state'.
   void makeFilterCache(dwio::common::ScanState& state);
 
@@ -186,6 +218,10 @@ class PageReader {
   void prepareDictionary(const thrift::PageHeader& pageHeader);
   void makeDecoder();
 
+  // Converts the big endian FIXED_LEN_BYTE_ARRAY short decimals of the page
+  // to int64_t in 'directValues_' and makes 'directDecoder_' over them.
+  void makeNativeShortDecimalDecoder();
+
   // For a non-top level leaf, reads the defs and sets 'leafNulls_' and
   // 'numRowsInPage_' accordingly. This is used for non-top level leaves when
   // 'hasChunkRepDefs_' is false.
@@ -204,6 +240,15 @@ class PageReader {
       uint32_t compressedSize,
       uint32_t uncompressedSize);
 
+  // If an AsyncDecompressor is set and supports 'codec_' and the rest of the
+  // column chunk is in the current buffer, submits all its compressed pages
+  // for decompression into 'decompressedPages_'. uncompressData() then waits
+  // for the batch instead of decompressing each page.
+  void decompressPagesAhead();
+
+  // Waits for the decompression started by decompressPagesAhead().
+  void waitForDecompression();
+
   template <typename T>
   T readField(const char* FOLLY_NONNULL& ptr) {
     T data = *reinterpret_cast<const T*>(ptr);
@@ -252,12 +297,28 @@ class PageReader {
       const uint64_t* FOLLY_NULLABLE nulls,
       bool& nullsFromFastPath,
       Visitor visitor) {
+    if (deltaBpDecoder_) {
+      nullsFromFastPath = false;
+      if (nulls) {
+        deltaBpDecoder_->readWithVisitor<true>(nulls, visitor);
+      } else {
+        deltaBpDecoder_->readWithVisitor<false>(nulls, visitor);
+      }
+      return;
+    }
     if (nulls) {
       nullsFromFastPath = dwio::common::useFastPath<Visitor, true>(visitor) &&
           (!this->type_->type()->isLongDecimal()) &&
-          (this->type_->type()->isShortDecimal() ? isDictionary() : true);
+          (this->type_->type()->isShortDecimal()
+               ? isDictionary() || nativeShortDecimals_
+               : true);
 
       if (isDictionary()) {
+        if (readDictionaryIds(visitor)) {
+          auto idVisitor = visitor.toStringDictionaryColumnVisitor();
+          dictionaryIdDecoder_->readWithVisitor<true>(nulls, idVisitor);
+          return;
+        }
         auto dictVisitor = visitor.toDictionaryColumnVisitor();
         dictionaryIdDecoder_->readWithVisitor<true>(nulls, dictVisitor);
       } else {
@@ -266,11 +327,18 @@ class PageReader {
       }
     } else {
       if (isDictionary()) {
+        if (readDictionaryIds(visitor)) {
+          auto idVisitor = visitor.toStringDictionaryColumnVisitor();
+          dictionaryIdDecoder_->readWithVisitor<false>(nullptr, idVisitor);
+          return;
+        }
         auto dictVisitor = visitor.toDictionaryColumnVisitor();
         dictionaryIdDecoder_->readWithVisitor<false>(nullptr, dictVisitor);
       } else {
         directDecoder_->readWithVisitor<false>(
-            nulls, visitor, !this->type_->type()->isShortDecimal());
+            nulls,
+            visitor,
+            !this->type_->type()->isShortDecimal() || nativeShortDecimals_);
       }
     }
   }
@@ -284,6 +352,16 @@ class PageReader {
       const uint64_t* FOLLY_NULLABLE nulls,
       bool& nullsFromFastPath,
       Visitor visitor) {
+    if (deltaLengthByteArrayDecoder_) {
+      nullsFromFastPath = false;
+      callStringDecoder(*deltaLengthByteArrayDecoder_, nulls, visitor);
+      return;
+    }
+    if (deltaByteArrayDecoder_) {
+      nullsFromFastPath = false;
+      callStringDecoder(*deltaByteArrayDecoder_, nulls, visitor);
+      return;
+    }
     if (nulls) {
       if (isDictionary()) {
         nullsFromFastPath = dwio::common::useFastPath<Visitor, true>(visitor);
@@ -303,6 +381,36 @@ class PageReader {
     }
   }
 
+  // True if 'visitor' should get dictionary indices instead of values. The id
+  // visitor is instantiated only for unfiltered 32 and 64 bit integer reads
+  // into the reader.
+  template <typename Visitor>
+  bool readDictionaryIds(Visitor& /*visitor*/) const {
+    if constexpr (
+        std::is_same_v<typename Visitor::FilterType, common::AlwaysTrue> &&
+        std::is_same_v<
+            typename Visitor::Extract,
+            dwio::common::ExtractToReader> &&
+        (std::is_same_v<typename Visitor::DataType, int32_t> ||
+         std::is_same_v<typename Visitor::DataType, int64_t>)) {
+      return readDictionaryIds_;
+    } else {
+      return false;
+    }
+  }
+
+  template <typename Decoder, typename Visitor>
+  void callStringDecoder(
+      Decoder& decoder,
+      const uint64_t* FOLLY_NULLABLE nulls,
+      Visitor& visitor) {
+    if (nulls) {
+      decoder.template readWithVisitor<true>(nulls, visitor);
+    } else {
+      decoder.template readWithVisitor<false>(nulls, visitor);
+    }
+  }
+
   template <
       typename Visitor,
       typename std::enable_if<
@@ -408,6 +516,20 @@ class PageReader {
   // Uncompressed data for the page. Rep-def-data in V1, data alone in V2.
   BufferPtr uncompressedData_;
 
+  // True after decompressPagesAhead() has been called for the chunk.
+  bool decompressAheadChecked_{false};
+
+  // Pages decompressed by decompressPagesAhead(), keyed on the first byte of
+  // their compressed data.
+  folly::F14FastMap<const char*, BufferPtr> decompressedPages_;
+
+  // Completes when all of 'decompressedPages_' are filled.
+  std::optional<folly::SemiFuture<std::vector<uint64_t>>>
+      pendingDecompression_;
+
+  // Expected uncompressed size of each request in 'pendingDecompression_'.
+  std::vector<uint64_t> expectedDecompressedSizes_;
+
   // First byte of uncompressed encoded data. Contains the encoded data as a
   // contiguous run of bytes.
   const char* FOLLY_NULLABLE pageData_{nullptr};
@@ -446,6 +568,16 @@ class PageReader {
   // Offset of 'visitorRows_[0]' relative too start of ColumnChunk.
   int64_t visitBase_{0};
 
+  // Page index of the column chunk, if set and the column is top level.
+  std::unique_ptr<thrift::ColumnIndex> columnIndex_;
+  std::unique_ptr<thrift::OffsetIndex> offsetIndex_;
+  int64_t numRowsInChunk_{0};
+
+  // Filter results of the pages in 'columnIndex_' for 'pageFilter_'. 1 for a
+  // possible match, 0 for no match, -1 if not tested.
+  common::Filter* FOLLY_NULLABLE pageFilter_{nullptr};
+  std::vector<int8_t> pageMatches_;
+
   //  Temporary for rewriting rows to access in readWithVisitor when moving
   //  between pages. Initialized from the visitor.
   raw_vector<vector_size_t>* FOLLY_NULLABLE rowsCopy_{nullptr};
@@ -464,14 +596,30 @@ class PageReader {
   // LevelInfo for reading nulls for the leaf column 'this' represents.
   ::parquet::internal::LevelInfo leafInfo_;
 
-  // Base values of dictionary when reading a string dictionary.
+  // Base values of dictionary when returning a DictionaryVector.
   VectorPtr dictionaryValues_;
 
+  // See setReadDictionaryIds().
+  bool readDictionaryIds_{false};
+
+  // Page values decoded ahead for 'directDecoder_'. Set for a
+  // BYTE_STREAM_SPLIT page or a FIXED_LEN_BYTE_ARRAY short decimal page.
+  BufferPtr directValues_;
+
+  // True if 'directDecoder_' reads short decimals as native int64_t, so that
+  // its fast path applies.
+  bool nativeShortDecimals_{false};
+
   // Decoders. Only one will be set at a time.
   std::unique_ptr<dwio::common::DirectDecoder<true>> directDecoder_;
   std::unique_ptr<RleBpDataDecoder> dictionaryIdDecoder_;
   std::unique_ptr<StringDecoder> stringDecoder_;
   std::unique_ptr<BooleanDecoder> booleanDecoder_;
+  // The delta decoders are reset for each page, a non-null one is the
+  // decoder of the current page.
+  std::unique_ptr<DeltaBpDecoder> deltaBpDecoder_;
+  std::unique_ptr<DeltaLengthByteArrayDecoder> deltaLengthByteArrayDecoder_;
+  std::unique_ptr<DeltaByteArrayDecoder> deltaByteArrayDecoder_;
   // Add decoders for other encodings here.
 };
 
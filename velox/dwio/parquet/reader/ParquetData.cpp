@@ -15,6 +15,8 @@
  */
 
 #include "velox/dwio/parquet/reader/ParquetData.h"
+#include "velox/dwio/common/StreamUtil.h"
+#include "velox/dwio/parquet/reader/BloomFilter.h"
 #include "velox/dwio/parquet/reader/Statistics.h"
 
 namespace facebook::velox::parquet {
@@ -23,10 +25,29 @@ using thrift::RowGroup;
 
 std::unique_ptr<dwio::common::FormatData> ParquetParams::toFormatData(
     const std::shared_ptr<const dwio::common::TypeWithId>& type,
-    const common::ScanSpec& /*scanSpec*/) {
-  return std::make_unique<ParquetData>(type, metaData_.row_groups, pool());
+    const common::ScanSpec& scanSpec) {
+  return std::make_unique<ParquetData>(
+      type, metaData_.row_groups, pool(), &scanSpec, input_);
 }
 
+namespace {
+// Reads 'size' bytes from 'stream' and deserializes them as a T.
+template <typename T>
+T readThrift(dwio::common::SeekableInputStream& stream, int64_t size) {
+  std::string data(size, '\0');
+  const char* bufferStart = nullptr;
+  const char* bufferEnd = nullptr;
+  dwio::common::readBytes(size, &stream, data.data(), bufferStart, bufferEnd);
+  std::shared_ptr<thrift::ThriftTransport> transport =
+      std::make_shared<thrift::ThriftBufferedTransport>(data.data(), size);
+  apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport> protocol(
+      transport);
+  T result;
+  result.read(&protocol);
+  return result;
+}
+} // namespace
+
 void ParquetData::filterRowGroups(
     const common::ScanSpec& scanSpec,
     uint64_t /*rowsPerRowGroup*/,
@@ -37,6 +58,9 @@ void ParquetData::filterRowGroups(
   if (result.filterResult.size() < nwords) {
     result.filterResult.resize(nwords);
   }
+  if (result.bloomFilterResult.size() < nwords) {
+    result.bloomFilterResult.resize(nwords);
+  }
   auto metadataFiltersStartIndex = result.metadataFilterResults.size();
   for (int i = 0; i < scanSpec.numMetadataFilters(); ++i) {
     result.metadataFilterResults.emplace_back(
@@ -47,6 +71,14 @@ void ParquetData::filterRowGroups(
       bits::setBit(result.filterResult.data(), i);
       continue;
     }
+    // The Bloom filter costs a read. Probe it only if no column before this
+    // has excluded the row group.
+    if (scanSpec.filter() && !bits::isBitSet(result.filterResult.data(), i) &&
+        !bloomFilterMatches(i, *scanSpec.filter())) {
+      bits::setBit(result.filterResult.data(), i);
+      bits::setBit(result.bloomFilterResult.data(), i);
+      continue;
+    }
     for (int j = 0; j < scanSpec.numMetadataFilters(); ++j) {
       auto* metadataFilter = scanSpec.metadataFilterAt(j);
       if (!rowGroupMatches(i, metadataFilter)) {
@@ -82,6 +114,26 @@ bool ParquetData::rowGroupMatches(
   return true;
 }
 
+bool ParquetData::bloomFilterMatches(
+    uint32_t rowGroupId,
+    const common::Filter& filter) {
+  if (!input_ || !type_->parquetType_.has_value() ||
+      !canUseBloomFilter(filter, type_->parquetType_.value())) {
+    return true;
+  }
+  auto& metaData = rowGroups_[rowGroupId].columns[type_->column()].meta_data;
+  if (!rowGroups_[rowGroupId].columns[type_->column()].__isset.meta_data ||
+      !metaData.__isset.bloom_filter_offset) {
+    return true;
+  }
+  auto bloomFilter =
+      BlockSplitBloomFilter::read(*input_, metaData.bloom_filter_offset);
+  if (!bloomFilter) {
+    return true;
+  }
+  return testBloomFilter(filter, *bloomFilter, type_->parquetType_.value());
+}
+
 void ParquetData::enqueueRowGroup(
     uint32_t index,
     dwio::common::BufferedInput& input) {
@@ -107,6 +159,19 @@ void ParquetData::enqueueRowGroup(
 
   auto id = dwio::common::StreamIdentifier(type_->column());
   streams_[index] = input.enqueue({chunkReadOffset, readSize}, &id);
+
+  if (scanSpec_ && scanSpec_->filter() && maxRepeat_ == 0 &&
+      chunk.__isset.column_index_offset && chunk.__isset.column_index_length &&
+      chunk.__isset.offset_index_offset && chunk.__isset.offset_index_length) {
+    columnIndexStreams_.resize(rowGroups_.size());
+    offsetIndexStreams_.resize(rowGroups_.size());
+    columnIndexStreams_[index] = input.enqueue(
+        {static_cast<uint64_t>(chunk.column_index_offset),
+         static_cast<uint64_t>(chunk.column_index_length)});
+    offsetIndexStreams_[index] = input.enqueue(
+        {static_cast<uint64_t>(chunk.offset_index_offset),
+         static_cast<uint64_t>(chunk.offset_index_length)});
+  }
 }
 
 dwio::common::PositionProvider ParquetData::seekToRowGroup(uint32_t index) {
@@ -120,6 +185,19 @@ dwio::common::PositionProvider ParquetData::seekToRowGroup(uint32_t index) {
       type_,
       metadata.codec,
       metadata.total_compressed_size);
+  if (index < columnIndexStreams_.size() && columnIndexStreams_[index]) {
+    auto& chunk = rowGroups_[index].columns[type_->column()];
+    auto columnIndex = readThrift<thrift::ColumnIndex>(
+        *columnIndexStreams_[index], chunk.column_index_length);
+    auto offsetIndex = readThrift<thrift::OffsetIndex>(
+        *offsetIndexStreams_[index], chunk.offset_index_length);
+    columnIndexStreams_[index].reset();
+    offsetIndexStreams_[index].reset();
+    reader_->setPageIndex(
+        std::move(columnIndex),
+        std::move(offsetIndex),
+        rowGroups_[index].num_rows);
+  }
   return dwio::common::PositionProvider(empty);
 }
 
@@ -28,14 +28,19 @@
 namespace facebook::velox::parquet {
 class ParquetParams : public dwio::common::FormatParams {
  public:
-  ParquetParams(memory::MemoryPool& pool, const thrift::FileMetaData& metaData)
-      : FormatParams(pool), metaData_(metaData) {}
+  ParquetParams(
+      memory::MemoryPool& pool,
+      const thrift::FileMetaData& metaData,
+      dwio::common::BufferedInput* FOLLY_NULLABLE input = nullptr)
+      : FormatParams(pool), metaData_(metaData), input_(input) {}
   std::unique_ptr<dwio::common::FormatData> toFormatData(
       const std::shared_ptr<const dwio::common::TypeWithId>& type,
       const common::ScanSpec& scanSpec) override;
 
  private:
   const thrift::FileMetaData& metaData_;
+  // Input of the file for reading Bloom filters when filtering row groups.
+  dwio::common::BufferedInput* FOLLY_NULLABLE input_;
 };
 
 /// Format-specific data created for each leaf column of a Parquet rowgroup.
@@ -44,10 +49,14 @@ class ParquetData : public dwio::common::FormatData {
   ParquetData(
       const std::shared_ptr<const dwio::common::TypeWithId>& type,
       const std::vector<thrift::RowGroup>& rowGroups,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      const common::ScanSpec* FOLLY_NULLABLE scanSpec = nullptr,
+      dwio::common::BufferedInput* FOLLY_NULLABLE input = nullptr)
       : pool_(pool),
         type_(std::static_pointer_cast<const ParquetTypeWithId>(type)),
         rowGroups_(rowGroups),
+        scanSpec_(scanSpec),
+        input_(input),
         maxDefine_(type_->maxDefine_),
         maxRepeat_(type_->maxRepeat_),
         rowsInRowGroup_(-1) {}
@@ -164,6 +173,10 @@ class ParquetData : public dwio::common::FormatData {
     reader_->clearDictionary();
   }
 
+  void setReadDictionaryIds(bool readDictionaryIds) {
+    reader_->setReadDictionaryIds(readDictionaryIds);
+  }
+
   bool hasDictionary() const {
     return reader_->isDictionary();
   }
@@ -180,13 +193,29 @@ class ParquetData : public dwio::common::FormatData {
   /// stats in 'rowGroup'.
   bool rowGroupMatches(uint32_t rowGroupId, common::Filter* filter);
 
+  /// False if the Bloom filter of the column chunk in 'rowGroupId' has none of
+  /// the values passing 'filter'. True if there is no Bloom filter or 'filter'
+  /// is not an equality or IN-list.
+  bool bloomFilterMatches(uint32_t rowGroupId, const common::Filter& filter);
+
  protected:
   memory::MemoryPool& pool_;
   std::shared_ptr<const ParquetTypeWithId> type_;
   const std::vector<thrift::RowGroup>& rowGroups_;
+  // The ScanSpec of the column. The page index is read if it has a filter.
+  const common::ScanSpec* FOLLY_NULLABLE scanSpec_;
+  // Input for reading Bloom filters in filterRowGroups(). Not owned.
+  dwio::common::BufferedInput* FOLLY_NULLABLE input_;
   // Streams for this column in each of 'rowGroups_'. Will be created on or
   // ahead of first use, not at construction.
   std::vector<std::unique_ptr<dwio::common::SeekableInputStream>> streams_;
+  // Streams for the ColumnIndex and OffsetIndex of this column in each of
+  // 'rowGroups_'. Set if the column has a filter and the file has a page
+  // index.
+  std::vector<std::unique_ptr<dwio::common::SeekableInputStream>>
+      columnIndexStreams_;
+  std::vector<std::unique_ptr<dwio::common::SeekableInputStream>>
+      offsetIndexStreams_;
 
   const uint32_t maxDefine_;
   const uint32_t maxRepeat_;
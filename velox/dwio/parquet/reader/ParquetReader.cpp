@@ -16,6 +16,7 @@
 
 #include "velox/dwio/parquet/reader/ParquetReader.h"
 #include <thrift/protocol/TCompactProtocol.h> //@manual
+#include "velox/dwio/common/FileMetadataCache.h"
 #include "velox/dwio/common/MetricsLog.h"
 #include "velox/dwio/common/TypeUtils.h"
 #include "velox/dwio/parquet/reader/StructColumnReader.h"
@@ -28,8 +29,29 @@ DEFINE_int32(
     "prefetch. 1 means prefetch the next row group before decoding "
     "the current one");
 
+DEFINE_int32(
+    parquet_max_prefetch_rowgroups,
+    4,
+    "Maximum number of next row groups to prefetch. The number of row "
+    "groups in flight grows from parquet_prefetch_rowgroups towards this "
+    "while the query thread waits for IO");
+
 namespace facebook::velox::parquet {
 
+namespace {
+// The parsed footer of a file in FileMetadataCache.
+struct ParquetFileMetadata : public dwio::common::FileMetadataCache::Entry {
+  std::shared_ptr<const thrift::FileMetaData> fileMetaData;
+  // The size of the serialized footer. Approximates the memory of the parsed
+  // footer.
+  uint64_t footerLength{0};
+
+  uint64_t memoryBytes() const override {
+    return sizeof(*this) + sizeof(thrift::FileMetaData) + footerLength;
+  }
+};
+} // namespace
+
 /// Metadata and options for reading Parquet.
 class ReaderBase {
  public:
@@ -78,6 +100,10 @@ class ReaderBase {
       int32_t currentGroup,
       StructColumnReader& reader);
 
+  /// Returns the compressed size of the 'rowGroupIndex'th row group in the
+  /// file.
+  int64_t rowGroupCompressedSize(int32_t rowGroupIndex) const;
+
   /// Returns the uncompressed size for columns in 'type' and its children in
   /// row
   /// group.
@@ -86,8 +112,12 @@ class ReaderBase {
       const dwio::common::TypeWithId& type) const;
 
  private:
-  // Reads and parses file footer.
-  void loadFileMetaData();
+  // Reads and parses file footer. Returns the size of the serialized footer.
+  uint32_t loadFileMetaData();
+
+  // Sets 'fileMetaData_' from FileMetadataCache or reads it and adds it to
+  // the cache.
+  void initializeFileMetaData();
 
   void initializeSchema();
 
@@ -100,6 +130,10 @@ class ReaderBase {
 
   TypePtr convertType(const thrift::SchemaElement& schemaElement) const;
 
+  // Updates 'prefetchRowGroups_' from the time the query thread spent waiting
+  // for IO since the previous call.
+  void adjustPrefetchRowGroups();
+
   static std::shared_ptr<const RowType> createRowType(
       std::vector<std::shared_ptr<const ParquetTypeWithId::TypeWithId>>
           children,
@@ -112,7 +146,7 @@ class ReaderBase {
   const dwio::common::ReaderOptions options_;
   std::shared_ptr<velox::dwio::common::BufferedInput> input_;
   uint64_t fileLength_;
-  std::unique_ptr<thrift::FileMetaData> fileMetaData_;
+  std::shared_ptr<const thrift::FileMetaData> fileMetaData_;
   RowTypePtr schema_;
   std::shared_ptr<const dwio::common::TypeWithId> schemaWithId_;
 
@@ -121,6 +155,13 @@ class ReaderBase {
   // Map from row group index to pre-created loading BufferedInput.
   std::unordered_map<uint32_t, std::shared_ptr<dwio::common::BufferedInput>>
       inputs_;
+
+  // Number of row groups after the current one to load ahead.
+  int32_t prefetchRowGroups_;
+
+  // Value of 'queryThreadIoLatency' of the IoStatistics of 'input_' at the
+  // previous adjustPrefetchRowGroups().
+  uint64_t lastIoWaitUs_{0};
 };
 
 ReaderBase::ReaderBase(
@@ -130,16 +171,53 @@ ReaderBase::ReaderBase(
       directorySizeGuess_(options.getDirectorySizeGuess()),
       filePreloadThreshold_(options.getFilePreloadThreshold()),
       options_(options),
-      input_(std::move(input)) {
+      input_(std::move(input)),
+      prefetchRowGroups_(std::max(0, FLAGS_parquet_prefetch_rowgroups)) {
   fileLength_ = input_->getReadFile()->size();
   VELOX_CHECK_GT(fileLength_, 0, "Parquet file is empty");
   VELOX_CHECK_GE(fileLength_, 12, "Parquet file is too small");
 
-  loadFileMetaData();
+  initializeFileMetaData();
   initializeSchema();
+  if (auto* ioStats = input_->ioStatistics()) {
+    lastIoWaitUs_ = ioStats->queryThreadIoLatency().sum();
+  }
+}
+
+void ReaderBase::initializeFileMetaData() {
+  auto* metadataCache = dwio::common::FileMetadataCache::getInstance();
+  if (metadataCache == nullptr) {
+    loadFileMetaData();
+    return;
+  }
+  auto* ioStats = input_->ioStatistics();
+  const dwio::common::FileMetadataCache::Key cacheKey{
+      dwio::common::FileFormat::PARQUET,
+      input_->getReadFile()->getName(),
+      fileLength_};
+  auto cached = std::dynamic_pointer_cast<const ParquetFileMetadata>(
+      metadataCache->find(cacheKey));
+  if (cached != nullptr) {
+    // The footer is not read but a small file is still loaded in one IO.
+    if (fileLength_ <= std::max(filePreloadThreshold_, directorySizeGuess_)) {
+      input_->loadCompleteFile();
+    }
+    fileMetaData_ = cached->fileMetaData;
+    if (ioStats != nullptr) {
+      ioStats->metadataCacheHit().increment(cached->memoryBytes());
+    }
+    return;
+  }
+  auto entry = std::make_shared<ParquetFileMetadata>();
+  entry->footerLength = loadFileMetaData();
+  entry->fileMetaData = fileMetaData_;
+  if (ioStats != nullptr) {
+    ioStats->metadataCacheMiss().increment(entry->memoryBytes());
+  }
+  metadataCache->insert(cacheKey, std::move(entry));
 }
 
-void ReaderBase::loadFileMetaData() {
+uint32_t ReaderBase::loadFileMetaData() {
   bool preloadFile =
       fileLength_ <= std::max(filePreloadThreshold_, directorySizeGuess_);
   uint64_t readSize = preloadFile ? fileLength_ : directorySizeGuess_;
@@ -186,8 +264,10 @@ void ReaderBase::loadFileMetaData() {
   auto thriftProtocol = std::make_unique<
       apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport>>(
       thriftTransport);
-  fileMetaData_ = std::make_unique<thrift::FileMetaData>();
-  fileMetaData_->read(thriftProtocol.get());
+  auto fileMetaData = std::make_shared<thrift::FileMetaData>();
+  fileMetaData->read(thriftProtocol.get());
+  fileMetaData_ = std::move(fileMetaData);
+  return footerLength;
 }
 
 void ReaderBase::initializeSchema() {
@@ -565,34 +645,62 @@ std::shared_ptr<const RowType> ReaderBase::createRowType(
       std::move(childNames), std::move(childTypes));
 }
 
+void ReaderBase::adjustPrefetchRowGroups() {
+  auto* ioStats = input_->ioStatistics();
+  if (!ioStats) {
+    return;
+  }
+  auto ioWaitUs = ioStats->queryThreadIoLatency().sum();
+  if (ioWaitUs > lastIoWaitUs_) {
+    // The previous row group was not loaded by the time it was decoded. Read
+    // further ahead.
+    prefetchRowGroups_ = std::min(
+        prefetchRowGroups_ + 1,
+        std::max(prefetchRowGroups_, FLAGS_parquet_max_prefetch_rowgroups));
+  } else if (prefetchRowGroups_ > FLAGS_parquet_prefetch_rowgroups) {
+    // IO keeps up with decoding. Hold less data in memory.
+    --prefetchRowGroups_;
+  }
+  lastIoWaitUs_ = ioWaitUs;
+}
+
 void ReaderBase::scheduleRowGroups(
     const std::vector<uint32_t>& rowGroupIds,
     int32_t currentGroup,
     StructColumnReader& reader) {
+  adjustPrefetchRowGroups();
   auto thisGroup = rowGroupIds[currentGroup];
-  auto nextGroup =
-      currentGroup + 1 < rowGroupIds.size() ? rowGroupIds[currentGroup + 1] : 0;
-  auto input = inputs_[thisGroup].get();
-  if (!input) {
+  if (inputs_.count(thisGroup) == 0) {
     inputs_[thisGroup] = reader.loadRowGroup(thisGroup, input_);
   }
-  for (auto counter = 0; counter < FLAGS_parquet_prefetch_rowgroups;
-       ++counter) {
-    if (nextGroup) {
-      if (inputs_.count(nextGroup) != 0) {
-        inputs_[nextGroup] = reader.loadRowGroup(thisGroup, input_);
-      }
-    } else {
+  // Issues the loads for up to 'prefetchRowGroups_' next row groups. Each
+  // load coalesces the column chunks of its row group. The row groups after
+  // the next one are not loaded ahead if this would put more than
+  // maxCoalesceBytes in flight.
+  int64_t bytesAhead = 0;
+  auto lastGroup = std::min<int32_t>(
+      rowGroupIds.size() - 1, currentGroup + prefetchRowGroups_);
+  for (auto i = currentGroup + 1; i <= lastGroup; ++i) {
+    auto group = rowGroupIds[i];
+    bytesAhead += rowGroupCompressedSize(group);
+    if (i > currentGroup + 1 && bytesAhead > options_.maxCoalesceBytes()) {
       break;
     }
-    nextGroup =
-        nextGroup + 1 < rowGroupIds.size() ? rowGroupIds[nextGroup + 1] : 0;
+    if (inputs_.count(group) == 0) {
+      inputs_[group] = reader.loadRowGroup(group, input_);
+    }
   }
-  if (currentGroup > 1) {
+  if (currentGroup > 0) {
     inputs_.erase(rowGroupIds[currentGroup - 1]);
   }
 }
 
+int64_t ReaderBase::rowGroupCompressedSize(int32_t rowGroupIndex) const {
+  auto& rowGroup = fileMetaData_->row_groups[rowGroupIndex];
+  return rowGroup.__isset.total_compressed_size ? rowGroup.total_compressed_size
+                                                : rowGroup.total_byte_size;
+}
+
 int64_t ReaderBase::rowGroupUncompressedSize(
     int32_t rowGroupIndex,
     const dwio::common::TypeWithId& type) const {
@@ -635,7 +743,8 @@ ParquetRowReader::ParquetRowReader(
   if (rowGroups_.empty()) {
     return; // TODO
   }
-  ParquetParams params(pool_, readerBase_->fileMetaData());
+  ParquetParams params(
+      pool_, readerBase_->fileMetaData(), &readerBase_->bufferedInput());
 
   columnReader_ = ParquetColumnReader::build(
       readerBase_->schemaWithId(), // Id is schema id
@@ -681,6 +790,10 @@ void ParquetRowReader::filterRowGroups() {
     if (rowGroupInRange) {
       if (i < res.totalCount && bits::isBitSet(res.filterResult.data(), i)) {
         ++skippedRowGroups_;
+        if (i < res.bloomFilterResult.size() * 64 &&
+            bits::isBitSet(res.bloomFilterResult.data(), i)) {
+          ++skippedRowGroupsByBloomFilter_;
+        }
       } else {
         rowGroupIds_.push_back(i);
         firstRowOfRowGroup_.push_back(rowNumber);
@@ -742,6 +855,7 @@ bool ParquetRowReader::advanceToNextRowGroup() {
 void ParquetRowReader::updateRuntimeStats(
     dwio::common::RuntimeStatistics& stats) const {
   stats.skippedStrides += skippedRowGroups_;
+  stats.skippedStridesByBloomFilter += skippedRowGroupsByBloomFilter_;
 }
 
 void ParquetRowReader::resetFilterCaches() {
@@ -91,6 +91,10 @@ class ParquetRowReader : public dwio::common::RowReader {
   // Number of row groups skipped based on stats.
   int32_t skippedRowGroups_{0};
 
+  // Number of the row groups in 'skippedRowGroups_' that passed the min/max
+  // stats and were skipped based on Bloom filters.
+  int32_t skippedRowGroupsByBloomFilter_{0};
+
   std::unique_ptr<dwio::common::SelectiveColumnReader> columnReader_;
 
   RowTypePtr requestedType_;
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/BloomFilter.h"
+#include "velox/common/file/File.h"
+
+#include <gtest/gtest.h>
+#include <arrow/io/memory.h> // @manual
+#include <parquet/bloom_filter.h> // @manual
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+namespace {
+auto defaultPool = memory::addDefaultLeafMemoryPool();
+
+::parquet::ByteArray toByteArray(const std::string& value) {
+  return ::parquet::ByteArray(
+      value.size(), reinterpret_cast<const uint8_t*>(value.data()));
+}
+} // namespace
+
+class BloomFilterTest : public testing::Test {
+ protected:
+  // Writes 'filter' after 'kPrefix' bytes of padding and reads it back.
+  std::unique_ptr<BlockSplitBloomFilter> writeAndRead(
+      const ::parquet::BlockSplitBloomFilter& filter) {
+    auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+    filter.WriteTo(sink.get());
+    auto buffer = sink->Finish().ValueOrDie();
+    data_ = std::string(kPrefix, 'x') +
+        std::string(
+                reinterpret_cast<const char*>(buffer->data()), buffer->size());
+    dwio::common::BufferedInput input(
+        std::make_shared<InMemoryReadFile>(data_), *defaultPool);
+    return BlockSplitBloomFilter::read(input, kPrefix);
+  }
+
+  static constexpr int32_t kPrefix = 100;
+  std::string data_;
+};
+
+TEST_F(BloomFilterTest, int64) {
+  ::parquet::BlockSplitBloomFilter arrowFilter;
+  arrowFilter.Init(1024);
+  for (int64_t i = 0; i < 100; ++i) {
+    arrowFilter.InsertHash(arrowFilter.Hash(i * 1000));
+  }
+  auto filter = writeAndRead(arrowFilter);
+  ASSERT_TRUE(filter != nullptr);
+  int32_t numFalsePositives = 0;
+  for (int64_t i = 0; i < 100'000; ++i) {
+    auto hash = BlockSplitBloomFilter::hashInt64(i);
+    EXPECT_EQ(hash, arrowFilter.Hash(i));
+    if (i % 1000 == 0 && i < 100'000) {
+      EXPECT_TRUE(filter->mayContain(hash));
+    } else if (filter->mayContain(hash)) {
+      ++numFalsePositives;
+    }
+  }
+  EXPECT_LT(numFalsePositives, 1000);
+
+  auto physicalType = thrift::Type::INT64;
+  common::BigintRange hit(5000, 5000, false);
+  ASSERT_TRUE(canUseBloomFilter(hit, physicalType));
+  EXPECT_TRUE(testBloomFilter(hit, *filter, physicalType));
+
+  auto inList = common::createBigintValues({5000, 7000, 9000}, false);
+  ASSERT_TRUE(canUseBloomFilter(*inList, physicalType));
+  EXPECT_TRUE(testBloomFilter(*inList, *filter, physicalType));
+
+  // Look for values that the filter surely rejects.
+  std::vector<int64_t> misses;
+  for (int64_t i = 1; misses.size() < 10; ++i) {
+    if (!filter->mayContain(BlockSplitBloomFilter::hashInt64(i))) {
+      misses.push_back(i);
+    }
+  }
+  common::BigintRange miss(misses[0], misses[0], false);
+  EXPECT_FALSE(testBloomFilter(miss, *filter, physicalType));
+  auto missList = common::createBigintValues(misses, false);
+  EXPECT_FALSE(testBloomFilter(*missList, *filter, physicalType));
+
+  // Nulls and ranges are not in the Bloom filter.
+  EXPECT_FALSE(canUseBloomFilter(
+      common::BigintRange(misses[0], misses[0], true), physicalType));
+  EXPECT_FALSE(
+      canUseBloomFilter(common::BigintRange(1, 10, false), physicalType));
+}
+
+TEST_F(BloomFilterTest, int32) {
+  ::parquet::BlockSplitBloomFilter arrowFilter;
+  arrowFilter.Init(256);
+  for (int32_t i = 0; i < 20; ++i) {
+    arrowFilter.InsertHash(arrowFilter.Hash(i * 7));
+  }
+  auto filter = writeAndRead(arrowFilter);
+  ASSERT_TRUE(filter != nullptr);
+  auto physicalType = thrift::Type::INT32;
+  for (int32_t i = 0; i < 20; ++i) {
+    EXPECT_EQ(BlockSplitBloomFilter::hashInt32(i), arrowFilter.Hash(i));
+    common::BigintRange hit(i * 7, i * 7, false);
+    EXPECT_TRUE(testBloomFilter(hit, *filter, physicalType));
+  }
+  // Values outside of the range of INT32 are never in the column.
+  common::BigintRange outOfRange(1L << 40, 1L << 40, false);
+  EXPECT_FALSE(testBloomFilter(outOfRange, *filter, physicalType));
+}
+
+TEST_F(BloomFilterTest, bytes) {
+  ::parquet::BlockSplitBloomFilter arrowFilter;
+  arrowFilter.Init(1024);
+  std::vector<std::string> values;
+  for (auto i = 0; i < 100; ++i) {
+    values.push_back(fmt::format("value{}", i));
+    auto byteArray = toByteArray(values.back());
+    arrowFilter.InsertHash(arrowFilter.Hash(&byteArray));
+  }
+  auto filter = writeAndRead(arrowFilter);
+  ASSERT_TRUE(filter != nullptr);
+  auto physicalType = thrift::Type::BYTE_ARRAY;
+  for (auto& value : values) {
+    auto byteArray = toByteArray(value);
+    EXPECT_EQ(
+        BlockSplitBloomFilter::hashBytes(value.data(), value.size()),
+        arrowFilter.Hash(&byteArray));
+  }
+
+  common::BytesRange hit(
+      "value7", false, false, "value7", false, false, false);
+  ASSERT_TRUE(canUseBloomFilter(hit, physicalType));
+  EXPECT_TRUE(testBloomFilter(hit, *filter, physicalType));
+
+  std::vector<std::string> misses;
+  for (auto i = 0; misses.size() < 5; ++i) {
+    auto value = fmt::format("other{}", i);
+    if (!filter->mayContain(
+            BlockSplitBloomFilter::hashBytes(value.data(), value.size()))) {
+      misses.push_back(value);
+    }
+  }
+  common::BytesValues missList(misses, false);
+  ASSERT_TRUE(canUseBloomFilter(missList, physicalType));
+  EXPECT_FALSE(testBloomFilter(missList, *filter, physicalType));
+  misses.push_back("value50");
+  common::BytesValues hitList(misses, false);
+  EXPECT_TRUE(testBloomFilter(hitList, *filter, physicalType));
+  EXPECT_FALSE(canUseBloomFilter(hitList, thrift::Type::INT64));
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/ByteStreamSplit.h"
+
+#include <gtest/gtest.h>
+#include <parquet/encoding.h> // @manual
+
+#include <cstring>
+#include <limits>
+#include <random>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+namespace {
+
+template <typename DType, typename T>
+std::string byteStreamSplitEncode(const std::vector<T>& values) {
+  auto encoder = ::parquet::MakeTypedEncoder<DType>(
+      ::parquet::Encoding::BYTE_STREAM_SPLIT);
+  encoder->Put(values.data(), values.size());
+  auto buffer = encoder->FlushValues();
+  return std::string(
+      reinterpret_cast<const char*>(buffer->data()), buffer->size());
+}
+
+template <typename DType, typename T>
+void testRoundTrip(const std::vector<T>& values) {
+  auto encoded = byteStreamSplitEncode<DType>(values);
+  std::vector<T> decoded(values.size());
+  auto numValues = decodeByteStreamSplit(
+      encoded.data(),
+      encoded.size(),
+      sizeof(T),
+      reinterpret_cast<char*>(decoded.data()));
+  ASSERT_EQ(numValues, values.size());
+  for (auto i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(memcmp(&decoded[i], &values[i], sizeof(T)), 0) << "at " << i;
+  }
+}
+
+} // namespace
+
+TEST(ByteStreamSplitTest, floats) {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> distribution(-1e6, 1e6);
+  for (auto size : {0, 1, 7, 100, 10'001}) {
+    std::vector<float> values(size);
+    for (auto& value : values) {
+      value = distribution(rng);
+    }
+    testRoundTrip<::parquet::FloatType>(values);
+  }
+}
+
+TEST(ByteStreamSplitTest, doubles) {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> distribution(-1e12, 1e12);
+  for (auto size : {0, 1, 7, 100, 10'001}) {
+    std::vector<double> values(size);
+    for (auto& value : values) {
+      value = distribution(rng);
+    }
+    values.push_back(std::numeric_limits<double>::quiet_NaN());
+    values.push_back(-0.0);
+    testRoundTrip<::parquet::DoubleType>(values);
+  }
+}
+
+TEST(ByteStreamSplitTest, partialValue) {
+  std::string data(10, 'a');
+  std::vector<char> values(10);
+  EXPECT_THROW(
+      decodeByteStreamSplit(data.data(), data.size(), 4, values.data()),
+      VeloxRuntimeError);
+}
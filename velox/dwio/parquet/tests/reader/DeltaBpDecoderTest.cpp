@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
+#include "velox/dwio/parquet/reader/DeltaByteArrayDecoder.h"
+
+#include <gtest/gtest.h>
+#include <parquet/encoding.h> // @manual
+
+#include <random>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+namespace {
+
+template <typename DType, typename T>
+std::string deltaEncode(const std::vector<T>& values) {
+  auto encoder = ::parquet::MakeTypedEncoder<DType>(
+      ::parquet::Encoding::DELTA_BINARY_PACKED);
+  encoder->Put(values.data(), values.size());
+  auto buffer = encoder->FlushValues();
+  return std::string(
+      reinterpret_cast<const char*>(buffer->data()), buffer->size());
+}
+
+// Encodes 'values' as DELTA_LENGTH_BYTE_ARRAY.
+std::string deltaLengthEncode(const std::vector<std::string>& values) {
+  std::vector<int32_t> lengths;
+  std::string data;
+  for (auto& value : values) {
+    lengths.push_back(value.size());
+    data += value;
+  }
+  return deltaEncode<::parquet::Int32Type>(lengths) + data;
+}
+
+// Encodes 'values' as DELTA_BYTE_ARRAY.
+std::string deltaByteArrayEncode(const std::vector<std::string>& values) {
+  std::vector<int32_t> prefixLengths;
+  std::vector<std::string> suffixes;
+  std::string previous;
+  for (auto& value : values) {
+    int32_t prefixLength = 0;
+    while (prefixLength < previous.size() && prefixLength < value.size() &&
+           previous[prefixLength] == value[prefixLength]) {
+      ++prefixLength;
+    }
+    prefixLengths.push_back(prefixLength);
+    suffixes.push_back(value.substr(prefixLength));
+    previous = value;
+  }
+  return deltaEncode<::parquet::Int32Type>(prefixLengths) +
+      deltaLengthEncode(suffixes);
+}
+
+} // namespace
+
+TEST(DeltaBpDecoderTest, int64) {
+  std::mt19937 rng(1);
+  std::vector<int64_t> values;
+  // Small deltas, large deltas that need 64 bit wide miniblocks and a
+  // partial trailing miniblock.
+  for (auto i = 0; i < 1000; ++i) {
+    values.push_back(i * 3 + rng() % 10);
+  }
+  for (auto i = 0; i < 300; ++i) {
+    values.push_back(
+        i % 2 ? std::numeric_limits<int64_t>::max()
+              : std::numeric_limits<int64_t>::min() + rng() % 100);
+  }
+  for (auto i = 0; i < 77; ++i) {
+    values.push_back(static_cast<int64_t>(rng()) << (i % 32));
+  }
+  auto encoded = deltaEncode<::parquet::Int64Type>(values);
+  DeltaBpDecoder decoder(encoded.data(), encoded.data() + encoded.size());
+  ASSERT_EQ(values.size(), decoder.totalValues());
+  for (auto i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(values[i], decoder.readLong()) << i;
+  }
+  EXPECT_EQ(encoded.data() + encoded.size(), decoder.bufferStart());
+
+  DeltaBpDecoder skipDecoder(encoded.data(), encoded.data() + encoded.size());
+  auto index = 0;
+  for (auto skip : {0, 1, 31, 200, 1000, 45}) {
+    skipDecoder.skip(skip);
+    index += skip;
+    ASSERT_EQ(values[index], skipDecoder.readLong()) << index;
+    ++index;
+  }
+}
+
+TEST(DeltaBpDecoderTest, int32) {
+  std::vector<int32_t> values;
+  for (auto i = 0; i < 500; ++i) {
+    values.push_back(
+        i % 3 == 0       ? std::numeric_limits<int32_t>::max()
+            : i % 3 == 1 ? std::numeric_limits<int32_t>::min()
+                         : -i);
+  }
+  auto encoded = deltaEncode<::parquet::Int32Type>(values);
+  DeltaBpDecoder decoder(encoded.data(), encoded.data() + encoded.size(), true);
+  for (auto i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(values[i], decoder.readLong()) << i;
+  }
+}
+
+TEST(DeltaBpDecoderTest, singleValue) {
+  std::vector<int64_t> values = {-12345};
+  auto encoded = deltaEncode<::parquet::Int64Type>(values);
+  DeltaBpDecoder decoder(encoded.data(), encoded.data() + encoded.size());
+  EXPECT_EQ(1, decoder.totalValues());
+  EXPECT_EQ(-12345, decoder.readLong());
+}
+
+TEST(DeltaBpDecoderTest, byteArray) {
+  std::vector<std::string> values;
+  for (auto i = 0; i < 1000; ++i) {
+    values.push_back(
+        fmt::format("prefix_{}_{}", i / 10, std::string(i % 17, 'x')));
+  }
+  values.push_back("");
+  values.push_back("a string that does not share a prefix");
+
+  auto lengthEncoded = deltaLengthEncode(values);
+  DeltaLengthByteArrayDecoder lengthDecoder(
+      lengthEncoded.data(), lengthEncoded.data() + lengthEncoded.size());
+  for (auto i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(values[i], lengthDecoder.readString().str()) << i;
+  }
+
+  auto encoded = deltaByteArrayEncode(values);
+  DeltaByteArrayDecoder decoder(
+      encoded.data(), encoded.data() + encoded.size());
+  decoder.skip(505);
+  for (auto i = 505; i < values.size(); ++i) {
+    ASSERT_EQ(values[i], decoder.readString().str()) << i;
+  }
+}
@@ -14,10 +14,13 @@
  * limitations under the License.
  */
 
+#include "velox/dwio/common/compression/AsyncDecompressor.h"
 #include "velox/dwio/common/tests/E2EFilterTestBase.h"
 #include "velox/dwio/parquet/reader/ParquetReader.h"
 #include "velox/dwio/parquet/writer/Writer.h"
 
+#include <folly/ScopeGuard.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/init/Init.h>
 
 using namespace facebook::velox;
@@ -194,6 +197,47 @@ TEST_F(E2EFilterTest, compression) {
   }
 }
 
+TEST_F(E2EFilterTest, asyncDecompression) {
+  // Decompresses the pages of each column chunk together on a thread pool.
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  dwio::common::compression::setAsyncDecompressor(
+      std::make_shared<dwio::common::compression::ExecutorDecompressor>(
+          executor.get()));
+  SCOPE_EXIT {
+    dwio::common::compression::setAsyncDecompressor(nullptr);
+  };
+  for (const auto compression :
+       {common::CompressionKind_SNAPPY,
+        common::CompressionKind_ZSTD,
+        common::CompressionKind_GZIP}) {
+    if (!facebook::velox::parquet::Writer::isCodecAvailable(compression)) {
+      continue;
+    }
+
+    options_.dataPageSize = 4 * 1024;
+    options_.compression = compression;
+
+    testWithTypes(
+        "int_val:int,"
+        "long_val:bigint,"
+        "string_val:string",
+        [&]() {
+          makeIntDistribution<int64_t>(
+              "long_val",
+              10, // min
+              100, // max
+              22, // repeats
+              19, // rareFrequency
+              -9999, // rareMin
+              10000000000, // rareMax
+              true); // keepNulls
+        },
+        true,
+        {"int_val", "long_val", "string_val"},
+        3);
+  }
+}
+
 TEST_F(E2EFilterTest, integerDictionary) {
   options_.dataPageSize = 4 * 1024;
 
@@ -615,6 +659,93 @@ TEST_F(E2EFilterTest, combineRowGroup) {
   EXPECT_EQ(parquetReader.numberOfRows(), 5);
 }
 
+TEST_F(E2EFilterTest, integerDictionaryVector) {
+  rowType_ = ROW({"i", "b"}, {INTEGER(), BIGINT()});
+  constexpr int32_t kNumRows = 1'000;
+  auto ints = BaseVector::create<FlatVector<int32_t>>(
+      INTEGER(), kNumRows, leafPool_.get());
+  auto bigints = BaseVector::create<FlatVector<int64_t>>(
+      BIGINT(), kNumRows, leafPool_.get());
+  for (auto i = 0; i < kNumRows; ++i) {
+    ints->set(i, i % 7);
+    if (i % 11 == 0) {
+      bigints->setNull(i, true);
+    } else {
+      bigints->set(i, (i % 5) * 1'000'000'000'000L);
+    }
+  }
+  auto batch = std::make_shared<RowVector>(
+      leafPool_.get(),
+      rowType_,
+      nullptr,
+      kNumRows,
+      std::vector<VectorPtr>{ints, bigints});
+  writeToMemory(rowType_, {batch}, true);
+
+  dwio::common::ReaderOptions readerOpts{leafPool_.get()};
+  std::string_view data(sinkPtr_->data(), sinkPtr_->size());
+  auto input = std::make_unique<BufferedInput>(
+      std::make_shared<InMemoryReadFile>(data), readerOpts.getMemoryPool());
+  auto reader = makeReader(readerOpts, std::move(input));
+  auto spec = std::make_shared<common::ScanSpec>("<root>");
+  spec->addAllChildFields(*rowType_);
+  dwio::common::RowReaderOptions rowReaderOpts;
+  setUpRowReaderOptions(rowReaderOpts, spec);
+  auto rowReader = reader->createRowReader(rowReaderOpts);
+
+  // Unfiltered dictionary encoded columns come back as dictionaries over the
+  // column chunk dictionary.
+  VectorPtr result = BaseVector::create(rowType_, 0, leafPool_.get());
+  int32_t numRead = 0;
+  while (rowReader->next(100, result)) {
+    auto rowVector = result->as<RowVector>();
+    for (auto column = 0; column < rowType_->size(); ++column) {
+      auto& child = rowVector->childAt(column);
+      EXPECT_EQ(child->encoding(), VectorEncoding::Simple::DICTIONARY);
+      for (auto i = 0; i < child->size(); ++i) {
+        ASSERT_TRUE(child->equalValueAt(
+            batch->childAt(column).get(), i, numRead + i))
+            << child->toString(i);
+      }
+    }
+    numRead += result->size();
+  }
+  EXPECT_EQ(numRead, kNumRows);
+}
+
+TEST_F(E2EFilterTest, writerMemoryInPool) {
+  rowType_ = ROW({BIGINT()});
+  constexpr int32_t kNumRows = 10'000;
+  auto values = BaseVector::create<FlatVector<int64_t>>(
+      BIGINT(), kNumRows, leafPool_.get());
+  for (auto i = 0; i < kNumRows; ++i) {
+    values->set(i, i);
+  }
+  auto batch = std::make_shared<RowVector>(
+      leafPool_.get(),
+      rowType_,
+      nullptr,
+      kNumRows,
+      std::vector<VectorPtr>{values});
+
+  auto writerPool =
+      memory::defaultMemoryManager().addRootPool("writerMemoryInPool");
+  auto sink = std::make_unique<MemorySink>(
+      10 * 1024 * 1024, FileSink::Options{.pool = leafPool_.get()});
+  WriterOptions options;
+  options.memoryPool = writerPool.get();
+  auto writer = std::make_unique<facebook::velox::parquet::Writer>(
+      std::move(sink), options);
+  writer->write(batch);
+  writer->flush();
+  // The dictionary and page buffers of the Arrow writer are allocated from
+  // the writer's pool.
+  EXPECT_GT(writerPool->stats().peakBytes, kNumRows * sizeof(int64_t));
+  writer->close();
+  writer.reset();
+  EXPECT_EQ(writerPool->currentBytes(), 0);
+}
+
 // Define main so that gflags get processed.
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
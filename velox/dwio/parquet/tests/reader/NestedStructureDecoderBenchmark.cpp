@@ -20,6 +20,7 @@
 #include "velox/vector/TypeAliases.h"
 
 #include <folly/Benchmark.h>
+#include <parquet/level_conversion.h>
 
 using namespace facebook::velox;
 using namespace facebook::velox::parquet;
@@ -90,6 +91,105 @@ BENCHMARK(randomDefs) {
   folly::doNotOptimizeAway(numCollections);
 }
 
+// Levels of an optional ARRAY<ARRAY<INTEGER>> if 'nested', else of an optional
+// ARRAY<INTEGER>, with optional elements and about 'averageLength' elements
+// per row.
+class TopLevelListBenchmark {
+ public:
+  TopLevelListBenchmark(int32_t numRows, int32_t averageLength, bool nested)
+      : lengths_(numRows), nulls_(bits::nwords(numRows)) {
+    info_.def_level = 2;
+    info_.rep_level = 1;
+    info_.repeated_ancestor_def_level = 0;
+    offsets_.resize(numRows + 1);
+    for (auto row = 0; row < numRows; ++row) {
+      auto kind = rand() % 10;
+      if (kind == 0) {
+        addLevel(0, 0);
+        continue;
+      }
+      if (kind == 1) {
+        addLevel(1, 0);
+        continue;
+      }
+      auto size = 1 + rand() % (2 * averageLength);
+      for (auto i = 0; i < size; ++i) {
+        addLevel(2 + rand() % 2 * (nested ? 3 : 1), i == 0 ? 0 : 1);
+        if (nested && definitionLevels_.back() == 5) {
+          // Continue the inner list.
+          for (auto j = rand() % 3; j > 0; --j) {
+            addLevel(4 + rand() % 2, 2);
+          }
+        }
+      }
+    }
+  }
+
+  int32_t decodeArrow() {
+    ::parquet::internal::ValidityBitmapInputOutput bits;
+    bits.values_read_upper_bound = lengths_.size();
+    bits.values_read = 0;
+    bits.null_count = 0;
+    bits.valid_bits = reinterpret_cast<uint8_t*>(nulls_.data());
+    bits.valid_bits_offset = 0;
+    ::parquet::internal::DefRepLevelsToList(
+        definitionLevels_.data(),
+        repetitionLevels_.data(),
+        definitionLevels_.size(),
+        info_,
+        &bits,
+        offsets_.data());
+    for (auto i = 0; i < bits.values_read; ++i) {
+      lengths_[i] = offsets_[i + 1] - offsets_[i];
+    }
+    return bits.values_read;
+  }
+
+  int32_t decodeVelox() {
+    return NestedStructureDecoder::readTopLevelLengthsAndNulls(
+        definitionLevels_.data(),
+        repetitionLevels_.data(),
+        definitionLevels_.size(),
+        info_.def_level,
+        lengths_.data(),
+        nulls_.data(),
+        0,
+        lengths_.size());
+  }
+
+ private:
+  void addLevel(int16_t definition, int16_t repetition) {
+    definitionLevels_.push_back(definition);
+    repetitionLevels_.push_back(repetition);
+  }
+
+  ::parquet::internal::LevelInfo info_;
+  std::vector<int16_t> definitionLevels_;
+  std::vector<int16_t> repetitionLevels_;
+  std::vector<int32_t> offsets_;
+  std::vector<int32_t> lengths_;
+  std::vector<uint64_t> nulls_;
+};
+
+#define TOP_LEVEL_LIST_BENCHMARKS(name, averageLength, nested)                 \
+  BENCHMARK(name##Arrow) {                                                     \
+    folly::BenchmarkSuspender suspender;                                       \
+    TopLevelListBenchmark benchmark(100'000, averageLength, nested);           \
+    suspender.dismiss();                                                       \
+    folly::doNotOptimizeAway(benchmark.decodeArrow());                         \
+  }                                                                            \
+  BENCHMARK_RELATIVE(name##Velox) {                                            \
+    folly::BenchmarkSuspender suspender;                                       \
+    TopLevelListBenchmark benchmark(100'000, averageLength, nested);           \
+    suspender.dismiss();                                                       \
+    folly::doNotOptimizeAway(benchmark.decodeVelox());                         \
+  }
+
+BENCHMARK_DRAW_LINE();
+TOP_LEVEL_LIST_BENCHMARKS(shortLists, 2, false)
+TOP_LEVEL_LIST_BENCHMARKS(longLists, 20, false)
+TOP_LEVEL_LIST_BENCHMARKS(nestedLists, 5, true)
+
 int main(int /*argc*/, char** /*argv*/) {
   folly::runBenchmarks();
   return 0;
@@ -67,6 +67,32 @@ class NestedStructureDecoderTest : public testing::Test {
     assertNulls(nullsBuffer_, numCollections, expectedNulls);
   }
 
+  void assertTopLevelStructure(
+      const uint8_t* definitionLevels,
+      const uint8_t* repetitionLevels,
+      int64_t numValues,
+      int16_t elementDefinition,
+      std::vector<vector_size_t> expectedLengths,
+      std::vector<bool> expectedNulls) {
+    std::vector<int16_t> defs(
+        definitionLevels, definitionLevels + numValues);
+    std::vector<int16_t> reps(
+        repetitionLevels, repetitionLevels + numValues);
+    auto numCollections = NestedStructureDecoder::readTopLevelLengthsAndNulls(
+        defs.data(),
+        reps.data(),
+        numValues,
+        elementDefinition,
+        lengthsBuffer_->asMutable<vector_size_t>(),
+        nullsBuffer_->asMutable<uint64_t>(),
+        0,
+        kMaxNumValues);
+
+    assertBufferContent<vector_size_t>(
+        lengthsBuffer_, numCollections, expectedLengths);
+    assertNulls(nullsBuffer_, numCollections, expectedNulls);
+  }
+
  private:
   template <typename T>
   void assertBufferContent(
@@ -127,6 +153,8 @@ TEST_F(NestedStructureDecoderTest, oneLevel) {
 
   assertStructure(
       defs, reps, 18, 1, 1, expectedOffsets, expectedLengths, expectedNulls);
+  assertTopLevelStructure(
+      defs, reps, 18, 2, expectedLengths, expectedNulls);
 }
 
 //---------------------------
@@ -208,6 +236,8 @@ TEST_F(NestedStructureDecoderTest, firstLevelInTwo) {
   // tests the second level, where maxDefinition = 1 and maxRepeat = 1
   assertStructure(
       defs, reps, 24, 1, 1, expectedOffsets, expectedLengths, expectedNulls);
+  assertTopLevelStructure(
+      defs, reps, 24, 2, expectedLengths, expectedNulls);
 }
 
 // ------------------------
@@ -263,3 +293,66 @@ TEST_F(NestedStructureDecoderTest, emptyRowAtEnd) {
   assertStructure(
       defs, reps, 4, 3, 2, expectedOffsets, expectedLengths, expectedNulls);
 }
+
+// ------------------------
+// ARRAY<INTEGER> with random null, empty and non-empty rows spanning many
+// 64 level words. Top level lengths and nulls must match
+// readOffsetsAndNulls().
+TEST_F(NestedStructureDecoderTest, topLevelRandom) {
+  std::vector<uint8_t> defs;
+  std::vector<uint8_t> reps;
+  std::vector<vector_size_t> expectedLengths;
+  std::vector<bool> expectedNulls;
+  std::vector<vector_size_t> expectedOffsets{0};
+  while (defs.size() < 1'000) {
+    auto kind = rand() % 4;
+    if (kind == 0) {
+      defs.push_back(0);
+      reps.push_back(0);
+      expectedLengths.push_back(0);
+    } else if (kind == 1) {
+      defs.push_back(1);
+      reps.push_back(0);
+      expectedLengths.push_back(0);
+    } else {
+      auto size = 1 + rand() % 70;
+      for (auto i = 0; i < size; ++i) {
+        defs.push_back(2 + rand() % 2);
+        reps.push_back(i == 0 ? 0 : 1);
+      }
+      expectedLengths.push_back(size);
+    }
+    expectedNulls.push_back(kind == 0);
+    expectedOffsets.push_back(expectedOffsets.back() + expectedLengths.back());
+  }
+
+  assertStructure(
+      defs.data(),
+      reps.data(),
+      defs.size(),
+      1,
+      1,
+      expectedOffsets,
+      expectedLengths,
+      expectedNulls);
+  assertTopLevelStructure(
+      defs.data(),
+      reps.data(),
+      defs.size(),
+      2,
+      expectedLengths,
+      expectedNulls);
+
+  // Starting in the middle of the levels, the elements before the first
+  // top level row are not counted.
+  auto numCollections = NestedStructureDecoder::readTopLevelLengthsAndNulls(
+      std::vector<int16_t>(defs.begin(), defs.end()).data() + 1,
+      std::vector<int16_t>(reps.begin(), reps.end()).data() + 1,
+      defs.size() - 1,
+      2,
+      lengthsBuffer_->asMutable<vector_size_t>(),
+      nullsBuffer_->asMutable<uint64_t>(),
+      0,
+      kMaxNumValues);
+  EXPECT_EQ(numCollections, expectedLengths.size() - 1);
+}
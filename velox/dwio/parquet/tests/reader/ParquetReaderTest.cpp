@@ -18,6 +18,11 @@
 #include "velox/dwio/parquet/tests/ParquetReaderTestBase.h"
 #include "velox/expression/ExprToSubfieldFilter.h"
 
+#include <folly/ScopeGuard.h>
+#include <gflags/gflags.h>
+
+DECLARE_int32(parquet_prefetch_rowgroups);
+
 using namespace facebook::velox;
 using namespace facebook::velox::common;
 using namespace facebook::velox::dwio::common;
@@ -630,3 +635,26 @@ TEST_F(ParquetReaderTest, preloadSmallFile) {
     ASSERT_EQ(file->bytesRead(), 0);
   }
 }
+
+TEST_F(ParquetReaderTest, prefetchRowGroups) {
+  // Load the two row groups of sample.parquet separately and have both in
+  // flight when the first one is decoded.
+  const std::string sample(getExampleFilePath("sample.parquet"));
+  auto prefetchRowGroups = FLAGS_parquet_prefetch_rowgroups;
+  FLAGS_parquet_prefetch_rowgroups = 3;
+  SCOPE_EXIT {
+    FLAGS_parquet_prefetch_rowgroups = prefetchRowGroups;
+  };
+
+  ReaderOptions readerOptions{defaultPool.get()};
+  readerOptions.setFilePreloadThreshold(0);
+  readerOptions.setDirectorySizeGuess(1024);
+  ParquetReader reader = createReader(sample, readerOptions);
+
+  auto rowReaderOpts = getReaderOpts(sampleSchema());
+  rowReaderOpts.setScanSpec(makeScanSpec(sampleSchema()));
+  auto rowReader = reader.createRowReader(rowReaderOpts);
+  auto expected = vectorMaker_->rowVector(
+      {rangeVector<int64_t>(20, 1), rangeVector<double>(20, 1)});
+  assertReadExpected(sampleSchema(), *rowReader, expected, *pool_);
+}
@@ -86,6 +86,11 @@ class ThriftBufferedTransport : public ThriftTransport {
     return len;
   }
 
+  // Returns the number of bytes consumed from the start of the buffer.
+  uint64_t offset() const {
+    return offset_;
+  }
+
  private:
   const uint8_t* inputBuf_;
   const uint64_t size_;
@@ -17,6 +17,7 @@
 #include "velox/vector/arrow/Bridge.h"
 
 #include <arrow/c/bridge.h>
+#include <arrow/memory_pool.h>
 #include <arrow/table.h>
 #include <parquet/arrow/writer.h>
 #include "velox/dwio/parquet/writer/Writer.h"
@@ -82,7 +83,82 @@ class ArrowDataBufferSink : public arrow::io::OutputStream {
   int64_t bytesFlushed_ = 0;
 };
 
+// Routes the allocations of the Arrow Parquet writer to a Velox MemoryPool so
+// that the encoding, page and compression buffers are accounted in the pool of
+// the writer instead of the Arrow default pool.
+class ArrowMemoryPool : public arrow::MemoryPool {
+ public:
+  explicit ArrowMemoryPool(std::shared_ptr<memory::MemoryPool> pool)
+      : pool_(std::move(pool)) {
+    // Arrow expects buffers aligned for SIMD access.
+    VELOX_CHECK_GE(pool_->alignment(), arrow::kDefaultBufferAlignment);
+  }
+
+  arrow::Status Allocate(int64_t size, uint8_t** out) override {
+    if (size == 0) {
+      *out = zeroSizeArea();
+      return arrow::Status::OK();
+    }
+    try {
+      *out = reinterpret_cast<uint8_t*>(pool_->allocate(size));
+    } catch (const VeloxException& e) {
+      return arrow::Status::OutOfMemory(e.what());
+    }
+    bytesAllocated_ += size;
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Reallocate(int64_t oldSize, int64_t newSize, uint8_t** ptr)
+      override {
+    if (oldSize == 0) {
+      return Allocate(newSize, ptr);
+    }
+    if (newSize == 0) {
+      Free(*ptr, oldSize);
+      *ptr = zeroSizeArea();
+      return arrow::Status::OK();
+    }
+    try {
+      *ptr =
+          reinterpret_cast<uint8_t*>(pool_->reallocate(*ptr, oldSize, newSize));
+    } catch (const VeloxException& e) {
+      return arrow::Status::OutOfMemory(e.what());
+    }
+    bytesAllocated_ += newSize - oldSize;
+    return arrow::Status::OK();
+  }
+
+  void Free(uint8_t* buffer, int64_t size) override {
+    if (size == 0) {
+      return;
+    }
+    pool_->free(buffer, size);
+    bytesAllocated_ -= size;
+  }
+
+  int64_t bytes_allocated() const override {
+    return bytesAllocated_;
+  }
+
+  std::string backend_name() const override {
+    return "velox";
+  }
+
+ private:
+  // Arrow does not distinguish empty buffers from null ones. Zero sized
+  // allocations return this instead of going to 'pool_'.
+  static uint8_t* zeroSizeArea() {
+    alignas(arrow::kDefaultBufferAlignment) static uint8_t area[1];
+    return area;
+  }
+
+  const std::shared_ptr<memory::MemoryPool> pool_;
+  std::atomic<int64_t> bytesAllocated_{0};
+};
+
 struct ArrowContext {
+  // Destroyed last, after everything allocated from it.
+  std::unique_ptr<ArrowMemoryPool> pool;
   std::unique_ptr<::parquet::arrow::FileWriter> writer;
   std::shared_ptr<arrow::Schema> schema;
   std::shared_ptr<::parquet::WriterProperties> properties;
@@ -111,9 +187,11 @@ struct ArrowContext {
 
 std::shared_ptr<::parquet::WriterProperties> getArrowParquetWriterOptions(
     const parquet::WriterOptions& options,
-    const std::unique_ptr<DefaultFlushPolicy>& flushPolicy) {
+    const std::unique_ptr<DefaultFlushPolicy>& flushPolicy,
+    arrow::MemoryPool* pool) {
   auto builder = ::parquet::WriterProperties::Builder();
   ::parquet::WriterProperties::Builder* properties = &builder;
+  properties = properties->memory_pool(pool);
   if (!options.enableDictionary) {
     properties = properties->disable_dictionary();
   }
@@ -141,8 +219,10 @@ Writer::Writer(
   } else {
     flushPolicy_ = std::make_unique<DefaultFlushPolicy>();
   }
-  arrowContext_->properties =
-      getArrowParquetWriterOptions(options, flushPolicy_);
+  arrowContext_->pool =
+      std::make_unique<ArrowMemoryPool>(pool_->addLeafChild(".arrow"));
+  arrowContext_->properties = getArrowParquetWriterOptions(
+      options, flushPolicy_, arrowContext_->pool.get());
 }
 
 Writer::Writer(
@@ -162,7 +242,7 @@ void Writer::flush() {
           ::parquet::ArrowWriterProperties::Builder().build();
       PARQUET_THROW_NOT_OK(::parquet::arrow::FileWriter::Open(
           *arrowContext_->schema.get(),
-          arrow::default_memory_pool(),
+          arrowContext_->pool.get(),
           stream_,
           arrowContext_->properties,
           arrowProperties,
@@ -25,10 +25,22 @@ namespace facebook::velox::exec {
 
 namespace {
 
+// Number of partition rows aggregated into each leaf of the segment tree.
+constexpr vector_size_t kRowsPerLeaf = 16;
+
+// Least average number of rows per frame in an output block for which the
+// frames are aggregated from the segment tree instead of row by row.
+constexpr vector_size_t kMinSegmentTreeFrameRows = 4 * kRowsPerLeaf;
+
 // A generic way to compute any aggregation used as a window function.
 // Creates an Aggregate function object for the window function invocation.
 // At each row, computes the aggregation across all rows from the frameStart
 // to frameEnd boundaries at that row using singleGroup.
+//
+// Frames with a fixed start and growing ends are aggregated incrementally.
+// Wide sliding frames are combined from the accumulators of a segment tree
+// over the partition, so that each frame takes O(log n) accumulators and at
+// most 2 * kRowsPerLeaf rows instead of all of its rows.
 class AggregateWindowFunction : public exec::WindowFunction {
  public:
   AggregateWindowFunction(
@@ -87,6 +99,23 @@ class AggregateWindowFunction : public exec::WindowFunction {
         exec::RowContainer::nullByte(kNullOffset),
         exec::RowContainer::nullMask(kNullOffset),
         /* needed for out of line allocations */ kRowSizeOffset);
+
+    // The nodes of the segment tree for sliding frames have the same layout
+    // as the single group row.
+    treeAggregate_ = exec::Aggregate::create(
+        name,
+        core::AggregationNode::Step::kSingle,
+        argTypes_,
+        resultType,
+        config);
+    treeAggregate_->setAllocator(stringAllocator_);
+    treeAggregate_->setOffsets(
+        singleGroupRowSize_,
+        exec::RowContainer::nullByte(kNullOffset),
+        exec::RowContainer::nullMask(kNullOffset),
+        kRowSizeOffset);
+    intermediateVector_ = BaseVector::create(
+        exec::Aggregate::intermediateType(name, argTypes_), 0, pool_);
     singleGroupRowSize_ += aggregate_->accumulatorFixedWidthSize();
 
     // Construct the single row in the MemoryPool.
@@ -106,12 +135,14 @@ class AggregateWindowFunction : public exec::WindowFunction {
       std::vector<char*> singleGroupRowVector = {rawSingleGroupRow_};
       aggregate_->destroy(folly::Range(singleGroupRowVector.data(), 1));
     }
+    clearSegmentTree();
   }
 
   void resetPartition(const exec::WindowPartition* partition) override {
     partition_ = partition;
 
     previousFrameMetadata_.reset();
+    clearSegmentTree();
   }
 
   void apply(
@@ -159,6 +190,9 @@ class AggregateWindowFunction : public exec::WindowFunction {
           rawFrameEnds,
           resultOffset,
           result);
+    } else if (useSegmentTree(validRows, rawFrameStarts, rawFrameEnds)) {
+      segmentTreeAggregation(
+          validRows, rawFrameStarts, rawFrameEnds, resultOffset, result);
     } else {
       fillArgVectors(frameMetadata.firstRow, frameMetadata.lastRow);
       simpleAggregation(
@@ -327,9 +361,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
       // This is a very naive algorithm.
       // It evaluates the entire aggregation for each row by iterating over
       // input rows from frameStart to frameEnd in the SelectivityVector.
-      // TODO : Try to re-use previous computations by advancing and retracting
-      // the aggregation based on the frame changes with each row. This would
-      // require adding new APIs to the Aggregate framework.
+      // Wide frames are aggregated by segmentTreeAggregation() instead.
       aggregate_->clear();
       aggregate_->initializeNewGroups(&rawSingleGroupRow_, kSingleGroup);
       aggregateInitialized_ = true;
@@ -344,6 +376,194 @@ class AggregateWindowFunction : public exec::WindowFunction {
     setNullEmptyFramesResults(validRows, resultOffset, result);
   }
 
+  // Returns true if the valid frames of the block are wide enough on average
+  // for the segment tree to pay off.
+  bool useSegmentTree(
+      const SelectivityVector& validRows,
+      const vector_size_t* rawFrameStarts,
+      const vector_size_t* rawFrameEnds) const {
+    if (partition_->numRows() < kMinSegmentTreeFrameRows) {
+      return false;
+    }
+    int64_t numFrameRows = 0;
+    validRows.applyToSelected([&](auto i) {
+      numFrameRows += rawFrameEnds[i] + 1 - rawFrameStarts[i];
+    });
+    return numFrameRows >=
+        static_cast<int64_t>(validRows.countSelected()) *
+        kMinSegmentTreeFrameRows;
+  }
+
+  // Builds a segment tree of accumulators over all rows of the partition.
+  // Leaf i aggregates rows [i * kRowsPerLeaf, (i + 1) * kRowsPerLeaf). The
+  // tree is laid out bottom-up: leaves are nodes [numLeaves_, 2 * numLeaves_)
+  // and node i > 0 combines nodes 2 * i and 2 * i + 1 in this order, so that
+  // order sensitive aggregates see the rows in partition order.
+  void buildSegmentTree() {
+    const auto numRows = partition_->numRows();
+    numLeaves_ = bits::roundUp(numRows, kRowsPerLeaf) / kRowsPerLeaf;
+    const auto numNodes = 2 * numLeaves_;
+    const auto nodeSize = bits::roundUp(
+        singleGroupRowSize_, treeAggregate_->accumulatorAlignmentSize());
+    treeBuffer_ = AlignedBuffer::allocate<char>(numNodes * nodeSize, pool_);
+    auto* rawTree = treeBuffer_->asMutable<char>();
+    treeNodes_.resize(numNodes);
+    std::vector<vector_size_t> indices;
+    indices.reserve(numNodes - 1);
+    for (auto i = 1; i < numNodes; ++i) {
+      treeNodes_[i] = rawTree + i * nodeSize;
+      indices.push_back(i);
+    }
+    treeAggregate_->clear();
+    treeAggregate_->initializeNewGroups(treeNodes_.data(), indices);
+    treeBuilt_ = true;
+
+    // Reads all rows of the partition. Constant arguments are wrapped to the
+    // size of the partition.
+    treeArgVectors_.resize(argIndices_.size());
+    for (auto i = 0; i < argIndices_.size(); ++i) {
+      if (argIndices_[i] == kConstantChannel) {
+        treeArgVectors_[i] =
+            BaseVector::wrapInConstant(numRows, 0, argVectors_[i]);
+      } else {
+        treeArgVectors_[i] = BaseVector::create(argTypes_[i], numRows, pool_);
+        partition_->extractColumn(
+            argIndices_[i], 0, numRows, 0, treeArgVectors_[i]);
+      }
+    }
+
+    std::vector<char*> groups(numRows);
+    for (auto row = 0; row < numRows; ++row) {
+      groups[row] = treeNodes_[numLeaves_ + row / kRowsPerLeaf];
+    }
+    treeAggregate_->addRawInput(
+        groups.data(), SelectivityVector(numRows), treeArgVectors_, false);
+
+    // The children of the nodes in [low, high) are in [2 * low, 2 * high),
+    // which is at or above 'high', so each pass combines complete nodes.
+    for (auto high = numLeaves_; high > 1;) {
+      const auto low = (high + 1) / 2;
+      const auto numChildren = 2 * (high - low);
+      BaseVector::prepareForReuse(intermediateVector_, numChildren);
+      treeAggregate_->extractAccumulators(
+          treeNodes_.data() + 2 * low, numChildren, &intermediateVector_);
+      groups.resize(numChildren);
+      for (auto i = 0; i < numChildren; ++i) {
+        groups[i] = treeNodes_[low + i / 2];
+      }
+      treeAggregate_->addIntermediateResults(
+          groups.data(),
+          SelectivityVector(numChildren),
+          {intermediateVector_},
+          false);
+      high = low;
+    }
+  }
+
+  void clearSegmentTree() {
+    if (treeBuilt_) {
+      treeAggregate_->destroy(
+          folly::Range(treeNodes_.data() + 1, treeNodes_.size() - 1));
+      treeBuilt_ = false;
+    }
+    treeNodes_.clear();
+    treeBuffer_.reset();
+    treeArgVectors_.clear();
+  }
+
+  // Adds rows [start, end) of the partition to the single group.
+  void addTreeRows(
+      SelectivityVector& rows,
+      vector_size_t start,
+      vector_size_t end) {
+    if (start >= end) {
+      return;
+    }
+    rows.clearAll();
+    rows.setValidRange(start, end, true);
+    rows.updateBounds();
+    aggregate_->addSingleGroupRawInput(
+        rawSingleGroupRow_, rows, treeArgVectors_, false);
+  }
+
+  // Aggregates rows [start, end) of the partition into the single group. The
+  // whole leaves in the frame are covered by O(log n) tree nodes and the rows
+  // of partially covered leaves at either end are added as raw input.
+  void aggregateFrame(
+      SelectivityVector& rows,
+      std::vector<char*>& nodes,
+      std::vector<char*>& rightNodes,
+      vector_size_t start,
+      vector_size_t end) {
+    const auto firstLeaf = bits::roundUp(start, kRowsPerLeaf) / kRowsPerLeaf;
+    const auto endLeaf = end / kRowsPerLeaf;
+    if (firstLeaf >= endLeaf) {
+      addTreeRows(rows, start, end);
+      return;
+    }
+    addTreeRows(rows, start, firstLeaf * kRowsPerLeaf);
+
+    nodes.clear();
+    rightNodes.clear();
+    for (auto left = firstLeaf + numLeaves_, right = endLeaf + numLeaves_;
+         left < right;
+         left /= 2, right /= 2) {
+      if (left & 1) {
+        nodes.push_back(treeNodes_[left++]);
+      }
+      if (right & 1) {
+        rightNodes.push_back(treeNodes_[--right]);
+      }
+    }
+    nodes.insert(nodes.end(), rightNodes.rbegin(), rightNodes.rend());
+    BaseVector::prepareForReuse(intermediateVector_, nodes.size());
+    treeAggregate_->extractAccumulators(
+        nodes.data(), nodes.size(), &intermediateVector_);
+    aggregate_->addSingleGroupIntermediateResults(
+        rawSingleGroupRow_,
+        SelectivityVector(nodes.size()),
+        {intermediateVector_},
+        false);
+
+    addTreeRows(rows, endLeaf * kRowsPerLeaf, end);
+  }
+
+  void segmentTreeAggregation(
+      const SelectivityVector& validRows,
+      const vector_size_t* frameStartsVector,
+      const vector_size_t* frameEndsVector,
+      vector_size_t resultOffset,
+      const VectorPtr& result) {
+    if (!treeBuilt_) {
+      buildSegmentTree();
+    }
+
+    SelectivityVector rows(partition_->numRows(), false);
+    std::vector<char*> nodes;
+    std::vector<char*> rightNodes;
+    static auto kSingleGroup = std::vector<vector_size_t>{0};
+
+    validRows.applyToSelected([&](auto i) {
+      aggregate_->clear();
+      aggregate_->initializeNewGroups(&rawSingleGroupRow_, kSingleGroup);
+      aggregateInitialized_ = true;
+
+      aggregateFrame(
+          rows,
+          nodes,
+          rightNodes,
+          frameStartsVector[i],
+          frameEndsVector[i] + 1);
+      BaseVector::prepareForReuse(aggregateResultVector_, 1);
+      aggregate_->extractValues(
+          &rawSingleGroupRow_, 1, &aggregateResultVector_);
+      result->copy(aggregateResultVector_.get(), resultOffset + i, 0, 1);
+    });
+
+    // Set null values for empty (non valid) frames in the output block.
+    setNullEmptyFramesResults(validRows, resultOffset, result);
+  }
+
   // Aggregate function object required for this window function evaluation.
   std::unique_ptr<exec::Aggregate> aggregate_;
 
@@ -374,6 +594,20 @@ class AggregateWindowFunction : public exec::WindowFunction {
   // Stores metadata about the previous output block of the partition
   // to optimize aggregate computation and reading argument vectors.
   std::optional<FrameMetadata> previousFrameMetadata_;
+
+  // Segment tree over the current partition, built on first use for wide
+  // sliding frames. 'treeAggregate_' owns the accumulators of the tree nodes.
+  // It is separate from 'aggregate_', which is cleared for every frame.
+  std::unique_ptr<exec::Aggregate> treeAggregate_;
+  bool treeBuilt_{false};
+  vector_size_t numLeaves_{0};
+  BufferPtr treeBuffer_;
+  // Pointers to the tree nodes in 'treeBuffer_'. Entry 0 is unused.
+  std::vector<char*> treeNodes_;
+  // Arguments for all rows of the partition.
+  std::vector<VectorPtr> treeArgVectors_;
+  // Accumulators of tree nodes extracted for combining.
+  VectorPtr intermediateVector_;
 };
 
 } // namespace
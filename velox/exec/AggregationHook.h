@@ -35,6 +35,14 @@ class AggregationHook : public ValueHook {
   static constexpr Kind kFloatMin = 8;
   static constexpr Kind kDoubleMax = 9;
   static constexpr Kind kDoubleMin = 10;
+  static constexpr Kind kSumSmallintToBigint = 11;
+  static constexpr Kind kSumTinyintToBigint = 12;
+  static constexpr Kind kIntegerMax = 13;
+  static constexpr Kind kIntegerMin = 14;
+  static constexpr Kind kSmallintMax = 15;
+  static constexpr Kind kSmallintMin = 16;
+  static constexpr Kind kTinyintMax = 17;
+  static constexpr Kind kTinyintMin = 18;
 
   // Make null behavior known at compile time. This is useful when
   // templating a column decoding loop with a hook.
@@ -134,6 +142,12 @@ class SumHook final : public AggregationHook {
       if (std::is_same_v<TValue, int64_t>) {
         return kSumBigintToBigint;
       }
+      if (std::is_same_v<TValue, int16_t>) {
+        return kSumSmallintToBigint;
+      }
+      if (std::is_same_v<TValue, int8_t>) {
+        return kSumTinyintToBigint;
+      }
     }
     return kGeneric;
   }
@@ -192,6 +206,15 @@ class MinMaxHook final : public AggregationHook {
       if (std::is_same_v<T, int64_t>) {
         return kBigintMin;
       }
+      if (std::is_same_v<T, int32_t>) {
+        return kIntegerMin;
+      }
+      if (std::is_same_v<T, int16_t>) {
+        return kSmallintMin;
+      }
+      if (std::is_same_v<T, int8_t>) {
+        return kTinyintMin;
+      }
       if (std::is_same_v<T, float>) {
         return kFloatMin;
       }
@@ -202,6 +225,15 @@ class MinMaxHook final : public AggregationHook {
       if (std::is_same_v<T, int64_t>) {
         return kBigintMax;
       }
+      if (std::is_same_v<T, int32_t>) {
+        return kIntegerMax;
+      }
+      if (std::is_same_v<T, int16_t>) {
+        return kSmallintMax;
+      }
+      if (std::is_same_v<T, int8_t>) {
+        return kTinyintMax;
+      }
       if (std::is_same_v<T, float>) {
         return kFloatMax;
       }
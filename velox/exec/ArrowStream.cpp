@@ -15,8 +15,19 @@
  */
 #include "velox/exec/ArrowStream.h"
 
+#include "velox/exec/Task.h"
+
 namespace facebook::velox::exec {
 
+namespace {
+folly::Executor* prefetchExecutor(DriverCtx* driverCtx) {
+  if (driverCtx->queryConfig().arrowStreamPrefetchDepth() == 0) {
+    return nullptr;
+  }
+  return driverCtx->task->queryCtx()->executor();
+}
+} // namespace
+
 ArrowStream::ArrowStream(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -26,62 +37,169 @@ ArrowStream::ArrowStream(
           arrowStreamNode->outputType(),
           operatorId,
           arrowStreamNode->id(),
-          "ArrowStream") {
-  arrowStream_ = arrowStreamNode->arrowStream();
+          "ArrowStream"),
+      prefetchDepth_(driverCtx->queryConfig().arrowStreamPrefetchDepth()),
+      executor_(prefetchExecutor(driverCtx)) {
+  // Each driver reads every numDrivers'th stream starting at its driver id.
+  const auto& arrowStreams = arrowStreamNode->arrowStreams();
+  const uint32_t numDrivers = driverCtx->driver != nullptr
+      ? driverCtx->task->numDrivers(driverCtx->driver)
+      : 1;
+  for (size_t i = driverCtx->driverId; i < arrowStreams.size();
+       i += numDrivers) {
+    arrowStreams_.push_back(arrowStreams[i]);
+  }
 }
 
 ArrowStream::~ArrowStream() {
   close();
 }
 
-RowVectorPtr ArrowStream::getOutput() {
-  // Get Arrow array.
-  struct ArrowArray arrowArray;
-  if (arrowStream_->get_next(arrowStream_.get(), &arrowArray)) {
-    if (arrowArray.release) {
-      arrowArray.release(&arrowArray);
+bool ArrowStream::fetchNext(Batch& batch) {
+  for (; streamIndex_ < arrowStreams_.size(); ++streamIndex_) {
+    auto* arrowStream = arrowStreams_[streamIndex_].get();
+    // Get Arrow array.
+    if (arrowStream->get_next(arrowStream, &batch.array)) {
+      if (batch.array.release) {
+        batch.array.release(&batch.array);
+      }
+      VELOX_FAIL(
+          "Failed to call get_next on ArrowStream: {}",
+          std::string(getError(arrowStream)));
+    }
+    if (batch.array.release == nullptr) {
+      // End of this stream.
+      continue;
+    }
+
+    // Get Arrow schema.
+    if (arrowStream->get_schema(arrowStream, &batch.schema)) {
+      if (batch.schema.release) {
+        batch.schema.release(&batch.schema);
+      }
+      batch.array.release(&batch.array);
+      VELOX_FAIL(
+          "Failed to call get_schema on ArrowStream: {}",
+          std::string(getError(arrowStream)));
     }
-    VELOX_FAIL(
-        "Failed to call get_next on ArrowStream: {}", std::string(getError()));
+    return true;
   }
-  if (arrowArray.release == nullptr) {
-    // End of Stream.
-    finished_ = true;
-    return nullptr;
+  return false;
+}
+
+RowVectorPtr ArrowStream::importBatch(Batch& batch) {
+  // Convert Arrow Array into RowVector and return.
+  return std::dynamic_pointer_cast<RowVector>(
+      importFromArrowAsOwner(batch.schema, batch.array, pool()));
+}
+
+RowVectorPtr ArrowStream::getOutput() {
+  Batch batch;
+  if (executor_ == nullptr) {
+    if (!fetchNext(batch)) {
+      finished_ = true;
+      return nullptr;
+    }
+    return importBatch(batch);
   }
 
-  // Get Arrow schema.
-  struct ArrowSchema arrowSchema;
-  if (arrowStream_->get_schema(arrowStream_.get(), &arrowSchema)) {
-    if (arrowSchema.release) {
-      arrowSchema.release(&arrowSchema);
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (error_) {
+      std::rethrow_exception(error_);
     }
-    if (arrowArray.release) {
-      arrowArray.release(&arrowArray);
+    if (prefetched_.empty()) {
+      finished_ = atEnd_;
+      maybeScheduleFetchLocked();
+      return nullptr;
     }
-    VELOX_FAIL(
-        "Failed to call get_schema on ArrowStream: {}",
-        std::string(getError()));
+    batch = prefetched_.front();
+    prefetched_.pop_front();
+    maybeScheduleFetchLocked();
   }
+  return importBatch(batch);
+}
 
-  // Convert Arrow Array into RowVector and return.
-  return std::dynamic_pointer_cast<RowVector>(
-      importFromArrowAsOwner(arrowSchema, arrowArray, pool()));
+BlockingReason ArrowStream::isBlocked(ContinueFuture* future) {
+  if (executor_ == nullptr) {
+    return BlockingReason::kNotBlocked;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  maybeScheduleFetchLocked();
+  if (!prefetched_.empty() || error_ || atEnd_) {
+    return BlockingReason::kNotBlocked;
+  }
+  consumerPromise_ = ContinuePromise("ArrowStream::isBlocked");
+  *future = consumerPromise_->getSemiFuture();
+  return BlockingReason::kWaitForProducer;
+}
+
+void ArrowStream::maybeScheduleFetchLocked() {
+  if (fetching_ || atEnd_ || error_ || closed_ ||
+      prefetched_.size() >= prefetchDepth_) {
+    return;
+  }
+  fetching_ = true;
+  executor_->add([this]() { fetchAsync(); });
+}
+
+void ArrowStream::fetchAsync() {
+  Batch batch;
+  bool hasBatch = false;
+  std::exception_ptr error;
+  try {
+    hasBatch = fetchNext(batch);
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  std::optional<ContinuePromise> promise;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    fetching_ = false;
+    if (error) {
+      error_ = error;
+    } else if (hasBatch) {
+      prefetched_.push_back(batch);
+    } else {
+      atEnd_ = true;
+    }
+    maybeScheduleFetchLocked();
+    promise = std::move(consumerPromise_);
+    consumerPromise_.reset();
+    // close() may destroy 'this' as soon as the mutex is released.
+    fetchDone_.notify_all();
+  }
+  if (promise.has_value()) {
+    promise->setValue();
+  }
 }
 
 bool ArrowStream::isFinished() {
   return finished_;
 }
 
-const char* ArrowStream::getError() const {
-  const char* lastError = arrowStream_->get_last_error(arrowStream_.get());
+const char* ArrowStream::getError(ArrowArrayStream* arrowStream) const {
+  const char* lastError = arrowStream->get_last_error(arrowStream);
   VELOX_CHECK_NOT_NULL(lastError);
   return lastError;
 }
 
 void ArrowStream::close() {
-  if (arrowStream_->release) {
-    arrowStream_->release(arrowStream_.get());
+  {
+    std::unique_lock<std::mutex> l(mutex_);
+    closed_ = true;
+    fetchDone_.wait(l, [&]() { return !fetching_; });
+    for (auto& batch : prefetched_) {
+      batch.schema.release(&batch.schema);
+      batch.array.release(&batch.array);
+    }
+    prefetched_.clear();
+  }
+  for (auto& arrowStream : arrowStreams_) {
+    if (arrowStream->release) {
+      arrowStream->release(arrowStream.get());
+    }
   }
   SourceOperator::close();
 }
@@ -20,6 +20,11 @@
 
 namespace facebook::velox::exec {
 
+/// Reads the Arrow array streams of an ArrowStreamNode assigned to this
+/// driver. With arrow_stream_prefetch_depth > 0, up to that many batches are
+/// fetched ahead on the query executor while the driver processes earlier
+/// ones. The fetched arrays are imported without copying on the driver
+/// thread.
 class ArrowStream : public SourceOperator {
  public:
   ArrowStream(
@@ -31,20 +36,54 @@ class ArrowStream : public SourceOperator {
 
   RowVectorPtr getOutput() override;
 
-  BlockingReason isBlocked(ContinueFuture* /* unused */) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override;
 
   void close() override;
 
  private:
+  // An Arrow array and its schema as returned by an Arrow stream.
+  struct Batch {
+    ArrowArray array;
+    ArrowSchema schema;
+  };
+
   /// Return last error in Arrow array stream.
-  const char* getError() const;
+  const char* getError(ArrowArrayStream* arrowStream) const;
+
+  // Reads the next batch from the streams of this driver into 'batch'.
+  // Returns false at the end of the last stream. Throws on stream errors.
+  bool fetchNext(Batch& batch);
+
+  RowVectorPtr importBatch(Batch& batch);
+
+  // Schedules a fetch on 'executor_' if none is running and there is room
+  // for another batch in 'prefetched_'.
+  void maybeScheduleFetchLocked();
+
+  // Runs on 'executor_'. Fetches one batch into 'prefetched_'.
+  void fetchAsync();
 
   bool finished_ = false;
-  std::shared_ptr<ArrowArrayStream> arrowStream_;
+
+  // The streams read by this driver and the index of the one being read.
+  std::vector<std::shared_ptr<ArrowArrayStream>> arrowStreams_;
+  size_t streamIndex_{0};
+
+  const uint32_t prefetchDepth_;
+  folly::Executor* const executor_;
+
+  // Serializes the state below between the driver and the executor. The
+  // streams are accessed only by the fetch in flight, if any.
+  std::mutex mutex_;
+  std::condition_variable fetchDone_;
+  std::deque<Batch> prefetched_;
+  std::exception_ptr error_;
+  bool fetching_{false};
+  bool atEnd_{false};
+  bool closed_{false};
+  std::optional<ContinuePromise> consumerPromise_;
 };
 
 } // namespace facebook::velox::exec
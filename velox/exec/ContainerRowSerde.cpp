@@ -23,46 +23,45 @@ namespace facebook::velox::exec {
 
 namespace {
 
-// Copy from vector to stream.
-void serializeSwitch(
-    const BaseVector& source,
-    vector_size_t index,
-    ByteStream& out);
+// Appends to a std::string through the part of the ByteStream interface used
+// by serialization, so that a value can be serialized into contiguous memory.
+class StringOutput {
+ public:
+  explicit StringOutput(std::string& out) : out_(out) {}
+
+  template <typename T>
+  void appendOne(const T& value) {
+    out_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
 
-template <TypeKind Kind>
-void serializeOne(
-    const BaseVector& vector,
-    vector_size_t index,
-    ByteStream& stream) {
-  using T = typename TypeTraits<Kind>::NativeType;
-  stream.appendOne<T>(vector.asUnchecked<SimpleVector<T>>()->valueAt(index));
-}
+  template <typename T>
+  void append(folly::Range<const T*> values) {
+    out_.append(
+        reinterpret_cast<const char*>(values.data()),
+        values.size() * sizeof(T));
+  }
 
-template <>
-void serializeOne<TypeKind::VARCHAR>(
-    const BaseVector& vector,
-    vector_size_t index,
-    ByteStream& stream) {
-  auto string = vector.asUnchecked<SimpleVector<StringView>>()->valueAt(index);
-  stream.appendOne<int32_t>(string.size());
-  stream.appendStringPiece(folly::StringPiece(string.data(), string.size()));
-}
+  void appendStringPiece(folly::StringPiece value) {
+    out_.append(value.data(), value.size());
+  }
 
-template <>
-void serializeOne<TypeKind::VARBINARY>(
-    const BaseVector& vector,
-    vector_size_t index,
-    ByteStream& stream) {
+ private:
+  std::string& out_;
+};
+
+// Copy from vector to stream. 'Out' is a ByteStream or a StringOutput.
+template <typename Out>
+void serializeSwitch(const BaseVector& source, vector_size_t index, Out& out);
+
+template <typename Out>
+void serializeString(const BaseVector& vector, vector_size_t index, Out& out) {
   auto string = vector.asUnchecked<SimpleVector<StringView>>()->valueAt(index);
-  stream.appendOne<int32_t>(string.size());
-  stream.appendStringPiece(folly::StringPiece(string.data(), string.size()));
+  out.template appendOne<int32_t>(string.size());
+  out.appendStringPiece(folly::StringPiece(string.data(), string.size()));
 }
 
-template <>
-void serializeOne<TypeKind::ROW>(
-    const BaseVector& vector,
-    vector_size_t index,
-    ByteStream& out) {
+template <typename Out>
+void serializeRow(const BaseVector& vector, vector_size_t index, Out& out) {
   auto row = vector.wrappedVector()->asUnchecked<RowVector>();
   auto wrappedIndex = vector.wrappedIndex(index);
   const auto& type = row->type()->as<TypeKind::ROW>();
@@ -78,7 +77,7 @@ void serializeOne<TypeKind::ROW>(
       bits::setBit(nulls.data(), i);
     }
   }
-  out.append<uint64_t>(nulls);
+  out.template append<uint64_t>(nulls);
   for (auto i = 0; i < children.size(); ++i) {
     if (!bits ::isBitSet(nulls.data(), i)) {
       serializeSwitch(*children[i], wrappedIndex, out);
@@ -86,11 +85,12 @@ void serializeOne<TypeKind::ROW>(
   }
 }
 
+template <typename Out>
 void writeNulls(
     const BaseVector& values,
     vector_size_t offset,
     vector_size_t size,
-    ByteStream& out) {
+    Out& out) {
   for (auto i = 0; i < size; i += 64) {
     uint64_t flags = 0;
     auto end = i + 64 < size ? 64 : size - i;
@@ -99,14 +99,15 @@ void writeNulls(
         bits::setBit(&flags, bit, true);
       }
     }
-    out.appendOne<uint64_t>(flags);
+    out.template appendOne<uint64_t>(flags);
   }
 }
 
+template <typename Out>
 void writeNulls(
     const BaseVector& values,
     folly::Range<const vector_size_t*> indices,
-    ByteStream& out) {
+    Out& out) {
   auto size = indices.size();
   for (auto i = 0; i < size; i += 64) {
     uint64_t flags = 0;
@@ -116,16 +117,17 @@ void writeNulls(
         bits::setBit(&flags, bit, true);
       }
     }
-    out.appendOne<uint64_t>(flags);
+    out.template appendOne<uint64_t>(flags);
   }
 }
 
+template <typename Out>
 void serializeArray(
     const BaseVector& elements,
     vector_size_t offset,
     vector_size_t size,
-    ByteStream& out) {
-  out.appendOne<int32_t>(size);
+    Out& out) {
+  out.template appendOne<int32_t>(size);
   writeNulls(elements, offset, size, out);
   for (auto i = 0; i < size; ++i) {
     if (!elements.isNullAt(i + offset)) {
@@ -134,11 +136,12 @@ void serializeArray(
   }
 }
 
+template <typename Out>
 void serializeArray(
     const BaseVector& elements,
     folly::Range<const vector_size_t*> indices,
-    ByteStream& out) {
-  out.appendOne<int32_t>(indices.size());
+    Out& out) {
+  out.template appendOne<int32_t>(indices.size());
   writeNulls(elements, indices, out);
   for (auto i : indices) {
     if (!elements.isNullAt(i)) {
@@ -147,40 +150,37 @@ void serializeArray(
   }
 }
 
-template <>
-void serializeOne<TypeKind::ARRAY>(
-    const BaseVector& source,
-    vector_size_t index,
-    ByteStream& out) {
-  auto array = source.wrappedVector()->asUnchecked<ArrayVector>();
-  auto wrappedIndex = source.wrappedIndex(index);
-  serializeArray(
-      *array->elements(),
-      array->offsetAt(wrappedIndex),
-      array->sizeAt(wrappedIndex),
-      out);
-}
-
-template <>
-void serializeOne<TypeKind::MAP>(
-    const BaseVector& vector,
-    vector_size_t index,
-    ByteStream& out) {
-  auto map = vector.wrappedVector()->asUnchecked<MapVector>();
-  auto wrappedIndex = vector.wrappedIndex(index);
-  auto size = map->sizeAt(wrappedIndex);
-  auto offset = map->offsetAt(wrappedIndex);
-  auto indices = map->sortedKeyIndices(wrappedIndex);
-  serializeArray(*map->mapKeys(), indices, out);
-  serializeArray(*map->mapValues(), indices, out);
+template <TypeKind Kind, typename Out>
+void serializeOne(const BaseVector& vector, vector_size_t index, Out& out) {
+  if constexpr (Kind == TypeKind::VARCHAR || Kind == TypeKind::VARBINARY) {
+    serializeString(vector, index, out);
+  } else if constexpr (Kind == TypeKind::ROW) {
+    serializeRow(vector, index, out);
+  } else if constexpr (Kind == TypeKind::ARRAY) {
+    auto array = vector.wrappedVector()->asUnchecked<ArrayVector>();
+    auto wrappedIndex = vector.wrappedIndex(index);
+    serializeArray(
+        *array->elements(),
+        array->offsetAt(wrappedIndex),
+        array->sizeAt(wrappedIndex),
+        out);
+  } else if constexpr (Kind == TypeKind::MAP) {
+    auto map = vector.wrappedVector()->asUnchecked<MapVector>();
+    auto wrappedIndex = vector.wrappedIndex(index);
+    auto indices = map->sortedKeyIndices(wrappedIndex);
+    serializeArray(*map->mapKeys(), indices, out);
+    serializeArray(*map->mapValues(), indices, out);
+  } else {
+    using T = typename TypeTraits<Kind>::NativeType;
+    out.template appendOne<T>(
+        vector.asUnchecked<SimpleVector<T>>()->valueAt(index));
+  }
 }
 
-void serializeSwitch(
-    const BaseVector& source,
-    vector_size_t index,
-    ByteStream& stream) {
+template <typename Out>
+void serializeSwitch(const BaseVector& source, vector_size_t index, Out& out) {
   VELOX_DYNAMIC_TYPE_DISPATCH(
-      serializeOne, source.typeKind(), source, index, stream);
+      serializeOne, source.typeKind(), source, index, out);
 }
 
 // Copy from serialization to vector.
@@ -811,6 +811,44 @@ void ContainerRowSerde::serialize(
   serializeSwitch(source, index, out);
 }
 
+// static
+void ContainerRowSerde::serialize(
+    const BaseVector& source,
+    vector_size_t index,
+    std::string& out) {
+  VELOX_DCHECK(
+      !source.isNullAt(index), "Null top-level values are not supported");
+  StringOutput output(out);
+  serializeSwitch(source, index, output);
+}
+
+// static
+bool ContainerRowSerde::isBinaryEqualityComparable(const Type& type) {
+  switch (type.kind()) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::HUGEINT:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+    case TypeKind::TIMESTAMP:
+      return true;
+    case TypeKind::ARRAY:
+    case TypeKind::MAP:
+    case TypeKind::ROW:
+      for (const auto& child : type) {
+        if (!isBinaryEqualityComparable(*child)) {
+          return false;
+        }
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
 // static
 void ContainerRowSerde::deserialize(
     ByteStream& in,
@@ -29,6 +29,17 @@ class ContainerRowSerde {
   static void
   serialize(const BaseVector& source, vector_size_t index, ByteStream& out);
 
+  /// Appends the serialization of source[index] to 'out'. These are the same
+  /// bytes serialize() writes to a ByteStream.
+  static void
+  serialize(const BaseVector& source, vector_size_t index, std::string& out);
+
+  /// Returns true if two values of 'type' are equal exactly when their
+  /// serializations are equal, so that equality is a memcmp. Not so for
+  /// types with floating point values since 0.0 equals -0.0 and NaN does not
+  /// equal itself.
+  static bool isBinaryEqualityComparable(const Type& type);
+
   static void
   deserialize(ByteStream& in, vector_size_t index, BaseVector* result);
 
@@ -49,9 +49,61 @@ class TypedDistinctAggregations : public DistinctAggregations {
                 reinterpret_cast<AccumulatorType*>(group + offset_);
             accumulator->free(*allocator_);
           }
+        },
+        [this](folly::Range<char**> groups, VectorPtr& result) {
+          extractForSpill(groups, result);
         }};
   }
 
+  TypePtr spillType() const override {
+    return ARRAY(inputType_);
+  }
+
+  void extractForSpill(folly::Range<char**> groups, VectorPtr& result)
+      const override {
+    const auto numGroups = groups.size();
+    BufferPtr offsets = allocateOffsets(numGroups, pool_);
+    BufferPtr sizes = allocateSizes(numGroups, pool_);
+    auto* rawOffsets = offsets->asMutable<vector_size_t>();
+    auto* rawSizes = sizes->asMutable<vector_size_t>();
+
+    vector_size_t numValues = 0;
+    for (auto i = 0; i < numGroups; ++i) {
+      auto* accumulator =
+          reinterpret_cast<AccumulatorType*>(groups[i] + offset_);
+      rawOffsets[i] = numValues;
+      rawSizes[i] = accumulator->size();
+      numValues += rawSizes[i];
+    }
+
+    auto elements = BaseVector::create(inputType_, numValues, pool_);
+    for (auto i = 0; i < numGroups; ++i) {
+      auto* accumulator =
+          reinterpret_cast<AccumulatorType*>(groups[i] + offset_);
+      if constexpr (std::is_same_v<T, ComplexType>) {
+        accumulator->extractValues(*elements, rawOffsets[i]);
+      } else {
+        accumulator->extractValues(
+            *(elements->template as<FlatVector<T>>()), rawOffsets[i]);
+      }
+    }
+    result = std::make_shared<ArrayVector>(
+        pool_, spillType(), nullptr, numGroups, offsets, sizes, elements);
+  }
+
+  void addSingleGroupSpillInput(
+      char* group,
+      const VectorPtr& input,
+      vector_size_t index) override {
+    auto* arrayVector = input->as<ArrayVector>();
+    VELOX_CHECK_NOT_NULL(arrayVector);
+    decodedInput_.decode(*arrayVector->elements());
+
+    auto* accumulator = reinterpret_cast<AccumulatorType*>(group + offset_);
+    RowSizeTracker<char, uint32_t> tracker(group[rowSizeOffset_], *allocator_);
+    accumulator->addValues(*arrayVector, index, decodedInput_, allocator_);
+  }
+
   void initializeNewGroups(
       char** groups,
       folly::Range<const vector_size_t*> indices) override {
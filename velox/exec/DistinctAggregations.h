@@ -76,6 +76,22 @@ class DistinctAggregations {
       folly::Range<char**> groups,
       const RowVectorPtr& result) = 0;
 
+  /// Returns the type of the per-group unique values in spill files. This is
+  /// an array of the inputs.
+  virtual TypePtr spillType() const = 0;
+
+  /// Copies the unique values of 'groups' into 'result' of spillType().
+  virtual void extractForSpill(
+      folly::Range<char**> groups,
+      VectorPtr& result) const = 0;
+
+  /// Adds the values at 'index' in 'input' of spillType() to 'group'. Used for
+  /// merging spilled groups.
+  virtual void addSingleGroupSpillInput(
+      char* group,
+      const VectorPtr& input,
+      vector_size_t index) = 0;
+
  protected:
   HashStringAllocator* allocator_;
   int32_t offset_;
@@ -22,6 +22,8 @@
 #include "velox/common/process/TraceContext.h"
 #include "velox/common/testutil/TestValue.h"
 #include "velox/common/time/Timer.h"
+#include "velox/exec/DriverScheduler.h"
+#include "velox/exec/NumaExecutor.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
@@ -74,7 +76,11 @@ std::optional<Spiller::Config> DriverCtx::makeSpillConfig(
       queryConfig.aggregationSpillPartitionBits(),
       queryConfig.maxSpillLevel(),
       queryConfig.testingSpillPct(),
-      queryConfig.spillCompressionKind());
+      queryConfig.spillCompressionKind(),
+      queryConfig.joinSpillAdaptivePartitionBits(),
+      queryConfig.spillFormat(),
+      task->spillDirectories(),
+      queryConfig.spillColdPartitionsFirst());
 }
 
 std::atomic_uint64_t BlockingState::numBlockedDrivers_{0};
@@ -202,8 +208,33 @@ void Driver::enqueue(std::shared_ptr<Driver> driver) {
   if (driver->closed_) {
     return;
   }
-  driver->task()->queryCtx()->executor()->add(
-      [driver]() { Driver::run(driver); });
+  auto* executor = driver->task()->queryCtx()->executor();
+  if (auto* scheduler = dynamic_cast<DriverScheduler*>(executor)) {
+    scheduler->add(
+        driver->task()->queryCtx()->queryId(),
+        driver->scheduledCpuNanos_,
+        [driver]() {
+          DeltaCpuWallTimer timer([&](const CpuWallTiming& timing) {
+            driver->scheduledCpuNanos_ += timing.cpuNanos;
+          });
+          Driver::run(driver);
+        });
+    return;
+  }
+  if (auto* numaExecutor = dynamic_cast<NumaExecutor*>(executor)) {
+    // Keeps the Driver on one node so that its memory stays local.
+    numaExecutor->add(
+        driver->driverCtx()->driverId % numaExecutor->numNodes(),
+        [driver]() { Driver::run(driver); });
+    return;
+  }
+  executor->add([driver]() { Driver::run(driver); });
+}
+
+Driver::~Driver() {
+  if (profileActivity_ != nullptr) {
+    DriverProfiler::instance().remove(profileActivity_.get());
+  }
 }
 
 void Driver::init(
@@ -215,6 +246,9 @@ void Driver::init(
   operators_ = std::move(operators);
   curOpIndex_ = operators_.size() - 1;
   trackOperatorCpuUsage_ = ctx_->queryConfig().operatorTrackCpuUsage();
+  resumeAtBlockedOperator_ =
+      ctx_->queryConfig().driverResumeAtBlockedOperator();
+  adaptiveOutputBatchRows_ = ctx_->queryConfig().adaptiveOutputBatchRows();
 }
 
 namespace {
@@ -237,6 +271,16 @@ void Driver::initializeOperators() {
     return;
   }
   operatorsInitialized_ = true;
+  if (ctx_->queryConfig().driverProfilingEnabled()) {
+    std::vector<std::string> operatorTypes(operators_.size());
+    for (auto& op : operators_) {
+      operatorTypes[op->operatorId()] = op->operatorType();
+    }
+    profileActivity_ =
+        std::make_unique<DriverProfiler::Activity>(std::move(operatorTypes));
+    ctx_->threadDebugInfo.profileFrames_ = &profileActivity_->frames;
+    DriverProfiler::instance().add(profileActivity_.get());
+  }
   for (auto& op : operators_) {
     op->initialize();
   }
@@ -316,6 +360,8 @@ void Driver::enqueueInternal() {
 
 #define CALL_OPERATOR(call, operator, methodName)                       \
   try {                                                                 \
+    DriverProfiler::ScopedOperator profiledOperator(                    \
+        profileActivity_.get(), operator->operatorId());                \
     call;                                                               \
   } catch (const VeloxException& e) {                                   \
     throw;                                                              \
@@ -386,8 +432,13 @@ StopReason Driver::runInternal(
     const int32_t numOperators = operators_.size();
     ContinueFuture future;
 
+    // The operators after 'curOpIndex_' had nothing to do when 'this' went
+    // off thread. Their state changes only when input is added from below,
+    // which happens in the walk anyway.
+    int32_t startIndex =
+        resumeAtBlockedOperator_ ? curOpIndex_ : numOperators - 1;
     for (;;) {
-      for (int32_t i = numOperators - 1; i >= 0; --i) {
+      for (int32_t i = startIndex; i >= 0; --i) {
         stop = task()->shouldStop();
         if (stop != StopReason::kNone) {
           guard.notThrown();
@@ -435,6 +486,7 @@ StopReason Driver::runInternal(
               auto timer = createDeltaCpuWallTimer(
                   [op](const CpuWallTiming& deltaTiming) {
                     op->stats().wlock()->getOutputTiming.add(deltaTiming);
+                    op->reportGetOutputLatency(deltaTiming.wallNanos);
                   });
               RuntimeStatWriterScopeGuard statsWriterGuard(op);
               CALL_OPERATOR(result = op->getOutput(), op, "getOutput");
@@ -456,6 +508,7 @@ StopReason Driver::runInternal(
               auto timer = createDeltaCpuWallTimer(
                   [nextOp](const CpuWallTiming& timing) {
                     nextOp->stats().wlock()->addInputTiming.add(timing);
+                    nextOp->reportAddInputLatency(timing.wallNanos);
                   });
               {
                 auto lockedStats = nextOp->stats().wlock();
@@ -467,6 +520,11 @@ StopReason Driver::runInternal(
                   nextOp);
 
               CALL_OPERATOR(nextOp->addInput(result), nextOp, "addInput");
+              if (adaptiveOutputBatchRows_) {
+                // The lazy columns 'nextOp' needed are loaded now.
+                op->recordOutputBatchSize(
+                    result->estimateFlatSize(), result->size());
+              }
 
               // The next iteration will see if operators_[i + 1] has
               // output now that it got input.
@@ -516,6 +574,7 @@ StopReason Driver::runInternal(
             auto timer =
                 createDeltaCpuWallTimer([op](const CpuWallTiming& timing) {
                   op->stats().wlock()->getOutputTiming.add(timing);
+                  op->reportGetOutputLatency(timing.wallNanos);
                 });
             CALL_OPERATOR(result = op->getOutput(), op, "getOutput");
             if (result) {
@@ -545,6 +604,7 @@ StopReason Driver::runInternal(
           continue;
         }
       }
+      startIndex = numOperators - 1;
     }
   } catch (velox::VeloxException& e) {
     task()->setError(std::current_exception());
@@ -627,11 +687,19 @@ void Driver::closeOperators() {
     op->close();
   }
 
+  if (profileActivity_ != nullptr) {
+    DriverProfiler::instance().remove(profileActivity_.get());
+  }
+
   // Add operator stats to the task.
   for (auto& op : operators_) {
     auto stats = op->stats(true);
     stats.memoryStats.update(op->pool());
     stats.numDrivers = 1;
+    if (profileActivity_ != nullptr) {
+      stats.profileSamples =
+          std::move(profileActivity_->samples[op->operatorId()]);
+    }
     task()->addOperatorStats(stats);
   }
 }
@@ -814,6 +882,8 @@ std::string blockingReasonToString(BlockingReason reason) {
       return "kWaitForConnector";
     case BlockingReason::kWaitForSpill:
       return "kWaitForSpill";
+    case BlockingReason::kWaitForOrderByPeers:
+      return "kWaitForOrderByPeers";
   }
   VELOX_UNREACHABLE();
   return "";
@@ -25,6 +25,7 @@
 #include "velox/connectors/Connector.h"
 #include "velox/core/PlanNode.h"
 #include "velox/core/QueryCtx.h"
+#include "velox/exec/DriverProfiler.h"
 #include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
@@ -106,6 +107,9 @@ struct ThreadState {
   // memory, which a third party can revoke while the thread is in
   // this state.
   bool isSuspended{false};
+  // True if created but held back by the Task until its pipeline needs more
+  // drivers. See QueryConfig::kTableScanInitialDrivers.
+  bool isParked{false};
 
   bool isOnThread() const {
     return thread != std::thread::id();
@@ -133,6 +137,7 @@ struct ThreadState {
     obj["isEnqueued"] = isEnqueued.load();
     obj["hasBlockingFuture"] = hasBlockingFuture;
     obj["isSuspended"] = isSuspended;
+    obj["isParked"] = isParked;
     return folly::toPrettyJson(obj);
   }
 };
@@ -161,6 +166,9 @@ enum class BlockingReason {
   /// Build operator is blocked waiting for all its peers to stop to run group
   /// spill on all of them.
   kWaitForSpill,
+  /// OrderBy operator is blocked waiting for all its peers to sort their
+  /// input before the sorted rows are divided into key ranges.
+  kWaitForOrderByPeers,
 };
 
 std::string blockingReasonToString(BlockingReason reason);
@@ -245,6 +253,8 @@ struct DriverCtx {
 
 class Driver : public std::enable_shared_from_this<Driver> {
  public:
+  ~Driver();
+
   static void enqueue(std::shared_ptr<Driver> instance);
 
   /// Run the pipeline until it produces a batch of data or gets blocked.
@@ -370,6 +380,10 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   // Timer used to track down the time we are sitting in the driver queue.
   size_t queueTimeStartMicros_{0};
+
+  // CPU time used by the slices of 'this' run by a DriverScheduler. Decides
+  // the scheduler's level for the next slice.
+  std::atomic<uint64_t> scheduledCpuNanos_{0};
   // Index of the current operator to run (or the 1st one if we haven't
   // started yet). Used to determine which operator's queueTime we should
   // update.
@@ -381,6 +395,19 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   bool trackOperatorCpuUsage_;
 
+  // Set from QueryConfig::kDriverResumeAtBlockedOperator. If true,
+  // runInternal() starts from 'curOpIndex_' instead of the last operator.
+  bool resumeAtBlockedOperator_{false};
+
+  // Set from QueryConfig::kAdaptiveOutputBatchRows. If true, the size of
+  // each batch passed between operators is recorded with
+  // Operator::recordOutputBatchSize().
+  bool adaptiveOutputBatchRows_{false};
+
+  // Set on first run if QueryConfig::kDriverProfilingEnabled. Registered
+  // with DriverProfiler until the operators are closed.
+  std::unique_ptr<DriverProfiler::Activity> profileActivity_;
+
   // Indicates that a DriverAdapter can rearrange Operators. Set to false at end
   // of DriverFactory::createDriver().
   bool isAdaptable_{true};
@@ -490,6 +517,16 @@ struct DriverFactory {
     return std::nullopt;
   }
 
+  /// Returns TableScan plan node ID if the pipeline reads splits of a table.
+  std::optional<core::PlanNodeId> needsTableScan() const {
+    VELOX_CHECK(!planNodes.empty());
+    if (auto scanNode = std::dynamic_pointer_cast<const core::TableScanNode>(
+            planNodes.front())) {
+      return scanNode->id();
+    }
+    return std::nullopt;
+  }
+
   /// Returns LocalPartition plan node ID if the pipeline gets data from a
   /// local exchange.
   std::optional<core::PlanNodeId> needsLocalExchange() const {
@@ -510,6 +547,11 @@ struct DriverFactory {
   /// based on this pipeline.
   std::vector<core::PlanNodeId> needsNestedLoopJoinBridges() const;
 
+  /// Returns the plan node ID of the partial OrderBy that ends this pipeline
+  /// if the pipeline feeds a LocalMerge. An OrderByBridge must be created for
+  /// it.
+  std::vector<core::PlanNodeId> needsOrderByBridges() const;
+
   static std::vector<DriverAdapter> adapters;
 };
 
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/DriverProfiler.h"
+
+#include <gflags/gflags.h>
+#include <thread>
+
+DEFINE_int32(
+    driver_profile_interval_ms,
+    10,
+    "Interval between samples of Drivers with driver_profiling_enabled");
+
+namespace facebook::velox::exec {
+
+// static
+DriverProfiler& DriverProfiler::instance() {
+  // Leaked so that the sampling thread never outlives it.
+  static auto* profiler = new DriverProfiler();
+  return *profiler;
+}
+
+void DriverProfiler::add(Activity* activity) {
+  std::lock_guard<std::mutex> l(mutex_);
+  activities_.insert(activity);
+  if (!started_) {
+    started_ = true;
+    std::thread([this]() { run(); }).detach();
+  }
+  if (activities_.size() == 1) {
+    activitiesChanged_.notify_one();
+  }
+}
+
+void DriverProfiler::remove(Activity* activity) {
+  std::lock_guard<std::mutex> l(mutex_);
+  activities_.erase(activity);
+}
+
+void DriverProfiler::run() {
+  std::unique_lock<std::mutex> l(mutex_);
+  for (;;) {
+    activitiesChanged_.wait(l, [&]() { return !activities_.empty(); });
+    activitiesChanged_.wait_for(
+        l, std::chrono::milliseconds(FLAGS_driver_profile_interval_ms));
+    sample();
+  }
+}
+
+void DriverProfiler::sample() {
+  std::string stack;
+  for (auto* activity : activities_) {
+    const auto index =
+        activity->operatorIndex.load(std::memory_order_relaxed);
+    if (index < 0) {
+      continue;
+    }
+    stack = activity->operatorTypes[index];
+    for (const auto* name : activity->frames.read()) {
+      if (name == nullptr) {
+        // Read while the first push to this depth is in progress.
+        break;
+      }
+      stack.push_back(';');
+      stack.append(name);
+    }
+    ++activity->samples[index][stack];
+  }
+}
+
+} // namespace facebook::velox::exec
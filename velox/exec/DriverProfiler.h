@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "velox/common/process/ThreadDebugInfo.h"
+
+namespace facebook::velox::exec {
+
+/// Sampling profiler for Drivers. A background thread periodically looks at
+/// what each registered Driver is running and counts the samples by stack of
+/// operator and expressions. The Driver publishes the operator it calls and
+/// Expr publishes the expressions it evaluates through ThreadDebugInfo, so a
+/// sample costs the profiled thread nothing and needs no signal handler.
+/// Samples of a Driver that is not in an operator call, e.g. one that is
+/// blocked or queued, are not counted.
+class DriverProfiler {
+ public:
+  /// Sample counts keyed on folded stack, i.e. the operator type followed by
+  /// the expressions being evaluated, separated by ';'. This is the input
+  /// format of flame graph tools.
+  using Stacks = std::unordered_map<std::string, uint64_t>;
+
+  /// What a Driver is running. Written by the Driver's thread and read by
+  /// the sampling thread.
+  struct Activity {
+    explicit Activity(std::vector<std::string> _operatorTypes)
+        : operatorTypes(std::move(_operatorTypes)),
+          samples(operatorTypes.size()) {}
+
+    /// Index into 'operatorTypes' of the operator being called, -1 if none.
+    std::atomic<int32_t> operatorIndex{-1};
+
+    /// Expressions being evaluated. Set as ThreadDebugInfo::profileFrames_
+    /// of the Driver's thread.
+    process::ProfileFrames frames;
+
+    /// Operator types of the Driver's operators in pipeline order.
+    const std::vector<std::string> operatorTypes;
+
+    /// Samples per operator, 1:1 with 'operatorTypes'. Written by the
+    /// sampling thread until the Activity is removed.
+    std::vector<Stacks> samples;
+  };
+
+  /// Sets 'activity->operatorIndex' to 'index' for the life of 'this'.
+  class ScopedOperator {
+   public:
+    ScopedOperator(Activity* activity, int32_t index) : activity_(activity) {
+      if (activity_ != nullptr) {
+        activity_->operatorIndex.store(index, std::memory_order_relaxed);
+      }
+    }
+
+    ~ScopedOperator() {
+      if (activity_ != nullptr) {
+        activity_->operatorIndex.store(-1, std::memory_order_relaxed);
+      }
+    }
+
+   private:
+    Activity* const activity_;
+  };
+
+  static DriverProfiler& instance();
+
+  /// Starts sampling 'activity'. Starts the sampling thread on first use.
+  void add(Activity* activity);
+
+  /// Stops sampling 'activity'. 'activity->samples' is not written after
+  /// this returns.
+  void remove(Activity* activity);
+
+ private:
+  DriverProfiler() = default;
+
+  void run();
+
+  // Adds a sample of each Activity in 'activities_'.
+  void sample();
+
+  std::mutex mutex_;
+  std::condition_variable activitiesChanged_;
+  std::unordered_set<Activity*> activities_;
+  // True once the sampling thread is started. The thread runs until the
+  // process exits.
+  bool started_{false};
+};
+
+} // namespace facebook::velox::exec
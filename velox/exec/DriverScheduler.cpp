@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/DriverScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <sstream>
+
+#include <folly/ScopeGuard.h>
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/base/SuccinctPrinter.h"
+#include "velox/common/process/ProcessBase.h"
+
+namespace facebook::velox::exec {
+namespace {
+uint64_t currentTimeNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+} // namespace
+
+DriverScheduler::DriverScheduler(folly::Executor* executor, Options options)
+    : executor_(executor), levelCpuNanos_(std::move(options.levelCpuNanos)) {
+  VELOX_CHECK_NOT_NULL(executor_);
+  VELOX_CHECK_GE(options.levelTimeMultiplier, 1);
+  for (auto i = 1; i < levelCpuNanos_.size(); ++i) {
+    VELOX_CHECK_LT(
+        levelCpuNanos_[i - 1],
+        levelCpuNanos_[i],
+        "Level CPU time bounds must be increasing");
+  }
+  const auto numLevels = levelCpuNanos_.size() + 1;
+  levelShares_.resize(numLevels);
+  uint64_t share = 1;
+  for (auto i = numLevels; i-- > 0;) {
+    levelShares_[i] = share;
+    share *= options.levelTimeMultiplier;
+  }
+  levels_.resize(numLevels);
+}
+
+void DriverScheduler::add(folly::Func func) {
+  add("", 0, std::move(func));
+}
+
+void DriverScheduler::add(
+    const std::string& queryId,
+    uint64_t accumulatedCpuNanos,
+    folly::Func func) {
+  const auto levelIndex = levelOf(accumulatedCpuNanos);
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto& level = levels_[levelIndex];
+    if (level.numQueued == 0) {
+      // A level that was empty does not get credit for the time it was idle.
+      for (const auto& other : levels_) {
+        if (other.numQueued > 0) {
+          level.virtualCpuNanos =
+              std::max(level.virtualCpuNanos, other.virtualCpuNanos);
+        }
+      }
+    }
+
+    auto it = queries_.find(queryId);
+    if (it == queries_.end()) {
+      // Same for a query that had no work.
+      const auto startCpuNanos = minActiveQueryCpuNanos();
+      it = queries_.emplace(queryId, QueryState{}).first;
+      auto weightIt = weights_.find(queryId);
+      if (weightIt != weights_.end()) {
+        it->second.weight = weightIt->second;
+      }
+      it->second.virtualCpuNanos = startCpuNanos;
+    }
+    ++it->second.numActive;
+
+    level.queries[queryId].push_back({std::move(func), currentTimeNanos()});
+    ++level.numQueued;
+  }
+  executor_->add([this]() { runNext(); });
+}
+
+void DriverScheduler::setQueryWeight(
+    const std::string& queryId,
+    uint32_t weight) {
+  VELOX_CHECK_GE(weight, 1);
+  std::lock_guard<std::mutex> l(mutex_);
+  weights_[queryId] = weight;
+  auto it = queries_.find(queryId);
+  if (it != queries_.end()) {
+    it->second.weight = weight;
+  }
+}
+
+void DriverScheduler::clearQueryWeight(const std::string& queryId) {
+  std::lock_guard<std::mutex> l(mutex_);
+  weights_.erase(queryId);
+  auto it = queries_.find(queryId);
+  if (it != queries_.end()) {
+    it->second.weight = 1;
+  }
+}
+
+int32_t DriverScheduler::levelOf(uint64_t cpuNanos) const {
+  return std::upper_bound(
+             levelCpuNanos_.begin(), levelCpuNanos_.end(), cpuNanos) -
+      levelCpuNanos_.begin();
+}
+
+uint64_t DriverScheduler::minActiveQueryCpuNanos() const {
+  std::optional<uint64_t> result;
+  for (const auto& [id, query] : queries_) {
+    if (query.numActive > 0) {
+      result = std::min(
+          result.value_or(query.virtualCpuNanos), query.virtualCpuNanos);
+    }
+  }
+  return result.value_or(0);
+}
+
+DriverScheduler::Slice DriverScheduler::nextSlice(
+    int32_t& levelIndex,
+    std::string& queryId) {
+  levelIndex = -1;
+  for (auto i = 0; i < levels_.size(); ++i) {
+    if (levels_[i].numQueued > 0 &&
+        (levelIndex == -1 ||
+         levels_[i].virtualCpuNanos < levels_[levelIndex].virtualCpuNanos)) {
+      levelIndex = i;
+    }
+  }
+  VELOX_CHECK_GE(levelIndex, 0, "No queued slice to run");
+  auto& level = levels_[levelIndex];
+
+  auto next = level.queries.end();
+  uint64_t minCpuNanos = 0;
+  for (auto it = level.queries.begin(); it != level.queries.end(); ++it) {
+    const auto cpuNanos = queries_[it->first].virtualCpuNanos;
+    if (next == level.queries.end() || cpuNanos < minCpuNanos) {
+      next = it;
+      minCpuNanos = cpuNanos;
+    }
+  }
+  VELOX_CHECK(next != level.queries.end());
+
+  queryId = next->first;
+  auto slice = std::move(next->second.front());
+  next->second.pop_front();
+  if (next->second.empty()) {
+    level.queries.erase(next);
+  }
+  --level.numQueued;
+  return slice;
+}
+
+void DriverScheduler::runNext() {
+  int32_t levelIndex;
+  std::string queryId;
+  Slice slice;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    slice = nextSlice(levelIndex, queryId);
+    auto& stats = levels_[levelIndex].stats;
+    const auto queuedNanos = currentTimeNanos() - slice.enqueueTimeNanos;
+    ++stats.numRuns;
+    stats.queuedWallNanos += queuedNanos;
+    stats.maxQueuedWallNanos =
+        std::max(stats.maxQueuedWallNanos, queuedNanos);
+  }
+
+  const auto startCpuNanos = process::threadCpuNanos();
+  SCOPE_EXIT {
+    const auto cpuNanos = process::threadCpuNanos() - startCpuNanos;
+    std::lock_guard<std::mutex> l(mutex_);
+    auto& level = levels_[levelIndex];
+    level.stats.cpuNanos += cpuNanos;
+    level.virtualCpuNanos += cpuNanos / levelShares_[levelIndex];
+    auto it = queries_.find(queryId);
+    VELOX_DCHECK(it != queries_.end());
+    auto& query = it->second;
+    query.virtualCpuNanos += cpuNanos / query.weight;
+    if (--query.numActive == 0) {
+      queries_.erase(it);
+    }
+  };
+  slice.func();
+}
+
+std::vector<DriverScheduler::LevelStats> DriverScheduler::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  std::vector<LevelStats> result;
+  result.reserve(levels_.size());
+  for (const auto& level : levels_) {
+    result.push_back(level.stats);
+    result.back().numQueued = level.numQueued;
+  }
+  return result;
+}
+
+std::string DriverScheduler::toString() const {
+  const auto levelStats = stats();
+  std::stringstream out;
+  out << "DriverScheduler:";
+  for (auto i = 0; i < levelStats.size(); ++i) {
+    const auto& stats = levelStats[i];
+    out << "\n  Level " << i << ": " << stats.numQueued << " queued, "
+        << stats.numRuns << " runs, CPU " << succinctNanos(stats.cpuNanos)
+        << ", queued avg "
+        << succinctNanos(
+               stats.numRuns == 0 ? 0 : stats.queuedWallNanos / stats.numRuns)
+        << " max " << succinctNanos(stats.maxQueuedWallNanos);
+  }
+  return out.str();
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <folly/Executor.h>
+#include <folly/container/F14Map.h>
+
+namespace facebook::velox::exec {
+
+/// Executor that orders Driver time slices with a multi-level feedback queue
+/// before running them on an underlying executor. Pass it as the executor of
+/// a QueryCtx to have the Drivers of the query scheduled by it.
+///
+/// A Driver is queued at a level that depends on the CPU time it has used so
+/// far. Drivers that have used little CPU, e.g. the ones of short interactive
+/// queries, are at level 0. Long running Drivers sink to lower levels. Each
+/// level gets a share of the CPU time that is 'levelTimeMultiplier' times
+/// smaller than the level above it, so that long running work is not starved.
+///
+/// Within a level, the queries get CPU time in proportion to their weight.
+/// A query that becomes runnable after being idle starts even with the other
+/// runnable queries instead of being credited for the time it was idle.
+///
+/// Each add() submits one task to the underlying executor. That task runs
+/// whichever queued slice is first in the above order, so the number of
+/// concurrent slices is bounded by the threads of the underlying executor.
+/// The scheduler must outlive the tasks submitted to the underlying executor.
+class DriverScheduler : public folly::Executor {
+ public:
+  struct Options {
+    /// Upper bounds of accumulated CPU time in nanoseconds for the levels
+    /// except the last one. A Driver that has used more CPU time than all the
+    /// bounds is at the last level. Must be increasing.
+    std::vector<uint64_t> levelCpuNanos{
+        1'000'000'000,
+        10'000'000'000,
+        60'000'000'000,
+        300'000'000'000};
+
+    /// Ratio of the CPU time share of a level to the share of the next one.
+    uint32_t levelTimeMultiplier{2};
+  };
+
+  struct LevelStats {
+    /// Number of slices that ran at this level.
+    uint64_t numRuns{0};
+
+    /// Sum of the time the slices spent queued before they started.
+    uint64_t queuedWallNanos{0};
+
+    /// Longest time a slice spent queued before it started.
+    uint64_t maxQueuedWallNanos{0};
+
+    /// Sum of the CPU time of the slices.
+    uint64_t cpuNanos{0};
+
+    /// Number of slices queued at the time of the call to stats().
+    uint64_t numQueued{0};
+  };
+
+  explicit DriverScheduler(folly::Executor* executor, Options options = {});
+
+  /// Queues 'func' at level 0 as work of an anonymous query.
+  void add(folly::Func func) override;
+
+  /// Queues 'func' as a slice of work for query 'queryId' with
+  /// 'accumulatedCpuNanos' of CPU time used by the same Driver so far.
+  void add(
+      const std::string& queryId,
+      uint64_t accumulatedCpuNanos,
+      folly::Func func);
+
+  /// Sets the relative CPU share of 'queryId' among the queries queued at the
+  /// same level. The default weight is 1.
+  void setQueryWeight(const std::string& queryId, uint32_t weight);
+
+  /// Removes the weight set for 'queryId'.
+  void clearQueryWeight(const std::string& queryId);
+
+  /// Returns the level for a Driver that has used 'cpuNanos' of CPU time.
+  int32_t levelOf(uint64_t cpuNanos) const;
+
+  int32_t numLevels() const {
+    return levelShares_.size();
+  }
+
+  std::vector<LevelStats> stats() const;
+
+  std::string toString() const;
+
+ private:
+  struct Slice {
+    folly::Func func;
+    uint64_t enqueueTimeNanos{0};
+  };
+
+  struct QueryState {
+    uint32_t weight{1};
+
+    // CPU time used by the query while scheduled, divided by 'weight'. The
+    // runnable query with the smallest value at a level runs next.
+    uint64_t virtualCpuNanos{0};
+
+    // Number of slices that are queued or running.
+    int32_t numActive{0};
+  };
+
+  struct Level {
+    // Queued slices by query id.
+    folly::F14FastMap<std::string, std::deque<Slice>> queries;
+
+    // CPU time used by the level divided by its share.
+    uint64_t virtualCpuNanos{0};
+
+    int32_t numQueued{0};
+
+    LevelStats stats;
+  };
+
+  // Runs the next slice. Called once from the underlying executor for each
+  // add().
+  void runNext();
+
+  // Picks and removes the next slice to run. Sets 'level' and 'queryId' to
+  // where the slice was queued.
+  Slice nextSlice(int32_t& level, std::string& queryId);
+
+  // Returns the smallest virtual CPU time of the queries that have work.
+  uint64_t minActiveQueryCpuNanos() const;
+
+  folly::Executor* const executor_;
+  const std::vector<uint64_t> levelCpuNanos_;
+
+  // Relative CPU share of each level.
+  std::vector<uint64_t> levelShares_;
+
+  mutable std::mutex mutex_;
+  std::vector<Level> levels_;
+  folly::F14FastMap<std::string, QueryState> queries_;
+  folly::F14FastMap<std::string, uint32_t> weights_;
+};
+
+} // namespace facebook::velox::exec
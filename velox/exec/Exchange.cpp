@@ -18,6 +18,14 @@
 
 namespace facebook::velox::exec {
 
+serializer::presto::PrestoVectorSerde::PrestoOptions exchangeSerdeOptions(
+    const core::QueryConfig& queryConfig) {
+  return serializer::presto::PrestoVectorSerde::PrestoOptions(
+      false,
+      common::stringToCompressionKind(queryConfig.exchangeCompressionKind()),
+      queryConfig.exchangePreserveEncodings());
+}
+
 bool Exchange::getSplits(ContinueFuture* future) {
   if (!processSplits_) {
     return false;
@@ -53,7 +61,7 @@ bool Exchange::getSplits(ContinueFuture* future) {
 }
 
 BlockingReason Exchange::isBlocked(ContinueFuture* future) {
-  if (currentPage_ || atEnd_) {
+  if (!currentPages_.empty() || atEnd_) {
     return BlockingReason::kNotBlocked;
   }
 
@@ -65,8 +73,11 @@ BlockingReason Exchange::isBlocked(ContinueFuture* future) {
   }
 
   ContinueFuture dataFuture;
-  currentPage_ = exchangeClient_->next(&atEnd_, &dataFuture);
-  if (currentPage_ || atEnd_) {
+  currentPages_ = exchangeClient_->next(
+      operatorCtx_->driverCtx()->queryConfig().preferredOutputBatchBytes(),
+      &atEnd_,
+      &dataFuture);
+  if (!currentPages_.empty() || atEnd_) {
     if (atEnd_ && noMoreSplits_) {
       const auto numSplits = stats_.rlock()->numSplits;
       operatorCtx_->task()->multipleSplitsFinished(numSplits);
@@ -96,37 +107,117 @@ bool Exchange::isFinished() {
 }
 
 RowVectorPtr Exchange::getOutput() {
-  if (!currentPage_) {
+  if (currentPages_.empty()) {
     return nullptr;
   }
 
+  if (!currentPage()->isSerialized()) {
+    return nextInProcessVector();
+  }
+
+  deserializeNextVector(result_);
+
+  // With many producers the pages are often small. The vectors of the queued
+  // serialized pages are then combined up to the preferred batch size so
+  // that the operators downstream see fewer, larger batches. Only small
+  // vectors are combined so that large ones are not copied.
+  const auto maxBytes =
+      operatorCtx_->driverCtx()->queryConfig().preferredOutputBatchBytes();
+  const auto maxRows = outputBatchRows();
+  vector_size_t numRows = result_->size();
+  uint64_t numBytes = result_->estimateFlatSize();
+  if (numRows >= maxRows / 2 || numBytes >= maxBytes / 2) {
+    return result_;
+  }
+
+  std::vector<RowVectorPtr> batches{result_};
+  while (numRows < maxRows && numBytes < maxBytes && !currentPages_.empty() &&
+         currentPage()->isSerialized()) {
+    RowVectorPtr batch;
+    deserializeNextVector(batch);
+    numRows += batch->size();
+    numBytes += batch->estimateFlatSize();
+    batches.push_back(std::move(batch));
+  }
+  if (batches.size() == 1) {
+    return result_;
+  }
+
+  auto output = BaseVector::create<RowVector>(outputType_, numRows, pool());
+  vector_size_t offset = 0;
+  for (const auto& batch : batches) {
+    output->copy(batch.get(), offset, 0, batch->size());
+    offset += batch->size();
+  }
+  return output;
+}
+
+void Exchange::deserializeNextVector(RowVectorPtr& result) {
   uint64_t rawInputBytes{0};
   if (!inputStream_) {
     inputStream_ = std::make_unique<ByteStream>();
-    rawInputBytes += currentPage_->size();
-    currentPage_->prepareStreamForDeserialize(inputStream_.get());
+    rawInputBytes += currentPage()->size();
+    currentPage()->prepareStreamForDeserialize(inputStream_.get());
   }
 
   getSerde()->deserialize(
-      inputStream_.get(), operatorCtx_->pool(), outputType_, &result_);
+      inputStream_.get(),
+      operatorCtx_->pool(),
+      outputType_,
+      &result,
+      &serdeOptions_);
 
   {
     auto lockedStats = stats_.wlock();
     lockedStats->rawInputBytes += rawInputBytes;
-    lockedStats->addInputVector(result_->estimateFlatSize(), result_->size());
+    lockedStats->addInputVector(result->estimateFlatSize(), result->size());
   }
 
   if (inputStream_->atEnd()) {
-    currentPage_ = nullptr;
     inputStream_ = nullptr;
+    nextPage();
+  }
+}
+
+void Exchange::nextPage() {
+  if (++currentPageIndex_ == currentPages_.size()) {
+    currentPages_.clear();
+    currentPageIndex_ = 0;
+  }
+}
+
+RowVectorPtr Exchange::nextInProcessVector() {
+  const auto& vectors = currentPage()->vectors();
+  VELOX_CHECK_LT(nextVector_, vectors.size());
+  const auto& vector = vectors[nextVector_];
+  // The page vectors live in the memory of the producer task, so they are
+  // copied into the memory of this operator. This flattens the dictionaries
+  // made by the producer.
+  auto copy = BaseVector::create(outputType_, vector->size(), pool());
+  copy->copy(vector.get(), 0, 0, vector->size());
+  result_ = std::static_pointer_cast<RowVector>(copy);
+
+  {
+    auto lockedStats = stats_.wlock();
+    if (nextVector_ == 0) {
+      lockedStats->rawInputBytes += currentPage()->size();
+    }
+    lockedStats->addInputVector(result_->estimateFlatSize(), result_->size());
   }
 
+  if (++nextVector_ == vectors.size()) {
+    nextVector_ = 0;
+    nextPage();
+  }
   return result_;
 }
 
 void Exchange::close() {
   SourceOperator::close();
-  currentPage_ = nullptr;
+  currentPages_.clear();
+  currentPageIndex_ = 0;
+  inputStream_ = nullptr;
+  nextVector_ = 0;
   result_ = nullptr;
   if (exchangeClient_) {
     recordExchangeClientStats();
@@ -17,9 +17,15 @@
 
 #include "velox/exec/ExchangeClient.h"
 #include "velox/exec/Operator.h"
+#include "velox/serializers/PrestoSerializer.h"
 
 namespace facebook::velox::exec {
 
+/// Returns the options for serializing and deserializing the pages exchanged
+/// between the tasks of a query with 'queryConfig'.
+serializer::presto::PrestoVectorSerde::PrestoOptions exchangeSerdeOptions(
+    const core::QueryConfig& queryConfig);
+
 struct RemoteConnectorSplit : public connector::ConnectorSplit {
   const std::string taskId;
 
@@ -46,6 +52,7 @@ class Exchange : public SourceOperator {
             exchangeNode->id(),
             operatorType),
         processSplits_{operatorCtx_->driverCtx()->driverId == 0},
+        serdeOptions_{exchangeSerdeOptions(ctx->queryConfig())},
         exchangeClient_{std::move(exchangeClient)} {}
 
   ~Exchange() override {
@@ -77,9 +84,25 @@ class Exchange : public SourceOperator {
   /// operator's stats.
   void recordExchangeClientStats();
 
+  /// Returns a copy of the next vector of an in-process currentPage() and
+  /// moves to the next page after its last vector.
+  RowVectorPtr nextInProcessVector();
+
+  /// Deserializes the next vector of the serialized currentPage() into
+  /// 'result' and moves to the next page after its last vector.
+  void deserializeNextVector(RowVectorPtr& result);
+
+  SerializedPage* currentPage() const {
+    return currentPages_[currentPageIndex_].get();
+  }
+
+  /// Moves past currentPage(). Clears 'currentPages_' after the last one.
+  void nextPage();
+
   /// True if this operator is responsible for fetching splits from the Task and
   /// passing these to ExchangeClient.
   const bool processSplits_;
+  const serializer::presto::PrestoVectorSerde::PrestoOptions serdeOptions_;
   bool noMoreSplits_ = false;
 
   /// A future received from Task::getSplitOrFuture(). It will be complete when
@@ -88,8 +111,14 @@ class Exchange : public SourceOperator {
 
   RowVectorPtr result_;
   std::shared_ptr<ExchangeClient> exchangeClient_;
-  std::unique_ptr<SerializedPage> currentPage_;
+  // The pages received by the last isBlocked(). Empty when all are consumed.
+  std::vector<std::unique_ptr<SerializedPage>> currentPages_;
+  // The index of the page in 'currentPages_' being consumed.
+  size_t currentPageIndex_{0};
   std::unique_ptr<ByteStream> inputStream_;
+  // The index of the next vector to return from an in-process
+  // currentPage().
+  size_t nextVector_{0};
   bool atEnd_{false};
 };
 
@@ -15,6 +15,10 @@
  */
 #include "velox/exec/ExchangeClient.h"
 
+#include <algorithm>
+
+#include "velox/common/base/BitUtil.h"
+
 namespace facebook::velox::exec {
 
 void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
@@ -47,6 +51,7 @@ void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
       toClose = std::move(source);
     } else {
       sources_.push_back(source);
+      requestedPages_.push_back(1);
       queue_->addSourceLocked();
 
       toRequest = pickSourcesToRequestLocked();
@@ -74,6 +79,7 @@ void ExchangeClient::close() {
     }
     closed_ = true;
     sources = std::move(sources_);
+    requestedPages_.clear();
   }
 
   // Outside of mutex.
@@ -105,18 +111,24 @@ folly::F14FastMap<std::string, RuntimeMetric> ExchangeClient::stats() const {
 std::unique_ptr<SerializedPage> ExchangeClient::next(
     bool* atEnd,
     ContinueFuture* future) {
+  auto pages = next(0, atEnd, future);
+  return pages.empty() ? nullptr : std::move(pages[0]);
+}
+
+std::vector<std::unique_ptr<SerializedPage>>
+ExchangeClient::next(uint64_t maxBytes, bool* atEnd, ContinueFuture* future) {
   RequestSpec toRequest;
-  std::unique_ptr<SerializedPage> page;
+  std::vector<std::unique_ptr<SerializedPage>> pages;
   {
     std::lock_guard<std::mutex> l(queue_->mutex());
     *atEnd = false;
-    page = queue_->dequeueLocked(atEnd, future);
+    pages = queue_->dequeueLocked(maxBytes, atEnd, future);
     if (*atEnd) {
-      return page;
+      return pages;
     }
 
-    if (page && queue_->totalBytes() > maxQueuedBytes_) {
-      return page;
+    if (!pages.empty() && queue_->totalBytes() > maxQueuedBytes_) {
+      return pages;
     }
 
     toRequest = pickSourcesToRequestLocked();
@@ -124,12 +136,13 @@ std::unique_ptr<SerializedPage> ExchangeClient::next(
 
   // Outside of lock
   request(toRequest);
-  return page;
+  return pages;
 }
 
 void ExchangeClient::request(const RequestSpec& requestSpec) {
-  for (auto& source : requestSpec.sources) {
-    auto future = source->request(requestSpec.maxBytes);
+  for (auto i = 0; i < requestSpec.sources.size(); ++i) {
+    auto& source = requestSpec.sources[i];
+    auto future = source->request(requestSpec.maxBytes[i]);
     VELOX_CHECK(future.valid());
     auto& exec = folly::QueuedImmediateExecutor::instance();
     std::move(future)
@@ -142,11 +155,11 @@ void ExchangeClient::request(const RequestSpec& requestSpec) {
   }
 }
 
-int32_t ExchangeClient::countPendingSourcesLocked() {
+int32_t ExchangeClient::countPendingPagesLocked() {
   int32_t numPending = 0;
-  for (auto& source : sources_) {
-    if (source->isRequestPendingLocked()) {
-      ++numPending;
+  for (auto i = 0; i < sources_.size(); ++i) {
+    if (sources_[i]->isRequestPendingLocked()) {
+      numPending += requestedPages_[i];
     }
   }
   return numPending;
@@ -170,7 +183,7 @@ int64_t ExchangeClient::getAveragePageSize() {
 int32_t ExchangeClient::getNumSourcesToRequestLocked(int64_t averagePageSize) {
   // Figure out how many more 'averagePageSize' fit into 'maxQueuedBytes_'.
   // Make sure to leave room for 'numPending' pages.
-  const auto numPending = countPendingSourcesLocked();
+  const auto numPending = countPendingPagesLocked();
 
   auto numToRequest = std::max<int32_t>(
       1, (maxQueuedBytes_ - queue_->totalBytes()) / averagePageSize);
@@ -193,23 +206,76 @@ ExchangeClient::RequestSpec ExchangeClient::pickSourcesToRequestLocked() {
     return {};
   }
 
-  RequestSpec toRequest;
-  toRequest.maxBytes = averagePageSize;
-
-  // Pick up to 'numToRequest' next sources to request data from.
+  // Pick the sources whose producers have the most data buffered first. That
+  // unblocks the producers that are furthest behind and avoids the head of
+  // line blocking of a strict round robin over many sources.
+  backloggedSources_.clear();
   for (auto i = 0; i < sources_.size(); ++i) {
-    auto& source = sources_[nextSourceIndex_];
+    if (sources_[i]->producerBufferedBytesLocked() > 0) {
+      backloggedSources_.push_back(i);
+    }
+  }
+  std::sort(
+      backloggedSources_.begin(),
+      backloggedSources_.end(),
+      [&](int32_t lhs, int32_t rhs) {
+        return sources_[lhs]->producerBufferedBytesLocked() >
+            sources_[rhs]->producerBufferedBytesLocked();
+      });
+
+  std::vector<int32_t> picked;
+  for (auto i : backloggedSources_) {
+    if (picked.size() == numToRequest) {
+      break;
+    }
+    if (sources_[i]->shouldRequestLocked()) {
+      picked.push_back(i);
+    }
+  }
 
+  // Pick up to 'numToRequest' next sources to request data from.
+  for (auto i = 0; i < sources_.size() && picked.size() < numToRequest; ++i) {
+    const auto index = nextSourceIndex_;
     nextSourceIndex_ = (nextSourceIndex_ + 1) % sources_.size();
 
-    if (source->shouldRequestLocked()) {
-      toRequest.sources.push_back(source);
-      if (toRequest.sources.size() == numToRequest) {
-        break;
-      }
+    if (sources_[index]->producerBufferedBytesLocked() > 0) {
+      // Considered above.
+      continue;
+    }
+    if (sources_[index]->shouldRequestLocked()) {
+      picked.push_back(index);
     }
   }
 
+  return sizeRequestsLocked(averagePageSize, numToRequest, picked);
+}
+
+ExchangeClient::RequestSpec ExchangeClient::sizeRequestsLocked(
+    int64_t averagePageSize,
+    int32_t numToRequest,
+    const std::vector<int32_t>& picked) {
+  RequestSpec toRequest;
+  toRequest.sources.reserve(picked.size());
+  toRequest.maxBytes.reserve(picked.size());
+  // The number of average size pages that fit in the queue beyond one per
+  // picked source. The backlogged sources come first in 'picked', deepest
+  // first, and get these.
+  int64_t numSparePages = numToRequest - static_cast<int64_t>(picked.size());
+  for (auto i : picked) {
+    const auto& source = sources_[i];
+    int64_t numPages = 1;
+    if (numSparePages > 0) {
+      const auto numBufferedPages = bits::divRoundUp(
+          source->producerBufferedBytesLocked(), averagePageSize);
+      const auto numExtraPages =
+          std::min(numSparePages, std::max<int64_t>(0, numBufferedPages - 1));
+      numPages += numExtraPages;
+      numSparePages -= numExtraPages;
+    }
+    requestedPages_[i] = numPages;
+    toRequest.sources.push_back(source);
+    toRequest.maxBytes.push_back(numPages * averagePageSize);
+  }
   return toRequest;
 }
 
@@ -68,6 +68,12 @@ class ExchangeClient {
 
   std::unique_ptr<SerializedPage> next(bool* atEnd, ContinueFuture* future);
 
+  // Returns the queued pages up to 'maxBytes' in total and at least one page
+  // if there is one, so that a consumer of many small pages can combine
+  // them. See ExchangeQueue::dequeueLocked().
+  std::vector<std::unique_ptr<SerializedPage>>
+  next(uint64_t maxBytes, bool* atEnd, ContinueFuture* future);
+
   std::string toString() const;
 
   std::string toJsonString() const;
@@ -77,7 +83,8 @@ class ExchangeClient {
   // (in bytes).
   struct RequestSpec {
     std::vector<std::shared_ptr<ExchangeSource>> sources;
-    int64_t maxBytes;
+    // How much to request from the source at the same index in 'sources'.
+    std::vector<int64_t> maxBytes;
   };
 
   int64_t getAveragePageSize();
@@ -88,7 +95,18 @@ class ExchangeClient {
 
   RequestSpec pickSourcesToRequestLocked();
 
-  int32_t countPendingSourcesLocked();
+  // Returns the requests to the sources at 'picked' indices in 'sources_'.
+  // Each source gets 'averagePageSize'. If fewer than 'numToRequest' sources
+  // were picked, the queue space left over goes to the sources with the
+  // deepest producer buffers, up to what their producers have buffered.
+  RequestSpec sizeRequestsLocked(
+      int64_t averagePageSize,
+      int32_t numToRequest,
+      const std::vector<int32_t>& picked);
+
+  // Returns the number of average size pages requested from the sources with
+  // a pending request.
+  int32_t countPendingPagesLocked();
 
   void request(const RequestSpec& requestSpec);
 
@@ -100,7 +118,13 @@ class ExchangeClient {
   std::shared_ptr<ExchangeQueue> queue_;
   std::unordered_set<std::string> taskIds_;
   std::vector<std::shared_ptr<ExchangeSource>> sources_;
+  // The number of average size pages requested by the last request to the
+  // source at the same index in 'sources_'.
+  std::vector<int32_t> requestedPages_;
   uint32_t nextSourceIndex_{0};
+  // Indices into 'sources_' of the sources with a known producer backlog.
+  // Reused across pickSourcesToRequestLocked() calls.
+  std::vector<int32_t> backloggedSources_;
   bool closed_{false};
 };
 
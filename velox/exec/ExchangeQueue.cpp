@@ -33,13 +33,29 @@ SerializedPage::SerializedPage(
   }
 }
 
+SerializedPage::SerializedPage(
+    std::vector<RowVectorPtr> vectors,
+    uint64_t size,
+    std::function<void()> releaseFn)
+    : iobufBytes_(size),
+      vectors_(std::move(vectors)),
+      releaseFn_(std::move(releaseFn)) {
+  VELOX_CHECK(!vectors_.empty());
+}
+
 SerializedPage::~SerializedPage() {
   if (onDestructionCb_) {
     onDestructionCb_(*iobuf_.get());
   }
+  // The vectors may be allocated from memory that 'releaseFn_' keeps alive.
+  vectors_.clear();
+  if (releaseFn_) {
+    releaseFn_();
+  }
 }
 
 void SerializedPage::prepareStreamForDeserialize(ByteStream* input) {
+  VELOX_CHECK(isSerialized());
   input->resetInput(std::move(ranges_));
 }
 
@@ -116,6 +132,26 @@ std::unique_ptr<SerializedPage> ExchangeQueue::dequeueLocked(
   return page;
 }
 
+std::vector<std::unique_ptr<SerializedPage>> ExchangeQueue::dequeueLocked(
+    uint64_t maxBytes,
+    bool* atEnd,
+    ContinueFuture* future) {
+  std::vector<std::unique_ptr<SerializedPage>> pages;
+  auto page = dequeueLocked(atEnd, future);
+  if (page == nullptr) {
+    return pages;
+  }
+  uint64_t totalBytes = page->size();
+  pages.push_back(std::move(page));
+  while (!queue_.empty() && totalBytes + queue_.front()->size() <= maxBytes) {
+    totalBytes += queue_.front()->size();
+    totalBytes_ -= queue_.front()->size();
+    pages.push_back(std::move(queue_.front()));
+    queue_.pop_front();
+  }
+  return pages;
+}
+
 void ExchangeQueue::setError(const std::string& error) {
   std::vector<ContinuePromise> promises;
   {
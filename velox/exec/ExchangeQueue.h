@@ -16,11 +16,13 @@
 #pragma once
 
 #include "velox/common/memory/ByteStream.h"
+#include "velox/vector/ComplexVector.h"
 
 namespace facebook::velox::exec {
 
 // Corresponds to Presto SerializedPage, i.e. a container for
-// serialize vectors in Presto wire format.
+// serialize vectors in Presto wire format. For an exchange between tasks in
+// the same process, it may instead hold the vectors themselves.
 class SerializedPage {
  public:
   // Construct from IOBuf chain.
@@ -28,6 +30,14 @@ class SerializedPage {
       std::unique_ptr<folly::IOBuf> iobuf,
       std::function<void(folly::IOBuf&)> onDestructionCb = nullptr);
 
+  // Constructs an in-process page holding 'vectors' instead of serialized
+  // data. 'size' is the estimated serialized size of 'vectors' for flow
+  // control. 'releaseFn' is called on destruction after 'vectors' are freed.
+  SerializedPage(
+      std::vector<RowVectorPtr> vectors,
+      uint64_t size,
+      std::function<void()> releaseFn = nullptr);
+
   ~SerializedPage();
 
   // Returns the size of the serialized data in bytes.
@@ -35,11 +45,24 @@ class SerializedPage {
     return iobufBytes_;
   }
 
+  // Returns true if 'this' holds serialized data, false if it holds vectors.
+  bool isSerialized() const {
+    return iobuf_ != nullptr;
+  }
+
+  // Returns the vectors of an in-process page.
+  const std::vector<RowVectorPtr>& vectors() const {
+    return vectors_;
+  }
+
   // Makes 'input' ready for deserializing 'this' with
   // VectorStreamGroup::read().
   void prepareStreamForDeserialize(ByteStream* input);
 
   std::unique_ptr<folly::IOBuf> getIOBuf() const {
+    VELOX_CHECK(
+        isSerialized(),
+        "An in-process page can only be consumed in the same process");
     return iobuf_->clone();
   }
 
@@ -58,9 +81,16 @@ class SerializedPage {
   // IOBuf holding the data in 'ranges_.
   std::unique_ptr<folly::IOBuf> iobuf_;
 
-  // Number of payload bytes in 'iobuf_'.
+  // Number of payload bytes in 'iobuf_', or the estimated size of
+  // 'vectors_'.
   const int64_t iobufBytes_;
 
+  // The vectors of an in-process page.
+  std::vector<RowVectorPtr> vectors_;
+
+  // Called on destruction of an in-process page after freeing 'vectors_'.
+  std::function<void()> releaseFn_;
+
   // Callback that will be called on destruction of the SerializedPage,
   // primarily used to free externally allocated memory backing folly::IOBuf
   // from caller. Caller is responsible to pass in proper cleanup logic to
@@ -104,6 +134,13 @@ class ExchangeQueue {
       bool* atEnd,
       ContinueFuture* future);
 
+  /// Returns the pages at the front of the queue while their total size does
+  /// not exceed 'maxBytes', and at least one page if the queue is not empty.
+  /// Sets 'atEnd' and 'future' like the single page dequeueLocked() if the
+  /// queue is empty.
+  std::vector<std::unique_ptr<SerializedPage>>
+  dequeueLocked(uint64_t maxBytes, bool* atEnd, ContinueFuture* future);
+
   /// Returns the total bytes held by SerializedPages in 'this'.
   uint64_t totalBytes() const {
     return totalBytes_;
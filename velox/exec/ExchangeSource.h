@@ -57,6 +57,15 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
     return requestPending_;
   }
 
+  /// Returns the number of bytes that the producer still had buffered for
+  /// this source after the last response, or 0 if the source does not know.
+  /// ExchangeClient requests from sources with deeper buffers first and asks
+  /// them for more. This is expected to be called while holding lock over
+  /// queue_.mutex().
+  int64_t producerBufferedBytesLocked() const {
+    return producerBufferedBytes_;
+  }
+
   /// Requests the producer to generate up to 'maxBytes' more data.
   /// Returns a future that completes when producer responds either with 'data'
   /// or with a message indicating that all data has been already produced or
@@ -86,6 +95,7 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
     obj["sequence"] = sequence_;
     obj["requestPending"] = requestPending_.load();
     obj["atEnd"] = atEnd_;
+    obj["producerBufferedBytes"] = producerBufferedBytes_;
     return folly::toPrettyJson(obj);
   }
 
@@ -111,6 +121,9 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
   std::shared_ptr<ExchangeQueue> queue_;
   std::atomic<bool> requestPending_{false};
   bool atEnd_ = false;
+  // Set by subclasses that learn the producer's backlog for this source from
+  // its responses. Guarded by queue_->mutex().
+  int64_t producerBufferedBytes_{0};
 
   // Holds a shared reference on the memory pool as it might be still possible
   // to be accessed by external components after the query task is destroyed.
@@ -20,6 +20,10 @@
 
 namespace facebook::velox::exec {
 namespace {
+// Minimum fraction of rows passing the filter for compacting projection
+// results instead of wrapping them in a dictionary.
+constexpr double kMinCompactionSelectivity = 0.5;
+
 bool checkAddIdentityProjection(
     const core::TypedExprPtr& projection,
     const RowTypePtr& inputType,
@@ -194,10 +198,40 @@ RowVectorPtr FilterProject::getOutput() {
     project(*rows, evalCtx);
   }
 
+  // Most rows passed. Compacting the results costs about as much as reading
+  // them through a dictionary once.
+  if (!allRowsSelected && !resultProjections_.empty() &&
+      numOut >= size * kMinCompactionSelectivity) {
+    return fillCompactedOutput(numOut);
+  }
+
   return fillOutput(
       numOut, allRowsSelected ? nullptr : filterEvalCtx_.selectedIndices);
 }
 
+RowVectorPtr FilterProject::fillCompactedOutput(vector_size_t numOut) {
+  const auto size = input_->size();
+  const auto& mapping = filterEvalCtx_.selectedIndices;
+  const auto* selectedBits = filterEvalCtx_.selectedBits->as<uint64_t>();
+  auto output = std::make_shared<RowVector>(
+      operatorCtx_->pool(),
+      outputType_,
+      nullptr,
+      numOut,
+      std::vector<VectorPtr>(outputType_->size(), nullptr));
+  projectChildren(output, input_, identityProjections_, numOut, mapping);
+  for (const auto& projection : resultProjections_) {
+    auto& result = results_[projection.inputChannel];
+    if (compactFlatVector(result, selectedBits, size, numOut)) {
+      output->childAt(projection.outputChannel) = result;
+    } else {
+      output->childAt(projection.outputChannel) =
+          wrapChild(numOut, mapping, result);
+    }
+  }
+  return output;
+}
+
 void FilterProject::project(const SelectivityVector& rows, EvalCtx& evalCtx) {
   exprs_->eval(
       hasFilter_ ? 1 : 0, numExprs_, !hasFilter_, rows, evalCtx, results_);
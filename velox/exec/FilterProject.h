@@ -90,6 +90,12 @@ class FilterProject : public Operator {
   // pre-condition: !isIdentityProjection_
   void project(const SelectivityVector& rows, EvalCtx& evalCtx);
 
+  // Returns the output for 'numOut' rows passing the filter. Projection
+  // results that are flat fixed width vectors are compacted in place to the
+  // passing rows instead of being wrapped in a dictionary. Identity
+  // projections and other results are wrapped as in fillOutput().
+  RowVectorPtr fillCompactedOutput(vector_size_t numOut);
+
   // If true exprs_[0] is a filter and the other expressions are projections
   const bool hasFilter_{false};
 
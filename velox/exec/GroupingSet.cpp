@@ -70,6 +70,8 @@ GroupingSet::GroupingSet(
       spillMemoryThreshold_(operatorCtx->driverCtx()
                                 ->queryConfig()
                                 .aggregationSpillMemoryThreshold()),
+      spillAll_(
+          operatorCtx->driverCtx()->queryConfig().aggregationSpillAll()),
       spillConfig_(spillConfig),
       numSpillRuns_(numSpillRuns),
       nonReclaimableSection_(nonReclaimableSection),
@@ -130,6 +132,27 @@ GroupingSet::GroupingSet(
       distinctAggregations_.push_back(nullptr);
     }
   }
+
+  tablePartitionBits_ = makeTablePartitionBits(
+      operatorCtx->driverCtx()->queryConfig().aggregationTablePartitionBits());
+}
+
+HashBitRange GroupingSet::makeTablePartitionBits(uint8_t numBits) const {
+  // The max number of partition bits.
+  constexpr uint8_t kMaxBits = 6;
+  // The first partition bit. The bits below are used by the sub-tables for
+  // selecting buckets and tags.
+  constexpr uint8_t kStartBit = 48;
+  // Partial aggregations flush often and spilling and pre-grouped keys expect
+  // a single table. Without aggregates, HashAggregation and MarkDistinct read
+  // the new groups in input order from the lookup.
+  if (numBits == 0 || isGlobal_ || isPartial_ ||
+      !preGroupedKeyChannels_.empty() || spillConfig_ != nullptr ||
+      aggregates_.empty()) {
+    return HashBitRange();
+  }
+  numBits = std::min(numBits, kMaxBits);
+  return HashBitRange(kStartBit, kStartBit + numBits);
 }
 
 GroupingSet::~GroupingSet() {
@@ -226,7 +249,7 @@ void GroupingSet::addInputForActiveRows(
     const RowVectorPtr& input,
     bool mayPushdown) {
   VELOX_CHECK(!isGlobal_);
-  if (!table_) {
+  if (!table_ && subTables_.empty()) {
     createHashTable();
   }
   ensureInputFits(input);
@@ -239,8 +262,12 @@ void GroupingSet::addInputForActiveRows(
   auto guard = folly::makeGuard([this]() { *nonReclaimableSection_ = false; });
   *nonReclaimableSection_ = true;
 
-  table_->prepareForProbe(*lookup_, input, activeRows_, ignoreNullKeys_);
-  table_->groupProbe(*lookup_);
+  if (!subTables_.empty()) {
+    partitionedGroupProbe(input);
+  } else if (!dictionaryGroupProbe(input)) {
+    table_->prepareForProbe(*lookup_, input, activeRows_, ignoreNullKeys_);
+    table_->groupProbe(*lookup_);
+  }
   masks_.addInput(input, activeRows_);
 
   auto* groups = lookup_->hits.data();
@@ -355,6 +382,11 @@ std::vector<Accumulator> GroupingSet::accumulators(bool excludeToIntermediate) {
 }
 
 void GroupingSet::createHashTable() {
+  if (tablePartitionBits_.numBits() > 0) {
+    createPartitionedTables();
+    return;
+  }
+
   if (ignoreNullKeys_) {
     table_ = HashTable<true>::createForAggregation(
         std::move(hashers_), accumulators(false), &pool_);
@@ -363,7 +395,143 @@ void GroupingSet::createHashTable() {
         std::move(hashers_), accumulators(false), &pool_);
   }
 
-  RowContainer& rows = *table_->rows();
+  initializeAccumulators(*table_->rows());
+
+  lookup_ = std::make_unique<HashLookup>(table_->hashers());
+  if (!isAdaptive_ && table_->hashMode() != BaseHashTable::HashMode::kHash) {
+    table_->forceGenericHashMode();
+  }
+}
+
+void GroupingSet::createPartitionedTables() {
+  const auto numPartitions = tablePartitionBits_.numPartitions();
+  std::shared_ptr<HashStringAllocator> stringAllocator;
+  for (auto i = 0; i < numPartitions; ++i) {
+    std::vector<std::unique_ptr<VectorHasher>> hashers;
+    hashers.reserve(hashers_.size());
+    for (const auto& hasher : hashers_) {
+      hashers.push_back(VectorHasher::create(hasher->type(), hasher->channel()));
+    }
+    std::unique_ptr<BaseHashTable> table;
+    if (ignoreNullKeys_) {
+      table = HashTable<true>::createForAggregation(
+          std::move(hashers), accumulators(false), &pool_, stringAllocator);
+    } else {
+      table = HashTable<false>::createForAggregation(
+          std::move(hashers), accumulators(false), &pool_, stringAllocator);
+    }
+    if (stringAllocator == nullptr) {
+      stringAllocator = table->rows()->stringAllocatorShared();
+    }
+    if (!isAdaptive_ && table->hashMode() != BaseHashTable::HashMode::kHash) {
+      table->forceGenericHashMode();
+    }
+    subLookups_.push_back(std::make_unique<HashLookup>(table->hashers()));
+    subTables_.push_back(std::move(table));
+  }
+  subTableRows_.resize(numPartitions);
+
+  // All sub-tables have the same row layout and allocator.
+  initializeAccumulators(*subTables_[0]->rows());
+
+  // Gets the hits and new groups of all sub-tables.
+  lookup_ = std::make_unique<HashLookup>(subTables_[0]->hashers());
+}
+
+void GroupingSet::partitionedGroupProbe(const RowVectorPtr& input) {
+  const auto numRows = activeRows_.size();
+  partitionHashes_.resize(numRows);
+  for (auto i = 0; i < hashers_.size(); ++i) {
+    auto key = input->childAt(hashers_[i]->channel())->loadedVector();
+    hashers_[i]->decode(*key, activeRows_);
+    hashers_[i]->hash(activeRows_, i > 0, partitionHashes_);
+  }
+
+  for (auto& rows : subTableRows_) {
+    rows.resizeFill(numRows, false);
+  }
+  activeRows_.applyToSelected([&](auto row) {
+    subTableRows_[tablePartitionBits_.partition(partitionHashes_[row])]
+        .setValid(row, true);
+  });
+
+  lookup_->reset(numRows);
+  activeRows_.clearAll();
+  for (auto i = 0; i < subTables_.size(); ++i) {
+    auto& rows = subTableRows_[i];
+    rows.updateBounds();
+    if (!rows.hasSelections()) {
+      continue;
+    }
+    auto& lookup = *subLookups_[i];
+    subTables_[i]->prepareForProbe(lookup, input, rows, ignoreNullKeys_);
+    subTables_[i]->groupProbe(lookup);
+    for (auto row : lookup.rows) {
+      lookup_->hits[row] = lookup.hits[row];
+      activeRows_.setValid(row, true);
+    }
+    lookup_->newGroups.insert(
+        lookup_->newGroups.end(),
+        lookup.newGroups.begin(),
+        lookup.newGroups.end());
+  }
+  activeRows_.updateBounds();
+}
+
+bool GroupingSet::dictionaryGroupProbe(const RowVectorPtr& input) {
+  // Min number of rows per dictionary entry for probing once per entry. Below
+  // this, finding the first row of each entry costs more than it saves.
+  constexpr int32_t kMinRowsPerEntry = 4;
+  if (lookup_->hashers.size() != 1) {
+    return false;
+  }
+  const auto* key =
+      input->childAt(lookup_->hashers[0]->channel())->loadedVector();
+  if (key->encoding() != VectorEncoding::Simple::DICTIONARY) {
+    return false;
+  }
+  const auto numEntries = key->valueVector()->size();
+  if (static_cast<int64_t>(numEntries) * kMinRowsPerEntry >
+      activeRows_.countSelected()) {
+    return false;
+  }
+
+  const auto* indices = key->wrapInfo()->as<vector_size_t>();
+  auto entryOf = [&](vector_size_t row) {
+    return key->isNullAt(row) ? numEntries : indices[row];
+  };
+  dictionaryFirstRows_.assign(numEntries + 1, -1);
+  dictionaryProbeRows_.resizeFill(activeRows_.end(), false);
+  activeRows_.applyToSelected([&](auto row) {
+    auto& firstRow = dictionaryFirstRows_[entryOf(row)];
+    if (firstRow < 0) {
+      firstRow = row;
+      dictionaryProbeRows_.setValid(row, true);
+    }
+  });
+  dictionaryProbeRows_.updateBounds();
+
+  table_->prepareForProbe(
+      *lookup_, input, dictionaryProbeRows_, ignoreNullKeys_);
+  table_->groupProbe(*lookup_);
+
+  // The probe sized the hits for the probed rows only.
+  lookup_->hits.resize(activeRows_.end());
+  auto* hits = lookup_->hits.data();
+  activeRows_.applyToSelected([&](auto row) {
+    const auto firstRow = dictionaryFirstRows_[entryOf(row)];
+    if (!dictionaryProbeRows_.isValid(firstRow)) {
+      // Null key that was removed from the probe.
+      activeRows_.setValid(row, false);
+      return;
+    }
+    hits[row] = hits[firstRow];
+  });
+  activeRows_.updateBounds();
+  return true;
+}
+
+void GroupingSet::initializeAccumulators(RowContainer& rows) {
   initializeAggregates(aggregates_, rows, false);
 
   auto numColumns = rows.keyTypes().size() + aggregates_.size();
@@ -394,11 +562,6 @@ void GroupingSet::createHashTable() {
       ++numColumns;
     }
   }
-
-  lookup_ = std::make_unique<HashLookup>(table_->hashers());
-  if (!isAdaptive_ && table_->hashMode() != BaseHashTable::HashMode::kHash) {
-    table_->forceGenericHashMode();
-  }
 }
 
 void GroupingSet::initializeGlobalAggregation() {
@@ -641,6 +804,9 @@ bool GroupingSet::getOutput(
   if (spiller_) {
     return getOutputWithSpill(batchSize, result);
   }
+  if (!subTables_.empty()) {
+    return getPartitionedOutput(batchSize, iterator, result);
+  }
 
   // @lint-ignore CLANGTIDY
   char* groups[batchSize];
@@ -656,6 +822,38 @@ bool GroupingSet::getOutput(
   return true;
 }
 
+bool GroupingSet::getPartitionedOutput(
+    int32_t batchSize,
+    RowContainerIterator& iterator,
+    const RowVectorPtr& result) {
+  // @lint-ignore CLANGTIDY
+  char* groups[batchSize];
+  while (outputSubTable_ < subTables_.size()) {
+    const auto numGroups = subTables_[outputSubTable_]->rows()->listRows(
+        &iterator, batchSize, groups);
+    if (numGroups > 0) {
+      extractGroups(folly::Range<char**>(groups, numGroups), result);
+      return true;
+    }
+    iterator.reset();
+    ++outputSubTable_;
+  }
+  for (auto& table : subTables_) {
+    table->clear();
+  }
+  return false;
+}
+
+RowContainer& GroupingSet::outputRows() {
+  if (table_ != nullptr) {
+    return *table_->rows();
+  }
+  if (!subTables_.empty()) {
+    return *subTables_[outputSubTable_]->rows();
+  }
+  return *rowsWhileReadingSpill_;
+}
+
 void GroupingSet::extractGroups(
     folly::Range<char**> groups,
     const RowVectorPtr& result) {
@@ -663,7 +861,7 @@ void GroupingSet::extractGroups(
   if (groups.empty()) {
     return;
   }
-  RowContainer& rows = table_ ? *table_->rows() : *rowsWhileReadingSpill_;
+  RowContainer& rows = outputRows();
   auto totalKeys = rows.keyTypes().size();
   for (int32_t i = 0; i < totalKeys; ++i) {
     auto keyVector = result->childAt(i);
@@ -701,6 +899,28 @@ void GroupingSet::resetPartial() {
   }
 }
 
+int32_t GroupingSet::evictPartialGroups(
+    int32_t maxGroups,
+    const RowVectorPtr& result) {
+  VELOX_CHECK(isPartial_);
+  if (table_ == nullptr || maxGroups == 0) {
+    return 0;
+  }
+  // Erased rows are marked free and skipped by listRows, so each call starts
+  // from the beginning of the container.
+  RowContainerIterator iterator;
+  std::vector<char*> groups(maxGroups);
+  const auto numGroups =
+      table_->rows()->listRows(&iterator, maxGroups, groups.data());
+  if (numGroups == 0) {
+    return 0;
+  }
+  folly::Range<char**> evicted(groups.data(), numGroups);
+  extractGroups(evicted, result);
+  table_->erase(evicted);
+  return numGroups;
+}
+
 bool GroupingSet::isPartialFull(int64_t maxBytes) {
   VELOX_CHECK(isPartial_);
   if (!table_ || allocatedBytes() <= maxBytes) {
@@ -722,10 +942,57 @@ bool GroupingSet::isPartialFull(int64_t maxBytes) {
   return allocatedBytes() > maxBytes;
 }
 
+int64_t GroupingSet::numDistinct() const {
+  if (table_ != nullptr) {
+    return table_->numDistinct();
+  }
+  int64_t numDistinct = 0;
+  for (const auto& table : subTables_) {
+    numDistinct += table->numDistinct();
+  }
+  return numDistinct;
+}
+
+HashTableStats GroupingSet::hashTableStats() const {
+  if (table_ != nullptr) {
+    return table_->stats();
+  }
+  HashTableStats stats;
+  for (const auto& table : subTables_) {
+    const auto tableStats = table->stats();
+    stats.capacity += tableStats.capacity;
+    stats.numRehashes += tableStats.numRehashes;
+    stats.numDistinct += tableStats.numDistinct;
+    stats.numTombstones += tableStats.numTombstones;
+  }
+  return stats;
+}
+
+int64_t GroupingSet::numRows() const {
+  if (table_ != nullptr) {
+    return table_->rows()->numRows();
+  }
+  int64_t numRows = 0;
+  for (const auto& table : subTables_) {
+    numRows += table->rows()->numRows();
+  }
+  return numRows;
+}
+
 uint64_t GroupingSet::allocatedBytes() const {
   if (table_) {
     return table_->allocatedBytes();
   }
+  if (!subTables_.empty()) {
+    uint64_t bytes = 0;
+    for (const auto& table : subTables_) {
+      bytes += table->allocatedBytes();
+    }
+    // Each table counts the shared variable length data arena.
+    return bytes -
+        (subTables_.size() - 1) *
+        subTables_[0]->rows()->stringAllocator().retainedSize();
+  }
 
   return stringAllocator_.retainedSize() + rows_.allocatedBytes();
 }
@@ -836,6 +1103,16 @@ void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
     for (const auto& aggregate : aggregates_) {
       types.push_back(aggregate.intermediateType);
     }
+    // The inputs of the sorted and distinct aggregations follow in the order
+    // of accumulators().
+    if (sortedAggregations_ != nullptr) {
+      types.push_back(sortedAggregations_->spillType());
+    }
+    for (const auto& aggregation : distinctAggregations_) {
+      if (aggregation != nullptr) {
+        types.push_back(aggregation->spillType());
+      }
+    }
     std::vector<std::string> names;
     for (auto i = 0; i < types.size(); ++i) {
       names.push_back(fmt::format("s{}", i));
@@ -857,7 +1134,14 @@ void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
         spillConfig_->minSpillRunSize,
         spillConfig_->compressionKind,
         Spiller::pool(),
-        spillConfig_->executor);
+        spillConfig_->executor,
+        spillConfig_->format,
+        spillConfig_->directories,
+        spillConfig_->spillColdPartitionsFirst);
+  }
+  if (spillAll_) {
+    targetRows = 0;
+    targetBytes = 0;
   }
   ++(*numSpillRuns_);
   spiller_->spill(targetRows, targetBytes);
@@ -888,7 +1172,7 @@ bool GroupingSet::getOutputWithSpill(
         &pool_,
         table_->rows()->stringAllocatorShared());
 
-    initializeAggregates(aggregates_, *mergeRows_, false);
+    initializeAccumulators(*mergeRows_);
 
     // Take ownership of the rows and free the hash table. The table will not be
     // needed for producing spill output.
@@ -949,9 +1233,19 @@ void GroupingSet::initializeRow(SpillMergeStream& keys, char* row) {
     mergeRows_->store(keys.decoded(i), keys.currentIndex(), mergeState_, i);
   }
   vector_size_t zero = 0;
-  for (auto& aggregate : aggregates_) {
-    aggregate.function->initializeNewGroups(
-        &row, folly::Range<const vector_size_t*>(&zero, 1));
+  const folly::Range<const vector_size_t*> indices(&zero, 1);
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    if (!aggregates_[i].sortingKeys.empty()) {
+      continue;
+    }
+    if (aggregates_[i].distinct) {
+      distinctAggregations_[i]->initializeNewGroups(&row, indices);
+      continue;
+    }
+    aggregates_[i].function->initializeNewGroups(&row, indices);
+  }
+  if (sortedAggregations_ != nullptr) {
+    sortedAggregations_->initializeNewGroups(&row, indices);
   }
 }
 
@@ -974,11 +1268,29 @@ void GroupingSet::updateRow(SpillMergeStream& input, char* row) {
   mergeSelection_.setValid(input.currentIndex(), true);
   mergeSelection_.updateBounds();
   for (auto i = 0; i < aggregates_.size(); ++i) {
+    // The sorted and distinct aggregations get their inputs at extraction.
+    if (!aggregates_[i].sortingKeys.empty() || aggregates_[i].distinct) {
+      continue;
+    }
     mergeArgs_[0] = input.current().childAt(i + keyChannels_.size());
     aggregates_[i].function->addSingleGroupIntermediateResults(
         row, mergeSelection_, mergeArgs_, false);
   }
   mergeSelection_.setValid(input.currentIndex(), false);
+
+  auto column = keyChannels_.size() + aggregates_.size();
+  if (sortedAggregations_ != nullptr) {
+    sortedAggregations_->addSingleGroupSpillInput(
+        row, input.current().childAt(column), input.currentIndex());
+    ++column;
+  }
+  for (const auto& aggregation : distinctAggregations_) {
+    if (aggregation != nullptr) {
+      aggregation->addSingleGroupSpillInput(
+          row, input.current().childAt(column), input.currentIndex());
+      ++column;
+    }
+  }
 }
 
 void GroupingSet::abandonPartialAggregation() {
@@ -1095,8 +1407,9 @@ void GroupingSet::toIntermediate(
 }
 
 std::optional<int64_t> GroupingSet::estimateRowSize() const {
-  const RowContainer* rows =
-      table_ ? table_->rows() : rowsWhileReadingSpill_.get();
+  const RowContainer* rows = table_ ? table_->rows()
+      : !subTables_.empty()          ? subTables_[0]->rows()
+                                     : rowsWhileReadingSpill_.get();
   return rows && rows->estimateRowSize() >= 0
       ? std::optional<int64_t>(rows->estimateRowSize())
       : std::nullopt;
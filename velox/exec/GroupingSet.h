@@ -18,6 +18,7 @@
 #include "velox/exec/AggregateInfo.h"
 #include "velox/exec/AggregationMasks.h"
 #include "velox/exec/DistinctAggregations.h"
+#include "velox/exec/HashBitRange.h"
 #include "velox/exec/HashTable.h"
 #include "velox/exec/SortedAggregations.h"
 #include "velox/exec/Spiller.h"
@@ -73,6 +74,12 @@ class GroupingSet {
 
   void resetPartial();
 
+  /// Extracts up to 'maxGroups' groups into 'result' and removes them from the
+  /// table. The groups are taken in the order of the row container, which is
+  /// roughly the order of insertion. Used by partial aggregation to keep a
+  /// bounded number of groups. Returns the number of extracted groups.
+  int32_t evictPartialGroups(int32_t maxGroups, const RowVectorPtr& result);
+
   /// Returns true if 'this' should start producing partial
   /// aggregation results. Checks the memory consumption against
   /// 'maxBytes'. If exceeding 'maxBytes', sees if changing hash mode
@@ -82,9 +89,7 @@ class GroupingSet {
   bool isPartialFull(int64_t maxBytes);
 
   /// Returns the count of the hash table, if any.
-  int64_t numDistinct() const {
-    return table_ ? table_->numDistinct() : 0;
-  }
+  int64_t numDistinct() const;
 
   const HashLookup& hashLookup() const;
 
@@ -106,14 +111,10 @@ class GroupingSet {
   }
 
   /// Returns the hashtable stats.
-  HashTableStats hashTableStats() const {
-    return table_ ? table_->stats() : HashTableStats{};
-  }
+  HashTableStats hashTableStats() const;
 
   /// Return the number of rows kept in memory.
-  int64_t numRows() const {
-    return table_ ? table_->rows()->numRows() : 0;
-  }
+  int64_t numRows() const;
 
   // Frees hash tables and other state when giving up partial aggregation as
   // non-productive. Must be called before toIntermediate() is used.
@@ -145,6 +146,40 @@ class GroupingSet {
 
   void createHashTable();
 
+  // Sets the allocator and the row offsets of the accumulators to the ones of
+  // 'rows'.
+  void initializeAccumulators(RowContainer& rows);
+
+  // Returns the bits of the grouping key hash for partitioning the groups into
+  // 'subTables_' given 'numBits' from the query config. Returns an empty range
+  // if the groups are to be kept in a single table.
+  HashBitRange makeTablePartitionBits(uint8_t numBits) const;
+
+  // Creates 'subTables_' when the groups are partitioned.
+  void createPartitionedTables();
+
+  // Inserts 'activeRows_' of 'input' into the sub-tables selected by their key
+  // hashes. Sets 'lookup_->hits' and 'lookup_->newGroups' for all rows as if
+  // probed into one table and removes the rows with null keys from
+  // 'activeRows_' if null keys are ignored.
+  void partitionedGroupProbe(const RowVectorPtr& input);
+
+  // Probes 'table_' with one row per distinct dictionary index if the only
+  // grouping key of 'input' is a dictionary with few entries compared to the
+  // number of 'activeRows_'. Copies the hit of that row to all rows with the
+  // same index. Returns false without probing if the key is not such a
+  // dictionary.
+  bool dictionaryGroupProbe(const RowVectorPtr& input);
+
+  // Produces output from 'subTables_' one table at a time.
+  bool getPartitionedOutput(
+      int32_t batchSize,
+      RowContainerIterator& iterator,
+      const RowVectorPtr& result);
+
+  // Returns the container of the groups being extracted in extractGroups().
+  RowContainer& outputRows();
+
   void populateTempVectors(int32_t aggregateIndex, const RowVectorPtr& input);
 
   // If the given aggregation has mask, the method returns reference to the
@@ -222,6 +257,9 @@ class GroupingSet {
   // If it is zero, then there is no such limit.
   const uint64_t spillMemoryThreshold_;
 
+  // If true, each spill writes out the whole table as one sorted run.
+  const bool spillAll_;
+
   const Spiller::Config* const spillConfig_;
 
   uint32_t* const numSpillRuns_;
@@ -240,6 +278,37 @@ class GroupingSet {
   std::vector<VectorPtr> tempVectors_;
   std::unique_ptr<BaseHashTable> table_;
   std::unique_ptr<HashLookup> lookup_;
+
+  // The bits of the grouping key hash which select the sub-table of a group if
+  // the groups are partitioned into 'subTables_'. 'hashers_' compute the hash.
+  // Empty range if the groups are in 'table_'.
+  HashBitRange tablePartitionBits_;
+
+  // Used instead of 'table_' if the groups are partitioned on
+  // 'tablePartitionBits_'. The tables share the variable length data arena so
+  // that the accumulators have one allocator. Inserting one partition of an
+  // input batch at a time touches a table 2^N times smaller than a single
+  // table for all groups.
+  std::vector<std::unique_ptr<BaseHashTable>> subTables_;
+
+  // Lookups for 'subTables_', 1:1.
+  std::vector<std::unique_ptr<HashLookup>> subLookups_;
+
+  // The rows of the input going into each of 'subTables_'.
+  std::vector<SelectivityVector> subTableRows_;
+
+  // Partitioning hashes of the input rows.
+  raw_vector<uint64_t> partitionHashes_;
+
+  // The sub-table producing output.
+  size_t outputSubTable_{0};
+
+  // The first active row for each dictionary index in dictionaryGroupProbe().
+  // The last entry is for null keys.
+  std::vector<vector_size_t> dictionaryFirstRows_;
+
+  // The rows in 'dictionaryFirstRows_'.
+  SelectivityVector dictionaryProbeRows_;
   SelectivityVector activeRows_;
 
   // Used to allocate memory for a single row accumulating results of global
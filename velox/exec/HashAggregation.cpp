@@ -86,7 +86,11 @@ HashAggregation::HashAggregation(
       abandonPartialAggregationMinRows_(
           driverCtx->queryConfig().abandonPartialAggregationMinRows()),
       abandonPartialAggregationMinPct_(
-          driverCtx->queryConfig().abandonPartialAggregationMinPct()) {
+          driverCtx->queryConfig().abandonPartialAggregationMinPct()),
+      maxPartialGroups_(
+          isPartialOutput_ && !isGlobal_ && !isDistinct_
+              ? driverCtx->queryConfig().partialAggregationMaxGroups()
+              : 0) {
   VELOX_CHECK(pool()->trackUsage());
 
   auto inputType = aggregationNode->sources()[0]->outputType();
@@ -173,6 +177,15 @@ HashAggregation::HashAggregation(
     }
   }
 
+  if (driverCtx->queryConfig().collectKeyNdvs() && !isGlobal_) {
+    std::vector<column_index_t> keyChannels;
+    for (const auto& hasher : hashers) {
+      keyChannels.push_back(hasher->channel());
+    }
+    keyNdvs_ =
+        std::make_unique<KeyNdvEstimator>(inputType, keyChannels, pool());
+  }
+
   groupingSet_ = std::make_unique<GroupingSet>(
       inputType,
       std::move(hashers),
@@ -198,6 +211,9 @@ void HashAggregation::addInput(RowVectorPtr input) {
     mayPushdown_ = operatorCtx_->driver()->mayPushdownAggregation(this);
     pushdownChecked_ = true;
   }
+  if (keyNdvs_ != nullptr) {
+    keyNdvs_->addInput(*input);
+  }
   if (abandonedPartialAggregation_) {
     input_ = input;
     numInputRows_ += input->size();
@@ -208,6 +224,20 @@ void HashAggregation::addInput(RowVectorPtr input) {
 
   updateRuntimeStats();
 
+  if (boundedPartialAggregation()) {
+    // Evicts down to half of the max so that the next few batches of
+    // clustered input do not evict again right away.
+    const auto numDistinct = groupingSet_->numDistinct();
+    if (numDistinct > maxPartialGroups_) {
+      numGroupsToEvict_ = numDistinct - maxPartialGroups_ / 2;
+    }
+    // The memory limit still applies for groups with large accumulators.
+    if (groupingSet_->isPartialFull(maxPartialAggregationMemoryUsage_)) {
+      partialFull_ = true;
+    }
+    return;
+  }
+
   // NOTE: we should not trigger partial output flush in case of global
   // aggregation as the final aggregator will handle it the same way as the
   // partial aggregator. Hence, we have to use more memory anyway.
@@ -299,7 +329,7 @@ void HashAggregation::resetPartialOutputIfNeed() {
   }
   groupingSet_->resetPartial();
   partialFull_ = false;
-  if (!finished_) {
+  if (!finished_ && !boundedPartialAggregation()) {
     maybeIncreasePartialAggregationMemoryUsage(aggregationPct);
   }
   numOutputRows_ = 0;
@@ -344,6 +374,24 @@ void HashAggregation::maybeIncreasePartialAggregationMemoryUsage(
           maxPartialAggregationMemoryUsage_, RuntimeCounter::Unit::kBytes));
 }
 
+RowVectorPtr HashAggregation::getEvictedGroups() {
+  if (numGroupsToEvict_ == 0) {
+    return nullptr;
+  }
+  const auto batchSize = std::min<int64_t>(
+      numGroupsToEvict_, outputBatchRows(groupingSet_->estimateRowSize()));
+  prepareOutput(batchSize);
+  const auto numEvicted = groupingSet_->evictPartialGroups(batchSize, output_);
+  if (numEvicted == 0) {
+    numGroupsToEvict_ = 0;
+    return nullptr;
+  }
+  numGroupsToEvict_ = std::max<int64_t>(0, numGroupsToEvict_ - numEvicted);
+  numOutputRows_ += numEvicted;
+  addRuntimeStat("evictedPartialGroups", RuntimeCounter(numEvicted));
+  return output_;
+}
+
 RowVectorPtr HashAggregation::getOutput() {
   if (finished_) {
     input_ = nullptr;
@@ -363,6 +411,10 @@ RowVectorPtr HashAggregation::getOutput() {
     return output_;
   }
 
+  if (auto evicted = getEvictedGroups()) {
+    return evicted;
+  }
+
   // Produce results if one of the following is true:
   // - received no-more-input message;
   // - partial aggregation reached memory limit;
@@ -455,6 +507,10 @@ void HashAggregation::reclaim(uint64_t targetBytes) {
 }
 
 void HashAggregation::close() {
+  if (keyNdvs_ != nullptr) {
+    keyNdvs_->updateStats(*stats_.wlock());
+    keyNdvs_.reset();
+  }
   Operator::close();
 
   output_ = nullptr;
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "velox/exec/GroupingSet.h"
+#include "velox/exec/KeyNdvEstimator.h"
 #include "velox/exec/Operator.h"
 
 namespace facebook::velox::exec {
@@ -32,7 +33,7 @@ class HashAggregation : public Operator {
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_ && !partialFull_;
+    return !noMoreInput_ && !partialFull_ && numGroupsToEvict_ == 0;
   }
 
   void noMoreInput() override;
@@ -69,6 +70,16 @@ class HashAggregation : public Operator {
   // 'abandonPartialAggregationMinPct_' % of rows are unique.
   bool abandonPartialAggregationEarly(int64_t numOutput) const;
 
+  // True if the partial aggregation keeps a bounded number of groups and
+  // evicts the oldest ones instead of flushing or abandoning.
+  bool boundedPartialAggregation() const {
+    return maxPartialGroups_ > 0;
+  }
+
+  // Produces up to one batch of the groups to evict from a bounded partial
+  // aggregation. Returns nullptr if there is nothing to evict.
+  RowVectorPtr getEvictedGroups();
+
   // Invoked to record the spilling stats in operator stats after processing all
   // the inputs.
   void recordSpillStats();
@@ -95,6 +106,13 @@ class HashAggregation : public Operator {
   // are unique, the partial aggregation is not worthwhile.
   const int32_t abandonPartialAggregationMinPct_;
 
+  // Max number of groups in a bounded partial aggregation. 0 if not bounded.
+  const int32_t maxPartialGroups_;
+
+  // The number of groups to evict from a bounded partial aggregation before
+  // accepting more input.
+  int64_t numGroupsToEvict_{0};
+
   RowContainerIterator resultIterator_;
   bool pushdownChecked_ = false;
   bool mayPushdown_ = false;
@@ -108,6 +126,10 @@ class HashAggregation : public Operator {
 
   // Possibly reusable output vector.
   RowVectorPtr output_;
+
+  // Estimates the distinct values of the grouping keys if
+  // QueryConfig::kCollectKeyNdvs is set.
+  std::unique_ptr<KeyNdvEstimator> keyNdvs_;
 };
 
 } // namespace facebook::velox::exec
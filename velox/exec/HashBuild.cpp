@@ -15,7 +15,9 @@
  */
 
 #include "velox/exec/HashBuild.h"
+#include <folly/String.h>
 #include "velox/common/testutil/TestValue.h"
+#include "velox/common/time/Timer.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 #include "velox/expression/FieldReference.h"
@@ -41,6 +43,35 @@ BlockingReason fromStateToBlockingReason(HashBuild::State state) {
       VELOX_UNREACHABLE(HashBuild::stateName(state));
   }
 }
+
+// Returns the key to cache the table of 'joinNode' in HashJoinTableCache under
+// or an empty string if the table is not to be cached. The join types which
+// mark probed rows or check for null keys in the table are not cached.
+std::string makeTableCacheKey(
+    const core::HashJoinNode& joinNode,
+    const core::QueryConfig& queryConfig) {
+  auto cacheKey = queryConfig.hashJoinTableCacheKey();
+  if (cacheKey.empty() || joinNode.isNullAware()) {
+    return "";
+  }
+  if (!joinNode.isInnerJoin() && !joinNode.isLeftJoin() &&
+      !joinNode.isLeftSemiFilterJoin() && !joinNode.isLeftSemiProjectJoin()) {
+    return "";
+  }
+  std::vector<std::string> keys;
+  keys.reserve(joinNode.rightKeys().size());
+  for (const auto& key : joinNode.rightKeys()) {
+    keys.push_back(key->toString());
+  }
+  // The filter decides whether a semi join table drops duplicate keys.
+  return fmt::format(
+      "{}|{}|{}|{}|{}",
+      cacheKey,
+      core::joinTypeName(joinNode.joinType()),
+      folly::join(",", keys),
+      joinNode.filter() != nullptr,
+      joinNode.sources()[1]->toString(true, true));
+}
 } // namespace
 
 HashBuild::HashBuild(
@@ -53,7 +84,9 @@ HashBuild::HashBuild(
           operatorId,
           joinNode->id(),
           "HashBuild",
-          joinNode->canSpill(driverCtx->queryConfig())
+          joinNode->canSpill(driverCtx->queryConfig()) &&
+                  makeTableCacheKey(*joinNode, driverCtx->queryConfig())
+                      .empty()
               ? driverCtx->makeSpillConfig(operatorId)
               : std::nullopt),
       joinNode_(std::move(joinNode)),
@@ -63,10 +96,21 @@ HashBuild::HashBuild(
           operatorCtx_->driverCtx()->splitGroupId,
           planNodeId())),
       spillMemoryThreshold_(
-          operatorCtx_->driverCtx()->queryConfig().joinSpillMemoryThreshold()) {
+          operatorCtx_->driverCtx()->queryConfig().joinSpillMemoryThreshold()),
+      hotKeyRowsPct_(
+          operatorCtx_->driverCtx()->queryConfig().hashJoinHotKeyRowsPct()),
+      tableCacheKey_(makeTableCacheKey(
+          *joinNode_,
+          operatorCtx_->driverCtx()->queryConfig())) {
   VELOX_CHECK(pool()->trackUsage());
   VELOX_CHECK_NOT_NULL(joinBridge_);
 
+  if (!tableCacheKey_.empty()) {
+    auto lookup = joinBridge_->lookupTableCache(tableCacheKey_);
+    cachedTable_ = std::move(lookup.entry);
+    tableCachePool_ = std::move(lookup.pool);
+  }
+
   spillGroup_ = spillEnabled()
       ? operatorCtx_->task()->getSpillOperatorGroupLocked(
             operatorCtx_->driverCtx()->splitGroupId, planNodeId())
@@ -114,6 +158,10 @@ HashBuild::HashBuild(
   }
 
   tableType_ = ROW(std::move(names), std::move(types));
+  if (driverCtx->queryConfig().collectKeyNdvs()) {
+    keyNdvs_ =
+        std::make_unique<KeyNdvEstimator>(inputType, keyChannels_, pool());
+  }
   setupTable();
   setupSpiller();
 
@@ -139,6 +187,9 @@ void HashBuild::setupTable() {
   for (int i = numKeys; i < tableType_->size(); ++i) {
     dependentTypes.emplace_back(tableType_->childAt(i));
   }
+  // A table to be cached is built in a cache owned pool to outlive the query.
+  auto* tablePool =
+      tableCachePool_ != nullptr ? tableCachePool_.get() : pool();
   if (joinNode_->isRightJoin() || joinNode_->isFullJoin() ||
       joinNode_->isRightSemiProjectJoin()) {
     // Do not ignore null keys.
@@ -150,7 +201,7 @@ void HashBuild::setupTable() {
         operatorCtx_->driverCtx()
             ->queryConfig()
             .minTableRowsForParallelJoinBuild(),
-        pool());
+        tablePool);
   } else {
     // (Left) semi and anti join with no extra filter only needs to know whether
     // there is a match. Hence, no need to store entries with duplicate keys.
@@ -170,7 +221,7 @@ void HashBuild::setupTable() {
           operatorCtx_->driverCtx()
               ->queryConfig()
               .minTableRowsForParallelJoinBuild(),
-          pool());
+          tablePool);
     } else {
       // Ignore null keys
       table_ = HashTable<true>::createForJoin(
@@ -181,7 +232,7 @@ void HashBuild::setupTable() {
           operatorCtx_->driverCtx()
               ->queryConfig()
               .minTableRowsForParallelJoinBuild(),
-          pool());
+          tablePool);
     }
   }
   analyzeKeys_ = table_->hashMode() != BaseHashTable::HashMode::kHash;
@@ -206,14 +257,16 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
   } else {
     spillInputReader_ = spillPartition->createReader();
 
-    const auto startBit = spillPartition->id().partitionBitOffset() +
-        spillConfig.joinPartitionBits;
+    const auto partitionBitOffset = spillPartition->id().partitionBitOffset();
+    const auto startBit = partitionBitOffset +
+        spillConfig.joinPartitionBitsAt(partitionBitOffset);
     // Disable spilling if exceeding the max spill level and the query might run
     // out of memory if the restored partition still can't fit in memory.
     if (spillConfig.exceedJoinSpillLevelLimit(startBit)) {
       return;
     }
-    hashBits = HashBitRange(startBit, startBit + spillConfig.joinPartitionBits);
+    hashBits = HashBitRange(
+        startBit, startBit + spillConfig.joinPartitionBitsAt(startBit));
   }
 
   spiller_ = std::make_unique<Spiller>(
@@ -229,7 +282,9 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
       spillConfig.minSpillRunSize,
       spillConfig.compressionKind,
       Spiller::pool(),
-      spillConfig.executor);
+      spillConfig.executor,
+      spillConfig.format,
+      spillConfig.directories);
 
   const int32_t numPartitions = spiller_->hashBits().numPartitions();
   spillInputIndicesBuffers_.resize(numPartitions);
@@ -301,6 +356,11 @@ void HashBuild::removeInputRowsForAntiJoinFilter() {
   }
 }
 
+void HashBuild::initialize() {
+  Operator::initialize();
+  preReserveMemory();
+}
+
 void HashBuild::addInput(RowVectorPtr input) {
   checkRunning();
 
@@ -314,6 +374,10 @@ void HashBuild::addInput(RowVectorPtr input) {
   // the execution belowg.
   NonReclaimableSection guard(this);
 
+  if (keyNdvs_ != nullptr) {
+    keyNdvs_->addInput(*input);
+  }
+
   activeRows_.resize(input->size());
   activeRows_.setAll();
 
@@ -366,6 +430,8 @@ void HashBuild::addInput(RowVectorPtr input) {
     return;
   }
 
+  maybeSampleHotKeys();
+
   if (analyzeKeys_ && hashes_.size() < activeRows_.end()) {
     hashes_.resize(activeRows_.end());
   }
@@ -661,7 +727,9 @@ void HashBuild::runSpill(const std::vector<Operator*>& spillOperators) {
     spiller->fillSpillRuns(spillableStats);
   }
 
-  // Sort the partitions based on the amount of spillable data.
+  // Sort the partitions based on the amount of spillable data, or on how
+  // recently they were inserted into if cold partitions are spilled first.
+  const bool coldFirst = spillConfig()->spillColdPartitionsFirst;
   SpillPartitionNumSet partitionsToSpill;
   std::vector<int32_t> partitionIndices(spillableStats.size());
   std::iota(partitionIndices.begin(), partitionIndices.end(), 0);
@@ -669,7 +737,8 @@ void HashBuild::runSpill(const std::vector<Operator*>& spillOperators) {
       partitionIndices.begin(),
       partitionIndices.end(),
       [&](int32_t lhs, int32_t rhs) {
-        return spillableStats[lhs].numBytes > spillableStats[rhs].numBytes;
+        return Spiller::spillBefore(
+            spillableStats[lhs], spillableStats[rhs], coldFirst);
       });
   int64_t numRows = 0;
   int64_t numBytes = 0;
@@ -708,6 +777,11 @@ void HashBuild::noMoreInput() {
   }
   Operator::noMoreInput();
 
+  if (keyNdvs_ != nullptr) {
+    keyNdvs_->updateStats(*stats_.wlock());
+    keyNdvs_.reset();
+  }
+
   noMoreInputInternal();
 }
 
@@ -777,7 +851,15 @@ bool HashBuild::finishHashBuild() {
     otherBuilds.push_back(build);
   }
 
+  if (cachedTable_.has_value()) {
+    addRuntimeStat("tableCacheHit", RuntimeCounter(1));
+    joinBridge_->setHashTable(
+        cachedTable_->table, {}, cachedTable_->hasNullKeys);
+    return true;
+  }
+
   ensureTableFits(numRows);
+  findHotKeys(otherBuilds, numRows);
 
   NonReclaimableSection guard(this);
   std::vector<std::unique_ptr<BaseHashTable>> otherTables;
@@ -816,9 +898,23 @@ bool HashBuild::finishHashBuild() {
       std::move(otherTables),
       allowParallelJoinBuild ? operatorCtx_->task()->queryCtx()->executor()
                              : nullptr);
+  maybeBuildKeyBloomFilters(spillPartitions.empty());
   addRuntimeStats();
+  std::shared_ptr<BaseHashTable> table;
+  if (tableCachePool_ != nullptr) {
+    // The deleter keeps the cache pool alive until the table is destroyed
+    // whether or not the table makes it into the cache.
+    VELOX_CHECK(spillPartitions.empty());
+    table = std::shared_ptr<BaseHashTable>(
+        table_.release(),
+        [pool = tableCachePool_](BaseHashTable* table) { delete table; });
+    HashJoinTableCache::instance().put(
+        tableCacheKey_, table, joinHasNullKeys_, tableCachePool_);
+  } else {
+    table = std::move(table_);
+  }
   if (joinBridge_->setHashTable(
-          std::move(table_), std::move(spillPartitions), joinHasNullKeys_)) {
+          std::move(table), std::move(spillPartitions), joinHasNullKeys_)) {
     spillGroup_->restart();
   }
 
@@ -828,6 +924,107 @@ bool HashBuild::finishHashBuild() {
   return true;
 }
 
+void HashBuild::maybeBuildKeyBloomFilters(bool hasAllRows) {
+  const auto& queryConfig = operatorCtx_->driverCtx()->queryConfig();
+  if (!queryConfig.hashJoinBloomFilterEnabled() || !hasAllRows ||
+      table_->hashMode() != BaseHashTable::HashMode::kHash) {
+    return;
+  }
+  // Same join types as the ones that push down dynamic filters in HashProbe.
+  if (!isInnerJoin(joinType_) && !isLeftSemiFilterJoin(joinType_) &&
+      !isRightSemiFilterJoin(joinType_) && !isRightSemiProjectJoin(joinType_)) {
+    return;
+  }
+  uint64_t bloomFilterTimeUs{0};
+  {
+    MicrosecondTimer timer(&bloomFilterTimeUs);
+    table_->buildKeyBloomFilters(queryConfig.hashJoinBloomFilterMaxRows());
+  }
+  if (table_->hasKeyBloomFilters()) {
+    addRuntimeStat(
+        "bloomFilterBuildTime",
+        RuntimeCounter(
+            bloomFilterTimeUs * 1'000, RuntimeCounter::Unit::kNanos));
+  }
+}
+
+void HashBuild::maybeSampleHotKeys() {
+  if (hotKeyRowsPct_ == 0) {
+    return;
+  }
+  sampleRows_.resize(activeRows_.end());
+  sampleRows_.clearAll();
+  activeRows_.applyToSelected([&](auto row) {
+    if (++hotKeySampleCounter_ % kHotKeySampleInterval == 0) {
+      sampleRows_.setValid(row, true);
+    }
+  });
+  sampleRows_.updateBounds();
+  if (!sampleRows_.hasSelections()) {
+    return;
+  }
+
+  sampleHashes_.resize(sampleRows_.end());
+  auto& hashers = table_->hashers();
+  for (auto i = 0; i < hashers.size(); ++i) {
+    hashers[i]->hash(sampleRows_, i > 0, sampleHashes_);
+  }
+  sampleRows_.applyToSelected([&](auto row) {
+    const auto hash = sampleHashes_[row];
+    if (hotKeySamples_.size() < kMaxHotKeySamples) {
+      ++hotKeySamples_[hash];
+      return;
+    }
+    auto it = hotKeySamples_.find(hash);
+    if (it != hotKeySamples_.end()) {
+      ++it->second;
+    }
+  });
+
+  if (hotKeySamples_.size() >= kMaxHotKeySamples) {
+    for (auto it = hotKeySamples_.begin(); it != hotKeySamples_.end();) {
+      if (it->second == 1) {
+        it = hotKeySamples_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+void HashBuild::findHotKeys(
+    const std::vector<HashBuild*>& otherBuilds,
+    uint64_t numRows) {
+  if (hotKeyRowsPct_ == 0 || numRows == 0) {
+    return;
+  }
+  for (auto* build : otherBuilds) {
+    for (const auto& [hash, count] : build->hotKeySamples_) {
+      hotKeySamples_[hash] += count;
+    }
+    build->hotKeySamples_.clear();
+  }
+
+  hotKeyHashes_.clear();
+  numHotKeyRows_ = 0;
+  const double minHotKeyRows = numRows * hotKeyRowsPct_ / 100;
+  for (const auto& [hash, count] : hotKeySamples_) {
+    const auto estimatedRows = count * kHotKeySampleInterval;
+    if (count >= kMinHotKeySamples && estimatedRows >= minHotKeyRows) {
+      hotKeyHashes_.push_back(hash);
+      numHotKeyRows_ += estimatedRows;
+    }
+  }
+  hotKeySamples_.clear();
+  if (!hotKeyHashes_.empty()) {
+    VLOG(1) << "Hash join " << planNodeId() << " has "
+            << hotKeyHashes_.size() << " hot keys with about "
+            << numHotKeyRows_ << " of " << numRows
+            << " build side rows, key hashes: "
+            << folly::join(", ", hotKeyHashes_);
+  }
+}
+
 void HashBuild::recordSpillStats() {
   VELOX_CHECK_NOT_NULL(spiller_);
   const auto spillStats = spiller_->stats();
@@ -953,6 +1150,13 @@ void HashBuild::addRuntimeStats() {
         RuntimeMetric(hashTableStats.numTombstones);
   }
 
+  if (!hotKeyHashes_.empty()) {
+    lockedStats->addRuntimeStat(
+        "hashtable.numHotKeys", RuntimeCounter(hotKeyHashes_.size()));
+    lockedStats->addRuntimeStat(
+        "hashtable.hotKeyRows", RuntimeCounter(numHotKeyRows_));
+  }
+
   // Add max spilling level stats if spilling has been triggered.
   if (spiller_ != nullptr && spiller_->isAnySpilled()) {
     lockedStats->addRuntimeStat(
@@ -967,6 +1171,9 @@ BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
     case State::kRunning:
       if (isInputFromSpill()) {
         processSpillInput();
+      } else if (cachedTable_.has_value() && !noMoreInput_) {
+        // The table is cached, so skip the build input.
+        noMoreInput();
       }
       break;
     case State::kFinish:
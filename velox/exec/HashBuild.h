@@ -17,6 +17,7 @@
 
 #include "velox/exec/HashJoinBridge.h"
 #include "velox/exec/HashTable.h"
+#include "velox/exec/KeyNdvEstimator.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/Spill.h"
 #include "velox/exec/SpillOperatorGroup.h"
@@ -61,6 +62,8 @@ class HashBuild final : public Operator {
       DriverCtx* FOLLY_NONNULL driverCtx,
       std::shared_ptr<const core::HashJoinNode> joinNode);
 
+  void initialize() override;
+
   void addInput(RowVectorPtr input) override;
 
   RowVectorPtr getOutput() override {
@@ -68,7 +71,7 @@ class HashBuild final : public Operator {
   }
 
   bool needsInput() const override {
-    return !noMoreInput_;
+    return !noMoreInput_ && !cachedTable_.has_value();
   }
 
   void noMoreInput() override;
@@ -118,6 +121,23 @@ class HashBuild final : public Operator {
 
   void recordSpillStats();
 
+  // Makes Bloom filters over the join keys of 'table_' for pushdown into the
+  // probe side scan if enabled by the query config and applicable to the join.
+  // 'hasAllRows' is false if some build side rows were spilled, in which case
+  // the filters are not made since they would drop probe rows of the spilled
+  // partitions.
+  void maybeBuildKeyBloomFilters(bool hasAllRows);
+
+  // Adds the keys of a sample of 'activeRows_' to 'hotKeySamples_' if hot key
+  // detection is enabled. Expects the key columns to be decoded by the table
+  // hashers.
+  void maybeSampleHotKeys();
+
+  // Merges the key samples of 'otherBuilds' into 'hotKeySamples_' and sets
+  // 'hotKeyHashes_' to the hashes of the keys having at least
+  // 'hotKeyRowsPct_' of 'numRows' build side rows.
+  void findHotKeys(const std::vector<HashBuild*>& otherBuilds, uint64_t numRows);
+
   // Indicates if the input is read from spill data or not.
   bool isInputFromSpill() const;
 
@@ -233,6 +253,16 @@ class HashBuild final : public Operator {
 
   void addRuntimeStats();
 
+  // Picks every 64th input row for sampling the join keys.
+  static constexpr uint64_t kHotKeySampleInterval = 64;
+
+  // The max number of distinct keys in 'hotKeySamples_'. If exceeded, the
+  // keys sampled only once are dropped since these can't be hot.
+  static constexpr size_t kMaxHotKeySamples = 64 << 10;
+
+  // The min number of samples of a key to be reported as hot.
+  static constexpr uint64_t kMinHotKeySamples = 4;
+
   // Invoked to check if it needs to trigger spilling for test purpose only.
   bool testingTriggerSpill();
 
@@ -248,6 +278,22 @@ class HashBuild final : public Operator {
   // If it is zero, then there is no such limit.
   const uint64_t spillMemoryThreshold_;
 
+  // The min percentage of build side rows for a join key to be reported as
+  // hot. 0 if hot key detection is disabled.
+  const double hotKeyRowsPct_;
+
+  // The key of the build side table in HashJoinTableCache. Empty if the table
+  // is not cached.
+  const std::string tableCacheKey_;
+
+  // Set if the table is found in HashJoinTableCache. The build input is
+  // skipped and the cached table is handed over to the probe side.
+  std::optional<HashJoinTableCache::Entry> cachedTable_;
+
+  // Set if the table is to be built and then cached in HashJoinTableCache.
+  // The table is built in this pool owned by the cache.
+  std::shared_ptr<memory::MemoryPool> tableCachePool_;
+
   std::shared_ptr<SpillOperatorGroup> spillGroup_;
 
   State state_{State::kRunning};
@@ -264,6 +310,10 @@ class HashBuild final : public Operator {
   // Non-key channels in 'input_'.
   std::vector<column_index_t> dependentChannels_;
 
+  // Estimates the distinct values of the join keys if
+  // QueryConfig::kCollectKeyNdvs is set. Reported and reset on noMoreInput().
+  std::unique_ptr<KeyNdvEstimator> keyNdvs_;
+
   // Corresponds 1:1 to 'dependentChannels_'.
   std::vector<std::unique_ptr<DecodedVector>> decoders_;
 
@@ -314,6 +364,25 @@ class HashBuild final : public Operator {
   std::vector<column_index_t> keyFilterChannels_;
   // Indices of dependent columns used by the filter in 'decoders_'.
   std::vector<column_index_t> dependentFilterChannels_;
+
+  // Sampled number of rows per join key hash for hot key detection. The key
+  // hashes are the ones computed by the table hashers, which are the same as
+  // the ones of a HashPartitionFunction on the same keys.
+  folly::F14FastMap<uint64_t, uint64_t> hotKeySamples_;
+
+  // Counts the input rows for picking one in 'kHotKeySampleInterval' rows.
+  uint64_t hotKeySampleCounter_{0};
+
+  // Hashes of the hot join keys found over all build side drivers. Set by the
+  // last driver to finish the build.
+  std::vector<uint64_t> hotKeyHashes_;
+
+  // The estimated number of build side rows of the hot keys.
+  uint64_t numHotKeyRows_{0};
+
+  // Reusable memory for hot key sampling.
+  SelectivityVector sampleRows_;
+  raw_vector<uint64_t> sampleHashes_;
 };
 
 inline std::ostream& operator<<(std::ostream& os, HashBuild::State state) {
@@ -38,8 +38,24 @@ void HashJoinBridge::addBuilder() {
   ++numBuilders_;
 }
 
+HashJoinBridge::TableCacheLookup HashJoinBridge::lookupTableCache(
+    const std::string& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!started_);
+  if (!tableCacheLookup_.has_value()) {
+    auto& cache = HashJoinTableCache::instance();
+    TableCacheLookup lookup;
+    lookup.entry = cache.find(key);
+    if (!lookup.entry.has_value()) {
+      lookup.pool = cache.makePool(key);
+    }
+    tableCacheLookup_ = std::move(lookup);
+  }
+  return tableCacheLookup_.value();
+}
+
 bool HashJoinBridge::setHashTable(
-    std::unique_ptr<BaseHashTable> table,
+    std::shared_ptr<BaseHashTable> table,
     SpillPartitionSet spillPartitionSet,
     bool hasNullKeys) {
   VELOX_CHECK_NOT_NULL(table, "setHashTable called with null table");
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/exec/HashJoinTableCache.h"
 #include "velox/exec/HashTable.h"
 #include "velox/exec/JoinBridge.h"
 #include "velox/exec/Spill.h"
@@ -39,12 +40,25 @@ class HashJoinBridge : public JoinBridge {
   /// after HashProbe operators process 'table', otherwise false. This only
   /// applies if the disk spilling is enabled.
   bool setHashTable(
-      std::unique_ptr<BaseHashTable> table,
+      std::shared_ptr<BaseHashTable> table,
       SpillPartitionSet spillPartitionSet,
       bool hasNullKeys);
 
   void setAntiJoinHasNullKeys();
 
+  /// The result of looking up the build side table in HashJoinTableCache.
+  /// 'entry' is set if the table is cached. Otherwise, 'pool' is the memory
+  /// pool to build the table in so that it can be cached after the build.
+  struct TableCacheLookup {
+    std::optional<HashJoinTableCache::Entry> entry;
+    std::shared_ptr<memory::MemoryPool> pool;
+  };
+
+  /// Invoked by HashBuild operator ctor to look up the build side table cached
+  /// under 'key'. The lookup is done once by the first caller and all the
+  /// HashBuild operators of the join get the same result.
+  TableCacheLookup lookupTableCache(const std::string& key);
+
   /// Represents the result of HashBuild operators: a hash table, an optional
   /// restored spill partition id associated with the table, and the spilled
   /// partitions while building the table if not empty. In case of an anti join,
@@ -107,6 +121,9 @@ class HashJoinBridge : public JoinBridge {
  private:
   uint32_t numBuilders_{0};
 
+  // Set by the first lookupTableCache() call.
+  std::optional<TableCacheLookup> tableCacheLookup_;
+
   std::optional<HashBuildResult> buildResult_;
 
   // restoringSpillPartitionXxx member variables are populated by the
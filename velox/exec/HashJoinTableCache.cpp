@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/HashJoinTableCache.h"
+
+namespace facebook::velox::exec {
+namespace {
+// Default capacity of the cache.
+constexpr uint64_t kDefaultCapacity = 1UL << 30;
+
+// Reclaims memory from the cache pool for the memory arbitrator by evicting
+// unreferenced tables.
+class HashJoinTableCacheReclaimer final : public memory::MemoryReclaimer {
+ public:
+  static std::unique_ptr<memory::MemoryReclaimer> create() {
+    return std::unique_ptr<memory::MemoryReclaimer>(
+        new HashJoinTableCacheReclaimer());
+  }
+
+  bool reclaimableBytes(
+      const memory::MemoryPool& /*pool*/,
+      uint64_t& reclaimableBytes) const override {
+    reclaimableBytes = HashJoinTableCache::instance().evictableBytes();
+    return reclaimableBytes > 0;
+  }
+
+  uint64_t reclaim(memory::MemoryPool* /*pool*/, uint64_t targetBytes)
+      override {
+    return HashJoinTableCache::instance().evict(targetBytes);
+  }
+
+ private:
+  HashJoinTableCacheReclaimer() : MemoryReclaimer() {}
+};
+} // namespace
+
+// static
+HashJoinTableCache& HashJoinTableCache::instance() {
+  static HashJoinTableCache cache;
+  return cache;
+}
+
+HashJoinTableCache::HashJoinTableCache()
+    : pool_(memory::defaultMemoryManager().addRootPool(
+          "HashJoinTableCache",
+          memory::kMaxMemory,
+          HashJoinTableCacheReclaimer::create())),
+      capacity_(kDefaultCapacity) {}
+
+void HashJoinTableCache::setCapacity(uint64_t capacity) {
+  std::lock_guard<std::mutex> l(mutex_);
+  capacity_ = capacity;
+  const auto currentBytes = currentBytesLocked();
+  if (currentBytes > capacity_) {
+    evictLocked(currentBytes - capacity_);
+  }
+}
+
+uint64_t HashJoinTableCache::capacity() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return capacity_;
+}
+
+std::optional<HashJoinTableCache::Entry> HashJoinTableCache::find(
+    const std::string& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++stats_.numMisses;
+    return std::nullopt;
+  }
+  ++stats_.numHits;
+  it->second.lastUse = ++useCounter_;
+  return it->second.entry;
+}
+
+std::shared_ptr<memory::MemoryPool> HashJoinTableCache::makePool(
+    const std::string& /*key*/) {
+  std::lock_guard<std::mutex> l(mutex_);
+  return pool_->addLeafChild(
+      fmt::format("HashJoinTableCache.{}", poolCounter_++));
+}
+
+void HashJoinTableCache::put(
+    const std::string& key,
+    std::shared_ptr<BaseHashTable> table,
+    bool hasNullKeys,
+    std::shared_ptr<memory::MemoryPool> pool) {
+  VELOX_CHECK_NOT_NULL(table);
+  VELOX_CHECK_NOT_NULL(pool);
+  std::lock_guard<std::mutex> l(mutex_);
+  if (entries_.count(key) != 0) {
+    return;
+  }
+  entries_[key] = CacheEntry{
+      std::move(pool), Entry{std::move(table), hasNullKeys}, ++useCounter_};
+  const auto currentBytes = currentBytesLocked();
+  if (currentBytes > capacity_) {
+    evictLocked(currentBytes - capacity_);
+  }
+}
+
+uint64_t HashJoinTableCache::evict(uint64_t targetBytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  return evictLocked(targetBytes);
+}
+
+uint64_t HashJoinTableCache::evictLocked(uint64_t targetBytes) {
+  uint64_t freedBytes = 0;
+  while (targetBytes == 0 || freedBytes < targetBytes) {
+    auto victim = entries_.end();
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (isEvictable(it->second) &&
+          (victim == entries_.end() ||
+           it->second.lastUse < victim->second.lastUse)) {
+        victim = it;
+      }
+    }
+    if (victim == entries_.end()) {
+      break;
+    }
+    freedBytes += victim->second.pool->currentBytes();
+    entries_.erase(victim);
+    ++stats_.numEvictions;
+  }
+  return freedBytes;
+}
+
+uint64_t HashJoinTableCache::evictableBytes() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  uint64_t bytes = 0;
+  for (const auto& [key, entry] : entries_) {
+    if (isEvictable(entry)) {
+      bytes += entry.pool->currentBytes();
+    }
+  }
+  return bytes;
+}
+
+uint64_t HashJoinTableCache::currentBytesLocked() const {
+  uint64_t bytes = 0;
+  for (const auto& [key, entry] : entries_) {
+    bytes += entry.pool->currentBytes();
+  }
+  return bytes;
+}
+
+HashJoinTableCache::Stats HashJoinTableCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto stats = stats_;
+  stats.numEntries = entries_.size();
+  stats.currentBytes = currentBytesLocked();
+  return stats;
+}
+
+void HashJoinTableCache::testingClear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  evictLocked(0);
+  stats_ = Stats{};
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/container/F14Map.h>
+
+#include "velox/common/memory/Memory.h"
+#include "velox/exec/HashTable.h"
+
+namespace facebook::velox::exec {
+
+/// Process wide cache of built hash join tables. A join whose build side is
+/// the same across queries, e.g. a dimension table of one snapshot, builds the
+/// table once and later joins with the same cache key take it from here
+/// instead of running the build. See 'hash_join_table_cache_key' for what goes
+/// into the key.
+///
+/// The cached tables are allocated from memory pools owned by the cache so that
+/// they outlive the query that built them. A table is referenced via shared_ptr
+/// by the joins probing it. Unreferenced tables are evicted in LRU order when
+/// the cache goes over its capacity or when the memory arbitrator reclaims
+/// memory from the cache pool.
+class HashJoinTableCache {
+ public:
+  struct Entry {
+    std::shared_ptr<BaseHashTable> table;
+    bool hasNullKeys{false};
+  };
+
+  struct Stats {
+    int64_t numEntries{0};
+    int64_t numHits{0};
+    int64_t numMisses{0};
+    int64_t numEvictions{0};
+    int64_t currentBytes{0};
+  };
+
+  static HashJoinTableCache& instance();
+
+  /// Sets the max memory in bytes held by the cached tables and evicts
+  /// unreferenced tables to get under it.
+  void setCapacity(uint64_t capacity);
+
+  uint64_t capacity() const;
+
+  /// Returns the table cached under 'key' or std::nullopt if there is none.
+  std::optional<Entry> find(const std::string& key);
+
+  /// Returns a new leaf memory pool to build the table to cache under 'key'.
+  std::shared_ptr<memory::MemoryPool> makePool(const std::string& key);
+
+  /// Caches 'table' built in 'pool' under 'key'. 'pool' is expected to be
+  /// made by makePool(). Does nothing if 'key' is already cached by a
+  /// concurrent build.
+  void put(
+      const std::string& key,
+      std::shared_ptr<BaseHashTable> table,
+      bool hasNullKeys,
+      std::shared_ptr<memory::MemoryPool> pool);
+
+  /// Evicts unreferenced tables in LRU order until at least 'targetBytes' are
+  /// freed. Evicts all unreferenced tables if 'targetBytes' is 0. Returns the
+  /// number of freed bytes.
+  uint64_t evict(uint64_t targetBytes);
+
+  /// Returns the memory held by the unreferenced tables.
+  uint64_t evictableBytes() const;
+
+  Stats stats() const;
+
+  /// Removes all unreferenced tables and resets the stats.
+  void testingClear();
+
+ private:
+  struct CacheEntry {
+    // Declared before 'entry' to be destroyed after the table.
+    std::shared_ptr<memory::MemoryPool> pool;
+    Entry entry;
+    uint64_t lastUse{0};
+  };
+
+  HashJoinTableCache();
+
+  // Returns true if 'entry' is not referenced outside of the cache.
+  static bool isEvictable(const CacheEntry& entry) {
+    return entry.entry.table.use_count() == 1;
+  }
+
+  uint64_t evictLocked(uint64_t targetBytes);
+
+  uint64_t currentBytesLocked() const;
+
+  mutable std::mutex mutex_;
+  std::shared_ptr<memory::MemoryPool> pool_;
+  uint64_t capacity_;
+  uint64_t useCounter_{0};
+  uint64_t poolCounter_{0};
+  folly::F14FastMap<std::string, CacheEntry> entries_;
+  Stats stats_;
+};
+} // namespace facebook::velox::exec
@@ -84,13 +84,55 @@ std::optional<uint32_t> HashPartitionFunction::partition(
     }
   }
 
+  if (!skewedHashes_.empty()) {
+    for (auto i = 0; i < size; ++i) {
+      if (!skewedHashes_.contains(hashes_[i])) {
+        continue;
+      }
+      if (replicateSkewedKeys_) {
+        partitions[i] = kAllPartitions;
+      } else {
+        partitions[i] = nextSkewedPartition_;
+        nextSkewedPartition_ = (nextSkewedPartition_ + 1) % numPartitions_;
+      }
+    }
+  }
+
   return std::nullopt;
 }
 
+bool HashPartitionFunction::hasOnlyColumnKeys() const {
+  for (const auto& hasher : hashers_) {
+    if (hasher->channel() == kConstantChannel) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<column_index_t> HashPartitionFunction::keyChannels() const {
+  std::vector<column_index_t> channels;
+  channels.reserve(hashers_.size());
+  for (const auto& hasher : hashers_) {
+    channels.push_back(hasher->channel());
+  }
+  return channels;
+}
+
+void HashPartitionFunction::setSkewedKeys(const SkewedKeys& skewedKeys) {
+  skewedHashes_.clear();
+  skewedHashes_.insert(skewedKeys.hashes.begin(), skewedKeys.hashes.end());
+  replicateSkewedKeys_ = skewedKeys.replicate;
+}
+
 std::unique_ptr<core::PartitionFunction> HashPartitionFunctionSpec::create(
     int numPartitions) const {
-  return std::make_unique<exec::HashPartitionFunction>(
+  auto function = std::make_unique<exec::HashPartitionFunction>(
       numPartitions, inputType_, keyChannels_, constValues_);
+  if (!skewedKeys_.empty()) {
+    function->setSkewedKeys(skewedKeys_);
+  }
+  return function;
 }
 
 std::string HashPartitionFunctionSpec::toString() const {
@@ -108,6 +150,13 @@ std::string HashPartitionFunctionSpec::toString() const {
     }
   }
 
+  if (!skewedKeys_.empty()) {
+    return fmt::format(
+        "HASH({}) SKEWED({} keys, {})",
+        keys.str(),
+        skewedKeys_.hashes.size(),
+        skewedKeys_.replicate ? "REPLICATE" : "SPREAD");
+  }
   return fmt::format("HASH({})", keys.str());
 }
 
@@ -123,6 +172,14 @@ folly::dynamic HashPartitionFunctionSpec::serialize() const {
     constValues.emplace_back(value);
   }
   obj["constants"] = ISerializable::serialize(constValues);
+  if (!skewedKeys_.empty()) {
+    folly::dynamic hashes = folly::dynamic::array;
+    for (const auto hash : skewedKeys_.hashes) {
+      hashes.push_back(static_cast<int64_t>(hash));
+    }
+    obj["skewedKeyHashes"] = std::move(hashes);
+    obj["replicateSkewedKeys"] = skewedKeys_.replicate;
+  }
   return obj;
 }
 
@@ -142,7 +199,17 @@ core::PartitionFunctionSpecPtr HashPartitionFunctionSpec::deserialize(
   for (const auto& value : constTypeExprs) {
     constValues.emplace_back(value->toConstantVector(pool));
   }
+  SkewedKeys skewedKeys;
+  if (obj.count("skewedKeyHashes")) {
+    for (const auto& hash : obj["skewedKeyHashes"]) {
+      skewedKeys.hashes.push_back(static_cast<uint64_t>(hash.asInt()));
+    }
+    skewedKeys.replicate = obj["replicateSkewedKeys"].asBool();
+  }
   return std::make_shared<HashPartitionFunctionSpec>(
-      ISerializable::deserialize<RowType>(obj["inputType"]), keys, constValues);
+      ISerializable::deserialize<RowType>(obj["inputType"]),
+      keys,
+      constValues,
+      std::move(skewedKeys));
 }
 } // namespace facebook::velox::exec
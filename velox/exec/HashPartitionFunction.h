@@ -15,12 +15,31 @@
  */
 #pragma once
 
+#include <folly/container/F14Set.h>
 #include <velox/exec/HashBitRange.h>
 #include <velox/exec/VectorHasher.h>
 #include "velox/core/PlanNode.h"
 
 namespace facebook::velox::exec {
 
+/// Describes the join keys with too many rows to be handled by a single
+/// partition. The HashBuild operator reports these if
+/// 'hash_join_hot_key_rows_pct' is set.
+struct SkewedKeys {
+  /// Hashes of the skewed keys as computed by VectorHasher over the
+  /// partitioning keys.
+  std::vector<uint64_t> hashes;
+
+  /// If true, the rows of skewed keys go to all partitions. This is for the
+  /// build side of a join. Otherwise these rows are spread round-robin over the
+  /// partitions, which is for the probe side.
+  bool replicate{false};
+
+  bool empty() const {
+    return hashes.empty();
+  }
+};
+
 class HashPartitionFunction : public core::PartitionFunction {
  public:
   HashPartitionFunction(
@@ -45,6 +64,22 @@ class HashPartitionFunction : public core::PartitionFunction {
     return numPartitions_;
   }
 
+  /// Returns true if no partitioning key is a constant, so that the hashes
+  /// of the last partition() depend only on columns of the input.
+  bool hasOnlyColumnKeys() const;
+
+  /// Returns the input channels of the partitioning keys in order.
+  std::vector<column_index_t> keyChannels() const;
+
+  /// Returns the hashes of the rows of the input of the last partition().
+  const raw_vector<uint64_t>& hashes() const {
+    return hashes_;
+  }
+
+  /// Sets the keys whose rows are replicated or spread over all partitions
+  /// instead of going to the partition of their hash.
+  void setSkewedKeys(const SkewedKeys& skewedKeys);
+
  private:
   void init(
       const RowTypePtr& inputType,
@@ -55,6 +90,14 @@ class HashPartitionFunction : public core::PartitionFunction {
   const std::optional<HashBitRange> hashBitRange_ = std::nullopt;
   std::vector<std::unique_ptr<VectorHasher>> hashers_;
 
+  // Hashes of the skewed keys. See SkewedKeys.
+  folly::F14FastSet<uint64_t> skewedHashes_;
+  bool replicateSkewedKeys_{false};
+
+  // The partition for the next row of a skewed key if the rows are spread
+  // round-robin.
+  uint32_t nextSkewedPartition_{0};
+
   // Reusable memory.
   SelectivityVector rows_;
   raw_vector<uint64_t> hashes_;
@@ -65,15 +108,19 @@ class HashPartitionFunction : public core::PartitionFunction {
 /// constant, use index 'kConstantChannel' to indicate so and store the constant
 /// value as a base vector in 'constValues'
 /// The 'constValues' size is less than or equal to 'keyChannels' size
+/// If 'skewedKeys' is not empty, the rows of these keys are replicated or
+/// spread over all partitions as described in SkewedKeys.
 class HashPartitionFunctionSpec : public core::PartitionFunctionSpec {
  public:
   HashPartitionFunctionSpec(
       RowTypePtr inputType,
       std::vector<column_index_t> keyChannels,
-      std::vector<VectorPtr> constValues = {})
+      std::vector<VectorPtr> constValues = {},
+      SkewedKeys skewedKeys = {})
       : inputType_{std::move(inputType)},
         keyChannels_{std::move(keyChannels)},
-        constValues_{std::move(constValues)} {}
+        constValues_{std::move(constValues)},
+        skewedKeys_{std::move(skewedKeys)} {}
 
   std::unique_ptr<core::PartitionFunction> create(
       int numPartitions) const override;
@@ -90,5 +137,6 @@ class HashPartitionFunctionSpec : public core::PartitionFunctionSpec {
   const RowTypePtr inputType_;
   const std::vector<column_index_t> keyChannels_;
   const std::vector<VectorPtr> constValues_;
+  const SkewedKeys skewedKeys_;
 };
 } // namespace facebook::velox::exec
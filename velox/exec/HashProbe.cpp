@@ -237,19 +237,20 @@ void HashProbe::maybeSetupSpillInput(
   // spill the incoming probe inputs.
   const auto& spillConfig = spillConfig_.value();
   ++numSpillRuns_;
+  const auto startBit = spillInputPartitionIds_.begin()->partitionBitOffset();
   spiller_ = std::make_unique<Spiller>(
       Spiller::Type::kHashJoinProbe,
       probeType_,
       HashBitRange(
-          spillInputPartitionIds_.begin()->partitionBitOffset(),
-          spillInputPartitionIds_.begin()->partitionBitOffset() +
-              spillConfig.joinPartitionBits),
+          startBit, startBit + spillConfig.joinPartitionBitsAt(startBit)),
       spillConfig.filePath,
       spillConfig.maxFileSize,
       spillConfig.minSpillRunSize,
       spillConfig.compressionKind,
       Spiller::pool(),
-      spillConfig.executor);
+      spillConfig.executor,
+      spillConfig.format,
+      spillConfig.directories);
   // Set the spill partitions to the corresponding ones at the build side. The
   // hash probe operator itself won't trigger any spilling.
   spiller_->setPartitionsSpilled(toPartitionNumSet(spillInputPartitionIds_));
@@ -307,8 +308,9 @@ void HashProbe::asyncWaitForHashTable() {
   } else if (
       (isInnerJoin(joinType_) || isLeftSemiFilterJoin(joinType_) ||
        isRightSemiFilterJoin(joinType_) || isRightSemiProjectJoin(joinType_)) &&
-      table_->hashMode() != BaseHashTable::HashMode::kHash && !isSpillInput() &&
-      !hasMoreSpillData()) {
+      (table_->hashMode() != BaseHashTable::HashMode::kHash ||
+       table_->hasKeyBloomFilters()) &&
+      !isSpillInput() && !hasMoreSpillData()) {
     // Find out whether there are any upstream operators that can accept
     // dynamic filters on all or a subset of the join keys. Create dynamic
     // filters to push down.
@@ -317,15 +319,28 @@ void HashProbe::asyncWaitForHashTable() {
     // probe input is read from spilled data and there is no upstream operators
     // involved; (2) if there is spill data to restore, then we can't filter
     // probe inputs solely based on the current table's join keys.
+    //
+    // The value filters from the VectorHashers are exact. If a key has none,
+    // falls back to the approximate Bloom filter made by HashBuild, if any.
     const auto& buildHashers = table_->hashers();
     auto channels = operatorCtx_->driverCtx()->driver->canPushdownFilters(
         this, keyChannels_);
     for (auto i = 0; i < keyChannels_.size(); i++) {
-      if (channels.find(keyChannels_[i]) != channels.end()) {
+      if (channels.find(keyChannels_[i]) == channels.end()) {
+        continue;
+      }
+      if (table_->hashMode() != BaseHashTable::HashMode::kHash) {
         if (auto filter = buildHashers[i]->getFilter(false)) {
           dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
+          continue;
         }
       }
+      if (auto bloomFilter = table_->keyBloomFilter(i)) {
+        dynamicFilters_.emplace(
+            keyChannels_[i],
+            std::make_shared<common::BloomFilterValues>(
+                std::move(bloomFilter), false));
+      }
     }
   }
 }
@@ -484,9 +499,12 @@ void HashProbe::clearDynamicFilters() {
   // The join can be completely replaced with a pushed down
   // filter when the following conditions are met:
   //  * hash table has a single key with unique values,
-  //  * build side has no dependent columns.
+  //  * build side has no dependent columns,
+  //  * the pushed down filter is exact, i.e. not a Bloom filter.
   if (keyChannels_.size() == 1 && !table_->hasDuplicateKeys() &&
-      tableOutputProjections_.empty() && !filter_ && !dynamicFilters_.empty()) {
+      tableOutputProjections_.empty() && !filter_ && !dynamicFilters_.empty() &&
+      dynamicFilters_.begin()->second->kind() !=
+          common::FilterKind::kBloomFilterValues) {
     canReplaceWithDynamicFilter_ = true;
   }
 
@@ -570,13 +588,23 @@ void HashProbe::addInput(RowVectorPtr input) {
   lookup_->hashes.resize(input_->size());
   auto mode = table_->hashMode();
   auto& buildHashers = table_->hashers();
-  for (auto i = 0; i < keyChannels_.size(); ++i) {
-    if (mode != BaseHashTable::HashMode::kHash) {
-      auto key = input_->childAt(keyChannels_[i]);
-      buildHashers[i]->lookupValueIds(
-          *key, activeRows_, scratchMemory_, lookup_->hashes);
-    } else {
-      hashers_[i]->hash(activeRows_, i > 0, lookup_->hashes);
+  const uint64_t* attachedHashes = mode == BaseHashTable::HashMode::kHash
+      ? attachedKeyHashes(*input_, hashers_)
+      : nullptr;
+  if (attachedHashes != nullptr) {
+    std::copy(
+        attachedHashes,
+        attachedHashes + input_->size(),
+        lookup_->hashes.data());
+  } else {
+    for (auto i = 0; i < keyChannels_.size(); ++i) {
+      if (mode != BaseHashTable::HashMode::kHash) {
+        auto key = input_->childAt(keyChannels_[i]);
+        buildHashers[i]->lookupValueIds(
+            *key, activeRows_, scratchMemory_, lookup_->hashes);
+      } else {
+        hashers_[i]->hash(activeRows_, i > 0, lookup_->hashes);
+      }
     }
   }
   lookup_->rows.clear();
@@ -845,6 +873,9 @@ RowVectorPtr HashProbe::getOutput() {
   checkRunning();
 
   clearIdentityProjectedOutput();
+  if (observedOutputRowSize().has_value()) {
+    outputBatchSize_ = outputBatchRows();
+  }
   if (!input_) {
     if (!hasMoreInput()) {
       if (needLastProbe() && lastProber_) {
@@ -239,7 +239,9 @@ class HashProbe : public Operator {
   }
 
   // TODO: Define batch size as bytes based on RowContainer row sizes.
-  const uint32_t outputBatchSize_;
+  // Updated from the observed output row size if
+  // QueryConfig::kAdaptiveOutputBatchRows is set.
+  uint32_t outputBatchSize_;
 
   const std::shared_ptr<const core::HashJoinNode> joinNode_;
 
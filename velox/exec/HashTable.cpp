@@ -41,6 +41,118 @@ std::string BaseHashTable::modeString(HashMode mode) {
   }
 }
 
+namespace {
+template <TypeKind Kind>
+void addKeysToBloomFilter(
+    const BaseVector& keys,
+    vector_size_t numKeys,
+    BloomFilter<>& bloomFilter) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  const auto* flatKeys = keys.asUnchecked<FlatVector<T>>();
+  for (auto i = 0; i < numKeys; ++i) {
+    if (flatKeys->isNullAt(i)) {
+      continue;
+    }
+    const auto value = flatKeys->valueAt(i);
+    if constexpr (std::is_same_v<T, StringView>) {
+      bloomFilter.insert(
+          common::BloomFilterValues::hashBytes(value.data(), value.size()));
+    } else {
+      bloomFilter.insert(common::BloomFilterValues::hashInt64(value));
+    }
+  }
+}
+
+// Copies the values of 'decoded' for 'rows' to 'offset' bytes into
+// 'packedKeys', which has one entry of 'stride' bytes per row number.
+template <typename T>
+void packKeyColumn(
+    const DecodedVector& decoded,
+    const raw_vector<vector_size_t>& rows,
+    int32_t offset,
+    int32_t stride,
+    char* packedKeys) {
+  for (auto row : rows) {
+    const auto value = decoded.valueAt<T>(row);
+    memcpy(packedKeys + row * stride + offset, &value, sizeof(T));
+  }
+}
+} // namespace
+
+void BaseHashTable::buildKeyBloomFilters(uint64_t maxRows) {
+  keyBloomFilters_.clear();
+  const auto numRows = numDistinct();
+  if (numRows == 0 || numRows > maxRows) {
+    return;
+  }
+
+  std::vector<std::shared_ptr<BloomFilter<>>> bloomFilters(hashers_.size());
+  std::vector<VectorPtr> keys(hashers_.size());
+  constexpr int32_t kBatch = 1024;
+  bool hasBloomFilter{false};
+  for (auto i = 0; i < hashers_.size(); ++i) {
+    switch (hashers_[i]->typeKind()) {
+      case TypeKind::TINYINT:
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        bloomFilters[i] = std::make_shared<BloomFilter<>>();
+        bloomFilters[i]->reset(numRows);
+        keys[i] = BaseVector::create(
+            hashers_[i]->type(), kBatch, rows_->pool());
+        hasBloomFilter = true;
+        break;
+      default:
+        break;
+    }
+  }
+  if (!hasBloomFilter) {
+    return;
+  }
+
+  std::vector<char*> rows(kBatch);
+  RowsIterator iter;
+  while (auto numListed = listAllRows(
+             &iter, kBatch, RowContainer::kUnlimited, rows.data())) {
+    for (auto i = 0; i < hashers_.size(); ++i) {
+      if (bloomFilters[i] == nullptr) {
+        continue;
+      }
+      // Strings are copied out of the row container so that keys spanning
+      // multiple allocations are hashed as contiguous values.
+      rows_->extractColumn(rows.data(), numListed, i, keys[i]);
+      switch (hashers_[i]->typeKind()) {
+        case TypeKind::TINYINT:
+          addKeysToBloomFilter<TypeKind::TINYINT>(
+              *keys[i], numListed, *bloomFilters[i]);
+          break;
+        case TypeKind::SMALLINT:
+          addKeysToBloomFilter<TypeKind::SMALLINT>(
+              *keys[i], numListed, *bloomFilters[i]);
+          break;
+        case TypeKind::INTEGER:
+          addKeysToBloomFilter<TypeKind::INTEGER>(
+              *keys[i], numListed, *bloomFilters[i]);
+          break;
+        case TypeKind::BIGINT:
+          addKeysToBloomFilter<TypeKind::BIGINT>(
+              *keys[i], numListed, *bloomFilters[i]);
+          break;
+        case TypeKind::VARCHAR:
+        case TypeKind::VARBINARY:
+          addKeysToBloomFilter<TypeKind::VARCHAR>(
+              *keys[i], numListed, *bloomFilters[i]);
+          break;
+        default:
+          VELOX_UNREACHABLE();
+      }
+    }
+  }
+  keyBloomFilters_.assign(bloomFilters.begin(), bloomFilters.end());
+}
+
 template <bool ignoreNullKeys>
 HashTable<ignoreNullKeys>::HashTable(
     std::vector<std::unique_ptr<VectorHasher>>&& hashers,
@@ -50,7 +162,8 @@ HashTable<ignoreNullKeys>::HashTable(
     bool isJoinBuild,
     bool hasProbedFlag,
     uint32_t minTableSizeForParallelJoinBuild,
-    memory::MemoryPool* pool)
+    memory::MemoryPool* pool,
+    std::shared_ptr<HashStringAllocator> stringAllocator)
     : BaseHashTable(std::move(hashers)),
       minTableSizeForParallelJoinBuild_(minTableSizeForParallelJoinBuild),
       isJoinBuild_(isJoinBuild) {
@@ -71,8 +184,146 @@ HashTable<ignoreNullKeys>::HashTable(
       isJoinBuild,
       hasProbedFlag,
       hashMode_ != HashMode::kHash,
-      pool);
+      pool,
+      std::move(stringAllocator));
   nextOffset_ = rows_->nextOffset();
+  packedKeyBytes_ = packedKeyBytes();
+  for (auto i = 0; i < hashers_.size(); ++i) {
+    const auto& type = hashers_[i]->type();
+    if (!type->isPrimitiveType() &&
+        ContainerRowSerde::isBinaryEqualityComparable(*type)) {
+      serializedKeyColumns_.resize(hashers_.size());
+      serializedKeyColumns_[i] = true;
+    }
+  }
+}
+
+template <bool ignoreNullKeys>
+int32_t HashTable<ignoreNullKeys>::packedKeyBytes() const {
+  // Nullable keys need a null flag check per key.
+  constexpr int32_t kMaxPackedKeyBytes = 32;
+  if (!ignoreNullKeys || hashers_.size() < 2) {
+    return 0;
+  }
+  int32_t numBytes = 0;
+  for (auto i = 0; i < hashers_.size(); ++i) {
+    switch (hashers_[i]->typeKind()) {
+      case TypeKind::TINYINT:
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+        break;
+      default:
+        return 0;
+    }
+    // The keys are expected to be back to back at the start of the row.
+    if (rows_->columnAt(i).offset() != numBytes) {
+      return 0;
+    }
+    numBytes += hashers_[i]->type()->cppSizeInBytes();
+  }
+  return numBytes <= kMaxPackedKeyBytes ? numBytes : 0;
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::packProbeKeys(HashLookup& lookup) {
+  if (packedKeyBytes_ == 0) {
+    lookup.packedKeyWords = 0;
+    return;
+  }
+  const auto numWords = bits::nwords(packedKeyBytes_ * 8);
+  lookup.packedKeyWords = numWords;
+  lookup.packedKeys.resize(lookup.hashes.size() * numWords);
+  auto* packedKeys = reinterpret_cast<char*>(lookup.packedKeys.data());
+  const auto stride = numWords * sizeof(uint64_t);
+  int32_t offset = 0;
+  for (auto i = 0; i < lookup.hashers.size(); ++i) {
+    const auto& decoded = lookup.hashers[i]->decodedVector();
+    switch (lookup.hashers[i]->typeKind()) {
+      case TypeKind::TINYINT:
+        packKeyColumn<int8_t>(decoded, lookup.rows, offset, stride, packedKeys);
+        offset += sizeof(int8_t);
+        break;
+      case TypeKind::SMALLINT:
+        packKeyColumn<int16_t>(
+            decoded, lookup.rows, offset, stride, packedKeys);
+        offset += sizeof(int16_t);
+        break;
+      case TypeKind::INTEGER:
+        packKeyColumn<int32_t>(
+            decoded, lookup.rows, offset, stride, packedKeys);
+        offset += sizeof(int32_t);
+        break;
+      case TypeKind::BIGINT:
+        packKeyColumn<int64_t>(
+            decoded, lookup.rows, offset, stride, packedKeys);
+        offset += sizeof(int64_t);
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+  }
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::serializeProbeKeys(HashLookup& lookup) {
+  if (serializedKeyColumns_.empty()) {
+    lookup.serializedKeys.clear();
+    return;
+  }
+  lookup.serializedKeys.resize(lookup.hashers.size());
+  for (auto i = 0; i < lookup.hashers.size(); ++i) {
+    auto& keys = lookup.serializedKeys[i];
+    keys.data.clear();
+    if (!serializedKeyColumns_[i]) {
+      keys.offsets.clear();
+      continue;
+    }
+    keys.offsets.resize(lookup.hashes.size());
+    keys.sizes.resize(lookup.hashes.size());
+    const auto& decoded = lookup.hashers[i]->decodedVector();
+    for (auto row : lookup.rows) {
+      if (decoded.isNullAt(row)) {
+        keys.sizes[row] = -1;
+        continue;
+      }
+      keys.offsets[row] = keys.data.size();
+      ContainerRowSerde::serialize(
+          *decoded.base(), decoded.index(row), keys.data);
+      keys.sizes[row] = keys.data.size() - keys.offsets[row];
+    }
+  }
+}
+
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::packedKeysEqual(
+    const char* group,
+    const char* key,
+    int32_t size) {
+  constexpr int32_t kBatch = sizeof(TagVector);
+  if (size >= kBatch) {
+    // Compares the first and the last 'kBatch' bytes. These overlap unless
+    // 'size' is 2 * 'kBatch'.
+    const auto first = TagVector::load_unaligned(
+                           reinterpret_cast<const uint8_t*>(group)) ==
+        TagVector::load_unaligned(reinterpret_cast<const uint8_t*>(key));
+    const auto last = TagVector::load_unaligned(
+                          reinterpret_cast<const uint8_t*>(group + size) -
+                          kBatch) ==
+        TagVector::load_unaligned(
+                          reinterpret_cast<const uint8_t*>(key + size) -
+                          kBatch);
+    return simd::toBitMask(first & last) ==
+        simd::allSetBitMask<uint8_t, TagVector::arch_type>();
+  }
+  constexpr int32_t kWord = sizeof(uint64_t);
+  if (size >= kWord) {
+    return folly::loadUnaligned<uint64_t>(group) ==
+        folly::loadUnaligned<uint64_t>(key) &&
+        folly::loadUnaligned<uint64_t>(group + size - kWord) ==
+        folly::loadUnaligned<uint64_t>(key + size - kWord);
+  }
+  return memcmp(group, key, size) == 0;
 }
 
 class ProbeState {
@@ -280,6 +531,13 @@ void HashTable<ignoreNullKeys>::storeKeys(
     HashLookup& lookup,
     vector_size_t row) {
   for (int32_t i = 0; i < hashers_.size(); ++i) {
+    if (!lookup.serializedKeys.empty() &&
+        !lookup.serializedKeys[i].offsets.empty()) {
+      if (auto key = lookup.serializedKeys[i].keyAt(row)) {
+        rows_->storeSerialized(*key, lookup.hits[row], i); // NOLINT
+        continue;
+      }
+    }
     auto& hasher = hashers_[i];
     rows_->store(hasher->decodedVector(), row, lookup.hits[row], i); // NOLINT
   }
@@ -326,11 +584,28 @@ bool HashTable<ignoreNullKeys>::compareKeys(
     const char* group,
     HashLookup& lookup,
     vector_size_t row) {
+  if (lookup.packedKeyWords != 0) {
+    return packedKeysEqual(
+        group,
+        reinterpret_cast<const char*>(
+            lookup.packedKeys.data() + row * lookup.packedKeyWords),
+        packedKeyBytes_);
+  }
   int32_t numKeys = lookup.hashers.size();
   // The loop runs at least once. Allow for first comparison to fail
   // before loop end check.
   int32_t i = 0;
   do {
+    if (!lookup.serializedKeys.empty() &&
+        !lookup.serializedKeys[i].offsets.empty()) {
+      if (!RowContainer::equalsSerialized(
+              group,
+              rows_->columnAt(i),
+              lookup.serializedKeys[i].keyAt(row))) {
+        return false;
+      }
+      continue;
+    }
     auto& hasher = lookup.hashers[i];
     if (!rows_->equals<!ignoreNullKeys>(
             group, rows_->columnAt(i), hasher->decodedVector(), row)) {
@@ -347,6 +622,13 @@ bool HashTable<ignoreNullKeys>::compareKeys(
   auto numKeys = hashers_.size();
   int32_t i = 0;
   do {
+    if (!serializedKeyColumns_.empty() && serializedKeyColumns_[i]) {
+      if (!RowContainer::equalsSerialized(
+              group, inserted, rows_->columnAt(i))) {
+        return false;
+      }
+      continue;
+    }
     if (rows_->compare(group, inserted, i, CompareFlags{true, true})) {
       return false;
     }
@@ -437,6 +719,7 @@ void HashTable<ignoreNullKeys>::groupProbe(HashLookup& lookup) {
     groupNormalizedKeyProbe(lookup);
     return;
   }
+  serializeProbeKeys(lookup);
   ProbeState state1;
   ProbeState state2;
   ProbeState state3;
@@ -444,7 +727,16 @@ void HashTable<ignoreNullKeys>::groupProbe(HashLookup& lookup) {
   int32_t probeIndex = 0;
   int32_t numProbes = lookup.rows.size();
   auto rows = lookup.rows.data();
+  const bool prefetch = shouldPrefetchBuckets();
+  if (prefetch) {
+    prefetchBuckets(
+        lookup.hashes.data(), rows, 0, numProbes, kPrefetchDistance);
+  }
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
+    if (prefetch) {
+      prefetchBuckets(
+          lookup.hashes.data(), rows, probeIndex + kPrefetchDistance, numProbes);
+    }
     int32_t row = rows[probeIndex];
     state1.preProbe(*this, lookup.hashes[row], row);
     row = rows[probeIndex + 1];
@@ -483,7 +775,16 @@ void HashTable<ignoreNullKeys>::groupNormalizedKeyProbe(HashLookup& lookup) {
   auto rows = lookup.rows.data();
   constexpr int32_t kKeyOffset =
       -static_cast<int32_t>(sizeof(normalized_key_t));
+  const bool prefetch = shouldPrefetchBuckets();
+  if (prefetch) {
+    prefetchBuckets(
+        lookup.hashes.data(), rows, 0, numProbes, kPrefetchDistance);
+  }
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
+    if (prefetch) {
+      prefetchBuckets(
+          lookup.hashes.data(), rows, probeIndex + kPrefetchDistance, numProbes);
+    }
     int32_t row = rows[probeIndex];
     state1.preProbe(*this, lookup.hashes[row], row);
     row = rows[probeIndex + 1];
@@ -572,6 +873,8 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
     joinNormalizedKeyProbe(lookup);
     return;
   }
+  packProbeKeys(lookup);
+  serializeProbeKeys(lookup);
   int32_t probeIndex = 0;
   int32_t numProbes = lookup.rows.size();
   const vector_size_t* rows = lookup.rows.data();
@@ -579,7 +882,16 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
   ProbeState state2;
   ProbeState state3;
   ProbeState state4;
+  const bool prefetch = shouldPrefetchBuckets();
+  if (prefetch) {
+    prefetchBuckets(
+        lookup.hashes.data(), rows, 0, numProbes, kPrefetchDistance);
+  }
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
+    if (prefetch) {
+      prefetchBuckets(
+          lookup.hashes.data(), rows, probeIndex + kPrefetchDistance, numProbes);
+    }
     int32_t row = rows[probeIndex];
     state1.preProbe(*this, lookup.hashes[row], row);
     row = rows[probeIndex + 1];
@@ -661,7 +973,14 @@ void HashTable<ignoreNullKeys>::joinNormalizedKeyProbe(HashLookup& lookup) {
   char** hits = lookup.hits.data();
   constexpr int32_t kKeyOffset =
       -static_cast<int32_t>(sizeof(normalized_key_t));
+  const bool prefetch = shouldPrefetchBuckets();
+  if (prefetch) {
+    prefetchBuckets(hashes, rows, 0, numProbes, kPrefetchDistance);
+  }
   for (; probeIndex + 4 <= numProbes; probeIndex += 4) {
+    if (prefetch) {
+      prefetchBuckets(hashes, rows, probeIndex + kPrefetchDistance, numProbes);
+    }
     int32_t row = rows[probeIndex];
     state1.preProbe(*this, hashes[row], row);
     row = rows[probeIndex + 1];
@@ -824,16 +1143,79 @@ bool HashTable<ignoreNullKeys>::canApplyParallelJoinBuild() const {
   if (!isJoinBuild_ || buildExecutor_ == nullptr) {
     return false;
   }
-  if (hashMode_ == HashMode::kArray) {
-    return false;
-  }
   if (otherTables_.empty()) {
     return false;
   }
+  if (hashMode_ == HashMode::kArray) {
+    // The array mode table has one slot per possible key value, so the work is
+    // proportional to the number of rows rather than the table capacity.
+    return (numDistinct_ / (1 + otherTables_.size())) >
+        minTableSizeForParallelJoinBuild_;
+  }
   return (capacity_ / (1 + otherTables_.size())) >
       minTableSizeForParallelJoinBuild_;
 }
 
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::parallelArrayJoinBuild() {
+  TestValue::adjust(
+      "facebook::velox::exec::HashTable::parallelJoinBuild", rows_->pool());
+  VELOX_CHECK_EQ(hashMode_, HashMode::kArray);
+  const int32_t numTables = 1 + otherTables_.size();
+  // Set to false if any of the build steps finds a key not mappable by
+  // 'hashers_'.
+  std::atomic<bool> allMapped{true};
+  std::vector<std::shared_ptr<AsyncSource<bool>>> buildSteps;
+  auto sync = folly::makeGuard([&]() {
+    // This is executed on returning path, possibly in unwinding, so must not
+    // throw.
+    std::exception_ptr error;
+    syncWorkItems(buildSteps, error, true);
+  });
+
+  // Each sub-table is inserted by its own thread. The slots are claimed with
+  // compare-and-swap so no partitioning of the rows is required.
+  for (auto i = 0; i < numTables; ++i) {
+    auto* table = i == 0 ? this : otherTables_[i - 1].get();
+    buildSteps.push_back(
+        std::make_shared<AsyncSource<bool>>([this, table, &allMapped]() {
+          if (!buildArrayJoinPartition(*table)) {
+            allMapped = false;
+          }
+          return std::make_unique<bool>(true);
+        }));
+    VELOX_CHECK(!buildSteps.empty());
+    buildExecutor_->add([step = buildSteps.back()]() { step->prepare(); });
+  }
+  std::exception_ptr error;
+  syncWorkItems(buildSteps, error);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return allMapped;
+}
+
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::buildArrayJoinPartition(
+    HashTable<ignoreNullKeys>& subtable) {
+  constexpr int32_t kBatch = 1024;
+  raw_vector<char*> rows(kBatch);
+  raw_vector<uint64_t> hashes(kBatch);
+  RowContainerIterator iter;
+  while (auto numRows = subtable.rows_->listRows(
+             &iter, kBatch, RowContainer::kUnlimited, rows.data())) {
+    if (!hashRows(folly::Range<char**>(rows.data(), numRows), true, hashes)) {
+      return false;
+    }
+    for (auto i = 0; i < numRows; ++i) {
+      const auto index = hashes[i];
+      VELOX_CHECK_LT(index, capacity_);
+      concurrentArrayPushRow(rows[i], index);
+    }
+  }
+  return true;
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::parallelJoinBuild() {
   TestValue::adjust(
@@ -1083,6 +1465,37 @@ bool HashTable<ignoreNullKeys>::arrayPushRow(char* row, int32_t index) {
   return !existing;
 }
 
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::concurrentArrayPushRow(
+    char* row,
+    int32_t index) {
+  char** slot = &table_[index];
+  char* existing = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+  for (;;) {
+    if (existing != nullptr && nextOffset_ == 0) {
+      // Semijoin or a known unique build side ignores a repeat of a key.
+      return;
+    }
+    if (nextOffset_) {
+      nextRow(row) = existing;
+    }
+    // On failure 'existing' is updated to the current head of the slot and
+    // the insert is retried.
+    if (__atomic_compare_exchange_n(
+            slot,
+            &existing,
+            row,
+            false,
+            __ATOMIC_RELEASE,
+            __ATOMIC_ACQUIRE)) {
+      if (existing != nullptr) {
+        hasDuplicates_ = true;
+      }
+      return;
+    }
+  }
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::pushNext(char* row, char* next) {
   if (nextOffset_) {
@@ -1188,7 +1601,13 @@ void HashTable<ignoreNullKeys>::rehash(bool initNormalizedKeys) {
   ++numRehashes_;
   constexpr int32_t kHashBatchSize = 1024;
   if (canApplyParallelJoinBuild()) {
-    parallelJoinBuild();
+    if (hashMode_ != HashMode::kArray) {
+      parallelJoinBuild();
+      return;
+    }
+    if (!parallelArrayJoinBuild()) {
+      setHashMode(HashMode::kHash, 0);
+    }
     return;
   }
   raw_vector<uint64_t> hashes;
@@ -1898,14 +2317,22 @@ void BaseHashTable::prepareForProbe(
 
   bool rehash = false;
   const auto mode = hashMode();
-  for (auto i = 0; i < hashers.size(); ++i) {
-    auto& hasher = hashers[i];
-    if (mode != BaseHashTable::HashMode::kHash) {
-      if (!hasher->computeValueIds(rows, lookup.hashes)) {
-        rehash = true;
+  const uint64_t* attachedHashes = mode == BaseHashTable::HashMode::kHash
+      ? attachedKeyHashes(*input, hashers)
+      : nullptr;
+  if (attachedHashes != nullptr) {
+    std::copy(
+        attachedHashes, attachedHashes + rows.end(), lookup.hashes.data());
+  } else {
+    for (auto i = 0; i < hashers.size(); ++i) {
+      auto& hasher = hashers[i];
+      if (mode != BaseHashTable::HashMode::kHash) {
+        if (!hasher->computeValueIds(rows, lookup.hashes)) {
+          rehash = true;
+        }
+      } else {
+        hasher->hash(rows, i > 0, lookup.hashes);
       }
-    } else {
-      hasher->hash(rows, i > 0, lookup.hashes);
     }
   }
 
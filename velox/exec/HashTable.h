@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/base/BloomFilter.h"
 #include "velox/common/base/Portability.h"
 #include "velox/common/memory/MemoryAllocator.h"
 #include "velox/exec/Operator.h"
@@ -35,8 +36,28 @@ struct HashLookup {
     hits.resize(size);
     std::fill(hits.begin(), hits.end(), nullptr);
     newGroups.clear();
+    serializedKeys.clear();
   }
 
+  // The complex type values of one key of all input rows, serialized as in
+  // the table rows.
+  struct SerializedKeys {
+    // The serializations back to back.
+    std::string data;
+    // Offset of the serialization of each input row in 'data', 1:1 with
+    // 'hashes'.
+    raw_vector<int32_t> offsets;
+    // Size of the serialization of each input row, -1 for a null key.
+    raw_vector<int32_t> sizes;
+
+    std::optional<std::string_view> keyAt(vector_size_t row) const {
+      if (sizes[row] < 0) {
+        return std::nullopt;
+      }
+      return std::string_view(data.data() + offsets[row], sizes[row]);
+    }
+  };
+
   // One entry per aggregation or join key
   const std::vector<std::unique_ptr<VectorHasher>>& hashers;
   raw_vector<vector_size_t> rows;
@@ -49,6 +70,17 @@ struct HashLookup {
   raw_vector<char*> hits;
   // Indices of newly inserted rows (not found during probe).
   std::vector<vector_size_t> newGroups;
+  // If set by the join probe, the fixed width keys of each input row laid out
+  // as in the table rows, 'packedKeyWords' words per row. 1:1 with 'hashes'.
+  raw_vector<uint64_t> packedKeys;
+  // Number of words per row in 'packedKeys', 0 if 'packedKeys' is not used.
+  int32_t packedKeyWords{0};
+  // If set by the probe, one entry per key. Keys of complex types whose
+  // equality is a memcmp of their serializations have the serialized key of
+  // each input row, so that comparing to a table row does not deserialize the
+  // row and inserting a row does not serialize the key again. Empty for other
+  // keys. See ContainerRowSerde::isBinaryEqualityComparable().
+  std::vector<SerializedKeys> serializedKeys;
 };
 
 struct HashTableStats {
@@ -250,6 +282,23 @@ class BaseHashTable {
   /// Returns a brief description for use in debugging.
   virtual std::string toString() = 0;
 
+  /// Makes a Bloom filter over the values of each integer or string key column
+  /// of a join build side. These are pushed down to the probe side scan when
+  /// the keys do not fit a value filter of 'hashers_'. Makes nothing if the
+  /// table has more than 'maxRows' rows. Must be called after
+  /// prepareJoinTable().
+  void buildKeyBloomFilters(uint64_t maxRows);
+
+  /// Returns the Bloom filter made by buildKeyBloomFilters() for key 'index' or
+  /// nullptr if there is none.
+  std::shared_ptr<const BloomFilter<>> keyBloomFilter(int32_t index) const {
+    return index < keyBloomFilters_.size() ? keyBloomFilters_[index] : nullptr;
+  }
+
+  bool hasKeyBloomFilters() const {
+    return !keyBloomFilters_.empty();
+  }
+
   const std::vector<std::unique_ptr<VectorHasher>>& hashers() const {
     return hashers_;
   }
@@ -302,6 +351,10 @@ class BaseHashTable {
 
   std::vector<std::unique_ptr<VectorHasher>> hashers_;
   std::unique_ptr<RowContainer> rows_;
+
+  // Bloom filters over the key columns of a join build side, 1:1 with
+  // 'hashers_'. Null for keys of unsupported types. Empty if not made.
+  std::vector<std::shared_ptr<const BloomFilter<>>> keyBloomFilters_;
 };
 
 FOLLY_ALWAYS_INLINE std::ostream& operator<<(
@@ -331,12 +384,16 @@ class HashTable : public BaseHashTable {
       bool isJoinBuild,
       bool hasProbedFlag,
       uint32_t minTableSizeForParallelJoinBuild,
-      memory::MemoryPool* pool);
+      memory::MemoryPool* pool,
+      std::shared_ptr<HashStringAllocator> stringAllocator = nullptr);
 
+  /// 'stringAllocator' allows sharing the variable length data arena with
+  /// another table, e.g. the other partitions of a partitioned aggregation.
   static std::unique_ptr<HashTable> createForAggregation(
       std::vector<std::unique_ptr<VectorHasher>>&& hashers,
       const std::vector<Accumulator>& accumulators,
-      memory::MemoryPool* pool) {
+      memory::MemoryPool* pool,
+      std::shared_ptr<HashStringAllocator> stringAllocator = nullptr) {
     return std::make_unique<HashTable>(
         std::move(hashers),
         accumulators,
@@ -345,7 +402,8 @@ class HashTable : public BaseHashTable {
         false, // isJoinBuild
         false, // hasProbedFlag
         0, // minTableSizeForParallelJoinBuild
-        pool);
+        pool,
+        std::move(stringAllocator));
   }
 
   static std::unique_ptr<HashTable> createForJoin(
@@ -507,7 +565,11 @@ class HashTable : public BaseHashTable {
   // 16 slots. Each slot has a 1 byte tag (a field of hash number) and a 48 bit
   // pointer. All the tags are in a 16 byte SIMD word followed by the 6 byte
   // pointers. There are 16 bytes of padding at the end to make the bucket
-  // occupy exactly two (64 bytes) cache lines.
+  // occupy exactly two (64 bytes) cache lines. The pointers are not narrowed
+  // further to offsets since the rows of a RowContainer are spread over many
+  // non-contiguous allocation runs, and a bucket of 16 tags with 32 bit
+  // offsets would still have to be padded to 128 bytes to keep 'sizeMask_'
+  // based bucket addressing.
   class Bucket {
    public:
     Bucket() {
@@ -547,6 +609,14 @@ class HashTable : public BaseHashTable {
 
   static constexpr uint64_t kBucketSize = sizeof(Bucket);
 
+  // Number of probe rows between prefetching a bucket and probing it. This
+  // covers a DRAM miss with 4 rows probed per loop iteration.
+  static constexpr int32_t kPrefetchDistance = 16;
+
+  // Min size of the table for prefetching buckets in probe loops. Below this
+  // the table is expected to be mostly cache resident.
+  static constexpr uint64_t kMinTableBytesForPrefetch = 2UL << 20;
+
   // Returns the bucket at byte offset 'offset' from 'table_'.
   Bucket* bucketAt(int64_t offset) const {
     VELOX_DCHECK_EQ(0, offset & (kBucketSize - 1));
@@ -662,11 +732,25 @@ class HashTable : public BaseHashTable {
   // 1. the hash table is built for parallel join;
   // 2. there is more than one sub-tables;
   // 3. the build executor has been set;
-  // 4. the table is not in kArray mode;
-  // 5. the number of table entries per each parallel build shard is no less
-  //    than a pre-defined threshold: 1000 for now.
+  // 4. the number of table entries per each parallel build shard is no less
+  //    than 'minTableSizeForParallelJoinBuild_'. In kArray mode the number of
+  //    rows per shard is used instead since the table size depends on the key
+  //    ranges and not on the number of rows.
   bool canApplyParallelJoinBuild() const;
 
+  // Builds a kArray mode join table with '1 + otherTables_.size()' independent
+  // threads using 'executor_'. Each thread inserts the rows of one sub-table
+  // with compare-and-swap on the array slots, so unlike parallelJoinBuild()
+  // there is no partitioning step and no sequential overflow pass. Returns
+  // false if some key is not mappable by 'hashers_', in which case the caller
+  // must switch to kHash mode.
+  bool parallelArrayJoinBuild();
+
+  // Inserts all the rows of 'subtable' into the kArray mode table of 'this'.
+  // May run concurrently with other calls for different sub-tables. Returns
+  // false if some key is not mappable by 'hashers_'.
+  bool buildArrayJoinPartition(HashTable<ignoreNullKeys>& subtable);
+
   // Builds a join table with '1 + otherTables_.size()' independent
   // threads using 'executor_'. First all RowContainers get partition
   // numbers assigned to each row. Next, all threads pick all rows
@@ -708,6 +792,26 @@ class HashTable : public BaseHashTable {
 
   bool compareKeys(const char* group, const char* inserted);
 
+  // Returns the byte size of the keys in the table rows if all keys are fixed
+  // width integers that can be compared as one memory range. This is the case
+  // for more than one integer key in a table without null keys. Returns 0
+  // otherwise.
+  int32_t packedKeyBytes() const;
+
+  // Fills 'lookup.packedKeys' with the keys of the rows in 'lookup.rows' from
+  // the decoded vectors of 'lookup.hashers' if 'packedKeyBytes_' is not 0.
+  // Sets 'lookup.packedKeyWords' to 0 otherwise.
+  void packProbeKeys(HashLookup& lookup);
+
+  // Returns true if the first 'size' bytes of 'group' and 'key' are equal.
+  // Uses at most two SIMD compares for up to 32 bytes and does not read past
+  // 'size' bytes.
+  static bool packedKeysEqual(const char* group, const char* key, int32_t size);
+
+  // Fills 'lookup.serializedKeys' for the rows in 'lookup.rows' if some key
+  // is in 'serializedKeyColumns_'. Clears 'lookup.serializedKeys' otherwise.
+  void serializeProbeKeys(HashLookup& lookup);
+
   template <bool isJoin, bool isNormalizedKey = false>
   void fullProbe(HashLookup& lookup, ProbeState& state, bool extraCheck);
 
@@ -725,6 +829,11 @@ class HashTable : public BaseHashTable {
   // existing set of rows with the same key.
   bool arrayPushRow(char* row, int32_t index);
 
+  // Thread-safe version of arrayPushRow() used by parallelArrayJoinBuild().
+  // Duplicate key rows are linked to the head of the slot with a lock-free
+  // push.
+  void concurrentArrayPushRow(char* row, int32_t index);
+
   // Adds a row to a hash join build side entry with multiple rows
   // with the same key.
   void pushNext(char* row, char* next);
@@ -773,6 +882,35 @@ class HashTable : public BaseHashTable {
     return bucketAt(bucketOffset)->pointerAt(slotIndex);
   }
 
+  // Returns true if the table is large enough for the probe loops to benefit
+  // from prefetching buckets ahead of use. Tables that fit in cache only pay
+  // for the extra instructions.
+  bool shouldPrefetchBuckets() const {
+    return table_ != nullptr && sizeMask_ + 1 >= kMinTableBytesForPrefetch;
+  }
+
+  // Prefetches the buckets for 'count' probe rows starting at position 'begin'
+  // of 'rows' into cache. The probe loops process 4 rows at a time and call
+  // this for the rows 'kPrefetchDistance' ahead, so that the cache misses of
+  // these overlap the probes of the current rows. Positions at or past
+  // 'numProbes' are ignored.
+  void prefetchBuckets(
+      const uint64_t* hashes,
+      const vector_size_t* rows,
+      int32_t begin,
+      int32_t numProbes,
+      int32_t count = 4) const {
+    const auto end = std::min(begin + count, numProbes);
+    for (auto i = begin; i < end; ++i) {
+      const auto* bucket = reinterpret_cast<const char*>(
+          bucketAt(bucketOffset(hashes[rows[i]])));
+      // A bucket is two cache lines. The tags are in the first one while the
+      // pointers span both.
+      __builtin_prefetch(bucket);
+      __builtin_prefetch(bucket + kBucketSize / 2);
+    }
+  }
+
   // Returns the tag vector for bucket at 'bucketOffset'.
   TagVector loadTags(int32_t bucketOffset) const {
     return BaseHashTable::loadTags(
@@ -818,6 +956,16 @@ class HashTable : public BaseHashTable {
   // Offset of next row link for join build side, 0 if none. Copied
   // from 'rows_'.
   int32_t nextOffset_;
+
+  // Byte size of the keys at the start of the table rows for comparing these
+  // in one memory compare. 0 if the keys can't be compared this way. See
+  // packedKeyBytes().
+  int32_t packedKeyBytes_{0};
+
+  // True for each key of a complex type that is compared by its
+  // serialization. Empty if there is no such key.
+  std::vector<bool> serializedKeyColumns_;
+
   char** table_ = nullptr;
   memory::ContiguousAllocation tableAllocation_;
 
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/KeyNdvEstimator.h"
+
+#include <folly/hash/Hash.h>
+
+namespace facebook::velox::exec {
+
+KeyNdvEstimator::KeyNdvEstimator(
+    const RowTypePtr& inputType,
+    const std::vector<column_index_t>& keyChannels,
+    memory::MemoryPool* pool)
+    : allocator_(pool) {
+  hlls_.reserve(keyChannels.size());
+  for (auto channel : keyChannels) {
+    names_.push_back(inputType->nameOf(channel));
+    hashers_.push_back(
+        VectorHasher::create(inputType->childAt(channel), channel));
+    hlls_.emplace_back(kIndexBitLength, &allocator_);
+  }
+}
+
+void KeyNdvEstimator::addInput(const RowVector& input) {
+  rows_.resizeFill(input.size());
+  hashes_.resize(input.size());
+  for (auto i = 0; i < hashers_.size(); ++i) {
+    auto& hasher = *hashers_[i];
+    hasher.decode(*input.childAt(hasher.channel())->loadedVector(), rows_);
+    hasher.hash(rows_, false, hashes_);
+    const auto& decoded = hasher.decodedVector();
+    auto& hll = hlls_[i];
+    // The value hashes are not uniform enough for HyperLogLog, e.g. for
+    // small integers, so they are mixed first.
+    if (decoded.mayHaveNulls()) {
+      rows_.applyToSelected([&](auto row) {
+        if (!decoded.isNullAt(row)) {
+          hll.insertHash(folly::hash::twang_mix64(hashes_[row]));
+        }
+      });
+    } else {
+      rows_.applyToSelected([&](auto row) {
+        hll.insertHash(folly::hash::twang_mix64(hashes_[row]));
+      });
+    }
+  }
+}
+
+void KeyNdvEstimator::updateStats(OperatorStats& stats) {
+  for (auto i = 0; i < hlls_.size(); ++i) {
+    std::string sketch(hlls_[i].serializedSize(), '\0');
+    hlls_[i].serialize(sketch.data());
+    auto it = stats.keyNdvSketches.find(names_[i]);
+    if (it == stats.keyNdvSketches.end()) {
+      stats.keyNdvSketches.emplace(names_[i], std::move(sketch));
+    } else {
+      mergeSketch(it->second, sketch);
+    }
+  }
+}
+
+// static
+void KeyNdvEstimator::mergeSketch(
+    std::string& sketch,
+    const std::string& other) {
+  HashStringAllocator allocator(&memory::deprecatedSharedLeafPool());
+  common::hll::DenseHll hll(sketch.data(), &allocator);
+  hll.mergeWith(other.data());
+  sketch.resize(hll.serializedSize());
+  hll.serialize(sketch.data());
+}
+
+// static
+int64_t KeyNdvEstimator::cardinality(const std::string& sketch) {
+  return common::hll::DenseHll::cardinality(sketch.data());
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/common/hyperloglog/DenseHll.h"
+#include "velox/exec/Operator.h"
+#include "velox/exec/VectorHasher.h"
+
+namespace facebook::velox::exec {
+
+/// Estimates the number of distinct values of the key columns of an
+/// operator's input with HyperLogLog sketches. The sketches are added to
+/// OperatorStats::keyNdvSketches under the names of the key columns. They
+/// merge across drivers, tasks and queries, so that a planner can feed them
+/// back into e.g. join ordering or the choice of partial aggregation.
+class KeyNdvEstimator {
+ public:
+  KeyNdvEstimator(
+      const RowTypePtr& inputType,
+      const std::vector<column_index_t>& keyChannels,
+      memory::MemoryPool* pool);
+
+  /// Adds the non-null keys of all rows of 'input'.
+  void addInput(const RowVector& input);
+
+  /// Merges the sketches into 'stats'.
+  void updateStats(OperatorStats& stats);
+
+  /// Merges the serialized sketch 'other' into the serialized sketch
+  /// 'sketch'.
+  static void mergeSketch(std::string& sketch, const std::string& other);
+
+  /// Returns the number of distinct values estimated by a serialized sketch.
+  static int64_t cardinality(const std::string& sketch);
+
+ private:
+  // 2 ^ 11 buckets take 1KB per key and give a standard error of 2.3%.
+  static constexpr int8_t kIndexBitLength = 11;
+
+  HashStringAllocator allocator_;
+  std::vector<std::string> names_;
+  std::vector<std::unique_ptr<VectorHasher>> hashers_;
+  std::vector<common::hll::DenseHll> hlls_;
+  SelectivityVector rows_;
+  raw_vector<uint64_t> hashes_;
+};
+
+} // namespace facebook::velox::exec
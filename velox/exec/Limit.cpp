@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/Limit.h"
+#include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
 Limit::Limit(
@@ -26,9 +27,14 @@ Limit::Limit(
           operatorId,
           limitNode->id(),
           "Limit"),
+      count_{limitNode->count()},
       remainingOffset_{limitNode->offset()},
       remainingLimit_{limitNode->count()} {
   isIdentityProjection_ = true;
+  if (limitNode->isPartial() && limitNode->offset() == 0) {
+    sharedRowCount_ = driverCtx->task->getLimitRowCount(
+        driverCtx->splitGroupId, planNodeId());
+  }
 
   const auto numColumns = limitNode->outputType()->size();
   identityProjections_.reserve(numColumns);
@@ -47,6 +53,14 @@ void Limit::addInput(RowVectorPtr input) {
 }
 
 RowVectorPtr Limit::getOutput() {
+  auto output = getOutputInternal();
+  if (output != nullptr && sharedRowCount_ != nullptr) {
+    *sharedRowCount_ += output->size();
+  }
+  return output;
+}
+
+RowVectorPtr Limit::getOutputInternal() {
   if (input_ == nullptr || (remainingOffset_ == 0 && remainingLimit_ == 0)) {
     return nullptr;
   }
@@ -38,9 +38,28 @@ class Limit : public Operator {
     return finished_ || (noMoreInput_ && input_ == nullptr);
   }
 
+  /// Returns the number of input rows after which 'this' is finished.
+  int64_t remainingInputRows() const {
+    return remainingOffset_ + remainingLimit_;
+  }
+
+  /// Returns true if 'this' is a partial limit and all its drivers together
+  /// have produced as many rows as the final limit needs. The sources of the
+  /// pipeline may then stop reading.
+  bool allDriversDone() const {
+    return sharedRowCount_ != nullptr && *sharedRowCount_ >= count_;
+  }
+
  private:
+  RowVectorPtr getOutputInternal();
+
+  const int32_t count_;
   int32_t remainingOffset_;
   int32_t remainingLimit_;
   bool finished_{false};
+
+  // Rows produced by all drivers of a partial limit without offset. Null
+  // otherwise.
+  std::shared_ptr<std::atomic<int64_t>> sharedRowCount_;
 };
 } // namespace facebook::velox::exec
@@ -15,6 +15,7 @@
  */
 
 #include "velox/exec/LocalPartition.h"
+#include "velox/exec/HashPartitionFunction.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
@@ -29,55 +30,69 @@ void notify(std::vector<ContinuePromise>& promises) {
 bool LocalExchangeMemoryManager::increaseMemoryUsage(
     ContinueFuture* future,
     int64_t added) {
-  std::lock_guard<std::mutex> l(mutex_);
-  bufferedBytes_ += added;
-
-  if (bufferedBytes_ >= maxBufferSize_) {
-    promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
-    *future = promises_.back().getSemiFuture();
-    return true;
+  if (bufferedBytes_.fetch_add(added) + added < maxBufferSize_) {
+    return false;
   }
 
-  return false;
+  std::lock_guard<std::mutex> l(mutex_);
+  // Publish the waiter before checking the usage again. A decrease that
+  // brings the usage below the limit either happened before the check or
+  // sees 'hasWaiters_' and takes the mutex to fulfill the promise.
+  hasWaiters_ = true;
+  if (bufferedBytes_ < maxBufferSize_) {
+    hasWaiters_ = !promises_.empty();
+    return false;
+  }
+  promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
+  *future = promises_.back().getSemiFuture();
+  return true;
 }
 
 std::vector<ContinuePromise> LocalExchangeMemoryManager::decreaseMemoryUsage(
     int64_t removed) {
+  if (bufferedBytes_.fetch_sub(removed) - removed >= maxBufferSize_ ||
+      !hasWaiters_) {
+    return {};
+  }
+
   std::vector<ContinuePromise> promises;
   {
     std::lock_guard<std::mutex> l(mutex_);
-    bufferedBytes_ -= removed;
-
     if (bufferedBytes_ < maxBufferSize_) {
       promises = std::move(promises_);
+      promises_.clear();
+      hasWaiters_ = false;
     }
   }
   return promises;
 }
 
 void LocalExchangeQueue::addProducer() {
-  queue_.withWLock([&](auto& /*queue*/) {
-    VELOX_CHECK(!noMoreProducers_, "addProducer called after noMoreProducers");
-    ++pendingProducers_;
-  });
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!noMoreProducers_, "addProducer called after noMoreProducers");
+  ++pendingProducers_;
 }
 
 void LocalExchangeQueue::noMoreProducers() {
   std::vector<ContinuePromise> consumerPromises;
   std::vector<ContinuePromise> producerPromises;
-  queue_.withWLock([&](auto& queue) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK(!noMoreProducers_, "noMoreProducers can be called only once");
     noMoreProducers_ = true;
     if (pendingProducers_ == 0) {
       // No more data will be produced.
+      noMoreData_ = true;
       consumerPromises = std::move(consumerPromises_);
+      consumerPromises_.clear();
 
-      if (queue.empty()) {
+      if (queue_.empty()) {
         // All data has been consumed.
         producerPromises = std::move(producerPromises_);
+        producerPromises_.clear();
       }
     }
-  });
+  }
   notify(consumerPromises);
   notify(producerPromises);
 }
@@ -85,29 +100,34 @@ void LocalExchangeQueue::noMoreProducers() {
 BlockingReason LocalExchangeQueue::enqueue(
     RowVectorPtr input,
     ContinueFuture* future) {
-  auto inputBytes = input->estimateFlatSize();
-
-  std::vector<ContinuePromise> consumerPromises;
-  bool blockedOnConsumer = false;
-  bool isClosed = queue_.withWLock([&](auto& queue) {
-    if (closed_) {
-      return true;
-    }
-    queue.push(std::move(input));
-    consumerPromises = std::move(consumerPromises_);
-
-    if (memoryManager_->increaseMemoryUsage(future, inputBytes)) {
-      blockedOnConsumer = true;
-    }
+  if (closed_) {
+    return BlockingReason::kNotBlocked;
+  }
 
-    return false;
-  });
+  const int64_t inputBytes = input->estimateFlatSize();
+  queue_.enqueue({std::move(input), inputBytes});
+  const bool blockedOnConsumer =
+      memoryManager_->increaseMemoryUsage(future, inputBytes);
 
-  if (isClosed) {
+  // Pairs with the fence in next(). Either the consumer sees the data or this
+  // sees the waiting consumer.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (closed_) {
+    // close() may have drained the queue before the enqueue.
+    notify(drain());
     return BlockingReason::kNotBlocked;
   }
 
-  notify(consumerPromises);
+  if (hasWaitingConsumers_) {
+    std::vector<ContinuePromise> consumerPromises;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      consumerPromises = std::move(consumerPromises_);
+      consumerPromises_.clear();
+      hasWaitingConsumers_ = false;
+    }
+    notify(consumerPromises);
+  }
 
   if (blockedOnConsumer) {
     return BlockingReason::kWaitForConsumer;
@@ -119,63 +139,103 @@ BlockingReason LocalExchangeQueue::enqueue(
 void LocalExchangeQueue::noMoreData() {
   std::vector<ContinuePromise> consumerPromises;
   std::vector<ContinuePromise> producerPromises;
-  queue_.withWLock([&](auto& queue) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK_GT(pendingProducers_, 0);
     --pendingProducers_;
     if (noMoreProducers_ && pendingProducers_ == 0) {
+      noMoreData_ = true;
       consumerPromises = std::move(consumerPromises_);
-      if (queue.empty()) {
+      consumerPromises_.clear();
+      // Pairs with the fence in checkAllFetched().
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (queue_.empty()) {
         producerPromises = std::move(producerPromises_);
+        producerPromises_.clear();
       }
     }
-  });
+  }
   notify(consumerPromises);
   notify(producerPromises);
 }
 
+bool LocalExchangeQueue::dequeue(
+    RowVectorPtr* data,
+    std::vector<ContinuePromise>& promises) {
+  Entry entry;
+  if (!queue_.try_dequeue(entry)) {
+    return false;
+  }
+  *data = std::move(entry.data);
+  auto memoryPromises = memoryManager_->decreaseMemoryUsage(entry.bytes);
+  for (auto& promise : memoryPromises) {
+    promises.push_back(std::move(promise));
+  }
+  return true;
+}
+
+void LocalExchangeQueue::checkAllFetched() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!noMoreData_ || !queue_.empty()) {
+    return;
+  }
+  std::vector<ContinuePromise> producerPromises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    producerPromises = std::move(producerPromises_);
+    producerPromises_.clear();
+  }
+  notify(producerPromises);
+}
+
+bool LocalExchangeQueue::tryNext(RowVectorPtr* data) {
+  std::vector<ContinuePromise> promises;
+  if (!dequeue(data, promises)) {
+    return false;
+  }
+  notify(promises);
+  checkAllFetched();
+  return true;
+}
+
 BlockingReason LocalExchangeQueue::next(
     ContinueFuture* future,
-    memory::MemoryPool* pool,
+    memory::MemoryPool* /*pool*/,
     RowVectorPtr* data) {
-  std::vector<ContinuePromise> producerPromises;
-  std::vector<ContinuePromise> memoryPromises;
-  auto blockingReason = queue_.withWLock([&](auto& queue) {
-    *data = nullptr;
-    if (queue.empty()) {
-      if (isFinishedLocked(queue)) {
-        return BlockingReason::kNotBlocked;
-      }
+  *data = nullptr;
+  if (tryNext(data)) {
+    return BlockingReason::kNotBlocked;
+  }
+
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (isFinishedLocked()) {
+      return BlockingReason::kNotBlocked;
+    }
 
+    // Publish the waiter before looking at the queue again. Pairs with the
+    // fence in enqueue().
+    hasWaitingConsumers_ = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!dequeue(data, promises)) {
       consumerPromises_.emplace_back("LocalExchangeQueue::next");
       *future = consumerPromises_.back().getSemiFuture();
-
       return BlockingReason::kWaitForProducer;
     }
-
-    *data = queue.front();
-    queue.pop();
-
-    memoryPromises =
-        memoryManager_->decreaseMemoryUsage((*data)->estimateFlatSize());
-
-    if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
-      producerPromises = std::move(producerPromises_);
-    }
-
-    return BlockingReason::kNotBlocked;
-  });
-  notify(memoryPromises);
-  notify(producerPromises);
-  return blockingReason;
+    hasWaitingConsumers_ = !consumerPromises_.empty();
+  }
+  notify(promises);
+  checkAllFetched();
+  return BlockingReason::kNotBlocked;
 }
 
-bool LocalExchangeQueue::isFinishedLocked(
-    const std::queue<RowVectorPtr>& queue) const {
+bool LocalExchangeQueue::isFinishedLocked() const {
   if (closed_) {
     return true;
   }
 
-  if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
+  if (noMoreData_ && queue_.empty()) {
     return true;
   }
 
@@ -183,41 +243,47 @@ bool LocalExchangeQueue::isFinishedLocked(
 }
 
 BlockingReason LocalExchangeQueue::isFinished(ContinueFuture* future) {
-  return queue_.withWLock([&](auto& queue) {
-    if (isFinishedLocked(queue)) {
-      return BlockingReason::kNotBlocked;
-    }
+  std::lock_guard<std::mutex> l(mutex_);
+  if (isFinishedLocked()) {
+    return BlockingReason::kNotBlocked;
+  }
 
-    producerPromises_.emplace_back("LocalExchangeQueue::isFinished");
-    *future = producerPromises_.back().getSemiFuture();
+  producerPromises_.emplace_back("LocalExchangeQueue::isFinished");
+  *future = producerPromises_.back().getSemiFuture();
 
-    return BlockingReason::kWaitForConsumer;
-  });
+  return BlockingReason::kWaitForConsumer;
 }
 
 bool LocalExchangeQueue::isFinished() {
-  return queue_.withWLock([&](auto& queue) { return isFinishedLocked(queue); });
+  std::lock_guard<std::mutex> l(mutex_);
+  return isFinishedLocked();
+}
+
+std::vector<ContinuePromise> LocalExchangeQueue::drain() {
+  uint64_t freedBytes = 0;
+  Entry entry;
+  while (queue_.try_dequeue(entry)) {
+    freedBytes += entry.bytes;
+  }
+  if (freedBytes == 0) {
+    return {};
+  }
+  return memoryManager_->decreaseMemoryUsage(freedBytes);
 }
 
 void LocalExchangeQueue::close() {
   std::vector<ContinuePromise> producerPromises;
   std::vector<ContinuePromise> consumerPromises;
   std::vector<ContinuePromise> memoryPromises;
-  queue_.withWLock([&](auto& queue) {
-    uint64_t freedBytes = 0;
-    while (!queue.empty()) {
-      freedBytes += queue.front()->estimateFlatSize();
-      queue.pop();
-    }
-
-    if (freedBytes) {
-      memoryPromises = memoryManager_->decreaseMemoryUsage(freedBytes);
-    }
-
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    closed_ = true;
+    memoryPromises = drain();
     producerPromises = std::move(producerPromises_);
+    producerPromises_.clear();
     consumerPromises = std::move(consumerPromises_);
-    closed_ = true;
-  });
+    consumerPromises_.clear();
+  }
   notify(producerPromises);
   notify(consumerPromises);
   notify(memoryPromises);
@@ -258,11 +324,45 @@ RowVectorPtr LocalExchange::getOutput() {
   if (blockingReason_ != BlockingReason::kNotBlocked) {
     return nullptr;
   }
-  if (data != nullptr) {
+  if (data == nullptr) {
+    return nullptr;
+  }
+  {
     auto lockedStats = stats_.wlock();
     lockedStats->addInputVector(data->estimateFlatSize(), data->size());
   }
-  return data;
+  return coalesce(std::move(data));
+}
+
+RowVectorPtr LocalExchange::coalesce(RowVectorPtr data) {
+  // Only small vectors are combined so that large ones are not copied.
+  const auto maxRows = outputBatchRows();
+  if (data->size() >= maxRows / 2) {
+    return data;
+  }
+
+  std::vector<RowVectorPtr> batches{std::move(data)};
+  vector_size_t numRows = batches[0]->size();
+  RowVectorPtr next;
+  while (numRows < maxRows && queue_->tryNext(&next)) {
+    {
+      auto lockedStats = stats_.wlock();
+      lockedStats->addInputVector(next->estimateFlatSize(), next->size());
+    }
+    numRows += next->size();
+    batches.push_back(std::move(next));
+  }
+  if (batches.size() == 1) {
+    return std::move(batches[0]);
+  }
+
+  auto result = BaseVector::create<RowVector>(outputType_, numRows, pool());
+  vector_size_t offset = 0;
+  for (const auto& batch : batches) {
+    result->copy(batch.get(), offset, 0, batch->size());
+    offset += batch->size();
+  }
+  return result;
 }
 
 bool LocalExchange::isFinished() {
@@ -288,6 +388,16 @@ LocalPartition::LocalPartition(
               : planNode->partitionFunctionSpec().create(numPartitions_)) {
   VELOX_CHECK(numPartitions_ == 1 || partitionFunction_ != nullptr);
 
+  if (partitionFunction_ != nullptr &&
+      ctx->queryConfig().localExchangeReuseKeyHashes()) {
+    auto* hashFunction =
+        dynamic_cast<HashPartitionFunction*>(partitionFunction_.get());
+    if (hashFunction != nullptr && hashFunction->hasOnlyColumnKeys()) {
+      hashPartitionFunction_ = hashFunction;
+      keyChannels_ = hashFunction->keyChannels();
+    }
+  }
+
   for (auto& queue : queues_) {
     queue->addProducer();
   }
@@ -373,6 +483,13 @@ void LocalPartition::addInput(RowVectorPtr input) {
   std::vector<vector_size_t> maxIndex(numPartitions_, 0);
   for (auto i = 0; i < numInput; ++i) {
     auto partition = partitions_[i];
+    if (FOLLY_UNLIKELY(partition == core::PartitionFunction::kAllPartitions)) {
+      for (auto j = 0; j < numPartitions_; ++j) {
+        rawIndices[j][maxIndex[j]] = i;
+        ++maxIndex[j];
+      }
+      continue;
+    }
     rawIndices[partition][maxIndex[partition]] = i;
     ++maxIndex[partition];
   }
@@ -386,6 +503,9 @@ void LocalPartition::addInput(RowVectorPtr input) {
     indexBuffers[i]->setSize(partitionSize * sizeof(vector_size_t));
     auto partitionData =
         wrapChildren(input_, partitionSize, std::move(indexBuffers[i]));
+    if (hashPartitionFunction_ != nullptr) {
+      attachPartitionHashes(*partitionData, rawIndices[i]);
+    }
 
     ContinueFuture future;
     auto reason = queues_[i]->enqueue(partitionData, &future);
@@ -396,6 +516,19 @@ void LocalPartition::addInput(RowVectorPtr input) {
   }
 }
 
+void LocalPartition::attachPartitionHashes(
+    RowVector& partitionData,
+    const vector_size_t* indices) {
+  const auto& hashes = hashPartitionFunction_->hashes();
+  const auto size = partitionData.size();
+  auto partitionHashes = AlignedBuffer::allocate<uint64_t>(size, pool());
+  auto* rawHashes = partitionHashes->asMutable<uint64_t>();
+  for (auto i = 0; i < size; ++i) {
+    rawHashes[i] = hashes[indices[i]];
+  }
+  attachKeyHashes(partitionData, keyChannels_, std::move(partitionHashes));
+}
+
 BlockingReason LocalPartition::isBlocked(ContinueFuture* future) {
   if (!futures_.empty()) {
     auto blockingReason = blockingReasons_.front();
@@ -15,13 +15,18 @@
  */
 #pragma once
 
+#include <folly/concurrency/UnboundedQueue.h>
+
 #include "velox/exec/Operator.h"
 #include "velox/exec/VectorHasher.h"
 
 namespace facebook::velox::exec {
 
+class HashPartitionFunction;
+
 /// Keeps track of the total size in bytes of the data buffered in all
-/// LocalExchangeQueues.
+/// LocalExchangeQueues. The size is updated without locking. The mutex is
+/// only taken when a producer has to wait or a waiting producer is released.
 class LocalExchangeMemoryManager {
  public:
   explicit LocalExchangeMemoryManager(int64_t maxBufferSize)
@@ -38,8 +43,10 @@ class LocalExchangeMemoryManager {
 
  private:
   const int64_t maxBufferSize_;
+  std::atomic<int64_t> bufferedBytes_{0};
+  // True while a producer is waiting or about to wait on 'promises_'.
+  std::atomic<bool> hasWaiters_{false};
   std::mutex mutex_;
-  int64_t bufferedBytes_{0};
   std::vector<ContinuePromise> promises_;
 };
 
@@ -49,6 +56,10 @@ class LocalExchangeMemoryManager {
 /// must be called after all producers have been registered. A producer calls
 /// 'enqueue' multiple time to put the data and calls 'noMoreData' when done.
 /// Consumers call 'next' repeatedly to fetch the data.
+///
+/// The data is kept in a lock-free queue, so that many producers feeding few
+/// consumers do not contend on a mutex. The mutex only guards the producer
+/// bookkeeping and the promises of waiting producers and consumers.
 class LocalExchangeQueue {
  public:
   LocalExchangeQueue(
@@ -82,6 +93,10 @@ class LocalExchangeQueue {
   BlockingReason
   next(ContinueFuture* future, memory::MemoryPool* pool, RowVectorPtr* data);
 
+  /// Sets 'data' to the next buffered vector and returns true. Returns false
+  /// without waiting if no data is buffered.
+  bool tryNext(RowVectorPtr* data);
+
   /// Used by producers to get notified when all data has been fetched. Returns
   /// kNotBlocked if all data has been fetched. Otherwise, returns
   /// kWaitForConsumer and sets future that will be competed when all data is
@@ -97,22 +112,45 @@ class LocalExchangeQueue {
   void close();
 
  private:
-  bool isFinishedLocked(const std::queue<RowVectorPtr>& queue) const;
+  struct Entry {
+    RowVectorPtr data;
+    // Bytes accounted in 'memoryManager_'.
+    int64_t bytes;
+  };
+
+  bool isFinishedLocked() const;
+
+  // Dequeues the next entry, releasing its memory. Adds the promises of the
+  // producers to wake up to 'promises'.
+  bool dequeue(RowVectorPtr* data, std::vector<ContinuePromise>& promises);
+
+  // Called after a dequeue. Notifies the producers waiting in isFinished()
+  // if all data is fetched.
+  void checkAllFetched();
+
+  // Removes all data. Returns the promises of producers waiting for memory.
+  std::vector<ContinuePromise> drain();
 
   std::shared_ptr<LocalExchangeMemoryManager> memoryManager_;
   const int partition_;
-  folly::Synchronized<std::queue<RowVectorPtr>> queue_;
+  folly::UMPMCQueue<Entry, false> queue_;
+  // Guards the members below that are not atomic.
+  std::mutex mutex_;
   // Satisfied when data becomes available or all producers report that they
   // finished producing, e.g. queue_ is not empty or noMoreProducers_ is true
   // and pendingProducers_ is zero.
   std::vector<ContinuePromise> consumerPromises_;
+  // True while a consumer is waiting or about to wait on 'consumerPromises_'.
+  std::atomic<bool> hasWaitingConsumers_{false};
   // Satisfied when all data has been fetched and no more data will be produced,
   // e.g. queue_ is empty, noMoreProducers_ is true and pendingProducers_ is
   // zero.
   std::vector<ContinuePromise> producerPromises_;
   int pendingProducers_{0};
   bool noMoreProducers_{false};
-  bool closed_{false};
+  // True once noMoreProducers_ is set and pendingProducers_ is zero.
+  std::atomic<bool> noMoreData_{false};
+  std::atomic<bool> closed_{false};
 };
 
 /// Fetches data for a single partition produced by local exchange from
@@ -146,6 +184,11 @@ class LocalExchange : public SourceOperator {
   }
 
  private:
+  // Appends more buffered vectors to 'data' while it has fewer than
+  // outputBatchRows() rows. Returns 'data' if nothing was buffered or a copy
+  // of the vectors in a single vector.
+  RowVectorPtr coalesce(RowVectorPtr data);
+
   const int partition_;
   const std::shared_ptr<LocalExchangeQueue> queue_{nullptr};
   ContinueFuture future_;
@@ -184,10 +227,23 @@ class LocalPartition : public Operator {
   bool isFinished() override;
 
  private:
+  // Attaches the partitioning hashes of the rows of 'input_' at 'indices' to
+  // 'partitionData'. See QueryConfig::kLocalExchangeReuseKeyHashes.
+  void attachPartitionHashes(
+      RowVector& partitionData,
+      const vector_size_t* indices);
+
   const std::vector<std::shared_ptr<LocalExchangeQueue>> queues_;
   const size_t numPartitions_;
   std::unique_ptr<core::PartitionFunction> partitionFunction_;
 
+  // Set to 'partitionFunction_' if it is a HashPartitionFunction over columns
+  // only and the hashes are attached to the output.
+  HashPartitionFunction* hashPartitionFunction_{nullptr};
+
+  // Channels of the partitioning keys if 'hashPartitionFunction_' is set.
+  std::vector<column_index_t> keyChannels_;
+
   std::vector<BlockingReason> blockingReasons_;
   std::vector<ContinueFuture> futures_;
 
@@ -15,6 +15,7 @@
  */
 #include "velox/exec/LocalPlanner.h"
 #include "velox/core/PlanFragment.h"
+#include "velox/exec/Aggregate.h"
 #include "velox/exec/ArrowStream.h"
 #include "velox/exec/AssignUniqueId.h"
 #include "velox/exec/CallbackSink.h"
@@ -131,12 +132,136 @@ OperatorSupplier makeConsumerSupplier(
   return Operator::operatorSupplierFromPlanNode(planNode);
 }
 
+// Returns an equivalent of 'aggregationNode' over a GroupId in which the
+// input of the GroupId is first aggregated by all grouping keys. GroupId then
+// replicates one row per group instead of one row per input row for each
+// grouping set, and 'aggregationNode' becomes the final or intermediate step
+// of the aggregation. Returns nullptr if 'aggregationNode' is not over a
+// GroupId or if some aggregate cannot be split into partial and final steps.
+std::shared_ptr<const core::PlanNode> preAggregateGroupId(
+    const std::shared_ptr<const core::AggregationNode>& aggregationNode) {
+  using Step = core::AggregationNode::Step;
+  auto groupIdNode = std::dynamic_pointer_cast<const core::GroupIdNode>(
+      aggregationNode->sources()[0]);
+  const auto step = aggregationNode->step();
+  if (!groupIdNode || !aggregationNode->preGroupedKeys().empty() ||
+      (step != Step::kSingle && step != Step::kPartial)) {
+    return nullptr;
+  }
+
+  // The pre-aggregation groups by the GroupId inputs of the grouping keys and
+  // names its results like the aggregates. Names must not collide.
+  std::vector<core::FieldAccessTypedExprPtr> keys;
+  std::unordered_set<std::string> names;
+  for (const auto& info : groupIdNode->groupingKeyInfos()) {
+    if (names.insert(info.input->name()).second) {
+      keys.push_back(info.input);
+    }
+    names.insert(info.output);
+  }
+  names.insert(groupIdNode->groupIdName());
+  std::unordered_set<std::string> aggregationInputs;
+  for (const auto& input : groupIdNode->aggregationInputs()) {
+    aggregationInputs.insert(input->name());
+  }
+
+  const auto& aggregates = aggregationNode->aggregates();
+  const auto& aggregateNames = aggregationNode->aggregateNames();
+  std::vector<core::AggregationNode::Aggregate> partialAggregates;
+  std::vector<core::AggregationNode::Aggregate> finalAggregates;
+  std::vector<core::FieldAccessTypedExprPtr> intermediates;
+  for (auto i = 0; i < aggregates.size(); ++i) {
+    const auto& aggregate = aggregates[i];
+    if (aggregate.distinct || aggregate.mask ||
+        !aggregate.sortingKeys.empty() ||
+        !names.insert(aggregateNames[i]).second) {
+      return nullptr;
+    }
+    // Inputs that are grouping keys would be null for some grouping sets.
+    std::vector<TypePtr> argTypes;
+    for (const auto& input : aggregate.call->inputs()) {
+      if (auto field =
+              std::dynamic_pointer_cast<const core::FieldAccessTypedExpr>(
+                  input)) {
+        if (aggregationInputs.count(field->name()) == 0) {
+          return nullptr;
+        }
+      } else if (!std::dynamic_pointer_cast<const core::ConstantTypedExpr>(
+                     input)) {
+        return nullptr;
+      }
+      argTypes.push_back(input->type());
+    }
+    const auto& name = aggregate.call->name();
+    auto intermediateType = Aggregate::intermediateType(name, argTypes);
+
+    core::AggregationNode::Aggregate partialAggregate;
+    partialAggregate.call = std::make_shared<core::CallTypedExpr>(
+        intermediateType, aggregate.call->inputs(), name);
+    partialAggregates.push_back(std::move(partialAggregate));
+
+    auto intermediate = std::make_shared<core::FieldAccessTypedExpr>(
+        intermediateType, aggregateNames[i]);
+    intermediates.push_back(intermediate);
+
+    core::AggregationNode::Aggregate finalAggregate;
+    finalAggregate.call = std::make_shared<core::CallTypedExpr>(
+        aggregate.call->type(),
+        std::vector<core::TypedExprPtr>{intermediate},
+        name);
+    finalAggregates.push_back(std::move(finalAggregate));
+  }
+
+  auto partialAggregation = std::make_shared<core::AggregationNode>(
+      fmt::format("{}.preAggregation", groupIdNode->id()),
+      Step::kPartial,
+      keys,
+      std::vector<core::FieldAccessTypedExprPtr>{},
+      aggregateNames,
+      partialAggregates,
+      false,
+      groupIdNode->sources()[0]);
+  auto groupId = std::make_shared<core::GroupIdNode>(
+      groupIdNode->id(),
+      groupIdNode->groupingSets(),
+      groupIdNode->groupingKeyInfos(),
+      std::move(intermediates),
+      groupIdNode->groupIdName(),
+      std::move(partialAggregation));
+  return std::make_shared<core::AggregationNode>(
+      aggregationNode->id(),
+      step == Step::kSingle ? Step::kFinal : Step::kIntermediate,
+      aggregationNode->groupingKeys(),
+      std::vector<core::FieldAccessTypedExprPtr>{},
+      aggregateNames,
+      finalAggregates,
+      aggregationNode->ignoreNullKeys(),
+      std::move(groupId));
+}
+
 void plan(
     const std::shared_ptr<const core::PlanNode>& planNode,
     std::vector<std::shared_ptr<const core::PlanNode>>* currentPlanNodes,
     const std::shared_ptr<const core::PlanNode>& consumerNode,
     OperatorSupplier consumerSupplier,
+    bool groupIdPreAggregation,
     std::vector<std::unique_ptr<DriverFactory>>* driverFactories) {
+  if (groupIdPreAggregation) {
+    if (auto aggregationNode =
+            std::dynamic_pointer_cast<const core::AggregationNode>(planNode)) {
+      if (auto rewritten = preAggregateGroupId(aggregationNode)) {
+        plan(
+            rewritten,
+            currentPlanNodes,
+            consumerNode,
+            std::move(consumerSupplier),
+            groupIdPreAggregation,
+            driverFactories);
+        return;
+      }
+    }
+  }
+
   if (!currentPlanNodes) {
     driverFactories->push_back(std::make_unique<DriverFactory>());
     currentPlanNodes = &driverFactories->back()->planNodes;
@@ -154,6 +279,7 @@ void plan(
           mustStartNewPipeline(planNode, i) ? nullptr : currentPlanNodes,
           planNode,
           makeConsumerSupplier(planNode),
+          groupIdPreAggregation,
           driverFactories);
     }
   }
@@ -190,9 +316,11 @@ uint32_t maxDrivers(
       if (!values->isParallelizable()) {
         return 1;
       }
-    } else if (std::dynamic_pointer_cast<const core::ArrowStreamNode>(node)) {
-      // ArrowStream node must run single-threaded.
-      return 1;
+    } else if (
+        auto arrowStream =
+            std::dynamic_pointer_cast<const core::ArrowStreamNode>(node)) {
+      // An Arrow stream is read by a single driver.
+      return arrowStream->arrowStreams().size();
     } else if (
         auto limit = std::dynamic_pointer_cast<const core::LimitNode>(node)) {
       // final limit must run single-threaded
@@ -267,6 +395,7 @@ void LocalPlanner::plan(
       nullptr,
       nullptr,
       detail::makeConsumerSupplier(consumerSupplier),
+      queryConfig.groupIdPreAggregation(),
       driverFactories);
 
   (*driverFactories)[0]->outputDriver = true;
@@ -664,6 +793,18 @@ std::vector<core::PlanNodeId> DriverFactory::needsNestedLoopJoinBridges()
   return planNodeIds;
 }
 
+std::vector<core::PlanNodeId> DriverFactory::needsOrderByBridges() const {
+  if (!std::dynamic_pointer_cast<const core::LocalMergeNode>(consumerNode)) {
+    return {};
+  }
+  auto orderBy =
+      std::dynamic_pointer_cast<const core::OrderByNode>(planNodes.back());
+  if (orderBy == nullptr || !orderBy->isPartial()) {
+    return {};
+  }
+  return {orderBy->id()};
+}
+
 // static
 void DriverFactory::registerAdapter(DriverAdapter adapter) {
   adapters.push_back(std::move(adapter));
@@ -16,6 +16,7 @@
 
 #include "velox/exec/Merge.h"
 #include "velox/common/testutil/TestValue.h"
+#include "velox/exec/OrderBy.h"
 #include "velox/exec/Task.h"
 
 using facebook::velox::common::testutil::TestValue;
@@ -59,8 +60,8 @@ void Merge::initializeTreeOfLosers() {
   std::vector<std::unique_ptr<SourceStream>> sourceCursors;
   sourceCursors.reserve(sources_.size());
   for (auto& source : sources_) {
-    sourceCursors.push_back(std::make_unique<SourceStream>(
-        source.get(), sortingKeys_, outputBatchSize_));
+    sourceCursors.push_back(
+        std::make_unique<SourceStream>(source.get(), sortingKeys_));
   }
 
   // Save the pointers to cursors before moving these into the TreeOfLosers.
@@ -131,6 +132,16 @@ RowVectorPtr Merge::getOutput() {
     return data;
   }
 
+  if (!rangesChecked_) {
+    rangesChecked_ = true;
+    if (sourcesAreRanges()) {
+      initializeConcatenation();
+    }
+  }
+  if (!orderedStreams_.empty()) {
+    return concatenateOutput();
+  }
+
   if (!output_) {
     output_ = BaseVector::create<RowVector>(
         outputType_, outputBatchSize_, operatorCtx_->pool());
@@ -140,7 +151,7 @@ RowVectorPtr Merge::getOutput() {
   }
 
   for (;;) {
-    auto stream = treeOfLosers_->next();
+    auto [stream, runnerUp] = treeOfLosers_->nextWithRunnerUp();
 
     if (!stream) {
       finished_ = true;
@@ -154,31 +165,70 @@ RowVectorPtr Merge::getOutput() {
       return std::move(output_);
     }
 
-    if (stream->setOutputRow(outputSize_)) {
-      // The stream is at end of input batch. Need to copy out the rows before
-      // fetching next batch in 'pop'.
-      stream->copyToOutput(output_);
-    }
+    // Take rows from 'stream' while these are not greater than the first row
+    // of 'runnerUp'. The rows go to consecutive output rows and are copied
+    // as one range.
+    do {
+      if (stream->setOutputRow(outputSize_)) {
+        // The stream is at end of input batch. Need to copy out the rows
+        // before fetching next batch in 'pop'.
+        stream->copyToOutput(output_);
+      }
 
-    ++outputSize_;
+      ++outputSize_;
 
-    // Advance the stream.
-    stream->pop(sourceBlockingFutures_);
+      // Advance the stream.
+      stream->pop(sourceBlockingFutures_);
 
-    if (outputSize_ == outputBatchSize_) {
-      // Copy out data from all sources.
-      for (auto& s : streams_) {
-        s->copyToOutput(output_);
+      if (outputSize_ == outputBatchSize_) {
+        // Copy out data from all sources.
+        for (auto& s : streams_) {
+          s->copyToOutput(output_);
+        }
+
+        outputSize_ = 0;
+        return std::move(output_);
       }
 
-      outputSize_ = 0;
-      return std::move(output_);
+      if (!sourceBlockingFutures_.empty()) {
+        return nullptr;
+      }
+    } while (stream->hasData() && !(runnerUp && *runnerUp < *stream));
+  }
+}
+
+void Merge::initializeConcatenation() {
+  for (auto* stream : streams_) {
+    if (stream->hasData()) {
+      orderedStreams_.push_back(stream);
     }
+  }
+  if (orderedStreams_.empty()) {
+    return;
+  }
+  std::sort(
+      orderedStreams_.begin(),
+      orderedStreams_.end(),
+      [](const SourceStream* left, const SourceStream* right) {
+        return *left < *right;
+      });
+  addRuntimeStat(
+      "concatenatedSources", RuntimeCounter(orderedStreams_.size()));
+}
 
-    if (!sourceBlockingFutures_.empty()) {
-      return nullptr;
+RowVectorPtr Merge::concatenateOutput() {
+  while (nextStream_ < orderedStreams_.size()) {
+    auto* stream = orderedStreams_[nextStream_];
+    if (!stream->hasData()) {
+      ++nextStream_;
+      continue;
     }
+    RowVectorPtr data;
+    stream->takeBatch(data, sourceBlockingFutures_);
+    return data;
   }
+  finished_ = true;
+  return nullptr;
 }
 
 void Merge::close() {
@@ -211,36 +261,32 @@ bool SourceStream::pop(std::vector<ContinueFuture>& futures) {
   ++currentSourceRow_;
   if (currentSourceRow_ == data_->size()) {
     // Make sure all current data has been copied out.
-    VELOX_CHECK(!outputRows_.hasSelections());
+    VELOX_CHECK(ranges_.empty());
     return fetchMoreData(futures);
   }
 
   return false;
 }
 
-void SourceStream::copyToOutput(RowVectorPtr& output) {
-  outputRows_.updateBounds();
+bool SourceStream::takeBatch(
+    RowVectorPtr& batch,
+    std::vector<ContinueFuture>& futures) {
+  VELOX_CHECK(!atEnd_);
+  VELOX_CHECK_EQ(currentSourceRow_, 0);
+  batch = std::move(data_);
+  return fetchMoreData(futures);
+}
 
-  if (!outputRows_.hasSelections()) {
+void SourceStream::copyToOutput(RowVectorPtr& output) {
+  if (ranges_.empty()) {
     return;
   }
 
-  vector_size_t sourceRow = firstSourceRow_;
-  outputRows_.applyToSelected(
-      [&](auto row) { sourceRows_[row] = sourceRow++; });
-
   for (auto i = 0; i < output->type()->size(); ++i) {
-    output->childAt(i)->copy(
-        data_->childAt(i).get(), outputRows_, sourceRows_.data());
+    output->childAt(i)->copyRanges(data_->childAt(i).get(), ranges_);
   }
 
-  outputRows_.clearAll();
-
-  if (sourceRow == data_->size()) {
-    firstSourceRow_ = 0;
-  } else {
-    firstSourceRow_ = sourceRow;
-  }
+  ranges_.clear();
 }
 
 bool SourceStream::fetchMoreData(std::vector<ContinueFuture>& futures) {
@@ -284,6 +330,15 @@ LocalMerge::LocalMerge(
       operatorCtx_->driverCtx()->driverId,
       0,
       "LocalMerge needs to run single-threaded");
+  const auto& sourceNodes = localMergeNode->sources();
+  if (sourceNodes.size() != 1) {
+    return;
+  }
+  if (auto orderBy =
+          std::dynamic_pointer_cast<const core::OrderByNode>(sourceNodes[0])) {
+    orderByBridge_ = operatorCtx_->task()->getOrderByBridge(
+        operatorCtx_->driverCtx()->splitGroupId, orderBy->id());
+  }
 }
 
 BlockingReason LocalMerge::addMergeSources(ContinueFuture* /* future */) {
@@ -294,6 +349,10 @@ BlockingReason LocalMerge::addMergeSources(ContinueFuture* /* future */) {
   return BlockingReason::kNotBlocked;
 }
 
+bool LocalMerge::sourcesAreRanges() const {
+  return orderByBridge_ != nullptr && orderByBridge_->rangePartitioned();
+}
+
 MergeExchange::MergeExchange(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -305,7 +364,8 @@ MergeExchange::MergeExchange(
           mergeExchangeNode->sortingKeys(),
           mergeExchangeNode->sortingOrders(),
           mergeExchangeNode->id(),
-          "MergeExchange") {}
+          "MergeExchange"),
+      serdeOptions_(exchangeSerdeOptions(driverCtx->queryConfig())) {}
 
 BlockingReason MergeExchange::addMergeSources(ContinueFuture* future) {
   if (operatorCtx_->driverCtx()->driverId != 0) {
@@ -21,6 +21,7 @@
 
 namespace facebook::velox::exec {
 
+class OrderByBridge;
 class SourceStream;
 
 // Merge operator Implementation: This implementation uses priority queue
@@ -53,11 +54,24 @@ class Merge : public SourceOperator {
  protected:
   virtual BlockingReason addMergeSources(ContinueFuture* future) = 0;
 
+  /// Returns true if the sources produce disjoint key ranges, so that their
+  /// outputs are concatenated in the order of their first rows instead of
+  /// merged. Called once all sources have produced their first batch.
+  virtual bool sourcesAreRanges() const {
+    return false;
+  }
+
   std::vector<std::shared_ptr<MergeSource>> sources_;
 
  private:
   void initializeTreeOfLosers();
 
+  // Orders the streams that have data by their first rows.
+  void initializeConcatenation();
+
+  // Returns the next batch of the streams in 'orderedStreams_'.
+  RowVectorPtr concatenateOutput();
+
   /// Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
@@ -72,6 +86,16 @@ class Merge : public SourceOperator {
 
   RowVectorPtr output_;
 
+  /// True once getOutput() has checked sourcesAreRanges().
+  bool rangesChecked_{false};
+
+  /// The streams with data in the order of their first rows if their batches
+  /// are concatenated instead of merged.
+  std::vector<SourceStream*> orderedStreams_;
+
+  /// Index of the stream in 'orderedStreams_' that is being returned.
+  size_t nextStream_{0};
+
   /// Number of rows accumulated in 'output_' so far.
   vector_size_t outputSize_{0};
 
@@ -86,12 +110,8 @@ class SourceStream final : public MergeStream {
  public:
   SourceStream(
       MergeSource* source,
-      const std::vector<std::pair<column_index_t, CompareFlags>>& sortingKeys,
-      uint32_t outputBatchSize)
-      : source_{source},
-        sortingKeys_{sortingKeys},
-        outputRows_(outputBatchSize, false),
-        sourceRows_(outputBatchSize) {
+      const std::vector<std::pair<column_index_t, CompareFlags>>& sortingKeys)
+      : source_{source}, sortingKeys_{sortingKeys} {
     keyColumns_.reserve(sortingKeys.size());
   }
 
@@ -124,10 +144,21 @@ class SourceStream final : public MergeStream {
   /// call 'setOutputRow' before calling 'pop'. The output rows must
   /// monotonically increase in between calls to 'copyToOutput'.
   bool setOutputRow(vector_size_t row) {
-    outputRows_.setValid(row, true);
+    if (!ranges_.empty() &&
+        ranges_.back().targetIndex + ranges_.back().count == row) {
+      ++ranges_.back().count;
+    } else {
+      ranges_.push_back({currentSourceRow_, row, 1});
+    }
     return currentSourceRow_ == data_->size() - 1;
   }
 
+  /// Moves the current batch to 'batch' and fetches the next one. Returns true
+  /// and appends a future to 'futures' if needs to wait for the source to
+  /// produce the next batch. Used when the sources are concatenated instead
+  /// of merged and no row has been popped.
+  bool takeBatch(RowVectorPtr& batch, std::vector<ContinueFuture>& futures);
+
   /// Called if either current row is the last row in the current batch or the
   /// caller accumulated enough output rows across all sources to produce an
   /// output batch.
@@ -157,14 +188,10 @@ class SourceStream final : public MergeStream {
   /// returned by 'source_->next()'.
   bool needData_{true};
 
-  /// First source row that hasn't been copied out yet.
-  vector_size_t firstSourceRow_{0};
-
-  /// Output row numbers for source rows that haven't been copied out yet.
-  SelectivityVector outputRows_;
-
-  /// Reusable memory.
-  std::vector<vector_size_t> sourceRows_;
+  /// Ranges of consecutive source rows that haven't been copied out yet and
+  /// their positions in the output. Rows taken from this stream in a run
+  /// go to consecutive output rows and extend the last range.
+  std::vector<BaseVector::CopyRange> ranges_;
 };
 
 // LocalMerge merges its source's output into a single stream of
@@ -179,6 +206,13 @@ class LocalMerge : public Merge {
 
  protected:
   BlockingReason addMergeSources(ContinueFuture* future) override;
+
+  bool sourcesAreRanges() const override;
+
+ private:
+  // Set if the source is a partial OrderBy that may divide its rows into key
+  // ranges, one per driver.
+  std::shared_ptr<OrderByBridge> orderByBridge_;
 };
 
 // MergeExchange merges its sources' outputs into a single stream of
@@ -191,10 +225,16 @@ class MergeExchange : public Merge {
       DriverCtx* driverCtx,
       const std::shared_ptr<const core::MergeExchangeNode>& orderByNode);
 
+  const serializer::presto::PrestoVectorSerde::PrestoOptions& serdeOptions()
+      const {
+    return serdeOptions_;
+  }
+
  protected:
   BlockingReason addMergeSources(ContinueFuture* future) override;
 
  private:
+  const serializer::presto::PrestoVectorSerde::PrestoOptions serdeOptions_;
   bool noMoreSplits_ = false;
   size_t numSplits_{0}; // Number of splits we took to process so far.
 };
@@ -30,6 +30,7 @@ MergeJoin::MergeJoin(
           operatorId,
           joinNode->id(),
           "MergeJoin"),
+      useOutputIndices_{joinNode->isInnerJoin() && !joinNode->filter()},
       outputBatchSize_{outputBatchRows()},
       joinType_{joinNode->joinType()},
       numKeys_{joinNode->leftKeys().size()} {
@@ -156,6 +157,60 @@ int32_t MergeJoin::compare(
   return 0;
 }
 
+namespace {
+// Returns the first index in [start, end) for which 'predicate' is false or
+// 'end' if there is none. 'predicate' must be true for a prefix of the range
+// and false for the rest, e.g. a run of equal keys in sorted input. Probes
+// exponentially growing steps from 'start' and then binary searches within
+// the last step, so that skipping a run of n rows takes O(log(n)) calls to
+// 'predicate' instead of n. A run of 1 row takes 2 calls, same as a linear
+// scan.
+template <typename TPredicate>
+vector_size_t gallop(
+    vector_size_t start,
+    vector_size_t end,
+    TPredicate predicate) {
+  if (start >= end || !predicate(start)) {
+    return start;
+  }
+  // 'predicate' is true at 'low' and false at 'high' unless 'high' is 'end'.
+  int64_t low = start;
+  int64_t high;
+  for (int64_t step = 1;; step *= 2) {
+    high = low + step;
+    if (high >= end) {
+      high = end;
+      break;
+    }
+    if (!predicate(high)) {
+      break;
+    }
+    low = high;
+  }
+  while (high - low > 1) {
+    const auto middle = low + (high - low) / 2;
+    if (predicate(middle)) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+  return high;
+}
+
+// Returns true if any of the 'keys' columns of 'input' may have nulls.
+bool mayHaveNullKeys(
+    const RowVectorPtr& input,
+    const std::vector<column_index_t>& keys) {
+  for (auto key : keys) {
+    if (input->childAt(key)->mayHaveNulls()) {
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace
+
 bool MergeJoin::findEndOfMatch(
     Match& match,
     const RowVectorPtr& input,
@@ -169,11 +224,9 @@ bool MergeJoin::findEndOfMatch(
 
   auto numInput = input->size();
 
-  vector_size_t endIndex = 0;
-  while (endIndex < numInput &&
-         compare(keys, input, endIndex, keys, prevInput, prevIndex) == 0) {
-    ++endIndex;
-  }
+  const vector_size_t endIndex = gallop(0, numInput, [&](auto index) {
+    return compare(keys, input, index, keys, prevInput, prevIndex) == 0;
+  });
 
   if (endIndex == numInput) {
     // Inputs are kept past getting a new batch of inputs. LazyVectors
@@ -231,6 +284,12 @@ void MergeJoin::addOutputRow(
     vector_size_t leftIndex,
     const RowVectorPtr& right,
     vector_size_t rightIndex) {
+  if (outputIndices_.has_value()) {
+    outputIndices_->add(left, leftIndex, right, rightIndex, outputSize_);
+    ++outputSize_;
+    return;
+  }
+
   copyRow(left, leftIndex, output_, outputSize_, leftProjections_);
   copyRow(right, rightIndex, output_, outputSize_, rightProjections_);
 
@@ -250,6 +309,14 @@ void MergeJoin::addOutputRow(
 }
 
 void MergeJoin::prepareOutput() {
+  if (useOutputIndices_) {
+    if (!outputIndices_.has_value()) {
+      outputIndices_.emplace(outputBatchSize_, operatorCtx_->pool());
+      outputSize_ = 0;
+    }
+    return;
+  }
+
   if (output_ == nullptr) {
     std::vector<VectorPtr> localColumns(outputType_->size());
     for (auto i = 0; i < outputType_->size(); ++i) {
@@ -299,6 +366,114 @@ void MergeJoin::prepareOutput() {
   }
 }
 
+RowVectorPtr MergeJoin::produceOutput() {
+  if (outputIndices_.has_value()) {
+    auto output = makeOutputFromIndices();
+    outputIndices_.reset();
+    return output;
+  }
+  if (output_ != nullptr && output_->size() != outputSize_) {
+    output_->resize(outputSize_);
+  }
+  return std::move(output_);
+}
+
+namespace {
+// Copies the output rows which come from 'sources' into the 'projections'
+// columns of 'output'. 'rawIndices' gives the source row for each output row.
+// Consecutive rows are copied as one range.
+void copyFromSources(
+    const std::vector<std::pair<vector_size_t, RowVectorPtr>>& sources,
+    const vector_size_t* rawIndices,
+    vector_size_t numRows,
+    const std::vector<IdentityProjection>& projections,
+    const RowVectorPtr& output,
+    std::vector<BaseVector::CopyRange>& ranges) {
+  for (auto i = 0; i < sources.size(); ++i) {
+    const auto begin = sources[i].first;
+    const auto end = i + 1 < sources.size() ? sources[i + 1].first : numRows;
+    ranges.clear();
+    for (auto row = begin; row < end; ++row) {
+      if (!ranges.empty() &&
+          ranges.back().sourceIndex + ranges.back().count == rawIndices[row] &&
+          ranges.back().targetIndex + ranges.back().count == row) {
+        ++ranges.back().count;
+      } else {
+        ranges.push_back({rawIndices[row], row, 1});
+      }
+    }
+    const auto& source = sources[i].second;
+    for (const auto& projection : projections) {
+      output->childAt(projection.outputChannel)
+          ->copyRanges(
+              source->childAt(projection.inputChannel)->loadedVector(),
+              ranges);
+    }
+  }
+}
+} // namespace
+
+RowVectorPtr MergeJoin::makeOutputFromIndices() {
+  VELOX_CHECK(outputIndices_.has_value());
+  auto& indices = outputIndices_.value();
+  if (outputSize_ == 0) {
+    return nullptr;
+  }
+
+  std::vector<VectorPtr> columns(outputType_->size());
+  if (indices.leftSources.size() == 1 && indices.rightSources.size() == 1) {
+    // All rows come from one batch on each side. Wrap the input columns in
+    // dictionaries instead of copying.
+    const auto& left = indices.leftSources[0].second;
+    for (const auto& projection : leftProjections_) {
+      columns[projection.outputChannel] = wrapChild(
+          outputSize_,
+          indices.leftIndices,
+          left->childAt(projection.inputChannel));
+    }
+    const auto& right = indices.rightSources[0].second;
+    for (const auto& projection : rightProjections_) {
+      columns[projection.outputChannel] = wrapChild(
+          outputSize_,
+          indices.rightIndices,
+          right->childAt(projection.inputChannel));
+    }
+    return std::make_shared<RowVector>(
+        operatorCtx_->pool(),
+        outputType_,
+        nullptr,
+        outputSize_,
+        std::move(columns));
+  }
+
+  for (auto i = 0; i < outputType_->size(); ++i) {
+    columns[i] = BaseVector::create(
+        outputType_->childAt(i), outputSize_, operatorCtx_->pool());
+  }
+  auto output = std::make_shared<RowVector>(
+      operatorCtx_->pool(),
+      outputType_,
+      nullptr,
+      outputSize_,
+      std::move(columns));
+  std::vector<BaseVector::CopyRange> ranges;
+  copyFromSources(
+      indices.leftSources,
+      indices.rawLeftIndices,
+      outputSize_,
+      leftProjections_,
+      output,
+      ranges);
+  copyFromSources(
+      indices.rightSources,
+      indices.rawRightIndices,
+      outputSize_,
+      rightProjections_,
+      output,
+      ranges);
+  return output;
+}
+
 bool MergeJoin::addToOutput() {
   prepareOutput();
 
@@ -441,7 +616,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
     // Not all rows from the last match fit in the output. Continue producing
     // results from the current match.
     if (addToOutput()) {
-      return std::move(output_);
+      return produceOutput();
     }
   }
 
@@ -496,7 +671,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
     VELOX_CHECK(rightMatch_ && rightMatch_->complete);
 
     if (addToOutput()) {
-      return std::move(output_);
+      return produceOutput();
     }
   }
 
@@ -506,7 +681,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
         prepareOutput();
         while (true) {
           if (outputSize_ == outputBatchSize_) {
-            return std::move(output_);
+            return produceOutput();
           }
 
           addOutputRowForLeftJoin(input_, index_);
@@ -520,15 +695,13 @@ RowVectorPtr MergeJoin::doGetOutput() {
         }
       }
 
-      if (noMoreInput_ && output_) {
-        output_->resize(outputSize_);
-        return std::move(output_);
+      if (noMoreInput_ && hasOutput()) {
+        return produceOutput();
       }
     } else {
       if (noMoreInput_ || noMoreRightInput_) {
-        if (output_) {
-          output_->resize(outputSize_);
-          return std::move(output_);
+        if (hasOutput()) {
+          return produceOutput();
         }
         input_ = nullptr;
       }
@@ -542,13 +715,33 @@ RowVectorPtr MergeJoin::doGetOutput() {
   auto compareResult = compare();
 
   for (;;) {
-    // Catch up input_ with rightInput_.
+    // Catch up input_ with rightInput_. An inner join skips the left rows
+    // without output by galloping if there are no null keys, which would break
+    // the key order the search relies on.
+    if (compareResult < 0 && !isLeftJoin(joinType_) &&
+        !mayHaveNullKeys(input_, leftKeys_)) {
+      index_ = gallop(index_, input_->size(), [&](auto index) {
+        return compare(
+                   leftKeys_,
+                   input_,
+                   index,
+                   rightKeys_,
+                   rightInput_,
+                   rightIndex_) < 0;
+      });
+      if (index_ == input_->size()) {
+        // Ran out of rows on the left side.
+        input_ = nullptr;
+        return nullptr;
+      }
+      compareResult = compare();
+    }
     while (compareResult < 0) {
       if (isLeftJoin(joinType_)) {
         prepareOutput();
 
         if (outputSize_ == outputBatchSize_) {
-          return std::move(output_);
+          return produceOutput();
         }
 
         addOutputRowForLeftJoin(input_, index_);
@@ -564,6 +757,23 @@ RowVectorPtr MergeJoin::doGetOutput() {
     }
 
     // Catch up rightInput_ with input_.
+    if (compareResult > 0 && !mayHaveNullKeys(rightInput_, rightKeys_)) {
+      rightIndex_ = gallop(rightIndex_, rightInput_->size(), [&](auto index) {
+        return compare(
+                   leftKeys_,
+                   input_,
+                   index_,
+                   rightKeys_,
+                   rightInput_,
+                   index) > 0;
+      });
+      if (rightIndex_ == rightInput_->size()) {
+        // Ran out of rows on the right side.
+        rightInput_ = nullptr;
+        return nullptr;
+      }
+      compareResult = compare();
+    }
     while (compareResult > 0) {
       rightIndex_ = firstNonNull(rightInput_, rightKeys_, rightIndex_ + 1);
       if (rightIndex_ == rightInput_->size()) {
@@ -577,10 +787,10 @@ RowVectorPtr MergeJoin::doGetOutput() {
     if (compareResult == 0) {
       // Found a match. Identify all rows on the left and right that have the
       // matching keys.
-      vector_size_t endIndex = index_ + 1;
-      while (endIndex < input_->size() && compareLeft(endIndex) == 0) {
-        ++endIndex;
-      }
+      const vector_size_t endIndex = gallop(
+          index_ + 1, input_->size(), [&](auto index) {
+            return compareLeft(index) == 0;
+          });
 
       if (endIndex == input_->size()) {
         // Matches continue in subsequent input. Load all lazies.
@@ -589,11 +799,10 @@ RowVectorPtr MergeJoin::doGetOutput() {
       leftMatch_ = Match{
           {input_}, index_, endIndex, endIndex < input_->size(), std::nullopt};
 
-      vector_size_t endRightIndex = rightIndex_ + 1;
-      while (endRightIndex < rightInput_->size() &&
-             compareRight(endRightIndex) == 0) {
-        ++endRightIndex;
-      }
+      const vector_size_t endRightIndex = gallop(
+          rightIndex_ + 1, rightInput_->size(), [&](auto index) {
+            return compareRight(index) == 0;
+          });
 
       rightMatch_ = Match{
           {rightInput_},
@@ -623,7 +832,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
       }
 
       if (addToOutput()) {
-        return std::move(output_);
+        return produceOutput();
       }
 
       if (!rightInput_) {
@@ -148,9 +148,22 @@ class MergeJoin : public Operator {
       const std::vector<column_index_t>& keys);
 
   /// Initialize 'output_' vector using 'ouputType_' and 'outputBatchSize_' if
-  /// it is null.
+  /// it is null. Initializes 'outputIndices_' instead if
+  /// 'useOutputIndices_' is true.
   void prepareOutput();
 
+  /// Returns true if there is an output batch in progress.
+  bool hasOutput() const {
+    return output_ != nullptr || outputIndices_.has_value();
+  }
+
+  /// Returns the first 'outputSize_' rows of the output batch in progress and
+  /// resets the latter.
+  RowVectorPtr produceOutput();
+
+  /// Makes the output batch from 'outputIndices_'.
+  RowVectorPtr makeOutputFromIndices();
+
   // Appends a cartesian product of the current set of matching rows, leftMatch_
   // x rightMatch_, to output_. Returns true if output_ is full. Sets
   // leftMatchCursor_ and rightMatchCursor_ if output_ filled up before all the
@@ -161,12 +174,9 @@ class MergeJoin : public Operator {
   bool addToOutput();
 
   // Adds one row of output by copying values from left and right batches at the
-  // specified rows. Advances outputSize_. Assumes that output_ has room.
-  //
-  // TODO: Copying is inefficient especially for complex type values. Consider
-  // an optimization of using dictionary wrapping when full batch of output can
-  // be produced using single batch of input from the left side and single batch
-  // of input from the right side.
+  // specified rows. Advances outputSize_. Assumes that output_ has room. If
+  // 'useOutputIndices_' is true, records the row in 'outputIndices_' instead
+  // of copying.
   void addOutputRow(
       const RowVectorPtr& left,
       vector_size_t leftIndex,
@@ -335,6 +345,54 @@ class MergeJoin : public Operator {
 
   std::optional<LeftJoinTracker> leftJoinTracker_{std::nullopt};
 
+  /// Accumulates the rows of an output batch as indices into the left and
+  /// right side batches. If all rows come from a single batch on each side, the
+  /// output wraps the columns of these batches in dictionaries. This is the
+  /// common case for 1:N and N:M key matches where the same rows repeat in the
+  /// output. Otherwise, the rows are copied using one copyRanges() call per
+  /// column and input batch.
+  struct OutputIndices {
+    OutputIndices(vector_size_t numRows, memory::MemoryPool* pool)
+        : leftIndices{allocateIndices(numRows, pool)},
+          rightIndices{allocateIndices(numRows, pool)},
+          rawLeftIndices{leftIndices->asMutable<vector_size_t>()},
+          rawRightIndices{rightIndices->asMutable<vector_size_t>()} {}
+
+    /// Records output row 'outputIndex' made of the 'leftIndex' row of 'left'
+    /// and the 'rightIndex' row of 'right'. The rows must be added in order.
+    void add(
+        const RowVectorPtr& left,
+        vector_size_t leftIndex,
+        const RowVectorPtr& right,
+        vector_size_t rightIndex,
+        vector_size_t outputIndex) {
+      if (leftSources.empty() || leftSources.back().second != left) {
+        leftSources.emplace_back(outputIndex, left);
+      }
+      if (rightSources.empty() || rightSources.back().second != right) {
+        rightSources.emplace_back(outputIndex, right);
+      }
+      rawLeftIndices[outputIndex] = leftIndex;
+      rawRightIndices[outputIndex] = rightIndex;
+    }
+
+    BufferPtr leftIndices;
+    BufferPtr rightIndices;
+    vector_size_t* rawLeftIndices;
+    vector_size_t* rawRightIndices;
+
+    /// The batches the output rows come from, each with the first output row
+    /// that comes from it.
+    std::vector<std::pair<vector_size_t, RowVectorPtr>> leftSources;
+    std::vector<std::pair<vector_size_t, RowVectorPtr>> rightSources;
+  };
+
+  /// True if the output rows are recorded in 'outputIndices_' instead of being
+  /// copied into 'output_'. Applies to inner joins without filter.
+  const bool useOutputIndices_;
+
+  std::optional<OutputIndices> outputIndices_;
+
   /// Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
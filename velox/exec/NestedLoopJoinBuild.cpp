@@ -108,7 +108,37 @@ void NestedLoopJoinBuild::noMoreInput() {
   operatorCtx_->task()
       ->getNestedLoopJoinBridge(
           operatorCtx_->driverCtx()->splitGroupId, planNodeId())
-      ->setData(std::move(dataVectors_));
+      ->setData(mergeDataVectors(std::move(dataVectors_)));
+}
+
+std::vector<RowVectorPtr> NestedLoopJoinBuild::mergeDataVectors(
+    std::vector<RowVectorPtr> vectors) const {
+  const auto maxBatchRows = outputBatchRows();
+  std::vector<RowVectorPtr> merged;
+  merged.reserve(vectors.size());
+  for (auto i = 0; i < vectors.size();) {
+    // Finds the run of vectors starting at 'i' that fit in one batch.
+    vector_size_t numRows = vectors[i]->size();
+    auto end = i + 1;
+    while (end < vectors.size() &&
+           numRows + vectors[end]->size() <= maxBatchRows) {
+      numRows += vectors[end++]->size();
+    }
+    if (end == i + 1) {
+      merged.push_back(std::move(vectors[i++]));
+      continue;
+    }
+    auto batch = BaseVector::create<RowVector>(
+        vectors[i]->type(), numRows, operatorCtx_->pool());
+    vector_size_t offset = 0;
+    for (; i < end; ++i) {
+      batch->copy(vectors[i].get(), offset, 0, vectors[i]->size());
+      offset += vectors[i]->size();
+      vectors[i].reset();
+    }
+    merged.push_back(std::move(batch));
+  }
+  return merged;
 }
 
 bool NestedLoopJoinBuild::isFinished() {
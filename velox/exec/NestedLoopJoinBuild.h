@@ -59,6 +59,12 @@ class NestedLoopJoinBuild : public Operator {
   }
 
  private:
+  // Combines runs of build vectors smaller than the output batch size into
+  // vectors of about that size so that the probe evaluates the join
+  // condition over larger batches.
+  std::vector<RowVectorPtr> mergeDataVectors(
+      std::vector<RowVectorPtr> vectors) const;
+
   std::vector<RowVectorPtr> dataVectors_;
 
   // Future for synchronizing with other Drivers of the same pipeline. All build
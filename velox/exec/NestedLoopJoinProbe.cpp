@@ -336,9 +336,9 @@ vector_size_t NestedLoopJoinProbe::getNumProbeRows() const {
   VELOX_CHECK(!hasProbedAllBuildData());
 
   const auto inputSize = input_->size();
-  auto numBuildRows = buildVectors_.value()[buildIndex_]->size();
+  auto numBuildRows = getNumBuildRows();
   vector_size_t numProbeRows;
-  if (numBuildRows > outputBatchSize_) {
+  if (numBuildRows >= outputBatchSize_) {
     numProbeRows = 1;
   } else {
     numProbeRows = std::min(
@@ -347,6 +347,11 @@ vector_size_t NestedLoopJoinProbe::getNumProbeRows() const {
   return numProbeRows;
 }
 
+vector_size_t NestedLoopJoinProbe::getNumBuildRows() const {
+  const auto buildSize = buildVectors_.value()[buildIndex_]->size();
+  return std::min<vector_size_t>(outputBatchSize_, buildSize - buildRow_);
+}
+
 RowVectorPtr NestedLoopJoinProbe::getCrossProduct(
     vector_size_t probeCnt,
     const RowTypePtr& outputType,
@@ -355,9 +360,13 @@ RowVectorPtr NestedLoopJoinProbe::getCrossProduct(
   VELOX_CHECK_GT(probeCnt, 0);
   VELOX_CHECK(!hasProbedAllBuildData());
 
-  const auto buildSize = buildVectors_.value()[buildIndex_]->size();
+  const auto buildSize = getNumBuildRows();
   const auto numOutputRows = probeCnt * buildSize;
-  const bool probeCntChanged = (probeCnt != numPrevProbedRows_);
+  // The build indices are reused while the same rows of the build vector are
+  // matched against consecutive probe rows.
+  const bool isBlocked =
+      buildSize < buildVectors_.value()[buildIndex_]->size();
+  const bool probeCntChanged = (probeCnt != numPrevProbedRows_) || isBlocked;
   numPrevProbedRows_ = probeCnt;
   auto output =
       BaseVector::create<RowVector>(outputType, numOutputRows, pool());
@@ -378,7 +387,7 @@ RowVectorPtr NestedLoopJoinProbe::getCrossProduct(
       std::iota(
           rawBuildIndices_.begin() + i * buildSize,
           rawBuildIndices_.begin() + (i + 1) * buildSize,
-          0);
+          buildRow_);
     }
   }
 
@@ -394,6 +403,11 @@ RowVectorPtr NestedLoopJoinProbe::getCrossProduct(
 }
 
 bool NestedLoopJoinProbe::advanceProbeRows(vector_size_t probeCnt) {
+  buildRow_ += getNumBuildRows();
+  if (buildRow_ < buildVectors_.value()[buildIndex_]->size()) {
+    return false;
+  }
+  buildRow_ = 0;
   probeRow_ += probeCnt;
   if (probeRow_ < input_->size()) {
     return false;
@@ -60,8 +60,15 @@ class NestedLoopJoinProbe : public Operator {
   // given the output batch size limit.
   vector_size_t getNumProbeRows() const;
 
-  // Generates cross product of next 'probeCnt' rows of input_, and all rows of
-  // build side vector at 'buildIndex_' in 'buildData_'.
+  // Returns the number of rows of the build side vector at 'buildIndex_' to
+  // match starting at 'buildRow_'. A build vector larger than the output
+  // batch size is matched a batch size block at a time so that the cross
+  // product stays within the batch size.
+  vector_size_t getNumBuildRows() const;
+
+  // Generates cross product of next 'probeCnt' rows of input_, and the next
+  // getNumBuildRows() rows of build side vector at 'buildIndex_' in
+  // 'buildData_'.
   // 'outputType' specifies the type of output.
   // Projections from input_ and buildData_ to the output are specified by
   // 'probeProjections' and 'buildProjections' respectively. Caller is
@@ -80,8 +87,10 @@ class NestedLoopJoinProbe : public Operator {
   // buildMatched_ accordingly.
   RowVectorPtr doMatch(vector_size_t probeCnt);
 
-  // Updates 'probeRow_' and 'buildIndex_' by advancing 'probeRow_' by probeCnt.
-  // Returns true if 'buildIndex_' points to the end of 'buildData_'.
+  // Updates 'buildRow_', 'probeRow_' and 'buildIndex_' by advancing to the
+  // next block of the build vector or, after its last block, advancing
+  // 'probeRow_' by probeCnt. Returns true if 'buildIndex_' points to the end
+  // of 'buildData_'.
   bool advanceProbeRows(vector_size_t probeCnt);
 
   bool hasProbedAllBuildData() const {
@@ -150,6 +159,10 @@ class NestedLoopJoinProbe : public Operator {
   // Index into buildData_ for the build side vector to process on next call to
   // getOutput().
   size_t buildIndex_{0};
+  // First row of the block of the build vector at 'buildIndex_' to process on
+  // next call to getOutput(). Non-zero only for build vectors larger than
+  // the output batch size.
+  vector_size_t buildRow_{0};
   std::vector<IdentityProjection> buildProjections_;
   BufferPtr buildIndices_;
 
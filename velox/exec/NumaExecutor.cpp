@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/NumaExecutor.h"
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <thread>
+
+#include <folly/String.h>
+#include <folly/executors/thread_factory/InitThreadFactory.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <glog/logging.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::exec {
+namespace {
+void pinCurrentThread(const std::vector<int32_t>& cpus) {
+#ifdef __linux__
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  for (auto cpu : cpus) {
+    CPU_SET(cpu, &cpuSet);
+  }
+  const auto rc =
+      pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+  if (rc != 0) {
+    LOG(WARNING) << "Failed to pin thread to CPUs " << folly::join(",", cpus)
+                 << ": " << folly::errnoStr(rc);
+  }
+#endif
+}
+} // namespace
+
+NumaExecutor::NumaExecutor(
+    std::vector<std::vector<int32_t>> nodeCpus,
+    int32_t numThreadsPerNode)
+    : nodeCpus_(std::move(nodeCpus)) {
+  VELOX_CHECK(!nodeCpus_.empty());
+  VELOX_CHECK_GE(numThreadsPerNode, 0);
+  for (auto node = 0; node < nodeCpus_.size(); ++node) {
+    const auto& cpus = nodeCpus_[node];
+    VELOX_CHECK(!cpus.empty(), "NUMA node {} has no CPUs", node);
+    pools_.push_back(std::make_unique<folly::CPUThreadPoolExecutor>(
+        numThreadsPerNode == 0 ? cpus.size() : numThreadsPerNode,
+        std::make_shared<folly::InitThreadFactory>(
+            std::make_shared<folly::NamedThreadFactory>(
+                fmt::format("numa{}-", node)),
+            [cpus]() { pinCurrentThread(cpus); })));
+  }
+}
+
+// static
+std::unique_ptr<NumaExecutor> NumaExecutor::create(int32_t numThreadsPerNode) {
+  return std::make_unique<NumaExecutor>(numaNodeCpus(), numThreadsPerNode);
+}
+
+NumaExecutor::~NumaExecutor() {
+  join();
+}
+
+void NumaExecutor::add(folly::Func func) {
+  add(nextNode_++ % pools_.size(), std::move(func));
+}
+
+void NumaExecutor::add(int32_t node, folly::Func func) {
+  VELOX_DCHECK_LT(node, pools_.size());
+  pools_[node]->add(std::move(func));
+}
+
+void NumaExecutor::join() {
+  for (auto& pool : pools_) {
+    pool->join();
+  }
+}
+
+// static
+std::vector<std::vector<int32_t>> NumaExecutor::numaNodeCpus() {
+  // Node directories are ordered by node number, which may have gaps.
+  std::map<int32_t, std::vector<int32_t>> nodes;
+  std::error_code ec;
+  for (const auto& entry :
+       std::filesystem::directory_iterator("/sys/devices/system/node", ec)) {
+    const auto name = entry.path().filename().string();
+    if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+        name.find_first_not_of("0123456789", 4) != std::string::npos) {
+      continue;
+    }
+    std::ifstream in(entry.path() / "cpulist");
+    std::string list;
+    if (std::getline(in, list)) {
+      auto cpus = parseCpuList(list);
+      if (!cpus.empty()) {
+        nodes[std::stoi(name.substr(4))] = std::move(cpus);
+      }
+    }
+  }
+
+  std::vector<std::vector<int32_t>> result;
+  for (auto& [node, cpus] : nodes) {
+    result.push_back(std::move(cpus));
+  }
+  if (result.empty()) {
+    std::vector<int32_t> cpus(
+        std::max(1u, std::thread::hardware_concurrency()));
+    for (auto i = 0; i < cpus.size(); ++i) {
+      cpus[i] = i;
+    }
+    result.push_back(std::move(cpus));
+  }
+  return result;
+}
+
+// static
+std::vector<int32_t> NumaExecutor::parseCpuList(std::string_view list) {
+  std::vector<int32_t> cpus;
+  std::vector<folly::StringPiece> ranges;
+  folly::split(
+      ',',
+      folly::trimWhitespace(folly::StringPiece(list.data(), list.size())),
+      ranges,
+      true);
+  for (const auto& range : ranges) {
+    const auto dash = range.find('-');
+    if (dash == folly::StringPiece::npos) {
+      cpus.push_back(folly::to<int32_t>(range));
+      continue;
+    }
+    const auto first = folly::to<int32_t>(range.subpiece(0, dash));
+    const auto last = folly::to<int32_t>(range.subpiece(dash + 1));
+    VELOX_CHECK_LE(first, last, "Bad CPU range: {}", range.str());
+    for (auto cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+} // namespace facebook::velox::exec
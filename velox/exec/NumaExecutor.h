@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include <folly/Executor.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+
+namespace facebook::velox::exec {
+
+/// Executor with a thread pool per NUMA node. The threads of a pool are
+/// pinned to the CPUs of their node. Memory is allocated on the node of the
+/// thread that first touches it, so work that stays on one node mostly uses
+/// local memory. Pass it as the executor of a QueryCtx to have
+/// Driver::enqueue() run each Driver on the node given by its driver id, so
+/// that a Driver and the memory of its operators stay on one node.
+class NumaExecutor : public folly::Executor {
+ public:
+  /// Makes a pool of 'numThreadsPerNode' threads for each element of
+  /// 'nodeCpus', which lists the CPUs of a node. If 'numThreadsPerNode' is 0,
+  /// a pool gets one thread per CPU of its node.
+  explicit NumaExecutor(
+      std::vector<std::vector<int32_t>> nodeCpus,
+      int32_t numThreadsPerNode = 0);
+
+  /// Makes pools for the NUMA nodes of this machine.
+  static std::unique_ptr<NumaExecutor> create(int32_t numThreadsPerNode = 0);
+
+  ~NumaExecutor() override;
+
+  /// Runs 'func' on the nodes in round robin order.
+  void add(folly::Func func) override;
+
+  /// Runs 'func' on a thread of 'node'.
+  void add(int32_t node, folly::Func func);
+
+  int32_t numNodes() const {
+    return pools_.size();
+  }
+
+  const std::vector<int32_t>& cpus(int32_t node) const {
+    return nodeCpus_[node];
+  }
+
+  /// Waits for the queued work to finish and stops the threads.
+  void join();
+
+  /// Returns the CPUs of each NUMA node of this machine. Returns one node with
+  /// all CPUs if the NUMA topology is not known.
+  static std::vector<std::vector<int32_t>> numaNodeCpus();
+
+  /// Parses a Linux CPU list like "0-3,8,10-11".
+  static std::vector<int32_t> parseCpuList(std::string_view list);
+
+ private:
+  const std::vector<std::vector<int32_t>> nodeCpus_;
+  std::vector<std::unique_ptr<folly::CPUThreadPoolExecutor>> pools_;
+  std::atomic<uint32_t> nextNode_{0};
+};
+
+} // namespace facebook::velox::exec
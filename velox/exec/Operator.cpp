@@ -14,10 +14,15 @@
  * limitations under the License.
  */
 #include "velox/exec/Operator.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include "velox/common/base/Counters.h"
+#include "velox/common/base/StatsReporter.h"
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/common/testutil/TestValue.h"
 #include "velox/exec/Driver.h"
 #include "velox/exec/HashJoinBridge.h"
+#include "velox/exec/KeyNdvEstimator.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 #include "velox/expression/Expr.h"
@@ -26,6 +31,17 @@ using facebook::velox::common::testutil::TestValue;
 
 namespace facebook::velox::exec {
 
+namespace {
+// Runs the memory reservations started by Operator::reserveMemoryAsync(). One
+// thread is enough as the memory arbitration requests are serialized by the
+// arbitrator. Never destroyed so that it outlives all the drivers.
+folly::Executor& asyncReservationExecutor() {
+  static auto* executor = new folly::CPUThreadPoolExecutor(
+      1, std::make_shared<folly::NamedThreadFactory>("AsyncMemoryReserve"));
+  return *executor;
+}
+} // namespace
+
 OperatorCtx::OperatorCtx(
     DriverCtx* driverCtx,
     const core::PlanNodeId& planNodeId,
@@ -49,7 +65,8 @@ std::shared_ptr<connector::ConnectorQueryCtx>
 OperatorCtx::createConnectorQueryCtx(
     const std::string& connectorId,
     const std::string& planNodeId,
-    memory::MemoryPool* connectorPool) const {
+    memory::MemoryPool* connectorPool,
+    const SpillConfig* spillConfig) const {
   return std::make_shared<connector::ConnectorQueryCtx>(
       pool_,
       connectorPool,
@@ -60,7 +77,8 @@ OperatorCtx::createConnectorQueryCtx(
       driverCtx_->task->queryCtx()->queryId(),
       taskId(),
       planNodeId,
-      driverCtx_->driverId);
+      driverCtx_->driverId,
+      spillConfig);
 }
 
 Operator::Operator(
@@ -83,6 +101,15 @@ Operator::Operator(
           std::move(planNodeId),
           std::move(operatorType)}) {
   maybeSetReclaimer();
+  if (BaseStatsReporter::registered) {
+    const auto& type = operatorCtx_->operatorType();
+    registerOperatorCounters(type);
+    addInputLatencyKey_ =
+        operatorCounterKey(type, kCounterOperatorAddInputLatencyUs);
+    getOutputLatencyKey_ =
+        operatorCounterKey(type, kCounterOperatorGetOutputLatencyUs);
+    ioWaitKey_ = operatorCounterKey(type, kCounterOperatorIoWaitUs);
+  }
 }
 
 void Operator::maybeSetReclaimer() {
@@ -239,6 +266,10 @@ uint32_t Operator::outputBatchRows(
     std::optional<uint64_t> averageRowSize) const {
   const auto& queryConfig = operatorCtx_->task()->queryCtx()->queryConfig();
 
+  // Set only if adaptive output batch rows are enabled.
+  if (observedOutputRowSize_.has_value()) {
+    averageRowSize = observedOutputRowSize_;
+  }
   if (!averageRowSize.has_value()) {
     return queryConfig.preferredOutputBatchRows();
   }
@@ -259,6 +290,19 @@ uint32_t Operator::outputBatchRows(
       queryConfig.preferredOutputBatchBytes() / rowSize, 1);
 }
 
+void Operator::recordOutputBatchSize(uint64_t bytes, vector_size_t numRows) {
+  if (bytes == 0 || numRows == 0) {
+    // Nothing was loaded.
+    return;
+  }
+  const uint64_t rowSize = std::max<uint64_t>(bytes / numRows, 1);
+  // Weighs the last batch by 1/4 so that a few unusual batches do not swing
+  // the batch size.
+  observedOutputRowSize_ = observedOutputRowSize_.has_value()
+      ? (observedOutputRowSize_.value() * 3 + rowSize) / 4
+      : rowSize;
+}
+
 void Operator::recordBlockingTime(uint64_t start, BlockingReason reason) {
   uint64_t now =
       std::chrono::duration_cast<std::chrono::microseconds>(
@@ -276,6 +320,70 @@ void Operator::recordBlockingTime(uint64_t start, BlockingReason reason) {
       fmt::format("blocked{}Times", blockReason), RuntimeCounter(1));
 }
 
+void Operator::reportAddInputLatency(uint64_t wallNanos) {
+  if (!addInputLatencyKey_.empty()) {
+    REPORT_ADD_HISTOGRAM_VALUE(addInputLatencyKey_, wallNanos / 1'000);
+  }
+}
+
+void Operator::reportGetOutputLatency(uint64_t wallNanos) {
+  if (!getOutputLatencyKey_.empty()) {
+    REPORT_ADD_HISTOGRAM_VALUE(getOutputLatencyKey_, wallNanos / 1'000);
+  }
+}
+
+void Operator::reportIoWait(uint64_t nanos) {
+  if (!ioWaitKey_.empty()) {
+    REPORT_ADD_HISTOGRAM_VALUE(ioWaitKey_, nanos / 1'000);
+  }
+}
+
+bool Operator::preReserveMemory() {
+  const auto& task = operatorCtx_->task();
+  const auto estimate = task->memoryEstimate(planNodeId());
+  if (!estimate.has_value()) {
+    return false;
+  }
+  const uint64_t bytes = estimate.value() /
+      std::max(1, task->numDrivers(operatorCtx_->driver()));
+  if (bytes == 0) {
+    return false;
+  }
+  const bool reserved = pool()->maybeReserve(bytes);
+  addRuntimeStat(
+      reserved ? "preReservedBytes" : "preReserveFailedBytes",
+      RuntimeCounter(bytes, RuntimeCounter::Unit::kBytes));
+  return reserved;
+}
+
+bool Operator::reserveMemoryAsync(uint64_t bytes, ContinueFuture* future) {
+  if (pool()->availableReservation() >= bytes) {
+    return true;
+  }
+  auto [promise, reservationFuture] =
+      makeVeloxContinuePromiseContract("Operator::reserveMemoryAsync");
+  *future = std::move(reservationFuture);
+  // NOTE: the driver is off thread while blocked on 'future', so the memory
+  // arbitration does not need to suspend it and may reclaim from this
+  // operator.
+  asyncReservationExecutor().add(
+      [pool = pool()->shared_from_this(),
+       bytes,
+       promise = std::move(promise)]() mutable {
+        try {
+          pool->maybeReserve(bytes);
+        } catch (const std::exception& e) {
+          // The reservation is retried on the driver thread which surfaces the
+          // error.
+          LOG(WARNING) << "Async memory reservation of "
+                       << succinctBytes(bytes) << " failed for "
+                       << pool->name() << ": " << e.what();
+        }
+        promise.setValue();
+      });
+  return false;
+}
+
 void Operator::recordSpillStats(const SpillStats& spillStats) {
   VELOX_CHECK(noMoreInput_);
   auto lockedStats = stats_.wlock();
@@ -444,6 +552,19 @@ void OperatorStats::add(const OperatorStats& other) {
     }
   }
 
+  for (const auto& [stack, count] : other.profileSamples) {
+    profileSamples[stack] += count;
+  }
+
+  for (const auto& [name, sketch] : other.keyNdvSketches) {
+    auto it = keyNdvSketches.find(name);
+    if (it == keyNdvSketches.end()) {
+      keyNdvSketches.emplace(name, sketch);
+    } else {
+      KeyNdvEstimator::mergeSketch(it->second, sketch);
+    }
+  }
+
   numDrivers += other.numDrivers;
   spilledInputBytes += other.spilledInputBytes;
   spilledBytes += other.spilledBytes;
@@ -474,6 +595,8 @@ void OperatorStats::clear() {
   memoryStats.clear();
 
   runtimeStats.clear();
+  profileSamples.clear();
+  keyNdvSketches.clear();
 
   numDrivers = 0;
   spilledInputBytes = 0;
@@ -45,6 +45,10 @@ struct MemoryStats {
   uint64_t peakSystemMemoryReservation{0};
   uint64_t peakTotalMemoryReservation{0};
   uint64_t numMemoryAllocations{0};
+  /// The memory timeline of the operator pool, see
+  /// MemoryPool::memoryTimeline(). When adding up the stats of several
+  /// operators, this is the timeline of the one with the highest peak.
+  std::vector<memory::MemoryPool::TimelineSample> timeline;
 
   void update(memory::MemoryPool* pool) {
     const memory::MemoryPool::Stats stats = pool->stats();
@@ -54,9 +58,13 @@ struct MemoryStats {
     peakSystemMemoryReservation = 0;
     peakTotalMemoryReservation = stats.peakBytes;
     numMemoryAllocations = stats.numAllocs;
+    timeline = pool->memoryTimeline();
   }
 
   void add(const MemoryStats& other) {
+    if (other.peakTotalMemoryReservation > peakTotalMemoryReservation) {
+      timeline = other.timeline;
+    }
     userMemoryReservation += other.userMemoryReservation;
     revocableMemoryReservation += other.revocableMemoryReservation;
     systemMemoryReservation += other.systemMemoryReservation;
@@ -77,6 +85,7 @@ struct MemoryStats {
     peakSystemMemoryReservation = 0;
     peakTotalMemoryReservation = 0;
     numMemoryAllocations = 0;
+    timeline.clear();
   }
 };
 
@@ -143,6 +152,16 @@ struct OperatorStats {
 
   std::unordered_map<std::string, RuntimeMetric> runtimeStats;
 
+  // Number of DriverProfiler samples taken while the operator was called,
+  // keyed on folded stack of operator type and expressions. Empty unless
+  // QueryConfig::kDriverProfilingEnabled is set.
+  std::unordered_map<std::string, uint64_t> profileSamples;
+
+  // Serialized HyperLogLog sketches of the distinct values of key columns,
+  // keyed on column name. Empty unless QueryConfig::kCollectKeyNdvs is set.
+  // See KeyNdvEstimator.
+  std::unordered_map<std::string, std::string> keyNdvSketches;
+
   int numDrivers = 0;
 
   OperatorStats(
@@ -221,11 +240,13 @@ class OperatorCtx {
   /// Makes an extract of QueryCtx for use in a connector. 'planNodeId'
   /// is the id of the calling TableScan. This and the task id identify the scan
   /// for column access tracking. 'connectorPool' is an aggregate memory pool
-  /// for connector use.
+  /// for connector use. 'spillConfig' is the calling operator's spill config
+  /// if it lets the connector spill, e.g. a sorting table writer.
   std::shared_ptr<connector::ConnectorQueryCtx> createConnectorQueryCtx(
       const std::string& connectorId,
       const std::string& planNodeId,
-      memory::MemoryPool* connectorPool) const;
+      memory::MemoryPool* connectorPool,
+      const SpillConfig* spillConfig = nullptr) const;
 
  private:
   DriverCtx* const driverCtx_;
@@ -441,6 +462,39 @@ class Operator : public BaseRuntimeStatWriter {
 
   void recordBlockingTime(uint64_t start, BlockingReason reason);
 
+  /// Adds the wall time of one addInput() or getOutput() call to the latency
+  /// histograms of the operator type that are exported through the
+  /// StatsReporter. Does nothing if no StatsReporter is registered.
+  void reportAddInputLatency(uint64_t wallNanos);
+
+  void reportGetOutputLatency(uint64_t wallNanos);
+
+  /// Records the size of an output batch of this operator after the next
+  /// operator has processed it, so that the lazy columns the next operator
+  /// needed are loaded. Called by the Driver if
+  /// QueryConfig::kAdaptiveOutputBatchRows is set. outputBatchRows() then
+  /// sizes the next batches by the observed bytes per row.
+  void recordOutputBatchSize(uint64_t bytes, vector_size_t numRows);
+
+  /// Grows the memory reservation of this operator's pool to at least
+  /// 'bytes' without blocking the driver thread. Returns true if the pool
+  /// already has that much available reservation. Otherwise starts the
+  /// reservation on a separate thread, sets 'future' to complete when it is
+  /// done and returns false. The operator is expected to return
+  /// BlockingReason::kWaitForMemory with 'future' from isBlocked(). The
+  /// reservation may fail, so the operator must check the reservation again
+  /// before using it.
+  bool reserveMemoryAsync(uint64_t bytes, ContinueFuture* future);
+
+  /// Reserves this operator's share of the memory estimate of its plan node,
+  /// see Task::setMemoryEstimate(). The estimate is split evenly between the
+  /// drivers of the pipeline. Called on start by operators whose memory
+  /// otherwise grows in many small reservation steps, so that the memory
+  /// arbitration happens once up front. Returns true if the share has been
+  /// reserved, false if there is no estimate or the reservation failed, in
+  /// which case the operator is likely to spill.
+  bool preReserveMemory();
+
   virtual std::string toString() const;
 
   velox::memory::MemoryPool* pool() const {
@@ -553,7 +607,7 @@ class Operator : public BaseRuntimeStatWriter {
     void abort(memory::MemoryPool* pool, const std::exception_ptr& /* error */)
         override;
 
-   private:
+   protected:
     MemoryReclaimer(const std::shared_ptr<Driver>& driver, Operator* op)
         : driver_(driver), op_(op) {
       VELOX_CHECK_NOT_NULL(op_);
@@ -613,13 +667,25 @@ class Operator : public BaseRuntimeStatWriter {
   /// number of rows at 10K and returns at least one row. The averageRowSize
   /// must not be negative. If the averageRowSize is 0 which is not advised,
   /// returns maxOutputBatchRows. If the averageRowSize is not given, returns
-  /// preferredOutputBatchRows.
+  /// preferredOutputBatchRows. If QueryConfig::kAdaptiveOutputBatchRows is
+  /// set and batches have been recorded by recordOutputBatchSize(), the
+  /// observed row size is used instead of averageRowSize.
   uint32_t outputBatchRows(
       std::optional<uint64_t> averageRowSize = std::nullopt) const;
 
+  /// Returns the bytes per row observed by recordOutputBatchSize() or
+  /// std::nullopt if no batch has been recorded.
+  std::optional<uint64_t> observedOutputRowSize() const {
+    return observedOutputRowSize_;
+  }
+
   /// Invoked to record spill stats in operator stats.
   void recordSpillStats(const SpillStats& spillStats);
 
+  /// Adds the I/O wait while reading one split to the histogram of the
+  /// operator type. Does nothing if no StatsReporter is registered.
+  void reportIoWait(uint64_t nanos);
+
   const std::unique_ptr<OperatorCtx> operatorCtx_;
   const RowTypePtr outputType_;
   /// Contains the disk spilling related configs if spilling is enabled (e.g.
@@ -656,6 +722,16 @@ class Operator : public BaseRuntimeStatWriter {
 
   /// The number of times that spilling run on this operator.
   uint32_t numSpillRuns_{0};
+
+  /// Running average of the bytes per row of the output batches recorded by
+  /// recordOutputBatchSize().
+  std::optional<uint64_t> observedOutputRowSize_;
+
+  /// StatsReporter keys of the latency histograms of the operator type. Empty
+  /// if no StatsReporter is registered.
+  std::string addInputLatencyKey_;
+  std::string getOutputLatencyKey_;
+  std::string ioWaitKey_;
 };
 
 /// Given a row type returns indices for the specified subset of columns.
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/OperatorUtils.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/exec/VectorHasher.h"
 #include "velox/expression/EvalCtx.h"
 #include "velox/vector/ConstantVector.h"
@@ -266,6 +267,99 @@ VectorPtr wrapChild(
   return BaseVector::wrapInDictionary(nulls, mapping, size, child);
 }
 
+namespace {
+template <typename T>
+void compactValues(
+    T* values,
+    const uint64_t* selectedBits,
+    vector_size_t size) {
+  using Batch = xsimd::batch<T>;
+  constexpr int32_t kWidth = Batch::size;
+  static_assert(64 % kWidth == 0);
+  vector_size_t numOut = 0;
+  vector_size_t row = 0;
+  // Selected values are never moved to a higher position, so a batch stored
+  // at 'numOut' does not overwrite values that are not yet loaded.
+  for (; row + kWidth <= size; row += kWidth) {
+    const auto mask =
+        (selectedBits[row / 64] >> (row % 64)) & bits::lowMask(kWidth);
+    if (mask == 0) {
+      continue;
+    }
+    if (numOut != row || mask != bits::lowMask(kWidth)) {
+      simd::filter(Batch::load_unaligned(values + row), mask)
+          .store_unaligned(values + numOut);
+    }
+    numOut += __builtin_popcountll(mask);
+  }
+  for (; row < size; ++row) {
+    if (bits::isBitSet(selectedBits, row)) {
+      values[numOut++] = values[row];
+    }
+  }
+}
+
+// Returns the number of nulls after compaction.
+vector_size_t compactNulls(
+    uint64_t* nulls,
+    const uint64_t* selectedBits,
+    vector_size_t size) {
+  vector_size_t numOut = 0;
+  vector_size_t numNulls = 0;
+  bits::forEachSetBit(selectedBits, 0, size, [&](auto row) {
+    const bool isNull = bits::isBitNull(nulls, row);
+    bits::setNull(nulls, numOut++, isNull);
+    numNulls += isNull;
+  });
+  return numNulls;
+}
+
+bool isExclusive(const BufferPtr& buffer) {
+  return buffer && buffer->unique() && buffer->isMutable();
+}
+} // namespace
+
+bool compactFlatVector(
+    VectorPtr& vector,
+    const uint64_t* selectedBits,
+    vector_size_t size,
+    vector_size_t numSelected) {
+  if (!vector || vector.use_count() != 1 || !vector->isFlatEncoding() ||
+      !isExclusive(vector->values())) {
+    return false;
+  }
+  if (vector->mayHaveNulls() && !isExclusive(vector->nulls())) {
+    return false;
+  }
+  // Results evaluated for a subset of rows may end at the last selected row.
+  size = std::min(size, vector->size());
+  switch (vector->typeKind()) {
+    case TypeKind::INTEGER:
+      compactValues(
+          vector->values()->asMutable<int32_t>(), selectedBits, size);
+      break;
+    case TypeKind::BIGINT:
+      compactValues(
+          vector->values()->asMutable<int64_t>(), selectedBits, size);
+      break;
+    case TypeKind::REAL:
+      compactValues(vector->values()->asMutable<float>(), selectedBits, size);
+      break;
+    case TypeKind::DOUBLE:
+      compactValues(
+          vector->values()->asMutable<double>(), selectedBits, size);
+      break;
+    default:
+      return false;
+  }
+  if (vector->mayHaveNulls()) {
+    vector->setNullCount(
+        compactNulls(vector->mutableRawNulls(), selectedBits, size));
+  }
+  vector->resize(numSelected);
+  return true;
+}
+
 RowVectorPtr
 wrap(vector_size_t size, BufferPtr mapping, const RowVectorPtr& vector) {
   if (!mapping) {
@@ -72,6 +72,18 @@ VectorPtr wrapChild(
     const VectorPtr& child,
     BufferPtr nulls = nullptr);
 
+/// Moves the values of 'vector' at the positions set in the first 'size' bits
+/// of 'selectedBits' to the front and resizes 'vector' to 'numSelected'.
+/// Returns false and leaves 'vector' unchanged if 'vector' is not a flat
+/// vector of a 4 or 8 byte fixed width type or if 'vector' or its buffers are
+/// referenced elsewhere. Used to return filtered results as flat vectors
+/// instead of wrapping them in a dictionary.
+bool compactFlatVector(
+    VectorPtr& vector,
+    const uint64_t* FOLLY_NONNULL selectedBits,
+    vector_size_t size,
+    vector_size_t numSelected);
+
 /// Wraps all children of the specified row vector into a dictionary using
 /// specified mapping. Returns vector as-is if mapping is null.
 RowVectorPtr
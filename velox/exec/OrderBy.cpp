@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/OrderBy.h"
+#include <folly/ScopeGuard.h>
 #include "velox/common/testutil/TestValue.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
@@ -49,7 +50,10 @@ OrderBy::OrderBy(
       numSortKeys_(orderByNode->sortingKeys().size()),
       spillMemoryThreshold_(operatorCtx_->driverCtx()
                                 ->queryConfig()
-                                .orderBySpillMemoryThreshold()) {
+                                .orderBySpillMemoryThreshold()),
+      asyncMemoryReservation_(operatorCtx_->driverCtx()
+                                  ->queryConfig()
+                                  .asyncMemoryReservationEnabled()) {
   VELOX_CHECK(pool()->trackUsage());
 
   std::vector<TypePtr> keyTypes;
@@ -91,7 +95,7 @@ OrderBy::OrderBy(
   }
 
   // Create row container.
-  data_ = std::make_unique<RowContainer>(keyTypes, dependentTypes, pool());
+  data_ = std::make_shared<RowContainer>(keyTypes, dependentTypes, pool());
   internalStoreType_ = ROW(std::move(names), std::move(types));
 #ifndef NDEBUG
   for (int i = 0; i < internalStoreType_->children().size(); ++i) {
@@ -104,6 +108,15 @@ OrderBy::OrderBy(
   outputBatchSize_ = outputBatchRows();
 }
 
+void OrderBy::initialize() {
+  Operator::initialize();
+  preReserveMemory();
+  if (operatorCtx_->driverCtx()->queryConfig().parallelOrderByEnabled()) {
+    bridge_ = operatorCtx_->task()->getOrderByBridge(
+        operatorCtx_->driverCtx()->splitGroupId, planNodeId());
+  }
+}
+
 void OrderBy::addInput(RowVectorPtr input) {
   ensureInputFits(input);
 
@@ -125,6 +138,43 @@ void OrderBy::addInput(RowVectorPtr input) {
   }
 
   numRows_ += allRows.size();
+  if (asyncMemoryReservation_) {
+    prepareReservationForNextInput(input);
+  }
+}
+
+BlockingReason OrderBy::isBlocked(ContinueFuture* future) {
+  if (peersFuture_.valid()) {
+    *future = std::move(peersFuture_);
+    return BlockingReason::kWaitForOrderByPeers;
+  }
+  if (nextInputReservationBytes_ == 0 || noMoreInput_) {
+    return BlockingReason::kNotBlocked;
+  }
+  const auto bytes = std::exchange(nextInputReservationBytes_, 0);
+  if (reserveMemoryAsync(bytes, future)) {
+    return BlockingReason::kNotBlocked;
+  }
+  return BlockingReason::kWaitForMemory;
+}
+
+void OrderBy::prepareReservationForNextInput(const RowVectorPtr& input) {
+  if (!spillConfig_.has_value() || data_->numRows() == 0) {
+    return;
+  }
+  // Mirrors the reservation growth in ensureInputFits() assuming the next
+  // input is like 'input'.
+  const auto outOfLineBytes = data_->stringAllocator().retainedSize() -
+      data_->freeSpace().second;
+  const int64_t incrementBytes = data_->sizeIncrement(
+      input->size(), outOfLineBytes ? input->estimateFlatSize() : 0);
+  if (pool()->availableReservation() > 2 * incrementBytes) {
+    return;
+  }
+  nextInputReservationBytes_ = std::max<int64_t>(
+      incrementBytes * 2,
+      pool()->currentBytes() * spillConfig_->spillableReservationGrowthPct /
+          100);
 }
 
 void OrderBy::ensureInputFits(const RowVectorPtr& input) {
@@ -222,8 +272,25 @@ void OrderBy::reclaim(uint64_t targetBytes) {
     return;
   }
 
-  // TODO: support fine-grain disk spilling based on 'targetBytes' after having
-  // row container memory compaction support later.
+  // Compacting the out-of-line data first may free enough memory to avoid the
+  // spill. The copy is limited to the unused reservation so that it does not
+  // need to grow the pool under arbitration.
+  if (data_->stringAllocator().fragmentation() >=
+      kMinCompactionFragmentation) {
+    const auto compactedBytes =
+        data_->compactStringAllocator(pool()->availableReservation());
+    if (compactedBytes > 0) {
+      addRuntimeStat(
+          "compactedStringBytes",
+          RuntimeCounter(compactedBytes, RuntimeCounter::Unit::kBytes));
+      if (compactedBytes >= targetBytes) {
+        pool()->release();
+        return;
+      }
+    }
+  }
+
+  // TODO: support fine-grain disk spilling based on 'targetBytes'.
   spill(0, targetBytes);
   VELOX_CHECK_EQ(data_->numRows(), 0);
   data_->clear();
@@ -250,7 +317,9 @@ void OrderBy::spill(int64_t targetRows, int64_t targetBytes) {
         spillConfig.minSpillRunSize,
         spillConfig.compressionKind,
         Spiller::pool(),
-        spillConfig.executor);
+        spillConfig.executor,
+        spillConfig.format,
+        spillConfig.directories);
     VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
   }
   spiller_->spill(targetRows, targetBytes);
@@ -259,32 +328,20 @@ void OrderBy::spill(int64_t targetRows, int64_t targetBytes) {
 void OrderBy::noMoreInput() {
   Operator::noMoreInput();
 
-  // No data.
+  // No data. With 'bridge_' the peers still wait for this to divide their
+  // rows into ranges, one of which this returns.
   if (numRows_ == 0) {
-    finished_ = true;
+    finished_ = bridge_ == nullptr;
     return;
   }
 
   if (spiller_ == nullptr) {
     VELOX_CHECK_EQ(numRows_, data_->numRows());
     // Sort the pointers to the rows in RowContainer (data_) instead of sorting
-    // the rows.
+    // the rows. The sort is done by sortStep() from getOutput().
     returningRows_.resize(numRows_);
     RowContainerIterator iter;
     data_->listRows(&iter, numRows_, returningRows_.data());
-    std::sort(
-        returningRows_.begin(),
-        returningRows_.end(),
-        [this](const char* leftRow, const char* rightRow) {
-          for (vector_size_t index = 0; index < numSortKeys_; ++index) {
-            if (auto result = data_->compare(
-                    leftRow, rightRow, index, keyCompareFlags_[index])) {
-              return result < 0;
-            }
-          }
-          return false;
-        });
-
   } else {
     // Finish spill, and we shouldn't get any rows from non-spilled partition as
     // there is only one hash partition for orderBy operator.
@@ -306,8 +363,224 @@ void OrderBy::recordSpillStats() {
   Operator::recordSpillStats(spillStats);
 }
 
+bool OrderBy::lessThan(const char* left, const char* right) const {
+  for (vector_size_t index = 0; index < numSortKeys_; ++index) {
+    if (auto result =
+            data_->compare(left, right, index, keyCompareFlags_[index])) {
+      return result < 0;
+    }
+  }
+  return false;
+}
+
+bool OrderBy::sortStep() {
+  size_t budget = kSortStepRows;
+  const auto numRows = returningRows_.size();
+  auto less = [this](const char* left, const char* right) {
+    return lessThan(left, right);
+  };
+  while (sortedRunsEnd_ < numRows) {
+    const auto end = std::min(sortedRunsEnd_ + kSortRunRows, numRows);
+    std::sort(
+        returningRows_.begin() + sortedRunsEnd_,
+        returningRows_.begin() + end,
+        less);
+    budget -= std::min(budget, end - sortedRunsEnd_);
+    sortedRunsEnd_ = end;
+    if (budget == 0) {
+      return false;
+    }
+  }
+
+  while (mergeWidth_ < numRows) {
+    if (mergeBuffer_.empty()) {
+      mergeBuffer_.resize(numRows);
+      mergeRight_ = std::min(mergeWidth_, numRows);
+    }
+    // Merges the runs starting at 'mergeOut_' and at 'mergeRight_'.
+    const auto runStart = mergeOut_ - mergeOut_ % (2 * mergeWidth_);
+    const auto mid = std::min(runStart + mergeWidth_, numRows);
+    const auto end = std::min(runStart + 2 * mergeWidth_, numRows);
+    while (mergeOut_ < end && budget > 0) {
+      if (mergeRight_ >= end ||
+          (mergeLeft_ < mid &&
+           !lessThan(
+               returningRows_[mergeRight_], returningRows_[mergeLeft_]))) {
+        mergeBuffer_[mergeOut_++] = returningRows_[mergeLeft_++];
+      } else {
+        mergeBuffer_[mergeOut_++] = returningRows_[mergeRight_++];
+      }
+      --budget;
+    }
+    if (mergeOut_ == end) {
+      if (end == numRows) {
+        // The pass is done. The next one merges runs of twice the width.
+        std::swap(returningRows_, mergeBuffer_);
+        mergeWidth_ *= 2;
+        mergeOut_ = 0;
+      }
+      mergeLeft_ = mergeOut_;
+      mergeRight_ = std::min(mergeOut_ + mergeWidth_, numRows);
+    }
+    if (budget == 0 && mergeWidth_ < numRows) {
+      return false;
+    }
+  }
+  mergeBuffer_.clear();
+  mergeBuffer_.shrink_to_fit();
+  return true;
+}
+
+bool OrderBy::finishPeers() {
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(),
+          operatorCtx_->driver(),
+          &peersFuture_,
+          promises,
+          peers)) {
+    return false;
+  }
+
+  auto promisesGuard = folly::makeGuard([&]() {
+    // Continues the peers once the rows are divided.
+    peers.clear();
+    for (auto& promise : promises) {
+      promise.setValue();
+    }
+  });
+
+  std::vector<OrderBy*> orderBys{this};
+  bool spilled = spiller_ != nullptr;
+  for (auto& peer : peers) {
+    auto* orderBy = dynamic_cast<OrderBy*>(peer->findOperator(planNodeId()));
+    VELOX_CHECK_NOT_NULL(orderBy);
+    spilled |= orderBy->spiller_ != nullptr;
+    orderBys.push_back(orderBy);
+  }
+  // The drivers that spilled merge their rows from disk, so all drivers
+  // return their own rows and the LocalMerge merges them.
+  if (!spilled && orderBys.size() > 1) {
+    partitionRanges(orderBys);
+  }
+  return true;
+}
+
+void OrderBy::partitionRanges(const std::vector<OrderBy*>& orderBys) {
+  const auto numRanges = orderBys.size();
+  auto less = [this](const char* left, const char* right) {
+    return lessThan(left, right);
+  };
+  // Takes 'numRanges' evenly spaced rows of each driver and picks the
+  // splitters evenly spaced from the sorted samples. The containers of all
+  // drivers have the same layout, so that any of them compares and extracts
+  // the rows of the others.
+  std::vector<char*> samples;
+  samples.reserve(numRanges * numRanges);
+  for (const auto* orderBy : orderBys) {
+    const auto& rows = orderBy->returningRows_;
+    if (rows.empty()) {
+      continue;
+    }
+    for (auto i = 0; i < numRanges; ++i) {
+      samples.push_back(rows[i * rows.size() / numRanges]);
+    }
+  }
+  if (samples.empty()) {
+    return;
+  }
+  std::sort(samples.begin(), samples.end(), less);
+  std::vector<char*> splitters;
+  splitters.reserve(numRanges - 1);
+  for (auto i = 1; i < numRanges; ++i) {
+    splitters.push_back(samples[i * samples.size() / numRanges]);
+  }
+
+  // Range 'i' has the rows that are not less than splitter 'i' - 1 and less
+  // than splitter 'i'. Each driver contributes one sorted part to each range.
+  std::vector<std::vector<char*>> ranges(numRanges);
+  std::vector<std::vector<size_t>> partEnds(numRanges);
+  std::vector<std::shared_ptr<RowContainer>> containers;
+  containers.reserve(numRanges);
+  for (const auto* orderBy : orderBys) {
+    const auto& rows = orderBy->returningRows_;
+    auto begin = rows.begin();
+    for (auto i = 0; i < numRanges; ++i) {
+      const auto end = i < splitters.size()
+          ? std::lower_bound(begin, rows.end(), splitters[i], less)
+          : rows.end();
+      if (end != begin) {
+        ranges[i].insert(ranges[i].end(), begin, end);
+        partEnds[i].push_back(ranges[i].size());
+      }
+      begin = end;
+    }
+    containers.push_back(orderBy->data_);
+  }
+
+  for (auto i = 0; i < numRanges; ++i) {
+    auto* orderBy = orderBys[i];
+    orderBy->returningRows_ = std::move(ranges[i]);
+    orderBy->partEnds_ = std::move(partEnds[i]);
+    orderBy->numRows_ = orderBy->returningRows_.size();
+    orderBy->rangeData_ = containers;
+  }
+  bridge_->setRangePartitioned();
+}
+
+void OrderBy::mergePartsStep() {
+  auto less = [this](const char* left, const char* right) {
+    return lessThan(left, right);
+  };
+  mergeBuffer_.resize(returningRows_.size());
+  std::vector<size_t> mergedEnds;
+  mergedEnds.reserve((partEnds_.size() + 1) / 2);
+  size_t begin = 0;
+  for (auto i = 0; i < partEnds_.size(); i += 2) {
+    const auto mid = partEnds_[i];
+    const auto end = i + 1 < partEnds_.size() ? partEnds_[i + 1] : mid;
+    std::merge(
+        returningRows_.begin() + begin,
+        returningRows_.begin() + mid,
+        returningRows_.begin() + mid,
+        returningRows_.begin() + end,
+        mergeBuffer_.begin() + begin,
+        less);
+    mergedEnds.push_back(end);
+    begin = end;
+  }
+  std::swap(returningRows_, mergeBuffer_);
+  partEnds_ = std::move(mergedEnds);
+  if (partEnds_.size() == 1) {
+    mergeBuffer_.clear();
+    mergeBuffer_.shrink_to_fit();
+  }
+}
+
 RowVectorPtr OrderBy::getOutput() {
-  if (finished_ || !noMoreInput_ || numRows_ == numRowsReturned_) {
+  if (finished_ || !noMoreInput_) {
+    return nullptr;
+  }
+  if (spiller_ == nullptr && !sorted_) {
+    // Returns to the Driver between steps so that it can pause or yield.
+    sorted_ = sortStep();
+    if (!sorted_) {
+      return nullptr;
+    }
+  }
+  if (bridge_ != nullptr && !joinedPeers_) {
+    joinedPeers_ = true;
+    if (!finishPeers()) {
+      return nullptr;
+    }
+  }
+  if (partEnds_.size() > 1) {
+    mergePartsStep();
+    return nullptr;
+  }
+  if (numRows_ == numRowsReturned_) {
+    finished_ = true;
     return nullptr;
   }
   prepareOutput();
@@ -415,5 +688,6 @@ void OrderBy::abort() {
   output_ = nullptr;
   spiller_.reset();
   data_.reset();
+  rangeData_.clear();
 }
 } // namespace facebook::velox::exec
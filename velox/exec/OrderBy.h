@@ -16,18 +16,43 @@
 #pragma once
 
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/exec/JoinBridge.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
 #include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
+/// Connects the drivers of a partial OrderBy with the LocalMerge that
+/// consumes their output. Tells the LocalMerge that the drivers return
+/// disjoint key ranges, so that their outputs are concatenated in order
+/// instead of merged.
+class OrderByBridge : public JoinBridge {
+ public:
+  void setRangePartitioned() {
+    rangePartitioned_ = true;
+  }
+
+  bool rangePartitioned() const {
+    return rangePartitioned_;
+  }
+
+ private:
+  std::atomic<bool> rangePartitioned_{false};
+};
+
 /// OrderBy operator implementation: OrderBy stores all its inputs in a
 /// RowContainer as the inputs are added. Until all inputs are available,
 /// it blocks the pipeline. Once all inputs are available, it sorts pointers
 /// to the rows using the RowContainer's compare() function. And finally it
 /// constructs and returns the sorted output RowVector using the data in the
-/// RowContainer.
+/// RowContainer. The sort is done in bounded steps over several getOutput()
+/// calls, so that the Driver can pause or yield between the steps.
+/// If 'parallel_order_by_enabled' is set and the OrderBy is partial and feeds
+/// a LocalMerge, the drivers wait for each other after sorting. The last one
+/// samples the sorted rows of all drivers and divides them into one key range
+/// per driver. Each driver then merges the parts of its range from all
+/// drivers and returns them.
 /// Limitations:
 /// * It memcopies twice: 1) input to RowContainer and 2) RowContainer to
 /// output.
@@ -42,15 +67,15 @@ class OrderBy : public Operator {
     return !finished_;
   }
 
+  void initialize() override;
+
   void addInput(RowVectorPtr input) override;
 
   void noMoreInput() override;
 
   RowVectorPtr getOutput() override;
 
-  BlockingReason isBlocked(ContinueFuture* FOLLY_NULLABLE /*future*/) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* FOLLY_NULLABLE future) override;
 
   bool isFinished() override {
     return finished_;
@@ -61,11 +86,48 @@ class OrderBy : public Operator {
   void abort() override;
 
  private:
+  // The min fraction of the string allocator memory on its free lists for
+  // reclaim() to try compaction before spilling.
+  static constexpr double kMinCompactionFragmentation = 0.5;
+
+  // Size of the runs that are sorted whole before merging.
+  static constexpr size_t kSortRunRows = 16 << 10;
+
+  // Number of rows sorted or merged in one sortStep(). Takes a few ms.
+  static constexpr size_t kSortStepRows = 64 << 10;
+
+  // Returns true if 'left' sorts before 'right'.
+  bool lessThan(const char* left, const char* right) const;
+
+  // Continues sorting 'returningRows_' for about 'kSortStepRows' rows. Sorts
+  // runs of 'kSortRunRows' and then merges them pairwise. Returns true if the
+  // rows are sorted.
+  bool sortStep();
+
+  // Waits for the peer drivers to sort their input. The last driver to get
+  // here divides the rows of all drivers into key ranges. Returns false if
+  // this has to wait for 'peersFuture_'.
+  bool finishPeers();
+
+  // Gives each of 'orderBys' the rows of one key range from the sorted rows
+  // of all of them. The ranges are bounded by splitters taken from regular
+  // samples of the sorted rows.
+  void partitionRanges(const std::vector<OrderBy*>& orderBys);
+
+  // Merges adjacent pairs of the sorted parts of 'returningRows_' delimited
+  // by 'partEnds_'.
+  void mergePartsStep();
+
   // Checks if input will fit in the existing memory and increases
   // reservation if not. If reservation cannot be increased, spills enough to
   // make 'input' fit.
   void ensureInputFits(const RowVectorPtr& input);
 
+  // Sets 'nextInputReservationBytes_' to the reservation growth that
+  // ensureInputFits() would need for an input like 'input' if it is not
+  // already available.
+  void prepareReservationForNextInput(const RowVectorPtr& input);
+
   // Prepare the reusable output buffer based on the output batch size and the
   // remaining rows to return.
   void prepareOutput();
@@ -90,6 +152,13 @@ class OrderBy : public Operator {
   // If it is zero, then there is no such limit.
   const uint64_t spillMemoryThreshold_;
 
+  // If true, the reservation for the next input is grown off the driver
+  // thread from isBlocked().
+  const bool asyncMemoryReservation_;
+
+  // The reservation growth to start in the next isBlocked() call.
+  int64_t nextInputReservationBytes_{0};
+
   // The map from column channel in 'output_' to the corresponding one stored in
   // 'data_'. The column channel might be reordered to ensure the sorting key
   // columns stored first in 'data_'.
@@ -97,7 +166,26 @@ class OrderBy : public Operator {
 
   std::vector<CompareFlags> keyCompareFlags_;
 
-  std::unique_ptr<RowContainer> data_;
+  std::shared_ptr<RowContainer> data_;
+
+  // Set if the OrderBy feeds a LocalMerge and 'parallel_order_by_enabled' is
+  // set.
+  std::shared_ptr<OrderByBridge> bridge_;
+
+  // True once finishPeers() has been called.
+  bool joinedPeers_{false};
+
+  // Future for the peers to sort their input and the last one to divide the
+  // rows into key ranges.
+  ContinueFuture peersFuture_{ContinueFuture::makeEmpty()};
+
+  // The containers of all drivers if this returns a key range. The range has
+  // rows from all of them.
+  std::vector<std::shared_ptr<RowContainer>> rangeData_;
+
+  // The ends of the sorted parts of 'returningRows_' that come from different
+  // drivers. The parts are merged before returning rows.
+  std::vector<size_t> partEnds_;
 
   // The row type used to store input data in row container and for spilling
   // internally.
@@ -118,6 +206,18 @@ class OrderBy : public Operator {
   // Used to collect sorted rows from 'data_' on non-spilling output path.
   std::vector<char*> returningRows_;
 
+  // The state of sortStep(). The runs before 'sortedRunsEnd_' are sorted. The
+  // merge pass merges runs of 'mergeWidth_' rows from 'returningRows_' into
+  // 'mergeBuffer_' and has merged the rows before 'mergeOut_'. 'mergeLeft_'
+  // and 'mergeRight_' are the next rows of the two runs being merged.
+  bool sorted_{false};
+  size_t sortedRunsEnd_{0};
+  size_t mergeWidth_{kSortRunRows};
+  size_t mergeLeft_{0};
+  size_t mergeRight_{0};
+  size_t mergeOut_{0};
+  std::vector<char*> mergeBuffer_;
+
   std::unique_ptr<Spiller> spiller_;
 
   // Counts input batches and triggers spilling if folly hash of this % 100 <=
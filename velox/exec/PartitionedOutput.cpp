@@ -15,6 +15,7 @@
  */
 
 #include "velox/exec/PartitionedOutput.h"
+#include "velox/exec/Exchange.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/Task.h"
 
@@ -29,16 +30,17 @@ BlockingReason Destination::advance(
     const std::function<void()>& bufferReleaseFn,
     bool* atEnd,
     ContinueFuture* future) {
-  if (row_ >= rows_.size()) {
-    *atEnd = true;
-    return BlockingReason::kNotBlocked;
-  }
-
   const uint32_t adjustedMaxBytes = (maxBytes * targetSizePct_) / 100;
   if (bytesInCurrent_ >= adjustedMaxBytes) {
+    // Rows that were scattered into 'current_' may fill it with no rows left.
     return flush(bufferManager, bufferReleaseFn, future);
   }
 
+  if (row_ >= rows_.size()) {
+    *atEnd = true;
+    return BlockingReason::kNotBlocked;
+  }
+
   auto firstRow = row_;
   for (; row_ < rows_.size(); ++row_) {
     // TODO: add support for serializing partial ranges if the full range is too
@@ -65,6 +67,10 @@ void Destination::serialize(
     const RowVectorPtr& output,
     vector_size_t begin,
     vector_size_t end) {
+  if (inProcess_) {
+    collect(output, begin, end);
+    return;
+  }
   if (!current_) {
     current_ = std::make_unique<VectorStreamGroup>(pool_);
     auto rowType = asRowType(output->type());
@@ -72,15 +78,85 @@ void Destination::serialize(
     for (vector_size_t i = begin; i < end; i++) {
       numRows += rows_[i].size;
     }
-    current_->createStreamTree(rowType, numRows);
+    current_->createStreamTree(rowType, numRows, serdeOptions_);
   }
   current_->append(output, folly::Range(&rows_[begin], end - begin));
 }
 
+VectorStreamGroup* Destination::scatterGroup(
+    const RowTypePtr& rowType,
+    vector_size_t numRows) {
+  VELOX_CHECK(!inProcess_);
+  if (!current_) {
+    current_ = std::make_unique<VectorStreamGroup>(pool_);
+    current_->createStreamTree(rowType, numRows, serdeOptions_);
+  }
+  return current_.get();
+}
+
+void Destination::collect(
+    const RowVectorPtr& output,
+    vector_size_t begin,
+    vector_size_t end) {
+  if (begin == end) {
+    return;
+  }
+  if (end - begin == 1 && rows_[begin].begin == 0 &&
+      rows_[begin].size == output->size()) {
+    vectors_.push_back(output);
+    return;
+  }
+  vector_size_t numRows = 0;
+  for (auto i = begin; i < end; ++i) {
+    numRows += rows_[i].size;
+  }
+  auto indices = allocateIndices(numRows, pool_);
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  BufferPtr nulls;
+  uint64_t* rawNulls = nullptr;
+  if (output->rawNulls() != nullptr) {
+    nulls = allocateNulls(numRows, pool_);
+    rawNulls = nulls->asMutable<uint64_t>();
+  }
+  vector_size_t numCollected = 0;
+  for (auto i = begin; i < end; ++i) {
+    for (auto row = rows_[i].begin; row < rows_[i].begin + rows_[i].size;
+         ++row) {
+      if (rawNulls != nullptr) {
+        bits::setNull(rawNulls, numCollected, output->isNullAt(row));
+      }
+      rawIndices[numCollected++] = row;
+    }
+  }
+  std::vector<VectorPtr> children;
+  children.reserve(output->childrenSize());
+  for (const auto& child : output->children()) {
+    children.push_back(
+        BaseVector::wrapInDictionary(nullptr, indices, numRows, child));
+  }
+  vectors_.push_back(std::make_shared<RowVector>(
+      pool_, output->type(), nulls, numRows, std::move(children)));
+}
+
 BlockingReason Destination::flush(
     PartitionedOutputBufferManager& bufferManager,
     const std::function<void()>& bufferReleaseFn,
     ContinueFuture* future) {
+  if (!vectors_.empty()) {
+    // The page keeps 'vectors_' and, through 'bufferReleaseFn', the memory
+    // which they reference alive until the consumer is done with it.
+    auto page = std::make_unique<SerializedPage>(
+        std::move(vectors_),
+        std::max<uint64_t>(1, bytesInCurrent_),
+        bufferReleaseFn);
+    vectors_.clear();
+    bytesInCurrent_ = 0;
+    setTargetSizePct();
+    const bool blocked =
+        bufferManager.enqueue(taskId_, destination_, std::move(page), future);
+    return blocked ? BlockingReason::kWaitForConsumer
+                   : BlockingReason::kNotBlocked;
+  }
   if (!current_) {
     return BlockingReason::kNotBlocked;
   }
@@ -136,7 +212,11 @@ PartitionedOutput::PartitionedOutput(
       bufferReleaseFn_([task = operatorCtx_->task()]() {}),
       maxBufferedBytes_(ctx->task->queryCtx()
                             ->queryConfig()
-                            .maxPartitionedOutputBufferSize()) {
+                            .maxPartitionedOutputBufferSize()),
+      inProcessExchange_(
+          ctx->task->queryCtx()->queryConfig().inProcessExchange()),
+      serdeOptions_(
+          exchangeSerdeOptions(ctx->task->queryCtx()->queryConfig())) {
   if (!planNode->isPartitioned()) {
     VELOX_USER_CHECK_EQ(numDestinations_, 1);
   }
@@ -178,7 +258,8 @@ void PartitionedOutput::initializeDestinations() {
     auto taskId = operatorCtx_->taskId();
     for (int i = 0; i < numDestinations_; ++i) {
       destinations_.push_back(
-          std::make_unique<detail::Destination>(taskId, i, pool()));
+          std::make_unique<detail::Destination>(
+              taskId, i, pool(), &serdeOptions_, inProcessExchange_));
     }
   }
 }
@@ -256,7 +337,7 @@ void PartitionedOutput::addInput(RowVectorPtr input) {
           if (singlePartition.has_value()) {
             destinations_[singlePartition.value()]->addRow(i);
           } else {
-            destinations_[partitions_[i]]->addRow(i);
+            addRow(partitions_[i], i);
           }
         }
       }
@@ -264,15 +345,62 @@ void PartitionedOutput::addInput(RowVectorPtr input) {
       if (singlePartition.has_value()) {
         destinations_[singlePartition.value()]->addRows(
             IndexRange{0, numInput});
-      } else {
+      } else if (!tryScatter()) {
         for (vector_size_t i = 0; i < numInput; ++i) {
-          destinations_[partitions_[i]]->addRow(i);
+          addRow(partitions_[i], i);
         }
       }
     }
   }
 }
 
+bool PartitionedOutput::tryScatter() {
+  if (inProcessExchange_) {
+    return false;
+  }
+  const auto numInput = input_->size();
+  scatterBytes_.assign(numDestinations_, 0);
+  for (vector_size_t i = 0; i < numInput; ++i) {
+    const auto partition = partitions_[i];
+    if (partition == core::PartitionFunction::kAllPartitions) {
+      return false;
+    }
+    scatterBytes_[partition] += rowSize_[i];
+  }
+  const auto maxBytes = maxPageSize();
+  for (auto i = 0; i < numDestinations_; ++i) {
+    if (scatterBytes_[i] > 0 &&
+        destinations_[i]->serializedBytes() + scatterBytes_[i] > maxBytes) {
+      return false;
+    }
+  }
+
+  const auto rowType = asRowType(output_->type());
+  scatterGroups_.assign(numDestinations_, nullptr);
+  for (auto i = 0; i < numDestinations_; ++i) {
+    if (scatterBytes_[i] > 0) {
+      scatterGroups_[i] = destinations_[i]->scatterGroup(
+          rowType, numInput / numDestinations_ + 1);
+    }
+  }
+  VectorStreamGroup::scatter(
+      output_, folly::Range(partitions_.data(), numInput), scatterGroups_);
+  for (auto i = 0; i < numDestinations_; ++i) {
+    if (scatterBytes_[i] > 0) {
+      destinations_[i]->addScatteredBytes(scatterBytes_[i]);
+    }
+  }
+  return true;
+}
+
+uint64_t PartitionedOutput::maxPageSize() const {
+  // Limit serialized pages to 1MB.
+  static const uint64_t kMaxPageSize = 1 << 20;
+  return std::max<uint64_t>(
+      kMinDestinationSize,
+      std::min<uint64_t>(kMaxPageSize, maxBufferedBytes_ / numDestinations_));
+}
+
 void PartitionedOutput::collectNullRows() {
   auto size = input_->size();
   rows_.resize(size);
@@ -307,11 +435,7 @@ RowVectorPtr PartitionedOutput::getOutput() {
   VELOX_CHECK_NOT_NULL(
       bufferManager, "PartitionedOutputBufferManager was already destructed");
 
-  // Limit serialized pages to 1MB.
-  static const uint64_t kMaxPageSize = 1 << 20;
-  const uint64_t maxPageSize = std::max<uint64_t>(
-      kMinDestinationSize,
-      std::min<uint64_t>(kMaxPageSize, maxBufferedBytes_ / numDestinations_));
+  const uint64_t maxPageSize = this->maxPageSize();
 
   bool workLeft;
   do {
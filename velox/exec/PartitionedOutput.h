@@ -18,6 +18,7 @@
 #include <folly/Random.h>
 #include "velox/exec/Operator.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
+#include "velox/serializers/PrestoSerializer.h"
 #include "velox/vector/VectorStream.h"
 
 namespace facebook::velox::exec {
@@ -28,8 +29,14 @@ class Destination {
   Destination(
       const std::string& taskId,
       int destination,
-      memory::MemoryPool* pool)
-      : taskId_(taskId), destination_(destination), pool_(pool) {
+      memory::MemoryPool* pool,
+      const VectorSerde::Options* serdeOptions = nullptr,
+      bool inProcess = false)
+      : taskId_(taskId),
+        destination_(destination),
+        pool_(pool),
+        serdeOptions_(serdeOptions),
+        inProcess_(inProcess) {
     setTargetSizePct();
   }
 
@@ -47,6 +54,18 @@ class Destination {
     rows_.push_back(rows);
   }
 
+  // Returns the stream group to scatter rows of 'rowType' into, see
+  // VectorStreamGroup::scatter(). Creates it with room for 'numRows' if there
+  // is none. The caller adds the size of the scattered rows with
+  // addScatteredBytes(). Not used if 'inProcess'.
+  VectorStreamGroup* scatterGroup(
+      const RowTypePtr& rowType,
+      vector_size_t numRows);
+
+  void addScatteredBytes(uint64_t bytes) {
+    bytesInCurrent_ += bytes;
+  }
+
   BlockingReason advance(
       uint64_t maxBytes,
       const std::vector<vector_size_t>& sizes,
@@ -77,6 +96,11 @@ class Destination {
   void
   serialize(const RowVectorPtr& input, vector_size_t begin, vector_size_t end);
 
+  // Appends the rows in 'rows_[begin, end)' of 'input' to 'vectors_' without
+  // copying, as the whole of 'input' or as dictionaries over its children.
+  void
+  collect(const RowVectorPtr& input, vector_size_t begin, vector_size_t end);
+
   // Sets the next target size for flushing. This is called at the
   // start of each batch of output for the destination. The effect is
   // to make different destinations ready at slightly different times
@@ -93,12 +117,19 @@ class Destination {
   const std::string taskId_;
   const int destination_;
   memory::MemoryPool* const pool_;
+  // The options for serializing the output. Owned by PartitionedOutput.
+  const VectorSerde::Options* const serdeOptions_;
+  // If true, the output is enqueued as in-process pages holding vectors
+  // instead of serialized pages. See QueryConfig::inProcessExchange().
+  const bool inProcess_;
   uint64_t bytesInCurrent_{0};
   std::vector<IndexRange> rows_;
 
   // First row of 'rows_' that is not appended to 'current_'
   vector_size_t row_{0};
   std::unique_ptr<VectorStreamGroup> current_;
+  // The vectors to enqueue on the next flush if 'inProcess_'.
+  std::vector<RowVectorPtr> vectors_;
   bool finished_{false};
 
   // Flush accumulated data to buffer manager after reaching this
@@ -175,6 +206,27 @@ class PartitionedOutput : public Operator {
   /// Collect all rows with null keys into nullRows_.
   void collectNullRows();
 
+  // Returns the max size of a serialized page for one destination.
+  uint64_t maxPageSize() const;
+
+  // Serializes all rows of 'output_' into the destinations given by
+  // 'partitions_' in one pass over each column. Returns false without
+  // serializing anything if a row goes to all destinations or if a
+  // destination would exceed maxPageSize() with the rows of this batch.
+  bool tryScatter();
+
+  /// Adds 'row' to the destination for 'partition', or to all destinations if
+  /// 'partition' is core::PartitionFunction::kAllPartitions.
+  void addRow(uint32_t partition, vector_size_t row) {
+    if (FOLLY_UNLIKELY(partition == core::PartitionFunction::kAllPartitions)) {
+      for (auto& destination : destinations_) {
+        destination->addRow(row);
+      }
+      return;
+    }
+    destinations_[partition]->addRow(row);
+  }
+
   const std::vector<column_index_t> keyChannels_;
   const int numDestinations_;
   const bool replicateNullsAndAny_;
@@ -184,6 +236,8 @@ class PartitionedOutput : public Operator {
   const std::weak_ptr<exec::PartitionedOutputBufferManager> bufferManager_;
   const std::function<void()> bufferReleaseFn_;
   const int64_t maxBufferedBytes_;
+  const bool inProcessExchange_;
+  const serializer::presto::PrestoVectorSerde::PrestoOptions serdeOptions_;
 
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
   ContinueFuture future_;
@@ -202,6 +256,9 @@ class PartitionedOutput : public Operator {
   SelectivityVector rows_;
   SelectivityVector nullRows_;
   std::vector<uint32_t> partitions_;
+  // The estimated serialized bytes of each destination in tryScatter().
+  std::vector<uint64_t> scatterBytes_;
+  std::vector<VectorStreamGroup*> scatterGroups_;
   std::vector<DecodedVector> decodedVectors_;
 };
 
@@ -20,6 +20,32 @@ namespace facebook::velox::exec {
 
 using core::PartitionedOutputNode;
 
+namespace {
+// Returns shallow copies of the serialized bytes of 'pages'. A null page is
+// the end marker and stays null.
+std::vector<std::unique_ptr<folly::IOBuf>> toIOBufs(
+    const std::vector<std::shared_ptr<SerializedPage>>& pages) {
+  std::vector<std::unique_ptr<folly::IOBuf>> buffers;
+  buffers.reserve(pages.size());
+  for (const auto& page : pages) {
+    buffers.push_back(page == nullptr ? nullptr : page->getIOBuf());
+  }
+  return buffers;
+}
+
+PagesAvailableCallback toPagesAvailableCallback(DataAvailableCallback notify) {
+  if (notify == nullptr) {
+    return nullptr;
+  }
+  return [notify = std::move(notify)](
+             std::vector<std::shared_ptr<SerializedPage>> pages,
+             int64_t sequence,
+             int64_t /*remainingBytes*/) {
+    notify(toIOBufs(pages), sequence);
+  };
+}
+} // namespace
+
 void ArbitraryBuffer::noMoreData() {
   // Drop duplicate end markers.
   if (!pages_.empty() && pages_.back() == nullptr) {
@@ -62,16 +88,20 @@ std::string ArbitraryBuffer::toString() const {
       hasNoMoreData());
 }
 
-std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
+std::vector<std::shared_ptr<SerializedPage>> DestinationBuffer::getPages(
     uint64_t maxBytes,
     int64_t sequence,
-    DataAvailableCallback notify,
-    ArbitraryBuffer* arbitraryBuffer) {
+    PagesAvailableCallback notify,
+    ArbitraryBuffer* arbitraryBuffer,
+    int64_t* remainingBytes) {
   VELOX_CHECK_GE(
       sequence, sequence_, "Get received for an already acknowledged item");
   if (arbitraryBuffer != nullptr) {
     loadData(arbitraryBuffer, maxBytes);
   }
+  if (remainingBytes != nullptr) {
+    *remainingBytes = dataBytes_;
+  }
 
   if (sequence - sequence_ > data_.size()) {
     VLOG(1) << this << " Out of order get: " << sequence << " over "
@@ -89,7 +119,7 @@ std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
     return {};
   }
 
-  std::vector<std::unique_ptr<folly::IOBuf>> result;
+  std::vector<std::shared_ptr<SerializedPage>> result;
   uint64_t resultBytes = 0;
   for (auto i = sequence - sequence_; i < data_.size(); ++i) {
     // nullptr is used as end marker
@@ -98,21 +128,46 @@ std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
       result.push_back(nullptr);
       break;
     }
-    result.push_back(data_[i]->getIOBuf());
+    result.push_back(data_[i]);
     resultBytes += data_[i]->size();
     if (resultBytes >= maxBytes) {
       break;
     }
   }
+  if (remainingBytes != nullptr) {
+    // Not yet acknowledged pages before 'sequence' are not remaining.
+    int64_t skippedBytes = 0;
+    for (auto i = 0; i < sequence - sequence_; ++i) {
+      if (data_[i] != nullptr) {
+        skippedBytes += data_[i]->size();
+      }
+    }
+    *remainingBytes = dataBytes_ - skippedBytes - resultBytes;
+  }
   return result;
 }
 
+std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
+    uint64_t maxBytes,
+    int64_t sequence,
+    DataAvailableCallback notify,
+    ArbitraryBuffer* arbitraryBuffer) {
+  return toIOBufs(getPages(
+      maxBytes,
+      sequence,
+      toPagesAvailableCallback(std::move(notify)),
+      arbitraryBuffer));
+}
+
 void DestinationBuffer::enqueue(std::shared_ptr<SerializedPage> data) {
   // Drop duplicate end markers.
   if (data == nullptr && !data_.empty() && data_.back() == nullptr) {
     return;
   }
 
+  if (data != nullptr) {
+    dataBytes_ += data->size();
+  }
   data_.push_back(std::move(data));
 }
 
@@ -123,7 +178,12 @@ DataAvailable DestinationBuffer::getAndClearNotify() {
   DataAvailable result;
   result.callback = notify_;
   result.sequence = notifySequence_;
-  result.data = getData(notifyMaxBytes_, notifySequence_, nullptr);
+  result.data = getPages(
+      notifyMaxBytes_,
+      notifySequence_,
+      nullptr,
+      nullptr,
+      &result.remainingBytes);
   notify_ = nullptr;
   notifySequence_ = 0;
   notifyMaxBytes_ = 0;
@@ -175,6 +235,7 @@ std::vector<std::shared_ptr<SerializedPage>> DestinationBuffer::acknowledge(
       VELOX_CHECK_EQ(i, data_.size() - 1, "null marker found in the middle");
       break;
     }
+    dataBytes_ -= data_[i]->size();
     freed.push_back(std::move(data_[i]));
   }
   data_.erase(data_.begin(), data_.begin() + numDeleted);
@@ -193,6 +254,7 @@ DestinationBuffer::deleteResults() {
     freed.push_back(std::move(data_[i]));
   }
   data_.clear();
+  dataBytes_ = 0;
   return freed;
 }
 
@@ -567,12 +629,13 @@ bool PartitionedOutputBuffer::deleteResults(int destination) {
   return isFinished;
 }
 
-void PartitionedOutputBuffer::getData(
+void PartitionedOutputBuffer::getPages(
     int destination,
     uint64_t maxBytes,
     int64_t sequence,
-    DataAvailableCallback notify) {
-  std::vector<std::unique_ptr<folly::IOBuf>> data;
+    PagesAvailableCallback notify) {
+  std::vector<std::shared_ptr<SerializedPage>> data;
+  int64_t remainingBytes{0};
   std::vector<std::shared_ptr<SerializedPage>> freed;
   std::vector<ContinuePromise> promises;
   {
@@ -591,14 +654,27 @@ void PartitionedOutputBuffer::getData(
         sequence);
     freed = buffer->acknowledge(sequence, true);
     updateAfterAcknowledgeLocked(freed, promises);
-    data = buffer->getData(maxBytes, sequence, notify, arbitraryBuffer_.get());
+    data = buffer->getPages(
+        maxBytes, sequence, notify, arbitraryBuffer_.get(), &remainingBytes);
   }
   releaseAfterAcknowledge(freed, promises);
   if (!data.empty()) {
-    notify(std::move(data), sequence);
+    notify(std::move(data), sequence, remainingBytes);
   }
 }
 
+void PartitionedOutputBuffer::getData(
+    int destination,
+    uint64_t maxBytes,
+    int64_t sequence,
+    DataAvailableCallback notify) {
+  getPages(
+      destination,
+      maxBytes,
+      sequence,
+      toPagesAvailableCallback(std::move(notify)));
+}
+
 void PartitionedOutputBuffer::terminate() {
   VELOX_CHECK(!task_->isRunning());
 
@@ -27,14 +27,26 @@ namespace facebook::velox::exec {
 using DataAvailableCallback = std::function<
     void(std::vector<std::unique_ptr<folly::IOBuf>> pages, int64_t sequence)>;
 
+/// Same as DataAvailableCallback but hands out the buffered pages themselves
+/// instead of shallow copies of their serialized bytes. This is used by
+/// consumers in the same process, which can take pages that hold vectors
+/// instead of serialized data. See SerializedPage::isSerialized().
+/// 'remainingBytes' is the size of the pages that stay buffered for the
+/// destination after 'pages'.
+using PagesAvailableCallback = std::function<void(
+    std::vector<std::shared_ptr<SerializedPage>> pages,
+    int64_t sequence,
+    int64_t remainingBytes)>;
+
 struct DataAvailable {
-  DataAvailableCallback callback;
+  PagesAvailableCallback callback;
   int64_t sequence;
-  std::vector<std::unique_ptr<folly::IOBuf>> data;
+  std::vector<std::shared_ptr<SerializedPage>> data;
+  int64_t remainingBytes{0};
 
   void notify() {
     if (callback) {
-      callback(std::move(data), sequence);
+      callback(std::move(data), sequence, remainingBytes);
     }
   }
 };
@@ -99,6 +111,16 @@ class DestinationBuffer {
       DataAvailableCallback notify,
       ArbitraryBuffer* arbitraryBuffer = nullptr);
 
+  // Same as getData but returns the pages instead of copies of their bytes.
+  // Sets 'remainingBytes', if not null, to the bytes buffered after the
+  // returned pages.
+  std::vector<std::shared_ptr<SerializedPage>> getPages(
+      uint64_t maxBytes,
+      int64_t sequence,
+      PagesAvailableCallback notify,
+      ArbitraryBuffer* arbitraryBuffer = nullptr,
+      int64_t* remainingBytes = nullptr);
+
   // Removes data from the queue and returns removed data. If 'fromGetData' we
   // do not give a warning for the case where no data is removed, otherwise we
   // expect that data does get freed. We cannot assert that data gets
@@ -118,9 +140,11 @@ class DestinationBuffer {
 
  private:
   std::vector<std::shared_ptr<SerializedPage>> data_;
+  // The total size of the pages in 'data_'.
+  int64_t dataBytes_{0};
   // The sequence number of the first in 'data_'.
   int64_t sequence_ = 0;
-  DataAvailableCallback notify_ = nullptr;
+  PagesAvailableCallback notify_ = nullptr;
   // The sequence number of the first item to pass to 'notify'.
   int64_t notifySequence_{0};
   uint64_t notifyMaxBytes_{0};
@@ -178,6 +202,14 @@ class PartitionedOutputBuffer {
       int64_t sequence,
       DataAvailableCallback notify);
 
+  // Same as getData but hands out the pages instead of copies of their
+  // bytes. Used by consumers in the same process.
+  void getPages(
+      int destination,
+      uint64_t maxSize,
+      int64_t sequence,
+      PagesAvailableCallback notify);
+
   // Continues any possibly waiting producers. Called when the
   // producer task has an error or cancellation.
   void terminate();
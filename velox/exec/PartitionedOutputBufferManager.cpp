@@ -103,6 +103,19 @@ bool PartitionedOutputBufferManager::getData(
   return false;
 }
 
+bool PartitionedOutputBufferManager::getPages(
+    const std::string& taskId,
+    int destination,
+    uint64_t maxBytes,
+    int64_t sequence,
+    PagesAvailableCallback notify) {
+  if (auto buffer = getBufferIfExists(taskId)) {
+    buffer->getPages(destination, maxBytes, sequence, std::move(notify));
+    return true;
+  }
+  return false;
+}
+
 void PartitionedOutputBufferManager::initializeTask(
     std::shared_ptr<Task> task,
     core::PartitionedOutputNode::Kind kind,
@@ -80,6 +80,16 @@ class PartitionedOutputBufferManager {
       int64_t sequence,
       DataAvailableCallback notify);
 
+  // Same as getData but hands out the buffered pages instead of copies of
+  // their serialized bytes. Used by consumers in the same process, which can
+  // also take pages that hold vectors.
+  bool getPages(
+      const std::string& taskId,
+      int destination,
+      uint64_t maxBytes,
+      int64_t sequence,
+      PagesAvailableCallback notify);
+
   void removeTask(const std::string& taskId);
 
   static std::weak_ptr<PartitionedOutputBufferManager> getInstance();
@@ -15,10 +15,22 @@
  */
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/common/base/SuccinctPrinter.h"
+#include "velox/exec/KeyNdvEstimator.h"
 #include "velox/exec/TaskStats.h"
 
 namespace facebook::velox::exec {
 
+namespace {
+int64_t timelinePeakBytes(
+    const std::vector<memory::MemoryPool::TimelineSample>& timeline) {
+  int64_t peak = 0;
+  for (const auto& sample : timeline) {
+    peak = std::max(peak, sample.reservedBytes);
+  }
+  return peak;
+}
+} // namespace
+
 void PlanNodeStats::add(const OperatorStats& stats) {
   auto it = operatorStats.find(stats.operatorType);
   if (it != operatorStats.end()) {
@@ -51,6 +63,10 @@ void PlanNodeStats::addTotals(const OperatorStats& stats) {
 
   peakMemoryBytes += stats.memoryStats.peakTotalMemoryReservation;
   numMemoryAllocations += stats.memoryStats.numMemoryAllocations;
+  if (timelinePeakBytes(stats.memoryStats.timeline) >
+      timelinePeakBytes(memoryTimeline)) {
+    memoryTimeline = stats.memoryStats.timeline;
+  }
 
   for (const auto& [name, runtimeStats] : stats.runtimeStats) {
     if (UNLIKELY(customStats.count(name) == 0)) {
@@ -60,6 +76,19 @@ void PlanNodeStats::addTotals(const OperatorStats& stats) {
     }
   }
 
+  for (const auto& [stack, count] : stats.profileSamples) {
+    profileSamples[stack] += count;
+  }
+
+  for (const auto& [name, sketch] : stats.keyNdvSketches) {
+    auto it = keyNdvSketches.find(name);
+    if (it == keyNdvSketches.end()) {
+      keyNdvSketches.emplace(name, sketch);
+    } else {
+      KeyNdvEstimator::mergeSketch(it->second, sketch);
+    }
+  }
+
   // Populating number of drivers for plan nodes with multiple operators is not
   // useful. Each operator could have been executed in different pipelines with
   // different number of drivers.
@@ -102,6 +131,37 @@ std::string PlanNodeStats::toString(bool includeInputStats) const {
   if (numSplits > 0) {
     out << ", Splits: " << numSplits;
   }
+
+  if (!keyNdvSketches.empty()) {
+    out << ", Key NDVs:";
+    for (const auto& [name, ndv] : keyNdvs()) {
+      out << " " << name << "=" << ndv;
+    }
+  }
+  return out.str();
+}
+
+std::map<std::string, int64_t> PlanNodeStats::keyNdvs() const {
+  std::map<std::string, int64_t> ndvs;
+  for (const auto& [name, sketch] : keyNdvSketches) {
+    ndvs[name] = KeyNdvEstimator::cardinality(sketch);
+  }
+  return ndvs;
+}
+
+std::string PlanNodeStats::memoryTimelineToString() const {
+  std::stringstream out;
+  out << "[";
+  for (auto i = 0; i < memoryTimeline.size(); ++i) {
+    const auto& sample = memoryTimeline[i];
+    if (i > 0) {
+      out << ", ";
+    }
+    out << "+" << sample.timeMs - memoryTimeline[0].timeMs << "ms "
+        << succinctBytes(sample.reservedBytes) << "/"
+        << succinctBytes(sample.usedBytes);
+  }
+  out << "]";
   return out.str();
 }
 
@@ -159,6 +219,12 @@ folly::dynamic toPlanStatsJson(const facebook::velox::exec::TaskStats& stats) {
       }
       stat["customStats"] = cs;
 
+      folly::dynamic ndvs = folly::dynamic::object;
+      for (const auto& [name, ndv] : operatorStat.second->keyNdvs()) {
+        ndvs[name] = ndv;
+      }
+      stat["keyNdvs"] = ndvs;
+
       jsonStats.push_back(stat);
     }
   }
@@ -195,7 +261,8 @@ void printCustomStats(
 std::string printPlanWithStats(
     const core::PlanNode& plan,
     const TaskStats& taskStats,
-    bool includeCustomStats) {
+    bool includeCustomStats,
+    bool includeMemoryTimeline) {
   auto planStats = toPlanStats(taskStats);
   auto leafPlanNodes = plan.leafPlanNodeIds();
 
@@ -229,6 +296,11 @@ std::string printPlanWithStats(
             printCustomStats(stats.customStats, indentation + "   ", stream);
           }
         }
+        if (includeMemoryTimeline && !stats.memoryTimeline.empty()) {
+          stream << std::endl
+                 << indentation << "   memoryTimeline "
+                 << stats.memoryTimelineToString();
+        }
       });
 }
 } // namespace facebook::velox::exec
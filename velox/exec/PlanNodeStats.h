@@ -87,9 +87,21 @@ struct PlanNodeStats {
 
   uint64_t numMemoryAllocations{0};
 
+  /// The memory timeline of the corresponding operator with the highest peak
+  /// memory usage. See MemoryPool::memoryTimeline().
+  std::vector<memory::MemoryPool::TimelineSample> memoryTimeline;
+
   /// Operator-specific counters.
   std::unordered_map<std::string, RuntimeMetric> customStats;
 
+  /// Sum of DriverProfiler samples for all corresponding operators, keyed on
+  /// folded stack of operator type and expressions.
+  std::unordered_map<std::string, uint64_t> profileSamples;
+
+  /// Merged HyperLogLog sketches of the distinct values of key columns of all
+  /// corresponding operators, keyed on column name. See keyNdvs().
+  std::unordered_map<std::string, std::string> keyNdvSketches;
+
   /// Breakdown of stats by operator type.
   std::unordered_map<std::string, std::unique_ptr<PlanNodeStats>> operatorStats;
 
@@ -119,6 +131,21 @@ struct PlanNodeStats {
 
   std::string toString(bool includeInputStats = false) const;
 
+  /// Returns the memory timeline as a list of samples, each giving the time
+  /// since the first sample, the reserved and the used bytes.
+  std::string memoryTimelineToString() const;
+
+  /// Returns the estimated number of distinct values of each key column in
+  /// 'keyNdvSketches'.
+  std::map<std::string, int64_t> keyNdvs() const;
+
+  /// Returns the ratio of output to input rows. This is the selectivity of a
+  /// filter and, for the HashProbe entry of 'operatorStats', the fanout of a
+  /// join. Returns 1 if there is no input.
+  double outputRatio() const {
+    return inputRows == 0 ? 1 : static_cast<double>(outputRows) / inputRows;
+  }
+
   bool isMultiOperatorTypeNode() const {
     return operatorStats.size() > 1;
   }
@@ -142,8 +169,11 @@ folly::dynamic toPlanStatsJson(const facebook::velox::exec::TaskStats& stats);
 /// Note that input row counts and sizes are printed only for leaf plan nodes.
 ///
 /// @param includeCustomStats If true, prints operator-specific counters.
+/// @param includeMemoryTimeline If true, prints the memory timeline of plan
+/// nodes that use memory.
 std::string printPlanWithStats(
     const core::PlanNode& plan,
     const TaskStats& taskStats,
-    bool includeCustomStats = false);
+    bool includeCustomStats = false,
+    bool includeMemoryTimeline = false);
 } // namespace facebook::velox::exec
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PrefixSort.h"
+
+#include <folly/lang/Bits.h>
+
+#include "velox/common/base/BitUtil.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+// The smallest number of bytes of a string worth putting in the prefix.
+constexpr int32_t kMinStringBytes = 4;
+
+// Returns the number of bytes of a value of 'kind' in the prefix, 0 if
+// values of 'kind' are not encoded and -1 for strings, which take the rest
+// of the prefix.
+int32_t valueBytes(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+      return 1;
+    case TypeKind::SMALLINT:
+      return 2;
+    case TypeKind::INTEGER:
+    case TypeKind::REAL:
+      return 4;
+    case TypeKind::BIGINT:
+    case TypeKind::DOUBLE:
+      return 8;
+    case TypeKind::TIMESTAMP:
+      // Seconds and nanos.
+      return 12;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return -1;
+    default:
+      return 0;
+  }
+}
+
+template <typename U>
+void storeBigEndian(U bits, bool ascending, uint8_t* out) {
+  if (!ascending) {
+    bits = ~bits;
+  }
+  bits = folly::Endian::big(bits);
+  memcpy(out, &bits, sizeof(U));
+}
+
+// Flips the sign bit so that negative values order before positive ones as
+// unsigned.
+template <typename T>
+void encodeInteger(T value, bool ascending, uint8_t* out) {
+  using U = std::make_unsigned_t<T>;
+  const auto bits =
+      static_cast<U>(static_cast<U>(value) ^ (U(1) << (sizeof(T) * 8 - 1)));
+  storeBigEndian<U>(bits, ascending, out);
+}
+
+// Orders like comparePrimitiveAsc(): NaNs are equal and greater than all
+// other values and -0 equals 0.
+template <typename T, typename U>
+void encodeFloat(T value, bool ascending, uint8_t* out) {
+  if (std::isnan(value)) {
+    value = std::numeric_limits<T>::quiet_NaN();
+  } else if (value == 0) {
+    value = 0;
+  }
+  U bits;
+  memcpy(&bits, &value, sizeof(T));
+  constexpr U kSignBit = U(1) << (sizeof(U) * 8 - 1);
+  bits = (bits & kSignBit) ? ~bits : bits | kSignBit;
+  storeBigEndian<U>(bits, ascending, out);
+}
+
+// Copies the first 'numBytes' of the string, padded with zeros. Strings that
+// are equal in their first 'numBytes' compare equal, so a tie is compared in
+// full.
+void encodeString(
+    StringView value,
+    int32_t numBytes,
+    bool ascending,
+    uint8_t* out) {
+  std::string storage;
+  if (!value.isInline()) {
+    value = HashStringAllocator::contiguousString(value, storage);
+  }
+  const auto size = std::min<int32_t>(value.size(), numBytes);
+  memcpy(out, value.data(), size);
+  if (!ascending) {
+    for (auto i = 0; i < numBytes; ++i) {
+      out[i] = ~out[i];
+    }
+  }
+}
+
+void encodeValue(
+    TypeKind kind,
+    const char* value,
+    int32_t numBytes,
+    bool ascending,
+    uint8_t* out) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+      out[0] = *reinterpret_cast<const bool*>(value) ^ !ascending;
+      break;
+    case TypeKind::TINYINT:
+      out[0] = (*reinterpret_cast<const uint8_t*>(value) ^ 0x80) ^
+          (ascending ? 0 : 0xff);
+      break;
+    case TypeKind::SMALLINT:
+      encodeInteger(*reinterpret_cast<const int16_t*>(value), ascending, out);
+      break;
+    case TypeKind::INTEGER:
+      encodeInteger(*reinterpret_cast<const int32_t*>(value), ascending, out);
+      break;
+    case TypeKind::BIGINT:
+      encodeInteger(*reinterpret_cast<const int64_t*>(value), ascending, out);
+      break;
+    case TypeKind::REAL:
+      encodeFloat<float, uint32_t>(
+          *reinterpret_cast<const float*>(value), ascending, out);
+      break;
+    case TypeKind::DOUBLE:
+      encodeFloat<double, uint64_t>(
+          *reinterpret_cast<const double*>(value), ascending, out);
+      break;
+    case TypeKind::TIMESTAMP: {
+      const auto* timestamp = reinterpret_cast<const Timestamp*>(value);
+      encodeInteger(timestamp->getSeconds(), ascending, out);
+      storeBigEndian<uint32_t>(timestamp->getNanos(), ascending, out + 8);
+      break;
+    }
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      encodeString(
+          *reinterpret_cast<const StringView*>(value),
+          numBytes,
+          ascending,
+          out);
+      break;
+    default:
+      VELOX_UNREACHABLE(
+          "Unexpected prefix sort key {}", mapTypeKindToName(kind));
+  }
+}
+} // namespace
+
+// static
+PrefixSort::Layout PrefixSort::makeLayout(
+    const RowContainer& data,
+    const std::vector<std::pair<column_index_t, CompareFlags>>& keys,
+    const std::vector<char*>& rows) {
+  Layout layout;
+  layout.complete = true;
+  int32_t numBytes = 0;
+  for (const auto& [channel, flags] : keys) {
+    const auto kind = data.columnTypes()[channel]->kind();
+    const auto column = data.columnAt(channel);
+    auto keyBytes = valueBytes(kind);
+    if (keyBytes == 0) {
+      layout.complete = false;
+      break;
+    }
+    bool hasNulls = false;
+    if (column.nullMask()) {
+      for (const auto* row : rows) {
+        if (RowContainer::isNullAt(row, column.nullByte(), column.nullMask())) {
+          hasNulls = true;
+          break;
+        }
+      }
+    }
+    const int32_t nullBytes = hasNulls ? 1 : 0;
+    const bool isString = keyBytes < 0;
+    if (isString) {
+      keyBytes = kMaxPrefixBytes - numBytes - nullBytes;
+      if (keyBytes < kMinStringBytes) {
+        layout.complete = false;
+        break;
+      }
+    } else if (numBytes + nullBytes + keyBytes > kMaxPrefixBytes) {
+      layout.complete = false;
+      break;
+    }
+    layout.keys.push_back({column, kind, flags, hasNulls, keyBytes});
+    numBytes += nullBytes + keyBytes;
+    if (isString) {
+      // A string may be longer than its part in the prefix.
+      layout.complete = false;
+      break;
+    }
+  }
+  layout.numWords = bits::roundUp(numBytes, 8) / 8;
+  return layout;
+}
+
+// static
+void PrefixSort::encode(
+    const Layout& layout,
+    const char* row,
+    uint64_t* words) {
+  uint8_t buffer[kMaxPrefixBytes] = {};
+  int32_t offset = 0;
+  for (const auto& key : layout.keys) {
+    const bool isNull = RowContainer::isNullAt(
+        row, key.column.nullByte(), key.column.nullMask());
+    if (key.hasNullByte) {
+      // Nulls go first or last regardless of the order of the values.
+      buffer[offset++] = isNull ? (key.flags.nullsFirst ? 0 : 2) : 1;
+    }
+    if (!isNull) {
+      encodeValue(
+          key.kind,
+          row + key.column.offset(),
+          key.numBytes,
+          key.flags.ascending,
+          buffer + offset);
+    }
+    offset += key.numBytes;
+  }
+  for (auto i = 0; i < layout.numWords; ++i) {
+    words[i] = folly::Endian::big(
+        folly::loadUnaligned<uint64_t>(buffer + i * sizeof(uint64_t)));
+  }
+}
+
+} // namespace facebook::velox::exec
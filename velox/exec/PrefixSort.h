@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+/// Sorts pointers to the rows of a RowContainer by a prefix of normalized
+/// keys. The leading sort keys of each row are encoded into at most
+/// kMaxPrefixBytes bytes that compare as unsigned big endian words in the
+/// order of the keys. The encoded prefixes are sorted next to the row
+/// pointers, so that most comparisons do not touch the rows. Rows with equal
+/// prefixes are compared in full.
+class PrefixSort {
+ public:
+  static constexpr int32_t kMaxPrefixBytes = 16;
+
+  /// Sorts 'rows' of 'data' by 'keys', each a column of 'data' and its
+  /// order. 'lessThan' compares two rows by all of 'keys' and is used for
+  /// rows with equal prefixes, or for all comparisons if the first key
+  /// cannot be encoded, e.g. is of a complex type.
+  template <typename LessThan>
+  static void sort(
+      const RowContainer& data,
+      const std::vector<std::pair<column_index_t, CompareFlags>>& keys,
+      std::vector<char*>& rows,
+      LessThan lessThan) {
+    const auto layout = makeLayout(data, keys, rows);
+    switch (layout.numWords) {
+      case 1:
+        sortWithPrefix<1>(layout, rows, lessThan);
+        break;
+      case 2:
+        sortWithPrefix<2>(layout, rows, lessThan);
+        break;
+      default:
+        std::sort(rows.begin(), rows.end(), lessThan);
+    }
+  }
+
+ private:
+  struct PrefixKey {
+    RowColumn column;
+    TypeKind kind;
+    CompareFlags flags;
+    // True if the prefix has a byte for the null flag of the key. This is
+    // left out if no row has a null.
+    bool hasNullByte;
+    // Number of bytes for the value of the key.
+    int32_t numBytes;
+  };
+
+  struct Layout {
+    std::vector<PrefixKey> keys;
+    // Number of 64 bit words in the prefix. 0 if the first key cannot be
+    // encoded.
+    int32_t numWords{0};
+    // True if 'keys' has all sort keys in full, so that rows with equal
+    // prefixes are equal.
+    bool complete{false};
+  };
+
+  template <int32_t kNumWords>
+  struct Entry {
+    uint64_t words[kNumWords];
+    char* row;
+  };
+
+  static Layout makeLayout(
+      const RowContainer& data,
+      const std::vector<std::pair<column_index_t, CompareFlags>>& keys,
+      const std::vector<char*>& rows);
+
+  // Writes the prefix of 'row' to 'layout.numWords' words at 'words'.
+  static void encode(const Layout& layout, const char* row, uint64_t* words);
+
+  template <int32_t kNumWords, typename LessThan>
+  static void sortWithPrefix(
+      const Layout& layout,
+      std::vector<char*>& rows,
+      LessThan lessThan) {
+    std::vector<Entry<kNumWords>> entries(rows.size());
+    for (auto i = 0; i < rows.size(); ++i) {
+      encode(layout, rows[i], entries[i].words);
+      entries[i].row = rows[i];
+    }
+    const bool complete = layout.complete;
+    std::sort(
+        entries.begin(),
+        entries.end(),
+        [&](const Entry<kNumWords>& left, const Entry<kNumWords>& right) {
+          for (auto i = 0; i < kNumWords; ++i) {
+            if (left.words[i] != right.words[i]) {
+              return left.words[i] < right.words[i];
+            }
+          }
+          return !complete && lessThan(left.row, right.row);
+        });
+    for (auto i = 0; i < rows.size(); ++i) {
+      rows[i] = entries[i].row;
+    }
+  }
+};
+
+} // namespace facebook::velox::exec
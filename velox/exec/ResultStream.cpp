@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/ResultStream.h"
+
+#include <cerrno>
+
+#include "velox/vector/arrow/Abi.h"
+#include "velox/vector/arrow/Bridge.h"
+
+namespace facebook::velox::exec {
+
+ResultStream::ResultStream(RowTypePtr type, int32_t maxQueuedBatches)
+    : type_(std::move(type)), maxQueuedBatches_(maxQueuedBatches) {
+  VELOX_CHECK_GT(maxQueuedBatches_, 0);
+}
+
+ResultStream::~ResultStream() {
+  close();
+}
+
+ConsumerSupplier ResultStream::consumerSupplier() {
+  return [self = shared_from_this()]() -> Consumer {
+    Producer* producer;
+    {
+      std::lock_guard<std::mutex> l(self->mutex_);
+      producer = &self->producers_.emplace_back(self->maxQueuedBatches_);
+    }
+    ++self->numProducersAdded_;
+    return [self, producer](RowVectorPtr vector, ContinueFuture* future) {
+      return self->add(*producer, std::move(vector), future);
+    };
+  };
+}
+
+void ResultStream::setNumProducers(int32_t numProducers) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    numProducers_ = numProducers;
+  }
+  consumerWait_.notifyAll();
+}
+
+BlockingReason ResultStream::add(
+    Producer& producer,
+    RowVectorPtr vector,
+    ContinueFuture* future) {
+  if (!vector) {
+    ++numProducersFinished_;
+    consumerWait_.notify();
+    return BlockingReason::kNotBlocked;
+  }
+  VELOX_CHECK(!closed_, "Result stream is closed");
+  // The producer does not add while blocked, so there is always room.
+  VELOX_CHECK(producer.queue.write(std::move(vector)));
+  consumerWait_.notify();
+  if (producer.queue.sizeGuess() < maxQueuedBatches_) {
+    return BlockingReason::kNotBlocked;
+  }
+
+  std::lock_guard<std::mutex> l(producer.mutex);
+  producer.blocked = true;
+  // Either this sees the reads of the consumer or the consumer sees
+  // 'blocked' after its read.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (producer.queue.sizeGuess() <= maxQueuedBatches_ / 2 || closed_) {
+    producer.blocked = false;
+    return BlockingReason::kNotBlocked;
+  }
+  auto [promise, blockFuture] =
+      makeVeloxContinuePromiseContract("ResultStream::add");
+  producer.promise = std::move(promise);
+  *future = std::move(blockFuture);
+  return BlockingReason::kWaitForConsumer;
+}
+
+void ResultStream::maybeUnblock(Producer& producer) {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!producer.blocked) {
+    return;
+  }
+  std::optional<ContinuePromise> promise;
+  {
+    std::lock_guard<std::mutex> l(producer.mutex);
+    if (!producer.blocked ||
+        (producer.queue.sizeGuess() > maxQueuedBatches_ / 2 && !closed_)) {
+      return;
+    }
+    producer.blocked = false;
+    promise = std::move(producer.promise);
+    producer.promise.reset();
+  }
+  promise->setValue();
+}
+
+RowVectorPtr ResultStream::tryRead(const std::vector<Producer*>& producers) {
+  for (auto i = 0; i < producers.size(); ++i) {
+    auto* producer = producers[(nextProducer_ + i) % producers.size()];
+    RowVectorPtr vector;
+    if (producer->queue.read(vector)) {
+      maybeUnblock(*producer);
+      // Reads the next batch from the next producer for fairness.
+      nextProducer_ = (nextProducer_ + i + 1) % producers.size();
+      return vector;
+    }
+  }
+  return nullptr;
+}
+
+bool ResultStream::atEnd(const std::vector<Producer*>& producers) const {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!numProducers_.has_value() ||
+        numProducersFinished_ < numProducers_.value()) {
+      return false;
+    }
+  }
+  // A producer adds its last batch before it finishes.
+  for (auto* producer : producers) {
+    if (!producer->queue.isEmpty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RowVectorPtr ResultStream::next() {
+  std::vector<Producer*> producers;
+  auto updateProducers = [&]() {
+    if (producers.size() == numProducersAdded_.load()) {
+      return;
+    }
+    std::lock_guard<std::mutex> l(mutex_);
+    producers.clear();
+    for (auto& producer : producers_) {
+      producers.push_back(&producer);
+    }
+  };
+
+  for (;;) {
+    if (closed_) {
+      return nullptr;
+    }
+    updateProducers();
+    if (auto vector = tryRead(producers)) {
+      return vector;
+    }
+    const auto key = consumerWait_.prepareWait();
+    updateProducers();
+    if (auto vector = tryRead(producers)) {
+      consumerWait_.cancelWait();
+      return vector;
+    }
+    if (closed_ || atEnd(producers)) {
+      consumerWait_.cancelWait();
+      return nullptr;
+    }
+    consumerWait_.wait(key);
+  }
+}
+
+void ResultStream::close() {
+  closed_ = true;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (auto& producer : producers_) {
+      maybeUnblock(producer);
+    }
+  }
+  consumerWait_.notifyAll();
+}
+
+namespace {
+struct ArrowStreamState {
+  std::shared_ptr<ResultStream> stream;
+  std::shared_ptr<memory::MemoryPool> pool;
+  std::string error;
+};
+
+ArrowStreamState* streamState(ArrowArrayStream* arrowStream) {
+  return static_cast<ArrowStreamState*>(arrowStream->private_data);
+}
+
+int getSchema(ArrowArrayStream* arrowStream, ArrowSchema* out) {
+  auto* state = streamState(arrowStream);
+  try {
+    velox::exportToArrow(
+        BaseVector::create(state->stream->type(), 0, state->pool.get()),
+        *out);
+  } catch (const std::exception& e) {
+    state->error = e.what();
+    return EINVAL;
+  }
+  return 0;
+}
+
+int getNext(ArrowArrayStream* arrowStream, ArrowArray* out) {
+  auto* state = streamState(arrowStream);
+  try {
+    auto batch = state->stream->next();
+    if (!batch) {
+      // Marks the end of the stream.
+      out->release = nullptr;
+      return 0;
+    }
+    // Flattens a copy of the top level so that the producer's vectors keep
+    // their encodings.
+    auto children = batch->children();
+    for (auto& child : children) {
+      BaseVector::flattenVector(child);
+    }
+    auto flat = std::make_shared<RowVector>(
+        state->pool.get(),
+        batch->type(),
+        batch->nulls(),
+        batch->size(),
+        std::move(children));
+    velox::exportToArrow(flat, *out, state->pool.get());
+  } catch (const std::exception& e) {
+    state->error = e.what();
+    return EIO;
+  }
+  return 0;
+}
+
+const char* getLastError(ArrowArrayStream* arrowStream) {
+  const auto& error = streamState(arrowStream)->error;
+  return error.empty() ? nullptr : error.c_str();
+}
+
+void release(ArrowArrayStream* arrowStream) {
+  delete streamState(arrowStream);
+  arrowStream->release = nullptr;
+}
+} // namespace
+
+void ResultStream::exportToArrow(
+    ArrowArrayStream& arrowStream,
+    std::shared_ptr<memory::MemoryPool> pool) {
+  arrowStream.get_schema = getSchema;
+  arrowStream.get_next = getNext;
+  arrowStream.get_last_error = getLastError;
+  arrowStream.release = release;
+  arrowStream.private_data =
+      new ArrowStreamState{shared_from_this(), std::move(pool), ""};
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+#include <folly/ProducerConsumerQueue.h>
+#include <folly/experimental/EventCount.h>
+
+#include "velox/exec/Driver.h"
+
+struct ArrowArrayStream;
+
+namespace facebook::velox::exec {
+
+/// Hands the results of a Task to a consumer in the same process. Each
+/// output Driver of the Task writes to its own bounded single producer single
+/// consumer queue, so the Drivers do not contend with each other or with the
+/// consumer for a lock. A Driver whose queue is full gets
+/// BlockingReason::kWaitForConsumer and is continued when the consumer has
+/// read half of its queue. Results are passed by reference, without copying.
+///
+/// Usage:
+///
+///   auto stream = std::make_shared<ResultStream>(plan->outputType());
+///   auto task = Task::create(
+///       taskId, plan, 0, queryCtx, stream->consumerSupplier());
+///   Task::start(task, numDrivers);
+///   stream->setNumProducers(task->numOutputDrivers());
+///   while (auto batch = stream->next()) {
+///     ...
+///   }
+///   // A failed Task ends the stream early. Check task->error().
+///
+/// next() must be called from one thread at a time.
+class ResultStream : public std::enable_shared_from_this<ResultStream> {
+ public:
+  /// 'maxQueuedBatches' is the number of batches each output Driver can
+  /// queue before it blocks.
+  explicit ResultStream(RowTypePtr type, int32_t maxQueuedBatches = 4);
+
+  ~ResultStream();
+
+  const RowTypePtr& type() const {
+    return type_;
+  }
+
+  /// Returns the ConsumerSupplier to create the Task with. Each call of the
+  /// supplier adds a producer. The supplier references 'this'.
+  ConsumerSupplier consumerSupplier();
+
+  /// Sets the number of producers that must finish before next() returns
+  /// nullptr. Must be called after the Task created its output Drivers.
+  void setNumProducers(int32_t numProducers);
+
+  /// Returns the next batch of results. Blocks until a batch is available.
+  /// Returns nullptr when all producers have finished or after close().
+  RowVectorPtr next();
+
+  /// Stops reading. Producers that add results after this fail their Task.
+  void close();
+
+  /// Exports 'this' as an Arrow C stream. Batches are flattened before export
+  /// so that all have the schema of the stream. Allocations for the export
+  /// are made from 'pool'. The stream keeps 'this' and 'pool' alive.
+  void exportToArrow(
+      ArrowArrayStream& arrowStream,
+      std::shared_ptr<memory::MemoryPool> pool);
+
+ private:
+  struct Producer {
+    explicit Producer(int32_t maxQueuedBatches)
+        : queue(maxQueuedBatches + 1) {}
+
+    // Holds at most 'maxQueuedBatches_'. The producer stops adding when the
+    // queue is full.
+    folly::ProducerConsumerQueue<RowVectorPtr> queue;
+
+    // True while the producer waits for the consumer. Checked by the
+    // consumer without 'mutex' after each read.
+    std::atomic<bool> blocked{false};
+
+    // Serializes setting and fulfilling 'promise'.
+    std::mutex mutex;
+    std::optional<ContinuePromise> promise;
+  };
+
+  BlockingReason
+  add(Producer& producer, RowVectorPtr vector, ContinueFuture* future);
+
+  // Reads a batch from one of 'producers', starting after the producer of the
+  // last batch. Returns nullptr if all queues are empty.
+  RowVectorPtr tryRead(const std::vector<Producer*>& producers);
+
+  // Continues 'producer' if it is blocked and has room.
+  void maybeUnblock(Producer& producer);
+
+  bool atEnd(const std::vector<Producer*>& producers) const;
+
+  const RowTypePtr type_;
+  const int32_t maxQueuedBatches_;
+
+  // Wakes up the consumer waiting for results.
+  folly::EventCount consumerWait_;
+
+  // Serializes adding producers and reading 'producers_' and
+  // 'numProducers_'.
+  mutable std::mutex mutex_;
+  std::deque<Producer> producers_;
+  std::optional<int32_t> numProducers_;
+
+  std::atomic<int32_t> numProducersAdded_{0};
+  std::atomic<int32_t> numProducersFinished_{0};
+  std::atomic<bool> closed_{false};
+
+  // Producer to read from next. Used only by the consumer.
+  size_t nextProducer_{0};
+};
+
+} // namespace facebook::velox::exec
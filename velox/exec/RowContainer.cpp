@@ -65,12 +65,15 @@ Accumulator::Accumulator(
     int32_t fixedSize,
     bool usesExternalMemory,
     int32_t alignment,
-    std::function<void(folly::Range<char**> groups)> destroyFunction)
+    std::function<void(folly::Range<char**> groups)> destroyFunction,
+    std::function<void(folly::Range<char**> groups, VectorPtr& result)>
+        spillFunction)
     : isFixedSize_{isFixedSize},
       fixedSize_{fixedSize},
       usesExternalMemory_{usesExternalMemory},
       alignment_{alignment},
-      destroyFunction_{destroyFunction} {}
+      destroyFunction_{destroyFunction},
+      spillFunction_{std::move(spillFunction)} {}
 
 bool Accumulator::isFixedSize() const {
   return isFixedSize_;
@@ -92,6 +95,18 @@ void Accumulator::destroy(folly::Range<char**> groups) {
   destroyFunction_(groups);
 }
 
+void Accumulator::extractForSpill(
+    folly::Range<char**> groups,
+    VectorPtr& result) const {
+  if (aggregate_ != nullptr) {
+    aggregate_->extractAccumulators(groups.data(), groups.size(), &result);
+    return;
+  }
+  VELOX_CHECK(
+      spillFunction_ != nullptr, "Accumulator does not support spilling");
+  spillFunction_(groups, result);
+}
+
 // static
 int32_t RowContainer::combineAlignments(int32_t a, int32_t b) {
   VELOX_CHECK_EQ(__builtin_popcount(a), 1, "Alignment can only be power of 2");
@@ -487,14 +502,83 @@ void RowContainer::storeComplexType(
       StringView(reinterpret_cast<char*>(position.position), stream.size());
 }
 
+void RowContainer::storeSerialized(
+    std::string_view serialized,
+    char* row,
+    int32_t columnIndex) {
+  const auto offset = columnAt(columnIndex).offset();
+  RowSizeTracker tracker(row[rowSizeOffset_], *stringAllocator_);
+  ByteStream stream(stringAllocator_.get(), false, false);
+  auto position = stringAllocator_->newWrite(stream);
+  stream.appendStringPiece(
+      folly::StringPiece(serialized.data(), serialized.size()));
+  stringAllocator_->finishWrite(stream, 0);
+  valueAt<StringView>(row, offset) =
+      StringView(reinterpret_cast<char*>(position.position), stream.size());
+}
+
+// static
+bool RowContainer::equalsSerialized(
+    const char* row,
+    RowColumn column,
+    std::optional<std::string_view> serialized) {
+  const bool rowIsNull = isNullAt(row, column.nullByte(), column.nullMask());
+  if (rowIsNull || !serialized.has_value()) {
+    return rowIsNull == !serialized.has_value();
+  }
+  const auto value = valueAt<StringView>(row, column.offset());
+  // Values of different sizes are different without reading them.
+  if (value.size() != serialized->size()) {
+    return false;
+  }
+  std::string storage;
+  return memcmp(
+             HashStringAllocator::contiguousString(value, storage).data(),
+             serialized->data(),
+             serialized->size()) == 0;
+}
+
+// static
+bool RowContainer::equalsSerialized(
+    const char* left,
+    const char* right,
+    RowColumn column) {
+  if (isNullAt(right, column.nullByte(), column.nullMask())) {
+    return equalsSerialized(left, column, std::nullopt);
+  }
+  const auto value = valueAt<StringView>(right, column.offset());
+  std::string storage;
+  const auto contiguous = HashStringAllocator::contiguousString(value, storage);
+  return equalsSerialized(
+      left, column, std::string_view(contiguous.data(), contiguous.size()));
+}
+
 //   static
 int32_t RowContainer::compareStringAsc(
     StringView left,
     const DecodedVector& decoded,
     vector_size_t index) {
+  auto right = decoded.valueAt<StringView>(index);
+  // Decide on the inlined prefix if possible. This does not touch the out of
+  // line part of 'left', which may be cold or split over several blocks.
+  if (auto result = left.comparePrefix(right)) {
+    return result;
+  }
   std::string storage;
-  return HashStringAllocator::contiguousString(left, storage)
-      .compare(decoded.valueAt<StringView>(index));
+  return HashStringAllocator::contiguousString(left, storage).compare(right);
+}
+
+// static
+bool RowContainer::equalsString(
+    StringView left,
+    const DecodedVector& decoded,
+    vector_size_t index) {
+  auto right = decoded.valueAt<StringView>(index);
+  if (!left.sizeAndPrefixEquals(right)) {
+    return false;
+  }
+  std::string storage;
+  return HashStringAllocator::contiguousString(left, storage) == right;
 }
 
 // static
@@ -512,6 +596,9 @@ int RowContainer::compareComplexType(
 }
 
 int32_t RowContainer::compareStringAsc(StringView left, StringView right) {
+  if (auto result = left.comparePrefix(right)) {
+    return result;
+  }
   std::string leftStorage;
   std::string rightStorage;
   return HashStringAllocator::contiguousString(left, leftStorage)
@@ -623,6 +710,59 @@ void RowContainer::clear() {
   firstFreeRow_ = nullptr;
 }
 
+int64_t RowContainer::compactStringAllocator(int64_t maxCopyBytes) {
+  if (!accumulators_.empty() || !stringAllocator_.unique() ||
+      usesExternalMemory_ || numRows_ == 0) {
+    return 0;
+  }
+  std::vector<RowColumn> columns;
+  for (auto i = 0; i < types_.size(); ++i) {
+    switch (typeKinds_[i]) {
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+      case TypeKind::ROW:
+      case TypeKind::ARRAY:
+      case TypeKind::MAP:
+        columns.push_back(columnAt(i));
+        break;
+      default:;
+    }
+  }
+  const int64_t retainedBytes = stringAllocator_->retainedSize();
+  const int64_t liveBytes = retainedBytes - stringAllocator_->freeSpace();
+  if (columns.empty() || liveBytes > maxCopyBytes) {
+    return 0;
+  }
+
+  // Strings and serialized complex type values are both written as a
+  // possibly multipart byte range that starts at the first byte of its first
+  // block, so both can be moved with contiguousString() and copyMultipart().
+  auto compacted =
+      std::make_shared<HashStringAllocator>(stringAllocator_->pool());
+  constexpr int32_t kBatch = 1000;
+  std::vector<char*> rows(kBatch);
+  std::string storage;
+  RowContainerIterator iter;
+  while (auto numRows = listRows(&iter, kBatch, rows.data())) {
+    for (auto i = 0; i < numRows; ++i) {
+      auto* row = rows[i];
+      for (const auto& column : columns) {
+        if (isNullAt(row, column.nullByte(), column.nullMask())) {
+          continue;
+        }
+        auto& view = valueAt<StringView>(row, column.offset());
+        if (view.isInline()) {
+          continue;
+        }
+        view = HashStringAllocator::contiguousString(view, storage);
+        compacted->copyMultipart(row, column.offset());
+      }
+    }
+  }
+  stringAllocator_ = std::move(compacted);
+  return std::max<int64_t>(0, retainedBytes - stringAllocator_->retainedSize());
+}
+
 void RowContainer::setProbedFlag(char** rows, int32_t numRows) {
   for (auto i = 0; i < numRows; i++) {
     // Row may be null in case of a FULL join.
@@ -29,12 +29,16 @@ class Aggregate;
 
 class Accumulator {
  public:
+  /// 'spillFunction' extracts the accumulators of 'groups' into a vector for
+  /// spilling. If not set, the accumulators can not be spilled.
   Accumulator(
       bool isFixedSize,
       int32_t fixedSize,
       bool usesExternalMemory,
       int32_t alignment,
-      std::function<void(folly::Range<char**> groups)> destroyFunction);
+      std::function<void(folly::Range<char**> groups)> destroyFunction,
+      std::function<void(folly::Range<char**> groups, VectorPtr& result)>
+          spillFunction = nullptr);
 
   explicit Accumulator(Aggregate* aggregate);
 
@@ -48,11 +52,9 @@ class Accumulator {
 
   void destroy(folly::Range<char**> groups);
 
-  /// Used only for spilling. Do not introduce other usages.
-  Aggregate* aggregateForSpill() const {
-    VELOX_CHECK_NOT_NULL(aggregate_);
-    return aggregate_;
-  }
+  /// Extracts the accumulators of 'groups' into 'result' for spilling. Uses
+  /// the intermediate results of the aggregate if constructed from one.
+  void extractForSpill(folly::Range<char**> groups, VectorPtr& result) const;
 
  private:
   const bool isFixedSize_;
@@ -60,6 +62,8 @@ class Accumulator {
   const bool usesExternalMemory_;
   const int32_t alignment_;
   std::function<void(folly::Range<char**> groups)> destroyFunction_;
+  std::function<void(folly::Range<char**> groups, VectorPtr& result)>
+      spillFunction_;
   Aggregate* aggregate_{nullptr};
 };
 
@@ -275,6 +279,31 @@ class RowContainer {
       char* FOLLY_NONNULL row,
       int32_t columnIndex);
 
+  // Stores 'serialized', a complex type value serialized by
+  // ContainerRowSerde, into 'row' at 'columnIndex'. Copies the bytes instead
+  // of serializing the value again.
+  void storeSerialized(
+      std::string_view serialized,
+      char* FOLLY_NONNULL row,
+      int32_t columnIndex);
+
+  // Returns true if the complex type value of 'column' in 'row' equals
+  // 'serialized', a value serialized by ContainerRowSerde, or if both are
+  // null. The type of 'column' must be binary equality comparable, see
+  // ContainerRowSerde::isBinaryEqualityComparable().
+  static bool equalsSerialized(
+      const char* FOLLY_NONNULL row,
+      RowColumn column,
+      std::optional<std::string_view> serialized);
+
+  // Returns true if the complex type values of 'column' in 'left' and
+  // 'right' are equal or both null, comparing their serializations. The same
+  // requirement on the type as above applies.
+  static bool equalsSerialized(
+      const char* FOLLY_NONNULL left,
+      const char* FOLLY_NONNULL right,
+      RowColumn column);
+
   HashStringAllocator& stringAllocator() {
     return *stringAllocator_;
   }
@@ -616,6 +645,18 @@ class RowContainer {
   // Resets the state to be as after construction. Frees memory for payload.
   void clear();
 
+  /// Copies the out-of-line variable width values of all rows into a new
+  /// HashStringAllocator and frees the old one, which gives back memory lost
+  /// to fragmentation of the old free lists. Returns the reduction of the
+  /// retained size of the string allocator in bytes. This is a no-op
+  /// returning 0 if the container has accumulators, whose state may hold
+  /// pointers into the string allocator, if the string allocator is shared
+  /// with another container, or if the live variable width data may exceed
+  /// 'maxCopyBytes'. Both allocators are alive during the copy, so the
+  /// caller should pass the memory it can use without growing its
+  /// reservation.
+  int64_t compactStringAllocator(int64_t maxCopyBytes);
+
   int32_t compareRows(
       const char* FOLLY_NONNULL left,
       const char* FOLLY_NONNULL right,
@@ -911,8 +952,7 @@ class RowContainer {
       return compareComplexType(row, offset, decoded, index) == 0;
     }
     if (Kind == TypeKind::VARCHAR || Kind == TypeKind::VARBINARY) {
-      return compareStringAsc(
-                 valueAt<StringView>(row, offset), decoded, index) == 0;
+      return equalsString(valueAt<StringView>(row, offset), decoded, index);
     }
     return decoded.valueAt<T>(index) == valueAt<T>(row, offset);
   }
@@ -930,8 +970,7 @@ class RowContainer {
       return compareComplexType(row, offset, decoded, index) == 0;
     }
     if (Kind == TypeKind::VARCHAR || Kind == TypeKind::VARBINARY) {
-      return compareStringAsc(
-                 valueAt<StringView>(row, offset), decoded, index) == 0;
+      return equalsString(valueAt<StringView>(row, offset), decoded, index);
     }
 
     return decoded.valueAt<T>(index) == valueAt<T>(row, offset);
@@ -1085,6 +1124,13 @@ class RowContainer {
 
   static int32_t compareStringAsc(StringView left, StringView right);
 
+  // Returns true if 'left' is equal to the string at 'index' in 'decoded'.
+  // Decides on size and prefix before making 'left' contiguous.
+  static bool equalsString(
+      StringView left,
+      const DecodedVector& decoded,
+      vector_size_t index);
+
   int32_t compareComplexType(
       const char* FOLLY_NONNULL row,
       int32_t offset,
@@ -15,6 +15,7 @@
  */
 
 #include "SortBuffer.h"
+#include "velox/exec/PrefixSort.h"
 #include "velox/vector/BaseVector.h"
 
 namespace facebook::velox::exec {
@@ -26,7 +27,7 @@ SortBuffer::SortBuffer(
     uint32_t outputBatchSize,
     velox::memory::MemoryPool* pool,
     tsan_atomic<bool>* nonReclaimableSection,
-    Spiller::Config* spillConfig,
+    const Spiller::Config* spillConfig,
     uint64_t spillMemoryThreshold)
     : input_(input),
       sortCompareFlags_(sortCompareFlags),
@@ -35,7 +36,7 @@ SortBuffer::SortBuffer(
       nonReclaimableSection_(nonReclaimableSection),
       spillConfig_(spillConfig),
       spillMemoryThreshold_(spillMemoryThreshold) {
-  VELOX_CHECK_GT(input_->size(), sortCompareFlags_.size());
+  VELOX_CHECK_GE(input_->size(), sortCompareFlags_.size());
   VELOX_CHECK_GT(sortCompareFlags_.size(), 0);
   VELOX_CHECK_EQ(sortColumnIndices.size(), sortCompareFlags_.size());
   VELOX_CHECK_GT(outputBatchSize_, 0);
@@ -116,9 +117,15 @@ void SortBuffer::noMoreInput() {
     sortedRows_.resize(numInputRows_);
     RowContainerIterator iter;
     data_->listRows(&iter, numInputRows_, sortedRows_.data());
-    std::sort(
-        sortedRows_.begin(),
-        sortedRows_.end(),
+    std::vector<std::pair<column_index_t, CompareFlags>> keys;
+    keys.reserve(sortCompareFlags_.size());
+    for (column_index_t i = 0; i < sortCompareFlags_.size(); ++i) {
+      keys.emplace_back(i, sortCompareFlags_[i]);
+    }
+    PrefixSort::sort(
+        *data_,
+        keys,
+        sortedRows_,
         [this](const char* leftRow, const char* rightRow) {
           for (vector_size_t index = 0; index < sortCompareFlags_.size();
                ++index) {
@@ -176,7 +183,9 @@ void SortBuffer::spill(int64_t targetRows, int64_t targetBytes) {
         spillConfig_->minSpillRunSize,
         spillConfig_->compressionKind,
         Spiller::pool(),
-        spillConfig_->executor);
+        spillConfig_->executor,
+        spillConfig_->format,
+        spillConfig_->directories);
     VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
   }
 
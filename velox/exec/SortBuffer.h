@@ -37,7 +37,7 @@ class SortBuffer {
       uint32_t outputBatchSize,
       velox::memory::MemoryPool* pool,
       tsan_atomic<bool>* nonReclaimableSection,
-      Spiller::Config* spillConfig = nullptr,
+      const Spiller::Config* spillConfig = nullptr,
       uint64_t spillMemoryThreshold = 0);
 
   void addInput(const RowVectorPtr& input);
@@ -15,12 +15,15 @@
  */
 
 #include "velox/exec/SortWindowBuild.h"
+#include "velox/exec/PrefixSort.h"
 
 namespace facebook::velox::exec {
 
 SortWindowBuild::SortWindowBuild(
     const std::shared_ptr<const core::WindowNode>& windowNode,
-    velox::memory::MemoryPool* pool)
+    velox::memory::MemoryPool* pool,
+    const Spiller::Config* spillConfig,
+    tsan_atomic<bool>* nonReclaimableSection)
     : WindowBuild(windowNode, pool) {
   allKeyInfo_.reserve(partitionKeyInfo_.size() + sortKeyInfo_.size());
   allKeyInfo_.insert(
@@ -28,9 +31,38 @@ SortWindowBuild::SortWindowBuild(
   allKeyInfo_.insert(
       allKeyInfo_.cend(), sortKeyInfo_.begin(), sortKeyInfo_.end());
   partitionStartRows_.resize(0);
+
+  if (spillConfig != nullptr) {
+    // A column repeated in the keys does not change the order. SortBuffer
+    // expects each sort column once.
+    std::vector<column_index_t> sortColumns;
+    std::vector<CompareFlags> sortFlags;
+    for (const auto& [column, order] : allKeyInfo_) {
+      if (std::find(sortColumns.begin(), sortColumns.end(), column) !=
+          sortColumns.end()) {
+        continue;
+      }
+      sortColumns.push_back(column);
+      sortFlags.push_back({order.isNullsFirst(), order.isAscending(), false});
+    }
+    sortBuffer_ = std::make_unique<SortBuffer>(
+        windowNode->sources()[0]->outputType(),
+        sortColumns,
+        sortFlags,
+        kSortedBatchSize,
+        pool,
+        nonReclaimableSection,
+        spillConfig);
+  }
 }
 
 void SortWindowBuild::addInput(RowVectorPtr input) {
+  if (sortBuffer_ != nullptr) {
+    sortBuffer_->addInput(input);
+    numRows_ += input->size();
+    return;
+  }
+
   for (auto col = 0; col < input->childrenSize(); ++col) {
     decodedInputVectors_[col].decode(*input->childAt(col));
   }
@@ -80,9 +112,17 @@ void SortWindowBuild::sortPartitions() {
   RowContainerIterator iter;
   data_->listRows(&iter, numRows_, sortedRows_.data());
 
-  std::sort(
-      sortedRows_.begin(),
-      sortedRows_.end(),
+  std::vector<std::pair<column_index_t, CompareFlags>> keys;
+  keys.reserve(allKeyInfo_.size());
+  for (const auto& [column, order] : allKeyInfo_) {
+    keys.emplace_back(
+        column,
+        CompareFlags{order.isNullsFirst(), order.isAscending(), false});
+  }
+  PrefixSort::sort(
+      *data_,
+      keys,
+      sortedRows_,
       [this](const char* leftRow, const char* rightRow) {
         return compareRowsWithKeys(leftRow, rightRow, allKeyInfo_);
       });
@@ -94,6 +134,11 @@ void SortWindowBuild::noMoreInput() {
   if (numRows_ == 0) {
     return;
   }
+  if (sortBuffer_ != nullptr) {
+    sortBuffer_->noMoreInput();
+    sortBufferReady_ = true;
+    return;
+  }
   // At this point we have seen all the input rows. The operator is
   // being prepared to output rows now.
   // To prepare the rows for output in SortWindowBuild they need to
@@ -102,7 +147,66 @@ void SortWindowBuild::noMoreInput() {
   sortPartitions();
 }
 
+void SortWindowBuild::spill() {
+  VELOX_CHECK_NOT_NULL(sortBuffer_);
+  VELOX_CHECK(!sortBufferReady_);
+  sortBuffer_->spill(0, 0);
+}
+
+bool SortWindowBuild::isSamePartition(const char* row) const {
+  for (const auto& key : partitionKeyInfo_) {
+    if (!data_->equals<true>(
+            row,
+            data_->columnAt(key.first),
+            decodedInputVectors_[key.first],
+            sortedBatchRow_)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void SortWindowBuild::loadNextPartition() {
+  // The previous partition has been fully output and its rows are no longer
+  // referenced.
+  data_->clear();
+  sortedRows_.clear();
+  for (;;) {
+    if (sortedBatch_ == nullptr || sortedBatchRow_ == sortedBatch_->size()) {
+      if (numLoadedRows_ + sortedRows_.size() == numRows_) {
+        break;
+      }
+      sortedBatch_ = sortBuffer_->getOutput();
+      VELOX_CHECK_NOT_NULL(sortedBatch_);
+      sortedBatchRow_ = 0;
+      for (auto col = 0; col < sortedBatch_->childrenSize(); ++col) {
+        decodedInputVectors_[col].decode(*sortedBatch_->childAt(col));
+      }
+    }
+    if (!sortedRows_.empty() && !isSamePartition(sortedRows_[0])) {
+      break;
+    }
+    char* newRow = data_->newRow();
+    for (auto col = 0; col < sortedBatch_->childrenSize(); ++col) {
+      data_->store(decodedInputVectors_[col], sortedBatchRow_, newRow, col);
+    }
+    sortedRows_.push_back(newRow);
+    ++sortedBatchRow_;
+  }
+  numLoadedRows_ += sortedRows_.size();
+}
+
 std::unique_ptr<WindowPartition> SortWindowBuild::nextPartition() {
+  if (sortBuffer_ != nullptr) {
+    VELOX_CHECK(hasNextPartition(), "No window partitions available");
+    loadNextPartition();
+    auto windowPartition = std::make_unique<WindowPartition>(
+        data_.get(), inputColumns_, sortKeyInfo_);
+    windowPartition->resetPartition(
+        folly::Range(sortedRows_.data(), sortedRows_.size()));
+    return windowPartition;
+  }
+
   VELOX_CHECK(partitionStartRows_.size() > 0, "No window partitions available")
 
   currentPartition_++;
@@ -124,6 +228,9 @@ std::unique_ptr<WindowPartition> SortWindowBuild::nextPartition() {
 }
 
 bool SortWindowBuild::hasNextPartition() {
+  if (sortBuffer_ != nullptr) {
+    return sortBufferReady_ && numLoadedRows_ < numRows_;
+  }
   return partitionStartRows_.size() > 0 &&
       currentPartition_ < int(partitionStartRows_.size() - 2);
 }
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "velox/exec/SortBuffer.h"
 #include "velox/exec/WindowBuild.h"
 
 namespace facebook::velox::exec {
@@ -23,11 +24,18 @@ namespace facebook::velox::exec {
 // Sorts input data of the Window by {partition keys, sort keys}
 // to identify window partitions. This sort fully orders
 // rows as needed for window function computation.
+//
+// If 'spillConfig' is set, the input rows are accumulated in a SortBuffer
+// which spills sorted runs when running out of memory. The sorted rows are
+// then read back one partition at a time, so that only the partition being
+// output is held in 'data_'.
 class SortWindowBuild : public WindowBuild {
  public:
   SortWindowBuild(
       const std::shared_ptr<const core::WindowNode>& windowNode,
-      velox::memory::MemoryPool* pool);
+      velox::memory::MemoryPool* pool,
+      const Spiller::Config* spillConfig = nullptr,
+      tsan_atomic<bool>* nonReclaimableSection = nullptr);
 
   bool needsInput() override {
     // No partitions are available yet, so can consume input rows.
@@ -42,7 +50,24 @@ class SortWindowBuild : public WindowBuild {
 
   std::unique_ptr<WindowPartition> nextPartition() override;
 
+  void spill() override;
+
+  std::optional<SpillStats> spilledStats() const override {
+    return sortBuffer_ != nullptr ? sortBuffer_->spilledStats() : std::nullopt;
+  }
+
  private:
+  // Number of rows per batch read back from 'sortBuffer_'.
+  static constexpr uint32_t kSortedBatchSize = 1'024;
+
+  // Loads the rows of the next partition from 'sortBuffer_' into 'data_'.
+  // Replaces the rows of the previous partition.
+  void loadNextPartition();
+
+  // Returns true if the row at 'sortedBatchRow_' in 'sortedBatch_' has the
+  // same partition keys as 'row'.
+  bool isSamePartition(const char* row) const;
+
   // Main sorting function loop done after all input rows are received
   // by WindowBuild.
   void sortPartitions();
@@ -73,6 +98,21 @@ class SortWindowBuild : public WindowBuild {
   // Current partition being output. Used to construct WindowPartitions
   // during resetPartition.
   vector_size_t currentPartition_ = -1;
+
+  // Set if spilling is enabled. Receives all the input rows instead of
+  // 'data_'.
+  std::unique_ptr<SortBuffer> sortBuffer_;
+
+  // True after noMoreInput() when 'sortBuffer_' is set.
+  bool sortBufferReady_{false};
+
+  // The batch of sorted rows from 'sortBuffer_' being loaded into partitions
+  // and the next row in it to load.
+  RowVectorPtr sortedBatch_;
+  vector_size_t sortedBatchRow_{0};
+
+  // Number of rows loaded from 'sortBuffer_' so far.
+  vector_size_t numLoadedRows_{0};
 };
 
 } // namespace facebook::velox::exec
@@ -50,7 +50,7 @@ struct RowPointers {
     }
   }
 
-  std::vector<char*> read(HashStringAllocator& allocator) {
+  std::vector<char*> read(HashStringAllocator& allocator) const {
     ByteStream stream(&allocator);
     HashStringAllocator::prepareRead(firstBlock, stream);
 
@@ -115,9 +115,74 @@ Accumulator SortedAggregations::accumulator() const {
           auto* accumulator = reinterpret_cast<RowPointers*>(group + offset_);
           accumulator->free(*allocator_);
         }
+      },
+      [this](folly::Range<char**> groups, VectorPtr& result) {
+        extractForSpill(groups, result);
       }};
 }
 
+TypePtr SortedAggregations::spillType() const {
+  const auto& types = inputData_->keyTypes();
+  std::vector<std::string> names;
+  names.reserve(types.size());
+  for (auto i = 0; i < types.size(); ++i) {
+    names.push_back(fmt::format("c{}", i));
+  }
+  return ARRAY(ROW(std::move(names), std::vector<TypePtr>(types)));
+}
+
+void SortedAggregations::extractForSpill(
+    folly::Range<char**> groups,
+    VectorPtr& result) const {
+  auto* pool = inputData_->pool();
+  const auto numGroups = groups.size();
+  BufferPtr offsets = allocateOffsets(numGroups, pool);
+  BufferPtr sizes = allocateSizes(numGroups, pool);
+  auto* rawOffsets = offsets->asMutable<vector_size_t>();
+  auto* rawSizes = sizes->asMutable<vector_size_t>();
+
+  std::vector<char*> allRows;
+  for (auto i = 0; i < numGroups; ++i) {
+    const auto groupRows =
+        reinterpret_cast<RowPointers*>(groups[i] + offset_)->read(*allocator_);
+    rawOffsets[i] = allRows.size();
+    rawSizes[i] = groupRows.size();
+    allRows.insert(allRows.end(), groupRows.begin(), groupRows.end());
+  }
+
+  const auto type = spillType();
+  auto elements = BaseVector::create<RowVector>(
+      type->childAt(0), allRows.size(), pool);
+  for (auto i = 0; i < inputs_.size(); ++i) {
+    inputData_->extractColumn(
+        allRows.data(), allRows.size(), i, elements->childAt(i));
+  }
+  result = std::make_shared<ArrayVector>(
+      pool, type, nullptr, numGroups, offsets, sizes, elements);
+}
+
+void SortedAggregations::addSingleGroupSpillInput(
+    char* group,
+    const VectorPtr& input,
+    vector_size_t index) {
+  auto* arrayVector = input->as<ArrayVector>();
+  VELOX_CHECK_NOT_NULL(arrayVector);
+  auto* elements = arrayVector->elements()->as<RowVector>();
+  for (auto i = 0; i < inputs_.size(); ++i) {
+    decodedInputs_[i].decode(*elements->childAt(i));
+  }
+
+  const auto offset = arrayVector->offsetAt(index);
+  const auto size = arrayVector->sizeAt(index);
+  for (auto row = offset; row < offset + size; ++row) {
+    char* newRow = inputData_->newRow();
+    for (auto i = 0; i < inputs_.size(); ++i) {
+      inputData_->store(decodedInputs_[i], row, newRow, i);
+    }
+    addNewRow(group, newRow);
+  }
+}
+
 void SortedAggregations::initializeNewGroups(
     char** groups,
     folly::Range<const vector_size_t*> indices) {
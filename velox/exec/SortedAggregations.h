@@ -64,6 +64,20 @@ class SortedAggregations {
 
   void noMoreInput();
 
+  /// Returns the type of the per-group input rows in spill files. This is an
+  /// array of rows of all inputs.
+  TypePtr spillType() const;
+
+  /// Copies the input rows of 'groups' into 'result' of spillType().
+  void extractForSpill(folly::Range<char**> groups, VectorPtr& result) const;
+
+  /// Adds the input rows at 'index' in 'input' of spillType() to 'group'. Used
+  /// for merging spilled groups.
+  void addSingleGroupSpillInput(
+      char* group,
+      const VectorPtr& input,
+      vector_size_t index);
+
   /// Sorts input row for the specified groups, computes aggregations and stores
   /// results in the specified 'result' vector.
   void extractValues(folly::Range<char**> groups, const RowVectorPtr& result);
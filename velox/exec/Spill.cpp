@@ -16,7 +16,10 @@
 
 #include "velox/exec/Spill.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/time/Timer.h"
 #include "velox/exec/OperatorUtils.h"
+#include "velox/row/CompactRow.h"
+#include "velox/serializers/CompactRowSerializer.h"
 #include "velox/serializers/PrestoSerializer.h"
 
 namespace facebook::velox::exec {
@@ -34,6 +37,16 @@ std::vector<folly::Synchronized<SpillStats>>& allSpillStats() {
   return spillStatsList;
 }
 
+// The serde for writing SpillFormat::kCompactRow batches. The batches are
+// read back by SpillFile::nextBatch() directly.
+VectorSerde* compactRowSerde() {
+  static serializer::CompactRowVectorSerde serde;
+  return &serde;
+}
+
+// The row size prefix written by CompactRowVectorSerde for each row.
+using CompactRowSize = uint32_t;
+
 folly::Synchronized<SpillStats>& localSpillStats() {
   const auto idx = std::hash<std::thread::id>{}(std::this_thread::get_id());
   auto& spillStatsVector = allSpillStats();
@@ -41,14 +54,81 @@ folly::Synchronized<SpillStats>& localSpillStats() {
 }
 } // namespace
 
+std::string spillFormatName(SpillFormat format) {
+  switch (format) {
+    case SpillFormat::kPresto:
+      return "presto";
+    case SpillFormat::kCompactRow:
+      return "compact_row";
+    default:
+      VELOX_UNREACHABLE(
+          "Unknown spill format {}", static_cast<int32_t>(format));
+  }
+}
+
+SpillFormat stringToSpillFormat(const std::string& name) {
+  if (name == "presto") {
+    return SpillFormat::kPresto;
+  }
+  if (name == "compact_row") {
+    return SpillFormat::kCompactRow;
+  }
+  VELOX_USER_FAIL("Unknown spill format: {}", name);
+}
+
 std::atomic<int32_t> SpillFile::ordinalCounter_;
 
+SpillInput::~SpillInput() {
+  if (readAhead_ == nullptr) {
+    return;
+  }
+  // Make sure the read ahead is not running into 'readAheadBuffer_' after
+  // 'this' is gone.
+  try {
+    readAhead_->move();
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Error in spill file read ahead: " << e.what();
+  }
+}
+
 void SpillInput::next(bool /*throwIfPastEnd*/) {
-  int32_t readBytes = std::min(input_->size() - offset_, buffer_->capacity());
-  VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
-  setRange({buffer_->asMutable<uint8_t>(), readBytes, 0});
-  input_->pread(offset_, readBytes, buffer_->asMutable<char>());
+  uint64_t readBytes;
+  {
+    MicrosecondTimer timer(&readWaitTimeUs_);
+    if (readAhead_ != nullptr) {
+      auto bytes = readAhead_->move();
+      readAhead_ = nullptr;
+      VELOX_CHECK_NOT_NULL(bytes);
+      readBytes = *bytes;
+      std::swap(buffer_, readAheadBuffer_);
+    } else {
+      readBytes = std::min(size_ - offset_, buffer_->capacity());
+      VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
+      input_->pread(offset_, readBytes, buffer_->asMutable<char>());
+      offset_ += readBytes;
+    }
+  }
+  setRange({buffer_->asMutable<uint8_t>(), static_cast<int32_t>(readBytes), 0});
+  maybeReadAhead();
+}
+
+void SpillInput::maybeReadAhead() {
+  if (executor_ == nullptr || offset_ >= size_) {
+    return;
+  }
+  const uint64_t readBytes =
+      std::min(size_ - offset_, readAheadBuffer_->capacity());
+  const uint64_t offset = offset_;
   offset_ += readBytes;
+  readAhead_ = std::make_shared<AsyncSource<uint64_t>>(
+      [input = input_.get(),
+       buffer = readAheadBuffer_->asMutable<char>(),
+       offset,
+       readBytes]() {
+        input->pread(offset, readBytes, buffer);
+        return std::make_unique<uint64_t>(readBytes);
+      });
+  executor_->add([source = readAhead_]() { source->prepare(); });
 }
 
 void SpillMergeStream::pop() {
@@ -98,14 +178,23 @@ SpillFile::SpillFile(
     const std::vector<CompareFlags>& sortCompareFlags,
     const std::string& path,
     common::CompressionKind compressionKind,
-    memory::MemoryPool* pool)
+    memory::MemoryPool* pool,
+    SpillFormat format,
+    SpillDirectorySet* directories)
     : type_(std::move(type)),
       numSortingKeys_(numSortingKeys),
       sortCompareFlags_(sortCompareFlags),
       ordinal_(ordinalCounter_++),
       path_(fmt::format("{}-{}", path, ordinal_)),
       compressionKind_(compressionKind),
-      pool_(pool) {
+      pool_(pool),
+      format_(format) {
+  if (directories != nullptr) {
+    // Keep the file name and place the file in the directory picked by
+    // 'directories'.
+    const auto fileName = path_.substr(path_.rfind('/') + 1);
+    path_ = directories->newFilePath(fileName, directoryIndex_);
+  }
   // NOTE: if the spilling operator has specified the sort comparison flags,
   // then it must match the number of sorting keys.
   VELOX_CHECK(
@@ -120,28 +209,78 @@ WriteFile& SpillFile::output() {
   return *output_;
 }
 
-void SpillFile::startRead() {
+void SpillFile::startRead(
+    folly::Executor* executor,
+    folly::Synchronized<SpillStats>* stats) {
   constexpr uint64_t kMaxReadBufferSize =
       (1 << 20) - AlignedBuffer::kPaddedSize; // 1MB - padding.
   VELOX_CHECK(!output_);
   VELOX_CHECK(!input_);
   auto fs = filesystems::getFileSystem(path_, nullptr);
   auto file = fs->openFileForRead(path_);
-  auto buffer = AlignedBuffer::allocate<char>(
-      std::min<uint64_t>(fileSize_, kMaxReadBufferSize), pool_);
-  input_ = std::make_unique<SpillInput>(std::move(file), std::move(buffer));
+  const auto bufferSize = std::min<uint64_t>(fileSize_, kMaxReadBufferSize);
+  auto buffer = AlignedBuffer::allocate<char>(bufferSize, pool_);
+  // There is nothing to read ahead if the whole file fits in one buffer.
+  BufferPtr readAheadBuffer;
+  if (executor != nullptr && fileSize_ > bufferSize) {
+    readAheadBuffer = AlignedBuffer::allocate<char>(bufferSize, pool_);
+  } else {
+    executor = nullptr;
+  }
+  readStats_ = stats;
+  input_ = std::make_unique<SpillInput>(
+      std::move(file),
+      std::move(buffer),
+      executor,
+      std::move(readAheadBuffer));
 }
 
 bool SpillFile::nextBatch(RowVectorPtr& rowVector) {
   if (input_->atEnd()) {
+    if (!readFinished_) {
+      readFinished_ = true;
+      const auto waitTimeUs = input_->readWaitTimeUs();
+      if (readStats_ != nullptr) {
+        readStats_->wlock()->spillReadWaitTimeUs += waitTimeUs;
+      }
+      updateGlobalSpillReadWaitTime(waitTimeUs);
+    }
     return false;
   }
+  if (format_ == SpillFormat::kCompactRow) {
+    readCompactRowBatch(rowVector);
+    return true;
+  }
   serializer::presto::PrestoVectorSerde::PrestoOptions options = {
       kDefaultUseLosslessTimestamp, compressionKind_};
   VectorStreamGroup::read(input_.get(), pool_, type_, &rowVector, &options);
   return true;
 }
 
+void SpillFile::readCompactRowBatch(RowVectorPtr& rowVector) {
+  // A batch is its byte size followed by the rows as written by
+  // CompactRowVectorSerde, each prefixed by its big endian byte size. The
+  // batch is copied out of 'input_' since its rows may straddle read buffers.
+  const auto batchSize = input_->read<uint64_t>();
+  if (batchBuffer_ == nullptr || batchBuffer_->capacity() < batchSize) {
+    batchBuffer_ = AlignedBuffer::allocate<char>(batchSize, pool_);
+  }
+  auto* rawBatch = batchBuffer_->asMutable<char>();
+  input_->readBytes(rawBatch, static_cast<int32_t>(batchSize));
+
+  std::vector<std::string_view> rows;
+  for (uint64_t offset = 0; offset < batchSize;) {
+    CompactRowSize rowSize;
+    memcpy(&rowSize, rawBatch + offset, sizeof(rowSize));
+    rowSize = folly::Endian::big(rowSize);
+    offset += sizeof(rowSize);
+    rows.emplace_back(rawBatch + offset, rowSize);
+    offset += rowSize;
+  }
+  VELOX_CHECK(!rows.empty());
+  rowVector = row::CompactRow::deserialize(rows, type_, pool_);
+}
+
 SpillFileList::SpillFileList(
     const RowTypePtr& type,
     int32_t numSortingKeys,
@@ -150,7 +289,9 @@ SpillFileList::SpillFileList(
     uint64_t targetFileSize,
     common::CompressionKind compressionKind,
     memory::MemoryPool* pool,
-    folly::Synchronized<SpillStats>* stats)
+    folly::Synchronized<SpillStats>* stats,
+    SpillFormat format,
+    SpillDirectorySet* directories)
     : type_(type),
       numSortingKeys_(numSortingKeys),
       sortCompareFlags_(sortCompareFlags),
@@ -158,7 +299,9 @@ SpillFileList::SpillFileList(
       targetFileSize_(targetFileSize),
       compressionKind_(compressionKind),
       pool_(pool),
-      stats_(stats) {
+      stats_(stats),
+      format_(format),
+      directories_(directories) {
   // NOTE: if the associated spilling operator has specified the sort
   // comparison flags, then it must match the number of sorting keys.
   VELOX_CHECK(
@@ -178,7 +321,9 @@ WriteFile& SpillFileList::currentOutput() {
         sortCompareFlags_,
         fmt::format("{}-{}", path_, files_.size()),
         compressionKind_,
-        pool_));
+        pool_,
+        format_,
+        directories_));
   }
   return files_.back()->output();
 }
@@ -196,11 +341,22 @@ uint64_t SpillFileList::flush() {
 
     batch_.reset();
     auto iobuf = out.getIOBuf();
+    const uint64_t batchSize = iobuf->computeChainDataLength();
+    if (format_ == SpillFormat::kCompactRow && batchSize == 0) {
+      return 0;
+    }
     auto& file = currentOutput();
     uint64_t writeTimeUs{0};
     uint32_t numDiskWrites{0};
     {
       MicrosecondTimer timer(&writeTimeUs);
+      if (format_ == SpillFormat::kCompactRow) {
+        // Prefix the rows with their byte size since they carry no batch
+        // header of their own.
+        file.append(std::string_view(
+            reinterpret_cast<const char*>(&batchSize), sizeof(batchSize)));
+        writtenBytes += sizeof(batchSize);
+      }
       for (auto& range : *iobuf) {
         ++numDiskWrites;
         file.append(std::string_view(
@@ -208,6 +364,10 @@ uint64_t SpillFileList::flush() {
         writtenBytes += range.size();
       }
     }
+    if (directories_ != nullptr) {
+      directories_->recordWrite(
+          files_.back()->directoryIndex(), writtenBytes, writeTimeUs);
+    }
     updateWriteStats(numDiskWrites, writtenBytes, flushTimeUs, writeTimeUs);
   }
   return writtenBytes;
@@ -220,13 +380,16 @@ uint64_t SpillFileList::write(
   {
     MicrosecondTimer timer(&timeUs);
     if (batch_ == nullptr) {
-      serializer::presto::PrestoVectorSerde::PrestoOptions options = {
-          kDefaultUseLosslessTimestamp, compressionKind_};
-      batch_ = std::make_unique<VectorStreamGroup>(pool_);
-      batch_->createStreamTree(
-          std::static_pointer_cast<const RowType>(rows->type()),
-          1000,
-          &options);
+      const auto type = std::static_pointer_cast<const RowType>(rows->type());
+      if (format_ == SpillFormat::kCompactRow) {
+        batch_ = std::make_unique<VectorStreamGroup>(pool_, compactRowSerde());
+        batch_->createStreamTree(type, 1000);
+      } else {
+        serializer::presto::PrestoVectorSerde::PrestoOptions options = {
+            kDefaultUseLosslessTimestamp, compressionKind_};
+        batch_ = std::make_unique<VectorStreamGroup>(pool_);
+        batch_->createStreamTree(type, 1000, &options);
+      }
     }
     batch_->append(rows, indices);
   }
@@ -291,7 +454,10 @@ SpillState::SpillState(
     uint64_t targetFileSize,
     common::CompressionKind compressionKind,
     memory::MemoryPool* pool,
-    folly::Synchronized<SpillStats>* stats)
+    folly::Synchronized<SpillStats>* stats,
+    folly::Executor* readAheadExecutor,
+    SpillFormat format,
+    SpillDirectorySet* directories)
     : path_(path),
       maxPartitions_(maxPartitions),
       numSortingKeys_(numSortingKeys),
@@ -300,6 +466,9 @@ SpillState::SpillState(
       compressionKind_(compressionKind),
       pool_(pool),
       stats_(stats),
+      readAheadExecutor_(readAheadExecutor),
+      format_(format),
+      directories_(directories),
       files_(maxPartitions_) {}
 
 void SpillState::setPartitionSpilled(int32_t partition) {
@@ -332,7 +501,9 @@ uint64_t SpillState::appendToPartition(
         targetFileSize_,
         compressionKind_,
         pool_,
-        stats_);
+        stats_,
+        format_,
+        directories_);
   }
   updateSpilledInputBytes(rows->estimateFlatSize());
 
@@ -348,7 +519,8 @@ std::unique_ptr<TreeOfLosers<SpillMergeStream>> SpillState::startMerge(
   auto list = std::move(files_[partition]);
   if (list != nullptr) {
     for (auto& file : list->files()) {
-      result.push_back(FileSpillMergeStream::create(std::move(file)));
+      result.push_back(FileSpillMergeStream::create(
+          std::move(file), readAheadExecutor_, stats_));
     }
   }
   VELOX_DCHECK_EQ(!result.empty(), isPartitionSpilled(partition));
@@ -432,7 +604,8 @@ SpillStats::SpillStats(
     uint64_t _spillSerializationTimeUs,
     uint64_t _spillDiskWrites,
     uint64_t _spillFlushTimeUs,
-    uint64_t _spillWriteTimeUs)
+    uint64_t _spillWriteTimeUs,
+    uint64_t _spillReadWaitTimeUs)
     : spillRuns(_spillRuns),
       spilledInputBytes(_spilledInputBytes),
       spilledBytes(_spilledBytes),
@@ -444,7 +617,8 @@ SpillStats::SpillStats(
       spillSerializationTimeUs(_spillSerializationTimeUs),
       spillDiskWrites(_spillDiskWrites),
       spillFlushTimeUs(_spillFlushTimeUs),
-      spillWriteTimeUs(_spillWriteTimeUs) {}
+      spillWriteTimeUs(_spillWriteTimeUs),
+      spillReadWaitTimeUs(_spillReadWaitTimeUs) {}
 
 SpillStats& SpillStats::operator+=(const SpillStats& other) {
   spillRuns += other.spillRuns;
@@ -459,6 +633,7 @@ SpillStats& SpillStats::operator+=(const SpillStats& other) {
   spillDiskWrites += other.spillDiskWrites;
   spillFlushTimeUs += other.spillFlushTimeUs;
   spillWriteTimeUs += other.spillWriteTimeUs;
+  spillReadWaitTimeUs += other.spillReadWaitTimeUs;
   return *this;
 }
 
@@ -477,6 +652,8 @@ SpillStats SpillStats::operator-(const SpillStats& other) const {
   result.spillDiskWrites = spillDiskWrites - other.spillDiskWrites;
   result.spillFlushTimeUs = spillFlushTimeUs - other.spillFlushTimeUs;
   result.spillWriteTimeUs = spillWriteTimeUs - other.spillWriteTimeUs;
+  result.spillReadWaitTimeUs =
+      spillReadWaitTimeUs - other.spillReadWaitTimeUs;
   return result;
 }
 
@@ -507,6 +684,7 @@ bool SpillStats::operator<(const SpillStats& other) const {
   UPDATE_COUNTER(spillDiskWrites);
   UPDATE_COUNTER(spillFlushTimeUs);
   UPDATE_COUNTER(spillWriteTimeUs);
+  UPDATE_COUNTER(spillReadWaitTimeUs);
 #undef UPDATE_COUNTER
   VELOX_CHECK(
       !((gtCount > 0) && (ltCount > 0)),
@@ -541,7 +719,8 @@ bool SpillStats::operator==(const SpillStats& other) const {
              spillSerializationTimeUs,
              spillDiskWrites,
              spillFlushTimeUs,
-             spillWriteTimeUs) ==
+             spillWriteTimeUs,
+             spillReadWaitTimeUs) ==
       std::tie(
              other.spillRuns,
              other.spilledInputBytes,
@@ -554,7 +733,8 @@ bool SpillStats::operator==(const SpillStats& other) const {
              other.spillSerializationTimeUs,
              other.spillDiskWrites,
              other.spillFlushTimeUs,
-             other.spillWriteTimeUs);
+             other.spillWriteTimeUs,
+             other.spillReadWaitTimeUs);
 }
 
 void SpillStats::reset() {
@@ -570,11 +750,12 @@ void SpillStats::reset() {
   spillDiskWrites = 0;
   spillFlushTimeUs = 0;
   spillWriteTimeUs = 0;
+  spillReadWaitTimeUs = 0;
 }
 
 std::string SpillStats::toString() const {
   return fmt::format(
-      "spillRuns[{}] spilledInputBytes[{}] spilledBytes[{}] spilledRows[{}] spilledPartitions[{}] spilledFiles[{}] spillFillTimeUs[{}] spillSortTime[{}] spillSerializationTime[{}] spillDiskWrites[{}] spillFlushTime[{}] spillWriteTime[{}]",
+      "spillRuns[{}] spilledInputBytes[{}] spilledBytes[{}] spilledRows[{}] spilledPartitions[{}] spilledFiles[{}] spillFillTimeUs[{}] spillSortTime[{}] spillSerializationTime[{}] spillDiskWrites[{}] spillFlushTime[{}] spillWriteTime[{}] spillReadWaitTime[{}]",
       spillRuns,
       succinctBytes(spilledInputBytes),
       succinctBytes(spilledBytes),
@@ -586,7 +767,8 @@ std::string SpillStats::toString() const {
       succinctMicros(spillSerializationTimeUs),
       spillDiskWrites,
       succinctMicros(spillFlushTimeUs),
-      succinctMicros(spillWriteTimeUs));
+      succinctMicros(spillWriteTimeUs),
+      succinctMicros(spillReadWaitTimeUs));
 }
 
 SpillPartitionIdSet toSpillPartitionIdSet(
@@ -636,6 +818,10 @@ void updateGlobalSpillWriteStats(
   statsLocked->spillWriteTimeUs += writeTimeUs;
 }
 
+void updateGlobalSpillReadWaitTime(uint64_t timeUs) {
+  localSpillStats().wlock()->spillReadWaitTimeUs += timeUs;
+}
+
 void updateGlobalSpillMemoryBytes(uint64_t spilledInputBytes) {
   auto statsLocked = localSpillStats().wlock();
   statsLocked->spilledInputBytes += spilledInputBytes;
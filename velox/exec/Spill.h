@@ -16,10 +16,13 @@
 
 #pragma once
 
+#include <folly/Executor.h>
 #include <folly/container/F14Set.h>
 
+#include "velox/common/base/AsyncSource.h"
 #include "velox/common/compression/Compression.h"
 #include "velox/common/file/File.h"
+#include "velox/exec/SpillDirectorySet.h"
 #include "velox/exec/TreeOfLosers.h"
 #include "velox/exec/UnorderedStreamReader.h"
 #include "velox/vector/ComplexVector.h"
@@ -28,32 +31,77 @@
 
 namespace facebook::velox::exec {
 
+/// The serialization format of spill files.
+enum class SpillFormat {
+  /// PrestoVectorSerde pages, compressed with the spill compression kind.
+  kPresto,
+  /// CompactRow serialized rows. These are cheaper to write and read back
+  /// than PrestoVectorSerde pages but are not compressed.
+  kCompactRow,
+};
+
+std::string spillFormatName(SpillFormat format);
+
+/// Returns the spill format for 'name', which is 'presto' or 'compact_row'.
+SpillFormat stringToSpillFormat(const std::string& name);
+
 // Input stream backed by spill file.
 class SpillInput : public ByteStream {
  public:
-  // Reads from 'input' using 'buffer' for buffering reads.
-  SpillInput(std::unique_ptr<ReadFile>&& input, BufferPtr buffer)
+  // Reads from 'input' using 'buffer' for buffering reads. If 'executor' is
+  // set, the next 'readAheadBuffer' worth of the file is read on 'executor'
+  // while 'buffer' is being consumed, and the two buffers then swap roles.
+  SpillInput(
+      std::unique_ptr<ReadFile>&& input,
+      BufferPtr buffer,
+      folly::Executor* executor = nullptr,
+      BufferPtr readAheadBuffer = nullptr)
       : input_(std::move(input)),
         buffer_(std::move(buffer)),
+        executor_(executor),
+        readAheadBuffer_(std::move(readAheadBuffer)),
         size_(input_->size()) {
+    VELOX_CHECK_EQ(executor_ == nullptr, readAheadBuffer_ == nullptr);
     next(true);
   }
 
+  ~SpillInput() override;
+
   void next(bool throwIfPastEnd) override;
 
   // True if all of the file has been read into vectors.
   bool atEnd() const {
-    return offset_ >= size_ && ranges()[0].position >= ranges()[0].size;
+    return offset_ >= size_ && readAhead_ == nullptr &&
+        ranges()[0].position >= ranges()[0].size;
+  }
+
+  // Returns the time spent waiting for reads, either reading on the caller
+  // thread or waiting for a read ahead to finish.
+  uint64_t readWaitTimeUs() const {
+    return readWaitTimeUs_;
   }
 
  private:
+  // Starts reading the next range of the file into 'readAheadBuffer_' on
+  // 'executor_' if there is one and not all the file has been read.
+  void maybeReadAhead();
+
   std::unique_ptr<ReadFile> input_;
   BufferPtr buffer_;
+  folly::Executor* const executor_;
+  BufferPtr readAheadBuffer_;
   const uint64_t size_;
-  // Offset of first byte not in 'buffer_'
+  // Offset of first byte not in 'buffer_' or being read into
+  // 'readAheadBuffer_'.
   uint64_t offset_ = 0;
+  // The pending read into 'readAheadBuffer_'. Produces the number of bytes
+  // read.
+  std::shared_ptr<AsyncSource<uint64_t>> readAhead_;
+  uint64_t readWaitTimeUs_{0};
 };
 
+struct SpillStats;
+
 /// Represents a spill file that is first in write mode and then
 /// turns into a source of spilled RowVectors. Owns a file system file that
 /// contains the spilled data and is live for the duration of 'this'.
@@ -70,7 +118,9 @@ class SpillFile {
       const std::vector<CompareFlags>& sortCompareFlags,
       const std::string& path,
       common::CompressionKind compressionKind,
-      memory::MemoryPool* pool);
+      memory::MemoryPool* pool,
+      SpillFormat format = SpillFormat::kPresto,
+      SpillDirectorySet* directories = nullptr);
 
   int32_t numSortingKeys() const {
     return numSortingKeys_;
@@ -100,7 +150,11 @@ class SpillFile {
 
   /// Prepares 'this' for reading. Positions the read at the first row of
   /// content. The caller must call output() and finishWrite() before this.
-  void startRead();
+  /// If 'executor' is set, reads ahead on it. If 'stats' is set, the time
+  /// spent waiting for reads is added to it once all of the file is read.
+  void startRead(
+      folly::Executor* executor = nullptr,
+      folly::Synchronized<SpillStats>* stats = nullptr);
 
   bool nextBatch(RowVectorPtr& rowVector);
 
@@ -122,23 +176,42 @@ class SpillFile {
     return path_;
   }
 
+  /// Returns the index of the directory in 'directories' passed to the
+  /// constructor that 'this' is in, or -1 if no 'directories' were passed.
+  int32_t directoryIndex() const {
+    return directoryIndex_;
+  }
+
  private:
   static std::atomic<int32_t> ordinalCounter_;
 
+  // Reads the next SpillFormat::kCompactRow batch from 'input_'.
+  void readCompactRowBatch(RowVectorPtr& rowVector);
+
   // Type of 'rowVector_'. Needed for setting up writing.
   const RowTypePtr type_;
   const int32_t numSortingKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
   // Ordinal number used for making a label for debugging.
   const int32_t ordinal_;
-  const std::string path_;
+  // Set in the constructor after picking the directory if there are multiple
+  // spill directories.
+  std::string path_;
   const common::CompressionKind compressionKind_;
   memory::MemoryPool* const pool_;
+  const SpillFormat format_;
+  int32_t directoryIndex_{-1};
 
   // Byte size of the backing file. Set when finishing writing.
   uint64_t fileSize_ = 0;
   std::unique_ptr<WriteFile> output_;
   std::unique_ptr<SpillInput> input_;
+  // Set by startRead() to receive the read wait time.
+  folly::Synchronized<SpillStats>* readStats_{nullptr};
+  // Set when all of the file has been read and the read wait time reported.
+  bool readFinished_{false};
+  // Holds the serialized rows of the last SpillFormat::kCompactRow batch.
+  BufferPtr batchBuffer_;
 };
 
 /// Provides the fine-grained spill execution stats.
@@ -171,6 +244,8 @@ struct SpillStats {
   uint64_t spillFlushTimeUs{0};
   /// The time spent on writing spilled rows to disk.
   uint64_t spillWriteTimeUs{0};
+  /// The time spent waiting for reads of spilled data when reading it back.
+  uint64_t spillReadWaitTimeUs{0};
 
   SpillStats(
       uint64_t _spillRuns,
@@ -184,7 +259,8 @@ struct SpillStats {
       uint64_t _spillSerializationTimeUs,
       uint64_t _spillDiskWrites,
       uint64_t _spillFlushTimeUs,
-      uint64_t _spillWriteTimeUs);
+      uint64_t _spillWriteTimeUs,
+      uint64_t _spillReadWaitTimeUs = 0);
 
   SpillStats() = default;
 
@@ -233,7 +309,9 @@ class SpillFileList {
       uint64_t targetFileSize,
       common::CompressionKind compressionKind,
       memory::MemoryPool* pool,
-      folly::Synchronized<SpillStats>* stats);
+      folly::Synchronized<SpillStats>* stats,
+      SpillFormat format = SpillFormat::kPresto,
+      SpillDirectorySet* directories = nullptr);
 
   /// Adds 'rows' for the positions in 'indices' into 'this'. The indices
   /// must produce a view where the rows are sorted if sorting is desired.
@@ -283,6 +361,8 @@ class SpillFileList {
   const common::CompressionKind compressionKind_;
   memory::MemoryPool* const pool_;
   folly::Synchronized<SpillStats>* const stats_;
+  const SpillFormat format_;
+  SpillDirectorySet* const directories_;
   std::unique_ptr<VectorStreamGroup> batch_;
   SpillFiles files_;
 };
@@ -383,8 +463,10 @@ class SpillMergeStream : public MergeStream {
 class FileSpillMergeStream : public SpillMergeStream {
  public:
   static std::unique_ptr<SpillMergeStream> create(
-      std::unique_ptr<SpillFile> spillFile) {
-    spillFile->startRead();
+      std::unique_ptr<SpillFile> spillFile,
+      folly::Executor* executor = nullptr,
+      folly::Synchronized<SpillStats>* stats = nullptr) {
+    spillFile->startRead(executor, stats);
     auto* spillStream = new FileSpillMergeStream(std::move(spillFile));
     spillStream->nextBatch();
     return std::unique_ptr<SpillMergeStream>(spillStream);
@@ -578,7 +660,10 @@ class SpillState {
       uint64_t targetFileSize,
       common::CompressionKind compressionKind,
       memory::MemoryPool* pool,
-      folly::Synchronized<SpillStats>* stats);
+      folly::Synchronized<SpillStats>* stats,
+      folly::Executor* readAheadExecutor = nullptr,
+      SpillFormat format = SpillFormat::kPresto,
+      SpillDirectorySet* directories = nullptr);
 
   /// Indicates if a given 'partition' has been spilled or not.
   bool isPartitionSpilled(int32_t partition) const {
@@ -602,6 +687,10 @@ class SpillState {
     return compressionKind_;
   }
 
+  SpillFormat format() const {
+    return format_;
+  }
+
   const std::vector<CompareFlags>& sortCompareFlags() const {
     return sortCompareFlags_;
   }
@@ -663,6 +752,11 @@ class SpillState {
   const common::CompressionKind compressionKind_;
   memory::MemoryPool* const pool_;
   folly::Synchronized<SpillStats>* const stats_;
+  // If set, the files are read ahead on this executor when merging.
+  folly::Executor* const readAheadExecutor_;
+  const SpillFormat format_;
+  // If set, spreads the spill files over multiple directories.
+  SpillDirectorySet* const directories_;
 
   // A set of spilled partition numbers.
   SpillPartitionNumSet spilledPartitionSet_;
@@ -698,6 +792,8 @@ void updateGlobalSpillWriteStats(
     uint64_t spilledBytes,
     uint64_t flushTimeUs,
     uint64_t writeTimeUs);
+/// Updates the time spent waiting for reads of spilled data.
+void updateGlobalSpillReadWaitTime(uint64_t timeUs);
 // Increment the spill memory bytes.
 void updateGlobalSpillMemoryBytes(uint64_t spilledInputBytes);
 
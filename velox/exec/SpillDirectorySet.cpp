@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/SpillDirectorySet.h"
+
+#include <limits>
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::exec {
+
+SpillDirectorySet::SpillDirectorySet(
+    std::vector<LocalDirectory> localDirectories,
+    std::string overflowDirectory)
+    : numLocalDirectories_(localDirectories.size()),
+      hasOverflow_(!overflowDirectory.empty()) {
+  VELOX_CHECK(
+      numLocalDirectories_ > 0 || hasOverflow_,
+      "No spill directory is given");
+  directories_.reserve(numLocalDirectories_ + (hasOverflow_ ? 1 : 0));
+  for (auto& local : localDirectories) {
+    VELOX_CHECK(!local.path.empty());
+    directories_.push_back({local.path, local.capacity, {local.path}});
+  }
+  if (hasOverflow_) {
+    directories_.push_back(
+        {overflowDirectory,
+         std::numeric_limits<uint64_t>::max(),
+         {overflowDirectory}});
+  }
+}
+
+std::string SpillDirectorySet::newFilePath(
+    const std::string& fileName,
+    int32_t& directoryIndex) {
+  std::lock_guard<std::mutex> l(mutex_);
+  int32_t best = -1;
+  uint64_t bestFree = 0;
+  for (auto i = 0; i < numLocalDirectories_; ++i) {
+    const auto& directory = directories_[i];
+    const auto free = directory.capacity -
+        std::min(directory.capacity, directory.stats.writtenBytes);
+    // Ties go to the directory with the least files, which stripes files
+    // round-robin over directories with equal free capacity.
+    if (best == -1 || free > bestFree ||
+        (free == bestFree &&
+         directory.stats.numFiles < directories_[best].stats.numFiles)) {
+      best = i;
+      bestFree = free;
+    }
+  }
+  if (hasOverflow_ && (best == -1 || bestFree == 0)) {
+    best = numLocalDirectories_;
+  }
+  directoryIndex = best;
+  auto& directory = directories_[best];
+  ++directory.stats.numFiles;
+  return fmt::format("{}/{}", directory.path, fileName);
+}
+
+void SpillDirectorySet::recordWrite(
+    int32_t directoryIndex,
+    uint64_t bytes,
+    uint64_t timeUs) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK_LT(directoryIndex, directories_.size());
+  auto& stats = directories_[directoryIndex].stats;
+  stats.writtenBytes += bytes;
+  stats.writeTimeUs += timeUs;
+}
+
+std::vector<SpillDirectorySet::DirectoryStats> SpillDirectorySet::stats()
+    const {
+  std::lock_guard<std::mutex> l(mutex_);
+  std::vector<DirectoryStats> result;
+  result.reserve(directories_.size());
+  for (const auto& directory : directories_) {
+    result.push_back(directory.stats);
+  }
+  return result;
+}
+
+} // namespace facebook::velox::exec
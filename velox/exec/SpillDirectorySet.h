@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace facebook::velox::exec {
+
+/// A set of directories that the spill files of a task are spread over. The
+/// local directories, e.g. one per local NVMe mount, each have a capacity in
+/// bytes. A new spill file goes to the local directory with the most free
+/// capacity, which stripes consecutive files round-robin over directories
+/// with equal free capacity. Once no local directory has free capacity, new
+/// files go to the overflow directory if there is one. The overflow directory
+/// can be on any registered file system, e.g. a remote object store, and has
+/// no capacity limit.
+///
+/// The capacity is checked when a file is created and the file is written
+/// to completion where it was created, so a directory can go over its
+/// capacity by up to one spill file per writer.
+///
+/// This object is thread-safe.
+class SpillDirectorySet {
+ public:
+  struct LocalDirectory {
+    std::string path;
+    /// The max number of bytes to spill into 'path'.
+    uint64_t capacity;
+  };
+
+  /// The write stats of one directory.
+  struct DirectoryStats {
+    std::string path;
+    uint64_t numFiles{0};
+    uint64_t writtenBytes{0};
+    uint64_t writeTimeUs{0};
+
+    /// Returns the write throughput in bytes per second.
+    double writeBytesPerSecond() const {
+      return writeTimeUs == 0 ? 0 : writtenBytes * 1'000'000.0 / writeTimeUs;
+    }
+  };
+
+  /// 'overflowDirectory' may be empty, in which case files go to the local
+  /// directory with the most free capacity even if all are full. At least one
+  /// directory must be given.
+  SpillDirectorySet(
+      std::vector<LocalDirectory> localDirectories,
+      std::string overflowDirectory = "");
+
+  /// Returns the number of directories including the overflow directory.
+  int32_t numDirectories() const {
+    return directories_.size();
+  }
+
+  /// Returns the path of the directory at 'index'. The overflow directory,
+  /// if any, is the last one.
+  const std::string& path(int32_t index) const {
+    return directories_[index].path;
+  }
+
+  /// Picks the directory for a new spill file named 'fileName'. Returns the
+  /// file path and sets 'directoryIndex' to the index of the directory to
+  /// pass to recordWrite().
+  std::string newFilePath(
+      const std::string& fileName,
+      int32_t& directoryIndex);
+
+  /// Records that 'bytes' were written in 'timeUs' to the directory at
+  /// 'directoryIndex'.
+  void recordWrite(int32_t directoryIndex, uint64_t bytes, uint64_t timeUs);
+
+  /// Returns the write stats of each directory, in directory order.
+  std::vector<DirectoryStats> stats() const;
+
+ private:
+  struct Directory {
+    std::string path;
+    // The capacity in bytes. Unlimited for the overflow directory.
+    uint64_t capacity;
+    DirectoryStats stats;
+  };
+
+  const int32_t numLocalDirectories_;
+  const bool hasOverflow_;
+
+  mutable std::mutex mutex_;
+  std::vector<Directory> directories_;
+};
+
+} // namespace facebook::velox::exec
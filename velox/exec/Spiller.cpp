@@ -39,7 +39,9 @@ Spiller::Spiller(
     uint64_t minSpillRunSize,
     common::CompressionKind compressionKind,
     memory::MemoryPool* pool,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    SpillFormat format,
+    SpillDirectorySet* directories)
     : Spiller(
           type,
           container,
@@ -53,7 +55,9 @@ Spiller::Spiller(
           minSpillRunSize,
           compressionKind,
           pool,
-          executor) {
+          executor,
+          format,
+          directories) {
   VELOX_CHECK_EQ(type_, Type::kOrderBy);
 }
 
@@ -66,7 +70,9 @@ Spiller::Spiller(
     uint64_t minSpillRunSize,
     common::CompressionKind compressionKind,
     memory::MemoryPool* pool,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    SpillFormat format,
+    SpillDirectorySet* directories)
     : Spiller(
           type,
           nullptr,
@@ -80,7 +86,9 @@ Spiller::Spiller(
           minSpillRunSize,
           compressionKind,
           pool,
-          executor) {
+          executor,
+          format,
+          directories) {
   VELOX_CHECK_EQ(type_, Type::kHashJoinProbe);
 }
 
@@ -97,7 +105,10 @@ Spiller::Spiller(
     uint64_t minSpillRunSize,
     common::CompressionKind compressionKind,
     memory::MemoryPool* pool,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    SpillFormat format,
+    SpillDirectorySet* directories,
+    bool coldPartitionsFirst)
     : type_(type),
       container_(container),
       executor_(executor),
@@ -106,6 +117,7 @@ Spiller::Spiller(
       bits_(bits),
       rowType_(std::move(rowType)),
       minSpillRunSize_(minSpillRunSize),
+      coldPartitionsFirst_(coldPartitionsFirst),
       state_(
           path,
           bits.numPartitions(),
@@ -114,7 +126,10 @@ Spiller::Spiller(
           targetFileSize,
           compressionKind,
           pool_,
-          &stats_) {
+          &stats_,
+          executor_,
+          format,
+          directories) {
   TestValue::adjust(
       "facebook::velox::exec::Spiller", const_cast<HashBitRange*>(&bits_));
 
@@ -125,6 +140,7 @@ Spiller::Spiller(
   for (int i = 0; i < state_.maxPartitions(); ++i) {
     spillRuns_.emplace_back(*pool_);
   }
+  lastNumRows_.resize(state_.maxPartitions(), 0);
 }
 
 void Spiller::extractSpill(folly::Range<char**> rows, RowVectorPtr& resultPtr) {
@@ -144,8 +160,7 @@ void Spiller::extractSpill(folly::Range<char**> rows, RowVectorPtr& resultPtr) {
 
   auto numKeys = types.size();
   for (auto i = 0; i < accumulators.size(); ++i) {
-    accumulators[i].aggregateForSpill()->extractAccumulators(
-        rows.data(), rows.size(), &result->childAt(i + numKeys));
+    accumulators[i].extractForSpill(rows, result->childAt(i + numKeys));
   }
 }
 
@@ -342,6 +357,8 @@ void Spiller::advanceSpill() {
       container_->clear();
     }
     run.rows.erase(run.rows.begin(), run.rows.begin() + numWritten);
+    lastNumRows_[partition] -=
+        std::min<uint64_t>(lastNumRows_[partition], numWritten);
     if (run.rows.empty()) {
       // Run ends, start with a new file next time.
       run.clear();
@@ -487,6 +504,13 @@ void Spiller::spill(uint32_t partition, const RowVectorPtr& spillVector) {
 int32_t Spiller::pickNextPartitionToSpill() {
   VELOX_DCHECK_EQ(spillRuns_.size(), state_.maxPartitions());
 
+  std::vector<SpillableStats> partitionStats(spillRuns_.size());
+  for (auto i = 0; i < spillRuns_.size(); ++i) {
+    partitionStats[i].numRows = spillRuns_[i].rows.size();
+    partitionStats[i].numBytes = spillRuns_[i].numBytes;
+    partitionStats[i].numNewRows = spillRuns_[i].numNewRows;
+  }
+
   // Sort the partitions based on spiller type to pick.
   std::vector<int32_t> partitionIndices(spillRuns_.size());
   std::iota(partitionIndices.begin(), partitionIndices.end(), 0);
@@ -506,7 +530,8 @@ int32_t Spiller::pickNextPartitionToSpill() {
             return false;
           }
         }
-        return spillRuns_[lhs].numBytes > spillRuns_[rhs].numBytes;
+        return spillBefore(
+            partitionStats[lhs], partitionStats[rhs], coldPartitionsFirst_);
       });
   for (auto partition : partitionIndices) {
     if (pendingSpillPartitions_.count(partition) != 0) {
@@ -604,10 +629,35 @@ void Spiller::fillSpillRuns(SpillRows* rowsFromNonSpillingPartitions) {
         break;
       }
     }
+    if (rowsFromNonSpillingPartitions == nullptr) {
+      for (auto partition = 0; partition < spillRuns_.size(); ++partition) {
+        auto& run = spillRuns_[partition];
+        run.numNewRows = run.rows.size() -
+            std::min<uint64_t>(run.rows.size(), lastNumRows_[partition]);
+        lastNumRows_[partition] = run.rows.size();
+      }
+    }
   }
   updateSpillFillTime(execTimeUs);
 }
 
+// static
+bool Spiller::spillBefore(
+    const SpillableStats& lhs,
+    const SpillableStats& rhs,
+    bool coldFirst) {
+  if (coldFirst) {
+    // Compare the fractions of new rows, numNewRows / numRows, without
+    // dividing.
+    const auto lhsNew = static_cast<__int128_t>(lhs.numNewRows) * rhs.numRows;
+    const auto rhsNew = static_cast<__int128_t>(rhs.numNewRows) * lhs.numRows;
+    if (lhsNew != rhsNew) {
+      return lhsNew < rhsNew;
+    }
+  }
+  return lhs.numBytes > rhs.numBytes;
+}
+
 void Spiller::clearNonSpillingRuns() {
   for (auto partition = 0; partition < spillRuns_.size(); ++partition) {
     if (pendingSpillPartitions_.count(partition) == 0) {
@@ -625,7 +675,53 @@ std::string Spiller::toString() const {
       finalized_);
 }
 
-int32_t Spiller::Config::joinSpillLevel(uint8_t startBitOffset) const {
+uint8_t SpillConfig::joinPartitionBitsForLevel(int32_t level) const {
+  if (!joinAdaptivePartitionBits) {
+    return joinPartitionBits;
+  }
+  return std::max<int32_t>(
+      joinPartitionBits,
+      std::min<int32_t>(
+          joinPartitionBits + level, kMaxAdaptiveJoinPartitionBits));
+}
+
+int32_t SpillConfig::adaptiveJoinSpillLevel(uint8_t startBitOffset) const {
+  VELOX_CHECK(joinAdaptivePartitionBits);
+  int32_t level = 0;
+  int32_t levelBitOffset = startPartitionBit;
+  while (levelBitOffset < startBitOffset) {
+    levelBitOffset += joinPartitionBitsForLevel(level);
+    ++level;
+  }
+  return levelBitOffset == startBitOffset ? level : -1;
+}
+
+uint8_t SpillConfig::joinPartitionBitsAt(uint8_t startBitOffset) const {
+  if (!joinAdaptivePartitionBits) {
+    return joinPartitionBits;
+  }
+  return joinPartitionBitsForLevel(joinSpillLevel(startBitOffset));
+}
+
+int32_t SpillConfig::joinSpillLevel(uint8_t startBitOffset) const {
+  if (joinAdaptivePartitionBits) {
+    VELOX_CHECK_GE(
+        startBitOffset,
+        startPartitionBit,
+        "startBitOffset:{} startPartitionBit:{}",
+        startBitOffset,
+        startPartitionBit);
+    const auto level = adaptiveJoinSpillLevel(startBitOffset);
+    VELOX_CHECK_GE(
+        level, 0, "startBitOffset:{} is not a spill level", startBitOffset);
+    VELOX_CHECK_LE(
+        startBitOffset + joinPartitionBitsForLevel(level),
+        64,
+        "startBitOffset:{} numPartitionsBits:{}",
+        startBitOffset,
+        joinPartitionBitsForLevel(level));
+    return level;
+  }
   const auto numPartitionBits = joinPartitionBits;
   VELOX_CHECK_LE(
       startBitOffset + numPartitionBits,
@@ -644,7 +740,15 @@ int32_t Spiller::Config::joinSpillLevel(uint8_t startBitOffset) const {
   return deltaBits / numPartitionBits;
 }
 
-bool Spiller::Config::exceedJoinSpillLevelLimit(uint8_t startBitOffset) const {
+bool SpillConfig::exceedJoinSpillLevelLimit(uint8_t startBitOffset) const {
+  if (joinAdaptivePartitionBits) {
+    const auto level = adaptiveJoinSpillLevel(startBitOffset);
+    if (level < 0 ||
+        startBitOffset + joinPartitionBitsForLevel(level) > 64) {
+      return true;
+    }
+    return maxSpillLevel != -1 && level > maxSpillLevel;
+  }
   if (startBitOffset + joinPartitionBits > 64) {
     return true;
   }
@@ -684,6 +788,7 @@ void Spiller::fillSpillRuns(std::vector<SpillableStats>& statsList) {
     const auto& spillRun = spillRuns_[partitionNum];
     statsList[partitionNum].numBytes += spillRun.numBytes;
     statsList[partitionNum].numRows += spillRun.rows.size();
+    statsList[partitionNum].numNewRows += spillRun.numNewRows;
   }
 }
 
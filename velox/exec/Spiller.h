@@ -18,9 +18,141 @@
 #include "velox/common/compression/Compression.h"
 #include "velox/exec/HashBitRange.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spill.h"
 
 namespace facebook::velox::exec {
 
+/// Specifies the config for spilling.
+struct SpillConfig {
+  SpillConfig(
+      const std::string& _filePath,
+      uint64_t _maxFileSize,
+      uint64_t _minSpillRunSize,
+      folly::Executor* _executor,
+      int32_t _spillableReservationGrowthPct,
+      uint8_t _startPartitionBit,
+      uint8_t _joinPartitionBits,
+      uint8_t _aggregationPartitionBits,
+      int32_t _maxSpillLevel,
+      int32_t _testSpillPct,
+      const std::string& _compressionKind,
+      bool _joinAdaptivePartitionBits = false,
+      const std::string& _format = "presto",
+      SpillDirectorySet* _directories = nullptr,
+      bool _spillColdPartitionsFirst = false)
+      : filePath(_filePath),
+        maxFileSize(
+            _maxFileSize == 0 ? std::numeric_limits<int64_t>::max()
+                              : _maxFileSize),
+        minSpillRunSize(_minSpillRunSize),
+        executor(_executor),
+        spillableReservationGrowthPct(_spillableReservationGrowthPct),
+        startPartitionBit(_startPartitionBit),
+        joinPartitionBits(_joinPartitionBits),
+        aggregationPartitionBits(_aggregationPartitionBits),
+        maxSpillLevel(_maxSpillLevel),
+        testSpillPct(_testSpillPct),
+        compressionKind(common::stringToCompressionKind(_compressionKind)),
+        joinAdaptivePartitionBits(_joinAdaptivePartitionBits),
+        format(stringToSpillFormat(_format)),
+        directories(_directories),
+        spillColdPartitionsFirst(_spillColdPartitionsFirst) {}
+
+  /// The max number of hash join spill partition bits used by a recursive
+  /// spill level if 'joinAdaptivePartitionBits' is set.
+  static constexpr uint8_t kMaxAdaptiveJoinPartitionBits = 6;
+
+  /// Returns the hash join spilling level with given 'startBitOffset'.
+  ///
+  /// NOTE: we advance (or right shift) the partition bit offset when goes to
+  /// the next level of recursive spilling.
+  int32_t joinSpillLevel(uint8_t startBitOffset) const;
+
+  /// Checks if the given 'startBitOffset' has exceeded the max hash join
+  /// spill limit.
+  bool exceedJoinSpillLevelLimit(uint8_t startBitOffset) const;
+
+  /// Returns the number of hash join spill partition bits used by the spill
+  /// level starting at 'startBitOffset'. This is 'joinPartitionBits' unless
+  /// 'joinAdaptivePartitionBits' is set.
+  uint8_t joinPartitionBitsAt(uint8_t startBitOffset) const;
+
+  /// Filesystem path for spill files.
+  std::string filePath;
+
+  /// The max spill file size. If it is zero, there is no limit on the spill
+  /// file size.
+  uint64_t maxFileSize;
+
+  /// The min spill run size (bytes) limit used to select partitions for
+  /// spilling. The spiller tries to spill a previously spilled partitions if
+  /// its data size exceeds this limit, otherwise it spills the partition with
+  /// most data. If the limit is zero, then the spiller always spill a
+  /// previously spilled partition if it has any data. This is to avoid spill
+  /// from a partition wigth a small amount of data which might result in
+  /// generating too many small spilled files.
+  uint64_t minSpillRunSize;
+
+  // Executor for spilling. If nullptr spilling writes on the Driver's thread.
+  folly::Executor* executor; // Not owned.
+
+  // The spillable memory reservation growth percentage of the current
+  // reservation size.
+  int32_t spillableReservationGrowthPct;
+
+  // Used to calculate spill partition number.
+  uint8_t startPartitionBit;
+
+  // Used to calculate the spill hash partition number for hash join with
+  // 'startPartitionBit'.
+  uint8_t joinPartitionBits;
+
+  // Used to calculate the spill hash partition number for aggregation with
+  // 'startPartitionBit'.
+  uint8_t aggregationPartitionBits;
+
+  // The max allowed spilling level with zero being the initial spilling
+  // level. This only applies for hash build spilling which needs recursive
+  // spilling when the build table is too big. If it is set to -1, then there
+  // is no limit and then some extreme large query might run out of spilling
+  // partition bits at the end.
+  int32_t maxSpillLevel;
+
+  // Percentage of input batches to be spilled for testing. 0 means no
+  // spilling for test.
+  int32_t testSpillPct;
+
+  // CompressionKind when spilling, CompressionKind_NONE means no compression.
+  common::CompressionKind compressionKind;
+
+  // If true, each recursive hash join spill level uses one more partition
+  // bit than its parent level, up to 'kMaxAdaptiveJoinPartitionBits'. A
+  // partition that still doesn't fit in memory after being restored is
+  // usually skewed, so a wider fan-out gets it under the memory limit in
+  // fewer levels than the fixed 'joinPartitionBits' split.
+  bool joinAdaptivePartitionBits;
+
+  // The serialization format of the spill files.
+  SpillFormat format;
+
+  // If set, the spill files are spread over these directories instead of
+  // being put next to 'filePath'. Not owned.
+  SpillDirectorySet* directories;
+
+  // If true, spills the partitions with the fewest rows inserted since the
+  // previous spill relative to their size first. Otherwise spills the
+  // partitions with the most data first.
+  bool spillColdPartitionsFirst;
+
+ private:
+  // Returns the number of partition bits used by recursive spill 'level'.
+  uint8_t joinPartitionBitsForLevel(int32_t level) const;
+
+  // Returns the spill level starting at 'startBitOffset' if the adaptive
+  // partition bits are used, or -1 if no level starts at 'startBitOffset'.
+  int32_t adaptiveJoinSpillLevel(uint8_t startBitOffset) const;
+};
+
 /// Manages spilling data from a RowContainer.
 class Spiller {
  public:
@@ -38,92 +170,7 @@ class Spiller {
   static constexpr int kNumTypes = 4;
   static std::string typeName(Type);
 
-  // Specifies the config for spilling.
-  struct Config {
-    Config(
-        const std::string& _filePath,
-        uint64_t _maxFileSize,
-        uint64_t _minSpillRunSize,
-        folly::Executor* _executor,
-        int32_t _spillableReservationGrowthPct,
-        uint8_t _startPartitionBit,
-        uint8_t _joinPartitionBits,
-        uint8_t _aggregationPartitionBits,
-        int32_t _maxSpillLevel,
-        int32_t _testSpillPct,
-        const std::string& _compressionKind)
-        : filePath(_filePath),
-          maxFileSize(
-              _maxFileSize == 0 ? std::numeric_limits<int64_t>::max()
-                                : _maxFileSize),
-          minSpillRunSize(_minSpillRunSize),
-          executor(_executor),
-          spillableReservationGrowthPct(_spillableReservationGrowthPct),
-          startPartitionBit(_startPartitionBit),
-          joinPartitionBits(_joinPartitionBits),
-          aggregationPartitionBits(_aggregationPartitionBits),
-          maxSpillLevel(_maxSpillLevel),
-          testSpillPct(_testSpillPct),
-          compressionKind(common::stringToCompressionKind(_compressionKind)) {}
-
-    /// Returns the hash join spilling level with given 'startBitOffset'.
-    ///
-    /// NOTE: we advance (or right shift) the partition bit offset when goes to
-    /// the next level of recursive spilling.
-    int32_t joinSpillLevel(uint8_t startBitOffset) const;
-
-    /// Checks if the given 'startBitOffset' has exceeded the max hash join
-    /// spill limit.
-    bool exceedJoinSpillLevelLimit(uint8_t startBitOffset) const;
-
-    /// Filesystem path for spill files.
-    std::string filePath;
-
-    /// The max spill file size. If it is zero, there is no limit on the spill
-    /// file size.
-    uint64_t maxFileSize;
-
-    /// The min spill run size (bytes) limit used to select partitions for
-    /// spilling. The spiller tries to spill a previously spilled partitions if
-    /// its data size exceeds this limit, otherwise it spills the partition with
-    /// most data. If the limit is zero, then the spiller always spill a
-    /// previously spilled partition if it has any data. This is to avoid spill
-    /// from a partition wigth a small amount of data which might result in
-    /// generating too many small spilled files.
-    uint64_t minSpillRunSize;
-
-    // Executor for spilling. If nullptr spilling writes on the Driver's thread.
-    folly::Executor* executor; // Not owned.
-
-    // The spillable memory reservation growth percentage of the current
-    // reservation size.
-    int32_t spillableReservationGrowthPct;
-
-    // Used to calculate spill partition number.
-    uint8_t startPartitionBit;
-
-    // Used to calculate the spill hash partition number for hash join with
-    // 'startPartitionBit'.
-    uint8_t joinPartitionBits;
-
-    // Used to calculate the spill hash partition number for aggregation with
-    // 'startPartitionBit'.
-    uint8_t aggregationPartitionBits;
-
-    // The max allowed spilling level with zero being the initial spilling
-    // level. This only applies for hash build spilling which needs recursive
-    // spilling when the build table is too big. If it is set to -1, then there
-    // is no limit and then some extreme large query might run out of spilling
-    // partition bits at the end.
-    int32_t maxSpillLevel;
-
-    // Percentage of input batches to be spilled for testing. 0 means no
-    // spilling for test.
-    int32_t testSpillPct;
-
-    // CompressionKind when spilling, CompressionKind_NONE means no compression.
-    common::CompressionKind compressionKind;
-  };
+  using Config = SpillConfig;
 
   using SpillRows = std::vector<char*, memory::StlAllocator<char*>>;
 
@@ -141,7 +188,9 @@ class Spiller {
       uint64_t minSpillRunSize,
       common::CompressionKind compressionKind,
       memory::MemoryPool* pool,
-      folly::Executor* executor);
+      folly::Executor* executor,
+      SpillFormat format = SpillFormat::kPresto,
+      SpillDirectorySet* directories = nullptr);
 
   Spiller(
       Type type,
@@ -152,7 +201,9 @@ class Spiller {
       uint64_t minSpillRunSize,
       common::CompressionKind compressionKind,
       memory::MemoryPool* pool,
-      folly::Executor* executor);
+      folly::Executor* executor,
+      SpillFormat format = SpillFormat::kPresto,
+      SpillDirectorySet* directories = nullptr);
 
   Spiller(
       Type type,
@@ -167,7 +218,10 @@ class Spiller {
       uint64_t minSpillRunSize,
       common::CompressionKind compressionKind,
       memory::MemoryPool* pool,
-      folly::Executor* executor);
+      folly::Executor* executor,
+      SpillFormat format = SpillFormat::kPresto,
+      SpillDirectorySet* directories = nullptr,
+      bool coldPartitionsFirst = false);
 
   /// Spills rows from 'this' until there are under 'targetRows' rows
   /// and 'targetBytes' of allocated variable length space in use. spill()
@@ -204,14 +258,26 @@ class Spiller {
   struct SpillableStats {
     int64_t numRows = 0;
     int64_t numBytes = 0;
+    /// The number of rows inserted since the previous fill of spill runs.
+    int64_t numNewRows = 0;
 
     inline SpillableStats& operator+=(const SpillableStats& other) {
       this->numRows += other.numRows;
       this->numBytes += other.numBytes;
+      this->numNewRows += other.numNewRows;
       return *this;
     }
   };
 
+  /// Returns true if a partition with 'lhs' spillable stats is to be spilled
+  /// before one with 'rhs'. If 'coldFirst' is true, the partition with the
+  /// smaller fraction of rows inserted since the previous spill goes first.
+  /// Otherwise, or on a tie, the partition with more bytes goes first.
+  static bool spillBefore(
+      const SpillableStats& lhs,
+      const SpillableStats& rhs,
+      bool coldFirst);
+
   /// Invoked to fill spill runs on all partitions and accumulate the spillable
   /// stats in 'statsList' by partition number.
   void fillSpillRuns(std::vector<SpillableStats>& statsList);
@@ -310,12 +376,16 @@ class Spiller {
     SpillRows rows;
     // The total byte size of rows referenced from 'rows'.
     uint64_t numBytes{0};
+    // The number of rows in 'rows' inserted since the previous fill of spill
+    // runs.
+    uint64_t numNewRows{0};
     // True if 'rows' are sorted on their key.
     bool sorted{false};
 
     void clear() {
       rows.clear();
       numBytes = 0;
+      numNewRows = 0;
       sorted = false;
     }
 
@@ -392,6 +462,7 @@ class Spiller {
   const HashBitRange bits_;
   const RowTypePtr rowType_;
   const uint64_t minSpillRunSize_;
+  const bool coldPartitionsFirst_;
 
   // True if all rows of spilling partitions are in 'spillRuns_', so
   // that one can start reading these back. This means that the rows
@@ -407,5 +478,10 @@ class Spiller {
 
   // One spill run for each partition of spillable data.
   std::vector<SpillRun> spillRuns_;
+
+  // The number of rows of each partition left in 'container_' after the
+  // previous fill of spill runs and the spills since. Used to tell the
+  // number of rows inserted into a partition since then.
+  std::vector<uint64_t> lastNumRows_;
 };
 } // namespace facebook::velox::exec
@@ -16,6 +16,7 @@
 #include "velox/exec/StreamingAggregation.h"
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/vector/LazyVector.h"
 
 namespace facebook::velox::exec {
 
@@ -55,18 +56,17 @@ StreamingAggregation::StreamingAggregation(
   for (auto i = 0; i < numAggregates; i++) {
     const auto& aggregate = aggregationNode->aggregates()[i];
 
-    std::vector<column_index_t> channels;
-    std::vector<VectorPtr> constants;
+    AggregateInfo info;
     std::vector<TypePtr> argTypes;
     for (auto& arg : aggregate.call->inputs()) {
       argTypes.push_back(arg->type());
-      channels.push_back(exprToChannel(arg.get(), inputType));
-      if (channels.back() == kConstantChannel) {
+      info.inputs.push_back(exprToChannel(arg.get(), inputType));
+      if (info.inputs.back() == kConstantChannel) {
         auto constant = static_cast<const core::ConstantTypedExpr*>(arg.get());
-        constants.push_back(BaseVector::createConstant(
+        info.constantInputs.push_back(BaseVector::createConstant(
             constant->type(), constant->value(), 1, operatorCtx_->pool()));
       } else {
-        constants.push_back(nullptr);
+        info.constantInputs.push_back(nullptr);
       }
     }
 
@@ -77,14 +77,28 @@ StreamingAggregation::StreamingAggregation(
     }
 
     const auto& aggResultType = outputType_->childAt(numKeys + i);
-    aggregates_.push_back(Aggregate::create(
+    info.function = Aggregate::create(
         aggregate.call->name(),
         aggregationNode->step(),
         argTypes,
         aggResultType,
-        driverCtx->queryConfig()));
-    args_.push_back(channels);
-    constantArgs_.push_back(constants);
+        driverCtx->queryConfig());
+    info.distinct = aggregate.distinct;
+    info.output = numKeys + i;
+    aggregates_.push_back(std::move(info));
+  }
+
+  distinctAggregations_.reserve(numAggregates);
+  for (auto& aggregate : aggregates_) {
+    if (aggregate.distinct) {
+      VELOX_USER_CHECK(
+          !isPartialOutput(step_) && isRawInput(step_),
+          "Partial aggregations over distinct inputs are not supported");
+      distinctAggregations_.push_back(
+          DistinctAggregations::create({&aggregate}, inputType, pool()));
+    } else {
+      distinctAggregations_.push_back(nullptr);
+    }
   }
 
   if (aggregationNode->ignoreNullKeys()) {
@@ -96,7 +110,12 @@ StreamingAggregation::StreamingAggregation(
   std::vector<Accumulator> accumulators;
   accumulators.reserve(aggregates_.size());
   for (auto& aggregate : aggregates_) {
-    accumulators.push_back(Accumulator{aggregate.get()});
+    accumulators.push_back(Accumulator{aggregate.function.get()});
+  }
+  for (const auto& aggregation : distinctAggregations_) {
+    if (aggregation != nullptr) {
+      accumulators.push_back(aggregation->accumulator());
+    }
   }
 
   rows_ = std::make_unique<RowContainer>(
@@ -111,15 +130,30 @@ StreamingAggregation::StreamingAggregation(
       pool());
 
   for (auto i = 0; i < aggregates_.size(); ++i) {
-    aggregates_[i]->setAllocator(&rows_->stringAllocator());
+    aggregates_[i].function->setAllocator(&rows_->stringAllocator());
 
     const auto rowColumn = rows_->columnAt(numKeys + i);
-    aggregates_[i]->setOffsets(
+    aggregates_[i].function->setOffsets(
         rowColumn.offset(),
         rowColumn.nullByte(),
         rowColumn.nullMask(),
         rows_->rowSizeOffset());
   }
+
+  auto column = numKeys + aggregates_.size();
+  for (const auto& aggregation : distinctAggregations_) {
+    if (aggregation != nullptr) {
+      aggregation->setAllocator(&rows_->stringAllocator());
+
+      const auto rowColumn = rows_->columnAt(column);
+      aggregation->setOffsets(
+          rowColumn.offset(),
+          rowColumn.nullByte(),
+          rowColumn.nullMask(),
+          rows_->rowSizeOffset());
+      ++column;
+    }
+  }
 }
 
 void StreamingAggregation::close() {
@@ -149,6 +183,49 @@ bool equalKeys(
 
   return true;
 }
+
+// Sets the bit in 'boundaries' for each row in [1, size) whose value of
+// 'decoded' differs from the previous row. Nulls are equal to each other and
+// differ from all values.
+template <typename T>
+void markBoundaries(
+    const DecodedVector& decoded,
+    vector_size_t size,
+    uint64_t* boundaries) {
+  if (decoded.isIdentityMapping() && !decoded.mayHaveNulls()) {
+    const auto* values = decoded.data<T>();
+    for (auto row = 1; row < size; ++row) {
+      if (values[row] != values[row - 1]) {
+        bits::setBit(boundaries, row);
+      }
+    }
+    return;
+  }
+  for (auto row = 1; row < size; ++row) {
+    const bool isNull = decoded.isNullAt(row);
+    if (isNull != decoded.isNullAt(row - 1) ||
+        (!isNull && decoded.valueAt<T>(row) != decoded.valueAt<T>(row - 1))) {
+      bits::setBit(boundaries, row);
+    }
+  }
+}
+
+// Same as above for any type, comparing values with equalValueAt().
+void markBoundariesGeneric(
+    const DecodedVector& decoded,
+    vector_size_t size,
+    uint64_t* boundaries) {
+  const auto* base = decoded.base();
+  for (auto row = 1; row < size; ++row) {
+    const bool isNull = decoded.isNullAt(row);
+    if (isNull != decoded.isNullAt(row - 1) ||
+        (!isNull &&
+         !base->equalValueAt(
+             base, decoded.index(row), decoded.index(row - 1)))) {
+      bits::setBit(boundaries, row);
+    }
+  }
+}
 } // namespace
 
 char* StreamingAggregation::startNewGroup(vector_size_t index) {
@@ -180,10 +257,14 @@ RowVectorPtr StreamingAggregation::createOutput(size_t numGroups) {
     rows_->extractColumn(groups_.data(), numGroups, i, output->childAt(i));
   }
 
-  auto numKeys = groupingKeys_.size();
   for (auto i = 0; i < aggregates_.size(); ++i) {
-    auto& aggregate = aggregates_[i];
-    auto& result = output->childAt(numKeys + i);
+    if (distinctAggregations_[i] != nullptr) {
+      distinctAggregations_[i]->extractValues(
+          folly::Range<char**>(groups_.data(), numGroups), output);
+      continue;
+    }
+    auto& aggregate = aggregates_[i].function;
+    auto& result = output->childAt(aggregates_[i].output);
     if (isPartialOutput(step_)) {
       aggregate->extractAccumulators(groups_.data(), numGroups, &result);
     } else {
@@ -194,42 +275,70 @@ RowVectorPtr StreamingAggregation::createOutput(size_t numGroups) {
   return output;
 }
 
-void StreamingAggregation::assignGroups() {
-  auto numInput = input_->size();
-
-  inputGroups_.resize(numInput);
+void StreamingAggregation::computeGroupBoundaries() {
+  const auto numInput = input_->size();
+  groupBoundaries_.assign(bits::nwords(numInput), 0);
+  auto* boundaries = groupBoundaries_.data();
+
+  // The first row starts a group unless it continues the last group of the
+  // previous batch.
+  if (!prevInput_ ||
+      !equalKeys(
+          groupingKeys_, prevInput_, prevInput_->size() - 1, input_, 0)) {
+    bits::setBit(boundaries, 0);
+  }
 
-  // Look for the end of the last group.
-  vector_size_t index = 0;
-  if (prevInput_) {
-    auto prevIndex = prevInput_->size() - 1;
-    auto* prevGroup = groups_[numGroups_ - 1];
-    for (; index < numInput; ++index) {
-      if (equalKeys(groupingKeys_, prevInput_, prevIndex, input_, index)) {
-        inputGroups_[index] = prevGroup;
-      } else {
+  for (auto i = 0; i < groupingKeys_.size(); ++i) {
+    auto& decoded = decodedKeys_[i];
+    decoded.decode(*input_->childAt(groupingKeys_[i]), inputRows_);
+    // Floating point keys go through equalValueAt() to compare NaNs as equal.
+    switch (decoded.base()->typeKind()) {
+      case TypeKind::TINYINT:
+        markBoundaries<int8_t>(decoded, numInput, boundaries);
         break;
-      }
+      case TypeKind::SMALLINT:
+        markBoundaries<int16_t>(decoded, numInput, boundaries);
+        break;
+      case TypeKind::INTEGER:
+        markBoundaries<int32_t>(decoded, numInput, boundaries);
+        break;
+      case TypeKind::BIGINT:
+        markBoundaries<int64_t>(decoded, numInput, boundaries);
+        break;
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        markBoundaries<StringView>(decoded, numInput, boundaries);
+        break;
+      default:
+        markBoundariesGeneric(decoded, numInput, boundaries);
     }
   }
+}
 
-  if (index < numInput) {
-    for (auto i = 0; i < groupingKeys_.size(); ++i) {
-      decodedKeys_[i].decode(*input_->childAt(groupingKeys_[i]), inputRows_);
-    }
+void StreamingAggregation::assignGroups() {
+  const auto numInput = input_->size();
 
-    auto* newGroup = startNewGroup(index);
-    inputGroups_[index] = newGroup;
+  computeGroupBoundaries();
 
-    for (auto i = index + 1; i < numInput; ++i) {
-      if (equalKeys(groupingKeys_, input_, index, input_, i)) {
-        inputGroups_[i] = inputGroups_[index];
-      } else {
-        newGroup = startNewGroup(i);
-        inputGroups_[i] = newGroup;
-        index = i;
-      }
-    }
+  runStarts_.clear();
+  runGroups_.clear();
+  if (!bits::isBitSet(groupBoundaries_.data(), 0)) {
+    runStarts_.push_back(0);
+    runGroups_.push_back(groups_[numGroups_ - 1]);
+  }
+  bits::forEachSetBit(
+      groupBoundaries_.data(), 0, numInput, [&](vector_size_t row) {
+        runStarts_.push_back(row);
+        runGroups_.push_back(startNewGroup(row));
+      });
+  runStarts_.push_back(numInput);
+
+  inputGroups_.resize(numInput);
+  for (auto i = 0; i < runGroups_.size(); ++i) {
+    std::fill(
+        inputGroups_.begin() + runStarts_[i],
+        inputGroups_.begin() + runStarts_[i + 1],
+        runGroups_[i]);
   }
 }
 
@@ -243,20 +352,29 @@ const SelectivityVector& StreamingAggregation::getSelectivityVector(
 
 void StreamingAggregation::evaluateAggregates() {
   for (auto i = 0; i < aggregates_.size(); ++i) {
-    auto& aggregate = aggregates_[i];
+    const auto& rows = getSelectivityVector(i);
+
+    if (distinctAggregations_[i] != nullptr) {
+      if (rows.hasSelections()) {
+        distinctAggregations_[i]->addInput(inputGroups_.data(), input_, rows);
+      }
+      continue;
+    }
 
+    auto& aggregate = aggregates_[i].function;
+    const auto& inputs = aggregates_[i].inputs;
     std::vector<VectorPtr> args;
-    for (auto j = 0; j < args_[i].size(); ++j) {
-      if (args_[i][j] == kConstantChannel) {
-        args.push_back(constantArgs_[i][j]);
+    for (auto j = 0; j < inputs.size(); ++j) {
+      if (inputs[j] == kConstantChannel) {
+        args.push_back(aggregates_[i].constantInputs[j]);
       } else {
-        args.push_back(input_->childAt(args_[i][j]));
+        args.push_back(input_->childAt(inputs[j]));
       }
     }
 
-    const auto& rows = getSelectivityVector(i);
-
-    if (isRawInput(step_)) {
+    if (input_->size() >= kMinAverageRunLength * runGroups_.size()) {
+      addInputByRuns(*aggregate, rows, args);
+    } else if (isRawInput(step_)) {
       aggregate->addRawInput(inputGroups_.data(), rows, args, false);
     } else {
       aggregate->addIntermediateResults(inputGroups_.data(), rows, args, false);
@@ -264,6 +382,40 @@ void StreamingAggregation::evaluateAggregates() {
   }
 }
 
+void StreamingAggregation::addInputByRuns(
+    Aggregate& aggregate,
+    const SelectivityVector& rows,
+    std::vector<VectorPtr>& args) {
+  // Lazy vectors can be loaded only once.
+  for (auto& arg : args) {
+    LazyVector::ensureLoadedRows(arg, rows);
+  }
+
+  runRows_.resizeFill(input_->size(), false);
+  for (auto i = 0; i < runGroups_.size(); ++i) {
+    const auto begin = std::max(runStarts_[i], rows.begin());
+    const auto end = std::min(runStarts_[i + 1], rows.end());
+    if (begin >= end) {
+      continue;
+    }
+    runRows_.setValidRange(begin, end, true);
+    if (!rows.isAllSelected()) {
+      bits::andBits(
+          runRows_.asMutableRange().bits(), rows.asRange().bits(), begin, end);
+    }
+    runRows_.updateBounds();
+    if (runRows_.hasSelections()) {
+      if (isRawInput(step_)) {
+        aggregate.addSingleGroupRawInput(runGroups_[i], runRows_, args, false);
+      } else {
+        aggregate.addSingleGroupIntermediateResults(
+            runGroups_[i], runRows_, args, false);
+      }
+    }
+    runRows_.setValidRange(begin, end, false);
+  }
+}
+
 bool StreamingAggregation::isFinished() {
   return noMoreInput_ && input_ == nullptr && numGroups_ == 0;
 }
@@ -294,10 +446,12 @@ RowVectorPtr StreamingAggregation::getOutput() {
   std::iota(newGroups.begin(), newGroups.end(), numPrevGroups);
 
   for (auto i = 0; i < aggregates_.size(); ++i) {
-    auto& aggregate = aggregates_[i];
-
-    aggregate->initializeNewGroups(
-        groups_.data(), folly::Range(newGroups.data(), newGroups.size()));
+    const auto indices = folly::Range(newGroups.data(), newGroups.size());
+    if (distinctAggregations_[i] != nullptr) {
+      distinctAggregations_[i]->initializeNewGroups(groups_.data(), indices);
+    } else {
+      aggregates_[i].function->initializeNewGroups(groups_.data(), indices);
+    }
   }
 
   evaluateAggregates();
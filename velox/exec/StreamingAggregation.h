@@ -16,7 +16,9 @@
 #pragma once
 
 #include "velox/exec/Aggregate.h"
+#include "velox/exec/AggregateInfo.h"
 #include "velox/exec/AggregationMasks.h"
+#include "velox/exec/DistinctAggregations.h"
 #include "velox/exec/Operator.h"
 
 namespace facebook::velox::exec {
@@ -62,22 +64,44 @@ class StreamingAggregation : public Operator {
   RowVectorPtr createOutput(size_t numGroups);
 
   // Assign input rows to groups based on values of the grouping keys. Store the
-  // assignments in inputGroups_.
+  // assignments in inputGroups_ and the runs of rows of the same group in
+  // runStarts_ and runGroups_.
   void assignGroups();
 
+  // Sets a bit in groupBoundaries_ for each input row that starts a new group.
+  // Decodes the keys into decodedKeys_ and compares adjacent rows one key
+  // column at a time.
+  void computeGroupBoundaries();
+
   // Add input data to accumulators.
   void evaluateAggregates();
 
+  // Adds 'rows' of 'args' to 'aggregate' one run of rows of the same group at
+  // a time.
+  void addInputByRuns(
+      Aggregate& aggregate,
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args);
+
+  // Minimum average number of input rows per group for adding input to the
+  // accumulators one run of rows at a time instead of one row at a time.
+  static constexpr vector_size_t kMinAverageRunLength = 16;
+
   /// Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
   const core::AggregationNode::Step step_;
 
   std::vector<column_index_t> groupingKeys_;
-  std::vector<std::unique_ptr<Aggregate>> aggregates_;
+  std::vector<AggregateInfo> aggregates_;
+
+  // De-duplicates the inputs of the aggregates over distinct inputs. 1:1 to
+  // 'aggregates_', nullptr for the aggregates over all inputs. Since the input
+  // is clustered on the grouping keys, only the unique values of the groups
+  // not yet produced are kept in memory.
+  std::vector<std::unique_ptr<DistinctAggregations>> distinctAggregations_;
+
   std::unique_ptr<AggregationMasks> masks_;
-  std::vector<std::vector<column_index_t>> args_;
-  std::vector<std::vector<VectorPtr>> constantArgs_;
   std::vector<DecodedVector> decodedKeys_;
 
   // Storage of grouping keys and accumulators.
@@ -99,6 +123,18 @@ class StreamingAggregation : public Operator {
   // Pointers to groups for all input rows.
   std::vector<char*> inputGroups_;
 
+  // Bit per input row, set if the row starts a new group.
+  std::vector<uint64_t> groupBoundaries_;
+
+  // First input row of each run of rows of the same group followed by the
+  // number of input rows. runGroups_[i] is the group of rows [runStarts_[i],
+  // runStarts_[i + 1]).
+  std::vector<vector_size_t> runStarts_;
+  std::vector<char*> runGroups_;
+
+  // Rows of one run passed to the accumulators.
+  SelectivityVector runRows_;
+
   // A subset of input rows to evaluate the aggregate function on. Rows
   // where aggregation mask is false are excluded.
   SelectivityVector inputRows_;
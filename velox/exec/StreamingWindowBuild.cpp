@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/StreamingWindowBuild.h"
+
+namespace facebook::velox::exec {
+
+StreamingWindowBuild::StreamingWindowBuild(
+    const std::shared_ptr<const core::WindowNode>& windowNode,
+    velox::memory::MemoryPool* pool)
+    : WindowBuild(windowNode, pool) {}
+
+bool StreamingWindowBuild::isSamePartition(const char* lhs, const char* rhs) {
+  for (const auto& [column, order] : partitionKeyInfo_) {
+    if (data_->compare(
+            lhs,
+            rhs,
+            column,
+            {order.isNullsFirst(), order.isAscending(), false}) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void StreamingWindowBuild::addInput(RowVectorPtr input) {
+  for (auto col = 0; col < input->childrenSize(); ++col) {
+    decodedInputVectors_[col].decode(*input->childAt(col));
+  }
+
+  for (auto row = 0; row < input->size(); ++row) {
+    char* newRow = data_->newRow();
+    for (auto col = 0; col < input->childrenSize(); ++col) {
+      data_->store(decodedInputVectors_[col], row, newRow, col);
+    }
+    if (!inputRows_.empty() && !isSamePartition(inputRows_.back(), newRow)) {
+      completedPartitions_.push_back(std::move(inputRows_));
+      inputRows_.clear();
+    }
+    inputRows_.push_back(newRow);
+  }
+  numRows_ += input->size();
+}
+
+void StreamingWindowBuild::noMoreInput() {
+  if (!inputRows_.empty()) {
+    completedPartitions_.push_back(std::move(inputRows_));
+    inputRows_.clear();
+  }
+}
+
+std::unique_ptr<WindowPartition> StreamingWindowBuild::nextPartition() {
+  VELOX_CHECK(hasNextPartition(), "No window partitions available");
+  // The previous partition has been fully output.
+  if (!outputRows_.empty()) {
+    data_->eraseRows(
+        folly::Range<char**>(outputRows_.data(), outputRows_.size()));
+  }
+  outputRows_ = std::move(completedPartitions_.front());
+  completedPartitions_.pop_front();
+
+  auto windowPartition = std::make_unique<WindowPartition>(
+      data_.get(), inputColumns_, sortKeyInfo_);
+  windowPartition->resetPartition(
+      folly::Range(outputRows_.data(), outputRows_.size()));
+  return windowPartition;
+}
+
+} // namespace facebook::velox::exec
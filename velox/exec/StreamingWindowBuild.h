@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+
+#include "velox/exec/WindowBuild.h"
+
+namespace facebook::velox::exec {
+
+// Builds the window partitions of an input that is already clustered by the
+// partition keys and sorted by the sort keys within each partition, e.g. the
+// output of a MergeJoin or a LocalMerge. A partition is complete when a row
+// with different partition keys arrives or at the end of input. The rows of
+// a partition are erased from 'data_' when the next partition is taken, so
+// that the memory is bounded by the largest partitions instead of the whole
+// input.
+class StreamingWindowBuild : public WindowBuild {
+ public:
+  StreamingWindowBuild(
+      const std::shared_ptr<const core::WindowNode>& windowNode,
+      velox::memory::MemoryPool* pool);
+
+  bool needsInput() override {
+    // Completed partitions are output before taking more input.
+    return completedPartitions_.empty();
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  void noMoreInput() override;
+
+  bool hasNextPartition() override {
+    return !completedPartitions_.empty();
+  }
+
+  std::unique_ptr<WindowPartition> nextPartition() override;
+
+ private:
+  // Returns true if 'lhs' and 'rhs' have the same partition keys.
+  bool isSamePartition(const char* lhs, const char* rhs);
+
+  // Rows of the partition being added.
+  std::vector<char*> inputRows_;
+
+  // Rows of the partitions that are complete and not yet output, in input
+  // order.
+  std::deque<std::vector<char*>> completedPartitions_;
+
+  // Rows of the partition returned by the last nextPartition(). The
+  // WindowPartition refers to these until the next call.
+  std::vector<char*> outputRows_;
+};
+
+} // namespace facebook::velox::exec
@@ -14,7 +14,10 @@
  * limitations under the License.
  */
 #include "velox/exec/TableScan.h"
+#include "velox/common/base/StatsReporter.h"
 #include "velox/common/time/Timer.h"
+#include "velox/exec/FilterProject.h"
+#include "velox/exec/Limit.h"
 #include "velox/exec/Task.h"
 #include "velox/expression/Expr.h"
 
@@ -43,18 +46,62 @@ TableScan::TableScan(
           driverCtx_->driverId,
           operatorType(),
           tableHandle_->connectorId())),
+      splitPreloadPerDriver_(
+          driverCtx_->task->queryCtx()
+              ->queryConfig()
+              .splitPreloadPerDriver()
+              .value_or(FLAGS_split_preload_per_driver)),
+      splitMetadataPrefetchPerDriver_(driverCtx_->task->queryCtx()
+                                          ->queryConfig()
+                                          .splitMetadataPrefetchPerDriver()),
+      maxSplitParts_(driverCtx_->task->queryCtx()
+                         ->queryConfig()
+                         .tableScanMaxSplitParts()),
       readBatchSize_(driverCtx_->task->queryCtx()
                          ->queryConfig()
                          .preferredOutputBatchRows()) {
   connector_ = connector::getConnector(tableHandle_->connectorId());
 }
 
+void TableScan::initialize() {
+  Operator::initialize();
+  bool hasFilter = false;
+  for (auto* op : operatorCtx_->driver()->operators()) {
+    if (op == this) {
+      continue;
+    }
+    if (auto* limit = dynamic_cast<Limit*>(op)) {
+      limit_ = limit;
+      limitCountsScanRows_ = !hasFilter;
+      break;
+    }
+    auto* filterProject = dynamic_cast<FilterProject*>(op);
+    if (filterProject == nullptr) {
+      break;
+    }
+    hasFilter |= filterProject->exprsAndProjection().hasFilter;
+  }
+}
+
 RowVectorPtr TableScan::getOutput() {
   if (noMoreSplits_) {
     return nullptr;
   }
 
   for (;;) {
+    if (limit_ != nullptr && limit_->allDriversDone()) {
+      // The rest of the current split and the remaining splits cannot add to
+      // the result of the limit.
+      if (!needNewSplit_) {
+        driverCtx_->task->splitFinished();
+        needNewSplit_ = true;
+      }
+      addRuntimeStat("finishedByLimit", RuntimeCounter(1));
+      noMoreSplits_ = true;
+      addDataSourceStats();
+      return nullptr;
+    }
+
     if (needNewSplit_) {
       exec::Split split;
       blockingReason_ = driverCtx_->task->getSplitOrFuture(
@@ -63,36 +110,24 @@ RowVectorPtr TableScan::getOutput() {
           split,
           blockingFuture_,
           maxPreloadedSplits_,
-          splitPreloader_);
+          splitPreloader_,
+          maxSplitParts_ > 1);
       if (blockingReason_ != BlockingReason::kNotBlocked) {
         return nullptr;
       }
 
+      if (dataSource_) {
+        reportSplitIoWait();
+      }
       if (!split.hasConnectorSplit()) {
         noMoreSplits_ = true;
-        if (dataSource_) {
-          auto connectorStats = dataSource_->runtimeStats();
-          auto lockedStats = stats_.wlock();
-          for (const auto& [name, counter] : connectorStats) {
-            if (name == "ioWaitNanos") {
-              ioWaitNanos_ += counter.value - lastIoWaitNanos_;
-              lastIoWaitNanos_ = counter.value;
-            }
-            if (UNLIKELY(lockedStats->runtimeStats.count(name) == 0)) {
-              lockedStats->runtimeStats.insert(
-                  std::make_pair(name, RuntimeMetric(counter.unit)));
-            } else {
-              VELOX_CHECK_EQ(
-                  lockedStats->runtimeStats.at(name).unit, counter.unit);
-            }
-            lockedStats->runtimeStats.at(name).addValue(counter.value);
-          }
-        }
+        addDataSourceStats();
         return nullptr;
       }
 
       const auto& connectorSplit = split.connectorSplit;
       needNewSplit_ = false;
+      lookaheadIssued_ = false;
 
       VELOX_CHECK_EQ(
           connector_->connectorId(),
@@ -107,6 +142,7 @@ RowVectorPtr TableScan::getOutput() {
             tableHandle_,
             columnHandles_,
             connectorQueryCtx_.get());
+        dataSource_->setMaxSplitParts(maxSplitParts_);
         for (const auto& entry : pendingDynamicFilters_) {
           dataSource_->addDynamicFilter(entry.first, entry.second);
         }
@@ -140,6 +176,9 @@ RowVectorPtr TableScan::getOutput() {
         dataSource_->addSplit(connectorSplit);
       }
       ++stats_.wlock()->numSplits;
+      if (maxSplitParts_ > 1) {
+        addSplitParts(split.groupId);
+      }
 
       auto estimatedRowSize = dataSource_->estimatedRowSize();
       readBatchSize_ =
@@ -160,6 +199,13 @@ RowVectorPtr TableScan::getOutput() {
          },
          &debugString_});
 
+    if (observedOutputRowSize().has_value()) {
+      // The batches read so far give a better row size than the estimate.
+      readBatchSize_ = outputBatchRows();
+    }
+    if (limitCountsScanRows_) {
+      dataSource_->setRemainingLimit(limit_->remainingInputRows());
+    }
     auto dataOptional = dataSource_->next(readBatchSize_, blockingFuture_);
     checkPreload();
 
@@ -200,6 +246,12 @@ RowVectorPtr TableScan::getOutput() {
             "readyPreloadedSplits", RuntimeCounter(numReadyPreloadedSplits_));
         numReadyPreloadedSplits_ = 0;
       }
+      if (numMetadataPrefetchedSplits_ > 0) {
+        lockedStats->addRuntimeStat(
+            "metadataPrefetchedSplits",
+            RuntimeCounter(numMetadataPrefetchedSplits_));
+        numMetadataPrefetchedSplits_ = 0;
+      }
     }
 
     driverCtx_->task->splitFinished();
@@ -221,6 +273,7 @@ void TableScan::preload(std::shared_ptr<connector::ConnectorSplit> split) {
        ctx = operatorCtx_->createConnectorQueryCtx(
            split->connectorId, planNodeId(), connectorPool_),
        task = operatorCtx_->task(),
+       maxParts = maxSplitParts_,
        split]() -> std::unique_ptr<connector::DataSource> {
         if (task->isCancelled()) {
           return nullptr;
@@ -234,6 +287,7 @@ void TableScan::preload(std::shared_ptr<connector::ConnectorSplit> split) {
              &debugString});
 
         auto ptr = connector->createDataSource(type, table, columns, ctx.get());
+        ptr->setMaxSplitParts(maxParts);
         if (task->isCancelled()) {
           return nullptr;
         }
@@ -242,15 +296,27 @@ void TableScan::preload(std::shared_ptr<connector::ConnectorSplit> split) {
       });
 }
 
+void TableScan::addSplitParts(int32_t groupId) {
+  // Called for every split got with 'divisible' set, also if the split was
+  // not divided, so that the task stops holding back the other drivers.
+  std::vector<exec::Split> parts;
+  for (auto& part : dataSource_->takeSplitParts()) {
+    parts.emplace_back(std::move(part), groupId);
+  }
+  driverCtx_->task->addSplitParts(
+      driverCtx_->splitGroupId, planNodeId(), std::move(parts));
+}
+
 void TableScan::checkPreload() {
   auto executor = connector_->executor();
-  if (FLAGS_split_preload_per_driver == 0 || !executor ||
-      !connector_->supportsSplitPreload()) {
+  if (!executor || !dataSource_->allPrefetchIssued()) {
     return;
   }
-  if (dataSource_->allPrefetchIssued()) {
-    maxPreloadedSplits_ = driverCtx_->task->numDrivers(driverCtx_->driver) *
-        FLAGS_split_preload_per_driver;
+  const auto numDrivers = driverCtx_->task->numDrivers(driverCtx_->driver);
+  const bool preloadEnabled =
+      splitPreloadPerDriver_ > 0 && connector_->supportsSplitPreload();
+  if (preloadEnabled) {
+    maxPreloadedSplits_ = numDrivers * splitPreloadPerDriver_;
     if (!splitPreloader_) {
       splitPreloader_ =
           [executor, this](std::shared_ptr<connector::ConnectorSplit> split) {
@@ -263,12 +329,77 @@ void TableScan::checkPreload() {
           };
     }
   }
+  if (lookaheadIssued_) {
+    return;
+  }
+  // Starts opening the next splits now instead of at the next split
+  // boundary so that their open overlaps with reading the current split.
+  lookaheadIssued_ = true;
+  if (preloadEnabled) {
+    driverCtx_->task->preloadSplits(
+        driverCtx_->splitGroupId,
+        planNodeId(),
+        maxPreloadedSplits_,
+        splitPreloader_);
+  }
+  if (splitMetadataPrefetchPerDriver_ > 0 &&
+      connector_->supportsMetadataPrefetch()) {
+    // The splits behind the preloaded ones only get their metadata fetched,
+    // which takes no memory for readers but saves a round trip each.
+    numMetadataPrefetchedSplits_ += driverCtx_->task->prefetchSplitMetadata(
+        driverCtx_->splitGroupId,
+        planNodeId(),
+        maxPreloadedSplits_ + numDrivers * splitMetadataPrefetchPerDriver_,
+        [&](std::shared_ptr<connector::ConnectorSplit> split) {
+          executor->add([task = operatorCtx_->task(),
+                         connector = connector_,
+                         split = std::move(split)]() {
+            if (!task->isCancelled()) {
+              connector->prefetchMetadata(split);
+            }
+          });
+        });
+  }
 }
 
 bool TableScan::isFinished() {
   return noMoreSplits_;
 }
 
+void TableScan::addDataSourceStats() {
+  if (!dataSource_) {
+    return;
+  }
+  auto connectorStats = dataSource_->runtimeStats();
+  auto lockedStats = stats_.wlock();
+  for (const auto& [name, counter] : connectorStats) {
+    if (name == "ioWaitNanos") {
+      ioWaitNanos_ += counter.value - lastIoWaitNanos_;
+      lastIoWaitNanos_ = counter.value;
+    }
+    if (UNLIKELY(lockedStats->runtimeStats.count(name) == 0)) {
+      lockedStats->runtimeStats.insert(
+          std::make_pair(name, RuntimeMetric(counter.unit)));
+    } else {
+      VELOX_CHECK_EQ(lockedStats->runtimeStats.at(name).unit, counter.unit);
+    }
+    lockedStats->runtimeStats.at(name).addValue(counter.value);
+  }
+}
+
+void TableScan::reportSplitIoWait() {
+  if (!BaseStatsReporter::registered) {
+    return;
+  }
+  const auto connectorStats = dataSource_->runtimeStats();
+  auto it = connectorStats.find("ioWaitNanos");
+  if (it == connectorStats.end()) {
+    return;
+  }
+  reportIoWait(it->second.value - splitStartIoWaitNanos_);
+  splitStartIoWaitNanos_ = it->second.value;
+}
+
 void TableScan::addDynamicFilter(
     column_index_t outputChannel,
     const std::shared_ptr<common::Filter>& filter) {
@@ -22,6 +22,8 @@ DECLARE_int32(split_preload_per_driver);
 
 namespace facebook::velox::exec {
 
+class Limit;
+
 class TableScan : public SourceOperator {
  public:
   TableScan(
@@ -29,6 +31,8 @@ class TableScan : public SourceOperator {
       DriverCtx* driverCtx,
       std::shared_ptr<const core::TableScanNode> tableScanNode);
 
+  void initialize() override;
+
   RowVectorPtr getOutput() override;
 
   BlockingReason isBlocked(ContinueFuture* future) override {
@@ -60,9 +64,24 @@ class TableScan : public SourceOperator {
   // Sets 'maxPreloadSplits' and 'splitPreloader' if prefetching
   // splits is appropriate. The preloader will be applied to the
   // 'first 'maxPreloadSplits' of the Tasks's split queue for 'this'
-  // when getting splits.
+  // when getting splits. The first time this is appropriate for the
+  // current split, the preloader is also applied right away so that
+  // the next splits are opened while the current one is read, and the
+  // metadata of the splits queued behind these is prefetched.
   void checkPreload();
 
+  // Adds the runtime stats of 'dataSource_' to the stats of 'this'. Called
+  // once the scan is finished.
+  void addDataSourceStats();
+
+  // Reports the IO wait of the split 'dataSource_' has finished reading to
+  // the StatsReporter.
+  void reportSplitIoWait();
+
+  // Gives the parts 'dataSource_' divided the current split into to the task
+  // for reading by other drivers. 'groupId' is the group of the split.
+  void addSplitParts(int32_t groupId);
+
   // Sets 'split->dataSource' to be a Asyncsource that makes a
   // DataSource to read 'split'. This source will be prepared in the
   // background on the executor of the connector. If the DataSource is
@@ -89,8 +108,23 @@ class TableScan : public SourceOperator {
   std::unordered_map<column_index_t, std::shared_ptr<common::Filter>>
       pendingDynamicFilters_;
 
+  // Number of splits per driver to preload. 0 disables preload.
+  const int32_t splitPreloadPerDriver_;
+
+  // Number of splits per driver beyond the preloaded ones whose metadata is
+  // prefetched. 0 disables metadata prefetch.
+  const int32_t splitMetadataPrefetchPerDriver_;
+
+  // Maximum number of parts a split is divided into for reading by other
+  // drivers. 1 means splits are read whole.
+  const int32_t maxSplitParts_;
+
   int32_t maxPreloadedSplits_{0};
 
+  // True if the next splits have been given to 'splitPreloader_' while
+  // reading the current split.
+  bool lookaheadIssued_{false};
+
   // Callback passed to getSplitOrFuture() for triggering async
   // preload. The callback's lifetime is the lifetime of 'this'. This
   // callback can schedule preloads on an executor. These preloads may
@@ -105,6 +139,9 @@ class TableScan : public SourceOperator {
   // Count of splits that finished preloading before being read.
   int32_t numReadyPreloadedSplits_{0};
 
+  // Count of queued splits whose metadata prefetch was started.
+  int32_t numMetadataPrefetchedSplits_{0};
+
   int32_t readBatchSize_;
 
   // String shown in ExceptionContext inside DataSource and LazyVector loading.
@@ -113,5 +150,18 @@ class TableScan : public SourceOperator {
   // The last value of the IO wait time of 'this' that has been added to the
   // global static 'ioWaitNanos_'.
   uint64_t lastIoWaitNanos_{0};
+
+  // The IO wait time of 'dataSource_' when the current split started.
+  uint64_t splitStartIoWaitNanos_{0};
+
+  // The Limit fed by 'this' through filters and projections only, or
+  // nullptr. The scan stops reading once the drivers of a partial limit
+  // together have enough rows.
+  Limit* limit_{nullptr};
+
+  // True if no filter is between 'this' and 'limit_', so that every row
+  // 'this' returns is input to 'limit_'. 'dataSource_' is then told how many
+  // rows are still needed.
+  bool limitCountsScanRows_{false};
 };
 } // namespace facebook::velox::exec
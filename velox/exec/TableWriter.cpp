@@ -30,7 +30,8 @@ TableWriter::TableWriter(
           tableWriteNode->outputType(),
           operatorId,
           tableWriteNode->id(),
-          "TableWrite"),
+          "TableWrite",
+          driverCtx->makeSpillConfig(operatorId)),
       driverCtx_(driverCtx),
       connectorPool_(driverCtx_->task->addConnectorPoolLocked(
           planNodeId(),
@@ -41,6 +42,10 @@ TableWriter::TableWriter(
       insertTableHandle_(
           tableWriteNode->insertTableHandle()->connectorInsertTableHandle()),
       commitStrategy_(tableWriteNode->commitStrategy()) {
+  if (connectorPool_->parent()->reclaimer() != nullptr) {
+    connectorPool_->setReclaimer(
+        ConnectorReclaimer::create(driverCtx_, this));
+  }
   if (tableWriteNode->outputType()->size() == 1) {
     VELOX_USER_CHECK_NULL(tableWriteNode->aggregationNode());
   } else {
@@ -55,7 +60,10 @@ TableWriter::TableWriter(
   const auto& connectorId = tableWriteNode->insertTableHandle()->connectorId();
   connector_ = connector::getConnector(connectorId);
   connectorQueryCtx_ = operatorCtx_->createConnectorQueryCtx(
-      connectorId, planNodeId(), connectorPool_);
+      connectorId,
+      planNodeId(),
+      connectorPool_,
+      spillConfig_.has_value() ? &spillConfig_.value() : nullptr);
 
   auto names = tableWriteNode->columnNames();
   auto types = tableWriteNode->columns()->children();
@@ -103,7 +111,11 @@ void TableWriter::addInput(RowVectorPtr input) {
       mappedChildren,
       input->getNullCount());
 
-  dataSink_->appendData(mappedInput);
+  {
+    // The data sink can only release memory between two inputs.
+    NonReclaimableSection guard(this);
+    dataSink_->appendData(mappedInput);
+  }
   numWrittenRows_ += input->size();
   updateWrittenBytes();
 
@@ -311,4 +323,49 @@ int64_t TableWriteTraits::getRowCount(const RowVectorPtr& output) {
   }
   return rowCount;
 }
+
+// static
+std::unique_ptr<memory::MemoryReclaimer>
+TableWriter::ConnectorReclaimer::create(
+    const DriverCtx* driverCtx,
+    TableWriter* writer) {
+  return std::unique_ptr<memory::MemoryReclaimer>(
+      new TableWriter::ConnectorReclaimer(
+          driverCtx->driver->shared_from_this(), writer));
+}
+
+bool TableWriter::ConnectorReclaimer::reclaimableBytes(
+    const memory::MemoryPool& pool,
+    uint64_t& reclaimableBytes) const {
+  reclaimableBytes = 0;
+  std::shared_ptr<Driver> driver = ensureDriver();
+  if (FOLLY_UNLIKELY(driver == nullptr)) {
+    return false;
+  }
+  VELOX_CHECK_EQ(pool.name(), writer_->connectorPool_->name());
+  if (!writer_->canReclaimFromDataSink()) {
+    return false;
+  }
+  reclaimableBytes = pool.reservedBytes();
+  return true;
+}
+
+uint64_t TableWriter::ConnectorReclaimer::reclaim(
+    memory::MemoryPool* pool,
+    uint64_t targetBytes) {
+  std::shared_ptr<Driver> driver = ensureDriver();
+  if (FOLLY_UNLIKELY(driver == nullptr)) {
+    return 0;
+  }
+  VELOX_CHECK_EQ(pool->name(), writer_->connectorPool_->name());
+  VELOX_CHECK(
+      !driver->state().isOnThread() || driver->state().isSuspended ||
+      driver->state().isTerminated);
+  VELOX_CHECK(driver->task()->pauseRequested());
+  if (!writer_->canReclaimFromDataSink()) {
+    return 0;
+  }
+  writer_->dataSink_->reclaim(targetBytes);
+  return pool->shrink(targetBytes);
+}
 } // namespace facebook::velox::exec
@@ -140,7 +140,47 @@ class TableWriter : public Operator {
     return finished_;
   }
 
+  /// The operator memory pool holds little. The memory is reclaimed from the
+  /// data sink through the connector memory pool's ConnectorReclaimer.
+  bool canReclaim() const override {
+    return false;
+  }
+
  private:
+  // The memory reclaimer of the connector memory pool. It reclaims by asking
+  // the data sink to flush or close some of its file writers.
+  class ConnectorReclaimer : public Operator::MemoryReclaimer {
+   public:
+    static std::unique_ptr<memory::MemoryReclaimer> create(
+        const DriverCtx* driverCtx,
+        TableWriter* writer);
+
+    bool reclaimableBytes(
+        const memory::MemoryPool& pool,
+        uint64_t& reclaimableBytes) const override;
+
+    uint64_t reclaim(memory::MemoryPool* pool, uint64_t targetBytes) override;
+
+    // The table writer is aborted through its operator memory pool.
+    void abort(memory::MemoryPool* pool, const std::exception_ptr& /* error */)
+        override {}
+
+   private:
+    ConnectorReclaimer(
+        const std::shared_ptr<Driver>& driver,
+        TableWriter* writer)
+        : Operator::MemoryReclaimer(driver, writer), writer_(writer) {}
+
+    TableWriter* const writer_;
+  };
+
+  // Returns true if the data sink can release memory, i.e. it is between two
+  // inputs and not yet closed.
+  bool canReclaimFromDataSink() const {
+    return dataSink_ != nullptr && !closed_ && !nonReclaimableSection_ &&
+        dataSink_->canReclaim();
+  }
+
   void createDataSink();
 
   // Updates physicalWrittenBytes in OperatorStats with current written bytes.
@@ -27,6 +27,7 @@
 #include "velox/exec/Merge.h"
 #include "velox/exec/NestedLoopJoinBuild.h"
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/OrderBy.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/Task.h"
 #if CODEGEN_ENABLED == 1
@@ -284,6 +285,16 @@ uint64_t Task::timeSinceStartMsLocked() const {
   return getCurrentTimeMs() - taskStats_.executionStartTimeMs;
 }
 
+/// Moves split promises from one vector to another.
+static void movePromisesOut(
+    std::vector<ContinuePromise>& from,
+    std::vector<ContinuePromise>& to) {
+  for (auto& promise : from) {
+    to.push_back(std::move(promise));
+  }
+  from.clear();
+}
+
 SplitsState& Task::getPlanNodeSplitsStateLocked(
     const core::PlanNodeId& planNodeId) {
   auto it = splitsStates_.find(planNodeId);
@@ -307,12 +318,20 @@ bool Task::allNodesReceivedNoMoreSplitsMessageLocked() const {
 }
 
 void Task::removeSpillDirectoryIfExists() {
-  if (!spillDirectory_.empty()) {
+  std::vector<std::string> directories;
+  if (spillDirectories_ != nullptr) {
+    for (auto i = 0; i < spillDirectories_->numDirectories(); ++i) {
+      directories.push_back(spillDirectories_->path(i));
+    }
+  } else if (!spillDirectory_.empty()) {
+    directories.push_back(spillDirectory_);
+  }
+  for (const auto& directory : directories) {
     try {
-      auto fs = filesystems::getFileSystem(spillDirectory_, nullptr);
-      fs->rmdir(spillDirectory_);
+      auto fs = filesystems::getFileSystem(directory, nullptr);
+      fs->rmdir(directory);
     } catch (const std::exception& e) {
-      LOG(ERROR) << "Failed to remove spill directory '" << spillDirectory_
+      LOG(ERROR) << "Failed to remove spill directory '" << directory
                  << "' for Task " << taskId() << ": " << e.what();
     }
   }
@@ -694,6 +713,11 @@ void Task::start(
               self->queryCtx()->executor())) {
         l.unlock();
       }
+      // Drivers are held back only while holding 'mutex_' because they are
+      // started later under 'mutex_'.
+      const uint32_t initialScanDrivers = l.owns_lock()
+          ? self->queryCtx()->queryConfig().tableScanInitialDrivers()
+          : 0;
       // We might have first slots taken for grouped execution drivers, so need
       // only to enqueue the ungrouped execution drivers.
       for (auto it = self->drivers_.end() - self->numDriversUngrouped_;
@@ -701,9 +725,17 @@ void Task::start(
            ++it) {
         if (*it) {
           ++self->numRunningDrivers_;
+          if (initialScanDrivers > 0 &&
+              self->parkDriverLocked(*it, initialScanDrivers)) {
+            continue;
+          }
           Driver::enqueue(*it);
         }
       }
+      // Splits may have been added before the start.
+      for (auto& [planNodeId, parked] : self->parkedDrivers_) {
+        self->startParkedDriversLocked(planNodeId);
+      }
     }
 
     // As some splits for grouped execution could have been added before the
@@ -743,6 +775,10 @@ void Task::resume(std::shared_ptr<Task> self) {
             // enqueued twice.
             continue;
           }
+          if (driver->state().isParked) {
+            // Started by startParkedDriversLocked().
+            continue;
+          }
           VELOX_CHECK(!driver->isOnThread() && !driver->isTerminated());
           if (!driver->state().hasBlockingFuture) {
             // Do not continue a Driver that is blocked on external
@@ -840,6 +876,7 @@ void Task::createSplitGroupStateLocked(uint32_t splitGroupId) {
     addHashJoinBridgesLocked(splitGroupId, factory->needsHashJoinBridges());
     addNestedLoopJoinBridgesLocked(
         splitGroupId, factory->needsNestedLoopJoinBridges());
+    addOrderByBridgesLocked(splitGroupId, factory->needsOrderByBridges());
     addCustomJoinBridgesLocked(splitGroupId, factory->planNodes);
   }
 }
@@ -980,6 +1017,24 @@ void Task::removeDriver(std::shared_ptr<Task> self, Driver* driver) {
   }
 }
 
+bool Task::splitGroupFitsLocked() const {
+  if (numRunningSplitGroups_ == 0) {
+    return true;
+  }
+  const auto admissionPct =
+      queryCtx_->queryConfig().splitGroupMemoryAdmissionPct();
+  if (admissionPct == 0) {
+    return true;
+  }
+  const int64_t usedBytes = pool_->currentBytes();
+  const int64_t splitGroupBytes = usedBytes / numRunningSplitGroups_;
+  const int64_t maxBytes = pool_->maxCapacity();
+  if (maxBytes == memory::kMaxMemory) {
+    return true;
+  }
+  return usedBytes + splitGroupBytes <= maxBytes / 100 * admissionPct;
+}
+
 void Task::ensureSplitGroupsAreBeingProcessedLocked(
     std::shared_ptr<Task>& self) {
   // Only try creating more drivers if we are running.
@@ -988,7 +1043,7 @@ void Task::ensureSplitGroupsAreBeingProcessedLocked(
   }
 
   while (numRunningSplitGroups_ < concurrentSplitGroups_ and
-         not queuedSplitGroups_.empty()) {
+         not queuedSplitGroups_.empty() and splitGroupFitsLocked()) {
     const uint32_t splitGroupId = queuedSplitGroups_.front();
     queuedSplitGroups_.pop();
 
@@ -1028,6 +1083,23 @@ void Task::setMaxSplitSequenceId(
   }
 }
 
+void Task::setMemoryEstimate(
+    const core::PlanNodeId& planNodeId,
+    uint64_t bytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  memoryEstimates_[planNodeId] = bytes;
+}
+
+std::optional<uint64_t> Task::memoryEstimate(
+    const core::PlanNodeId& planNodeId) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = memoryEstimates_.find(planNodeId);
+  if (it == memoryEstimates_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
 bool Task::addSplitWithSequence(
     const core::PlanNodeId& planNodeId,
     exec::Split&& split,
@@ -1070,6 +1142,7 @@ void Task::addSplit(const core::PlanNodeId& planNodeId, exec::Split&& split) {
     if (isTaskRunning) {
       promise = addSplitLocked(
           getPlanNodeSplitsStateLocked(planNodeId), std::move(split));
+      startParkedDriversLocked(planNodeId);
     }
   }
 
@@ -1126,6 +1199,46 @@ std::unique_ptr<ContinuePromise> Task::addSplitLocked(
       splitsState.groupSplitsStores[splitGroupId], std::move(split));
 }
 
+bool Task::parkDriverLocked(
+    const std::shared_ptr<Driver>& driver,
+    uint32_t initialDrivers) {
+  const auto& factory = driverFactories_[driver->driverCtx()->pipelineId];
+  const auto scanNodeId = factory->needsTableScan();
+  if (!scanNodeId.has_value()) {
+    return false;
+  }
+  auto& parked = parkedDrivers_[scanNodeId.value()];
+  if (parked.numStarted < initialDrivers) {
+    ++parked.numStarted;
+    return false;
+  }
+  driver->state().isParked = true;
+  parked.drivers.push_back(driver);
+  return true;
+}
+
+void Task::startParkedDriversLocked(const core::PlanNodeId& planNodeId) {
+  auto it = parkedDrivers_.find(planNodeId);
+  if (it == parkedDrivers_.end() || it->second.drivers.empty()) {
+    return;
+  }
+  auto& parked = it->second;
+  auto& splitsState = getPlanNodeSplitsStateLocked(planNodeId);
+  const auto& splitsStore = splitsState.groupSplitsStores[kUngroupedGroupId];
+  // Each started driver takes a queued split. A driver is added for each
+  // split beyond that. All start when no more splits are coming so that they
+  // can finish.
+  while (!parked.drivers.empty() &&
+         (splitsState.noMoreSplits || splitsStore.noMoreSplits ||
+          splitsStore.splits.size() > parked.numStarted)) {
+    auto driver = std::move(parked.drivers.back());
+    parked.drivers.pop_back();
+    driver->state().isParked = false;
+    ++parked.numStarted;
+    Driver::enqueue(std::move(driver));
+  }
+}
+
 std::unique_ptr<ContinuePromise> Task::addSplitToStoreLocked(
     SplitsStore& splitsStore,
     exec::Split&& split) {
@@ -1194,6 +1307,8 @@ void Task::noMoreSplits(const core::PlanNodeId& planNodeId) {
 
     if (!isRunningLocked()) {
       exchangeClient = getExchangeClientLocked(planNodeId);
+    } else {
+      startParkedDriversLocked(planNodeId);
     }
   }
 
@@ -1245,14 +1360,60 @@ BlockingReason Task::getSplitOrFuture(
     exec::Split& split,
     ContinueFuture& future,
     int32_t maxPreloadSplits,
-    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload) {
+    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload,
+    bool divisible) {
   std::lock_guard<std::mutex> l(mutex_);
   return getSplitOrFutureLocked(
       getPlanNodeSplitsStateLocked(planNodeId).groupSplitsStores[splitGroupId],
       split,
       future,
       maxPreloadSplits,
-      preload);
+      preload,
+      divisible);
+}
+
+void Task::addSplitParts(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId,
+    std::vector<exec::Split>&& parts) {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto& splitsState = getPlanNodeSplitsStateLocked(planNodeId);
+    auto& splitsStore = splitsState.groupSplitsStores[splitGroupId];
+    VELOX_CHECK_GT(splitsStore.numDividingSplits, 0);
+    --splitsStore.numDividingSplits;
+    if (isRunningLocked() && !parts.empty()) {
+      // The parts are the rest of a split that a driver is reading. They go to
+      // the front of the queue so that idle drivers take them before starting
+      // new splits. This keeps a large split that starts late from becoming a
+      // straggler at the end of the scan.
+      // The parts are in the group of the divided split, so the group is
+      // already known to the task.
+      auto& partsStore = splitsState.groupSplitsStores
+                             [parts[0].hasGroup() ? parts[0].groupId
+                                                  : kUngroupedGroupId];
+      taskStats_.numTotalSplits += parts.size();
+      taskStats_.numQueuedSplits += parts.size();
+      partsStore.splits.insert(
+          partsStore.splits.begin(),
+          std::make_move_iterator(parts.begin()),
+          std::make_move_iterator(parts.end()));
+      for (auto i = 0; i < parts.size() && !partsStore.splitPromises.empty();
+           ++i) {
+        promises.push_back(std::move(partsStore.splitPromises.back()));
+        partsStore.splitPromises.pop_back();
+      }
+    }
+    if (splitsStore.numDividingSplits == 0 && splitsStore.noMoreSplits) {
+      // Wakes up the drivers waiting for parts so that they can finish.
+      movePromisesOut(splitsStore.splitPromises, promises);
+    }
+    startParkedDriversLocked(planNodeId);
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
 }
 
 BlockingReason Task::getSplitOrFutureLocked(
@@ -1260,9 +1421,10 @@ BlockingReason Task::getSplitOrFutureLocked(
     exec::Split& split,
     ContinueFuture& future,
     int32_t maxPreloadSplits,
-    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload) {
+    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload,
+    bool divisible) {
   if (splitsStore.splits.empty()) {
-    if (splitsStore.noMoreSplits) {
+    if (splitsStore.noMoreSplits && splitsStore.numDividingSplits == 0) {
       return BlockingReason::kNotBlocked;
     }
     auto [splitPromise, splitFuture] = makeVeloxContinuePromiseContract(
@@ -1273,23 +1435,74 @@ BlockingReason Task::getSplitOrFutureLocked(
   }
 
   split = getSplitLocked(splitsStore, maxPreloadSplits, preload);
+  if (divisible && split.hasConnectorSplit()) {
+    ++splitsStore.numDividingSplits;
+  }
   return BlockingReason::kNotBlocked;
 }
 
+void Task::preloadSplits(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId,
+    int32_t maxPreloadSplits,
+    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload) {
+  std::lock_guard<std::mutex> l(mutex_);
+  preloadSplitsLocked(
+      getPlanNodeSplitsStateLocked(planNodeId).groupSplitsStores[splitGroupId],
+      maxPreloadSplits,
+      preload);
+}
+
+void Task::preloadSplitsLocked(
+    SplitsStore& splitsStore,
+    int32_t maxPreloadSplits,
+    const std::function<void(std::shared_ptr<connector::ConnectorSplit>)>&
+        preload) {
+  for (auto i = 0; i < splitsStore.splits.size() && i < maxPreloadSplits;
+       ++i) {
+    auto& split = splitsStore.splits[i].connectorSplit;
+    if (!split->dataSource) {
+      // Initializes split->dataSource
+      preload(split);
+    }
+  }
+}
+
+int32_t Task::prefetchSplitMetadata(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId,
+    int32_t maxSplits,
+    const std::function<void(std::shared_ptr<connector::ConnectorSplit>)>&
+        prefetch) {
+  std::lock_guard<std::mutex> l(mutex_);
+  const auto& splits = getPlanNodeSplitsStateLocked(planNodeId)
+                           .groupSplitsStores[splitGroupId]
+                           .splits;
+  int32_t numPrefetched = 0;
+  for (auto i = 0; i < splits.size() && i < maxSplits; ++i) {
+    auto& split = splits[i].connectorSplit;
+    if (!split->dataSource && !split->metadataPrefetched) {
+      split->metadataPrefetched = true;
+      prefetch(split);
+      ++numPrefetched;
+    }
+  }
+  return numPrefetched;
+}
+
 exec::Split Task::getSplitLocked(
     SplitsStore& splitsStore,
     int32_t maxPreloadSplits,
     std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload) {
   int32_t readySplitIndex = -1;
   if (maxPreloadSplits) {
+    preloadSplitsLocked(splitsStore, maxPreloadSplits, preload);
     for (auto i = 0; i < splitsStore.splits.size() && i < maxPreloadSplits;
          ++i) {
       auto& split = splitsStore.splits[i].connectorSplit;
-      if (!split->dataSource) {
-        // Initializes split->dataSource
-        preload(split);
-      } else if (readySplitIndex == -1 && split->dataSource->hasValue()) {
+      if (split->dataSource->hasValue()) {
         readySplitIndex = i;
+        break;
       }
     }
   }
@@ -1541,6 +1754,16 @@ void Task::addNestedLoopJoinBridgesLocked(
   }
 }
 
+void Task::addOrderByBridgesLocked(
+    uint32_t splitGroupId,
+    const std::vector<core::PlanNodeId>& planNodeIds) {
+  auto& splitGroupState = splitGroupStates_[splitGroupId];
+  for (const auto& planNodeId : planNodeIds) {
+    splitGroupState.bridges.emplace(
+        planNodeId, std::make_shared<OrderByBridge>());
+  }
+}
+
 std::shared_ptr<HashJoinBridge> Task::getHashJoinBridge(
     uint32_t splitGroupId,
     const core::PlanNodeId& planNodeId) {
@@ -1559,6 +1782,18 @@ std::shared_ptr<NestedLoopJoinBridge> Task::getNestedLoopJoinBridge(
   return getJoinBridgeInternal<NestedLoopJoinBridge>(splitGroupId, planNodeId);
 }
 
+std::shared_ptr<OrderByBridge> Task::getOrderByBridge(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId) {
+  std::lock_guard<std::mutex> l(mutex_);
+  const auto& bridges = splitGroupStates_[splitGroupId].bridges;
+  auto it = bridges.find(planNodeId);
+  if (it == bridges.end()) {
+    return nullptr;
+  }
+  return std::dynamic_pointer_cast<OrderByBridge>(it->second);
+}
+
 template <class TBridgeType>
 std::shared_ptr<TBridgeType> Task::getJoinBridgeInternal(
     uint32_t splitGroupId,
@@ -1611,16 +1846,6 @@ std::string Task::shortId(const std::string& id) {
   return fmt::format("tk:{}", hash & 0xffff);
 }
 
-/// Moves split promises from one vector to another.
-static void movePromisesOut(
-    std::vector<ContinuePromise>& from,
-    std::vector<ContinuePromise>& to) {
-  for (auto& promise : from) {
-    to.push_back(std::move(promise));
-  }
-  from.clear();
-}
-
 ContinueFuture Task::terminate(TaskState terminalState) {
   std::vector<std::shared_ptr<Driver>> offThreadDrivers;
   EventCompletionNotifier taskCompletionNotifier;
@@ -1663,6 +1888,8 @@ ContinueFuture Task::terminate(TaskState terminalState) {
     // 'numRunningDrivers_' is cleared here so that this is 0 right
     // after terminate as tests expect.
     numRunningDrivers_ = 0;
+    // The held back drivers are off thread and closed below.
+    parkedDrivers_.clear();
     for (auto& driver : drivers_) {
       if (driver) {
         if (enterForTerminateLocked(driver->state()) ==
@@ -2026,6 +2253,17 @@ std::shared_ptr<MergeJoinSource> Task::getMergeJoinSource(
   return it->second;
 }
 
+std::shared_ptr<std::atomic<int64_t>> Task::getLimitRowCount(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto& rowCount = splitGroupStates_[splitGroupId].limitRowCounts[planNodeId];
+  if (rowCount == nullptr) {
+    rowCount = std::make_shared<std::atomic<int64_t>>(0);
+  }
+  return rowCount;
+}
+
 void Task::createLocalExchangeQueuesLocked(
     uint32_t splitGroupId,
     const core::PlanNodeId& planNodeId,
@@ -19,6 +19,7 @@
 #include "velox/exec/Driver.h"
 #include "velox/exec/LocalPartition.h"
 #include "velox/exec/MergeSource.h"
+#include "velox/exec/SpillDirectorySet.h"
 #include "velox/exec/Split.h"
 #include "velox/exec/TaskStats.h"
 #include "velox/exec/TaskStructs.h"
@@ -30,6 +31,7 @@ class PartitionedOutputBufferManager;
 
 class HashJoinBridge;
 class NestedLoopJoinBridge;
+class OrderByBridge;
 class Task : public std::enable_shared_from_this<Task> {
  public:
   /// Creates a task to execute a plan fragment, but doesn't start execution
@@ -72,6 +74,16 @@ class Task : public std::enable_shared_from_this<Task> {
     spillDirectory_ = spillDirectory;
   }
 
+  /// Specifies multiple directories to spread the spilled data over, e.g.
+  /// several local disks with a remote overflow directory. Replaces the
+  /// directory set by setSpillDirectory(). All directories in 'directories'
+  /// are removed when 'this' is destroyed.
+  void setSpillDirectories(std::shared_ptr<SpillDirectorySet> directories) {
+    VELOX_CHECK_NOT_NULL(directories);
+    spillDirectory_ = directories->path(0);
+    spillDirectories_ = std::move(directories);
+  }
+
   std::string toString() const;
 
   std::string toJsonString() const;
@@ -186,6 +198,19 @@ class Task : public std::enable_shared_from_this<Task> {
   /// Note that, the operation is silently ignored if Task is not running.
   void addSplit(const core::PlanNodeId& planNodeId, exec::Split&& split);
 
+  /// Sets the predicted peak memory in bytes of the operators of the plan
+  /// node with 'planNodeId' summed over all of their drivers, e.g. from the
+  /// cardinality estimates of the planner or from earlier runs of the same
+  /// query. The operators that support it reserve their share of the
+  /// estimate when they start, see Operator::preReserveMemory(). Must be
+  /// called before start() to take effect.
+  void setMemoryEstimate(const core::PlanNodeId& planNodeId, uint64_t bytes);
+
+  /// Returns the memory estimate set for 'planNodeId' by setMemoryEstimate(),
+  /// or std::nullopt if there is none.
+  std::optional<uint64_t> memoryEstimate(
+      const core::PlanNodeId& planNodeId) const;
+
   /// We mark that for the given group there would be no more splits coming.
   void noMoreSplitsForGroup(
       const core::PlanNodeId& planNodeId,
@@ -325,7 +350,10 @@ class Task : public std::enable_shared_from_this<Task> {
   /// that will complete when split becomes available or no-more-splits
   /// signal is received. If 'maxPreloadSplits' is given, ensures that
   /// so many of splits at the head of the queue are preloading. If
-  /// they are not, calls preload on them to start preload.
+  /// they are not, calls preload on them to start preload. If 'divisible' is
+  /// true, the caller may divide the split it gets and must then call
+  /// addSplitParts(). Until then, other drivers wait instead of finishing when
+  /// there are no more splits.
   BlockingReason getSplitOrFuture(
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId,
@@ -333,7 +361,39 @@ class Task : public std::enable_shared_from_this<Task> {
       ContinueFuture& future,
       int32_t maxPreloadSplits = 0,
       std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload =
-          nullptr);
+          nullptr,
+      bool divisible = false);
+
+  /// Adds 'parts' of a split received from getSplitOrFuture() with
+  /// 'divisible' set to the queue of the source operator for 'planNodeId' so
+  /// that other drivers can read them. The parts are queued ahead of the
+  /// splits that have not started. 'parts' may be empty if the split was not
+  /// divided.
+  void addSplitParts(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId,
+      std::vector<exec::Split>&& parts);
+
+  /// Calls 'preload' on the splits among the first 'maxPreloadSplits' in
+  /// the queue of the source operator for 'planNodeId' that are not
+  /// preloading. This lets a source start opening its next splits while it
+  /// is still reading the current one.
+  void preloadSplits(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId,
+      int32_t maxPreloadSplits,
+      std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload);
+
+  /// Calls 'prefetch' on the splits among the first 'maxSplits' in the
+  /// queue of the source operator for 'planNodeId' that are neither
+  /// preloading nor had their metadata prefetched. Returns the number of
+  /// such splits.
+  int32_t prefetchSplitMetadata(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId,
+      int32_t maxSplits,
+      const std::function<void(std::shared_ptr<connector::ConnectorSplit>)>&
+          prefetch);
 
   void splitFinished();
 
@@ -358,6 +418,13 @@ class Task : public std::enable_shared_from_this<Task> {
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId);
 
+  /// Returns the number of rows produced so far by all drivers of the partial
+  /// Limit 'planNodeId' in 'splitGroupId'. Table scans below the limit stop
+  /// once this reaches the limit.
+  std::shared_ptr<std::atomic<int64_t>> getLimitRowCount(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId);
+
   void createLocalExchangeQueuesLocked(
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId,
@@ -421,6 +488,11 @@ class Task : public std::enable_shared_from_this<Task> {
       uint32_t splitGroupId,
       const std::vector<core::PlanNodeId>& planNodeIds);
 
+  /// Adds OrderByBridge's for all the specified plan node IDs.
+  void addOrderByBridgesLocked(
+      uint32_t splitGroupId,
+      const std::vector<core::PlanNodeId>& planNodeIds);
+
   /// Adds custom join bridges for all the specified plan nodes.
   void addCustomJoinBridgesLocked(
       uint32_t splitGroupId,
@@ -443,6 +515,12 @@ class Task : public std::enable_shared_from_this<Task> {
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId);
 
+  /// Returns the OrderByBridge for 'planNodeId' or nullptr if the OrderBy
+  /// does not feed a LocalMerge.
+  std::shared_ptr<OrderByBridge> getOrderByBridge(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId);
+
   /// Returns a custom join bridge for 'planNodeId'.
   std::shared_ptr<JoinBridge> getCustomJoinBridge(
       uint32_t splitGroupId,
@@ -571,6 +649,11 @@ class Task : public std::enable_shared_from_this<Task> {
     return spillDirectory_;
   }
 
+  /// Returns the spill directories set by setSpillDirectories() or nullptr.
+  SpillDirectorySet* spillDirectories() const {
+    return spillDirectories_.get();
+  }
+
   /// True if produces output via PartitionedOutputBufferManager.
   bool hasPartitionedOutput() const {
     return numDriversInPartitionedOutput_ > 0;
@@ -709,7 +792,16 @@ class Task : public std::enable_shared_from_this<Task> {
       ContinueFuture& future,
       int32_t maxPreloadSplits = 0,
       std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload =
-          nullptr);
+          nullptr,
+      bool divisible = false);
+
+  /// Calls 'preload' on the splits among the first 'maxPreloadSplits' of
+  /// 'splitsStore' that are not preloading.
+  void preloadSplitsLocked(
+      SplitsStore& splitsStore,
+      int32_t maxPreloadSplits,
+      const std::function<void(std::shared_ptr<connector::ConnectorSplit>)>&
+          preload);
 
   /// Returns next split from the store. The caller must ensure the store is not
   /// empty.
@@ -733,6 +825,10 @@ class Task : public std::enable_shared_from_this<Task> {
   /// processed. If yes, creates split group state and Drivers and runs them.
   void ensureSplitGroupsAreBeingProcessedLocked(std::shared_ptr<Task>& self);
 
+  // Returns true if another split group is expected to fit in memory next to
+  // the running ones. See QueryConfig::kSplitGroupMemoryAdmissionPct.
+  bool splitGroupFitsLocked() const;
+
   void driverClosedLocked();
 
   /// Returns true if Task is in kRunning state, but all output drivers finished
@@ -765,6 +861,18 @@ class Task : public std::enable_shared_from_this<Task> {
       SplitsStore& splitsStore,
       exec::Split&& split);
 
+  // Holds back 'driver' from starting if its pipeline scans a table and
+  // already has 'initialDrivers' started. Returns true if 'driver' is held
+  // back.
+  bool parkDriverLocked(
+      const std::shared_ptr<Driver>& driver,
+      uint32_t initialDrivers);
+
+  // Starts the held back drivers of the pipeline that scans 'planNodeId' if
+  // there are more queued splits than started drivers or no more splits are
+  // coming.
+  void startParkedDriversLocked(const core::PlanNodeId& planNodeId);
+
   // Invoked when all the driver threads are off thread. The function returns
   // 'threadFinishPromises_' to fulfill.
   std::vector<ContinuePromise> allThreadsFinishedLocked();
@@ -965,6 +1073,21 @@ class Task : public std::enable_shared_from_this<Task> {
   /// manage splits of the plan nodes that expect splits.
   std::unordered_map<core::PlanNodeId, SplitsState> splitsStates_;
 
+  struct ParkedDrivers {
+    // Drivers that are created but not started yet.
+    std::vector<std::shared_ptr<Driver>> drivers;
+    // Number of drivers of the pipeline that have been started.
+    uint32_t numStarted{0};
+  };
+
+  // Drivers of table scan pipelines held back by parkDriverLocked(), keyed on
+  // TableScan plan node id.
+  std::unordered_map<core::PlanNodeId, ParkedDrivers> parkedDrivers_;
+
+  // Predicted peak memory of the operators of a plan node over all drivers.
+  // Set by setMemoryEstimate().
+  std::unordered_map<core::PlanNodeId, uint64_t> memoryEstimates_;
+
   // Promises that are fulfilled when the task is completed (terminated).
   std::vector<ContinuePromise> taskCompletionPromises_;
 
@@ -1005,6 +1128,10 @@ class Task : public std::enable_shared_from_this<Task> {
 
   // Base spill directory for this task.
   std::string spillDirectory_;
+
+  // If set, the spill files are spread over these directories.
+  // 'spillDirectory_' is then the first of them.
+  std::shared_ptr<SpillDirectorySet> spillDirectories_;
 };
 
 /// Listener invoked on task completion.
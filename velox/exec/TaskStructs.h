@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #pragma once
+#include <atomic>
 #include <limits>
 #include <unordered_set>
 #include <vector>
@@ -53,6 +54,10 @@ struct SplitsStore {
   bool noMoreSplits{false};
   /// Blocking promises given out when out of splits to distribute.
   std::vector<ContinuePromise> splitPromises;
+  /// Number of distributed splits that may still be divided into parts which
+  /// are added back to 'splits'. Drivers wait for these instead of finishing
+  /// when there are no more splits.
+  int32_t numDividingSplits{0};
 };
 
 /// Structure contains the current info on splits for a particular plan node.
@@ -103,6 +108,11 @@ struct SplitGroupState {
   /// Map of local exchanges keyed on LocalPartition plan node ID.
   std::unordered_map<core::PlanNodeId, LocalExchangeState> localExchanges;
 
+  /// Rows produced by all drivers of a partial Limit, keyed on the Limit plan
+  /// node ID.
+  std::unordered_map<core::PlanNodeId, std::shared_ptr<std::atomic<int64_t>>>
+      limitRowCounts;
+
   /// Drivers created and still running for this split group.
   /// The split group is finished when this numbers reaches zero.
   uint32_t numRunningDrivers{0};
@@ -129,6 +139,7 @@ struct SplitGroupState {
     localMergeSources.clear();
     mergeJoinSources.clear();
     localExchanges.clear();
+    limitRowCounts.clear();
   }
 };
 
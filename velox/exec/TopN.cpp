@@ -14,10 +14,26 @@
  * limitations under the License.
  */
 #include "velox/exec/TopN.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/exec/Driver.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::exec {
+namespace {
+bool isIntegerKind(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+} // namespace
+
 TopN::TopN(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -36,15 +52,25 @@ TopN::TopN(
           topNNode->sortingOrders(),
           data_.get()),
       topRows_(comparator_),
-      decodedVectors_(outputType_->children().size()) {}
+      decodedVectors_(outputType_->children().size()),
+      firstKeyChannel_(
+          exprToChannel(topNNode->sortingKeys()[0].get(), outputType_)),
+      firstKeyOrder_(topNNode->sortingOrders()[0]),
+      filterByThreshold_(
+          isIntegerKind(outputType_->childAt(firstKeyChannel_)->kind())) {}
 
 void TopN::addInput(RowVectorPtr input) {
-  // TODO Decode keys first, then decode the rest only for passing positions
+  findCandidates(input);
+  if (!candidates_.hasSelections()) {
+    return;
+  }
   for (auto col = 0; col < input->childrenSize(); ++col) {
-    decodedVectors_[col].decode(*input->childAt(col));
+    if (col != firstKeyChannel_) {
+      decodedVectors_[col].decode(*input->childAt(col), candidates_);
+    }
   }
 
-  for (auto row = 0; row < input->size(); ++row) {
+  candidates_.applyToSelected([&](auto row) {
     char* newRow = nullptr;
     if (topRows_.size() < count_) {
       newRow = data_->newRow();
@@ -52,7 +78,7 @@ void TopN::addInput(RowVectorPtr input) {
       char* topRow = topRows_.top();
 
       if (!comparator_(decodedVectors_, row, topRow)) {
-        continue;
+        return;
       }
       topRows_.pop();
       // Reuse the topRow's memory.
@@ -64,7 +90,121 @@ void TopN::addInput(RowVectorPtr input) {
     }
 
     topRows_.push(newRow);
+  });
+
+  if (auto value = threshold()) {
+    pushdownThreshold(value.value());
+  }
+}
+
+void TopN::findCandidates(const RowVectorPtr& input) {
+  const auto size = input->size();
+  decodedVectors_[firstKeyChannel_].decode(*input->childAt(firstKeyChannel_));
+  candidates_.resize(size);
+  const auto value = threshold();
+  if (!value.has_value()) {
+    candidates_.setAll();
+    return;
+  }
+  switch (outputType_->childAt(firstKeyChannel_)->kind()) {
+    case TypeKind::TINYINT:
+      filterByThreshold<int8_t>(size, value.value());
+      break;
+    case TypeKind::SMALLINT:
+      filterByThreshold<int16_t>(size, value.value());
+      break;
+    case TypeKind::INTEGER:
+      filterByThreshold<int32_t>(size, value.value());
+      break;
+    case TypeKind::BIGINT:
+      filterByThreshold<int64_t>(size, value.value());
+      break;
+    default:
+      VELOX_UNREACHABLE();
+  }
+  addRuntimeStat(
+      "thresholdFilteredRows",
+      RuntimeCounter(size - candidates_.countSelected()));
+}
+
+template <typename T>
+void TopN::filterByThreshold(vector_size_t size, T threshold) {
+  const auto& keys = decodedVectors_[firstKeyChannel_];
+  const bool ascending = firstKeyOrder_.isAscending();
+  auto* bits = candidates_.asMutableRange().bits();
+  bits::fillBits(bits, 0, size, false);
+  vector_size_t row = 0;
+  if (keys.isIdentityMapping() && !keys.mayHaveNulls()) {
+    // Compares a batch of keys at a time. The batch size divides 64, so that
+    // the bits of a batch are in one word.
+    const auto* values = keys.data<T>();
+    const auto thresholds = xsimd::batch<T>::broadcast(threshold);
+    constexpr int32_t kBatchSize = xsimd::batch<T>::size;
+    for (; row + kBatchSize <= size; row += kBatchSize) {
+      const auto batch = xsimd::batch<T>::load_unaligned(values + row);
+      const uint32_t mask = simd::toBitMask(
+          ascending ? batch <= thresholds : batch >= thresholds);
+      bits[row / 64] |= static_cast<uint64_t>(mask) << (row % 64);
+    }
+  }
+  const bool nullsFirst = firstKeyOrder_.isNullsFirst();
+  for (; row < size; ++row) {
+    bool passed;
+    if (keys.isNullAt(row)) {
+      passed = nullsFirst;
+    } else {
+      const auto value = keys.valueAt<T>(row);
+      passed = ascending ? value <= threshold : value >= threshold;
+    }
+    if (passed) {
+      bits::setBit(bits, row);
+    }
+  }
+  candidates_.updateBounds();
+}
+
+std::optional<int64_t> TopN::threshold() const {
+  if (!filterByThreshold_ || topRows_.size() < count_) {
+    return std::nullopt;
+  }
+  const auto* row = topRows_.top();
+  const auto column = data_->columnAt(firstKeyChannel_);
+  if (RowContainer::isNullAt(row, column.nullByte(), column.nullMask())) {
+    return std::nullopt;
+  }
+  const auto* value = row + column.offset();
+  switch (outputType_->childAt(firstKeyChannel_)->kind()) {
+    case TypeKind::TINYINT:
+      return *reinterpret_cast<const int8_t*>(value);
+    case TypeKind::SMALLINT:
+      return *reinterpret_cast<const int16_t*>(value);
+    case TypeKind::INTEGER:
+      return *reinterpret_cast<const int32_t*>(value);
+    case TypeKind::BIGINT:
+      return *reinterpret_cast<const int64_t*>(value);
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+void TopN::pushdownThreshold(int64_t threshold) {
+  if (!canPushdownThreshold_.has_value()) {
+    // Filters or projections between the scan and this may drop rows but may
+    // not add rows that have no counterpart in the scan, as a join would.
+    auto* driver = operatorCtx_->driverCtx()->driver;
+    canPushdownThreshold_ = driver->mayPushdownAggregation(this) &&
+        driver->canPushdownFilters(this, {firstKeyChannel_})
+            .count(firstKeyChannel_);
+  }
+  if (!canPushdownThreshold_.value() || pushedThreshold_ == threshold) {
+    return;
   }
+  pushedThreshold_ = threshold;
+  const bool ascending = firstKeyOrder_.isAscending();
+  dynamicFilters_[firstKeyChannel_] = std::make_shared<common::BigintRange>(
+      ascending ? std::numeric_limits<int64_t>::min() : threshold,
+      ascending ? threshold : std::numeric_limits<int64_t>::max(),
+      firstKeyOrder_.isNullsFirst());
 }
 
 RowVectorPtr TopN::getOutput() {
@@ -65,5 +65,39 @@ class TopN : public Operator {
 
   std::vector<DecodedVector> decodedVectors_;
   vector_size_t outputBatchSize_;
+
+  // Once 'topRows_' is full, a row can only enter it if its first sorting key
+  // sorts at or before the first key of the row at the top. This key is the
+  // threshold. For integer first keys, addInput() compares the whole batch
+  // to the threshold and decodes and inserts only the rows that pass. The
+  // threshold is also pushed down to the table scan as a dynamic filter if
+  // all operators in between are filters.
+
+  // Sets 'candidates_' to the rows of 'input' that may enter 'topRows_'.
+  // Decodes the first sorting key of all rows.
+  void findCandidates(const RowVectorPtr& input);
+
+  template <typename T>
+  void filterByThreshold(vector_size_t size, T threshold);
+
+  // Returns the first sorting key of the row at the top of a full
+  // 'topRows_', or std::nullopt if it is null or cannot be used to filter.
+  std::optional<int64_t> threshold() const;
+
+  // Adds a dynamic filter for the rows that sort at or before 'threshold' if
+  // it is tighter than the filter pushed before.
+  void pushdownThreshold(int64_t threshold);
+
+  const column_index_t firstKeyChannel_;
+  const core::SortOrder firstKeyOrder_;
+
+  // True if the first sorting key is of an integer type.
+  const bool filterByThreshold_;
+
+  // True if the threshold may be pushed down. Set on first use.
+  std::optional<bool> canPushdownThreshold_;
+  std::optional<int64_t> pushedThreshold_;
+
+  SelectivityVector candidates_;
 };
 } // namespace facebook::velox::exec
@@ -14,9 +14,66 @@
  * limitations under the License.
  */
 #include "velox/exec/TopNRowNumber.h"
+#include "velox/common/testutil/TestValue.h"
+#include "velox/exec/OperatorUtils.h"
+
+using facebook::velox::common::testutil::TestValue;
 
 namespace facebook::velox::exec {
 
+namespace {
+// Returns the channels of the partition keys followed by the sorting keys
+// that are not partition keys.
+std::vector<column_index_t> keyChannels(
+    const core::TopNRowNumberNode& node,
+    const RowTypePtr& inputType) {
+  std::vector<column_index_t> channels;
+  for (const auto& key : node.partitionKeys()) {
+    channels.push_back(exprToChannel(key.get(), inputType));
+  }
+  for (const auto& key : node.sortingKeys()) {
+    const auto channel = exprToChannel(key.get(), inputType);
+    if (std::find(channels.begin(), channels.end(), channel) ==
+        channels.end()) {
+      channels.push_back(channel);
+    }
+  }
+  return channels;
+}
+
+// Returns 'keyChannels' followed by the other channels of 'inputType'.
+std::vector<column_index_t> allChannels(
+    std::vector<column_index_t> keyChannels,
+    const RowTypePtr& inputType) {
+  for (column_index_t i = 0; i < inputType->size(); ++i) {
+    if (std::find(keyChannels.begin(), keyChannels.end(), i) ==
+        keyChannels.end()) {
+      keyChannels.push_back(i);
+    }
+  }
+  return keyChannels;
+}
+
+RowTypePtr reorderColumns(
+    const RowTypePtr& inputType,
+    const std::vector<column_index_t>& channels) {
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (auto channel : channels) {
+    names.push_back(inputType->nameOf(channel));
+    types.push_back(inputType->childAt(channel));
+  }
+  return ROW(std::move(names), std::move(types));
+}
+
+std::vector<TypePtr> columnTypes(
+    const RowTypePtr& type,
+    size_t begin,
+    size_t end) {
+  return {type->children().begin() + begin, type->children().begin() + end};
+}
+} // namespace
+
 TopNRowNumber::TopNRowNumber(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -26,13 +83,23 @@ TopNRowNumber::TopNRowNumber(
           node->outputType(),
           operatorId,
           node->id(),
-          "TopNRowNumber"),
+          "TopNRowNumber",
+          node->canSpill(driverCtx->queryConfig())
+              ? driverCtx->makeSpillConfig(operatorId)
+              : std::nullopt),
       limit_{node->limit()},
       generateRowNumber_{node->generateRowNumber()},
       inputType_{node->sources()[0]->outputType()},
-      data_(std::make_unique<RowContainer>(inputType_->children(), pool())),
+      numPartitionKeys_{node->partitionKeys().size()},
+      inputChannels_{allChannels(keyChannels(*node, inputType_), inputType_)},
+      numKeys_{keyChannels(*node, inputType_).size()},
+      dataType_{reorderColumns(inputType_, inputChannels_)},
+      data_(std::make_unique<RowContainer>(
+          columnTypes(dataType_, 0, numKeys_),
+          columnTypes(dataType_, numKeys_, dataType_->size()),
+          pool())),
       comparator_(
-          inputType_,
+          dataType_,
           node->sortingKeys(),
           node->sortingOrders(),
           data_.get()),
@@ -68,13 +135,42 @@ TopNRowNumber::TopNRowNumber(
     resultProjections_.emplace_back(0, inputType_->size());
     results_.resize(1);
   }
+
+  if (canSpill()) {
+    // Partition keys only need to be adjacent, sorting keys are in the order
+    // of the node.
+    spillCompareFlags_.resize(numKeys_);
+    for (auto i = 0; i < node->sortingKeys().size(); ++i) {
+      const auto channel =
+          exprToChannel(node->sortingKeys()[i].get(), dataType_);
+      if (channel >= numPartitionKeys_) {
+        const auto& order = node->sortingOrders()[i];
+        spillCompareFlags_[channel] = {
+            order.isNullsFirst(),
+            order.isAscending(),
+            false,
+            CompareFlags::NullHandlingMode::NoStop};
+      }
+    }
+    for (column_index_t i = 0; i < dataType_->size(); ++i) {
+      spillColumnMap_.emplace_back(i, inputChannels_[i]);
+    }
+  }
 }
 
 void TopNRowNumber::addInput(RowVectorPtr input) {
+  if (canSpill() && testingTriggerSpill()) {
+    spill();
+  }
+
+  // Prevents the memory arbitrator to reclaim memory from this operator during
+  // the execution below.
+  NonReclaimableSection guard(this);
+
   const auto numInput = input->size();
 
-  for (auto i = 0; i < inputType_->size(); ++i) {
-    decodedVectors_[i].decode(*input->childAt(i));
+  for (auto i = 0; i < inputChannels_.size(); ++i) {
+    decodedVectors_[i].decode(*input->childAt(inputChannels_[i]));
   }
 
   if (table_) {
@@ -147,6 +243,18 @@ void TopNRowNumber::noMoreInput() {
 
   outputBatchSize_ = outputBatchRows(rowSize);
   outputRows_.resize(outputBatchSize_);
+
+  if (spiller_ != nullptr) {
+    // The rows in memory are merged with the spilled runs. They are sorted by
+    // the spiller, so the partitions are not needed anymore.
+    const auto nonSpilledRows = spiller_->finishSpill();
+    VELOX_CHECK(nonSpilledRows.empty());
+    recordSpillStats(spiller_->stats());
+    merger_ = spiller_->startMerge(0);
+    spillSources_.resize(outputBatchSize_);
+    spillSourceRows_.resize(outputBatchSize_);
+    previousPartition_ = BaseVector::create<RowVector>(dataType_, 1, pool());
+  }
 }
 
 TopNRowNumber::TopRows* TopNRowNumber::nextPartition() {
@@ -214,6 +322,10 @@ RowVectorPtr TopNRowNumber::getOutput() {
     return nullptr;
   }
 
+  if (merger_ != nullptr) {
+    return getOutputFromSpill();
+  }
+
   // Loop over partitions and emit sorted rows along with row numbers.
   auto output =
       BaseVector::create<RowVector>(outputType_, outputBatchSize_, pool());
@@ -267,10 +379,92 @@ RowVectorPtr TopNRowNumber::getOutput() {
   }
   output->resize(offset);
 
-  for (int i = 0; i < inputType_->size(); ++i) {
-    data_->extractColumn(outputRows_.data(), offset, i, output->childAt(i));
+  for (int i = 0; i < inputChannels_.size(); ++i) {
+    data_->extractColumn(
+        outputRows_.data(), offset, i, output->childAt(inputChannels_[i]));
+  }
+
+  return output;
+}
+
+bool TopNRowNumber::isSamePartition(
+    const RowVector& row,
+    vector_size_t index) const {
+  if (!hasPreviousPartition_) {
+    return false;
+  }
+  for (auto i = 0; i < numPartitionKeys_; ++i) {
+    if (!row.childAt(i)->equalValueAt(
+            previousPartition_->childAt(i).get(), index, 0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RowVectorPtr TopNRowNumber::getOutputFromSpill() {
+  auto output =
+      BaseVector::create<RowVector>(outputType_, outputBatchSize_, pool());
+  FlatVector<int64_t>* rowNumbers = nullptr;
+  if (generateRowNumber_) {
+    rowNumbers = output->children().back()->as<FlatVector<int64_t>>();
+  }
+
+  vector_size_t outputRow = 0;
+  vector_size_t numPending = 0;
+  // Copies the pending rows before their source batch is replaced.
+  auto copyPending = [&]() {
+    gatherCopy(
+        output.get(),
+        outputRow,
+        numPending,
+        spillSources_,
+        spillSourceRows_,
+        spillColumnMap_);
+    outputRow += numPending;
+    numPending = 0;
+  };
+
+  while (outputRow + numPending < outputBatchSize_) {
+    auto* stream = merger_->next();
+    if (stream == nullptr) {
+      break;
+    }
+    bool isEndOfBatch = false;
+    const auto& row = stream->current();
+    const auto index = stream->currentIndex(&isEndOfBatch);
+    if (!isSamePartition(row, index)) {
+      for (auto i = 0; i < numPartitionKeys_; ++i) {
+        previousPartition_->childAt(i)->copy(
+            row.childAt(i).get(), 0, index, 1);
+      }
+      hasPreviousPartition_ = true;
+      numPreviousPartitionRows_ = 0;
+    }
+    if (numPreviousPartitionRows_ < limit_) {
+      ++numPreviousPartitionRows_;
+      if (rowNumbers) {
+        rowNumbers->set(outputRow + numPending, numPreviousPartitionRows_);
+      }
+      spillSources_[numPending] = &row;
+      spillSourceRows_[numPending] = index;
+      ++numPending;
+    }
+    if (isEndOfBatch) {
+      copyPending();
+    }
+    stream->pop();
   }
+  copyPending();
 
+  if (outputRow == 0) {
+    finished_ = true;
+    return nullptr;
+  }
+  if (rowNumbers) {
+    rowNumbers->resize(outputRow);
+  }
+  output->resize(outputRow);
   return output;
 }
 
@@ -278,7 +472,7 @@ bool TopNRowNumber::isFinished() {
   return finished_;
 }
 
-void TopNRowNumber::close() {
+void TopNRowNumber::destroyPartitions() {
   if (table_) {
     partitionIt_.reset();
     partitions_.resize(1000);
@@ -295,4 +489,80 @@ void TopNRowNumber::close() {
   }
 }
 
+void TopNRowNumber::close() {
+  destroyPartitions();
+  merger_.reset();
+  Operator::close();
+}
+
+bool TopNRowNumber::testingTriggerSpill() {
+  // Test-only spill path.
+  if (spillConfig_->testSpillPct == 0) {
+    return false;
+  }
+  return folly::hasher<uint64_t>()(++spillTestCounter_) % 100 <=
+      spillConfig_->testSpillPct;
+}
+
+void TopNRowNumber::spill() {
+  VELOX_CHECK(canSpill());
+  if (data_->numRows() == 0) {
+    return;
+  }
+
+  if (spiller_ == nullptr) {
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kOrderBy,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        dataType_,
+        numKeys_,
+        spillCompareFlags_,
+        spillConfig_->filePath,
+        spillConfig_->maxFileSize,
+        spillConfig_->minSpillRunSize,
+        spillConfig_->compressionKind,
+        Spiller::pool(),
+        spillConfig_->executor,
+        spillConfig_->format,
+        spillConfig_->directories);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+
+  // Spills the top rows of all partitions as one sorted run. The partitions
+  // point to the spilled rows, so they start over.
+  spiller_->spill(0, 0);
+  VELOX_CHECK_EQ(data_->numRows(), 0);
+  data_->clear();
+  destroyPartitions();
+  partitionIt_.reset();
+  if (table_) {
+    table_->clear();
+  } else {
+    singlePartition_ = std::make_unique<TopRows>(allocator_.get(), comparator_);
+  }
+}
+
+void TopNRowNumber::reclaim(uint64_t /*targetBytes*/) {
+  VELOX_CHECK(canReclaim());
+
+  TestValue::adjust("facebook::velox::exec::TopNRowNumber::reclaim", this);
+
+  // NOTE: a top n row number operator is reclaimable if it hasn't started
+  // output processing and is not under non-reclaimable execution section.
+  if (noMoreInput_ || nonReclaimableSection_) {
+    // TODO: add stats to record the non-reclaimable case and reduce the log
+    // frequency if it is too verbose.
+    LOG(WARNING) << "Can't reclaim from top n row number operator, "
+                 << "noMoreInput_[" << noMoreInput_
+                 << "], nonReclaimableSection_[" << nonReclaimableSection_
+                 << "], " << toString();
+    return;
+  }
+
+  spill();
+  // Release the minimum reserved memory.
+  pool()->release();
+}
+
 } // namespace facebook::velox::exec
@@ -34,6 +34,15 @@ namespace facebook::velox::exec {
 ///
 /// This is an optimized version of a Window operator with a single row_number
 /// window function followed by a row_number <= N filter.
+///
+/// Without the row number column, the operator computes partial results: it
+/// can run before a shuffle on the partition keys to cut the exchanged rows to
+/// 'limit' per partition and source, followed by the final operator.
+///
+/// If spilling is enabled, the operator spills the top rows of all partitions
+/// as a run sorted by partition and sorting keys, and starts over with no
+/// partitions. At the end of input, the runs and the rows in memory are
+/// merged and the first 'limit' rows of each partition are returned.
 class TopNRowNumber : public Operator {
  public:
   TopNRowNumber(
@@ -59,6 +68,8 @@ class TopNRowNumber : public Operator {
 
   void close() override;
 
+  void reclaim(uint64_t targetBytes) override;
+
  private:
   /// A priority queue to keep track of top 'limit' rows for a given partition.
   struct TopRows {
@@ -96,6 +107,24 @@ class TopNRowNumber : public Operator {
   /// Returns partition that was partially added to the previous output batch.
   TopRows& currentPartition();
 
+  /// Destroys the TopRows of all partitions.
+  void destroyPartitions();
+
+  /// Spills all rows in 'data_' and clears the partitions.
+  void spill();
+
+  /// Returns true if the test-only spill path should spill before the next
+  /// input.
+  bool testingTriggerSpill();
+
+  /// Returns the next batch of rows merged from the spilled runs and the rows
+  /// in memory, or nullptr if there are no more rows.
+  RowVectorPtr getOutputFromSpill();
+
+  /// Returns true if row 'index' of 'row' has the same partition keys as the
+  /// previous row returned by 'merger_'.
+  bool isSamePartition(const RowVector& row, vector_size_t index) const;
+
   /// Appends partition rows to outputRows_ and optionally populates row
   /// numbers.
   void appendPartitionRows(
@@ -108,6 +137,17 @@ class TopNRowNumber : public Operator {
   const int32_t limit_;
   const bool generateRowNumber_;
   const RowTypePtr inputType_;
+  const size_t numPartitionKeys_;
+
+  /// The columns of 'data_' are the partition keys, the sorting keys that are
+  /// not partition keys and the other input columns. 'data_' column i has
+  /// input column 'inputChannels_[i]'. The partition and sorting keys are the
+  /// keys of 'data_', which are also the sort keys of the spilled runs.
+  const std::vector<column_index_t> inputChannels_;
+  const size_t numKeys_;
+
+  /// Type of the rows of 'data_' and of the spilled runs.
+  const RowTypePtr dataType_;
 
   /// Hash table to keep track of partitions. Not used if there are no
   /// partitioning keys. For each partition, stores an instance of TopRows
@@ -143,5 +183,23 @@ class TopNRowNumber : public Operator {
   size_t numPartitions_{0};
   std::optional<int32_t> currentPartition_;
   vector_size_t remainingRowsInPartition_{0};
+
+  std::vector<CompareFlags> spillCompareFlags_;
+  std::unique_ptr<Spiller> spiller_;
+  uint64_t spillTestCounter_{0};
+
+  /// Merges the spilled runs after the end of input.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> merger_;
+
+  /// The partition keys of the last row read from 'merger_'.
+  RowVectorPtr previousPartition_;
+  bool hasPreviousPartition_{false};
+  /// Number of rows returned from the partition of 'previousPartition_'.
+  int32_t numPreviousPartitionRows_{0};
+
+  /// Maps the columns of the spilled runs to the output columns.
+  std::vector<IdentityProjection> spillColumnMap_;
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
 };
 } // namespace facebook::velox::exec
@@ -120,6 +120,21 @@ class TreeOfLosers {
     return lastIndex_ == kEmpty ? nullptr : streams_[lastIndex_].get();
   }
 
+  // Returns the stream with the lowest first element and the stream with the
+  // next lowest first element, which is nullptr if no other stream has
+  // data. The caller may pop off all elements of the first stream that are
+  // not greater than the first element of the second before calling this
+  // again. A run of consecutive elements from one stream then costs one
+  // comparison per element instead of a pass up the tree. Returns {nullptr,
+  // nullptr} when all streams are at end.
+  std::pair<Stream*, Stream*> nextWithRunnerUp() {
+    auto* winner = next();
+    if (winner == nullptr || values_.empty()) {
+      return {winner, nullptr};
+    }
+    return {winner, runnerUp()};
+  }
+
   // Returns the stream with the lowest first element and a flag that
   // is true if there is another equal value to come from some other
   // stream. The streams should have ordered unique values when using
@@ -236,6 +251,22 @@ class TreeOfLosers {
     }
   }
 
+  // Returns the lowest of the losers on the path from the last winner to the
+  // root. The runner-up lost only to the winner, so it is one of these.
+  Stream* runnerUp() const {
+    TIndex result = kEmpty;
+    TIndex node = firstStream_ + lastIndex_;
+    do {
+      node = parent(node);
+      const auto loser = values_[node];
+      if (loser != kEmpty &&
+          (result == kEmpty || *streams_[loser] < *streams_[result])) {
+        result = loser;
+      }
+    } while (node != 0);
+    return result == kEmpty ? nullptr : streams_[result].get();
+  }
+
   FOLLY_ALWAYS_INLINE IndexAndFlag
   propagateWithEquals(TIndex node, TIndex valueIndex) {
     auto value = indexAndFlag(valueIndex, false);
@@ -855,4 +855,36 @@ std::vector<std::unique_ptr<VectorHasher>> createVectorHashers(
   return hashers;
 }
 
+void attachKeyHashes(
+    RowVector& input,
+    const std::vector<column_index_t>& keyChannels,
+    BufferPtr hashes) {
+  VELOX_CHECK_GE(hashes->size(), input.size() * sizeof(uint64_t));
+  auto keyHashes = std::make_shared<RowKeyHashes>();
+  keyHashes->keys.reserve(keyChannels.size());
+  for (auto channel : keyChannels) {
+    keyHashes->keys.push_back(input.childAt(channel));
+  }
+  keyHashes->hashes = std::move(hashes);
+  input.setKeyHashes(std::move(keyHashes));
+}
+
+const uint64_t* attachedKeyHashes(
+    const RowVector& input,
+    const std::vector<std::unique_ptr<VectorHasher>>& hashers) {
+  const auto& keyHashes = input.keyHashes();
+  if (keyHashes == nullptr || keyHashes->keys.size() != hashers.size() ||
+      keyHashes->hashes->size() < input.size() * sizeof(uint64_t)) {
+    return nullptr;
+  }
+  for (auto i = 0; i < hashers.size(); ++i) {
+    const auto channel = hashers[i]->channel();
+    if (channel == kConstantChannel || channel >= input.childrenSize() ||
+        input.childAt(channel) != keyHashes->keys[i]) {
+      return nullptr;
+    }
+  }
+  return keyHashes->hashes->as<uint64_t>();
+}
+
 } // namespace facebook::velox::exec
@@ -694,6 +694,21 @@ std::vector<std::unique_ptr<VectorHasher>> createVectorHashers(
     const RowTypePtr& rowType,
     const std::vector<core::FieldAccessTypedExprPtr>& keys);
 
+/// Attaches 'hashes' to 'input' as the hashes of its children at
+/// 'keyChannels'. See RowKeyHashes.
+void attachKeyHashes(
+    RowVector& input,
+    const std::vector<column_index_t>& keyChannels,
+    BufferPtr hashes);
+
+/// Returns the hashes attached to 'input' if they are over the channels of
+/// 'hashers' in order and these children of 'input' have not been replaced
+/// since, nullptr otherwise. The hashes are then the same as VectorHasher::
+/// hash() over 'hashers' would compute for all rows of 'input'.
+const uint64_t* FOLLY_NULLABLE attachedKeyHashes(
+    const RowVector& input,
+    const std::vector<std::unique_ptr<VectorHasher>>& hashers);
+
 } // namespace facebook::velox::exec
 
 #include "velox/exec/VectorHasher-inl.h"
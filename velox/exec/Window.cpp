@@ -16,10 +16,25 @@
 #include "velox/exec/Window.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/SortWindowBuild.h"
+#include "velox/exec/StreamingWindowBuild.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
 
+namespace {
+std::unique_ptr<WindowBuild> makeWindowBuild(
+    const std::shared_ptr<const core::WindowNode>& windowNode,
+    memory::MemoryPool* pool,
+    const Spiller::Config* spillConfig,
+    tsan_atomic<bool>* nonReclaimableSection) {
+  if (windowNode->inputsSorted()) {
+    return std::make_unique<StreamingWindowBuild>(windowNode, pool);
+  }
+  return std::make_unique<SortWindowBuild>(
+      windowNode, pool, spillConfig, nonReclaimableSection);
+}
+} // namespace
+
 Window::Window(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -29,9 +44,16 @@ Window::Window(
           windowNode->outputType(),
           operatorId,
           windowNode->id(),
-          "Window"),
+          "Window",
+          windowNode->canSpill(driverCtx->queryConfig())
+              ? driverCtx->makeSpillConfig(operatorId)
+              : std::nullopt),
       numInputColumns_(windowNode->sources()[0]->outputType()->size()),
-      windowBuild_(std::make_unique<SortWindowBuild>(windowNode, pool())),
+      windowBuild_(makeWindowBuild(
+          windowNode,
+          pool(),
+          spillConfig_.has_value() ? &spillConfig_.value() : nullptr,
+          &nonReclaimableSection_)),
       windowNode_(windowNode),
       currentPartition_(nullptr),
       stringAllocator_(pool()) {}
@@ -168,6 +190,26 @@ void Window::noMoreInput() {
     return;
   }
   windowBuild_->noMoreInput();
+  if (auto spillStats = windowBuild_->spilledStats()) {
+    recordSpillStats(spillStats.value());
+  }
+}
+
+void Window::reclaim(uint64_t /*targetBytes*/) {
+  VELOX_CHECK(canReclaim());
+
+  // NOTE: a window operator is reclaimable if it hasn't started output
+  // processing and is not under non-reclaimable execution section.
+  if (noMoreInput_ || nonReclaimableSection_) {
+    LOG(WARNING) << "Can't reclaim from window operator, noMoreInput_["
+                 << noMoreInput_ << "], nonReclaimableSection_["
+                 << nonReclaimableSection_ << "], " << toString();
+    return;
+  }
+
+  windowBuild_->spill();
+  // Release the minimum reserved memory.
+  pool()->release();
 }
 
 void Window::callResetPartition() {
@@ -433,7 +475,7 @@ void Window::callApplyForPartitionRows(
   partitionOffset_ += numRows;
 }
 
-void Window::callApplyLoop(
+vector_size_t Window::callApplyLoop(
     vector_size_t numOutputRows,
     const RowVectorPtr& result) {
   // Compute outputs by traversing as many partitions as possible. This
@@ -475,6 +517,7 @@ void Window::callApplyLoop(
       break;
     }
   }
+  return numOutputRows - numOutputRowsLeft;
 }
 
 RowVectorPtr Window::getOutput() {
@@ -506,7 +549,12 @@ RowVectorPtr Window::getOutput() {
   }
 
   // Compute the output values of window functions.
-  callApplyLoop(numOutputRows, result);
+  const auto numResultRows = callApplyLoop(numOutputRows, result);
+  if (numResultRows < numOutputRows) {
+    // A streaming WindowBuild may have fewer rows in complete partitions than
+    // the rows not yet output.
+    result->resize(numResultRows);
+  }
   return result;
 }
 
@@ -33,8 +33,11 @@ namespace facebook::velox::exec {
 /// It is also sorted in the order required for the WindowFunction
 /// to process it.
 ///
-/// We will revise this algorithm in the future using a HashTable based
-/// approach pending some profiling results.
+/// If the input is already clustered by the partition keys and sorted by the
+/// order by keys, e.g. after a MergeJoin or a LocalMerge, the WindowNode is
+/// marked 'inputsSorted' and the partitions are computed one at a time as
+/// the input arrives, holding only the rows of the partitions not yet
+/// output.
 class Window : public Operator {
  public:
   Window(
@@ -64,6 +67,8 @@ class Window : public Operator {
     return noMoreInput_ && numRows_ == numProcessedRows_;
   }
 
+  void reclaim(uint64_t targetBytes) override;
+
  private:
   // Used for k preceding/following frames. Index is the column index if k is a
   // column. value is used to read column values from the column index when k
@@ -121,8 +126,11 @@ class Window : public Operator {
 
   // Computes the result vector for a single output block. The result
   // consists of all the input columns followed by the results of the
-  // window function.
-  void callApplyLoop(vector_size_t numOutputRows, const RowVectorPtr& result);
+  // window function. Returns the number of rows computed, which is less than
+  // 'numOutputRows' if the WindowBuild runs out of complete partitions.
+  vector_size_t callApplyLoop(
+      vector_size_t numOutputRows,
+      const RowVectorPtr& result);
 
   // Converts WindowNode::Frame to Window::WindowFrame.
   WindowFrame createWindowFrame(
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spill.h"
 #include "velox/exec/WindowPartition.h"
 
 namespace facebook::velox::exec {
@@ -62,6 +63,17 @@ class WindowBuild {
   // if called when no partition is available.
   virtual std::unique_ptr<WindowPartition> nextPartition() = 0;
 
+  // Spills all the input rows received so far. Only supported by builds
+  // created with a spill config.
+  virtual void spill() {
+    VELOX_UNSUPPORTED("This window build does not support spilling");
+  }
+
+  // Returns the spiller stats if spilling has been triggered.
+  virtual std::optional<SpillStats> spilledStats() const {
+    return std::nullopt;
+  }
+
   // Returns the average size of input rows in bytes stored in the
   // data container of the WindowBuild.
   std::optional<int64_t> estimateRowSize() {
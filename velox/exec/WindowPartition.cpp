@@ -109,21 +109,116 @@ WindowPartition::extractNulls(
                    : std::nullopt;
 }
 
-bool WindowPartition::compareRowsWithSortKeys(const char* lhs, const char* rhs)
-    const {
-  if (lhs == rhs) {
-    return false;
+namespace {
+
+// Smallest number of rows compared at a time when looking for the end of a
+// peer group past the rows whose peer buffers are computed.
+constexpr vector_size_t kMinPeerBlockRows = 64;
+
+// Sets the bit for each row in [begin, end) of 'rows' whose value of
+// 'column' differs from the value in the previous row. The bits are
+// relative to 'begin'. Rows whose bit is already set are not compared.
+template <typename T>
+void markValueChanges(
+    char* const* rows,
+    RowColumn column,
+    vector_size_t begin,
+    vector_size_t end,
+    uint64_t* bits) {
+  const auto offset = column.offset();
+  const auto nullByte = column.nullByte();
+  const auto nullMask = column.nullMask();
+  for (auto i = begin; i < end; ++i) {
+    if (bits::isBitSet(bits, i - begin)) {
+      continue;
+    }
+    const char* previous = rows[i - 1];
+    const char* current = rows[i];
+    const bool previousNull =
+        RowContainer::isNullAt(previous, nullByte, nullMask);
+    const bool currentNull =
+        RowContainer::isNullAt(current, nullByte, nullMask);
+    if (previousNull != currentNull ||
+        (!previousNull &&
+         *reinterpret_cast<const T*>(previous + offset) !=
+             *reinterpret_cast<const T*>(current + offset))) {
+      bits::setBit(bits, i - begin);
+    }
+  }
+}
+
+} // namespace
+
+void WindowPartition::markPeerBoundaries(
+    vector_size_t begin,
+    vector_size_t end,
+    uint64_t* bits) const {
+  VELOX_DCHECK_GT(begin, 0);
+  bits::fillBits(bits, 0, end - begin, false);
+  for (const auto& [channel, _] : sortKeyInfo_) {
+    const auto column = data_->columnAt(channel);
+    switch (data_->columnTypes()[channel]->kind()) {
+      case TypeKind::BOOLEAN:
+        markValueChanges<bool>(partition_.data(), column, begin, end, bits);
+        break;
+      case TypeKind::TINYINT:
+        markValueChanges<int8_t>(partition_.data(), column, begin, end, bits);
+        break;
+      case TypeKind::SMALLINT:
+        markValueChanges<int16_t>(partition_.data(), column, begin, end, bits);
+        break;
+      case TypeKind::INTEGER:
+        markValueChanges<int32_t>(partition_.data(), column, begin, end, bits);
+        break;
+      case TypeKind::BIGINT:
+        markValueChanges<int64_t>(partition_.data(), column, begin, end, bits);
+        break;
+      case TypeKind::TIMESTAMP:
+        markValueChanges<Timestamp>(
+            partition_.data(), column, begin, end, bits);
+        break;
+      default:
+        // Floating point values that are equal as keys may differ in their
+        // bits or compare unequal as values, e.g. NaN. Strings and complex
+        // types may not be contiguous.
+        for (auto i = begin; i < end; ++i) {
+          if (!bits::isBitSet(bits, i - begin) &&
+              data_->compare(partition_[i - 1], partition_[i], channel) !=
+                  0) {
+            bits::setBit(bits, i - begin);
+          }
+        }
+    }
+  }
+}
+
+vector_size_t WindowPartition::findPeerGroupEnd(
+    vector_size_t row,
+    vector_size_t end,
+    PeerBoundaries& boundaries) const {
+  const auto numPartitionRows = numRows();
+  if (sortKeyInfo_.empty()) {
+    return numPartitionRows;
   }
-  for (auto& key : sortKeyInfo_) {
-    if (auto result = data_->compare(
-            lhs,
-            rhs,
-            key.first,
-            {key.second.isNullsFirst(), key.second.isAscending(), false})) {
-      return result < 0;
+  auto begin = row + 1;
+  while (begin < numPartitionRows) {
+    if (begin < boundaries.begin || begin >= boundaries.end) {
+      boundaries.begin = begin;
+      boundaries.end = std::min<vector_size_t>(
+          numPartitionRows, std::max(end, begin + kMinPeerBlockRows));
+      boundaries.bits.resize(bits::nwords(boundaries.end - begin));
+      markPeerBoundaries(begin, boundaries.end, boundaries.bits.data());
     }
+    const auto boundary = bits::findFirstBit(
+        boundaries.bits.data(),
+        begin - boundaries.begin,
+        boundaries.end - boundaries.begin);
+    if (boundary >= 0) {
+      return boundaries.begin + boundary;
+    }
+    begin = boundaries.end;
   }
-  return false;
+  return numPartitionRows;
 }
 
 std::pair<vector_size_t, vector_size_t> WindowPartition::computePeerBuffers(
@@ -133,40 +228,33 @@ std::pair<vector_size_t, vector_size_t> WindowPartition::computePeerBuffers(
     vector_size_t prevPeerEnd,
     vector_size_t* rawPeerStarts,
     vector_size_t* rawPeerEnds) const {
-  auto peerCompare = [&](const char* lhs, const char* rhs) -> bool {
-    return compareRowsWithSortKeys(lhs, rhs);
-  };
-
   VELOX_CHECK_LE(end, numRows());
 
-  auto lastPartitionRow = numRows() - 1;
+  // When traversing input partition rows, the peers are the rows with the
+  // same values for the ORDER BY clause. These rows are equal in some ways
+  // and affect the results of ranking functions. All rows between peerStart
+  // and peerEnd have the same values for rawPeerStarts and rawPeerEnds, so
+  // these are filled in for the whole peer group at once. The ends of the
+  // peer groups come from comparing adjacent rows column by column in
+  // blocks of rows. Note: peerStart and peerEnd can be maintained across
+  // getOutput calls. Hence, they are returned to the caller.
   auto peerStart = prevPeerStart;
   auto peerEnd = prevPeerEnd;
-  for (auto i = start, j = 0; i < end; i++, j++) {
-    // When traversing input partition rows, the peers are the rows
-    // with the same values for the ORDER BY clause. These rows
-    // are equal in some ways and affect the results of ranking functions.
-    // This logic exploits the fact that all rows between the peerStart
-    // and peerEnd have the same values for rawPeerStarts and rawPeerEnds.
-    // So we can compute them just once and reuse across the rows in that peer
-    // interval. Note: peerStart and peerEnd can be maintained across
-    // getOutput calls. Hence, they are returned to the caller.
-
+  PeerBoundaries boundaries;
+  vector_size_t i = start;
+  while (i < end) {
     if (i == 0 || i >= peerEnd) {
       // Compute peerStart and peerEnd rows for the first row of the partition
       // or when past the previous peerGroup.
       peerStart = i;
-      peerEnd = i;
-      while (peerEnd <= lastPartitionRow) {
-        if (peerCompare(partition_[peerStart], partition_[peerEnd])) {
-          break;
-        }
-        peerEnd++;
-      }
+      peerEnd = findPeerGroupEnd(i, end, boundaries);
     }
-
-    rawPeerStarts[j] = peerStart;
-    rawPeerEnds[j] = peerEnd - 1;
+    const auto groupEnd = std::min(peerEnd, end);
+    std::fill(
+        rawPeerStarts + i - start, rawPeerStarts + groupEnd - start, peerStart);
+    std::fill(
+        rawPeerEnds + i - start, rawPeerEnds + groupEnd - start, peerEnd - 1);
+    i = groupEnd;
   }
   return {peerStart, peerEnd};
 }
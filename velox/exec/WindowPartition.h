@@ -108,7 +108,31 @@ class WindowPartition {
       vector_size_t* rawPeerEnds) const;
 
  private:
-  bool compareRowsWithSortKeys(const char* lhs, const char* rhs) const;
+  // Peer group boundaries of a block of consecutive rows.
+  struct PeerBoundaries {
+    // Bit 'i' is set if row 'begin + i' starts a peer group.
+    std::vector<uint64_t> bits;
+    vector_size_t begin{0};
+    vector_size_t end{0};
+  };
+
+  // Sets bit 'i - begin' of 'bits' for each row 'i' in [begin, end) that
+  // starts a new peer group, i.e. differs from row 'i - 1' in some of the
+  // order by columns. Compares the rows one column at a time. 'begin' must
+  // be > 0.
+  void markPeerBoundaries(
+      vector_size_t begin,
+      vector_size_t end,
+      uint64_t* bits) const;
+
+  // Returns the first row after 'row' that is not a peer of 'row', or
+  // numRows() if there is none. Marks the boundaries of the rows up to 'end'
+  // in one block and of the rows after in smaller blocks. 'boundaries' keeps
+  // the last block for the next call.
+  vector_size_t findPeerGroupEnd(
+      vector_size_t row,
+      vector_size_t end,
+      PeerBoundaries& boundaries) const;
 
   // The RowContainer associated with the partition.
   // It is owned by the WindowBuild that creates the partition.
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/parse/TypeResolver.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+/// Benchmark for the cost of a Driver going off and on thread. A pipeline of
+/// 'kNumProjects' projections reads tiny batches from a local exchange, so
+/// that the Driver blocks on the exchange after almost every batch. Compares
+/// walking the pipeline from the last operator on each resume with resuming
+/// at the blocked operator. The benchmarks report batches per second.
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+namespace {
+constexpr int32_t kNumBatches = 10'000;
+constexpr int32_t kBatchSize = 4;
+constexpr int32_t kNumProjects = 20;
+
+class DriverBenchmark : public VectorTestBase {
+ public:
+  DriverBenchmark() {
+    for (auto i = 0; i < kNumBatches; ++i) {
+      batches_.push_back(makeRowVector({makeFlatVector<int64_t>(
+          kBatchSize, [i](auto row) { return i + row; })}));
+    }
+  }
+
+  void makeBenchmark(const std::string& name, bool resumeAtBlockedOperator) {
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    exec::test::PlanBuilder builder(planNodeIdGenerator);
+    builder.localPartitionRoundRobin({exec::test::PlanBuilder(
+                                          planNodeIdGenerator)
+                                          .values(batches_)
+                                          .planNode()});
+    for (auto i = 0; i < kNumProjects; ++i) {
+      builder.project({"c0 + 1 AS c0"});
+    }
+    auto plan =
+        builder.singleAggregation({}, {"count(1)", "sum(c0)"}).planNode();
+    folly::addBenchmark(
+        __FILE__, name, [plan, resumeAtBlockedOperator, this]() {
+          exec::test::AssertQueryBuilder(plan)
+              .config(
+                  core::QueryConfig::kDriverResumeAtBlockedOperator,
+                  resumeAtBlockedOperator ? "true" : "false")
+              .copyResults(pool_.get());
+          return kNumBatches;
+        });
+  }
+
+ private:
+  std::vector<RowVectorPtr> batches_;
+};
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  functions::prestosql::registerAllScalarFunctions();
+  aggregate::prestosql::registerAllAggregateFunctions();
+  parse::registerTypeResolver();
+
+  DriverBenchmark benchmark;
+  benchmark.makeBenchmark("resumeAtLastOperator", false);
+  benchmark.makeBenchmark("resumeAtBlockedOperator", true);
+  folly::runBenchmarks();
+  return 0;
+}
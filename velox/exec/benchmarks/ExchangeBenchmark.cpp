@@ -13,7 +13,11 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <sys/resource.h>
+
 #include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/String.h>
 #include <folly/init/Init.h>
 
 #include "velox/core/QueryConfig.h"
@@ -23,6 +27,8 @@
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/LocalExchangeSource.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+#include "velox/exec/tests/utils/TcpExchangeSource.h"
 #include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
 #include "velox/parse/TypeResolver.h"
@@ -41,6 +47,42 @@ DEFINE_int64(
     "task-wide buffer in local exchange");
 DEFINE_int64(exchange_buffer_mb, 32, "task-wide buffer in remote exchange");
 
+DEFINE_string(
+    exchange_transport,
+    "local",
+    "Transport of the remote exchanges: 'local' reads the producer buffers "
+    "in process, 'tcp' sends the pages over TCP sockets");
+DEFINE_string(
+    tcp_exchange_host,
+    "127.0.0.1",
+    "IPv4 address the TCP exchange server listens on. Use the address of a "
+    "NIC instead of loopback to go through the NIC");
+DEFINE_int32(tcp_exchange_port, 0, "TCP exchange server port, 0 for any");
+DEFINE_string(
+    exchange_role,
+    "all",
+    "'all' runs the benchmarks in this process. 'producer' serves the "
+    "partitioned --exchange_dataset over TCP until it is consumed. "
+    "'consumer' reads it from the --tcp_exchange_producers");
+DEFINE_string(
+    tcp_exchange_producers,
+    "",
+    "Comma separated host:port of the producer processes to consume from");
+DEFINE_string(
+    exchange_dataset,
+    "flat10k",
+    "Data sent between a producer and a consumer process: flat10k, flat50, "
+    "deep10k, deep50 or dict10k");
+DEFINE_string(
+    exchange_compression_kind,
+    "none",
+    "Compression of the pages between a producer and a consumer process");
+DEFINE_bool(
+    exchange_preserve_encodings,
+    false,
+    "Serialize dictionaries as such between a producer and a consumer "
+    "process");
+
 /// Benchmarks repartition/exchange with different batch sizes,
 /// numbers of destinations and data type mixes.  Generates a plan
 /// that 1. shuffles a constant input in each of n workers, sending
@@ -59,12 +101,46 @@ struct Counters {
   int64_t bytes{0};
   int64_t rows{0};
   int64_t usec{0};
+  // CPU time of the PartitionedOutput and Exchange operators, i.e. the cost
+  // of serializing, compressing and deserializing.
+  int64_t serdeCpuNanos{0};
+  // User and system CPU time of the process, including the transport.
+  int64_t cpuNanos{0};
+  // Round trip times of the TCP exchange requests.
+  std::vector<uint64_t> requestMicros;
 
   std::string toString() {
-    return fmt::format("{} MB/s", (bytes / (1024 * 1024.0)) / (usec / 1.0e6));
+    const double gb = bytes / (1024 * 1024 * 1024.0);
+    auto result = fmt::format(
+        "{} MB/s, {} MB on wire, {} ms serde CPU, {} s CPU/GB",
+        (bytes / (1024 * 1024.0)) / (usec / 1.0e6),
+        bytes / (1024 * 1024.0),
+        serdeCpuNanos / 1'000'000,
+        gb == 0 ? 0 : cpuNanos / 1.0e9 / gb);
+    if (!requestMicros.empty()) {
+      std::sort(requestMicros.begin(), requestMicros.end());
+      auto percentile = [&](double fraction) {
+        return requestMicros[(requestMicros.size() - 1) * fraction];
+      };
+      result += fmt::format(
+          ", request us p50 {} p99 {} max {}",
+          percentile(0.5),
+          percentile(0.99),
+          requestMicros.back());
+    }
+    return result;
   }
 };
 
+int64_t processCpuNanos() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  auto nanos = [](struct timeval tv) {
+    return tv.tv_sec * 1'000'000'000L + tv.tv_usec * 1'000L;
+  };
+  return nanos(usage.ru_utime) + nanos(usage.ru_stime);
+}
+
 class ExchangeBenchmark : public VectorTestBase {
  public:
   std::vector<RowVectorPtr>
@@ -78,78 +154,132 @@ class ExchangeBenchmark : public VectorTestBase {
     return vectors;
   }
 
+  // Returns a copy of 'vectors' where the columns other than the partitioning
+  // key c0 are dictionaries over the first 'numDistinct' rows of the first
+  // vector. All batches share the dictionary bases, like the batches a reader
+  // produces from one dictionary encoded stripe.
+  std::vector<RowVectorPtr> makeDictionaryRows(
+      const std::vector<RowVectorPtr>& vectors,
+      int32_t numDistinct) {
+    std::vector<VectorPtr> bases;
+    for (auto i = 1; i < vectors[0]->childrenSize(); ++i) {
+      bases.push_back(vectors[0]->childAt(i)->slice(0, numDistinct));
+    }
+    std::vector<RowVectorPtr> result;
+    for (const auto& vector : vectors) {
+      const auto size = vector->size();
+      auto indices = makeIndices(
+          size,
+          [&](auto /*row*/) { return folly::Random::rand32(numDistinct); },
+          pool_.get());
+      std::vector<VectorPtr> children{vector->childAt(0)};
+      for (const auto& base : bases) {
+        children.push_back(
+            BaseVector::wrapInDictionary(nullptr, indices, size, base));
+      }
+      result.push_back(std::make_shared<RowVector>(
+          pool_.get(), vector->type(), nullptr, size, std::move(children)));
+    }
+    return result;
+  }
+
+  /// Sends the pages of the remote exchanges through 'server' instead of
+  /// reading the producer buffers in process.
+  void setServer(exec::test::TcpExchangeServer* server) {
+    server_ = server;
+  }
+
   void run(
       std::vector<RowVectorPtr>& vectors,
       int32_t width,
       int32_t taskWidth,
-      Counters& counters) {
+      Counters& counters,
+      const std::unordered_map<std::string, std::string>& extraConfig = {}) {
     assert(!vectors.empty());
+    configSettings_.clear();
     configSettings_[core::QueryConfig::kMaxPartitionedOutputBufferSize] =
         fmt::format("{}", FLAGS_exchange_buffer_mb << 20);
+    for (const auto& [name, value] : extraConfig) {
+      if (server_ && name == core::QueryConfig::kInProcessExchange) {
+        // Pages that hold vectors cannot go through a socket.
+        continue;
+      }
+      configSettings_[name] = value;
+    }
     std::vector<std::shared_ptr<Task>> tasks;
-    std::vector<std::string> leafTaskIds;
-    auto leafPlan = exec::test::PlanBuilder()
-                        .values(vectors, true)
-                        .partitionedOutput({"c0"}, width)
-                        .planNode();
-
     auto startMicros = getCurrentTimeMicro();
-    for (int32_t counter = 0; counter < width; ++counter) {
-      auto leafTaskId = makeTaskId("leaf", counter);
-      leafTaskIds.push_back(leafTaskId);
-      auto leafTask = makeTask(leafTaskId, leafPlan, counter);
-      tasks.push_back(leafTask);
-      Task::start(leafTask, taskWidth);
+    auto startCpuNanos = processCpuNanos();
+    auto leafTaskIds = startProducers(vectors, width, taskWidth, tasks);
+    if (server_) {
+      for (auto& taskId : leafTaskIds) {
+        taskId = server_->remoteTaskId(taskId);
+      }
     }
+    runConsumers(
+        asRowType(vectors[0]->type()),
+        leafTaskIds,
+        width,
+        taskWidth,
+        vectors.size() * vectors[0]->size() * width * taskWidth,
+        tasks);
+    addCounters(
+        tasks,
+        getCurrentTimeMicro() - startMicros,
+        processCpuNanos() - startCpuNanos,
+        width * vectors.size() * vectors[0]->size(),
+        counters);
+  }
 
-    core::PlanNodePtr finalAggPlan;
-    std::vector<std::string> finalAggTaskIds;
-    finalAggPlan = exec::test::PlanBuilder()
-                       .exchange(leafPlan->outputType())
-                       .singleAggregation({}, {"count(1)"})
-                       .partitionedOutput({}, 1)
-                       .planNode();
-
-    std::vector<exec::Split> finalAggSplits;
-    for (int i = 0; i < width; i++) {
-      auto taskId = makeTaskId("final-agg", i);
-      finalAggSplits.push_back(
-          exec::Split(std::make_shared<exec::RemoteConnectorSplit>(taskId)));
-      auto task = makeTask(taskId, finalAggPlan, i);
-      tasks.push_back(task);
-      Task::start(task, taskWidth);
-      addRemoteSplits(task, leafTaskIds);
+  /// Serves the partitioned 'vectors' to consumers in other processes and
+  /// returns when they have read all of it.
+  void produce(
+      std::vector<RowVectorPtr>& vectors,
+      int32_t width,
+      int32_t taskWidth) {
+    VELOX_CHECK_NOT_NULL(server_);
+    setRemoteConfig();
+    std::vector<std::shared_ptr<Task>> tasks;
+    startProducers(vectors, width, taskWidth, tasks);
+    for (auto& task : tasks) {
+      VELOX_CHECK(exec::test::waitForTaskCompletion(
+          task.get(), std::numeric_limits<uint64_t>::max()));
     }
+  }
 
-    auto plan = exec::test::PlanBuilder()
-                    .exchange(finalAggPlan->outputType())
-                    .singleAggregation({}, {"sum(a0)"})
-                    .planNode();
-
-    auto expected =
-        makeRowVector({makeFlatVector<int64_t>(1, [&](auto /*row*/) {
-          return vectors.size() * vectors[0]->size() * width * taskWidth;
-        })});
-
-    exec::test::AssertQueryBuilder(plan)
-        .splits(finalAggSplits)
-        .assertResults(expected);
-    auto elapsed = getCurrentTimeMicro() - startMicros;
-    int64_t bytes = 0;
-    for (auto& task : tasks) {
-      auto stats = task->taskStats();
-      for (auto& pipeline : stats.pipelineStats) {
-        for (auto& op : pipeline.operatorStats) {
-          if (op.operatorType == "Exchange") {
-            bytes += op.rawInputBytes;
-          }
-        }
+  /// Reads the partitioned 'vectors' from the 'produce' of each of
+  /// 'producers', given as host:port.
+  void consume(
+      std::vector<RowVectorPtr>& vectors,
+      const std::vector<std::string>& producers,
+      int32_t width,
+      int32_t taskWidth,
+      Counters& counters) {
+    setRemoteConfig();
+    std::vector<std::string> leafTaskIds;
+    for (const auto& producer : producers) {
+      for (int32_t counter = 0; counter < width; ++counter) {
+        leafTaskIds.push_back(fmt::format(
+            "tcp://{}/{}", producer, makeTaskId("leaf", counter)));
       }
     }
-
-    counters.bytes += bytes;
-    counters.rows += width * vectors.size() * vectors[0]->size();
-    counters.usec += elapsed;
+    const int64_t numRows = producers.size() * width * vectors.size() *
+        vectors[0]->size();
+    std::vector<std::shared_ptr<Task>> tasks;
+    auto startMicros = getCurrentTimeMicro();
+    auto startCpuNanos = processCpuNanos();
+    runConsumers(
+        asRowType(vectors[0]->type()),
+        leafTaskIds,
+        width,
+        taskWidth,
+        numRows * taskWidth,
+        tasks);
+    addCounters(
+        tasks,
+        getCurrentTimeMicro() - startMicros,
+        processCpuNanos() - startCpuNanos,
+        numRows,
+        counters);
   }
 
   void runLocal(
@@ -238,6 +368,115 @@ class ExchangeBenchmark : public VectorTestBase {
     return fmt::format("local://{}-{}", prefix, num);
   }
 
+  void setRemoteConfig() {
+    configSettings_.clear();
+    configSettings_[core::QueryConfig::kMaxPartitionedOutputBufferSize] =
+        fmt::format("{}", FLAGS_exchange_buffer_mb << 20);
+    configSettings_[core::QueryConfig::kExchangeCompressionKind] =
+        FLAGS_exchange_compression_kind;
+    configSettings_[core::QueryConfig::kExchangePreserveEncodings] =
+        FLAGS_exchange_preserve_encodings ? "true" : "false";
+  }
+
+  // Starts 'width' tasks that each partition 'vectors' by c0 into 'width'
+  // destinations. Returns their ids.
+  std::vector<std::string> startProducers(
+      std::vector<RowVectorPtr>& vectors,
+      int32_t width,
+      int32_t taskWidth,
+      std::vector<std::shared_ptr<Task>>& tasks) {
+    std::vector<std::string> leafTaskIds;
+    auto leafPlan = exec::test::PlanBuilder()
+                        .values(vectors, true)
+                        .partitionedOutput({"c0"}, width)
+                        .planNode();
+
+    for (int32_t counter = 0; counter < width; ++counter) {
+      auto leafTaskId = makeTaskId("leaf", counter);
+      leafTaskIds.push_back(leafTaskId);
+      auto leafTask = makeTask(leafTaskId, leafPlan, counter);
+      tasks.push_back(leafTask);
+      Task::start(leafTask, taskWidth);
+    }
+    return leafTaskIds;
+  }
+
+  // Runs 'width' tasks that count the rows they read from 'leafTaskIds' and
+  // a final task that checks that the counts add up to 'expectedCount'.
+  void runConsumers(
+      const RowTypePtr& leafType,
+      const std::vector<std::string>& leafTaskIds,
+      int32_t width,
+      int32_t taskWidth,
+      int64_t expectedCount,
+      std::vector<std::shared_ptr<Task>>& tasks) {
+    auto finalAggPlan = exec::test::PlanBuilder()
+                            .exchange(leafType)
+                            .singleAggregation({}, {"count(1)"})
+                            .partitionedOutput({}, 1)
+                            .planNode();
+
+    std::vector<exec::Split> finalAggSplits;
+    for (int i = 0; i < width; i++) {
+      auto taskId = makeTaskId("final-agg", i);
+      finalAggSplits.push_back(
+          exec::Split(std::make_shared<exec::RemoteConnectorSplit>(taskId)));
+      auto task = makeTask(taskId, finalAggPlan, i);
+      tasks.push_back(task);
+      Task::start(task, taskWidth);
+      addRemoteSplits(task, leafTaskIds);
+    }
+
+    auto plan = exec::test::PlanBuilder()
+                    .exchange(finalAggPlan->outputType())
+                    .singleAggregation({}, {"sum(a0)"})
+                    .planNode();
+
+    auto expected = makeRowVector({makeFlatVector<int64_t>(
+        1, [&](auto /*row*/) { return expectedCount; })});
+
+    exec::test::AssertQueryBuilder(plan)
+        .configs(configSettings_)
+        .splits(finalAggSplits)
+        .assertResults(expected);
+  }
+
+  // Adds the bytes received and the serde CPU time of the exchanges in
+  // 'tasks' and the given totals to 'counters'.
+  void addCounters(
+      const std::vector<std::shared_ptr<Task>>& tasks,
+      int64_t elapsedMicros,
+      int64_t cpuNanos,
+      int64_t numRows,
+      Counters& counters) {
+    int64_t bytes = 0;
+    for (auto& task : tasks) {
+      auto stats = task->taskStats();
+      for (auto& pipeline : stats.pipelineStats) {
+        for (auto& op : pipeline.operatorStats) {
+          if (op.operatorType == "Exchange") {
+            bytes += op.rawInputBytes;
+          }
+          if (op.operatorType == "Exchange" ||
+              op.operatorType == "PartitionedOutput") {
+            counters.serdeCpuNanos += op.addInputTiming.cpuNanos +
+                op.getOutputTiming.cpuNanos + op.finishTiming.cpuNanos;
+          }
+        }
+      }
+    }
+
+    counters.bytes += bytes;
+    counters.rows += numRows;
+    counters.usec += elapsedMicros;
+    counters.cpuNanos += cpuNanos;
+    auto requestMicros = exec::test::takeTcpExchangeRequestMicros();
+    counters.requestMicros.insert(
+        counters.requestMicros.end(),
+        requestMicros.begin(),
+        requestMicros.end());
+  }
+
   std::shared_ptr<Task> makeTask(
       const std::string& taskId,
       std::shared_ptr<const core::PlanNode> planNode,
@@ -292,6 +531,7 @@ class ExchangeBenchmark : public VectorTestBase {
   }
 
   std::unordered_map<std::string, std::string> configSettings_;
+  exec::test::TcpExchangeServer* server_{nullptr};
 };
 
 ExchangeBenchmark bm;
@@ -300,11 +540,18 @@ std::vector<RowVectorPtr> flat10k;
 std::vector<RowVectorPtr> deep10k;
 std::vector<RowVectorPtr> flat50;
 std::vector<RowVectorPtr> deep50;
+std::vector<RowVectorPtr> dict10k;
 
 Counters flat10kCounters;
 Counters deep10kCounters;
 Counters flat50Counters;
 Counters deep50Counters;
+Counters flat10kInProcessCounters;
+Counters deep10kInProcessCounters;
+Counters dict10kCounters;
+Counters dict10kPreserveCounters;
+Counters dict10kPreserveLz4Counters;
+Counters dict10kPreserveZstdCounters;
 Counters localFlat10kCounters;
 
 BENCHMARK(exchangeFlat10k) {
@@ -315,6 +562,15 @@ BENCHMARK_RELATIVE(exchangeFlat50) {
   bm.run(flat50, FLAGS_width, FLAGS_task_width, flat50Counters);
 }
 
+BENCHMARK_RELATIVE(exchangeFlat10kInProcess) {
+  bm.run(
+      flat10k,
+      FLAGS_width,
+      FLAGS_task_width,
+      flat10kInProcessCounters,
+      {{core::QueryConfig::kInProcessExchange, "true"}});
+}
+
 BENCHMARK(exchangeDeep10k) {
   bm.run(deep10k, FLAGS_width, FLAGS_task_width, deep10kCounters);
 }
@@ -323,6 +579,48 @@ BENCHMARK_RELATIVE(exchangeDeep50) {
   bm.run(deep50, FLAGS_width, FLAGS_task_width, deep50Counters);
 }
 
+BENCHMARK_RELATIVE(exchangeDeep10kInProcess) {
+  bm.run(
+      deep10k,
+      FLAGS_width,
+      FLAGS_task_width,
+      deep10kInProcessCounters,
+      {{core::QueryConfig::kInProcessExchange, "true"}});
+}
+
+BENCHMARK(exchangeDict10k) {
+  bm.run(dict10k, FLAGS_width, FLAGS_task_width, dict10kCounters);
+}
+
+BENCHMARK_RELATIVE(exchangeDict10kPreserve) {
+  bm.run(
+      dict10k,
+      FLAGS_width,
+      FLAGS_task_width,
+      dict10kPreserveCounters,
+      {{core::QueryConfig::kExchangePreserveEncodings, "true"}});
+}
+
+BENCHMARK_RELATIVE(exchangeDict10kPreserveLz4) {
+  bm.run(
+      dict10k,
+      FLAGS_width,
+      FLAGS_task_width,
+      dict10kPreserveLz4Counters,
+      {{core::QueryConfig::kExchangePreserveEncodings, "true"},
+       {core::QueryConfig::kExchangeCompressionKind, "lz4"}});
+}
+
+BENCHMARK_RELATIVE(exchangeDict10kPreserveZstd) {
+  bm.run(
+      dict10k,
+      FLAGS_width,
+      FLAGS_task_width,
+      dict10kPreserveZstdCounters,
+      {{core::QueryConfig::kExchangePreserveEncodings, "true"},
+       {core::QueryConfig::kExchangeCompressionKind, "zstd"}});
+}
+
 BENCHMARK(localFlat10k) {
   bm.runLocal(
       flat10k, FLAGS_width, FLAGS_num_local_tasks, localFlat10kCounters);
@@ -337,6 +635,7 @@ int main(int argc, char** argv) {
   parse::registerTypeResolver();
   serializer::presto::PrestoVectorSerde::registerVectorSerde();
   exec::ExchangeSource::registerFactory(exec::test::createLocalExchangeSource);
+  exec::ExchangeSource::registerFactory(exec::test::createTcpExchangeSource);
   std::vector<std::string> flatNames = {"c0"};
   std::vector<TypePtr> flatTypes = {BIGINT()};
   std::vector<TypePtr> typeSelection = {
@@ -379,12 +678,58 @@ int main(int argc, char** argv) {
   deep10k = bm.makeRows(deepType, 10, 10000);
   flat50 = bm.makeRows(flatType, 2000, 50);
   deep50 = bm.makeRows(deepType, 2000, 50);
+  dict10k = bm.makeDictionaryRows(flat10k, 1000);
+
+  std::unique_ptr<exec::test::TcpExchangeServer> server;
+  if (FLAGS_exchange_transport == "tcp" || FLAGS_exchange_role == "producer") {
+    server = std::make_unique<exec::test::TcpExchangeServer>(
+        FLAGS_tcp_exchange_host, FLAGS_tcp_exchange_port);
+    bm.setServer(server.get());
+  }
+  if (FLAGS_exchange_role != "all") {
+    std::unordered_map<std::string, std::vector<RowVectorPtr>*> datasets = {
+        {"flat10k", &flat10k},
+        {"flat50", &flat50},
+        {"deep10k", &deep10k},
+        {"deep50", &deep50},
+        {"dict10k", &dict10k}};
+    auto it = datasets.find(FLAGS_exchange_dataset);
+    VELOX_CHECK(
+        it != datasets.end(), "Unknown dataset {}", FLAGS_exchange_dataset);
+    if (FLAGS_exchange_role == "producer") {
+      std::cout << "Serving " << FLAGS_exchange_dataset << " on "
+                << FLAGS_tcp_exchange_host << ":" << server->port()
+                << std::endl;
+      bm.produce(*it->second, FLAGS_width, FLAGS_task_width);
+    } else {
+      VELOX_CHECK_EQ(FLAGS_exchange_role, "consumer");
+      std::vector<std::string> producers;
+      folly::split(',', FLAGS_tcp_exchange_producers, producers, true);
+      VELOX_CHECK(!producers.empty(), "No --tcp_exchange_producers");
+      Counters counters;
+      bm.consume(
+          *it->second, producers, FLAGS_width, FLAGS_task_width, counters);
+      std::cout << FLAGS_exchange_dataset << ": " << counters.toString()
+                << std::endl;
+    }
+    return 0;
+  }
 
   folly::runBenchmarks();
   std::cout << "flat10k: " << flat10kCounters.toString() << std::endl
             << "flat50: " << flat50Counters.toString() << std::endl
             << "deep10k: " << deep10kCounters.toString() << std::endl
-            << "deep50: " << deep50Counters.toString() << std::endl;
-  return 0;
+            << "deep50: " << deep50Counters.toString() << std::endl
+            << "flat10kInProcess: " << flat10kInProcessCounters.toString()
+            << std::endl
+            << "deep10kInProcess: " << deep10kInProcessCounters.toString()
+            << std::endl
+            << "dict10k: " << dict10kCounters.toString() << std::endl
+            << "dict10kPreserve: " << dict10kPreserveCounters.toString()
+            << std::endl
+            << "dict10kPreserveLz4: " << dict10kPreserveLz4Counters.toString()
+            << std::endl
+            << "dict10kPreserveZstd: "
+            << dict10kPreserveZstdCounters.toString() << std::endl;
   return 0;
 }
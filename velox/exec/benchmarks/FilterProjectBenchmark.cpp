@@ -42,6 +42,10 @@
 /// of base values in each vector or each vector sharing the same base
 /// values. The latter case allows memoization of expressions on
 /// different elements of the base values.
+///
+/// Floating point arithmetic is benchmarked with and without
+/// expression.fuse_floating_point_arithmetic, which evaluates the filter and
+/// the projection without vectors for the results of inner calls.
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec;
@@ -251,10 +255,50 @@ class FilterProjectBenchmark : public VectorTestBase {
     cases_.push_back(std::move(test));
   }
 
-  int64_t run(std::shared_ptr<const core::PlanNode> plan) {
+  void makeArithmeticBenchmark(
+      std::string name,
+      int64_t numVectors,
+      int32_t numPerVector) {
+    auto test = std::make_unique<TestCase>();
+    for (auto i = 0; i < numVectors; ++i) {
+      auto makeDoubles = [&]() {
+        return makeFlatVector<double>(numPerVector, [&](auto /*row*/) {
+          return folly::Random::randDouble01(rng_) * 100;
+        });
+      };
+      test->rows.push_back(makeRowVector(
+          {"c0", "c1", "c2", "c3"},
+          {makeDoubles(), makeDoubles(), makeDoubles(), makeDoubles()}));
+    }
+    test->baseline =
+        exec::test::PlanBuilder()
+            .values(test->rows)
+            .filter("c0 * 2.0 + c1 - c2 > c3 * 0.5")
+            .project({"c0 * c1 + c2 * c3 - c0 as p0", "c1 - c2 * 3.0 as p1"})
+            .singleAggregation({}, {"count(1)", "max(p0)", "max(p1)"})
+            .planNode();
+    folly::addBenchmark(
+        __FILE__, name + "_interpreted", [plan = &test->baseline, this]() {
+          run(*plan);
+          return 1;
+        });
+    folly::addBenchmark(
+        __FILE__, "%" + name + "_fused", [plan = &test->baseline, this]() {
+          run(*plan, true);
+          return 1;
+        });
+    cases_.push_back(std::move(test));
+  }
+
+  int64_t run(std::shared_ptr<const core::PlanNode> plan, bool fuse = false) {
     auto start = getCurrentTimeMicro();
     int32_t numRows = 0;
-    auto result = exec::test::AssertQueryBuilder(plan).copyResults(pool_.get());
+    auto result =
+        exec::test::AssertQueryBuilder(plan)
+            .config(
+                core::QueryConfig::kExprFuseFloatingPointArithmetic,
+                fuse ? "true" : "false")
+            .copyResults(pool_.get());
     numRows += result->childAt(0)->as<FlatVector<int64_t>>()->valueAt(0);
     auto elapsedMicros = getCurrentTimeMicro() - start;
     return elapsedMicros;
@@ -305,6 +349,10 @@ int main(int argc, char** argv) {
   bm.makeBenchmark(
       "StrRepDict4_50", varchar4, 2000, 50, 8000, true, true, true);
 
+  // Floating point arithmetic.
+  bm.makeArithmeticBenchmark("Double4_10K", 10, 10000);
+  bm.makeArithmeticBenchmark("Double4_50", 2000, 50);
+
   folly::runBenchmarks();
   return 0;
 }
@@ -34,6 +34,11 @@ DEFINE_int32(custom_key_spacing, 1, "Spacing between key values");
 
 DEFINE_int32(custom_num_ways, 10, "Number of build threads");
 
+DEFINE_bool(
+    include_1b,
+    false,
+    "Adds cases with 1 billion build keys. These need tens of GB of memory");
+
 using namespace facebook::velox;
 using namespace facebook::velox::exec;
 using namespace facebook::velox::test;
@@ -360,7 +365,8 @@ class HashTableBenchmark : public VectorTestBase {
         return vectorMaker_->flatVector<int64_t>(
             size,
             [&](vector_size_t row) {
-              return params_.keySpacing * (sequence + row);
+              return static_cast<int64_t>(params_.keySpacing) *
+                  (sequence + row);
             },
             nullptr);
 
@@ -632,10 +638,41 @@ int main(int argc, char** argv) {
       HashTableBenchmarkParams("Hit4M", 4000000, 100),
       HashTableBenchmarkParams("Miss4M", 4000000, 5),
 
+      HashTableBenchmarkParams("Hit10M", 10000000, 100),
+      HashTableBenchmarkParams("Miss10M", 10000000, 5),
+
       HashTableBenchmarkParams("Hit32M", 32000000, 100),
       HashTableBenchmarkParams("Miss32M", 32000000, 5),
 
+      HashTableBenchmarkParams("Hit100M", 100000000, 100),
+      HashTableBenchmarkParams("Miss100M", 100000000, 5),
+
       HashTableBenchmarkParams("Hit128M", 128000000, 100)};
+  // Composite fixed width keys that need kHash mode. These use the packed
+  // key comparison.
+  for (auto numKeys : {2, 4}) {
+    for (auto hitRate : {100, 5}) {
+      HashTableBenchmarkParams compositeParams(
+          fmt::format("{}{}Bigint4M", hitRate == 100 ? "Hit" : "Miss", numKeys),
+          4000000,
+          hitRate,
+          1'000'000'000);
+      std::vector<std::string> names;
+      std::vector<TypePtr> types;
+      for (auto i = 0; i < numKeys; ++i) {
+        names.push_back(fmt::format("k{}", i + 1));
+        types.push_back(BIGINT());
+      }
+      compositeParams.buildType = ROW(std::move(names), std::move(types));
+      compositeParams.numKeys = numKeys;
+      compositeParams.mode = BaseHashTable::HashMode::kHash;
+      params.push_back(std::move(compositeParams));
+    }
+  }
+  if (FLAGS_include_1b) {
+    params.push_back(HashTableBenchmarkParams("Hit1B", 1000000000, 100));
+    params.push_back(HashTableBenchmarkParams("Miss1B", 1000000000, 5));
+  }
   if (FLAGS_custom_size != 0) {
     params.push_back(HashTableBenchmarkParams(
         "Custom",
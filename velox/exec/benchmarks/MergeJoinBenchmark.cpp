@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/parse/TypeResolver.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+/// Benchmark for merge join over sorted inputs with different key
+/// distributions: 1:1 where each key appears once on each side, 1:N where
+/// each left key matches 'kRepeats' right rows and N:M where each key
+/// appears 'kRepeats' times on both sides. The benchmarks report left side
+/// input rows per second.
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+namespace {
+constexpr int32_t kNumBatches = 100;
+constexpr int32_t kBatchSize = 10'000;
+constexpr int32_t kRepeats = 10;
+
+class MergeJoinBenchmark : public VectorTestBase {
+ public:
+  // Makes 'kNumBatches' sorted batches with columns '<prefix>c0' and
+  // '<prefix>c1'. The key '<prefix>c0' repeats each value 'repeats' times.
+  std::vector<RowVectorPtr> makeInput(
+      const std::string& prefix,
+      int32_t repeats) {
+    std::vector<RowVectorPtr> batches;
+    batches.reserve(kNumBatches);
+    for (auto i = 0; i < kNumBatches; ++i) {
+      const int64_t firstRow = static_cast<int64_t>(i) * kBatchSize;
+      batches.push_back(makeRowVector(
+          {prefix + "c0", prefix + "c1"},
+          {makeFlatVector<int64_t>(
+               kBatchSize,
+               [&](auto row) { return (firstRow + row) / repeats; }),
+           makeFlatVector<int64_t>(
+               kBatchSize, [&](auto row) { return firstRow + row; })}));
+    }
+    return batches;
+  }
+
+  void makeBenchmark(
+      const std::string& name,
+      int32_t leftRepeats,
+      int32_t rightRepeats) {
+    auto left = makeInput("t_", leftRepeats);
+    auto right = makeInput("u_", rightRepeats);
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = exec::test::PlanBuilder(planNodeIdGenerator)
+                    .values(left)
+                    .mergeJoin(
+                        {"t_c0"},
+                        {"u_c0"},
+                        exec::test::PlanBuilder(planNodeIdGenerator)
+                            .values(right)
+                            .planNode(),
+                        "",
+                        {"t_c0", "t_c1", "u_c1"})
+                    .singleAggregation({}, {"count(1)", "sum(u_c1)"})
+                    .planNode();
+    folly::addBenchmark(__FILE__, name, [plan, this]() {
+      exec::test::AssertQueryBuilder(plan).copyResults(pool_.get());
+      return kNumBatches * kBatchSize;
+    });
+  }
+};
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  aggregate::prestosql::registerAllAggregateFunctions();
+  parse::registerTypeResolver();
+
+  MergeJoinBenchmark benchmark;
+  benchmark.makeBenchmark("oneToOne", 1, 1);
+  benchmark.makeBenchmark("oneToN", 1, kRepeats);
+  benchmark.makeBenchmark("nToM", kRepeats, kRepeats);
+  folly::runBenchmarks();
+  return 0;
+}
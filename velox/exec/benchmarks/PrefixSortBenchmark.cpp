@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/exec/PrefixSort.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+namespace {
+
+// Rows of a RowContainer to sort by their leading columns.
+class SortData {
+ public:
+  SortData(const RowTypePtr& type, int32_t numKeys, vector_size_t numRows)
+      : container_(type->children(), pool_.get()) {
+    VectorFuzzer::Options options;
+    options.vectorSize = numRows;
+    options.nullRatio = 0.01;
+    options.stringLength = 16;
+    VectorFuzzer fuzzer(options, pool_.get());
+    auto data = fuzzer.fuzzFlat(type);
+    auto* row = data->as<RowVector>();
+
+    SelectivityVector allRows(numRows);
+    rows_.resize(numRows);
+    for (auto i = 0; i < numRows; ++i) {
+      rows_[i] = container_.newRow();
+    }
+    for (auto column = 0; column < type->size(); ++column) {
+      DecodedVector decoded(*row->childAt(column), allRows);
+      for (auto i = 0; i < numRows; ++i) {
+        container_.store(decoded, i, rows_[i], column);
+      }
+    }
+    for (column_index_t i = 0; i < numKeys; ++i) {
+      keys_.emplace_back(i, CompareFlags{true, true, false});
+    }
+  }
+
+  bool lessThan(const char* left, const char* right) {
+    for (const auto& [column, flags] : keys_) {
+      if (auto result = container_.compare(left, right, column, flags)) {
+        return result < 0;
+      }
+    }
+    return false;
+  }
+
+  void sort(bool usePrefix) {
+    folly::BenchmarkSuspender suspender;
+    auto rows = rows_;
+    suspender.dismiss();
+
+    auto lessThan = [&](const char* left, const char* right) {
+      return this->lessThan(left, right);
+    };
+    if (usePrefix) {
+      PrefixSort::sort(container_, keys_, rows, lessThan);
+    } else {
+      std::sort(rows.begin(), rows.end(), lessThan);
+    }
+    folly::doNotOptimizeAway(rows);
+  }
+
+ private:
+  std::shared_ptr<memory::MemoryPool> pool_{memory::addDefaultLeafMemoryPool()};
+  RowContainer container_;
+  std::vector<char*> rows_;
+  std::vector<std::pair<column_index_t, CompareFlags>> keys_;
+};
+
+constexpr vector_size_t kNumRows = 1'000'000;
+
+std::unique_ptr<SortData> bigint;
+std::unique_ptr<SortData> twoIntegers;
+std::unique_ptr<SortData> varchar;
+std::unique_ptr<SortData> bigintVarchar;
+
+} // namespace
+
+BENCHMARK(bigintStdSort) {
+  bigint->sort(false);
+}
+
+BENCHMARK_RELATIVE(bigintPrefixSort) {
+  bigint->sort(true);
+}
+
+BENCHMARK(twoIntegersStdSort) {
+  twoIntegers->sort(false);
+}
+
+BENCHMARK_RELATIVE(twoIntegersPrefixSort) {
+  twoIntegers->sort(true);
+}
+
+BENCHMARK(varcharStdSort) {
+  varchar->sort(false);
+}
+
+BENCHMARK_RELATIVE(varcharPrefixSort) {
+  varchar->sort(true);
+}
+
+BENCHMARK(bigintVarcharStdSort) {
+  bigintVarchar->sort(false);
+}
+
+BENCHMARK_RELATIVE(bigintVarcharPrefixSort) {
+  bigintVarchar->sort(true);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  bigint = std::make_unique<SortData>(ROW({BIGINT(), VARCHAR()}), 1, kNumRows);
+  twoIntegers = std::make_unique<SortData>(
+      ROW({INTEGER(), INTEGER(), DOUBLE()}), 2, kNumRows);
+  varchar = std::make_unique<SortData>(ROW({VARCHAR(), BIGINT()}), 1, kNumRows);
+  bigintVarchar =
+      std::make_unique<SortData>(ROW({BIGINT(), VARCHAR()}), 2, kNumRows);
+  folly::runBenchmarks();
+  bigint.reset();
+  twoIntegers.reset();
+  varchar.reset();
+  bigintVarchar.reset();
+  return 0;
+}
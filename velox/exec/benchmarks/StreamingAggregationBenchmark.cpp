@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/parse/TypeResolver.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+/// Compares streaming aggregation with hash aggregation over input sorted on
+/// the grouping key. Each key repeats 1, 10 or 1000 times, so groups range
+/// from single rows to runs much longer than a batch. The benchmarks report
+/// input rows per second.
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+namespace {
+constexpr int32_t kNumBatches = 100;
+constexpr int32_t kBatchSize = 10'000;
+
+class StreamingAggregationBenchmark : public VectorTestBase {
+ public:
+  // Makes 'kNumBatches' batches sorted on 'c0', where each value of 'c0'
+  // repeats 'repeats' times.
+  std::vector<RowVectorPtr> makeInput(int32_t repeats) {
+    std::vector<RowVectorPtr> batches;
+    batches.reserve(kNumBatches);
+    for (auto i = 0; i < kNumBatches; ++i) {
+      const int64_t firstRow = static_cast<int64_t>(i) * kBatchSize;
+      batches.push_back(makeRowVector(
+          {makeFlatVector<int64_t>(
+               kBatchSize,
+               [&](auto row) { return (firstRow + row) / repeats; }),
+           makeFlatVector<int64_t>(
+               kBatchSize, [&](auto row) { return firstRow + row; }),
+           makeFlatVector<double>(
+               kBatchSize, [&](auto row) { return (firstRow + row) * 0.1; })}));
+    }
+    return batches;
+  }
+
+  void makeBenchmarks(const std::string& name, int32_t repeats) {
+    auto input = makeInput(repeats);
+    const std::vector<std::string> aggregates = {
+        "count(1)", "sum(c1)", "min(c1)", "max(c2)", "sum(c2)"};
+    auto hashPlan = exec::test::PlanBuilder()
+                        .values(input)
+                        .singleAggregation({"c0"}, aggregates)
+                        .planNode();
+    auto streamingPlan = exec::test::PlanBuilder()
+                             .values(input)
+                             .streamingAggregation(
+                                 {"c0"},
+                                 aggregates,
+                                 {},
+                                 core::AggregationNode::Step::kSingle,
+                                 false)
+                             .planNode();
+    folly::addBenchmark(__FILE__, name + "_hash", [hashPlan, this]() {
+      exec::test::AssertQueryBuilder(hashPlan).copyResults(pool_.get());
+      return kNumBatches * kBatchSize;
+    });
+    folly::addBenchmark(
+        __FILE__, "%" + name + "_streaming", [streamingPlan, this]() {
+          exec::test::AssertQueryBuilder(streamingPlan)
+              .copyResults(pool_.get());
+          return kNumBatches * kBatchSize;
+        });
+  }
+};
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  aggregate::prestosql::registerAllAggregateFunctions();
+  parse::registerTypeResolver();
+
+  StreamingAggregationBenchmark benchmark;
+  benchmark.makeBenchmarks("uniqueKeys", 1);
+  benchmark.makeBenchmarks("shortRuns", 10);
+  benchmark.makeBenchmarks("longRuns", 1'000);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -715,6 +715,57 @@ TEST_F(AggregationTest, allKeyTypes) {
       " GROUP BY c0, c1, c2, c3, c4, c5");
 }
 
+TEST_F(AggregationTest, complexTypeKeys) {
+  // Keys of complex types without floating point values are compared by their
+  // serializations. Null keys and equal maps with keys in different orders
+  // make one group each.
+  using Array = std::vector<std::optional<int64_t>>;
+  using Map = std::vector<std::pair<int32_t, std::optional<int64_t>>>;
+  auto data = makeRowVector({
+      makeNullableArrayVector<int64_t>(
+          {Array{1, 2},
+           std::nullopt,
+           Array{1, 2},
+           Array{},
+           Array{1, std::nullopt},
+           std::nullopt,
+           Array{},
+           Array{1, std::nullopt}}),
+      makeFlatVector<int64_t>({1, 2, 3, 4, 5, 6, 7, 8}),
+      makeMapVector<int32_t, int64_t>(std::vector<Map>{
+          {{1, 10}, {2, 20}},
+          {{2, 20}, {1, 10}},
+          {{1, 10}, {2, 20}},
+          {{2, 20}, {1, 10}},
+          {{1, 10}, {2, 20}},
+          {{2, 20}, {1, 10}},
+          {{1, 10}, {2, 20}},
+          {{1, 10}}}),
+  });
+
+  auto expected = makeRowVector({
+      makeNullableArrayVector<int64_t>(
+          {Array{1, 2}, std::nullopt, Array{}, Array{1, std::nullopt}}),
+      makeFlatVector<int64_t>({8, 16, 22, 26}),
+  });
+  AssertQueryBuilder(PlanBuilder()
+                         .values({data, data})
+                         .singleAggregation({"c0"}, {"sum(c1)"})
+                         .planNode())
+      .assertResults(expected);
+
+  expected = makeRowVector({
+      makeMapVector<int32_t, int64_t>(
+          std::vector<Map>{{{1, 10}, {2, 20}}, {{1, 10}}}),
+      makeFlatVector<int64_t>({56, 16}),
+  });
+  AssertQueryBuilder(PlanBuilder()
+                         .values({data, data})
+                         .singleAggregation({"c2"}, {"sum(c1)"})
+                         .planNode())
+      .assertResults(expected);
+}
+
 TEST_F(AggregationTest, partialAggregationMemoryLimit) {
   auto vectors = {
       makeRowVector({makeFlatVector<int32_t>(
@@ -794,6 +845,42 @@ TEST_F(AggregationTest, partialAggregationMemoryLimit) {
           .customStats.count("flushRowCount"));
 }
 
+TEST_F(AggregationTest, boundedPartialAggregation) {
+  // Clustered keys: each batch has 50 distinct keys of which half repeat the
+  // keys of the previous batch.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 20; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             1'000, [&](auto row) { return i * 25 + row % 50; }, nullEvery(17)),
+         makeFlatVector<StringView>(1'000, [&](auto row) {
+           return StringView(fmt::format("string value {}", row % 13));
+         })}));
+  }
+  createDuckDbTable(vectors);
+
+  core::PlanNodeId aggNodeId;
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .config(QueryConfig::kPartialAggregationMaxGroups, "64")
+          .config(QueryConfig::kAbandonPartialAggregationMinRows, "100")
+          .config(QueryConfig::kAbandonPartialAggregationMinPct, "1")
+          .plan(PlanBuilder()
+                    .values(vectors)
+                    .partialAggregation(
+                        {"c0"}, {"count(1)", "sum(c0)", "max(c1)"})
+                    .capturePlanNodeId(aggNodeId)
+                    .finalAggregation()
+                    .planNode())
+          .assertResults(
+              "SELECT c0, count(1), sum(c0), max(c1) FROM tmp GROUP BY 1");
+  auto stats = toPlanStats(task->taskStats()).at(aggNodeId).customStats;
+  EXPECT_GT(stats.at("evictedPartialGroups").sum, 0);
+  EXPECT_EQ(stats.count("abandonedPartialAggregation"), 0);
+  EXPECT_LT(
+      toPlanStats(task->taskStats()).at(aggNodeId).outputRows, 20 * 1'000);
+}
+
 TEST_F(AggregationTest, partialDistinctWithAbandon) {
   auto vectors = {
       // 1st batch will produce 100 distinct groups from 10 rows.
@@ -1478,6 +1565,65 @@ TEST_F(AggregationTest, groupingSets) {
       "SELECT k1, k2, count(1), sum(a), max(b) FROM tmp GROUP BY ROLLUP (k1, k2)");
 }
 
+TEST_F(AggregationTest, groupingSetsPreAggregation) {
+  vector_size_t size = 1'000;
+  auto data = makeRowVector(
+      {"k1", "k2", "a", "b"},
+      {
+          makeFlatVector<int64_t>(size, [](auto row) { return row % 11; }),
+          makeFlatVector<int64_t>(size, [](auto row) { return row % 17; }),
+          makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+          makeFlatVector<StringView>(
+              size,
+              [](auto row) {
+                auto str = std::string(row % 12, 'x');
+                return StringView(str);
+              }),
+      });
+
+  createDuckDbTable({data});
+
+  struct {
+    std::vector<std::vector<std::string>> groupingSets;
+    std::string groupBy;
+  } testSettings[] = {
+      {{{"k1", "k2"}, {"k1"}, {"k2"}, {}}, "CUBE (k1, k2)"},
+      {{{"k1", "k2"}, {"k1"}, {}}, "ROLLUP (k1, k2)"},
+      {{{"k1"}, {"k2"}}, "GROUPING SETS ((k1), (k2))"}};
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.groupBy);
+    core::PlanNodeId groupIdNodeId;
+    auto plan = PlanBuilder()
+                    .values({data})
+                    .groupId(testData.groupingSets, {"a", "b"})
+                    .capturePlanNodeId(groupIdNodeId)
+                    .singleAggregation(
+                        {"k1", "k2", "group_id"},
+                        {"count(1) as count_1",
+                         "sum(a) as sum_a",
+                         "max(b) as max_b",
+                         "avg(a) as avg_a"})
+                    .project({"k1", "k2", "count_1", "sum_a", "max_b", "avg_a"})
+                    .planNode();
+
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .config(QueryConfig::kGroupIdPreAggregation, "true")
+            .assertResults(fmt::format(
+                "SELECT k1, k2, count(1), sum(a), max(b), avg(a) FROM tmp "
+                "GROUP BY {}",
+                testData.groupBy));
+
+    // GroupId gets one row per distinct (k1, k2) instead of the input rows.
+    auto planStats = toPlanStats(task->taskStats());
+    EXPECT_EQ(
+        planStats.at(fmt::format("{}.preAggregation", groupIdNodeId))
+            .inputRows,
+        size);
+    EXPECT_EQ(planStats.at(groupIdNodeId).inputRows, 11 * 17);
+  }
+}
+
 TEST_F(AggregationTest, groupingSetsOutput) {
   vector_size_t size = 1'000;
   auto data = makeRowVector(
@@ -1626,6 +1772,77 @@ TEST_F(AggregationTest, distinctWithSpilling) {
   OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
 }
 
+TEST_F(AggregationTest, sortedAndDistinctAggregationsWithSpilling) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(100, [](auto row) { return row % 20; }),
+         makeFlatVector<int64_t>(
+             100, [i](auto row) { return (i + row) % 7; }, nullEvery(11)),
+         makeFlatVector<StringView>(100, [i](auto row) {
+           return StringView(fmt::format("string value {}", (i * 100 + row)));
+         })}));
+  }
+  createDuckDbTable(vectors);
+
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  core::PlanNodeId aggrNodeId;
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .spillDirectory(spillDirectory->path)
+                  .config(QueryConfig::kSpillEnabled, "true")
+                  .config(QueryConfig::kAggregationSpillEnabled, "true")
+                  .config(QueryConfig::kTestingSpillPct, "100")
+                  .plan(PlanBuilder()
+                            .values(vectors)
+                            .singleAggregation(
+                                {"c0"},
+                                {"count(distinct c1)",
+                                 "sum(distinct c1)",
+                                 "array_agg(c2 ORDER BY c1, c2)",
+                                 "sum(c1)"})
+                            .capturePlanNodeId(aggrNodeId)
+                            .planNode())
+                  .assertResults(
+                      "SELECT c0, count(distinct c1), sum(distinct c1), "
+                      "array_agg(c2 ORDER BY c1, c2), sum(c1) "
+                      "FROM tmp GROUP BY 1");
+  ASSERT_GT(toPlanStats(task->taskStats()).at(aggrNodeId).spilledBytes, 0);
+  OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+}
+
+TEST_F(AggregationTest, spillAll) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             1'000, [i](auto row) { return i * 500 + row; }),
+         makeFlatVector<int64_t>(1'000, [](auto row) { return row % 7; })}));
+  }
+  createDuckDbTable(vectors);
+
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  core::PlanNodeId aggrNodeId;
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .spillDirectory(spillDirectory->path)
+                  .config(QueryConfig::kSpillEnabled, "true")
+                  .config(QueryConfig::kAggregationSpillEnabled, "true")
+                  .config(QueryConfig::kAggregationSpillAll, "true")
+                  .config(QueryConfig::kTestingSpillPct, "100")
+                  .plan(PlanBuilder()
+                            .values(vectors)
+                            .singleAggregation({"c0"}, {"sum(c1)", "count(1)"})
+                            .capturePlanNodeId(aggrNodeId)
+                            .planNode())
+                  .assertResults(
+                      "SELECT c0, sum(c1), count(1) FROM tmp GROUP BY 1");
+  auto stats = toPlanStats(task->taskStats()).at(aggrNodeId);
+  ASSERT_GT(stats.spilledBytes, 0);
+  // The test spill before each input writes out all groups, i.e. the 1'000
+  // groups added by the previous input.
+  ASSERT_EQ(stats.spilledRows, 9 * 1'000);
+  OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+}
+
 TEST_F(AggregationTest, preGroupedAggregationWithSpilling) {
   std::vector<RowVectorPtr> vectors;
   int64_t val = 0;
@@ -1713,6 +1930,77 @@ TEST_F(AggregationTest, adaptiveOutputBatchRows) {
   }
 }
 
+TEST_F(AggregationTest, dictionaryKeys) {
+  // A dictionary of 10 strings with a null entry, wrapped with nulls.
+  auto dictionary = makeNullableFlatVector<StringView>(
+      {"apple",
+       "banana",
+       std::nullopt,
+       "cherry",
+       "durian long string value",
+       "elderberry long string value",
+       "fig",
+       "grape",
+       "honeydew",
+       "apple"});
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 5; ++i) {
+    const vector_size_t size = 1'000;
+    auto indices = makeIndices(size, [i](auto row) { return (i + row) % 10; });
+    auto nulls = makeNulls(size, [](auto row) { return row % 37 == 0; });
+    vectors.push_back(makeRowVector(
+        {BaseVector::wrapInDictionary(nulls, indices, size, dictionary),
+         makeFlatVector<int64_t>(size, [](auto row) { return row; })}));
+  }
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .singleAggregation({"c0"}, {"sum(c1)", "count(1)"})
+                  .planNode();
+  assertQuery(plan, "SELECT c0, sum(c1), count(1) FROM tmp GROUP BY 1");
+
+  plan = PlanBuilder()
+             .values(vectors)
+             .partialAggregation({"c0"}, {})
+             .finalAggregation()
+             .planNode();
+  assertQuery(plan, "SELECT DISTINCT c0 FROM tmp");
+}
+
+TEST_F(AggregationTest, partitionedTables) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector(
+        {"k0", "k1", "c0"},
+        {makeFlatVector<int64_t>(
+             1'000, [&](auto row) { return (i * 1'000 + row) % 3'000; }),
+         makeFlatVector<StringView>(
+             1'000,
+             [&](auto row) {
+               return StringView::makeInline(fmt::format("{}", row % 7));
+             }),
+         makeFlatVector<int32_t>(
+             1'000, [](auto row) { return row; }, nullEvery(11))}));
+  }
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .singleAggregation(
+                      {"k0", "k1"}, {"sum(c0)", "count(c0)", "max(k1)"})
+                  .planNode();
+  for (const auto numBits : {"1", "3", "8"}) {
+    SCOPED_TRACE(numBits);
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(QueryConfig::kAggregationTablePartitionBits, numBits)
+        .config(QueryConfig::kPreferredOutputBatchRows, "100")
+        .assertResults(
+            "SELECT k0, k1, sum(c0), count(c0), max(k1) FROM tmp "
+            "GROUP BY k0, k1");
+  }
+}
+
 DEBUG_ONLY_TEST_F(AggregationTest, reclaimDuringInputProcessing) {
   constexpr int64_t kMaxBytes = 1LL << 30; // 1GB
   auto rowType = ROW({"c0", "c1", "c2"}, {INTEGER(), INTEGER(), VARCHAR()});
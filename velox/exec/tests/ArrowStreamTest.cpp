@@ -226,3 +226,59 @@ TEST_F(ArrowStreamTest, error) {
       AssertQueryBuilder(plan).copyResults(pool_.get()),
       "Failed to call get_schema on ArrowStream: get_schema failed.");
 }
+
+TEST_F(ArrowStreamTest, prefetchAndMultipleStreams) {
+  vector_size_t size = 100;
+  std::vector<std::vector<RowVectorPtr>> streamVectors(5);
+  std::vector<RowVectorPtr> allVectors;
+  for (int32_t i = 0; i < 20; ++i) {
+    auto vector = makeRowVector(
+        {makeFlatVector<int64_t>(
+             size, [&](auto row) { return size * i + row; }, nullEvery(7)),
+         makeFlatVector<StringView>(size, [](auto row) {
+           return StringView::makeInline(std::to_string(row % 13));
+         })});
+    streamVectors[i % streamVectors.size()].push_back(vector);
+    allVectors.push_back(vector);
+  }
+  createDuckDbTable(allVectors);
+  auto type = asRowType(allVectors[0]->type());
+
+  auto makePlan = [&]() {
+    std::vector<std::shared_ptr<ArrowArrayStream>> arrowStreams;
+    for (const auto& vectors : streamVectors) {
+      auto arrowStream = std::make_shared<ArrowArrayStream>();
+      exportArrowStream(
+          std::make_shared<ArrowReader>(pool_, vectors, type),
+          arrowStream.get());
+      arrowStreams.push_back(std::move(arrowStream));
+    }
+    return std::make_shared<core::ArrowStreamNode>("0", type, arrowStreams);
+  };
+
+  for (auto prefetchDepth : {0, 1, 3}) {
+    for (auto numDrivers : {1, 2, 5}) {
+      SCOPED_TRACE(fmt::format(
+          "prefetchDepth {} numDrivers {}", prefetchDepth, numDrivers));
+      AssertQueryBuilder(makePlan(), duckDbQueryRunner_)
+          .config(
+              core::QueryConfig::kArrowStreamPrefetchDepth,
+              std::to_string(prefetchDepth))
+          .maxDrivers(numDrivers)
+          .assertResults("SELECT * FROM tmp");
+    }
+  }
+
+  // Errors of a prefetching fetch surface on the driver.
+  struct ArrowArrayStream arrowStream;
+  exportArrowStream(
+      std::make_shared<ArrowReader>(pool_, allVectors, type, true, false),
+      &arrowStream);
+  auto plan = std::make_shared<core::ArrowStreamNode>(
+      "0", type, std::make_shared<ArrowArrayStream>(arrowStream));
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(plan)
+          .config(core::QueryConfig::kArrowStreamPrefetchDepth, "2")
+          .copyResults(pool_.get()),
+      "Failed to call get_next on ArrowStream: get_next failed.");
+}
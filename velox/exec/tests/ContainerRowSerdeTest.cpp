@@ -144,5 +144,48 @@ TEST_F(ContainerRowSerdeTest, nested) {
   testRoundTrip(nestedArray);
 }
 
+TEST_F(ContainerRowSerdeTest, serializeToString) {
+  auto data = makeRowVector(
+      {makeNullableFlatVector<int64_t>({1, std::nullopt, 3}),
+       makeFlatVector<std::string>({"a", "", "Long test sentence ......"}),
+       makeNullableArrayVector<std::string>({{"a", "b", "c"}, {}, {"d"}})});
+
+  // The bytes are the same as those written to a ByteStream.
+  for (auto i = 0; i < data->size(); ++i) {
+    std::string serialized;
+    ContainerRowSerde::serialize(*data, i, serialized);
+    auto position = serialize(data->slice(i, 1));
+    ByteStream in;
+    HashStringAllocator::prepareRead(position.header, in);
+    std::string expected(serialized.size(), '\0');
+    in.readBytes(expected.data(), expected.size());
+    EXPECT_TRUE(in.atEnd());
+    EXPECT_EQ(serialized, expected);
+    allocator_.clear();
+  }
+
+  // Equal maps serialize to the same bytes whatever the order of their keys.
+  using Map = std::vector<std::pair<int32_t, std::optional<std::string>>>;
+  auto maps = makeMapVector<int32_t, std::string>(std::vector<Map>{
+      {{1, "x"}, {2, "y"}}, {{2, "y"}, {1, "x"}}, {{1, "x"}, {2, "z"}}});
+  std::vector<std::string> serialized(maps->size());
+  for (auto i = 0; i < maps->size(); ++i) {
+    ContainerRowSerde::serialize(*maps, i, serialized[i]);
+  }
+  EXPECT_EQ(serialized[0], serialized[1]);
+  EXPECT_NE(serialized[0], serialized[2]);
+}
+
+TEST_F(ContainerRowSerdeTest, isBinaryEqualityComparable) {
+  EXPECT_TRUE(ContainerRowSerde::isBinaryEqualityComparable(
+      *ROW({"a", "b"}, {BIGINT(), ARRAY(VARCHAR())})));
+  EXPECT_TRUE(ContainerRowSerde::isBinaryEqualityComparable(
+      *MAP(INTEGER(), ROW({"a"}, {TIMESTAMP()}))));
+  EXPECT_FALSE(ContainerRowSerde::isBinaryEqualityComparable(
+      *ROW({"a", "b"}, {BIGINT(), DOUBLE()})));
+  EXPECT_FALSE(ContainerRowSerde::isBinaryEqualityComparable(
+      *ARRAY(MAP(REAL(), INTEGER()))));
+}
+
 } // namespace
 } // namespace facebook::velox::exec
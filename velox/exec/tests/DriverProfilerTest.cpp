@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/DriverProfiler.h"
+
+#include <folly/ScopeGuard.h>
+
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+DECLARE_int32(driver_profile_interval_ms);
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class DriverProfilerTest : public OperatorTestBase {};
+
+TEST_F(DriverProfilerTest, profileFrames) {
+  process::ProfileFrames frames;
+  ASSERT_TRUE(frames.read().empty());
+  const char* outer = process::internProfileName("outer");
+  ASSERT_EQ(outer, process::internProfileName(std::string("outer")));
+  frames.push(outer);
+  frames.push(process::internProfileName("inner"));
+  auto names = frames.read();
+  ASSERT_EQ(names.size(), 2);
+  ASSERT_STREQ(names[0], "outer");
+  ASSERT_STREQ(names[1], "inner");
+  frames.pop();
+  ASSERT_EQ(frames.read().size(), 1);
+
+  // Frames beyond the max depth are counted but not recorded.
+  for (auto i = 0; i < process::ProfileFrames::kMaxDepth; ++i) {
+    frames.push(outer);
+  }
+  ASSERT_EQ(frames.read().size(), process::ProfileFrames::kMaxDepth);
+  for (auto i = 0; i < process::ProfileFrames::kMaxDepth; ++i) {
+    frames.pop();
+  }
+  ASSERT_EQ(frames.read().size(), 1);
+}
+
+TEST_F(DriverProfilerTest, samplesByPlanNode) {
+  auto oldInterval = FLAGS_driver_profile_interval_ms;
+  FLAGS_driver_profile_interval_ms = 1;
+  SCOPE_EXIT {
+    FLAGS_driver_profile_interval_ms = oldInterval;
+  };
+
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 20; ++i) {
+    vectors.push_back(makeRowVector({makeFlatVector<int64_t>(
+        10'000, [](auto row) { return row; })}));
+  }
+  createDuckDbTable(vectors);
+  core::PlanNodeId projectId;
+  auto plan = PlanBuilder()
+                  .values(vectors, true)
+                  .project({"c0 * 3 + c0 % 7 AS p"})
+                  .capturePlanNodeId(projectId)
+                  .planNode();
+
+  // A sample is taken every ms, so a stack with an expression shows up
+  // after a few runs at most.
+  bool expressionSampled = false;
+  for (auto run = 0; run < 100 && !expressionSampled; ++run) {
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .maxDrivers(2)
+                    .config(core::QueryConfig::kDriverProfilingEnabled, "true")
+                    .assertResults("SELECT c0 * 3 + c0 % 7 FROM tmp");
+    auto planStats = toPlanStats(task->taskStats());
+    for (const auto& [stack, count] : planStats.at(projectId).profileSamples) {
+      ASSERT_GT(count, 0);
+      ASSERT_EQ(stack.rfind("FilterProject", 0), 0) << stack;
+      if (stack.find(";plus") != std::string::npos) {
+        expressionSampled = true;
+      }
+    }
+  }
+  ASSERT_TRUE(expressionSampled);
+
+  // No samples without the config.
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .maxDrivers(2)
+                  .assertResults("SELECT c0 * 3 + c0 % 7 FROM tmp");
+  auto planStats = toPlanStats(task->taskStats());
+  ASSERT_TRUE(planStats.at(projectId).profileSamples.empty());
+}
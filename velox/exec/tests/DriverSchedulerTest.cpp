@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/DriverScheduler.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/ManualExecutor.h>
+
+#include "velox/common/process/ProcessBase.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+namespace {
+// Uses about 'nanos' of CPU time on the calling thread.
+void burnCpu(uint64_t nanos) {
+  const auto start = process::threadCpuNanos();
+  while (process::threadCpuNanos() - start < nanos) {
+  }
+}
+} // namespace
+
+class DriverSchedulerTest : public OperatorTestBase {};
+
+TEST_F(DriverSchedulerTest, levels) {
+  folly::ManualExecutor executor;
+  DriverScheduler scheduler(&executor);
+  ASSERT_EQ(scheduler.numLevels(), 5);
+  ASSERT_EQ(scheduler.levelOf(0), 0);
+  ASSERT_EQ(scheduler.levelOf(999'999'999), 0);
+  ASSERT_EQ(scheduler.levelOf(1'000'000'000), 1);
+  ASSERT_EQ(scheduler.levelOf(59'000'000'000), 2);
+  ASSERT_EQ(scheduler.levelOf(1'000'000'000'000), 4);
+
+  // A slice of a Driver that has used little CPU runs before the ones of long
+  // running Drivers even if queued last.
+  std::vector<int32_t> order;
+  scheduler.add("etl", 400'000'000'000, [&]() { order.push_back(4); });
+  scheduler.add("etl", 20'000'000'000, [&]() { order.push_back(2); });
+  scheduler.add("interactive", 0, [&]() { order.push_back(0); });
+
+  auto stats = scheduler.stats();
+  ASSERT_EQ(stats[0].numQueued, 1);
+  ASSERT_EQ(stats[2].numQueued, 1);
+  ASSERT_EQ(stats[4].numQueued, 1);
+
+  executor.drain();
+  ASSERT_EQ(order, (std::vector<int32_t>{0, 2, 4}));
+
+  stats = scheduler.stats();
+  for (auto level : {0, 2, 4}) {
+    ASSERT_EQ(stats[level].numQueued, 0);
+    ASSERT_EQ(stats[level].numRuns, 1);
+  }
+  ASSERT_EQ(stats[1].numRuns, 0);
+  ASSERT_EQ(stats[3].numRuns, 0);
+}
+
+TEST_F(DriverSchedulerTest, levelShares) {
+  folly::ManualExecutor executor;
+  DriverScheduler::Options options;
+  options.levelCpuNanos = {1'000'000'000};
+  options.levelTimeMultiplier = 4;
+  DriverScheduler scheduler(&executor, options);
+
+  // Levels 0 and 1 get CPU time in 4:1 ratio.
+  int32_t numRuns[2] = {0, 0};
+  constexpr int32_t kNumSlices = 100;
+  for (auto i = 0; i < kNumSlices; ++i) {
+    scheduler.add("short", 0, [&]() {
+      ++numRuns[0];
+      burnCpu(200'000);
+    });
+    scheduler.add("long", 2'000'000'000, [&]() {
+      ++numRuns[1];
+      burnCpu(200'000);
+    });
+  }
+  for (auto i = 0; i < kNumSlices; ++i) {
+    executor.step();
+  }
+  ASSERT_GT(numRuns[0], numRuns[1] * 2);
+  ASSERT_GT(numRuns[1], 0);
+  executor.drain();
+  ASSERT_EQ(numRuns[0], kNumSlices);
+  ASSERT_EQ(numRuns[1], kNumSlices);
+}
+
+TEST_F(DriverSchedulerTest, queryWeights) {
+  folly::ManualExecutor executor;
+  DriverScheduler scheduler(&executor);
+  scheduler.setQueryWeight("heavy", 3);
+
+  // Queries at the same level get CPU time in proportion to their weights.
+  folly::F14FastMap<std::string, int32_t> numRuns;
+  constexpr int32_t kNumSlices = 100;
+  for (auto i = 0; i < kNumSlices; ++i) {
+    for (const auto* queryId : {"heavy", "light"}) {
+      scheduler.add(queryId, 0, [&numRuns, queryId]() {
+        ++numRuns[queryId];
+        burnCpu(200'000);
+      });
+    }
+  }
+  for (auto i = 0; i < kNumSlices; ++i) {
+    executor.step();
+  }
+  ASSERT_GT(numRuns["heavy"], numRuns["light"] * 2);
+  ASSERT_GT(numRuns["light"], 0);
+
+  // A query that was idle does not get credit for the idle time. It shares
+  // the CPU with the query that is still running instead of taking all of it.
+  for (auto i = 0; i < 10; ++i) {
+    scheduler.add("new", 0, [&]() {
+      ++numRuns["new"];
+      burnCpu(200'000);
+    });
+  }
+  for (auto i = 0; i < 10; ++i) {
+    executor.step();
+  }
+  ASSERT_LT(numRuns["new"], 10);
+
+  executor.drain();
+  ASSERT_EQ(numRuns["new"], 10);
+  ASSERT_EQ(numRuns["heavy"], kNumSlices);
+  ASSERT_EQ(numRuns["light"], kNumSlices);
+}
+
+TEST_F(DriverSchedulerTest, runQuery) {
+  auto data = makeRowVector({makeFlatVector<int64_t>(
+      1'000, [](auto row) { return row % 7; })});
+  createDuckDbTable({data, data, data});
+  auto plan = PlanBuilder()
+                  .values({data, data, data})
+                  .singleAggregation({"c0"}, {"count(1)"})
+                  .planNode();
+
+  folly::CPUThreadPoolExecutor threads(2);
+  DriverScheduler scheduler(&threads);
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .queryCtx(std::make_shared<core::QueryCtx>(&scheduler))
+      .assertResults("SELECT c0, count(1) FROM tmp GROUP BY 1");
+  // Wait for the Drivers to go off thread before checking stats.
+  threads.join();
+
+  uint64_t numRuns = 0;
+  for (const auto& stats : scheduler.stats()) {
+    numRuns += stats.numRuns;
+    ASSERT_EQ(stats.numQueued, 0);
+  }
+  ASSERT_GT(numRuns, 0);
+}
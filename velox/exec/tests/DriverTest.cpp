@@ -1027,6 +1027,37 @@ TEST_F(DriverTest, nonVeloxOperatorException) {
       "Operator::getOutput failed for [operator: Throw, plan node ID: 1]");
 }
 
+TEST_F(DriverTest, resumeAtBlockedOperator) {
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 100; ++i) {
+    batches.push_back(makeRowVector({makeFlatVector<int64_t>(
+        10, [i](auto row) { return i * 10 + row; })}));
+  }
+  createDuckDbTable(batches);
+
+  // The consumer pipeline blocks on the local exchange after each small
+  // batch and comes back on thread at the LocalExchange operator.
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .localPartitionRoundRobin({PlanBuilder(planNodeIdGenerator)
+                                                 .values(batches)
+                                                 .planNode()})
+                  .project({"c0 + 1 AS c0"})
+                  .filter("c0 % 3 <> 0")
+                  .project({"c0 * 2 AS c0"})
+                  .singleAggregation({}, {"count(1)", "sum(c0)"})
+                  .planNode();
+  for (const auto* resume : {"false", "true"}) {
+    SCOPED_TRACE(resume);
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .maxDrivers(2)
+        .config(core::QueryConfig::kDriverResumeAtBlockedOperator, resume)
+        .assertResults(
+            "SELECT count(1), sum((c0 + 1) * 2) FROM tmp "
+            "WHERE (c0 + 1) % 3 <> 0");
+  }
+}
+
 DEBUG_ONLY_TEST_F(DriverTest, driverSuspensionRaceWithTaskPause) {
   struct {
     int numDrivers;
@@ -20,6 +20,7 @@
 #include "velox/exec/Task.h"
 #include "velox/exec/tests/utils/LocalExchangeSource.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TcpExchangeSource.h"
 #include "velox/serializers/PrestoSerializer.h"
 #include "velox/vector/tests/utils/VectorTestBase.h"
 
@@ -149,6 +150,43 @@ TEST_F(ExchangeClientTest, stats) {
   bufferManager_->removeTask(taskId);
 }
 
+TEST_F(ExchangeClientTest, multiplePages) {
+  auto data = makeRowVector({makeFlatVector<int32_t>({1, 2, 3})});
+  auto plan = test::PlanBuilder()
+                  .values({data})
+                  .partitionedOutput({"c0"}, 100)
+                  .planNode();
+  auto taskId = "local://t1";
+  auto task = makeTask(taskId, plan, 17);
+
+  bufferManager_->initializeTask(
+      task, core::PartitionedOutputNode::Kind::kPartitioned, 100, 16);
+
+  int32_t pageSize;
+  for (auto i = 0; i < 10; ++i) {
+    pageSize = enqueue(taskId, 17, data);
+  }
+
+  ExchangeClient client(
+      "t", 17, pool(), ExchangeClient::kDefaultMaxQueuedBytes);
+  client.addRemoteTaskId(taskId);
+
+  // All pages are the same size, so 3 fit in 3.5 pages.
+  bool atEnd;
+  ContinueFuture future;
+  for (auto i = 0; i < 3; ++i) {
+    auto pages = client.next(pageSize * 3.5, &atEnd, &future);
+    ASSERT_FALSE(atEnd);
+    EXPECT_EQ(3, pages.size());
+  }
+
+  // A limit below the page size still returns one page.
+  EXPECT_EQ(1, client.next(0, &atEnd, &future).size());
+
+  task->requestCancel();
+  bufferManager_->removeTask(taskId);
+}
+
 // Test scenario where fetching data from all sources at once would exceed queue
 // size. Verify that ExchangeClient is fetching data only from a few sources at
 // a time to avoid exceeding the limit.
@@ -197,5 +235,55 @@ TEST_F(ExchangeClientTest, flowControl) {
   }
 }
 
+TEST_F(ExchangeClientTest, tcpExchangeSource) {
+  ExchangeSource::registerFactory(test::createTcpExchangeSource);
+  test::TcpExchangeServer server("127.0.0.1", 0);
+
+  auto data = {
+      makeRowVector({makeFlatVector<int32_t>({1, 2, 3})}),
+      makeRowVector({makeFlatVector<int32_t>({1, 2, 3, 4, 5})}),
+      makeRowVector({makeFlatVector<int32_t>({1, 2})}),
+  };
+  auto plan = test::PlanBuilder()
+                  .values(data)
+                  .partitionedOutput({"c0"}, 100)
+                  .planNode();
+  auto taskId = "local://t1";
+  auto task = makeTask(taskId, plan, 17);
+  bufferManager_->initializeTask(
+      task, core::PartitionedOutputNode::Kind::kPartitioned, 100, 16);
+
+  ExchangeClient client(
+      "t", 17, pool(), ExchangeClient::kDefaultMaxQueuedBytes);
+  client.addRemoteTaskId(server.remoteTaskId(taskId));
+
+  std::vector<uint64_t> pageBytes;
+  for (auto vector : data) {
+    pageBytes.push_back(enqueue(taskId, 17, vector));
+  }
+  bufferManager_->noMoreData(taskId);
+
+  // The pages arrive from another thread, so wait for each.
+  std::vector<uint64_t> receivedBytes;
+  bool atEnd = false;
+  while (!atEnd) {
+    ContinueFuture future;
+    auto page = client.next(&atEnd, &future);
+    if (page != nullptr) {
+      receivedBytes.push_back(page->size());
+    } else if (!atEnd) {
+      std::move(future).wait();
+    }
+  }
+  EXPECT_EQ(pageBytes, receivedBytes);
+  EXPECT_EQ(data.size(), client.stats().at("numReceivedPages").sum);
+  EXPECT_FALSE(test::takeTcpExchangeRequestMicros().empty());
+
+  client.close();
+  server.stop();
+  task->requestCancel();
+  bufferManager_->removeTask(taskId);
+}
+
 } // namespace
 } // namespace facebook::velox::exec
@@ -322,3 +322,31 @@ TEST_F(FilterProjectTest, projectAndIdentityOverLazy) {
                   .planNode();
   assertQuery(plan, "SELECT c0 < 10 AND c1 < 10, c1 FROM tmp");
 }
+
+TEST_F(FilterProjectTest, compactedProjections) {
+  // Most rows pass the filter. Fixed width results are compacted to the
+  // passing rows, the string result and identity projections are wrapped in
+  // dictionaries.
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(std::dynamic_pointer_cast<RowVector>(
+        BatchMaker::createBatch(rowType_, 1'000, *pool_)));
+  }
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .filter("c0 % 4 <> 0")
+                  .project(
+                      {"c0",
+                       "c0 % 1000 + 1",
+                       "c1 % 1000 * 2",
+                       "c3 * 1.5",
+                       "cast(c1 as real)",
+                       "cast(c2 as varchar)"})
+                  .planNode();
+  assertQuery(
+      plan,
+      "SELECT c0, c0 % 1000 + 1, c1 % 1000 * 2, c3 * 1.5, cast(c1 as real), "
+      "cast(c2 as varchar) FROM tmp WHERE c0 % 4 <> 0");
+}
@@ -515,4 +515,58 @@ TEST_F(GroupedExecutionTest, groupedExecution) {
   EXPECT_EQ(numRead, numSplits * 10'000);
 }
 
+TEST_F(GroupedExecutionTest, memoryAdmission) {
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+
+  constexpr int64_t kMaxBytes = 100 << 20;
+  auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+  queryCtx->testingOverrideMemoryPool(
+      memory::defaultMemoryManager().addRootPool(
+          queryCtx->queryId(), kMaxBytes));
+  queryCtx->testingOverrideConfigUnsafe(
+      {{core::QueryConfig::kSplitGroupMemoryAdmissionPct, "50"}});
+
+  CursorParameters params;
+  params.planNode = tableScanNode(ROW({}, {}));
+  params.queryCtx = queryCtx;
+  params.maxDrivers = 2;
+  params.executionStrategy = core::ExecutionStrategy::kGrouped;
+  params.groupedExecutionLeafNodeIds.emplace(params.planNode->id());
+  params.numSplitGroups = 3;
+  params.numConcurrentSplitGroups = 2;
+  auto cursor = std::make_unique<TaskCursor>(params);
+  auto task = cursor->task();
+  cursor->start();
+
+  // Memory held by the first split group. Another split group of the same
+  // size would not fit in half of the limit.
+  auto pool = task->pool()->addLeafChild("test");
+  constexpr int64_t kGroupBytes = 40 << 20;
+  void* buffer = pool->allocate(kGroupBytes);
+
+  task->addSplit("0", makeHiveSplitWithGroup(filePath->path, 1));
+  task->addSplit("0", makeHiveSplitWithGroup(filePath->path, 5));
+  task->addSplit("0", makeHiveSplitWithGroup(filePath->path, 8));
+  EXPECT_EQ(2, task->numRunningDrivers());
+
+  // Once the memory is released, two split groups run after the first one
+  // finishes.
+  pool->free(buffer, kGroupBytes);
+  task->noMoreSplitsForGroup("0", 1);
+  waitForFinishedDrivers(task, 2);
+  EXPECT_EQ(4, task->numRunningDrivers());
+
+  task->noMoreSplitsForGroup("0", 5);
+  task->noMoreSplitsForGroup("0", 8);
+  task->noMoreSplits("0");
+  int32_t numRead = 0;
+  while (cursor->moveNext()) {
+    numRead += cursor->current()->size();
+  }
+  EXPECT_EQ(numRead, 3 * 10'000);
+  EXPECT_EQ(exec::TaskState::kFinished, task->state());
+}
+
 } // namespace facebook::velox::exec::test
@@ -22,6 +22,7 @@
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
 #include "velox/exec/HashBuild.h"
 #include "velox/exec/HashJoinBridge.h"
+#include "velox/exec/HashJoinTableCache.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/Cursor.h"
@@ -4419,6 +4420,224 @@ TEST_F(HashJoinTest, dynamicFilters) {
   }
 }
 
+TEST_F(HashJoinTest, bloomFilterDynamicFilters) {
+  const int32_t numSplits = 5;
+  const int32_t numRowsProbe = 1'000;
+  // More distinct keys than VectorHasher::kMaxDistinct to build the table in
+  // kHash mode which has no exact value filter to push down.
+  const int32_t numRowsBuild = 120'000;
+
+  std::vector<RowVectorPtr> probeVectors;
+  std::vector<std::shared_ptr<TempFilePath>> tempFiles;
+  for (int32_t i = 0; i < numSplits; ++i) {
+    auto rowVector = makeRowVector({
+        makeFlatVector<StringView>(
+            numRowsProbe,
+            [&](auto row) {
+              // One out of 10 probe rows has a match.
+              return StringView::makeInline(fmt::format(
+                  "{}", row % 10 == 0 ? row * 2 : numRowsBuild * 2 + row));
+            }),
+        makeFlatVector<int64_t>(numRowsProbe, [](auto row) { return row; }),
+    });
+    probeVectors.push_back(rowVector);
+    tempFiles.push_back(TempFilePath::create());
+    writeToFile(tempFiles.back()->path, rowVector);
+  }
+  auto makeInputSplits = [&](const core::PlanNodeId& nodeId) {
+    return [&] {
+      std::vector<exec::Split> probeSplits;
+      for (auto& file : tempFiles) {
+        probeSplits.push_back(exec::Split(makeHiveConnectorSplit(file->path)));
+      }
+      SplitInput splits;
+      splits.emplace(nodeId, probeSplits);
+      return splits;
+    };
+  };
+
+  std::vector<RowVectorPtr> buildVectors{makeRowVector({
+      makeFlatVector<StringView>(
+          numRowsBuild,
+          [](auto row) {
+            return StringView::makeInline(fmt::format("{}", row * 2));
+          }),
+      makeFlatVector<int64_t>(numRowsBuild, [](auto row) { return row; }),
+  })};
+
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  auto probeType = ROW({"c0", "c1"}, {VARCHAR(), BIGINT()});
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto buildSide = PlanBuilder(planNodeIdGenerator, pool_.get())
+                       .values(buildVectors)
+                       .project({"c0 AS u_c0", "c1 AS u_c1"})
+                       .planNode();
+
+  for (bool bloomFilterEnabled : {false, true}) {
+    SCOPED_TRACE(fmt::format("bloomFilterEnabled: {}", bloomFilterEnabled));
+    core::PlanNodeId probeScanId;
+    auto op = PlanBuilder(planNodeIdGenerator, pool_.get())
+                  .tableScan(probeType)
+                  .capturePlanNodeId(probeScanId)
+                  .hashJoin(
+                      {"c0"},
+                      {"u_c0"},
+                      buildSide,
+                      "",
+                      {"c0", "c1", "u_c1"},
+                      core::JoinType::kInner)
+                  .project({"c0", "c1 + u_c1"})
+                  .planNode();
+    HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+        .planNode(std::move(op))
+        .makeInputSplits(makeInputSplits(probeScanId))
+        .config(
+            core::QueryConfig::kHashJoinBloomFilterEnabled,
+            bloomFilterEnabled ? "true" : "false")
+        .referenceQuery("SELECT t.c0, t.c1 + u.c1 FROM t, u WHERE t.c0 = u.c0")
+        .verifier([&](const std::shared_ptr<Task>& task, bool hasSpill) {
+          SCOPED_TRACE(fmt::format("hasSpill:{}", hasSpill));
+          if (hasSpill || !bloomFilterEnabled) {
+            ASSERT_EQ(0, getFiltersProduced(task, 1).sum);
+            ASSERT_EQ(getInputPositions(task, 1), numRowsProbe * numSplits);
+          } else {
+            ASSERT_EQ(1, getFiltersProduced(task, 1).sum);
+            ASSERT_EQ(1, getFiltersAccepted(task, 0).sum);
+            // The join still runs since a Bloom filter may have false
+            // positives.
+            ASSERT_EQ(0, getReplacedWithFilterRows(task, 1).sum);
+            ASSERT_LT(getInputPositions(task, 1), numRowsProbe * numSplits);
+          }
+        })
+        .run();
+  }
+}
+
+TEST_F(HashJoinTest, hotKeyDetection) {
+  const int32_t numRowsBuild = 10'000;
+  // Half of the build rows have key 7, the other keys are unique.
+  std::vector<RowVectorPtr> buildVectors{makeRowVector(
+      {"u_c0", "u_c1"},
+      {makeFlatVector<int64_t>(
+           numRowsBuild,
+           [](auto row) { return row % 2 == 0 ? 7 : row + 1'000; }),
+       makeFlatVector<int64_t>(numRowsBuild, [](auto row) { return row; })})};
+  std::vector<RowVectorPtr> probeVectors{makeRowVector(
+      {"t_c0", "t_c1"},
+      {makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+       makeFlatVector<int64_t>(100, [](auto row) { return row; })})};
+
+  const auto numHotKeys = [](const exec::Task& task) {
+    int64_t count = 0;
+    for (auto& pipelineStat : task.taskStats().pipelineStats) {
+      for (auto& operatorStat : pipelineStat.operatorStats) {
+        if (operatorStat.operatorType == "HashBuild" &&
+            operatorStat.runtimeStats.count("hashtable.numHotKeys") != 0) {
+          count += operatorStat.runtimeStats.at("hashtable.numHotKeys").sum;
+        }
+      }
+    }
+    return count;
+  };
+
+  for (const auto hotKeyRowsPct : {0, 10}) {
+    SCOPED_TRACE(fmt::format("hotKeyRowsPct: {}", hotKeyRowsPct));
+    HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+        .numDrivers(1)
+        .probeKeys({"t_c0"})
+        .probeVectors(std::vector<RowVectorPtr>(probeVectors))
+        .buildKeys({"u_c0"})
+        .buildVectors(std::vector<RowVectorPtr>(buildVectors))
+        .config(
+            core::QueryConfig::kHashJoinHotKeyRowsPct,
+            std::to_string(hotKeyRowsPct))
+        .referenceQuery(
+            "SELECT t_c0, t_c1, u_c0, u_c1 FROM t, u WHERE t_c0 = u_c0")
+        .verifier([&](const std::shared_ptr<Task>& task, bool hasSpill) {
+          if (hasSpill) {
+            return;
+          }
+          ASSERT_EQ(numHotKeys(*task), hotKeyRowsPct == 0 ? 0 : 1);
+        })
+        .run();
+  }
+}
+
+TEST_F(HashJoinTest, tableCache) {
+  std::vector<RowVectorPtr> buildVectors{makeRowVector(
+      {"u_c0", "u_c1"},
+      {makeFlatVector<int64_t>(1'000, [](auto row) { return row * 3; }),
+       makeFlatVector<int64_t>(1'000, [](auto row) { return row; })})};
+  std::vector<RowVectorPtr> probeVectors{makeRowVector(
+      {"t_c0", "t_c1"},
+      {makeFlatVector<int64_t>(2'000, [](auto row) { return row; }),
+       makeFlatVector<int64_t>(2'000, [](auto row) { return row; })})};
+  createDuckDbTable("t", probeVectors);
+  // Each of the 4 build drivers gets all of 'buildVectors'.
+  createDuckDbTable(
+      "u", {buildVectors[0], buildVectors[0], buildVectors[0], buildVectors[0]});
+
+  const auto numCacheHits = [](const exec::Task& task) {
+    int64_t count = 0;
+    for (auto& pipelineStat : task.taskStats().pipelineStats) {
+      for (auto& operatorStat : pipelineStat.operatorStats) {
+        if (operatorStat.operatorType == "HashBuild" &&
+            operatorStat.runtimeStats.count("tableCacheHit") != 0) {
+          count += operatorStat.runtimeStats.at("tableCacheHit").sum;
+        }
+      }
+    }
+    return count;
+  };
+
+  auto& cache = HashJoinTableCache::instance();
+  cache.testingClear();
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values(probeVectors)
+                  .hashJoin(
+                      {"t_c0"},
+                      {"u_c0"},
+                      PlanBuilder(planNodeIdGenerator)
+                          .values(buildVectors, true)
+                          .planNode(),
+                      "",
+                      {"t_c0", "t_c1", "u_c1"})
+                  .planNode();
+  const std::string referenceQuery =
+      "SELECT t_c0, t_c1, u_c1 FROM t, u WHERE t_c0 = u_c0";
+
+  for (int i = 0; i < 3; ++i) {
+    SCOPED_TRACE(fmt::format("run: {}", i));
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .maxDrivers(4)
+                    .config(core::QueryConfig::kHashJoinTableCacheKey, "u.v1")
+                    .assertResults(referenceQuery);
+    ASSERT_EQ(numCacheHits(*task), i == 0 ? 0 : 1);
+  }
+  auto stats = cache.stats();
+  ASSERT_EQ(stats.numEntries, 1);
+  ASSERT_EQ(stats.numMisses, 1);
+  ASSERT_EQ(stats.numHits, 2);
+  ASSERT_GT(stats.currentBytes, 0);
+
+  // A different key builds a new table.
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .maxDrivers(4)
+                  .config(core::QueryConfig::kHashJoinTableCacheKey, "u.v2")
+                  .assertResults(referenceQuery);
+  ASSERT_EQ(numCacheHits(*task), 0);
+  ASSERT_EQ(cache.stats().numEntries, 2);
+
+  // No table is referenced after the queries finish.
+  task.reset();
+  ASSERT_GT(cache.evict(0), 0);
+  ASSERT_EQ(cache.stats().numEntries, 0);
+  cache.testingClear();
+}
+
 TEST_F(HashJoinTest, dynamicFiltersWithSkippedSplits) {
   const int32_t numSplits = 20;
   const int32_t numNonSkippedSplits = 10;
@@ -116,6 +116,76 @@ TEST_F(HashPartitionFunctionTest, function) {
   }
 }
 
+TEST_F(HashPartitionFunctionTest, skewedKeys) {
+  const int numRows = 1'000;
+  // Every other row has key 7.
+  RowVectorPtr vector = makeRowVector({makeFlatVector<int32_t>(
+      numRows, [](auto row) { return row % 2 == 0 ? 7 : row; })});
+  RowTypePtr rowType = asRowType(vector->type());
+
+  auto hasher = VectorHasher::create(INTEGER(), 0);
+  SelectivityVector rows(1);
+  raw_vector<uint64_t> hashes(1);
+  auto skewedKey = makeFlatVector<int32_t>({7});
+  hasher->decode(*skewedKey, rows);
+  hasher->hash(rows, false, hashes);
+  const SkewedKeys skewedKeys{{hashes[0]}, false};
+
+  std::vector<uint32_t> expectedPartitions(numRows);
+  HashPartitionFunction function(4, rowType, {0});
+  function.partition(*vector, expectedPartitions);
+
+  // Spreads the rows of the skewed key round-robin.
+  {
+    std::vector<uint32_t> partitions(numRows);
+    HashPartitionFunction skewedFunction(4, rowType, {0});
+    skewedFunction.setSkewedKeys(skewedKeys);
+    skewedFunction.partition(*vector, partitions);
+    for (auto i = 0; i < numRows; ++i) {
+      if (i % 2 == 0) {
+        ASSERT_EQ(partitions[i], (i / 2) % 4);
+      } else {
+        ASSERT_EQ(partitions[i], expectedPartitions[i]);
+      }
+    }
+  }
+
+  // Replicates the rows of the skewed key.
+  {
+    std::vector<uint32_t> partitions(numRows);
+    HashPartitionFunction skewedFunction(4, rowType, {0});
+    skewedFunction.setSkewedKeys({skewedKeys.hashes, true});
+    skewedFunction.partition(*vector, partitions);
+    for (auto i = 0; i < numRows; ++i) {
+      if (i % 2 == 0) {
+        ASSERT_EQ(partitions[i], core::PartitionFunction::kAllPartitions);
+      } else {
+        ASSERT_EQ(partitions[i], expectedPartitions[i]);
+      }
+    }
+  }
+
+  // Serializes the skewed keys with the spec.
+  {
+    Type::registerSerDe();
+    core::ITypedExpr::registerSerDe();
+    auto hashSpec = std::make_unique<exec::HashPartitionFunctionSpec>(
+        rowType,
+        std::vector<column_index_t>{0},
+        std::vector<VectorPtr>{},
+        SkewedKeys{skewedKeys.hashes, true});
+    ASSERT_EQ("HASH(c0) SKEWED(1 keys, REPLICATE)", hashSpec->toString());
+
+    auto copy =
+        HashPartitionFunctionSpec::deserialize(hashSpec->serialize(), pool());
+    ASSERT_EQ(hashSpec->toString(), copy->toString());
+
+    std::vector<uint32_t> partitions(numRows);
+    copy->create(4)->partition(*vector, partitions);
+    ASSERT_EQ(partitions[0], core::PartitionFunction::kAllPartitions);
+  }
+}
+
 TEST_F(HashPartitionFunctionTest, spec) {
   Type::registerSerDe();
   core::ITypedExpr::registerSerDe();
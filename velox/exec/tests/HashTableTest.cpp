@@ -516,6 +516,13 @@ TEST_P(HashTableTest, int2DenseArray) {
   testCycle(BaseHashTable::HashMode::kArray, 500, 2, type, 2);
 }
 
+TEST_P(HashTableTest, int1DenseArrayParallelBuild) {
+  // Enough rows per sub-table to build the kArray table in parallel if the
+  // executor is set.
+  auto type = ROW({"k1"}, {BIGINT()});
+  testCycle(BaseHashTable::HashMode::kArray, 5000, 4, type, 1);
+}
+
 TEST_P(HashTableTest, string1DenseArray) {
   auto type = ROW({"k1"}, {VARCHAR()});
   testCycle(BaseHashTable::HashMode::kArray, 500, 2, type, 1);
@@ -552,6 +559,14 @@ TEST_P(HashTableTest, structKey) {
   testCycle(BaseHashTable::HashMode::kHash, 100000, 2, type, 1);
 }
 
+TEST_P(HashTableTest, int4SparseHash) {
+  // Fixed width keys compared as one packed memory range.
+  auto type =
+      ROW({"k1", "k2", "k3", "k4"}, {BIGINT(), BIGINT(), BIGINT(), BIGINT()});
+  keySpacing_ = 1000;
+  testCycle(BaseHashTable::HashMode::kHash, 100000, 2, type, 4);
+}
+
 TEST_P(HashTableTest, mixed6Sparse) {
   auto type =
       ROW({"k1", "k2", "k3", "k4", "k5", "k6"},
@@ -215,6 +215,55 @@ TEST_F(MergeJoinTest, allRowsMatch) {
   testJoin(rightKeys, leftKeys);
 }
 
+TEST_F(MergeJoinTest, longKeyRuns) {
+  // Long runs of equal keys and of non-matching keys exercise the galloping
+  // search.
+  testJoin<int32_t>(
+      [](auto row) { return row / 100; },
+      [](auto row) { return row < 500 ? 0 : row / 37; });
+}
+
+TEST_F(MergeJoinTest, dictionaryOutput) {
+  auto left = makeRowVector(
+      {"t0", "t1"},
+      {makeFlatVector<int64_t>(100, [](auto row) { return row / 10; }),
+       makeFlatVector<int64_t>(100, [](auto row) { return row; })});
+  auto right = makeRowVector(
+      {"u0", "u1"},
+      {makeFlatVector<int64_t>(50, [](auto row) { return row / 5; }),
+       makeFlatVector<int64_t>(50, [](auto row) { return row; })});
+
+  createDuckDbTable("t", {left});
+  createDuckDbTable("u", {right});
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .values({left})
+          .mergeJoin(
+              {"t0"},
+              {"u0"},
+              PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+              "",
+              {"t0", "t1", "u1"},
+              core::JoinType::kInner)
+          .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .assertResults("SELECT t0, t1, u1 FROM t, u WHERE t.t0 = u.u0");
+
+  // All output comes from a single batch on each side, so the output columns
+  // wrap the inputs in dictionaries instead of copying.
+  CursorParameters params;
+  params.planNode = plan;
+  auto [cursor, results] = readCursor(params, [](Task*) {});
+  ASSERT_FALSE(results.empty());
+  for (const auto& result : results) {
+    for (const auto& child : result->children()) {
+      ASSERT_EQ(child->encoding(), VectorEncoding::Simple::DICTIONARY);
+    }
+  }
+}
+
 TEST_F(MergeJoinTest, aggregationOverJoin) {
   auto left =
       makeRowVector({"t_c0"}, {makeFlatVector<int32_t>({1, 2, 3, 4, 5})});
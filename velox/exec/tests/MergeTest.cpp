@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -182,3 +183,52 @@ TEST_F(MergeTest, offByOne) {
       {{core::QueryConfig::kPreferredOutputBatchRows, "6"}});
   assertQueryOrdered(params, "VALUES (0), (1), (2), (3), (4), (5), (10)", {0});
 }
+
+TEST_F(MergeTest, parallelOrderBy) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return (row * 7 + i) % 300; }, nullEvery(7)),
+        makeFlatVector<std::string>(
+            1'000, [&](auto row) { return std::to_string(row * i % 1'000); }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  for (const auto& orderByClauses : std::vector<std::vector<std::string>>{
+           {"c0 NULLS LAST", "c1"},
+           {"c0 DESC NULLS FIRST", "c1 DESC"},
+           {"c1", "c0 NULLS LAST"}}) {
+    SCOPED_TRACE(folly::join(", ", orderByClauses));
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    core::PlanNodeId mergeId;
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .localMerge(
+                        orderByClauses,
+                        {PlanBuilder(planNodeIdGenerator)
+                             .values(vectors, true)
+                             .orderBy(orderByClauses, true)
+                             .planNode()})
+                    .capturePlanNodeId(mergeId)
+                    .planNode();
+
+    CursorParameters params;
+    params.planNode = plan;
+    params.maxDrivers = 4;
+    params.queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+    params.queryCtx->testingOverrideConfigUnsafe(
+        {{core::QueryConfig::kParallelOrderByEnabled, "true"},
+         {core::QueryConfig::kPreferredOutputBatchRows, "300"}});
+    auto task = assertQueryOrdered(
+        params,
+        fmt::format(
+            "SELECT * FROM (SELECT * FROM tmp UNION ALL SELECT * FROM tmp "
+            "UNION ALL SELECT * FROM tmp UNION ALL SELECT * FROM tmp) "
+            "ORDER BY {}",
+            folly::join(", ", orderByClauses)),
+        {0, 1});
+    auto stats = toPlanStats(task->taskStats());
+    EXPECT_GT(stats.at(mergeId).customStats.at("concatenatedSources").sum, 1);
+  }
+}
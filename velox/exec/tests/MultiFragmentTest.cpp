@@ -686,6 +686,95 @@ TEST_F(MultiFragmentTest, replicateNullsAndAny) {
   }
 }
 
+TEST_F(MultiFragmentTest, inProcessExchange) {
+  configSettings_[core::QueryConfig::kInProcessExchange] = "true";
+  std::vector<RowVectorPtr> data;
+  for (int32_t i = 0; i < 5; ++i) {
+    data.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return i * 1'000 + row; }, nullEvery(11)),
+        makeFlatVector<StringView>(
+            1'000,
+            [](auto row) {
+              auto str = std::string(row % 29, 'x');
+              return StringView(str);
+            }),
+    }));
+  }
+  createDuckDbTable(data);
+
+  std::vector<std::shared_ptr<Task>> tasks;
+  auto addTask = [&](std::shared_ptr<Task> task,
+                     const std::vector<std::string>& remoteTaskIds) {
+    tasks.emplace_back(task);
+    Task::start(task, 1);
+    if (!remoteTaskIds.empty()) {
+      addRemoteSplits(task, remoteTaskIds);
+    }
+  };
+
+  // Hash partitioning hands out dictionaries over the input rows of each
+  // partition.
+  auto leafTaskId = makeTaskId("leaf", 0);
+  auto leafPlan =
+      PlanBuilder().values(data).partitionedOutput({"c0"}, 3).planNode();
+  addTask(makeTask(leafTaskId, leafPlan, 0), {});
+
+  // A single destination hands out whole input vectors.
+  std::vector<std::string> collectTaskIds;
+  for (int i = 0; i < 3; ++i) {
+    auto collectPlan = PlanBuilder()
+                           .exchange(leafPlan->outputType())
+                           .partitionedOutput({}, 1)
+                           .planNode();
+    collectTaskIds.push_back(makeTaskId("collect", i));
+    addTask(makeTask(collectTaskIds.back(), collectPlan, i), {leafTaskId});
+  }
+
+  auto finalPlan = PlanBuilder().exchange(leafPlan->outputType()).planNode();
+  assertQuery(finalPlan, collectTaskIds, "SELECT * FROM tmp");
+
+  for (auto& task : tasks) {
+    ASSERT_TRUE(waitForTaskCompletion(task.get())) << task->taskId();
+  }
+}
+
+TEST_F(MultiFragmentTest, smallPages) {
+  // Many producers of a few rows each. The Exchange combines the small pages
+  // it finds queued into larger output vectors.
+  constexpr int32_t kNumProducers = 20;
+  std::vector<RowVectorPtr> data;
+  std::vector<std::shared_ptr<Task>> tasks;
+  std::vector<std::string> leafTaskIds;
+  for (int32_t i = 0; i < kNumProducers; ++i) {
+    data.push_back(makeRowVector({
+        makeFlatVector<int64_t>(10, [&](auto row) { return i * 10 + row; }),
+        makeFlatVector<StringView>(
+            10, [](auto row) { return StringView::makeInline("abc"); }),
+    }));
+    auto leafPlan =
+        PlanBuilder().values({data.back()}).partitionedOutput({}, 1).planNode();
+    leafTaskIds.push_back(makeTaskId("leaf", i));
+    tasks.push_back(makeTask(leafTaskIds.back(), leafPlan, 0));
+    Task::start(tasks.back(), 1);
+  }
+  createDuckDbTable(data);
+
+  auto finalPlan =
+      PlanBuilder().exchange(asRowType(data[0]->type())).planNode();
+  auto task = assertQuery(finalPlan, leafTaskIds, "SELECT * FROM tmp");
+
+  auto exchangeStats =
+      task->taskStats().pipelineStats[0].operatorStats.front();
+  EXPECT_EQ(kNumProducers * 10, exchangeStats.outputPositions);
+  EXPECT_EQ(kNumProducers, exchangeStats.inputVectors);
+  EXPECT_LE(exchangeStats.outputVectors, exchangeStats.inputVectors);
+
+  for (auto& leafTask : tasks) {
+    ASSERT_TRUE(waitForTaskCompletion(leafTask.get())) << leafTask->taskId();
+  }
+}
+
 // Test query finishing before all splits have been scheduled.
 TEST_F(MultiFragmentTest, limit) {
   auto data = makeRowVector({makeFlatVector<int32_t>(
@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/exec/tests/utils/VectorTestUtil.h"
@@ -380,6 +381,43 @@ TEST_F(NestedLoopJoinTest, zeroColumnBuild) {
   assertQuery(op, "SELECT * FROM t");
 }
 
+// Build vectors smaller than the output batch size are merged and larger
+// ones are matched a block at a time.
+TEST_F(NestedLoopJoinTest, smallOutputBatchSize) {
+  auto probeVectors = {
+      makeRowVector({sequence<int32_t>(10)}),
+      makeRowVector({sequence<int32_t>(25, 10)}),
+  };
+  auto buildVectors = {
+      makeRowVector({"u_c0"}, {sequence<int32_t>(3)}),
+      makeRowVector({"u_c0"}, {sequence<int32_t>(2, 3)}),
+      makeRowVector({"u_c0"}, {sequence<int32_t>(30, 5)}),
+      makeRowVector({"u_c0"}, {sequence<int32_t>(1, 35)}),
+  };
+  createDuckDbTable("t", {makeRowVector({sequence<int32_t>(35)})});
+  createDuckDbTable("u", {makeRowVector({sequence<int32_t>(36)})});
+
+  for (const auto joinType : joinTypes_) {
+    SCOPED_TRACE(joinTypeName(joinType));
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values({probeVectors})
+                    .nestedLoopJoin(
+                        PlanBuilder(planNodeIdGenerator)
+                            .values({buildVectors})
+                            .planNode(),
+                        "c0 + u_c0 < 20",
+                        {"c0", "u_c0"},
+                        joinType)
+                    .planNode();
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(core::QueryConfig::kPreferredOutputBatchRows, "7")
+        .assertResults(fmt::format(
+            "SELECT * FROM t {} JOIN u ON t.c0 + u.c0 < 20",
+            joinTypeName(joinType)));
+  }
+}
+
 TEST_F(NestedLoopJoinTest, bigintArray) {
   auto probeVectors = makeBatches(1000, 5, probeType_, pool_.get());
   auto buildVectors = makeBatches(900, 5, buildType_, pool_.get());
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/NumaExecutor.h"
+
+#include <folly/synchronization/Baton.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class NumaExecutorTest : public OperatorTestBase {};
+
+TEST_F(NumaExecutorTest, parseCpuList) {
+  ASSERT_EQ(NumaExecutor::parseCpuList("0"), (std::vector<int32_t>{0}));
+  ASSERT_EQ(
+      NumaExecutor::parseCpuList("0-3,8,10-11\n"),
+      (std::vector<int32_t>{0, 1, 2, 3, 8, 10, 11}));
+  ASSERT_TRUE(NumaExecutor::parseCpuList("").empty());
+}
+
+TEST_F(NumaExecutorTest, numaNodeCpus) {
+  auto nodes = NumaExecutor::numaNodeCpus();
+  ASSERT_FALSE(nodes.empty());
+  for (const auto& cpus : nodes) {
+    ASSERT_FALSE(cpus.empty());
+  }
+}
+
+#ifdef __linux__
+TEST_F(NumaExecutorTest, pinning) {
+  // Two nodes on the CPU this thread runs on.
+  const int32_t cpu = sched_getcpu();
+  NumaExecutor executor({{cpu}, {cpu}}, 1);
+  ASSERT_EQ(executor.numNodes(), 2);
+  for (auto node = 0; node < executor.numNodes(); ++node) {
+    folly::Baton<> done;
+    int32_t runCpu = -1;
+    executor.add(node, [&]() {
+      runCpu = sched_getcpu();
+      done.post();
+    });
+    done.wait();
+    ASSERT_EQ(runCpu, cpu);
+  }
+}
+#endif
+
+TEST_F(NumaExecutorTest, runQuery) {
+  auto data = makeRowVector({makeFlatVector<int64_t>(
+      1'000, [](auto row) { return row % 7; })});
+  createDuckDbTable({data, data, data});
+  auto plan = PlanBuilder()
+                  .values({data, data, data}, true)
+                  .singleAggregation({"c0"}, {"count(1)"})
+                  .planNode();
+
+  auto cpus = NumaExecutor::numaNodeCpus().front();
+  NumaExecutor executor({cpus, cpus}, 2);
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .maxDrivers(4)
+      .queryCtx(std::make_shared<core::QueryCtx>(&executor))
+      .assertResults("SELECT c0, count(1) * 4 FROM tmp GROUP BY 1");
+}
@@ -359,3 +359,45 @@ TEST_F(OperatorUtilsTest, projectChildren) {
     }
   }
 }
+
+TEST_F(OperatorUtilsTest, compactFlatVector) {
+  const vector_size_t size = 1'000;
+  auto selectedBits = AlignedBuffer::allocate<bool>(size, pool(), false);
+  auto* rawSelected = selectedBits->asMutable<uint64_t>();
+  std::vector<vector_size_t> selected;
+  for (auto i = 0; i < size; ++i) {
+    // Runs of passing and failing rows of different lengths.
+    if (i % 13 < 9 && i % 7 != 3) {
+      bits::setBit(rawSelected, i);
+      selected.push_back(i);
+    }
+  }
+  const vector_size_t numSelected = selected.size();
+
+  VectorPtr vector = makeFlatVector<int64_t>(
+      size, [](auto row) { return row * 3; }, nullEvery(11));
+  ASSERT_TRUE(compactFlatVector(vector, rawSelected, size, numSelected));
+  auto expected = makeFlatVector<int64_t>(
+      numSelected,
+      [&](auto row) { return selected[row] * 3; },
+      [&](auto row) { return selected[row] % 11 == 0; });
+  assertEqualVectors(expected, vector);
+
+  vector = makeFlatVector<float>(size, [](auto row) { return row * 0.5; });
+  ASSERT_TRUE(compactFlatVector(vector, rawSelected, size, numSelected));
+  assertEqualVectors(
+      makeFlatVector<float>(
+          numSelected, [&](auto row) { return selected[row] * 0.5; }),
+      vector);
+
+  // A vector referenced elsewhere is not changed.
+  vector = makeFlatVector<int32_t>(size, [](auto row) { return row; });
+  auto copy = vector;
+  ASSERT_FALSE(compactFlatVector(vector, rawSelected, size, numSelected));
+  ASSERT_EQ(vector->size(), size);
+
+  // Strings are not compacted.
+  vector = makeFlatVector<std::string>(
+      size, [](auto row) { return std::to_string(row); });
+  ASSERT_FALSE(compactFlatVector(vector, rawSelected, size, numSelected));
+}
@@ -326,6 +326,29 @@ TEST_F(OrderByTest, multiBatchResult) {
   testSingleKey(vectors, "c0");
 }
 
+TEST_F(OrderByTest, sortInSteps) {
+  // Several sort runs with a partial last run, merged over several passes.
+  const vector_size_t kNumRows = 200'003;
+  auto data = makeRowVector(
+      {makeFlatVector<int64_t>(
+           kNumRows,
+           [](auto row) { return (row * 7'919) % 10'007; },
+           nullEvery(101)),
+       makeFlatVector<int32_t>(kNumRows, [](auto row) { return row; })});
+  createDuckDbTable({data});
+
+  auto plan = PlanBuilder()
+                  .values({data})
+                  .orderBy({"c0 DESC NULLS FIRST", "c1"}, false)
+                  .planNode();
+  auto task = assertQueryOrdered(
+      plan, "SELECT * FROM tmp ORDER BY c0 DESC NULLS FIRST, c1", {0, 1});
+
+  // The sort returns to the Driver between steps.
+  auto stats = task->taskStats().pipelineStats[0].operatorStats[1];
+  ASSERT_GT(stats.getOutputTiming.count, stats.outputVectors + 10);
+}
+
 TEST_F(OrderByTest, varfields) {
   vector_size_t batchSize = 1000;
   std::vector<RowVectorPtr> vectors;
@@ -492,6 +515,43 @@ TEST_F(OrderByTest, spill) {
   OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
 }
 
+TEST_F(OrderByTest, asyncMemoryReservation) {
+  const int kNumBatches = 3;
+  const int kNumRows = 100'000;
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < kNumBatches; ++i) {
+    batches.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(kNumRows, [](auto row) { return row * 3; }),
+         makeFlatVector<StringView>(kNumRows, [](auto row) {
+           return StringView::makeInline(std::to_string(row * 3));
+         })}));
+  }
+  createDuckDbTable(batches);
+
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .orderBy({"c0 ASC NULLS LAST"}, false)
+                  .planNode();
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+  queryCtx->testingOverrideConfigUnsafe({
+      {core::QueryConfig::kSpillEnabled, "true"},
+      {core::QueryConfig::kOrderBySpillEnabled, "true"},
+      {core::QueryConfig::kAsyncMemoryReservationEnabled, "true"},
+  });
+  CursorParameters params;
+  params.planNode = plan;
+  params.queryCtx = queryCtx;
+  params.spillDirectory = spillDirectory->path;
+  auto task = assertQueryOrdered(
+      params, "SELECT * FROM tmp ORDER BY c0 ASC NULLS LAST", {0});
+  auto stats = task->taskStats().pipelineStats[0].operatorStats[1];
+  // The reservation for the second input is grown with the driver off thread.
+  ASSERT_GT(stats.runtimeStats["blockedWaitForMemoryTimes"].count, 0);
+  ASSERT_EQ(stats.spilledRows, 0);
+  OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+}
+
 TEST_F(OrderByTest, spillWithMemoryLimit) {
   constexpr int32_t kNumRows = 2000;
   constexpr int64_t kMaxBytes = 1LL << 30; // 1GB
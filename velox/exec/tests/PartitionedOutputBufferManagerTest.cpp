@@ -553,6 +553,44 @@ TEST_F(PartitionedOutputBufferManagerTest, destinationBuffer) {
   }
 }
 
+TEST_F(PartitionedOutputBufferManagerTest, remainingBytes) {
+  const std::string taskId = "t0";
+  auto task = initializeTask(
+      taskId, rowType_, PartitionedOutputNode::Kind::kPartitioned, 1, 1);
+  int64_t totalBytes = 0;
+  for (auto i = 0; i < 4; ++i) {
+    auto page = makeSerializedPage(rowType_, 100);
+    totalBytes += page->size();
+    ContinueFuture future;
+    ASSERT_FALSE(bufferManager_->enqueue(taskId, 0, std::move(page), &future));
+  }
+
+  // The producer reports what it still has buffered past the returned pages.
+  // Pages before the requested sequence are acknowledged and not counted.
+  for (auto sequence = 0; sequence < 4; ++sequence) {
+    int64_t pageBytes = 0;
+    int64_t remainingBytes = -1;
+    ASSERT_TRUE(bufferManager_->getPages(
+        taskId,
+        0,
+        1,
+        sequence,
+        [&](std::vector<std::shared_ptr<SerializedPage>> pages,
+            int64_t /*sequence*/,
+            int64_t remaining) {
+          ASSERT_EQ(pages.size(), 1);
+          pageBytes = pages[0]->size();
+          remainingBytes = remaining;
+        }));
+    totalBytes -= pageBytes;
+    EXPECT_EQ(remainingBytes, totalBytes);
+  }
+  EXPECT_EQ(totalBytes, 0);
+
+  task->requestCancel();
+  bufferManager_->removeTask(taskId);
+}
+
 TEST_F(PartitionedOutputBufferManagerTest, basicPartitioned) {
   vector_size_t size = 100;
 
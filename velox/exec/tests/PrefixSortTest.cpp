@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PrefixSort.h"
+
+#include <gtest/gtest.h>
+
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+namespace facebook::velox::exec::test {
+namespace {
+
+class PrefixSortTest : public testing::Test,
+                       public velox::test::VectorTestBase {
+ protected:
+  // Stores 'data' in a RowContainer, sorts it by 'keys' with PrefixSort and
+  // checks that the rows come out in the order of a full comparison.
+  void testSort(
+      const RowVectorPtr& data,
+      const std::vector<std::pair<column_index_t, CompareFlags>>& keys) {
+    std::vector<TypePtr> types;
+    for (auto i = 0; i < data->childrenSize(); ++i) {
+      types.push_back(data->childAt(i)->type());
+    }
+    RowContainer container(types, pool());
+    std::vector<char*> rows(data->size());
+    SelectivityVector allRows(data->size());
+    for (auto i = 0; i < data->size(); ++i) {
+      rows[i] = container.newRow();
+    }
+    for (auto column = 0; column < data->childrenSize(); ++column) {
+      DecodedVector decoded(*data->childAt(column), allRows);
+      for (auto i = 0; i < data->size(); ++i) {
+        container.store(decoded, i, rows[i], column);
+      }
+    }
+
+    auto compare = [&](const char* left, const char* right) {
+      for (const auto& [column, flags] : keys) {
+        if (auto result = container.compare(left, right, column, flags)) {
+          return result;
+        }
+      }
+      return 0;
+    };
+    PrefixSort::sort(
+        container, keys, rows, [&](const char* left, const char* right) {
+          return compare(left, right) < 0;
+        });
+    for (auto i = 1; i < rows.size(); ++i) {
+      ASSERT_LE(compare(rows[i - 1], rows[i]), 0) << "at row " << i;
+    }
+  }
+
+  static std::vector<std::pair<column_index_t, CompareFlags>> makeKeys(
+      const std::vector<column_index_t>& columns,
+      bool nullsFirst,
+      bool ascending) {
+    std::vector<std::pair<column_index_t, CompareFlags>> keys;
+    for (auto column : columns) {
+      keys.emplace_back(column, CompareFlags{nullsFirst, ascending, false});
+    }
+    return keys;
+  }
+};
+
+TEST_F(PrefixSortTest, fuzz) {
+  auto type =
+      ROW({"c0", "c1", "c2", "c3", "c4", "c5", "c6", "c7", "c8"},
+          {TINYINT(),
+           SMALLINT(),
+           INTEGER(),
+           BIGINT(),
+           REAL(),
+           DOUBLE(),
+           TIMESTAMP(),
+           VARCHAR(),
+           BOOLEAN()});
+  VectorFuzzer::Options options;
+  options.vectorSize = 2'000;
+  options.nullRatio = 0.1;
+  options.stringLength = 20;
+  options.stringVariableLength = true;
+  VectorFuzzer fuzzer(options, pool());
+  auto data = fuzzer.fuzzInputRow(type);
+
+  const std::vector<std::vector<column_index_t>> keyLists = {
+      {0},
+      {1, 0},
+      {2},
+      {3, 2},
+      {4},
+      {5, 3},
+      {6},
+      {7},
+      {8, 7},
+      {3, 7},
+      {8, 0, 1, 2, 3}};
+  for (const auto& columns : keyLists) {
+    for (auto nullsFirst : {true, false}) {
+      for (auto ascending : {true, false}) {
+        SCOPED_TRACE(fmt::format(
+            "keys {} nullsFirst {} ascending {}",
+            folly::join(",", columns),
+            nullsFirst,
+            ascending));
+        testSort(data, makeKeys(columns, nullsFirst, ascending));
+      }
+    }
+  }
+}
+
+TEST_F(PrefixSortTest, ties) {
+  // Few distinct values, strings with a common part longer than the prefix
+  // and floating point values that compare equal with different bits.
+  const std::vector<double> doubles = {
+      0.0,
+      -0.0,
+      std::numeric_limits<double>::quiet_NaN(),
+      -std::numeric_limits<double>::quiet_NaN(),
+      std::numeric_limits<double>::infinity(),
+      -std::numeric_limits<double>::infinity(),
+      1.5,
+      -1.5,
+      std::numeric_limits<double>::lowest()};
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row % 7 - 3; }),
+      makeFlatVector<std::string>(
+          1'000,
+          [](auto row) {
+            return fmt::format("a common part longer than the prefix {}", row);
+          }),
+      makeFlatVector<double>(
+          1'000,
+          [&](auto row) { return doubles[row % doubles.size()]; },
+          nullEvery(11)),
+      makeFlatVector<std::string>(
+          1'000, [](auto row) { return std::string(row % 5, 'x'); }),
+  });
+
+  const std::vector<std::vector<column_index_t>> keyLists = {
+      {0}, {0, 1}, {1, 0}, {2, 0}, {3, 0}};
+  for (const auto& columns : keyLists) {
+    for (auto ascending : {true, false}) {
+      SCOPED_TRACE(fmt::format(
+          "keys {} ascending {}", folly::join(",", columns), ascending));
+      testSort(data, makeKeys(columns, true, ascending));
+    }
+  }
+}
+
+} // namespace
+} // namespace facebook::velox::exec::test
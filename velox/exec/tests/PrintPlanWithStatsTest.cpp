@@ -301,3 +301,57 @@ TEST_F(PrintPlanWithStatsTest, partialAggregateWithTableScan) {
          {"        totalScanTime    [ ]* sum: .+, count: .+, min: .+, max: .+"}});
   }
 }
+
+TEST_F(PrintPlanWithStatsTest, keyNdvs) {
+  vector_size_t size = 10'000;
+  auto probe = makeRowVector(
+      {"p0", "p1"},
+      {makeFlatVector<int64_t>(size, [](auto row) { return row % 1'000; }),
+       makeFlatVector<int32_t>(
+           size, [](auto row) { return row % 7; }, nullEvery(3))});
+  auto build = makeRowVector(
+      {"b0"}, {makeFlatVector<int64_t>(size, [](auto row) { return row; })});
+  createDuckDbTable({probe, probe});
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId joinNodeId;
+  core::PlanNodeId aggregationNodeId;
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .values({probe, probe})
+          .hashJoin(
+              {"p0"},
+              {"b0"},
+              PlanBuilder(planNodeIdGenerator).values({build}).planNode(),
+              "",
+              {"p0", "p1"})
+          .capturePlanNodeId(joinNodeId)
+          .singleAggregation({"p0", "p1"}, {"count(1)"})
+          .capturePlanNodeId(aggregationNodeId)
+          .planNode();
+
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .config(core::QueryConfig::kCollectKeyNdvs, "true")
+          .assertResults("SELECT p0, p1, count(*) FROM tmp GROUP BY 1, 2");
+
+  // The estimates are within a few percent of the exact counts. Nulls are
+  // not counted.
+  auto planStats = toPlanStats(task->taskStats());
+  auto joinNdvs = planStats.at(joinNodeId).keyNdvs();
+  ASSERT_EQ(joinNdvs.size(), 1);
+  EXPECT_NEAR(joinNdvs.at("b0"), size, size * 0.05);
+
+  auto aggregationNdvs = planStats.at(aggregationNodeId).keyNdvs();
+  ASSERT_EQ(aggregationNdvs.size(), 2);
+  EXPECT_NEAR(aggregationNdvs.at("p0"), 1'000, 50);
+  EXPECT_NEAR(aggregationNdvs.at("p1"), 7, 1);
+  EXPECT_NE(
+      planStats.at(aggregationNodeId).toString().find("Key NDVs: p0="),
+      std::string::npos);
+
+  // The fanout of the join is 1 per probe row.
+  EXPECT_EQ(
+      planStats.at(joinNodeId).operatorStats.at("HashProbe")->outputRatio(),
+      1);
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/ResultStream.h"
+
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/vector/arrow/Abi.h"
+#include "velox/vector/arrow/Bridge.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class ResultStreamTest : public OperatorTestBase {
+ protected:
+  static constexpr int32_t kNumDrivers = 4;
+
+  // Starts a Task for 'plan' with 'kNumDrivers' output Drivers that write to
+  // 'stream'.
+  std::shared_ptr<Task> startTask(
+      const core::PlanNodePtr& plan,
+      const std::shared_ptr<ResultStream>& stream) {
+    auto task = Task::create(
+        "task-0",
+        core::PlanFragment{plan},
+        0,
+        std::make_shared<core::QueryCtx>(driverExecutor_.get()),
+        stream->consumerSupplier());
+    Task::start(task, kNumDrivers);
+    stream->setNumProducers(task->numOutputDrivers());
+    return task;
+  }
+
+  std::vector<RowVectorPtr> makeBatches(int32_t numBatches) {
+    std::vector<RowVectorPtr> batches;
+    for (auto i = 0; i < numBatches; ++i) {
+      batches.push_back(makeRowVector({makeFlatVector<int64_t>(
+          100, [i](auto row) { return i * 100 + row; })}));
+    }
+    return batches;
+  }
+};
+
+TEST_F(ResultStreamTest, basic) {
+  auto batches = makeBatches(20);
+  createDuckDbTable(batches);
+  auto plan = PlanBuilder()
+                  .values(batches, true)
+                  .project({"c0 * 2 AS c0"})
+                  .planNode();
+
+  // One queued batch per Driver makes the Drivers wait for the consumer.
+  auto stream =
+      std::make_shared<ResultStream>(asRowType(plan->outputType()), 1);
+  auto task = startTask(plan, stream);
+  std::vector<RowVectorPtr> results;
+  while (auto batch = stream->next()) {
+    results.push_back(batch);
+  }
+  ASSERT_TRUE(waitForTaskCompletion(task.get()));
+  ASSERT_EQ(results.size(), batches.size() * kNumDrivers);
+  assertResults(
+      results,
+      plan->outputType(),
+      "SELECT c0 * 2 FROM tmp, (VALUES (1), (2), (3), (4)) t(x)",
+      duckDbQueryRunner_);
+}
+
+TEST_F(ResultStreamTest, error) {
+  auto plan = PlanBuilder()
+                  .values(makeBatches(10), true)
+                  .project({"c0 / (c0 - 500) AS c0"})
+                  .planNode();
+  auto stream = std::make_shared<ResultStream>(asRowType(plan->outputType()));
+  auto task = startTask(plan, stream);
+  while (stream->next()) {
+  }
+  ASSERT_TRUE(waitForTaskFailure(task.get()));
+  ASSERT_TRUE(task->error() != nullptr);
+}
+
+TEST_F(ResultStreamTest, arrow) {
+  auto batches = makeBatches(10);
+  auto plan = PlanBuilder()
+                  .values(batches, true)
+                  .filter("c0 % 3 = 0")
+                  .planNode();
+  auto stream = std::make_shared<ResultStream>(asRowType(plan->outputType()));
+  auto task = startTask(plan, stream);
+
+  ArrowArrayStream arrowStream;
+  stream->exportToArrow(arrowStream, pool_);
+  stream.reset();
+
+  ArrowSchema schema;
+  ASSERT_EQ(arrowStream.get_schema(&arrowStream, &schema), 0);
+  ASSERT_EQ(std::string(schema.format), "+s");
+  ASSERT_EQ(schema.n_children, 1);
+  ASSERT_EQ(std::string(schema.children[0]->format), "l");
+
+  int64_t numRows = 0;
+  for (;;) {
+    ArrowArray array;
+    ASSERT_EQ(arrowStream.get_next(&arrowStream, &array), 0);
+    if (array.release == nullptr) {
+      break;
+    }
+    ArrowSchema batchSchema;
+    ASSERT_EQ(arrowStream.get_schema(&arrowStream, &batchSchema), 0);
+    auto vector = importFromArrowAsOwner(batchSchema, array, pool_.get());
+    for (auto i = 0; i < vector->size(); ++i) {
+      ASSERT_EQ(
+          vector->as<RowVector>()
+                  ->childAt(0)
+                  ->asFlatVector<int64_t>()
+                  ->valueAt(i) %
+              3,
+          0);
+    }
+    numRows += vector->size();
+  }
+  ASSERT_EQ(numRows, 334 * kNumDrivers);
+
+  schema.release(&schema);
+  arrowStream.release(&arrowStream);
+  ASSERT_TRUE(arrowStream.release == nullptr);
+  ASSERT_TRUE(waitForTaskCompletion(task.get()));
+}
@@ -1227,3 +1227,85 @@ TEST_F(RowContainerTest, mixedFree) {
   data1->checkConsistency();
   data2->checkConsistency();
 }
+
+TEST_F(RowContainerTest, compactStringAllocator) {
+  constexpr int32_t kNumRows = 10'000;
+  auto data = makeRowContainer({BIGINT()}, {VARCHAR(), ARRAY(BIGINT())});
+  auto input = makeRowVector({
+      makeFlatVector<int64_t>(kNumRows, [](auto row) { return row; }),
+      makeFlatVector<std::string>(
+          kNumRows,
+          [](auto row) { return std::string(100 + row % 200, 'a' + row % 26); },
+          nullEvery(7)),
+      makeArrayVector<int64_t>(
+          kNumRows,
+          [](auto row) { return 10 + row % 30; },
+          [](auto row, auto index) { return row + index; }),
+  });
+  std::vector<char*> rows(kNumRows);
+  std::vector<DecodedVector> decoded(input->childrenSize());
+  for (auto column = 0; column < decoded.size(); ++column) {
+    decoded[column].decode(*input->childAt(column));
+  }
+  for (auto row = 0; row < kNumRows; ++row) {
+    rows[row] = data->newRow();
+    for (auto column = 0; column < decoded.size(); ++column) {
+      data->store(decoded[column], row, rows[row], column);
+    }
+  }
+
+  // Erase every second row to leave the string allocator fragmented.
+  std::vector<char*> erased;
+  std::vector<char*> kept;
+  std::vector<vector_size_t> keptIndices;
+  for (auto row = 0; row < kNumRows; ++row) {
+    if (row % 2 == 0) {
+      erased.push_back(rows[row]);
+    } else {
+      kept.push_back(rows[row]);
+      keptIndices.push_back(row);
+    }
+  }
+  data->eraseRows(folly::Range<char**>(erased.data(), erased.size()));
+  const auto fragmentation = data->stringAllocator().fragmentation();
+  ASSERT_GT(fragmentation, 0.3);
+
+  // Not enough memory for the copy.
+  ASSERT_EQ(0, data->compactStringAllocator(0));
+  ASSERT_EQ(fragmentation, data->stringAllocator().fragmentation());
+
+  const auto retainedBytes = data->stringAllocator().retainedSize();
+  const auto compactedBytes =
+      data->compactStringAllocator(std::numeric_limits<int64_t>::max());
+  ASSERT_GT(compactedBytes, 0);
+  ASSERT_EQ(
+      retainedBytes - compactedBytes, data->stringAllocator().retainedSize());
+  ASSERT_LT(data->stringAllocator().fragmentation(), fragmentation);
+  data->checkConsistency();
+
+  auto indices = makeIndices(
+      keptIndices.size(), [&](auto row) { return keptIndices[row]; });
+  for (auto column = 1; column < input->childrenSize(); ++column) {
+    auto expected = BaseVector::wrapInDictionary(
+        nullptr, indices, keptIndices.size(), input->childAt(column));
+    auto result = BaseVector::create(
+        input->childAt(column)->type(), kept.size(), pool_.get());
+    data->extractColumn(kept.data(), kept.size(), column, result);
+    assertEqualVectors(expected, result);
+  }
+
+  // A container that shares its string allocator is not compacted.
+  auto sharing = std::make_unique<RowContainer>(
+      std::vector<TypePtr>{BIGINT()},
+      false,
+      std::vector<Accumulator>{},
+      std::vector<TypePtr>{VARCHAR()},
+      false,
+      false,
+      false,
+      false,
+      pool_.get(),
+      data->stringAllocatorShared());
+  ASSERT_EQ(
+      0, data->compactStringAllocator(std::numeric_limits<int64_t>::max()));
+}
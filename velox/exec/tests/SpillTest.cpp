@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/Spill.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <memory>
@@ -356,7 +357,7 @@ class SpillTest : public ::testing::TestWithParam<common::CompressionKind>,
     ASSERT_EQ(
         finalStats.toString(),
         fmt::format(
-            "spillRuns[{}] spilledInputBytes[{}] spilledBytes[{}] spilledRows[{}] spilledPartitions[{}] spilledFiles[{}] spillFillTimeUs[{}] spillSortTime[{}] spillSerializationTime[{}] spillDiskWrites[{}] spillFlushTime[{}] spillWriteTime[{}]",
+            "spillRuns[{}] spilledInputBytes[{}] spilledBytes[{}] spilledRows[{}] spilledPartitions[{}] spilledFiles[{}] spillFillTimeUs[{}] spillSortTime[{}] spillSerializationTime[{}] spillDiskWrites[{}] spillFlushTime[{}] spillWriteTime[{}] spillReadWaitTime[{}]",
             finalStats.spillRuns,
             succinctBytes(finalStats.spilledInputBytes),
             succinctBytes(finalStats.spilledBytes),
@@ -368,7 +369,8 @@ class SpillTest : public ::testing::TestWithParam<common::CompressionKind>,
             succinctMicros(finalStats.spillSerializationTimeUs),
             finalStats.spillDiskWrites,
             succinctMicros(finalStats.spillFlushTimeUs),
-            succinctMicros(finalStats.spillWriteTimeUs)));
+            succinctMicros(finalStats.spillWriteTimeUs),
+            succinctMicros(finalStats.spillReadWaitTimeUs)));
 
     // Verify the spilled files are still there after spill state destruction.
     for (const auto& spilledFile : spilledFileSet) {
@@ -453,6 +455,179 @@ TEST_P(SpillTest, spillTimestamp) {
   ASSERT_EQ(nullptr, merge->next());
 }
 
+TEST_P(SpillTest, spillStateWithReadAhead) {
+  // Spill files larger than the read buffer so that the merge reads ahead on
+  // 'executor'.
+  constexpr int32_t kNumRows = 400'000;
+  constexpr int32_t kNumFiles = 3;
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(2);
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  std::vector<CompareFlags> emptyCompareFlags;
+  SpillState state(
+      tempDirectory->path + "/test",
+      1,
+      1,
+      emptyCompareFlags,
+      kGB,
+      compressionKind_,
+      pool(),
+      &stats_,
+      executor.get());
+  state.setPartitionSpilled(0);
+  for (auto i = 0; i < kNumFiles; ++i) {
+    state.appendToPartition(
+        0, makeRowVector({makeFlatVector<int64_t>(kNumRows, [&](auto row) {
+          return row * kNumFiles + i;
+        })}));
+    state.finishWrite(0);
+  }
+
+  auto merge = state.startMerge(0, nullptr);
+  for (auto i = 0; i < kNumRows * kNumFiles; ++i) {
+    auto stream = merge->next();
+    ASSERT_NE(nullptr, stream);
+    ASSERT_EQ(
+        i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
+    stream->pop();
+  }
+  ASSERT_EQ(nullptr, merge->next());
+}
+
+TEST_P(SpillTest, spillStateWithCompactRowFormat) {
+  // Spill sorted runs with strings spanning several read buffers in compact
+  // row format and merge them back.
+  constexpr int32_t kNumRows = 50'000;
+  constexpr int32_t kNumFiles = 2;
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  std::vector<CompareFlags> emptyCompareFlags;
+  SpillState state(
+      tempDirectory->path + "/test",
+      1,
+      1,
+      emptyCompareFlags,
+      kGB,
+      compressionKind_,
+      pool(),
+      &stats_,
+      nullptr,
+      SpillFormat::kCompactRow);
+  ASSERT_EQ(SpillFormat::kCompactRow, state.format());
+  const auto makeString = [](auto value) {
+    return std::string(value % 100, 'a' + value % 26);
+  };
+  state.setPartitionSpilled(0);
+  for (auto i = 0; i < kNumFiles; ++i) {
+    state.appendToPartition(
+        0,
+        makeRowVector(
+            {makeFlatVector<int64_t>(
+                 kNumRows, [&](auto row) { return row * kNumFiles + i; }),
+             makeFlatVector<std::string>(kNumRows, [&](auto row) {
+               return makeString(row * kNumFiles + i);
+             })}));
+    state.finishWrite(0);
+  }
+
+  auto merge = state.startMerge(0, nullptr);
+  for (auto i = 0; i < kNumRows * kNumFiles; ++i) {
+    auto stream = merge->next();
+    ASSERT_NE(nullptr, stream);
+    const auto index = stream->currentIndex();
+    ASSERT_EQ(i, stream->decoded(0).valueAt<int64_t>(index));
+    ASSERT_EQ(
+        makeString(i), stream->decoded(1).valueAt<StringView>(index).str());
+    stream->pop();
+  }
+  ASSERT_EQ(nullptr, merge->next());
+
+  ASSERT_EQ(SpillFormat::kPresto, stringToSpillFormat("presto"));
+  ASSERT_EQ(SpillFormat::kCompactRow, stringToSpillFormat("compact_row"));
+  ASSERT_EQ("compact_row", spillFormatName(SpillFormat::kCompactRow));
+  VELOX_ASSERT_THROW(stringToSpillFormat("foo"), "Unknown spill format: foo");
+}
+
+TEST_P(SpillTest, spillDirectorySet) {
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  const auto localA = tempDirectory->path + "/a";
+  const auto localB = tempDirectory->path + "/b";
+  const auto overflow = tempDirectory->path + "/overflow";
+  {
+    SpillDirectorySet directories({{localA, 1'000}, {localB, 1'000}}, overflow);
+    ASSERT_EQ(3, directories.numDirectories());
+    int32_t index;
+    // Files are striped over the local directories with the same free space.
+    ASSERT_EQ(localA + "/f0", directories.newFilePath("f0", index));
+    ASSERT_EQ(0, index);
+    ASSERT_EQ(localB + "/f1", directories.newFilePath("f1", index));
+    ASSERT_EQ(1, index);
+    directories.recordWrite(0, 1'000, 10);
+    directories.recordWrite(1, 500, 10);
+    ASSERT_EQ(localB + "/f2", directories.newFilePath("f2", index));
+    directories.recordWrite(1, 500, 10);
+    // All local directories are full.
+    ASSERT_EQ(overflow + "/f3", directories.newFilePath("f3", index));
+    ASSERT_EQ(2, index);
+    directories.recordWrite(2, 100, 0);
+
+    const auto stats = directories.stats();
+    ASSERT_EQ(3, stats.size());
+    ASSERT_EQ(localA, stats[0].path);
+    ASSERT_EQ(1, stats[0].numFiles);
+    ASSERT_EQ(1'000, stats[0].writtenBytes);
+    ASSERT_EQ(100'000'000, stats[0].writeBytesPerSecond());
+    ASSERT_EQ(2, stats[1].numFiles);
+    ASSERT_EQ(1'000, stats[1].writtenBytes);
+    ASSERT_EQ(1, stats[2].numFiles);
+    ASSERT_EQ(100, stats[2].writtenBytes);
+    ASSERT_EQ(0, stats[2].writeBytesPerSecond());
+  }
+
+  // Spill one file per batch over two local directories without overflow.
+  SpillDirectorySet directories({{localA, kGB}, {localB, kGB}});
+  std::vector<CompareFlags> emptyCompareFlags;
+  SpillState state(
+      tempDirectory->path + "/test",
+      1,
+      1,
+      emptyCompareFlags,
+      1,
+      compressionKind_,
+      pool(),
+      &stats_,
+      nullptr,
+      SpillFormat::kPresto,
+      &directories);
+  constexpr int32_t kNumBatches = 4;
+  constexpr int32_t kNumRows = 100;
+  state.setPartitionSpilled(0);
+  for (auto i = 0; i < kNumBatches; ++i) {
+    state.appendToPartition(
+        0, makeRowVector({makeFlatVector<int64_t>(kNumRows, [&](auto row) {
+          return row * kNumBatches + i;
+        })}));
+    state.finishWrite(0);
+  }
+  int32_t numFilesA = 0;
+  for (const auto& path : state.testingSpilledFilePaths()) {
+    numFilesA += path.find(localA + "/") == 0 ? 1 : 0;
+  }
+  ASSERT_EQ(kNumBatches / 2, numFilesA);
+  const auto stats = directories.stats();
+  ASSERT_EQ(
+      stats_.rlock()->spilledBytes,
+      stats[0].writtenBytes + stats[1].writtenBytes);
+
+  auto merge = state.startMerge(0, nullptr);
+  for (auto i = 0; i < kNumRows * kNumBatches; ++i) {
+    auto stream = merge->next();
+    ASSERT_NE(nullptr, stream);
+    ASSERT_EQ(
+        i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
+    stream->pop();
+  }
+  ASSERT_EQ(nullptr, merge->next());
+}
+
 TEST_P(SpillTest, spillStateWithSmallTargetFileSize) {
   // Set the target file size to a small value to open a new file on each batch
   // write.
@@ -697,6 +872,7 @@ TEST(SpillTest, spillStats) {
   stats1.spillFillTimeUs = 1023;
   stats1.spilledRows = 1023;
   stats1.spillSerializationTimeUs = 1023;
+  stats1.spillReadWaitTimeUs = 1023;
   SpillStats stats2;
   stats2.spillRuns = 100;
   stats2.spilledInputBytes = 2048;
@@ -710,6 +886,7 @@ TEST(SpillTest, spillStats) {
   stats2.spillFillTimeUs = 1030;
   stats2.spilledRows = 1031;
   stats2.spillSerializationTimeUs = 1032;
+  stats2.spillReadWaitTimeUs = 1033;
   ASSERT_TRUE(stats1 < stats2);
   ASSERT_TRUE(stats1 <= stats2);
   ASSERT_FALSE(stats1 > stats2);
@@ -736,6 +913,7 @@ TEST(SpillTest, spillStats) {
   ASSERT_EQ(delta.spillFillTimeUs, 7);
   ASSERT_EQ(delta.spilledRows, 8);
   ASSERT_EQ(delta.spillSerializationTimeUs, 9);
+  ASSERT_EQ(delta.spillReadWaitTimeUs, 10);
   delta = stats1 - stats2;
   ASSERT_EQ(delta.spilledInputBytes, 0);
   ASSERT_EQ(delta.spilledBytes, 0);
@@ -748,6 +926,7 @@ TEST(SpillTest, spillStats) {
   ASSERT_EQ(delta.spillFillTimeUs, -7);
   ASSERT_EQ(delta.spilledRows, -8);
   ASSERT_EQ(delta.spillSerializationTimeUs, -9);
+  ASSERT_EQ(delta.spillReadWaitTimeUs, -10);
   stats1.spilledInputBytes = 2060;
   stats1.spilledBytes = 1030;
   VELOX_ASSERT_THROW(stats1 < stats2, "");
@@ -761,5 +940,5 @@ TEST(SpillTest, spillStats) {
   ASSERT_EQ(zeroStats, stats1);
   ASSERT_EQ(
       stats2.toString(),
-      "spillRuns[100] spilledInputBytes[2.00KB] spilledBytes[1.00KB] spilledRows[1031] spilledPartitions[1025] spilledFiles[1026] spillFillTimeUs[1.03ms] spillSortTime[1.03ms] spillSerializationTime[1.03ms] spillDiskWrites[1028] spillFlushTime[1.03ms] spillWriteTime[1.03ms]");
+      "spillRuns[100] spilledInputBytes[2.00KB] spilledBytes[1.00KB] spilledRows[1031] spilledPartitions[1025] spilledFiles[1026] spillFillTimeUs[1.03ms] spillSortTime[1.03ms] spillSerializationTime[1.03ms] spillDiskWrites[1028] spillFlushTime[1.03ms] spillWriteTime[1.03ms] spillReadWaitTime[1.03ms]");
 }
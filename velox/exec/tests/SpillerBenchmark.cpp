@@ -27,11 +27,19 @@ int main(int argc, char* argv[]) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
   serializer::presto::PrestoVectorSerde::registerVectorSerde();
   filesystems::registerLocalFileSystem();
-  auto test =
-      std::make_unique<facebook::velox::exec::test::JoinSpillInputTest>();
-  test->setUp();
-  test->run();
-  test->printStats();
-  test->cleanup();
+  auto runTest = [](auto test) {
+    test->setUp();
+    test->run();
+    test->printStats();
+    test->cleanup();
+  };
+  if (FLAGS_spiller_benchmark_name == "spill_throughput") {
+    runTest(
+        std::make_unique<facebook::velox::exec::test::SpillThroughputTest>());
+  } else {
+    VELOX_CHECK_EQ(FLAGS_spiller_benchmark_name, "join_spill_input");
+    runTest(
+        std::make_unique<facebook::velox::exec::test::JoinSpillInputTest>());
+  }
   return 0;
 }
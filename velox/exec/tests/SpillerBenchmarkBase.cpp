@@ -16,6 +16,10 @@
 
 #include "velox/exec/tests/SpillerBenchmarkBase.h"
 
+#include <sys/resource.h>
+
+#include <folly/String.h>
+
 DEFINE_string(
     spiller_benchmark_path,
     "",
@@ -44,6 +48,38 @@ DEFINE_uint32(
     spiller_benchmark_spill_executor_size,
     std::thread::hardware_concurrency(),
     "The spiller executor size in number of threads");
+DEFINE_string(
+    spiller_benchmark_name,
+    "join_spill_input",
+    "The benchmark to run: 'join_spill_input' or 'spill_throughput'");
+DEFINE_string(
+    spiller_benchmark_paths,
+    "",
+    "Comma separated spill directories to compare in spill_throughput, e.g. "
+    "one on a local disk and one on tmpfs. Defaults to "
+    "spiller_benchmark_path");
+DEFINE_string(
+    spiller_benchmark_types,
+    "all",
+    "Comma separated spiller types to run in spill_throughput, e.g. "
+    "ORDER_BY,HASH_JOIN_PROBE, or 'all'");
+DEFINE_string(
+    spiller_benchmark_key_widths,
+    "1,4",
+    "Comma separated numbers of bigint keys to run in spill_throughput");
+DEFINE_string(
+    spiller_benchmark_row_widths,
+    "16,256",
+    "Comma separated sizes of the varchar payload to run in spill_throughput");
+DEFINE_string(
+    spiller_benchmark_compression_kinds,
+    "none,lz4,zstd",
+    "Comma separated spill compression kinds to run in spill_throughput");
+DEFINE_string(
+    spiller_benchmark_formats,
+    "presto",
+    "Comma separated spill formats to run in spill_throughput: 'presto' "
+    "and/or 'compact_row'");
 
 using namespace facebook::velox;
 using namespace facebook::velox::common;
@@ -53,7 +89,39 @@ using namespace facebook::velox::exec;
 namespace facebook::velox::exec::test {
 namespace {
 static const int kNumSampleVectors = 100;
+
+std::vector<std::string> splitList(const std::string& list) {
+  std::vector<std::string> items;
+  folly::split(',', list, items, true);
+  return items;
+}
+
+// Returns the user and system CPU time of the process, which includes the
+// spill executor threads.
+uint64_t processCpuMicros() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  auto micros = [](struct timeval tv) {
+    return tv.tv_sec * 1'000'000 + tv.tv_usec;
+  };
+  return micros(usage.ru_utime) + micros(usage.ru_stime);
+}
+
+// Adds the wall and CPU time of 'func' to 'wallUs' and 'cpuUs'.
+template <typename F>
+void measure(F&& func, uint64_t& wallUs, uint64_t& cpuUs) {
+  const auto cpuStartUs = processCpuMicros();
+  {
+    MicrosecondTimer timer(&wallUs);
+    func();
+  }
+  cpuUs += processCpuMicros() - cpuStartUs;
+}
+
+double megabytesPerSecond(uint64_t bytes, uint64_t micros) {
+  return micros == 0 ? 0 : bytes / (double)micros;
 }
+} // namespace
 
 void JoinSpillInputTest::setUp() {
   rootPool_ = defaultMemoryManager().addRootPool("JoinSpillInputTest");
@@ -134,4 +202,322 @@ void JoinSpillInputTest::cleanup() {
   LOG(INFO) << "Remove spill dir: " << spillDir_;
   fs_->rmdir(spillDir_);
 }
+
+void SpillThroughputTest::setUp() {
+  rootPool_ = defaultMemoryManager().addRootPool("SpillThroughputTest");
+  pool_ = rootPool_->addLeafChild("SpillThroughputTest");
+
+  if (FLAGS_spiller_benchmark_spill_executor_size != 0) {
+    executor_ = std::make_unique<folly::IOThreadPoolExecutor>(
+        FLAGS_spiller_benchmark_spill_executor_size,
+        std::make_shared<folly::NamedThreadFactory>("Spiller"));
+  }
+
+  spillDirs_ = splitList(FLAGS_spiller_benchmark_paths);
+  if (spillDirs_.empty() && !FLAGS_spiller_benchmark_path.empty()) {
+    spillDirs_.push_back(FLAGS_spiller_benchmark_path);
+  }
+  if (spillDirs_.empty()) {
+    tempDirs_.push_back(exec::test::TempDirectoryPath::create());
+    spillDirs_.push_back(tempDirs_.back()->path);
+  }
+  for (const auto& dir : spillDirs_) {
+    filesystems::getFileSystem(dir, {})->mkdir(dir);
+  }
+
+  for (const auto& name : splitList(FLAGS_spiller_benchmark_types)) {
+    for (auto i = 0; i < Spiller::kNumTypes; ++i) {
+      const auto type = static_cast<Spiller::Type>(i);
+      if (name == "all" || name == Spiller::typeName(type)) {
+        types_.push_back(type);
+      }
+    }
+  }
+  VELOX_CHECK(
+      !types_.empty(),
+      "No spiller type in {}",
+      FLAGS_spiller_benchmark_types);
+  for (const auto& width : splitList(FLAGS_spiller_benchmark_key_widths)) {
+    keyWidths_.push_back(folly::to<int32_t>(width));
+  }
+  for (const auto& width : splitList(FLAGS_spiller_benchmark_row_widths)) {
+    rowWidths_.push_back(folly::to<int32_t>(width));
+  }
+  for (const auto& kind :
+       splitList(FLAGS_spiller_benchmark_compression_kinds)) {
+    compressionKinds_.push_back(stringToCompressionKind(kind));
+  }
+  for (const auto& format : splitList(FLAGS_spiller_benchmark_formats)) {
+    formats_.push_back(stringToSpillFormat(format));
+  }
+}
+
+void SpillThroughputTest::run() {
+  for (const auto& dir : spillDirs_) {
+    for (auto type : types_) {
+      for (auto keyWidth : keyWidths_) {
+        for (auto rowWidth : rowWidths_) {
+          for (auto compressionKind : compressionKinds_) {
+            for (auto format : formats_) {
+              runCase(type, keyWidth, rowWidth, compressionKind, format, dir);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// static
+RowTypePtr SpillThroughputTest::makeRowType(int32_t keyWidth) {
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (auto i = 0; i < keyWidth; ++i) {
+    names.push_back(fmt::format("k{}", i));
+    types.push_back(BIGINT());
+  }
+  names.push_back("p0");
+  types.push_back(VARCHAR());
+  names.push_back("p1");
+  types.push_back(DOUBLE());
+  return ROW(std::move(names), std::move(types));
+}
+
+void SpillThroughputTest::runCase(
+    Spiller::Type type,
+    int32_t keyWidth,
+    int32_t rowWidth,
+    CompressionKind compressionKind,
+    SpillFormat format,
+    const std::string& path) {
+  Result result;
+  result.name = fmt::format(
+      "{} keys={} row={} {} {} {}",
+      Spiller::typeName(type),
+      keyWidth,
+      rowWidth,
+      compressionKindToString(compressionKind),
+      spillFormatName(format),
+      path);
+
+  const auto rowType = makeRowType(keyWidth);
+  std::vector<RowVectorPtr> vectors;
+  {
+    VectorFuzzer::Options options;
+    options.vectorSize = FLAGS_spiller_benchmark_spill_vector_size;
+    options.stringLength = rowWidth;
+    options.stringVariableLength = false;
+    VectorFuzzer fuzzer(options, pool_.get());
+    const auto numSamples = std::min<uint32_t>(
+        kNumSampleVectors, FLAGS_spiller_benchmark_num_spill_vectors);
+    for (auto i = 0; i < numSamples; ++i) {
+      vectors.push_back(fuzzer.fuzzRow(rowType));
+    }
+  }
+
+  const auto spillPath = fmt::format("{}/SpillThroughputTest", path);
+  const auto targetFileSize = FLAGS_spiller_benchmark_max_spill_file_size;
+  const auto minSpillRunSize = FLAGS_spiller_benchmark_min_spill_run_size;
+  const std::vector<TypePtr> keyTypes(keyWidth, BIGINT());
+  RowContainer container(keyTypes, {VARCHAR(), DOUBLE()}, pool_.get());
+  auto eraser = [&](folly::Range<char**> rows) { container.eraseRows(rows); };
+  std::unique_ptr<Spiller> spiller;
+  switch (type) {
+    case Spiller::Type::kOrderBy:
+      spiller = std::make_unique<Spiller>(
+          type,
+          &container,
+          eraser,
+          rowType,
+          keyWidth,
+          std::vector<CompareFlags>{},
+          spillPath,
+          targetFileSize,
+          minSpillRunSize,
+          compressionKind,
+          Spiller::pool(),
+          executor_.get(),
+          format);
+      break;
+    case Spiller::Type::kHashJoinProbe:
+      spiller = std::make_unique<Spiller>(
+          type,
+          rowType,
+          HashBitRange{29, 29},
+          spillPath,
+          targetFileSize,
+          minSpillRunSize,
+          compressionKind,
+          Spiller::pool(),
+          executor_.get(),
+          format);
+      break;
+    default:
+      spiller = std::make_unique<Spiller>(
+          type,
+          &container,
+          eraser,
+          rowType,
+          HashBitRange{29, 29},
+          type == Spiller::Type::kAggregate ? keyWidth : 0,
+          std::vector<CompareFlags>{},
+          spillPath,
+          targetFileSize,
+          minSpillRunSize,
+          compressionKind,
+          Spiller::pool(),
+          executor_.get(),
+          format);
+      break;
+  }
+
+  if (type == Spiller::Type::kHashJoinProbe) {
+    spiller->setPartitionsSpilled({0});
+    writeVectors(*spiller, vectors, result);
+  } else {
+    writeRows(type, *spiller, container, vectors, result);
+  }
+  result.spilledBytes = spiller->stats().spilledBytes;
+  read(type, *spiller, result);
+  results_.push_back(std::move(result));
+
+  spiller.reset();
+  filesystems::getFileSystem(path, {})->rmdir(spillPath);
+}
+
+void SpillThroughputTest::writeVectors(
+    Spiller& spiller,
+    const std::vector<RowVectorPtr>& vectors,
+    Result& result) {
+  for (auto i = 0; i < FLAGS_spiller_benchmark_num_spill_vectors; ++i) {
+    const auto& vector = vectors[i % vectors.size()];
+    measure(
+        [&]() { spiller.spill(0, vector); },
+        result.writeWallUs,
+        result.writeCpuUs);
+    result.numRows += vector->size();
+    result.inputBytes += vector->estimateFlatSize();
+  }
+}
+
+void SpillThroughputTest::writeRows(
+    Spiller::Type type,
+    Spiller& spiller,
+    RowContainer& container,
+    const std::vector<RowVectorPtr>& vectors,
+    Result& result) {
+  // Spills in rounds of up to all the sample vectors to bound the memory
+  // held in 'container'. The sorted spillers write one sorted run per round.
+  // Hash join build appends the vectors after the first round directly to
+  // the spilled partition as the hash build operator does.
+  const bool joinBuild = type == Spiller::Type::kHashJoinBuild;
+  const auto numVectors = FLAGS_spiller_benchmark_num_spill_vectors;
+  uint32_t numSpilled = 0;
+  while (numSpilled < numVectors && !(joinBuild && numSpilled > 0)) {
+    const auto numRoundVectors =
+        std::min<uint32_t>(vectors.size(), numVectors - numSpilled);
+    for (auto i = 0; i < numRoundVectors; ++i) {
+      const auto& vector = vectors[i];
+      const SelectivityVector allRows(vector->size());
+      std::vector<char*> rows(vector->size());
+      for (auto row = 0; row < vector->size(); ++row) {
+        rows[row] = container.newRow();
+      }
+      for (auto column = 0; column < vector->childrenSize(); ++column) {
+        DecodedVector decoded(*vector->childAt(column), allRows);
+        for (auto row = 0; row < vector->size(); ++row) {
+          container.store(decoded, row, rows[row], column);
+        }
+      }
+      result.numRows += vector->size();
+      result.inputBytes += vector->estimateFlatSize();
+    }
+    measure(
+        [&]() {
+          if (joinBuild) {
+            std::vector<Spiller::SpillableStats> statsList;
+            spiller.fillSpillRuns(statsList);
+            spiller.spill();
+          } else {
+            spiller.spill(0, 0);
+          }
+        },
+        result.writeWallUs,
+        result.writeCpuUs);
+    numSpilled += numRoundVectors;
+  }
+  for (; numSpilled < numVectors; ++numSpilled) {
+    const auto& vector = vectors[numSpilled % vectors.size()];
+    measure(
+        [&]() { spiller.spill(0, vector); },
+        result.writeWallUs,
+        result.writeCpuUs);
+    result.numRows += vector->size();
+    result.inputBytes += vector->estimateFlatSize();
+  }
+}
+
+void SpillThroughputTest::read(
+    Spiller::Type type,
+    Spiller& spiller,
+    Result& result) {
+  uint64_t numRows = 0;
+  if (type == Spiller::Type::kOrderBy || type == Spiller::Type::kAggregate) {
+    measure(
+        [&]() {
+          VELOX_CHECK(spiller.finishSpill().empty());
+          auto merge = spiller.startMerge(0);
+          while (auto* stream = merge->next()) {
+            stream->pop();
+            ++numRows;
+          }
+        },
+        result.readWallUs,
+        result.readCpuUs);
+  } else {
+    measure(
+        [&]() {
+          SpillPartitionSet partitionSet;
+          spiller.finishSpill(partitionSet);
+          for (auto& [id, partition] : partitionSet) {
+            auto reader = partition->createReader();
+            RowVectorPtr batch;
+            while (reader->nextBatch(batch)) {
+              numRows += batch->size();
+            }
+          }
+        },
+        result.readWallUs,
+        result.readCpuUs);
+  }
+  VELOX_CHECK_EQ(numRows, result.numRows);
+}
+
+void SpillThroughputTest::printStats() {
+  std::cout << std::left << std::setw(64) << "case" << std::right
+            << std::setw(12) << "rows" << std::setw(12) << "input"
+            << std::setw(12) << "spilled" << std::setw(12) << "write MB/s"
+            << std::setw(12) << "write cpu" << std::setw(12) << "read MB/s"
+            << std::setw(12) << "read cpu" << std::endl;
+  for (const auto& result : results_) {
+    std::cout << std::left << std::setw(64) << result.name << std::right
+              << std::setw(12) << result.numRows << std::setw(12)
+              << succinctBytes(result.inputBytes) << std::setw(12)
+              << succinctBytes(result.spilledBytes) << std::setw(12)
+              << std::fixed << std::setprecision(1)
+              << megabytesPerSecond(result.inputBytes, result.writeWallUs)
+              << std::setw(12) << succinctMicros(result.writeCpuUs)
+              << std::setw(12)
+              << megabytesPerSecond(result.inputBytes, result.readWallUs)
+              << std::setw(12) << succinctMicros(result.readCpuUs)
+              << std::endl;
+  }
+}
+
+void SpillThroughputTest::cleanup() {
+  for (const auto& dir : spillDirs_) {
+    LOG(INFO) << "Remove spill dir: " << dir;
+    filesystems::getFileSystem(dir, {})->rmdir(dir);
+  }
+}
 } // namespace facebook::velox::exec::test
@@ -19,6 +19,7 @@
 #include <deque>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 
 #include <folly/executors/IOThreadPoolExecutor.h>
@@ -35,10 +36,17 @@
 DECLARE_string(spiller_benchmark_path);
 DECLARE_uint64(spiller_benchmark_max_spill_file_size);
 DECLARE_uint64(spiller_benchmark_min_spill_run_size);
-DECLARE_uint32(spiller_benchmark_num_input_vectors);
-DECLARE_uint32(spiller_benchmark_input_vector_size);
+DECLARE_uint32(spiller_benchmark_num_spill_vectors);
+DECLARE_uint32(spiller_benchmark_spill_vector_size);
 DECLARE_string(spiller_benchmark_compression_kind);
 DECLARE_uint32(spiller_benchmark_spill_executor_size);
+DECLARE_string(spiller_benchmark_name);
+DECLARE_string(spiller_benchmark_paths);
+DECLARE_string(spiller_benchmark_types);
+DECLARE_string(spiller_benchmark_key_widths);
+DECLARE_string(spiller_benchmark_row_widths);
+DECLARE_string(spiller_benchmark_compression_kinds);
+DECLARE_string(spiller_benchmark_formats);
 
 using namespace facebook::velox;
 using namespace facebook::velox::common;
@@ -79,4 +87,85 @@ class JoinSpillInputTest {
   // Stats.
   uint64_t executionTimeUs_{0};
 };
+
+// This test measures the spill write and read throughput of each spiller type
+// over the combinations of key width, row width, compression kind, spill
+// format and spill directory. The directories can be on different devices,
+// e.g. a local disk and a tmpfs mount, to tell the device cost apart from the
+// serialization and compression cost.
+class SpillThroughputTest {
+ public:
+  SpillThroughputTest() = default;
+
+  /// Sets up the test.
+  void setUp();
+
+  /// Runs the test over all the combinations.
+  void run();
+
+  /// Prints out the measured test stats, one line per combination.
+  void printStats();
+
+  /// Cleans up the test.
+  void cleanup();
+
+ private:
+  // The measurements of one combination.
+  struct Result {
+    std::string name;
+    uint64_t numRows{0};
+    // The flat size of the spilled vectors.
+    uint64_t inputBytes{0};
+    // The size of the spill files.
+    uint64_t spilledBytes{0};
+    uint64_t writeWallUs{0};
+    uint64_t writeCpuUs{0};
+    uint64_t readWallUs{0};
+    uint64_t readCpuUs{0};
+  };
+
+  // Returns 'keyWidth' bigint keys followed by a varchar and a double.
+  static RowTypePtr makeRowType(int32_t keyWidth);
+
+  // Spills the sample vectors with a spiller of 'type', reads them back and
+  // records the measurements in 'results_'.
+  void runCase(
+      Spiller::Type type,
+      int32_t keyWidth,
+      int32_t rowWidth,
+      CompressionKind compressionKind,
+      SpillFormat format,
+      const std::string& path);
+
+  // Spills 'vectors' by appending them to the spill file as hash join probe
+  // does.
+  void writeVectors(
+      Spiller& spiller,
+      const std::vector<RowVectorPtr>& vectors,
+      Result& result);
+
+  // Stores 'vectors' in 'container' and spills all of its rows.
+  void writeRows(
+      Spiller::Type type,
+      Spiller& spiller,
+      RowContainer& container,
+      const std::vector<RowVectorPtr>& vectors,
+      Result& result);
+
+  // Reads back all the spilled rows. Sorted spills are read with a merge of
+  // the spill files, others with an unordered read of each partition.
+  void read(Spiller::Type type, Spiller& spiller, Result& result);
+
+  std::shared_ptr<MemoryPool> rootPool_;
+  std::shared_ptr<MemoryPool> pool_;
+  std::unique_ptr<folly::IOThreadPoolExecutor> executor_;
+  std::vector<std::shared_ptr<exec::test::TempDirectoryPath>> tempDirs_;
+  std::vector<std::string> spillDirs_;
+  std::vector<Spiller::Type> types_;
+  std::vector<int32_t> keyWidths_;
+  std::vector<int32_t> rowWidths_;
+  std::vector<CompressionKind> compressionKinds_;
+  std::vector<SpillFormat> formats_;
+  std::vector<Result> results_;
+};
 } // namespace facebook::velox::exec::test
@@ -1488,6 +1488,38 @@ TEST(SpillerTest, stats) {
   EXPECT_EQ(3 * stats.spilledFiles, sumStats.spilledFiles);
 }
 
+TEST(SpillerTest, spillBefore) {
+  // A large partition that is still being inserted into and a smaller one
+  // which has not been inserted into since the previous spill.
+  Spiller::SpillableStats hot{1'000, 100'000, 500};
+  Spiller::SpillableStats cold{100, 10'000, 0};
+  Spiller::SpillableStats empty;
+  ASSERT_TRUE(Spiller::spillBefore(hot, cold, false));
+  ASSERT_FALSE(Spiller::spillBefore(cold, hot, false));
+  ASSERT_TRUE(Spiller::spillBefore(cold, hot, true));
+  ASSERT_FALSE(Spiller::spillBefore(hot, cold, true));
+
+  // Partitions with the same fraction of new rows go by size.
+  Spiller::SpillableStats smallHot{100, 10'000, 50};
+  ASSERT_TRUE(Spiller::spillBefore(hot, smallHot, true));
+  ASSERT_FALSE(Spiller::spillBefore(smallHot, hot, true));
+
+  // Empty partitions go last.
+  for (const bool coldFirst : {false, true}) {
+    ASSERT_TRUE(Spiller::spillBefore(hot, empty, coldFirst));
+    ASSERT_TRUE(Spiller::spillBefore(cold, empty, coldFirst));
+    ASSERT_FALSE(Spiller::spillBefore(empty, hot, coldFirst));
+    ASSERT_FALSE(Spiller::spillBefore(empty, cold, coldFirst));
+  }
+
+  Spiller::SpillableStats sum;
+  sum += hot;
+  sum += cold;
+  ASSERT_EQ(1'100, sum.numRows);
+  ASSERT_EQ(110'000, sum.numBytes);
+  ASSERT_EQ(500, sum.numNewRows);
+}
+
 TEST(SpillerTest, spillLevel) {
   const uint8_t kInitialBitOffset = 16;
   const uint8_t kNumPartitionsBits = 3;
@@ -1533,6 +1565,64 @@ TEST(SpillerTest, spillLevel) {
   }
 }
 
+TEST(SpillerTest, adaptiveSpillLevel) {
+  const uint8_t kInitialBitOffset = 16;
+  const uint8_t kNumPartitionsBits = 2;
+  const Spiller::Config config(
+      "fakeSpillPath",
+      0,
+      0,
+      nullptr,
+      0,
+      kInitialBitOffset,
+      kNumPartitionsBits,
+      0,
+      2,
+      0,
+      "none",
+      true);
+  struct {
+    uint8_t bitOffset;
+    // Indicates an invalid if 'expectedLevel' is negative.
+    int32_t expectedLevel;
+    uint8_t expectedBits;
+    bool expectedExceeds;
+
+    std::string debugString() const {
+      return fmt::format(
+          "bitOffset:{}, expectedLevel:{}, expectedBits:{}, expectedExceeds:{}",
+          bitOffset,
+          expectedLevel,
+          expectedBits,
+          expectedExceeds);
+    }
+  } testSettings[] = {
+      {kInitialBitOffset - 1, -1, 0, true},
+      {kInitialBitOffset, 0, 2, false},
+      {kInitialBitOffset + 1, -1, 0, true},
+      {kInitialBitOffset + 2, 1, 3, false},
+      {kInitialBitOffset + 4, -1, 0, true},
+      {kInitialBitOffset + 5, 2, 4, false},
+      {kInitialBitOffset + 9, 3, 5, true},
+      {kInitialBitOffset + 14, 4, 6, true},
+      {kInitialBitOffset + 20, 5, 6, true},
+      {kInitialBitOffset + 26, 6, 6, true}};
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.debugString());
+    ASSERT_EQ(
+        config.exceedJoinSpillLevelLimit(testData.bitOffset),
+        testData.expectedExceeds);
+    if (testData.expectedLevel == -1) {
+      ASSERT_ANY_THROW(config.joinSpillLevel(testData.bitOffset));
+      continue;
+    }
+    ASSERT_EQ(
+        config.joinSpillLevel(testData.bitOffset), testData.expectedLevel);
+    ASSERT_EQ(
+        config.joinPartitionBitsAt(testData.bitOffset), testData.expectedBits);
+  }
+}
+
 TEST(SpillerTest, spillLevelLimit) {
   struct {
     uint8_t startBitOffset;
@@ -262,6 +262,46 @@ TEST_F(StreamingAggregationTest, uniqueKeys) {
   testAggregation(keys, 100);
 }
 
+TEST_F(StreamingAggregationTest, longRuns) {
+  // Groups of 100 rows are long enough to add input one run at a time. Every
+  // 7th group has a null key.
+  auto size = 1'024;
+  auto keyAt = [](auto row) { return row / 100; };
+  auto isNullAt = [](auto row) { return row / 100 % 7 == 3; };
+
+  std::vector<VectorPtr> keys = {
+      makeFlatVector<int32_t>(size, keyAt, isNullAt),
+      makeFlatVector<int32_t>(
+          size, [&](auto row) { return keyAt(size + row); }, isNullAt),
+      makeFlatVector<int32_t>(
+          size, [&](auto row) { return keyAt(2 * size + row); }),
+  };
+
+  testAggregation(keys);
+  testAggregation(keys, 3);
+
+  // A dictionary encoded string key and a bigint key.
+  std::vector<RowVectorPtr> multiKeys;
+  for (auto i = 0; i < 3; ++i) {
+    auto indices = makeIndices(size, [](auto row) { return row / 50; });
+    multiKeys.push_back(makeRowVector({
+        wrapInDictionary(
+            indices,
+            size,
+            makeFlatVector<StringView>(
+                size,
+                [&](auto row) {
+                  return StringView::makeInline(
+                      fmt::format("{}", (i * size + row * 50) / 100));
+                })),
+        makeFlatVector<int64_t>(
+            size, [&](auto row) { return keyAt(i * size + row) / 2; }),
+    }));
+  }
+
+  testMultiKeyAggregation(multiKeys);
+}
+
 TEST_F(StreamingAggregationTest, partialStreaming) {
   auto size = 1'024;
 
@@ -299,3 +339,49 @@ TEST_F(StreamingAggregationTest, partialStreaming) {
 
   testMultiKeyAggregation(keys, {"c0"});
 }
+
+TEST_F(StreamingAggregationTest, distinctAggregations) {
+  // Groups of 7 rows span batches. Each group has 3 distinct values in c1 and
+  // c2.
+  std::vector<RowVectorPtr> data;
+  vector_size_t totalSize = 0;
+  for (auto i = 0; i < 5; ++i) {
+    const vector_size_t size = 100;
+    data.push_back(makeRowVector({
+        makeFlatVector<int32_t>(
+            size, [totalSize](auto row) { return (totalSize + row) / 7; }),
+        makeFlatVector<int64_t>(
+            size, [totalSize](auto row) { return (totalSize + row) % 3; }),
+        makeFlatVector<StringView>(
+            size,
+            [totalSize](auto row) {
+              return StringView(
+                  fmt::format("string value {}", (totalSize + row) % 3));
+            }),
+    }));
+    totalSize += size;
+  }
+  createDuckDbTable(data);
+
+  for (const auto outputBatchSize : {"1024", "3"}) {
+    SCOPED_TRACE(outputBatchSize);
+    auto plan = PlanBuilder()
+                    .values(data)
+                    .streamingAggregation(
+                        {"c0"},
+                        {"count(distinct c1)",
+                         "sum(distinct c1)",
+                         "count(distinct c2)",
+                         "count(c1)"},
+                        {},
+                        core::AggregationNode::Step::kSingle,
+                        false)
+                    .planNode();
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(
+            core::QueryConfig::kPreferredOutputBatchRows, outputBatchSize)
+        .assertResults(
+            "SELECT c0, count(distinct c1), sum(distinct c1), "
+            "count(distinct c2), count(c1) FROM tmp GROUP BY 1");
+  }
+}
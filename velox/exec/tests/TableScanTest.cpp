@@ -17,8 +17,10 @@
 #include "velox/common/base/Fs.h"
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/testutil/TestValue.h"
+#include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
+#include "velox/dwio/common/DecodedVectorCache.h"
 #include "velox/dwio/common/tests/utils/DataFiles.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/PlanNodeStats.h"
@@ -221,6 +223,111 @@ TEST_F(TableScanTest, allColumns) {
   EXPECT_LT(0, exec::TableScan::ioWaitNanos());
 }
 
+TEST_F(TableScanTest, decodedVectorCache) {
+  auto vectors = makeVectors(5, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  dwio::common::DecodedVectorCache cache(64 << 20, 32 << 20);
+  dwio::common::DecodedVectorCache::setInstance(&cache);
+  SCOPE_EXIT {
+    dwio::common::DecodedVectorCache::setInstance(nullptr);
+  };
+
+  auto plan = tableScanNode();
+  auto task = assertQuery(plan, {filePath}, "SELECT * FROM tmp");
+  ASSERT_EQ(getTableScanRuntimeStats(task).count("numDecodedCacheHits"), 0);
+  ASSERT_EQ(cache.stats().numEntries, 1);
+
+  // The repeat scan is served from the cache.
+  task = assertQuery(plan, {filePath}, "SELECT * FROM tmp");
+  ASSERT_EQ(getTableScanRuntimeStats(task)["numDecodedCacheHits"].sum, 1);
+
+  // A scan with a different filter does not use the entry of the first scan.
+  auto filterPlan = PlanBuilder(pool_.get())
+                        .tableScan(rowType_, {"c1 <= 0"}, "")
+                        .planNode();
+  task = assertQuery(filterPlan, {filePath}, "SELECT * FROM tmp WHERE c1 <= 0");
+  ASSERT_EQ(getTableScanRuntimeStats(task).count("numDecodedCacheHits"), 0);
+  task = assertQuery(filterPlan, {filePath}, "SELECT * FROM tmp WHERE c1 <= 0");
+  ASSERT_EQ(getTableScanRuntimeStats(task)["numDecodedCacheHits"].sum, 1);
+  ASSERT_EQ(cache.stats().numEntries, 2);
+
+  // A remaining filter is applied to the cached batches.
+  auto remainingPlan = PlanBuilder(pool_.get())
+                           .tableScan(rowType_, {}, "c0 % 3 = 0")
+                           .planNode();
+  assertQuery(remainingPlan, {filePath}, "SELECT * FROM tmp WHERE c0 % 3 = 0");
+  task = assertQuery(
+      remainingPlan, {filePath}, "SELECT * FROM tmp WHERE c0 % 3 = 0");
+  ASSERT_EQ(getTableScanRuntimeStats(task)["numDecodedCacheHits"].sum, 1);
+
+  // The arbitrator can take the memory back.
+  ASSERT_GT(cache.shrink(0), 0);
+  ASSERT_EQ(cache.stats().numEntries, 0);
+  task.reset();
+}
+
+TEST_F(TableScanTest, sharedScan) {
+  auto vectors = makeVectors(5, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  dwio::common::DecodedVectorCache cache(64 << 20, 32 << 20);
+  dwio::common::DecodedVectorCache::setInstance(&cache);
+  SCOPE_EXIT {
+    dwio::common::DecodedVectorCache::setInstance(nullptr);
+  };
+
+  auto assertSharedScan = [&](const core::PlanNodePtr& plan,
+                              const std::string& duckDbSql) {
+    return AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .connectorConfig(
+            kHiveConnectorId, HiveConfig::kSharedScanEnabled, "true")
+        .split(makeHiveSplit(filePath->path))
+        .assertResults(duckDbSql);
+  };
+
+  // The first scan reads the split without its filter and leaves the batches
+  // in the cache when done.
+  auto plan = PlanBuilder(pool_.get())
+                  .tableScan(
+                      ROW({"c0", "c1"}, {BIGINT(), INTEGER()}), {"c1 <= 0"}, "")
+                  .planNode();
+  auto task = assertSharedScan(plan, "SELECT c0, c1 FROM tmp WHERE c1 <= 0");
+  ASSERT_EQ(getTableScanRuntimeStats(task).count("numSharedScanSplits"), 0);
+  ASSERT_EQ(cache.stats().numEntries, 1);
+
+  // Scans of the same columns use these batches with their own filters.
+  plan = PlanBuilder(pool_.get())
+             .tableScan(
+                 ROW({"c1", "c0"}, {INTEGER(), BIGINT()}), {"c0 > 100"}, "")
+             .planNode();
+  task = assertSharedScan(plan, "SELECT c1, c0 FROM tmp WHERE c0 > 100");
+  ASSERT_EQ(getTableScanRuntimeStats(task)["numSharedScanSplits"].sum, 1);
+
+  plan = PlanBuilder(pool_.get())
+             .tableScan(
+                 ROW({"c0", "c1"}, {BIGINT(), INTEGER()}),
+                 {"c1 is not null"},
+                 "c0 % 3 = 0")
+             .planNode();
+  task = assertSharedScan(
+      plan, "SELECT c0, c1 FROM tmp WHERE c1 IS NOT NULL AND c0 % 3 = 0");
+  ASSERT_EQ(getTableScanRuntimeStats(task)["numSharedScanSplits"].sum, 1);
+
+  // A scan of other columns reads the split by itself.
+  plan = PlanBuilder(pool_.get())
+             .tableScan(ROW({"c0"}, {BIGINT()}), {"c0 > 100"}, "")
+             .planNode();
+  task = assertSharedScan(plan, "SELECT c0 FROM tmp WHERE c0 > 100");
+  ASSERT_EQ(getTableScanRuntimeStats(task).count("numSharedScanSplits"), 0);
+  ASSERT_EQ(cache.stats().numEntries, 2);
+  task.reset();
+}
+
 TEST_F(TableScanTest, connectorStats) {
   auto hiveConnector =
       std::dynamic_pointer_cast<connector::hive::HiveConnector>(
@@ -946,6 +1053,215 @@ TEST_F(TableScanTest, multipleSplits) {
   }
 }
 
+TEST_F(TableScanTest, splitMetadataPrefetch) {
+  auto filePaths = makeFilePaths(50);
+  auto vectors = makeVectors(50, 100);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .plan(tableScanNode())
+                  .splits(makeHiveConnectorSplits(filePaths))
+                  .config(core::QueryConfig::kSplitPreloadPerDriver, "0")
+                  .config(
+                      core::QueryConfig::kSplitMetadataPrefetchPerDriver, "8")
+                  .assertResults("SELECT * FROM tmp");
+  auto stats = getTableScanRuntimeStats(task);
+  ASSERT_GT(stats.at("metadataPrefetchedSplits").sum, 0);
+  ASSERT_EQ(stats.count("preloadedSplits"), 0);
+
+  // Disabled by default.
+  task = assertQuery(tableScanNode(), filePaths, "SELECT * FROM tmp");
+  stats = getTableScanRuntimeStats(task);
+  ASSERT_EQ(stats.count("metadataPrefetchedSplits"), 0);
+}
+
+TEST_F(TableScanTest, initialDrivers) {
+  auto filePaths = makeFilePaths(20);
+  auto vectors = makeVectors(20, 100);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  // The drivers beyond the first one start as splits queue up or at no more
+  // splits.
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .plan(tableScanNode())
+                  .splits(makeHiveConnectorSplits(filePaths))
+                  .maxDrivers(4)
+                  .config(core::QueryConfig::kTableScanInitialDrivers, "1")
+                  .assertResults("SELECT * FROM tmp");
+  ASSERT_EQ(getTableScanStats(task).numSplits, 20);
+  ASSERT_EQ(task->numTotalDrivers(), 4);
+}
+
+TEST_F(TableScanTest, adaptiveOutputBatchRows) {
+  std::vector<RowVectorPtr> vectors = {makeRowVector(
+      {makeFlatVector<int64_t>(10'000, [](auto row) { return row; }),
+       makeFlatVector<StringView>(10'000, [](auto row) {
+         return StringView(std::string(500, 'a' + row % 26));
+       })})};
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  // The row size estimate of the file includes the wide column that is not
+  // read. The observed row size lets the scan read larger batches.
+  auto plan = PlanBuilder(pool_.get())
+                  .tableScan(ROW({"c0"}, {BIGINT()}))
+                  .project({"c0 + 1"})
+                  .planNode();
+  auto scanBatches = [&](bool adaptive) {
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .split(makeHiveConnectorSplit(filePath->path))
+                    .config(
+                        core::QueryConfig::kPreferredOutputBatchBytes,
+                        std::to_string(100 << 10))
+                    .config(
+                        core::QueryConfig::kAdaptiveOutputBatchRows,
+                        adaptive ? "true" : "false")
+                    .assertResults("SELECT c0 + 1 FROM tmp");
+    return getTableScanStats(task).outputVectors;
+  };
+  ASSERT_LT(scanBatches(true), scanBatches(false));
+}
+
+TEST_F(TableScanTest, splitPreloadConfig) {
+  auto filePaths = makeFilePaths(20);
+  auto vectors = makeVectors(20, 100);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  auto oldSplitPreload = FLAGS_split_preload_per_driver;
+  FLAGS_split_preload_per_driver = 0;
+  // The query config overrides the flag.
+  for (const auto& numPreloadSplit : {0, 4}) {
+    SCOPED_TRACE(fmt::format("numPreloadSplit {}", numPreloadSplit));
+    auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                    .plan(tableScanNode())
+                    .splits(makeHiveConnectorSplits(filePaths))
+                    .config(
+                        QueryConfig::kSplitPreloadPerDriver,
+                        folly::to<std::string>(numPreloadSplit))
+                    .assertResults("SELECT * FROM tmp");
+    auto stats = getTableScanRuntimeStats(task);
+    if (numPreloadSplit != 0) {
+      ASSERT_GT(stats.at("preloadedSplits").sum, 0);
+    } else {
+      ASSERT_EQ(stats.count("preloadedSplits"), 0);
+    }
+  }
+  FLAGS_split_preload_per_driver = oldSplitPreload;
+}
+
+TEST_F(TableScanTest, divideSplitsIntoStripeRanges) {
+  auto filePaths = makeFilePaths(2);
+  auto vectors = makeVectors(20, 1'000);
+  // Makes a stripe of about every vector.
+  auto config = std::make_shared<dwrf::Config>();
+  config->set(dwrf::Config::STRIPE_SIZE, static_cast<uint64_t>(1'024));
+  writeToFile(
+      filePaths[0]->path,
+      std::vector<RowVectorPtr>(vectors.begin(), vectors.begin() + 10),
+      config);
+  writeToFile(
+      filePaths[1]->path,
+      std::vector<RowVectorPtr>(vectors.begin() + 10, vectors.end()),
+      config);
+  createDuckDbTable(vectors);
+
+  for (const auto& maxParts : {1, 3, 100}) {
+    SCOPED_TRACE(fmt::format("maxParts {}", maxParts));
+    auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                    .plan(tableScanNode())
+                    .splits(makeHiveConnectorSplits(filePaths))
+                    .maxDrivers(4)
+                    .config(
+                        QueryConfig::kTableScanMaxSplitParts,
+                        folly::to<std::string>(maxParts))
+                    .assertResults("SELECT * FROM tmp");
+    auto numSplits = getTableScanStats(task).numSplits;
+    if (maxParts == 1) {
+      ASSERT_EQ(numSplits, 2);
+    } else {
+      ASSERT_GT(numSplits, 2);
+      ASSERT_LE(numSplits, 2 * maxParts);
+    }
+  }
+}
+
+TEST_F(TableScanTest, divideSplitsWithUnevenStripes) {
+  // One large stripe followed by many small ones. The parts are balanced by
+  // bytes, so the large stripe gets a part of its own.
+  auto filePath = TempFilePath::create();
+  std::vector<RowVectorPtr> vectors = makeVectors(1, 20'000);
+  auto smallVectors = makeVectors(9, 100);
+  vectors.insert(vectors.end(), smallVectors.begin(), smallVectors.end());
+  auto config = std::make_shared<dwrf::Config>();
+  config->set(dwrf::Config::STRIPE_SIZE, static_cast<uint64_t>(1'024));
+  writeToFile(filePath->path, vectors, config);
+  createDuckDbTable(vectors);
+
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .plan(tableScanNode())
+                  .split(makeHiveConnectorSplit(filePath->path))
+                  .maxDrivers(2)
+                  .config(QueryConfig::kTableScanMaxSplitParts, "2")
+                  .assertResults("SELECT * FROM tmp");
+  ASSERT_EQ(getTableScanStats(task).numSplits, 2);
+}
+
+TEST_F(TableScanTest, limitPushdown) {
+  auto filePaths = makeFilePaths(20);
+  auto vectors = makeVectors(20, 1'000);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+
+  // Returns the number of result rows and the task.
+  auto run = [&](const core::PlanNodePtr& plan) {
+    CursorParameters params;
+    params.planNode = plan;
+    params.maxDrivers = 4;
+    auto cursor = std::make_unique<TaskCursor>(params);
+    for (const auto& filePath : filePaths) {
+      cursor->task()->addSplit("0", makeHiveSplit(filePath->path));
+    }
+    cursor->task()->noMoreSplits("0");
+    vector_size_t numRows = 0;
+    while (cursor->moveNext()) {
+      numRows += cursor->current()->size();
+    }
+    waitForFinishedDrivers(cursor->task(), 4);
+    return std::make_pair(numRows, cursor->task());
+  };
+
+  // Each driver reads only the rows its partial limit needs, and the scans
+  // stop once the drivers together have 10 rows.
+  auto [numRows, task] =
+      run(PlanBuilder().tableScan(rowType_).limit(0, 10, true).planNode());
+  ASSERT_GE(numRows, 10);
+  ASSERT_LE(numRows, 40);
+  ASSERT_LE(getTableScanStats(task).numSplits, 4);
+  ASSERT_LE(getTableScanStats(task).rawInputRows, 40);
+
+  // With a filter in between, the scans read whole batches but still stop
+  // requesting splits.
+  std::tie(numRows, task) = run(PlanBuilder()
+                                    .tableScan(rowType_)
+                                    .filter("c0 % 2 = 0")
+                                    .limit(0, 10, true)
+                                    .planNode());
+  ASSERT_GE(numRows, 10);
+  ASSERT_LE(numRows, 40);
+  ASSERT_LT(getTableScanStats(task).numSplits, 20);
+}
+
 TEST_F(TableScanTest, waitForSplit) {
   auto filePaths = makeFilePaths(10);
   auto vectors = makeVectors(10, 1'000);
@@ -2020,6 +2336,97 @@ TEST_F(TableScanTest, stringNotEqualFilter) {
       "SELECT * FROM tmp WHERE c1 != ''");
 }
 
+TEST_F(TableScanTest, timestampFilter) {
+  constexpr vector_size_t kSize = 10'000;
+  // The seconds go from before to after the epoch, so that the sign fixup of
+  // negative timestamps with nanos is applied before comparing.
+  auto makeTimestamp = [](vector_size_t row) {
+    return Timestamp(row * 7 - 35'000, (row % 4) * 250'000'000);
+  };
+  auto isNull = [](vector_size_t row) { return row % 11 == 0; };
+  auto rowVector = makeRowVector(
+      {makeFlatVector<Timestamp>(kSize, makeTimestamp, isNull),
+       makeFlatVector<int64_t>(kSize, [](auto row) { return row; })});
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, rowVector);
+
+  auto test = [&](std::unique_ptr<common::Filter> filter,
+                  bool projectTimestamp) {
+    SCOPED_TRACE(fmt::format(
+        "{} projectTimestamp {}", filter->toString(), projectTimestamp));
+    std::vector<vector_size_t> passing;
+    for (auto row = 0; row < kSize; ++row) {
+      bool passes;
+      if (isNull(row)) {
+        passes = filter->testNull();
+      } else if (filter->kind() == common::FilterKind::kIsNull) {
+        passes = false;
+      } else if (filter->kind() == common::FilterKind::kIsNotNull) {
+        passes = true;
+      } else {
+        passes = filter->testTimestamp(makeTimestamp(row));
+      }
+      if (passes) {
+        passing.push_back(row);
+      }
+    }
+    auto indices = makeIndices(passing);
+    std::vector<std::string> names = {"c1"};
+    std::vector<VectorPtr> expected = {
+        wrapInDictionary(indices, passing.size(), rowVector->childAt(1))};
+    ColumnHandleMap assignments = {{"c1", regularColumn("c1", BIGINT())}};
+    if (projectTimestamp) {
+      names.push_back("c0");
+      expected.push_back(
+          wrapInDictionary(indices, passing.size(), rowVector->childAt(0)));
+      assignments["c0"] = regularColumn("c0", TIMESTAMP());
+    }
+    auto expectedRows = makeRowVector(names, expected);
+    auto tableHandle = makeTableHandle(
+        singleSubfieldFilter("c0", std::move(filter)),
+        nullptr,
+        "hive_table",
+        asRowType(rowVector->type()));
+    auto plan = PlanBuilder()
+                    .tableScan(
+                        asRowType(expectedRows->type()),
+                        tableHandle,
+                        assignments)
+                    .planNode();
+    auto result = AssertQueryBuilder(plan)
+                      .split(makeHiveConnectorSplit(filePath->path))
+                      .copyResults(pool());
+    assertEqualVectors(expectedRows, result);
+  };
+
+  auto range = [](const Timestamp& lower,
+                  const Timestamp& upper,
+                  bool nullAllowed) {
+    return std::make_unique<common::TimestampRange>(lower, upper, nullAllowed);
+  };
+  // Bounds with nanos on both sides of the epoch.
+  const Timestamp lower(-1'000, 500'000'000);
+  const Timestamp upper(20'000, 250'000'000);
+  for (auto projectTimestamp : {true, false}) {
+    test(range(lower, upper, false), projectTimestamp);
+    test(range(lower, upper, true), projectTimestamp);
+    // A single value.
+    test(
+        range(Timestamp(-34'300, 0), Timestamp(-34'300, 0), false),
+        projectTimestamp);
+    // Bounds on whole seconds.
+    test(
+        range(Timestamp(-20'000, 0), Timestamp(-7, Timestamp::kMaxNanos), true),
+        projectTimestamp);
+    // Only the nulls pass.
+    test(
+        range(Timestamp(50'000, 0), Timestamp(60'000, 0), true),
+        projectTimestamp);
+    test(std::make_unique<common::IsNull>(), projectTimestamp);
+    test(std::make_unique<common::IsNotNull>(), projectTimestamp);
+  }
+}
+
 TEST_F(TableScanTest, arrayIsNullFilter) {
   std::vector<RowVectorPtr> vectors(3);
   auto filePaths = makeFilePaths(vectors.size());
@@ -2157,6 +2564,127 @@ TEST_F(TableScanTest, remainingFilter) {
       "SELECT * FROM tmp WHERE not (c0 > 0 or c1 > c0)");
 }
 
+TEST_F(TableScanTest, remainingFilterInReader) {
+  auto rowType = ROW(
+      {"c0", "c1", "c2", "c3"}, {INTEGER(), INTEGER(), DOUBLE(), VARCHAR()});
+  auto filePaths = makeFilePaths(5);
+  auto vectors = makeVectors(5, 1'000, rowType);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  auto assertReaderFilter = [&](const core::PlanNodePtr& plan,
+                                const std::string& duckDbSql) {
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .connectorConfig(
+            kHiveConnectorId,
+            HiveConfig::kReaderExpressionFilterEnabled,
+            "true")
+        .splits(makeHiveConnectorSplits(filePaths))
+        .assertResults(duckDbSql);
+  };
+
+  assertReaderFilter(
+      PlanBuilder(pool_.get()).tableScan(rowType, {}, "c1 > c0").planNode(),
+      "SELECT * FROM tmp WHERE c1 > c0");
+
+  // Range filter and several conjuncts evaluated in the reader.
+  assertReaderFilter(
+      PlanBuilder(pool_.get())
+          .tableScan(
+              rowType,
+              {"c0 >= 0::INTEGER"},
+              "c1 > c0 and c2 * c0 < c1 and c1 % 3 = 1")
+          .planNode(),
+      "SELECT * FROM tmp WHERE c0 >= 0 AND c1 > c0 AND c2 * c0 < c1 "
+      "AND c1 % 3 = 1");
+
+  // The filter columns are not projected out.
+  ColumnHandleMap assignments = {{"c3", regularColumn("c3", VARCHAR())}};
+  auto tableHandle =
+      makeTableHandle(SubfieldFilters{}, parseExpr("c1 > c0", rowType));
+  assertReaderFilter(
+      PlanBuilder(pool_.get())
+          .tableScan(ROW({"c3"}, {VARCHAR()}), tableHandle, assignments)
+          .planNode(),
+      "SELECT c3 FROM tmp WHERE c1 > c0");
+
+  // A conjunct that references no column stays after the scan together with
+  // the conjuncts that follow it.
+  assertReaderFilter(
+      PlanBuilder(pool_.get())
+          .tableScan(rowType, {}, "c1 > c0 and 1 = 1 and c2 * c1 > c0")
+          .planNode(),
+      "SELECT * FROM tmp WHERE c1 > c0 AND c2 * c1 > c0");
+}
+
+TEST_F(TableScanTest, positionalDeletes) {
+  const vector_size_t size = 20'000;
+  auto data = makeRowVector(
+      {makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+       makeFlatVector<int64_t>(size, [](auto row) { return row % 11; })});
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, {data});
+  createDuckDbTable({data});
+  const auto dataPath = HiveConnectorSplitBuilder::toUri(filePath->path);
+  const std::string otherPath = "file:/other";
+
+  // Every 7th row and a dense range are deleted, in two delete files that
+  // also have rows of another data file.
+  auto makeDeletes = [&](const std::vector<int64_t>& positions) {
+    return makeRowVector(
+        {"file_path", "pos"},
+        {makeFlatVector<StringView>(
+             positions.size() + 100,
+             [&](auto row) {
+               return StringView(
+                   row < positions.size() ? dataPath : otherPath);
+             }),
+         makeFlatVector<int64_t>(positions.size() + 100, [&](auto row) {
+           return row < positions.size() ? positions[row] : row;
+         })});
+  };
+  std::vector<int64_t> sparse;
+  for (auto i = 0; i < size; i += 7) {
+    sparse.push_back(i);
+  }
+  std::vector<int64_t> dense;
+  for (auto i = 5'000; i < 12'000; ++i) {
+    dense.push_back(i);
+  }
+  auto sparseDeletes = TempFilePath::create();
+  writeToFile(sparseDeletes->path, {makeDeletes(sparse)});
+  auto denseDeletes = TempFilePath::create();
+  writeToFile(denseDeletes->path, {makeDeletes(dense)});
+
+  auto makeSplits = [&]() {
+    std::vector<std::shared_ptr<connector::ConnectorSplit>> splits;
+    splits.push_back(HiveConnectorSplitBuilder(filePath->path)
+                         .deleteFile(sparseDeletes->path)
+                         .deleteFile(denseDeletes->path)
+                         .build());
+    return splits;
+  };
+  const std::string notDeleted =
+      "c0 % 7 <> 0 AND (c0 < 5000 OR c0 >= 12000)";
+
+  auto rowType = asRowType(data->type());
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .plan(PlanBuilder().tableScan(rowType).planNode())
+                  .splits(makeSplits())
+                  .assertResults("SELECT * FROM tmp WHERE " + notDeleted);
+  ASSERT_EQ(
+      getTableScanRuntimeStats(task).at("numDeletedRows").sum,
+      size / 7 + 1 + 7'000 - 1'000);
+
+  // Deletes combined with a filter.
+  AssertQueryBuilder(duckDbQueryRunner_)
+      .plan(PlanBuilder().tableScan(rowType, {"c1 > 5"}).planNode())
+      .splits(makeSplits())
+      .assertResults("SELECT * FROM tmp WHERE c1 > 5 AND " + notDeleted);
+}
+
 TEST_F(TableScanTest, remainingFilterSkippedStrides) {
   auto rowType = ROW({{"c0", BIGINT()}, {"c1", BIGINT()}});
   std::vector<RowVectorPtr> vectors(3);
@@ -2357,6 +2885,30 @@ TEST_F(TableScanTest, aggregationPushdown) {
   EXPECT_EQ(0, loadedToValueHook(task));
 }
 
+// TopN pushes its threshold on the first sorting key into the scan once it
+// has seen 'count' rows.
+TEST_F(TableScanTest, topNThresholdPushdown) {
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  for (const auto& key : {"c0 NULLS LAST", "c1 DESC NULLS FIRST"}) {
+    SCOPED_TRACE(key);
+    auto plan = PlanBuilder()
+                    .tableScan(rowType_)
+                    .filter("c2 % 2 = 0")
+                    .topN({key}, 10, false)
+                    .planNode();
+    auto task = assertQuery(
+        plan,
+        {filePath},
+        fmt::format(
+            "SELECT * FROM tmp WHERE c2 % 2 = 0 ORDER BY {} LIMIT 10", key));
+    EXPECT_LT(0, getTableScanRuntimeStats(task)["dynamicFiltersAccepted"].sum);
+  }
+}
+
 TEST_F(TableScanTest, bitwiseAggregationPushdown) {
   auto vectors = makeVectors(10, 1'000);
   auto filePath = TempFilePath::create();
@@ -786,6 +786,31 @@ class TableWriteTest : public HiveConnectorTestBase {
     for (const auto bucketId : bucketIds) {
       ASSERT_EQ(expectedBucketId, bucketId);
     }
+
+    // Verify the rows are written in the order of the sorting columns.
+    std::vector<column_index_t> sortChannels;
+    std::vector<CompareFlags> sortCompareFlags;
+    for (const auto& sortColumn : bucketProperty_->sortedBy()) {
+      sortChannels.push_back(
+          tableSchema_->getChildIdx(sortColumn->sortColumn()));
+      sortCompareFlags.push_back(
+          {sortColumn->sortOrder().isNullsFirst(),
+           sortColumn->sortOrder().isAscending(),
+           false,
+           CompareFlags::NullHandlingMode::NoStop});
+    }
+    for (vector_size_t row = 1; row < resultVector->size(); ++row) {
+      for (auto i = 0; i < sortChannels.size(); ++i) {
+        const auto& column = resultVector->childAt(sortChannels[i]);
+        const auto result =
+            column->compare(column.get(), row - 1, row, sortCompareFlags[i]);
+        ASSERT_TRUE(result.has_value());
+        ASSERT_LE(result.value(), 0) << "Unsorted row " << row;
+        if (result.value() < 0) {
+          break;
+        }
+      }
+    }
   }
 
   // Verifies the file layout and data produced by a table writer.
@@ -2080,6 +2105,55 @@ TEST_P(BucketedTableOnlyWriteTest, mismatchedBucketTypes) {
           bucketProperty_->bucketedTypes()[0]));
 }
 
+TEST_P(BucketedTableOnlyWriteTest, sortedBuckets) {
+  SCOPED_TRACE(testParam_.toString());
+  auto input = makeVectors(4, 500);
+  createDuckDbTable(input);
+  setBucketProperty(
+      bucketProperty_->kind(),
+      bucketProperty_->bucketCount(),
+      bucketProperty_->bucketedBy(),
+      bucketProperty_->bucketedTypes(),
+      {std::make_shared<const HiveSortingColumn>(
+           "c4", core::SortOrder{true, true}),
+       std::make_shared<const HiveSortingColumn>(
+           "c2", core::SortOrder{false, false})});
+
+  for (bool enableSpill : {false, true}) {
+    SCOPED_TRACE(fmt::format("enableSpill: {}", enableSpill));
+    auto outputDirectory = TempDirectoryPath::create();
+    auto spillDirectory = TempDirectoryPath::create();
+    auto plan = createInsertPlan(
+        PlanBuilder().values(input),
+        rowType_,
+        outputDirectory->path,
+        partitionedBy_,
+        bucketProperty_,
+        compressionKind_,
+        getNumWriters(),
+        connector::hive::LocationHandle::TableType::kNew,
+        commitStrategy_);
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .maxDrivers(
+            2 * std::max(kNumTableWriterCount, kNumPartitionedTableWriterCount))
+        .config(
+            QueryConfig::kTaskPartitionedWriterCount,
+            std::to_string(numPartitionedTableWriterCount_))
+        .config(QueryConfig::kSpillEnabled, enableSpill ? "true" : "false")
+        .config(QueryConfig::kTestingSpillPct, "100")
+        .connectorConfig(
+            kHiveConnectorId, HiveConfig::kSortWriterMaxOutputRows, "100")
+        .spillDirectory(spillDirectory->path)
+        .assertResults("SELECT count(*) FROM tmp");
+
+    assertQuery(
+        PlanBuilder().tableScan(rowType_).planNode(),
+        makeHiveConnectorSplits(outputDirectory),
+        "SELECT * FROM tmp");
+    verifyTableWriterOutput(outputDirectory->path);
+  }
+}
+
 TEST_P(AllTableWriterTest, tableWriteOutputCheck) {
   SCOPED_TRACE(testParam_.toString());
   if (!testParam_.multiDrivers() ||
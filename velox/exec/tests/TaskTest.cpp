@@ -1200,4 +1200,31 @@ DEBUG_ONLY_TEST_F(TaskTest, raceBetweenTaskPauseAndTerminate) {
   taskThread.join();
 }
 
+TEST_F(TaskTest, memoryEstimate) {
+  auto data = makeRowVector({makeFlatVector<int64_t>(1'000, folly::identity)});
+  core::PlanNodeId orderById;
+  auto plan = PlanBuilder()
+                  .values({data})
+                  .orderBy({"c0 DESC"}, false)
+                  .capturePlanNodeId(orderById)
+                  .planFragment();
+  auto task = Task::create(
+      "memoryEstimate", plan, 0, std::make_shared<core::QueryCtx>());
+  ASSERT_FALSE(task->memoryEstimate(orderById).has_value());
+  constexpr uint64_t kEstimateBytes = 64 << 20;
+  task->setMemoryEstimate(orderById, kEstimateBytes);
+  ASSERT_EQ(kEstimateBytes, task->memoryEstimate(orderById).value());
+
+  while (task->next() != nullptr) {
+  }
+  ASSERT_TRUE(waitForTaskCompletion(task.get()));
+
+  // The single driver reserves the whole estimate when it starts.
+  auto planStats = toPlanStats(task->taskStats());
+  const auto& runtimeStats = planStats.at(orderById).customStats;
+  ASSERT_EQ(1, runtimeStats.at("preReservedBytes").count);
+  ASSERT_EQ(kEstimateBytes, runtimeStats.at("preReservedBytes").sum);
+  ASSERT_EQ(0, runtimeStats.count("preReserveFailedBytes"));
+}
+
 } // namespace facebook::velox::exec::test
@@ -13,9 +13,11 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox::exec::test;
 
@@ -166,5 +168,59 @@ TEST_F(TopNRowNumberTest, manyPartitions) {
   testLimit(100);
 }
 
+TEST_F(TopNRowNumberTest, spill) {
+  const vector_size_t size = 1'000;
+  std::vector<RowVectorPtr> data;
+  for (auto i = 0; i < 10; ++i) {
+    data.push_back(makeRowVector({
+        // Partitioning key.
+        makeFlatVector<int64_t>(
+            size, [](auto row) { return row % 37; }, nullEvery(13)),
+        // Sorting key.
+        makeFlatVector<int64_t>(
+            size, [&](auto row) { return (row * 7919 + i) % 10'007; }),
+        // Data.
+        makeFlatVector<std::string>(
+            size, [&](auto row) { return fmt::format("{} {}", i, row); }),
+    }));
+  }
+
+  createDuckDbTable(data);
+
+  auto testLimit = [&](const std::vector<std::string>& partitionKeys,
+                       auto limit) {
+    SCOPED_TRACE(fmt::format(
+        "numPartitionKeys {} limit {}", partitionKeys.size(), limit));
+    core::PlanNodeId topNRowNumberId;
+    auto plan = PlanBuilder()
+                    .values(data)
+                    .topNRowNumber(partitionKeys, {"c1"}, limit, true)
+                    .capturePlanNodeId(topNRowNumberId)
+                    .planNode();
+
+    auto spillDirectory = TempDirectoryPath::create();
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .spillDirectory(spillDirectory->path)
+            .config(core::QueryConfig::kSpillEnabled, "true")
+            .config(core::QueryConfig::kTopNRowNumberSpillEnabled, "true")
+            .config(core::QueryConfig::kTestingSpillPct, "100")
+            .config(core::QueryConfig::kPreferredOutputBatchRows, "17")
+            .assertResults(fmt::format(
+                "SELECT * FROM (SELECT *, row_number() over ({} order by c1) as rn FROM tmp) "
+                " WHERE rn <= {}",
+                partitionKeys.empty() ? "" : "partition by c0",
+                limit));
+    auto stats = toPlanStats(task->taskStats());
+    ASSERT_GT(stats.at(topNRowNumberId).spilledRows, 0);
+  };
+
+  testLimit({"c0"}, 1);
+  testLimit({"c0"}, 5);
+  testLimit({"c0"}, 1'000);
+  testLimit({}, 1);
+  testLimit({}, 100);
+}
+
 } // namespace
 } // namespace facebook::velox::exec
@@ -28,6 +28,7 @@ class TreeOfLosersTest : public testing::Test, public MergeTestBase {
     TestData testData = makeTestData(numValues, numStreams);
     test<TreeOfLosers<TestingStream>>(testData, true);
     test<MergeArray<TestingStream>>(testData, true);
+    testRuns(testData, true);
   }
 };
 
@@ -40,6 +41,37 @@ TEST_F(TreeOfLosersTest, merge) {
   testBoth(500, 1);
 }
 
+TEST_F(TreeOfLosersTest, nextWithRunnerUp) {
+  for (auto clusterSize : {1, 3, 100, 10'000}) {
+    for (auto numStreams : {1, 2, 7, 33}) {
+      SCOPED_TRACE(fmt::format(
+          "clusterSize: {}, numStreams: {}", clusterSize, numStreams));
+      testRuns(makeClusteredTestData(100'000, numStreams, clusterSize), true);
+    }
+  }
+
+  // Runs of duplicates across streams.
+  std::vector<std::unique_ptr<TestingStream>> mergeStreams;
+  for (auto i = 0; i < 5; ++i) {
+    mergeStreams.push_back(
+        std::make_unique<TestingStream>(std::vector<uint32_t>{3, 3, 2, 1, 1}));
+  }
+  TreeOfLosers<TestingStream> merge(std::move(mergeStreams));
+  std::vector<uint32_t> values;
+  for (;;) {
+    auto [stream, runnerUp] = merge.nextWithRunnerUp();
+    if (!stream) {
+      break;
+    }
+    do {
+      values.push_back(stream->current()->value());
+      stream->pop();
+    } while (stream->hasData() && !(runnerUp && *runnerUp < *stream));
+  }
+  ASSERT_EQ(values.size(), 25);
+  ASSERT_TRUE(std::is_sorted(values.begin(), values.end()));
+}
+
 TEST_F(TreeOfLosersTest, nextWithEquals) {
   constexpr int32_t kNumStreams = 17;
   std::vector<std::vector<uint32_t>> streams(kNumStreams);
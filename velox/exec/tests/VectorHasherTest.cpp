@@ -984,3 +984,50 @@ TEST_F(VectorHasherTest, typeMismatch) {
   VELOX_ASSERT_THROW(
       hasher->decode(*data, rows), "Type mismatch: BIGINT vs. VARCHAR");
 }
+
+TEST_F(VectorHasherTest, attachedKeyHashes) {
+  auto data = vectorMaker_->rowVector({
+      vectorMaker_->flatVector<int64_t>(100, [](auto row) { return row; }),
+      vectorMaker_->flatVector<double>(100, [](auto row) { return row / 3; }),
+      vectorMaker_->flatVector<int32_t>(100, [](auto row) { return row; }),
+  });
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  hashers.push_back(VectorHasher::create(DOUBLE(), 1));
+  hashers.push_back(VectorHasher::create(BIGINT(), 0));
+  EXPECT_EQ(attachedKeyHashes(*data, hashers), nullptr);
+
+  raw_vector<uint64_t> expected(data->size());
+  for (auto i = 0; i < hashers.size(); ++i) {
+    hashers[i]->decode(*data->childAt(hashers[i]->channel()), allRows_);
+    hashers[i]->hash(allRows_, i > 0, expected);
+  }
+  auto hashes = AlignedBuffer::allocate<uint64_t>(data->size(), pool_.get());
+  std::copy(expected.begin(), expected.end(), hashes->asMutable<uint64_t>());
+  attachKeyHashes(*data, {1, 0}, hashes);
+
+  const auto* attached = attachedKeyHashes(*data, hashers);
+  ASSERT_NE(attached, nullptr);
+  for (auto i = 0; i < data->size(); ++i) {
+    EXPECT_EQ(attached[i], expected[i]);
+  }
+
+  // Hashes over other keys or in another order are not used.
+  std::vector<std::unique_ptr<VectorHasher>> otherHashers;
+  otherHashers.push_back(VectorHasher::create(BIGINT(), 0));
+  otherHashers.push_back(VectorHasher::create(DOUBLE(), 1));
+  EXPECT_EQ(attachedKeyHashes(*data, otherHashers), nullptr);
+  otherHashers.pop_back();
+  EXPECT_EQ(attachedKeyHashes(*data, otherHashers), nullptr);
+
+  // Replacing a key drops the hashes.
+  auto key = data->childAt(0);
+  data->childAt(0) =
+      vectorMaker_->flatVector<int64_t>(100, [](auto row) { return -row; });
+  EXPECT_EQ(attachedKeyHashes(*data, hashers), nullptr);
+  data->childAt(0) = key;
+  EXPECT_NE(attachedKeyHashes(*data, hashers), nullptr);
+
+  // So does writing into the RowVector.
+  data->copy(data.get(), 0, 1, 1);
+  EXPECT_EQ(attachedKeyHashes(*data, hashers), nullptr);
+}
@@ -215,15 +215,28 @@ class HiveConnectorSplitBuilder {
     return *this;
   }
 
+  HiveConnectorSplitBuilder& deleteFile(
+      std::string path,
+      dwio::common::FileFormat format = dwio::common::FileFormat::DWRF) {
+    deleteFiles_.push_back({toUri(path), format});
+    return *this;
+  }
+
   std::shared_ptr<connector::hive::HiveConnectorSplit> build() const {
-    return std::make_shared<connector::hive::HiveConnectorSplit>(
+    auto split = std::make_shared<connector::hive::HiveConnectorSplit>(
         kHiveConnectorId,
-        filePath_.find("/") == 0 ? "file:" + filePath_ : filePath_,
+        toUri(filePath_),
         fileFormat_,
         start_,
         length_,
         partitionKeys_,
         tableBucketNumber_);
+    split->deleteFiles = deleteFiles_;
+    return split;
+  }
+
+  static std::string toUri(const std::string& path) {
+    return path.find("/") == 0 ? "file:" + path : path;
   }
 
  private:
@@ -233,6 +246,7 @@ class HiveConnectorSplitBuilder {
   uint64_t length_{std::numeric_limits<uint64_t>::max()};
   std::unordered_map<std::string, std::optional<std::string>> partitionKeys_;
   std::optional<int32_t> tableBucketNumber_;
+  std::vector<connector::hive::HiveDeleteFile> deleteFiles_;
 };
 
 } // namespace facebook::velox::exec::test
@@ -58,7 +58,7 @@ class LocalExchangeSource : public exec::ExchangeSource {
     VELOX_CHECK(requestPending_);
     auto requestedSequence = sequence_;
     auto self = shared_from_this();
-    buffers->getData(
+    buffers->getPages(
         taskId_,
         destination_,
         maxBytes,
@@ -66,7 +66,9 @@ class LocalExchangeSource : public exec::ExchangeSource {
         // Since this lambda may outlive 'this', we need to capture a
         // shared_ptr to the current object (self).
         [self, requestedSequence, buffers, this](
-            std::vector<std::unique_ptr<folly::IOBuf>> data, int64_t sequence) {
+            std::vector<std::shared_ptr<SerializedPage>> data,
+            int64_t sequence,
+            int64_t remainingBytes) {
           if (requestedSequence > sequence) {
             VLOG(2) << "Receives earlier sequence than requested: task "
                     << taskId_ << ", destination " << destination_
@@ -85,9 +87,19 @@ class LocalExchangeSource : public exec::ExchangeSource {
               // Keep looping, there could be extra end markers.
               continue;
             }
-            inputPage->unshare();
-            pages.push_back(
-                std::make_unique<SerializedPage>(std::move(inputPage)));
+            if (!inputPage->isSerialized()) {
+              // An in-process page is shared with the producer buffer
+              // until acknowledged, so the queued page keeps it alive.
+              pages.push_back(std::make_unique<SerializedPage>(
+                  inputPage->vectors(),
+                  inputPage->size(),
+                  [inputPage]() {}));
+              inputPage = nullptr;
+              continue;
+            }
+            auto iobuf = inputPage->getIOBuf();
+            iobuf->unshare();
+            pages.push_back(std::make_unique<SerializedPage>(std::move(iobuf)));
             inputPage = nullptr;
           }
           numPages_ += pages.size();
@@ -109,6 +121,7 @@ class LocalExchangeSource : public exec::ExchangeSource {
               std::lock_guard<std::mutex> l(queue_->mutex());
               requestPending_ = false;
               requestPromise = std::move(promise_);
+              producerBufferedBytes_ = atEnd ? 0 : remainingBytes;
               for (auto& page : pages) {
                 queue_->enqueueLocked(std::move(page), queuePromises);
               }
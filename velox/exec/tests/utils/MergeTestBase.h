@@ -146,6 +146,31 @@ class MergeTestBase {
     return data;
   }
 
+  // Makes 'numRuns' sorted streams of the values 0 to 'numValues' - 1. The
+  // values go to random streams in clusters of 'clusterSize' consecutive
+  // values, so that the merge takes runs of 'clusterSize' from one stream.
+  TestData makeClusteredTestData(
+      int32_t numValues,
+      int32_t numRuns,
+      int32_t clusterSize) {
+    TestData data;
+    data.data.reserve(numValues);
+    std::vector<std::vector<uint32_t>> runs(numRuns);
+    int32_t run = 0;
+    for (auto i = 0; i < numValues; ++i) {
+      if (i % clusterSize == 0) {
+        run = folly::Random::rand32(rng_) % numRuns;
+      }
+      data.data.push_back(i);
+      runs[run].push_back(i);
+    }
+    for (auto& run : runs) {
+      std::reverse(run.begin(), run.end());
+      data.sources.push_back(std::make_unique<TestingStream>(std::move(run)));
+    }
+    return data;
+  }
+
   // Reads the data in 'testData.runs' using the merging class MergeType. Checks
   // that the results match the globally sorted data in 'testData' if check is
   // true.
@@ -175,6 +200,34 @@ class MergeTestBase {
     }
   }
 
+  // Like test() but reads runs of values from the first stream while these
+  // are not greater than the first value of the runner-up stream.
+  static void testRuns(const TestData& testData, bool check) {
+    std::vector<std::unique_ptr<TestingStream>> sources;
+    for (auto& source : testData.sources) {
+      sources.push_back(std::make_unique<TestingStream>(*source));
+    }
+    TreeOfLosers<TestingStream> merge(std::move(sources));
+    size_t numValues = 0;
+    for (;;) {
+      auto [source, runnerUp] = merge.nextWithRunnerUp();
+      if (!source) {
+        break;
+      }
+      do {
+        if (check) {
+          ASSERT_LT(numValues, testData.data.size());
+          ASSERT_EQ(source->current()->value(), testData.data[numValues]);
+        }
+        ++numValues;
+        source->pop();
+      } while (source->hasData() && !(runnerUp && *runnerUp < *source));
+    }
+    if (check) {
+      ASSERT_EQ(numValues, testData.data.size());
+    }
+  }
+
  protected:
   folly::Random::DefaultGenerator rng_;
 };
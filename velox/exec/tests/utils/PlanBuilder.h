@@ -738,6 +738,11 @@ class PlanBuilder {
   ///  rows between a + 10 preceding and 10 following)"
   PlanBuilder& window(const std::vector<std::string>& windowFunctions);
 
+  /// Same as window() for an input that is already clustered by the PARTITION
+  /// BY keys and sorted by the ORDER BY keys within each partition. The
+  /// window is computed one partition at a time as the input arrives.
+  PlanBuilder& streamingWindow(const std::vector<std::string>& windowFunctions);
+
   /// Add a RowNumberNode to compute single row_number window function with an
   /// optional limit and no sorting.
   PlanBuilder& rowNumber(
@@ -843,6 +848,10 @@ class PlanBuilder {
       const RowTypePtr& inputType,
       const std::string& name);
 
+  PlanBuilder& window(
+      const std::vector<std::string>& windowFunctions,
+      bool inputsSorted);
+
   core::PlanNodePtr createIntermediateOrFinalAggregation(
       core::AggregationNode::Step step,
       const core::AggregationNode* partialAggNode);
@@ -0,0 +1,511 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/tests/utils/TcpExchangeSource.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <folly/String.h>
+#include <folly/Synchronized.h>
+
+#include "velox/common/time/Timer.h"
+#include "velox/exec/PartitionedOutputBufferManager.h"
+
+namespace facebook::velox::exec::test {
+namespace {
+
+enum class RequestKind : uint8_t { kGet, kDelete };
+
+// Fixed size part of a request. The task id follows.
+struct RequestHeader {
+  RequestKind kind;
+  int32_t destination;
+  int64_t sequence;
+  uint32_t maxBytes;
+  uint32_t taskIdSize;
+};
+
+// Fixed size part of a response. Each page follows as its size and bytes.
+struct ResponseHeader {
+  int64_t sequence;
+  int64_t remainingBytes;
+  uint32_t numPages;
+  bool atEnd;
+};
+
+folly::Synchronized<std::vector<uint64_t>>& requestMicros() {
+  static folly::Synchronized<std::vector<uint64_t>> micros;
+  return micros;
+}
+
+void writeFully(int fd, const void* data, size_t size) {
+  auto* bytes = reinterpret_cast<const char*>(data);
+  while (size > 0) {
+    const auto written = ::send(fd, bytes, size, MSG_NOSIGNAL);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    VELOX_CHECK_GT(
+        written, 0, "Exchange socket write failed: {}", folly::errnoStr(errno));
+    bytes += written;
+    size -= written;
+  }
+}
+
+// Returns false if the peer closed 'fd' before the first byte.
+bool readFully(int fd, void* data, size_t size) {
+  auto* bytes = reinterpret_cast<char*>(data);
+  const auto total = size;
+  while (size > 0) {
+    const auto numRead = ::recv(fd, bytes, size, 0);
+    if (numRead < 0 && errno == EINTR) {
+      continue;
+    }
+    if (numRead == 0 && size == total) {
+      return false;
+    }
+    VELOX_CHECK_GT(
+        numRead, 0, "Exchange socket read failed: {}", folly::errnoStr(errno));
+    bytes += numRead;
+    size -= numRead;
+  }
+  return true;
+}
+
+void setNoDelay(int fd) {
+  int one = 1;
+  ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+int connectTo(const std::string& host, uint16_t port) {
+  struct addrinfo hints {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo* addresses;
+  const auto error = ::getaddrinfo(
+      host.c_str(), std::to_string(port).c_str(), &hints, &addresses);
+  VELOX_CHECK_EQ(
+      error, 0, "Cannot resolve {}: {}", host, ::gai_strerror(error));
+  int fd = -1;
+  for (auto* address = addresses; address; address = address->ai_next) {
+    fd = ::socket(
+        address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (fd < 0) {
+      continue;
+    }
+    if (::connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+      break;
+    }
+    ::close(fd);
+    fd = -1;
+  }
+  ::freeaddrinfo(addresses);
+  VELOX_CHECK_GE(fd, 0, "Cannot connect to {}:{}", host, port);
+  setNoDelay(fd);
+  return fd;
+}
+
+class TcpExchangeSource : public exec::ExchangeSource {
+ public:
+  TcpExchangeSource(
+      const std::string& taskId,
+      int destination,
+      std::shared_ptr<exec::ExchangeQueue> queue,
+      memory::MemoryPool* pool,
+      std::string host,
+      uint16_t port,
+      std::string remoteTaskId)
+      : ExchangeSource(taskId, destination, queue, pool),
+        host_(std::move(host)),
+        port_(port),
+        remoteTaskId_(std::move(remoteTaskId)) {
+    // A request blocks until the producer has data, which may in turn wait
+    // for other sources to consume theirs, so the sources do not share a
+    // bounded pool of threads.
+    thread_ = std::thread([this]() { run(); });
+  }
+
+  ~TcpExchangeSource() override {
+    close();
+    thread_.join();
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  bool shouldRequestLocked() override {
+    if (atEnd_) {
+      return false;
+    }
+    return !requestPending_.exchange(true);
+  }
+
+  ContinueFuture request(uint32_t maxBytes) override {
+    auto [promise, future] =
+        makeVeloxContinuePromiseContract("TcpExchangeSource::request");
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      VELOX_CHECK(!promise_.valid());
+      promise_ = std::move(promise);
+      maxBytes_ = maxBytes;
+    }
+    requested_.notify_one();
+    return std::move(future);
+  }
+
+  void close() override {
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (closed_) {
+        return;
+      }
+      closed_ = true;
+      if (fd_ >= 0) {
+        // Unblocks a pending read. The server deletes the results of a
+        // closed connection.
+        ::shutdown(fd_, SHUT_RDWR);
+      }
+    }
+    requested_.notify_one();
+  }
+
+  folly::F14FastMap<std::string, int64_t> stats() const override {
+    return {
+        {"tcpExchangeSource.numPages", numPages_},
+        {"tcpExchangeSource.numRequests", numRequests_}};
+  }
+
+ private:
+  void run() {
+    for (;;) {
+      ContinuePromise promise{ContinuePromise::makeEmpty()};
+      uint32_t maxBytes;
+      {
+        std::unique_lock<std::mutex> l(mutex_);
+        requested_.wait(l, [&]() { return closed_ || promise_.valid(); });
+        if (closed_) {
+          promise = std::move(promise_);
+          if (promise.valid()) {
+            promise.setValue();
+          }
+          return;
+        }
+        promise = std::move(promise_);
+        maxBytes = maxBytes_;
+      }
+      try {
+        fetch(maxBytes);
+      } catch (const std::exception& e) {
+        bool closed;
+        {
+          std::lock_guard<std::mutex> l(mutex_);
+          closed = closed_;
+        }
+        if (!closed) {
+          queue_->setError(e.what());
+        }
+      }
+      promise.setValue();
+    }
+  }
+
+  void sendRequest(RequestKind kind, uint32_t maxBytes) {
+    RequestHeader header{
+        kind,
+        destination_,
+        sequence_,
+        maxBytes,
+        static_cast<uint32_t>(remoteTaskId_.size())};
+    writeFully(fd_, &header, sizeof(header));
+    writeFully(fd_, remoteTaskId_.data(), remoteTaskId_.size());
+  }
+
+  void fetch(uint32_t maxBytes) {
+    if (fd_ < 0) {
+      auto fd = connectTo(host_, port_);
+      std::lock_guard<std::mutex> l(mutex_);
+      fd_ = fd;
+      if (closed_) {
+        return;
+      }
+    }
+    const auto startMicros = getCurrentTimeMicro();
+    ++numRequests_;
+    sendRequest(RequestKind::kGet, maxBytes);
+    ResponseHeader header;
+    VELOX_CHECK(
+        readFully(fd_, &header, sizeof(header)),
+        "Exchange server closed the connection");
+    std::vector<std::unique_ptr<SerializedPage>> pages;
+    pages.reserve(header.numPages);
+    for (auto i = 0; i < header.numPages; ++i) {
+      uint32_t size;
+      VELOX_CHECK(readFully(fd_, &size, sizeof(size)));
+      auto iobuf = folly::IOBuf::create(size);
+      VELOX_CHECK(readFully(fd_, iobuf->writableData(), size));
+      iobuf->append(size);
+      pages.push_back(std::make_unique<SerializedPage>(std::move(iobuf)));
+    }
+    requestMicros().wlock()->push_back(getCurrentTimeMicro() - startMicros);
+    numPages_ += pages.size();
+
+    std::vector<ContinuePromise> queuePromises;
+    {
+      std::lock_guard<std::mutex> l(queue_->mutex());
+      requestPending_ = false;
+      producerBufferedBytes_ = header.atEnd ? 0 : header.remainingBytes;
+      for (auto& page : pages) {
+        queue_->enqueueLocked(std::move(page), queuePromises);
+      }
+      if (header.atEnd) {
+        queue_->enqueueLocked(nullptr, queuePromises);
+        atEnd_ = true;
+      }
+      sequence_ = header.sequence + header.numPages;
+    }
+    for (auto& promise : queuePromises) {
+      promise.setValue();
+    }
+    if (header.atEnd) {
+      sendRequest(RequestKind::kDelete, 0);
+    }
+  }
+
+  const std::string host_;
+  const uint16_t port_;
+  // The id of the producer task on the server.
+  const std::string remoteTaskId_;
+
+  std::mutex mutex_;
+  std::condition_variable requested_;
+  // The promise of the pending request, if any.
+  ContinuePromise promise_{ContinuePromise::makeEmpty()};
+  uint32_t maxBytes_{0};
+  bool closed_{false};
+  int fd_{-1};
+  std::thread thread_;
+
+  std::atomic<int64_t> numPages_{0};
+  std::atomic<int64_t> numRequests_{0};
+};
+
+} // namespace
+
+TcpExchangeServer::TcpExchangeServer(const std::string& host, uint16_t port)
+    : host_(host), port_(port) {
+  listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+  VELOX_CHECK_GE(listenFd_, 0, "Cannot create socket");
+  int one = 1;
+  ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  struct sockaddr_in address {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port_);
+  VELOX_CHECK_EQ(
+      ::inet_pton(AF_INET, host_.c_str(), &address.sin_addr),
+      1,
+      "Not an IPv4 address: {}",
+      host_);
+  VELOX_CHECK_EQ(
+      ::bind(listenFd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)),
+      0,
+      "Cannot bind {}:{}: {}",
+      host_,
+      port_,
+      folly::errnoStr(errno));
+  VELOX_CHECK_EQ(::listen(listenFd_, SOMAXCONN), 0);
+  socklen_t size = sizeof(address);
+  ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&address), &size);
+  port_ = ntohs(address.sin_port);
+  acceptThread_ = std::thread([this]() { acceptLoop(); });
+}
+
+TcpExchangeServer::~TcpExchangeServer() {
+  stop();
+}
+
+std::string TcpExchangeServer::remoteTaskId(const std::string& taskId) const {
+  return fmt::format("tcp://{}:{}/{}", host_, port_, taskId);
+}
+
+void TcpExchangeServer::stop() {
+  if (stopped_.exchange(true)) {
+    return;
+  }
+  ::shutdown(listenFd_, SHUT_RDWR);
+  acceptThread_.join();
+  ::close(listenFd_);
+  std::vector<std::thread> threads;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (auto fd : connections_) {
+      ::shutdown(fd, SHUT_RDWR);
+    }
+    threads.swap(connectionThreads_);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+void TcpExchangeServer::acceptLoop() {
+  while (!stopped_) {
+    const auto fd = ::accept(listenFd_, nullptr, nullptr);
+    if (fd < 0) {
+      continue;
+    }
+    setNoDelay(fd);
+    std::lock_guard<std::mutex> l(mutex_);
+    if (stopped_) {
+      ::close(fd);
+      break;
+    }
+    connections_.push_back(fd);
+    connectionThreads_.emplace_back([this, fd]() { serve(fd); });
+  }
+}
+
+void TcpExchangeServer::serve(int fd) {
+  struct Pages {
+    std::vector<std::shared_ptr<SerializedPage>> pages;
+    int64_t sequence;
+    int64_t remainingBytes;
+  };
+
+  std::string taskId;
+  int32_t destination = -1;
+  bool deleted = false;
+  try {
+    RequestHeader request;
+    while (readFully(fd, &request, sizeof(request))) {
+      taskId.resize(request.taskIdSize);
+      VELOX_CHECK(readFully(fd, taskId.data(), taskId.size()));
+      destination = request.destination;
+      auto buffers = PartitionedOutputBufferManager::getInstance().lock();
+      VELOX_CHECK_NOT_NULL(buffers, "invalid PartitionedOutputBufferManager");
+      if (request.kind == RequestKind::kDelete) {
+        buffers->deleteResults(taskId, destination);
+        deleted = true;
+        continue;
+      }
+
+      auto promise = std::make_shared<folly::Promise<Pages>>();
+      auto future = promise->getSemiFuture();
+      const bool found = buffers->getPages(
+          taskId,
+          destination,
+          request.maxBytes,
+          request.sequence,
+          [promise](
+              std::vector<std::shared_ptr<SerializedPage>> pages,
+              int64_t sequence,
+              int64_t remainingBytes) {
+            promise->setValue(
+                Pages{std::move(pages), sequence, remainingBytes});
+          });
+      Pages result{{}, request.sequence, 0};
+      if (found) {
+        while (!future.isReady() && !stopped_) {
+          future.wait(std::chrono::milliseconds(100));
+        }
+        if (!future.isReady()) {
+          break;
+        }
+        result = std::move(future).get();
+      } else {
+        // The producer task has not started yet. The consumer asks again.
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      if (request.sequence > result.sequence) {
+        const auto numExtra = request.sequence - result.sequence;
+        VELOX_CHECK_LT(numExtra, result.pages.size());
+        result.pages.erase(
+            result.pages.begin(), result.pages.begin() + numExtra);
+        result.sequence = request.sequence;
+      }
+
+      ResponseHeader response{
+          result.sequence, result.remainingBytes, 0, false};
+      for (const auto& page : result.pages) {
+        if (page == nullptr) {
+          response.atEnd = true;
+        } else {
+          ++response.numPages;
+        }
+      }
+      writeFully(fd, &response, sizeof(response));
+      for (const auto& page : result.pages) {
+        if (page == nullptr) {
+          continue;
+        }
+        const uint32_t size = page->size();
+        writeFully(fd, &size, sizeof(size));
+        auto iobuf = page->getIOBuf();
+        for (const auto& range : *iobuf) {
+          writeFully(fd, range.data(), range.size());
+        }
+      }
+    }
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "TCP exchange connection failed: " << e.what();
+  }
+  if (!deleted && destination >= 0) {
+    if (auto buffers = PartitionedOutputBufferManager::getInstance().lock()) {
+      buffers->deleteResults(taskId, destination);
+    }
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  connections_.erase(
+      std::find(connections_.begin(), connections_.end(), fd));
+  ::close(fd);
+}
+
+std::unique_ptr<ExchangeSource> createTcpExchangeSource(
+    const std::string& taskId,
+    int destination,
+    std::shared_ptr<ExchangeQueue> queue,
+    memory::MemoryPool* pool) {
+  static const std::string kPrefix = "tcp://";
+  if (taskId.compare(0, kPrefix.size(), kPrefix) != 0) {
+    return nullptr;
+  }
+  const auto slash = taskId.find('/', kPrefix.size());
+  const auto colon = taskId.rfind(':', slash);
+  VELOX_CHECK(
+      slash != std::string::npos && colon != std::string::npos &&
+          colon >= kPrefix.size(),
+      "Bad TCP exchange task id: {}",
+      taskId);
+  return std::make_unique<TcpExchangeSource>(
+      taskId,
+      destination,
+      std::move(queue),
+      pool,
+      taskId.substr(kPrefix.size(), colon - kPrefix.size()),
+      folly::to<uint16_t>(taskId.substr(colon + 1, slash - colon - 1)),
+      taskId.substr(slash + 1));
+}
+
+std::vector<uint64_t> takeTcpExchangeRequestMicros() {
+  std::vector<uint64_t> micros;
+  requestMicros().wlock()->swap(micros);
+  return micros;
+}
+
+} // namespace facebook::velox::exec::test
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <thread>
+
+#include "velox/exec/Exchange.h"
+
+namespace facebook::velox::exec::test {
+
+/// Serves the pages of the local PartitionedOutputBufferManager over TCP to
+/// the exchange sources made by createTcpExchangeSource(), possibly in other
+/// processes. Each source uses one connection, served by a thread of its
+/// own. This is a simple transport for benchmarking exchange over a real
+/// network stack, not a production protocol: it assumes both ends have the
+/// same byte order.
+class TcpExchangeServer {
+ public:
+  /// Listens on 'host':'port'. A 'port' of 0 picks a free port.
+  TcpExchangeServer(const std::string& host, uint16_t port);
+
+  ~TcpExchangeServer();
+
+  uint16_t port() const {
+    return port_;
+  }
+
+  /// Returns the remote task id that reads the results of the local task
+  /// 'taskId' through 'this', i.e. tcp://<host>:<port>/<taskId>.
+  std::string remoteTaskId(const std::string& taskId) const;
+
+  /// Stops accepting connections and closes the open ones.
+  void stop();
+
+ private:
+  void acceptLoop();
+
+  // Answers the requests on 'fd' until the peer closes it.
+  void serve(int fd);
+
+  const std::string host_;
+  uint16_t port_;
+  int listenFd_{-1};
+  std::atomic<bool> stopped_{false};
+  std::thread acceptThread_;
+  std::mutex mutex_;
+  std::vector<int> connections_;
+  std::vector<std::thread> connectionThreads_;
+};
+
+/// Given taskId that starts with tcp:// returns an instance of ExchangeSource
+/// that fetches data from a TcpExchangeServer. The taskId has the form
+/// tcp://<host>:<port>/<remote task id>.
+std::unique_ptr<exec::ExchangeSource> createTcpExchangeSource(
+    const std::string& taskId,
+    int destination,
+    std::shared_ptr<exec::ExchangeQueue> queue,
+    memory::MemoryPool* pool);
+
+/// Returns the round trip times in microseconds of the requests of all the
+/// TCP exchange sources in the process since the previous call. A request
+/// waits for the producer to have data, so this includes producer stalls.
+std::vector<uint64_t> takeTcpExchangeRequestMicros();
+
+} // namespace facebook::velox::exec::test
@@ -145,8 +145,12 @@ TpchPlan TpchQueryBuilder::getQueryPlan(int queryId) const {
   switch (queryId) {
     case 1:
       return getQ1Plan();
+    case 2:
+      return getQ2Plan();
     case 3:
       return getQ3Plan();
+    case 4:
+      return getQ4Plan();
     case 5:
       return getQ5Plan();
     case 6:
@@ -159,6 +163,8 @@ TpchPlan TpchQueryBuilder::getQueryPlan(int queryId) const {
       return getQ9Plan();
     case 10:
       return getQ10Plan();
+    case 11:
+      return getQ11Plan();
     case 12:
       return getQ12Plan();
     case 13:
@@ -239,6 +245,169 @@ TpchPlan TpchQueryBuilder::getQ1Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ2Plan() const {
+  std::vector<std::string> partColumns = {
+      "p_partkey", "p_mfgr", "p_size", "p_type"};
+  std::vector<std::string> supplierColumns = {
+      "s_suppkey",
+      "s_name",
+      "s_address",
+      "s_nationkey",
+      "s_phone",
+      "s_acctbal",
+      "s_comment"};
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_supplycost"};
+  std::vector<std::string> nationColumns = {
+      "n_nationkey", "n_name", "n_regionkey"};
+  std::vector<std::string> regionColumns = {"r_regionkey", "r_name"};
+
+  auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+  auto regionSelectedRowType = getRowType(kRegion, regionColumns);
+  const auto& regionFileColumns = getFileColumnNames(kRegion);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  TpchPlan context;
+
+  // Suppliers in Europe. Used by both the query and the subquery for the
+  // minimum supply cost of each part.
+  auto europeSuppliers = [&]() {
+    core::PlanNodeId supplierScanNodeId;
+    core::PlanNodeId nationScanNodeId;
+    core::PlanNodeId regionScanNodeId;
+
+    auto region = PlanBuilder(planNodeIdGenerator, pool_.get())
+                      .tableScan(
+                          kRegion,
+                          regionSelectedRowType,
+                          regionFileColumns,
+                          {"r_name = 'EUROPE'"})
+                      .capturePlanNodeId(regionScanNodeId)
+                      .planNode();
+
+    auto nation =
+        PlanBuilder(planNodeIdGenerator, pool_.get())
+            .tableScan(kNation, nationSelectedRowType, nationFileColumns)
+            .capturePlanNodeId(nationScanNodeId)
+            .hashJoin(
+                {"n_regionkey"},
+                {"r_regionkey"},
+                region,
+                "",
+                {"n_nationkey", "n_name"})
+            .planNode();
+
+    auto suppliers =
+        PlanBuilder(planNodeIdGenerator, pool_.get())
+            .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+            .capturePlanNodeId(supplierScanNodeId)
+            .hashJoin(
+                {"s_nationkey"},
+                {"n_nationkey"},
+                nation,
+                "",
+                {"s_suppkey",
+                 "s_name",
+                 "s_address",
+                 "s_phone",
+                 "s_acctbal",
+                 "s_comment",
+                 "n_name"})
+            .planNode();
+
+    context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+    context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+    context.dataFiles[regionScanNodeId] = getTableFilePaths(kRegion);
+    return suppliers;
+  };
+
+  core::PlanNodeId partsuppScanNodeIdSubQuery;
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId partScanNodeId;
+
+  auto minSupplyCost =
+      PlanBuilder(planNodeIdGenerator, pool_.get())
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeIdSubQuery)
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              europeSuppliers(),
+              "",
+              {"ps_partkey", "ps_supplycost"})
+          .partialAggregation(
+              {"ps_partkey"}, {"min(ps_supplycost) as min_supplycost"})
+          .localPartition({"ps_partkey"})
+          .finalAggregation()
+          .project({"ps_partkey as min_partkey", "min_supplycost"})
+          .planNode();
+
+  auto part = PlanBuilder(planNodeIdGenerator, pool_.get())
+                  .tableScan(
+                      kPart,
+                      partSelectedRowType,
+                      partFileColumns,
+                      {"p_size = 15"},
+                      "p_type LIKE '%BRASS'")
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator, pool_.get())
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"ps_partkey", "ps_suppkey", "ps_supplycost", "p_mfgr"})
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              europeSuppliers(),
+              "",
+              {"ps_partkey",
+               "ps_supplycost",
+               "p_mfgr",
+               "s_name",
+               "s_address",
+               "s_phone",
+               "s_acctbal",
+               "s_comment",
+               "n_name"})
+          .hashJoin(
+              {"ps_partkey", "ps_supplycost"},
+              {"min_partkey", "min_supplycost"},
+              minSupplyCost,
+              "",
+              {"s_acctbal",
+               "s_name",
+               "n_name",
+               "ps_partkey",
+               "p_mfgr",
+               "s_address",
+               "s_phone",
+               "s_comment"})
+          .orderBy({"s_acctbal DESC", "n_name", "s_name", "ps_partkey"}, false)
+          .limit(0, 100, false)
+          .planNode();
+
+  context.plan = std::move(plan);
+  context.dataFiles[partsuppScanNodeIdSubQuery] = getTableFilePaths(kPartsupp);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ3Plan() const {
   std::vector<std::string> lineitemColumns = {
       "l_shipdate", "l_orderkey", "l_extendedprice", "l_discount"};
@@ -327,6 +496,65 @@ TpchPlan TpchQueryBuilder::getQ3Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ4Plan() const {
+  std::vector<std::string> ordersColumns = {
+      "o_orderkey", "o_orderdate", "o_orderpriority"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey", "l_commitdate", "l_receiptdate"};
+
+  const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+
+  // '1993-07-01' <= orderdate < '1993-10-01'
+  const std::string orderDateFilter = formatDateFilter(
+      "o_orderdate", ordersSelectedRowType, "'1993-07-01'", "'1993-09-30'");
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+
+  auto lineitem = PlanBuilder(planNodeIdGenerator, pool_.get())
+                      .tableScan(
+                          kLineitem,
+                          lineitemSelectedRowType,
+                          lineitemFileColumns,
+                          {},
+                          "l_commitdate < l_receiptdate")
+                      .capturePlanNodeId(lineitemScanNodeId)
+                      .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator, pool_.get())
+          .tableScan(
+              kOrders,
+              ordersSelectedRowType,
+              ordersFileColumns,
+              {orderDateFilter})
+          .capturePlanNodeId(ordersScanNodeId)
+          .hashJoin(
+              {"o_orderkey"},
+              {"l_orderkey"},
+              lineitem,
+              "",
+              {"o_orderpriority"},
+              core::JoinType::kLeftSemiFilter)
+          .partialAggregation(
+              {"o_orderpriority"}, {"count(0) as order_count"})
+          .localPartition(std::vector<std::string>{})
+          .finalAggregation()
+          .orderBy({"o_orderpriority"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ5Plan() const {
   std::vector<std::string> customerColumns = {"c_custkey", "c_nationkey"};
   std::vector<std::string> ordersColumns = {
@@ -1060,6 +1288,90 @@ TpchPlan TpchQueryBuilder::getQ10Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ11Plan() const {
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_availqty", "ps_supplycost"};
+  std::vector<std::string> supplierColumns = {"s_suppkey", "s_nationkey"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+
+  auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  TpchPlan context;
+
+  // The value of the stock of each part held by suppliers in Germany. Used
+  // by both the query and the subquery for the total value.
+  auto germanStock = [&]() {
+    core::PlanNodeId partsuppScanNodeId;
+    core::PlanNodeId supplierScanNodeId;
+    core::PlanNodeId nationScanNodeId;
+
+    auto nation = PlanBuilder(planNodeIdGenerator, pool_.get())
+                      .tableScan(
+                          kNation,
+                          nationSelectedRowType,
+                          nationFileColumns,
+                          {"n_name = 'GERMANY'"})
+                      .capturePlanNodeId(nationScanNodeId)
+                      .planNode();
+
+    auto supplier =
+        PlanBuilder(planNodeIdGenerator, pool_.get())
+            .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+            .capturePlanNodeId(supplierScanNodeId)
+            .hashJoin(
+                {"s_nationkey"}, {"n_nationkey"}, nation, "", {"s_suppkey"})
+            .planNode();
+
+    auto stock =
+        PlanBuilder(planNodeIdGenerator, pool_.get())
+            .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+            .capturePlanNodeId(partsuppScanNodeId)
+            .hashJoin(
+                {"ps_suppkey"},
+                {"s_suppkey"},
+                supplier,
+                "",
+                {"ps_partkey", "ps_availqty", "ps_supplycost"})
+            .project(
+                {"ps_partkey",
+                 "ps_supplycost * cast(ps_availqty as double) as part_value"});
+
+    context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+    context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+    context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+    return stock;
+  };
+
+  auto threshold = germanStock()
+                       .partialAggregation({}, {"sum(part_value) as total"})
+                       .localPartition(std::vector<std::string>{})
+                       .finalAggregation()
+                       .project({"total * 0.0001 as threshold"})
+                       .planNode();
+
+  auto plan = germanStock()
+                  .partialAggregation(
+                      {"ps_partkey"}, {"sum(part_value) as value"})
+                  .localPartition({"ps_partkey"})
+                  .finalAggregation()
+                  .nestedLoopJoin(
+                      threshold, {"ps_partkey", "value", "threshold"})
+                  .filter("value > threshold")
+                  .project({"ps_partkey", "value"})
+                  .orderBy({"value DESC"}, false)
+                  .planNode();
+
+  context.plan = std::move(plan);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ12Plan() const {
   std::vector<std::string> ordersColumns = {"o_orderkey", "o_orderpriority"};
   std::vector<std::string> lineitemColumns = {
@@ -189,6 +189,79 @@ class Compiler {
     return dynamicLibPath;
   }
 
+  /// Compiles a given c++ string and links it into a dynamic library. If
+  /// the options have a cache directory, the library is kept there under a
+  /// name derived from the source and the compile and link commands, and a
+  /// later call with the same inputs, also from another process, returns a
+  /// copy of it without compiling.
+  /// \param additionalLibraries
+  /// \param cppContent  c++ file content
+  /// \return path to the dynamic library
+  std::filesystem::path compileAndLink(
+      const std::vector<LibraryDescriptor>& additionalLibraries,
+      const std::string& cppContent) {
+    if (!compilerOptions_.cacheDirectory.has_value()) {
+      auto object = compileString(additionalLibraries, cppContent);
+      return link(additionalLibraries, {object});
+    }
+    DefaultScopedTimer timer("CompileAndLinkCached", eventSequence_);
+    const auto& cacheDirectory = compilerOptions_.cacheDirectory.value();
+
+    // The key has the commands with fixed file names so that it does not
+    // depend on the temporary paths of a particular compilation.
+    const auto key = fmt::format(
+        "{}\n{}\n{}",
+        compileCommand(additionalLibraries, "source.cpp", "source.o")
+            .toString(),
+        linkCommand(additionalLibraries, {"source.o"}, "dyn.so").toString(),
+        cppContent);
+    const auto name = fmt::format("{:016x}", std::hash<std::string>{}(key));
+    const auto libraryPath = cacheDirectory / (name + ".so");
+    const auto keyPath = cacheDirectory / (name + ".key");
+
+    // NativeLibraryLoader does not load the same path twice, so each caller
+    // gets a private copy of the cached library.
+    auto copyOut = [&]() {
+      auto path = pathGenerator_.tempPath("dyn", ".so");
+      std::filesystem::copy_file(
+          libraryPath, path, std::filesystem::copy_options::overwrite_existing);
+      return path;
+    };
+    if (std::filesystem::exists(libraryPath) &&
+        std::filesystem::exists(keyPath)) {
+      std::stringstream cachedKey;
+      cachedKey << std::ifstream(keyPath).rdbuf();
+      if (cachedKey.str() == key) {
+        return copyOut();
+      }
+      LOG(WARNING) << "Codegen cache collision on " << libraryPath;
+      auto object = compileString(additionalLibraries, cppContent);
+      return link(additionalLibraries, {object});
+    }
+
+    auto object = compileString(additionalLibraries, cppContent);
+    auto library = link(additionalLibraries, {object});
+
+    // Renames complete files into place so that concurrent processes never
+    // see a partially written entry. The key goes last since its presence
+    // marks the entry as valid.
+    std::filesystem::create_directories(cacheDirectory);
+    auto publish = [&](const std::filesystem::path& target, auto write) {
+      auto temp = pathGenerator_.tempPath(
+          cacheDirectory, name, target.extension().string());
+      write(temp);
+      std::filesystem::rename(temp, target);
+    };
+    publish(libraryPath, [&](const std::filesystem::path& temp) {
+      std::filesystem::copy_file(
+          library, temp, std::filesystem::copy_options::overwrite_existing);
+    });
+    publish(keyPath, [&](const std::filesystem::path& temp) {
+      std::ofstream(temp) << key;
+    });
+    return library;
+  }
+
   /// Construct a command object which execution would compile the give files.
   /// \param additionalLibraries
   /// \param cppFile
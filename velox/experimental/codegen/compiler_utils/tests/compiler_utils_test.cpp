@@ -290,4 +290,46 @@ TEST(Compiler, CompileAndLink) {
   ASSERT_EQ(dlerror(), nullptr);
   ASSERT_EQ(f(), 24);
 };
+
+TEST(Compiler, CompileAndLinkCached) {
+  auto sourceCode = R"a(
+  extern "C" {
+  int f() {
+    return 24;
+  };
+  }
+  )a";
+
+  auto cacheDirectory = boost::filesystem::unique_path(
+                            fmt::format(
+                                "{}/%%%%-%%%%",
+                                boost::filesystem::temp_directory_path()
+                                    .string()))
+                            .string();
+  auto options = testCompilerOptions().withCacheDirectory(cacheDirectory);
+
+  auto countEntries = [&]() {
+    return std::distance(
+        std::filesystem::directory_iterator(cacheDirectory),
+        std::filesystem::directory_iterator());
+  };
+
+  DefaultScopedTimer::EventSequence eventSequence;
+  auto first = Compiler(options, eventSequence).compileAndLink({}, sourceCode);
+  ASSERT_EQ(countEntries(), 2);
+
+  // A new Compiler, as in a restarted process, finds the library in the
+  // cache and gets its own copy of it.
+  auto second =
+      Compiler(options, eventSequence).compileAndLink({}, sourceCode);
+  ASSERT_NE(first, second);
+  ASSERT_EQ(countEntries(), 2);
+
+  auto libraryPtr =
+      native_loader::NativeLibraryLoader::loadLibraryInternal(second);
+  auto f = (int (*)())dlsym(libraryPtr, "f");
+  ASSERT_EQ(f(), 24);
+
+  std::filesystem::remove_all(cacheDirectory);
+}
 } // namespace facebook::velox::codegen::compiler_utils::test
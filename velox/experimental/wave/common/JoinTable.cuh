@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/experimental/wave/common/JoinTable.h"
+
+#include "velox/experimental/wave/common/StringView.cuh"
+
+namespace facebook::velox::wave {
+
+template <typename T, typename H>
+__device__ void JoinTable<T, H>::clearTable() {
+  for (int i = threadIdx.x; i < capacity_; i += blockDim.x) {
+    keys_[i] = kEmptyMarker;
+    heads_[i] = -1;
+  }
+}
+
+template <typename T, typename H>
+__device__ T JoinTable<T, H>::casValue(T* address, T compare, T val) {
+  if constexpr (std::is_same_v<T, StringView>) {
+    return address->cas(compare, val);
+  } else if constexpr (sizeof(T) == 8) {
+    using ULL = unsigned long long;
+    return atomicCAS((ULL*)address, (ULL)compare, (ULL)val);
+  } else {
+    return atomicCAS(address, compare, val);
+  }
+  __builtin_unreachable();
+}
+
+template <typename T, typename H>
+__device__ bool JoinTable<T, H>::insert(T key, int32_t row) {
+  if (key == kEmptyMarker) {
+    next_[row] = atomicExch(&emptyHead_, row);
+    return true;
+  }
+  auto mask = capacity_ - 1;
+  auto maxEntries = capacity_ - capacity_ / 4;
+  for (auto i = H()(key) & mask;; i = (i + 1) & mask) {
+    if (keys_[i] == kEmptyMarker) {
+      if (numKeys_ >= maxEntries) {
+        return false;
+      }
+      if (casValue(&keys_[i], kEmptyMarker, key) == kEmptyMarker) {
+        atomicAdd(const_cast<int*>(&numKeys_), 1);
+      }
+    }
+    if (keys_[i] == key) {
+      // Rows with the same key are pushed on the front of the chain, so
+      // their order is not defined.
+      next_[row] = atomicExch(&heads_[i], row);
+      return true;
+    }
+  }
+}
+
+template <typename T, typename H>
+__device__ int32_t JoinTable<T, H>::find(T key) const {
+  if (key == kEmptyMarker) {
+    return emptyHead_;
+  }
+  auto mask = capacity_ - 1;
+  for (auto i = H()(key) & mask;; i = (i + 1) & mask) {
+    if (keys_[i] == key) {
+      return heads_[i];
+    }
+    // At most 3/4 of the slots are used, so the probe ends.
+    if (keys_[i] == kEmptyMarker) {
+      return -1;
+    }
+  }
+}
+
+} // namespace facebook::velox::wave
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <fmt/format.h>
+
+#include "velox/experimental/wave/common/Exception.h"
+#include "velox/experimental/wave/common/Hash.h"
+
+namespace facebook::velox::wave {
+
+/// Device resident hash table for the build side of a hash join. Maps each
+/// distinct key to the chain of build rows with that key. Keys are in an
+/// open addressing table of 'capacity' slots. Build rows with the same key
+/// are linked through 'next', which has one entry per build row. Inserts are
+/// done by all threads of a build kernel in parallel and lookups by a later
+/// probe kernel, so the two must not overlap.
+template <typename T, typename H = Hasher<T, uint32_t>>
+class JoinTable {
+ public:
+  void init(int capacity, T* keys, int32_t* heads, int32_t* next);
+
+  __device__ void clearTable();
+
+  /// Adds build row 'row' with 'key'. Returns false if the table is full.
+  __device__ bool insert(T key, int32_t row);
+
+  /// Returns the first build row with 'key' or -1 if there is none.
+  __device__ int32_t find(T key) const;
+
+  /// Returns the next build row with the same key as 'row' or -1 after the
+  /// last one.
+  __device__ int32_t nextRow(int32_t row) const {
+    return next_[row];
+  }
+
+  __device__ int numKeys() const {
+    return numKeys_;
+  }
+
+ private:
+  __device__ static T casValue(T* address, T compare, T val);
+
+  static constexpr T kEmptyMarker = {};
+  int capacity_;
+  T* keys_;
+  int32_t* heads_;
+  int32_t* next_;
+  // Chain of build rows whose key equals 'kEmptyMarker'.
+  int32_t emptyHead_;
+  volatile int numKeys_;
+};
+
+// Non-trivial class does not play well in device code.
+static_assert(std::is_trivial_v<JoinTable<StringView>>);
+
+template <typename T, typename H>
+void JoinTable<T, H>::init(
+    int capacity,
+    T* keys,
+    int32_t* heads,
+    int32_t* next) {
+  if ((capacity & (capacity - 1)) != 0) {
+    waveError(fmt::format("Capacity must be power of two, got {}", capacity));
+  }
+  if ((uintptr_t)keys % sizeof(T) != 0) {
+    waveError("Keys buffer must be aligned");
+  }
+  capacity_ = capacity;
+  keys_ = keys;
+  heads_ = heads;
+  next_ = next;
+  emptyHead_ = -1;
+  numKeys_ = 0;
+}
+
+} // namespace facebook::velox::wave
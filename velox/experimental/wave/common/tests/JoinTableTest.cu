@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/init/Init.h>
+#include <gtest/gtest.h>
+#include <random>
+#include <unordered_map>
+
+#include "velox/experimental/wave/common/Cuda.h"
+#include "velox/experimental/wave/common/JoinTable.cuh"
+
+namespace facebook::velox::wave {
+namespace {
+
+constexpr int kBlockSize = 256;
+
+std::random_device::result_type randomSeed() {
+  auto seed = std::random_device{}();
+  LOG(INFO) << "Random seed: " << seed;
+  return seed;
+}
+
+struct JoinTableHolder {
+  GpuAllocator::UniquePtr<int64_t[]> keys;
+  GpuAllocator::UniquePtr<int32_t[]> heads;
+  GpuAllocator::UniquePtr<int32_t[]> next;
+  GpuAllocator::UniquePtr<JoinTable<int64_t>> table;
+};
+
+__global__ void initTable(JoinTable<int64_t>* table) {
+  table->clearTable();
+}
+
+__global__ void runBuild(
+    JoinTable<int64_t>* table,
+    const int64_t* keys,
+    int size,
+    int* numFailed) {
+  int step = gridDim.x * blockDim.x;
+  for (int i = threadIdx.x + blockIdx.x * blockDim.x; i < size; i += step) {
+    if (!table->insert(keys[i], i)) {
+      atomicAdd(numFailed, 1);
+    }
+  }
+}
+
+// Writes the matching build row of each hit to 'buildRows' and the probe row
+// to 'probeRows'. 'numHits' is the count of pairs written.
+__global__ void runProbe(
+    JoinTable<int64_t>* table,
+    const int64_t* keys,
+    int size,
+    int32_t* probeRows,
+    int32_t* buildRows,
+    int* numHits) {
+  int step = gridDim.x * blockDim.x;
+  for (int i = threadIdx.x + blockIdx.x * blockDim.x; i < size; i += step) {
+    for (auto row = table->find(keys[i]); row != -1;
+         row = table->nextRow(row)) {
+      auto hit = atomicAdd(numHits, 1);
+      probeRows[hit] = i;
+      buildRows[hit] = row;
+    }
+  }
+}
+
+JoinTableHolder
+createTable(GpuAllocator* allocator, int capacity, int numBuildRows) {
+  JoinTableHolder holder;
+  holder.table = allocator->allocate<JoinTable<int64_t>>();
+  holder.keys = allocator->allocate<int64_t>(capacity);
+  holder.heads = allocator->allocate<int32_t>(capacity);
+  holder.next = allocator->allocate<int32_t>(numBuildRows);
+  holder.table->init(
+      capacity, holder.keys.get(), holder.heads.get(), holder.next.get());
+  initTable<<<1, kBlockSize>>>(holder.table.get());
+  EXPECT_EQ(cudaGetLastError(), cudaSuccess);
+  return holder;
+}
+
+int numBlocks(int size) {
+  return (size + kBlockSize - 1) / kBlockSize;
+}
+
+TEST(JoinTableTest, buildAndProbe) {
+  constexpr int kCapacity = 16 << 10;
+  constexpr int kNumBuildRows = 10'007;
+  constexpr int kNumProbeRows = 40'013;
+  auto* allocator = getAllocator(getDevice());
+  auto holder = createTable(allocator, kCapacity, kNumBuildRows);
+
+  // Build keys have duplicates and include 0, which is the empty marker.
+  std::default_random_engine gen(randomSeed());
+  std::uniform_int_distribution<> dist(0, kNumBuildRows / 2);
+  auto buildKeys = allocator->allocate<int64_t>(kNumBuildRows);
+  std::unordered_multimap<int64_t, int32_t> expected;
+  for (int i = 0; i < kNumBuildRows; ++i) {
+    buildKeys[i] = 3 * dist(gen);
+    expected.emplace(buildKeys[i], i);
+  }
+  auto probeKeys = allocator->allocate<int64_t>(kNumProbeRows);
+  size_t expectedHits = 0;
+  for (int i = 0; i < kNumProbeRows; ++i) {
+    probeKeys[i] = dist(gen);
+    expectedHits += expected.count(probeKeys[i]);
+  }
+
+  auto counters = allocator->allocate<int>(2);
+  counters[0] = 0;
+  counters[1] = 0;
+  auto probeRows = allocator->allocate<int32_t>(expectedHits);
+  auto buildRows = allocator->allocate<int32_t>(expectedHits);
+
+  runBuild<<<numBlocks(kNumBuildRows), kBlockSize>>>(
+      holder.table.get(), buildKeys.get(), kNumBuildRows, &counters[0]);
+  ASSERT_EQ(cudaGetLastError(), cudaSuccess);
+  runProbe<<<numBlocks(kNumProbeRows), kBlockSize>>>(
+      holder.table.get(),
+      probeKeys.get(),
+      kNumProbeRows,
+      probeRows.get(),
+      buildRows.get(),
+      &counters[1]);
+  ASSERT_EQ(cudaGetLastError(), cudaSuccess);
+  ASSERT_EQ(cudaDeviceSynchronize(), cudaSuccess);
+
+  ASSERT_EQ(0, counters[0]);
+  ASSERT_EQ(expectedHits, static_cast<size_t>(counters[1]));
+  std::vector<std::vector<int32_t>> hits(kNumProbeRows);
+  for (int i = 0; i < expectedHits; ++i) {
+    ASSERT_EQ(probeKeys[probeRows[i]], buildKeys[buildRows[i]]);
+    hits[probeRows[i]].push_back(buildRows[i]);
+  }
+  for (int i = 0; i < kNumProbeRows; ++i) {
+    std::vector<int32_t> rows;
+    auto range = expected.equal_range(probeKeys[i]);
+    for (auto it = range.first; it != range.second; ++it) {
+      rows.push_back(it->second);
+    }
+    std::sort(rows.begin(), rows.end());
+    std::sort(hits[i].begin(), hits[i].end());
+    ASSERT_EQ(rows, hits[i]) << "probe row " << i;
+  }
+}
+
+TEST(JoinTableTest, overflow) {
+  constexpr int kCapacity = 32;
+  constexpr int kNumBuildRows = 1'000;
+  auto* allocator = getAllocator(getDevice());
+  auto holder = createTable(allocator, kCapacity, kNumBuildRows);
+  auto buildKeys = allocator->allocate<int64_t>(kNumBuildRows);
+  for (int i = 0; i < kNumBuildRows; ++i) {
+    buildKeys[i] = i + 1;
+  }
+  auto numFailed = allocator->allocate<int>(1);
+  numFailed[0] = 0;
+  runBuild<<<numBlocks(kNumBuildRows), kBlockSize>>>(
+      holder.table.get(), buildKeys.get(), kNumBuildRows, numFailed.get());
+  ASSERT_EQ(cudaGetLastError(), cudaSuccess);
+  ASSERT_EQ(cudaDeviceSynchronize(), cudaSuccess);
+  ASSERT_GT(numFailed[0], 0);
+}
+
+} // namespace
+} // namespace facebook::velox::wave
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::Init follyInit(&argc, &argv);
+  return RUN_ALL_TESTS();
+}
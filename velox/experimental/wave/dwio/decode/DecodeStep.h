@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/experimental/wave/common/Cuda.h"
+
+/// Describes decoding of encoded column streams on the GPU. Included from
+/// both host and device code.
+
+namespace facebook::velox::wave {
+
+enum class DecodeStep {
+  /// Values stored as is, e.g. Parquet PLAIN or uncompressed DWRF DIRECT.
+  kTrivial,
+  /// Bit packed values plus 'baseline'. If a dictionary is given, the result
+  /// is an index into it.
+  kDictionaryOnBitpack,
+  /// Runs of repeated values.
+  kRle,
+};
+
+/// One decoding step. Decodes 'numValues' values of 'valueBytes' bytes each
+/// into 'result'. The encoded data and 'result' must be addressable from the
+/// device, e.g. allocated from a GpuArena.
+struct GpuDecode {
+  struct Trivial {
+    const void* input;
+  };
+
+  struct DictionaryOnBitpack {
+    /// Bit packed values, least significant bits first.
+    const uint64_t* input;
+    uint8_t bitWidth;
+    int64_t baseline;
+    /// nullptr if the unpacked values are not dictionary indices.
+    const void* dictionary;
+  };
+
+  struct Rle {
+    const void* values;
+    const int32_t* lengths;
+    int32_t numRuns;
+  };
+
+  DecodeStep step;
+
+  /// 4 or 8.
+  uint8_t valueBytes;
+
+  int32_t numValues;
+
+  void* result;
+
+  union {
+    Trivial trivial;
+    DictionaryOnBitpack dictionaryOnBitpack;
+    Rle rle;
+  } data;
+};
+
+/// Enqueues the decoding of 'decodes' on 'stream', one thread block per
+/// step. 'decodes' must be addressable from the device.
+void decodeGlobal(GpuDecode* decodes, int32_t numDecodes, Stream& stream);
+
+} // namespace facebook::velox::wave
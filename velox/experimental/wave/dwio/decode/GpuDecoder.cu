@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/experimental/wave/common/CudaUtil.cuh"
+#include "velox/experimental/wave/dwio/decode/GpuDecoder.cuh"
+
+namespace facebook::velox::wave {
+
+constexpr int32_t kDecodeBlockSize = 256;
+
+__global__ void decodeGlobalKernel(GpuDecode* decodes) {
+  const auto& op = decodes[blockIdx.x];
+  // Values are copied as bits, so the signedness or floating point type of
+  // the column does not matter.
+  if (op.valueBytes == sizeof(int32_t)) {
+    decodeSwitch<int32_t, kDecodeBlockSize>(op);
+  } else {
+    decodeSwitch<int64_t, kDecodeBlockSize>(op);
+  }
+}
+
+void decodeGlobal(GpuDecode* decodes, int32_t numDecodes, Stream& stream) {
+  decodeGlobalKernel<<<
+      numDecodes,
+      kDecodeBlockSize,
+      0,
+      stream.stream()->stream>>>(decodes);
+  CUDA_CHECK(cudaGetLastError());
+}
+
+} // namespace facebook::velox::wave
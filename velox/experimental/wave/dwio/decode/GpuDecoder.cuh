@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cub/block/block_scan.cuh>
+
+#include "velox/experimental/wave/dwio/decode/DecodeStep.h"
+
+/// Device functions for decoding column streams. Each decodes one GpuDecode
+/// with all threads of a thread block, so that they can be called from fused
+/// kernels as well as from decodeGlobal().
+
+namespace facebook::velox::wave {
+
+template <typename T>
+__device__ void decodeTrivial(const GpuDecode& op) {
+  auto* input = reinterpret_cast<const T*>(op.data.trivial.input);
+  auto* result = reinterpret_cast<T*>(op.result);
+  for (auto i = threadIdx.x; i < op.numValues; i += blockDim.x) {
+    result[i] = input[i];
+  }
+}
+
+/// Returns 'bitWidth' bits starting at 'bit' in 'words'. Reads the next word
+/// only if the value straddles a word boundary.
+__device__ inline uint64_t
+loadBits(const uint64_t* words, uint64_t bit, uint8_t bitWidth) {
+  const auto word = bit / 64;
+  const auto shift = bit & 63;
+  uint64_t bits = words[word] >> shift;
+  if (shift + bitWidth > 64) {
+    bits |= words[word + 1] << (64 - shift);
+  }
+  return bitWidth == 64 ? bits : bits & ((1ULL << bitWidth) - 1);
+}
+
+template <typename T>
+__device__ void decodeDictionaryOnBitpack(const GpuDecode& op) {
+  const auto& bitpack = op.data.dictionaryOnBitpack;
+  auto* dictionary = reinterpret_cast<const T*>(bitpack.dictionary);
+  auto* result = reinterpret_cast<T*>(op.result);
+  for (auto i = threadIdx.x; i < op.numValues; i += blockDim.x) {
+    const int64_t value = bitpack.baseline +
+        loadBits(bitpack.input,
+                 static_cast<uint64_t>(i) * bitpack.bitWidth,
+                 bitpack.bitWidth);
+    result[i] = dictionary ? dictionary[value] : static_cast<T>(value);
+  }
+}
+
+/// Each thread takes one run out of each 'kBlockSize' runs. An exclusive
+/// sum of the run lengths gives the place of each run in the result.
+template <typename T, int32_t kBlockSize>
+__device__ void decodeRle(const GpuDecode& op) {
+  using Scan = cub::BlockScan<int32_t, kBlockSize>;
+  __shared__ typename Scan::TempStorage temp;
+
+  const auto& rle = op.data.rle;
+  auto* values = reinterpret_cast<const T*>(rle.values);
+  auto* result = reinterpret_cast<T*>(op.result);
+  int32_t offset = 0;
+  for (int32_t start = 0; start < rle.numRuns; start += kBlockSize) {
+    const auto run = start + threadIdx.x;
+    const int32_t length = run < rle.numRuns ? rle.lengths[run] : 0;
+    int32_t runOffset;
+    int32_t total;
+    Scan(temp).ExclusiveSum(length, runOffset, total);
+    for (auto i = 0; i < length; ++i) {
+      result[offset + runOffset + i] = values[run];
+    }
+    offset += total;
+    // 'temp' is reused by the next scan.
+    __syncthreads();
+  }
+}
+
+template <typename T, int32_t kBlockSize>
+__device__ void decodeSwitch(const GpuDecode& op) {
+  switch (op.step) {
+    case DecodeStep::kTrivial:
+      decodeTrivial<T>(op);
+      break;
+    case DecodeStep::kDictionaryOnBitpack:
+      decodeDictionaryOnBitpack<T>(op);
+      break;
+    case DecodeStep::kRle:
+      decodeRle<T, kBlockSize>(op);
+      break;
+  }
+}
+
+} // namespace facebook::velox::wave
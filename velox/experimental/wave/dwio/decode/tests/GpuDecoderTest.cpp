@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/experimental/wave/common/GpuArena.h"
+#include "velox/experimental/wave/dwio/decode/DecodeStep.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::wave;
+
+class GpuDecoderTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    device_ = getDevice();
+    setDevice(device_);
+    allocator_ = getAllocator(device_);
+    arena_ = std::make_unique<GpuArena>(1 << 28, allocator_);
+  }
+
+  // Bit packs 'values' with 'bitWidth' bits each, least significant first.
+  WaveBufferPtr bitpack(const std::vector<uint64_t>& values, int bitWidth) {
+    auto numWords = (values.size() * bitWidth + 63) / 64;
+    auto buffer = arena_->allocate<uint64_t>(numWords);
+    auto* words = buffer->as<uint64_t>();
+    std::fill(words, words + numWords, 0);
+    for (auto i = 0; i < values.size(); ++i) {
+      const uint64_t bit = static_cast<uint64_t>(i) * bitWidth;
+      words[bit / 64] |= values[i] << (bit % 64);
+      if (bit % 64 + bitWidth > 64) {
+        words[bit / 64 + 1] |= values[i] >> (64 - bit % 64);
+      }
+    }
+    return buffer;
+  }
+
+  template <typename T>
+  WaveBufferPtr copy(const std::vector<T>& values) {
+    auto buffer = arena_->allocate<T>(values.size());
+    std::copy(values.begin(), values.end(), buffer->as<T>());
+    return buffer;
+  }
+
+  void decode(std::vector<GpuDecode>& steps) {
+    auto buffer = copy(steps);
+    Stream stream;
+    decodeGlobal(buffer->as<GpuDecode>(), steps.size(), stream);
+    stream.wait();
+  }
+
+  Device* device_;
+  GpuAllocator* allocator_;
+  std::unique_ptr<GpuArena> arena_;
+};
+
+TEST_F(GpuDecoderTest, bitpack) {
+  constexpr int32_t kNumValues = 10'000;
+  std::vector<WaveBufferPtr> buffers;
+  std::vector<std::vector<int64_t>> expected;
+  std::vector<GpuDecode> steps;
+  for (auto bitWidth : {1, 7, 13, 32, 33, 63, 64}) {
+    std::vector<uint64_t> values(kNumValues);
+    expected.emplace_back(kNumValues);
+    const int64_t baseline = bitWidth < 64 ? -5 : 0;
+    for (auto i = 0; i < kNumValues; ++i) {
+      values[i] = (i * 0x9E3779B97F4A7C15ULL) >> (64 - bitWidth);
+      expected.back()[i] = values[i] + baseline;
+    }
+    buffers.push_back(bitpack(values, bitWidth));
+    auto& step = steps.emplace_back();
+    step.step = DecodeStep::kDictionaryOnBitpack;
+    step.valueBytes = sizeof(int64_t);
+    step.numValues = kNumValues;
+    buffers.push_back(arena_->allocate<int64_t>(kNumValues));
+    step.result = buffers.back()->as<int64_t>();
+    step.data.dictionaryOnBitpack = {
+        buffers[buffers.size() - 2]->as<uint64_t>(),
+        static_cast<uint8_t>(bitWidth),
+        baseline,
+        nullptr};
+  }
+
+  decode(steps);
+  for (auto i = 0; i < steps.size(); ++i) {
+    auto* result = reinterpret_cast<int64_t*>(steps[i].result);
+    for (auto j = 0; j < kNumValues; ++j) {
+      ASSERT_EQ(expected[i][j], result[j]) << "step " << i << " at " << j;
+    }
+  }
+}
+
+TEST_F(GpuDecoderTest, dictionary) {
+  constexpr int32_t kNumValues = 5'000;
+  constexpr int32_t kBitWidth = 10;
+  std::vector<int32_t> dictionary(1 << kBitWidth);
+  for (auto i = 0; i < dictionary.size(); ++i) {
+    dictionary[i] = i * 31 - 1'000;
+  }
+  std::vector<uint64_t> indices(kNumValues);
+  for (auto i = 0; i < kNumValues; ++i) {
+    indices[i] = (i * 17) % dictionary.size();
+  }
+  auto input = bitpack(indices, kBitWidth);
+  auto dictionaryBuffer = copy(dictionary);
+  auto result = arena_->allocate<int32_t>(kNumValues);
+
+  std::vector<GpuDecode> steps(1);
+  steps[0].step = DecodeStep::kDictionaryOnBitpack;
+  steps[0].valueBytes = sizeof(int32_t);
+  steps[0].numValues = kNumValues;
+  steps[0].result = result->as<int32_t>();
+  steps[0].data.dictionaryOnBitpack = {
+      input->as<uint64_t>(), kBitWidth, 0, dictionaryBuffer->as<int32_t>()};
+  decode(steps);
+
+  for (auto i = 0; i < kNumValues; ++i) {
+    ASSERT_EQ(dictionary[indices[i]], result->as<int32_t>()[i]) << i;
+  }
+}
+
+TEST_F(GpuDecoderTest, rleAndTrivial) {
+  // More runs than threads in a block, some of them empty.
+  constexpr int32_t kNumRuns = 1'000;
+  std::vector<int64_t> runValues(kNumRuns);
+  std::vector<int32_t> lengths(kNumRuns);
+  std::vector<int64_t> expected;
+  for (auto i = 0; i < kNumRuns; ++i) {
+    runValues[i] = i * 1'000'003;
+    lengths[i] = i % 7 == 0 ? 0 : i % 13;
+    expected.insert(expected.end(), lengths[i], runValues[i]);
+  }
+  auto valuesBuffer = copy(runValues);
+  auto lengthsBuffer = copy(lengths);
+  auto rleResult = arena_->allocate<int64_t>(expected.size());
+  auto trivialInput = copy(expected);
+  auto trivialResult = arena_->allocate<int64_t>(expected.size());
+
+  std::vector<GpuDecode> steps(2);
+  steps[0].step = DecodeStep::kRle;
+  steps[0].valueBytes = sizeof(int64_t);
+  steps[0].numValues = expected.size();
+  steps[0].result = rleResult->as<int64_t>();
+  steps[0].data.rle = {
+      valuesBuffer->as<int64_t>(), lengthsBuffer->as<int32_t>(), kNumRuns};
+  steps[1].step = DecodeStep::kTrivial;
+  steps[1].valueBytes = sizeof(int64_t);
+  steps[1].numValues = expected.size();
+  steps[1].result = trivialResult->as<int64_t>();
+  steps[1].data.trivial = {trivialInput->as<int64_t>()};
+  decode(steps);
+
+  for (auto i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(expected[i], rleResult->as<int64_t>()[i]) << i;
+    ASSERT_EQ(expected[i], trivialResult->as<int64_t>()[i]) << i;
+  }
+}
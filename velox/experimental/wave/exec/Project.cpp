@@ -45,6 +45,9 @@ void Project::schedule(WaveStream& stream, int32_t maxRows) {
               control->operands,
               inputControl->status,
               control->sharedMemorySize);
+          for (auto* exe : exes) {
+            stream.markLaunch(*out, *exe);
+          }
         });
   }
 }
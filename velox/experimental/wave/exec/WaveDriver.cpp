@@ -15,9 +15,15 @@
  */
 
 #include "velox/experimental/wave/exec/WaveDriver.h"
+#include "velox/common/time/Timer.h"
 #include "velox/experimental/wave/exec/Instruction.h"
 #include "velox/experimental/wave/exec/WaveOperator.h"
 
+DEFINE_int32(
+    velox_wave_max_streams,
+    4,
+    "Maximum number of WaveStreams in flight per Wave pipeline");
+
 namespace facebook::velox::wave {
 
 WaveDriver::WaveDriver(
@@ -64,7 +70,12 @@ RowVectorPtr WaveDriver::getOutput() {
       auto& streams = pipelines_[i].streams;
       for (auto it = streams.begin(); it != streams.end();) {
         auto& stream = *it;
-        if (!stream->isArrived(lastSet)) {
+        bool arrived;
+        {
+          MicrosecondTimer timer(&waitUs_);
+          arrived = stream->isArrived(lastSet);
+        }
+        if (!arrived) {
           ++it;
           continue;
         }
@@ -73,6 +84,7 @@ RowVectorPtr WaveDriver::getOutput() {
           pipelines_[i + 1].operators[0]->enqueue(
               makeWaveResult(op.outputType(), *stream, lastSet));
         } else {
+          MicrosecondTimer timer(&resultUs_);
           result = makeResult(*stream, lastSet);
         }
         if (streamAtEnd(*stream)) {
@@ -82,6 +94,7 @@ RowVectorPtr WaveDriver::getOutput() {
         }
         if (result) {
           VLOG(1) << "Output size: " << result->size();
+          recordStats();
           return result;
         }
       }
@@ -92,6 +105,7 @@ RowVectorPtr WaveDriver::getOutput() {
     }
     if (!running) {
       VLOG(1) << "No more output";
+      recordStats();
       finished_ = true;
       return nullptr;
     }
@@ -141,9 +155,18 @@ RowVectorPtr WaveDriver::makeResult(
 }
 
 void WaveDriver::startMore() {
+  MicrosecondTimer timer(&scheduleUs_);
   for (int i = 0; i < pipelines_.size(); ++i) {
     auto& ops = pipelines_[i].operators;
-    if (auto rows = ops[0]->canAdvance()) {
+    auto& streams = pipelines_[i].streams;
+    // Keeps starting streams while the source has data so that the
+    // transfers and kernels of consecutive batches overlap.
+    bool started = false;
+    while (streams.size() < FLAGS_velox_wave_max_streams) {
+      auto rows = ops[0]->canAdvance();
+      if (!rows) {
+        break;
+      }
       auto stream = std::make_unique<WaveStream>(*arena_);
       for (auto& op : ops) {
         op->schedule(*stream, rows);
@@ -151,14 +174,48 @@ void WaveDriver::startMore() {
       if (i == pipelines_.size() - 1) {
         prefetchReturn(*stream);
       }
-      pipelines_[i].streams.push_back(std::move(stream));
+      streams.push_back(std::move(stream));
+      ++numStreams_;
+      started = true;
+    }
+    if (started) {
       break;
     }
   }
 }
 
 void WaveDriver::prefetchReturn(WaveStream& stream) {
-  // Schedule return buffers from last op to be on host side.
+  // The result buffers are in managed memory. Queues their migration to
+  // host after the kernels that produce them so that the copy overlaps
+  // with other streams and makeResult() does not fault them in page by
+  // page.
+  for (auto id : resultOrder_) {
+    auto exe = stream.operandExecutable(id);
+    if (!exe || !exe->stream) {
+      continue;
+    }
+    auto ordinal = exe->outputOperands.ordinal(id);
+    if (auto& vector = exe->output[ordinal]) {
+      vector->prefetch(*exe->stream, nullptr);
+    }
+  }
+}
+
+void WaveDriver::recordStats() {
+  auto recordTime = [&](const char* name, uint64_t& timeUs) {
+    if (timeUs) {
+      addRuntimeStat(
+          name, RuntimeCounter(timeUs * 1'000, RuntimeCounter::Unit::kNanos));
+      timeUs = 0;
+    }
+  };
+  recordTime("waveScheduleTime", scheduleUs_);
+  recordTime("waveWaitTime", waitUs_);
+  recordTime("waveResultTime", resultUs_);
+  if (numStreams_) {
+    addRuntimeStat("waveStreams", RuntimeCounter(numStreams_));
+    numStreams_ = 0;
+  }
 }
 
 LaunchControl* WaveDriver::inputControl(
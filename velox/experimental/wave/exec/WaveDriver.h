@@ -83,13 +83,16 @@ class WaveDriver : public exec::SourceOperator {
       WaveStream& stream,
       const OperandSet& lastSet);
 
-  // Starts another WaveStream if the source operator indicates it has more data
-  // and there is space in the arena.
+  // Starts WaveStreams while the source operator indicates it has more data
+  // and the pipeline has fewer than FLAGS_velox_wave_max_streams in flight.
   void startMore();
 
   // Enqueus a prefetch from device to host for the buffers of output vectors.
   void prefetchReturn(WaveStream& stream);
 
+  // Adds the times accumulated since the previous call to the runtime stats.
+  void recordStats();
+
   std::unique_ptr<GpuArena> arena_;
 
   ContinueFuture blockingFuture_{ContinueFuture::makeEmpty()};
@@ -97,6 +100,16 @@ class WaveDriver : public exec::SourceOperator {
 
   bool finished_{false};
 
+  // Time spent in scheduling work on streams, in polling for arrival and in
+  // converting results to Velox vectors. Flushed to runtime stats by
+  // recordStats().
+  uint64_t scheduleUs_{0};
+  uint64_t waitUs_{0};
+  uint64_t resultUs_{0};
+
+  // Number of WaveStreams started since the last recordStats().
+  uint64_t numStreams_{0};
+
   struct Pipeline {
     // Wave operators replacing 'cpuOperators_' on GPU path.
     std::vector<std::unique_ptr<WaveOperator>> operators;
@@ -63,6 +63,19 @@ void WaveVector::resize(vector_size_t size, bool nullable) {
   }
 }
 
+void WaveVector::prefetch(Stream& stream, Device* device) const {
+  for (auto* buffer : {&values_, &nulls_, &indices_, &lengths_, &offsets_}) {
+    if (*buffer) {
+      stream.prefetch(device, (*buffer)->as<char>(), (*buffer)->capacity());
+    }
+  }
+  for (auto& child : children_) {
+    if (child) {
+      child->prefetch(stream, device);
+    }
+  }
+}
+
 void WaveVector::toOperand(Operand* operand) const {
   operand->size = size_;
   operand->nulls = nulls_ ? nulls_->as<uint8_t>() : nullptr;
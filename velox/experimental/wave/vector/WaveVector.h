@@ -16,6 +16,7 @@
 
 #pragma once
 #include "velox/experimental/wave/common/Buffer.h"
+#include "velox/experimental/wave/common/Cuda.h"
 #include "velox/experimental/wave/common/GpuArena.h"
 #include "velox/experimental/wave/vector/Operand.h"
 #include "velox/vector/BaseVector.h"
@@ -105,6 +106,10 @@ class WaveVector {
   /// buffers stay live while referenced by Velox.
   VectorPtr toVelox(memory::MemoryPool* pool);
 
+  /// Enqueues a prefetch of the buffers of 'this' and its children on
+  /// 'stream'. Prefetches to host memory if 'device' is nullptr.
+  void prefetch(Stream& stream, Device* device) const;
+
   /// Sets 'operand' to point to the buffers of 'this'.
   void toOperand(Operand* operand) const;
 
@@ -14,10 +14,13 @@
  * limitations under the License.
  */
 #pragma once
+#include <folly/lang/Bits.h>
+
 #include "velox/common/base/Exceptions.h"
 #include "velox/core/CoreTypeSystem.h"
 #include "velox/expression/StringWriter.h"
 #include "velox/external/date/tz.h"
+#include "velox/type/TimestampConversion.h"
 #include "velox/type/Type.h"
 #include "velox/vector/SelectivityVector.h"
 
@@ -48,6 +51,88 @@ inline std::exception_ptr makeBadCastException(
       false));
 };
 
+// Returns true if the 8 bytes of 'chunk' are all ASCII digits.
+inline bool isEightDigits(uint64_t chunk) {
+  constexpr uint64_t kHighNibbles = 0xF0F0F0F0F0F0F0F0ULL;
+  constexpr uint64_t kZeros = 0x3030303030303030ULL;
+  return (chunk & kHighNibbles) == kZeros &&
+      ((chunk + 0x0606060606060606ULL) & kHighNibbles) == kZeros;
+}
+
+// Returns the value of the 8 ASCII digits in 'chunk', loaded little endian.
+// Combines pairs of adjacent digits, then pairs of pairs, then the halves.
+inline uint64_t parseEightDigits(uint64_t chunk) {
+  chunk -= 0x3030303030303030ULL;
+  chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FFULL;
+  chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFFULL;
+  return (chunk * 10000 + (chunk >> 32)) & 0xFFFFFFFFULL;
+}
+
+// Parses 'value' if it is an optional '-' followed by at most
+// std::numeric_limits<T>::digits10 decimal digits, which cannot overflow T.
+// Returns false for any other format. Such values are parsed by folly.
+template <typename T>
+bool tryParseDecimalDigits(const StringView& value, T& result) {
+  const char* data = value.data();
+  int32_t size = value.size();
+  const bool negative = size > 0 && data[0] == '-';
+  if (negative) {
+    ++data;
+    --size;
+  }
+  if (size == 0 || size > std::numeric_limits<T>::digits10) {
+    return false;
+  }
+  uint64_t magnitude = 0;
+  int32_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const auto chunk =
+        folly::Endian::little(folly::loadUnaligned<uint64_t>(data + i));
+    if (!isEightDigits(chunk)) {
+      return false;
+    }
+    magnitude = magnitude * 100'000'000 + parseEightDigits(chunk);
+  }
+  for (; i < size; ++i) {
+    const uint8_t digit = data[i] - '0';
+    if (digit > 9) {
+      return false;
+    }
+    magnitude = magnitude * 10 + digit;
+  }
+  const auto signedMagnitude = static_cast<int64_t>(magnitude);
+  result = static_cast<T>(negative ? -signedMagnitude : signedMagnitude);
+  return true;
+}
+
+// Parses 'value' if it is a valid date in the YYYY-MM-DD format. Returns
+// false for any other format or an invalid date.
+inline bool tryParseIsoDate(const StringView& value, int32_t& days) {
+  const char* data = value.data();
+  if (value.size() != 10 || data[4] != '-' || data[7] != '-') {
+    return false;
+  }
+  int32_t fields[3] = {};
+  const int32_t ends[3] = {4, 7, 10};
+  int32_t position = 0;
+  for (auto field = 0; field < 3; ++field) {
+    for (; position < ends[field]; ++position) {
+      const uint8_t digit = data[position] - '0';
+      if (digit > 9) {
+        return false;
+      }
+      fields[field] = fields[field] * 10 + digit;
+    }
+    // Skip the separator.
+    ++position;
+  }
+  if (!util::isValidDate(fields[0], fields[1], fields[2])) {
+    return false;
+  }
+  days = util::daysSinceEpochFromDate(fields[0], fields[1], fields[2]);
+  return true;
+}
+
 } // namespace
 
 template <bool adjustForTimeZone>
@@ -154,6 +239,51 @@ void CastExpr::applyCastKernel(
   }
 }
 
+template <TypeKind ToKind>
+void CastExpr::applyStringToNumberCast(
+    const SelectivityVector& rows,
+    exec::EvalCtx& context,
+    const BaseVector& input,
+    VectorPtr& result) {
+  using T = typename TypeTraits<ToKind>::NativeType;
+  auto* resultFlatVector = result->as<FlatVector<T>>();
+  auto* inputVector = input.as<SimpleVector<StringView>>();
+  auto& resultType = resultFlatVector->type();
+
+  // Invalid values are reported without throwing, with the same messages
+  // as the per-row kernel.
+  auto setError = [&](vector_size_t row, const std::string& details) {
+    if (setNullInResultAtError()) {
+      result->setNull(row, true);
+    } else {
+      context.setVeloxExceptionError(
+          row, makeBadCastException(resultType, input, row, details));
+    }
+  };
+
+  rows.applyToSelected([&](auto row) {
+    const auto value = inputVector->valueAt(row);
+    if (value.size() == 0) {
+      setError(row, "Empty string");
+      return;
+    }
+    if constexpr (std::is_integral_v<T>) {
+      T parsed;
+      if (tryParseDecimalDigits(value, parsed)) {
+        resultFlatVector->set(row, parsed);
+        return;
+      }
+    }
+    const folly::StringPiece piece(value);
+    auto parsed = folly::tryTo<T>(piece);
+    if (parsed.hasValue()) {
+      resultFlatVector->set(row, parsed.value());
+    } else {
+      setError(row, folly::makeConversionError(parsed.error(), piece).what());
+    }
+  });
+}
+
 template <typename TInput, typename TOutput>
 void CastExpr::applyDecimalCastKernel(
     const SelectivityVector& rows,
@@ -360,6 +490,18 @@ void CastExpr::applyCastPrimitives(
     }
   };
 
+  if constexpr (
+      (FromKind == TypeKind::VARCHAR || FromKind == TypeKind::VARBINARY) &&
+      (ToKind == TypeKind::TINYINT || ToKind == TypeKind::SMALLINT ||
+       ToKind == TypeKind::INTEGER || ToKind == TypeKind::BIGINT ||
+       ToKind == TypeKind::REAL || ToKind == TypeKind::DOUBLE)) {
+    // Casts from strings to floating point values do not truncate.
+    if (!std::is_integral_v<To> || !queryConfig.isCastToIntByTruncate()) {
+      applyStringToNumberCast<ToKind>(rows, context, input, result);
+      return;
+    }
+  }
+
   if (!queryConfig.isCastToIntByTruncate()) {
     applyToSelectedNoThrowLocal(context, rows, result, [&](int row) {
       try {
@@ -104,8 +104,15 @@ VectorPtr CastExpr::castToDate(
     case TypeKind::VARCHAR: {
       auto* inputVector = input.as<SimpleVector<StringView>>();
       applyToSelectedNoThrowLocal(context, rows, castResult, [&](int row) {
+        auto inputString = inputVector->valueAt(row);
+        // Parse the common YYYY-MM-DD format without the general parser,
+        // which throws for invalid dates.
+        int32_t days;
+        if (tryParseIsoDate(inputString, days)) {
+          resultFlatVector->set(row, days);
+          return;
+        }
         try {
-          auto inputString = inputVector->valueAt(row);
           resultFlatVector->set(row, DATE()->toDays(inputString));
         } catch (const VeloxException& ue) {
           if (!ue.isUserError()) {
@@ -182,6 +182,16 @@ class CastExpr : public SpecialForm {
       const SimpleVector<typename TypeTraits<FromKind>::NativeType>* input,
       FlatVector<typename TypeTraits<ToKind>::NativeType>* result);
 
+  /// Casts strings to integer or floating point values. Strings of decimal
+  /// digits are parsed 8 digits at a time and other strings by folly. Does
+  /// not throw for invalid strings.
+  template <TypeKind ToKind>
+  void applyStringToNumberCast(
+      const SelectivityVector& rows,
+      exec::EvalCtx& context,
+      const BaseVector& input,
+      VectorPtr& result);
+
   VectorPtr castFromDate(
       const SelectivityVector& rows,
       const BaseVector& input,
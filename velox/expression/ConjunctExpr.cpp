@@ -162,18 +162,23 @@ void ConjunctExpr::evalSpecialForm(
   // Clear errors for 'rows' that are not in 'activeRows'.
   finalizeErrors(rows, *activeRows, throwOnError, context);
   if (!reorderEnabledChecked_) {
-    reorderEnabled_ = context.execCtx()
-                          ->queryCtx()
-                          ->queryConfig()
-                          .adaptiveFilterReorderingEnabled();
+    const auto& config = context.execCtx()->queryCtx()->queryConfig();
+    reorderEnabled_ = config.adaptiveFilterReorderingEnabled();
+    reorderInterval_ = std::max(1, config.adaptiveFilterReorderingInterval());
     reorderEnabledChecked_ = true;
   }
-  if (reorderEnabled_) {
+  if (reorderEnabled_ && inputs_.size() > 1 && --batchesToReorder_ == 0) {
     maybeReorderInputs();
+    batchesToReorder_ = reorderInterval_;
   }
 }
 
 void ConjunctExpr::maybeReorderInputs() {
+  // Halve the measurements so that the order follows changes in the cost and
+  // selectivity of the inputs, e.g. from one file or partition to the next.
+  for (auto& selectivity : selectivity_) {
+    selectivity.halve();
+  }
   bool reorder = false;
   for (auto i = 1; i < inputs_.size(); ++i) {
     if (selectivity_[inputOrder_[i - 1]].timeToDropValue() >
@@ -64,6 +64,11 @@ class ConjunctExpr : public SpecialForm {
     return selectivity_[inputOrder_[index]];
   }
 
+  /// Returns the input evaluated 'index'th.
+  const ExprPtr& inputAt(int32_t index) const {
+    return inputs_[inputOrder_[index]];
+  }
+
   std::string toSql(
       std::vector<VectorPtr>* complexConstants = nullptr) const override;
 
@@ -92,6 +97,11 @@ class ConjunctExpr : public SpecialForm {
   BufferPtr tempNulls_;
   bool reorderEnabledChecked_ = false;
   bool reorderEnabled_;
+  // Number of batches between calls to maybeReorderInputs().
+  int32_t reorderInterval_;
+  // Number of batches left before the next call to maybeReorderInputs(). The
+  // first call is after the first batch.
+  int32_t batchesToReorder_{1};
   std::vector<SelectivityInfo> selectivity_;
   std::vector<int32_t> inputOrder_;
 
@@ -269,6 +269,14 @@ class EvalCtx {
     return execCtx_->vectorPool();
   }
 
+  /// Returns uninitialized space for 'count' values of T that is valid until
+  /// evaluation of the next batch starts. See ExecCtx::allocateScratch().
+  template <typename T>
+  T* FOLLY_NONNULL allocateScratch(vector_size_t count) {
+    return reinterpret_cast<T*>(
+        execCtx_->allocateScratch(count * sizeof(T), alignof(T)));
+  }
+
   VectorPtr getVector(const TypePtr& type, vector_size_t size) {
     return execCtx_->getVector(type, size);
   }
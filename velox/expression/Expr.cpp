@@ -21,6 +21,7 @@
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/Fs.h"
 #include "velox/common/base/SuccinctPrinter.h"
+#include "velox/common/process/ThreadDebugInfo.h"
 #include "velox/common/testutil/TestValue.h"
 #include "velox/core/Expressions.h"
 #include "velox/expression/CastExpr.h"
@@ -704,6 +705,7 @@ void Expr::evalFlatNoNulls(
     EvalCtx& context,
     VectorPtr& result,
     const ExprSet* parentExprSet) {
+  process::ScopedProfileFrame profileFrame(profileName_, name_);
   if (shouldEvaluateSharedSubexp()) {
     evaluateSharedSubexpr(
         rows,
@@ -768,6 +770,7 @@ void Expr::eval(
     EvalCtx& context,
     VectorPtr& result,
     const ExprSet* parentExprSet) {
+  process::ScopedProfileFrame profileFrame(profileName_, name_);
   if (supportsFlatNoNullsFastPath_ && context.throwOnError() &&
       context.inputFlatNoNulls() && rows.countSelected() < 1'000) {
     evalFlatNoNulls(rows, context, result, parentExprSet);
@@ -1174,23 +1177,31 @@ void Expr::evalWithMemo(
   VectorPtr base;
   distinctFields_[0]->evalSpecialForm(rows, context, base);
   ++numCachableInput_;
-  if (baseDictionary_ == base) {
+  auto it = std::find_if(
+      dictionaryMemos_.begin(),
+      dictionaryMemos_.end(),
+      [&](const auto& memo) { return memo.baseDictionary == base; });
+  if (it != dictionaryMemos_.end()) {
     ++numCacheableRepeats_;
-    if (cachedDictionaryIndices_) {
+    std::rotate(dictionaryMemos_.begin(), it, it + 1);
+    auto& memo = dictionaryMemos_.front();
+    auto& cachedDictionaryIndices = memo.cachedDictionaryIndices;
+    auto& dictionaryCache = memo.dictionaryCache;
+    if (cachedDictionaryIndices) {
       LocalSelectivityVector cachedHolder(context, rows);
       auto cached = cachedHolder.get();
       VELOX_DCHECK(cached != nullptr);
-      cached->intersect(*cachedDictionaryIndices_);
+      cached->intersect(*cachedDictionaryIndices);
       if (cached->hasSelections()) {
         context.ensureWritable(rows, type(), result);
-        result->copy(dictionaryCache_.get(), *cached, nullptr);
+        result->copy(dictionaryCache.get(), *cached, nullptr);
       }
     }
     LocalSelectivityVector uncachedHolder(context, rows);
     auto uncached = uncachedHolder.get();
     VELOX_DCHECK(uncached != nullptr);
-    if (cachedDictionaryIndices_) {
-      uncached->deselect(*cachedDictionaryIndices_);
+    if (cachedDictionaryIndices) {
+      uncached->deselect(*cachedDictionaryIndices);
     }
     if (uncached->hasSelections()) {
       // Fix finalSelection at "rows" if uncached rows is a strict subset to
@@ -1204,44 +1215,52 @@ void Expr::evalWithMemo(
       context.exprSet()->addToMemo(this);
       auto newCacheSize = uncached->end();
 
-      // dictionaryCache_ is valid only for cachedDictionaryIndices_. Hence, a
+      // dictionaryCache is valid only for cachedDictionaryIndices. Hence, a
       // safe call to BaseVector::ensureWritable must include all the rows not
-      // covered by cachedDictionaryIndices_. If BaseVector::ensureWritable is
+      // covered by cachedDictionaryIndices. If BaseVector::ensureWritable is
       // called only for a subset of rows not covered by
-      // cachedDictionaryIndices_, it will attempt to copy rows that are not
+      // cachedDictionaryIndices, it will attempt to copy rows that are not
       // valid leading to a crash.
-      LocalSelectivityVector allUncached(context, dictionaryCache_->size());
+      LocalSelectivityVector allUncached(context, dictionaryCache->size());
       allUncached.get()->setAll();
-      allUncached.get()->deselect(*cachedDictionaryIndices_);
-      context.ensureWritable(*allUncached.get(), type(), dictionaryCache_);
+      allUncached.get()->deselect(*cachedDictionaryIndices);
+      context.ensureWritable(*allUncached.get(), type(), dictionaryCache);
 
-      if (cachedDictionaryIndices_->size() < newCacheSize) {
-        cachedDictionaryIndices_->resize(newCacheSize, false);
+      if (cachedDictionaryIndices->size() < newCacheSize) {
+        cachedDictionaryIndices->resize(newCacheSize, false);
       }
 
-      cachedDictionaryIndices_->select(*uncached);
+      cachedDictionaryIndices->select(*uncached);
 
-      // Resize the dictionaryCache_ to accommodate all the necessary rows.
-      if (dictionaryCache_->size() < uncached->end()) {
-        dictionaryCache_->resize(uncached->end());
+      // Resize the dictionaryCache to accommodate all the necessary rows.
+      if (dictionaryCache->size() < uncached->end()) {
+        dictionaryCache->resize(uncached->end());
       }
-      dictionaryCache_->copy(result.get(), *uncached, nullptr);
+      dictionaryCache->copy(result.get(), *uncached, nullptr);
     }
     context.releaseVector(base);
     return;
   }
-  context.releaseVector(baseDictionary_);
-  baseDictionary_ = base;
+  // Evict the least recently seen base dictionary and reuse its indices.
+  DictionaryMemo memo;
+  if (dictionaryMemos_.size() == kMaxDictionaryMemos) {
+    auto& oldest = dictionaryMemos_.back();
+    context.releaseVector(oldest.baseDictionary);
+    context.releaseVector(oldest.dictionaryCache);
+    memo.cachedDictionaryIndices = std::move(oldest.cachedDictionaryIndices);
+    dictionaryMemos_.pop_back();
+  }
+  memo.baseDictionary = base;
   evalWithNulls(rows, context, result);
 
-  context.releaseVector(dictionaryCache_);
-  dictionaryCache_ = result;
-  if (!cachedDictionaryIndices_) {
-    cachedDictionaryIndices_ =
+  memo.dictionaryCache = result;
+  if (!memo.cachedDictionaryIndices) {
+    memo.cachedDictionaryIndices =
         context.execCtx()->getSelectivityVector(rows.end());
   }
-  *cachedDictionaryIndices_ = rows;
-  context.deselectErrors(*cachedDictionaryIndices_);
+  *memo.cachedDictionaryIndices = rows;
+  context.deselectErrors(*memo.cachedDictionaryIndices);
+  dictionaryMemos_.insert(dictionaryMemos_.begin(), std::move(memo));
 }
 
 void Expr::setAllNulls(
@@ -1826,6 +1845,7 @@ void ExprSet::eval(
   result.resize(exprs_.size());
   if (initialize) {
     clearSharedSubexprs();
+    context.execCtx()->resetScratch();
   }
 
   // Make sure LazyVectors, referenced by multiple expressions, are loaded
@@ -1869,6 +1889,7 @@ void ExprSetSimplified::eval(
   result.resize(exprs_.size());
   if (initialize) {
     clearSharedSubexprs();
+    context.execCtx()->resetScratch();
   }
   for (int32_t i = begin; i < end; ++i) {
     exprs_[i]->evalSimplified(rows, context, result[i]);
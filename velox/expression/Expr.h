@@ -244,9 +244,7 @@ class Expr {
   }
 
   void clearMemo() {
-    baseDictionary_ = nullptr;
-    dictionaryCache_ = nullptr;
-    cachedDictionaryIndices_ = nullptr;
+    dictionaryMemos_.clear();
   }
 
   const TypePtr& type() const {
@@ -556,6 +554,10 @@ class Expr {
   const bool supportsFlatNoNullsFastPath_;
   const bool trackCpuUsage_;
 
+  // Interned copy of 'name_' pushed to the thread's ProfileFrames while
+  // 'this' is evaluated. Set on first use by a profiled thread.
+  const char* profileName_{nullptr};
+
   std::vector<VectorPtr> constantInputs_;
   std::vector<bool> inputIsConstant_;
 
@@ -596,14 +598,26 @@ class Expr {
   // evaluateSharedSubexpr() is called to the cached shared results.
   std::map<std::vector<const BaseVector*>, SharedResults> sharedSubexprResults_;
 
-  VectorPtr baseDictionary_;
+  struct DictionaryMemo {
+    VectorPtr baseDictionary;
+
+    // Values computed for the base dictionary, 1:1 to the positions in
+    // 'baseDictionary'.
+    VectorPtr dictionaryCache;
+
+    // The indices that are valid in 'dictionaryCache'.
+    std::unique_ptr<SelectivityVector> cachedDictionaryIndices;
+  };
 
-  // Values computed for the base dictionary, 1:1 to the positions in
-  // 'baseDictionary_'.
-  VectorPtr dictionaryCache_;
+  // Maximum number of base dictionaries with cached results. A reader may
+  // alternate between dictionaries in consecutive batches, e.g. a DWRF string
+  // column between the stripe dictionary and the stripe dictionary combined
+  // with a stride dictionary.
+  static constexpr int32_t kMaxDictionaryMemos = 2;
 
-  // The indices that are valid in 'dictionaryCache_'.
-  std::unique_ptr<SelectivityVector> cachedDictionaryIndices_;
+  // Cached results for the most recently seen base dictionaries, most recent
+  // first.
+  std::vector<DictionaryMemo> dictionaryMemos_;
 
   // Count of executions where this is wrapped in a dictionary so that
   // results could be cached.
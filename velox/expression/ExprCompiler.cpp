@@ -21,7 +21,9 @@
 #include "velox/expression/ConstantExpr.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/FieldReference.h"
+#include "velox/expression/FusedExpr.h"
 #include "velox/expression/LambdaExpr.h"
+#include "velox/expression/PreparedExprCache.h"
 #include "velox/expression/SimpleFunctionRegistry.h"
 #include "velox/expression/SpecialFormRegistry.h"
 #include "velox/expression/SwitchExpr.h"
@@ -379,6 +381,19 @@ core::TypedExprPtr rewriteExpression(const core::TypedExprPtr& expr) {
   return expr;
 }
 
+std::vector<TypedExprPtr> rewriteExpressionSet(
+    const std::vector<TypedExprPtr>& exprs) {
+  auto result = exprs;
+  for (auto& rewrite : expressionSetRewrites()) {
+    auto rewritten = rewrite(result);
+    if (!rewritten.empty()) {
+      VELOX_CHECK_EQ(rewritten.size(), result.size());
+      result = std::move(rewritten);
+    }
+  }
+  return result;
+}
+
 ExprPtr compileRewrittenExpression(
     const TypedExprPtr& expr,
     Scope* scope,
@@ -530,6 +545,11 @@ ExprPtr compileRewrittenExpression(
   auto folded = enableConstantFolding && !isConstantExpr
       ? tryFoldIfConstant(result, scope)
       : result;
+  if (config.exprFuseFloatingPointArithmetic()) {
+    if (auto fused = FusedExpr::tryFuse(folded, trackCpuUsage)) {
+      folded = fused;
+    }
+  }
   scope->visited[expr.get()] = folded;
   return folded;
 }
@@ -587,13 +607,124 @@ std::unordered_set<std::string> collectFlatteningCandidates(
     return flatteningCandidates;
   });
 }
+
+// Returns a copy of 'expr' with 'inputs' or nullptr if 'expr' is not a kind
+// that prepareExpressions() folds.
+TypedExprPtr withInputs(
+    const TypedExprPtr& expr,
+    std::vector<TypedExprPtr> inputs) {
+  if (auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get())) {
+    return std::make_shared<core::CallTypedExpr>(
+        expr->type(), std::move(inputs), call->name());
+  }
+  if (auto cast = dynamic_cast<const core::CastTypedExpr*>(expr.get())) {
+    return std::make_shared<core::CastTypedExpr>(
+        expr->type(), inputs, cast->nullOnFailure());
+  }
+  if (dynamic_cast<const core::ConcatTypedExpr*>(expr.get())) {
+    return std::make_shared<core::ConcatTypedExpr>(
+        asRowType(expr->type())->names(), inputs);
+  }
+  if (auto dereference =
+          dynamic_cast<const core::DereferenceTypedExpr*>(expr.get())) {
+    return std::make_shared<core::DereferenceTypedExpr>(
+        expr->type(), inputs[0], dereference->index());
+  }
+  if (auto access =
+          dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get())) {
+    if (!access->isInputColumn()) {
+      return std::make_shared<core::FieldAccessTypedExpr>(
+          expr->type(), inputs[0], access->name());
+    }
+  }
+  return nullptr;
+}
+
+// Returns the value of 'expr' if it compiles to a constant.
+VectorPtr tryEvaluateConstant(
+    const TypedExprPtr& expr,
+    core::ExecCtx* execCtx) {
+  try {
+    ExprSet exprSet({expr}, execCtx);
+    if (auto constant =
+            std::dynamic_pointer_cast<ConstantExpr>(exprSet.exprs()[0])) {
+      return constant->value();
+    }
+  } catch (const VeloxUserError&) {
+    // Left to the compilation of the expression to report.
+  }
+  return nullptr;
+}
+
+TypedExprPtr foldConstantInputs(
+    const TypedExprPtr& expr,
+    core::ExecCtx* execCtx,
+    std::unordered_map<const ITypedExpr*, TypedExprPtr>& folded) {
+  if (expr->inputs().empty() ||
+      dynamic_cast<const core::LambdaTypedExpr*>(expr.get())) {
+    return expr;
+  }
+  auto it = folded.find(expr.get());
+  if (it != folded.end()) {
+    return it->second;
+  }
+
+  std::vector<TypedExprPtr> inputs;
+  inputs.reserve(expr->inputs().size());
+  bool changed = false;
+  bool allConstant = true;
+  for (const auto& input : expr->inputs()) {
+    inputs.push_back(foldConstantInputs(input, execCtx, folded));
+    changed |= inputs.back() != input;
+    allConstant &=
+        dynamic_cast<const core::ConstantTypedExpr*>(inputs.back().get()) !=
+        nullptr;
+  }
+
+  auto result = withInputs(expr, std::move(inputs));
+  if (result == nullptr) {
+    folded[expr.get()] = expr;
+    return expr;
+  }
+  if (!changed) {
+    result = expr;
+  }
+  if (allConstant) {
+    if (auto value = tryEvaluateConstant(result, execCtx)) {
+      result = std::make_shared<core::ConstantTypedExpr>(value);
+    }
+  }
+  folded[expr.get()] = result;
+  return result;
+}
 } // namespace
 
 std::vector<std::shared_ptr<Expr>> compileExpressions(
-    const std::vector<TypedExprPtr>& sources,
+    const std::vector<TypedExprPtr>& inputSources,
     core::ExecCtx* execCtx,
     ExprSet* exprSet,
     bool enableConstantFolding) {
+  const auto& config = execCtx->queryCtx()->queryConfig();
+  if (enableConstantFolding && config.exprPreparedCacheEnabled()) {
+    // The prepared expressions are rewritten already.
+    const auto prepared =
+        PreparedExprCache::instance().get(inputSources, config);
+    Scope scope({}, nullptr, exprSet);
+    std::vector<std::shared_ptr<Expr>> exprs;
+    exprs.reserve(prepared->exprs.size());
+    for (const auto& source : prepared->exprs) {
+      exprs.push_back(compileRewrittenExpression(
+          source,
+          &scope,
+          config,
+          execCtx->pool(),
+          prepared->flatteningCandidates,
+          true));
+    }
+    return exprs;
+  }
+
+  auto sources = rewriteExpressionSet(inputSources);
   Scope scope({}, nullptr, exprSet);
   std::vector<std::shared_ptr<Expr>> exprs;
   exprs.reserve(sources.size());
@@ -614,4 +745,20 @@ std::vector<std::shared_ptr<Expr>> compileExpressions(
   return exprs;
 }
 
+PreparedExprs prepareExpressions(
+    const std::vector<TypedExprPtr>& inputSources,
+    core::ExecCtx* execCtx) {
+  auto sources = rewriteExpressionSet(inputSources);
+  PreparedExprs prepared;
+  prepared.flatteningCandidates = collectFlatteningCandidates(sources);
+  prepared.exprs.reserve(sources.size());
+  std::unordered_map<const ITypedExpr*, TypedExprPtr> folded;
+  for (auto& source : sources) {
+    auto rewritten = rewriteExpression(source);
+    prepared.exprs.push_back(foldConstantInputs(
+        rewritten == nullptr ? source : rewritten, execCtx, folded));
+  }
+  return prepared;
+}
+
 } // namespace facebook::velox::exec
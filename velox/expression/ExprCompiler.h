@@ -17,6 +17,7 @@
 #pragma once
 
 #include <memory>
+#include <unordered_set>
 #include "velox/core/Expressions.h"
 #include "velox/core/QueryCtx.h"
 
@@ -31,4 +32,20 @@ std::vector<std::shared_ptr<Expr>> compileExpressions(
     ExprSet* exprSet,
     bool enableConstantFolding = true);
 
+/// Expressions of an ExprSet after the expression set and expression rewrites
+/// and with constant subexpressions replaced by their values.
+struct PreparedExprs {
+  std::vector<core::TypedExprPtr> exprs;
+
+  /// Names of the called functions that support flattening.
+  std::unordered_set<std::string> flatteningCandidates;
+};
+
+/// Rewrites 'sources' and replaces the calls, casts and field accesses whose
+/// inputs are all constant by their values evaluated with 'execCtx'. Calls
+/// without inputs are kept. Used by PreparedExprCache.
+PreparedExprs prepareExpressions(
+    const std::vector<core::TypedExprPtr>& sources,
+    core::ExecCtx* execCtx);
+
 } // namespace facebook::velox::exec
@@ -453,49 +453,269 @@ std::unique_ptr<common::Filter> makeBetweenFilter(
   }
 }
 
-} // namespace
+bool isComparison(const std::string& name) {
+  return name == "eq" || name == "neq" || name == "lt" || name == "lte" ||
+      name == "gt" || name == "gte";
+}
 
-std::unique_ptr<common::Filter> leafCallToSubfieldFilter(
-    const core::CallTypedExpr& call,
+// Returns the comparison that is equivalent to 'name' with the arguments
+// swapped, e.g. 5 < a is the same as a > 5.
+std::string flipComparison(const std::string& name) {
+  if (name == "lt") {
+    return "gt";
+  }
+  if (name == "lte") {
+    return "gte";
+  }
+  if (name == "gt") {
+    return "lt";
+  }
+  if (name == "gte") {
+    return "lte";
+  }
+  return name;
+}
+
+bool isIntegralKind(TypeKind kind) {
+  return kind == TypeKind::TINYINT || kind == TypeKind::SMALLINT ||
+      kind == TypeKind::INTEGER || kind == TypeKind::BIGINT;
+}
+
+core::TypedExprPtr makeCall(
+    const std::string& name,
+    const TypePtr& type,
+    const core::TypedExprPtr& left,
+    const core::TypedExprPtr& right) {
+  return std::make_shared<core::CallTypedExpr>(
+      type, std::vector<core::TypedExprPtr>{left, right}, name);
+}
+
+int64_t countUtf8Characters(const std::string& value) {
+  int64_t count = 0;
+  for (auto c : value) {
+    count += (c & 0xC0) != 0x80;
+  }
+  return count;
+}
+
+// Returns a filter that passes strings that start with 'prefix'. These are the
+// strings in [prefix, next) where 'next' is the smallest string greater than
+// all strings starting with 'prefix'.
+std::unique_ptr<common::Filter> makePrefixFilter(const std::string& prefix) {
+  auto next = prefix;
+  while (!next.empty() && static_cast<uint8_t>(next.back()) == 0xFF) {
+    next.pop_back();
+  }
+  if (next.empty()) {
+    return greaterThanOrEqual(prefix);
+  }
+  ++next.back();
+  return std::make_unique<common::BytesRange>(
+      prefix, false, false, next, false, true, false);
+}
+
+std::unique_ptr<common::Filter> makeComparisonFilter(
+    const std::string& name,
+    const core::TypedExprPtr& left,
+    const core::TypedExprPtr& right,
+    common::Subfield& subfield,
+    core::ExpressionEvaluator* evaluator,
+    bool negated);
+
+// Converts substr(a, 1, n) = 'value' into a filter on 'a'. If 'value' has n
+// characters this matches strings starting with 'value'. If it has fewer, the
+// whole string must be equal to 'value'.
+std::unique_ptr<common::Filter> makeSubstrEqualFilter(
+    const core::CallTypedExpr& substr,
+    const core::TypedExprPtr& right,
+    common::Subfield& subfield,
+    core::ExpressionEvaluator* evaluator) {
+  if (substr.inputs().size() != 3 || !substr.type()->isVarchar()) {
+    return nullptr;
+  }
+  auto start = toConstant(substr.inputs()[1], evaluator);
+  auto length = toConstant(substr.inputs()[2], evaluator);
+  auto value = toConstant(right, evaluator);
+  if (!start || !length || !value || start->isNullAt(0) ||
+      length->isNullAt(0) || value->isNullAt(0) ||
+      start->typeKind() != TypeKind::BIGINT ||
+      length->typeKind() != TypeKind::BIGINT) {
+    return nullptr;
+  }
+  if (singleValue<int64_t>(start) != 1 || singleValue<int64_t>(length) <= 0) {
+    return nullptr;
+  }
+  if (!toSubfield(substr.inputs()[0].get(), subfield)) {
+    return nullptr;
+  }
+
+  const auto prefix = singleValue<StringView>(value).str();
+  const auto numCharacters = countUtf8Characters(prefix);
+  if (numCharacters == singleValue<int64_t>(length)) {
+    return makePrefixFilter(prefix);
+  }
+  if (numCharacters < singleValue<int64_t>(length)) {
+    return equal(prefix);
+  }
+  return nullptr;
+}
+
+// Converts coalesce(a, fallback) <op> value into a filter on 'a' that passes
+// nulls if fallback <op> value is true.
+std::unique_ptr<common::Filter> makeCoalesceComparisonFilter(
+    const std::string& name,
+    const core::CallTypedExpr& coalesce,
+    const core::TypedExprPtr& right,
     common::Subfield& subfield,
     core::ExpressionEvaluator* evaluator,
     bool negated) {
-  if (call.inputs().empty()) {
+  if (coalesce.inputs().size() != 2) {
+    return nullptr;
+  }
+  auto filter = makeComparisonFilter(
+      name, coalesce.inputs()[0], right, subfield, evaluator, negated);
+  if (!filter) {
     return nullptr;
   }
+  auto fallback = toConstant(
+      makeCall(name, BOOLEAN(), coalesce.inputs()[1], right), evaluator);
+  if (!fallback || fallback->isNullAt(0)) {
+    return nullptr;
+  }
+  return filter->clone(singleValue<bool>(fallback) != negated);
+}
 
-  const auto* leftSide = call.inputs()[0].get();
+// Converts a + c <op> value, c + a <op> value and a - c <op> value on integers
+// into a <op> value - c or a <op> value + c. The new bound is folded into a
+// constant, which fails and leaves the expression alone if it overflows. Rows
+// for which a + c itself would overflow are filtered out instead of raising an
+// error.
+std::unique_ptr<common::Filter> makeArithmeticComparisonFilter(
+    const std::string& name,
+    const core::CallTypedExpr& arithmetic,
+    const core::TypedExprPtr& right,
+    common::Subfield& subfield,
+    core::ExpressionEvaluator* evaluator,
+    bool negated) {
+  const auto& type = arithmetic.type();
+  if (arithmetic.inputs().size() != 2 || !isIntegralKind(type->kind())) {
+    return nullptr;
+  }
+  const auto& lhs = arithmetic.inputs()[0];
+  const auto& rhs = arithmetic.inputs()[1];
+  if (*lhs->type() != *type || *rhs->type() != *type) {
+    return nullptr;
+  }
 
-  if (call.name() == "eq") {
-    if (toSubfield(leftSide, subfield)) {
-      return negated ? makeNotEqualFilter(call.inputs()[1], evaluator)
-                     : makeEqualFilter(call.inputs()[1], evaluator);
+  if (arithmetic.name() == "plus") {
+    if (auto filter = makeComparisonFilter(
+            name,
+            lhs,
+            makeCall("minus", type, right, rhs),
+            subfield,
+            evaluator,
+            negated)) {
+      return filter;
     }
-  } else if (call.name() == "neq") {
-    if (toSubfield(leftSide, subfield)) {
-      return negated ? makeEqualFilter(call.inputs()[1], evaluator)
-                     : makeNotEqualFilter(call.inputs()[1], evaluator);
+    return makeComparisonFilter(
+        name,
+        rhs,
+        makeCall("minus", type, right, lhs),
+        subfield,
+        evaluator,
+        negated);
+  }
+  return makeComparisonFilter(
+      name,
+      lhs,
+      makeCall("plus", type, right, rhs),
+      subfield,
+      evaluator,
+      negated);
+}
+
+// Makes a filter for left <op> right where 'left' is a subfield, or an
+// expression over a subfield that can be inverted, and 'right' is constant.
+std::unique_ptr<common::Filter> makeComparisonFilter(
+    const std::string& name,
+    const core::TypedExprPtr& left,
+    const core::TypedExprPtr& right,
+    common::Subfield& subfield,
+    core::ExpressionEvaluator* evaluator,
+    bool negated) {
+  if (toSubfield(left.get(), subfield)) {
+    if (name == "eq") {
+      return negated ? makeNotEqualFilter(right, evaluator)
+                     : makeEqualFilter(right, evaluator);
     }
-  } else if (call.name() == "lte") {
-    if (toSubfield(leftSide, subfield)) {
-      return negated ? makeGreaterThanFilter(call.inputs()[1], evaluator)
-                     : makeLessThanOrEqualFilter(call.inputs()[1], evaluator);
+    if (name == "neq") {
+      return negated ? makeEqualFilter(right, evaluator)
+                     : makeNotEqualFilter(right, evaluator);
     }
-  } else if (call.name() == "lt") {
-    if (toSubfield(leftSide, subfield)) {
-      return negated ? makeGreaterThanOrEqualFilter(call.inputs()[1], evaluator)
-                     : makeLessThanFilter(call.inputs()[1], evaluator);
+    if (name == "lte") {
+      return negated ? makeGreaterThanFilter(right, evaluator)
+                     : makeLessThanOrEqualFilter(right, evaluator);
     }
-  } else if (call.name() == "gte") {
-    if (toSubfield(leftSide, subfield)) {
-      return negated
-          ? makeLessThanFilter(call.inputs()[1], evaluator)
-          : makeGreaterThanOrEqualFilter(call.inputs()[1], evaluator);
+    if (name == "lt") {
+      return negated ? makeGreaterThanOrEqualFilter(right, evaluator)
+                     : makeLessThanFilter(right, evaluator);
     }
-  } else if (call.name() == "gt") {
-    if (toSubfield(leftSide, subfield)) {
-      return negated ? makeLessThanOrEqualFilter(call.inputs()[1], evaluator)
-                     : makeGreaterThanFilter(call.inputs()[1], evaluator);
+    if (name == "gte") {
+      return negated ? makeLessThanFilter(right, evaluator)
+                     : makeGreaterThanOrEqualFilter(right, evaluator);
+    }
+    if (name == "gt") {
+      return negated ? makeLessThanOrEqualFilter(right, evaluator)
+                     : makeGreaterThanFilter(right, evaluator);
+    }
+    return nullptr;
+  }
+
+  if (toSubfield(right.get(), subfield)) {
+    return makeComparisonFilter(
+        flipComparison(name), right, left, subfield, evaluator, negated);
+  }
+
+  auto* call = asCall(left.get());
+  if (!call) {
+    return nullptr;
+  }
+  if (call->name() == "coalesce") {
+    return makeCoalesceComparisonFilter(
+        name, *call, right, subfield, evaluator, negated);
+  }
+  if (call->name() == "plus" || call->name() == "minus") {
+    return makeArithmeticComparisonFilter(
+        name, *call, right, subfield, evaluator, negated);
+  }
+  if (call->name() == "substr" && name == "eq" && !negated) {
+    return makeSubstrEqualFilter(*call, right, subfield, evaluator);
+  }
+  return nullptr;
+}
+
+} // namespace
+
+std::unique_ptr<common::Filter> leafCallToSubfieldFilter(
+    const core::CallTypedExpr& call,
+    common::Subfield& subfield,
+    core::ExpressionEvaluator* evaluator,
+    bool negated) {
+  if (call.inputs().empty()) {
+    return nullptr;
+  }
+
+  const auto* leftSide = call.inputs()[0].get();
+
+  if (isComparison(call.name())) {
+    if (call.inputs().size() == 2) {
+      return makeComparisonFilter(
+          call.name(),
+          call.inputs()[0],
+          call.inputs()[1],
+          subfield,
+          evaluator,
+          negated);
     }
   } else if (call.name() == "between") {
     if (toSubfield(leftSide, subfield)) {
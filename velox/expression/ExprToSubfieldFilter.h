@@ -380,6 +380,10 @@ std::pair<common::Subfield, std::unique_ptr<common::Filter>> toSubfieldFilter(
 /// because this conversion is frequently applied when extracting filters from
 /// remaining filter in readers.  Frequent throw clutters logs and slows down
 /// execution.
+///
+/// Besides comparisons of a subfield with a constant, this handles constants on
+/// the left side, coalesce(a, constant), integer a + constant and a - constant,
+/// and substr(a, 1, n) = constant.
 std::unique_ptr<common::Filter> leafCallToSubfieldFilter(
     const core::CallTypedExpr&,
     common::Subfield&,
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/expression/FusedExpr.h"
+#include "velox/expression/ConstantExpr.h"
+#include "velox/expression/FieldReference.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+
+template <typename TOperand, typename TResult, typename F>
+void applyBinary(
+    const TOperand& left,
+    const TOperand& right,
+    int32_t numRows,
+    TResult* result,
+    F func) {
+  if (left.values && right.values) {
+    for (auto i = 0; i < numRows; ++i) {
+      result[i] = func(left.values[i], right.values[i]);
+    }
+  } else if (left.values) {
+    const auto constant = right.constant;
+    for (auto i = 0; i < numRows; ++i) {
+      result[i] = func(left.values[i], constant);
+    }
+  } else if (right.values) {
+    const auto constant = left.constant;
+    for (auto i = 0; i < numRows; ++i) {
+      result[i] = func(constant, right.values[i]);
+    }
+  } else {
+    std::fill(result, result + numRows, func(left.constant, right.constant));
+  }
+}
+
+bool isDouble(const Expr& expr) {
+  return expr.type()->kind() == TypeKind::DOUBLE;
+}
+
+} // namespace
+
+FusedExpr::FusedExpr(
+    ExprPtr expr,
+    std::vector<Step> steps,
+    std::vector<Expr*> leaves,
+    bool trackCpuUsage)
+    : SpecialForm(
+          expr->type(),
+          {expr},
+          "fused",
+          expr->supportsFlatNoNullsFastPath(),
+          trackCpuUsage),
+      steps_(std::move(steps)),
+      leaves_(std::move(leaves)) {}
+
+// static
+ExprPtr FusedExpr::tryFuse(const ExprPtr& expr, bool trackCpuUsage) {
+  std::vector<Step> steps;
+  std::vector<Expr*> leaves;
+  if (!addSteps(expr.get(), true, steps, leaves)) {
+    return nullptr;
+  }
+  int32_t numCalls = 0;
+  int32_t depth = 0;
+  int32_t maxDepth = 0;
+  for (const auto& step : steps) {
+    if (step.op == Op::kLeaf) {
+      maxDepth = std::max(maxDepth, ++depth);
+    } else {
+      ++numCalls;
+      --depth;
+    }
+  }
+  // A single call has no intermediate results to eliminate.
+  if (numCalls < 2 || maxDepth > kMaxDepth) {
+    return nullptr;
+  }
+  auto fused = std::make_shared<FusedExpr>(
+      expr, std::move(steps), std::move(leaves), trackCpuUsage);
+  fused->computeMetadata();
+  return fused;
+}
+
+// static
+bool FusedExpr::addSteps(
+    Expr* expr,
+    bool isRoot,
+    std::vector<Step>& steps,
+    std::vector<Expr*>& leaves) {
+  static const std::unordered_map<std::string, Op> kArithmetic = {
+      {"plus", Op::kPlus}, {"minus", Op::kMinus}, {"multiply", Op::kMultiply}};
+  static const std::unordered_map<std::string, Op> kComparisons = {
+      {"lt", Op::kLt},
+      {"lte", Op::kLte},
+      {"gt", Op::kGt},
+      {"gte", Op::kGte},
+      {"eq", Op::kEq},
+      {"neq", Op::kNeq}};
+
+  if (auto* fused = dynamic_cast<FusedExpr*>(expr)) {
+    return addSteps(fused->inputs_[0].get(), isRoot, steps, leaves);
+  }
+  if (auto* constant = dynamic_cast<ConstantExpr*>(expr)) {
+    if (!isDouble(*expr) || constant->value()->isNullAt(0)) {
+      return false;
+    }
+    steps.push_back({Op::kLeaf, static_cast<int32_t>(leaves.size())});
+    leaves.push_back(expr);
+    return true;
+  }
+  if (dynamic_cast<FieldReference*>(expr)) {
+    if (!isDouble(*expr) || !expr->inputs().empty()) {
+      return false;
+    }
+    steps.push_back({Op::kLeaf, static_cast<int32_t>(leaves.size())});
+    leaves.push_back(expr);
+    return true;
+  }
+  if (expr->isSpecialForm() || expr->inputs().size() != 2 ||
+      !isDouble(*expr->inputs()[0]) || !isDouble(*expr->inputs()[1])) {
+    return false;
+  }
+  Op op;
+  if (auto it = kArithmetic.find(expr->name());
+      it != kArithmetic.end() && isDouble(*expr)) {
+    op = it->second;
+  } else if (auto it = kComparisons.find(expr->name());
+             isRoot && it != kComparisons.end() &&
+             expr->type()->kind() == TypeKind::BOOLEAN) {
+    op = it->second;
+  } else {
+    return false;
+  }
+  if (!addSteps(expr->inputs()[0].get(), false, steps, leaves) ||
+      !addSteps(expr->inputs()[1].get(), false, steps, leaves)) {
+    return false;
+  }
+  steps.push_back({op});
+  return true;
+}
+
+void FusedExpr::evalSpecialForm(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    VectorPtr& result) {
+  std::vector<VectorPtr> leafVectors(leaves_.size());
+  std::vector<Operand> leafValues(leaves_.size());
+  for (auto i = 0; i < leaves_.size(); ++i) {
+    auto& vector = leafVectors[i];
+    leaves_[i]->eval(rows, context, vector);
+    if (vector->isConstantEncoding() && !vector->isNullAt(0)) {
+      leafValues[i] = {
+          nullptr, vector->asUnchecked<SimpleVector<double>>()->valueAt(0)};
+    } else if (vector->isFlatEncoding() && !vector->mayHaveNulls()) {
+      leafValues[i] = {
+          vector->asUnchecked<FlatVector<double>>()->rawValues(), 0};
+    } else {
+      inputs_[0]->eval(rows, context, result);
+      return;
+    }
+  }
+
+  context.ensureWritable(rows, type(), result);
+  result->clearNulls(rows);
+  const bool isBoolean = type()->kind() == TypeKind::BOOLEAN;
+  uint64_t* rawBits = nullptr;
+  double* rawDoubles = nullptr;
+  if (isBoolean) {
+    rawBits =
+        result->asUnchecked<FlatVector<bool>>()->mutableRawValues<uint64_t>();
+  } else {
+    rawDoubles = result->asUnchecked<FlatVector<double>>()->mutableRawValues();
+  }
+  const bool allSelected = rows.isAllSelected();
+  double doubleChunk[kChunkSize];
+  bool boolChunk[kChunkSize];
+  for (auto offset = rows.begin(); offset < rows.end(); offset += kChunkSize) {
+    const int32_t numRows = std::min<int32_t>(kChunkSize, rows.end() - offset);
+    if (isBoolean) {
+      evalChunk(leafValues, offset, numRows, nullptr, boolChunk);
+      auto set = [&](auto row) {
+        bits::setBit(rawBits, row, boolChunk[row - offset]);
+      };
+      if (allSelected) {
+        for (auto row = offset; row < offset + numRows; ++row) {
+          set(row);
+        }
+      } else {
+        bits::forEachSetBit(
+            rows.asRange().bits(), offset, offset + numRows, set);
+      }
+    } else if (allSelected) {
+      evalChunk(leafValues, offset, numRows, rawDoubles + offset, nullptr);
+    } else {
+      evalChunk(leafValues, offset, numRows, doubleChunk, nullptr);
+      bits::forEachSetBit(
+          rows.asRange().bits(), offset, offset + numRows, [&](auto row) {
+            rawDoubles[row] = doubleChunk[row - offset];
+          });
+    }
+  }
+}
+
+void FusedExpr::evalChunk(
+    const std::vector<Operand>& leafValues,
+    vector_size_t offset,
+    int32_t numRows,
+    double* doubleResult,
+    bool* boolResult) {
+  Operand stack[kMaxDepth];
+  int32_t depth = 0;
+  for (auto i = 0; i < steps_.size(); ++i) {
+    const auto& step = steps_[i];
+    if (step.op == Op::kLeaf) {
+      auto operand = leafValues[step.leaf];
+      if (operand.values) {
+        operand.values += offset;
+      }
+      stack[depth++] = operand;
+      continue;
+    }
+    const auto& left = stack[depth - 2];
+    const auto& right = stack[depth - 1];
+    const bool isLast = i == steps_.size() - 1;
+    double* result = isLast ? doubleResult : temp_[depth - 2];
+    switch (step.op) {
+      case Op::kPlus:
+        applyBinary(left, right, numRows, result, std::plus<double>());
+        break;
+      case Op::kMinus:
+        applyBinary(left, right, numRows, result, std::minus<double>());
+        break;
+      case Op::kMultiply:
+        applyBinary(left, right, numRows, result, std::multiplies<double>());
+        break;
+      case Op::kLt:
+        applyBinary(left, right, numRows, boolResult, std::less<double>());
+        break;
+      case Op::kLte:
+        applyBinary(
+            left, right, numRows, boolResult, std::less_equal<double>());
+        break;
+      case Op::kGt:
+        applyBinary(left, right, numRows, boolResult, std::greater<double>());
+        break;
+      case Op::kGte:
+        applyBinary(
+            left, right, numRows, boolResult, std::greater_equal<double>());
+        break;
+      case Op::kEq:
+        applyBinary(left, right, numRows, boolResult, std::equal_to<double>());
+        break;
+      case Op::kNeq:
+        applyBinary(
+            left, right, numRows, boolResult, std::not_equal_to<double>());
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+    --depth;
+    stack[depth - 1] = {result, 0};
+  }
+}
+
+} // namespace facebook::velox::exec
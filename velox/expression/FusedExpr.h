@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/expression/SpecialForm.h"
+
+namespace facebook::velox::exec {
+
+/// Evaluates a tree of DOUBLE plus, minus and multiply calls, optionally under
+/// one comparison, in one pass over the rows. The results of the inner calls
+/// are kept in arrays of kChunkSize values instead of vectors of the batch
+/// size. The leaves are top level columns and constants. Falls back to
+/// evaluating the original tree if a leaf is not flat or constant or may have
+/// nulls.
+class FusedExpr : public SpecialForm {
+ public:
+  /// Number of rows processed at a time. The intermediate results of a chunk
+  /// stay in the L1 cache.
+  static constexpr int32_t kChunkSize = 256;
+
+  /// Maximum number of intermediate results alive at a time.
+  static constexpr int32_t kMaxDepth = 8;
+
+  /// Returns a FusedExpr evaluating 'expr', or nullptr if 'expr' is not a tree
+  /// of at least two calls that can be fused.
+  static ExprPtr tryFuse(const ExprPtr& expr, bool trackCpuUsage);
+
+  void evalSpecialForm(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      VectorPtr& result) override;
+
+  std::string toSql(
+      std::vector<VectorPtr>* complexConstants = nullptr) const override {
+    return inputs_[0]->toSql(complexConstants);
+  }
+
+  enum class Op : uint8_t {
+    kLeaf,
+    kPlus,
+    kMinus,
+    kMultiply,
+    kLt,
+    kLte,
+    kGt,
+    kGte,
+    kEq,
+    kNeq
+  };
+
+  // A step of a postfix program. A leaf pushes the values of a leaf, an
+  // operation replaces the top two values by its result.
+  struct Step {
+    Op op;
+    // Index into 'leaves_' for kLeaf.
+    int32_t leaf{0};
+  };
+
+  // A value on the evaluation stack for one chunk. Either 'values' or
+  // 'constant' is set.
+  struct Operand {
+    const double* values;
+    double constant;
+  };
+
+  /// Use tryFuse().
+  FusedExpr(
+      ExprPtr expr,
+      std::vector<Step> steps,
+      std::vector<Expr*> leaves,
+      bool trackCpuUsage);
+
+ private:
+  // Appends the steps for evaluating 'expr' to 'steps'. Returns false if
+  // 'expr' cannot be fused. Comparisons are allowed only when 'isRoot'.
+  static bool addSteps(
+      Expr* expr,
+      bool isRoot,
+      std::vector<Step>& steps,
+      std::vector<Expr*>& leaves);
+
+  void computePropagatesNulls() override {
+    propagatesNulls_ = inputs_[0]->propagatesNulls();
+  }
+
+  // Evaluates the program for 'numRows' rows starting at 'offset' of
+  // 'leafValues'. Arithmetic results are written to 'doubleResult' and
+  // comparison results to 'boolResult'.
+  void evalChunk(
+      const std::vector<Operand>& leafValues,
+      vector_size_t offset,
+      int32_t numRows,
+      double* doubleResult,
+      bool* boolResult);
+
+  const std::vector<Step> steps_;
+
+  // Top level field references and constants of the tree. Owned by
+  // inputs_[0].
+  const std::vector<Expr*> leaves_;
+
+  // Intermediate results for one chunk.
+  double temp_[kMaxDepth][kChunkSize];
+};
+
+} // namespace facebook::velox::exec
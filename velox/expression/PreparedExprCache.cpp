@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/expression/PreparedExprCache.h"
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/core/QueryCtx.h"
+
+namespace facebook::velox::exec {
+
+bool PreparedExprCache::Key::operator==(const Key& other) const {
+  if (hash != other.hash || exprs.size() != other.exprs.size()) {
+    return false;
+  }
+  for (auto i = 0; i < exprs.size(); ++i) {
+    if (!(*exprs[i] == *other.exprs[i])) {
+      return false;
+    }
+  }
+  return config == other.config;
+}
+
+// static
+PreparedExprCache& PreparedExprCache::instance() {
+  // Never destroyed since cached constants may be referenced until exit.
+  static auto* cache = new PreparedExprCache();
+  return *cache;
+}
+
+PreparedExprCache::PreparedExprCache()
+    : pool_(memory::addDefaultLeafMemoryPool("PreparedExprCache")) {}
+
+std::shared_ptr<const PreparedExprs> PreparedExprCache::get(
+    const std::vector<core::TypedExprPtr>& exprs,
+    const core::QueryConfig& config) {
+  Key key{exprs, config.values(), 0};
+  for (const auto& expr : exprs) {
+    key.hash = bits::hashMix(key.hash, expr->hash());
+  }
+  // The config is unordered, so combine its entries commutatively.
+  size_t configHash = 0;
+  for (const auto& [name, value] : key.config) {
+    configHash += bits::hashMix(
+        std::hash<std::string>()(name), std::hash<std::string>()(value));
+  }
+  key.hash = bits::hashMix(key.hash, configHash);
+
+  std::promise<std::shared_ptr<const PreparedExprs>> promise;
+  std::optional<Value> cached;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      ++numHits_;
+      cached = it->second;
+    } else {
+      ++numMisses_;
+      auto newIt = entries_.emplace(key, promise.get_future().share()).first;
+      insertionOrder_.push_back(&newIt->first);
+      evictLocked();
+    }
+  }
+  if (cached.has_value()) {
+    // Waits if another thread is preparing the same expressions.
+    return cached->get();
+  }
+
+  try {
+    auto prepared = prepare(exprs, config);
+    promise.set_value(prepared);
+    return prepared;
+  } catch (const std::exception&) {
+    promise.set_exception(std::current_exception());
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      insertionOrder_.remove(&it->first);
+      entries_.erase(it);
+    }
+    throw;
+  }
+}
+
+std::shared_ptr<const PreparedExprs> PreparedExprCache::prepare(
+    const std::vector<core::TypedExprPtr>& exprs,
+    const core::QueryConfig& config) {
+  auto values = config.values();
+  // Folding compiles subexpressions, which must not go through the cache.
+  values.erase(core::QueryConfig::kExprPreparedCacheEnabled);
+  auto queryCtx = std::make_shared<core::QueryCtx>(nullptr, std::move(values));
+  core::ExecCtx execCtx(pool_.get(), queryCtx.get());
+  return std::make_shared<const PreparedExprs>(
+      prepareExpressions(exprs, &execCtx));
+}
+
+void PreparedExprCache::evictLocked() {
+  while (entries_.size() > maxEntries_ && !insertionOrder_.empty()) {
+    auto it = entries_.find(*insertionOrder_.front());
+    insertionOrder_.pop_front();
+    entries_.erase(it);
+  }
+}
+
+void PreparedExprCache::setMaxEntries(int32_t maxEntries) {
+  std::lock_guard<std::mutex> l(mutex_);
+  maxEntries_ = maxEntries;
+  evictLocked();
+}
+
+void PreparedExprCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  insertionOrder_.clear();
+  entries_.clear();
+}
+
+int32_t PreparedExprCache::size() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return entries_.size();
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <future>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "velox/common/memory/Memory.h"
+#include "velox/core/QueryConfig.h"
+#include "velox/expression/ExprCompiler.h"
+
+namespace facebook::velox::exec {
+
+/// Process-wide cache of PreparedExprs keyed by the expressions and the query
+/// config. Every driver of a FilterProject compiles the same expressions, so
+/// without the cache the rewrites and the evaluation of constant
+/// subexpressions, e.g. of large CASE or IN lists, are repeated per driver. A
+/// cache hit leaves only building the Expr tree, which every ExprSet still
+/// does by itself since Expr and VectorFunction instances keep per-driver
+/// state.
+///
+/// Calls without arguments are not folded when preparing, e.g.
+/// current_date(), since a cached value would outlive the query. They are
+/// still folded by each ExprSet. The constants are allocated from a pool of
+/// the cache and shared read-only by all ExprSets.
+///
+/// Concurrent requests for the same expressions wait for the first one to
+/// prepare them. Used by compileExpressions() if
+/// QueryConfig::kExprPreparedCacheEnabled is set.
+class PreparedExprCache {
+ public:
+  static constexpr int32_t kDefaultMaxEntries = 1'000;
+
+  static PreparedExprCache& instance();
+
+  /// Returns the prepared form of 'exprs' under 'config', preparing it if
+  /// not cached.
+  std::shared_ptr<const PreparedExprs> get(
+      const std::vector<core::TypedExprPtr>& exprs,
+      const core::QueryConfig& config);
+
+  /// Sets the number of entries above which the least recently inserted
+  /// entries are dropped.
+  void setMaxEntries(int32_t maxEntries);
+
+  void clear();
+
+  int32_t size() const;
+
+  uint64_t numHits() const {
+    return numHits_;
+  }
+
+  uint64_t numMisses() const {
+    return numMisses_;
+  }
+
+ private:
+  struct Key {
+    std::vector<core::TypedExprPtr> exprs;
+    std::unordered_map<std::string, std::string> config;
+    size_t hash;
+
+    bool operator==(const Key& other) const;
+  };
+
+  struct KeyHasher {
+    size_t operator()(const Key& key) const {
+      return key.hash;
+    }
+  };
+
+  using Value = std::shared_future<std::shared_ptr<const PreparedExprs>>;
+
+  PreparedExprCache();
+
+  std::shared_ptr<const PreparedExprs> prepare(
+      const std::vector<core::TypedExprPtr>& exprs,
+      const core::QueryConfig& config);
+
+  // Drops the oldest entries while there are more than 'maxEntries_'.
+  void evictLocked();
+
+  const std::shared_ptr<memory::MemoryPool> pool_;
+  mutable std::mutex mutex_;
+  std::unordered_map<Key, Value, KeyHasher> entries_;
+  // Keys of 'entries_' in insertion order.
+  std::list<const Key*> insertionOrder_;
+  int32_t maxEntries_{kDefaultMaxEntries};
+  std::atomic<uint64_t> numHits_{0};
+  std::atomic<uint64_t> numMisses_{0};
+};
+
+} // namespace facebook::velox::exec
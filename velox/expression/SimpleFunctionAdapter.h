@@ -177,7 +177,38 @@ class SimpleFunctionAdapter : public VectorFunction {
 
     template <typename Callable>
     void applyToSelectedNoThrow(Callable func) {
-      context.template applyToSelectedNoThrow<Callable>(*rows, func);
+      if (rows->isAllSelected()) {
+        applyToAllSelectedNoThrow(func);
+      } else {
+        context.template applyToSelectedNoThrow<Callable>(*rows, func);
+      }
+    }
+
+    // Same as EvalCtx::applyToSelectedNoThrow() for a contiguous range of rows
+    // but with a single try block around the loop instead of one per row. A
+    // per-row try block keeps the compiler from vectorizing trivial functions
+    // over flat inputs. When a row throws, its error is recorded and the loop
+    // resumes at the next row, so no row is evaluated twice.
+    template <typename Callable>
+    void applyToAllSelectedNoThrow(Callable func) {
+      const vector_size_t end = rows->end();
+      vector_size_t row = rows->begin();
+      while (row < end) {
+        try {
+          for (; row < end; ++row) {
+            func(row);
+          }
+        } catch (const VeloxException& e) {
+          if (!e.isUserError()) {
+            throw;
+          }
+          context.setVeloxExceptionError(row, std::current_exception());
+          ++row;
+        } catch (const std::exception& e) {
+          context.setError(row, std::current_exception());
+          ++row;
+        }
+      }
     }
 
     const SelectivityVector* rows;
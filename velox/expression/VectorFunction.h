@@ -281,6 +281,21 @@ std::vector<ExpressionRewrite>& expressionRewrites();
 /// non-null result terminates the re-write for this particular expression.
 void registerExpressionRewrite(ExpressionRewrite rewrite);
 
+/// A re-writer that takes all expressions of an ExprSet together and returns
+/// equivalent expressions or an empty vector if re-write is not possible. Used
+/// for re-writes that depend on more than one expression, e.g. to share work
+/// between calls that appear in different expressions.
+using ExpressionSetRewrite = std::function<std::vector<core::TypedExprPtr>(
+    const std::vector<core::TypedExprPtr>&)>;
+
+/// Returns a list of registered expression set re-writes.
+std::vector<ExpressionSetRewrite>& expressionSetRewrites();
+
+/// Appends a 'rewrite' to 'expressionSetRewrites'. All set re-writes are
+/// applied in the order they were registered, each to the result of the
+/// previous one, before the per-expression re-writes.
+void registerExpressionSetRewrite(ExpressionSetRewrite rewrite);
+
 } // namespace facebook::velox::exec
 
 // Private. Return the external function name given a UDF tag.
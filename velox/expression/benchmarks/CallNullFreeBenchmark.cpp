@@ -43,6 +43,12 @@
 // expect simpleMinIntegerNullFreeFastPath to do about as well as
 // simpleMinInteger when null arrays or null elements are present because they
 // use the same code path after a quick additional check once per batch.
+//
+// simpleMultiplyAddNullFree runs a trivial callNullFree() function over flat
+// BIGINT inputs. With all rows selected the adapter evaluates it in a single
+// loop with no per-row exception handling, which the compiler can vectorize,
+// so we expect it to be close to vectorMultiplyAdd, a hand-written loop over
+// the raw arrays.
 
 namespace facebook::velox::functions {
 
@@ -186,6 +192,29 @@ struct ArrayMinNullFreeFastPathFunction {
   }
 };
 
+VectorPtr fastMultiplyAdd(const VectorPtr& a, const VectorPtr& b) {
+  const auto numRows = a->size();
+  auto result = std::static_pointer_cast<FlatVector<int64_t>>(
+      BaseVector::create(BIGINT(), numRows, a->pool()));
+  auto rawResults = result->mutableRawValues();
+  auto rawA = a->asFlatVector<int64_t>()->rawValues();
+  auto rawB = b->asFlatVector<int64_t>()->rawValues();
+  for (auto row = 0; row < numRows; ++row) {
+    rawResults[row] = rawA[row] * 3 + rawB[row];
+  }
+  return result;
+}
+
+template <typename T>
+struct MultiplyAddNullFreeFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  FOLLY_ALWAYS_INLINE void
+  callNullFree(int64_t& out, const int64_t& a, const int64_t& b) {
+    out = a * 3 + b;
+  }
+};
+
 void registerSimpleFunctions() {
   registerFunction<ArrayMinSimpleFunction, int32_t, Array<int32_t>>(
       {"array_min_simple"});
@@ -197,6 +226,9 @@ void registerSimpleFunctions() {
 
   registerFunction<ArrayMinNullFreeFastPathFunction, int32_t, Array<int32_t>>(
       {"array_min_null_free_fast_path"});
+
+  registerFunction<MultiplyAddNullFreeFunction, int64_t, int64_t, int64_t>(
+      {"multiply_add_null_free"});
 }
 
 namespace {
@@ -221,6 +253,37 @@ class CallNullFreeBenchmark : public functions::test::FunctionBenchmarkBase {
     return vectorMaker_.rowVector({arrayVector});
   }
 
+  RowVectorPtr makePrimitiveData() {
+    const vector_size_t size = 10'000;
+    return vectorMaker_.rowVector({
+        vectorMaker_.flatVector<int64_t>(size, [](auto row) { return row; }),
+        vectorMaker_.flatVector<int64_t>(
+            size, [](auto row) { return row % 17; }),
+    });
+  }
+
+  size_t runFastMultiplyAdd() {
+    folly::BenchmarkSuspender suspender;
+    auto data = makePrimitiveData();
+    suspender.dismiss();
+
+    int cnt = 0;
+    for (auto i = 0; i < 100; i++) {
+      cnt += fastMultiplyAdd(data->childAt(0), data->childAt(1))->size();
+    }
+    return cnt;
+  }
+
+  size_t runMultiplyAdd() {
+    folly::BenchmarkSuspender suspender;
+    auto data = makePrimitiveData();
+    auto exprSet =
+        compileExpression("multiply_add_null_free(c0, c1)", data->type());
+    suspender.dismiss();
+
+    return doRun(exprSet, data);
+  }
+
   size_t runFast() {
     folly::BenchmarkSuspender suspender;
     auto arrayVector = makeData()->childAt(0);
@@ -286,6 +349,17 @@ class CallNullFreeBenchmark : public functions::test::FunctionBenchmarkBase {
         VELOX_UNREACHABLE(fmt::format("testing failed at function {}", name));
       }
     }
+
+    auto primitiveInput = makePrimitiveData();
+    auto multiplyAdd = compileExpression(
+        "multiply_add_null_free(c0, c1)", primitiveInput->type());
+    if (!hasSameResults(
+            fastMultiplyAdd(
+                primitiveInput->childAt(0), primitiveInput->childAt(1)),
+            multiplyAdd,
+            primitiveInput)) {
+      VELOX_UNREACHABLE("testing failed at function multiply_add_null_free");
+    }
   }
 };
 
@@ -308,6 +382,18 @@ BENCHMARK_MULTI(simpleMinIntegerNullFreeFastPath) {
   CallNullFreeBenchmark benchmark;
   return benchmark.runInteger("array_min_null_free_fast_path");
 }
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_MULTI(vectorMultiplyAdd) {
+  CallNullFreeBenchmark benchmark;
+  return benchmark.runFastMultiplyAdd();
+}
+
+BENCHMARK_MULTI(simpleMultiplyAddNullFree) {
+  CallNullFreeBenchmark benchmark;
+  return benchmark.runMultiplyAdd();
+}
 } // namespace
 } // namespace facebook::velox::functions
 
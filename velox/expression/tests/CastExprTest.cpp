@@ -699,6 +699,66 @@ TEST_F(CastExprTest, date) {
       "date", input, result, false, false, VARCHAR(), DATE());
 }
 
+TEST_F(CastExprTest, stringToNumber) {
+  setCastIntByTruncate(false);
+  // Strings of up to 8, more than 8 and more than the digits that always fit
+  // the type, and strings in other formats.
+  testCast<std::string, int64_t>(
+      "bigint",
+      {"0",
+       "-0",
+       "00012",
+       "12345678",
+       "-123456789",
+       "123456789012345678",
+       "-9223372036854775808",
+       "9223372036854775807",
+       "1234567a",
+       "12345678901234567a",
+       "9223372036854775808",
+       "",
+       std::nullopt},
+      {0,
+       0,
+       12,
+       12345678,
+       -123456789,
+       123456789012345678,
+       std::numeric_limits<int64_t>::min(),
+       std::numeric_limits<int64_t>::max(),
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt},
+      false,
+      true);
+  testCast<std::string, int16_t>(
+      "smallint",
+      {"1234", "-32768", "32767", "32768", "1.5"},
+      {1234, -32768, 32767, std::nullopt, std::nullopt},
+      false,
+      true);
+  testCast<std::string, double>(
+      "double",
+      {"1", "-1.5", "1e10", "1.5a"},
+      {1, -1.5, 1e10, std::nullopt},
+      false,
+      true);
+
+  // Date strings in the YYYY-MM-DD format and others.
+  testCast<std::string, int32_t>(
+      "date",
+      {"2020-02-29", "1919-11-28", "2021-02-29", "2020-13-01", "2020-02-x1"},
+      {18321, -18297, std::nullopt, std::nullopt, std::nullopt},
+      false,
+      true,
+      VARCHAR(),
+      DATE());
+  testCast<std::string, int32_t>(
+      "date", {"2021-02-29"}, {0}, true, false, VARCHAR(), DATE());
+}
+
 TEST_F(CastExprTest, invalidDate) {
   testCast<int8_t, int32_t>("date", {12}, {0}, true, false, TINYINT(), DATE());
   testCast<int16_t, int32_t>(
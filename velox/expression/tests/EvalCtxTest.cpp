@@ -221,3 +221,33 @@ TEST_F(EvalCtxTest, localSingleRow) {
     }
   }
 }
+
+TEST_F(EvalCtxTest, scratch) {
+  EvalCtx context(&execCtx_);
+  ASSERT_EQ(0, execCtx_.scratchBytes());
+
+  auto* first = context.allocateScratch<int64_t>(1'000);
+  ASSERT_EQ(0, reinterpret_cast<uintptr_t>(first) % alignof(int64_t));
+  auto* second = context.allocateScratch<int32_t>(1'000);
+  ASSERT_NE(first, reinterpret_cast<int64_t*>(second));
+  const auto scratchBytes = execCtx_.scratchBytes();
+  ASSERT_GT(scratchBytes, 0);
+
+  // A reset reuses the memory without allocating.
+  execCtx_.resetScratch();
+  ASSERT_EQ(first, context.allocateScratch<int64_t>(1'000));
+  ASSERT_EQ(scratchBytes, execCtx_.scratchBytes());
+
+  // A batch that does not fit in one run is followed by a single run large
+  // enough for it.
+  for (auto i = 0; i < 10; ++i) {
+    context.allocateScratch<char>(100'000);
+  }
+  execCtx_.resetScratch();
+  const auto grownBytes = execCtx_.scratchBytes();
+  ASSERT_GE(grownBytes, 1'000'000);
+  for (auto i = 0; i < 10; ++i) {
+    context.allocateScratch<char>(100'000);
+  }
+  ASSERT_EQ(grownBytes, execCtx_.scratchBytes());
+}
@@ -16,6 +16,7 @@
 #include "gtest/gtest.h"
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/expression/Expr.h"
+#include "velox/expression/PreparedExprCache.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
 #include "velox/functions/prestosql/types/JsonType.h"
 #include "velox/parse/TypeResolver.h"
@@ -275,4 +276,46 @@ TEST_F(ExprCompilerTest, customTypeConstant) {
   ASSERT_EQ("[1, 2, 3]:JSON", compile(expression)->toString());
 }
 
+TEST_F(ExprCompilerTest, preparedExprCache) {
+  queryCtx_->testingOverrideConfigUnsafe(
+      {{core::QueryConfig::kExprPreparedCacheEnabled, "true"}});
+  auto& cache = PreparedExprCache::instance();
+  cache.clear();
+
+  auto rowType = ROW({"a"}, {BIGINT()});
+  auto field = makeField(rowType);
+  auto expression =
+      call("plus", {field("a"), call("plus", {bigint(1), bigint(5)})});
+
+  const auto numHits = cache.numHits();
+  auto first = compile(expression);
+  auto second = compile(expression);
+  ASSERT_EQ("plus(a, 6:BIGINT)", first->toString());
+  ASSERT_EQ("plus(a, 6:BIGINT)", second->toString());
+  ASSERT_EQ(numHits + 1, cache.numHits());
+  ASSERT_EQ(1, cache.size());
+
+  // Each ExprSet gets its own Expr tree.
+  ASSERT_NE(first->expr(0).get(), second->expr(0).get());
+
+  auto data = makeRowVector({makeFlatVector<int64_t>({1, 2, 3})});
+  for (auto* exprSet : {first.get(), second.get()}) {
+    SelectivityVector rows(data->size());
+    EvalCtx evalCtx(execCtx_.get(), exprSet, data.get());
+    std::vector<VectorPtr> results(1);
+    exprSet->eval(rows, evalCtx, results);
+    velox::test::assertEqualVectors(
+        makeFlatVector<int64_t>({7, 8, 9}), results[0]);
+  }
+
+  // A different expression is a miss.
+  const auto numMisses = cache.numMisses();
+  compile(call("plus", {field("a"), call("plus", {bigint(1), bigint(2)})}));
+  ASSERT_EQ(numMisses + 1, cache.numMisses());
+  ASSERT_EQ(2, cache.size());
+
+  cache.clear();
+  ASSERT_EQ(0, cache.size());
+}
+
 } // namespace facebook::velox::exec::test
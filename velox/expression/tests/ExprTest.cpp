@@ -460,6 +460,41 @@ TEST_F(ExprTest, reorder) {
   }
 }
 
+TEST_F(ExprTest, reorderFollowsData) {
+  constexpr int32_t kTestSize = 1'000;
+  queryCtx_->testingOverrideConfigUnsafe(
+      {{core::QueryConfig::kAdaptiveFilterReorderingInterval, "2"}});
+
+  auto makeData = [&](int64_t c0, int64_t c1) {
+    return makeRowVector(
+        {makeFlatVector<int64_t>(kTestSize, [&](auto /*row*/) { return c0; }),
+         makeFlatVector<int64_t>(kTestSize, [&](auto /*row*/) { return c1; })});
+  };
+  auto exprSet =
+      compileExpression("c0 < 0 and c1 < 0", ROW({"c0", "c1"}, {BIGINT(), BIGINT()}));
+  auto condition =
+      std::dynamic_pointer_cast<exec::ConjunctExpr>(exprSet->expr(0));
+  ASSERT_TRUE(condition != nullptr);
+  auto expected = makeFlatVector<bool>(kTestSize, [](auto /*row*/) {
+    return false;
+  });
+
+  // 'c0 < 0' drops all rows.
+  auto data = makeData(1, -1);
+  for (auto i = 0; i < 4; ++i) {
+    assertEqualVectors(expected, evaluate(exprSet.get(), data));
+  }
+  ASSERT_EQ(condition->inputAt(0)->inputs()[0]->toString(), "c0");
+
+  // 'c1 < 0' drops all rows. The older measurements are halved at each
+  // reordering and 'c1 < 0' moves first.
+  data = makeData(-1, 1);
+  for (auto i = 0; i < 10; ++i) {
+    assertEqualVectors(expected, evaluate(exprSet.get(), data));
+  }
+  ASSERT_EQ(condition->inputAt(0)->inputs()[0]->toString(), "c1");
+}
+
 TEST_F(ExprTest, constant) {
   auto exprSet = compileExpression("1 + 2 + 3 + 4", ROW({}));
   auto constExpr = dynamic_cast<exec::ConstantExpr*>(exprSet->expr(0).get());
@@ -2114,9 +2149,48 @@ TEST_F(ExprTest, memo) {
   assertEqualVectors(expectedResult, result);
 }
 
+TEST_F(ExprTest, memoAlternatingBases) {
+  auto base = makeFlatVector<int64_t>(1'000, [](auto row) { return row; });
+  auto otherBase =
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row * 10; });
+  auto thirdBase =
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row * 100; });
+
+  auto evenIndices = makeIndices(100, [](auto row) { return row * 2; });
+  auto oddIndices = makeIndices(100, [](auto row) { return row * 2 + 1; });
+
+  auto rowType = ROW({"c0"}, {BIGINT()});
+  auto exprSet = compileExpression("c0 % 7", rowType);
+
+  auto check = [&](const VectorPtr& batchBase,
+                   const BufferPtr& indices,
+                   int64_t scale,
+                   int32_t offset) {
+    auto result = evaluate(
+        exprSet.get(),
+        makeRowVector({wrapInDictionary(indices, 100, batchBase)}));
+    auto expectedResult = makeFlatVector<int64_t>(100, [&](auto row) {
+      return ((row * 2 + offset) * scale) % 7;
+    });
+    assertEqualVectors(expectedResult, result);
+  };
+
+  // The results for both bases stay cached when batches alternate between
+  // them. Odd indices are added to the cached even ones.
+  check(base, evenIndices, 1, 0);
+  check(otherBase, evenIndices, 10, 0);
+  check(base, oddIndices, 1, 1);
+  check(otherBase, oddIndices, 10, 1);
+  check(base, evenIndices, 1, 0);
+  // A third base evicts the least recently used one.
+  check(thirdBase, evenIndices, 100, 0);
+  check(otherBase, evenIndices, 10, 0);
+  check(base, oddIndices, 1, 1);
+}
+
 // This test triggers the situation when peelEncodings() produces an empty
 // selectivity vector, which if passed to evalWithMemo() causes the latter to
-// produce null Expr::dictionaryCache_, which leads to a crash in evaluation
+// produce a null dictionary cache, which leads to a crash in evaluation
 // of subsequent rows. We have fixed that issue with condition and this test
 // is for that.
 TEST_F(ExprTest, memoNulls) {
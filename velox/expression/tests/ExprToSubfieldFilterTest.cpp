@@ -208,6 +208,103 @@ TEST_F(ExprToSubfieldFilterTest, isNotNull) {
   ASSERT_FALSE(filter->testNull());
 }
 
+TEST_F(ExprToSubfieldFilterTest, constantOnLeft) {
+  auto call = parseCallExpr("42 < a", ROW({{"a", BIGINT()}}));
+  Subfield subfield;
+  auto filter = leafCallToSubfieldFilter(*call, subfield, evaluator());
+  ASSERT_TRUE(filter);
+  validateSubfield(subfield, {"a"});
+  ASSERT_FALSE(filter->testInt64(41));
+  ASSERT_FALSE(filter->testInt64(42));
+  ASSERT_TRUE(filter->testInt64(43));
+}
+
+TEST_F(ExprToSubfieldFilterTest, arithmetic) {
+  auto rowType = ROW({{"a", BIGINT()}});
+  Subfield subfield;
+
+  auto call = parseCallExpr("a + 1 < 10", rowType);
+  auto filter = leafCallToSubfieldFilter(*call, subfield, evaluator());
+  ASSERT_TRUE(filter);
+  validateSubfield(subfield, {"a"});
+  ASSERT_TRUE(filter->testInt64(8));
+  ASSERT_FALSE(filter->testInt64(9));
+
+  call = parseCallExpr("2 + a >= 10", rowType);
+  filter = leafCallToSubfieldFilter(*call, subfield, evaluator());
+  ASSERT_TRUE(filter);
+  validateSubfield(subfield, {"a"});
+  ASSERT_FALSE(filter->testInt64(7));
+  ASSERT_TRUE(filter->testInt64(8));
+
+  call = parseCallExpr("a - 3 = 10", rowType);
+  filter = leafCallToSubfieldFilter(*call, subfield, evaluator());
+  ASSERT_TRUE(filter);
+  validateSubfield(subfield, {"a"});
+  ASSERT_FALSE(filter->testInt64(10));
+  ASSERT_TRUE(filter->testInt64(13));
+
+  // The folded bound overflows.
+  call = parseCallExpr("a - 1 > 9223372036854775807", rowType);
+  ASSERT_FALSE(leafCallToSubfieldFilter(*call, subfield, evaluator()));
+
+  call =
+      parseCallExpr("a + b < 10", ROW({{"a", BIGINT()}, {"b", BIGINT()}}));
+  ASSERT_FALSE(leafCallToSubfieldFilter(*call, subfield, evaluator()));
+}
+
+TEST_F(ExprToSubfieldFilterTest, coalesce) {
+  auto rowType = ROW({{"a", BIGINT()}});
+  Subfield subfield;
+
+  auto call = parseCallExpr("coalesce(a, 0) > 5", rowType);
+  auto filter = leafCallToSubfieldFilter(*call, subfield, evaluator());
+  ASSERT_TRUE(filter);
+  validateSubfield(subfield, {"a"});
+  ASSERT_FALSE(filter->testInt64(5));
+  ASSERT_TRUE(filter->testInt64(6));
+  ASSERT_FALSE(filter->testNull());
+
+  call = parseCallExpr("coalesce(a, 10) > 5", rowType);
+  filter = leafCallToSubfieldFilter(*call, subfield, evaluator());
+  ASSERT_TRUE(filter);
+  ASSERT_FALSE(filter->testInt64(5));
+  ASSERT_TRUE(filter->testInt64(6));
+  ASSERT_TRUE(filter->testNull());
+
+  filter = leafCallToSubfieldFilter(*call, subfield, evaluator(), true);
+  ASSERT_TRUE(filter);
+  ASSERT_TRUE(filter->testInt64(5));
+  ASSERT_FALSE(filter->testInt64(6));
+  ASSERT_FALSE(filter->testNull());
+}
+
+TEST_F(ExprToSubfieldFilterTest, substrPrefix) {
+  auto rowType = ROW({{"s", VARCHAR()}});
+  Subfield subfield;
+
+  auto call = parseCallExpr("substr(s, 1, 3) = 'abc'", rowType);
+  auto filter = leafCallToSubfieldFilter(*call, subfield, evaluator());
+  ASSERT_TRUE(filter);
+  validateSubfield(subfield, {"s"});
+  ASSERT_TRUE(filter->testBytes("abc", 3));
+  ASSERT_TRUE(filter->testBytes("abcdef", 6));
+  ASSERT_FALSE(filter->testBytes("ab", 2));
+  ASSERT_FALSE(filter->testBytes("abd", 3));
+  ASSERT_FALSE(filter->testBytes("xabc", 4));
+  ASSERT_FALSE(filter->testNull());
+
+  // Shorter than the substring length. Only the exact value matches.
+  call = parseCallExpr("substr(s, 1, 5) = 'abc'", rowType);
+  filter = leafCallToSubfieldFilter(*call, subfield, evaluator());
+  ASSERT_TRUE(filter);
+  ASSERT_TRUE(filter->testBytes("abc", 3));
+  ASSERT_FALSE(filter->testBytes("abcd", 4));
+
+  call = parseCallExpr("substr(s, 2, 3) = 'abc'", rowType);
+  ASSERT_FALSE(leafCallToSubfieldFilter(*call, subfield, evaluator()));
+}
+
 TEST_F(ExprToSubfieldFilterTest, like) {
   auto call = parseCallExpr("a like 'foo%'", ROW({{"a", VARCHAR()}}));
   Subfield subfield;
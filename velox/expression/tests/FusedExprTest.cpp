@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/expression/FusedExpr.h"
+#include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
+
+namespace facebook::velox::exec {
+namespace {
+
+class FusedExprTest : public functions::test::FunctionBaseTest {
+ protected:
+  void SetUp() override {
+    FunctionBaseTest::SetUp();
+    queryCtx_->testingOverrideConfigUnsafe(
+        {{core::QueryConfig::kExprFuseFloatingPointArithmetic, "true"}});
+  }
+
+  RowVectorPtr makeData(vector_size_t size) {
+    return makeRowVector({
+        makeFlatVector<double>(size, [](auto row) { return row * 0.5; }),
+        makeFlatVector<double>(size, [](auto row) { return row % 7; }),
+        makeFlatVector<double>(size, [](auto row) { return 100 - row; }),
+    });
+  }
+
+  bool isFused(const std::string& expression, const RowVectorPtr& data) {
+    auto exprSet = compileExpression(expression, asRowType(data->type()));
+    return dynamic_cast<FusedExpr*>(exprSet->expr(0).get()) != nullptr;
+  }
+};
+
+TEST_F(FusedExprTest, arithmetic) {
+  // More rows than FusedExpr::kChunkSize and not a multiple of it.
+  const vector_size_t size = 1'000;
+  auto data = makeData(size);
+  const std::string expression = "c0 * 2.0 + c1 - c2 * c0";
+  ASSERT_TRUE(isFused(expression, data));
+
+  auto expected = makeFlatVector<double>(size, [](auto row) {
+    return row * 0.5 * 2.0 + (row % 7) - (100 - row) * (row * 0.5);
+  });
+  assertEqualVectors(expected, evaluate(expression, data));
+
+  // Every third row.
+  SelectivityVector rows(size, false);
+  for (auto i = 0; i < size; i += 3) {
+    rows.setValid(i, true);
+  }
+  rows.updateBounds();
+  auto result = evaluate(expression, data, rows);
+  rows.applyToSelected([&](auto row) {
+    ASSERT_EQ(
+        result->asFlatVector<double>()->valueAt(row), expected->valueAt(row))
+        << row;
+  });
+}
+
+TEST_F(FusedExprTest, comparison) {
+  const vector_size_t size = 1'000;
+  auto data = makeData(size);
+  const std::string expression = "c0 * c1 + 1.0 > c2";
+  ASSERT_TRUE(isFused(expression, data));
+
+  auto expected = makeFlatVector<bool>(size, [](auto row) {
+    return row * 0.5 * (row % 7) + 1.0 > 100 - row;
+  });
+  assertEqualVectors(expected, evaluate(expression, data));
+
+  // Used as a filter under a conjunct, which evaluates on a subset of rows.
+  auto result = evaluate("c0 > 200.0 and " + expression, data);
+  expected = makeFlatVector<bool>(size, [](auto row) {
+    return row * 0.5 > 200.0 && row * 0.5 * (row % 7) + 1.0 > 100 - row;
+  });
+  assertEqualVectors(expected, result);
+}
+
+TEST_F(FusedExprTest, fallback) {
+  const vector_size_t size = 300;
+  auto data = makeRowVector({
+      makeFlatVector<double>(
+          size, [](auto row) { return row; }, nullEvery(5)),
+      makeFlatVector<double>(size, [](auto row) { return row * 2; }),
+  });
+  const std::string expression = "c0 * 2.0 - c1 * 3.0";
+  ASSERT_TRUE(isFused(expression, data));
+
+  // Nulls in c0 are evaluated by the original tree.
+  auto expected = makeFlatVector<double>(
+      size, [](auto row) { return row * 2.0 - row * 2 * 3.0; }, nullEvery(5));
+  assertEqualVectors(expected, evaluate(expression, data));
+
+  // Dictionary encoded inputs are peeled before evaluating the fused tree.
+  auto indices = makeIndicesInReverse(size);
+  auto c0 = makeFlatVector<double>(size, [](auto row) { return row; });
+  auto dictionaryData = makeRowVector({
+      wrapInDictionary(indices, size, c0),
+      wrapInDictionary(indices, size, data->childAt(1)),
+  });
+  expected = makeFlatVector<double>(size, [&](auto row) {
+    auto index = size - 1 - row;
+    return index * 2.0 - index * 2 * 3.0;
+  });
+  assertEqualVectors(expected, evaluate(expression, dictionaryData));
+}
+
+TEST_F(FusedExprTest, notFused) {
+  auto data = makeData(10);
+  // A single call has no intermediate results.
+  ASSERT_FALSE(isFused("c0 + c1", data));
+  // Only DOUBLE arithmetic is fused.
+  ASSERT_FALSE(isFused("cast(c0 as bigint) + cast(c1 as bigint) * 2", data));
+  // Comparisons are fused only at the root.
+  ASSERT_FALSE(isFused("(c0 + c1 > c2) = (c1 > c2)", data));
+  // Division is not fused.
+  ASSERT_FALSE(isFused("c0 / c1 + c2 / c1", data));
+
+  queryCtx_->testingOverrideConfigUnsafe(
+      {{core::QueryConfig::kExprFuseFloatingPointArithmetic, "false"}});
+  ASSERT_FALSE(isFused("c0 * 2.0 + c1 - c2 * c0", data));
+}
+
+} // namespace
+} // namespace facebook::velox::exec
@@ -21,6 +21,7 @@
 #include "folly/lang/Hint.h"
 #include "glog/logging.h"
 #include "gtest/gtest.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/expression/Expr.h"
 #include "velox/functions/Udf.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
@@ -1131,6 +1132,35 @@ TEST_F(SimpleFunctionTest, testAllNotNull) {
   assertEqualVectors(expected, result);
 }
 
+template <typename T>
+struct DoubleOrThrowFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  void call(int64_t& out, const int64_t& in) {
+    VELOX_USER_CHECK_NE(in % 7, 0, "Multiple of 7");
+    out = in * 2;
+  }
+};
+
+// Verify that errors in a fully selected batch are recorded per row and that
+// evaluation continues with the rows after the failing ones.
+TEST_F(SimpleFunctionTest, errorsInAllSelectedRows) {
+  registerFunction<DoubleOrThrowFunction, int64_t, int64_t>(
+      {"double_or_throw"});
+
+  auto data = makeRowVector(
+      {makeFlatVector<int64_t>(100, [](auto row) { return row; })});
+
+  auto result = evaluate("try(double_or_throw(c0))", data);
+  auto expected = makeFlatVector<int64_t>(
+      100,
+      [](auto row) { return row * 2; },
+      [](auto row) { return row % 7 == 0; });
+  assertEqualVectors(expected, result);
+
+  VELOX_ASSERT_THROW(evaluate("double_or_throw(c0)", data), "Multiple of 7");
+}
+
 // Test that SimpleFunctionRegistry does not crash in multithreaded environment.
 TEST_F(SimpleFunctionTest, simpleFunctionRegistryThreadSafe) {
   std::vector<std::thread> threads;
@@ -62,6 +62,11 @@ DEFINE_bool(avx2, true, "Enables use of AVX2 when available");
 
 DEFINE_bool(bmi2, true, "Enables use of BMI2 when available");
 
+DEFINE_bool(
+    avx512,
+    true,
+    "Enables the AVX-512 kernels chosen at run time when available");
+
 // Used in exec/Expr.cpp
 
 DEFINE_string(
@@ -16,6 +16,8 @@
 
 #include "velox/functions/lib/DateTimeFormatter.h"
 #include <folly/String.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
 #include <velox/common/base/Exceptions.h>
 #include <cstring>
 #include <stdexcept>
@@ -925,8 +927,223 @@ void parseFromPattern(
   }
 }
 
+// Returns the number of digits a field of a fixed-width pattern has, 0 if
+// 'pattern' cannot be part of a fixed-width pattern.
+int32_t fixedWidthDigits(const FormatPattern& pattern) {
+  switch (pattern.specifier) {
+    case DateTimeFormatSpecifier::YEAR:
+    case DateTimeFormatSpecifier::YEAR_OF_ERA:
+      return pattern.minRepresentDigits == 4 ? 4 : 0;
+    case DateTimeFormatSpecifier::MONTH_OF_YEAR:
+    case DateTimeFormatSpecifier::DAY_OF_MONTH:
+    case DateTimeFormatSpecifier::HOUR_OF_DAY:
+    case DateTimeFormatSpecifier::MINUTE_OF_HOUR:
+    case DateTimeFormatSpecifier::SECOND_OF_MINUTE:
+      return pattern.minRepresentDigits == 2 ? 2 : 0;
+    default:
+      return 0;
+  }
+}
+
+// Writes 'value' as 'width' decimal digits to 'out'.
+inline void writeDigits(int32_t value, int32_t width, char* out) {
+  for (auto i = width - 1; i >= 0; --i) {
+    out[i] = '0' + value % 10;
+    value /= 10;
+  }
+}
+
+// Maximum number of formatters of each type kept by buildMysqlDateTimeFormatter
+// and buildJodaDateTimeFormatter.
+constexpr size_t kMaxCachedFormatters = 1'024;
+
+using FormatterCache = folly::Synchronized<
+    folly::F14FastMap<std::string, std::shared_ptr<DateTimeFormatter>>>;
+
+// Returns the formatter for 'format' from 'cache', building it with 'build'
+// if it is not there. Formatters that fail to build are not cached.
+template <typename Build>
+std::shared_ptr<DateTimeFormatter> getCachedFormatter(
+    FormatterCache& cache,
+    const std::string_view& format,
+    Build build) {
+  {
+    auto formatters = cache.rlock();
+    auto it = formatters->find(format);
+    if (it != formatters->end()) {
+      return it->second;
+    }
+  }
+  auto formatter = build(format);
+  auto formatters = cache.wlock();
+  if (formatters->size() >= kMaxCachedFormatters) {
+    formatters->clear();
+  }
+  formatters->emplace(format, formatter);
+  return formatter;
+}
+
 } // namespace
 
+void DateTimeFormatter::initializeFixedWidth() {
+  std::string layout;
+  std::vector<FixedWidthField> fields;
+  uint32_t seen = 0;
+  for (const auto& token : tokens_) {
+    if (token.type == DateTimeToken::Type::kLiteral) {
+      // A literal that starts like a number would be taken as part of the
+      // previous field by the generic parser.
+      const auto& literal = token.literal;
+      if (literal.empty() || characterIsDigit(literal[0]) ||
+          literal[0] == '+' || literal[0] == '-') {
+        return;
+      }
+      layout.append(literal.data(), literal.size());
+      continue;
+    }
+    const auto width = fixedWidthDigits(token.pattern);
+    const auto bit = 1u << static_cast<int>(token.pattern.specifier);
+    if (width == 0 || (seen & bit)) {
+      return;
+    }
+    seen |= bit;
+    fields.push_back(
+        {token.pattern.specifier, static_cast<int32_t>(layout.size()), width});
+    layout.append(width, '0');
+  }
+  const auto yearBits =
+      (1u << static_cast<int>(DateTimeFormatSpecifier::YEAR)) |
+      (1u << static_cast<int>(DateTimeFormatSpecifier::YEAR_OF_ERA));
+  const auto monthDayBits =
+      (1u << static_cast<int>(DateTimeFormatSpecifier::MONTH_OF_YEAR)) |
+      (1u << static_cast<int>(DateTimeFormatSpecifier::DAY_OF_MONTH));
+  if ((seen & yearBits) == 0 || (seen & yearBits) == yearBits ||
+      (seen & monthDayBits) != monthDayBits) {
+    return;
+  }
+  fixedWidthTemplate_ = std::move(layout);
+  fixedWidthFields_ = std::move(fields);
+}
+
+bool DateTimeFormatter::tryParseFixedWidth(
+    const std::string_view& input,
+    DateTimeResult& result) const {
+  if (input.size() != fixedWidthTemplate_.size()) {
+    return false;
+  }
+  // Literals are where the template has non-digits.
+  int32_t fieldIndex = 0;
+  for (int32_t i = 0; i < input.size(); ++i) {
+    if (fieldIndex < fixedWidthFields_.size() &&
+        i == fixedWidthFields_[fieldIndex].offset) {
+      i += fixedWidthFields_[fieldIndex++].width - 1;
+    } else if (input[i] != fixedWidthTemplate_[i]) {
+      return false;
+    }
+  }
+
+  int32_t year = 0;
+  int32_t month = 0;
+  int32_t day = 0;
+  int32_t hour = 0;
+  int32_t minute = 0;
+  int32_t second = 0;
+  bool isYearOfEra = false;
+  for (const auto& field : fixedWidthFields_) {
+    int32_t value = 0;
+    for (auto i = 0; i < field.width; ++i) {
+      const char c = input[field.offset + i];
+      if (!characterIsDigit(c)) {
+        return false;
+      }
+      value = value * 10 + (c - '0');
+    }
+    switch (field.specifier) {
+      case DateTimeFormatSpecifier::YEAR_OF_ERA:
+        isYearOfEra = true;
+        [[fallthrough]];
+      case DateTimeFormatSpecifier::YEAR:
+        year = value;
+        break;
+      case DateTimeFormatSpecifier::MONTH_OF_YEAR:
+        month = value;
+        break;
+      case DateTimeFormatSpecifier::DAY_OF_MONTH:
+        day = value;
+        break;
+      case DateTimeFormatSpecifier::HOUR_OF_DAY:
+        hour = value;
+        break;
+      case DateTimeFormatSpecifier::MINUTE_OF_HOUR:
+        minute = value;
+        break;
+      case DateTimeFormatSpecifier::SECOND_OF_MINUTE:
+        second = value;
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+  }
+  // Out of range values go through the generic parser for its errors.
+  if ((isYearOfEra && year < 1) || month < 1 || month > 12 ||
+      !util::isValidDate(year, month, day) || hour > 23 || minute > 59 ||
+      second > 59) {
+    return false;
+  }
+  result = {
+      util::fromDatetime(
+          util::daysSinceEpochFromDate(year, month, day),
+          util::fromTime(hour, minute, second, 0)),
+      -1};
+  return true;
+}
+
+bool DateTimeFormatter::tryFormatFixedWidth(
+    const Timestamp& timestamp,
+    std::string& result) const {
+  const auto timePoint = timestamp.toTimePoint();
+  const auto daysTimePoint = date::floor<date::days>(timePoint);
+  const date::year_month_day calDate(daysTimePoint);
+  const auto year = static_cast<int32_t>(calDate.year());
+  if (year < 1 || year > 9'999) {
+    return false;
+  }
+  const auto secondsInTheDay =
+      std::chrono::duration_cast<std::chrono::seconds>(
+          timePoint - daysTimePoint)
+          .count();
+
+  result = fixedWidthTemplate_;
+  for (const auto& field : fixedWidthFields_) {
+    int32_t value;
+    switch (field.specifier) {
+      case DateTimeFormatSpecifier::YEAR:
+      case DateTimeFormatSpecifier::YEAR_OF_ERA:
+        value = year;
+        break;
+      case DateTimeFormatSpecifier::MONTH_OF_YEAR:
+        value = static_cast<unsigned>(calDate.month());
+        break;
+      case DateTimeFormatSpecifier::DAY_OF_MONTH:
+        value = static_cast<unsigned>(calDate.day());
+        break;
+      case DateTimeFormatSpecifier::HOUR_OF_DAY:
+        value = secondsInTheDay / 3'600;
+        break;
+      case DateTimeFormatSpecifier::MINUTE_OF_HOUR:
+        value = secondsInTheDay / 60 % 60;
+        break;
+      case DateTimeFormatSpecifier::SECOND_OF_MINUTE:
+        value = secondsInTheDay % 60;
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+    writeDigits(value, field.width, result.data() + field.offset);
+  }
+  return true;
+}
+
 std::string DateTimeFormatter::format(
     const Timestamp& timestamp,
     const date::time_zone* timezone) const {
@@ -934,6 +1151,10 @@ std::string DateTimeFormatter::format(
   if (timezone != nullptr) {
     t.toTimezone(*timezone);
   }
+  std::string result;
+  if (isFixedWidth() && tryFormatFixedWidth(t, result)) {
+    return result;
+  }
   const auto timePoint = t.toTimePoint();
   const auto daysTimePoint = date::floor<date::days>(timePoint);
 
@@ -941,7 +1162,6 @@ std::string DateTimeFormatter::format(
   const date::year_month_day calDate(daysTimePoint);
   const date::weekday weekday(daysTimePoint);
 
-  std::string result;
   for (auto& token : tokens_) {
     if (token.type == DateTimeToken::Type::kLiteral) {
       result += token.literal;
@@ -1109,6 +1329,11 @@ std::string DateTimeFormatter::format(
 }
 
 DateTimeResult DateTimeFormatter::parse(const std::string_view& input) const {
+  DateTimeResult result;
+  if (isFixedWidth() && tryParseFixedWidth(input, result)) {
+    return result;
+  }
+
   Date date;
   const char* cur = input.data();
   const char* end = cur + input.size();
@@ -1189,7 +1414,8 @@ DateTimeResult DateTimeFormatter::parse(const std::string_view& input) const {
       util::fromDatetime(daysSinceEpoch, microsSinceMidnight), date.timezoneId};
 }
 
-std::shared_ptr<DateTimeFormatter> buildMysqlDateTimeFormatter(
+namespace {
+std::shared_ptr<DateTimeFormatter> makeMysqlDateTimeFormatter(
     const std::string_view& format) {
   if (format.empty()) {
     VELOX_USER_FAIL("Both printing and parsing not supported");
@@ -1317,7 +1543,7 @@ std::shared_ptr<DateTimeFormatter> buildMysqlDateTimeFormatter(
   return builder.setType(DateTimeFormatterType::MYSQL).build();
 }
 
-std::shared_ptr<DateTimeFormatter> buildJodaDateTimeFormatter(
+std::shared_ptr<DateTimeFormatter> makeJodaDateTimeFormatter(
     const std::string_view& format) {
   if (format.empty()) {
     VELOX_USER_FAIL("Invalid pattern specification");
@@ -1438,5 +1664,18 @@ std::shared_ptr<DateTimeFormatter> buildJodaDateTimeFormatter(
   }
   return builder.setType(DateTimeFormatterType::JODA).build();
 }
+} // namespace
+
+std::shared_ptr<DateTimeFormatter> buildMysqlDateTimeFormatter(
+    const std::string_view& format) {
+  static FormatterCache cache;
+  return getCachedFormatter(cache, format, makeMysqlDateTimeFormatter);
+}
+
+std::shared_ptr<DateTimeFormatter> buildJodaDateTimeFormatter(
+    const std::string_view& format) {
+  static FormatterCache cache;
+  return getCachedFormatter(cache, format, makeJodaDateTimeFormatter);
+}
 
 } // namespace facebook::velox::functions
@@ -159,7 +159,9 @@ class DateTimeFormatter {
       : literalBuf_(std::move(literalBuf)),
         bufSize_(bufSize),
         tokens_(std::move(tokens)),
-        type_(type) {}
+        type_(type) {
+    initializeFixedWidth();
+  }
 
   const std::unique_ptr<char[]>& literalBuf() const {
     return literalBuf_;
@@ -179,16 +181,59 @@ class DateTimeFormatter {
       const Timestamp& timestamp,
       const date::time_zone* timezone) const;
 
+  /// True if the pattern has zero padded year, month and day fields,
+  /// optionally hour of day, minute and second fields, and literals that do
+  /// not start with digits, e.g. yyyy-MM-dd HH:mm:ss. Values of such
+  /// patterns have a fixed width and are parsed and formatted without
+  /// interpreting the tokens, unless they are out of range.
+  bool isFixedWidth() const {
+    return !fixedWidthTemplate_.empty();
+  }
+
  private:
+  // A numeric field of a fixed-width pattern.
+  struct FixedWidthField {
+    DateTimeFormatSpecifier specifier;
+    // Position of the first digit in the value.
+    int32_t offset;
+    // Number of digits.
+    int32_t width;
+  };
+
+  // Sets 'fixedWidthTemplate_' and 'fixedWidthFields_' if the pattern is
+  // fixed-width.
+  void initializeFixedWidth();
+
+  // Parses 'input' into 'result' if it has the layout of the fixed-width
+  // pattern and valid field values. Returns false otherwise, in which case
+  // 'input' is parsed by the tokens.
+  bool tryParseFixedWidth(const std::string_view& input, DateTimeResult& result)
+      const;
+
+  // Formats 'timestamp' into 'result' if its year has at most 4 digits.
+  // Returns false otherwise.
+  bool tryFormatFixedWidth(const Timestamp& timestamp, std::string& result)
+      const;
+
   std::unique_ptr<char[]> literalBuf_;
   size_t bufSize_;
   std::vector<DateTimeToken> tokens_;
   DateTimeFormatterType type_;
+
+  // A value of the fixed-width pattern with the literals in place and zeros
+  // for the fields. Empty if the pattern is not fixed-width.
+  std::string fixedWidthTemplate_;
+
+  std::vector<FixedWidthField> fixedWidthFields_;
 };
 
+/// Returns a formatter for the MySQL 'format'. Formatters are immutable and
+/// shared by all callers that use the same format.
 std::shared_ptr<DateTimeFormatter> buildMysqlDateTimeFormatter(
     const std::string_view& format);
 
+/// Returns a formatter for the Joda 'format'. Formatters are immutable and
+/// shared by all callers that use the same format.
 std::shared_ptr<DateTimeFormatter> buildJodaDateTimeFormatter(
     const std::string_view& format);
 
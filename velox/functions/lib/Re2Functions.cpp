@@ -18,6 +18,7 @@
 #include <re2/re2.h>
 #include <optional>
 #include <string>
+#include <string_view>
 
 #include "velox/expression/VectorWriters.h"
 
@@ -411,6 +412,18 @@ bool matchSuffixPattern(
           length) == 0;
 }
 
+// Returns true if string 'input' contains the first 'length' characters of
+// 'pattern'.
+bool matchSubstringPattern(
+    StringView input,
+    StringView pattern,
+    vector_size_t length) {
+  return input.size() >= length &&
+      std::string_view(input.data(), input.size())
+              .find(std::string_view(pattern.data(), length)) !=
+      std::string_view::npos;
+}
+
 template <PatternKind P>
 class OptimizedLikeWithMemcmp final : public VectorFunction {
  public:
@@ -431,6 +444,8 @@ class OptimizedLikeWithMemcmp final : public VectorFunction {
         return matchPrefixPattern(input, pattern_, reducedPatternLength_);
       case PatternKind::kSuffix:
         return matchSuffixPattern(input, pattern_, reducedPatternLength_);
+      case PatternKind::kSubstring:
+        return matchSubstringPattern(input, pattern_, reducedPatternLength_);
     }
   }
 
@@ -846,6 +861,9 @@ std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern) {
   vector_size_t i = 0;
   // Index of the first % or _ character.
   vector_size_t wildcardStart = -1;
+  // Index of the first % or _ character after the fixed pattern if the pattern
+  // also starts with a wildcard, such as the second '%' in '%foo%'.
+  vector_size_t trailingWildcardStart = -1;
   // Index of the first character that is not % and not _.
   vector_size_t fixedPatternStart = -1;
   // Total number of % characters.
@@ -857,13 +875,20 @@ std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern) {
   while (i < patternLength) {
     if (patternStr[i] == '%' || patternStr[i] == '_') {
       // Ensures that pattern has a single contiguous stream of wildcard
-      // characters.
-      if (wildcardStart != -1) {
+      // characters, or one on each side of the fixed pattern.
+      if (wildcardStart != 0 && wildcardStart != -1) {
         return std::make_pair(PatternKind::kGeneric, 0);
       }
+      if (wildcardStart == 0) {
+        if (trailingWildcardStart != -1) {
+          return std::make_pair(PatternKind::kGeneric, 0);
+        }
+        trailingWildcardStart = i;
+      } else {
+        wildcardStart = i;
+      }
       // Look till the last contiguous wildcard character, starting from this
       // index, is found, or the end of pattern is reached.
-      wildcardStart = i;
       while (i < patternLength &&
              (patternStr[i] == '%' || patternStr[i] == '_')) {
         singleCharacterWildcardCount += (patternStr[i] == '_');
@@ -900,6 +925,10 @@ std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern) {
   if (singleCharacterWildcardCount) {
     return {PatternKind::kGeneric, 0};
   }
+  // Pattern is a substring pattern if the fixed pattern is surrounded by '%'.
+  if (trailingWildcardStart != -1) {
+    return {PatternKind::kSubstring, trailingWildcardStart - fixedPatternStart};
+  }
   // Classify pattern as prefix pattern or suffix pattern based on the
   // positions of the fixed pattern and contiguous wildcard character stream.
   if (fixedPatternStart < wildcardStart) {
@@ -990,6 +1019,16 @@ std::shared_ptr<exec::VectorFunction> makeLike(
       case PatternKind::kSuffix:
         return std::make_shared<OptimizedLikeWithMemcmp<PatternKind::kSuffix>>(
             pattern, reducedLength);
+      case PatternKind::kSubstring: {
+        // Skip the leading '%' so that the fixed pattern starts at offset 0.
+        const auto fixedPatternStart =
+            std::string_view(pattern.data(), pattern.size())
+                .find_first_not_of('%');
+        return std::make_shared<
+            OptimizedLikeWithMemcmp<PatternKind::kSubstring>>(
+            StringView(pattern.data() + fixedPatternStart, reducedLength),
+            reducedLength);
+      }
       default:
         return std::make_shared<LikeWithRe2>(pattern, escapeChar);
     }
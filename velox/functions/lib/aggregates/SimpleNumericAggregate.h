@@ -114,7 +114,7 @@ class SimpleNumericAggregate : public exec::Aggregate {
     if (decoded.isConstantMapping()) {
       if (!decoded.isNullAt(0)) {
         auto value = decoded.valueAt<TValue>(0);
-        rows.applyToSelected([&](vector_size_t i) {
+        applyWithPrefetch(groups, rows, [&](vector_size_t i) {
           updateNonNullValue<tableHasNulls, TData>(
               groups[i], TData(value), updateSingleValue);
         });
@@ -129,7 +129,7 @@ class SimpleNumericAggregate : public exec::Aggregate {
       });
     } else if (decoded.isIdentityMapping() && !std::is_same_v<TValue, bool>) {
       auto data = decoded.data<TValue>();
-      rows.applyToSelected([&](vector_size_t i) {
+      applyWithPrefetch(groups, rows, [&](vector_size_t i) {
         updateNonNullValue<tableHasNulls, TData>(
             groups[i], TData(data[i]), updateSingleValue);
       });
@@ -226,6 +226,39 @@ class SimpleNumericAggregate : public exec::Aggregate {
   }
 
  private:
+  // Number of rows between prefetching the accumulator of a group and
+  // updating it.
+  static constexpr int32_t kPrefetchDistance = 16;
+
+  // Calls 'func' for each of 'rows' while prefetching the accumulators of the
+  // groups 'kPrefetchDistance' rows ahead. With many groups, the accumulators
+  // are scattered over a RowContainer much larger than the cache and the
+  // update loop would otherwise stall on a miss for almost every row.
+  template <typename Func>
+  void applyWithPrefetch(
+      char** groups,
+      const SelectivityVector& rows,
+      Func func) const {
+    if (!rows.isAllSelected()) {
+      rows.applyToSelected(func);
+      return;
+    }
+    const auto end = rows.end();
+    const auto prefetchEnd = std::max(0, end - kPrefetchDistance);
+    for (auto i = 0; i < std::min(kPrefetchDistance, end); ++i) {
+      __builtin_prefetch(groups[i] + exec::Aggregate::offset_);
+    }
+    vector_size_t i = 0;
+    for (; i < prefetchEnd; ++i) {
+      __builtin_prefetch(
+          groups[i + kPrefetchDistance] + exec::Aggregate::offset_);
+      func(i);
+    }
+    for (; i < end; ++i) {
+      func(i);
+    }
+  }
+
   // TData is either TAccumulator or TResult, which in most cases are the same,
   // but for sum(real) can differ.
   template <
@@ -20,6 +20,7 @@
 #include <string_view>
 #include "folly/CPortability.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/external/utf8proc/utf8procImpl.h"
 
 #if (ENABLE_VECTORIZATION > 0) && !defined(_DEBUG) && !defined(DEBUG)
@@ -47,8 +48,29 @@ namespace stringCore {
 /// Check if a given string is ascii
 static bool isAscii(const char* str, size_t length);
 
+/// Returns true if the xsimd::batch<int8_t>::size bytes starting at 'str' are
+/// all ascii.
+FOLLY_ALWAYS_INLINE bool isAsciiBlock(const char* str) {
+  auto block = xsimd::batch<int8_t>::load_unaligned(
+      reinterpret_cast<const int8_t*>(str));
+  return simd::toBitMask(block < xsimd::batch<int8_t>(0)) == 0;
+}
+
 FOLLY_ALWAYS_INLINE bool isAscii(const char* str, size_t length) {
-  for (auto i = 0; i < length; i++) {
+  constexpr size_t kBlockSize = xsimd::batch<int8_t>::size;
+  size_t i = 0;
+  if (length >= kBlockSize) {
+    // OR all full blocks together and check the sign bits once at the end.
+    auto bits = xsimd::batch<int8_t>(0);
+    for (; i + kBlockSize <= length; i += kBlockSize) {
+      bits |= xsimd::batch<int8_t>::load_unaligned(
+          reinterpret_cast<const int8_t*>(str + i));
+    }
+    if (simd::toBitMask(bits < xsimd::batch<int8_t>(0)) != 0) {
+      return false;
+    }
+  }
+  for (; i < length; i++) {
     if (str[i] & 0x80) {
       return false;
     }
@@ -218,10 +240,24 @@ applyAppendersRecursive(TOutStr& output, Func appenderFunc, Funcs... funcs) {
 FOLLY_ALWAYS_INLINE int64_t
 lengthUnicode(const char* inputBuffer, size_t bufferLength) {
   // First address after the last byte in the buffer
+  constexpr size_t kBlockSize = xsimd::batch<int8_t>::size;
   auto buffEndAddress = inputBuffer + bufferLength;
   auto currentChar = inputBuffer;
+  // End of the last block that was found to contain non-ascii characters.
+  // Blocks are not checked again until 'currentChar' passes it.
+  auto nonAsciiEnd = inputBuffer;
   int64_t size = 0;
   while (currentChar < buffEndAddress) {
+    // Every ascii byte is one character. Count whole blocks of them at once.
+    if (currentChar >= nonAsciiEnd &&
+        buffEndAddress - currentChar >= kBlockSize) {
+      if (isAsciiBlock(currentChar)) {
+        currentChar += kBlockSize;
+        size += kBlockSize;
+        continue;
+      }
+      nonAsciiEnd = currentChar + kBlockSize;
+    }
     auto chrOffset = utf8proc_char_length(currentChar);
     // Skip bad byte if we get utf length < 0.
     currentChar += UNLIKELY(chrOffset < 0) ? 1 : chrOffset;
@@ -197,6 +197,24 @@ TEST_F(StringImplTest, badUnicodeLength) {
   ASSERT_EQ(2, len);
 }
 
+// Long inputs are checked in blocks. Place a multi-byte character at every
+// offset of a long ascii string to cover block boundaries.
+TEST_F(StringImplTest, longMixedInputs) {
+  const std::string ascii(100, 'a');
+  ASSERT_TRUE(isAscii(ascii.data(), ascii.size()));
+  ASSERT_EQ(100, length</*isAscii*/ false>(ascii));
+
+  for (auto i = 0; i <= ascii.size(); ++i) {
+    auto input = ascii;
+    input.insert(i, "ӿ");
+    ASSERT_FALSE(isAscii(input.data(), input.size())) << i;
+    ASSERT_EQ(101, length</*isAscii*/ false>(input)) << i;
+
+    input.insert(0, "\U0001D437");
+    ASSERT_EQ(102, length</*isAscii*/ false>(input)) << i;
+  }
+}
+
 TEST_F(StringImplTest, codePointToString) {
   auto testValidInput = [](const int64_t codePoint,
                            const std::string& expectedString) {
@@ -2438,4 +2438,71 @@ TEST_F(MysqlDateTimeTest, parseConsecutiveSpecifiers) {
   EXPECT_THROW(parseMysql("1212", "%Y%H"), VeloxUserError);
 }
 
+TEST_F(DateTimeFormatterTest, fixedWidth) {
+  EXPECT_TRUE(
+      buildJodaDateTimeFormatter("yyyy-MM-dd HH:mm:ss")->isFixedWidth());
+  EXPECT_TRUE(buildJodaDateTimeFormatter("YYYY/MM/dd")->isFixedWidth());
+  EXPECT_TRUE(buildMysqlDateTimeFormatter("%Y%m%d %H%i%s")->isFixedWidth());
+  EXPECT_FALSE(buildJodaDateTimeFormatter("yyyy-MM")->isFixedWidth());
+  EXPECT_FALSE(buildJodaDateTimeFormatter("yyyy-M-dd")->isFixedWidth());
+  EXPECT_FALSE(buildJodaDateTimeFormatter("yyyy-MM-dd-MM")->isFixedWidth());
+  EXPECT_FALSE(buildJodaDateTimeFormatter("yyyy-MM-dd'1'HH")->isFixedWidth());
+  EXPECT_FALSE(buildMysqlDateTimeFormatter("%Y-%m-%d %h")->isFixedWidth());
+
+  // Formatters are shared by all users of a format.
+  EXPECT_EQ(
+      buildJodaDateTimeFormatter("yyyy-MM-dd"),
+      buildJodaDateTimeFormatter("yyyy-MM-dd"));
+  EXPECT_NE(
+      buildJodaDateTimeFormatter("yyyy-MM-dd"),
+      buildMysqlDateTimeFormatter("yyyy-MM-dd"));
+
+  EXPECT_EQ(
+      util::fromTimestampString("2021-02-28 23:59:01"),
+      parseJoda("2021-02-28 23:59:01", "yyyy-MM-dd HH:mm:ss").timestamp);
+  EXPECT_EQ(
+      -1, parseJoda("2021-02-28 23:59:01", "yyyy-MM-dd HH:mm:ss").timezoneId);
+  EXPECT_EQ(
+      util::fromTimestampString("2020-02-29"),
+      parseJoda("2020/02/29", "YYYY/MM/dd").timestamp);
+  EXPECT_EQ(
+      util::fromTimestampString("0012-12-01 10:11:12"),
+      parseMysql("00121201 101112", "%Y%m%d %H%i%s"));
+
+  // Values that do not fit the layout or are out of range take the generic
+  // path.
+  EXPECT_EQ(
+      util::fromTimestampString("2021-02-08"),
+      parseJoda("2021-2-8", "yyyy-MM-dd").timestamp);
+  EXPECT_EQ(
+      util::fromTimestampString("12021-02-08"),
+      parseJoda("12021-02-08", "yyyy-MM-dd").timestamp);
+  EXPECT_EQ(
+      util::fromTimestampString("-2021-02-08"),
+      parseJoda("-2021-02-08", "yyyy-MM-dd").timestamp);
+  EXPECT_THROW(parseJoda("2021-02-29", "yyyy-MM-dd"), VeloxUserError);
+  EXPECT_THROW(parseJoda("2021-13-01", "yyyy-MM-dd"), VeloxUserError);
+  EXPECT_THROW(parseJoda("2021-12-01 24", "yyyy-MM-dd HH"), VeloxUserError);
+  EXPECT_THROW(parseJoda("0000-12-01", "YYYY-MM-dd"), VeloxUserError);
+  EXPECT_THROW(parseJoda("2021x12-01", "yyyy-MM-dd"), VeloxUserError);
+
+  auto formatter = buildJodaDateTimeFormatter("yyyy-MM-dd HH:mm:ss");
+  EXPECT_EQ(
+      "2021-02-28 23:59:01",
+      formatter->format(
+          util::fromTimestampString("2021-02-28 23:59:01.999"), nullptr));
+  EXPECT_EQ(
+      "1969-12-31 23:59:59",
+      formatter->format(Timestamp::fromMillis(-1), nullptr));
+  EXPECT_EQ(
+      "12021-01-01 00:00:00",
+      formatter->format(
+          util::fromTimestampString("12021-01-01 00:00:00"), nullptr));
+  EXPECT_EQ(
+      "2021-02-28 15:59:01",
+      formatter->format(
+          util::fromTimestampString("2021-02-28 23:59:01"),
+          date::locate_zone("America/Los_Angeles")));
+}
+
 } // namespace facebook::velox::functions
@@ -440,6 +440,13 @@ TEST_F(Re2FunctionsTest, likeDeterminePatternKind) {
   testPattern("%%_%aBcD", PatternKind::kGeneric, 0);
   testPattern("%%a%%BcD", PatternKind::kGeneric, 0);
   testPattern("foo%bar", PatternKind::kGeneric, 0);
+
+  testPattern("%presto%", PatternKind::kSubstring, 6);
+  testPattern("%%hello%%%", PatternKind::kSubstring, 5);
+  testPattern("%a%", PatternKind::kSubstring, 1);
+  testPattern("%_a%", PatternKind::kGeneric, 0);
+  testPattern("%a_%", PatternKind::kGeneric, 0);
+  testPattern("%a%b%", PatternKind::kGeneric, 0);
 }
 
 TEST_F(Re2FunctionsTest, likePatternWildcard) {
@@ -593,6 +600,32 @@ TEST_F(Re2FunctionsTest, likePatternSuffix) {
   EXPECT_TRUE(like(input, generateString(kAnyWildcardCharacter) + input));
 }
 
+TEST_F(Re2FunctionsTest, likePatternSubstring) {
+  auto like = [&](std::string str, std::string pattern) {
+    auto likeResult = evaluateOnce<bool>(
+        fmt::format("like(c0, '{}')", pattern), std::make_optional(str));
+    VELOX_CHECK(likeResult, "Like operator evaluation failed");
+    return *likeResult;
+  };
+
+  EXPECT_TRUE(like("abcde", "%abcde%"));
+  EXPECT_TRUE(like("abcde", "%bcd%"));
+  EXPECT_TRUE(like("abcde", "%%a%"));
+  EXPECT_TRUE(like("abcde", "%e%%"));
+  EXPECT_TRUE(like("abcabcd", "%abcd%"));
+  EXPECT_FALSE(like("", "%a%"));
+  EXPECT_FALSE(like("abcde", "%abcdef%"));
+  EXPECT_FALSE(like("abcde", "%bd%"));
+  EXPECT_FALSE(like("ABCDE", "%bcd%"));
+  EXPECT_TRUE(like("\nabc\nde\n", "%c\nd%"));
+
+  std::string input = generateString(kLikePatternCharacterSet, 65);
+  EXPECT_TRUE(like(
+      "xy" + input + "z",
+      generateString(kAnyWildcardCharacter) + input +
+          generateString(kAnyWildcardCharacter)));
+}
+
 TEST_F(Re2FunctionsTest, likePatternAndEscape) {
   auto like = ([&](std::optional<std::string> str,
                    std::optional<std::string> pattern,
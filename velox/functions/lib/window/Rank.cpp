@@ -37,9 +37,8 @@ class RankFunction : public exec::WindowFunction {
       : WindowFunction(resultType, nullptr, nullptr) {}
 
   void resetPartition(const exec::WindowPartition* partition) override {
-    rank_ = 1;
+    denseRank_ = 1;
     currentPeerGroupStart_ = 0;
-    previousPeerCount_ = 0;
     numPartitionRows_ = partition->numRows();
   }
 
@@ -53,37 +52,42 @@ class RankFunction : public exec::WindowFunction {
       const VectorPtr& result) override {
     int numRows = peerGroupStarts->size() / sizeof(vector_size_t);
     auto* rawPeerStarts = peerGroupStarts->as<vector_size_t>();
-    auto rawValues = result->asFlatVector<TResult>()->mutableRawValues();
+    auto rawValues =
+        result->asFlatVector<TResult>()->mutableRawValues() + resultOffset;
 
-    for (int i = 0; i < numRows; i++) {
-      auto start = rawPeerStarts[i];
-      if (start != currentPeerGroupStart_) {
-        currentPeerGroupStart_ = start;
-        if constexpr (TRank == RankType::kDenseRank) {
-          if (previousPeerCount_ > 0) {
-            ++rank_;
-          }
-        } else {
-          rank_ += previousPeerCount_;
-        }
-        previousPeerCount_ = 0;
+    // The rank of a row is 1 + the offset of its peer group in the
+    // partition and the dense rank counts the peer group starts. The loops
+    // have no branches so that the compiler can vectorize them.
+    if constexpr (TRank == RankType::kRank) {
+      for (int i = 0; i < numRows; i++) {
+        rawValues[i] = rawPeerStarts[i] + 1;
       }
-
-      if constexpr (TRank == RankType::kPercentRank) {
-        rawValues[resultOffset + i] = (numPartitionRows_ == 1)
-            ? 0
-            : double(rank_ - 1) / (numPartitionRows_ - 1);
-      } else {
-        rawValues[resultOffset + i] = rank_;
+    } else if constexpr (TRank == RankType::kPercentRank) {
+      if (numPartitionRows_ == 1) {
+        std::fill(rawValues, rawValues + numRows, 0);
+        return;
+      }
+      const double denominator = numPartitionRows_ - 1;
+      for (int i = 0; i < numRows; i++) {
+        rawValues[i] = rawPeerStarts[i] / denominator;
+      }
+    } else {
+      auto rank = denseRank_;
+      auto previousStart = currentPeerGroupStart_;
+      for (int i = 0; i < numRows; i++) {
+        rank += rawPeerStarts[i] != previousStart;
+        previousStart = rawPeerStarts[i];
+        rawValues[i] = rank;
       }
-      previousPeerCount_ += 1;
+      denseRank_ = rank;
+      currentPeerGroupStart_ = previousStart;
     }
   }
 
  private:
+  // Start of the peer group of the last row and its dense rank.
   int32_t currentPeerGroupStart_ = 0;
-  int32_t previousPeerCount_ = 0;
-  int64_t rank_ = 1;
+  int64_t denseRank_ = 1;
   vector_size_t numPartitionRows_ = 1;
 };
 
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <array>
+
 #include <folly/container/F14Set.h>
 
 #include "velox/expression/EvalCtx.h"
@@ -24,6 +26,11 @@
 namespace facebook::velox::functions {
 namespace {
 
+// Arrays with at most this many elements are deduplicated by comparing each
+// element with the distinct elements before it, which is faster than a hash
+// set for short arrays.
+constexpr vector_size_t kMaxLinearDistinctSize = 16;
+
 /// See documentation at https://prestodb.io/docs/current/functions/array.html
 ///
 /// array_distinct SQL function.
@@ -98,12 +105,39 @@ class ArrayDistinctFunction : public exec::VectorFunction {
 
     // Process the rows: store unique values in the hash table.
     folly::F14FastSet<T> uniqueSet;
+    // The distinct values of a short array. Floating point values always use
+    // the hash table, which decides how NaNs and zeros compare.
+    std::array<T, kMaxLinearDistinctSize> distinctValues;
 
     rows.applyToSelected([&](vector_size_t row) {
       auto size = arrayVector->sizeAt(row);
       auto offset = arrayVector->offsetAt(row);
 
       rawOffsets[row] = indicesCursor;
+      if (!std::is_floating_point_v<T> && size <= kMaxLinearDistinctSize) {
+        int32_t numDistinct = 0;
+        bool hasNulls = false;
+        for (vector_size_t i = offset; i < offset + size; ++i) {
+          if (elements->isNullAt(i)) {
+            if (!hasNulls) {
+              hasNulls = true;
+              rawNewIndices[indicesCursor++] = i;
+            }
+            continue;
+          }
+          const auto value = elements->valueAt<T>(i);
+          if (std::find(
+                  distinctValues.begin(),
+                  distinctValues.begin() + numDistinct,
+                  value) == distinctValues.begin() + numDistinct) {
+            distinctValues[numDistinct++] = value;
+            rawNewIndices[indicesCursor++] = i;
+          }
+        }
+        rawSizes[row] = indicesCursor - rawOffsets[row];
+        return;
+      }
+
       bool hasNulls = false;
       for (vector_size_t i = offset; i < offset + size; ++i) {
         if (elements->isNullAt(i)) {
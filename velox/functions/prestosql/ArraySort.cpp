@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <array>
+
 #include <folly/container/F14Set.h>
 
 #include "velox/expression/EvalCtx.h"
@@ -102,6 +104,52 @@ inline void swapWithNull(
   vector->setNull(index, true);
 }
 
+// Arrays of integers with at least this many non-null elements are radix
+// sorted. Shorter ones are sorted faster by std::sort.
+constexpr vector_size_t kMinRadixSortSize = 256;
+
+template <typename T>
+constexpr bool kRadixSortable = std::is_integral_v<T> &&
+    !std::is_same_v<T, bool> && sizeof(T) <= sizeof(int64_t);
+
+// Sorts 'size' 'values' with a least significant byte first radix sort.
+// 'scratch' has space for 'size' values. Skips the bytes that are the same
+// in all values, e.g. the high bytes of small numbers.
+template <typename T>
+void radixSort(T* values, vector_size_t size, bool ascending, T* scratch) {
+  using U = std::make_unsigned_t<T>;
+  constexpr U kSignBit = U(1) << (sizeof(T) * 8 - 1);
+  // Flipping the sign bit orders signed values as unsigned.
+  const U flip = ascending ? kSignBit : static_cast<U>(~kSignBit);
+  T* from = values;
+  T* to = scratch;
+  for (int32_t shift = 0; shift < sizeof(T) * 8; shift += 8) {
+    std::array<vector_size_t, 256> offsets{};
+    auto byteAt = [&](T value) {
+      return ((static_cast<U>(value) ^ flip) >> shift) & 0xff;
+    };
+    for (auto i = 0; i < size; ++i) {
+      ++offsets[byteAt(from[i])];
+    }
+    if (offsets[byteAt(from[0])] == size) {
+      continue;
+    }
+    vector_size_t offset = 0;
+    for (auto& count : offsets) {
+      const auto start = offset;
+      offset += count;
+      count = start;
+    }
+    for (auto i = 0; i < size; ++i) {
+      to[offsets[byteAt(from[i])]++] = from[i];
+    }
+    std::swap(from, to);
+  }
+  if (from != values) {
+    std::copy(from, from + size, values);
+  }
+}
+
 template <TypeKind kind>
 void applyScalarType(
     const SelectivityVector& rows,
@@ -128,6 +176,18 @@ void applyScalarType(
 
   auto flatResults = resultElements->asFlatVector<T>();
 
+  // Scratch for radix sorting the longest array.
+  T* scratch = nullptr;
+  if constexpr (kRadixSortable<T>) {
+    vector_size_t maxSize = 0;
+    rows.applyToSelected([&](vector_size_t row) {
+      maxSize = std::max(maxSize, inputArray->sizeAt(row));
+    });
+    if (maxSize >= kMinRadixSortSize) {
+      scratch = context.allocateScratch<T>(maxSize);
+    }
+  }
+
   auto processRow = [&](vector_size_t row) {
     const auto size = inputArray->sizeAt(row);
     const auto offset = inputArray->offsetAt(row);
@@ -160,6 +220,16 @@ void applyScalarType(
       }
     } else {
       T* resultRawValues = flatResults->mutableRawValues();
+      if constexpr (kRadixSortable<T>) {
+        if (endRow - startRow >= kMinRadixSortSize) {
+          radixSort(
+              resultRawValues + startRow,
+              endRow - startRow,
+              ascending,
+              scratch);
+          return;
+        }
+      }
       if (ascending) {
         std::sort(resultRawValues + startRow, resultRawValues + endRow);
       } else {
@@ -85,13 +85,9 @@ struct TimestampWithTimezoneSupport {
   int64_t getGMTOffsetSec(
       const arg_type<TimestampWithTimezone>& timestampWithTimezone) {
     Timestamp inputTimeStamp = this->toTimestamp(timestampWithTimezone);
-    // Get the given timezone name
-    auto timezone =
-        util::getTimeZoneName(*timestampWithTimezone.template at<1>());
-    auto* timezonePtr = date::locate_zone(timezone);
     // Create a copy of inputTimeStamp and convert it to GMT
     auto gmtTimeStamp = inputTimeStamp;
-    gmtTimeStamp.toGMT(*timezonePtr);
+    gmtTimeStamp.toGMT(*timestampWithTimezone.template at<1>());
     // Get offset in seconds with GMT and convert to hour
     return (inputTimeStamp.getSeconds() - gmtTimeStamp.getSeconds());
   }
@@ -1082,6 +1078,9 @@ struct DateFormatFunction : public TimestampWithTimezoneSupport<T> {
   const date::time_zone* sessionTimeZone_ = nullptr;
   std::shared_ptr<DateTimeFormatter> mysqlDateTime_;
   bool isConstFormat_ = false;
+  // The format 'mysqlDateTime_' was built for if the format is not constant.
+  // Consecutive rows usually have the same format.
+  std::string lastFormat_;
 
   FOLLY_ALWAYS_INLINE void setFormatter(const arg_type<Varchar>* formatString) {
     if (formatString != nullptr) {
@@ -1111,8 +1110,11 @@ struct DateFormatFunction : public TimestampWithTimezoneSupport<T> {
       const arg_type<Timestamp>& timestamp,
       const arg_type<Varchar>& formatString) {
     if (!isConstFormat_) {
-      mysqlDateTime_ = buildMysqlDateTimeFormatter(
-          std::string_view(formatString.data(), formatString.size()));
+      const std::string_view format(formatString.data(), formatString.size());
+      if (!mysqlDateTime_ || format != lastFormat_) {
+        mysqlDateTime_ = buildMysqlDateTimeFormatter(format);
+        lastFormat_ = format;
+      }
     }
 
     auto formattedResult = mysqlDateTime_->format(timestamp, sessionTimeZone_);
@@ -1140,6 +1142,8 @@ struct DateParseFunction {
   std::shared_ptr<DateTimeFormatter> format_;
   std::optional<int64_t> sessionTzID_;
   bool isConstFormat_ = false;
+  // The format 'format_' was built for if the format is not constant.
+  std::string lastFormat_;
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& config,
@@ -1162,8 +1166,11 @@ struct DateParseFunction {
       const arg_type<Varchar>& input,
       const arg_type<Varchar>& format) {
     if (!isConstFormat_) {
-      format_ = buildMysqlDateTimeFormatter(
-          std::string_view(format.data(), format.size()));
+      const std::string_view formatView(format.data(), format.size());
+      if (!format_ || formatView != lastFormat_) {
+        format_ = buildMysqlDateTimeFormatter(formatView);
+        lastFormat_ = formatView;
+      }
     }
 
     auto dateTimeResult =
@@ -1185,6 +1192,8 @@ struct FormatDateTimeFunction {
   const date::time_zone* sessionTimeZone_ = nullptr;
   std::shared_ptr<DateTimeFormatter> jodaDateTime_;
   bool isConstFormat_ = false;
+  // The format 'jodaDateTime_' was built for if the format is not constant.
+  std::string lastFormat_;
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& config,
@@ -1203,8 +1212,11 @@ struct FormatDateTimeFunction {
       const arg_type<Timestamp>& timestamp,
       const arg_type<Varchar>& formatString) {
     if (!isConstFormat_) {
-      jodaDateTime_ = buildJodaDateTimeFormatter(
-          std::string_view(formatString.data(), formatString.size()));
+      const std::string_view format(formatString.data(), formatString.size());
+      if (!jodaDateTime_ || format != lastFormat_) {
+        jodaDateTime_ = buildJodaDateTimeFormatter(format);
+        lastFormat_ = format;
+      }
     }
 
     auto formattedResult = jodaDateTime_->format(timestamp, sessionTimeZone_);
@@ -1224,6 +1236,8 @@ struct ParseDateTimeFunction {
   std::shared_ptr<DateTimeFormatter> format_;
   std::optional<int64_t> sessionTzID_;
   bool isConstFormat_ = false;
+  // The format 'format_' was built for if the format is not constant.
+  std::string lastFormat_;
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& config,
@@ -1246,8 +1260,11 @@ struct ParseDateTimeFunction {
       const arg_type<Varchar>& input,
       const arg_type<Varchar>& format) {
     if (!isConstFormat_) {
-      format_ = buildJodaDateTimeFormatter(
-          std::string_view(format.data(), format.size()));
+      const std::string_view formatView(format.data(), format.size());
+      if (!format_ || formatView != lastFormat_) {
+        format_ = buildJodaDateTimeFormatter(formatView);
+        lastFormat_ = formatView;
+      }
     }
     auto dateTimeResult =
         format_->parse(std::string_view(input.data(), input.size()));
@@ -106,6 +106,69 @@ class DecimalBaseFunction : public exec::VectorFunction {
   const uint8_t bRescale_;
 };
 
+/// Adds, subtracts or multiplies two short decimals. The result of these on
+/// short decimals always fits in the result precision, which is at most 37
+/// digits, so the values are computed without overflow checks and
+/// exception handling in loops that the compiler can vectorize.
+template <typename R /* Result Type */, typename Operation>
+class ShortDecimalFunction : public exec::VectorFunction {
+ public:
+  ShortDecimalFunction(uint8_t aRescale, uint8_t bRescale)
+      : aScale_(DecimalUtil::kPowersOfTen[aRescale]),
+        bScale_(DecimalUtil::kPowersOfTen[bRescale]) {}
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& resultType,
+      exec::EvalCtx& context,
+      VectorPtr& result) const override {
+    context.ensureWritable(rows, resultType, result);
+    result->clearNulls(rows);
+    auto* rawResults =
+        result->asUnchecked<FlatVector<R>>()->mutableRawValues();
+
+    if (args[0]->isConstantEncoding() && args[1]->isFlatEncoding()) {
+      const R a = args[0]->asUnchecked<SimpleVector<int64_t>>()->valueAt(0);
+      auto* rawB = args[1]->asUnchecked<FlatVector<int64_t>>()->rawValues();
+      rows.applyToSelected([&](auto row) {
+        rawResults[row] = Operation::template applyNoOverflow<R>(
+            a, rawB[row], aScale_, bScale_);
+      });
+    } else if (args[0]->isFlatEncoding() && args[1]->isConstantEncoding()) {
+      auto* rawA = args[0]->asUnchecked<FlatVector<int64_t>>()->rawValues();
+      const R b = args[1]->asUnchecked<SimpleVector<int64_t>>()->valueAt(0);
+      rows.applyToSelected([&](auto row) {
+        rawResults[row] = Operation::template applyNoOverflow<R>(
+            rawA[row], b, aScale_, bScale_);
+      });
+    } else if (args[0]->isFlatEncoding() && args[1]->isFlatEncoding()) {
+      auto* rawA = args[0]->asUnchecked<FlatVector<int64_t>>()->rawValues();
+      auto* rawB = args[1]->asUnchecked<FlatVector<int64_t>>()->rawValues();
+      rows.applyToSelected([&](auto row) {
+        rawResults[row] = Operation::template applyNoOverflow<R>(
+            rawA[row], rawB[row], aScale_, bScale_);
+      });
+    } else {
+      exec::DecodedArgs decodedArgs(rows, args, context);
+      auto a = decodedArgs.at(0);
+      auto b = decodedArgs.at(1);
+      rows.applyToSelected([&](auto row) {
+        rawResults[row] = Operation::template applyNoOverflow<R>(
+            a->valueAt<int64_t>(row),
+            b->valueAt<int64_t>(row),
+            aScale_,
+            bScale_);
+      });
+    }
+  }
+
+ private:
+  // 10 to the power of the rescale factors.
+  const R aScale_;
+  const R bScale_;
+};
+
 template <
     typename R /* Result Type */,
     typename A /* Argument */,
@@ -292,6 +355,13 @@ class Addition {
     DecimalUtil::valueInRange(r);
   }
 
+  /// Adds two short decimals multiplied by 'aScale' and 'bScale'. The result
+  /// of adding short decimals cannot overflow.
+  template <typename R>
+  inline static R applyNoOverflow(R a, R b, R aScale, R bScale) {
+    return a * aScale + b * bScale;
+  }
+
   inline static uint8_t
   computeRescaleFactor(uint8_t fromScale, uint8_t toScale, uint8_t rScale = 0) {
     return std::max(0, toScale - fromScale);
@@ -334,6 +404,11 @@ class Subtraction {
     DecimalUtil::valueInRange(r);
   }
 
+  template <typename R>
+  inline static R applyNoOverflow(R a, R b, R aScale, R bScale) {
+    return a * aScale - b * bScale;
+  }
+
   inline static uint8_t
   computeRescaleFactor(uint8_t fromScale, uint8_t toScale, uint8_t rScale = 0) {
     return std::max(0, toScale - fromScale);
@@ -360,6 +435,13 @@ class Multiply {
     DecimalUtil::valueInRange(r);
   }
 
+  /// Multiplies two short decimals. The product has at most 36 digits.
+  /// Multiplication doesn't rescale the arguments.
+  template <typename R>
+  inline static R applyNoOverflow(R a, R b, R /*aScale*/, R /*bScale*/) {
+    return a * b;
+  }
+
   inline static uint8_t
   computeRescaleFactor(uint8_t fromScale, uint8_t toScale, uint8_t rScale = 0) {
     return 0;
@@ -706,6 +788,32 @@ std::shared_ptr<exec::VectorFunction> createDecimalFunction(
   VELOX_UNSUPPORTED();
 }
 
+/// Creates add, subtract or multiply. These never overflow on two short
+/// decimals, so use ShortDecimalFunction for those.
+template <typename Operation>
+std::shared_ptr<exec::VectorFunction> createDecimalArithmeticFunction(
+    const std::string& name,
+    const std::vector<exec::VectorFunctionArg>& inputArgs,
+    const core::QueryConfig& config) {
+  const auto& aType = inputArgs[0].type;
+  const auto& bType = inputArgs[1].type;
+  if (!aType->isShortDecimal() || !bType->isShortDecimal()) {
+    return createDecimalFunction<Operation>(name, inputArgs, config);
+  }
+  auto [aPrecision, aScale] = getDecimalPrecisionScale(*aType);
+  auto [bPrecision, bScale] = getDecimalPrecisionScale(*bType);
+  auto [rPrecision, rScale] = Operation::computeResultPrecisionScale(
+      aPrecision, aScale, bPrecision, bScale);
+  uint8_t aRescale = Operation::computeRescaleFactor(aScale, bScale, rScale);
+  uint8_t bRescale = Operation::computeRescaleFactor(bScale, aScale, rScale);
+  if (rPrecision > ShortDecimalType::kMaxPrecision) {
+    return std::make_shared<ShortDecimalFunction<int128_t, Operation>>(
+        aRescale, bRescale);
+  }
+  return std::make_shared<ShortDecimalFunction<int64_t, Operation>>(
+      aRescale, bRescale);
+}
+
 std::shared_ptr<exec::VectorFunction> createDecimalBetweenFunction(
     const std::string& name,
     const std::vector<exec::VectorFunctionArg>& inputArgs,
@@ -731,17 +839,17 @@ std::shared_ptr<exec::VectorFunction> createDecimalBetweenFunction(
 VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
     udf_decimal_add,
     decimalAddSubtractSignature(),
-    createDecimalFunction<Addition>);
+    createDecimalArithmeticFunction<Addition>);
 
 VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
     udf_decimal_sub,
     decimalAddSubtractSignature(),
-    createDecimalFunction<Subtraction>);
+    createDecimalArithmeticFunction<Subtraction>);
 
 VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
     udf_decimal_mul,
     decimalMultiplySignature(),
-    createDecimalFunction<Multiply>);
+    createDecimalArithmeticFunction<Multiply>);
 
 VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
     udf_decimal_div,
@@ -64,12 +64,20 @@ class FromUnixtimeFunction : public exec::VectorFunction {
       auto* rawTimezones =
           timezones->asFlatVector<int16_t>()->mutableRawValues();
 
+      // Consecutive rows usually have the same time zone. Looks up the ID
+      // only when the name changes.
+      std::string lastTimezoneName;
+      int16_t lastTimezoneId = -1;
       rows.applyToSelected([&](auto row) {
         rawTimestamps[row] = toMillis(unixtimes->valueAt<double>(row));
 
         auto timezoneName = timezoneNames->valueAt<StringView>(row);
-        rawTimezones[row] = util::getTimeZoneID(
-            std::string_view(timezoneName.data(), timezoneName.size()));
+        const std::string_view name(timezoneName.data(), timezoneName.size());
+        if (lastTimezoneId == -1 || name != lastTimezoneName) {
+          lastTimezoneId = util::getTimeZoneID(name);
+          lastTimezoneName = name;
+        }
+        rawTimezones[row] = lastTimezoneId;
       });
     }
 
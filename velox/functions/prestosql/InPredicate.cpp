@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/type/Filter.h"
 
@@ -449,6 +450,16 @@ class InPredicate : public exec::VectorFunction {
           }
         }
       });
+    } else if constexpr (
+        std::is_same_v<T, int64_t> || std::is_same_v<T, int32_t>) {
+      if (rows.isAllSelected()) {
+        testBatches(flatArg->rawValues(), rows.end(), rawResults);
+      } else {
+        rows.applyToSelected([&](auto row) {
+          bool pass = testFunction(flatArg->valueAtFast(row));
+          bits::setBit(rawResults, row, pass);
+        });
+      }
     } else {
       rows.applyToSelected([&](auto row) {
         bool pass = testFunction(flatArg->valueAtFast(row));
@@ -457,6 +468,30 @@ class InPredicate : public exec::VectorFunction {
     }
   }
 
+  // Sets the bits in 'rawResults' for the first 'numRows' of 'values' that
+  // are in the IN list. Tests a SIMD batch of values at a time, so a hash
+  // table filter probes for several values at once.
+  template <typename T>
+  void testBatches(const T* values, vector_size_t numRows, uint64_t* rawResults)
+      const {
+    constexpr int32_t kBatchSize = xsimd::batch<T>::size;
+    static_assert(64 % kBatchSize == 0);
+    const vector_size_t numFullWords = numRows / 64;
+    for (vector_size_t word = 0; word < numFullWords; ++word) {
+      uint64_t hits = 0;
+      const T* wordValues = values + word * 64;
+      for (auto i = 0; i < 64; i += kBatchSize) {
+        const uint64_t batchHits = simd::toBitMask(
+            filter_->testValues(xsimd::load_unaligned(wordValues + i)));
+        hits |= batchHits << i;
+      }
+      rawResults[word] = hits;
+    }
+    for (auto row = numFullWords * 64; row < numRows; ++row) {
+      bits::setBit(rawResults, row, filter_->testInt64(values[row]));
+    }
+  }
+
   const std::unique_ptr<common::Filter> filter_;
   const bool alwaysNull_;
 };
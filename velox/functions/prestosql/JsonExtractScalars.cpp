@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/functions/prestosql/JsonExtractScalars.h"
+
+#include <folly/container/F14Map.h>
+
+#include "velox/expression/VectorWriters.h"
+#include "velox/functions/prestosql/SIMDJsonFunctions.h"
+
+namespace facebook::velox::functions {
+namespace {
+
+class JsonExtractScalarsFunction : public exec::VectorFunction {
+ public:
+  explicit JsonExtractScalarsFunction(std::vector<std::string> paths)
+      : paths_(std::move(paths)) {}
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& outputType,
+      exec::EvalCtx& context,
+      VectorPtr& result) const override {
+    exec::LocalDecodedVector decodedJson(context, *args[0], rows);
+    auto* json = decodedJson.get();
+
+    context.ensureWritable(rows, outputType, result);
+    exec::VectorWriter<Array<Varchar>> resultWriter;
+    resultWriter.init(*result->as<ArrayVector>());
+
+    context.applyToSelectedNoThrow(rows, [&](auto row) {
+      resultWriter.setOffset(row);
+      const auto value = json->valueAt<StringView>(row);
+      simdjson::padded_string paddedJson(value.data(), value.size());
+      simdjson::ondemand::document jsonDoc;
+      if (parser_.iterate(paddedJson).get(jsonDoc)) {
+        // If there's an error parsing the JSON, all paths are null.
+        resultWriter.commitNull();
+        return;
+      }
+
+      auto& arrayWriter = resultWriter.current();
+      for (const auto& path : paths_) {
+        JsonScalarConsumer consumer;
+        if (simdJsonExtract(jsonDoc, StringView(path), consumer) &&
+            consumer.result().has_value()) {
+          arrayWriter.add_item().copy_from(*consumer.result());
+        } else {
+          arrayWriter.add_null();
+        }
+      }
+      resultWriter.commit(true);
+    });
+    resultWriter.finish();
+  }
+
+ private:
+  const std::vector<std::string> paths_;
+  // Documents are parsed with one parser and then rewound for each path.
+  mutable simdjson::ondemand::parser parser_;
+};
+
+struct TypedExprHasher {
+  size_t operator()(const core::ITypedExpr* expr) const {
+    return expr->hash();
+  }
+};
+
+struct TypedExprComparer {
+  bool operator()(const core::ITypedExpr* lhs, const core::ITypedExpr* rhs)
+      const {
+    return *lhs == *rhs;
+  }
+};
+
+// Distinct paths of json_extract_scalar calls keyed on the 'json' input.
+using PathGroups = folly::F14FastMap<
+    const core::ITypedExpr*,
+    std::vector<std::string>,
+    TypedExprHasher,
+    TypedExprComparer>;
+
+// Returns the path of a json_extract_scalar(json, 'path') call with a valid
+// constant path. Returns std::nullopt for all other expressions.
+std::optional<std::string> constantPath(
+    const std::string& functionName,
+    const core::TypedExprPtr& expr) {
+  auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get());
+  if (call == nullptr || call->name() != functionName ||
+      call->inputs().size() != 2) {
+    return std::nullopt;
+  }
+  auto constant =
+      dynamic_cast<const core::ConstantTypedExpr*>(call->inputs()[1].get());
+  if (constant == nullptr || !constant->type()->isVarchar()) {
+    return std::nullopt;
+  }
+
+  std::string path;
+  if (constant->hasValueVector()) {
+    auto vector = constant->valueVector();
+    if (vector->isNullAt(0)) {
+      return std::nullopt;
+    }
+    path = vector->as<SimpleVector<StringView>>()->valueAt(0).str();
+  } else {
+    if (constant->value().isNull()) {
+      return std::nullopt;
+    }
+    path = constant->value().value<TypeKind::VARCHAR>();
+  }
+
+  // Calls with invalid paths are left alone so that they fail on their own.
+  if (!detail::SIMDJsonExtractor::isValidPath(path)) {
+    return std::nullopt;
+  }
+  return path;
+}
+
+void collectPaths(
+    const std::string& functionName,
+    const core::TypedExprPtr& expr,
+    PathGroups& groups) {
+  if (auto path = constantPath(functionName, expr)) {
+    auto& paths = groups[expr->inputs()[0].get()];
+    if (std::find(paths.begin(), paths.end(), *path) == paths.end()) {
+      paths.push_back(std::move(*path));
+    }
+  }
+  for (const auto& input : expr->inputs()) {
+    collectPaths(functionName, input, groups);
+  }
+}
+
+// Returns a copy of 'expr' with 'inputs' or nullptr if 'expr' is of a kind
+// that is not re-written.
+core::TypedExprPtr withInputs(
+    const core::TypedExprPtr& expr,
+    const std::vector<core::TypedExprPtr>& inputs) {
+  if (auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get())) {
+    return std::make_shared<core::CallTypedExpr>(
+        call->type(), inputs, call->name());
+  }
+  if (auto cast = dynamic_cast<const core::CastTypedExpr*>(expr.get())) {
+    return std::make_shared<core::CastTypedExpr>(
+        cast->type(), inputs, cast->nullOnFailure());
+  }
+  if (auto field =
+          dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get())) {
+    return std::make_shared<core::FieldAccessTypedExpr>(
+        field->type(), inputs[0], field->name());
+  }
+  if (auto dereference =
+          dynamic_cast<const core::DereferenceTypedExpr*>(expr.get())) {
+    return std::make_shared<core::DereferenceTypedExpr>(
+        dereference->type(), inputs[0], dereference->index());
+  }
+  if (dynamic_cast<const core::ConcatTypedExpr*>(expr.get())) {
+    return std::make_shared<core::ConcatTypedExpr>(
+        expr->type()->asRow().names(), inputs);
+  }
+  return nullptr;
+}
+
+core::TypedExprPtr rewritePaths(
+    const std::string& prefix,
+    const core::TypedExprPtr& expr,
+    const PathGroups& groups) {
+  const auto functionName = prefix + "json_extract_scalar";
+  if (auto path = constantPath(functionName, expr)) {
+    const auto& json = expr->inputs()[0];
+    auto it = groups.find(json.get());
+    if (it != groups.end() && it->second.size() > 1) {
+      const auto& paths = it->second;
+      std::vector<core::TypedExprPtr> inputs{json};
+      for (const auto& groupPath : paths) {
+        inputs.push_back(
+            std::make_shared<core::ConstantTypedExpr>(VARCHAR(), groupPath));
+      }
+      auto extractAll = std::make_shared<core::CallTypedExpr>(
+          ARRAY(VARCHAR()), std::move(inputs), prefix + kJsonExtractScalars);
+
+      const int32_t index =
+          std::find(paths.begin(), paths.end(), *path) - paths.begin() + 1;
+      return std::make_shared<core::CallTypedExpr>(
+          VARCHAR(),
+          std::vector<core::TypedExprPtr>{
+              extractAll,
+              std::make_shared<core::ConstantTypedExpr>(INTEGER(), index)},
+          prefix + "subscript");
+    }
+  }
+
+  std::vector<core::TypedExprPtr> newInputs;
+  newInputs.reserve(expr->inputs().size());
+  bool changed = false;
+  for (const auto& input : expr->inputs()) {
+    newInputs.push_back(rewritePaths(prefix, input, groups));
+    changed |= newInputs.back() != input;
+  }
+  if (!changed) {
+    return expr;
+  }
+  auto rewritten = withInputs(expr, newInputs);
+  return rewritten ? rewritten : expr;
+}
+} // namespace
+
+std::vector<std::shared_ptr<exec::FunctionSignature>>
+jsonExtractScalarsSignatures() {
+  std::vector<std::shared_ptr<exec::FunctionSignature>> signatures;
+  // json|varchar, varchar... -> array(varchar)
+  for (const auto& inputType : {"json", "varchar"}) {
+    signatures.push_back(exec::FunctionSignatureBuilder()
+                             .returnType("array(varchar)")
+                             .argumentType(inputType)
+                             .argumentType("varchar")
+                             .variableArity()
+                             .build());
+  }
+  return signatures;
+}
+
+std::shared_ptr<exec::VectorFunction> makeJsonExtractScalars(
+    const std::string& name,
+    const std::vector<exec::VectorFunctionArg>& inputArgs,
+    const core::QueryConfig& /*config*/) {
+  VELOX_USER_CHECK_GE(
+      inputArgs.size(), 2, "{} requires at least 2 arguments", name);
+
+  std::vector<std::string> paths;
+  for (auto i = 1; i < inputArgs.size(); ++i) {
+    auto constantPath = inputArgs[i].constantValue.get();
+    VELOX_USER_CHECK(
+        constantPath != nullptr && !constantPath->isNullAt(0),
+        "{} requires constant paths",
+        name);
+    paths.push_back(
+        constantPath->as<ConstantVector<StringView>>()->valueAt(0).str());
+  }
+  return std::make_shared<JsonExtractScalarsFunction>(std::move(paths));
+}
+
+std::vector<core::TypedExprPtr> rewriteJsonExtractScalarCalls(
+    const std::string& prefix,
+    const std::vector<core::TypedExprPtr>& exprs) {
+  PathGroups groups;
+  for (const auto& expr : exprs) {
+    collectPaths(prefix + "json_extract_scalar", expr, groups);
+  }
+
+  bool hasGroup = false;
+  for (const auto& [json, paths] : groups) {
+    hasGroup |= paths.size() > 1;
+  }
+  if (!hasGroup ||
+      !exec::getVectorFunctionSignatures(prefix + "subscript").has_value()) {
+    return {};
+  }
+
+  std::vector<core::TypedExprPtr> rewritten;
+  rewritten.reserve(exprs.size());
+  for (const auto& expr : exprs) {
+    rewritten.push_back(rewritePaths(prefix, expr, groups));
+  }
+  return rewritten;
+}
+
+} // namespace facebook::velox::functions
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/core/Expressions.h"
+#include "velox/expression/VectorFunction.h"
+
+namespace facebook::velox::functions {
+
+/// Name of the internal function that extracts several JSON paths with one
+/// parse of each document:
+///
+///     $internal$json_extract_scalars(json, path1, ..., pathN) ->
+///         array(varchar)
+///
+/// Element i of the result is json_extract_scalar(json, path<i+1>). All paths
+/// must be constant.
+constexpr const char* kJsonExtractScalars = "$internal$json_extract_scalars";
+
+std::vector<std::shared_ptr<exec::FunctionSignature>>
+jsonExtractScalarsSignatures();
+
+std::shared_ptr<exec::VectorFunction> makeJsonExtractScalars(
+    const std::string& name,
+    const std::vector<exec::VectorFunctionArg>& inputArgs,
+    const core::QueryConfig& config);
+
+/// Analyzes json_extract_scalar(json, 'path') calls in 'exprs' to find calls
+/// with constant paths that share the same 'json' input. The calls in each
+/// group of two or more distinct paths are re-written into
+///
+///     subscript($internal$json_extract_scalars(json, path1, ..., pathN), i)
+///
+/// The $internal$json_extract_scalars calls of a group are identical, so
+/// common subexpression elimination evaluates them once per batch and each
+/// document is parsed once for all paths.
+///
+/// Returns the re-written expressions or an empty vector if no re-write is
+/// possible.
+std::vector<core::TypedExprPtr> rewriteJsonExtractScalarCalls(
+    const std::string& prefix,
+    const std::vector<core::TypedExprPtr>& exprs);
+
+} // namespace facebook::velox::functions
@@ -13,8 +13,11 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/functions/prestosql/Reduce.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/functions/lib/LambdaFunctionUtil.h"
+#include "velox/functions/lib/RowsTranslationUtil.h"
+#include "velox/functions/prestosql/CheckedArithmeticImpl.h"
 
 namespace facebook::velox::functions {
 namespace {
@@ -185,11 +188,254 @@ class ReduceFunction : public exec::VectorFunction {
                 .build()};
   }
 };
+// Sets sums[row] to the sum of 'initial' and the elements of the array at
+// 'row'. The sum is null if the array, 'initial' or any of the elements is
+// null. Integers are added with overflow checks, floating point values are
+// added in the order of the elements, same as (s, x) -> s + x would do.
+template <typename T>
+void sumArrays(
+    const SelectivityVector& rows,
+    const DecodedVector& decodedArray,
+    const DecodedVector& decodedInitial,
+    exec::EvalCtx& context,
+    FlatVector<T>& sums) {
+  auto* baseArray = decodedArray.base()->asUnchecked<ArrayVector>();
+  auto* rawOffsets = baseArray->rawOffsets();
+  auto* rawSizes = baseArray->rawSizes();
+
+  auto elementRows = toElementRows(
+      baseArray->elements()->size(), rows, baseArray, decodedArray.indices());
+  exec::LocalDecodedVector elementsDecoder(
+      context, *baseArray->elements(), elementRows);
+  auto& elements = *elementsDecoder.get();
+  const T* rawElements = nullptr;
+  if (elements.isIdentityMapping() && !elements.mayHaveNulls()) {
+    rawElements = elements.data<T>();
+  }
+
+  auto add = [](T sum, T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+      return sum + value;
+    } else {
+      return checkedPlus<T>(sum, value);
+    }
+  };
+
+  context.applyToSelectedNoThrow(rows, [&](auto row) {
+    if (decodedArray.isNullAt(row) || decodedInitial.isNullAt(row)) {
+      sums.setNull(row, true);
+      return;
+    }
+    const auto index = decodedArray.index(row);
+    const auto begin = rawOffsets[index];
+    const auto end = begin + rawSizes[index];
+    T sum = decodedInitial.valueAt<T>(row);
+    if (rawElements) {
+      for (auto i = begin; i < end; ++i) {
+        sum = add(sum, rawElements[i]);
+      }
+    } else {
+      for (auto i = begin; i < end; ++i) {
+        if (elements.isNullAt(i)) {
+          sums.setNull(row, true);
+          return;
+        }
+        sum = add(sum, elements.valueAt<T>(i));
+      }
+    }
+    sums.set(row, sum);
+  });
+}
+
+/// Implements $internal$reduce_sum. See Reduce.h.
+class ReduceSumFunction : public exec::VectorFunction {
+ public:
+  bool isDefaultNullBehavior() const override {
+    // The output function may have captures. See ReduceFunction.
+    return false;
+  }
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& /* outputType */,
+      exec::EvalCtx& context,
+      VectorPtr& result) const override {
+    VELOX_CHECK_EQ(args.size(), 3);
+
+    exec::LocalDecodedVector arrayDecoder(context, *args[0], rows);
+    exec::LocalDecodedVector initialDecoder(context, *args[1], rows);
+
+    const auto& type = args[1]->type();
+    auto sums = BaseVector::create(type, rows.end(), context.pool());
+    switch (type->kind()) {
+      case TypeKind::TINYINT:
+        sumArrays<int8_t>(
+            rows,
+            *arrayDecoder,
+            *initialDecoder,
+            context,
+            *sums->asFlatVector<int8_t>());
+        break;
+      case TypeKind::SMALLINT:
+        sumArrays<int16_t>(
+            rows,
+            *arrayDecoder,
+            *initialDecoder,
+            context,
+            *sums->asFlatVector<int16_t>());
+        break;
+      case TypeKind::INTEGER:
+        sumArrays<int32_t>(
+            rows,
+            *arrayDecoder,
+            *initialDecoder,
+            context,
+            *sums->asFlatVector<int32_t>());
+        break;
+      case TypeKind::BIGINT:
+        sumArrays<int64_t>(
+            rows,
+            *arrayDecoder,
+            *initialDecoder,
+            context,
+            *sums->asFlatVector<int64_t>());
+        break;
+      case TypeKind::REAL:
+        sumArrays<float>(
+            rows,
+            *arrayDecoder,
+            *initialDecoder,
+            context,
+            *sums->asFlatVector<float>());
+        break;
+      case TypeKind::DOUBLE:
+        sumArrays<double>(
+            rows,
+            *arrayDecoder,
+            *initialDecoder,
+            context,
+            *sums->asFlatVector<double>());
+        break;
+      default:
+        VELOX_UNREACHABLE(
+            "Unexpected type of reduce_sum: {}", type->toString());
+    }
+
+    // Apply output function.
+    const SelectivityVector& validRowsInReusedResult = rows;
+    VectorPtr localResult;
+    auto outputFuncIt = args[2]->asUnchecked<FunctionVector>()->iterator(&rows);
+    while (auto entry = outputFuncIt.next()) {
+      std::vector<VectorPtr> lambdaArgs = {sums};
+      entry.callable->apply(
+          *entry.rows,
+          &validRowsInReusedResult,
+          nullptr,
+          &context,
+          lambdaArgs,
+          nullptr,
+          &localResult);
+    }
+    context.moveOrCopyResult(localResult, rows, result);
+  }
+
+  static std::vector<std::shared_ptr<exec::FunctionSignature>> signatures() {
+    // array(T), T, function(T, R) -> R
+    std::vector<std::shared_ptr<exec::FunctionSignature>> signatures;
+    for (const auto& type :
+         {"tinyint", "smallint", "integer", "bigint", "real", "double"}) {
+      signatures.push_back(
+          exec::FunctionSignatureBuilder()
+              .typeVariable("R")
+              .returnType("R")
+              .argumentType(fmt::format("array({})", type))
+              .argumentType(type)
+              .argumentType(fmt::format("function({},R)", type))
+              .build());
+    }
+    return signatures;
+  }
+};
+
+bool isSummableType(const TypePtr& type) {
+  // Excludes decimals, dates and intervals that share the physical types.
+  static const std::vector<TypePtr> kSummableTypes = {
+      TINYINT(), SMALLINT(), INTEGER(), BIGINT(), REAL(), DOUBLE()};
+  for (const auto& summable : kSummableTypes) {
+    if (type->equivalent(*summable)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool isLambdaArgument(
+    const core::TypedExprPtr& expr,
+    const std::string& name) {
+  auto field = dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get());
+  return field != nullptr && field->inputs().empty() && field->name() == name;
+}
+
+// Returns true if 'lambda' is (s, x) -> s + x or (s, x) -> x + s.
+bool isSumOfArguments(
+    const std::string& prefix,
+    const core::LambdaTypedExpr& lambda) {
+  const auto& signature = lambda.signature();
+  if (signature->size() != 2) {
+    return false;
+  }
+  auto call = dynamic_cast<const core::CallTypedExpr*>(lambda.body().get());
+  if (call == nullptr || call->name() != prefix + "plus" ||
+      call->inputs().size() != 2 ||
+      !call->type()->equivalent(*signature->childAt(0))) {
+    return false;
+  }
+  const auto& state = signature->nameOf(0);
+  const auto& element = signature->nameOf(1);
+  const auto& inputs = call->inputs();
+  return (isLambdaArgument(inputs[0], state) &&
+          isLambdaArgument(inputs[1], element)) ||
+      (isLambdaArgument(inputs[0], element) &&
+       isLambdaArgument(inputs[1], state));
+}
 } // namespace
 
+core::TypedExprPtr rewriteReduceCall(
+    const std::string& prefix,
+    const core::TypedExprPtr& expr) {
+  auto call = std::dynamic_pointer_cast<const core::CallTypedExpr>(expr);
+  if (call == nullptr || call->name() != prefix + "reduce" ||
+      call->inputs().size() != 4) {
+    return nullptr;
+  }
+
+  const auto& inputs = call->inputs();
+  const auto& elementType = inputs[0]->type()->childAt(0);
+  if (!isSummableType(elementType) ||
+      !inputs[1]->type()->equivalent(*elementType)) {
+    return nullptr;
+  }
+
+  auto lambda = dynamic_cast<const core::LambdaTypedExpr*>(inputs[2].get());
+  if (lambda == nullptr || !isSumOfArguments(prefix, *lambda)) {
+    return nullptr;
+  }
+
+  return std::make_shared<core::CallTypedExpr>(
+      call->type(),
+      std::vector<core::TypedExprPtr>{inputs[0], inputs[1], inputs[3]},
+      prefix + kReduceSum);
+}
+
 VELOX_DECLARE_VECTOR_FUNCTION(
     udf_reduce,
     ReduceFunction::signatures(),
     std::make_unique<ReduceFunction>());
 
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_reduce_sum,
+    ReduceSumFunction::signatures(),
+    std::make_unique<ReduceSumFunction>());
+
 } // namespace facebook::velox::functions
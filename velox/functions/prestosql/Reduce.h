@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/core/Expressions.h"
+
+namespace facebook::velox::functions {
+
+/// Name of the internal function that sums up the elements of each array
+/// starting from an initial value and applies an output function to the sum:
+///
+///     $internal$reduce_sum(array(T), T, function(T, R)) -> R
+///
+/// T is one of TINYINT, SMALLINT, INTEGER, BIGINT, REAL or DOUBLE. The result
+/// is the same as that of reduce(array, initial, (s, x) -> s + x, output),
+/// including integer overflow errors and nulls, but the elements are added in
+/// one pass over each array instead of evaluating the lambda once per element
+/// position.
+constexpr const char* kReduceSum = "$internal$reduce_sum";
+
+/// Analyzes reduce(array, initial, (s, x) -> s + x, output) call to determine
+/// whether it can be re-written into
+///
+///     $internal$reduce_sum(array, initial, output)
+///
+/// The input function must add its two arguments (in either order) and
+/// nothing else, and the array elements and the state must be of the same
+/// integer or floating point type.
+///
+/// Returns new expression or nullptr if rewrite is not possible.
+core::TypedExprPtr rewriteReduceCall(
+    const std::string& prefix,
+    const core::TypedExprPtr& expr);
+
+} // namespace facebook::velox::functions
@@ -153,6 +153,48 @@ struct SIMDJsonArrayLengthFunction {
   }
 };
 
+// Consumer for simdJsonExtract() that keeps the scalar value matched by a JSON
+// path as a string. The result is null if the path matched nothing, more than
+// one value or a value that is not a scalar.
+class JsonScalarConsumer {
+ public:
+  template <typename TValue>
+  void operator()(TValue& v) {
+    if (resultPopulated_) {
+      // We should just get a single value, if we see multiple, it's an error
+      // and we should return null.
+      result_ = std::nullopt;
+      return;
+    }
+
+    resultPopulated_ = true;
+
+    switch (v.type()) {
+      case simdjson::ondemand::json_type::boolean:
+        result_ = v.get_bool().value() ? "true" : "false";
+        break;
+      case simdjson::ondemand::json_type::string:
+        result_ = v.get_string().value();
+        break;
+      case simdjson::ondemand::json_type::object:
+      case simdjson::ondemand::json_type::array:
+      case simdjson::ondemand::json_type::null:
+        // Do nothing.
+        break;
+      default:
+        result_ = simdjson::to_json_string(v).value();
+    }
+  }
+
+  const std::optional<std::string>& result() const {
+    return result_;
+  }
+
+ private:
+  bool resultPopulated_{false};
+  std::optional<std::string> result_;
+};
+
 // jsonExtractScalar(json, json_path) -> varchar
 // Like jsonExtract(), but returns the result value as a string (as opposed
 // to being encoded as JSON). The value referenced by json_path must be a scalar
@@ -165,42 +207,14 @@ struct SIMDJsonExtractScalarFunction {
       out_type<Varchar>& result,
       const arg_type<Json>& json,
       const arg_type<Varchar>& jsonPath) {
-    bool resultPopulated = false;
-    std::optional<std::string> resultStr;
-    auto consumer = [&resultStr, &resultPopulated](auto& v) {
-      if (resultPopulated) {
-        // We should just get a single value, if we see multiple, it's an error
-        // and we should return null.
-        resultStr = std::nullopt;
-        return;
-      }
-
-      resultPopulated = true;
-
-      switch (v.type()) {
-        case simdjson::ondemand::json_type::boolean:
-          resultStr = v.get_bool().value() ? "true" : "false";
-          break;
-        case simdjson::ondemand::json_type::string:
-          resultStr = v.get_string().value();
-          break;
-        case simdjson::ondemand::json_type::object:
-        case simdjson::ondemand::json_type::array:
-        case simdjson::ondemand::json_type::null:
-          // Do nothing.
-          break;
-        default:
-          resultStr = simdjson::to_json_string(v).value();
-      }
-    };
-
+    JsonScalarConsumer consumer;
     if (!simdJsonExtract(json, jsonPath, consumer)) {
       // If there's an error parsing the JSON, return null.
       return false;
     }
 
-    if (resultStr.has_value()) {
-      result.copy_from(*resultStr);
+    if (consumer.result().has_value()) {
+      result.copy_from(*consumer.result());
       return true;
     } else {
       return false;
@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <numeric>
+
 #include "velox/common/base/IOUtils.h"
 #include "velox/common/base/Macros.h"
 #include "velox/common/base/RandomUtil.h"
@@ -333,11 +335,13 @@ class ApproxPercentileAggregate : public exec::Aggregate {
             return;
           }
 
+          auto tracker = trackRowSize(groups[row]);
           auto accumulator = initRawAccumulator(groups[row]);
           accumulator->append(decodedValue_.valueAt<T>(row));
         });
       } else {
         rows.applyToSelected([&](auto row) {
+          auto tracker = trackRowSize(groups[row]);
           auto accumulator = initRawAccumulator(groups[row]);
           accumulator->append(decodedValue_.valueAt<T>(row));
         });
@@ -635,8 +639,13 @@ class ApproxPercentileAggregate : public exec::Aggregate {
 
     KllSketchAccumulator<T>* accumulator = nullptr;
     std::vector<typename KllSketch<T>::View> views;
-    if constexpr (kSingleGroup) {
-      views.reserve(rows.end());
+    views.reserve(rows.countSelected());
+    // For grouped input, the row number of each entry in 'views'. Sketches
+    // landing in the same group are merged together in one pass instead of
+    // compacting the target sketch once per input row.
+    std::vector<vector_size_t> viewRows;
+    if constexpr (!kSingleGroup) {
+      viewRows.reserve(views.capacity());
     }
     rows.applyToSelected([&](auto row) {
       if (decoded.isNullAt(row)) {
@@ -690,11 +699,9 @@ class ApproxPercentileAggregate : public exec::Aggregate {
               {rawLevels + levels->offsetAt(i),
                static_cast<size_t>(levels->sizeAt(i))},
       };
-      if constexpr (kSingleGroup) {
-        views.push_back(v);
-      } else {
-        auto tracker = trackRowSize(group[row]);
-        accumulator->append(v);
+      views.push_back(v);
+      if constexpr (!kSingleGroup) {
+        viewRows.push_back(row);
       }
     });
     if constexpr (kSingleGroup) {
@@ -702,6 +709,45 @@ class ApproxPercentileAggregate : public exec::Aggregate {
         auto tracker = trackRowSize(group);
         accumulator->append(views);
       }
+    } else {
+      mergeGroupedViews(group, viewRows, views);
+    }
+  }
+
+  // Merges views[i] into the accumulator of group[viewRows[i]]. Runs of
+  // views with the same group are merged with a single KllSketch::mergeViews
+  // call so that each target sketch is compacted once per batch.
+  void mergeGroupedViews(
+      char** groups,
+      const std::vector<vector_size_t>& viewRows,
+      std::vector<typename KllSketch<T>::View>& views) {
+    if (views.empty()) {
+      return;
+    }
+    std::vector<int32_t> order(views.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](auto left, auto right) {
+      return groups[viewRows[left]] < groups[viewRows[right]];
+    });
+    std::vector<typename KllSketch<T>::View> groupViews;
+    for (auto begin = 0; begin < order.size();) {
+      char* group = groups[viewRows[order[begin]]];
+      auto end = begin + 1;
+      while (end < order.size() && groups[viewRows[order[end]]] == group) {
+        ++end;
+      }
+      auto tracker = trackRowSize(group);
+      auto* accumulator = value<KllSketchAccumulator<T>>(group);
+      if (end - begin == 1) {
+        accumulator->append(views[order[begin]]);
+      } else {
+        groupViews.clear();
+        for (auto i = begin; i < end; ++i) {
+          groupViews.push_back(views[order[i]]);
+        }
+        accumulator->append(groupViews);
+      }
+      begin = end;
     }
   }
 };
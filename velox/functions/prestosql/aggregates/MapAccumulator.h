@@ -15,7 +15,7 @@
  */
 #pragma once
 
-#include <folly/container/F14Map.h>
+#include <folly/hash/Hash.h>
 #include "velox/common/memory/HashStringAllocator.h"
 #include "velox/exec/AddressableNonNullValueList.h"
 #include "velox/exec/Strings.h"
@@ -27,31 +27,157 @@
 namespace facebook::velox::aggregate::prestosql {
 
 namespace detail {
+/// Unique non-null keys of a map in the order of insertion with an open
+/// addressing hash table over them. The table and the keys share one
+/// contiguous block from HashStringAllocator that is doubled when the table
+/// is 3/4 full. A slot holds 32 bits of the hash of the key in the high half
+/// and 1 + the index of the key in the low half, 0 if the slot is empty. The
+/// hash bits filter out most mismatches without calling 'equalTo' and let the
+/// table grow without hashing the keys again.
+template <typename T, typename Hash, typename EqualTo>
+class MapKeys {
+ public:
+  static_assert(std::is_trivially_copyable_v<T>);
+
+  MapKeys(Hash hash, EqualTo equalTo) : hash_{hash}, equalTo_{equalTo} {}
+
+  /// Returns number of keys.
+  size_t size() const {
+    return size_;
+  }
+
+  /// Returns the key added 'index'-th.
+  const T& at(int32_t index) const {
+    return keys_[index];
+  }
+
+  bool contains(const T& key) const {
+    return capacity_ > 0 && findSlot(key, hashOf(key)).second;
+  }
+
+  /// Adds 'key' if it is not in the map yet. Returns true if 'key' was added.
+  bool insert(const T& key, HashStringAllocator& allocator) {
+    const auto hash = hashOf(key);
+    if (capacity_ == 0) {
+      grow(allocator);
+    }
+    auto [slot, found] = findSlot(key, hash);
+    if (found) {
+      return false;
+    }
+    if (size_ == maxSize(capacity_)) {
+      grow(allocator);
+      slot = findSlot(key, hash).first;
+    }
+    memcpy(&keys_[size_], &key, sizeof(T));
+    slots_[slot] = (static_cast<uint64_t>(hash) << 32) | (size_ + 1);
+    ++size_;
+    return true;
+  }
+
+  void free(HashStringAllocator& allocator) {
+    if (slots_ != nullptr) {
+      AlignedStlAllocator<char, 16>(&allocator).deallocate(
+          reinterpret_cast<char*>(slots_), allocationSize(capacity_));
+    }
+    slots_ = nullptr;
+    keys_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+  }
+
+ private:
+  static constexpr int32_t kMinCapacity = 8;
+  static constexpr uint64_t kIndexMask = 0xffffffff;
+
+  static int32_t maxSize(int32_t capacity) {
+    return capacity - capacity / 4;
+  }
+
+  static size_t allocationSize(int32_t capacity) {
+    return capacity * sizeof(uint64_t) + maxSize(capacity) * sizeof(T);
+  }
+
+  uint32_t hashOf(const T& key) const {
+    // Mixes the bits since std::hash of an integer is the integer.
+    return folly::hash::twang_32from64(hash_(key));
+  }
+
+  // Returns the slot with 'key' and true or the empty slot for 'key' and
+  // false.
+  std::pair<int32_t, bool> findSlot(const T& key, uint32_t hash) const {
+    const auto mask = capacity_ - 1;
+    for (int32_t slot = hash & mask;; slot = (slot + 1) & mask) {
+      const auto entry = slots_[slot];
+      if (entry == 0) {
+        return {slot, false};
+      }
+      if ((entry >> 32) == hash &&
+          equalTo_(keys_[(entry & kIndexMask) - 1], key)) {
+        return {slot, true};
+      }
+    }
+  }
+
+  void grow(HashStringAllocator& allocator) {
+    const int32_t newCapacity = std::max(kMinCapacity, capacity_ * 2);
+    auto* newSlots =
+        reinterpret_cast<uint64_t*>(AlignedStlAllocator<char, 16>(&allocator)
+                                        .allocate(allocationSize(newCapacity)));
+    // 'newCapacity' slots take a multiple of 64 bytes, so the keys are
+    // aligned.
+    auto* newKeys = reinterpret_cast<T*>(newSlots + newCapacity);
+    std::fill(newSlots, newSlots + newCapacity, 0);
+
+    const auto mask = newCapacity - 1;
+    for (auto i = 0; i < capacity_; ++i) {
+      const auto entry = slots_[i];
+      if (entry != 0) {
+        auto slot = (entry >> 32) & mask;
+        while (newSlots[slot] != 0) {
+          slot = (slot + 1) & mask;
+        }
+        newSlots[slot] = entry;
+      }
+    }
+    const auto size = size_;
+    if (size > 0) {
+      memcpy(newKeys, keys_, size * sizeof(T));
+    }
+    free(allocator);
+
+    slots_ = newSlots;
+    keys_ = newKeys;
+    capacity_ = newCapacity;
+    size_ = size;
+  }
+
+  uint64_t* slots_{nullptr};
+  T* keys_{nullptr};
+  int32_t capacity_{0};
+  int32_t size_{0};
+  Hash hash_;
+  EqualTo equalTo_;
+};
+
 /// Maintains a key-value map. Keys must be non-null.
 template <
     typename T,
     typename Hash = std::hash<T>,
     typename EqualTo = std::equal_to<T>>
 struct MapAccumulator {
-  // Value is the index of the corresponding entry in 'values'.
-  folly::F14FastMap<
-      T,
-      int32_t,
-      Hash,
-      EqualTo,
-      AlignedStlAllocator<std::pair<const T, int32_t>, 16>>
-      keys;
+  // The i-th key corresponds to the i-th entry in 'values'.
+  MapKeys<T, Hash, EqualTo> keys;
   ValueList values;
 
-  MapAccumulator(const TypePtr& /*type*/, HashStringAllocator* allocator)
-      : keys{AlignedStlAllocator<std::pair<const T, int32_t>, 16>(allocator)} {}
+  MapAccumulator(const TypePtr& /*type*/, HashStringAllocator* /*allocator*/)
+      : keys{Hash{}, EqualTo{}} {}
 
-  MapAccumulator(Hash hash, EqualTo equalTo, HashStringAllocator* allocator)
-      : keys{
-            0,
-            hash,
-            equalTo,
-            AlignedStlAllocator<std::pair<const T, int32_t>, 16>(allocator)} {}
+  MapAccumulator(
+      Hash hash,
+      EqualTo equalTo,
+      HashStringAllocator* /*allocator*/)
+      : keys{hash, equalTo} {}
 
   /// Adds key-value pair if entry with that key doesn't exist yet.
   void insert(
@@ -60,8 +186,7 @@ struct MapAccumulator {
       vector_size_t index,
       HashStringAllocator& allocator) {
     // Drop duplicate keys.
-    auto cnt = keys.size();
-    if (keys.insert({decodedKeys.valueAt<T>(index), cnt}).second) {
+    if (keys.insert(decodedKeys.valueAt<T>(index), allocator)) {
       values.appendValue(decodedValues, index, &allocator);
     }
   }
@@ -75,37 +200,23 @@ struct MapAccumulator {
       const VectorPtr& mapKeys,
       const VectorPtr& mapValues,
       vector_size_t offset) {
-    const auto mapSize = keys.size();
-
-    // Align keys and values as the order of keys in 'keys' may not match the
-    // order of values in 'values'.
-    folly::F14FastMap<int32_t, int32_t> indices;
-
     auto flatKeys = mapKeys->asFlatVector<T>();
-
-    vector_size_t index = offset;
-    for (auto value : keys) {
-      flatKeys->set(index, value.first);
-      indices[value.second] = index - offset;
-      ++index;
+    for (auto i = 0; i < keys.size(); ++i) {
+      flatKeys->set(offset + i, keys.at(i));
     }
 
-    extractValues(mapValues, offset, mapSize, indices);
+    extractValues(mapValues, offset);
   }
 
-  void extractValues(
-      const VectorPtr& mapValues,
-      vector_size_t offset,
-      int32_t mapSize,
-      const folly::F14FastMap<int32_t, int32_t>& indices) {
+  void extractValues(const VectorPtr& mapValues, vector_size_t offset) {
     ValueListReader valuesReader(values);
-    for (auto index = 0; index < mapSize; ++index) {
-      valuesReader.next(*mapValues, offset + indices.at(index));
+    for (auto i = 0; i < keys.size(); ++i) {
+      valuesReader.next(*mapValues, offset + i);
     }
   }
 
   void free(HashStringAllocator& allocator) {
-    std::destroy_at(&keys);
+    keys.free(allocator);
     values.free(&allocator);
   }
 };
@@ -134,8 +245,7 @@ struct StringViewMapAccumulator {
       key = strings.append(key, allocator);
     }
 
-    auto cnt = base.keys.size();
-    if (base.keys.insert({key, cnt}).second) {
+    if (base.keys.insert(key, allocator)) {
       base.values.appendValue(decodedValues, index, &allocator);
     }
   }
@@ -182,8 +292,7 @@ struct ComplexTypeMapAccumulator {
       HashStringAllocator& allocator) {
     auto position = serializedKeys.append(decodedKeys, index, &allocator);
 
-    auto cnt = base.keys.size();
-    if (!base.keys.insert({position, cnt}).second) {
+    if (!base.keys.insert(position, allocator)) {
       serializedKeys.removeLast(position);
       return;
     }
@@ -199,19 +308,11 @@ struct ComplexTypeMapAccumulator {
       const VectorPtr& mapKeys,
       const VectorPtr& mapValues,
       vector_size_t offset) {
-    const auto mapSize = base.keys.size();
-
-    folly::F14FastMap<int32_t, int32_t> indices;
-    indices.reserve(mapSize);
-
-    vector_size_t index = offset;
-    for (const auto& value : base.keys) {
-      AddressableNonNullValueList::read(value.first, *mapKeys, index);
-      indices[value.second] = index - offset;
-      ++index;
+    for (auto i = 0; i < base.keys.size(); ++i) {
+      AddressableNonNullValueList::read(base.keys.at(i), *mapKeys, offset + i);
     }
 
-    base.extractValues(mapValues, offset, mapSize, indices);
+    base.extractValues(mapValues, offset);
   }
 
   void free(HashStringAllocator& allocator) {
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/functions/prestosql/aggregates/MapAccumulator.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
+
+DEFINE_int32(num_groups, 100'000, "Number of maps to accumulate");
+DEFINE_int32(num_keys, 100, "Number of distinct keys per map");
+
+using namespace facebook::velox;
+using namespace facebook::velox::aggregate::prestosql;
+
+namespace {
+
+// Adds 'FLAGS_num_keys' distinct keys, each twice, to each of
+// 'FLAGS_num_groups' accumulators the way map_agg does for a batch of rows
+// ordered by group, then extracts all maps.
+class MapAccumulatorBenchmark {
+ public:
+  template <typename T>
+  void run(const VectorPtr& keys) {
+    folly::BenchmarkSuspender suspender;
+    auto allocator = std::make_unique<HashStringAllocator>(pool_.get());
+    auto values = maker_.flatVector<int64_t>(
+        keys->size(), [](auto row) { return row; });
+    DecodedVector decodedKeys(*keys);
+    DecodedVector decodedValues(*values);
+    std::vector<MapAccumulator<T>> accumulators;
+    accumulators.reserve(FLAGS_num_groups);
+    for (auto i = 0; i < FLAGS_num_groups; ++i) {
+      accumulators.emplace_back(keys->type(), allocator.get());
+    }
+    suspender.dismiss();
+
+    size_t totalSize = 0;
+    for (auto& accumulator : accumulators) {
+      for (auto i = 0; i < keys->size(); ++i) {
+        accumulator.insert(decodedKeys, decodedValues, i, *allocator);
+      }
+      totalSize += accumulator.size();
+    }
+
+    auto mapKeys = BaseVector::create(keys->type(), totalSize, pool_.get());
+    auto mapValues = BaseVector::create(BIGINT(), totalSize, pool_.get());
+    vector_size_t offset = 0;
+    for (auto& accumulator : accumulators) {
+      accumulator.extract(mapKeys, mapValues, offset);
+      offset += accumulator.size();
+      accumulator.free(*allocator);
+    }
+    folly::doNotOptimizeAway(mapValues);
+  }
+
+  VectorPtr makeBigintKeys() {
+    return maker_.flatVector<int64_t>(
+        2 * FLAGS_num_keys,
+        [](auto row) { return (row % FLAGS_num_keys) * 1'000'003; });
+  }
+
+  VectorPtr makeVarcharKeys() {
+    return maker_.flatVector<std::string>(2 * FLAGS_num_keys, [](auto row) {
+      return fmt::format("key of a map {}", row % FLAGS_num_keys);
+    });
+  }
+
+ private:
+  std::shared_ptr<memory::MemoryPool> pool_{memory::addDefaultLeafMemoryPool()};
+  test::VectorMaker maker_{pool_.get()};
+};
+
+std::unique_ptr<MapAccumulatorBenchmark> benchmark;
+
+BENCHMARK(bigintKeys) {
+  benchmark->run<int64_t>(benchmark->makeBigintKeys());
+}
+
+BENCHMARK(varcharKeys) {
+  benchmark->run<StringView>(benchmark->makeVarcharKeys());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<MapAccumulatorBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
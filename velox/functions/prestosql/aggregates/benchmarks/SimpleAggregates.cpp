@@ -44,6 +44,7 @@ class SimpleAggregatesBenchmark : public HiveConnectorTestBase {
         {"k_array", INTEGER()},
         {"k_norm", INTEGER()},
         {"k_hash", INTEGER()},
+        {"k_unique", BIGINT()},
         {"i32", INTEGER()},
         {"i64", BIGINT()},
         {"f32", REAL()},
@@ -85,6 +86,11 @@ class SimpleAggregatesBenchmark : public HiveConnectorTestBase {
       // values).
       children.emplace_back(fuzzer.fuzzFlat(INTEGER()));
 
+      // Generate key with a unique value in each row (10M total values). The
+      // accumulators of the groups do not fit in cache.
+      children.emplace_back(makeFlatVector<int64_t>(
+          kRowsPerVector, [&](auto row) { return i * kRowsPerVector + row; }));
+
       // Generate random values without nulls.
       children.emplace_back(fuzzer.fuzzFlat(INTEGER()));
       // fuzzer.fuzzFlat(BIGINT()) generates very large number causing sum() to
@@ -233,12 +239,14 @@ BENCHMARK_DRAW_LINE();
 AGG_BENCHMARKS(count, k_array)
 AGG_BENCHMARKS(count, k_norm)
 AGG_BENCHMARKS(count, k_hash)
+AGG_BENCHMARKS(count, k_unique)
 BENCHMARK_DRAW_LINE();
 
 // Sum aggregate.
 AGG_BENCHMARKS(sum, k_array)
 AGG_BENCHMARKS(sum, k_norm)
 AGG_BENCHMARKS(sum, k_hash)
+AGG_BENCHMARKS(sum, k_unique)
 BENCHMARK_DRAW_LINE();
 
 // Avg aggregate.
@@ -251,12 +259,14 @@ BENCHMARK_DRAW_LINE();
 AGG_BENCHMARKS(min, k_array)
 AGG_BENCHMARKS(min, k_norm)
 AGG_BENCHMARKS(min, k_hash)
+AGG_BENCHMARKS(min, k_unique)
 BENCHMARK_DRAW_LINE();
 
 // Max aggregate.
 AGG_BENCHMARKS(max, k_array)
 AGG_BENCHMARKS(max, k_norm)
 AGG_BENCHMARKS(max, k_hash)
+AGG_BENCHMARKS(max, k_unique)
 BENCHMARK_DRAW_LINE();
 
 // Stddev aggregate.
@@ -381,6 +381,48 @@ TEST_F(ApproxPercentileTest, finalAggregateAccuracy) {
   assertQuery(op, "SELECT 5");
 }
 
+TEST_F(ApproxPercentileTest, finalAggregateManySketchesPerGroup) {
+  // Build a single batch of intermediate results holding many sketches for
+  // each group so that the final aggregation merges them in one pass.
+  constexpr int32_t kNumGroups = 17;
+  constexpr int32_t kNumBatches = 20;
+  RowVectorPtr intermediate;
+  for (int32_t i = 0; i < kNumBatches; ++i) {
+    auto data = makeRowVector({
+        makeFlatVector<int32_t>(
+            1'000, [](auto row) { return row % kNumGroups; }),
+        makeFlatVector<int32_t>(
+            1'000,
+            [&](auto row) {
+              return (row % kNumGroups) * 100 + (i < 15 ? 0 : 50);
+            }),
+    });
+    auto partial = AssertQueryBuilder(
+                       PlanBuilder()
+                           .values({data})
+                           .partialAggregation(
+                               {"c0"}, {"approx_percentile(c1, 0.5)"})
+                           .planNode())
+                       .copyResults(pool());
+    if (!intermediate) {
+      intermediate = partial;
+    } else {
+      intermediate->append(partial.get());
+    }
+  }
+
+  auto op =
+      PlanBuilder()
+          .values({intermediate})
+          .finalAggregation({"c0"}, {"approx_percentile(a0)"}, {INTEGER()})
+          .planNode();
+  auto expected = makeRowVector({
+      makeFlatVector<int32_t>(kNumGroups, [](auto row) { return row; }),
+      makeFlatVector<int32_t>(kNumGroups, [](auto row) { return row * 100; }),
+  });
+  AssertQueryBuilder(op).assertResults(expected);
+}
+
 TEST_F(ApproxPercentileTest, invalidEncoding) {
   auto indices = AlignedBuffer::allocate<vector_size_t>(3, pool());
   auto rawIndices = indices->asMutable<vector_size_t>();
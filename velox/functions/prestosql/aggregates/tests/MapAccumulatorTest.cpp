@@ -104,6 +104,30 @@ TEST_F(MapAccumulatorTest, integerKeys) {
   test<int32_t>(keys, values);
 }
 
+// Enough keys to grow the hash table several times, with integer keys that
+// differ only in high bits and long string keys.
+TEST_F(MapAccumulatorTest, manyKeys) {
+  constexpr int32_t kNumKeys = 5'000;
+  auto keys = makeFlatVector<int64_t>(
+      4 * kNumKeys, [](auto row) { return (row % kNumKeys) * 1024; });
+  auto values = makeFlatVector<int32_t>(4 * kNumKeys, folly::identity);
+  auto expected = makeMapVector(
+      {0},
+      makeFlatVector<int64_t>(kNumKeys, [](auto row) { return row * 1024; }),
+      makeFlatVector<int32_t>(kNumKeys, folly::identity));
+  test<int64_t>(keys, values, expected);
+
+  auto makeString = [](auto row) {
+    return fmt::format("a string that is not inlined {}", row % kNumKeys);
+  };
+  auto stringKeys = makeFlatVector<std::string>(4 * kNumKeys, makeString);
+  expected = makeMapVector(
+      {0},
+      makeFlatVector<std::string>(kNumKeys, makeString),
+      makeFlatVector<int32_t>(kNumKeys, folly::identity));
+  test<StringView>(stringKeys, values, expected);
+}
+
 TEST_F(MapAccumulatorTest, strings) {
   std::vector<std::string> s = {
       "grapes",
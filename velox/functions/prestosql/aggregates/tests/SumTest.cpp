@@ -581,7 +581,24 @@ void testHookLimits(bool expectOverflow = false) {
   }
 }
 
+TEST_F(SumTest, hookKinds) {
+  EXPECT_EQ(
+      (aggregate::SumHook<int8_t, int64_t>(0, 0, 0, nullptr, nullptr).kind()),
+      aggregate::AggregationHook::kSumTinyintToBigint);
+  EXPECT_EQ(
+      (aggregate::SumHook<int16_t, int64_t>(0, 0, 0, nullptr, nullptr).kind()),
+      aggregate::AggregationHook::kSumSmallintToBigint);
+  EXPECT_EQ(
+      (aggregate::SumHook<int32_t, int64_t>(0, 0, 0, nullptr, nullptr).kind()),
+      aggregate::AggregationHook::kSumIntegerToBigint);
+  EXPECT_EQ(
+      (aggregate::SumHook<int64_t, int64_t>(0, 0, 0, nullptr, nullptr).kind()),
+      aggregate::AggregationHook::kSumBigintToBigint);
+}
+
 TEST_F(SumTest, hookLimits) {
+  testHookLimits<int8_t, int64_t>();
+  testHookLimits<int16_t, int64_t>();
   testHookLimits<int32_t, int64_t>();
   testHookLimits<int64_t, int64_t>(true);
   // Float and Double do not throw an overflow error.
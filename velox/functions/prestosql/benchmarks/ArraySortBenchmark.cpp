@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/benchmarks/ExpressionBenchmarkBuilder.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+
+using namespace facebook::velox;
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+
+  functions::prestosql::registerArrayFunctions();
+
+  ExpressionBenchmarkBuilder benchmarkBuilder;
+
+  // Arrays of up to 'maxLength' elements. Arrays of 256 or more integers
+  // are radix sorted and arrays of up to 16 elements are deduplicated
+  // without a hash table.
+  auto createSet = [&](const TypePtr& elementType, size_t maxLength) {
+    benchmarkBuilder
+        .addBenchmarkSet(
+            fmt::format("{}_{}", elementType->toString(), maxLength),
+            ROW({"c0"}, {ARRAY(elementType)}))
+        .withFuzzerOptions(
+            {.vectorSize = 1'000,
+             .nullRatio = 0.01,
+             .containerLength = maxLength,
+             .complexElementsMaxSize = 1'000 * maxLength})
+        .addExpression("sort", "array_sort(c0)")
+        .addExpression("sort_desc", "array_sort_desc(c0)")
+        .addExpression("distinct", "array_distinct(c0)");
+  };
+
+  for (const auto& elementType :
+       std::vector<TypePtr>{INTEGER(), BIGINT(), DOUBLE()}) {
+    for (size_t maxLength : {10, 100, 1'000}) {
+      createSet(elementType, maxLength);
+    }
+  }
+
+  benchmarkBuilder.registerBenchmarks();
+
+  folly::runBenchmarks();
+  return 0;
+}
@@ -124,6 +124,49 @@ class DateTimeBenchmark : public functions::test::FunctionBenchmarkBase {
     doRun(exprSet, data);
   }
 
+  // Evaluates 'expression' over timestamps of recent years in c0 and
+  // 'format' in each row of c1.
+  void runFormat(const std::string& expression, const std::string& format) {
+    folly::BenchmarkSuspender suspender;
+    auto data = makeTimestamps(format);
+    auto exprSet = compileExpression(expression, data->type());
+    suspender.dismiss();
+
+    doRun(exprSet, data);
+  }
+
+  // Evaluates 'functionName' over timestamps of recent years with the
+  // session time zone set to 'timezone'.
+  void runAtTimezone(
+      const std::string& functionName,
+      const std::string& timezone) {
+    folly::BenchmarkSuspender suspender;
+    queryCtx_->testingOverrideConfigUnsafe({
+        {core::QueryConfig::kSessionTimezone, timezone},
+        {core::QueryConfig::kAdjustTimestampToTimezone, "true"},
+    });
+    auto data = makeTimestamps("");
+    auto exprSet =
+        compileExpression(fmt::format("{}(c0)", functionName), data->type());
+    suspender.dismiss();
+
+    doRun(exprSet, data);
+  }
+
+  // Evaluates 'expression' over timestamps of recent years formatted with
+  // Joda 'format' in c0 and 'format' in each row of c1.
+  void runParse(const std::string& expression, const std::string& format) {
+    folly::BenchmarkSuspender suspender;
+    auto timestamps = makeTimestamps(format);
+    auto data = vectorMaker_.rowVector(
+        {evaluate("format_datetime(c0, c1)", timestamps),
+         timestamps->childAt(1)});
+    auto exprSet = compileExpression(expression, data->type());
+    suspender.dismiss();
+
+    doRun(exprSet, data);
+  }
+
   void doRun(exec::ExprSet& exprSet, const RowVectorPtr& rowVector) {
     int cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -131,6 +174,19 @@ class DateTimeBenchmark : public functions::test::FunctionBenchmarkBase {
     }
     folly::doNotOptimizeAway(cnt);
   }
+
+ private:
+  RowVectorPtr makeTimestamps(const std::string& format) {
+    constexpr vector_size_t size = 10'000;
+    return vectorMaker_.rowVector(
+        {vectorMaker_.flatVector<Timestamp>(
+             size,
+             [](auto row) {
+               return Timestamp(1'500'000'000 + row * 17'393, 0);
+             }),
+         vectorMaker_.flatVector<StringView>(
+             size, [&](auto /*row*/) { return StringView(format); })});
+  }
 };
 
 BENCHMARK(truncYear) {
@@ -197,6 +253,64 @@ BENCHMARK(second) {
   DateTimeBenchmark benchmark;
   benchmark.run("second");
 }
+
+BENCHMARK(hourAtTimezone) {
+  DateTimeBenchmark benchmark;
+  benchmark.runAtTimezone("hour", "America/Los_Angeles");
+}
+
+BENCHMARK(dayAtTimezone) {
+  DateTimeBenchmark benchmark;
+  benchmark.runAtTimezone("day", "America/Los_Angeles");
+}
+
+BENCHMARK(hourWithTimezone) {
+  DateTimeBenchmark benchmark;
+  benchmark.runFormat(
+      "hour(from_unixtime(to_unixtime(c0), 'America/Los_Angeles'))", "");
+}
+
+BENCHMARK(formatDateTime) {
+  DateTimeBenchmark benchmark;
+  benchmark.runFormat("format_datetime(c0, 'yyyy-MM-dd HH:mm:ss')", "");
+}
+
+BENCHMARK_RELATIVE(formatDateTimeNonConstantFormat) {
+  DateTimeBenchmark benchmark;
+  benchmark.runFormat("format_datetime(c0, c1)", "yyyy-MM-dd HH:mm:ss");
+}
+
+BENCHMARK(formatDateTimeVariableWidth) {
+  DateTimeBenchmark benchmark;
+  benchmark.runFormat("format_datetime(c0, 'yyyy-M-d H:m:s')", "");
+}
+
+BENCHMARK(dateFormat) {
+  DateTimeBenchmark benchmark;
+  benchmark.runFormat("date_format(c0, '%Y-%m-%d %H:%i:%s')", "");
+}
+
+BENCHMARK(parseDateTime) {
+  DateTimeBenchmark benchmark;
+  benchmark.runParse(
+      "parse_datetime(c0, 'yyyy-MM-dd HH:mm:ss')", "yyyy-MM-dd HH:mm:ss");
+}
+
+BENCHMARK_RELATIVE(parseDateTimeNonConstantFormat) {
+  DateTimeBenchmark benchmark;
+  benchmark.runParse("parse_datetime(c0, c1)", "yyyy-MM-dd HH:mm:ss");
+}
+
+BENCHMARK(parseDateTimeVariableWidth) {
+  DateTimeBenchmark benchmark;
+  benchmark.runParse("parse_datetime(c0, c1)", "yyyy-M-d H:m:s");
+}
+
+BENCHMARK(dateParse) {
+  DateTimeBenchmark benchmark;
+  benchmark.runParse(
+      "date_parse(c0, '%Y-%m-%d %H:%i:%s')", "yyyy-MM-dd HH:mm:ss");
+}
 } // namespace
 
 int main(int argc, char** argv) {
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/benchmarks/ExpressionBenchmarkBuilder.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+
+using namespace facebook::velox;
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+
+  functions::prestosql::registerArithmeticFunctions();
+
+  ExpressionBenchmarkBuilder benchmarkBuilder;
+
+  // Add, subtract and multiply of two short decimals skip overflow checks.
+  // The results of the short x short sets are short decimals for
+  // DECIMAL(10, 2) and long decimals for DECIMAL(18, 4). The other sets have
+  // a long decimal argument. The precisions are chosen so that products of
+  // random values do not overflow.
+  auto createSet = [&](const TypePtr& a, const TypePtr& b) {
+    benchmarkBuilder
+        .addBenchmarkSet(
+            fmt::format("{}_{}", a->toString(), b->toString()),
+            ROW({"c0", "c1"}, {a, b}))
+        .withFuzzerOptions({.vectorSize = 1'000, .nullRatio = 0.01})
+        .addExpression("plus", "c0 + c1")
+        .addExpression("minus", "c0 - c1")
+        .addExpression("multiply", "c0 * c1");
+  };
+
+  createSet(DECIMAL(10, 2), DECIMAL(10, 2));
+  createSet(DECIMAL(18, 4), DECIMAL(18, 2));
+  createSet(DECIMAL(18, 4), DECIMAL(20, 2));
+  createSet(DECIMAL(20, 4), DECIMAL(17, 2));
+
+  benchmarkBuilder.registerBenchmarks();
+
+  folly::runBenchmarks();
+  return 0;
+}
@@ -114,6 +114,37 @@ class JsonBenchmark : public velox::functions::test::FunctionBenchmarkBase {
     doRun(iter, exprSet, rowVector);
   }
 
+  // Evaluates fnName(c0, '<path>') for each of 'paths' as one ExprSet.
+  void runWithJsonExtractPaths(
+      int iter,
+      int vectorSize,
+      const std::string& fnName,
+      const std::string& json,
+      const std::vector<std::string>& paths) {
+    folly::BenchmarkSuspender suspender;
+
+    auto rowVector = vectorMaker_.rowVector({makeJsonData(json, vectorSize)});
+    std::vector<core::TypedExprPtr> exprs;
+    for (const auto& path : paths) {
+      auto untyped =
+          parse::parseExpr(fmt::format("{}(c0, '{}')", fnName, path), options_);
+      exprs.push_back(core::Expressions::inferTypes(
+          untyped, rowVector->type(), execCtx_.pool()));
+    }
+    exec::ExprSet exprSet(exprs, &execCtx_);
+    SelectivityVector rows(vectorSize);
+    std::vector<VectorPtr> results(exprs.size());
+    suspender.dismiss();
+
+    uint32_t cnt = 0;
+    for (auto i = 0; i < iter; i++) {
+      exec::EvalCtx evalCtx(&execCtx_, &exprSet, rowVector.get());
+      exprSet.eval(rows, evalCtx, results);
+      cnt += results[0]->size();
+    }
+    folly::doNotOptimizeAway(cnt);
+  }
+
   void runWithJsonContains(
       int iter,
       int vectorSize,
@@ -211,6 +242,31 @@ void SIMDJsonExtractScalar(int iter, int vectorSize, int jsonSize) {
       iter, vectorSize, "simd_json_extract_scalar", json, "$.key[7].k1");
 }
 
+const std::vector<std::string> kExtractScalarPaths = {
+    "$.key[1].k1",
+    "$.key[4].k1",
+    "$.key[7].k1"};
+
+// Each path is extracted by a separate call that parses the document again.
+void SIMDJsonExtractScalarPaths(int iter, int vectorSize, int jsonSize) {
+  folly::BenchmarkSuspender suspender;
+  JsonBenchmark benchmark;
+  auto json = benchmark.prepareData(jsonSize);
+  suspender.dismiss();
+  benchmark.runWithJsonExtractPaths(
+      iter, vectorSize, "simd_json_extract_scalar", json, kExtractScalarPaths);
+}
+
+// The calls are re-written to share one parse of each document.
+void SharedJsonExtractScalarPaths(int iter, int vectorSize, int jsonSize) {
+  folly::BenchmarkSuspender suspender;
+  JsonBenchmark benchmark;
+  auto json = benchmark.prepareData(jsonSize);
+  suspender.dismiss();
+  benchmark.runWithJsonExtractPaths(
+      iter, vectorSize, "json_extract_scalar", json, kExtractScalarPaths);
+}
+
 void FollyJsonExtract(int iter, int vectorSize, int jsonSize) {
   folly::BenchmarkSuspender suspender;
   JsonBenchmark benchmark;
@@ -412,6 +468,31 @@ BENCHMARK_RELATIVE_NAMED_PARAM(
     10000);
 BENCHMARK_DRAW_LINE();
 
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(
+    SIMDJsonExtractScalarPaths,
+    100_iters_100bytes_size,
+    100,
+    100);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    SharedJsonExtractScalarPaths,
+    100_iters_100bytes_size,
+    100,
+    100);
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(
+    SIMDJsonExtractScalarPaths,
+    100_iters_10000bytes_size,
+    100,
+    10000);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    SharedJsonExtractScalarPaths,
+    100_iters_10000bytes_size,
+    100,
+    10000);
+BENCHMARK_DRAW_LINE();
+
 BENCHMARK_DRAW_LINE();
 BENCHMARK_NAMED_PARAM(FollyJsonExtract, 100_iters_10bytes_size, 100, 10);
 BENCHMARK_RELATIVE_NAMED_PARAM(
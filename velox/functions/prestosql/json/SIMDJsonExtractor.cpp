@@ -42,6 +42,15 @@ namespace facebook::velox::functions::detail {
   return *it.first->second;
 }
 
+/* static */ bool SIMDJsonExtractor::isValidPath(folly::StringPiece path) {
+  try {
+    getInstance(path);
+    return true;
+  } catch (const VeloxUserError&) {
+    return false;
+  }
+}
+
 simdjson::ondemand::document SIMDJsonExtractor::parse(
     const simdjson::padded_string& json) {
   thread_local static simdjson::ondemand::parser parser;
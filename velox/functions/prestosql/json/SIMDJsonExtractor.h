@@ -33,6 +33,12 @@ bool simdJsonExtract(
     const velox::StringView& path,
     TConsumer&& consumer);
 
+template <typename TConsumer>
+bool simdJsonExtract(
+    simdjson::ondemand::document& jsonDoc,
+    const velox::StringView& path,
+    TConsumer&& consumer);
+
 namespace detail {
 
 using JsonVector = std::vector<simdjson::ondemand::value>;
@@ -52,6 +58,10 @@ class SIMDJsonExtractor {
 
   simdjson::ondemand::document parse(const simdjson::padded_string& json);
 
+  // Returns true if 'path' is a valid JSON path, i.e. simdJsonExtract() does
+  // not throw for it.
+  static bool isValidPath(folly::StringPiece path);
+
  private:
   // Use this method to get an instance of SIMDJsonExtractor given a JSON path.
   // Given the nature of the cache, it's important this is only used by
@@ -77,6 +87,12 @@ class SIMDJsonExtractor {
       const velox::StringView& json,
       const velox::StringView& path,
       TConsumer&& consumer);
+
+  template <typename TConsumer>
+  friend bool facebook::velox::functions::simdJsonExtract(
+      simdjson::ondemand::document& jsonDoc,
+      const velox::StringView& path,
+      TConsumer&& consumer);
 };
 
 void extractObject(
@@ -184,6 +200,31 @@ bool simdJsonExtract(
   return true;
 }
 
+/// Same as above, but extracts from 'jsonDoc' that was parsed before. The
+/// document is rewound first, so that several paths can be extracted from one
+/// parsed document.
+template <typename TConsumer>
+bool simdJsonExtract(
+    simdjson::ondemand::document& jsonDoc,
+    const velox::StringView& path,
+    TConsumer&& consumer) {
+  try {
+    auto& extractor = detail::SIMDJsonExtractor::getInstance(path);
+    jsonDoc.rewind();
+
+    if (extractor.isRootOnlyPath()) {
+      consumer(jsonDoc);
+    } else {
+      auto value = jsonDoc.get_value().value();
+      extractor.extract(value, std::forward<TConsumer>(consumer));
+    }
+  } catch (const simdjson::simdjson_error&) {
+    return false;
+  }
+
+  return true;
+}
+
 template <typename TConsumer>
 bool simdJsonExtract(
     const std::string& json,
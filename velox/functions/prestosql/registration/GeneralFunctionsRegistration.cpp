@@ -17,6 +17,7 @@
 #include "velox/functions/Registerer.h"
 #include "velox/functions/lib/IsNull.h"
 #include "velox/functions/prestosql/Cardinality.h"
+#include "velox/functions/prestosql/Reduce.h"
 
 namespace facebook::velox::functions {
 
@@ -33,6 +34,10 @@ void registerGeneralFunctions(const std::string& prefix) {
   VELOX_REGISTER_VECTOR_FUNCTION(udf_subscript, prefix + "subscript");
   VELOX_REGISTER_VECTOR_FUNCTION(udf_transform, prefix + "transform");
   VELOX_REGISTER_VECTOR_FUNCTION(udf_reduce, prefix + "reduce");
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_reduce_sum, prefix + kReduceSum);
+  exec::registerExpressionRewrite([prefix](const auto& expr) {
+    return rewriteReduceCall(prefix, expr);
+  });
   VELOX_REGISTER_VECTOR_FUNCTION(udf_array_filter, prefix + "filter");
 
   VELOX_REGISTER_VECTOR_FUNCTION(udf_least, prefix + "least");
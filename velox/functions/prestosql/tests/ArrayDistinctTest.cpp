@@ -306,6 +306,33 @@ TEST_F(ArrayDistinctTest, nonContiguousRows) {
   assertEqualVectors(expected, result);
 }
 
+TEST_F(ArrayDistinctTest, longAndShortArrays) {
+  // Arrays up to 16 elements are deduplicated without a hash table.
+  std::vector<std::vector<std::optional<int64_t>>> arrays;
+  std::vector<std::vector<std::optional<int64_t>>> expectedArrays;
+  for (auto i = 0; i < 40; ++i) {
+    std::vector<std::optional<int64_t>> array;
+    std::vector<std::optional<int64_t>> expectedArray;
+    for (auto j = 0; j < i; ++j) {
+      std::optional<int64_t> value;
+      if (j % 7 != 3) {
+        value = (j * 5) % (i / 2 + 1) - 2;
+      }
+      array.push_back(value);
+      if (std::find(expectedArray.begin(), expectedArray.end(), value) ==
+          expectedArray.end()) {
+        expectedArray.push_back(value);
+      }
+    }
+    arrays.push_back(std::move(array));
+    expectedArrays.push_back(std::move(expectedArray));
+  }
+  testExpr(
+      makeNullableArrayVector(expectedArrays),
+      "array_distinct(C0)",
+      {makeNullableArrayVector(arrays)});
+}
+
 TEST_F(ArrayDistinctTest, constant) {
   vector_size_t size = 1'000;
   auto data =
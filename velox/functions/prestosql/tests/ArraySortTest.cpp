@@ -417,6 +417,50 @@ TEST_F(ArraySortTest, constant) {
   assertEqualVectors(expected, result);
 }
 
+TEST_F(ArraySortTest, longArrays) {
+  // Arrays of a few hundred elements are radix sorted. Values of small and
+  // full range exercise skipping bytes that are the same in all values.
+  auto test = [&](auto maxValue) {
+    using T = decltype(maxValue);
+    std::vector<std::vector<std::optional<T>>> arrays;
+    for (auto i = 0; i < 20; ++i) {
+      std::vector<std::optional<T>> array;
+      const int64_t modulus = i % 2 == 0 ? 100 : maxValue;
+      for (auto j = 0; j < 200 + i * 30; ++j) {
+        if (j % 11 == 5) {
+          array.push_back(std::nullopt);
+        } else {
+          array.push_back(
+              static_cast<T>((j * 2'654'435'761LL + i) % modulus - j % 3));
+        }
+      }
+      arrays.push_back(std::move(array));
+    }
+    auto data = makeRowVector({makeNullableArrayVector(arrays)});
+
+    for (auto ascending : {true, false}) {
+      auto expectedArrays = arrays;
+      for (auto& array : expectedArrays) {
+        // Nulls go last in both orders.
+        auto firstNull = std::stable_partition(
+            array.begin(), array.end(), [](auto value) {
+              return value.has_value();
+            });
+        std::sort(array.begin(), firstNull, [&](auto left, auto right) {
+          return ascending ? left < right : left > right;
+        });
+      }
+      auto result = evaluate(
+          ascending ? "array_sort(c0)" : "array_sort_desc(c0)", data);
+      assertEqualVectors(makeNullableArrayVector(expectedArrays), result);
+    }
+  };
+  test(std::numeric_limits<int8_t>::max());
+  test(std::numeric_limits<int16_t>::max());
+  test(std::numeric_limits<int32_t>::max());
+  test(std::numeric_limits<int64_t>::max());
+}
+
 TEST_F(ArraySortTest, dictionaryEncodedElements) {
   auto elementVector = makeNullableFlatVector<int64_t>({3, 1, 2, 4, 5});
   auto dictionaryVector = BaseVector::wrapInDictionary(
@@ -293,6 +293,50 @@ TEST_F(DecimalArithmeticTest, multiply) {
       "Decimal overflow. Value '119630519620642428561342635425231011830' is not in the range of Decimal Type");
 }
 
+// Add, subtract and multiply of short decimals are computed without overflow
+// checks. Verify the results at the largest short decimal values.
+TEST_F(DecimalArithmeticTest, shortDecimalLimits) {
+  const int64_t kMax = DecimalUtil::kShortDecimalMax;
+  auto integers = makeFlatVector<int64_t>({kMax, -kMax, 1}, DECIMAL(18, 0));
+  auto fractions = makeFlatVector<int64_t>({kMax, kMax, -1}, DECIMAL(18, 18));
+  const int128_t kScale = DecimalUtil::kPowersOfTen[18];
+
+  testDecimalExpr<TypeKind::HUGEINT>(
+      makeFlatVector<int128_t>(
+          {kMax * kScale + kMax, -kMax * kScale + kMax, kScale - 1},
+          DECIMAL(37, 18)),
+      "c0 + c1",
+      {integers, fractions});
+  testDecimalExpr<TypeKind::HUGEINT>(
+      makeFlatVector<int128_t>(
+          {kMax * kScale - kMax, -kMax * kScale - kMax, kScale + 1},
+          DECIMAL(37, 18)),
+      "c0 - c1",
+      {integers, fractions});
+  testDecimalExpr<TypeKind::HUGEINT>(
+      makeFlatVector<int128_t>(
+          {int128_t(kMax) * kMax, int128_t(-kMax) * kMax, -1},
+          DECIMAL(36, 18)),
+      "c0 * c1",
+      {integers, fractions});
+
+  // Short results.
+  auto small =
+      makeFlatVector<int64_t>({99'999'999, -99'999'999}, DECIMAL(8, 0));
+  auto smallFractions =
+      makeFlatVector<int64_t>({99'999'999, 1}, DECIMAL(8, 8));
+  testDecimalExpr<TypeKind::BIGINT>(
+      makeFlatVector<int64_t>(
+          {9'999'999'999'999'999, -9'999'999'899'999'999}, DECIMAL(17, 8)),
+      "c0 + c1",
+      {small, smallFractions});
+  testDecimalExpr<TypeKind::BIGINT>(
+      makeFlatVector<int64_t>(
+          {9'999'999'800'000'001, -99'999'999}, DECIMAL(16, 8)),
+      "c0 * c1",
+      {small, smallFractions});
+}
+
 TEST_F(DecimalArithmeticTest, decimalDivTest) {
   auto shortFlat = makeFlatVector<int64_t>({1000, 2000}, DECIMAL(17, 3));
   // Divide short and short, returning long.
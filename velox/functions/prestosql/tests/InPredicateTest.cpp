@@ -182,6 +182,40 @@ class InPredicateTest : public FunctionBaseTest {
     assertEqualVectors(expectedConstant, result);
   }
 
+  // Tests an IN list of 10K values i * 'step'. A step of 2 makes a dense
+  // list and a large step a sparse one.
+  template <typename T>
+  void testLargeInList(T step) {
+    constexpr int32_t kNumValues = 10'000;
+    std::vector<std::optional<T>> values;
+    std::unordered_set<T> valueSet;
+    for (auto i = 0; i < kNumValues; ++i) {
+      values.push_back(i * step);
+      valueSet.insert(i * step);
+    }
+    const auto inList = getInList<T>(values);
+
+    // Even rows hit. The size is not a multiple of 64.
+    const vector_size_t size = 1'000;
+    auto data = makeRowVector({makeFlatVector<T>(
+        size, [&](auto row) { return row * (step / 2); })});
+
+    auto result = evaluate<SimpleVector<bool>>(
+        fmt::format("c0 IN ({})", inList), data);
+    auto expected = makeFlatVector<bool>(
+        size, [&](auto row) { return valueSet.count(row * (step / 2)) > 0; });
+    assertEqualVectors(expected, result);
+
+    // Tests a subset of the rows.
+    result = evaluate<SimpleVector<bool>>(
+        fmt::format("if(c0 % 3 = 0, c0 IN ({}), false)", inList), data);
+    expected = makeFlatVector<bool>(size, [&](auto row) {
+      const T value = row * (step / 2);
+      return value % 3 == 0 && valueSet.count(value) > 0;
+    });
+    assertEqualVectors(expected, result);
+  }
+
   template <typename T>
   void testConstantValues(const TypePtr type = CppToType<T>::create()) {
     const vector_size_t size = 1'000;
@@ -359,6 +393,30 @@ TEST_F(InPredicateTest, varchar) {
   assertEqualVectors(expected, result);
 }
 
+TEST_F(InPredicateTest, largeInList) {
+  testLargeInList<int64_t>(2);
+  testLargeInList<int64_t>(200'002);
+  testLargeInList<int32_t>(2);
+  testLargeInList<int32_t>(200'002);
+}
+
+TEST_F(InPredicateTest, largeVarcharInList) {
+  std::ostringstream inList;
+  for (auto i = 0; i < 10'000; ++i) {
+    inList << (i > 0 ? ", " : "") << fmt::format("'a longer value {}'", i * 2);
+  }
+  const vector_size_t size = 1'000;
+  auto data = makeRowVector({makeFlatVector<std::string>(size, [](auto row) {
+    return fmt::format("a longer value {}", row);
+  })});
+
+  auto result = evaluate<SimpleVector<bool>>(
+      fmt::format("c0 IN ({})", inList.str()), data);
+  auto expected =
+      makeFlatVector<bool>(size, [](auto row) { return row % 2 == 0; });
+  assertEqualVectors(expected, result);
+}
+
 TEST_F(InPredicateTest, varcharConstant) {
   const vector_size_t size = 1'000;
   auto rowVector = makeRowVector(
@@ -206,6 +206,47 @@ TEST_F(JsonExtractScalarTest, wildcardSelect) {
       std::nullopt);
 }
 
+// Calls with constant paths over the same input are evaluated with one parse
+// of each document. Verify they return the same results as separate calls.
+TEST_F(JsonExtractScalarTest, multiplePaths) {
+  auto data = makeRowVector({makeNullableFlatVector<StringView>(
+      {R"({"a": 1, "b": "x", "c": [true, false]})",
+       R"({"a": {"b": 1}, "c": [1]})",
+       std::nullopt,
+       R"({"a": 1, "b": )",
+       R"({"b": null, "a": 2.5, "c": [1, 2, 3]})"},
+      JSON())});
+
+  const std::vector<std::string> exprs = {
+      "json_extract_scalar(c0, '$.a')",
+      "json_extract_scalar(c0, '$.b')",
+      "concat(json_extract_scalar(c0, '$.c[1]'), '!')",
+      "json_extract_scalar(c0, '$.a')",
+  };
+  auto exprSet = compileExpressions(exprs, asRowType(data->type()));
+  ASSERT_NE(
+      exprSet->toString().find("json_extract_scalars"), std::string::npos);
+
+  exec::EvalCtx context(&execCtx_, exprSet.get(), data.get());
+  SelectivityVector rows(data->size());
+  std::vector<VectorPtr> results(exprs.size());
+  exprSet->eval(rows, context, results);
+
+  for (auto i = 0; i < exprs.size(); ++i) {
+    velox::test::assertEqualVectors(evaluate(exprs[i], data), results[i]);
+  }
+  auto paths = results[0]->as<SimpleVector<StringView>>();
+  EXPECT_EQ(paths->valueAt(0), "1");
+  EXPECT_TRUE(paths->isNullAt(1));
+  EXPECT_TRUE(paths->isNullAt(2));
+  EXPECT_EQ(paths->valueAt(4), "2.5");
+
+  auto elements = results[2]->as<SimpleVector<StringView>>();
+  EXPECT_EQ(elements->valueAt(0), "false!");
+  EXPECT_TRUE(elements->isNullAt(1));
+  EXPECT_EQ(elements->valueAt(4), "2!");
+}
+
 } // namespace
 
 } // namespace facebook::velox::functions::prestosql
@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
 
 using namespace facebook::velox;
@@ -205,3 +206,56 @@ TEST_F(ReduceTest, finalSelectionLargerThanInput) {
 
   assertEqualVectors(makeFlatVector<int64_t>({2, 1}), result);
 }
+
+// reduce with (s, x) -> s + x is re-written into a single pass over each
+// array. Verify that nulls, overflow and the output function behave the same.
+TEST_F(ReduceTest, sum) {
+  auto input = makeRowVector({
+      makeNullableArrayVector<int64_t>({
+          {{1, 2, 3}},
+          {{}},
+          {{4, std::nullopt, 5}},
+          std::nullopt,
+          {{6}},
+      }),
+      makeNullableFlatVector<int64_t>({10, 10, 10, 10, std::nullopt}),
+  });
+
+  auto exprSet = compileExpression(
+      "reduce(c0, c1, (s, x) -> s + x, s -> s)", asRowType(input->type()));
+  ASSERT_NE(exprSet->toString().find("reduce_sum"), std::string::npos);
+
+  auto expected = makeNullableFlatVector<int64_t>(
+      {16, 10, std::nullopt, std::nullopt, std::nullopt});
+  assertEqualVectors(
+      expected, evaluate("reduce(c0, c1, (s, x) -> s + x, s -> s)", input));
+  assertEqualVectors(
+      expected, evaluate("reduce(c0, c1, (s, x) -> x + s, s -> s)", input));
+
+  expected = makeNullableFlatVector<int64_t>(
+      {32, 20, std::nullopt, std::nullopt, std::nullopt});
+  assertEqualVectors(
+      expected,
+      evaluate("reduce(c0, c1, (s, x) -> s + x, s -> s * 2)", input));
+
+  // Floating point values are added in order.
+  input = makeRowVector({
+      makeArrayVector<double>({{0.1, 0.2, 0.3}, {1e20, 1, -1e20}}),
+      makeFlatVector<double>({0, 0}),
+  });
+  assertEqualVectors(
+      makeFlatVector<double>({0.0 + 0.1 + 0.2 + 0.3, 1e20 + 1 - 1e20}),
+      evaluate("reduce(c0, c1, (s, x) -> s + x, s -> s)", input));
+
+  input = makeRowVector({
+      makeArrayVector<int32_t>(
+          {{std::numeric_limits<int32_t>::max(), 1}, {1, 2}}),
+      makeFlatVector<int32_t>({0, 0}),
+  });
+  VELOX_ASSERT_THROW(
+      evaluate("reduce(c0, c1, (s, x) -> s + x, s -> s)", input),
+      "integer overflow");
+  assertEqualVectors(
+      makeNullableFlatVector<int32_t>({std::nullopt, 3}),
+      evaluate("try(reduce(c0, c1, (s, x) -> s + x, s -> s))", input));
+}
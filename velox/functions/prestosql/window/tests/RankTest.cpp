@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/functions/lib/window/tests/WindowTestBase.h"
 #include "velox/functions/prestosql/window/WindowFunctionsRegistration.h"
 
@@ -97,6 +100,52 @@ TEST_P(RankTest, randomInput) {
   testWindowFunction({makeRandomInputVector(30)});
 }
 
+// Tests all functions with peer groups of many rows that span output batches.
+TEST_P(RankTest, largePeerGroups) {
+  vector_size_t size = 1'000;
+  std::vector<RowVectorPtr> vectors = {makeRowVector({
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 3; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row / 100; }),
+      makeFlatVector<double>(
+          size, [](auto row) { return row % 7 / 2; }, nullEvery(11)),
+      makeFlatVector<std::string>(
+          size, [](auto row) { return std::string(row / 300, 'x'); }),
+  })};
+  createDuckDbTable(vectors);
+  auto queryInfo = buildWindowQuery(vectors, function_, overClause_, "");
+  SCOPED_TRACE(queryInfo.functionSql);
+  AssertQueryBuilder(duckDbQueryRunner_)
+      .config(core::QueryConfig::kPreferredOutputBatchRows, "17")
+      .config(core::QueryConfig::kMaxOutputBatchRows, "17")
+      .plan(queryInfo.planNode)
+      .assertResults(queryInfo.querySql);
+}
+
+class RankSpillTest : public RankTestBase {
+ public:
+  RankSpillTest() : RankTestBase({"rank()", ""}) {}
+};
+
+// Tests the window operator spilling its input for all over clauses.
+TEST_F(RankSpillTest, spill) {
+  std::vector<RowVectorPtr> vectors = {
+      makeSimpleVector(1'000), makeSimpleVector(1'000), makeSimpleVector(500)};
+  createDuckDbTable(vectors);
+  for (const auto& overClause : kOverClauses) {
+    auto queryInfo = buildWindowQuery(vectors, function_, overClause, "");
+    SCOPED_TRACE(queryInfo.functionSql);
+    auto spillDirectory = TempDirectoryPath::create();
+    auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                    .spillDirectory(spillDirectory->path)
+                    .config(core::QueryConfig::kSpillEnabled, "true")
+                    .config(core::QueryConfig::kTestingSpillPct, "100")
+                    .plan(queryInfo.planNode)
+                    .assertResults(queryInfo.querySql);
+    auto stats = exec::toPlanStats(task->taskStats());
+    ASSERT_GT(stats.at(queryInfo.planNode->id()).spilledBytes, 0);
+  }
+}
+
 // Run above tests for all combinations of rank function and over clauses.
 VELOX_INSTANTIATE_TEST_SUITE_P(
     RankTestInstantiation,
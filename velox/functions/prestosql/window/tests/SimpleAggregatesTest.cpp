@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/functions/lib/window/tests/WindowTestBase.h"
 #include "velox/functions/prestosql/window/WindowFunctionsRegistration.h"
 
@@ -129,5 +131,69 @@ TEST_F(StringAggregatesTest, nonFixedWidthAggregate) {
   testWindowFunction(input, "max(c2)", kOverClauses);
 }
 
+// Test for sliding frames wide enough to be aggregated from a segment tree
+// over the partition.
+TEST_F(StringAggregatesTest, slidingFrames) {
+  auto size = 1'000;
+  auto input = {makeRowVector({
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 3; }),
+      makeFlatVector<int32_t>(size, [](auto row) { return row; }),
+      makeRandomInputVector(BIGINT(), size, 0.2),
+      makeRandomInputVector(VARCHAR(), size, 0.3),
+  })};
+
+  const std::vector<std::string> frameClauses = {
+      "rows between 100 preceding and 100 following",
+      "rows between 300 preceding and 10 preceding",
+      "rows between 5 following and 200 following",
+      "rows between 2 preceding and 2 following",
+  };
+  for (const auto& function :
+       {"sum(c2)", "count(c2)", "min(c2)", "max(c3)", "count(1)"}) {
+    testWindowFunction(
+        input, function, {"partition by c0 order by c1"}, frameClauses);
+  }
+}
+
+class StreamingWindowTest : public WindowTestBase {
+ protected:
+  void SetUp() override {
+    WindowTestBase::SetUp();
+    window::prestosql::registerAllWindowFunctions();
+  }
+};
+
+// Sorts the input by the partition and order by keys and computes the window
+// one partition at a time as the sorted rows arrive. The small output batches
+// make partitions span batches.
+TEST_F(StreamingWindowTest, sortedInput) {
+  auto input = {
+      makeSimpleVector(100),
+      makeSinglePartitionVector(30),
+      makeSingleRowPartitionsVector(20),
+      makeRowVector({
+          makeRandomInputVector(INTEGER(), 50, 0.2),
+          makeRandomInputVector(INTEGER(), 50, 0.2),
+          makeFlatVector<int64_t>(50, [](auto row) { return row % 3; }),
+          makeFlatVector<int32_t>(50, [](auto row) { return row % 4; }),
+      })};
+  createDuckDbTable(input);
+
+  for (const auto& function :
+       {"sum(c2)", "min(c3)", "count(c2)", "rank()", "dense_rank()"}) {
+    const auto functionSql = fmt::format(
+        "{} over (partition by c0 order by c1 nulls first, c2)", function);
+    SCOPED_TRACE(functionSql);
+    auto plan = PlanBuilder()
+                    .values(input)
+                    .orderBy({"c0", "c1 NULLS FIRST", "c2"}, false)
+                    .streamingWindow({functionSql})
+                    .planNode();
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(core::QueryConfig::kPreferredOutputBatchRows, "7")
+        .assertResults(fmt::format("SELECT *, {} FROM tmp", functionSql));
+  }
+}
+
 }; // namespace
 }; // namespace facebook::velox::window::test
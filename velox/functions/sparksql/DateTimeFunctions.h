@@ -188,8 +188,11 @@ struct UnixTimestampParseWithFormatFunction
     // Format or parsing error returns null.
     try {
       if (!isConstFormat_) {
-        this->format_ = buildJodaDateTimeFormatter(
-            std::string_view(format.data(), format.size()));
+        const std::string_view formatView(format.data(), format.size());
+        if (!this->format_ || formatView != lastFormat_) {
+          this->format_ = buildJodaDateTimeFormatter(formatView);
+          lastFormat_ = formatView;
+        }
       }
 
       auto dateTimeResult =
@@ -205,6 +208,8 @@ struct UnixTimestampParseWithFormatFunction
  private:
   bool isConstFormat_{false};
   bool invalidFormat_{false};
+  // The format 'format_' was built for if the format is not constant.
+  std::string lastFormat_;
 };
 
 template <typename T>
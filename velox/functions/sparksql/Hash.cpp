@@ -26,6 +26,36 @@ namespace {
 
 const int32_t kDefaultSeed = 42;
 
+// Sets result[row] to hashFn(value, result[row]) for the 'rows' of 'decoded',
+// which must not be null. Flat fixed-width values are hashed in a loop over
+// the raw values and results that the compiler can vectorize.
+template <typename T, typename ReturnType, typename HashFn>
+void hashColumn(
+    const SelectivityVector& rows,
+    const DecodedVector& decoded,
+    HashFn hashFn,
+    FlatVector<ReturnType>& result) {
+  auto* rawResult = result.mutableRawValues();
+  if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+    if (decoded.isIdentityMapping()) {
+      const auto* rawValues = decoded.data<T>();
+      if (rows.isAllSelected()) {
+        for (auto row = rows.begin(); row < rows.end(); ++row) {
+          rawResult[row] = hashFn(rawValues[row], rawResult[row]);
+        }
+      } else {
+        rows.applyToSelected([&](auto row) {
+          rawResult[row] = hashFn(rawValues[row], rawResult[row]);
+        });
+      }
+      return;
+    }
+  }
+  rows.applyToSelected([&](auto row) {
+    rawResult[row] = hashFn(decoded.valueAt<T>(row), rawResult[row]);
+  });
+}
+
 // ReturnType can be either int32_t or int64_t
 // HashClass contains the function like hashInt32
 template <typename ReturnType, typename HashClass, typename SeedType>
@@ -59,10 +89,11 @@ void applyWithType(
 // https://github.com/apache/spark/blob/382b66e/sql/catalyst/src/main/scala/org/apache/spark/sql/catalyst/expressions/hash.scala#L532
 #define CASE(typeEnum, hashFn, inputType)                                      \
   case TypeKind::typeEnum:                                                     \
-    selected->applyToSelected([&](int row) {                                   \
-      result.set(                                                              \
-          row, hashFn(decoded->valueAt<inputType>(row), result.valueAt(row))); \
-    });                                                                        \
+    hashColumn<inputType>(                                                     \
+        *selected,                                                             \
+        *decoded,                                                              \
+        [&](auto value, auto seed) { return hashFn(value, seed); },            \
+        result);                                                               \
     break;
       CASE(BOOLEAN, hash.hashInt32, bool);
       CASE(TINYINT, hash.hashInt32, int8_t);
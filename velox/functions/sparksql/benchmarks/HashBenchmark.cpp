@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/sparksql/Register.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+using namespace facebook::velox;
+
+namespace {
+
+class HashBenchmark : public functions::test::FunctionBenchmarkBase {
+ public:
+  HashBenchmark() {
+    functions::sparksql::registerFunctions("");
+
+    VectorFuzzer::Options options;
+    options.vectorSize = 10'000;
+    options.nullRatio = 0;
+    VectorFuzzer fuzzer(options, pool());
+    data_ = vectorMaker_.rowVector(
+        {"i32", "i64", "f64", "str"},
+        {fuzzer.fuzzFlat(INTEGER()),
+         fuzzer.fuzzFlat(BIGINT()),
+         fuzzer.fuzzFlat(DOUBLE()),
+         fuzzer.fuzzFlat(VARCHAR())});
+  }
+
+  void run(const std::string& expression) {
+    folly::BenchmarkSuspender suspender;
+    auto exprSet = compileExpression(expression, data_->type());
+    suspender.dismiss();
+
+    for (auto i = 0; i < 100; ++i) {
+      folly::doNotOptimizeAway(evaluate(exprSet, data_));
+    }
+  }
+
+ private:
+  RowVectorPtr data_;
+};
+
+std::unique_ptr<HashBenchmark> benchmark;
+
+BENCHMARK(hashInteger) {
+  benchmark->run("hash(i32)");
+}
+
+BENCHMARK(hashBigint) {
+  benchmark->run("hash(i64)");
+}
+
+BENCHMARK(hashColumns) {
+  benchmark->run("hash(i32, i64, f64, str)");
+}
+
+BENCHMARK(xxhash64Integer) {
+  benchmark->run("xxhash64(i32)");
+}
+
+BENCHMARK(xxhash64Bigint) {
+  benchmark->run("xxhash64(i64)");
+}
+
+BENCHMARK(xxhash64Columns) {
+  benchmark->run("xxhash64(i32, i64, f64, str)");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<HashBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -128,5 +128,38 @@ TEST_F(HashTest, Float) {
   EXPECT_EQ(hash<float>(-limits::infinity()), 427440766);
 }
 
+// Flat columns without nulls are hashed in a tight loop. Verify it matches
+// the row-by-row results for flat, nullable and dictionary encoded inputs.
+TEST_F(HashTest, multipleRows) {
+  const std::vector<std::optional<int32_t>> ints = {
+      1, std::nullopt, -1, 0, 123456, std::nullopt, 7};
+  const std::vector<double> doubles = {1, 2.5, -0.0, 0, 1e100, -3, 7};
+  const auto size = ints.size();
+
+  std::vector<std::optional<int32_t>> expected;
+  for (auto i = 0; i < size; ++i) {
+    expected.push_back(evaluateOnce<int32_t>(
+        "hash(c0, c1)", ints[i], std::optional(doubles[i])));
+  }
+
+  auto data = makeRowVector({
+      makeNullableFlatVector<int32_t>(ints),
+      makeFlatVector<double>(doubles),
+  });
+  assertEqualVectors(
+      makeNullableFlatVector<int32_t>(expected),
+      evaluate("hash(c0, c1)", data));
+
+  auto indices = makeIndicesInReverse(size);
+  auto dictionary = makeRowVector({
+      wrapInDictionary(indices, data->childAt(0)),
+      wrapInDictionary(indices, data->childAt(1)),
+  });
+  std::reverse(expected.begin(), expected.end());
+  assertEqualVectors(
+      makeNullableFlatVector<int32_t>(expected),
+      evaluate("hash(c0, c1)", dictionary));
+}
+
 } // namespace
 } // namespace facebook::velox::functions::sparksql::test
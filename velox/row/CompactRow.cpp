@@ -973,6 +973,70 @@ RowVectorPtr deserializeRows(
       pool, type, nulls, numRows, std::move(fields));
 }
 
+int32_t serializedSize(const TypePtr& type, const char* buffer);
+
+// Returns the number of bytes taken by an array of 'elementType' values that
+// starts at 'buffer'.
+// size | element nulls | serialized size (if complex type elements)
+// | element offsets (if complex type elements) | e1 | e2 | e3 |...
+int32_t serializedArraySize(const TypePtr& elementType, const char* buffer) {
+  const auto size = readInt32(buffer);
+  int32_t numBytes = kSizeBytes + bits::nbytes(size);
+  if (auto valueBytes = fixedValueSize(elementType)) {
+    return numBytes + size * valueBytes.value();
+  }
+  if (size == 0) {
+    return numBytes;
+  }
+  if (elementType->isVarchar() || elementType->isVarbinary()) {
+    auto* rawElementNulls = readNulls(buffer + kSizeBytes);
+    for (auto i = 0; i < size; ++i) {
+      if (!bits::isBitSet(rawElementNulls, i)) {
+        numBytes += kSizeBytes + readInt32(buffer + numBytes);
+      }
+    }
+    return numBytes;
+  }
+  // Complex type elements are preceded by their total size, which lets us
+  // skip them without looking at individual elements.
+  return numBytes + kSizeBytes + readInt32(buffer + numBytes);
+}
+
+// Returns the number of bytes taken by a non-null value of 'type' that starts
+// at 'buffer'.
+int32_t serializedSize(const TypePtr& type, const char* buffer) {
+  if (auto valueBytes = fixedValueSize(type)) {
+    return valueBytes.value();
+  }
+  switch (type->kind()) {
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return kSizeBytes + readInt32(buffer);
+    case TypeKind::ARRAY:
+      return serializedArraySize(type->childAt(0), buffer);
+    case TypeKind::MAP: {
+      const auto keysSize = serializedArraySize(type->childAt(0), buffer);
+      return keysSize +
+          serializedArraySize(type->childAt(1), buffer + keysSize);
+    }
+    case TypeKind::ROW: {
+      const auto* rawNulls = readNulls(buffer);
+      int32_t numBytes = bits::nbytes(type->size());
+      for (auto i = 0; i < type->size(); ++i) {
+        const auto& child = type->childAt(i);
+        if (auto valueBytes = fixedValueSize(child)) {
+          numBytes += valueBytes.value();
+        } else if (!bits::isBitSet(rawNulls, i)) {
+          numBytes += serializedSize(child, buffer + numBytes);
+        }
+      }
+      return numBytes;
+    }
+    default:
+      VELOX_UNREACHABLE("{}", type->toString());
+  }
+}
+
 } // namespace
 
 // static
@@ -986,4 +1050,82 @@ RowVectorPtr CompactRow::deserialize(
   return deserializeRows(rowType, data, nullptr, offsets, pool);
 }
 
+// static
+RowVectorPtr CompactRow::deserialize(
+    const std::vector<std::string_view>& data,
+    const RowTypePtr& rowType,
+    const std::vector<column_index_t>& columns,
+    memory::MemoryPool* pool) {
+  const auto numRows = data.size();
+  const size_t numFields = rowType->size();
+
+  column_index_t lastColumn = 0;
+  for (auto column : columns) {
+    VELOX_CHECK_LT(column, numFields);
+    lastColumn = std::max(lastColumn, column);
+  }
+
+  // Offsets of the fields in 'columns'. Fields before the first
+  // variable-width field are at the same offset in all rows and later ones
+  // are found by skipping over the fields before them.
+  std::vector<std::vector<size_t>> columnOffsets(numFields);
+  std::vector<bool> isSelected(numFields, false);
+  for (auto column : columns) {
+    isSelected[column] = true;
+  }
+
+  std::vector<size_t> offsets(numRows, bits::nbytes(numFields));
+  for (column_index_t i = 0; i <= lastColumn; ++i) {
+    if (isSelected[i]) {
+      columnOffsets[i] = offsets;
+    }
+    if (i == lastColumn) {
+      break;
+    }
+    const auto& child = rowType->childAt(i);
+    if (auto numBytes = fixedValueSize(child)) {
+      for (auto row = 0; row < numRows; ++row) {
+        offsets[row] += numBytes.value();
+      }
+    } else {
+      for (auto row = 0; row < numRows; ++row) {
+        const auto* rawRow = data[row].data();
+        if (!bits::isBitSet(readNulls(rawRow), i)) {
+          offsets[row] += serializedSize(child, rawRow + offsets[row]);
+        }
+      }
+    }
+  }
+
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  std::vector<VectorPtr> fields;
+  for (auto column : columns) {
+    BufferPtr fieldNulls = allocateNulls(numRows, pool);
+    auto* rawFieldNulls = fieldNulls->asMutable<uint8_t>();
+    for (auto row = 0; row < numRows; ++row) {
+      bits::setBit(
+          rawFieldNulls,
+          row,
+          !bits::isBitSet(readNulls(data[row].data()), column));
+    }
+
+    // 'deserialize' advances the offsets of variable-width fields, so a
+    // column listed more than once starts from a copy.
+    auto fieldOffsets = columnOffsets[column];
+    const auto& child = rowType->childAt(column);
+    fields.push_back(
+        row::deserialize(child, data, fieldNulls, fieldOffsets, pool));
+    names.push_back(rowType->nameOf(column));
+    types.push_back(child);
+  }
+
+  return std::make_shared<RowVector>(
+      pool,
+      ROW(std::move(names), std::move(types)),
+      nullptr,
+      numRows,
+      std::move(fields));
+}
+
 } // namespace facebook::velox::row
@@ -43,6 +43,17 @@ class CompactRow {
       const RowTypePtr& rowType,
       memory::MemoryPool* pool);
 
+  /// Deserializes only the specified 'columns' of multiple rows of type
+  /// 'rowType'. Returns a RowVector with one child per entry in 'columns', in
+  /// the order listed. Fields that are not needed are skipped without being
+  /// materialized, e.g. to read the sort keys of a spilled run without
+  /// deserializing the payload.
+  static RowVectorPtr deserialize(
+      const std::vector<std::string_view>& data,
+      const RowTypePtr& rowType,
+      const std::vector<column_index_t>& columns,
+      memory::MemoryPool* pool);
+
  private:
   explicit CompactRow(const VectorPtr& vector);
 
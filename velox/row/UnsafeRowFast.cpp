@@ -155,6 +155,87 @@ int32_t UnsafeRowFast::serialize(vector_size_t index, char* buffer) {
   return serializeRow(index, buffer);
 }
 
+void UnsafeRowFast::rowSizes(
+    vector_size_t offset,
+    vector_size_t size,
+    int32_t* sizes) {
+  const int32_t fixedSize = rowNullBytes_ + children_.size() * kFieldWidth;
+  std::fill(sizes, sizes + size, fixedSize);
+  for (auto i = 0; i < children_.size(); ++i) {
+    if (childIsFixedWidth_[i]) {
+      continue;
+    }
+    auto& child = children_[i];
+    for (auto row = 0; row < size; ++row) {
+      const auto childIndex = decoded_.index(offset + row);
+      if (!child.isNullAt(childIndex)) {
+        sizes[row] += alignBytes(child.variableWidthRowSize(childIndex));
+      }
+    }
+  }
+}
+
+void UnsafeRowFast::serialize(
+    vector_size_t offset,
+    vector_size_t size,
+    const size_t* bufferOffsets,
+    char* buffer) {
+  // Writes the same bytes as serializeRow() for each row, one field of all
+  // rows at a time, so that the type dispatch for each field happens once.
+  std::vector<int64_t> variableWidthOffsets(
+      size, rowNullBytes_ + kFieldWidth * children_.size());
+
+  for (auto i = 0; i < children_.size(); ++i) {
+    auto& child = children_[i];
+    const auto fieldOffset = rowNullBytes_ + i * kFieldWidth;
+
+    if (child.supportsBulkCopy_) {
+      // Flat values are copied without going through the decoded vector.
+      const auto* rawValues = child.decoded_.data<char>();
+      const auto valueBytes = child.valueBytes_;
+      for (auto row = 0; row < size; ++row) {
+        auto* rowBuffer = buffer + bufferOffsets[row];
+        const auto childIndex = decoded_.index(offset + row);
+        if (child.isNullAt(childIndex)) {
+          bits::setBit(rowBuffer, i, true);
+        } else {
+          memcpy(
+              rowBuffer + fieldOffset,
+              rawValues + childIndex * valueBytes,
+              valueBytes);
+        }
+      }
+    } else if (childIsFixedWidth_[i]) {
+      for (auto row = 0; row < size; ++row) {
+        auto* rowBuffer = buffer + bufferOffsets[row];
+        const auto childIndex = decoded_.index(offset + row);
+        if (child.isNullAt(childIndex)) {
+          bits::setBit(rowBuffer, i, true);
+        } else {
+          child.serializeFixedWidth(childIndex, rowBuffer + fieldOffset);
+        }
+      }
+    } else {
+      for (auto row = 0; row < size; ++row) {
+        auto* rowBuffer = buffer + bufferOffsets[row];
+        const auto childIndex = decoded_.index(offset + row);
+        if (child.isNullAt(childIndex)) {
+          bits::setBit(rowBuffer, i, true);
+          continue;
+        }
+        auto& variableWidthOffset = variableWidthOffsets[row];
+        auto valueSize = child.serializeVariableWidth(
+            childIndex, rowBuffer + variableWidthOffset);
+        // Write size and offset.
+        uint64_t sizeAndOffset = variableWidthOffset << 32 | valueSize;
+        *reinterpret_cast<uint64_t*>(rowBuffer + fieldOffset) = sizeAndOffset;
+
+        variableWidthOffset += alignBytes(valueSize);
+      }
+    }
+  }
+}
+
 void UnsafeRowFast::serializeFixedWidth(vector_size_t index, char* buffer) {
   VELOX_DCHECK(fixedWidthTypeKind_);
   switch (typeKind_) {
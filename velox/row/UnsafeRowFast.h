@@ -36,6 +36,20 @@ class UnsafeRowFast {
   /// 'buffer' must have sufficient capacity and set to all zeros.
   int32_t serialize(vector_size_t index, char* buffer);
 
+  /// Stores serialized sizes of rows in [offset, offset + size) in 'sizes'.
+  /// Sizes are computed a column at a time.
+  void rowSizes(vector_size_t offset, vector_size_t size, int32_t* sizes);
+
+  /// Serializes rows in [offset, offset + size) a column at a time. Row
+  /// 'offset + i' is written at 'buffer + bufferOffsets[i]', which must have
+  /// room for the size returned by 'rowSizes'. 'buffer' must be set to all
+  /// zeros.
+  void serialize(
+      vector_size_t offset,
+      vector_size_t size,
+      const size_t* bufferOffsets,
+      char* buffer);
+
  protected:
   explicit UnsafeRowFast(const VectorPtr& vector);
 
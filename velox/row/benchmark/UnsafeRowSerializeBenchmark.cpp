@@ -40,6 +40,26 @@ class SerializeBenchmark {
     VELOX_CHECK_EQ(serialized.size(), data->size());
   }
 
+  void serializeUnsafeBatch(const RowTypePtr& rowType) {
+    folly::BenchmarkSuspender suspender;
+    auto data = makeData(rowType);
+    suspender.dismiss();
+
+    const auto numRows = data->size();
+    UnsafeRowFast fast(data);
+    std::vector<int32_t> rowSizes(numRows);
+    fast.rowSizes(0, numRows, rowSizes.data());
+    std::vector<size_t> rowOffsets(numRows);
+    size_t totalSize = 0;
+    for (auto i = 0; i < numRows; ++i) {
+      rowOffsets[i] = totalSize;
+      totalSize += rowSizes[i];
+    }
+    auto buffer = AlignedBuffer::allocate<char>(totalSize, pool(), 0);
+    fast.serialize(0, numRows, rowOffsets.data(), buffer->asMutable<char>());
+    folly::doNotOptimizeAway(buffer);
+  }
+
   void deserializeUnsafe(const RowTypePtr& rowType) {
     folly::BenchmarkSuspender suspender;
     auto data = makeData(rowType);
@@ -78,6 +98,21 @@ class SerializeBenchmark {
     VELOX_CHECK_EQ(copy->size(), data->size());
   }
 
+  void deserializeCompactColumn(
+      const RowTypePtr& rowType,
+      column_index_t column) {
+    folly::BenchmarkSuspender suspender;
+    auto data = makeData(rowType);
+    CompactRow compact(data);
+    auto totalSize = computeTotalSize(compact, rowType, data->size());
+    auto buffer = AlignedBuffer::allocate<char>(totalSize, pool());
+    auto serialized = serialize(compact, data->size(), buffer);
+    suspender.dismiss();
+
+    auto copy = CompactRow::deserialize(serialized, rowType, {column}, pool());
+    VELOX_CHECK_EQ(copy->size(), data->size());
+  }
+
   void serializeContainer(const RowTypePtr& rowType) {
     folly::BenchmarkSuspender suspender;
     auto data = makeData(rowType);
@@ -204,35 +239,40 @@ class SerializeBenchmark {
   std::shared_ptr<memory::MemoryPool> pool_{memory::addDefaultLeafMemoryPool()};
 };
 
-#define SERDE_BENCHMARKS(name, rowType)      \
-  BENCHMARK(unsafe_serialize_##name) {       \
-    SerializeBenchmark benchmark;            \
-    benchmark.serializeUnsafe(rowType);      \
-  }                                          \
-                                             \
-  BENCHMARK(compact_serialize_##name) {      \
-    SerializeBenchmark benchmark;            \
-    benchmark.serializeCompact(rowType);     \
-  }                                          \
-                                             \
-  BENCHMARK(container_serialize_##name) {    \
-    SerializeBenchmark benchmark;            \
-    benchmark.serializeContainer(rowType);   \
-  }                                          \
-                                             \
-  BENCHMARK(unsafe_deserialize_##name) {     \
-    SerializeBenchmark benchmark;            \
-    benchmark.deserializeUnsafe(rowType);    \
-  }                                          \
-                                             \
-  BENCHMARK(compact_deserialize_##name) {    \
-    SerializeBenchmark benchmark;            \
-    benchmark.deserializeCompact(rowType);   \
-  }                                          \
-                                             \
-  BENCHMARK(container_deserialize_##name) {  \
-    SerializeBenchmark benchmark;            \
-    benchmark.deserializeContainer(rowType); \
+#define SERDE_BENCHMARKS(name, rowType)               \
+  BENCHMARK(unsafe_serialize_##name) {                \
+    SerializeBenchmark benchmark;                     \
+    benchmark.serializeUnsafe(rowType);               \
+  }                                                   \
+                                                      \
+  BENCHMARK_RELATIVE(unsafe_batch_serialize_##name) { \
+    SerializeBenchmark benchmark;                     \
+    benchmark.serializeUnsafeBatch(rowType);          \
+  }                                                   \
+                                                      \
+  BENCHMARK(compact_serialize_##name) {               \
+    SerializeBenchmark benchmark;                     \
+    benchmark.serializeCompact(rowType);              \
+  }                                                   \
+                                                      \
+  BENCHMARK(container_serialize_##name) {             \
+    SerializeBenchmark benchmark;                     \
+    benchmark.serializeContainer(rowType);            \
+  }                                                   \
+                                                      \
+  BENCHMARK(unsafe_deserialize_##name) {              \
+    SerializeBenchmark benchmark;                     \
+    benchmark.deserializeUnsafe(rowType);             \
+  }                                                   \
+                                                      \
+  BENCHMARK(compact_deserialize_##name) {             \
+    SerializeBenchmark benchmark;                     \
+    benchmark.deserializeCompact(rowType);            \
+  }                                                   \
+                                                      \
+  BENCHMARK(container_deserialize_##name) {           \
+    SerializeBenchmark benchmark;                     \
+    benchmark.deserializeContainer(rowType);          \
   }
 
 SERDE_BENCHMARKS(
@@ -285,6 +325,20 @@ SERDE_BENCHMARKS(
         VARCHAR(),
     }));
 
+BENCHMARK(compact_deserialize_strings5_first) {
+  SerializeBenchmark benchmark;
+  benchmark.deserializeCompactColumn(
+      ROW({BIGINT(), VARCHAR(), VARCHAR(), VARCHAR(), VARCHAR(), VARCHAR()}),
+      0);
+}
+
+BENCHMARK(compact_deserialize_strings5_last) {
+  SerializeBenchmark benchmark;
+  benchmark.deserializeCompactColumn(
+      ROW({BIGINT(), VARCHAR(), VARCHAR(), VARCHAR(), VARCHAR(), VARCHAR()}),
+      5);
+}
+
 SERDE_BENCHMARKS(arrays, ROW({BIGINT(), ARRAY(BIGINT())}));
 
 SERDE_BENCHMARKS(nestedArrays, ROW({BIGINT(), ARRAY(ARRAY(BIGINT()))}));
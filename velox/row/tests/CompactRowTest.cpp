@@ -74,6 +74,21 @@ class CompactRowTest : public ::testing::Test, public VectorTestBase {
 
     auto copy = CompactRow::deserialize(serialized, rowType, pool());
     assertEqualVectors(data, copy);
+
+    // Deserialize each column on its own and the columns in reverse order.
+    std::vector<column_index_t> reversed;
+    for (column_index_t i = 0; i < rowType->size(); ++i) {
+      auto column = CompactRow::deserialize(serialized, rowType, {i}, pool());
+      ASSERT_EQ(1, column->childrenSize());
+      assertEqualVectors(data->childAt(i), column->childAt(0));
+      reversed.insert(reversed.begin(), i);
+    }
+
+    auto columns =
+        CompactRow::deserialize(serialized, rowType, reversed, pool());
+    for (auto i = 0; i < reversed.size(); ++i) {
+      assertEqualVectors(data->childAt(reversed[i]), columns->childAt(i));
+    }
   }
 };
 
@@ -174,6 +174,38 @@ TEST_F(UnsafeRowFuzzTests, fast) {
     }
     return serialized;
   });
+
+  // Serialize a column at a time into one buffer. The rows must match
+  // row-by-row serialization byte for byte.
+  std::string buffer;
+  doTest(rowType, [&](const RowVectorPtr& data) {
+    const auto numRows = data->size();
+    UnsafeRowFast fast(data);
+
+    std::vector<int32_t> rowSizes(numRows);
+    fast.rowSizes(0, numRows, rowSizes.data());
+
+    std::vector<size_t> rowOffsets(numRows);
+    size_t totalSize = 0;
+    for (auto i = 0; i < numRows; ++i) {
+      EXPECT_EQ(rowSizes[i], fast.rowSize(i)) << i;
+      rowOffsets[i] = totalSize;
+      totalSize += rowSizes[i];
+    }
+
+    buffer.assign(totalSize, '\0');
+    fast.serialize(0, numRows, rowOffsets.data(), buffer.data());
+
+    std::vector<std::optional<std::string_view>> serialized;
+    serialized.reserve(numRows);
+    for (auto i = 0; i < numRows; ++i) {
+      auto rowSize = fast.serialize(i, buffers_[i]);
+      std::string_view row(buffer.data() + rowOffsets[i], rowSizes[i]);
+      EXPECT_EQ(std::string_view(buffers_[i], rowSize), row) << i;
+      serialized.push_back(row);
+    }
+    return serialized;
+  });
 }
 
 } // namespace
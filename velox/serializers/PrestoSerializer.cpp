@@ -28,6 +28,10 @@ constexpr int8_t kCompressedBitMask = 1;
 constexpr int8_t kEncryptedBitMask = 2;
 constexpr int8_t kCheckSumBitMask = 4;
 constexpr folly::StringPiece kRLE{"RLE"};
+constexpr folly::StringPiece kDictionary{"DICTIONARY"};
+// Size of the dictionary instance id that follows the ids of a DICTIONARY
+// block: two longs of a UUID and a sequence id.
+constexpr int32_t kDictionaryIdSize = 3 * sizeof(int64_t);
 
 int64_t computeChecksum(
     PrestoOutputStreamListener* listener,
@@ -149,6 +153,18 @@ FOLLY_ALWAYS_INLINE bool needCompression(const folly::io::Codec& codec) {
   return codec.type() != folly::io::CodecType::NO_COMPRESSION;
 }
 
+std::optional<common::BlockCompressionOptions> blockCompressionOptions(
+    const PrestoVectorSerde::PrestoOptions& options) {
+  if (options.compressionBlockSize == 0) {
+    return std::nullopt;
+  }
+  common::BlockCompressionOptions blockOptions;
+  blockOptions.level = options.compressionLevel;
+  blockOptions.blockSize = options.compressionBlockSize;
+  blockOptions.executor = options.compressionExecutor;
+  return blockOptions;
+}
+
 template <typename T>
 void readValues(
     ByteStream* source,
@@ -430,6 +446,27 @@ void readConstantVector(
   *result = BaseVector::wrapInConstant(size, 0, children[0]);
 }
 
+void readDictionaryVector(
+    ByteStream* source,
+    const TypePtr& type,
+    velox::memory::MemoryPool* pool,
+    VectorPtr* result,
+    bool useLosslessTimestamp) {
+  const auto size = source->read<int32_t>();
+  std::vector<TypePtr> childTypes = {type};
+  std::vector<VectorPtr> children(1);
+  readColumns(source, pool, childTypes, &children, useLosslessTimestamp);
+
+  auto indices = allocateIndices(size, pool);
+  source->readBytes(
+      indices->asMutable<uint8_t>(), size * sizeof(vector_size_t));
+  // Skip the dictionary instance id.
+  char id[kDictionaryIdSize];
+  source->readBytes(id, kDictionaryIdSize);
+  *result = BaseVector::wrapInDictionary(
+      nullptr, std::move(indices), size, std::move(children[0]));
+}
+
 void readArrayVector(
     ByteStream* source,
     std::shared_ptr<const Type> type,
@@ -701,8 +738,19 @@ void readColumns(
     if (encoding == kRLE) {
       readConstantVector(
           source, types[i], pool, &(*result)[i], useLosslessTimestamp);
+    } else if (encoding == kDictionary) {
+      readDictionaryVector(
+          source, types[i], pool, &(*result)[i], useLosslessTimestamp);
     } else {
       checkTypeEncoding(encoding, types[i]);
+      auto& reused = (*result)[i];
+      if (reused &&
+          (VectorEncoding::isConstant(reused->encoding()) ||
+           VectorEncoding::isDictionary(reused->encoding()))) {
+        // A previous page had a DICTIONARY or RLE block for this column. The
+        // readers below only reuse flat vectors.
+        reused = nullptr;
+      }
       auto it = readers.find(types[i]->kind());
       VELOX_CHECK(
           it != readers.end(),
@@ -1293,6 +1341,31 @@ void serializeBiasVector(
   }
 }
 
+// Appends row 'i' of flat 'vector' to 'streams[partitions[i]]' for all rows
+// in one pass over 'vector'.
+template <TypeKind kind>
+void scatterFlatVector(
+    const BaseVector* vector,
+    folly::Range<const uint32_t*> partitions,
+    const std::vector<VectorStream*>& streams) {
+  using T = typename TypeTraits<kind>::NativeType;
+  auto* flatVector = vector->asUnchecked<FlatVector<T>>();
+  const bool mayHaveNulls = flatVector->mayHaveNulls();
+  for (vector_size_t row = 0; row < partitions.size(); ++row) {
+    auto* stream = streams[partitions[row]];
+    if (mayHaveNulls && flatVector->isNullAt(row)) {
+      stream->appendNull();
+      continue;
+    }
+    stream->appendNonNull();
+    if constexpr (std::is_same_v<T, bool>) {
+      stream->appendOne<uint8_t>(flatVector->valueAtFast(row) ? 1 : 0);
+    } else {
+      stream->appendOne(flatVector->rawValues()[row]);
+    }
+  }
+}
+
 void serializeColumn(
     const BaseVector* vector,
     const folly::Range<const IndexRange*>& ranges,
@@ -1609,9 +1682,18 @@ class PrestoVectorSerializer : public VectorSerializer {
       int32_t numRows,
       StreamArena* streamArena,
       bool useLosslessTimestamp,
-      common::CompressionKind compressionKind)
+      common::CompressionKind compressionKind,
+      int32_t compressionLevel,
+      std::optional<common::BlockCompressionOptions> blockCompression,
+      bool preserveEncodings)
       : streamArena_(streamArena),
-        codec_(common::compressionKindToCodec(compressionKind)) {
+        compressionKind_(compressionKind),
+        codec_(common::compressionKindToCodec(
+            compressionKind,
+            compressionLevel)),
+        blockCompression_(std::move(blockCompression)),
+        useLosslessTimestamp_(useLosslessTimestamp),
+        preserveEncodings_(preserveEncodings) {
     auto types = rowType->children();
     auto numTypes = types.size();
     streams_.resize(numTypes);
@@ -1619,6 +1701,9 @@ class PrestoVectorSerializer : public VectorSerializer {
       streams_[i] = std::make_unique<VectorStream>(
           types[i], streamArena, numRows, useLosslessTimestamp);
     }
+    if (preserveEncodings_) {
+      encodedColumns_.resize(numTypes);
+    }
   }
 
   void append(
@@ -1628,21 +1713,33 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (newRows > 0) {
       numRows_ += newRows;
       for (int32_t i = 0; i < vector->childrenSize(); ++i) {
-        serializeColumn(vector->childAt(i).get(), ranges, streams_[i].get());
+        if (preserveEncodings_) {
+          appendEncoded(i, vector->childAt(i), ranges, newRows);
+        } else {
+          serializeColumn(vector->childAt(i).get(), ranges, streams_[i].get());
+        }
       }
     }
   }
 
   size_t maxSerializedSize() const override {
     size_t dataSize = 4; // streams_.size()
-    for (auto& stream : streams_) {
-      dataSize += stream->serializedSize();
+    for (auto i = 0; i < streams_.size(); ++i) {
+      CountingOutputStream out;
+      flushColumn(i, &out);
+      dataSize += out.size();
     }
 
-    auto compressedSize = needCompression(*codec_)
-        ? codec_->maxCompressedLength(dataSize)
-        : dataSize;
-    return kHeaderSize + compressedSize;
+    if (!needCompression(*codec_)) {
+      return kHeaderSize + dataSize;
+    }
+    if (blockCompression_.has_value()) {
+      // A block that does not get smaller is stored as is.
+      const auto blockSize = blockCompression_->blockSize;
+      const auto numBlocks = bits::roundUp(dataSize, blockSize) / blockSize;
+      return kHeaderSize + dataSize + 4 + numBlocks * 8;
+    }
+    return kHeaderSize + codec_->maxCompressedLength(dataSize);
   }
 
   // The SerializedPage layout is:
@@ -1652,6 +1749,19 @@ class PrestoVectorSerializer : public VectorSerializer {
     flushInternal(numRows_, false /*rle*/, out);
   }
 
+  bool preserveEncodings() const {
+    return preserveEncodings_;
+  }
+
+  // Counts 'numRows' rows appended directly to the column streams.
+  void addNumRows(int32_t numRows) {
+    numRows_ += numRows;
+  }
+
+  VectorStream* streamAt(int32_t column) const {
+    return streams_[column].get();
+  }
+
   void flushRle(const RowVectorPtr& vector, OutputStream* out) {
     VELOX_CHECK_EQ(0, numRows_);
     for (auto& child : vector->children()) {
@@ -1659,12 +1769,171 @@ class PrestoVectorSerializer : public VectorSerializer {
     }
 
     std::vector<IndexRange> ranges{{0, 1}};
-    append(vector, folly::Range(ranges.data(), ranges.size()));
+    for (int32_t i = 0; i < vector->childrenSize(); ++i) {
+      serializeColumn(vector->childAt(i).get(), ranges, streams_[i].get());
+    }
 
     flushInternal(vector->size(), true /*rle*/, out);
   }
 
  private:
+  // The encoding of a top level column if 'preserveEncodings_'. A column is
+  // undecided until its first non-empty append.
+  enum class ColumnEncoding { kUndecided, kFlat, kDictionary, kConstant };
+
+  struct EncodedColumn {
+    ColumnEncoding encoding{ColumnEncoding::kUndecided};
+    // The base of a dictionary column or the vector of a constant column.
+    VectorPtr base;
+    // 'base' serialized in full for a dictionary column, or the constant
+    // value for a constant column.
+    std::unique_ptr<VectorStream> baseStream;
+    // The ids into 'base' of the rows of a dictionary column.
+    std::vector<vector_size_t> indices;
+    // The number of rows of a constant column.
+    int32_t numRows{0};
+  };
+
+  void appendEncoded(
+      int32_t column,
+      const VectorPtr& vector,
+      const folly::Range<const IndexRange*>& ranges,
+      int32_t numNewRows) {
+    auto& encoded = encodedColumns_[column];
+    if (encoded.encoding == ColumnEncoding::kUndecided) {
+      startEncoding(column, vector, numNewRows);
+    } else if (!canAppendEncoded(encoded, *vector)) {
+      flattenEncoded(column);
+    }
+
+    switch (encoded.encoding) {
+      case ColumnEncoding::kDictionary: {
+        const auto* ids = vector->wrapInfo()->as<vector_size_t>();
+        for (const auto& range : ranges) {
+          encoded.indices.insert(
+              encoded.indices.end(),
+              ids + range.begin,
+              ids + range.begin + range.size);
+        }
+        break;
+      }
+      case ColumnEncoding::kConstant:
+        encoded.numRows += numNewRows;
+        break;
+      default:
+        serializeColumn(vector.get(), ranges, streams_[column].get());
+    }
+  }
+
+  static bool isPlainDictionary(const BaseVector& vector) {
+    return vector.encoding() == VectorEncoding::Simple::DICTIONARY &&
+        vector.rawNulls() == nullptr;
+  }
+
+  // Decides the encoding of 'column' from its first appended vector. A
+  // dictionary is kept only if its base is not larger than the appended
+  // rows, so that sending the base does not cost more than flattening.
+  void startEncoding(
+      int32_t column,
+      const VectorPtr& vector,
+      int32_t numNewRows) {
+    auto& encoded = encodedColumns_[column];
+    encoded.encoding = ColumnEncoding::kFlat;
+    IndexRange baseRange{0, 1};
+    if (isPlainDictionary(*vector) &&
+        vector->valueVector()->size() <= numNewRows) {
+      encoded.encoding = ColumnEncoding::kDictionary;
+      encoded.base = vector->valueVector();
+      baseRange.size = encoded.base->size();
+    } else if (vector->isConstantEncoding()) {
+      encoded.encoding = ColumnEncoding::kConstant;
+      encoded.base = vector;
+    } else {
+      return;
+    }
+    encoded.baseStream = std::make_unique<VectorStream>(
+        vector->type(), streamArena_, baseRange.size, useLosslessTimestamp_);
+    serializeColumn(
+        encoded.base.get(),
+        folly::Range(&baseRange, 1),
+        encoded.baseStream.get());
+  }
+
+  static bool canAppendEncoded(
+      const EncodedColumn& encoded,
+      const BaseVector& vector) {
+    switch (encoded.encoding) {
+      case ColumnEncoding::kDictionary:
+        return isPlainDictionary(vector) &&
+            vector.valueVector().get() == encoded.base.get();
+      case ColumnEncoding::kConstant:
+        return vector.isConstantEncoding() &&
+            vector.equalValueAt(encoded.base.get(), 0, 0);
+      default:
+        return true;
+    }
+  }
+
+  // Writes the rows of a dictionary or constant 'column' to its flat stream
+  // and keeps the column flat from now on.
+  void flattenEncoded(int32_t column) {
+    auto& encoded = encodedColumns_[column];
+    VectorPtr rows;
+    if (encoded.encoding == ColumnEncoding::kDictionary) {
+      const auto numRows = encoded.indices.size();
+      auto indices = allocateIndices(numRows, streamArena_->pool());
+      std::copy(
+          encoded.indices.begin(),
+          encoded.indices.end(),
+          indices->asMutable<vector_size_t>());
+      rows = BaseVector::wrapInDictionary(
+          nullptr, std::move(indices), numRows, encoded.base);
+    } else if (encoded.encoding == ColumnEncoding::kConstant) {
+      rows = BaseVector::wrapInConstant(encoded.numRows, 0, encoded.base);
+    }
+    if (rows != nullptr && rows->size() > 0) {
+      IndexRange range{0, rows->size()};
+      serializeColumn(
+          rows.get(), folly::Range(&range, 1), streams_[column].get());
+    }
+    encoded = EncodedColumn();
+    encoded.encoding = ColumnEncoding::kFlat;
+  }
+
+  // Writes 'column' in wire format, as a DICTIONARY or RLE block if it kept
+  // its encoding. Does not change the state.
+  void flushColumn(int32_t column, OutputStream* out) const {
+    if (!preserveEncodings_) {
+      streams_[column]->flush(out);
+      return;
+    }
+    const auto& encoded = encodedColumns_[column];
+    switch (encoded.encoding) {
+      case ColumnEncoding::kDictionary: {
+        writeInt32(out, kDictionary.size());
+        out->write(kDictionary.data(), kDictionary.size());
+        writeInt32(out, encoded.indices.size());
+        encoded.baseStream->flush(out);
+        out->write(
+            reinterpret_cast<const char*>(encoded.indices.data()),
+            encoded.indices.size() * sizeof(vector_size_t));
+        // The wire format has a dictionary instance id that only matters to
+        // readers which share dictionaries across blocks. Velox does not.
+        const char id[kDictionaryIdSize] = {};
+        out->write(id, kDictionaryIdSize);
+        return;
+      }
+      case ColumnEncoding::kConstant:
+        writeInt32(out, kRLE.size());
+        out->write(kRLE.data(), kRLE.size());
+        writeInt32(out, encoded.numRows);
+        encoded.baseStream->flush(out);
+        return;
+      default:
+        streams_[column]->flush(out);
+    }
+  }
+
   void flushUncompressed(
       int32_t numRows,
       bool rle,
@@ -1704,8 +1973,8 @@ class PrestoVectorSerializer : public VectorSerializer {
       writeInt32(out, numRows);
     }
 
-    for (auto& stream : streams_) {
-      stream->flush(out);
+    for (auto i = 0; i < streams_.size(); ++i) {
+      flushColumn(i, out);
     }
 
     // Pause CRC computation
@@ -1758,16 +2027,19 @@ class PrestoVectorSerializer : public VectorSerializer {
       writeInt32(&out, numRows);
     }
 
-    for (auto& stream : streams_) {
-      stream->flush(&out);
+    for (auto i = 0; i < streams_.size(); ++i) {
+      flushColumn(i, &out);
     }
     const int32_t uncompressedSize = out.tellp();
     VELOX_CHECK_LE(
         uncompressedSize,
         codec_->maxUncompressedLength(),
         "UncompressedSize exceeds limit");
-    auto compressed = codec_->compress(out.getIOBuf().get());
-    const int32_t compressedSize = compressed->length();
+    auto compressed = blockCompression_.has_value()
+        ? common::compressBlocks(
+              *out.getIOBuf(), compressionKind_, *blockCompression_)
+        : codec_->compress(out.getIOBuf().get());
+    const int32_t compressedSize = compressed->computeChainDataLength();
     writeInt32(output, uncompressedSize);
     writeInt32(output, compressedSize);
     const int32_t crcOffset = output->tellp();
@@ -1776,9 +2048,9 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (listener) {
       listener->resume();
     }
-    output->write(
-        reinterpret_cast<const char*>(compressed->writableData()),
-        compressed->length());
+    for (auto range : *compressed) {
+      output->write(reinterpret_cast<const char*>(range.data()), range.size());
+    }
     // Pause CRC computation
     if (listener) {
       listener->pause();
@@ -1813,9 +2085,16 @@ class PrestoVectorSerializer : public VectorSerializer {
   static const int32_t kHeaderSize{kSizeInBytesOffset + 4 + 4 + 8};
 
   StreamArena* const streamArena_;
+  const common::CompressionKind compressionKind_;
   const std::unique_ptr<folly::io::Codec> codec_;
+  // Set if compressed pages are compressed as independent blocks.
+  const std::optional<common::BlockCompressionOptions> blockCompression_;
+  const bool useLosslessTimestamp_;
+  const bool preserveEncodings_;
   int32_t numRows_{0};
   std::vector<std::unique_ptr<VectorStream>> streams_;
+  // One per column if 'preserveEncodings_'.
+  std::vector<EncodedColumn> encodedColumns_;
 };
 } // namespace
 
@@ -1837,7 +2116,64 @@ std::unique_ptr<VectorSerializer> PrestoVectorSerde::createSerializer(
       numRows,
       streamArena,
       prestoOptions.useLosslessTimestamp,
-      prestoOptions.compressionKind);
+      prestoOptions.compressionKind,
+      prestoOptions.compressionLevel,
+      blockCompressionOptions(prestoOptions),
+      prestoOptions.preserveEncodings);
+}
+
+void PrestoVectorSerde::scatter(
+    const RowVectorPtr& vector,
+    folly::Range<const uint32_t*> partitions,
+    const std::vector<VectorSerializer*>& serializers) {
+  const auto numPartitions = serializers.size();
+  std::vector<PrestoVectorSerializer*> prestoSerializers(numPartitions);
+  for (auto i = 0; i < numPartitions; ++i) {
+    if (serializers[i] == nullptr) {
+      continue;
+    }
+    prestoSerializers[i] = static_cast<PrestoVectorSerializer*>(serializers[i]);
+    if (prestoSerializers[i]->preserveEncodings()) {
+      // The encoding of a column is decided per serializer.
+      VectorSerde::scatter(vector, partitions, serializers);
+      return;
+    }
+  }
+
+  std::vector<int32_t> numRows(numPartitions, 0);
+  for (auto partition : partitions) {
+    ++numRows[partition];
+  }
+  for (auto i = 0; i < numPartitions; ++i) {
+    if (numRows[i] > 0) {
+      prestoSerializers[i]->addNumRows(numRows[i]);
+    }
+  }
+
+  std::vector<VectorStream*> streams(numPartitions);
+  // The rows of each partition for the columns that are not flat. Made on
+  // first use.
+  std::vector<std::vector<IndexRange>> ranges;
+  for (auto column = 0; column < vector->childrenSize(); ++column) {
+    for (auto i = 0; i < numPartitions; ++i) {
+      streams[i] = numRows[i] > 0 ? prestoSerializers[i]->streamAt(column)
+                                  : nullptr;
+    }
+    const auto* child = vector->childAt(column)->loadedVector();
+    if (child->encoding() == VectorEncoding::Simple::FLAT) {
+      VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
+          scatterFlatVector, child->typeKind(), child, partitions, streams);
+      continue;
+    }
+    if (ranges.empty()) {
+      ranges = toPartitionRanges(partitions, numPartitions);
+    }
+    for (auto i = 0; i < numPartitions; ++i) {
+      if (!ranges[i].empty()) {
+        serializeColumn(child, ranges[i], streams[i]);
+      }
+    }
+  }
 }
 
 void PrestoVectorSerde::serializeConstants(
@@ -1898,7 +2234,12 @@ void PrestoVectorSerde::deserialize(
     auto compressBuf = folly::IOBuf::create(compressedSize);
     source->readBytes(compressBuf->writableData(), compressedSize);
     compressBuf->append(compressedSize);
-    auto uncompress = codec->uncompress(compressBuf.get(), uncompressedSize);
+    auto uncompress = prestoOptions.compressionBlockSize > 0
+        ? common::uncompressBlocks(
+              *compressBuf,
+              prestoOptions.compressionKind,
+              prestoOptions.compressionExecutor)
+        : codec->uncompress(compressBuf.get(), uncompressedSize);
     ByteRange byteRange{
         uncompress->writableData(), (int32_t)uncompress->length(), 0};
     ByteStream uncompressedSource;
@@ -15,6 +15,7 @@
  */
 #pragma once
 #include "velox/common/base/Crc.h"
+#include "velox/common/compression/BlockCompression.h"
 #include "velox/common/compression/Compression.h"
 #include "velox/vector/VectorStream.h"
 
@@ -27,9 +28,11 @@ class PrestoVectorSerde : public VectorSerde {
 
     PrestoOptions(
         bool _useLosslessTimestamp,
-        common::CompressionKind _compressionKind)
+        common::CompressionKind _compressionKind,
+        bool _preserveEncodings = false)
         : useLosslessTimestamp(_useLosslessTimestamp),
-          compressionKind(_compressionKind) {}
+          compressionKind(_compressionKind),
+          preserveEncodings(_preserveEncodings) {}
 
     // Currently presto only supports millisecond precision and the serializer
     // converts velox native timestamp to that resulting in loss of precision.
@@ -38,6 +41,29 @@ class PrestoVectorSerde : public VectorSerde {
     bool useLosslessTimestamp{false};
     common::CompressionKind compressionKind{
         common::CompressionKind::CompressionKind_NONE};
+
+    // If true, a top level column that is a dictionary or constant vector in
+    // every appended batch is serialized as a DICTIONARY or RLE block instead
+    // of being flattened. A dictionary is only kept if all batches share its
+    // base vector and the base is not larger than the rows taken from it.
+    // Columns that do not qualify and nested columns are flattened. The
+    // deserializer reads both encodings regardless of this option.
+    bool preserveEncodings{false};
+
+    // Codec level of compressed pages, e.g. 1 to 22 for ZSTD.
+    int32_t compressionLevel{folly::io::COMPRESSION_LEVEL_DEFAULT};
+
+    // If non-zero, the data of a compressed page is compressed as independent
+    // blocks of this many bytes with common::BlockCompressor, so that large
+    // pages are compressed and decompressed in parallel on
+    // 'compressionExecutor'. Presto does not read this format, so it is only
+    // for pages read back by Velox, e.g. spill files. The deserializer must
+    // get the same setting.
+    uint64_t compressionBlockSize{0};
+
+    // Executor for the blocks of 'compressionBlockSize'. If nullptr, the
+    // blocks are processed on the calling thread.
+    folly::Executor* compressionExecutor{nullptr};
   };
 
   void estimateSerializedSize(
@@ -51,6 +77,14 @@ class PrestoVectorSerde : public VectorSerde {
       StreamArena* streamArena,
       const Options* options) override;
 
+  /// Appends each flat column of 'vector' to the streams of all
+  /// 'serializers' in one pass over the column. Other columns are appended
+  /// to one serializer at a time.
+  void scatter(
+      const RowVectorPtr& vector,
+      folly::Range<const uint32_t*> partitions,
+      const std::vector<VectorSerializer*>& serializers) override;
+
   /// Serializes a RowVector with a constant children.
   void serializeConstants(
       const RowVectorPtr& vector,
@@ -40,17 +40,19 @@ class UnsafeRowVectorSerializer : public VectorSerializer {
       const folly::Range<const IndexRange*>& ranges) override {
     size_t totalSize = 0;
     row::UnsafeRowFast unsafeRow(vector);
-    if (auto fixedRowSize =
-            row::UnsafeRowFast::fixedRowSize(asRowType(vector->type()))) {
-      for (const auto& range : ranges) {
-        totalSize += (fixedRowSize.value() + sizeof(TRowSize)) * range.size;
+    const auto fixedRowSize =
+        row::UnsafeRowFast::fixedRowSize(asRowType(vector->type()));
+    std::vector<std::vector<int32_t>> rowSizes(ranges.size());
+    for (auto i = 0; i < ranges.size(); ++i) {
+      const auto& range = ranges[i];
+      if (fixedRowSize) {
+        rowSizes[i].resize(range.size, fixedRowSize.value());
+      } else {
+        rowSizes[i].resize(range.size);
+        unsafeRow.rowSizes(range.begin, range.size, rowSizes[i].data());
       }
-
-    } else {
-      for (const auto& range : ranges) {
-        for (auto i = range.begin; i < range.begin + range.size; ++i) {
-          totalSize += unsafeRow.rowSize(i) + sizeof(TRowSize);
-        }
+      for (auto size : rowSizes[i]) {
+        totalSize += size + sizeof(TRowSize);
       }
     }
 
@@ -62,17 +64,20 @@ class UnsafeRowVectorSerializer : public VectorSerializer {
     auto rawBuffer = buffer->asMutable<char>();
     buffers_.push_back(std::move(buffer));
 
+    // Write the big endian size in front of each row, then all the rows of a
+    // range a column at a time.
     size_t offset = 0;
-    for (auto& range : ranges) {
-      for (auto i = range.begin; i < range.begin + range.size; ++i) {
-        // Write row data.
-        TRowSize size =
-            unsafeRow.serialize(i, rawBuffer + offset + sizeof(TRowSize));
-
-        // Write raw size. Needs to be in big endian order.
+    std::vector<size_t> rowOffsets;
+    for (auto i = 0; i < ranges.size(); ++i) {
+      rowOffsets.resize(ranges[i].size);
+      for (auto j = 0; j < ranges[i].size; ++j) {
+        const TRowSize size = rowSizes[i][j];
         *(TRowSize*)(rawBuffer + offset) = folly::Endian::big(size);
+        rowOffsets[j] = offset + sizeof(TRowSize);
         offset += sizeof(TRowSize) + size;
       }
+      unsafeRow.serialize(
+          ranges[i].begin, ranges[i].size, rowOffsets.data(), rawBuffer);
     }
   }
 
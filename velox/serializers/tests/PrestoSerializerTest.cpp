@@ -15,6 +15,7 @@
  */
 #include "velox/serializers/PrestoSerializer.h"
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <vector>
 #include "velox/common/base/tests/GTestUtils.h"
@@ -61,11 +62,11 @@ class PrestoSerializerTest
   serializer::presto::PrestoVectorSerde::PrestoOptions getParamSerdeOptions(
       const serializer::presto::PrestoVectorSerde::PrestoOptions*
           serdeOptions) {
-    const bool useLosslessTimestamp =
-        serdeOptions == nullptr ? false : serdeOptions->useLosslessTimestamp;
-    common::CompressionKind kind = GetParam();
-    serializer::presto::PrestoVectorSerde::PrestoOptions paramOptions{
-        useLosslessTimestamp, kind};
+    serializer::presto::PrestoVectorSerde::PrestoOptions paramOptions;
+    if (serdeOptions != nullptr) {
+      paramOptions = *serdeOptions;
+    }
+    paramOptions.compressionKind = GetParam();
     return paramOptions;
   }
 
@@ -402,6 +403,151 @@ TEST_P(PrestoSerializerTest, rle) {
       MAP(VARCHAR(), INTEGER()), 17, pool_.get()));
 }
 
+TEST_P(PrestoSerializerTest, preserveEncodings) {
+  serializer::presto::PrestoVectorSerde::PrestoOptions options;
+  options.preserveEncodings = true;
+  auto paramOptions = getParamSerdeOptions(&options);
+
+  auto base = vectorMaker_->flatVector<std::string>(
+      {"apple", "banana", "cherry", "durian"});
+  auto makeBatch = [&](const VectorPtr& dictionaryBase,
+                       const VectorPtr& flatColumn) {
+    auto indices = makeIndices(
+        10, [](auto row) { return (row * 3) % 4; }, pool_.get());
+    return vectorMaker_->rowVector({
+        BaseVector::wrapInDictionary(nullptr, indices, 10, dictionaryBase),
+        BaseVector::createConstant(BIGINT(), 11, 10, pool_.get()),
+        flatColumn,
+    });
+  };
+  auto flat = vectorMaker_->flatVector<int32_t>(10, [](auto row) {
+    return row;
+  });
+
+  auto serializeBatches = [&](const std::vector<RowVectorPtr>& batches) {
+    auto arena = std::make_unique<StreamArena>(pool_.get());
+    auto rowType = asRowType(batches[0]->type());
+    auto serializer =
+        serde_->createSerializer(rowType, 10, arena.get(), &paramOptions);
+    for (const auto& batch : batches) {
+      serializer->append(batch);
+    }
+    const auto size = serializer->maxSerializedSize();
+    std::ostringstream output;
+    facebook::velox::serializer::presto::PrestoOutputStreamListener listener;
+    OStreamOutputStream out(&output, &listener);
+    serializer->flush(&out);
+    if (paramOptions.compressionKind == common::CompressionKind_NONE) {
+      EXPECT_EQ(size, output.str().size());
+    }
+    return output.str();
+  };
+
+  // Batches over the same dictionary base keep the dictionary and equal
+  // constants stay RLE.
+  auto concat = [&](const std::vector<RowVectorPtr>& batches) {
+    auto result = BaseVector::create(batches[0]->type(), 0, pool_.get());
+    for (const auto& batch : batches) {
+      result->append(batch.get());
+    }
+    return result;
+  };
+
+  std::vector<RowVectorPtr> batches = {
+      makeBatch(base, flat), makeBatch(base, flat)};
+  auto expected = concat(batches);
+  auto rowType = asRowType(expected->type());
+  auto result = deserialize(rowType, serializeBatches(batches), &options);
+  ASSERT_EQ(
+      result->childAt(0)->encoding(), VectorEncoding::Simple::DICTIONARY);
+  ASSERT_EQ(result->childAt(0)->valueVector()->size(), base->size());
+  ASSERT_TRUE(result->childAt(1)->isConstantEncoding());
+  ASSERT_TRUE(result->childAt(2)->isFlatEncoding());
+  assertEqualVectors(expected, result);
+
+  // A batch over a different base flattens the column. Reading into the
+  // previous result must not reuse its dictionary.
+  auto otherBase = vectorMaker_->flatVector<std::string>(
+      {"elderberry", "fig", "grape", "honeydew"});
+  batches = {makeBatch(base, flat), makeBatch(otherBase, flat)};
+  expected = concat(batches);
+  auto byteStream = toByteStream(serializeBatches(batches));
+  serde_->deserialize(
+      byteStream.get(), pool_.get(), rowType, &result, &paramOptions);
+  ASSERT_TRUE(result->childAt(0)->isFlatEncoding());
+  ASSERT_TRUE(result->childAt(1)->isConstantEncoding());
+  assertEqualVectors(expected, result);
+
+  // A dictionary with a base larger than its rows is flattened.
+  auto largeBase = vectorMaker_->flatVector<std::string>(
+      100, [](auto row) { return std::string(row % 7, 'x'); });
+  batches = {makeBatch(largeBase, flat)};
+  result = deserialize(rowType, serializeBatches(batches), &options);
+  ASSERT_TRUE(result->childAt(0)->isFlatEncoding());
+  assertEqualVectors(batches[0], result);
+}
+
+TEST_P(PrestoSerializerTest, scatter) {
+  constexpr int32_t kNumRows = 1'000;
+  constexpr int32_t kNumPartitions = 7;
+  auto rowVector = vectorMaker_->rowVector({
+      vectorMaker_->flatVector<int64_t>(
+          kNumRows,
+          [](auto row) { return row; },
+          test::VectorMaker::nullEvery(5)),
+      vectorMaker_->flatVector<bool>(
+          kNumRows, [](auto row) { return row % 3 == 0; }),
+      vectorMaker_->flatVector<std::string>(
+          kNumRows,
+          [](auto row) { return std::string(row % 20, 'a' + row % 26); },
+          test::VectorMaker::nullEvery(7)),
+      vectorMaker_->arrayVector<int32_t>(
+          kNumRows,
+          [](vector_size_t row) { return row % 4; },
+          [](vector_size_t idx) { return idx; }),
+      BaseVector::createConstant(BIGINT(), 11, kNumRows, pool_.get()),
+  });
+  std::vector<uint32_t> partitions(kNumRows);
+  for (auto i = 0; i < kNumRows; ++i) {
+    partitions[i] = (i * 13 + i / 10) % kNumPartitions;
+  }
+
+  auto paramOptions = getParamSerdeOptions(nullptr);
+  auto arena = std::make_unique<StreamArena>(pool_.get());
+  auto rowType = asRowType(rowVector->type());
+  std::vector<std::unique_ptr<VectorSerializer>> serializers;
+  std::vector<VectorSerializer*> rawSerializers;
+  for (auto i = 0; i < kNumPartitions; ++i) {
+    serializers.push_back(
+        serde_->createSerializer(rowType, 10, arena.get(), &paramOptions));
+    rawSerializers.push_back(serializers.back().get());
+  }
+  // The last serializer gets no rows.
+  rawSerializers.push_back(nullptr);
+  serde_->scatter(
+      rowVector, folly::Range(partitions.data(), kNumRows), rawSerializers);
+
+  for (auto i = 0; i < kNumPartitions; ++i) {
+    std::vector<vector_size_t> rows;
+    for (auto row = 0; row < kNumRows; ++row) {
+      if (partitions[row] == i) {
+        rows.push_back(row);
+      }
+    }
+    auto indices = makeIndices(
+        rows.size(), [&](auto row) { return rows[row]; }, pool_.get());
+    auto expected =
+        BaseVector::wrapInDictionary(nullptr, indices, rows.size(), rowVector);
+
+    std::ostringstream output;
+    facebook::velox::serializer::presto::PrestoOutputStreamListener listener;
+    OStreamOutputStream out(&output, &listener);
+    serializers[i]->flush(&out);
+    auto result = deserialize(rowType, output.str(), nullptr);
+    assertEqualVectors(expected, result);
+  }
+}
+
 TEST_P(PrestoSerializerTest, lazy) {
   constexpr int kSize = 1000;
   auto rowVector = makeTestVector(kSize);
@@ -432,6 +578,19 @@ TEST_P(PrestoSerializerTest, ioBufRoundTrip) {
   }
 }
 
+TEST_P(PrestoSerializerTest, blockCompression) {
+  folly::CPUThreadPoolExecutor executor(4);
+  serializer::presto::PrestoVectorSerde::PrestoOptions options;
+  options.compressionBlockSize = 4 << 10;
+  options.compressionExecutor = &executor;
+  auto vector = makeTestVector(10'000);
+  testRoundTrip(vector, &options);
+
+  options.compressionExecutor = nullptr;
+  options.compressionLevel = folly::io::COMPRESSION_LEVEL_FASTEST;
+  testRoundTrip(vector, &options);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     PrestoSerializerTest,
     PrestoSerializerTest,
@@ -94,6 +94,9 @@ std::string Filter::toString() const {
     case FilterKind::kHugeintValuesUsingHashTable:
       strKind = "HugeintValuesUsingHashTable";
       break;
+    case FilterKind::kBloomFilterValues:
+      strKind = "BloomFilterValues";
+      break;
   };
 
   return fmt::format(
@@ -131,6 +134,7 @@ std::unordered_map<FilterKind, std::string> filterKindNames() {
       {FilterKind::kTimestampRange, "kTimestampRange"},
       {FilterKind::kHugeintValuesUsingHashTable,
        "kHugeintValuesUsingHashTable"},
+      {FilterKind::kBloomFilterValues, "kBloomFilterValues"},
   };
 }
 
@@ -199,6 +203,7 @@ void Filter::registerSerDe() {
   registry.Register("NegatedBytesValues", NegatedBytesValues::create);
   registry.Register("MultiRange", MultiRange::create);
   registry.Register("TimestampRange", TimestampRange::create);
+  registry.Register("BloomFilterValues", BloomFilterValues::create);
 }
 
 folly::dynamic Filter::serializeBase(std::string_view name) const {
@@ -209,6 +214,55 @@ folly::dynamic Filter::serializeBase(std::string_view name) const {
   return obj;
 }
 
+void Filter::testStringViews(
+    const StringView* values,
+    int32_t numValues,
+    uint64_t* passed) const {
+  for (auto i = 0; i < numValues; ++i) {
+    bits::setBit(passed, i, testBytes(values[i].data(), values[i].size()));
+  }
+}
+
+namespace {
+// Calls 'maybePass' with the sizes and prefixes of a batch of 'values' at a
+// time. It returns the lanes that may pass, which are then tested one at a
+// time with 'testOne'. Values that fail in 'maybePass' are not read beyond
+// their StringView.
+template <typename MaybePass, typename TestOne>
+void testStringViewBatches(
+    const StringView* values,
+    int32_t numValues,
+    uint64_t* passed,
+    MaybePass maybePass,
+    TestOne testOne) {
+  constexpr int32_t kBatchSize = xsimd::batch<int32_t>::size;
+  // The size and the prefix are the first 2 of the 4 words of a StringView.
+  static_assert(sizeof(StringView) == 4 * sizeof(int32_t));
+  const auto indices = simd::iota<int32_t>() * xsimd::broadcast<int32_t>(4);
+  const auto* words = reinterpret_cast<const int32_t*>(values);
+  bits::fillBits(passed, 0, numValues, false);
+  int32_t i = 0;
+  for (; i + kBatchSize <= numValues; i += kBatchSize) {
+    const auto* base = words + i * 4;
+    const auto sizes = simd::gather(base, indices);
+    const auto prefixes = simd::gather(base + 1, indices);
+    auto candidates = simd::toBitMask(maybePass(sizes, prefixes));
+    while (candidates) {
+      const auto lane = __builtin_ctz(candidates);
+      candidates &= candidates - 1;
+      if (testOne(values[i + lane])) {
+        bits::setBit(passed, i + lane);
+      }
+    }
+  }
+  for (; i < numValues; ++i) {
+    if (testOne(values[i])) {
+      bits::setBit(passed, i);
+    }
+  }
+}
+} // namespace
+
 folly::dynamic AlwaysFalse::serialize() const {
   return Filter::serializeBase("AlwaysFalse");
 }
@@ -344,6 +398,38 @@ bool TimestampRange::testingEquals(const Filter& other) const {
       (upper_ == otherTimestampRange->upper_);
 }
 
+folly::dynamic BloomFilterValues::serialize() const {
+  auto obj = Filter::serializeBase("BloomFilterValues");
+  std::string bits(bloomFilter_->serializedSize(), '\0');
+  bloomFilter_->serialize(bits.data());
+  obj["bloomFilter"] = bits;
+  return obj;
+}
+
+FilterPtr BloomFilterValues::create(const folly::dynamic& obj) {
+  auto nullAllowed = deserializeNullAllowed(obj);
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->merge(obj["bloomFilter"].asString().data());
+  return std::make_unique<BloomFilterValues>(
+      std::move(bloomFilter), nullAllowed);
+}
+
+bool BloomFilterValues::testingEquals(const Filter& other) const {
+  auto otherBloomFilter = dynamic_cast<const BloomFilterValues*>(&other);
+  if (otherBloomFilter == nullptr || !Filter::testingBaseEquals(other)) {
+    return false;
+  }
+  const auto size = bloomFilter_->serializedSize();
+  if (size != otherBloomFilter->bloomFilter_->serializedSize()) {
+    return false;
+  }
+  std::string bits(size, '\0');
+  std::string otherBits(size, '\0');
+  bloomFilter_->serialize(bits.data());
+  otherBloomFilter->bloomFilter_->serialize(otherBits.data());
+  return bits == otherBits;
+}
+
 folly::dynamic BigintValuesUsingHashTable::serialize() const {
   auto obj = Filter::serializeBase("BigintValuesUsingHashTable");
   obj["min"] = min_;
@@ -1261,6 +1347,47 @@ bool BytesRange::testBytes(const char* value, int32_t length) const {
   return true;
 }
 
+void BytesRange::testStringViews(
+    const StringView* values,
+    int32_t numValues,
+    uint64_t* passed) const {
+  if (singleValue_) {
+    const auto length = xsimd::broadcast<int32_t>(lower_.size());
+    const auto prefix = xsimd::broadcast<int32_t>(
+        static_cast<int32_t>(folly::Endian::big(lowerPrefix_)));
+    testStringViewBatches(
+        values,
+        numValues,
+        passed,
+        [&](auto sizes, auto prefixes) {
+          return (sizes == length) & (prefixes == prefix);
+        },
+        [&](const StringView& value) {
+          return testBytes(value.data(), value.size());
+        });
+    return;
+  }
+  for (auto i = 0; i < numValues; ++i) {
+    const auto& value = values[i];
+    // A value whose prefix differs from the prefix of a bound is on the
+    // same side of the bound as its prefix.
+    const auto prefix =
+        folly::Endian::big(static_cast<uint32_t>(value.prefixAsInt()));
+    bool result;
+    if ((!lowerUnbounded_ && prefix < lowerPrefix_) ||
+        (!upperUnbounded_ && prefix > upperPrefix_)) {
+      result = false;
+    } else if (
+        (lowerUnbounded_ || prefix > lowerPrefix_) &&
+        (upperUnbounded_ || prefix < upperPrefix_)) {
+      result = true;
+    } else {
+      result = testBytes(value.data(), value.size());
+    }
+    bits::setBit(passed, i, result);
+  }
+}
+
 bool BytesRange::testBytesRange(
     std::optional<std::string_view> min,
     std::optional<std::string_view> max,
@@ -1275,6 +1402,50 @@ bool BytesRange::testBytesRange(
   // clang-format on
 }
 
+void BytesValues::initializePrefilter() {
+  for (auto length : lengths_) {
+    lengthTable_[std::min<uint32_t>(length, kLengthTableSize)] = 1;
+  }
+  // 16 bits per value give about 6% false positives for distinct prefixes.
+  const uint64_t numBits =
+      std::max<uint64_t>(512, bits::nextPowerOfTwo(values_.size() * 16));
+  prefixBloomShift_ = 32 - __builtin_ctzll(numBits);
+  prefixBloom_.assign(numBits / 32, 0);
+  for (const auto& value : values_) {
+    const auto hash = prefixHash(prefixOf(value.data(), value.size()));
+    prefixBloom_[hash / 32] |= 1U << (hash % 32);
+  }
+}
+
+xsimd::batch_bool<int32_t> BytesValues::testLengths(
+    xsimd::batch<int32_t> lengths) const {
+  if (xsimd::any(lengths >= xsimd::broadcast<int32_t>(kLengthTableSize))) {
+    return Filter::testLengths(lengths);
+  }
+  return simd::gather(lengthTable_.data(), lengths) !=
+      xsimd::broadcast<int32_t>(0);
+}
+
+void BytesValues::testStringViews(
+    const StringView* values,
+    int32_t numValues,
+    uint64_t* passed) const {
+  const auto maxLength = xsimd::broadcast<int32_t>(kLengthTableSize);
+  testStringViewBatches(
+      values,
+      numValues,
+      passed,
+      [&](auto sizes, auto /*prefixes*/) {
+        const auto lengths = xsimd::min(sizes, maxLength);
+        return simd::gather(lengthTable_.data(), lengths) !=
+            xsimd::broadcast<int32_t>(0);
+      },
+      [&](const StringView& value) {
+        return testLength(value.size()) && testPrefix(value.prefixAsInt()) &&
+            values_.contains(std::string_view(value.data(), value.size()));
+      });
+}
+
 bool BytesValues::testBytesRange(
     std::optional<std::string_view> min,
     std::optional<std::string_view> max,
@@ -1614,6 +1785,23 @@ std::unique_ptr<Filter> MultiRange::mergeWith(const Filter* other) const {
   }
 }
 
+std::unique_ptr<Filter> BloomFilterValues::mergeWith(
+    const Filter* other) const {
+  switch (other->kind()) {
+    case FilterKind::kAlwaysTrue:
+      return this->clone();
+    case FilterKind::kAlwaysFalse:
+    case FilterKind::kIsNull:
+      return other->mergeWith(this);
+    case FilterKind::kIsNotNull:
+      return this->clone(false);
+    default:
+      // Either another Bloom filter or an exact filter. Both are correct to
+      // keep since a Bloom filter never rejects a value that passes.
+      return other->clone(nullAllowed_ && other->testNull());
+  }
+}
+
 std::unique_ptr<Filter> IsNull::mergeWith(const Filter* other) const {
   VELOX_CHECK(other->isDeterministic());
 
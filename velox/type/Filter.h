@@ -16,6 +16,7 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <memory>
 #include <sstream>
@@ -24,7 +25,11 @@
 
 #include <folly/Range.h>
 #include <folly/container/F14Set.h>
+#include <folly/hash/Hash.h>
+#include <folly/lang/Bits.h>
 
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/BloomFilter.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/SimdUtil.h"
 #include "velox/common/serialization/Serializable.h"
@@ -56,6 +61,7 @@ enum class FilterKind {
   kHugeintRange,
   kTimestampRange,
   kHugeintValuesUsingHashTable,
+  kBloomFilterValues,
 };
 
 class Filter;
@@ -191,6 +197,15 @@ class Filter : public velox::ISerializable {
     VELOX_UNSUPPORTED("{}: testBytes() is not supported.", toString());
   }
 
+  /// Tests 'numValues' strings at a time, e.g. the entries of a string
+  /// dictionary. Sets the bits of the passing values in 'passed' and clears
+  /// the others. Nulls are not tested. The default calls testBytes() for
+  /// each value.
+  virtual void testStringViews(
+      const StringView* values,
+      int32_t numValues,
+      uint64_t* passed) const;
+
   virtual bool testTimestamp(Timestamp /* unused */) const {
     VELOX_UNSUPPORTED("{}: testTimestamp() is not supported.", toString());
   }
@@ -1536,7 +1551,9 @@ class BytesRange final : public AbstractRange {
         upper_(upper),
         singleValue_(
             !lowerExclusive_ && !upperExclusive_ && !lowerUnbounded_ &&
-            !upperUnbounded_ && lower_ == upper_) {
+            !upperUnbounded_ && lower_ == upper_),
+        lowerPrefix_(bigEndianPrefix(lower_)),
+        upperPrefix_(bigEndianPrefix(upper_)) {
     // Always-true filters should be specified using AlwaysTrue.
     VELOX_CHECK(!lowerUnbounded_ || !upperUnbounded_);
   }
@@ -1551,7 +1568,9 @@ class BytesRange final : public AbstractRange {
             FilterKind::kBytesRange),
         lower_(other.lower_),
         upper_(other.upper_),
-        singleValue_(other.singleValue_) {}
+        singleValue_(other.singleValue_),
+        lowerPrefix_(other.lowerPrefix_),
+        upperPrefix_(other.upperPrefix_) {}
 
   folly::dynamic serialize() const override;
 
@@ -1578,6 +1597,13 @@ class BytesRange final : public AbstractRange {
 
   bool testBytes(const char* value, int32_t length) const final;
 
+  /// Decides most values by their length and StringView prefix, comparing
+  /// the whole strings only if the prefix is equal to that of a bound.
+  void testStringViews(
+      const StringView* values,
+      int32_t numValues,
+      uint64_t* passed) const final;
+
   bool testBytesRange(
       std::optional<std::string_view> min,
       std::optional<std::string_view> max,
@@ -1622,9 +1648,21 @@ class BytesRange final : public AbstractRange {
   bool testingEquals(const Filter& other) const final;
 
  private:
+  static uint32_t bigEndianPrefix(const std::string& value) {
+    uint32_t prefix = 0;
+    memcpy(
+        &prefix, value.data(), std::min<size_t>(value.size(), sizeof(prefix)));
+    return folly::Endian::big(prefix);
+  }
+
   const std::string lower_;
   const std::string upper_;
   const bool singleValue_;
+  // The first 4 bytes of 'lower_' and 'upper_' as big endian integers, zero
+  // padded like the prefix of a StringView. Comparing these orders strings
+  // that differ in the first 4 bytes.
+  const uint32_t lowerPrefix_;
+  const uint32_t upperPrefix_;
 };
 
 // Negated range filter for strings
@@ -1822,6 +1860,7 @@ class BytesValues final : public Filter {
 
     lower_ = *std::min_element(values_.begin(), values_.end());
     upper_ = *std::max_element(values_.begin(), values_.end());
+    initializePrefilter();
   }
 
   BytesValues(const BytesValues& other, bool nullAllowed)
@@ -1829,7 +1868,10 @@ class BytesValues final : public Filter {
         lower_(other.lower_),
         upper_(other.upper_),
         values_(other.values_),
-        lengths_(other.lengths_) {}
+        lengths_(other.lengths_),
+        lengthTable_(other.lengthTable_),
+        prefixBloom_(other.prefixBloom_),
+        prefixBloomShift_(other.prefixBloomShift_) {}
 
   folly::dynamic serialize() const override;
 
@@ -1844,15 +1886,34 @@ class BytesValues final : public Filter {
     }
   }
 
+  bool hasTestLength() const final {
+    return true;
+  }
+
   bool testLength(int32_t length) const final {
-    return lengths_.contains(length);
+    if (length < kLengthTableSize) {
+      return lengthTable_[length];
+    }
+    return lengthTable_[kLengthTableSize] && lengths_.contains(length);
   }
 
+  xsimd::batch_bool<int32_t> testLengths(
+      xsimd::batch<int32_t> lengths) const final;
+
   bool testBytes(const char* value, int32_t length) const final {
-    return lengths_.contains(length) &&
-        values_.contains(std::string(value, length));
+    // The default F14 hasher for std::string accepts std::string_view, so
+    // probing does not copy 'value'.
+    return testLength(length) && testPrefix(prefixOf(value, length)) &&
+        values_.contains(std::string_view(value, length));
   }
 
+  /// Checks the lengths and prefixes of a batch of values at a time and
+  /// probes 'values_' only for the values that pass both.
+  void testStringViews(
+      const StringView* values,
+      int32_t numValues,
+      uint64_t* passed) const final;
+
   bool testBytesRange(
       std::optional<std::string_view> min,
       std::optional<std::string_view> max,
@@ -1867,10 +1928,43 @@ class BytesValues final : public Filter {
   bool testingEquals(const Filter& other) const final;
 
  private:
+  // Returns the first 4 bytes of a value zero padded, as in
+  // StringView::prefixAsInt().
+  static uint32_t prefixOf(const char* value, int32_t length) {
+    uint32_t prefix = 0;
+    memcpy(&prefix, value, std::min<int32_t>(length, sizeof(prefix)));
+    return prefix;
+  }
+
+  uint32_t prefixHash(uint32_t prefix) const {
+    return (prefix * kPrefixHashMultiplier) >> prefixBloomShift_;
+  }
+
+  bool testPrefix(uint32_t prefix) const {
+    const auto hash = prefixHash(prefix);
+    return (prefixBloom_[hash / 32] >> (hash % 32)) & 1;
+  }
+
+  // Sets 'lengthTable_' and 'prefixBloom_' from 'values_'.
+  void initializePrefilter();
+
+  static constexpr int32_t kLengthTableSize = 64;
+  static constexpr uint32_t kPrefixHashMultiplier = 0x9E3779B1;
+
   std::string lower_;
   std::string upper_;
   folly::F14FastSet<std::string> values_;
   folly::F14FastSet<uint32_t> lengths_;
+  // Entry i is 1 if there is a value of length i. The last entry is 1 if
+  // there is a value of kLengthTableSize or more bytes. int32_t entries so
+  // that a batch of lengths is tested with one gather.
+  std::array<int32_t, kLengthTableSize + 1> lengthTable_{};
+  // Bit set of the hashes of the prefixes of the values. A value whose
+  // prefix hashes to a clear bit is not in 'values_'. This is cheaper than
+  // probing 'values_' and most probes of a large IN list do not match.
+  std::vector<uint32_t> prefixBloom_;
+  // Right shift that maps a multiplicative hash to a bit of 'prefixBloom_'.
+  int32_t prefixBloomShift_;
 };
 
 /// Represents a combination of two of more range filters on integral types with
@@ -1974,6 +2068,86 @@ class NegatedBytesValues final : public Filter {
   std::unique_ptr<BytesValues> nonNegated_;
 };
 
+/// Passes integer or string values whose hash is set in a Bloom filter. Used
+/// for runtime join filters pushed down from the build side of a hash join into
+/// the probe side scan. May pass values that are not in the set but never
+/// rejects one that is, so it can only be used to prune rows ahead of an exact
+/// check. The Bloom filter is shared between clones.
+class BloomFilterValues final : public Filter {
+ public:
+  /// @param bloomFilter Bloom filter populated with hashInt64() or hashBytes()
+  /// of the values that pass.
+  /// @param nullAllowed Null values are passing the filter if true.
+  BloomFilterValues(
+      std::shared_ptr<const BloomFilter<>> bloomFilter,
+      bool nullAllowed)
+      : Filter(true, nullAllowed, FilterKind::kBloomFilterValues),
+        bloomFilter_(std::move(bloomFilter)) {
+    VELOX_CHECK_NOT_NULL(bloomFilter_);
+  }
+
+  BloomFilterValues(const BloomFilterValues& other, bool nullAllowed)
+      : Filter(true, nullAllowed, FilterKind::kBloomFilterValues),
+        bloomFilter_(other.bloomFilter_) {}
+
+  /// Returns the hash to insert into the Bloom filter for an integer value.
+  static uint64_t hashInt64(int64_t value) {
+    return folly::hash::twang_mix64(static_cast<uint64_t>(value));
+  }
+
+  /// Returns the hash to insert into the Bloom filter for a string value.
+  static uint64_t hashBytes(const char* value, int32_t length) {
+    return bits::hashBytes(kHashSeed, value, length);
+  }
+
+  folly::dynamic serialize() const override;
+
+  static FilterPtr create(const folly::dynamic& obj);
+
+  std::unique_ptr<Filter> clone(
+      std::optional<bool> nullAllowed = std::nullopt) const final {
+    return std::make_unique<BloomFilterValues>(
+        *this, nullAllowed.value_or(nullAllowed_));
+  }
+
+  bool testInt64(int64_t value) const final {
+    return bloomFilter_->mayContain(hashInt64(value));
+  }
+
+  bool testBytes(const char* value, int32_t length) const final {
+    return bloomFilter_->mayContain(hashBytes(value, length));
+  }
+
+  // A Bloom filter cannot exclude a range of values.
+  bool testInt64Range(int64_t /*min*/, int64_t /*max*/, bool /*hasNull*/)
+      const final {
+    return true;
+  }
+
+  bool testBytesRange(
+      std::optional<std::string_view> /*min*/,
+      std::optional<std::string_view> /*max*/,
+      bool /*hasNull*/) const final {
+    return true;
+  }
+
+  /// Typed filters do not know Bloom filters, so ScanSpec calls this with the
+  /// existing filter of a column. Since the Bloom filter is only a pre-filter,
+  /// merging with an exact filter keeps the exact one.
+  std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
+
+  const BloomFilter<>& bloomFilter() const {
+    return *bloomFilter_;
+  }
+
+  bool testingEquals(const Filter& other) const final;
+
+ private:
+  static constexpr size_t kHashSeed = 1;
+
+  const std::shared_ptr<const BloomFilter<>> bloomFilter_;
+};
+
 /// Represents a combination of two of more filters with
 /// OR semantics. The filter passes if at least one of the contained filters
 /// passes.
@@ -133,7 +133,7 @@ struct StringView {
 
   bool operator==(const StringView& other) const {
     // Compare lengths and first 4 characters.
-    if (sizeAndPrefixAsInt64() != other.sizeAndPrefixAsInt64()) {
+    if (!sizeAndPrefixEquals(other)) {
       return false;
     }
     if (isInline()) {
@@ -157,15 +157,13 @@ struct StringView {
   //       < 0, if this < other
   //       > 0, if this > other
   int32_t compare(const StringView& other) const {
-    if (prefixAsInt() != other.prefixAsInt()) {
-      // The result is decided on prefix. The shorter will be less
-      // because the prefix is padded with zeros.
-      return memcmp(prefix_, other.prefix_, kPrefixSize);
+    if (auto result = comparePrefix(other)) {
+      return result;
     }
     int32_t size = std::min(size_, other.size_) - kPrefixSize;
     if (size <= 0) {
-      // One ends within the prefix.
-      return size_ - other.size_;
+      // Both are equal and end within the prefix.
+      return 0;
     }
     if (size <= kInlineSize && isInline() && other.isInline()) {
       int32_t result = memcmp(value_.inlined, other.value_.inlined, size);
@@ -176,6 +174,30 @@ struct StringView {
     return (result != 0) ? result : size_ - other.size_;
   }
 
+  /// Returns a non-zero result with the sign of compare() if the order of
+  /// 'this' and 'other' is decided by the size and the inlined prefix, and 0
+  /// otherwise. Does not read out of line data, so it can be used to skip
+  /// accessing non-contiguous or cold string bodies.
+  int32_t comparePrefix(const StringView& other) const {
+    if (prefixAsInt() != other.prefixAsInt()) {
+      // The result is decided on prefix. The shorter will be less
+      // because the prefix is padded with zeros.
+      return memcmp(prefix_, other.prefix_, kPrefixSize);
+    }
+    if (std::min(size_, other.size_) <= kPrefixSize) {
+      // One ends within the prefix.
+      return size_ - other.size_;
+    }
+    return 0;
+  }
+
+  /// Returns true if 'this' and 'other' have the same size and prefix. Like
+  /// comparePrefix(), does not read out of line data. If false, the strings
+  /// are not equal.
+  bool sizeAndPrefixEquals(const StringView& other) const {
+    return sizeAndPrefixAsInt64() == other.sizeAndPrefixAsInt64();
+  }
+
   bool operator<(const StringView& other) const {
     return compare(other) < 0;
   }
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #include "velox/type/Timestamp.h"
+#include <array>
+#include <atomic>
 #include <chrono>
 #include "velox/common/base/Exceptions.h"
 #include "velox/external/date/tz.h"
@@ -33,6 +35,49 @@ inline int64_t getPrestoTZOffsetInSeconds(int16_t tzID) {
   return ((tzID <= 840) ? (tzID - 841) : (tzID - 840)) * 60;
 }
 
+// Time zone IDs below this have their zone cached.
+constexpr int16_t kMaxCachedTimeZoneID = 4'096;
+
+// Returns the zone for a time zone ID above 1680. Looking up a zone by name
+// is much slower than the conversion itself, so zones are kept by ID.
+const date::time_zone* locateZone(int16_t tzID) {
+  if (tzID < 0 || tzID >= kMaxCachedTimeZoneID) {
+    return date::locate_zone(util::getTimeZoneName(tzID));
+  }
+  static std::array<std::atomic<const date::time_zone*>, kMaxCachedTimeZoneID>
+      zones{};
+  auto* zone = zones[tzID].load(std::memory_order_acquire);
+  if (zone == nullptr) {
+    // Zones live as long as the time zone database, so racing threads store
+    // the same pointer.
+    zone = date::locate_zone(util::getTimeZoneName(tzID));
+    zones[tzID].store(zone, std::memory_order_release);
+  }
+  return zone;
+}
+
+// The offset of 'zone' over the seconds in [begin, end). Each thread keeps
+// the last range it used for each direction of conversion. Consecutive
+// values usually fall into the same range between two transitions of the
+// zone, which saves the binary search over the transitions.
+struct ZoneOffsetRange {
+  const date::time_zone* zone{nullptr};
+  int64_t begin{0};
+  int64_t end{0};
+  int64_t offset{0};
+
+  bool contains(const date::time_zone& other, int64_t seconds) const {
+    return zone == &other && seconds >= begin && seconds < end;
+  }
+};
+
+// A local time that is at least this far from a transition maps to exactly
+// one GMT time. Zones have not changed their offsets by more than a day.
+constexpr int64_t kLocalTimeMargin = 2 * 86'400;
+
+thread_local ZoneOffsetRange lastGMTRange;
+thread_local ZoneOffsetRange lastLocalRange;
+
 } // namespace
 
 // static
@@ -51,8 +96,23 @@ void Timestamp::toGMT(const date::time_zone& zone) {
     VELOX_UNSUPPORTED(
         "Timestamp out of bound for time zone adjustment {} seconds", seconds_);
   }
+  if (lastLocalRange.contains(zone, seconds_)) {
+    seconds_ -= lastLocalRange.offset;
+    return;
+  }
   date::local_time<std::chrono::seconds> localTime{
       std::chrono::seconds(seconds_)};
+  const auto info = zone.get_info(localTime);
+  if (info.result == date::local_info::unique) {
+    // Local times away from the ends of 'info.first' are unique as well.
+    const auto offset = info.first.offset.count();
+    lastLocalRange = {
+        &zone,
+        info.first.begin.time_since_epoch().count() + offset +
+            kLocalTimeMargin,
+        info.first.end.time_since_epoch().count() + offset - kLocalTimeMargin,
+        offset};
+  }
   std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds>
       sysTime = zone.to_sys(localTime, date::choose::latest);
   seconds_ = sysTime.time_since_epoch().count();
@@ -65,7 +125,7 @@ void Timestamp::toGMT(int16_t tzID) {
     seconds_ -= getPrestoTZOffsetInSeconds(tzID);
   } else {
     // Other ids go this path.
-    toGMT(*date::locate_zone(util::getTimeZoneName(tzID)));
+    toGMT(*locateZone(tzID));
   }
 }
 
@@ -102,9 +162,19 @@ Timestamp::toTimePoint() const {
 }
 
 void Timestamp::toTimezone(const date::time_zone& zone) {
-  auto tp = toTimePoint();
-  auto epoch = zone.to_local(tp).time_since_epoch();
-  seconds_ = std::chrono::duration_cast<std::chrono::seconds>(epoch).count();
+  const auto tp = toTimePoint();
+  const auto sysSeconds = date::floor<std::chrono::seconds>(tp);
+  if (!lastGMTRange.contains(zone, sysSeconds.time_since_epoch().count())) {
+    const auto info = zone.get_info(sysSeconds);
+    lastGMTRange = {
+        &zone,
+        info.begin.time_since_epoch().count(),
+        info.end.time_since_epoch().count(),
+        info.offset.count()};
+  }
+  // Same as the seconds of zone.to_local(tp), which are truncated toward 0.
+  seconds_ = (tp.time_since_epoch().count() + lastGMTRange.offset * 1'000) /
+      1'000;
 }
 
 void Timestamp::toTimezone(int16_t tzID) {
@@ -114,7 +184,7 @@ void Timestamp::toTimezone(int16_t tzID) {
     seconds_ += getPrestoTZOffsetInSeconds(tzID);
   } else {
     // Other ids go this path.
-    toTimezone(*date::locate_zone(util::getTimeZoneName(tzID)));
+    toTimezone(*locateZone(tzID));
   }
 }
 
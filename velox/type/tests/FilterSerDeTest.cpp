@@ -110,6 +110,16 @@ TEST_F(FilterSerDeTest, valuesFilters) {
   }
 }
 
+TEST_F(FilterSerDeTest, bloomFilter) {
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(100);
+  for (auto i = 0; i < 100; ++i) {
+    bloomFilter->insert(BloomFilterValues::hashInt64(i));
+  }
+  testSerde(BloomFilterValues(bloomFilter, false));
+  testSerde(BloomFilterValues(bloomFilter, true));
+}
+
 TEST_F(FilterSerDeTest, rangeFilters) {
   FloatRange floatRange(1.0, true, true, 124.5, false, true, false);
   testSerde(floatRange);
@@ -950,6 +950,102 @@ TEST(FilterTest, bytesValues) {
   EXPECT_FALSE(filter->testBytesRange(std::nullopt, "Banana", false));
 }
 
+TEST(FilterTest, bytesTestStringViews) {
+  // Strings of 0 to 29 bytes that share prefixes, inline and not.
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 1'000; ++i) {
+    strings.push_back(std::string(i % 30, 'a' + i % 3) + std::to_string(i));
+  }
+  std::vector<StringView> views;
+  for (const auto& string : strings) {
+    views.emplace_back(string);
+  }
+
+  auto expectSameAsTestBytes = [&](const Filter& filter) {
+    std::vector<uint64_t> passed(bits::nwords(views.size()), ~0UL);
+    for (auto numValues : {0, 5, 17, 1'000}) {
+      filter.testStringViews(views.data(), numValues, passed.data());
+      for (auto i = 0; i < numValues; ++i) {
+        ASSERT_EQ(
+            filter.testBytes(views[i].data(), views[i].size()),
+            bits::isBitSet(passed.data(), i))
+            << filter.toString() << " " << strings[i];
+      }
+    }
+  };
+
+  // Small and large IN lists, with values that are not in 'strings'.
+  std::vector<std::string> values = {strings[3], strings[500], "zz", ""};
+  expectSameAsTestBytes(BytesValues(values, false));
+  for (auto i = 0; i < 1'000; i += 7) {
+    values.push_back(strings[i]);
+    values.push_back(strings[i] + "x");
+  }
+  BytesValues largeInList(values, false);
+  expectSameAsTestBytes(largeInList);
+  ASSERT_TRUE(largeInList.testBytes(strings[7].data(), strings[7].size()));
+  ASSERT_FALSE(largeInList.testBytes(strings[8].data(), strings[8].size()));
+
+  const auto& value = strings[500];
+  expectSameAsTestBytes(
+      BytesRange(value, false, false, value, false, false, false));
+  expectSameAsTestBytes(BytesRange("", false, false, "", false, false, false));
+  expectSameAsTestBytes(
+      BytesRange("aaa", false, true, "bbbb1", false, false, false));
+  expectSameAsTestBytes(BytesRange("b", false, false, "", true, false, false));
+  expectSameAsTestBytes(BytesRange("", true, false, "ab", false, true, false));
+  expectSameAsTestBytes(NegatedBytesValues({"a1", strings[9]}, false));
+}
+
+TEST(FilterTest, bloomFilterValues) {
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(1'000);
+  for (auto i = 0; i < 1'000; ++i) {
+    bloomFilter->insert(BloomFilterValues::hashInt64(i * 3));
+    const auto value = fmt::format("value-{}", i * 3);
+    bloomFilter->insert(
+        BloomFilterValues::hashBytes(value.data(), value.size()));
+  }
+  BloomFilterValues filter(bloomFilter, false);
+  EXPECT_FALSE(filter.testNull());
+  EXPECT_EQ(FilterKind::kBloomFilterValues, filter.kind());
+
+  int32_t numFalsePositives = 0;
+  for (auto i = 0; i < 3'000; ++i) {
+    const auto value = fmt::format("value-{}", i);
+    if (i % 3 == 0) {
+      // A Bloom filter never rejects a value that was inserted.
+      EXPECT_TRUE(filter.testInt64(i));
+      EXPECT_TRUE(filter.testBytes(value.data(), value.size()));
+    } else {
+      numFalsePositives += filter.testInt64(i);
+      numFalsePositives += filter.testBytes(value.data(), value.size());
+    }
+  }
+  EXPECT_LT(numFalsePositives, 4'000 / 10);
+
+  // Ranges are never pruned.
+  EXPECT_TRUE(filter.testInt64Range(5'000, 6'000, false));
+  EXPECT_TRUE(filter.testBytesRange("x", "y", false));
+
+  auto nullAllowed = filter.clone(true);
+  EXPECT_TRUE(nullAllowed->testNull());
+  EXPECT_TRUE(nullAllowed->testInt64(3));
+
+  // Merging with an exact filter keeps the exact one.
+  auto range = between(10, 20);
+  auto merged = filter.mergeWith(range.get());
+  EXPECT_EQ(FilterKind::kBigintRange, merged->kind());
+  EXPECT_FALSE(merged->testNull());
+  EXPECT_TRUE(merged->testInt64(15));
+  EXPECT_FALSE(merged->testInt64(21));
+
+  merged = filter.mergeWith(isNotNull().get());
+  EXPECT_EQ(FilterKind::kBloomFilterValues, merged->kind());
+  merged = filter.mergeWith(isNull().get());
+  EXPECT_EQ(FilterKind::kAlwaysFalse, merged->kind());
+}
+
 TEST(FilterTest, negatedBytesValues) {
   // create a filter
   std::vector<std::string> values(
@@ -55,6 +55,46 @@ TEST(StringView, comparison) {
       StringView("in hoc signo vinces, Constantinus"));
 }
 
+TEST(StringView, comparePrefix) {
+  auto sign = [](int32_t value) { return (value > 0) - (value < 0); };
+  std::vector<std::string> texts{
+      "",
+      "ab",
+      "abc",
+      "abcd",
+      "abcde",
+      "abce",
+      "abcdefghijkl",
+      "abcdefghijklm",
+      "abcdefghijklmnopq",
+      "abcdefghijklmnopz",
+      "b"};
+  for (const auto& left : texts) {
+    for (const auto& right : texts) {
+      StringView leftView(left);
+      StringView rightView(right);
+      auto prefixResult = leftView.comparePrefix(rightView);
+      if (prefixResult != 0) {
+        EXPECT_EQ(sign(prefixResult), sign(leftView.compare(rightView)))
+            << left << " vs. " << right;
+      }
+      EXPECT_EQ(sign(leftView.compare(rightView)), sign(left.compare(right)))
+          << left << " vs. " << right;
+      if (!leftView.sizeAndPrefixEquals(rightView)) {
+        EXPECT_NE(leftView, rightView);
+      }
+    }
+  }
+
+  // Decided on prefix or size when one string ends within the prefix.
+  EXPECT_LT(StringView("abc").comparePrefix(StringView("abd")), 0);
+  EXPECT_LT(StringView("ab").comparePrefix(StringView("abcdefghijklmnopq")), 0);
+  EXPECT_GT(StringView("abcd").comparePrefix(StringView("abc")), 0);
+  // Undecided when the prefixes match and both extend past it.
+  EXPECT_EQ(
+      StringView("abcdefghijklmnopq").comparePrefix(StringView("abcde")), 0);
+}
+
 TEST(StringView, container) {
   std::vector<std::string> strings = {
       "May",
@@ -201,5 +201,39 @@ TEST(TimestampTest, outOfRange) {
   VELOX_ASSERT_THROW(
       t.toTimezone(*timezone), "Timestamp is outside of supported range");
 }
+
+TEST(TimestampTest, timezoneConversionsAcrossTransitions) {
+  // Steps of 7.5 minutes over 2021 cross the DST transitions of each zone
+  // and reach local times that are ambiguous or do not exist. Alternating
+  // zones replaces the cached offset ranges.
+  const std::vector<const date::time_zone*> zones = {
+      date::locate_zone("America/Los_Angeles"),
+      date::locate_zone("Europe/Berlin"),
+      date::locate_zone("Australia/Sydney")};
+  const int64_t begin = 1'609'459'200;
+  const int64_t end = begin + 365 * 86'400;
+  int32_t step = 0;
+  for (int64_t seconds = begin; seconds < end; seconds += 450, ++step) {
+    const auto* zone = zones[(step / 1'000) % zones.size()];
+    Timestamp timestamp(seconds, 123'000'000);
+    const auto expectedLocal =
+        std::chrono::duration_cast<std::chrono::seconds>(
+            zone->to_local(timestamp.toTimePoint()).time_since_epoch())
+            .count();
+    timestamp.toTimezone(*zone);
+    ASSERT_EQ(expectedLocal, timestamp.getSeconds()) << seconds;
+
+    Timestamp local(seconds, 0);
+    const auto expectedGMT =
+        zone->to_sys(
+                date::local_seconds{std::chrono::seconds(seconds)},
+                date::choose::latest)
+            .time_since_epoch()
+            .count();
+    local.toGMT(*zone);
+    ASSERT_EQ(expectedGMT, local.getSeconds()) << seconds;
+  }
+}
+
 } // namespace
 } // namespace facebook::velox
@@ -145,5 +145,114 @@ xsimd::batch<T> BiasVector<T>::loadSIMDValueBufferAt(size_t index) const {
   }
 }
 
+template <typename T>
+void BiasVector<T>::unpack(
+    vector_size_t begin,
+    vector_size_t end,
+    T* result) const {
+  switch (valueType_) {
+    case TypeKind::INTEGER:
+      return unpackInternal<int32_t>(begin, end, result);
+    case TypeKind::SMALLINT:
+      return unpackInternal<int16_t>(begin, end, result);
+    case TypeKind::TINYINT:
+      return unpackInternal<int8_t>(begin, end, result);
+    default:
+      VELOX_UNSUPPORTED("Invalid type");
+  }
+}
+
+template <typename T>
+template <typename U>
+void BiasVector<T>::unpackInternal(
+    vector_size_t begin,
+    vector_size_t end,
+    T* result) const {
+  auto values = reinterpret_cast<const U*>(rawValues_);
+  auto row = begin;
+  if constexpr (can_simd && sizeof(U) < sizeof(T)) {
+    constexpr auto kBatchSize = xsimd::batch<T>::size;
+    for (; row + kBatchSize <= end; row += kBatchSize) {
+      (biasBuffer_ + xsimd::batch<T>::load_unaligned(values + row))
+          .store_unaligned(result + row);
+    }
+  }
+  for (; row < end; ++row) {
+    result[row] = bias_ + values[row];
+  }
+}
+
+template <typename T>
+BiasVectorPtr<T> tryBiasEncode(const FlatVector<T>& vector) {
+  if constexpr (admitsBias<T>()) {
+    const auto size = vector.size();
+    const auto* rawValues = vector.rawValues();
+    const auto* rawNulls = vector.rawNulls();
+    if (size == 0 || rawValues == nullptr) {
+      return nullptr;
+    }
+
+    std::optional<T> min;
+    std::optional<T> max;
+    for (vector_size_t i = 0; i < size; ++i) {
+      if (rawNulls && bits::isBitNull(rawNulls, i)) {
+        continue;
+      }
+      if (!min.has_value()) {
+        min = rawValues[i];
+        max = rawValues[i];
+      } else {
+        min = std::min(*min, rawValues[i]);
+        max = std::max(*max, rawValues[i]);
+      }
+    }
+    if (!min.has_value()) {
+      return nullptr;
+    }
+
+    // The subtraction is done in unsigned space to not overflow when 'min'
+    // and 'max' are at opposite ends of the range of T.
+    const uint64_t delta =
+        static_cast<uint64_t>(*max) - static_cast<uint64_t>(*min);
+    if (!deltaAllowsBias<T>(delta)) {
+      return nullptr;
+    }
+
+    // Check the class comment for explanation of this calculation.
+    const T bias = *min + static_cast<T>((delta + 1) / 2);
+
+    auto pool = vector.pool();
+    auto makeValues = [&](auto* dummy) {
+      using U = std::remove_pointer_t<decltype(dummy)>;
+      auto buffer = AlignedBuffer::allocate<U>(size, pool);
+      auto* data = buffer->template asMutable<U>();
+      for (vector_size_t i = 0; i < size; ++i) {
+        data[i] = (rawNulls && bits::isBitNull(rawNulls, i))
+            ? 0
+            : static_cast<U>(rawValues[i] - bias);
+      }
+      return buffer;
+    };
+
+    BufferPtr values;
+    TypeKind valueType;
+    if (delta <= std::numeric_limits<uint8_t>::max()) {
+      values = makeValues(static_cast<int8_t*>(nullptr));
+      valueType = TypeKind::TINYINT;
+    } else if (delta <= std::numeric_limits<uint16_t>::max()) {
+      values = makeValues(static_cast<int16_t*>(nullptr));
+      valueType = TypeKind::SMALLINT;
+    } else {
+      values = makeValues(static_cast<int32_t*>(nullptr));
+      valueType = TypeKind::INTEGER;
+    }
+
+    return std::make_shared<BiasVector<T>>(
+        pool, vector.nulls(), size, valueType, std::move(values), bias);
+  } else {
+    return nullptr;
+  }
+}
+
 } // namespace velox
 } // namespace facebook
@@ -128,6 +128,11 @@ class BiasVector : public SimpleVector<T> {
    */
   xsimd::batch<T> loadSIMDValueBufferAt(size_t index) const;
 
+  /// Writes the logical values for positions [begin, end) to
+  /// result[begin, end). Unpacks a SIMD batch at a time. Values at null
+  /// positions are undefined.
+  void unpack(vector_size_t begin, vector_size_t end, T* result) const;
+
   std::unique_ptr<SimpleVector<uint64_t>> hashAll() const override;
 
   inline T bias() const {
@@ -160,6 +165,10 @@ class BiasVector : public SimpleVector<T> {
   }
 
  private:
+  template <typename U>
+  void unpackInternal(vector_size_t begin, vector_size_t end, T* result)
+      const;
+
   template <typename U>
   inline xsimd::batch<T> loadSIMDInternal(size_t byteOffset) const {
     auto mem = reinterpret_cast<const U*>(
@@ -182,6 +191,14 @@ class BiasVector : public SimpleVector<T> {
 template <typename T>
 using BiasVectorPtr = std::shared_ptr<BiasVector<T>>;
 
+/// Returns a BiasVector with the values of 'vector' if the difference between
+/// the largest and smallest non-null value fits in a narrower integer type.
+/// Returns nullptr if 'vector' cannot be biased, e.g. if its type does not
+/// admit bias, all values are null or the range of values is too wide. The
+/// nulls buffer is shared with 'vector'.
+template <typename T>
+BiasVectorPtr<T> tryBiasEncode(const FlatVector<T>& vector);
+
 } // namespace facebook::velox
 
 #include "velox/vector/BiasVector-inl.h"
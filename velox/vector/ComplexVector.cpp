@@ -166,6 +166,7 @@ void RowVector::copy(
     const BaseVector* source,
     const SelectivityVector& rows,
     const vector_size_t* toSourceRow) {
+  keyHashes_.reset();
   // Copy non-null values.
   SelectivityVector nonNullRows = rows;
 
@@ -253,6 +254,7 @@ void RowVector::copyRanges(
   if (ranges.empty()) {
     return;
   }
+  keyHashes_.reset();
 
   auto minTargetIndex = std::numeric_limits<vector_size_t>::max();
   auto maxTargetIndex = std::numeric_limits<vector_size_t>::min();
@@ -351,6 +353,7 @@ std::string RowVector::toString(vector_size_t index) const {
 }
 
 void RowVector::ensureWritable(const SelectivityVector& rows) {
+  keyHashes_.reset();
   for (int i = 0; i < childrenSize_; i++) {
     if (children_[i]) {
       BaseVector::ensureWritable(
@@ -385,6 +388,7 @@ uint64_t RowVector::estimateFlatSize() const {
 
 void RowVector::prepareForReuse() {
   BaseVector::prepareForReuse();
+  keyHashes_.reset();
   for (auto& child : children_) {
     if (child) {
       BaseVector::prepareForReuse(child, 0);
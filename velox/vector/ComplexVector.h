@@ -35,6 +35,20 @@ using column_index_t = uint32_t;
 constexpr column_index_t kConstantChannel =
     std::numeric_limits<column_index_t>::max();
 
+/// Hashes of the rows of a RowVector over some of its children, attached by
+/// the operator that produced the RowVector, e.g. a local exchange that hash
+/// partitions its input, so that a consumer hashing the same keys, e.g. a
+/// hash join probe, does not hash them again. The hash of a row is that of
+/// exec::VectorHasher::hash() over 'keys' in order.
+struct RowKeyHashes {
+  /// The hashed children. The hashes are valid only while these are still
+  /// the children of the RowVector at the same positions.
+  std::vector<VectorPtr> keys;
+
+  /// One uint64_t per row of the RowVector.
+  BufferPtr hashes;
+};
+
 class RowVector : public BaseVector {
  public:
   RowVector(const RowVector&) = delete;
@@ -137,6 +151,18 @@ class RowVector : public BaseVector {
     return children_;
   }
 
+  /// Attaches hashes of some of the children. They are dropped by copy(),
+  /// copyRanges(), ensureWritable() and prepareForReuse(). Whoever changes
+  /// the values of a child in place must drop them with
+  /// setKeyHashes(nullptr).
+  void setKeyHashes(std::shared_ptr<const RowKeyHashes> keyHashes) {
+    keyHashes_ = std::move(keyHashes);
+  }
+
+  const std::shared_ptr<const RowKeyHashes>& keyHashes() const {
+    return keyHashes_;
+  }
+
   void copy(
       const BaseVector* source,
       vector_size_t targetIndex,
@@ -222,6 +248,9 @@ class RowVector : public BaseVector {
 
   const size_t childrenSize_;
   mutable std::vector<VectorPtr> children_;
+
+  // See setKeyHashes().
+  std::shared_ptr<const RowKeyHashes> keyHashes_;
 };
 
 // Common parent class for ARRAY and MAP vectors.  Contains 'offsets' and
@@ -17,6 +17,7 @@
 #include "velox/buffer/Buffer.h"
 #include "velox/common/base/BitUtil.h"
 #include "velox/vector/BaseVector.h"
+#include "velox/vector/BiasVector.h"
 #include "velox/vector/LazyVector.h"
 
 namespace facebook::velox {
@@ -297,6 +298,15 @@ void DecodedVector::setBaseData(
       setFlatNulls(vector, rows);
       break;
     }
+    case VectorEncoding::Simple::BIASED: {
+      // Under a dictionary the base positions are not known without a pass
+      // over the indices, so all of 'vector' is unpacked.
+      unpackBiased(
+          vector,
+          isIdentityMapping_ ? end(vector.size(), rows) : vector.size());
+      setFlatNulls(vector, rows);
+      break;
+    }
     case VectorEncoding::Simple::ROW:
     case VectorEncoding::Simple::ARRAY:
     case VectorEncoding::Simple::MAP: {
@@ -312,6 +322,32 @@ void DecodedVector::setBaseData(
   }
 }
 
+void DecodedVector::unpackBiased(
+    const BaseVector& vector,
+    vector_size_t end) {
+  unpackedValues_.resize(
+      bits::roundUp(end * vector.type()->cppSizeInBytes(), sizeof(uint64_t)) /
+      sizeof(uint64_t));
+  switch (vector.typeKind()) {
+    case TypeKind::SMALLINT:
+      vector.asUnchecked<BiasVector<int16_t>>()->unpack(
+          0, end, reinterpret_cast<int16_t*>(unpackedValues_.data()));
+      break;
+    case TypeKind::INTEGER:
+      vector.asUnchecked<BiasVector<int32_t>>()->unpack(
+          0, end, reinterpret_cast<int32_t*>(unpackedValues_.data()));
+      break;
+    case TypeKind::BIGINT:
+      vector.asUnchecked<BiasVector<int64_t>>()->unpack(
+          0, end, reinterpret_cast<int64_t*>(unpackedValues_.data()));
+      break;
+    default:
+      VELOX_UNREACHABLE(
+          "Unsupported type for biased vector: {}", vector.type()->toString());
+  }
+  data_ = unpackedValues_.data();
+}
+
 void DecodedVector::setBaseDataForConstant(
     const BaseVector& vector,
     const SelectivityVector* rows) {
@@ -351,6 +351,10 @@ class DecodedVector {
       const BaseVector& vector,
       const SelectivityVector* rows);
 
+  // Unpacks positions [0, end) of biased 'vector' into 'unpackedValues_' and
+  // points 'data_' to these.
+  void unpackBiased(const BaseVector& vector, vector_size_t end);
+
   void reset(vector_size_t size);
 
   // If `rows` is null applies the `func` to all rows in [0, size_)
@@ -423,6 +427,10 @@ class DecodedVector {
   // dictionary and base values.
   std::vector<uint64_t> copiedNulls_;
 
+  // Used as backing for 'data_' when the base vector is biased. Holds the
+  // logical values so that data<T>() and valueAt<T>() see a flat array.
+  std::vector<uint64_t> unpackedValues_;
+
   // Used as 'nulls_' for a null constant vector.
   static uint64_t constantNullMask_;
 };
@@ -65,7 +65,11 @@ void VectorLoader::loadInternal(
     const SelectivityVector& rows,
     ValueHook* hook,
     VectorPtr* result) {
-  if (rows.isAllSelected()) {
+  // A contiguous range of rows, e.g. the remainder of a batch that is
+  // produced in several parts, is passed as a range of the shared
+  // consecutive row numbers without materializing them.
+  if (rows.isAllSelected() ||
+      bits::isAllSet(rows.asRange().bits(), rows.begin(), rows.end())) {
     const auto& indices = DecodedVector::consecutiveIndices();
     assert(!indices.empty());
     if (rows.end() <= indices.size()) {
@@ -76,10 +80,7 @@ void VectorLoader::loadInternal(
       return;
     }
   }
-  std::vector<vector_size_t> positions(rows.countSelected());
-  int index = 0;
-  rows.applyToSelected([&](vector_size_t row) { positions[index++] = row; });
-  load(positions, hook, result);
+  load(rows.selectedIndices(), hook, result);
 }
 
 VectorPtr LazyVector::slice(vector_size_t offset, vector_size_t length) const {
@@ -146,21 +147,11 @@ void LazyVector::ensureLoadedRowsImpl(
       auto iota = velox::iota(rows.end(), rowNumbers);
       rowSet = RowSet(iota, rows.end());
     } else {
-      rowNumbers.resize(rows.end());
-      rowNumbers.resize(simd::indicesOfSetBits(
-          rows.asRange().bits(), 0, rows.end(), rowNumbers.data()));
-      rowSet = RowSet(rowNumbers);
+      rowSet = RowSet(rows.selectedIndices());
     }
   } else {
     decoded.unwrapRows(baseRows, rows);
-
-    rowNumbers.resize(baseRows.end());
-    rowNumbers.resize(simd::indicesOfSetBits(
-        baseRows.asRange().bits(), 0, baseRows.end(), rowNumbers.data()));
-
-    rowSet = RowSet(rowNumbers);
-
-    lazyVector->load(rowSet, nullptr);
+    lazyVector->load(RowSet(baseRows.selectedIndices()), nullptr);
     VectorPtr loadedVector = lazyVector->loadedVectorShared();
     if (isLazyNotLoaded(*loadedVector)) {
       decoded.unwrapRows(baseRows, rows);
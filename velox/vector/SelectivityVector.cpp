@@ -16,6 +16,7 @@
 #include "velox/vector/SelectivityVector.h"
 
 #include "velox/common/base/Nulls.h"
+#include "velox/common/base/SimdUtil.h"
 
 namespace facebook::velox {
 
@@ -54,6 +55,17 @@ std::string SelectivityVector::toString(
   return out.str();
 }
 
+const std::vector<vector_size_t>& SelectivityVector::selectedIndices() const {
+  if (!indicesValid_) {
+    // indicesOfSetBits() may store a full SIMD batch past the last index.
+    indices_.resize(end_ - begin_ + xsimd::batch<int32_t>::size);
+    indices_.resize(simd::indicesOfSetBits(
+        bits_.data(), begin_, end_, indices_.data()));
+    indicesValid_ = true;
+  }
+  return indices_;
+}
+
 void translateToInnerRows(
     const SelectivityVector& outerRows,
     const vector_size_t* indices,
@@ -88,6 +88,7 @@ class SelectivityVector {
     begin_ = 0;
     end_ = value ? size_ : 0;
     allSelected_ = value;
+    indicesValid_ = false;
   }
 
   /**
@@ -99,6 +100,7 @@ class SelectivityVector {
     VELOX_DCHECK_LT(idx, bits_.size() * sizeof(bits_[0]) * 8);
     bits::setBit(bits_.data(), idx, valid);
     allSelected_.reset();
+    indicesValid_ = false;
   }
 
   /**
@@ -114,6 +116,7 @@ class SelectivityVector {
     VELOX_DCHECK_LE(end, bits_.size() * sizeof(bits_[0]) * 8);
     bits::fillBits(bits_.data(), begin, end, valid);
     allSelected_.reset();
+    indicesValid_ = false;
   }
 
   /**
@@ -131,6 +134,7 @@ class SelectivityVector {
    * updateBounds() need to be called explicitly if data is modified.
    */
   MutableRange<bool> asMutableRange() {
+    indicesValid_ = false;
     return MutableRange<bool>(bits_.data(), begin_, end_);
   }
 
@@ -157,6 +161,7 @@ class SelectivityVector {
     begin_ = 0;
     end_ = 0;
     allSelected_ = false;
+    indicesValid_ = false;
   }
 
   /**
@@ -167,6 +172,7 @@ class SelectivityVector {
     begin_ = 0;
     end_ = size_;
     allSelected_ = true;
+    indicesValid_ = false;
   }
 
   void setFromBits(const uint64_t* bits, int32_t size) {
@@ -275,6 +281,7 @@ class SelectivityVector {
    * index (noting that the range in between may contain not selected indices).
    */
   void updateBounds() {
+    indicesValid_ = false;
     begin_ = bits::findFirstBit(bits_.data(), 0, size_);
     if (begin_ == -1) {
       begin_ = 0;
@@ -310,6 +317,14 @@ class SelectivityVector {
     return size_;
   }
 
+  /// Returns the selected rows in ascending order. The list is extracted from
+  /// the bits with SIMD on first use and is kept until 'this' is modified.
+  /// While the list is kept, applyToSelected() iterates over it instead of
+  /// scanning the bits, which is faster for sparse selections. Callers that
+  /// need the row numbers of a selection more than once, e.g. to make a
+  /// RowSet, should use this instead of converting the bits themselves.
+  const std::vector<vector_size_t>& selectedIndices() const;
+
   bool operator==(const SelectivityVector& other) const {
     return begin_ == other.begin_ && end_ == other.end_ &&
         bits::testWords(
@@ -377,6 +392,12 @@ class SelectivityVector {
 
   mutable std::optional<bool> allSelected_;
 
+  // Selected rows in ascending order. Valid only if 'indicesValid_' is true.
+  // Extracted on first call to selectedIndices().
+  mutable std::vector<vector_size_t> indices_;
+
+  mutable bool indicesValid_{false};
+
   friend class SelectivityIterator;
 };
 
@@ -428,6 +449,10 @@ inline void SelectivityVector::applyToSelected(Callable func) const {
     for (vector_size_t row = begin_; row < end_; ++row) {
       func(row);
     }
+  } else if (indicesValid_) {
+    for (auto row : indices_) {
+      func(row);
+    }
   } else {
     bits::forEachSetBit(bits_.data(), begin_, end_, func);
   }
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/vector/VectorPool.h"
+#include "velox/vector/ComplexVector.h"
 
 namespace facebook::velox {
 
@@ -47,13 +48,48 @@ FOLLY_ALWAYS_INLINE int32_t toCacheIndex(const TypePtr& type) {
 
   return -1;
 }
+
+bool isSupportedComplexType(const TypePtr& type) {
+  switch (type->kind()) {
+    case TypeKind::ARRAY:
+    case TypeKind::MAP:
+    case TypeKind::ROW:
+      return !type->containsUnknown();
+    default:
+      return false;
+  }
+}
+
+/// Row vectors come out of prepareForReuse with empty children. Resizes them
+/// to match a newly allocated vector of 'size' rows.
+void resizeRowChildren(BaseVector& vector, vector_size_t size) {
+  if (vector.encoding() != VectorEncoding::Simple::ROW) {
+    return;
+  }
+  for (const auto& child : vector.asUnchecked<RowVector>()->children()) {
+    if (child) {
+      if (child->size() != size) {
+        child->resize(size);
+      }
+      resizeRowChildren(*child, size);
+    }
+  }
+}
 } // namespace
 
 VectorPtr VectorPool::get(const TypePtr& type, vector_size_t size) {
-  auto cacheIndex = toCacheIndex(type);
-  if (cacheIndex >= 0 && size <= kMaxRecycleSize) {
-    return vectors_[cacheIndex].pop(type, size, *pool_);
+  if (size <= kMaxRecycleSize) {
+    auto cacheIndex = toCacheIndex(type);
+    auto* typePool = cacheIndex >= 0 ? &vectors_[cacheIndex]
+                                     : complexTypePool(type, false);
+    if (typePool != nullptr) {
+      if (auto vector = typePool->pop(size)) {
+        ++stats_.numHits;
+        return vector;
+      }
+    }
   }
+  ++stats_.numMisses;
   return BaseVector::create(type, size, pool_);
 }
 
@@ -62,14 +98,25 @@ bool VectorPool::release(VectorPtr& vector) {
     return false;
   }
   if (!vector.unique() || vector->size() > kMaxRecycleSize) {
+    ++stats_.numRejected;
     return false;
   }
 
+  TypePool* typePool = nullptr;
   auto cacheIndex = toCacheIndex(vector->type());
-  if (cacheIndex < 0) {
+  if (cacheIndex >= 0) {
+    typePool = &vectors_[cacheIndex];
+  } else if (
+      isSupportedComplexType(vector->type()) &&
+      vector->retainedSize() <= kMaxComplexRetainedBytes) {
+    typePool = complexTypePool(vector->type(), true);
+  }
+  if (typePool == nullptr || !typePool->maybePushBack(vector)) {
+    ++stats_.numRejected;
     return false;
   }
-  return vectors_[cacheIndex].maybePushBack(vector);
+  ++stats_.numReleased;
+  return true;
 }
 
 size_t VectorPool::release(std::vector<VectorPtr>& vectors) {
@@ -84,12 +131,45 @@ size_t VectorPool::release(std::vector<VectorPtr>& vectors) {
   return numReleased;
 }
 
+VectorPool::TypePool* VectorPool::complexTypePool(
+    const TypePtr& type,
+    bool create) {
+  if (!isSupportedComplexType(type)) {
+    return nullptr;
+  }
+  for (auto& entry : complexVectors_) {
+    if (entry.type == type || *entry.type == *type) {
+      return &entry.vectors;
+    }
+  }
+  if (!create || complexVectors_.size() >= kMaxComplexTypes) {
+    return nullptr;
+  }
+  complexVectors_.push_back({type, {}});
+  return &complexVectors_.back().vectors;
+}
+
 bool VectorPool::TypePool::maybePushBack(VectorPtr& vector) {
   // Check that this is a Flat Vector with an initialized, unique, and mutable
-  // values Buffer and an uninitialized or unique and mutable nulls Buffer.
-  if (!vector->isWritable() || !vector->isFlatEncoding() || !vector->values()) {
+  // values Buffer and an uninitialized or unique and mutable nulls Buffer, or
+  // an array, map or row vector with recursively writable offsets, sizes and
+  // children.
+  if (!vector->isWritable()) {
     return false;
   }
+  switch (vector->encoding()) {
+    case VectorEncoding::Simple::FLAT:
+      if (!vector->values()) {
+        return false;
+      }
+      break;
+    case VectorEncoding::Simple::ARRAY:
+    case VectorEncoding::Simple::MAP:
+    case VectorEncoding::Simple::ROW:
+      break;
+    default:
+      return false;
+  }
   if (size >= kNumPerType) {
     return false;
   }
@@ -99,32 +179,45 @@ bool VectorPool::TypePool::maybePushBack(VectorPtr& vector) {
   return true;
 }
 
-VectorPtr VectorPool::TypePool::pop(
-    const TypePtr& type,
-    vector_size_t vectorSize,
-    memory::MemoryPool& pool) {
-  if (size) {
-    auto result = std::move(vectors[--size]);
-    if (UNLIKELY(result->rawNulls() != nullptr)) {
-      // This is a recyclable vector, no need to check uniqueness.
-      simd::memset(
-          const_cast<uint64_t*>(result->rawNulls()),
-          bits::kNotNullByte,
-          bits::roundUp(std::min<int32_t>(vectorSize, result->size()), 64) / 8);
-    }
-    if (UNLIKELY(
-            result->typeKind() == TypeKind::VARCHAR ||
-            result->typeKind() == TypeKind::VARBINARY)) {
-      simd::memset(
-          const_cast<void*>(result->valuesAsVoid()),
-          0,
-          std::min<int32_t>(vectorSize, result->size()) * sizeof(StringView));
-    }
-    if (result->size() != vectorSize) {
-      result->resize(vectorSize);
+VectorPtr VectorPool::TypePool::pop(vector_size_t vectorSize) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  // Prefer a vector that is large enough to not reallocate its buffers on
+  // resize.
+  auto index = size - 1;
+  for (auto i = size - 1; i >= 0; --i) {
+    if (vectors[i]->size() >= vectorSize) {
+      index = i;
+      break;
     }
-    return result;
   }
-  return BaseVector::create(type, vectorSize, &pool);
+  auto result = std::move(vectors[index]);
+  for (auto i = index; i < size - 1; ++i) {
+    vectors[i] = std::move(vectors[i + 1]);
+  }
+  --size;
+
+  if (UNLIKELY(result->rawNulls() != nullptr)) {
+    // This is a recyclable vector, no need to check uniqueness.
+    simd::memset(
+        const_cast<uint64_t*>(result->rawNulls()),
+        bits::kNotNullByte,
+        bits::roundUp(std::min<int32_t>(vectorSize, result->size()), 64) / 8);
+  }
+  if (UNLIKELY(
+          result->typeKind() == TypeKind::VARCHAR ||
+          result->typeKind() == TypeKind::VARBINARY)) {
+    simd::memset(
+        const_cast<void*>(result->valuesAsVoid()),
+        0,
+        std::min<int32_t>(vectorSize, result->size()) * sizeof(StringView));
+  }
+  if (result->size() != vectorSize) {
+    result->resize(vectorSize);
+  }
+  resizeRowChildren(*result, vectorSize);
+  return result;
 }
 } // namespace facebook::velox
@@ -20,33 +20,54 @@
 
 namespace facebook::velox {
 
-/// A thread-level cache of pre-allocated flat vectors of different types.
+/// A thread-level cache of pre-allocated vectors of different types.
 /// Keeps up to 10 recyclable vectors of each type. A vector is
-/// recyclable if it is flat and recursively singly-referenced.
-/// Only singleton built-in types are supported. Decimal types, fixed-size array
-/// type, complex and custom types are not supported. Calling 'get' for an
-/// unsupported type already returns a newly allocated vector. Calling 'release'
-/// for an unsupported type is a no-op.
+/// recyclable if it is flat, array, map or row encoded and recursively
+/// singly-referenced. Singleton built-in types and up to 16 distinct complex
+/// types are supported. Decimal types, fixed-size array type and custom types
+/// are not supported. Calling 'get' for an unsupported type already returns a
+/// newly allocated vector. Calling 'release' for an unsupported type is a
+/// no-op.
 class VectorPool {
  public:
   explicit VectorPool(memory::MemoryPool* pool) : pool_{pool} {}
 
   /// Gets a possibly recycled vector of 'type and 'size'. Allocates from
-  /// 'pool_' if no pre-allocated vector or type is a complex type.
+  /// 'pool_' if no pre-allocated vector or type is not supported.
   VectorPtr get(const TypePtr& type, vector_size_t size);
 
-  /// Moves vector into 'this' if it is flat, recursively singly referenced and
-  /// there is space. The function returns true if 'vector' is not null and has
+  /// Moves vector into 'this' if it is flat, array, map or row encoded,
+  /// recursively singly referenced and there is space. The function returns true if 'vector' is not null and has
   /// been returned back to this pool, otherwise returns false.
   bool release(VectorPtr& vector);
 
   size_t release(std::vector<VectorPtr>& vectors);
 
+  struct Stats {
+    /// Number of 'get' calls that returned a recycled vector.
+    uint64_t numHits{0};
+    /// Number of 'get' calls that allocated a new vector.
+    uint64_t numMisses{0};
+    /// Number of vectors accepted by 'release'.
+    uint64_t numReleased{0};
+    /// Number of non-null vectors rejected by 'release'.
+    uint64_t numRejected{0};
+  };
+
+  const Stats& stats() const {
+    return stats_;
+  }
+
  private:
   /// Max number of elements for a vector to be recyclable. The larger
   /// the batch the less the win from recycling.
   static constexpr vector_size_t kMaxRecycleSize = 64 * 1024;
   static constexpr int32_t kNumPerType = 10;
+  /// Max number of distinct complex types to cache vectors for.
+  static constexpr int32_t kMaxComplexTypes = 16;
+  /// Max retained size of a complex vector to be recyclable. Bounds the memory
+  /// held by children of recycled arrays, maps and rows.
+  static constexpr uint64_t kMaxComplexRetainedBytes = 8 << 20;
 
   struct TypePool {
     int32_t size{0};
@@ -54,12 +75,22 @@ class VectorPool {
 
     bool maybePushBack(VectorPtr& vector);
 
-    VectorPtr pop(
-        const TypePtr& type,
-        vector_size_t vectorSize,
-        memory::MemoryPool& pool);
+    /// Returns the most recently released vector of at least 'vectorSize'
+    /// rows, or the most recently released vector if all are smaller. Returns
+    /// nullptr if empty.
+    VectorPtr pop(vector_size_t vectorSize);
   };
 
+  struct ComplexTypePool {
+    TypePtr type;
+    TypePool vectors;
+  };
+
+  /// Returns the cache for complex 'type' or nullptr if 'type' is not a
+  /// supported complex type. Adds a cache if there is space and 'create' is
+  /// true.
+  TypePool* complexTypePool(const TypePtr& type, bool create);
+
   memory::MemoryPool* const pool_;
 
   static constexpr int32_t kNumCachedVectorTypes =
@@ -67,6 +98,11 @@ class VectorPool {
 
   /// Caches of pre-allocated vectors indexed by typeKind.
   std::array<TypePool, kNumCachedVectorTypes> vectors_;
+
+  /// Caches of pre-allocated array, map and row vectors.
+  std::vector<ComplexTypePool> complexVectors_;
+
+  Stats stats_;
 };
 
 /// A simple vector ptr wrapper with an associated vector pool. It releases
@@ -23,6 +23,34 @@ void VectorSerializer::append(const RowVectorPtr& vector) {
   append(vector, folly::Range(&allRows, 1));
 }
 
+void VectorSerde::scatter(
+    const RowVectorPtr& vector,
+    folly::Range<const uint32_t*> partitions,
+    const std::vector<VectorSerializer*>& serializers) {
+  const auto ranges = toPartitionRanges(partitions, serializers.size());
+  for (auto i = 0; i < serializers.size(); ++i) {
+    if (!ranges[i].empty()) {
+      serializers[i]->append(vector, ranges[i]);
+    }
+  }
+}
+
+std::vector<std::vector<IndexRange>> toPartitionRanges(
+    folly::Range<const uint32_t*> partitions,
+    int32_t numPartitions) {
+  std::vector<std::vector<IndexRange>> ranges(numPartitions);
+  for (vector_size_t row = 0; row < partitions.size(); ++row) {
+    auto& partitionRanges = ranges[partitions[row]];
+    if (!partitionRanges.empty() &&
+        partitionRanges.back().begin + partitionRanges.back().size == row) {
+      ++partitionRanges.back().size;
+    } else {
+      partitionRanges.push_back(IndexRange{row, 1});
+    }
+  }
+  return ranges;
+}
+
 namespace {
 
 std::unique_ptr<VectorSerde>& getVectorSerdeImpl() {
@@ -110,6 +138,27 @@ void VectorStreamGroup::append(const RowVectorPtr& vector) {
   serializer_->append(vector);
 }
 
+// static
+void VectorStreamGroup::scatter(
+    const RowVectorPtr& vector,
+    folly::Range<const uint32_t*> partitions,
+    const std::vector<VectorStreamGroup*>& groups) {
+  VectorSerde* serde = nullptr;
+  std::vector<VectorSerializer*> serializers(groups.size(), nullptr);
+  for (auto i = 0; i < groups.size(); ++i) {
+    if (groups[i] == nullptr) {
+      continue;
+    }
+    VELOX_CHECK_NOT_NULL(groups[i]->serializer_);
+    VELOX_CHECK(serde == nullptr || serde == groups[i]->serde_);
+    serde = groups[i]->serde_;
+    serializers[i] = groups[i]->serializer_.get();
+  }
+  if (serde != nullptr) {
+    serde->scatter(vector, partitions, serializers);
+  }
+}
+
 void VectorStreamGroup::flush(OutputStream* out) {
   serializer_->flush(out);
 }
@@ -87,8 +87,24 @@ class VectorSerde {
       RowTypePtr type,
       RowVectorPtr* result,
       const Options* options = nullptr) = 0;
+
+  /// Appends row 'i' of 'vector' to 'serializers[partitions[i]]' for all rows
+  /// of 'vector'. 'serializers' must have been created by 'this'. An element
+  /// of 'serializers' may be nullptr if no row goes to it. The default
+  /// implementation appends to one serializer at a time. A serde may override
+  /// this to make a single pass over each column for all serializers.
+  virtual void scatter(
+      const RowVectorPtr& vector,
+      folly::Range<const uint32_t*> partitions,
+      const std::vector<VectorSerializer*>& serializers);
 };
 
+/// Returns the rows of each of 'numPartitions' partitions as ranges of
+/// consecutive rows, where row 'i' belongs to partition 'partitions[i]'.
+std::vector<std::vector<IndexRange>> toPartitionRanges(
+    folly::Range<const uint32_t*> partitions,
+    int32_t numPartitions);
+
 /// Register/deregister the "default" vector serde.
 void registerVectorSerde(std::unique_ptr<VectorSerde> serdeToRegister);
 void deregisterVectorSerde();
@@ -138,6 +154,15 @@ class VectorStreamGroup : public StreamArena {
 
   void append(const RowVectorPtr& vector);
 
+  /// Appends row 'i' of 'vector' to 'groups[partitions[i]]' for all rows of
+  /// 'vector'. The groups with rows to append must have their stream trees
+  /// created by the same serde. Others may be nullptr. See
+  /// VectorSerde::scatter().
+  static void scatter(
+      const RowVectorPtr& vector,
+      folly::Range<const uint32_t*> partitions,
+      const std::vector<VectorStreamGroup*>& groups);
+
   // Writes the contents to 'stream' in wire format.
   void flush(OutputStream* stream);
 
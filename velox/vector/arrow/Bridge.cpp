@@ -16,6 +16,8 @@
 
 #include "velox/vector/arrow/Bridge.h"
 
+#include <numeric>
+
 #include "velox/buffer/Buffer.h"
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/CheckedArithmetic.h"
@@ -29,17 +31,32 @@ namespace facebook::velox {
 namespace {
 
 // The supported conversions use one buffer for nulls (0), one for values (1),
-// and one for offsets (2).
+// and one for offsets (2). String views use a variable number of buffers.
 static constexpr size_t kMaxBuffers{3};
 
+// Layout of an element of an Arrow Utf8View or BinaryView array. Strings of up
+// to 12 bytes are stored inline after 'size'. Longer strings are stored at
+// 'offset' in data buffer 'bufferIndex'.
+struct ArrowStringView {
+  int32_t size;
+  char prefix[4];
+  int32_t bufferIndex;
+  int32_t offset;
+};
+static_assert(sizeof(ArrowStringView) == sizeof(StringView));
+
 // Structure that will hold the buffers needed by ArrowArray. This is opaquely
 // carried by ArrowArray.private_data
 class VeloxToArrowBridgeHolder {
  public:
-  VeloxToArrowBridgeHolder() {
-    for (size_t i = 0; i < kMaxBuffers; ++i) {
-      buffers_[i] = nullptr;
-    }
+  VeloxToArrowBridgeHolder()
+      : buffers_(kMaxBuffers, nullptr), bufferPtrs_(kMaxBuffers) {}
+
+  // Sets the number of buffers. Invalidates the pointer returned by
+  // getArrowBuffers().
+  void resizeBuffers(size_t numBuffers) {
+    buffers_.resize(numBuffers, nullptr);
+    bufferPtrs_.resize(numBuffers);
   }
 
   // Acquires a buffer at index `idx`.
@@ -56,7 +73,7 @@ class VeloxToArrowBridgeHolder {
   }
 
   const void** getArrowBuffers() {
-    return buffers_;
+    return buffers_.data();
   }
 
   // Allocates space for `numChildren` ArrowArray pointers.
@@ -87,11 +104,11 @@ class VeloxToArrowBridgeHolder {
 
  private:
   // Holds the pointers to the arrow buffers.
-  const void* buffers_[kMaxBuffers];
+  std::vector<const void*> buffers_;
 
   // Holds ownership over the Buffers being referenced by the buffers vector
   // above.
-  BufferPtr bufferPtrs_[kMaxBuffers];
+  std::vector<BufferPtr> bufferPtrs_;
 
   // Auxiliary buffers to hold ownership over ArrowArray children structures.
   std::vector<std::unique_ptr<ArrowArray>> childrenPtrs_;
@@ -209,6 +226,7 @@ static void releaseArrowSchema(ArrowSchema* arrowSchema) {
 // Returns the Arrow C data interface format type for a given Velox type.
 const char* exportArrowFormatStr(
     const TypePtr& type,
+    const ArrowOptions& options,
     std::string& formatBuffer) {
   if (type->isDecimal()) {
     // Decimal types encode the precision, scale values.
@@ -240,9 +258,9 @@ const char* exportArrowFormatStr(
     // We always map VARCHAR and VARBINARY to the "small" version (lower case
     // format string), which uses 32 bit offsets.
     case TypeKind::VARCHAR:
-      return "u"; // utf-8 string
+      return options.exportToStringView ? "vu" : "u"; // utf-8 string
     case TypeKind::VARBINARY:
-      return "z"; // binary
+      return options.exportToStringView ? "vz" : "z"; // binary
 
     case TypeKind::TIMESTAMP:
       // TODO: need to figure out how we'll map this since in Velox we currently
@@ -413,12 +431,111 @@ void exportStrings(
   VELOX_DCHECK_EQ(bufSize, *rawOffsets);
 }
 
+// Exports strings as an Arrow string view array. The string buffers of 'vec'
+// become the data buffers of the array. Strings that are not in the string
+// buffers, e.g. because the vector was made from external StringViews, are
+// copied into an extra data buffer.
+void exportStringViews(
+    const FlatVector<StringView>& vec,
+    const Selection& rows,
+    ArrowArray& out,
+    memory::MemoryPool* pool,
+    VeloxToArrowBridgeHolder& holder) {
+  const auto& stringBuffers = vec.stringBuffers();
+  std::vector<int32_t> bufferOrder(stringBuffers.size());
+  std::iota(bufferOrder.begin(), bufferOrder.end(), 0);
+  std::sort(bufferOrder.begin(), bufferOrder.end(), [&](auto left, auto right) {
+    return std::less<const char*>()(
+        stringBuffers[left]->as<char>(), stringBuffers[right]->as<char>());
+  });
+  // Returns the index of the string buffer that contains 'value' or -1.
+  auto findBuffer = [&](const StringView& value) -> int32_t {
+    auto it = std::upper_bound(
+        bufferOrder.begin(),
+        bufferOrder.end(),
+        value.data(),
+        [&](const char* data, auto index) {
+          return std::less<const char*>()(
+              data, stringBuffers[index]->as<char>());
+        });
+    if (it == bufferOrder.begin()) {
+      return -1;
+    }
+    const auto& buffer = stringBuffers[*(it - 1)];
+    if (value.data() + value.size() > buffer->as<char>() + buffer->size()) {
+      return -1;
+    }
+    return *(it - 1);
+  };
+
+  size_t extraSize = 0;
+  rows.apply([&](vector_size_t i) {
+    if (!vec.isNullAt(i)) {
+      auto value = vec.valueAtFast(i);
+      if (!value.isInline() && findBuffer(value) < 0) {
+        extraSize += value.size();
+      }
+    }
+  });
+  VELOX_CHECK_LT(extraSize, std::numeric_limits<int32_t>::max());
+
+  const auto extraIndex = stringBuffers.size();
+  const auto numDataBuffers = stringBuffers.size() + (extraSize > 0 ? 1 : 0);
+  out.n_buffers = 3 + numDataBuffers;
+  holder.resizeBuffers(out.n_buffers);
+  out.buffers = holder.getArrowBuffers();
+
+  auto dataSizes = AlignedBuffer::allocate<int64_t>(numDataBuffers, pool);
+  auto* rawDataSizes = dataSizes->asMutable<int64_t>();
+  for (auto i = 0; i < stringBuffers.size(); ++i) {
+    holder.setBuffer(2 + i, stringBuffers[i]);
+    rawDataSizes[i] = stringBuffers[i]->size();
+  }
+  char* rawExtra = nullptr;
+  if (extraSize > 0) {
+    holder.setBuffer(2 + extraIndex, AlignedBuffer::allocate<char>(extraSize, pool));
+    rawExtra = holder.getBufferAs<char>(2 + extraIndex);
+    rawDataSizes[extraIndex] = extraSize;
+  }
+  holder.setBuffer(out.n_buffers - 1, dataSizes);
+
+  holder.setBuffer(1, AlignedBuffer::allocate<ArrowStringView>(out.length, pool));
+  auto* rawViews = holder.getBufferAs<ArrowStringView>(1);
+  int32_t extraOffset = 0;
+  vector_size_t j = 0;
+  rows.apply([&](vector_size_t i) {
+    auto& view = rawViews[j++];
+    memset(&view, 0, sizeof(view));
+    if (vec.isNullAt(i)) {
+      return;
+    }
+    auto value = vec.valueAtFast(i);
+    view.size = value.size();
+    if (value.isInline()) {
+      memcpy(view.prefix, value.data(), value.size());
+      return;
+    }
+    memcpy(view.prefix, value.data(), sizeof(view.prefix));
+    auto bufferIndex = findBuffer(value);
+    if (bufferIndex >= 0) {
+      view.bufferIndex = bufferIndex;
+      view.offset = value.data() - stringBuffers[bufferIndex]->as<char>();
+    } else {
+      memcpy(rawExtra + extraOffset, value.data(), value.size());
+      view.bufferIndex = extraIndex;
+      view.offset = extraOffset;
+      extraOffset += value.size();
+    }
+  });
+}
+
 void exportFlat(
     const BaseVector& vec,
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
-    VeloxToArrowBridgeHolder& holder) {
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
   out.n_children = 0;
   out.children = nullptr;
   switch (vec.typeKind()) {
@@ -434,8 +551,21 @@ void exportFlat(
       break;
     case TypeKind::VARCHAR:
     case TypeKind::VARBINARY:
-      exportStrings(
-          *vec.asUnchecked<FlatVector<StringView>>(), rows, out, pool, holder);
+      if (options.exportToStringView) {
+        exportStringViews(
+            *vec.asUnchecked<FlatVector<StringView>>(),
+            rows,
+            out,
+            pool,
+            holder);
+      } else {
+        exportStrings(
+            *vec.asUnchecked<FlatVector<StringView>>(),
+            rows,
+            out,
+            pool,
+            holder);
+      }
       break;
     default:
       VELOX_NYI(
@@ -448,14 +578,16 @@ void exportBase(
     const BaseVector&,
     const Selection&,
     ArrowArray&,
-    memory::MemoryPool*);
+    memory::MemoryPool*,
+    const ArrowOptions&);
 
 void exportRows(
     const RowVector& vec,
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
-    VeloxToArrowBridgeHolder& holder) {
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
   out.n_buffers = 1;
   holder.resizeChildren(vec.childrenSize());
   out.n_children = vec.childrenSize();
@@ -466,7 +598,8 @@ void exportRows(
           *vec.childAt(i)->loadedVector(),
           rows,
           *holder.allocateChild(i),
-          pool);
+          pool,
+          options);
     } catch (const VeloxException&) {
       for (column_index_t j = 0; j < i; ++j) {
         // When exception is thrown, i th child is guaranteed unset.
@@ -527,7 +660,8 @@ void exportArrays(
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
-    VeloxToArrowBridgeHolder& holder) {
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
   Selection childRows(vec.elements()->size());
   exportOffsets(vec, rows, out, pool, holder, childRows);
   holder.resizeChildren(1);
@@ -535,7 +669,8 @@ void exportArrays(
       *vec.elements()->loadedVector(),
       childRows,
       *holder.allocateChild(0),
-      pool);
+      pool,
+      options);
   out.n_children = 1;
   out.children = holder.getChildrenArrays();
 }
@@ -545,7 +680,8 @@ void exportMaps(
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
-    VeloxToArrowBridgeHolder& holder) {
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
   RowVector child(
       pool,
       ROW({"key", "value"}, {vec.mapKeys()->type(), vec.mapValues()->type()}),
@@ -555,7 +691,7 @@ void exportMaps(
   Selection childRows(child.size());
   exportOffsets(vec, rows, out, pool, holder, childRows);
   holder.resizeChildren(1);
-  exportBase(child, childRows, *holder.allocateChild(0), pool);
+  exportBase(child, childRows, *holder.allocateChild(0), pool, options);
   out.n_children = 1;
   out.children = holder.getChildrenArrays();
 }
@@ -565,7 +701,8 @@ void exportDictionary(
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
-    VeloxToArrowBridgeHolder& holder) {
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
   out.n_buffers = 2;
   out.n_children = 0;
   if (rows.changed()) {
@@ -577,35 +714,84 @@ void exportDictionary(
   }
   auto& values = *vec.valueVector()->loadedVector();
   out.dictionary = holder.allocateDictionary();
-  exportBase(values, Selection(values.size()), *out.dictionary, pool);
+  exportBase(
+      values, Selection(values.size()), *out.dictionary, pool, options);
+}
+
+// Exports a constant vector as a run-end encoded array with a single run.
+void exportConstant(
+    const BaseVector& vec,
+    ArrowArray& out,
+    memory::MemoryPool* pool,
+    VeloxToArrowBridgeHolder& holder,
+    const ArrowOptions& options) {
+  // Run-end encoded arrays have no buffers. Nulls are in the values.
+  out.n_buffers = 0;
+  out.null_count = 0;
+
+  const vector_size_t numRuns = out.length > 0 ? 1 : 0;
+  auto runEnds = std::make_shared<FlatVector<int32_t>>(
+      pool,
+      INTEGER(),
+      nullptr,
+      numRuns,
+      AlignedBuffer::allocate<int32_t>(
+          numRuns, pool, static_cast<int32_t>(out.length)),
+      std::vector<BufferPtr>{});
+  auto values = BaseVector::create(vec.type(), numRuns, pool);
+  if (numRuns > 0) {
+    values->copy(&vec, 0, 0, 1);
+  }
+
+  holder.resizeChildren(2);
+  out.n_children = 2;
+  out.children = holder.getChildrenArrays();
+  exportBase(
+      *runEnds, Selection(numRuns), *holder.allocateChild(0), pool, options);
+  try {
+    exportBase(
+        *values, Selection(numRuns), *holder.allocateChild(1), pool, options);
+  } catch (const VeloxException&) {
+    out.children[0]->release(out.children[0]);
+    throw;
+  }
 }
 
 void exportBase(
     const BaseVector& vec,
     const Selection& rows,
     ArrowArray& out,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    const ArrowOptions& options) {
   auto holder = std::make_unique<VeloxToArrowBridgeHolder>();
   out.buffers = holder->getArrowBuffers();
   out.length = rows.count();
   out.offset = 0;
   out.dictionary = nullptr;
-  exportNulls(vec, rows, out, pool, *holder);
+  if (vec.encoding() != VectorEncoding::Simple::CONSTANT) {
+    exportNulls(vec, rows, out, pool, *holder);
+  }
   switch (vec.encoding()) {
     case VectorEncoding::Simple::FLAT:
-      exportFlat(vec, rows, out, pool, *holder);
+      exportFlat(vec, rows, out, pool, *holder, options);
       break;
     case VectorEncoding::Simple::ROW:
-      exportRows(*vec.asUnchecked<RowVector>(), rows, out, pool, *holder);
+      exportRows(
+          *vec.asUnchecked<RowVector>(), rows, out, pool, *holder, options);
       break;
     case VectorEncoding::Simple::ARRAY:
-      exportArrays(*vec.asUnchecked<ArrayVector>(), rows, out, pool, *holder);
+      exportArrays(
+          *vec.asUnchecked<ArrayVector>(), rows, out, pool, *holder, options);
       break;
     case VectorEncoding::Simple::MAP:
-      exportMaps(*vec.asUnchecked<MapVector>(), rows, out, pool, *holder);
+      exportMaps(
+          *vec.asUnchecked<MapVector>(), rows, out, pool, *holder, options);
       break;
     case VectorEncoding::Simple::DICTIONARY:
-      exportDictionary(vec, rows, out, pool, *holder);
+      exportDictionary(vec, rows, out, pool, *holder, options);
+      break;
+    case VectorEncoding::Simple::CONSTANT:
+      exportConstant(vec, out, pool, *holder, options);
       break;
     default:
       VELOX_NYI("{} cannot be exported to Arrow yet.", vec.encoding());
@@ -619,11 +805,15 @@ void exportBase(
 void exportToArrow(
     const VectorPtr& vector,
     ArrowArray& arrowArray,
-    memory::MemoryPool* pool) {
-  exportBase(*vector, Selection(vector->size()), arrowArray, pool);
+    memory::MemoryPool* pool,
+    const ArrowOptions& options) {
+  exportBase(*vector, Selection(vector->size()), arrowArray, pool, options);
 }
 
-void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
+void exportToArrow(
+    const VectorPtr& vec,
+    ArrowSchema& arrowSchema,
+    const ArrowOptions& options) {
   auto& type = vec->type();
 
   arrowSchema.name = nullptr;
@@ -643,10 +833,40 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
     arrowSchema.format = "i";
     bridgeHolder->dictionary = std::make_unique<ArrowSchema>();
     arrowSchema.dictionary = bridgeHolder->dictionary.get();
-    exportToArrow(vec->valueVector(), *arrowSchema.dictionary);
+    exportToArrow(vec->valueVector(), *arrowSchema.dictionary, options);
+
+  } else if (vec->encoding() == VectorEncoding::Simple::CONSTANT) {
+    // Run-end encoded with int32 run ends, see exportConstant().
+    arrowSchema.format = "+r";
+    arrowSchema.dictionary = nullptr;
+    bridgeHolder->childrenRaw.resize(2);
+    bridgeHolder->childrenOwned.resize(2);
+    arrowSchema.children = bridgeHolder->childrenRaw.data();
+    arrowSchema.n_children = 2;
+
+    auto& runEnds = bridgeHolder->childrenOwned[0];
+    runEnds = std::make_unique<ArrowSchema>();
+    exportToArrow(BaseVector::create(INTEGER(), 0, vec->pool()), *runEnds);
+    runEnds->name = "run_ends";
+    // Run ends are never null.
+    runEnds->flags = 0;
+    arrowSchema.children[0] = runEnds.get();
+
+    try {
+      auto& values = bridgeHolder->childrenOwned[1];
+      values = std::make_unique<ArrowSchema>();
+      exportToArrow(
+          BaseVector::create(type, 0, vec->pool()), *values, options);
+      values->name = "values";
+      arrowSchema.children[1] = values.get();
+    } catch (const VeloxException&) {
+      runEnds->release(runEnds.get());
+      throw;
+    }
 
   } else {
-    arrowSchema.format = exportArrowFormatStr(type, bridgeHolder->formatBuffer);
+    arrowSchema.format =
+        exportArrowFormatStr(type, options, bridgeHolder->formatBuffer);
     arrowSchema.dictionary = nullptr;
 
     if (type->kind() == TypeKind::MAP) {
@@ -661,14 +881,14 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
           0,
           std::vector<VectorPtr>{maps.mapKeys(), maps.mapValues()},
           maps.getNullCount());
-      exportToArrow(rows, *child);
+      exportToArrow(rows, *child, options);
       child->name = "entries";
       setUniqueChild(std::move(child), *bridgeHolder, arrowSchema);
 
     } else if (type->kind() == TypeKind::ARRAY) {
       auto child = std::make_unique<ArrowSchema>();
       auto& arrays = *vec->asUnchecked<ArrayVector>();
-      exportToArrow(arrays.elements(), *child);
+      exportToArrow(arrays.elements(), *child, options);
       // Name is required, and "item" is the default name used in arrow itself.
       child->name = "item";
       setUniqueChild(std::move(child), *bridgeHolder, arrowSchema);
@@ -701,7 +921,7 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
         try {
           auto& currentSchema = bridgeHolder->childrenOwned[i];
           currentSchema = std::make_unique<ArrowSchema>();
-          exportToArrow(rows.childAt(i), *currentSchema);
+          exportToArrow(rows.childAt(i), *currentSchema, options);
           currentSchema->name = bridgeHolder->rowType->nameOf(i).data();
           arrowSchema.children[i] = currentSchema.get();
         } catch (const VeloxException& e) {
@@ -756,6 +976,16 @@ TypePtr importFromArrow(const ArrowSchema& arrowSchema) {
     case 'Z':
       return VARBINARY();
 
+    // String and binary views.
+    case 'v':
+      if (format[1] == 'u') {
+        return VARCHAR();
+      }
+      if (format[1] == 'z') {
+        return VARBINARY();
+      }
+      break;
+
     case 't': // temporal types.
       // Mapping it to ttn for now.
       if (format[1] == 't' && format[2] == 'n') {
@@ -790,6 +1020,21 @@ TypePtr importFromArrow(const ArrowSchema& arrowSchema) {
           VELOX_CHECK_NOT_NULL(arrowSchema.children[0]);
           return ARRAY(importFromArrow(*arrowSchema.children[0]));
 
+        // List view.
+        case 'v':
+          if (format[2] == 'l') {
+            VELOX_CHECK_EQ(arrowSchema.n_children, 1);
+            VELOX_CHECK_NOT_NULL(arrowSchema.children[0]);
+            return ARRAY(importFromArrow(*arrowSchema.children[0]));
+          }
+          break;
+
+        // Run-end encoded. The type is the type of the values.
+        case 'r':
+          VELOX_CHECK_EQ(arrowSchema.n_children, 2);
+          VELOX_CHECK_NOT_NULL(arrowSchema.children[1]);
+          return importFromArrow(*arrowSchema.children[1]);
+
         // Map.
         case 'm': {
           VELOX_CHECK_EQ(arrowSchema.n_children, 1);
@@ -946,6 +1191,64 @@ VectorPtr createStringFlatVector(
       optionalNullCount(nullCount));
 }
 
+// Imports an Arrow string view array. The data buffers are wrapped without
+// copying and the Arrow views are converted into StringViews that point into
+// them.
+VectorPtr createStringViewFlatVector(
+    memory::MemoryPool* pool,
+    const TypePtr& type,
+    BufferPtr nulls,
+    const ArrowArray& arrowArray,
+    WrapInBufferViewFunc wrapInBufferView) {
+  VELOX_USER_CHECK_GE(
+      arrowArray.n_buffers,
+      3,
+      "Expecting at least three buffers as input for string views.");
+  const auto numDataBuffers = arrowArray.n_buffers - 3;
+  const auto* dataSizes =
+      static_cast<const int64_t*>(arrowArray.buffers[arrowArray.n_buffers - 1]);
+  std::vector<BufferPtr> stringBuffers;
+  stringBuffers.reserve(numDataBuffers);
+  for (auto i = 0; i < numDataBuffers; ++i) {
+    stringBuffers.push_back(
+        wrapInBufferView(arrowArray.buffers[2 + i], dataSizes[i]));
+  }
+
+  const auto length = arrowArray.length;
+  BufferPtr stringViews = AlignedBuffer::allocate<StringView>(length, pool);
+  auto* rawStringViews = stringViews->asMutable<StringView>();
+  const auto* views =
+      static_cast<const ArrowStringView*>(arrowArray.buffers[1]);
+  const auto* rawNulls = nulls ? nulls->as<uint64_t>() : nullptr;
+  for (int64_t i = 0; i < length; ++i) {
+    if (rawNulls && bits::isBitNull(rawNulls, i)) {
+      rawStringViews[i] = StringView();
+      continue;
+    }
+    const auto& view = views[i];
+    if (view.size <= StringView::kInlineSize) {
+      rawStringViews[i] = StringView(view.prefix, view.size);
+    } else {
+      VELOX_USER_CHECK_LT(view.bufferIndex, numDataBuffers);
+      rawStringViews[i] = StringView(
+          static_cast<const char*>(arrowArray.buffers[2 + view.bufferIndex]) +
+              view.offset,
+          view.size);
+    }
+  }
+
+  return std::make_shared<FlatVector<StringView>>(
+      pool,
+      type,
+      nulls,
+      length,
+      stringViews,
+      std::move(stringBuffers),
+      SimpleVectorStats<StringView>{},
+      std::nullopt,
+      optionalNullCount(arrowArray.null_count));
+}
+
 VectorPtr importFromArrowImpl(
     ArrowSchema& arrowSchema,
     ArrowArray& arrowArray,
@@ -1019,6 +1322,36 @@ ArrayVectorPtr createArrayVector(
       optionalNullCount(arrowArray.null_count));
 }
 
+// Imports an Arrow list view. Its offsets and sizes have the layout of the
+// ArrayVector offsets and sizes and are wrapped without copying.
+ArrayVectorPtr createListViewVector(
+    memory::MemoryPool* pool,
+    const TypePtr& type,
+    BufferPtr nulls,
+    const ArrowSchema& arrowSchema,
+    const ArrowArray& arrowArray,
+    bool isViewer,
+    WrapInBufferViewFunc wrapInBufferView) {
+  static_assert(sizeof(vector_size_t) == sizeof(int32_t));
+  VELOX_CHECK_EQ(arrowArray.n_buffers, 3);
+  VELOX_CHECK_EQ(arrowArray.n_children, 1);
+  auto offsets = wrapInBufferView(
+      arrowArray.buffers[1], arrowArray.length * sizeof(vector_size_t));
+  auto sizes = wrapInBufferView(
+      arrowArray.buffers[2], arrowArray.length * sizeof(vector_size_t));
+  auto elements = importFromArrowImpl(
+      *arrowSchema.children[0], *arrowArray.children[0], pool, isViewer);
+  return std::make_shared<ArrayVector>(
+      pool,
+      type,
+      std::move(nulls),
+      arrowArray.length,
+      std::move(offsets),
+      std::move(sizes),
+      std::move(elements),
+      optionalNullCount(arrowArray.null_count));
+}
+
 MapVectorPtr createMapVector(
     memory::MemoryPool* pool,
     const TypePtr& type,
@@ -1078,6 +1411,57 @@ VectorPtr createDictionaryVector(
       std::move(wrapped));
 }
 
+int64_t runEndAt(const BaseVector& runEnds, vector_size_t index) {
+  switch (runEnds.typeKind()) {
+    case TypeKind::SMALLINT:
+      return runEnds.asUnchecked<SimpleVector<int16_t>>()->valueAt(index);
+    case TypeKind::INTEGER:
+      return runEnds.asUnchecked<SimpleVector<int32_t>>()->valueAt(index);
+    case TypeKind::BIGINT:
+      return runEnds.asUnchecked<SimpleVector<int64_t>>()->valueAt(index);
+    default:
+      VELOX_USER_FAIL(
+          "Unsupported run ends type: {}", runEnds.type()->toString());
+  }
+}
+
+// Imports an Arrow run-end encoded array without copying the values. A single
+// run becomes a constant vector. Otherwise the values are wrapped in a
+// dictionary with one index per row.
+VectorPtr createRunEndEncodedVector(
+    memory::MemoryPool* pool,
+    const ArrowSchema& arrowSchema,
+    const ArrowArray& arrowArray,
+    bool isViewer) {
+  VELOX_USER_CHECK_EQ(
+      arrowArray.n_children,
+      2,
+      "Expecting run ends and values as children of run-end encoded arrays.");
+  auto runEnds = importFromArrowImpl(
+      *arrowSchema.children[0], *arrowArray.children[0], pool, isViewer);
+  auto values = importFromArrowImpl(
+      *arrowSchema.children[1], *arrowArray.children[1], pool, isViewer);
+  VELOX_USER_CHECK_EQ(runEnds->size(), values->size());
+
+  const vector_size_t length = arrowArray.length;
+  if (values->size() == 1 && length > 0) {
+    return BaseVector::wrapInConstant(length, 0, std::move(values));
+  }
+
+  auto indices = allocateIndices(length, pool);
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  vector_size_t row = 0;
+  for (vector_size_t run = 0; run < runEnds->size() && row < length; ++run) {
+    const auto end = std::min<int64_t>(runEndAt(*runEnds, run), length);
+    for (; row < end; ++row) {
+      rawIndices[row] = run;
+    }
+  }
+  VELOX_USER_CHECK_EQ(row, length, "Run ends do not cover the array.");
+  return BaseVector::wrapInDictionary(
+      nullptr, std::move(indices), length, std::move(values));
+}
+
 VectorPtr importFromArrowImpl(
     ArrowSchema& arrowSchema,
     ArrowArray& arrowArray,
@@ -1118,6 +1502,19 @@ VectorPtr importFromArrowImpl(
         pool, type, nulls, arrowSchema, arrowArray, isViewer, wrapInBufferView);
   }
 
+  const char* format = arrowSchema.format;
+  if (strcmp(format, "+r") == 0) {
+    return createRunEndEncodedVector(pool, arrowSchema, arrowArray, isViewer);
+  }
+  if (strcmp(format, "+vl") == 0) {
+    return createListViewVector(
+        pool, type, nulls, arrowSchema, arrowArray, isViewer, wrapInBufferView);
+  }
+  if (format[0] == 'v') {
+    return createStringViewFlatVector(
+        pool, type, nulls, arrowArray, wrapInBufferView);
+  }
+
   // String data types (VARCHAR and VARBINARY).
   if (type->isVarchar() || type->isVarbinary()) {
     VELOX_USER_CHECK_EQ(
@@ -27,6 +27,14 @@ struct ArrowSchema;
 
 namespace facebook::velox {
 
+struct ArrowOptions {
+  /// Export VARCHAR and VARBINARY vectors as Arrow Utf8View and BinaryView
+  /// arrays ("vu" and "vz" formats) instead of offset based strings. String
+  /// views refer to the string buffers of the exported vector, so the string
+  /// data is not copied.
+  bool exportToStringView{false};
+};
+
 /// Export a generic Velox Vector to an ArrowArray, as defined by Arrow's C data
 /// interface:
 ///
@@ -44,6 +52,10 @@ namespace facebook::velox {
 /// where the conversion is not zero-copy, e.g. for strings) and throws in case
 /// the conversion is not implemented yet.
 ///
+/// Dictionary vectors are exported as Arrow dictionary arrays and constant
+/// vectors as run-end encoded arrays with a single run. The same 'options' must
+/// be used to export the ArrowSchema.
+///
 /// Example usage:
 ///
 ///   ArrowArray arrowArray;
@@ -57,7 +69,8 @@ namespace facebook::velox {
 void exportToArrow(
     const VectorPtr& vector,
     ArrowArray& arrowArray,
-    memory::MemoryPool* pool);
+    memory::MemoryPool* pool,
+    const ArrowOptions& options = ArrowOptions{});
 
 /// Export the type of a Velox vector to an ArrowSchema.
 ///
@@ -78,7 +91,10 @@ void exportToArrow(
 ///
 /// NOTE: Since Arrow couples type and encoding, we need both Velox type and
 /// actual data (containing encoding) to create an ArrowSchema.
-void exportToArrow(const VectorPtr&, ArrowSchema&);
+void exportToArrow(
+    const VectorPtr&,
+    ArrowSchema&,
+    const ArrowOptions& options = ArrowOptions{});
 
 /// Import an ArrowSchema into a Velox Type object.
 ///
@@ -107,7 +123,10 @@ TypePtr importFromArrow(const ArrowSchema& arrowSchema);
 /// carry a pointer to it, but not really used in most cases - unless the
 /// conversion itself requires a new allocation. In most cases no new
 /// allocations are required, unless for arrays of varchars (or varbinaries) and
-/// complex types written out of order.
+/// complex types written out of order. String views, list views and
+/// run-end encoded arrays are also supported. String data is not copied for
+/// string views. Run-end encoded arrays become constant vectors if they have a
+/// single run and dictionary vectors otherwise.
 ///
 /// The new Velox vector returned contains only references to the underlying
 /// buffers, so it's the client's responsibility to ensure the buffer's
@@ -663,9 +663,6 @@ TEST_F(ArrowBridgeArrayExportTest, unsupported) {
   vector = vectorMaker_.flatVectorNullable<Timestamp>({});
   EXPECT_THROW(exportToArrow(vector, arrowArray, pool_.get()), VeloxException);
 
-  // Constant encoding.
-  vector = BaseVector::createConstant(INTEGER(), variant(10), 10, pool_.get());
-  EXPECT_THROW(exportToArrow(vector, arrowArray, pool_.get()), VeloxException);
 }
 
 class ArrowBridgeArrayImportTest : public ArrowBridgeArrayExportTest {
@@ -1297,4 +1294,155 @@ TEST_F(ArrowBridgeArrayImportAsOwnerTest, releaseCalled) {
   EXPECT_TRUE(TestReleaseCalled::arrayReleaseCalled);
 }
 
+class ArrowBridgeArrayRoundTripTest : public ArrowBridgeArrayExportTest {
+ protected:
+  VectorPtr roundTrip(
+      const VectorPtr& vector,
+      const ArrowOptions& options = ArrowOptions{}) {
+    ArrowSchema arrowSchema;
+    ArrowArray arrowArray;
+    exportToArrow(vector, arrowSchema, options);
+    exportToArrow(vector, arrowArray, pool_.get(), options);
+    auto imported =
+        importFromArrowAsOwner(arrowSchema, arrowArray, pool_.get());
+    assertEqualValues(vector, imported);
+    return imported;
+  }
+
+  void assertEqualValues(const VectorPtr& expected, const VectorPtr& actual) {
+    ASSERT_EQ(expected->size(), actual->size());
+    ASSERT_TRUE(expected->type()->equivalent(*actual->type()));
+    for (auto i = 0; i < expected->size(); ++i) {
+      ASSERT_TRUE(expected->equalValueAt(actual.get(), i, i))
+          << "at " << i << ": " << expected->toString(i) << " vs "
+          << actual->toString(i);
+    }
+  }
+};
+
+TEST_F(ArrowBridgeArrayRoundTripTest, stringView) {
+  ArrowOptions options;
+  options.exportToStringView = true;
+
+  auto vector = vectorMaker_.flatVectorNullable<std::string>(
+      {"short",
+       std::nullopt,
+       "a string that is too long to inline",
+       "",
+       "another string that is too long to inline"});
+  ArrowSchema arrowSchema;
+  exportToArrow(vector, arrowSchema, options);
+  EXPECT_STREQ("vu", arrowSchema.format);
+  arrowSchema.release(&arrowSchema);
+
+  ArrowArray arrowArray;
+  exportToArrow(vector, arrowArray, pool_.get(), options);
+  // Nulls, views, one data buffer and data buffer sizes.
+  EXPECT_EQ(4, arrowArray.n_buffers);
+  arrowArray.release(&arrowArray);
+
+  auto imported = roundTrip(vector, options);
+  // Long strings point into the exported string buffer.
+  auto flat = vector->asFlatVector<StringView>();
+  auto importedFlat = imported->asFlatVector<StringView>();
+  ASSERT_NE(importedFlat, nullptr);
+  EXPECT_EQ(flat->valueAt(2).data(), importedFlat->valueAt(2).data());
+
+  // Strings that are not in a string buffer of the vector are copied.
+  std::string external = "a string that is not in a string buffer";
+  auto externalVector = std::dynamic_pointer_cast<FlatVector<StringView>>(
+      BaseVector::create(VARCHAR(), 2, pool_.get()));
+  externalVector->setNoCopy(0, StringView(external));
+  externalVector->setNoCopy(1, StringView("inline"));
+  roundTrip(externalVector, options);
+
+  roundTrip(
+      vectorMaker_.arrayVector<StringView>(
+          {{"a", "a string that is too long to inline"}, {}, {"b"}}),
+      options);
+}
+
+TEST_F(ArrowBridgeArrayRoundTripTest, constant) {
+  auto imported = roundTrip(
+      BaseVector::createConstant(INTEGER(), variant(10), 10, pool_.get()));
+  EXPECT_TRUE(imported->isConstantEncoding());
+
+  imported = roundTrip(BaseVector::createNullConstant(BIGINT(), 5, pool_.get()));
+  EXPECT_TRUE(imported->isConstantEncoding());
+
+  auto arrays = vectorMaker_.arrayVector<int64_t>({{1, 2}, {3}});
+  imported = roundTrip(BaseVector::wrapInConstant(7, 1, arrays));
+  EXPECT_TRUE(imported->isConstantEncoding());
+
+  roundTrip(vectorMaker_.rowVector(
+      {vectorMaker_.flatVector<int64_t>({1, 2, 3}),
+       BaseVector::createConstant(VARCHAR(), variant("abc"), 3, pool_.get())}));
+
+  roundTrip(BaseVector::createConstant(INTEGER(), variant(10), 0, pool_.get()));
+}
+
+TEST_F(ArrowBridgeArrayRoundTripTest, dictionary) {
+  auto indices = makeBuffer<vector_size_t>({2, 0, 1, 1, 2});
+  auto imported = roundTrip(BaseVector::wrapInDictionary(
+      nullptr,
+      indices,
+      5,
+      vectorMaker_.flatVector<std::string>(
+          {"a", "a string that is too long to inline", "c"})));
+  EXPECT_EQ(VectorEncoding::Simple::DICTIONARY, imported->encoding());
+}
+
+TEST_F(ArrowBridgeArrayRoundTripTest, runEndEncoded) {
+  const int32_t runEnds[] = {2, 5};
+  const int64_t values[] = {10, 20};
+  const void* runEndsBuffers[] = {nullptr, runEnds};
+  const void* valuesBuffers[] = {nullptr, values};
+
+  auto runEndsSchema = makeArrowSchema("i");
+  auto valuesSchema = makeArrowSchema("l");
+  ArrowSchema* childSchemas[] = {&runEndsSchema, &valuesSchema};
+  auto arrowSchema = makeArrowSchema("+r");
+  arrowSchema.n_children = 2;
+  arrowSchema.children = childSchemas;
+
+  auto runEndsArray = makeArrowArray(runEndsBuffers, 2, 2, 0);
+  auto valuesArray = makeArrowArray(valuesBuffers, 2, 2, 0);
+  ArrowArray* childArrays[] = {&runEndsArray, &valuesArray};
+  auto arrowArray = makeArrowArray(nullptr, 0, 5, 0);
+  arrowArray.n_children = 2;
+  arrowArray.children = childArrays;
+
+  auto vector = importFromArrowAsViewer(arrowSchema, arrowArray, pool_.get());
+  EXPECT_EQ(VectorEncoding::Simple::DICTIONARY, vector->encoding());
+  assertEqualValues(
+      vectorMaker_.flatVector<int64_t>({10, 10, 20, 20, 20}), vector);
+}
+
+TEST_F(ArrowBridgeArrayRoundTripTest, listView) {
+  // Lists [30, 40], [], [10, 20, 30] sharing elements out of order.
+  const int64_t elements[] = {10, 20, 30, 40};
+  const int32_t offsets[] = {2, 0, 0};
+  const int32_t sizes[] = {2, 0, 3};
+  const void* elementsBuffers[] = {nullptr, elements};
+  const void* listBuffers[] = {nullptr, offsets, sizes};
+
+  auto elementsSchema = makeArrowSchema("l");
+  ArrowSchema* childSchemas[] = {&elementsSchema};
+  auto arrowSchema = makeArrowSchema("+vl");
+  arrowSchema.n_children = 1;
+  arrowSchema.children = childSchemas;
+
+  auto elementsArray = makeArrowArray(elementsBuffers, 2, 4, 0);
+  ArrowArray* childArrays[] = {&elementsArray};
+  auto arrowArray = makeArrowArray(listBuffers, 3, 3, 0);
+  arrowArray.n_children = 1;
+  arrowArray.children = childArrays;
+
+  auto vector = importFromArrowAsViewer(arrowSchema, arrowArray, pool_.get());
+  ASSERT_EQ(VectorEncoding::Simple::ARRAY, vector->encoding());
+  EXPECT_EQ(offsets, vector->as<ArrayVector>()->rawOffsets());
+  assertEqualValues(
+      vectorMaker_.arrayVector<int64_t>({{30, 40}, {}, {10, 20, 30}}), vector);
+}
+
 } // namespace
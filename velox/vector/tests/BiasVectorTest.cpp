@@ -153,4 +153,61 @@ TYPED_TEST(BiasVectorOverflowTest, minOverflowTest_delta_int32) {
   this->runMinOverflowTest(delta);
 }
 
+template <typename T>
+class BiasVectorEncodeTest : public BiasVectorTestBase {
+ protected:
+  void testEncode(const std::vector<std::optional<T>>& input) {
+    auto flat = vectorMaker_.flatVectorNullable(input);
+    auto biased = tryBiasEncode(*flat);
+    ASSERT_TRUE(biased != nullptr);
+    ASSERT_EQ(biased->size(), input.size());
+    if (input.size() >= 1'000) {
+      ASSERT_LT(biased->retainedSize(), flat->retainedSize());
+    }
+
+    std::vector<T> unpacked(input.size());
+    biased->unpack(0, input.size(), unpacked.data());
+    for (auto i = 0; i < input.size(); ++i) {
+      ASSERT_EQ(biased->isNullAt(i), !input[i].has_value()) << i;
+      if (input[i].has_value()) {
+        ASSERT_EQ(biased->valueAt(i), *input[i]) << i;
+        ASSERT_EQ(unpacked[i], *input[i]) << i;
+      }
+    }
+  }
+};
+
+VELOX_TYPED_TEST_SUITE(BiasVectorEncodeTest, inputTypes);
+
+TYPED_TEST(BiasVectorEncodeTest, encode) {
+  using T = TypeParam;
+  std::vector<std::optional<T>> input;
+  const T base = std::numeric_limits<T>::max() - 100;
+  for (auto i = 0; i < 1'000; ++i) {
+    input.push_back(
+        i % 7 == 0 ? std::nullopt : std::optional<T>(base + i % 100));
+  }
+  this->testEncode(input);
+
+  // Values at the low end of the range.
+  input.clear();
+  for (auto i = 0; i < 77; ++i) {
+    input.push_back(std::numeric_limits<T>::min() + i * 3);
+  }
+  this->testEncode(input);
+}
+
+TYPED_TEST(BiasVectorEncodeTest, notEncodable) {
+  using T = TypeParam;
+  auto flat = this->vectorMaker_.flatVectorNullable(
+      std::vector<std::optional<T>>{
+          std::numeric_limits<T>::min(), std::numeric_limits<T>::max()});
+  ASSERT_TRUE(tryBiasEncode(*flat) == nullptr);
+
+  flat = this->vectorMaker_.flatVectorNullable(
+      std::vector<std::optional<T>>{std::nullopt, std::nullopt});
+  ASSERT_TRUE(tryBiasEncode(*flat) == nullptr);
+}
+
+
 } // namespace facebook::velox::test
@@ -1427,4 +1427,51 @@ TEST_F(DecodedVectorTest, previousIndicesInReUsedDecodedVector) {
   EXPECT_EQ(rawIndices[0], 0);
 }
 
+TEST_F(DecodedVectorTest, biased) {
+  std::vector<std::optional<int64_t>> values;
+  for (auto i = 0; i < 1'000; ++i) {
+    values.push_back(
+        i % 11 == 0 ? std::nullopt
+                    : std::optional<int64_t>(1'000'000'000 + i % 200));
+  }
+  auto biased = vectorMaker_.biasVector(values);
+
+  DecodedVector decoded(*biased);
+  ASSERT_TRUE(decoded.isIdentityMapping());
+  ASSERT_EQ(decoded.base(), biased.get());
+  for (auto i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(decoded.isNullAt(i), !values[i].has_value()) << i;
+    if (values[i].has_value()) {
+      ASSERT_EQ(decoded.valueAt<int64_t>(i), *values[i]) << i;
+      ASSERT_EQ(decoded.data<int64_t>()[i], *values[i]) << i;
+    }
+  }
+
+  // Partial selection.
+  SelectivityVector rows(values.size(), false);
+  rows.setValidRange(10, 50, true);
+  rows.updateBounds();
+  decoded.decode(*biased, rows);
+  rows.applyToSelected([&](auto row) {
+    ASSERT_EQ(decoded.isNullAt(row), !values[row].has_value()) << row;
+    if (values[row].has_value()) {
+      ASSERT_EQ(decoded.valueAt<int64_t>(row), *values[row]) << row;
+    }
+  });
+
+  // Dictionary over biased.
+  auto indices = makeIndicesInReverse(values.size());
+  auto dictionary =
+      BaseVector::wrapInDictionary(nullptr, indices, values.size(), biased);
+  decoded.decode(*dictionary);
+  for (auto i = 0; i < values.size(); ++i) {
+    const auto& expected = values[values.size() - 1 - i];
+    ASSERT_EQ(decoded.isNullAt(i), !expected.has_value()) << i;
+    if (expected.has_value()) {
+      ASSERT_EQ(decoded.valueAt<int64_t>(i), *expected) << i;
+    }
+  }
+}
+
+
 } // namespace facebook::velox::test
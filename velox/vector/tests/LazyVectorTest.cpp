@@ -573,3 +573,46 @@ TEST_F(LazyVectorTest, lazyWithDictionaryInConstant) {
     EXPECT_EQ(constant->as<SimpleVector<int32_t>>()->valueAt(i), 7);
   }
 }
+
+TEST_F(LazyVectorTest, loadSubsetOfRows) {
+  // Verifies that only the requested rows are passed to the loader and that a
+  // contiguous range of rows is passed as consecutive row numbers.
+  static constexpr int32_t kVectorSize = 100;
+  std::vector<vector_size_t> loadedRows;
+  auto makeLazy = [&]() {
+    return std::make_shared<LazyVector>(
+        pool_.get(),
+        INTEGER(),
+        kVectorSize,
+        std::make_unique<test::SimpleVectorLoader>([&](auto rows) {
+          loadedRows.assign(rows.begin(), rows.end());
+          return makeFlatVector<int32_t>(
+              rows.back() + 1, [](auto row) { return row; });
+        }));
+  };
+
+  SelectivityVector rows(kVectorSize, false);
+  rows.setValidRange(20, 50, true);
+  rows.updateBounds();
+  VectorPtr lazy = makeLazy();
+  LazyVector::ensureLoadedRows(lazy, rows);
+  ASSERT_EQ(loadedRows.size(), 30);
+  for (auto i = 0; i < loadedRows.size(); ++i) {
+    ASSERT_EQ(loadedRows[i], 20 + i);
+  }
+
+  rows.clearAll();
+  std::vector<vector_size_t> expected;
+  for (auto i = 1; i < kVectorSize; i += 7) {
+    rows.setValid(i, true);
+    expected.push_back(i);
+  }
+  rows.updateBounds();
+  lazy = makeLazy();
+  LazyVector::ensureLoadedRows(lazy, rows);
+  ASSERT_EQ(loadedRows, expected);
+  rows.applyToSelected([&](auto row) {
+    ASSERT_EQ(
+        lazy->loadedVector()->as<SimpleVector<int32_t>>()->valueAt(row), row);
+  });
+}
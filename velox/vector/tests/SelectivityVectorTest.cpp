@@ -531,6 +531,52 @@ TEST(SelectivityVectorTest, toString) {
       "147 out of 1024 rows selected between 0 and 1023: 0, 7, 14, 21, 28, 35, 42, 49, 56, 63, 70, 77, 84, 91, 98, 105, 112, 119, 126, 133, 140, 147, 154, 161, 168, 175, 182, 189, 196, 203, 210, 217, 224, 231, 238, 245, 252, 259, 266, 273, 280, 287, 294, 301, 308, 315, 322, 329, 336, 343, 350, 357, 364, 371, 378, 385, 392, 399, 406, 413, 420, 427, 434, 441, 448, 455, 462, 469, 476, 483, 490, 497, 504, 511, 518, 525, 532, 539, 546, 553, 560, 567, 574, 581, 588, 595, 602, 609, 616, 623, 630, 637, 644, 651, 658, 665, 672, 679, 686, 693, 700, 707, 714, 721, 728, 735, 742, 749, 756, 763, 770, 777, 784, 791, 798, 805, 812, 819, 826, 833, 840, 847, 854, 861, 868, 875, 882, 889, 896, 903, 910, 917, 924, 931, 938, 945, 952, 959, 966, 973, 980, 987, 994, 1001, 1008, 1015, 1022");
 }
 
+TEST(SelectivityVectorTest, selectedIndices) {
+  SelectivityVector rows(1'000, false);
+  std::vector<vector_size_t> expected;
+  for (auto i = 3; i < rows.size(); i += 13) {
+    rows.setValid(i, true);
+    expected.push_back(i);
+  }
+  rows.updateBounds();
+
+  ASSERT_EQ(rows.selectedIndices(), expected);
+  // The cached list is returned on repeated calls.
+  ASSERT_EQ(rows.selectedIndices().data(), rows.selectedIndices().data());
+
+  std::vector<vector_size_t> iterated;
+  rows.applyToSelected([&](auto row) { iterated.push_back(row); });
+  ASSERT_EQ(iterated, expected);
+
+  // Modifications invalidate the list.
+  rows.setValid(3, false);
+  rows.updateBounds();
+  expected.erase(expected.begin());
+  ASSERT_EQ(rows.selectedIndices(), expected);
+
+  rows.setValidRange(0, 5, true);
+  rows.updateBounds();
+  expected.insert(expected.begin(), {0, 1, 2, 3, 4});
+  ASSERT_EQ(rows.selectedIndices(), expected);
+
+  SelectivityVector other(500);
+  rows.intersect(other);
+  while (expected.back() >= 500) {
+    expected.pop_back();
+  }
+  ASSERT_EQ(rows.selectedIndices(), expected);
+  iterated.clear();
+  rows.applyToSelected([&](auto row) { iterated.push_back(row); });
+  ASSERT_EQ(iterated, expected);
+
+  rows.clearAll();
+  ASSERT_TRUE(rows.selectedIndices().empty());
+
+  rows.setAll();
+  ASSERT_EQ(rows.selectedIndices().size(), rows.size());
+  ASSERT_EQ(rows.selectedIndices().back(), rows.size() - 1);
+}
+
 } // namespace test
 } // namespace velox
 } // namespace facebook
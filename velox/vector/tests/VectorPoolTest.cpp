@@ -146,4 +146,79 @@ TEST_F(VectorPoolTest, customTypes) {
   ASSERT_EQ(1'000, vector->size());
   ASSERT_TRUE(isJsonType(vector->type()));
 }
+
+TEST_F(VectorPoolTest, complexTypes) {
+  VectorPool vectorPool(pool());
+
+  auto rowType = ROW({"a", "b"}, {BIGINT(), ARRAY(VARCHAR())});
+  for (const auto& type : std::vector<TypePtr>{
+           ARRAY(BIGINT()), MAP(VARCHAR(), DOUBLE()), rowType}) {
+    SCOPED_TRACE(type->toString());
+    auto vector = vectorPool.get(type, 1'000);
+    ASSERT_EQ(1'000, vector->size());
+
+    auto* vectorPtr = vector.get();
+    ASSERT_TRUE(vectorPool.release(vector));
+    ASSERT_EQ(vector, nullptr);
+
+    // Structurally equal types share the cache.
+    auto recycledVector = vectorPool.get(type, 500);
+    ASSERT_EQ(vectorPtr, recycledVector.get());
+    ASSERT_EQ(500, recycledVector->size());
+    ASSERT_TRUE(recycledVector->type()->equivalent(*type));
+  }
+
+  // Children of recycled rows are sized to match the row.
+  auto row = vectorPool.get(rowType, 100);
+  auto* rowPtr = row.get();
+  ASSERT_TRUE(vectorPool.release(row));
+  row = vectorPool.get(ROW({"a", "b"}, {BIGINT(), ARRAY(VARCHAR())}), 200);
+  ASSERT_EQ(rowPtr, row.get());
+  for (const auto& child : row->as<RowVector>()->children()) {
+    ASSERT_EQ(200, child->size());
+  }
+
+  // Arrays with shared elements are not recyclable.
+  auto array = makeArrayVector<int64_t>({{1, 2}, {3}});
+  auto elements = array->as<ArrayVector>()->elements();
+  VectorPtr arrayPtr = array;
+  array.reset();
+  ASSERT_FALSE(vectorPool.release(arrayPtr));
+}
+
+TEST_F(VectorPoolTest, preferLargeEnough) {
+  VectorPool vectorPool(pool());
+
+  auto large = vectorPool.get(BIGINT(), 2'000);
+  auto small = vectorPool.get(BIGINT(), 100);
+  auto* largePtr = large.get();
+  auto* smallPtr = small.get();
+  ASSERT_TRUE(vectorPool.release(large));
+  ASSERT_TRUE(vectorPool.release(small));
+
+  // The most recently released vector is too small.
+  auto vector = vectorPool.get(BIGINT(), 1'000);
+  ASSERT_EQ(largePtr, vector.get());
+  vector = vectorPool.get(BIGINT(), 1'000);
+  ASSERT_EQ(smallPtr, vector.get());
+}
+
+TEST_F(VectorPoolTest, stats) {
+  VectorPool vectorPool(pool());
+
+  auto vector = vectorPool.get(BIGINT(), 1'000);
+  ASSERT_EQ(0, vectorPool.stats().numHits);
+  ASSERT_EQ(1, vectorPool.stats().numMisses);
+
+  auto copy = vector;
+  ASSERT_FALSE(vectorPool.release(vector));
+  ASSERT_EQ(1, vectorPool.stats().numRejected);
+  copy.reset();
+  ASSERT_TRUE(vectorPool.release(vector));
+  ASSERT_EQ(1, vectorPool.stats().numReleased);
+
+  vector = vectorPool.get(BIGINT(), 1'000);
+  ASSERT_EQ(1, vectorPool.stats().numHits);
+  ASSERT_EQ(1, vectorPool.stats().numMisses);
+}
 } // namespace facebook::velox::test